@@ -14,11 +14,44 @@
 //
 #include "arolla/array/array.h"
 
+#include <cstdint>
+
 #include "absl/strings/str_cat.h"
+#include "arolla/array/id_filter.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/repr.h"
 
 namespace arolla {
+namespace {
+
+// Thread-local, so that recording a conversion on a hot path does not contend
+// on a shared cache line between threads.
+thread_local ArrayFormConversionStats array_form_conversion_stats;
+
+}  // namespace
+
+namespace array_internal {
+
+void RecordArrayFormConversion(IdFilter::Type new_type, int64_t size) {
+  auto& stats = array_form_conversion_stats;
+  if (new_type == IdFilter::kFull) {
+    stats.to_dense_count += 1;
+    stats.to_dense_rows += size;
+  } else if (new_type == IdFilter::kPartial) {
+    stats.to_sparse_count += 1;
+    stats.to_sparse_rows += size;
+  }
+}
+
+}  // namespace array_internal
+
+ArrayFormConversionStats GetArrayFormConversionStats() {
+  return array_form_conversion_stats;
+}
+
+void ResetArrayFormConversionStats() {
+  array_form_conversion_stats = ArrayFormConversionStats{};
+}
 
 void FingerprintHasherTraits<ArrayShape>::operator()(
     FingerprintHasher* hasher, const ArrayShape& value) const {
@@ -19,10 +19,13 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iterator>
+#include <numeric>
 #include <optional>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/log/check.h"
@@ -41,6 +44,28 @@
 
 namespace arolla {
 
+// Per-thread counters of conversions between Array forms (see e.g.
+// Array::ToDenseForm, Array::ToSparseForm, Array::WithIds). Get/Reset functions
+// below only see the conversions made by the calling thread. Conversions that
+// keep the Array unchanged are not counted. `*_rows` is the total size of the
+// converted Arrays.
+struct ArrayFormConversionStats {
+  int64_t to_dense_count = 0;
+  int64_t to_dense_rows = 0;
+  int64_t to_sparse_count = 0;
+  int64_t to_sparse_rows = 0;
+};
+
+AROLLA_API ArrayFormConversionStats GetArrayFormConversionStats();
+AROLLA_API void ResetArrayFormConversionStats();
+
+namespace array_internal {
+
+AROLLA_API void RecordArrayFormConversion(IdFilter::Type new_type,
+                                          int64_t size);
+
+}  // namespace array_internal
+
 // ::arolla::Array is an immutable array with support of missing values.
 // Implemented on top of DenseArray. It efficiently represents very sparse data
 // and constants, but has bigger fixed overhead than DenseArray.
@@ -194,6 +219,12 @@ class AROLLA_API Array {
                                       id_filter_.ids().is_owner());
   }
 
+  // Returns the memory used by the buffers of the array. The buffers can be
+  // shared with other arrays, see Buffer::memory_usage().
+  size_t memory_usage() const {
+    return id_filter_.ids().memory_usage() + dense_data_.memory_usage();
+  }
+
   // It is cheap if underlaying buffers are already owned and requires full copy
   // otherwise.
   Array MakeOwned(
@@ -206,6 +237,18 @@ class AROLLA_API Array {
                  missing_id_value_);
   }
 
+  // Unowned Array is a bit cheaper to copy because internal shared pointers
+  // are set to nullptr.
+  Array MakeUnowned() const {
+    IdFilter ids =
+        id_filter_.type() == IdFilter::kPartial
+            ? IdFilter(size_, id_filter_.ids().ShallowCopy(),
+                       id_filter_.ids_offset())
+            : id_filter_;
+    return Array(size_, std::move(ids), dense_data_.MakeUnowned(),
+                 missing_id_value_);
+  }
+
   Array Slice(int64_t start_id, int64_t row_count) const {
     DCHECK_GE(start_id, 0);
     DCHECK_GE(row_count, 0);
@@ -378,35 +421,92 @@ bool ArraysAreEquivalent(const Array<T>& lhs, const Array<T>& rhs) {
                              rhs_transformed.dense_data());
 }
 
+// Returns true iff lhs and rhs are backed by the same memory, which implies
+// ArraysAreEquivalent(lhs, rhs). Unlike ArraysAreEquivalent, the check is O(1).
+template <typename T>
+bool ArraysShareBuffers(const Array<T>& lhs, const Array<T>& rhs) {
+  return lhs.size() == rhs.size() && lhs.id_filter().IsSame(rhs.id_filter()) &&
+         lhs.missing_id_value() == rhs.missing_id_value() &&
+         ArraysShareBuffers(lhs.dense_data(), rhs.dense_data());
+}
+
 template <class T>
 Array<T> CreateArray(absl::Span<const OptionalValue<T>> data) {
   return Array<T>(CreateDenseArray<T>(data));
 }
 
+namespace array_internal {
+
+// Creates Array of `size` from `count` (id, value) pairs returned by
+// `id_fn(i)` and `value_fn(i)`. The ids must be strictly ascending.
+template <class T, class IdFn, class ValueFn>
+Array<T> CreateArrayFromSortedIds(int64_t size, int64_t count, IdFn id_fn,
+                                  ValueFn value_fn,
+                                  RawBufferFactory* buf_factory) {
+  DCHECK_LE(count, size);
+  if (count > size * IdFilter::DenseSparsityLimit()) {
+    DenseArrayBuilder<T> bldr(size, buf_factory);
+    for (int64_t i = 0; i < count; ++i) {
+      bldr.Set(id_fn(i), value_fn(i));
+    }
+    return Array<T>(std::move(bldr).Build());
+  } else {
+    Buffer<int64_t>::Builder ids_bldr(count, buf_factory);
+    DenseArrayBuilder<T> values_bldr(count, buf_factory);
+    for (int64_t i = 0; i < count; ++i) {
+      ids_bldr.Set(i, id_fn(i));
+      values_bldr.Set(i, value_fn(i));
+    }
+    return Array<T>(size, IdFilter(size, std::move(ids_bldr).Build()),
+                    std::move(values_bldr).Build());
+  }
+}
+
+}  // namespace array_internal
+
 // Creates Array from lists of ids and values. It chooses dense or sparse
 // representation automatically. ValueT should be one of T, OptionalValue<T>,
 // std::optional<T>, or corresponding view types.
 template <class T, class ValueT = T>
 Array<T> CreateArray(int64_t size, absl::Span<const int64_t> ids,
-                     absl::Span<const ValueT> values) {
+                     absl::Span<const ValueT> values,
+                     RawBufferFactory* buf_factory = GetHeapBufferFactory()) {
   DCHECK_EQ(ids.size(), values.size());
-  DCHECK_LE(values.size(), size);
-  if (values.size() > size * IdFilter::kDenseSparsityLimit) {
-    DenseArrayBuilder<T> bldr(size);
-    for (int64_t i = 0; i < values.size(); ++i) {
-      bldr.Set(ids[i], values[i]);
-    }
-    return Array<T>(std::move(bldr).Build());
-  } else {
-    Buffer<int64_t>::Builder ids_bldr(ids.size());
-    DenseArrayBuilder<T> values_bldr(values.size());
-    for (int64_t i = 0; i < values.size(); ++i) {
-      ids_bldr.Set(i, ids[i]);
-      values_bldr.Set(i, values[i]);
+  return array_internal::CreateArrayFromSortedIds<T>(
+      size, ids.size(), [&](int64_t i) { return ids[i]; },
+      [&](int64_t i) -> const ValueT& { return values[i]; }, buf_factory);
+}
+
+// Creates Array from (id, value) pairs given in arbitrary order, e.g. sparse
+// features stored in a repeated proto field or a map. If an id occurs several
+// times, the last value is used. Like CreateArray above, the result is in the
+// sparse form unless the ids are dense enough, so no dense intermediate of
+// the full `size` is allocated for sparse inputs.
+template <class T, class ValueT = T>
+Array<T> CreateArrayFromUnorderedIds(
+    int64_t size, absl::Span<const int64_t> ids,
+    absl::Span<const ValueT> values,
+    RawBufferFactory* buf_factory = GetHeapBufferFactory()) {
+  DCHECK_EQ(ids.size(), values.size());
+  if (std::adjacent_find(ids.begin(), ids.end(), std::greater_equal<>()) ==
+      ids.end()) {
+    return CreateArray<T, ValueT>(size, ids, values, buf_factory);
+  }
+  std::vector<int64_t> order(ids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int64_t a, int64_t b) { return ids[a] < ids[b]; });
+  // Keep the last occurrence of each id.
+  int64_t unique_count = 0;
+  for (int64_t i = 0; i < order.size(); ++i) {
+    if (i + 1 == order.size() || ids[order[i]] != ids[order[i + 1]]) {
+      order[unique_count++] = order[i];
     }
-    return Array<T>(size, IdFilter(size, std::move(ids_bldr).Build()),
-                    std::move(values_bldr).Build());
   }
+  return array_internal::CreateArrayFromSortedIds<T>(
+      size, unique_count, [&](int64_t i) { return ids[order[i]]; },
+      [&](int64_t i) -> const ValueT& { return values[order[i]]; },
+      buf_factory);
 }
 
 // This helper allows to get Array type from optional types and references.
@@ -434,6 +534,7 @@ Array<T> Array<T>::WithIds(const IdFilter& ids,
     return Array(size_, ids, dense_data_, missing_id_value);
   }
 
+  array_internal::RecordArrayFormConversion(ids.type(), size_);
   DenseArray<T> new_data;
   switch (id_filter_.type()) {
     case IdFilter::kEmpty: {
@@ -606,6 +707,7 @@ Array<T> Array<T>::ToSparseFormWithMissedIdValue(
                    missing_id_value, buf_factory);
   }
 
+  array_internal::RecordArrayFormConversion(IdFilter::kPartial, size_);
   typename Buffer<T>::ReshuffleBuilder values_bldr(
       dense_data_.size(), dense_data_.values, std::nullopt, buf_factory);
   bitmap::Bitmap bitmap;
@@ -661,6 +763,7 @@ Array<T> Array<T>::ToSparseFormWithoutMissedIdValue(
 
   // No missing values, nothing to do.
   if (dense_data_.bitmap.empty()) return *this;
+  array_internal::RecordArrayFormConversion(IdFilter::kPartial, size_);
 
   Buffer<IdFilter::IdWithOffset>::Builder ids_bldr(dense_data_.size(),
                                                    buf_factory);
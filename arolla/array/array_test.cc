@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <thread>  // NOLINT(build/c++11)
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -171,6 +172,72 @@ TEST(ArrayTest, CreateFromIdsAndValues) {
   }
 }
 
+TEST(ArrayTest, CreateFromUnorderedIds) {
+  constexpr auto NA = std::nullopt;
+  {
+    auto array = CreateArrayFromUnorderedIds<int>(10, {4, 1}, {7, 3});
+    EXPECT_TRUE(array.IsSparseForm());
+    EXPECT_THAT(array, ElementsAre(NA, 3, NA, NA, 7, NA, NA, NA, NA, NA));
+  }
+  {
+    auto array =
+        CreateArrayFromUnorderedIds<int>(10, {4, 1, 4, 5, 1}, {7, 3, 8, 0, 2});
+    EXPECT_TRUE(array.IsDenseForm());
+    EXPECT_THAT(array, ElementsAre(NA, 2, NA, NA, 8, 0, NA, NA, NA, NA));
+  }
+  {
+    UnsafeArenaBufferFactory arena(1024);
+    auto array = CreateArrayFromUnorderedIds<float>(1000, {900, 3}, {1.f, 2.f},
+                                                    &arena);
+    EXPECT_TRUE(array.IsSparseForm());
+    EXPECT_FALSE(array.is_owned());
+    EXPECT_THAT(array.ToSparseForm().id_filter().ids(), ElementsAre(3, 900));
+    EXPECT_THAT(array.dense_data(), ElementsAre(2.f, 1.f));
+  }
+  {
+    auto array = CreateArrayFromUnorderedIds<int>(5, {}, {});
+    EXPECT_THAT(array, ElementsAre(NA, NA, NA, NA, NA));
+  }
+}
+
+TEST(ArrayTest, CreateFromIdsAndValuesWithCustomSparsityLimit) {
+  constexpr auto NA = std::nullopt;
+  IdFilter::SetDenseSparsityLimit(0.5);
+  auto array = CreateArray<int>(10, {1, 4, 5}, {3, 7, 0});
+  IdFilter::SetDenseSparsityLimit(IdFilter::kDenseSparsityLimit);
+  EXPECT_TRUE(array.IsSparseForm());
+  EXPECT_THAT(array, ElementsAre(NA, 3, NA, NA, 7, 0, NA, NA, NA, NA));
+}
+
+TEST(ArrayTest, FormConversionStats) {
+  auto array = CreateArray<int>({1, std::nullopt, 0, std::nullopt});
+  ResetArrayFormConversionStats();
+
+  Array<int> sparse = array.ToSparseForm();
+  Array<int> dense = sparse.ToDenseForm();
+  dense.ToDenseForm();    // no-op, not counted
+  array.ToSparseForm(0);  // with missing_id_value
+  ArrayFormConversionStats stats = GetArrayFormConversionStats();
+  EXPECT_EQ(stats.to_dense_count, 1);
+  EXPECT_EQ(stats.to_dense_rows, 4);
+  EXPECT_EQ(stats.to_sparse_count, 2);
+  EXPECT_EQ(stats.to_sparse_rows, 8);
+
+  ResetArrayFormConversionStats();
+  stats = GetArrayFormConversionStats();
+  EXPECT_EQ(stats.to_dense_count, 0);
+  EXPECT_EQ(stats.to_sparse_count, 0);
+}
+
+TEST(ArrayTest, FormConversionStatsArePerThread) {
+  ResetArrayFormConversionStats();
+  std::thread([] {
+    CreateArray<int>({1, std::nullopt, 0}).ToSparseForm();
+    EXPECT_EQ(GetArrayFormConversionStats().to_sparse_count, 1);
+  }).join();
+  EXPECT_EQ(GetArrayFormConversionStats().to_sparse_count, 0);
+}
+
 TEST(ArrayTest, ForEach) {
   struct V {
     bool repeated;
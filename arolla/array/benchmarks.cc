@@ -369,6 +369,53 @@ BENCHMARK(BM_Add_Union)
     ->ArgPair(64, 64);
 BENCHMARK(BM_Add_SameFilter)->Arg(4)->Arg(16)->Arg(64);
 
+void BM_IdFilter_IntersectPartial(benchmark::State& state) {
+  int sparsity1 = state.range(0);
+  int sparsity2 = state.range(1);
+  int64_t size = 1024 * 1024;
+  absl::BitGen gen;
+  auto ids1 = RandomIdFilter(size, sparsity1, gen);
+  auto ids2 = RandomIdFilter(size, sparsity2, gen);
+
+  for (auto s : state) {
+    int64_t count = 0;
+    IdFilter::IntersectPartial_ForEach(
+        ids1, ids2, [&](int64_t, int64_t, int64_t) { count++; });
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(size * state.iterations());
+}
+
+void BM_IdFilter_UpperBoundMerge(benchmark::State& state) {
+  int sparsity1 = state.range(0);
+  int sparsity2 = state.range(1);
+  int64_t size = 1024 * 1024;
+  absl::BitGen gen;
+  auto ids1 = RandomIdFilter(size, sparsity1, gen);
+  auto ids2 = RandomIdFilter(size, sparsity2, gen);
+
+  for (auto s : state) {
+    auto x =
+        IdFilter::UpperBoundMerge(size, GetHeapBufferFactory(), ids1, ids2);
+    benchmark::DoNotOptimize(x);
+  }
+  state.SetItemsProcessed(size * state.iterations());
+}
+
+BENCHMARK(BM_IdFilter_IntersectPartial)
+    ->ArgPair(2, 2)
+    ->ArgPair(2, 16)
+    ->ArgPair(2, 64)
+    ->ArgPair(2, 256)
+    ->ArgPair(2, 1024)
+    ->ArgPair(16, 4096);
+BENCHMARK(BM_IdFilter_UpperBoundMerge)
+    ->ArgPair(8, 8)
+    ->ArgPair(8, 64)
+    ->ArgPair(8, 256)
+    ->ArgPair(8, 1024)
+    ->ArgPair(16, 4096);
+
 void BM_AddFull(benchmark::State& state) {
   int64_t size = state.range(0);
   absl::BitGen gen;
@@ -0,0 +1,154 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/array/compressed_id_filter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/log/check.h"
+#include "absl/types/span.h"
+#include "arolla/array/id_filter.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/memory/raw_buffer_factory.h"
+
+namespace arolla {
+
+CompressedIdFilter CompressedIdFilter::FromIdFilter(
+    int64_t size, const IdFilter& filter, RawBufferFactory* buf_factory) {
+  switch (filter.type()) {
+    case IdFilter::kEmpty:
+      return CompressedIdFilter();
+    case IdFilter::kPartial:
+      return FromIds(filter.ids().span(), filter.ids_offset(), buf_factory);
+    case IdFilter::kFull:
+      break;
+  }
+  std::vector<int64_t> keys;
+  std::vector<int64_t> ranks;
+  for (int64_t rank = 0; rank < size; rank += kChunkSize) {
+    keys.push_back(rank >> kChunkBits);
+    ranks.push_back(rank);
+  }
+  ranks.push_back(size);
+  return FromChunks(std::move(keys), std::move(ranks), buf_factory,
+                    [size](int64_t chunk_id, absl::Span<uint16_t> array,
+                           absl::Span<uint64_t> bitmap) {
+                      for (int64_t i = 0; i < array.size(); ++i) {
+                        array[i] = i;
+                      }
+                      int64_t count = std::min(
+                          kChunkSize, size - chunk_id * kChunkSize);
+                      for (int64_t pos = 0; pos < count && !bitmap.empty();
+                           ++pos) {
+                        bitmap[pos >> 6] |= uint64_t{1} << (pos & 63);
+                      }
+                    });
+}
+
+CompressedIdFilter CompressedIdFilter::FromIds(absl::Span<const int64_t> ids,
+                                               int64_t ids_offset,
+                                               RawBufferFactory* buf_factory) {
+  std::vector<int64_t> keys;
+  std::vector<int64_t> ranks;
+  for (int64_t i = 0; i < ids.size(); ++i) {
+    DCHECK_GE(ids[i], ids_offset);
+    DCHECK(i == 0 || ids[i - 1] < ids[i]);
+    int64_t key = (ids[i] - ids_offset) >> kChunkBits;
+    if (keys.empty() || keys.back() != key) {
+      keys.push_back(key);
+      ranks.push_back(i);
+    }
+  }
+  ranks.push_back(ids.size());
+  auto fill = [&](int64_t chunk_id, absl::Span<uint16_t> array,
+                  absl::Span<uint64_t> bitmap) {
+    const int64_t base = (keys[chunk_id] << kChunkBits) + ids_offset;
+    absl::Span<const int64_t> chunk_ids = ids.subspan(
+        ranks[chunk_id], ranks[chunk_id + 1] - ranks[chunk_id]);
+    for (int64_t i = 0; i < array.size(); ++i) {
+      array[i] = static_cast<uint16_t>(chunk_ids[i] - base);
+    }
+    if (!bitmap.empty()) {
+      for (int64_t id : chunk_ids) {
+        int64_t pos = id - base;
+        bitmap[pos >> 6] |= uint64_t{1} << (pos & 63);
+      }
+    }
+  };
+  // `fill` uses `keys` and `ranks`, so we pass copies.
+  return FromChunks(keys, ranks, buf_factory, fill);
+}
+
+CompressedIdFilter CompressedIdFilter::FromChunks(
+    std::vector<int64_t> keys, std::vector<int64_t> ranks,
+    RawBufferFactory* buf_factory,
+    absl::FunctionRef<void(int64_t chunk_id, absl::Span<uint16_t> array,
+                           absl::Span<uint64_t> bitmap)>
+        fill) {
+  const int64_t chunk_count = keys.size();
+  DCHECK_EQ(ranks.size(), chunk_count + 1);
+  Buffer<int64_t>::Builder begins_bldr(chunk_count, buf_factory);
+  auto begins = begins_bldr.GetMutableSpan();
+  int64_t array_size = 0;
+  int64_t bitmap_size = 0;
+  for (int64_t c = 0; c < chunk_count; ++c) {
+    int64_t count = ranks[c + 1] - ranks[c];
+    if (count > kMaxArrayContainerSize) {
+      begins[c] = bitmap_size;
+      bitmap_size += kBitmapWords;
+    } else {
+      begins[c] = array_size;
+      array_size += count;
+    }
+  }
+
+  Buffer<uint16_t>::Builder array_bldr(array_size, buf_factory);
+  Buffer<uint64_t>::Builder bitmap_bldr(bitmap_size, buf_factory);
+  auto array_data = array_bldr.GetMutableSpan();
+  auto bitmap_data = bitmap_bldr.GetMutableSpan();
+  std::fill(bitmap_data.begin(), bitmap_data.end(), 0);
+  for (int64_t c = 0; c < chunk_count; ++c) {
+    int64_t count = ranks[c + 1] - ranks[c];
+    if (count > kMaxArrayContainerSize) {
+      fill(c, {}, bitmap_data.subspan(begins[c], kBitmapWords));
+    } else {
+      fill(c, array_data.subspan(begins[c], count), {});
+    }
+  }
+
+  CompressedIdFilter res;
+  res.chunk_keys_ = Buffer<int64_t>::Create(std::move(keys));
+  res.chunk_ranks_ = Buffer<int64_t>::Create(std::move(ranks));
+  res.chunk_begins_ = std::move(begins_bldr).Build();
+  res.array_data_ = std::move(array_bldr).Build();
+  res.bitmap_data_ = std::move(bitmap_bldr).Build();
+  return res;
+}
+
+IdFilter CompressedIdFilter::ToIdFilter(int64_t size,
+                                        RawBufferFactory* buf_factory) const {
+  if (ids_count() == 0) {
+    return IdFilter::kEmpty;
+  }
+  Buffer<int64_t>::Builder bldr(ids_count(), buf_factory);
+  auto ids = bldr.GetMutableSpan();
+  ForEach([&](int64_t id, int64_t offset) { ids[offset] = id; });
+  return IdFilter(size, std::move(bldr).Build());
+}
+
+}  // namespace arolla
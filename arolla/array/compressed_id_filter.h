@@ -0,0 +1,262 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_ARRAY_COMPRESSED_ID_FILTER_H_
+#define AROLLA_ARRAY_COMPRESSED_ID_FILTER_H_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/log/check.h"
+#include "absl/types/span.h"
+#include "arolla/array/id_filter.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/memory/raw_buffer_factory.h"
+
+namespace arolla {
+
+// Compressed representation of a sorted set of ids, equivalent to IdFilter of
+// type kPartial. The id range is split into chunks of kChunkSize ids, and every
+// non-empty chunk is stored either as a sorted array of 16-bit offsets within
+// the chunk (if it has at most kMaxArrayContainerSize ids) or as a bitmap
+// (roaring-style). So it takes at most 2 bytes per id instead of 8 for
+// IdFilter, and at most 1 bit per row for dense chunks.
+//
+// Like IdFilter, it maps every present id to its offset, i.e. to its index in
+// the sorted list of the present ids.
+class CompressedIdFilter {
+ public:
+  static constexpr int kChunkBits = 16;
+  static constexpr int64_t kChunkSize = int64_t{1} << kChunkBits;
+  // A chunk with more ids is stored as a bitmap: 2 bytes per id in an array
+  // container would exceed the kChunkSize / 8 bytes of the bitmap.
+  static constexpr int64_t kMaxArrayContainerSize = kChunkSize / 16;
+  static constexpr int64_t kBitmapWords = kChunkSize / 64;
+
+  CompressedIdFilter() = default;
+
+  // Compresses the given id filter. `size` is the size of the corresponding
+  // array, it is needed if filter.type() == kFull.
+  static CompressedIdFilter FromIdFilter(
+      int64_t size, const IdFilter& filter,
+      RawBufferFactory* buf_factory = GetHeapBufferFactory());
+
+  // Values in `ids` must be in increasing order, `ids[i] - ids_offset` must be
+  // non-negative.
+  static CompressedIdFilter FromIds(
+      absl::Span<const int64_t> ids, int64_t ids_offset = 0,
+      RawBufferFactory* buf_factory = GetHeapBufferFactory());
+
+  // Decompresses the filter. `size` has the same meaning as in IdFilter
+  // constructor.
+  IdFilter ToIdFilter(
+      int64_t size,
+      RawBufferFactory* buf_factory = GetHeapBufferFactory()) const;
+
+  // Number of the present ids.
+  int64_t ids_count() const {
+    return chunk_ranks_.empty() ? 0 : chunk_ranks_.back();
+  }
+
+  // Total size of the buffers in bytes.
+  size_t memory_usage() const {
+    return chunk_keys_.memory_usage() + chunk_ranks_.memory_usage() +
+           chunk_begins_.memory_usage() + array_data_.memory_usage() +
+           bitmap_data_.memory_usage();
+  }
+
+  // Calls `fn(id, offset)` for each present id in increasing order.
+  template <class Fn>
+  void ForEach(Fn&& fn) const;
+
+  // Calls `fn(id, offset_in_a, offset_in_b)` for each common id in increasing
+  // order. Only the chunks present in both filters are visited.
+  template <class Fn>
+  static void IntersectForEach(const CompressedIdFilter& a,
+                               const CompressedIdFilter& b, Fn&& fn);
+
+ private:
+  class Chunk {
+   public:
+    Chunk(const CompressedIdFilter& filter, int64_t chunk_id)
+        : base_id_(filter.chunk_keys_[chunk_id] << kChunkBits),
+          rank_(filter.chunk_ranks_[chunk_id]),
+          count_(filter.chunk_ranks_[chunk_id + 1] - rank_),
+          begin_(filter.chunk_begins_[chunk_id]),
+          filter_(filter) {}
+
+    bool is_bitmap() const { return count_ > kMaxArrayContainerSize; }
+    absl::Span<const uint16_t> array() const {
+      DCHECK(!is_bitmap());
+      return filter_.array_data_.span().subspan(begin_, count_);
+    }
+    absl::Span<const uint64_t> bitmap() const {
+      DCHECK(is_bitmap());
+      return filter_.bitmap_data_.span().subspan(begin_, kBitmapWords);
+    }
+
+    int64_t base_id() const { return base_id_; }
+    int64_t rank() const { return rank_; }
+
+   private:
+    int64_t base_id_;
+    int64_t rank_;
+    int64_t count_;
+    int64_t begin_;
+    const CompressedIdFilter& filter_;
+  };
+
+  // Computes the rank of the bits in a bitmap, assuming that the requested
+  // positions are non-decreasing.
+  class BitmapRanker {
+   public:
+    explicit BitmapRanker(absl::Span<const uint64_t> bitmap)
+        : bitmap_(bitmap) {}
+
+    bool Test(int pos) const {
+      return (bitmap_[pos >> 6] >> (pos & 63)) & 1;
+    }
+
+    // Returns the number of the set bits before `pos`.
+    int64_t Rank(int pos) {
+      int word = pos >> 6;
+      for (; word_ < word; ++word_) {
+        rank_ += std::popcount(bitmap_[word_]);
+      }
+      uint64_t mask = (uint64_t{1} << (pos & 63)) - 1;
+      return rank_ + std::popcount(bitmap_[word] & mask);
+    }
+
+   private:
+    absl::Span<const uint64_t> bitmap_;
+    int word_ = 0;
+    int64_t rank_ = 0;
+  };
+
+  template <class Fn>
+  static void IntersectChunks(const Chunk& a, const Chunk& b, Fn& fn);
+
+  // Allocates the containers for the chunks with the given keys and ranks
+  // (see the fields below), and calls `fill(chunk_id, array, bitmap)` to
+  // populate each of them. Exactly one of `array` and `bitmap` is non-empty;
+  // `bitmap` is zero-initialized.
+  static CompressedIdFilter FromChunks(
+      std::vector<int64_t> keys, std::vector<int64_t> ranks,
+      RawBufferFactory* buf_factory,
+      absl::FunctionRef<void(int64_t chunk_id, absl::Span<uint16_t> array,
+                             absl::Span<uint64_t> bitmap)>
+          fill);
+
+  // Indices of the non-empty chunks (i.e. id >> kChunkBits), increasing.
+  Buffer<int64_t> chunk_keys_;
+  // Offset of the first id of each chunk; has an extra element in the end
+  // with the total number of ids.
+  Buffer<int64_t> chunk_ranks_;
+  // Position of the chunk container in array_data_ or bitmap_data_.
+  Buffer<int64_t> chunk_begins_;
+  Buffer<uint16_t> array_data_;
+  Buffer<uint64_t> bitmap_data_;
+};
+
+template <class Fn>
+void CompressedIdFilter::ForEach(Fn&& fn) const {
+  for (int64_t c = 0; c < chunk_keys_.size(); ++c) {
+    Chunk chunk(*this, c);
+    int64_t offset = chunk.rank();
+    if (!chunk.is_bitmap()) {
+      for (uint16_t v : chunk.array()) {
+        fn(chunk.base_id() + v, offset++);
+      }
+      continue;
+    }
+    absl::Span<const uint64_t> bitmap = chunk.bitmap();
+    for (int64_t w = 0; w < kBitmapWords; ++w) {
+      for (uint64_t word = bitmap[w]; word != 0; word &= word - 1) {
+        fn(chunk.base_id() + w * 64 + std::countr_zero(word), offset++);
+      }
+    }
+  }
+}
+
+template <class Fn>
+void CompressedIdFilter::IntersectForEach(const CompressedIdFilter& a,
+                                          const CompressedIdFilter& b,
+                                          Fn&& fn) {
+  int64_t ca = 0;
+  int64_t cb = 0;
+  while (ca < a.chunk_keys_.size() && cb < b.chunk_keys_.size()) {
+    if (a.chunk_keys_[ca] < b.chunk_keys_[cb]) {
+      ++ca;
+    } else if (b.chunk_keys_[cb] < a.chunk_keys_[ca]) {
+      ++cb;
+    } else {
+      IntersectChunks(Chunk(a, ca++), Chunk(b, cb++), fn);
+    }
+  }
+}
+
+template <class Fn>
+void CompressedIdFilter::IntersectChunks(const Chunk& a, const Chunk& b,
+                                         Fn& fn) {
+  const int64_t base_id = a.base_id();
+  if (a.is_bitmap() && b.is_bitmap()) {
+    absl::Span<const uint64_t> bitmap_a = a.bitmap();
+    absl::Span<const uint64_t> bitmap_b = b.bitmap();
+    int64_t rank_a = a.rank();
+    int64_t rank_b = b.rank();
+    for (int64_t w = 0; w < kBitmapWords; ++w) {
+      for (uint64_t word = bitmap_a[w] & bitmap_b[w]; word != 0;
+           word &= word - 1) {
+        int bit = std::countr_zero(word);
+        uint64_t mask = (uint64_t{1} << bit) - 1;
+        fn(base_id + w * 64 + bit,
+           rank_a + std::popcount(bitmap_a[w] & mask),
+           rank_b + std::popcount(bitmap_b[w] & mask));
+      }
+      rank_a += std::popcount(bitmap_a[w]);
+      rank_b += std::popcount(bitmap_b[w]);
+    }
+  } else if (a.is_bitmap()) {
+    BitmapRanker ranker_a(a.bitmap());
+    absl::Span<const uint16_t> array_b = b.array();
+    for (int64_t i = 0; i < array_b.size(); ++i) {
+      if (ranker_a.Test(array_b[i])) {
+        fn(base_id + array_b[i], a.rank() + ranker_a.Rank(array_b[i]),
+           b.rank() + i);
+      }
+    }
+  } else if (b.is_bitmap()) {
+    absl::Span<const uint16_t> array_a = a.array();
+    BitmapRanker ranker_b(b.bitmap());
+    for (int64_t i = 0; i < array_a.size(); ++i) {
+      if (ranker_b.Test(array_a[i])) {
+        fn(base_id + array_a[i], a.rank() + i,
+           b.rank() + ranker_b.Rank(array_a[i]));
+      }
+    }
+  } else {
+    IdFilter::ForEachCommonId<uint16_t, uint16_t>(
+        a.array(), 0, b.array(), 0,
+        [&](int64_t id, int64_t offset_a, int64_t offset_b) {
+          fn(base_id + id, a.rank() + offset_a, b.rank() + offset_b);
+        });
+  }
+}
+
+}  // namespace arolla
+
+#endif  // AROLLA_ARRAY_COMPRESSED_ID_FILTER_H_
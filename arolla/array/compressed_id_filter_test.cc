@@ -0,0 +1,130 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/array/compressed_id_filter.h"
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/random/distributions.h"
+#include "absl/random/random.h"
+#include "arolla/array/id_filter.h"
+#include "arolla/memory/buffer.h"
+
+namespace arolla {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
+using ::testing::Not;
+
+// Generates ids with a presence probability varying from chunk to chunk, so
+// both array and bitmap containers are used.
+std::vector<int64_t> RandomIds(int64_t size, absl::BitGen& gen) {
+  std::vector<int64_t> ids;
+  double presence = 0;
+  for (int64_t id = 0; id < size; ++id) {
+    if (id % CompressedIdFilter::kChunkSize == 0) {
+      presence = absl::Uniform<double>(gen, 0, 0.2);
+    }
+    if (absl::Bernoulli(gen, presence)) {
+      ids.push_back(id);
+    }
+  }
+  return ids;
+}
+
+std::vector<int64_t> GetIds(const CompressedIdFilter& filter) {
+  std::vector<int64_t> ids;
+  filter.ForEach([&](int64_t id, int64_t offset) {
+    EXPECT_EQ(offset, ids.size());
+    ids.push_back(id);
+  });
+  return ids;
+}
+
+TEST(CompressedIdFilterTest, Empty) {
+  CompressedIdFilter filter;
+  EXPECT_EQ(filter.ids_count(), 0);
+  EXPECT_THAT(GetIds(filter), IsEmpty());
+  EXPECT_EQ(filter.ToIdFilter(10).type(), IdFilter::kEmpty);
+  EXPECT_EQ(CompressedIdFilter::FromIdFilter(10, IdFilter::kEmpty).ids_count(),
+            0);
+}
+
+TEST(CompressedIdFilterTest, FromIds) {
+  auto filter = CompressedIdFilter::FromIds({12, 15, 70000, 200005},
+                                            /*ids_offset=*/5);
+  EXPECT_EQ(filter.ids_count(), 4);
+  EXPECT_THAT(GetIds(filter), ElementsAre(7, 10, 69995, 200000));
+}
+
+TEST(CompressedIdFilterTest, RoundTrip) {
+  absl::BitGen gen;
+  constexpr int64_t kSize = 20 * CompressedIdFilter::kChunkSize + 17;
+  std::vector<int64_t> ids = RandomIds(kSize, gen);
+  IdFilter id_filter(kSize, Buffer<int64_t>::Create(ids.begin(), ids.end()));
+  ASSERT_EQ(id_filter.type(), IdFilter::kPartial);
+
+  auto filter = CompressedIdFilter::FromIdFilter(kSize, id_filter);
+  EXPECT_EQ(filter.ids_count(), ids.size());
+  EXPECT_THAT(GetIds(filter), ElementsAreArray(ids));
+  EXPECT_THAT(filter.ToIdFilter(kSize).ids(), ElementsAreArray(ids));
+  EXPECT_LE(filter.memory_usage(), id_filter.ids().memory_usage() / 4);
+}
+
+TEST(CompressedIdFilterTest, Full) {
+  constexpr int64_t kSize = 2 * CompressedIdFilter::kChunkSize + 5;
+  auto filter = CompressedIdFilter::FromIdFilter(kSize, IdFilter::kFull);
+  EXPECT_EQ(filter.ids_count(), kSize);
+  std::vector<int64_t> ids = GetIds(filter);
+  ASSERT_EQ(ids.size(), kSize);
+  for (int64_t i = 0; i < kSize; ++i) {
+    ASSERT_EQ(ids[i], i);
+  }
+  EXPECT_EQ(filter.ToIdFilter(kSize).type(), IdFilter::kFull);
+}
+
+TEST(CompressedIdFilterTest, IntersectForEach) {
+  absl::BitGen gen;
+  constexpr int64_t kSize = 20 * CompressedIdFilter::kChunkSize;
+  std::vector<int64_t> ids_a = RandomIds(kSize, gen);
+  std::vector<int64_t> ids_b = RandomIds(kSize, gen);
+  IdFilter a(kSize, Buffer<int64_t>::Create(ids_a.begin(), ids_a.end()));
+  IdFilter b(kSize, Buffer<int64_t>::Create(ids_b.begin(), ids_b.end()));
+
+  using FnArgs = std::tuple<int64_t, int64_t, int64_t>;
+  std::vector<FnArgs> expected;
+  IdFilter::IntersectPartial_ForEach(
+      a, b, [&](int64_t id, int64_t offset_a, int64_t offset_b) {
+        expected.push_back({id, offset_a, offset_b});
+      });
+  ASSERT_THAT(expected, Not(IsEmpty()));
+
+  std::vector<FnArgs> res;
+  CompressedIdFilter::IntersectForEach(
+      CompressedIdFilter::FromIdFilter(kSize, a),
+      CompressedIdFilter::FromIdFilter(kSize, b),
+      [&](int64_t id, int64_t offset_a, int64_t offset_b) {
+        res.push_back({id, offset_a, offset_b});
+      });
+  EXPECT_EQ(res, expected);
+}
+
+}  // namespace
+}  // namespace arolla
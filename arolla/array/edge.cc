@@ -26,6 +26,7 @@
 #include "absl/types/span.h"
 #include "arolla/array/array.h"
 #include "arolla/dense_array/edge.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/status_macros_backport.h"
@@ -80,10 +81,17 @@ absl::StatusOr<ArrayEdge> ArrayEdge::FromMapping(Array<int64_t> mapping,
 
 absl::StatusOr<ArrayEdge> ArrayEdge::FromUniformGroups(
     int64_t parent_size, int64_t group_size, RawBufferFactory& buf_factory) {
-  ASSIGN_OR_RETURN(
-      DenseArrayEdge edge,
-      DenseArrayEdge::FromUniformGroups(parent_size, group_size, buf_factory));
-  return ArrayEdge::FromDenseArrayEdge(std::move(edge));
+  if (parent_size < 0 || group_size < 0) {
+    return absl::InvalidArgumentError(
+        "parent_size and group_size cannot be negative");
+  }
+  // ArrayEdge always stores the split points, unlike the uniform
+  // DenseArrayEdge, so we build them in `buf_factory` directly.
+  Buffer<int64_t>::Builder split_points_builder(parent_size + 1, &buf_factory);
+  auto inserter = split_points_builder.GetInserter();
+  for (int64_t i = 0; i <= parent_size; ++i) inserter.Add(i * group_size);
+  return ArrayEdge::FromDenseArrayEdge(DenseArrayEdge::UnsafeFromSplitPoints(
+      {std::move(split_points_builder).Build()}));
 }
 
 ArrayEdge ArrayEdge::UnsafeFromMapping(Array<int64_t> mapping,
@@ -140,6 +148,13 @@ bool ArrayEdge::IsEquivalentTo(const ArrayEdge& other) const {
   return ArraysAreEquivalent(this_edge.edge_values(), other_edge.edge_values());
 }
 
+bool ArrayEdge::SharesBuffersWith(const ArrayEdge& other) const {
+  return edge_type() == other.edge_type() &&
+         parent_size() == other.parent_size() &&
+         child_size() == other.child_size() &&
+         ArraysShareBuffers(edge_values(), other.edge_values());
+}
+
 void FingerprintHasherTraits<ArrayEdge>::operator()(
     FingerprintHasher* hasher, const ArrayEdge& value) const {
   hasher->Combine(value.edge_type(), value.parent_size(), value.child_size(),
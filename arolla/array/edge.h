@@ -114,6 +114,10 @@ class AROLLA_API ArrayEdge {
   // Returns true iff this edge represents the same edge as other.
   bool IsEquivalentTo(const ArrayEdge& other) const;
 
+  // Returns true iff this edge and `other` are backed by the same buffers,
+  // which implies IsEquivalentTo(other). The check is O(1).
+  bool SharesBuffersWith(const ArrayEdge& other) const;
+
  private:
   ArrayEdge(EdgeType edge_values_type, int64_t parent_size, int64_t child_size,
             Array<int64_t> edge_values)
@@ -39,6 +39,7 @@
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/util/binary_search.h"
 #include "arolla/util/meta.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/view_types.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -89,10 +90,15 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
   //  `empty_accumulator` is an Accumulator instance used as a prototype for
   //      creating new accumulators. Note that a given accumulator may be used
   //      for multiple groups within a single operation.
+  //  `parallelism` enables multithreaded evaluation of big edges, see
+  //      GroupOpParallelism. Only used if the edge and all the arguments are
+  //      in dense form.
   explicit ArrayGroupOpImpl(RawBufferFactory* buffer_factory,
-                            Accumulator empty_accumulator = Accumulator())
+                            Accumulator empty_accumulator = Accumulator(),
+                            GroupOpParallelism parallelism = {})
       : buffer_factory_(buffer_factory),
-        empty_accumulator_(std::move(empty_accumulator)) {}
+        empty_accumulator_(std::move(empty_accumulator)),
+        parallelism_(parallelism) {}
 
   // Applies this group operator.
   //
@@ -112,7 +118,8 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
           (p_args.IsDenseForm() && ... && true) &&
           (c_args.IsDenseForm() && ... && true)) {
         auto op = [this](const auto&... args) ABSL_ATTRIBUTE_NOINLINE {
-          return DenseGroupOp(buffer_factory_, empty_accumulator_)
+          return DenseGroupOp(buffer_factory_, empty_accumulator_,
+                              parallelism_)
               .Apply(args...);
         };
         ASSIGN_OR_RETURN(DenseArray<ResT> res,
@@ -149,7 +156,7 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
           ParentUtil parent_util(edge.parent_size(), p_args...,
                                  buffer_factory_);
           if (child_util.PresentCountUpperEstimate() >
-              edge.child_size() * IdFilter::kDenseSparsityLimit) {
+              edge.child_size() * IdFilter::DenseSparsityLimit()) {
             return ApplyDenseWithSplitPoints(parent_util, child_util, splits);
           } else {
             return ApplySparseWithSplitPoints(parent_util, child_util, splits);
@@ -157,6 +164,14 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
         }
       }
       case ArrayEdge::MAPPING: {
+        if constexpr (kIsAggregator && !ForwardId &&
+                      sizeof...(ChildTs) > 0) {
+          if (((c_args.IsConstForm() && c_args.missing_id_value().present) &&
+               ... && true)) {
+            return ApplyAggregatorWithMappingOnConstData(edge, p_args...,
+                                                         c_args...);
+          }
+        }
         MappingAndChildUtil mapchild_util(edge.child_size(), edge.edge_values(),
                                           c_args..., buffer_factory_);
         if constexpr (kIsAggregator && sizeof...(ParentTs) == 0) {
@@ -216,8 +231,9 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
       return typename Accumulator::result_type(std::move(res));
     } else {
       const int64_t max_present_count = util.PresentCountUpperEstimate();
-      if (kIsPartial && max_present_count >
-                            edge.child_size() * IdFilter::kDenseSparsityLimit) {
+      if (kIsPartial &&
+          max_present_count >
+              edge.child_size() * IdFilter::DenseSparsityLimit()) {
         DenseArrayBuilder<ResT> builder(edge.child_size(), buffer_factory_);
         auto fn = [&](int64_t child_id, view_type_t<ChildTs>... args) {
           Add(accumulator, child_id, args...);
@@ -268,8 +284,8 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
     const int64_t child_row_count = mapchild_util.size();
     const int64_t max_present_count = mapchild_util.PresentCountUpperEstimate();
     if (kIsAggregator ||
-        (kIsPartial &&
-         max_present_count > child_row_count * IdFilter::kDenseSparsityLimit)) {
+        (kIsPartial && max_present_count >
+                           child_row_count * IdFilter::DenseSparsityLimit())) {
       return ApplyAggregatorOrDensePartialWithMapping(
           parent_util, mapchild_util, accumulators, valid_parents);
     }
@@ -378,6 +394,60 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
                        std::move(dense_builder).Build(), missing_id_value);
   }
 
+  // This algorithm is for aggregators over child arrays in const form.
+  //   * All the rows of a group have the same child values, so only the
+  //     number of rows per group is computed from the mapping. The child
+  //     arrays are not converted to dense form.
+  //   * Every group gets a single `AddN` call, so the accumulators that
+  //     implement it in closed form (e.g. sum = value * count) don't iterate
+  //     over the rows at all.
+  absl::StatusOr<Array<ResT>> ApplyAggregatorWithMappingOnConstData(
+      const ArrayEdge& edge, const AsArray<ParentTs>&... p_args,
+      const AsArray<ChildTs>&... c_args) const {
+    static_assert(kIsAggregator);
+    static_assert(!ForwardId);
+    std::vector<int64_t> group_sizes(edge.parent_size(), 0);
+    ArrayOpsUtil</*ConvertToDense=*/false, meta::type_list<int64_t>>
+        mapping_util(edge.child_size(), edge.edge_values(), buffer_factory_);
+    mapping_util.Iterate(
+        0, edge.child_size(),
+        [&](int64_t, int64_t parent_id) { group_sizes[parent_id]++; },
+        empty_missing_fn,
+        [&](int64_t, int64_t count, int64_t parent_id) {
+          group_sizes[parent_id] += count;
+        });
+
+    ParentUtil parent_util(edge.parent_size(), p_args..., buffer_factory_);
+    Accumulator accumulator = empty_accumulator_;
+    DenseArrayBuilder<ResT> builder(edge.parent_size(), buffer_factory_);
+    absl::Status status = absl::OkStatus();
+    parent_util.IterateSimple(
+        [&](int64_t parent_id, view_type_t<ParentTs>... args) {
+          if (!status.ok()) return;
+          accumulator.Reset(args...);
+          if (group_sizes[parent_id] > 0) {
+            accumulator.AddN(group_sizes[parent_id],
+                             ConstValue<ChildTs>(c_args)...);
+          }
+          builder.Set(parent_id, accumulator.GetResult());
+          status = accumulator.GetStatus();
+        });
+    RETURN_IF_ERROR(status);
+    return Array<ResT>(std::move(builder).Build());
+  }
+
+  // Returns the value of a child array in const form as the accumulator
+  // argument `ChildT`.
+  template <class ChildT>
+  static view_type_t<ChildT> ConstValue(const AsArray<ChildT>& arg) {
+    DCHECK(arg.IsConstForm() && arg.missing_id_value().present);
+    if constexpr (is_optional_v<ChildT>) {
+      return arg.missing_id_value();
+    } else {
+      return arg.missing_id_value().value;
+    }
+  }
+
   absl::StatusOr<Array<ResT>> ApplyAggregatorOrDensePartialWithMapping(
       ParentUtil& parent_util, MappingAndChildUtil& mapchild_util,
       std::vector<Accumulator>& accumulators,
@@ -612,6 +682,7 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
 
   RawBufferFactory* buffer_factory_;
   const Accumulator empty_accumulator_;
+  GroupOpParallelism parallelism_;
 };
 
 }  // namespace array_ops_internal
@@ -33,6 +33,7 @@
 #include "arolla/util/meta.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/text.h"
+#include "arolla/util/threading.h"
 
 namespace arolla {
 namespace {
@@ -40,6 +41,7 @@ namespace {
 using ::arolla::testing::IsOkAndHolds;
 using ::arolla::testing::StatusIs;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::HasSubstr;
 using ::testing::Test;
 
@@ -94,6 +96,33 @@ TEST(ArrayGroupOp, DenseGroupOpShortcut) {
               ElementsAre(std::nullopt, 13.0f, 3.0f, 6.0f));
 }
 
+TEST(ArrayGroupOp, ParallelDenseGroupOp) {
+  constexpr int64_t kParentCount = 10;
+  constexpr int64_t kChildCount = 1000;
+  std::vector<int64_t> detail_to_group(kChildCount);
+  std::vector<int64_t> values(kChildCount);
+  for (int64_t i = 0; i < kChildCount; ++i) {
+    detail_to_group[i] = i % kParentCount;
+    values[i] = i;
+  }
+  ASSERT_OK_AND_ASSIGN(
+      ArrayEdge edge,
+      ArrayEdge::FromMapping(
+          Array<int64_t>(CreateFullDenseArray(detail_to_group)), kParentCount));
+
+  StdThreading threading(4);
+  ArrayGroupOp<testing::AggSumAccumulator<int64_t>> sequential_agg(
+      GetHeapBufferFactory());
+  ArrayGroupOp<testing::AggSumAccumulator<int64_t>> parallel_agg(
+      GetHeapBufferFactory(), {},
+      {.threading = &threading, .min_child_rows_per_thread = 100});
+  Array<int64_t> child_values(CreateFullDenseArray(values));
+  ASSERT_OK_AND_ASSIGN(Array<int64_t> expected,
+                       sequential_agg.Apply(edge, child_values));
+  EXPECT_THAT(parallel_agg.Apply(edge, child_values),
+              IsOkAndHolds(ElementsAreArray(expected)));
+}
+
 TEST(ArrayGroupOp, ForwardId) {
   auto splits = CreateArray<int64_t>({0, 0, 2, 3, 4});
   ASSERT_OK_AND_ASSIGN(ArrayEdge edge, ArrayEdge::FromSplitPoints(splits));
@@ -237,6 +266,62 @@ TEST(ArrayGroupOp, AggregationOnVerySparseArray) {
   }
 }
 
+TEST(ArrayGroupOp, AggregationOnConstArrayWithMapping) {
+  // Children 2 and 5 have no parent.
+  auto mapping =
+      CreateArray<int64_t>({0, 2, std::nullopt, 2, 0, std::nullopt, 2});
+  ASSERT_OK_AND_ASSIGN(ArrayEdge edge,
+                       ArrayEdge::FromMapping(mapping, /*parent_size=*/4));
+  {
+    ArrayGroupOpNoDense<testing::AggSumAccumulator<float>> agg(
+        GetHeapBufferFactory());
+    EXPECT_THAT(*agg.Apply(edge, Array<float>(7, 1.5f)),
+                ElementsAre(3.0f, std::nullopt, 4.5f, std::nullopt));
+  }
+  {
+    ArrayGroupOpNoDense<testing::AggCountAccumulator<float>> agg(
+        GetHeapBufferFactory());
+    EXPECT_THAT(*agg.Apply(edge, Array<float>(7, 1.5f)),
+                ElementsAre(2, 0, 3, 0));
+    EXPECT_THAT(*agg.Apply(edge, Array<float>(7, std::nullopt)),
+                ElementsAre(0, 0, 0, 0));
+  }
+  {
+    // With parent arguments and an optional child argument.
+    ArrayGroupOpNoDense<testing::AggTextAccumulator> agg(
+        GetHeapBufferFactory());
+    auto prefix = CreateArray<Text>(
+        {Text("a:"), std::nullopt, Text("c:"), std::nullopt});
+    using V = absl::string_view;
+    EXPECT_THAT(*agg.Apply(edge, prefix, Array<Text>(7, Text("v")),
+                           Array<Text>(7, std::nullopt)),
+                ElementsAre(V("a:v\nv\n"), V(""), V("c:v\nv\nv\n"), V("")));
+    EXPECT_THAT(*agg.Apply(edge, prefix, Array<Text>(7, Text("v")),
+                           Array<Text>(7, Text("x"))),
+                ElementsAre(V("a:v (x)\nv (x)\n"), V(""),
+                            V("c:v (x)\nv (x)\nv (x)\n"), V("")));
+  }
+  {
+    // Sparse mapping in const form.
+    ASSERT_OK_AND_ASSIGN(
+        ArrayEdge const_edge,
+        ArrayEdge::FromMapping(Array<int64_t>(5, int64_t{1}),
+                               /*parent_size=*/2));
+    ArrayGroupOpNoDense<testing::AggSumAccumulator<float>> agg(
+        GetHeapBufferFactory());
+    EXPECT_THAT(*agg.Apply(const_edge, Array<float>(5, 2.0f)),
+                ElementsAre(std::nullopt, 10.0f));
+  }
+  {
+    // Group 1 is empty.
+    ArrayGroupOpNoDense<testing::AverageAccumulator> agg(
+        GetHeapBufferFactory());
+    EXPECT_THAT(
+        agg.Apply(edge, Array<float>(7, 1.5f)),
+        StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("empty group")));
+  }
+}
+
 TEST(ArrayGroupOp, AverageToScalar) {
   ArrayGroupOpNoDense<testing::AverageAccumulator> agg(GetHeapBufferFactory());
 
@@ -15,15 +15,20 @@
 #include "arolla/array/id_filter.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <utility>
 
+#include "absl/types/span.h"
 #include "arolla/memory/buffer.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/util/fingerprint.h"
 
 namespace arolla {
 
+std::atomic<double> IdFilter::dense_sparsity_limit_ =
+    IdFilter::kDenseSparsityLimit;
+
 IdFilter IdFilter::UpperBoundMergeImpl(int64_t size,
                                        RawBufferFactory* buf_factory,
                                        const IdFilter& a, const IdFilter& b) {
@@ -31,7 +36,7 @@ IdFilter IdFilter::UpperBoundMergeImpl(int64_t size,
   if (b.type() == kEmpty || a.type() == kFull) return a;
   if (a.IsSame(b)) return a;
 
-  if (std::max(a.ids().size(), b.ids().size()) >= size * kDenseSparsityLimit) {
+  if (std::max(a.ids().size(), b.ids().size()) >= size * DenseSparsityLimit()) {
     // For performance reason we switch from sparse to dense case if data is
     // not very sparse (at least one of the arguments has >=25% values present).
     return kFull;
@@ -39,6 +44,30 @@ IdFilter IdFilter::UpperBoundMergeImpl(int64_t size,
 
   Buffer<int64_t>::Builder bldr(a.ids().size() + b.ids().size(), buf_factory);
   auto inserter = bldr.GetInserter();
+  const IdFilter& small = a.ids().size() <= b.ids().size() ? a : b;
+  const IdFilter& large = a.ids().size() <= b.ids().size() ? b : a;
+  if (large.ids().size() >= kGallopingSizeRatio * small.ids().size()) {
+    // Copy the ranges of the large filter between the ids of the small one.
+    absl::Span<const int64_t> large_ids = large.ids().span();
+    int64_t pos = 0;
+    for (int64_t id : small.ids()) {
+      id -= small.ids_offset();
+      int64_t next_pos =
+          GallopingLowerBound(large_ids, large.ids_offset(), pos, id);
+      for (; pos < next_pos; ++pos) {
+        inserter.Add(large_ids[pos] - large.ids_offset());
+      }
+      if (pos < large_ids.size() && large_ids[pos] - large.ids_offset() == id) {
+        ++pos;
+      }
+      inserter.Add(id);
+    }
+    for (; pos < large_ids.size(); ++pos) {
+      inserter.Add(large_ids[pos] - large.ids_offset());
+    }
+    return IdFilter(size, std::move(bldr).Build(inserter));
+  }
+
   auto ia = a.ids().begin();
   auto ib = b.ids().begin();
 
@@ -16,6 +16,7 @@
 #define AROLLA_ARRAY_ID_FILTER_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <iterator>
 #include <utility>
@@ -50,6 +51,20 @@ class IdFilter {
   // dense/sparse for a newly created Array.
   static constexpr double kDenseSparsityLimit = 0.25;
 
+  // Returns the limit used in Array operations to choose between dense/sparse
+  // form of a newly created Array. Equal to kDenseSparsityLimit unless it was
+  // changed by SetDenseSparsityLimit.
+  static double DenseSparsityLimit() {
+    return dense_sparsity_limit_.load(std::memory_order_relaxed);
+  }
+
+  // Overrides DenseSparsityLimit() for the whole process. Intended for tuning
+  // the limit on a particular workload (see GetArrayFormConversionStats);
+  // affects only the Arrays created after the call.
+  static void SetDenseSparsityLimit(double limit) {
+    dense_sparsity_limit_.store(limit, std::memory_order_relaxed);
+  }
+
   // For types kEmpty and kFull.
   /* implicit */ IdFilter(Type type)  // NOLINT(google-explicit-constructor)
       : type_(type) {
@@ -126,6 +141,13 @@ class IdFilter {
   }
   int64_t ids_offset() const { return ids_offset_; }
 
+  // If one of the id lists is at least `kGallopingSizeRatio` times longer than
+  // the other, ForEachCommonId and UpperBoundMerge iterate over the shorter
+  // list and use exponential search in the longer one instead of the linear
+  // merge. The number is chosen according to BM_IdFilter_* benchmarks in
+  // `array/benchmarks.cc`.
+  static constexpr int64_t kGallopingSizeRatio = 128;
+
   // Calls `fn(id, offset_in_f1, offset_in_f2)` for each common (id-ids_offset).
   // Both f1 and f2 must be non-empty.
   template <class Id1, class Id2, class Fn>
@@ -157,12 +179,28 @@ class IdFilter {
                                              const IdFilters&... fs);
 
  private:
+  // Returns the first position `i >= from` such that
+  // `ids[i] - ids_offset >= id`, or ids.size() if there is no such position.
+  // The complexity is O(log(result - from)).
+  template <class Id>
+  static int64_t GallopingLowerBound(absl::Span<const Id> ids, Id ids_offset,
+                                     int64_t from, int64_t id);
+
+  // Calls `fn(id, offset_in_small, offset_in_large)` for each common id.
+  template <class IdS, class IdL, class Fn>
+  static void ForEachCommonIdGalloping(absl::Span<const IdS> small,
+                                       IdS ids_offset_small,
+                                       absl::Span<const IdL> large,
+                                       IdL ids_offset_large, Fn&& fn);
+
   static IdFilter UpperBoundMergeImpl(int64_t size,
                                       RawBufferFactory* buf_factory,
                                       const IdFilter& a, const IdFilter& b);
   static const IdFilter& UpperBoundIntersectImpl(const IdFilter& a,
                                                  const IdFilter& b);
 
+  static std::atomic<double> dense_sparsity_limit_;
+
   Type type_;
   // Must be in increasing order. Empty if type != kPartial.
   Buffer<IdWithOffset> ids_;
@@ -173,10 +211,20 @@ template <class Id1, class Id2, class Fn>
 ABSL_ATTRIBUTE_ALWAYS_INLINE inline void IdFilter::ForEachCommonId(
     absl::Span<const Id1> f1, Id1 ids_offset1, absl::Span<const Id2> f2,
     Id2 ids_offset2, Fn&& fn) {
-  // Don't change this code without running benchmarks
-  // BM_WithIds.*, BM_Add/.*, BM_Add_Union/.* in benchmarks.cc.
+  // Don't change this code without running benchmarks BM_WithIds.*,
+  // BM_Add/.*, BM_Add_Union/.*, BM_IdFilter_.* in benchmarks.cc.
   DCHECK(!f1.empty());
   DCHECK(!f2.empty());
+  if (f1.size() >= kGallopingSizeRatio * f2.size()) {
+    return ForEachCommonIdGalloping(
+        f2, ids_offset2, f1, ids_offset1,
+        [&fn](int64_t id, int64_t offset2, int64_t offset1) {
+          fn(id, offset1, offset2);
+        });
+  }
+  if (f2.size() >= kGallopingSizeRatio * f1.size()) {
+    return ForEachCommonIdGalloping(f1, ids_offset1, f2, ids_offset2, fn);
+  }
   auto iter1 = f1.begin();
   auto iter2 = f2.begin();
   int64_t id1 = *iter1 - ids_offset1;
@@ -212,6 +260,42 @@ ABSL_ATTRIBUTE_ALWAYS_INLINE inline void IdFilter::ForEachCommonId(
   }
 }
 
+template <class Id>
+int64_t IdFilter::GallopingLowerBound(absl::Span<const Id> ids, Id ids_offset,
+                                      int64_t from, int64_t id) {
+  const int64_t size = ids.size();
+  int64_t lo = from;
+  int64_t hi = from;
+  for (int64_t step = 1; hi < size && ids[hi] - ids_offset < id; step *= 2) {
+    lo = hi + 1;
+    hi += step;
+  }
+  // Here ids[lo - 1] < id <= ids[hi] (excluding the bounds of `ids`).
+  return std::lower_bound(ids.begin() + lo, ids.begin() + std::min(hi, size),
+                          id,
+                          [ids_offset](Id a, int64_t b) {
+                            return a - ids_offset < b;
+                          }) -
+         ids.begin();
+}
+
+template <class IdS, class IdL, class Fn>
+ABSL_ATTRIBUTE_ALWAYS_INLINE inline void IdFilter::ForEachCommonIdGalloping(
+    absl::Span<const IdS> small, IdS ids_offset_small,
+    absl::Span<const IdL> large, IdL ids_offset_large, Fn&& fn) {
+  int64_t pos = 0;
+  for (int64_t i = 0; i < small.size(); ++i) {
+    int64_t id = small[i] - ids_offset_small;
+    pos = GallopingLowerBound(large, ids_offset_large, pos, id);
+    if (pos == large.size()) {
+      return;
+    }
+    if (large[pos] - ids_offset_large == id) {
+      fn(id, i, pos);
+    }
+  }
+}
+
 template <class... IdFilters>
 IdFilter IdFilter::UpperBoundMerge(
     int64_t size ABSL_ATTRIBUTE_UNUSED,  // unused if sizeof...(fs) == 0
@@ -101,5 +101,48 @@ TEST(IdFilterTest, IntersectPartial_ForEach) {
   res.clear();
 }
 
+TEST(IdFilterTest, Galloping) {
+  // The size ratio exceeds kGallopingSizeRatio, so the exponential search is
+  // used both for the intersection and for the merge.
+  constexpr int64_t kSize = 10000;
+  std::vector<int64_t> large_ids;
+  for (int64_t id = 0; id < 4000; id += 2) {
+    large_ids.push_back(id + 7);
+  }
+  std::vector<int64_t> small_ids = {1, 10, 11, 3998, 3999};
+  ASSERT_GE(large_ids.size(),
+            IdFilter::kGallopingSizeRatio * small_ids.size());
+  IdFilter large =
+      IdFilter(kSize, Buffer<int64_t>::Create(large_ids.begin(),
+                                              large_ids.end()),
+               /*ids_offset=*/7);
+  IdFilter small = IdFilter(
+      kSize, Buffer<int64_t>::Create(small_ids.begin(), small_ids.end()));
+
+  using FnArgs = std::tuple<int64_t, int64_t, int64_t>;
+  std::vector<FnArgs> res;
+  auto fn = [&](int64_t id, int64_t offset1, int64_t offset2) {
+    res.push_back({id, offset1, offset2});
+  };
+  IdFilter::IntersectPartial_ForEach(small, large, fn);
+  EXPECT_EQ(res, (std::vector<FnArgs>{{10, 1, 5}, {3998, 3, 1999}}));
+  res.clear();
+  IdFilter::IntersectPartial_ForEach(large, small, fn);
+  EXPECT_EQ(res, (std::vector<FnArgs>{{10, 5, 1}, {3998, 1999, 3}}));
+
+  std::vector<int64_t> expected_union;
+  for (int64_t id = 0; id < 4000; id += 2) {
+    expected_union.push_back(id);
+  }
+  expected_union.insert(expected_union.begin() + 1, 1);
+  expected_union.insert(expected_union.begin() + 7, 11);
+  expected_union.push_back(3999);
+  RawBufferFactory* bf = GetHeapBufferFactory();
+  EXPECT_THAT(IdFilter::UpperBoundMerge(kSize, bf, small, large).ids(),
+              testing::ElementsAreArray(expected_union));
+  EXPECT_THAT(IdFilter::UpperBoundMerge(kSize, bf, large, small).ids(),
+              testing::ElementsAreArray(expected_union));
+}
+
 }  // namespace
 }  // namespace arolla
@@ -155,7 +155,7 @@ struct ArrayMultiEdgeUtil {
           }
         };
         if (util.PresentCountUpperEstimate() <
-            IdFilter::kDenseSparsityLimit * util.size()) {
+            IdFilter::DenseSparsityLimit() * util.size()) {
           SparseArrayBuilder<ResT> bldr(
               util.size(), util.PresentCountUpperEstimate(), buf_factory);
           process_fn(bldr);
@@ -178,7 +178,7 @@ struct ArrayMultiEdgeUtil {
           });
         };
         if (util.PresentCountUpperEstimate() <
-            IdFilter::kDenseSparsityLimit * util.size()) {
+            IdFilter::DenseSparsityLimit() * util.size()) {
           SparseArrayBuilder<ResT> bldr(
               util.size(), util.PresentCountUpperEstimate(), buf_factory);
           process_fn(bldr);
@@ -49,6 +49,18 @@ class ArrayPointwiseOp<ResT, DenseArrayOp, PointwiseFn,
 
   template <class... As>
   absl::StatusOr<Array<ResT>> operator()(const As&... args) const {
+    // Mostly missing arguments in dense form are converted to sparse form, so
+    // the result is computed (and stored) only for their present ids, and the
+    // sparsity propagates through chains of pointwise operations.
+    if ((MayBeSparsified<Args>(args) || ...)) {
+      return Apply(SparsifyIfNeeded<Args>(args)...);
+    }
+    return Apply(args...);
+  }
+
+ private:
+  template <class... As>
+  absl::StatusOr<Array<ResT>> Apply(const As&... args) const {
     ASSIGN_OR_RETURN(int64_t size, GetCommonSize(args...));
 
     if ((((!is_optional_v<Args> && args.IsAllMissingForm())) || ...)) {
@@ -83,7 +95,6 @@ class ArrayPointwiseOp<ResT, DenseArrayOp, PointwiseFn,
         OptionalValue<ResT>(UnStatus(std::move(missing_id_value))));
   }
 
- private:
   template <class... As>
   absl::StatusOr<DenseArray<ResT>> ApplyDenseOp(const As&... args) const {
     return dense_op_(args.dense_data()...);
@@ -94,6 +105,21 @@ class ArrayPointwiseOp<ResT, DenseArrayOp, PointwiseFn,
     return !is_optional_v<Arg> && !arg.HasMissingIdValue();
   }
 
+  template <class Arg, class A>
+  static bool MayBeSparsified(const A& arg) {
+    return !is_optional_v<Arg> && arg.IsDenseForm() &&
+           !arg.dense_data().bitmap.empty();
+  }
+
+  template <class Arg, class A>
+  A SparsifyIfNeeded(const A& arg) const {
+    if (MayBeSparsified<Arg>(arg) &&
+        arg.PresentCount() < arg.size() * IdFilter::DenseSparsityLimit()) {
+      return arg.ToSparseForm(std::nullopt, buf_factory_);
+    }
+    return arg;
+  }
+
   template <class A, class... As>
   static absl::StatusOr<int64_t> GetCommonSize(const A& a, const As&... as) {
     if (!((a.size() == as.size()) && ...)) {
@@ -140,6 +140,32 @@ TEST(OpAddTest, SparsePlusSparse) {
   }
 }
 
+TEST(OpAddTest, MostlyMissingDensePlusDense) {
+  auto op = CreateArrayOp([](int a, int b) { return a + b; });
+  auto arg1 = CreateArray<int>({std::nullopt, 1, std::nullopt, std::nullopt,
+                                std::nullopt, std::nullopt, std::nullopt, 2,
+                                std::nullopt, std::nullopt});
+  auto arg2 = CreateArray<int>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+  ASSERT_TRUE(arg1.IsDenseForm());
+  ASSERT_OK_AND_ASSIGN(Array<int> res, op(arg1, arg2));
+  EXPECT_TRUE(res.IsSparseForm());
+  EXPECT_FALSE(res.HasMissingIdValue());
+  EXPECT_THAT(res.dense_data(), ElementsAre(3, 10));
+  EXPECT_THAT(res, ElementsAre(std::nullopt, 3, std::nullopt, std::nullopt,
+                               std::nullopt, std::nullopt, std::nullopt, 10,
+                               std::nullopt, std::nullopt));
+
+  // The sparsity is propagated further.
+  ASSERT_OK_AND_ASSIGN(Array<int> res2, op(res, arg2));
+  EXPECT_TRUE(res2.id_filter().IsSame(res.id_filter()));
+  EXPECT_THAT(res2.dense_data(), ElementsAre(5, 18));
+
+  // Arguments with enough present values are kept in dense form.
+  auto arg3 = CreateArray<int>({1, std::nullopt, 3, 4, 5, 6, 7, 8, 9, 10});
+  ASSERT_OK_AND_ASSIGN(Array<int> res3, op(arg3, arg2));
+  EXPECT_TRUE(res3.IsDenseForm());
+}
+
 TEST(OpUnionAddTest, WithConst) {
   auto op = CreateArrayOp(UnionAddFn<int>());
   {  // const + const
@@ -23,8 +23,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "absl/status/statusor.h"
@@ -32,9 +34,12 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "arolla/array/array.h"
 #include "arolla/array/edge.h"
+#include "arolla/array/id_filter.h"
 #include "arolla/array/qtype/copier.h"  // IWYU pragma: export
+#include "arolla/dense_array/dense_array.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qtype/any_qtype.h"
@@ -43,6 +48,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_ref.h"
+#include "arolla/qtype/typed_value.h"
 #include "arolla/util/repr.h"
 #include "arolla/util/unit.h"
 #include "arolla/util/view_types.h"
@@ -67,6 +73,19 @@ class ArrayQTypeBase : public ArrayLikeQType {
   virtual void UnsafeSlice(int64_t start_id, int64_t row_count,
                            const void* source, void* destination) const = 0;
 
+  // Gets Array from "source", keeps only the values for the given ids (see
+  // Array::WithIds with missing_id_value=nullopt), and saves to "destination".
+  // Source and destination may point to the same Array.
+  virtual void UnsafeWithIds(const IdFilter& ids, const void* source,
+                             void* destination) const = 0;
+
+  // Creates an Array of the given size that contains the present values of all
+  // the "sources" Arrays, and saves it to "destination". The sources must have
+  // the given size, and their present ids must not intersect.
+  virtual void UnsafeMergeDisjoint(int64_t size,
+                                   absl::Span<const void* const> sources,
+                                   void* destination) const = 0;
+
  protected:
   void RegisterValueQType();
   using ArrayLikeQType::ArrayLikeQType;
@@ -100,11 +119,39 @@ class ArrayQType : public ArrayQTypeBase {
     dst = src.Slice(start_id, row_count);
   }
 
+  void UnsafeWithIds(const IdFilter& ids, const void* source,
+                     void* destination) const final {
+    const Array<T>& src = *reinterpret_cast<const Array<T>*>(source);
+    Array<T>& dst = *reinterpret_cast<Array<T>*>(destination);
+    dst = src.WithIds(ids, std::nullopt);
+  }
+
+  void UnsafeMergeDisjoint(int64_t size, absl::Span<const void* const> sources,
+                           void* destination) const final {
+    Array<T>& dst = *reinterpret_cast<Array<T>*>(destination);
+    if (sources.size() == 1) {
+      dst = *reinterpret_cast<const Array<T>*>(sources[0]);
+      return;
+    }
+    DenseArrayBuilder<T> builder(size);
+    for (const void* source : sources) {
+      reinterpret_cast<const Array<T>*>(source)->ForEachPresent(
+          [&](int64_t id, view_type_t<T> value) { builder.Set(id, value); });
+    }
+    dst = Array<T>(std::move(builder).Build());
+  }
+
   absl::StatusOr<size_t> ArraySize(TypedRef value) const final {
     ASSIGN_OR_RETURN(const Array<T>& v, value.As<Array<T>>());
     return v.size();
   }
 
+  absl::StatusOr<TypedValue> CopyToBufferFactory(
+      TypedRef value, RawBufferFactory* buffer_factory) const final {
+    ASSIGN_OR_RETURN(const Array<T>& v, value.As<Array<T>>());
+    return TypedValue::FromValue(v.MakeUnowned().MakeOwned(buffer_factory));
+  }
+
  private:
   using ArrayQTypeBase::ArrayQTypeBase;
   friend struct QTypeTraits<Array<T>>;
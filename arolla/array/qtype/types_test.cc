@@ -23,7 +23,9 @@
 #include "absl/status/status.h"
 #include "arolla/array/array.h"
 #include "arolla/array/edge.h"
+#include "arolla/array/id_filter.h"
 #include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/memory_allocation.h"
 #include "arolla/memory/optional_value.h"
@@ -152,6 +154,26 @@ TEST(ArrayTypesTest, SliceToSlot) {
   EXPECT_THAT(frame.Get(slot), ElementsAre(std::nullopt, 4, 3));
 }
 
+TEST(ArrayTypesTest, WithIdsAndMergeDisjoint) {
+  const auto* array_type =
+      dynamic_cast<const ArrayQTypeBase*>(GetArrayQType<int>());
+  ASSERT_NE(array_type, nullptr);
+
+  Array<int> block = CreateArray<int>({1, std::nullopt, 4, 3, 5});
+  Array<int> odd, even, merged;
+  array_type->UnsafeWithIds(IdFilter(5, CreateBuffer<int64_t>({1, 3})), &block,
+                            &odd);
+  array_type->UnsafeWithIds(IdFilter(5, CreateBuffer<int64_t>({0, 2, 4})),
+                            &block, &even);
+  EXPECT_THAT(odd, ElementsAre(std::nullopt, std::nullopt, std::nullopt, 3,
+                               std::nullopt));
+  EXPECT_THAT(even, ElementsAre(1, std::nullopt, 4, std::nullopt, 5));
+
+  const void* sources[] = {&odd, &even};
+  array_type->UnsafeMergeDisjoint(5, sources, &merged);
+  EXPECT_THAT(merged, ElementsAre(1, std::nullopt, 4, 3, 5));
+}
+
 TEST(ArrayTypesTest, ArraySize) {
   EXPECT_THAT(GetArraySize(TypedRef::FromValue(
                   CreateArray<int>({1, std::nullopt, 4, 3, 5}))),
@@ -15,16 +15,20 @@
 // Registration of ::arolla::KeyToRowDict types for codegeneration.
 // Library need to be linked to the binary.
 
+#include <algorithm>
 #include <cstdint>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
 #include "arolla/codegen/expr/types.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/dict/dict_types.h"
@@ -32,29 +36,59 @@
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/util/bytes.h"
 #include "arolla/util/text.h"
+#include "arolla/util/view_types.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::codegen {
 namespace {
 
+// Returns C++ code of a constexpr view of the key.
+template <class T>
+absl::StatusOr<std::string> CppKeyViewRepr(const T& key) {
+  if constexpr (std::is_same_v<view_type_t<T>, absl::string_view>) {
+    absl::string_view view = view_type_t<T>(key);
+    // The explicit size is needed for the keys with '\0'.
+    return absl::StrFormat("::absl::string_view(\"%s\", %d)",
+                           absl::CEscape(view), view.size());
+  } else {
+    return CppLiteralRepr(TypedRef::FromValue(key));
+  }
+}
+
+// Non empty dicts are created from the static constexpr arrays of the sorted
+// keys and the rows (see KeyToRowDict::CreateStatic), so they are not
+// constructed in runtime.
 template <class T>
 absl::StatusOr<std::string> CppDictLiteralRepr(TypedRef dict_ref) {
   ASSIGN_OR_RETURN(const KeyToRowDict<T>& dict, dict_ref.As<KeyToRowDict<T>>());
-  std::vector<std::pair<T, int64_t>> sorted_dict(dict.map().begin(),
-                                                 dict.map().end());
-  std::sort(sorted_dict.begin(), sorted_dict.end());
-  std::ostringstream oss;
   ASSIGN_OR_RETURN(std::string type_name, CppTypeName(::arolla::GetQType<T>()));
-  oss << "::arolla::KeyToRowDict<" << type_name << ">{";
+  if (dict.size() == 0) {
+    return absl::StrFormat("::arolla::KeyToRowDict<%s>{}", type_name);
+  }
+  std::vector<std::pair<T, int64_t>> sorted_dict;
+  sorted_dict.reserve(dict.size());
+  dict.ForEach([&](view_type_t<T> key, int64_t row) {
+    sorted_dict.emplace_back(T(key), row);
+  });
+  std::sort(sorted_dict.begin(), sorted_dict.end());
+  std::ostringstream keys;
+  std::ostringstream rows;
   for (const auto& [k, v] : sorted_dict) {
-    ASSIGN_OR_RETURN(std::string key_repr,
-                     CppLiteralRepr(TypedRef::FromValue(k)));
-    ASSIGN_OR_RETURN(std::string value_repr,
+    ASSIGN_OR_RETURN(std::string key_repr, CppKeyViewRepr(k));
+    ASSIGN_OR_RETURN(std::string row_repr,
                      CppLiteralRepr(TypedRef::FromValue(v)));
-    oss << "{" << key_repr << "," << value_repr << "},";
+    keys << key_repr << ",";
+    rows << row_repr << ",";
   }
-  oss << "}";
-  return oss.str();
+  std::string key_view_type_name =
+      std::is_same_v<view_type_t<T>, absl::string_view> ? "::absl::string_view"
+                                                         : type_name;
+  return absl::StrFormat(
+      "[]() { "
+      "static constexpr %s kKeys[] = {%s}; "
+      "static constexpr int64_t kRows[] = {%s}; "
+      "return ::arolla::KeyToRowDict<%s>::CreateStatic(kKeys, kRows); }()",
+      key_view_type_name, keys.str(), rows.str(), type_name);
 }
 
 #define REGISTER_CPP_TYPE(NAME, CTYPE)                                         \
@@ -67,7 +101,7 @@ absl::StatusOr<std::string> CppDictLiteralRepr(TypedRef dict_ref) {
           CppDictLiteralRepr<CTYPE>);                                          \
     }();                                                                       \
     if (!status.ok()) {                                                        \
-      LOG(FATAL) << status.message();                                         \
+      LOG(FATAL) << status.message();                                          \
     }                                                                          \
   }
 
@@ -13,12 +13,14 @@
 // limitations under the License.
 //
 #include <cstdint>
+#include <string>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "arolla/codegen/expr/types.h"
 #include "arolla/qtype/dict/dict_types.h"
 #include "arolla/qtype/typed_ref.h"
+#include "arolla/util/text.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 
 namespace {
@@ -35,8 +37,23 @@ TEST(DictLiteralTest, Sanity) {
   EXPECT_THAT(
       arolla::codegen::CppLiteralRepr(arolla::TypedRef::FromValue(
           arolla::KeyToRowDict<int32_t>{{{5, 2}, {2, 3}}})),
-      IsOkAndHolds("::arolla::KeyToRowDict<int32_t>{{int32_t{2},int64_t{3}},{"
-                   "int32_t{5},int64_t{2}},}"));
+      IsOkAndHolds(
+          "[]() { static constexpr int32_t kKeys[] = {int32_t{2},int32_t{5},}; "
+          "static constexpr int64_t kRows[] = {int64_t{3},int64_t{2},}; "
+          "return ::arolla::KeyToRowDict<int32_t>::CreateStatic(kKeys, kRows); "
+          "}()"));
+  EXPECT_THAT(
+      arolla::codegen::CppLiteralRepr(
+          arolla::TypedRef::FromValue(arolla::KeyToRowDict<arolla::Text>{
+              {{arolla::Text("b"), 0},
+               {arolla::Text(std::string("a\0\"", 3)), 1}}})),
+      IsOkAndHolds(
+          "[]() { static constexpr ::absl::string_view kKeys[] = "
+          "{::absl::string_view(\"a\\000\\\"\", 3),"
+          "::absl::string_view(\"b\", 1),}; "
+          "static constexpr int64_t kRows[] = {int64_t{1},int64_t{0},}; "
+          "return ::arolla::KeyToRowDict<::arolla::Text>::CreateStatic(kKeys, "
+          "kRows); }()"));
 }
 
 }  // namespace
@@ -247,7 +247,10 @@ def protopath_accessor(path, name = None, type = None):
           Child must not be a repeated field.
       `[:]`: selects all elements from the input container (array-like type will be returned).
       `field[:]`: selects all elements from repeated field (array-like type will be returned).
-           Repeated primitive fields are not supported in slot_listener.
+           In slot_listener a repeated primitive field is only supported as the only
+           repeated field in the path, its content is replaced with the present values.
+           An all missing array leaves the field (and the intermediate messages) untouched,
+           same as a missing value in the other accessors.
       `count(field[:])` : counts (or resizes in slot_listener) elements in the repeated field.
            Must be the last element in path.
            If there is no other repeated fields in the path ArrayShape object will be returned.
@@ -639,7 +642,8 @@ def input_loader(
           `{loader_name}_Shards` returning `std::vector<::arolla::InputLoaderPtr<T>>`
           will be created. The main function will return `ChainInputLoader` merging all shards.
           Sharding is useful for compilation optimization for enormously big loaders,
-          customization of `ChainInputLoader` (e.g., for multithreading), or
+          customization of `ChainInputLoader` (e.g., for multithreading, see
+          `ChainInputLoader::MakeParallelInvokeBoundLoadersFn`), or
           to speed up case with many unused fields (require benchmarking).
 
       array_type: "DenseArray" or "" the type of vector to use
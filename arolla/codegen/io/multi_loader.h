@@ -24,10 +24,13 @@
 #include <limits>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "google/protobuf/repeated_field.h"
 #include "google/protobuf/repeated_ptr_field.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/memory/optional_value.h"
@@ -235,6 +238,37 @@ void ResizeRepeatedProtoField(google::protobuf::RepeatedPtrField<T>* field, size
   arolla::proto::ResizeContainer(*field, size);
 }
 
+// Replaces the content of the repeated primitive proto field with the present
+// values of the array. Missing values are skipped. The values of a full array
+// of the same type are copied with a single memcpy.
+template <class ProtoT, class T>
+void WriteArrayToRepeatedProtoField(
+    const DenseArray<T>& array, google::protobuf::RepeatedField<ProtoT>* field) {
+  field->Clear();
+  if constexpr (std::is_same_v<ProtoT, T>) {
+    if (array.IsFull()) {
+      absl::Span<const T> values = array.values.span();
+      field->Add(values.begin(), values.end());
+      return;
+    }
+  }
+  field->Reserve(array.PresentCount());
+  array.ForEachPresent([&](int64_t, auto value) {
+    field->AddAlreadyReserved(static_cast<ProtoT>(value));
+  });
+}
+
+template <class T>
+void WriteArrayToRepeatedProtoField(
+    const DenseArray<T>& array,
+    google::protobuf::RepeatedPtrField<std::string>* field) {
+  field->Clear();
+  field->Reserve(array.PresentCount());
+  array.ForEachPresent([&](int64_t, absl::string_view value) {
+    field->Add()->assign(value.data(), value.size());
+  });
+}
+
 }  // namespace arolla::codegen::io
 
 #endif  // AROLLA_CODEGEN_IO_MULTI_LOADER_H_
@@ -14,6 +14,7 @@
 //
 #include "arolla/codegen/io/multi_loader.h"
 
+#include <cstdint>
 #include <optional>
 
 #include "gmock/gmock.h"
@@ -25,6 +26,7 @@
 #include "arolla/proto/test.pb.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/util/bytes.h"
 
 namespace arolla::codegen::io {
 namespace {
@@ -272,5 +274,37 @@ TEST(ResizeRepeatedProtoFieldTest, MessageResize) {
   EXPECT_EQ(root.inners(0).a(), 13);
 }
 
+TEST(WriteArrayToRepeatedProtoFieldTest, Numeric) {
+  testing_namespace::Root root;
+  root.add_repeated_int32s(57);
+  WriteArrayToRepeatedProtoField(CreateDenseArray<int32_t>({1, 2, 3}),
+                                 root.mutable_repeated_int32s());
+  EXPECT_THAT(root.repeated_int32s(), ElementsAre(1, 2, 3));
+
+  WriteArrayToRepeatedProtoField(
+      CreateDenseArray<int32_t>({4, std::nullopt, 6}),
+      root.mutable_repeated_int32s());
+  EXPECT_THAT(root.repeated_int32s(), ElementsAre(4, 6));
+
+  // type conversion
+  WriteArrayToRepeatedProtoField(CreateDenseArray<int64_t>({7, 8}),
+                                 root.mutable_repeated_int32s());
+  EXPECT_THAT(root.repeated_int32s(), ElementsAre(7, 8));
+
+  WriteArrayToRepeatedProtoField(
+      CreateDenseArray<int32_t>({std::nullopt, std::nullopt}),
+      root.mutable_repeated_int32s());
+  EXPECT_THAT(root.repeated_int32s(), ElementsAre());
+}
+
+TEST(WriteArrayToRepeatedProtoFieldTest, String) {
+  testing_namespace::Root root;
+  root.add_repeated_str("abc");
+  WriteArrayToRepeatedProtoField(
+      CreateDenseArray<Bytes>({Bytes("a"), std::nullopt, Bytes("b")}),
+      root.mutable_repeated_str());
+  EXPECT_THAT(root.repeated_str(), ElementsAre("a", "b"));
+}
+
 }  // namespace
 }  // namespace arolla::codegen::io
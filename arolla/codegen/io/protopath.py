@@ -1173,6 +1173,29 @@ class _SingleMultiElemPath:
     return (f'size_t {size_var} = [&]() {{ '
             f'{body}\nreturn {last_value}{size_path}; }}();')
 
+  def mutable_container(self, output_name: str, input_name: str) -> str:
+    """Returns code to reach the repeated field and put it to output_name.
+
+    Intermediate messages are created if missing.
+
+    Args:
+      output_name: name of the variable to put the mutable container to.
+      input_name: name of the mutable input variable.
+    """
+    body = ''
+    last_value = input_name
+    if not self._single_value_list.is_empty:
+      last_value = output_name + '_last'
+      body += self._single_value_list.set_path_to_field(
+          tmp_prefix=output_name + '_tmp',
+          input_name=input_name,
+          output_name=last_value,
+          missing_action='return',
+          is_mutable=True)
+    container = self._multi_elem.iteration_container(
+        last_value, is_mutable=True)
+    return body + f'\nauto& {output_name} = {container};'
+
   def open_loop(self,
                 loop_var: str,
                 input_name: str,
@@ -1490,11 +1513,18 @@ class Protopath:
           if self._multi_elems
           else array_gen.shape_type()
       )
-    if self._last_path.is_empty:
-      raise ValueError(
-          'mutable accessors not supported for repeated primitive fields.')
     if self._is_wildcard:
       raise ValueError('Wildcard mutable accessors is not supported.')
+    if self._last_path.is_empty:
+      if len(self._multi_elems) != 1 or not isinstance(
+          self._multi_elems[0].multi_element, _RangeSliceElement):
+        raise ValueError(
+            'mutable accessors supported for repeated primitive fields only'
+            ' in the form a/b/c[:].')
+      if array_gen is None:
+        raise ValueError(
+            'array_gen is required for repeated mutable accessors.')
+      return self._mutable_repeated_primitive_accessor(array_gen, cpp_type)
     if self._multi_elems:
       if array_gen is None:
         raise ValueError(
@@ -1765,6 +1795,47 @@ return [](const input_type& input, output_type* output_ptr) -> absl::Status {{
         protopath=self._protopath,
         cpp_type=cpp_type)
 
+  def _mutable_repeated_primitive_accessor(
+      self, array_gen: array_generator.ArrayBuilderGenerator,
+      cpp_type: Optional[str]) -> ProtopathAccessor:
+    """Returns accessor for replacing values of the repeated primitive field.
+
+    An all missing input leaves the field untouched, so a not computed output
+    neither clears the field nor creates the intermediate messages, same as a
+    missing value for the other mutable accessors.
+
+    Args:
+      array_gen: generator of the input array type.
+      cpp_type: type of the values, if None the proto field type is used.
+    """
+    assert len(self._multi_elems) == 1
+    container_setter = self._multi_elems[0].mutable_container(
+        output_name='repeated_field', input_name='(*output_ptr)')
+    body = """
+using output_type = typename decltype(output_type_meta_fn)::type;
+{value_type_definition}
+using input_type = ::arolla::DenseArray<value_type>;
+return [](const input_type& input, output_type* output_ptr) {{
+    if (input.IsAllMissing()) {{ return; }}
+    {container_setter}
+    ::arolla::codegen::io::WriteArrayToRepeatedProtoField(
+        input, &repeated_field);
+  }};""".format(
+      value_type_definition=self._value_type_definition(
+          var_name='std::declval<output_type>()',
+          cpp_type=cpp_type,
+          gen_proto_value_type=True,
+      ),
+      container_setter=container_setter)
+
+    return ProtopathAccessor(
+        _mutable_lambda(body),
+        _MANDATORY_INCLUDES + array_gen.required_includes() +
+        [cpp.Include('arolla/codegen/io/multi_loader.h')],
+        self.default_name,
+        protopath=self._protopath,
+        cpp_type=cpp_type)
+
   @classmethod
   def parse(cls, protopath: str, input_type: str = 'auto') -> 'Protopath':
     """Constructs Proptopath by parsing XPath-like string.
@@ -1300,14 +1300,40 @@ for (auto& x_key : ::arolla::SortedMapKeys(inp.abc())) {
 
   def test_protopath_mutable_accessor_errors(self):
     array_gen = array_generator.create_generator('DenseArray')
-    for ppath in ['abc/qwe[:]', 'abc[:]', 'abc[:]/@key', 'abc[:]/@value']:
-      with self.assertRaisesRegex(ValueError,
-                                  '.*supported for repeated primitive.*'):
-        protopath.Protopath.parse(ppath).mutable_accessor(array_gen=array_gen)
-    for ppath in ['abc/qwe[:]', 'abc[:]', 'abc[:]/@key', 'abc[:]/@value']:
+    for ppath in ['abc[:]/qwe[:]', 'abc[:]/@key', 'abc[:]/@value']:
       with self.assertRaisesRegex(ValueError,
                                   '.*supported for repeated primitive.*'):
         protopath.Protopath.parse(ppath).mutable_accessor(array_gen=array_gen)
+    with self.assertRaisesRegex(ValueError, '.*array_gen is required.*'):
+      protopath.Protopath.parse('abc[:]').mutable_accessor()
+
+  def test_protopath_repeated_primitive_mutable_accessor(self):
+    accessor = protopath.Protopath.parse('abc/qwe[:]').mutable_accessor(
+        array_gen=array_generator.create_generator('DenseArray'))
+    self.assertSetEqual(
+        accessor.required_includes,
+        DENSE_ARRAY_INCLUDES
+        | {cpp.Include('arolla/codegen/io/multi_loader.h')},
+    )
+    self.assertEqual(accessor.default_name,
+                     table.TablePath().Child('abc').Child('qwe'))
+    self.assertEqualIgnoringSpaces(
+        accessor.lambda_str,
+        """
+[](auto output_type_meta_fn) constexpr {
+  using output_type = typename decltype(output_type_meta_fn)::type;
+  using proto_value_type = std::decay_t<decltype(std::declval<output_type>().abc().qwe(0))>;
+  using value_type = ::arolla::proto::arolla_single_value_t<proto_value_type>;
+  using input_type = ::arolla::DenseArray<value_type>;
+  return [](const input_type& input, output_type* output_ptr) {
+    if (input.IsAllMissing()) { return; }
+    auto& repeated_field_last = *(*output_ptr).mutable_abc();
+    auto& repeated_field = *repeated_field_last.mutable_qwe();
+    ::arolla::codegen::io::WriteArrayToRepeatedProtoField(
+        input, &repeated_field);
+  };
+}""",
+    )
 
   def test_protopath_optional_mutable_accessor(self):
     for path in ['abc', 'AbC', 'ABC']:
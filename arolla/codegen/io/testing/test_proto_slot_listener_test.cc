@@ -43,6 +43,7 @@ namespace arolla {
 namespace {
 
 using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::HasSubstr;
 using ::testing::MatchesRegex;
@@ -358,6 +359,42 @@ TEST(InputLoaderTest, TestGetProtoSizedSlotListenerRepeatedSize) {
   EXPECT_EQ(r.inners(1).inners2(0).z(), -2);
 }
 
+TEST(InputLoaderTest, TestGetArrayProtoSlotListenerRepeatedPrimitive) {
+  using aint = ::arolla::DenseArray<int>;
+
+  FrameLayout::Builder layout_builder;
+  auto as_slot = layout_builder.AddSlot<aint>();
+
+  auto slot_listener = ::my_namespace::GetArrayProtoSlotListener();
+  EXPECT_THAT(slot_listener->GetQTypeOf("inner__as"), Eq(GetQType<aint>()));
+  ASSERT_OK_AND_ASSIGN(auto bound_listener,
+                       slot_listener->Bind({
+                           {"inner__as", TypedSlot::FromSlot(as_slot)},
+                       }));
+
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  FramePtr frame = alloc.frame();
+
+  ::testing_namespace::Root r;
+  ASSERT_OK(bound_listener(frame, &r));
+  // All values are missed, so nothing should be set
+  EXPECT_FALSE(r.has_inner());
+
+  frame.Set(as_slot, CreateDenseArray<int>({1, std::nullopt, 3}));
+  ASSERT_OK(bound_listener(frame, &r));
+  EXPECT_THAT(r.inner().as(), ElementsAre(1, 3));
+
+  frame.Set(as_slot, CreateDenseArray<int>({5}));
+  ASSERT_OK(bound_listener(frame, &r));
+  EXPECT_THAT(r.inner().as(), ElementsAre(5));
+
+  // An all missing array keeps the field, same as a missing optional value.
+  frame.Set(as_slot, CreateDenseArray<int>({std::nullopt, std::nullopt}));
+  ASSERT_OK(bound_listener(frame, &r));
+  EXPECT_THAT(r.inner().as(), ElementsAre(5));
+}
+
 TEST(InputLoaderTest, TestGetArrayProtoSlotListenerWithMap) {
   using aint = ::arolla::DenseArray<int>;
 
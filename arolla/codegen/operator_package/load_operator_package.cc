@@ -14,9 +14,12 @@
 //
 #include "arolla/codegen/operator_package/load_operator_package.h"
 
+#include <memory>
 #include <set>
+#include <utility>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
@@ -47,7 +50,11 @@ absl::Status ParseEmbeddedOperatorPackage(
   return absl::OkStatus();
 }
 
-absl::Status LoadOperatorPackage(
+namespace {
+
+// Checks the package version and that the dependencies of the package are
+// present in the registry, and that its operators are not.
+absl::Status CheckOperatorPackage(
     const OperatorPackageProto& operator_package_proto) {
   if (operator_package_proto.version() != 1) {
     return absl::InvalidArgumentError(
@@ -86,32 +93,66 @@ absl::Status LoadOperatorPackage(
         "already present in the registry: M." +
         absl::StrJoin(already_registered_operators, ", M."));
   }
+  return absl::OkStatus();
+}
+
+// Decodes operators[i] of the package.
+absl::StatusOr<ExprOperatorPtr> DecodeOperator(
+    const OperatorPackageProto& operator_package_proto, int i) {
+  const auto& operator_proto = operator_package_proto.operators(i);
+  ASSIGN_OR_RETURN(auto decode_result,
+                   serialization::Decode(operator_proto.implementation()),
+                   _ << "operators[" << i << "].registration_name="
+                     << operator_proto.registration_name());
+  if (decode_result.values.size() != 1 || !decode_result.exprs.empty()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "expected to get a value, got %d values and %d exprs; "
+        "operators[%d].registration_name=%s",
+        decode_result.values.size(), decode_result.exprs.size(), i,
+        operator_proto.registration_name()));
+  }
+  const auto& qvalue = decode_result.values[0];
+  if (qvalue.GetType() != GetQType<ExprOperatorPtr>()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "expected to get %s, got %s; operators[%d].registration_name=%s",
+        GetQType<ExprOperatorPtr>()->name(), qvalue.GetType()->name(), i,
+        operator_proto.registration_name()));
+  }
+  return qvalue.UnsafeAs<ExprOperatorPtr>();
+}
 
-  // Load operators.
+}  // namespace
+
+absl::Status LoadOperatorPackage(
+    const OperatorPackageProto& operator_package_proto) {
+  RETURN_IF_ERROR(CheckOperatorPackage(operator_package_proto));
+  auto* const operator_registry = ExprOperatorRegistry::GetInstance();
   for (int i = 0; i < operator_package_proto.operators_size(); ++i) {
-    const auto& operator_proto = operator_package_proto.operators(i);
-    ASSIGN_OR_RETURN(auto decode_result,
-                     serialization::Decode(operator_proto.implementation()),
-                     _ << "operators[" << i << "].registration_name="
-                       << operator_proto.registration_name());
-    if (decode_result.values.size() != 1 || !decode_result.exprs.empty()) {
-      return absl::InvalidArgumentError(absl::StrFormat(
-          "expected to get a value, got %d values and %d exprs; "
-          "operators[%d].registration_name=%s",
-          decode_result.values.size(), decode_result.exprs.size(), i,
-          operator_proto.registration_name()));
-    }
-    const auto& qvalue = decode_result.values[0];
-    if (qvalue.GetType() != GetQType<ExprOperatorPtr>()) {
-      return absl::InvalidArgumentError(absl::StrFormat(
-          "expected to get %s, got %s; operators[%d].registration_name=%s",
-          GetQType<ExprOperatorPtr>()->name(), qvalue.GetType()->name(), i,
-          operator_proto.registration_name()));
-    }
-    RETURN_IF_ERROR(operator_registry
-                        ->Register(operator_proto.registration_name(),
-                                   qvalue.UnsafeAs<ExprOperatorPtr>())
-                        .status());
+    ASSIGN_OR_RETURN(auto op, DecodeOperator(operator_package_proto, i));
+    RETURN_IF_ERROR(
+        operator_registry
+            ->Register(operator_package_proto.operators(i).registration_name(),
+                       std::move(op))
+            .status());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status LoadOperatorPackageLazily(
+    std::shared_ptr<const OperatorPackageProto> operator_package_proto) {
+  RETURN_IF_ERROR(CheckOperatorPackage(*operator_package_proto));
+  auto* const operator_registry = ExprOperatorRegistry::GetInstance();
+  for (int i = 0; i < operator_package_proto->operators_size(); ++i) {
+    // The package is kept alive by the loaders of the operators that are not
+    // decoded yet.
+    RETURN_IF_ERROR(
+        operator_registry
+            ->RegisterLazily(
+                operator_package_proto->operators(i).registration_name(),
+                [operator_package_proto, i] {
+                  return DecodeOperator(*operator_package_proto, i);
+                })
+            .status());
   }
   return absl::OkStatus();
 }
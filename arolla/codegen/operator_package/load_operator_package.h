@@ -15,6 +15,8 @@
 #ifndef AROLLA_CODEGEN_OPERATOR_PACKAGE_LOAD_OPERATOR_PACKAGE_H_
 #define AROLLA_CODEGEN_OPERATOR_PACKAGE_LOAD_OPERATOR_PACKAGE_H_
 
+#include <memory>
+
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "arolla/codegen/operator_package/operator_package.pb.h"
@@ -30,6 +32,14 @@ absl::Status ParseEmbeddedOperatorPackage(
 absl::Status LoadOperatorPackage(
     const OperatorPackageProto& operator_package_proto);
 
+// Registers expr operators from the operator package without decoding them.
+// Every operator is decoded when its implementation is requested for the first
+// time (see ExprOperatorRegistry::RegisterLazily), so the cost of the loading
+// depends only on the operators used by the binary. The decoding errors are
+// reported on the first use of the operator.
+absl::Status LoadOperatorPackageLazily(
+    std::shared_ptr<const OperatorPackageProto> operator_package_proto);
+
 }  // namespace arolla::operator_package
 
 #endif  // AROLLA_CODEGEN_OPERATOR_PACKAGE_LOAD_OPERATOR_PACKAGE_H_
@@ -15,6 +15,7 @@
 #include "arolla/codegen/operator_package/load_operator_package.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "gmock/gmock.h"
@@ -98,6 +99,35 @@ TEST_F(LoadOperatorPackageTest, Registration) {
   EXPECT_EQ(op_impl->fingerprint(), op->fingerprint());
 }
 
+TEST_F(LoadOperatorPackageTest, LazyRegistration) {
+  ASSERT_OK_AND_ASSIGN(ExprOperatorPtr op,
+                       MakeLambdaOperator(Placeholder("x")));
+  auto operator_package_proto = std::make_shared<OperatorPackageProto>();
+  operator_package_proto->set_version(1);
+  auto* operator_proto = operator_package_proto->add_operators();
+  operator_proto->set_registration_name("foo.bar.lazy_registration");
+  ASSERT_OK_AND_ASSIGN(*operator_proto->mutable_implementation(),
+                       serialization::Encode({TypedValue::FromValue(op)}, {}));
+  // A broken operator is registered, but not decoded.
+  operator_package_proto->add_operators()->set_registration_name(
+      "foo.bar.lazy_broken");
+  EXPECT_OK(LoadOperatorPackageLazily(operator_package_proto));
+  ASSERT_OK_AND_ASSIGN(auto reg_op,
+                       LookupOperator("foo.bar.lazy_registration"));
+  ASSERT_OK_AND_ASSIGN(auto op_impl, reg_op->GetImplementation());
+  EXPECT_EQ(op_impl->fingerprint(), op->fingerprint());
+
+  ASSERT_OK_AND_ASSIGN(auto broken_op, LookupOperator("foo.bar.lazy_broken"));
+  EXPECT_THAT(broken_op->GetSignature(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("; operators[1].registration_name="
+                                 "foo.bar.lazy_broken")));
+  EXPECT_THAT(LoadOperatorPackageLazily(operator_package_proto),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       "already present in the registry: "
+                       "M.foo.bar.lazy_broken, M.foo.bar.lazy_registration"));
+}
+
 TEST_F(LoadOperatorPackageTest, ErrorAlreadyRegistered) {
   ASSERT_OK_AND_ASSIGN(ExprOperatorPtr op,
                        MakeLambdaOperator(Placeholder("x")));
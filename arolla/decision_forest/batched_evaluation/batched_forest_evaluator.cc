@@ -15,12 +15,14 @@
 #include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/log/check.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
@@ -29,12 +31,14 @@
 #include "absl/types/span.h"
 #include "arolla/array/array.h"
 #include "arolla/array/qtype/types.h"
+#include "arolla/decision_forest/batched_evaluation/batched_oblivious_evaluator.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/decision_forest/pointwise_evaluation/forest_evaluator.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qtype/array_like/array_like_qtype.h"
 #include "arolla/qtype/array_like/frame_iter.h"
@@ -42,7 +46,9 @@
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/util/cancellation_context.h"
 #include "arolla/util/indestructible.h"
+#include "arolla/util/memory_usage.h"
 #include "arolla/util/threading.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -50,6 +56,12 @@ namespace arolla {
 
 namespace {
 
+absl::Status GetCancellationStatus(
+    const CancellationContext* cancellation_context) {
+  return cancellation_context == nullptr ? absl::OkStatus()
+                                         : cancellation_context->GetStatus();
+}
+
 absl::StatusOr<TypedValue> AddFullFloatArrays(TypedRef a, TypedRef b) {
   if (a.GetType() == GetDenseArrayQType<float>() &&
       b.GetType() == GetDenseArrayQType<float>()) {
@@ -84,6 +96,49 @@ absl::StatusOr<TypedValue> AddFullFloatArrays(TypedRef a, TypedRef b) {
   }
 }
 
+// Returns a float array as Array<float>. Unlike ToFloatDenseArray, keeps the
+// sparse arrays sparse.
+absl::StatusOr<Array<float>> ToFloatArray(TypedRef array) {
+  if (array.GetType() == GetDenseArrayQType<float>()) {
+    return Array<float>(array.UnsafeAs<DenseArray<float>>());
+  } else if (array.GetType() == GetArrayQType<float>()) {
+    return array.UnsafeAs<Array<float>>();
+  } else {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("unsupported type %s, an array of floats is expected",
+                        array.GetType()->name()));
+  }
+}
+
+// Returns values of a float array as DenseArray<float>.
+absl::StatusOr<DenseArray<float>> ToFloatDenseArray(TypedRef array) {
+  if (array.GetType() == GetDenseArrayQType<float>()) {
+    return array.UnsafeAs<DenseArray<float>>();
+  } else if (array.GetType() == GetArrayQType<float>()) {
+    return array.UnsafeAs<Array<float>>().ToDenseForm().dense_data();
+  } else {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("unsupported type %s, an array of floats is expected",
+                        array.GetType()->name()));
+  }
+}
+
+// Returns the id of the only group containing the tree, -1 if there are no
+// such groups, and -2 if there are several.
+int GetTreeGroup(const DecisionTree& tree,
+                 absl::Span<const TreeFilter> groups) {
+  int group_id = -1;
+  for (int i = 0; i < groups.size(); ++i) {
+    if (groups[i](tree.tag)) {
+      if (group_id != -1) {
+        return -2;
+      }
+      group_id = i;
+    }
+  }
+  return group_id;
+}
+
 absl::StatusOr<std::vector<ForestEvaluator>> CreatePointwiseEvaluators(
     const BatchedForestEvaluator::CompilationParams& params,
     const DecisionForest& decision_forest, const std::vector<TypedSlot>& inputs,
@@ -92,9 +147,14 @@ absl::StatusOr<std::vector<ForestEvaluator>> CreatePointwiseEvaluators(
   for (const auto& tree : decision_forest.GetTrees()) {
     split_count += tree.split_nodes.size();
   }
+  int64_t splits_per_evaluator_limit = params.optimal_splits_per_evaluator;
+  if (params.splits_per_tree_parallel_evaluator > 0) {
+    splits_per_evaluator_limit = std::min(
+        splits_per_evaluator_limit, params.splits_per_tree_parallel_evaluator);
+  }
   int64_t evaluator_count = std::max<int64_t>(
-      1, (split_count + params.optimal_splits_per_evaluator - 1) /
-             params.optimal_splits_per_evaluator);
+      1, (split_count + splits_per_evaluator_limit - 1) /
+             splits_per_evaluator_limit);
 
   std::vector<ForestEvaluator> evaluators;
   evaluators.reserve(evaluator_count);
@@ -143,11 +203,42 @@ absl::StatusOr<std::vector<ForestEvaluator>> CreatePointwiseEvaluators(
 Indestructible<std::unique_ptr<ThreadingInterface>>
     BatchedForestEvaluator::threading_;
 int64_t BatchedForestEvaluator::min_rows_per_thread_;
+bool BatchedForestEvaluator::parallelize_rows_ = false;
 
 absl::StatusOr<std::unique_ptr<BatchedForestEvaluator>>
 BatchedForestEvaluator::Compile(const DecisionForest& decision_forest,
                                 absl::Span<const TreeFilter> groups,
                                 const CompilationParams& params) {
+  // Separate the trees supported by BatchedObliviousEvaluator. Trees that
+  // don't belong to exactly one group are left to the pointwise evaluators,
+  // which report the errors or skip the trees.
+  BatchedObliviousEvaluator oblivious_evaluator;
+  const DecisionForest* pointwise_forest = &decision_forest;
+  std::unique_ptr<DecisionForest> pointwise_forest_holder;
+  bool has_oblivious_trees = false;
+  if (params.enable_batched_oblivious_eval) {
+    std::vector<DecisionTree> pointwise_trees;
+    for (const DecisionTree& tree : decision_forest.GetTrees()) {
+      int group_id = GetTreeGroup(tree, groups);
+      if (group_id >= 0 &&
+          (oblivious_evaluator.AddTree(tree, group_id) ||
+           (params.enable_batched_predicated_eval &&
+            oblivious_evaluator.AddPredicatedTree(tree, group_id)))) {
+        has_oblivious_trees = true;
+      } else {
+        pointwise_trees.push_back(tree);
+      }
+    }
+    if (has_oblivious_trees && params.enable_quantized_features) {
+      oblivious_evaluator.Quantize();
+    }
+    if (has_oblivious_trees) {
+      ASSIGN_OR_RETURN(pointwise_forest_holder,
+                       DecisionForest::FromTrees(std::move(pointwise_trees)));
+      pointwise_forest = pointwise_forest_holder.get();
+    }
+  }
+
   // Construct pointwise_layout
   FrameLayout::Builder bldr;
 
@@ -155,7 +246,7 @@ BatchedForestEvaluator::Compile(const DecisionForest& decision_forest,
   TypedSlot placeholder =
       TypedSlot::FromSlot(FrameLayout::Slot<float>::UnsafeUninitializedSlot());
   std::vector<TypedSlot> input_pointwise_slots;
-  for (const auto& kv : decision_forest.GetRequiredQTypes()) {
+  for (const auto& kv : pointwise_forest->GetRequiredQTypes()) {
     TypedSlot pointwise_slot = AddSlot(kv.second, &bldr);
     while (input_pointwise_slots.size() <= kv.first) {
       input_pointwise_slots.push_back(placeholder);
@@ -177,13 +268,17 @@ BatchedForestEvaluator::Compile(const DecisionForest& decision_forest,
   auto pointwise_layout = std::move(bldr).Build();
 
   // Create evaluator
-  ASSIGN_OR_RETURN(
-      std::vector<ForestEvaluator> pointwise_evaluators,
-      CreatePointwiseEvaluators(params, decision_forest, input_pointwise_slots,
-                                pointwise_outputs));
+  std::vector<ForestEvaluator> pointwise_evaluators;
+  if (!has_oblivious_trees || !pointwise_forest->GetTrees().empty()) {
+    ASSIGN_OR_RETURN(pointwise_evaluators,
+                     CreatePointwiseEvaluators(params, *pointwise_forest,
+                                               input_pointwise_slots,
+                                               pointwise_outputs));
+  }
   return absl::WrapUnique(new BatchedForestEvaluator(
       std::move(pointwise_layout), std::move(input_slots_mapping),
-      std::move(output_pointwise_slots), std::move(pointwise_evaluators)));
+      std::move(output_pointwise_slots), std::move(pointwise_evaluators),
+      std::move(oblivious_evaluator), params));
 }
 
 absl::Status BatchedForestEvaluator::GetInputsFromSlots(
@@ -201,10 +296,46 @@ absl::Status BatchedForestEvaluator::GetInputsFromSlots(
   return absl::OkStatus();
 }
 
+ThreadingInterface* BatchedForestEvaluator::GetThreading(
+    int64_t* min_rows_per_thread) const {
+  if (threading_override_ != nullptr) {
+    *min_rows_per_thread = min_rows_per_thread_override_;
+    return threading_override_.get();
+  }
+  *min_rows_per_thread = min_rows_per_thread_;
+  return threading_->get();
+}
+
+int BatchedForestEvaluator::GetMaxThreadCount(
+    ThreadingInterface& threading) const {
+  int max_thread_count = threading.GetRecommendedThreadCount();
+  if (max_thread_count_ > 0) {
+    max_thread_count = std::min(max_thread_count, max_thread_count_);
+  }
+  return std::max(max_thread_count, 1);
+}
+
+int BatchedForestEvaluator::GetThreadCount(
+    std::optional<int64_t> row_count, ThreadingInterface** threading) const {
+  int64_t min_rows_per_thread;
+  *threading = GetThreading(&min_rows_per_thread);
+  if (*threading == nullptr || !row_count.has_value()) {
+    return 1;
+  }
+  if (threading_override_ == nullptr && !parallelize_rows_) {
+    return 1;
+  }
+  min_rows_per_thread = std::max<int64_t>(min_rows_per_thread, 1);
+  return std::clamp<int64_t>(
+      (*row_count + min_rows_per_thread - 1) / min_rows_per_thread, 1,
+      GetMaxThreadCount(**threading));
+}
+
 absl::Status BatchedForestEvaluator::EvalBatch(
     absl::Span<const TypedSlot> input_slots,
     absl::Span<const TypedSlot> output_slots, FramePtr frame,
-    RawBufferFactory* buffer_factory, std::optional<int64_t> row_count) const {
+    RawBufferFactory* buffer_factory, std::optional<int64_t> row_count,
+    CancellationContext* cancellation_context) const {
   // TODO: Try also the non-pointwise algorithm:
   //     Iterate through split nodes in the outer loop, and iterate through rows
   //     in the inner loop.
@@ -216,23 +347,23 @@ absl::Status BatchedForestEvaluator::EvalBatch(
   if (!row_count.has_value()) {
     if (!input_arrays.empty()) {
       ASSIGN_OR_RETURN(row_count, GetArraySize(input_arrays[0]));
+    } else if (!oblivious_evaluator_.IsEmpty()) {
+      ASSIGN_OR_RETURN(
+          row_count,
+          GetArraySize(TypedRef::FromSlot(
+              input_slots[oblivious_evaluator_.input_ids()[0]], frame)));
     } else if (!input_slots.empty()) {
       ASSIGN_OR_RETURN(row_count,
                        GetArraySize(TypedRef::FromSlot(input_slots[0], frame)));
     }
   }
 
-  int thread_count = 1;
-
-  // TODO: The parallel implementation work slower than single
-  // threaded one (it wasn't this way when the algorithm was implemented,
-  // probably became slower after some infrastructure changes), so we disable it
-  // for now. Need to implement a different algorithm.
-  /*if (*threading_ && row_count.has_value()) {
-    thread_count = std::clamp<int>(
-        (*row_count + min_rows_per_thread_ - 1) / min_rows_per_thread_, 1,
-        (*threading_)->GetRecommendedThreadCount());
-  }*/
+  // NOTE: The global threading splits rows between threads only if enabled
+  // explicitly in SetThreading: with StdThreading the parallel implementation
+  // is often slower than the single threaded one because of thread startup
+  // costs on every call.
+  ThreadingInterface* threading = nullptr;
+  int thread_count = GetThreadCount(row_count, &threading);
 
   // Runs given evaluator and stores the results to `frame`.
   auto run_evaluator = [&](const ForestEvaluator& eval) -> absl::Status {
@@ -241,22 +372,38 @@ absl::Status BatchedForestEvaluator::EvalBatch(
         FrameIterator::Create(
             input_arrays, {input_pointwise_slots_.data(), input_arrays.size()},
             output_slots, output_pointwise_slots_, &pointwise_layout_,
-            FrameIterator::Options{.row_count = row_count,
-                                   .frame_buffer_count = 64 * thread_count,
-                                   .buffer_factory = buffer_factory}));
+            FrameIterator::Options{
+                .row_count = row_count,
+                .frame_buffer_count = frame_buffer_count_ * thread_count,
+                .buffer_factory = buffer_factory,
+                .cancellation_context = cancellation_context}));
 
     if (thread_count > 1) {
       frame_iterator.ForEachFrame([&eval](FramePtr f) { eval.Eval(f, f); },
-                                  **threading_, thread_count);
+                                  *threading, thread_count);
     } else {
       frame_iterator.ForEachFrame([&eval](FramePtr f) { eval.Eval(f, f); });
     }
+    RETURN_IF_ERROR(GetCancellationStatus(cancellation_context));
     return frame_iterator.StoreOutput(frame);
   };
 
-  if (pointwise_evaluators_.size() == 1) {
-    return run_evaluator(pointwise_evaluators_.front());
-  } else {
+  // Small batches of a forest split into several evaluators are parallelized
+  // over the evaluators rather than over the rows.
+  int tree_thread_count = 1;
+  if (enable_tree_parallelism_ && thread_count == 1 && threading != nullptr &&
+      pointwise_evaluators_.size() > 1) {
+    tree_thread_count = std::min<int64_t>(GetMaxThreadCount(*threading),
+                                          pointwise_evaluators_.size());
+  }
+
+  if (tree_thread_count > 1) {
+    RETURN_IF_ERROR(EvalPointwiseOverTrees(input_arrays, output_slots, frame,
+                                           row_count, tree_thread_count,
+                                           *threading, cancellation_context));
+  } else if (pointwise_evaluators_.size() == 1) {
+    RETURN_IF_ERROR(run_evaluator(pointwise_evaluators_.front()));
+  } else if (pointwise_evaluators_.size() > 1) {
     std::vector<TypedValue> res_sum;
     res_sum.reserve(output_slots.size());
     RETURN_IF_ERROR(run_evaluator(pointwise_evaluators_.front()));
@@ -281,8 +428,220 @@ absl::Status BatchedForestEvaluator::EvalBatch(
                              TypedRef::FromSlot(output_slots[i], frame)));
       RETURN_IF_ERROR(full_sum.CopyToSlot(output_slots[i], frame));
     }
+  }
+  if (!oblivious_evaluator_.IsEmpty()) {
+    // The oblivious trees have inputs, so row_count is always known here.
+    DCHECK(row_count.has_value());
+    RETURN_IF_ERROR(EvalObliviousTrees(input_slots, output_slots, frame,
+                                       buffer_factory, *row_count,
+                                       thread_count, threading,
+                                       cancellation_context));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BatchedForestEvaluator::EvalPointwiseOverTrees(
+    absl::Span<const TypedRef> input_arrays,
+    absl::Span<const TypedSlot> output_slots, FramePtr frame,
+    std::optional<int64_t> row_count, int thread_count,
+    ThreadingInterface& threading,
+    CancellationContext* cancellation_context) const {
+  // Each thread stores the results of its evaluators into its own frame and
+  // accumulates them in `partial_sums`.
+  FrameLayout::Builder bldr;
+  std::vector<TypedSlot> thread_output_slots;
+  thread_output_slots.reserve(output_slots.size());
+  for (const TypedSlot& slot : output_slots) {
+    thread_output_slots.push_back(AddSlot(slot.GetType(), &bldr));
+  }
+  FrameLayout thread_layout = std::move(bldr).Build();
+
+  std::vector<std::vector<TypedValue>> partial_sums(thread_count);
+  std::vector<absl::Status> statuses(thread_count);
+  auto eval_part = [&](int thread_id) -> absl::Status {
+    MemoryAllocation alloc(&thread_layout);
+    std::vector<TypedValue>& sums = partial_sums[thread_id];
+    for (size_t eval_id = thread_id; eval_id < pointwise_evaluators_.size();
+         eval_id += thread_count) {
+      const ForestEvaluator& eval = pointwise_evaluators_[eval_id];
+      // RawBufferFactory is not required to be thread safe, so the
+      // intermediate results are always allocated on heap.
+      ASSIGN_OR_RETURN(
+          auto frame_iterator,
+          FrameIterator::Create(
+              input_arrays,
+              {input_pointwise_slots_.data(), input_arrays.size()},
+              thread_output_slots, output_pointwise_slots_,
+              &pointwise_layout_,
+              FrameIterator::Options{
+                  .row_count = row_count,
+                  .frame_buffer_count = frame_buffer_count_,
+                  .cancellation_context = cancellation_context}));
+      frame_iterator.ForEachFrame([&eval](FramePtr f) { eval.Eval(f, f); });
+      RETURN_IF_ERROR(GetCancellationStatus(cancellation_context));
+      RETURN_IF_ERROR(frame_iterator.StoreOutput(alloc.frame()));
+      for (size_t i = 0; i < thread_output_slots.size(); ++i) {
+        TypedRef result =
+            TypedRef::FromSlot(thread_output_slots[i], alloc.frame());
+        if (sums.size() == i) {
+          sums.push_back(TypedValue(result));
+        } else {
+          ASSIGN_OR_RETURN(sums[i],
+                           AddFullFloatArrays(sums[i].AsRef(), result));
+        }
+      }
+    }
     return absl::OkStatus();
+  };
+  threading.WithThreading([&] {
+    std::vector<ThreadingInterface::JoinFn> join_fns;
+    join_fns.reserve(thread_count - 1);
+    for (int thread_id = 1; thread_id < thread_count; ++thread_id) {
+      join_fns.push_back(threading.StartThread([&, thread_id] {
+        statuses[thread_id] = eval_part(thread_id);
+      }));
+    }
+    statuses[0] = eval_part(0);
+    for (auto& join_fn : join_fns) {
+      join_fn();
+    }
+  });
+  for (const absl::Status& status : statuses) {
+    RETURN_IF_ERROR(status);
+  }
+
+  // Every thread has at least one evaluator, since
+  // thread_count <= pointwise_evaluators_.size().
+  for (size_t i = 0; i < output_slots.size(); ++i) {
+    TypedValue sum = std::move(partial_sums[0][i]);
+    for (int thread_id = 1; thread_id < thread_count; ++thread_id) {
+      ASSIGN_OR_RETURN(
+          sum, AddFullFloatArrays(sum.AsRef(),
+                                  partial_sums[thread_id][i].AsRef()));
+    }
+    RETURN_IF_ERROR(sum.CopyToSlot(output_slots[i], frame));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BatchedForestEvaluator::EvalObliviousTrees(
+    absl::Span<const TypedSlot> input_slots,
+    absl::Span<const TypedSlot> output_slots, FramePtr frame,
+    RawBufferFactory* buffer_factory, int64_t row_count, int thread_count,
+    ThreadingInterface* threading,
+    CancellationContext* cancellation_context) const {
+  if (output_slots.size() != output_pointwise_slots_.size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "output slots count mismatch: expected %d, got %d",
+        output_pointwise_slots_.size(), output_slots.size()));
+  }
+  for (const TypedSlot& slot : output_slots) {
+    if (slot.GetType() != GetDenseArrayQType<float>() &&
+        slot.GetType() != GetArrayQType<float>()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "unsupported output type %s, an array of floats is expected",
+          slot.GetType()->name()));
+    }
+  }
+
+  std::vector<Array<float>> inputs;
+  inputs.reserve(oblivious_evaluator_.input_ids().size());
+  for (int input_id : oblivious_evaluator_.input_ids()) {
+    ASSIGN_OR_RETURN(
+        inputs.emplace_back(),
+        ToFloatArray(TypedRef::FromSlot(input_slots[input_id], frame)));
+    if (inputs.back().size() != row_count) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("input #%d has %d rows, but %d expected", input_id,
+                          inputs.back().size(), row_count));
+    }
+  }
+
+  if (buffer_factory == nullptr) {
+    buffer_factory = GetHeapBufferFactory();
+  }
+  std::vector<Buffer<float>::Builder> builders;
+  std::vector<float*> outputs;
+  builders.reserve(output_slots.size());
+  outputs.reserve(output_slots.size());
+  for (const TypedSlot& slot : output_slots) {
+    auto values = builders.emplace_back(row_count, buffer_factory)
+                      .GetMutableSpan();
+    if (pointwise_evaluators_.empty()) {
+      std::fill(values.begin(), values.end(), 0.0f);
+    } else {
+      ASSIGN_OR_RETURN(DenseArray<float> pointwise_result,
+                       ToFloatDenseArray(TypedRef::FromSlot(slot, frame)));
+      DCHECK(pointwise_result.IsFull());
+      absl::c_copy(pointwise_result.values.span(), values.begin());
+    }
+    outputs.push_back(values.data());
+  }
+
+  constexpr int64_t kBlockSize = BatchedObliviousEvaluator::kBlockSize;
+  // Evaluates rows [row_begin, row_end) by chunks, checking the cancellation
+  // between them.
+  auto eval_rows = [&](int64_t row_begin, int64_t row_end) {
+    constexpr int64_t kRowsPerCheck = 64 * kBlockSize;
+    for (int64_t from = row_begin; from < row_end; from += kRowsPerCheck) {
+      if (cancellation_context != nullptr &&
+          cancellation_context->SoftCheck()) {
+        return;
+      }
+      oblivious_evaluator_.Eval(inputs, from,
+                                std::min(from + kRowsPerCheck, row_end),
+                                outputs);
+    }
+  };
+  if (thread_count > 1) {
+    // Each thread processes a range of whole blocks.
+    int64_t block_count = (row_count + kBlockSize - 1) / kBlockSize;
+    int64_t rows_per_thread =
+        (block_count + thread_count - 1) / thread_count * kBlockSize;
+    auto eval_part = [&](int64_t row_begin) {
+      eval_rows(row_begin, std::min(row_begin + rows_per_thread, row_count));
+    };
+    threading->WithThreading([&] {
+      std::vector<ThreadingInterface::JoinFn> join_fns;
+      join_fns.reserve(thread_count - 1);
+      for (int64_t row_begin = rows_per_thread; row_begin < row_count;
+           row_begin += rows_per_thread) {
+        join_fns.push_back(
+            threading->StartThread([&, row_begin] { eval_part(row_begin); }));
+      }
+      eval_part(0);
+      for (auto& join_fn : join_fns) {
+        join_fn();
+      }
+    });
+  } else {
+    eval_rows(0, row_count);
+  }
+  RETURN_IF_ERROR(GetCancellationStatus(cancellation_context));
+
+  for (size_t i = 0; i < output_slots.size(); ++i) {
+    DenseArray<float> result{std::move(builders[i]).Build()};
+    if (output_slots[i].GetType() == GetDenseArrayQType<float>()) {
+      frame.Set(output_slots[i].UnsafeToSlot<DenseArray<float>>(),
+                std::move(result));
+    } else {
+      frame.Set(output_slots[i].UnsafeToSlot<Array<float>>(),
+                Array<float>(std::move(result)));
+    }
+  }
+  return absl::OkStatus();
+}
+
+size_t BatchedForestEvaluator::memory_usage() const {
+  size_t result = sizeof(*this) + VectorMemoryUsage(input_mapping_) +
+                  VectorMemoryUsage(input_pointwise_slots_) +
+                  VectorMemoryUsage(output_pointwise_slots_) +
+                  VectorMemoryUsage(pointwise_evaluators_) +
+                  oblivious_evaluator_.memory_usage();
+  for (const ForestEvaluator& evaluator : pointwise_evaluators_) {
+    result += evaluator.memory_usage();
   }
+  return result;
 }
 
 }  // namespace arolla
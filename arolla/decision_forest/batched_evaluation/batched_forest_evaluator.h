@@ -16,6 +16,7 @@
 #define AROLLA_DECISION_FOREST_BATCHED_EVALUATION_BATCHED_FOREST_EVALUATOR_H_
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -25,6 +26,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
+#include "arolla/decision_forest/batched_evaluation/batched_oblivious_evaluator.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/decision_forest/pointwise_evaluation/forest_evaluator.h"
 #include "arolla/memory/frame.h"
@@ -32,6 +34,7 @@
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/indestructible.h"
+#include "arolla/util/cancellation_context.h"
 #include "arolla/util/threading.h"
 
 namespace arolla {
@@ -42,13 +45,62 @@ class BatchedForestEvaluator {
   // Intended for benchmarks and tests to force using a specific algorithm.
   // In all other cases the default value 'CompilationParams()' should be used.
   struct CompilationParams {
-    static constexpr CompilationParams Default() { return {}; }
+    static CompilationParams Default() { return {}; }
 
     // If the total count of split nodes in a forest exceeds this number,
     // BatchedForesetEvaluator splits the forest and uses several pointwise
     // evaluators. Important for performance if the forest doesn't fit into
     // processor cache in one piece.
     int64_t optimal_splits_per_evaluator = 500000;
+
+    // Threading used by this evaluator only. Allows to isolate forests from
+    // each other, e.g. to run latency critical models on a dedicated pool.
+    // Big batches are always split between its threads, so it should be a
+    // thread pool such as WorkStealingThreading. If nullptr, the
+    // process-global threading configured via SetThreading is used.
+    std::shared_ptr<ThreadingInterface> threading = nullptr;
+
+    // Minimal number of rows per thread. Used only together with `threading`,
+    // the global threading uses the value passed to SetThreading.
+    int64_t min_rows_per_thread = 128;
+
+    // The number of frames the pointwise evaluators process at once in a
+    // single thread (see FrameIterator::Options::frame_buffer_count).
+    int64_t frame_buffer_count = 64;
+
+    // The max number of threads used by a single EvalBatch call. Zero means
+    // no limit other than threading->GetRecommendedThreadCount(). Applies to
+    // both the per-evaluator and the global threading.
+    int max_thread_count = 0;
+
+    // If true, oblivious trees with only IntervalSplitConditions (e.g.
+    // CatBoost models) are evaluated directly on the input columns in blocks
+    // of rows, bypassing the pointwise evaluators. Disabled by default: the
+    // speedup is measured only on synthetic forests (see BM_ObliviousTrees in
+    // benchmarks.cc), so the models opt in.
+    bool enable_batched_oblivious_eval = false;
+
+    // If true, non-oblivious trees with only IntervalSplitConditions and at
+    // most BatchedObliviousEvaluator::kMaxPredicatedDepth levels are also
+    // evaluated on the input columns, with branch-free predicated descent
+    // over blocks of rows. Has no effect without
+    // enable_batched_oblivious_eval.
+    bool enable_batched_predicated_eval = false;
+
+    // If true, the trees evaluated by the batched oblivious evaluator compare
+    // uint8_t/uint16_t bin codes instead of float values. Bin boundaries are
+    // derived from the forest thresholds at compile time, and the input
+    // columns are quantized once per batch. Has no effect on the trees
+    // evaluated pointwise, so also without enable_batched_oblivious_eval.
+    bool enable_quantized_features = false;
+
+    // If positive, the pointwise part of the forest is split into evaluators
+    // of at most this many split nodes, and batches that are not split
+    // between threads by rows (at most min_rows_per_thread rows, or any size
+    // if row parallelism is not enabled in SetThreading) are evaluated in
+    // parallel over the evaluators instead. Reduces latency of big forests on
+    // a few rows. Has no effect without threading.
+    int64_t splits_per_tree_parallel_evaluator = 0;
   };
 
   struct SlotMapping {
@@ -70,37 +122,68 @@ class BatchedForestEvaluator {
   // Types of input_slots should correspond to required types of the decision.
   // Sizes of arrays in input_slots should correspond to row_count. The default
   // missed value row_count means that it should be taken from the input arrays.
-  absl::Status EvalBatch(absl::Span<const TypedSlot> input_slots,
-                         absl::Span<const TypedSlot> output_slots,
-                         FramePtr frame,
-                         RawBufferFactory* = GetHeapBufferFactory(),
-                         std::optional<int64_t> row_count = {}) const;
+  // If cancellation_context is not null, it is checked between chunks of rows
+  // and the evaluation stops with its error once it is cancelled.
+  absl::Status EvalBatch(
+      absl::Span<const TypedSlot> input_slots,
+      absl::Span<const TypedSlot> output_slots, FramePtr frame,
+      RawBufferFactory* = GetHeapBufferFactory(),
+      std::optional<int64_t> row_count = {},
+      CancellationContext* cancellation_context = nullptr) const;
 
+  // Returns an estimate of the memory used by the compiled forest. The memory
+  // owned by the split conditions (e.g. sets of values) is not counted.
+  size_t memory_usage() const;
+
+  // Sets the process-global threading. Pass nullptr to disable
+  // multithreading.
+  //
+  // Big batches are split between threads only if `parallelize_rows` is true.
+  // Use it with a thread pool such as WorkStealingThreading: with
+  // StdThreading, which starts new threads on every call, the parallel
+  // implementation is often slower than the single threaded one. Without
+  // `parallelize_rows` the threading is used only for tree parallelism (see
+  // CompilationParams::splits_per_tree_parallel_evaluator).
   static void SetThreading(std::unique_ptr<ThreadingInterface> threading,
-                           int64_t min_rows_per_thread = 128) {
+                           int64_t min_rows_per_thread = 128,
+                           bool parallelize_rows = false) {
     *threading_ = std::move(threading);
     min_rows_per_thread_ = min_rows_per_thread;
+    parallelize_rows_ = parallelize_rows;
   }
 
  private:
   static ::arolla::Indestructible<std::unique_ptr<ThreadingInterface>>
       threading_;
   static int64_t min_rows_per_thread_;
+  static bool parallelize_rows_;
 
   BatchedForestEvaluator(FrameLayout&& pointwise_layout,
                          std::vector<SlotMapping>&& input_mapping,
                          std::vector<TypedSlot>&& output_pointwise_slots,
-                         std::vector<ForestEvaluator>&& pointwise_evaluators)
+                         std::vector<ForestEvaluator>&& pointwise_evaluators,
+                         BatchedObliviousEvaluator&& oblivious_evaluator,
+                         const CompilationParams& params)
       : pointwise_layout_(std::move(pointwise_layout)),
         input_mapping_(std::move(input_mapping)),
         output_pointwise_slots_(output_pointwise_slots),
-        pointwise_evaluators_(std::move(pointwise_evaluators)) {
+        pointwise_evaluators_(std::move(pointwise_evaluators)),
+        oblivious_evaluator_(std::move(oblivious_evaluator)),
+        threading_override_(params.threading),
+        min_rows_per_thread_override_(params.min_rows_per_thread),
+        max_thread_count_(params.max_thread_count),
+        frame_buffer_count_(params.frame_buffer_count),
+        enable_tree_parallelism_(params.splits_per_tree_parallel_evaluator >
+                                 0) {
     input_pointwise_slots_.reserve(input_mapping_.size());
     input_count_ = 0;
     for (const auto& m : input_mapping_) {
       input_pointwise_slots_.push_back(m.pointwise_slot);
       input_count_ = std::max(input_count_, m.input_index + 1);
     }
+    for (int input_id : oblivious_evaluator_.input_ids()) {
+      input_count_ = std::max(input_count_, input_id + 1);
+    }
   }
 
   // Gets values from input_slots and remaps it according to input_mapping_.
@@ -108,12 +191,53 @@ class BatchedForestEvaluator {
                                   ConstFramePtr frame,
                                   std::vector<TypedRef>* input_arrays) const;
 
+  // Returns the threading to use (or nullptr) and the corresponding min
+  // number of rows per thread.
+  ThreadingInterface* GetThreading(int64_t* min_rows_per_thread) const;
+
+  // Returns the max number of threads to use in a single EvalBatch call.
+  int GetMaxThreadCount(ThreadingInterface& threading) const;
+
+  // Returns the number of threads to use for the given number of rows, and
+  // the threading to use if it is more than one.
+  int GetThreadCount(std::optional<int64_t> row_count,
+                     ThreadingInterface** threading) const;
+
+  // Runs pointwise_evaluators_ distributed over `thread_count` threads and
+  // stores the sum of their results to output_slots.
+  absl::Status EvalPointwiseOverTrees(absl::Span<const TypedRef> input_arrays,
+                                      absl::Span<const TypedSlot> output_slots,
+                                      FramePtr frame,
+                                      std::optional<int64_t> row_count,
+                                      int thread_count,
+                                      ThreadingInterface& threading,
+                                      CancellationContext* cancellation_context)
+      const;
+
+  // Adds results of oblivious_evaluator_ to the outputs of the pointwise
+  // evaluators, or stores them to output_slots if there are no pointwise
+  // evaluators.
+  absl::Status EvalObliviousTrees(absl::Span<const TypedSlot> input_slots,
+                                  absl::Span<const TypedSlot> output_slots,
+                                  FramePtr frame,
+                                  RawBufferFactory* buffer_factory,
+                                  int64_t row_count, int thread_count,
+                                  ThreadingInterface* threading,
+                                  CancellationContext* cancellation_context)
+      const;
+
   FrameLayout pointwise_layout_;
   std::vector<SlotMapping> input_mapping_;
   std::vector<TypedSlot> input_pointwise_slots_;
   std::vector<TypedSlot> output_pointwise_slots_;
   int input_count_;
   std::vector<ForestEvaluator> pointwise_evaluators_;
+  BatchedObliviousEvaluator oblivious_evaluator_;
+  std::shared_ptr<ThreadingInterface> threading_override_;
+  int64_t min_rows_per_thread_override_;
+  int max_thread_count_;
+  int64_t frame_buffer_count_;
+  bool enable_tree_parallelism_;
 };
 
 }  // namespace arolla
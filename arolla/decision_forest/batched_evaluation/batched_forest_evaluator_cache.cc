@@ -0,0 +1,97 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator_cache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+namespace {
+
+Fingerprint ComputeCacheKey(
+    const DecisionForest& decision_forest, absl::Span<const TreeFilter> groups,
+    const BatchedForestEvaluator::CompilationParams& params) {
+  FingerprintHasher hasher("arolla::BatchedForestEvaluatorCache");
+  hasher.Combine(decision_forest.fingerprint()).CombineSpan(groups);
+  // The cached evaluator holds a reference to `params.threading`, so its
+  // address cannot be reused by another object while the entry is alive.
+  hasher.Combine(params.optimal_splits_per_evaluator,
+                 reinterpret_cast<uintptr_t>(params.threading.get()),
+                 params.min_rows_per_thread, params.max_thread_count,
+                 params.frame_buffer_count,
+                 params.enable_batched_oblivious_eval,
+                 params.enable_batched_predicated_eval,
+                 params.enable_quantized_features,
+                 params.splits_per_tree_parallel_evaluator);
+  return std::move(hasher).Finish();
+}
+
+}  // namespace
+
+BatchedForestEvaluatorCache::BatchedForestEvaluatorCache(size_t capacity)
+    : cache_(capacity) {}
+
+BatchedForestEvaluatorCache& BatchedForestEvaluatorCache::GetInstance() {
+  static Indestructible<BatchedForestEvaluatorCache> instance;
+  return *instance;
+}
+
+absl::StatusOr<std::shared_ptr<const BatchedForestEvaluator>>
+BatchedForestEvaluatorCache::Compile(
+    const DecisionForest& decision_forest, absl::Span<const TreeFilter> groups,
+    const BatchedForestEvaluator::CompilationParams& params) {
+  const Fingerprint key = ComputeCacheKey(decision_forest, groups, params);
+  {
+    absl::MutexLock lock(&mutex_);
+    if (const auto* evaluator = cache_.LookupOrNull(key)) {
+      ++stats_.hits;
+      return *evaluator;
+    }
+    ++stats_.misses;
+  }
+  // The lock is not held during the compilation, which can take seconds for
+  // big forests. Concurrent misses on the same key may compile the forest
+  // several times, only the first result is kept.
+  ASSIGN_OR_RETURN(auto evaluator, BatchedForestEvaluator::Compile(
+                                       decision_forest, groups, params));
+  absl::MutexLock lock(&mutex_);
+  return *cache_.Put(
+      key, std::shared_ptr<const BatchedForestEvaluator>(std::move(evaluator)));
+}
+
+BatchedForestEvaluatorCache::Stats BatchedForestEvaluatorCache::GetStats()
+    const {
+  absl::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+void BatchedForestEvaluatorCache::Clear() {
+  absl::MutexLock lock(&mutex_);
+  cache_.Clear();
+  stats_ = Stats();
+}
+
+}  // namespace arolla
@@ -0,0 +1,78 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_DECISION_FOREST_BATCHED_EVALUATION_BATCHED_FOREST_EVALUATOR_CACHE_H_
+#define AROLLA_DECISION_FOREST_BATCHED_EVALUATION_BATCHED_FOREST_EVALUATOR_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/lru_cache.h"
+
+namespace arolla {
+
+// A thread-safe bounded cache of compiled BatchedForestEvaluators.
+//
+// The entries are keyed by the forest fingerprint, the tree filter groups and
+// the compilation params, so models using the same forest (e.g. several model
+// versions sharing a submodel) share one compiled evaluator.
+class BatchedForestEvaluatorCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 64;
+
+  struct Stats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+  };
+
+  // Constructs a cache keeping up to `capacity` compiled evaluators.
+  explicit BatchedForestEvaluatorCache(size_t capacity = kDefaultCapacity);
+
+  // Process-wide cache, used by the batched decision forest operator.
+  static BatchedForestEvaluatorCache& GetInstance();
+
+  // Same as BatchedForestEvaluator::Compile, but reuses the previously
+  // compiled evaluator if possible. Errors are not cached.
+  absl::StatusOr<std::shared_ptr<const BatchedForestEvaluator>> Compile(
+      const DecisionForest& decision_forest,
+      absl::Span<const TreeFilter> groups = {{}},
+      const BatchedForestEvaluator::CompilationParams& params =
+          BatchedForestEvaluator::CompilationParams::Default());
+
+  // Returns the number of cache hits and misses since construction or the last
+  // Clear() call.
+  Stats GetStats() const;
+
+  // Removes all the entries and resets the stats. The evaluators that are
+  // still in use are not affected.
+  void Clear();
+
+ private:
+  mutable absl::Mutex mutex_;
+  LruCache<Fingerprint, std::shared_ptr<const BatchedForestEvaluator>> cache_
+      ABSL_GUARDED_BY(mutex_);
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_DECISION_FOREST_BATCHED_EVALUATION_BATCHED_FOREST_EVALUATOR_CACHE_H_
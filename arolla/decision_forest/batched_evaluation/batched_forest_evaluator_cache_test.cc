@@ -0,0 +1,111 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator_cache.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/split_conditions/interval_split_condition.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/threading.h"
+
+namespace arolla {
+namespace {
+
+absl::StatusOr<DecisionForestPtr> CreateTestForest(float threshold) {
+  constexpr auto A = DecisionTreeNodeId::AdjustmentId;
+  std::vector<DecisionTree> trees(2);
+  trees[0].tag = {.submodel_id = 0};
+  trees[0].adjustments = {0.5, 1.5};
+  trees[0].split_nodes = {{A(0), A(1), IntervalSplit(0, threshold, 10)}};
+  trees[1].tag = {.submodel_id = 1};
+  trees[1].adjustments = {-1.0, 1.0};
+  trees[1].split_nodes = {{A(0), A(1), IntervalSplit(0, 1, 5)}};
+  return DecisionForest::FromTrees(std::move(trees));
+}
+
+TEST(BatchedForestEvaluatorCache, Compile) {
+  BatchedForestEvaluatorCache cache;
+  ASSERT_OK_AND_ASSIGN(auto forest, CreateTestForest(1.5));
+  // A separately constructed but identical forest.
+  ASSERT_OK_AND_ASSIGN(auto same_forest, CreateTestForest(1.5));
+  ASSERT_OK_AND_ASSIGN(auto other_forest, CreateTestForest(2.5));
+
+  ASSERT_OK_AND_ASSIGN(auto evaluator, cache.Compile(*forest));
+  ASSERT_NE(evaluator, nullptr);
+  EXPECT_EQ(cache.GetStats().misses, 1);
+  EXPECT_EQ(cache.GetStats().hits, 0);
+
+  ASSERT_OK_AND_ASSIGN(auto same_evaluator, cache.Compile(*same_forest));
+  EXPECT_EQ(same_evaluator, evaluator);
+  EXPECT_EQ(cache.GetStats().hits, 1);
+
+  ASSERT_OK_AND_ASSIGN(auto other_evaluator, cache.Compile(*other_forest));
+  EXPECT_NE(other_evaluator, evaluator);
+
+  std::vector<TreeFilter> groups{{.submodels = {0}}, {.submodels = {1}}};
+  ASSERT_OK_AND_ASSIGN(auto grouped_evaluator, cache.Compile(*forest, groups));
+  EXPECT_NE(grouped_evaluator, evaluator);
+  ASSERT_OK_AND_ASSIGN(auto same_grouped_evaluator,
+                       cache.Compile(*forest, groups));
+  EXPECT_EQ(same_grouped_evaluator, grouped_evaluator);
+
+  BatchedForestEvaluator::CompilationParams params;
+  params.enable_batched_oblivious_eval = true;
+  ASSERT_OK_AND_ASSIGN(auto evaluator_with_params,
+                       cache.Compile(*forest, {{}}, params));
+  EXPECT_NE(evaluator_with_params, evaluator);
+
+  params = {};
+  params.threading = std::make_shared<StdThreading>(2);
+  ASSERT_OK_AND_ASSIGN(auto evaluator_with_threading,
+                       cache.Compile(*forest, {{}}, params));
+  EXPECT_NE(evaluator_with_threading, evaluator);
+
+  EXPECT_EQ(cache.GetStats().hits, 2);
+  EXPECT_EQ(cache.GetStats().misses, 5);
+}
+
+TEST(BatchedForestEvaluatorCache, Clear) {
+  BatchedForestEvaluatorCache cache;
+  ASSERT_OK_AND_ASSIGN(auto forest, CreateTestForest(1.5));
+  ASSERT_OK_AND_ASSIGN(auto evaluator, cache.Compile(*forest));
+  cache.Clear();
+  EXPECT_EQ(cache.GetStats().misses, 0);
+  ASSERT_OK_AND_ASSIGN(auto recompiled_evaluator, cache.Compile(*forest));
+  EXPECT_NE(recompiled_evaluator, evaluator);
+  EXPECT_EQ(cache.GetStats().misses, 1);
+}
+
+TEST(BatchedForestEvaluatorCache, Capacity) {
+  BatchedForestEvaluatorCache cache(/*capacity=*/1);
+  ASSERT_OK_AND_ASSIGN(auto forest, CreateTestForest(1.5));
+  ASSERT_OK_AND_ASSIGN(auto other_forest, CreateTestForest(2.5));
+  ASSERT_OK_AND_ASSIGN(auto evaluator, cache.Compile(*forest));
+  ASSERT_OK_AND_ASSIGN(auto other_evaluator, cache.Compile(*other_forest));
+  // The first entry was evicted, but the evaluator is still alive.
+  ASSERT_OK_AND_ASSIGN(auto recompiled_evaluator, cache.Compile(*forest));
+  EXPECT_NE(recompiled_evaluator, evaluator);
+  EXPECT_EQ(cache.GetStats().misses, 3);
+}
+
+}  // namespace
+}  // namespace arolla
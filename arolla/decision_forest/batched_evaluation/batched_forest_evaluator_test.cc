@@ -14,10 +14,12 @@
 //
 #include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator.h"
 
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -25,6 +27,7 @@
 #include "gtest/gtest.h"
 #include "absl/random/distributions.h"
 #include "absl/random/random.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "arolla/array/array.h"
 #include "arolla/array/qtype/types.h"
@@ -36,12 +39,18 @@
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/threading.h"
 
 namespace arolla {
 namespace {
 
+using ::arolla::testing::StatusIs;
+
 absl::StatusOr<DecisionForestPtr> CreateTestForest() {
   constexpr float kInf = std::numeric_limits<float>::infinity();
   constexpr auto S = DecisionTreeNodeId::SplitNodeId;
@@ -59,6 +68,25 @@ absl::StatusOr<DecisionForestPtr> CreateTestForest() {
   return DecisionForest::FromTrees(std::move(trees));
 }
 
+// StdThreading that counts started threads.
+class CountingThreading final : public ThreadingInterface {
+ public:
+  explicit CountingThreading(int thread_count) : threading_(thread_count) {}
+
+  int GetRecommendedThreadCount() const final {
+    return threading_.GetRecommendedThreadCount();
+  }
+  JoinFn StartThread(TaskFn fn) final {
+    ++started_thread_count;
+    return threading_.StartThread(std::move(fn));
+  }
+
+  std::atomic<int> started_thread_count = 0;
+
+ private:
+  StdThreading threading_;
+};
+
 TEST(BatchedForestEvaluator, EvalBatch) {
   ASSERT_OK_AND_ASSIGN(auto forest, CreateTestForest());
   std::vector<TreeFilter> groups{{.submodels = {0}}, {.submodels = {1}}};
@@ -111,6 +139,26 @@ TEST(BatchedForestEvaluator, EvalBatch) {
 
   {  // multithreading enabled, 2 threads are used.
     BatchedForestEvaluator::SetThreading(std::make_unique<StdThreading>(2),
+                                         /*min_rows_per_thread=*/1,
+                                         /*parallelize_rows=*/true);
+    ASSERT_OK(eval->EvalBatch(
+        {TypedSlot::FromSlot(in1_slot), TypedSlot::FromSlot(in2_slot)},
+        {TypedSlot::FromSlot(out1_slot), TypedSlot::FromSlot(out2_slot)},
+        frame));
+    EXPECT_THAT(frame.Get(out1_slot),
+                ::testing::ElementsAre(0.5, 2.5, 2.5, 3.5, 3.5, 1.5, 0.5));
+    EXPECT_THAT(frame.Get(out2_slot),
+                ::testing::ElementsAre(-1, -1, 1, 1, -1, -1, -1));
+    BatchedForestEvaluator::SetThreading(nullptr);
+  }
+
+  frame.Set(out1_slot, DenseArray<float>());
+  frame.Set(out2_slot, DenseArray<float>());
+
+  {  // multithreading enabled without row parallelism: no threads started.
+    auto threading = std::make_unique<CountingThreading>(2);
+    auto* threading_ptr = threading.get();
+    BatchedForestEvaluator::SetThreading(std::move(threading),
                                          /*min_rows_per_thread=*/1);
     ASSERT_OK(eval->EvalBatch(
         {TypedSlot::FromSlot(in1_slot), TypedSlot::FromSlot(in2_slot)},
@@ -120,6 +168,25 @@ TEST(BatchedForestEvaluator, EvalBatch) {
                 ::testing::ElementsAre(0.5, 2.5, 2.5, 3.5, 3.5, 1.5, 0.5));
     EXPECT_THAT(frame.Get(out2_slot),
                 ::testing::ElementsAre(-1, -1, 1, 1, -1, -1, -1));
+    EXPECT_EQ(threading_ptr->started_thread_count, 0);
+    BatchedForestEvaluator::SetThreading(nullptr);
+  }
+
+  frame.Set(out1_slot, DenseArray<float>());
+  frame.Set(out2_slot, DenseArray<float>());
+
+  {  // multithreading enabled with a thread pool.
+    BatchedForestEvaluator::SetThreading(
+        std::make_unique<WorkStealingThreading>(2),
+        /*min_rows_per_thread=*/1, /*parallelize_rows=*/true);
+    ASSERT_OK(eval->EvalBatch(
+        {TypedSlot::FromSlot(in1_slot), TypedSlot::FromSlot(in2_slot)},
+        {TypedSlot::FromSlot(out1_slot), TypedSlot::FromSlot(out2_slot)},
+        frame));
+    EXPECT_THAT(frame.Get(out1_slot),
+                ::testing::ElementsAre(0.5, 2.5, 2.5, 3.5, 3.5, 1.5, 0.5));
+    EXPECT_THAT(frame.Get(out2_slot),
+                ::testing::ElementsAre(-1, -1, 1, 1, -1, -1, -1));
     BatchedForestEvaluator::SetThreading(nullptr);
   }
 }
@@ -259,5 +326,505 @@ TEST(BatchedForestEvaluator, SplitCountPerEvaluator) {
   }
 }
 
+TEST(BatchedForestEvaluator, FrameBufferCount) {
+  constexpr int64_t batch_size = 100;
+
+  absl::BitGen rnd;
+  auto forest =
+      CreateRandomFloatForest(&rnd, /*num_features=*/10, /*interactions=*/true,
+                              /*min_num_splits=*/0, /*max_num_splits=*/10,
+                              /*num_trees=*/10);
+  ASSERT_OK_AND_ASSIGN(auto evaluator,
+                       BatchedForestEvaluator::Compile(*forest));
+  // The rows are processed in several chunks, the result should be the same.
+  ASSERT_OK_AND_ASSIGN(auto small_buffer_evaluator,
+                       BatchedForestEvaluator::Compile(
+                           *forest, {TreeFilter()},
+                           {.frame_buffer_count = 7,
+                            .enable_batched_oblivious_eval = false}));
+
+  std::vector<TypedSlot> slots;
+  FrameLayout::Builder layout_builder;
+  ASSERT_OK(CreateArraySlotsForForest(*forest, &layout_builder, &slots));
+  auto output_slot = layout_builder.AddSlot<DenseArray<float>>();
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation ctx(&layout);
+  FramePtr frame = ctx.frame();
+  for (auto slot : slots) {
+    ASSERT_OK(FillArrayWithRandomValues(batch_size, slot, frame, &rnd));
+  }
+
+  ASSERT_OK(evaluator->EvalBatch(slots, {TypedSlot::FromSlot(output_slot)},
+                                 frame, nullptr, batch_size));
+  DenseArray<float> expected = frame.Get(output_slot);
+  ASSERT_OK(small_buffer_evaluator->EvalBatch(
+      slots, {TypedSlot::FromSlot(output_slot)}, frame, nullptr, batch_size));
+  DenseArray<float> actual = frame.Get(output_slot);
+  ASSERT_EQ(actual.size(), batch_size);
+  for (int64_t i = 0; i < batch_size; ++i) {
+    EXPECT_EQ(actual[i].present, expected[i].present);
+    if (expected[i].present) {
+      EXPECT_FLOAT_EQ(actual[i].value, expected[i].value);
+    }
+  }
+}
+
+TEST(BatchedForestEvaluator, TreeParallelism) {
+  constexpr int64_t num_trees = 100;
+  constexpr int64_t batch_size = 5;
+  absl::BitGen rnd;
+  auto random_forest =
+      CreateRandomForest(&rnd, /*num_features=*/10, /*interactions=*/true,
+                         /*min_num_splits=*/10, /*max_num_splits=*/30,
+                         num_trees);
+  std::vector<DecisionTree> trees(random_forest->GetTrees().begin(),
+                                  random_forest->GetTrees().end());
+  for (int i = 0; i < trees.size(); ++i) {
+    trees[i].tag.submodel_id = i % 2;
+  }
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  std::vector<TreeFilter> groups = {{.submodels = {0}}, {.submodels = {1}}};
+
+  std::vector<TypedSlot> slots;
+  FrameLayout::Builder layout_builder;
+  ASSERT_OK(CreateArraySlotsForForest(*forest, &layout_builder, &slots));
+  auto out1_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto out2_slot = layout_builder.AddSlot<Array<float>>();
+  std::vector<TypedSlot> output_slots = {TypedSlot::FromSlot(out1_slot),
+                                         TypedSlot::FromSlot(out2_slot)};
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation ctx(&layout);
+  FramePtr frame = ctx.frame();
+  for (auto slot : slots) {
+    ASSERT_OK(FillArrayWithRandomValues(batch_size, slot, frame, &rnd));
+  }
+
+  ASSERT_OK_AND_ASSIGN(auto evaluator,
+                       BatchedForestEvaluator::Compile(*forest, groups));
+  ASSERT_OK(
+      evaluator->EvalBatch(slots, output_slots, frame, nullptr, batch_size));
+  DenseArray<float> expected1 = frame.Get(out1_slot);
+  Array<float> expected2 = frame.Get(out2_slot);
+  ASSERT_TRUE(expected1.IsFull());
+  ASSERT_TRUE(expected2.IsFullForm());
+
+  // 2 threads for 7-8 evaluators, 3 threads for more evaluators than
+  // threads, 16 threads for less evaluators than threads.
+  for (auto [thread_count, splits_per_evaluator] :
+       std::vector<std::pair<int, int64_t>>{{2, 300}, {3, 200}, {16, 1000}}) {
+    ASSERT_OK_AND_ASSIGN(
+        auto parallel_evaluator,
+        BatchedForestEvaluator::Compile(
+            *forest, groups,
+            {.threading = std::make_shared<StdThreading>(thread_count),
+             .splits_per_tree_parallel_evaluator = splits_per_evaluator}));
+    frame.Set(out1_slot, DenseArray<float>());
+    frame.Set(out2_slot, Array<float>());
+    ASSERT_OK(parallel_evaluator->EvalBatch(slots, output_slots, frame,
+                                            nullptr, batch_size));
+    DenseArray<float> res1 = frame.Get(out1_slot);
+    Array<float> res2 = frame.Get(out2_slot);
+    ASSERT_EQ(res1.size(), batch_size);
+    ASSERT_EQ(res2.size(), batch_size);
+    for (int64_t i = 0; i < batch_size; ++i) {
+      EXPECT_FLOAT_EQ(res1[i].value, expected1[i].value);
+      EXPECT_FLOAT_EQ(res2[i].value, expected2[i].value);
+    }
+  }
+}
+
+TEST(BatchedForestEvaluator, ObliviousTrees) {
+  constexpr int64_t batch_size = 101;  // Not a multiple of the block size.
+  absl::BitGen rnd;
+
+  // Oblivious trees with only float features are evaluated by the batched
+  // oblivious evaluator, the rest by the pointwise evaluators.
+  std::vector<QTypePtr> float_types(5, GetOptionalQType<float>());
+  std::vector<QTypePtr> mixed_types = float_types;
+  mixed_types.resize(10, GetOptionalQType<int64_t>());
+  std::vector<DecisionTree> trees;
+  for (int i = 0; i < 30; ++i) {
+    int depth = absl::Uniform<int>(rnd, 1, 9);
+    trees.push_back(i % 3 == 0
+                        ? CreateRandomObliviousTree(&rnd, depth, &mixed_types)
+                        : CreateRandomObliviousTree(&rnd, depth, &float_types));
+    trees.back().tag.submodel_id = i % 2;
+    trees.back().weight = absl::Uniform<float>(rnd, 0.5, 1.5);
+  }
+  trees.push_back(CreateRandomTree(&rnd, /*interactions=*/true,
+                                   /*num_splits=*/20, &mixed_types));
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  std::vector<TreeFilter> groups{{.submodels = {0}}, {.submodels = {1}}};
+
+  ASSERT_OK_AND_ASSIGN(auto reference_eval,
+                       BatchedForestEvaluator::Compile(
+                           *forest, groups,
+                           {.enable_batched_oblivious_eval = false}));
+  ASSERT_OK_AND_ASSIGN(auto eval,
+                       BatchedForestEvaluator::Compile(
+                           *forest, groups,
+                           {.enable_batched_oblivious_eval = true}));
+  ASSERT_OK_AND_ASSIGN(auto quantized_eval,
+                       BatchedForestEvaluator::Compile(
+                           *forest, groups,
+                           {.enable_batched_oblivious_eval = true,
+                            .enable_quantized_features = true}));
+
+  std::vector<TypedSlot> slots;
+  FrameLayout::Builder layout_builder;
+  ASSERT_OK(CreateArraySlotsForForest(*forest, &layout_builder, &slots));
+  auto expected1_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto expected2_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto out1_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto out2_slot = layout_builder.AddSlot<Array<float>>();
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  for (auto slot : slots) {
+    ASSERT_OK(FillArrayWithRandomValues(batch_size, slot, frame, &rnd,
+                                        /*missed_prob=*/0.25));
+  }
+
+  ASSERT_OK(reference_eval->EvalBatch(slots,
+                                      {TypedSlot::FromSlot(expected1_slot),
+                                       TypedSlot::FromSlot(expected2_slot)},
+                                      frame));
+  const DenseArray<float>& expected1 = frame.Get(expected1_slot);
+  const DenseArray<float>& expected2 = frame.Get(expected2_slot);
+
+  for (int thread_count : {1, 3}) {
+    for (const auto* evaluator : {eval.get(), quantized_eval.get()}) {
+      BatchedForestEvaluator::SetThreading(
+          std::make_unique<StdThreading>(thread_count),
+          /*min_rows_per_thread=*/1, /*parallelize_rows=*/true);
+      ASSERT_OK(evaluator->EvalBatch(
+          slots,
+          {TypedSlot::FromSlot(out1_slot), TypedSlot::FromSlot(out2_slot)},
+          frame));
+      const DenseArray<float>& out1 = frame.Get(out1_slot);
+      const Array<float>& out2 = frame.Get(out2_slot);
+      ASSERT_EQ(out1.size(), batch_size);
+      ASSERT_EQ(out2.size(), batch_size);
+      for (int64_t i = 0; i < batch_size; ++i) {
+        EXPECT_FLOAT_EQ(out1[i].value, expected1[i].value);
+        EXPECT_FLOAT_EQ(out2[i].value, expected2[i].value);
+      }
+    }
+  }
+  BatchedForestEvaluator::SetThreading(nullptr);
+}
+
+TEST(BatchedForestEvaluator, PredicatedTrees) {
+  constexpr int64_t batch_size = 101;  // Not a multiple of the block size.
+  absl::BitGen rnd;
+
+  // Shallow float trees are evaluated with predicated descent, the deep tree
+  // and the trees with other features by the pointwise evaluators.
+  std::vector<QTypePtr> mixed_types(5, GetOptionalQType<float>());
+  mixed_types.resize(10, GetOptionalQType<int64_t>());
+  std::vector<DecisionTree> trees;
+  for (int i = 0; i < 30; ++i) {
+    int num_splits = absl::Uniform<int>(rnd, 1, 40);
+    trees.push_back(i % 5 == 0
+                        ? CreateRandomTree(&rnd, /*interactions=*/true,
+                                           num_splits, &mixed_types)
+                        : CreateRandomFloatTree(&rnd, /*num_features=*/5,
+                                                /*interactions=*/true,
+                                                num_splits,
+                                                /*range_split_prob=*/0.3));
+    trees.back().tag.submodel_id = i % 2;
+    trees.back().weight = absl::Uniform<float>(rnd, 0.5, 1.5);
+  }
+  trees.push_back(CreateRandomFloatTree(&rnd, /*num_features=*/5,
+                                        /*interactions=*/true,
+                                        /*num_splits=*/5000));
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  std::vector<TreeFilter> groups{{.submodels = {0}}, {.submodels = {1}}};
+
+  ASSERT_OK_AND_ASSIGN(auto reference_eval,
+                       BatchedForestEvaluator::Compile(
+                           *forest, groups,
+                           {.enable_batched_oblivious_eval = false}));
+  ASSERT_OK_AND_ASSIGN(auto eval,
+                       BatchedForestEvaluator::Compile(
+                           *forest, groups,
+                           {.enable_batched_oblivious_eval = true,
+                            .enable_batched_predicated_eval = true}));
+  ASSERT_OK_AND_ASSIGN(auto quantized_eval,
+                       BatchedForestEvaluator::Compile(
+                           *forest, groups,
+                           {.enable_batched_oblivious_eval = true,
+                            .enable_batched_predicated_eval = true,
+                            .enable_quantized_features = true}));
+
+  std::vector<TypedSlot> slots;
+  FrameLayout::Builder layout_builder;
+  ASSERT_OK(CreateArraySlotsForForest(*forest, &layout_builder, &slots));
+  auto expected1_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto expected2_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto out1_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto out2_slot = layout_builder.AddSlot<Array<float>>();
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  for (auto slot : slots) {
+    ASSERT_OK(FillArrayWithRandomValues(batch_size, slot, frame, &rnd,
+                                        /*missed_prob=*/0.25));
+  }
+
+  ASSERT_OK(reference_eval->EvalBatch(slots,
+                                      {TypedSlot::FromSlot(expected1_slot),
+                                       TypedSlot::FromSlot(expected2_slot)},
+                                      frame));
+  const DenseArray<float>& expected1 = frame.Get(expected1_slot);
+  const DenseArray<float>& expected2 = frame.Get(expected2_slot);
+
+  for (int thread_count : {1, 3}) {
+    for (const auto* evaluator : {eval.get(), quantized_eval.get()}) {
+      BatchedForestEvaluator::SetThreading(
+          std::make_unique<StdThreading>(thread_count),
+          /*min_rows_per_thread=*/1, /*parallelize_rows=*/true);
+      ASSERT_OK(evaluator->EvalBatch(
+          slots,
+          {TypedSlot::FromSlot(out1_slot), TypedSlot::FromSlot(out2_slot)},
+          frame));
+      const DenseArray<float>& out1 = frame.Get(out1_slot);
+      const Array<float>& out2 = frame.Get(out2_slot);
+      ASSERT_EQ(out1.size(), batch_size);
+      ASSERT_EQ(out2.size(), batch_size);
+      for (int64_t i = 0; i < batch_size; ++i) {
+        EXPECT_FLOAT_EQ(out1[i].value, expected1[i].value);
+        EXPECT_FLOAT_EQ(out2[i].value, expected2[i].value);
+      }
+    }
+  }
+  BatchedForestEvaluator::SetThreading(nullptr);
+}
+
+TEST(BatchedForestEvaluator, PredicatedTreeWithMissingValues) {
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  constexpr auto S = DecisionTreeNodeId::SplitNodeId;
+  constexpr auto A = DecisionTreeNodeId::AdjustmentId;
+  // Not oblivious: the left subtree is one level deeper than the right one.
+  DecisionTree tree;
+  tree.adjustments = {0, 1, 2};
+  tree.split_nodes = {{S(1), A(2), IntervalSplit(0, 1, kInf)},
+                      {A(0), A(1), IntervalSplit(1, -kInf, 0)}};
+  ASSERT_OK_AND_ASSIGN(auto forest, DecisionForest::FromTrees({tree}));
+
+  FrameLayout::Builder bldr;
+  auto in1_slot = bldr.AddSlot<Array<float>>();
+  auto in2_slot = bldr.AddSlot<DenseArray<float>>();
+  auto out_slot = bldr.AddSlot<DenseArray<float>>();
+  FrameLayout layout = std::move(bldr).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+
+  frame.Set(in1_slot, CreateArray<float>({0, 2, 0, {}, NAN, 1, 0}));
+  frame.Set(in2_slot, CreateDenseArray<float>({-1, {}, 1, -1, {}, 0, -kInf}));
+  for (bool quantized : {false, true}) {
+    ASSERT_OK_AND_ASSIGN(auto eval,
+                         BatchedForestEvaluator::Compile(
+                             *forest, {TreeFilter()},
+                             {.enable_batched_oblivious_eval = true,
+                              .enable_batched_predicated_eval = true,
+                              .enable_quantized_features = quantized}));
+    ASSERT_OK(eval->EvalBatch(
+        {TypedSlot::FromSlot(in1_slot), TypedSlot::FromSlot(in2_slot)},
+        {TypedSlot::FromSlot(out_slot)}, frame));
+    EXPECT_THAT(frame.Get(out_slot),
+                ::testing::ElementsAre(1, 2, 0, 1, 0, 2, 1));
+  }
+}
+
+TEST(BatchedForestEvaluator, SparseArrayInputs) {
+  constexpr int64_t batch_size = 203;
+  absl::BitGen rnd;
+
+  std::vector<QTypePtr> float_types(5, GetOptionalQType<float>());
+  std::vector<DecisionTree> trees;
+  for (int i = 0; i < 20; ++i) {
+    if (i % 2 == 0) {
+      int depth = absl::Uniform<int>(rnd, 1, 9);
+      trees.push_back(CreateRandomObliviousTree(&rnd, depth, &float_types));
+    } else {
+      int num_splits = absl::Uniform<int>(rnd, 1, 40);
+      trees.push_back(CreateRandomFloatTree(&rnd, /*num_features=*/5,
+                                            /*interactions=*/true, num_splits,
+                                            /*range_split_prob=*/0.3));
+    }
+    trees.back().tag.submodel_id = i % 2;
+  }
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  std::vector<TreeFilter> groups{{.submodels = {0}}, {.submodels = {1}}};
+
+  // Present values only in a few clusters of rows, so most of the blocks
+  // contain only missing ids.
+  auto create_sparse_array = [&](OptionalValue<float> missing_id_value) {
+    std::vector<OptionalValue<float>> values(batch_size, missing_id_value);
+    for (int64_t begin : {3, 40, 190}) {
+      for (int64_t i = begin; i < begin + 10; ++i) {
+        if (absl::Uniform<float>(rnd, 0, 1) < 0.8) {
+          values[i] = absl::Uniform<float>(rnd, 0, 1);
+        } else {
+          values[i] = std::nullopt;
+        }
+      }
+    }
+    return CreateArray<float>(values).ToSparseForm(missing_id_value);
+  };
+
+  FrameLayout::Builder layout_builder;
+  std::vector<TypedSlot> slots;
+  for (int i = 0; i < 5; ++i) {
+    slots.push_back(
+        TypedSlot::FromSlot(layout_builder.AddSlot<Array<float>>()));
+  }
+  auto expected1_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto expected2_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto out1_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto out2_slot = layout_builder.AddSlot<DenseArray<float>>();
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  frame.Set(slots[0].UnsafeToSlot<Array<float>>(),
+            create_sparse_array(std::nullopt));
+  frame.Set(slots[1].UnsafeToSlot<Array<float>>(), create_sparse_array(0.5));
+  frame.Set(slots[2].UnsafeToSlot<Array<float>>(),
+            create_sparse_array(std::nullopt));
+  frame.Set(slots[3].UnsafeToSlot<Array<float>>(),
+            Array<float>(batch_size, 0.25));
+  frame.Set(slots[4].UnsafeToSlot<Array<float>>(), Array<float>(batch_size));
+  ASSERT_TRUE(frame.Get(slots[0].UnsafeToSlot<Array<float>>()).IsSparseForm());
+
+  ASSERT_OK_AND_ASSIGN(auto reference_eval,
+                       BatchedForestEvaluator::Compile(
+                           *forest, groups,
+                           {.enable_batched_oblivious_eval = false}));
+  ASSERT_OK(reference_eval->EvalBatch(slots,
+                                      {TypedSlot::FromSlot(expected1_slot),
+                                       TypedSlot::FromSlot(expected2_slot)},
+                                      frame));
+  const DenseArray<float>& expected1 = frame.Get(expected1_slot);
+  const DenseArray<float>& expected2 = frame.Get(expected2_slot);
+
+  for (bool quantized : {false, true}) {
+    ASSERT_OK_AND_ASSIGN(auto eval,
+                         BatchedForestEvaluator::Compile(
+                             *forest, groups,
+                             {.enable_batched_oblivious_eval = true,
+                              .enable_batched_predicated_eval = true,
+                              .enable_quantized_features = quantized}));
+    for (int thread_count : {1, 3}) {
+      BatchedForestEvaluator::SetThreading(
+          std::make_unique<StdThreading>(thread_count),
+          /*min_rows_per_thread=*/1, /*parallelize_rows=*/true);
+      ASSERT_OK(eval->EvalBatch(
+          slots,
+          {TypedSlot::FromSlot(out1_slot), TypedSlot::FromSlot(out2_slot)},
+          frame));
+      const DenseArray<float>& out1 = frame.Get(out1_slot);
+      const DenseArray<float>& out2 = frame.Get(out2_slot);
+      ASSERT_EQ(out1.size(), batch_size);
+      ASSERT_EQ(out2.size(), batch_size);
+      for (int64_t i = 0; i < batch_size; ++i) {
+        EXPECT_FLOAT_EQ(out1[i].value, expected1[i].value);
+        EXPECT_FLOAT_EQ(out2[i].value, expected2[i].value);
+      }
+    }
+  }
+  BatchedForestEvaluator::SetThreading(nullptr);
+}
+
+TEST(BatchedForestEvaluator, ObliviousTreesOnly) {
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  constexpr auto S = DecisionTreeNodeId::SplitNodeId;
+  constexpr auto A = DecisionTreeNodeId::AdjustmentId;
+  DecisionTree tree;
+  tree.adjustments = {0, 1, 2, 3};
+  tree.split_nodes = {{S(1), S(2), IntervalSplit(0, 1, kInf)},
+                      {A(0), A(1), IntervalSplit(1, -kInf, 0)},
+                      {A(2), A(3), IntervalSplit(1, -kInf, 0)}};
+  ASSERT_OK_AND_ASSIGN(auto forest, DecisionForest::FromTrees({tree}));
+
+  FrameLayout::Builder bldr;
+  auto in1_slot = bldr.AddSlot<Array<float>>();
+  auto in2_slot = bldr.AddSlot<DenseArray<float>>();
+  auto out_slot = bldr.AddSlot<DenseArray<float>>();
+  auto int_out_slot = bldr.AddSlot<DenseArray<int64_t>>();
+  FrameLayout layout = std::move(bldr).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+
+  frame.Set(in1_slot, CreateArray<float>({0, 2, 2, {}, NAN, 1, kInf}));
+  frame.Set(in2_slot,
+            CreateDenseArray<float>({-1, -1, 1, -1, {}, 0, -kInf}));
+  for (bool quantized : {false, true}) {
+    ASSERT_OK_AND_ASSIGN(auto eval,
+                         BatchedForestEvaluator::Compile(
+                             *forest, {TreeFilter()},
+                             {.enable_batched_oblivious_eval = true,
+                              .enable_quantized_features = quantized}));
+    ASSERT_OK(eval->EvalBatch(
+        {TypedSlot::FromSlot(in1_slot), TypedSlot::FromSlot(in2_slot)},
+        {TypedSlot::FromSlot(out_slot)}, frame));
+    EXPECT_THAT(frame.Get(out_slot),
+                ::testing::ElementsAre(1, 3, 2, 1, 0, 3, 3));
+  }
+
+  ASSERT_OK_AND_ASSIGN(auto eval,
+                       BatchedForestEvaluator::Compile(
+                           *forest, {TreeFilter()},
+                           {.enable_batched_oblivious_eval = true}));
+
+  EXPECT_THAT(
+      eval->EvalBatch(
+          {TypedSlot::FromSlot(in1_slot), TypedSlot::FromSlot(in2_slot)},
+          {TypedSlot::FromSlot(int_out_slot)}, frame),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               ::testing::HasSubstr("unsupported output type")));
+  frame.Set(in2_slot, CreateDenseArray<float>({-1, -1}));
+  EXPECT_THAT(
+      eval->EvalBatch(
+          {TypedSlot::FromSlot(in1_slot), TypedSlot::FromSlot(in2_slot)},
+          {TypedSlot::FromSlot(out_slot)}, frame),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               "input #1 has 2 rows, but 7 expected"));
+}
+
+TEST(BatchedForestEvaluator, QuantizedFeaturesWithManyThresholds) {
+  constexpr auto A = DecisionTreeNodeId::AdjustmentId;
+  // 200 distinct thresholds don't fit into uint8_t bin codes.
+  std::vector<DecisionTree> trees(200);
+  for (int i = 0; i < trees.size(); ++i) {
+    trees[i].adjustments = {0, 1};
+    trees[i].split_nodes = {{A(0), A(1), IntervalSplit(0, i, i + 0.5)}};
+  }
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  ASSERT_OK_AND_ASSIGN(auto eval,
+                       BatchedForestEvaluator::Compile(
+                           *forest, {TreeFilter()},
+                           {.enable_batched_oblivious_eval = true,
+                            .enable_quantized_features = true}));
+
+  FrameLayout::Builder bldr;
+  auto in_slot = bldr.AddSlot<DenseArray<float>>();
+  auto out_slot = bldr.AddSlot<DenseArray<float>>();
+  FrameLayout layout = std::move(bldr).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+
+  frame.Set(in_slot,
+            CreateDenseArray<float>({-1, 0, 0.25, 0.75, 150.5, 199.7, 250}));
+  ASSERT_OK(eval->EvalBatch({TypedSlot::FromSlot(in_slot)},
+                            {TypedSlot::FromSlot(out_slot)}, frame));
+  EXPECT_THAT(frame.Get(out_slot), ::testing::ElementsAre(0, 1, 1, 0, 1, 0, 0));
+}
+
 }  // namespace
 }  // namespace arolla
@@ -0,0 +1,475 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/batched_evaluation/batched_oblivious_evaluator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/log/check.h"
+#include "absl/types/span.h"
+#include "arolla/array/array.h"
+#include "arolla/array/id_filter.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/pointwise_evaluation/oblivious.h"
+#include "arolla/decision_forest/split_conditions/interval_split_condition.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/util/fast_dynamic_downcast_final.h"
+#include "arolla/util/memory_usage.h"
+
+namespace arolla {
+
+bool BatchedObliviousEvaluator::AddTree(const DecisionTree& tree,
+                                        int group_id) {
+  auto oblivious = ToObliviousTree(tree);
+  if (!oblivious.has_value() || oblivious->layer_splits.empty() ||
+      oblivious->layer_splits.size() > kMaxDepth) {
+    return false;
+  }
+  std::vector<const IntervalSplitCondition*> conditions;
+  conditions.reserve(oblivious->layer_splits.size());
+  for (const auto& split : oblivious->layer_splits) {
+    auto* interval =
+        fast_dynamic_downcast_final<const IntervalSplitCondition*>(
+            split.get());
+    if (interval == nullptr) {
+      return false;
+    }
+    conditions.push_back(interval);
+  }
+
+  trees_.push_back({.group_id = group_id,
+                    .first_layer = layers_.size(),
+                    .layer_count = conditions.size(),
+                    .first_adjustment = adjustments_.size()});
+  for (const IntervalSplitCondition* cond : conditions) {
+    layers_.push_back(
+        {AddInput(cond->input_id()), cond->left(), cond->right()});
+  }
+  adjustments_.insert(adjustments_.end(), oblivious->adjustments.begin(),
+                      oblivious->adjustments.end());
+  return true;
+}
+
+bool BatchedObliviousEvaluator::AddPredicatedTree(const DecisionTree& tree,
+                                                  int group_id) {
+  if (tree.split_nodes.empty()) {
+    return false;
+  }
+  std::vector<const IntervalSplitCondition*> conditions;
+  conditions.reserve(tree.split_nodes.size());
+  for (const SplitNode& node : tree.split_nodes) {
+    auto* interval =
+        fast_dynamic_downcast_final<const IntervalSplitCondition*>(
+            node.condition.get());
+    if (interval == nullptr) {
+      return false;
+    }
+    conditions.push_back(interval);
+  }
+  // Depth-first pass computing the maximal number of splits on a path.
+  size_t depth = 0;
+  std::vector<std::pair<int64_t, size_t>> stack = {{0, 1}};
+  while (!stack.empty()) {
+    auto [split_id, split_depth] = stack.back();
+    stack.pop_back();
+    if (split_depth > kMaxPredicatedDepth) {
+      return false;
+    }
+    depth = std::max(depth, split_depth);
+    const SplitNode& node = tree.split_nodes[split_id];
+    for (DecisionTreeNodeId child : {node.child_if_false, node.child_if_true}) {
+      if (!child.is_leaf()) {
+        stack.push_back({child.split_node_index(), split_depth + 1});
+      }
+    }
+  }
+
+  // Splits are stored first, then leaves.
+  const size_t first_node = nodes_.size();
+  const size_t first_leaf = first_node + tree.split_nodes.size();
+  if (first_leaf + tree.adjustments.size() >
+      std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  auto to_node_index = [&](DecisionTreeNodeId id) {
+    return static_cast<uint32_t>(
+        id.is_leaf() ? first_leaf + id.adjustment_index()
+                     : first_node + id.split_node_index());
+  };
+  for (size_t i = 0; i < tree.split_nodes.size(); ++i) {
+    const SplitNode& node = tree.split_nodes[i];
+    nodes_.push_back({AddInput(conditions[i]->input_id()),
+                      conditions[i]->left(),
+                      conditions[i]->right(),
+                      {to_node_index(node.child_if_false),
+                       to_node_index(node.child_if_true)}});
+    node_adjustments_.push_back(0.0f);
+  }
+  // Leaves read the same input as the root, so the access is always valid.
+  const int leaf_input_index = nodes_[first_node].input_index;
+  for (size_t i = 0; i < tree.adjustments.size(); ++i) {
+    uint32_t self = static_cast<uint32_t>(first_leaf + i);
+    nodes_.push_back({leaf_input_index,
+                      std::numeric_limits<float>::quiet_NaN(),
+                      std::numeric_limits<float>::quiet_NaN(),
+                      {self, self}});
+    node_adjustments_.push_back(tree.adjustments[i] * tree.weight);
+  }
+  predicated_trees_.push_back({.group_id = group_id,
+                               .root = static_cast<uint32_t>(first_node),
+                               .depth = depth});
+  return true;
+}
+
+int BatchedObliviousEvaluator::AddInput(int input_id) {
+  auto [it, inserted] = input_id_to_index_.emplace(input_id, input_ids_.size());
+  if (inserted) {
+    input_ids_.push_back(input_id);
+  }
+  return it->second;
+}
+
+bool BatchedObliviousEvaluator::Quantize() {
+  // Quantized evaluation uses 16-bit leaf ids.
+  for (const Tree& tree : trees_) {
+    if (tree.layer_count > 16) {
+      return false;
+    }
+  }
+  std::vector<std::vector<float>> boundaries(input_ids_.size());
+  for (const Layer& layer : layers_) {
+    if (std::isnan(layer.left) || std::isnan(layer.right)) {
+      return false;
+    }
+    boundaries[layer.input_index].push_back(layer.left);
+    boundaries[layer.input_index].push_back(layer.right);
+  }
+  for (uint32_t i = 0; i < nodes_.size(); ++i) {
+    const Node& node = nodes_[i];
+    if (node.next[0] == i) {  // Leaf.
+      continue;
+    }
+    if (std::isnan(node.left) || std::isnan(node.right)) {
+      return false;
+    }
+    boundaries[node.input_index].push_back(node.left);
+    boundaries[node.input_index].push_back(node.right);
+  }
+  size_t max_boundary_count = 0;
+  for (std::vector<float>& b : boundaries) {
+    absl::c_sort(b);
+    b.erase(std::unique(b.begin(), b.end()), b.end());
+    max_boundary_count = std::max(max_boundary_count, b.size());
+  }
+  // Bin codes are in range [0, 2 * boundary_count].
+  size_t max_code = 2 * max_boundary_count;
+  if (max_code > std::numeric_limits<uint16_t>::max() ||
+      input_ids_.size() > std::numeric_limits<uint16_t>::max()) {
+    return false;
+  }
+  // With `boundaries` b[0] < ... < b[k-1], a value x gets the code
+  //   #{i: b[i] < x} + #{i: b[i] <= x},
+  // so `x >= b[j]` iff `code >= 2j + 1`, and `x <= b[j]` iff `code <= 2j + 1`.
+  // Missing values and NaNs get code 0 that fails all the conditions.
+  auto to_code = [&boundaries](int input_index, float threshold) {
+    const std::vector<float>& b = boundaries[input_index];
+    return static_cast<uint16_t>(
+        2 * (absl::c_lower_bound(b, threshold) - b.begin()) + 1);
+  };
+  code_layers_.reserve(layers_.size());
+  for (const Layer& layer : layers_) {
+    code_layers_.push_back({static_cast<uint16_t>(layer.input_index),
+                            to_code(layer.input_index, layer.left),
+                            to_code(layer.input_index, layer.right)});
+  }
+  code_nodes_.reserve(nodes_.size());
+  for (uint32_t i = 0; i < nodes_.size(); ++i) {
+    const Node& node = nodes_[i];
+    if (node.next[0] == i) {
+      // Empty code range, leaves don't look at the values anyway.
+      code_nodes_.push_back({static_cast<uint16_t>(node.input_index), 1, 0,
+                             {node.next[0], node.next[1]}});
+    } else {
+      code_nodes_.push_back({static_cast<uint16_t>(node.input_index),
+                             to_code(node.input_index, node.left),
+                             to_code(node.input_index, node.right),
+                             {node.next[0], node.next[1]}});
+    }
+  }
+  boundaries_ = std::move(boundaries);
+  code_type_ = max_code <= std::numeric_limits<uint8_t>::max()
+                   ? CodeType::kUint8
+                   : CodeType::kUint16;
+  return true;
+}
+
+namespace {
+
+// Returns the value stored in blocks for `x`. Missing values are replaced with
+// NaN that doesn't satisfy any IntervalSplitCondition.
+float ToBlockValue(absl::Span<const float>, OptionalValue<float> x, float*) {
+  return x.present ? x.value : std::numeric_limits<float>::quiet_NaN();
+}
+
+// Returns the bin code of `x`. See BatchedObliviousEvaluator::Quantize.
+template <typename Code>
+Code ToBlockValue(absl::Span<const float> boundaries, OptionalValue<float> x,
+                  Code*) {
+  if (!x.present) {
+    return 0;
+  }
+  auto it = absl::c_lower_bound(boundaries, x.value);
+  bool is_boundary = it != boundaries.end() && *it == x.value;
+  return 2 * (it - boundaries.begin()) + is_boundary;
+}
+
+// Reads the block values of an input column, sequentially block by block.
+template <typename T>
+class BlockLoader {
+ public:
+  BlockLoader(const Array<float>& input, absl::Span<const float> boundaries,
+              int64_t row_begin)
+      : input_(input), boundaries_(boundaries) {
+    if (!input.IsDenseForm()) {
+      const IdFilter& id_filter = input.id_filter();
+      next_id_ = absl::c_lower_bound(id_filter.ids(),
+                                     row_begin + id_filter.ids_offset()) -
+                 id_filter.ids().begin();
+      missing_id_value_ = ToBlockValue(
+          boundaries_, input.missing_id_value(), static_cast<T*>(nullptr));
+    }
+  }
+
+  // Returns true if all the rows of the block are missing ids, i.e. the block
+  // contains only missing_id_value().
+  bool IsDefaultBlock(int64_t block_begin, int64_t block_size) const {
+    if (input_.IsDenseForm()) {
+      return false;
+    }
+    const IdFilter& id_filter = input_.id_filter();
+    return next_id_ >= id_filter.ids().size() ||
+           id_filter.IdsOffsetToId(next_id_) >=
+               block_begin + block_size;
+  }
+
+  // Returns the values of rows [block_begin, block_begin + block_size),
+  // stored in `buffer` of size kBlockSize if needed. Must be called for the
+  // consecutive blocks.
+  const T* Load(int64_t block_begin, int64_t block_size, T* buffer) {
+    const DenseArray<float>& data = input_.dense_data();
+    if (input_.IsDenseForm()) {
+      if constexpr (std::is_same_v<T, float>) {
+        if (data.bitmap.empty() &&
+            block_size == BatchedObliviousEvaluator::kBlockSize) {
+          return data.values.span().data() + block_begin;
+        }
+      }
+      std::fill(buffer, buffer + BatchedObliviousEvaluator::kBlockSize,
+                ToBlockValue(boundaries_, std::nullopt, buffer));
+      for (int64_t j = 0; j < block_size; ++j) {
+        if (data.present(block_begin + j)) {
+          buffer[j] = ToBlockValue(boundaries_, data.values[block_begin + j],
+                                   buffer);
+        }
+      }
+      return buffer;
+    }
+    std::fill(buffer, buffer + BatchedObliviousEvaluator::kBlockSize,
+              missing_id_value_);
+    const IdFilter& id_filter = input_.id_filter();
+    const int64_t block_end = block_begin + block_size;
+    for (; next_id_ < id_filter.ids().size(); ++next_id_) {
+      int64_t row = id_filter.IdsOffsetToId(next_id_);
+      if (row >= block_end) {
+        break;
+      }
+      buffer[row - block_begin] =
+          data.present(next_id_)
+              ? ToBlockValue(boundaries_, data.values[next_id_], buffer)
+              : ToBlockValue(boundaries_, std::nullopt, buffer);
+    }
+    return buffer;
+  }
+
+ private:
+  const Array<float>& input_;
+  absl::Span<const float> boundaries_;
+  // Used for the sparse inputs only.
+  int64_t next_id_ = 0;
+  T missing_id_value_ = {};
+};
+
+}  // namespace
+
+template <typename T, typename AddFn>
+void BatchedObliviousEvaluator::EvalBlock(
+    absl::Span<const T* const> block_values, int64_t block_size,
+    AddFn add_fn) const {
+  constexpr bool kQuantized = !std::is_same_v<T, float>;
+  // Narrow leaf ids make the loops over a block narrower as well.
+  using LeafId = std::conditional_t<kQuantized, uint16_t, uint32_t>;
+  for (const Tree& tree : trees_) {
+    std::array<LeafId, kBlockSize> leaf_ids = {};
+    for (size_t l = tree.first_layer; l < tree.first_layer + tree.layer_count;
+         ++l) {
+      const T* values;
+      T left, right;
+      if constexpr (kQuantized) {
+        const CodeLayer& layer = code_layers_[l];
+        values = block_values[layer.input_index];
+        left = static_cast<T>(layer.first_code);
+        right = static_cast<T>(layer.last_code);
+      } else {
+        const Layer& layer = layers_[l];
+        values = block_values[layer.input_index];
+        left = layer.left;
+        right = layer.right;
+      }
+      for (int64_t j = 0; j < kBlockSize; ++j) {
+        leaf_ids[j] = (leaf_ids[j] << 1) |
+                      static_cast<LeafId>((left <= values[j]) &
+                                          (values[j] <= right));
+      }
+    }
+    const float* adjustments = adjustments_.data() + tree.first_adjustment;
+    for (int64_t j = 0; j < block_size; ++j) {
+      add_fn(tree.group_id, j, adjustments[leaf_ids[j]]);
+    }
+  }
+
+  for (const PredicatedTree& tree : predicated_trees_) {
+    std::array<uint32_t, kBlockSize> node_ids;
+    node_ids.fill(tree.root);
+    for (size_t step = 0; step < tree.depth; ++step) {
+      for (int64_t j = 0; j < kBlockSize; ++j) {
+        if constexpr (kQuantized) {
+          const CodeNode& node = code_nodes_[node_ids[j]];
+          T value = block_values[node.input_index][j];
+          node_ids[j] = node.next[(node.first_code <= value) &
+                                  (value <= node.last_code)];
+        } else {
+          const Node& node = nodes_[node_ids[j]];
+          float value = block_values[node.input_index][j];
+          node_ids[j] = node.next[(node.left <= value) & (value <= node.right)];
+        }
+      }
+    }
+    for (int64_t j = 0; j < block_size; ++j) {
+      add_fn(tree.group_id, j, node_adjustments_[node_ids[j]]);
+    }
+  }
+}
+
+template <typename T>
+void BatchedObliviousEvaluator::EvalImpl(
+    absl::Span<const Array<float>> inputs, int64_t row_begin, int64_t row_end,
+    absl::Span<float* const> outputs) const {
+  std::vector<T> block_buffers(inputs.size() * kBlockSize);
+  std::vector<const T*> block_values(inputs.size());
+  std::vector<BlockLoader<T>> loaders;
+  loaders.reserve(inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    absl::Span<const float> boundaries;
+    if constexpr (!std::is_same_v<T, float>) {
+      boundaries = boundaries_[i];
+    }
+    loaders.emplace_back(inputs[i], boundaries, row_begin);
+  }
+
+  // The adjustments of the trees for the blocks of missing ids only, computed
+  // on the first such block. (group_id, adjustment) pairs in the order of
+  // EvalBlock, so the results are the same as without the shortcut.
+  std::vector<std::pair<int, float>> default_adjustments;
+  bool has_default_adjustments = false;
+
+  for (int64_t block_begin = row_begin; block_begin < row_end;
+       block_begin += kBlockSize) {
+    int64_t block_size = std::min(kBlockSize, row_end - block_begin);
+    bool is_default_block = absl::c_all_of(loaders, [&](const auto& loader) {
+      return loader.IsDefaultBlock(block_begin, block_size);
+    });
+    if (is_default_block && has_default_adjustments) {
+      for (auto [group_id, adjustment] : default_adjustments) {
+        float* output = outputs[group_id] + block_begin;
+        for (int64_t j = 0; j < block_size; ++j) {
+          output[j] += adjustment;
+        }
+      }
+      continue;
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      block_values[i] = loaders[i].Load(
+          block_begin, block_size, block_buffers.data() + i * kBlockSize);
+    }
+    if (is_default_block) {
+      EvalBlock<T>(block_values, /*block_size=*/1,
+                   [&](int group_id, int64_t, float adjustment) {
+                     default_adjustments.emplace_back(group_id, adjustment);
+                   });
+      has_default_adjustments = true;
+      for (auto [group_id, adjustment] : default_adjustments) {
+        float* output = outputs[group_id] + block_begin;
+        for (int64_t j = 0; j < block_size; ++j) {
+          output[j] += adjustment;
+        }
+      }
+      continue;
+    }
+    EvalBlock<T>(block_values, block_size,
+                 [&](int group_id, int64_t j, float adjustment) {
+                   outputs[group_id][block_begin + j] += adjustment;
+                 });
+  }
+}
+
+void BatchedObliviousEvaluator::Eval(absl::Span<const Array<float>> inputs,
+                                     int64_t row_begin, int64_t row_end,
+                                     absl::Span<float* const> outputs) const {
+  DCHECK_EQ(inputs.size(), input_ids_.size());
+  switch (code_type_) {
+    case CodeType::kNone:
+      return EvalImpl<float>(inputs, row_begin, row_end, outputs);
+    case CodeType::kUint8:
+      return EvalImpl<uint8_t>(inputs, row_begin, row_end, outputs);
+    case CodeType::kUint16:
+      return EvalImpl<uint16_t>(inputs, row_begin, row_end, outputs);
+  }
+}
+
+size_t BatchedObliviousEvaluator::memory_usage() const {
+  size_t result =
+      VectorMemoryUsage(trees_) + VectorMemoryUsage(layers_) +
+      VectorMemoryUsage(code_layers_) + VectorMemoryUsage(adjustments_) +
+      VectorMemoryUsage(predicated_trees_) + VectorMemoryUsage(nodes_) +
+      VectorMemoryUsage(code_nodes_) + VectorMemoryUsage(node_adjustments_) +
+      VectorMemoryUsage(input_ids_) + HashTableMemoryUsage(input_id_to_index_) +
+      VectorMemoryUsage(boundaries_);
+  for (const auto& boundaries : boundaries_) {
+    result += VectorMemoryUsage(boundaries);
+  }
+  return result;
+}
+
+}  // namespace arolla
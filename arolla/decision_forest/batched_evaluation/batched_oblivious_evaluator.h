@@ -0,0 +1,173 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_DECISION_FOREST_BATCHED_EVALUATION_BATCHED_OBLIVIOUS_EVALUATOR_H_
+#define AROLLA_DECISION_FOREST_BATCHED_EVALUATION_BATCHED_OBLIVIOUS_EVALUATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "arolla/array/array.h"
+#include "arolla/decision_forest/decision_forest.h"
+
+namespace arolla {
+
+// Evaluates oblivious trees with IntervalSplitConditions directly on
+// Array<float> columns, without copying rows into pointwise frames.
+//
+// Rows are processed in blocks of kBlockSize. Since all the nodes of a layer
+// share the same split, leaf indices of all the rows in a block are computed
+// layer by layer in tight loops over contiguous values, which compilers
+// vectorize.
+//
+// Optionally the features can be quantized: interval bounds of each input are
+// replaced with indices in the sorted list of all its thresholds, and the
+// input values are converted into uint8_t or uint16_t bin codes when the
+// block is loaded. It makes the comparisons narrower, so more rows fit into
+// a SIMD register.
+//
+// Non-oblivious trees of limited depth are evaluated with predicated descent:
+// each row of a block keeps the index of its current node, and all the rows
+// make exactly `depth` steps, selecting the next node by the comparison result
+// instead of branching. Leaves point to themselves, so rows that reached a
+// leaf early stay there. It trades some extra comparisons for the absence of
+// data-dependent branches, and the loops over a block are again vectorizable
+// (with gathers).
+//
+// Sparse columns are not densified: a block is filled with the
+// missing_id_value and only the present ids of the block are written. The
+// blocks where all the columns are sparse and have no ids contain only the
+// missing_id_values, so their leaves are the same for all rows. They are
+// computed once per Eval call, and such blocks cost only the additions of
+// the adjustments.
+class BatchedObliviousEvaluator {
+ public:
+  static constexpr int64_t kBlockSize = 16;
+  static constexpr size_t kMaxDepth = 20;
+  static constexpr size_t kMaxPredicatedDepth = 12;
+
+  // Adds the tree to the evaluator if it is supported, i.e. if it is
+  // oblivious, has from 1 to kMaxDepth layers and uses only
+  // IntervalSplitConditions. Returns false if the tree is not supported.
+  bool AddTree(const DecisionTree& tree, int group_id);
+
+  // Adds a non-oblivious tree to the evaluator if it is supported, i.e. if
+  // it has at least one split, is at most kMaxPredicatedDepth deep and uses
+  // only IntervalSplitConditions. Returns false if the tree is not supported.
+  bool AddPredicatedTree(const DecisionTree& tree, int group_id);
+
+  // Switches the evaluator to quantized features. Should be called after all
+  // the trees are added. Returns false and keeps float comparisons if the
+  // thresholds can not be quantized (e.g. there are too many distinct
+  // thresholds for a feature, some of them are NaN, or a tree is deeper than 16
+  // layers).
+  bool Quantize();
+
+  bool IsQuantized() const { return code_type_ != CodeType::kNone; }
+
+  bool IsEmpty() const { return trees_.empty() && predicated_trees_.empty(); }
+
+  // Ids of the forest inputs used by the trees, in the order expected by Eval.
+  absl::Span<const int> input_ids() const { return input_ids_; }
+
+  // Adds the tree adjustments for rows [row_begin, row_end) to
+  // outputs[group_id][row]. `inputs` correspond to input_ids() and must have
+  // at least `row_end` rows, `outputs` must have an item for each group.
+  // Missing values don't satisfy any split condition.
+  void Eval(absl::Span<const Array<float>> inputs, int64_t row_begin,
+            int64_t row_end, absl::Span<float* const> outputs) const;
+
+  // Returns an estimate of the heap memory used by the evaluator.
+  size_t memory_usage() const;
+
+ private:
+  struct Layer {
+    int input_index;  // Index in input_ids_.
+    float left;
+    float right;
+  };
+  // Layer in terms of bin codes: first_code <= code <= last_code. Twice as
+  // compact as Layer.
+  struct CodeLayer {
+    uint16_t input_index;
+    uint16_t first_code;
+    uint16_t last_code;
+  };
+  struct Tree {
+    int group_id;
+    size_t first_layer;
+    size_t layer_count;
+    size_t first_adjustment;
+  };
+
+  // Node of a predicated tree. Leaves have both `next` pointing to
+  // themselves.
+  struct Node {
+    int input_index;  // Index in input_ids_.
+    float left;
+    float right;
+    uint32_t next[2];  // Indices in nodes_ if the condition is false / true.
+  };
+  struct CodeNode {
+    uint16_t input_index;
+    uint16_t first_code;
+    uint16_t last_code;
+    uint32_t next[2];
+  };
+  struct PredicatedTree {
+    int group_id;
+    uint32_t root;
+    size_t depth;
+  };
+
+  enum class CodeType { kNone, kUint8, kUint16 };
+
+  // Returns the index of the input in input_ids_, adding it if needed.
+  int AddInput(int input_id);
+
+  // T is the type of the values in blocks: float or a bin code type.
+  template <typename T>
+  void EvalImpl(absl::Span<const Array<float>> inputs, int64_t row_begin,
+                int64_t row_end, absl::Span<float* const> outputs) const;
+
+  // Computes the adjustments of all the trees for the first `block_size` rows
+  // of a block and calls add_fn(group_id, row_in_block, adjustment) for each
+  // of them, tree by tree. `block_values` correspond to input_ids() and each
+  // has kBlockSize items.
+  template <typename T, typename AddFn>
+  void EvalBlock(absl::Span<const T* const> block_values, int64_t block_size,
+                 AddFn add_fn) const;
+
+  std::vector<Tree> trees_;
+  std::vector<Layer> layers_;
+  std::vector<CodeLayer> code_layers_;  // Used if quantized.
+  std::vector<float> adjustments_;
+  std::vector<PredicatedTree> predicated_trees_;
+  std::vector<Node> nodes_;
+  std::vector<CodeNode> code_nodes_;  // Used if quantized.
+  // Per node in nodes_: adjustment for leaves, 0 for splits.
+  std::vector<float> node_adjustments_;
+  std::vector<int> input_ids_;
+  absl::flat_hash_map<int, int> input_id_to_index_;
+  CodeType code_type_ = CodeType::kNone;
+  // Sorted distinct thresholds per input, used if quantized.
+  std::vector<std::vector<float>> boundaries_;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_DECISION_FOREST_BATCHED_EVALUATION_BATCHED_OBLIVIOUS_EVALUATOR_H_
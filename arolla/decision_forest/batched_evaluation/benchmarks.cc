@@ -34,7 +34,10 @@
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/memory_allocation.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/util/testing/benchmark_perf_counters.h"
 #include "arolla/util/threading.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -69,6 +72,7 @@ absl::Status RunBatchedBenchmark(
   }
 
   // Run
+  testing::BenchmarkPerfCounters perf_counters(state);
   for (auto _ : state) {
     RETURN_IF_ERROR(
         evaluator->EvalBatch(slots, output_slots, frame, nullptr, batch_size));
@@ -100,6 +104,86 @@ void BM_MixedSplits(benchmark::State& state, size_t batch_size) {
                                num_splits * num_trees));
 }
 
+// Oblivious trees of depth state.range(0), e.g. as exported from CatBoost.
+void BM_ObliviousTrees(
+    benchmark::State& state, size_t batch_size,
+    const BatchedForestEvaluator::CompilationParams& params) {
+  int64_t depth = state.range(0);
+  int64_t num_trees = state.range(1);
+  absl::BitGen rnd;
+  std::vector<QTypePtr> feature_types(10, GetOptionalQType<float>());
+  std::vector<DecisionTree> trees;
+  trees.reserve(num_trees);
+  for (int64_t i = 0; i < num_trees; ++i) {
+    trees.push_back(CreateRandomObliviousTree(&rnd, depth, &feature_types));
+  }
+  auto forest = DecisionForest::FromTrees(std::move(trees)).value();
+  CHECK_OK(RunBatchedBenchmark(batch_size, *forest, params, state,
+                               ((int64_t{1} << depth) - 1) * num_trees));
+}
+
+void BM_ObliviousTrees_Pointwise(benchmark::State& state) {
+  BM_ObliviousTrees(state, /*batch_size=*/1000, {});
+}
+
+void BM_ObliviousTrees_Batched(benchmark::State& state) {
+  BM_ObliviousTrees(state, /*batch_size=*/1000,
+                    {.enable_batched_oblivious_eval = true});
+}
+
+void BM_ObliviousTrees_Quantized(benchmark::State& state) {
+  BM_ObliviousTrees(state, /*batch_size=*/1000,
+                    {.enable_batched_oblivious_eval = true,
+                     .enable_quantized_features = true});
+}
+
+BENCHMARK(BM_ObliviousTrees_Pointwise)
+    ->ArgPair(4, 1000)
+    ->ArgPair(6, 1000)
+    ->ArgPair(8, 300);
+BENCHMARK(BM_ObliviousTrees_Batched)
+    ->ArgPair(4, 1000)
+    ->ArgPair(6, 1000)
+    ->ArgPair(8, 300)
+    ->ArgPair(6, 30000);
+BENCHMARK(BM_ObliviousTrees_Quantized)
+    ->ArgPair(4, 1000)
+    ->ArgPair(6, 1000)
+    ->ArgPair(8, 300)
+    ->ArgPair(6, 30000);
+
+// Non-oblivious trees with state.range(0) splits on float features.
+void BM_PredicatedTrees(benchmark::State& state, bool predicated) {
+  int64_t num_splits = state.range(0);
+  int64_t num_trees = state.range(1);
+  absl::BitGen rnd;
+  auto forest = CreateRandomFloatForest(
+      &rnd, /*num_features=*/10, /*interactions=*/true,
+      /*min_num_splits=*/num_splits, /*max_num_splits=*/num_splits, num_trees);
+  CHECK_OK(RunBatchedBenchmark(
+      /*batch_size=*/1000, *forest,
+      {.enable_batched_oblivious_eval = true,
+       .enable_batched_predicated_eval = predicated},
+      state, num_splits * num_trees));
+}
+
+void BM_PredicatedTrees_Pointwise(benchmark::State& state) {
+  BM_PredicatedTrees(state, /*predicated=*/false);
+}
+
+void BM_PredicatedTrees_Batched(benchmark::State& state) {
+  BM_PredicatedTrees(state, /*predicated=*/true);
+}
+
+BENCHMARK(BM_PredicatedTrees_Pointwise)
+    ->ArgPair(7, 1000)
+    ->ArgPair(15, 1000)
+    ->ArgPair(31, 300);
+BENCHMARK(BM_PredicatedTrees_Batched)
+    ->ArgPair(7, 1000)
+    ->ArgPair(15, 1000)
+    ->ArgPair(31, 300);
+
 // MainPairs are used to compare different algorithm in wide range of params.
 void RunMainPairs(benchmark::internal::Benchmark* b) {
   b->ArgPair(0, 100000)
@@ -150,13 +234,25 @@ void RunBigModelPairs(benchmark::internal::Benchmark* b) {
   }                                                              \
   BENCHMARK(BM_##TYPE##_##SPLITS##_##BATCH)->Apply(&Run##TYPE##Pairs)
 
+// Compares StdThreading (new threads on every call) with WorkStealingThreading
+// (persistent pool).
 #define THREADED_BENCHMARK(TYPE, SPLITS, BATCH)                              \
   void BM_##TYPE##_##SPLITS##_##BATCH##_T4(benchmark::State& state) {        \
-    BatchedForestEvaluator::SetThreading(std::make_unique<StdThreading>(4)); \
+    BatchedForestEvaluator::SetThreading(std::make_unique<StdThreading>(4),  \
+                                         /*min_rows_per_thread=*/128,        \
+                                         /*parallelize_rows=*/true);         \
     BM_##SPLITS(state, BATCH);                                               \
     BatchedForestEvaluator::SetThreading(nullptr);                           \
   }                                                                          \
-  BENCHMARK(BM_##TYPE##_##SPLITS##_##BATCH##_T4)->Apply(&Run##TYPE##Pairs)
+  BENCHMARK(BM_##TYPE##_##SPLITS##_##BATCH##_T4)->Apply(&Run##TYPE##Pairs);  \
+  void BM_##TYPE##_##SPLITS##_##BATCH##_Pool4(benchmark::State& state) {     \
+    BatchedForestEvaluator::SetThreading(                                    \
+        std::make_unique<WorkStealingThreading>(4),                          \
+        /*min_rows_per_thread=*/128, /*parallelize_rows=*/true);             \
+    BM_##SPLITS(state, BATCH);                                               \
+    BatchedForestEvaluator::SetThreading(nullptr);                           \
+  }                                                                          \
+  BENCHMARK(BM_##TYPE##_##SPLITS##_##BATCH##_Pool4)->Apply(&Run##TYPE##Pairs)
 
 void BM_HugeForest(benchmark::State& state) {
   BM_IntervalSplits(state, /*batch_size=*/1000);
@@ -171,6 +267,30 @@ BENCHMARK(BM_HugeForest)
     ->ArgPair(1000, 3000)    // 3000'000 split nodes
     ->ArgPair(1000, 10000);  // 10'000'000 split nodes
 
+// Online traffic: a few rows against a big forest. state.range(0) is the
+// number of threads, zero means single threaded evaluation.
+void BM_TreeParallelism(benchmark::State& state) {
+  int thread_count = state.range(0);
+  int64_t batch_size = state.range(1);
+  absl::BitGen rnd;
+  auto forest = CreateRandomFloatForest(
+      &rnd, /*num_features=*/10, /*interactions=*/true,
+      /*min_num_splits=*/31, /*max_num_splits=*/31, /*num_trees=*/5000);
+  BatchedForestEvaluator::CompilationParams params;
+  if (thread_count > 0) {
+    params.threading = std::make_shared<WorkStealingThreading>(thread_count);
+    params.splits_per_tree_parallel_evaluator = 31 * 5000 / thread_count;
+  }
+  CHECK_OK(RunBatchedBenchmark(batch_size, *forest, params, state,
+                               31 * 5000));
+}
+
+BENCHMARK(BM_TreeParallelism)
+    ->ArgPair(0, 1)
+    ->ArgPair(4, 1)
+    ->ArgPair(0, 64)
+    ->ArgPair(4, 64);
+
 BATCH_BENCHMARK(Main, IntervalSplits, 100000);
 BATCH_BENCHMARK(Main, MixedSplits, 100000);
 
@@ -34,6 +34,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/simple_qtype.h"
 #include "arolla/util/fingerprint.h"
+#include "arolla/util/memory_usage.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
@@ -134,6 +135,16 @@ absl::Status DecisionForest::ValidateInputSlots(
   return absl::OkStatus();
 }
 
+size_t DecisionForest::memory_usage() const {
+  size_t result = sizeof(*this) + VectorMemoryUsage(trees_) +
+                  HashTableMemoryUsage(required_qtypes_);
+  for (const DecisionTree& tree : trees_) {
+    result += VectorMemoryUsage(tree.split_nodes) +
+              VectorMemoryUsage(tree.adjustments);
+  }
+  return result;
+}
+
 absl::Status DecisionForest::Initialize() {
   FingerprintHasher hasher("::arolla::DecisionForest");
   hasher.Combine(trees_.size());
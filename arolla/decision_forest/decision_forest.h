@@ -15,6 +15,7 @@
 #ifndef AROLLA_DECISION_FOREST_DECISION_FOREST_H_
 #define AROLLA_DECISION_FOREST_DECISION_FOREST_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -32,6 +33,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/util/fingerprint.h"
+#include "arolla/util/memory_usage.h"
 
 namespace arolla {
 
@@ -163,6 +165,10 @@ class DecisionForest {
 
   Fingerprint fingerprint() const { return fingerprint_; }
 
+  // Returns an estimate of the heap memory used by the forest. The memory
+  // owned by the split conditions is not counted.
+  size_t memory_usage() const;
+
  private:
   explicit DecisionForest(std::vector<DecisionTree>&& trees)
       : trees_(std::move(trees)) {}
@@ -187,6 +193,13 @@ float DecisionForestNaiveEvaluation(const DecisionForest& forest,
 
 using DecisionForestPtr = std::shared_ptr<const DecisionForest>;
 
+template <>
+struct MemoryUsageTraits<DecisionForestPtr> {
+  size_t operator()(const DecisionForestPtr& forest) const {
+    return forest == nullptr ? 0 : forest->memory_usage();
+  }
+};
+
 AROLLA_DECLARE_FINGERPRINT_HASHER_TRAITS(SplitNode);
 AROLLA_DECLARE_FINGERPRINT_HASHER_TRAITS(TreeFilter);
 AROLLA_DECLARE_FINGERPRINT_HASHER_TRAITS(DecisionForestPtr);
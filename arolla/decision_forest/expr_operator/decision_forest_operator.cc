@@ -15,6 +15,7 @@
 #include "arolla/decision_forest/expr_operator/decision_forest_operator.h"
 
 #include <algorithm>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -48,32 +49,51 @@ std::vector<int> GetRequiredInputIds(
   return result;
 }
 
+Fingerprint ComputeFingerprint(const DecisionForest& forest,
+                               absl::Span<const TreeFilter> tree_filters,
+                               std::optional<float> early_exit_cutoff) {
+  FingerprintHasher hasher("::arolla::DecisionForestOperator");
+  hasher.Combine(forest.fingerprint()).CombineSpan(tree_filters);
+  if (early_exit_cutoff.has_value()) {
+    hasher.Combine(*early_exit_cutoff);
+  }
+  return std::move(hasher).Finish();
+}
+
 }  // namespace
 
 DecisionForestOperator::DecisionForestOperator(
     DecisionForestPtr forest, std::vector<TreeFilter> tree_filters)
     : DecisionForestOperator(GetRequiredInputIds(forest->GetRequiredQTypes()),
-                             forest, std::move(tree_filters)) {}
+                             forest, std::move(tree_filters),
+                             /*early_exit_cutoff=*/std::nullopt) {}
 
 DecisionForestOperator::DecisionForestOperator(
     DecisionForestPtr forest, std::vector<TreeFilter> tree_filters,
     const absl::flat_hash_map<int, QTypePtr>& required_types)
     : DecisionForestOperator(GetRequiredInputIds(required_types),
-                             std::move(forest), std::move(tree_filters)) {}
+                             std::move(forest), std::move(tree_filters),
+                             /*early_exit_cutoff=*/std::nullopt) {}
+
+DecisionForestOperator::DecisionForestOperator(
+    DecisionForestPtr forest, std::vector<TreeFilter> tree_filters,
+    float early_exit_cutoff)
+    : DecisionForestOperator(GetRequiredInputIds(forest->GetRequiredQTypes()),
+                             forest, std::move(tree_filters),
+                             early_exit_cutoff) {}
 
 DecisionForestOperator::DecisionForestOperator(
     std::vector<int> required_input_ids, DecisionForestPtr forest,
-    std::vector<TreeFilter> tree_filters)
+    std::vector<TreeFilter> tree_filters,
+    std::optional<float> early_exit_cutoff)
     : BasicExprOperator(
           "anonymous.decision_forest_operator",
           expr::ExprOperatorSignature::MakeVariadicArgs(),
           "Evaluates decision forest stored in the operator state.",
-          FingerprintHasher("::arolla::DecisionForestOperator")
-              .Combine(forest->fingerprint())
-              .CombineSpan(tree_filters)
-              .Finish()),
+          ComputeFingerprint(*forest, tree_filters, early_exit_cutoff)),
       forest_(std::move(forest)),
       tree_filters_(std::move(tree_filters)),
+      early_exit_cutoff_(early_exit_cutoff),
       required_input_ids_(std::move(required_input_ids)) {
   std::sort(required_input_ids_.begin(), required_input_ids_.end());
 }
@@ -15,6 +15,7 @@
 #ifndef AROLLA_DECISION_FOREST_EXPR_OPERATOR_DECISION_FOREST_OPERATOR_H_
 #define AROLLA_DECISION_FOREST_EXPR_OPERATOR_DECISION_FOREST_OPERATOR_H_
 
+#include <optional>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -42,11 +43,21 @@ class DecisionForestOperator : public expr::BasicExprOperator,
       DecisionForestPtr forest, std::vector<TreeFilter> tree_filters,
       const absl::flat_hash_map<int, QTypePtr>& required_types);
 
+  // Creates ForestOperator for callers that only need to know whether the
+  // scores exceed `early_exit_cutoff`. Pointwise evaluation stops as soon as
+  // the remaining trees can not move a score across the cutoff, see
+  // ForestEvaluator::Output::early_exit_cutoff for the exact contract.
+  // Batched evaluation ignores the cutoff and computes the exact scores.
+  DecisionForestOperator(DecisionForestPtr forest,
+                         std::vector<TreeFilter> tree_filters,
+                         float early_exit_cutoff);
+
   absl::StatusOr<QTypePtr> GetOutputQType(
       absl::Span<const QTypePtr> input_qtypes) const final;
 
   DecisionForestPtr forest() const { return forest_; }
   const std::vector<TreeFilter>& tree_filters() const { return tree_filters_; }
+  std::optional<float> early_exit_cutoff() const { return early_exit_cutoff_; }
 
   absl::string_view py_qvalue_specialization_key() const final {
     return "::arolla::DecisionForestOperator";
@@ -55,10 +66,12 @@ class DecisionForestOperator : public expr::BasicExprOperator,
  private:
   DecisionForestOperator(std::vector<int> required_input_ids,
                          DecisionForestPtr forest,
-                         std::vector<TreeFilter> tree_filters);
+                         std::vector<TreeFilter> tree_filters,
+                         std::optional<float> early_exit_cutoff);
 
   DecisionForestPtr forest_;
   std::vector<TreeFilter> tree_filters_;
+  std::optional<float> early_exit_cutoff_;
   // Sorted list of required input ids.
   std::vector<int> required_input_ids_;
 };
@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -106,5 +107,25 @@ TEST_F(DecisionForestOperatorTest, GetOutputQType) {
   }
 }
 
+TEST_F(DecisionForestOperatorTest, EarlyExitCutoff) {
+  ASSERT_OK_AND_ASSIGN(const DecisionForestPtr forest, CreateForest());
+  std::vector<TreeFilter> filters = {TreeFilter{.submodels = {0}}};
+  auto op = std::make_shared<DecisionForestOperator>(forest, filters);
+  auto op_with_cutoff =
+      std::make_shared<DecisionForestOperator>(forest, filters, 1.0f);
+  auto op_with_other_cutoff =
+      std::make_shared<DecisionForestOperator>(forest, filters, 2.0f);
+  EXPECT_EQ(op->early_exit_cutoff(), std::nullopt);
+  EXPECT_EQ(op_with_cutoff->early_exit_cutoff(), 1.0f);
+  EXPECT_NE(op->fingerprint(), op_with_cutoff->fingerprint());
+  EXPECT_NE(op_with_cutoff->fingerprint(), op_with_other_cutoff->fingerprint());
+  EXPECT_EQ(op_with_cutoff->fingerprint(),
+            std::make_shared<DecisionForestOperator>(forest, filters, 1.0f)
+                ->fingerprint());
+  EXPECT_THAT(
+      op_with_cutoff->GetOutputQType({GetQType<float>(), GetQType<float>()}),
+      IsOkAndHolds(MakeTupleQType({GetQType<float>()})));
+}
+
 }  // namespace
 }  // namespace arolla
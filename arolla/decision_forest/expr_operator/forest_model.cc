@@ -36,6 +36,7 @@
 #include "absl/types/span.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/decision_forest/expr_operator/decision_forest_operator.h"
+#include "arolla/decision_forest/expr_operator/forest_simplification.h"
 #include "arolla/expr/annotation_utils.h"
 #include "arolla/expr/basic_expr_operator.h"
 #include "arolla/expr/expr.h"
@@ -55,6 +56,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/standard_type_properties/properties.h"
+#include "arolla/qtype/typed_value.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/text.h"
 #include "arolla/util/status_macros_backport.h"
@@ -168,6 +170,29 @@ NodeCountMap GetNodeCountMap(const expr::ExprNodePtr& expr) {
                            });
 }
 
+// Returns the value of a preprocessed forest input if it is known at compile
+// time. Scalar literals are wrapped into core.to_optional by
+// CastAndValidateArgType, the simplification accepts the unwrapped value.
+absl::StatusOr<std::optional<TypedValue>> GetConstantInputValue(
+    const expr::ExprNodePtr& arg) {
+  if (arg->qvalue().has_value()) {
+    return *arg->qvalue();
+  }
+  if (!arg->is_op() || arg->node_deps().size() != 1 ||
+      !arg->node_deps()[0]->qvalue().has_value()) {
+    return std::nullopt;
+  }
+  ASSIGN_OR_RETURN(auto op, expr::DecayRegisteredOperator(arg->op()));
+  ASSIGN_OR_RETURN(auto to_optional_op,
+                   expr::LookupOperator("core.to_optional"));
+  ASSIGN_OR_RETURN(auto decayed_to_optional_op,
+                   expr::DecayRegisteredOperator(to_optional_op));
+  if (op->fingerprint() != decayed_to_optional_op->fingerprint()) {
+    return std::nullopt;
+  }
+  return *arg->node_deps()[0]->qvalue();
+}
+
 }  // namespace
 
 absl::StatusOr<ForestModelPtr> ForestModel::Create(
@@ -297,7 +322,15 @@ absl::StatusOr<expr::ExprNodePtr> ForestModel::ToLowerLevel(
   }
 
   ASSIGN_OR_RETURN(std::vector<expr::ExprNodePtr> args, PreprocessInputs(node));
-  ASSIGN_OR_RETURN(auto op, CreateDecisionForestOperator(tree_filters_));
+  absl::flat_hash_map<int, TypedValue> constant_inputs;
+  for (size_t i = 0; i < args.size(); ++i) {
+    ASSIGN_OR_RETURN(auto value, GetConstantInputValue(args[i]));
+    if (value.has_value()) {
+      constant_inputs.emplace(i, *std::move(value));
+    }
+  }
+  ASSIGN_OR_RETURN(auto op, CreateDecisionForestOperator(tree_filters_,
+                                                         constant_inputs));
   ASSIGN_OR_RETURN(auto res_tuple, expr::MakeOpNode(op, std::move(args)));
   return ApplyPostprocessing(node, res_tuple);
 }
@@ -651,7 +684,8 @@ std::vector<DecisionTree> GetMaybeUsedTrees(
 }  // namespace
 
 absl::StatusOr<expr::ExprOperatorPtr> ForestModel::CreateDecisionForestOperator(
-    std::vector<TreeFilter> tree_filters) const {
+    std::vector<TreeFilter> tree_filters,
+    const absl::flat_hash_map<int, TypedValue>& constant_inputs) const {
   DecisionForestPtr forest = forest_;
   auto required_types = forest->GetRequiredQTypes();
   if (!submodel_weight_multipliers_.empty()) {
@@ -665,6 +699,12 @@ absl::StatusOr<expr::ExprOperatorPtr> ForestModel::CreateDecisionForestOperator(
     }
     ASSIGN_OR_RETURN(forest, DecisionForest::FromTrees(std::move(trees)));
   }
+  // The operator keeps the original required types, so the simplified forest
+  // accepts the same inputs even if some of them are no longer used.
+  if (!constant_inputs.empty()) {
+    ASSIGN_OR_RETURN(forest,
+                     SimplifyDecisionForest(std::move(forest), constant_inputs));
+  }
   return std::make_shared<DecisionForestOperator>(
       std::move(forest), std::move(tree_filters), required_types);
 }
@@ -34,6 +34,7 @@
 #include "arolla/expr/expr_operator.h"
 #include "arolla/expr/expr_operator_signature.h"
 #include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_value.h"
 #include "arolla/util/fingerprint.h"
 
 namespace arolla {
@@ -181,8 +182,11 @@ class ForestModel : public expr::BasicExprOperator {
   // Literal(bag_count_).
   absl::StatusOr<expr::ExprNodePtr> UsedBagCountExpr() const;
 
+  // The forest is simplified for `constant_inputs` (see
+  // SimplifyDecisionForest).
   absl::StatusOr<expr::ExprOperatorPtr> CreateDecisionForestOperator(
-      std::vector<TreeFilter> tree_filters) const;
+      std::vector<TreeFilter> tree_filters,
+      const absl::flat_hash_map<int, TypedValue>& constant_inputs = {}) const;
 
   absl::StatusOr<expr::ExprNodePtr> ApplyEvaluator(
       expr::ExprNodePtr forest_evaluator,
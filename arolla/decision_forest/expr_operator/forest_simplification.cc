@@ -0,0 +1,413 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/expr_operator/forest_simplification.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/base/casts.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/split_condition.h"
+#include "arolla/decision_forest/split_conditions/interval_split_condition.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/util/fast_dynamic_downcast_final.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+namespace {
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+
+// Values of the constant inputs stored in a frame, so any SplitCondition can
+// be evaluated on them.
+class ConstantInputs {
+ public:
+  ConstantInputs(const DecisionForest& forest,
+                 const absl::flat_hash_map<int, TypedValue>& values) {
+    const auto& required_qtypes = forest.GetRequiredQTypes();
+    FrameLayout::Builder layout_builder;
+    std::vector<std::pair<TypedSlot, const TypedValue*>> inits;
+    for (const auto& [id, value] : values) {
+      auto it = required_qtypes.find(id);
+      if (it == required_qtypes.end()) {
+        continue;
+      }
+      QTypePtr qtype = it->second;
+      bool is_value_qtype =
+          IsOptionalQType(qtype) && qtype->value_qtype() == value.GetType();
+      if (value.GetType() != qtype && !is_value_qtype) {
+        continue;
+      }
+      if (slots_.size() <= static_cast<size_t>(id)) {
+        slots_.resize(id + 1, TypedSlot::FromSlot(
+                                  FrameLayout::Slot<float>::
+                                      UnsafeUninitializedSlot()));
+        is_constant_.resize(id + 1, false);
+      }
+      slots_[id] = AddSlot(qtype, &layout_builder);
+      is_constant_[id] = true;
+      inits.emplace_back(slots_[id], &value);
+    }
+    layout_ = std::move(layout_builder).Build();
+    alloc_.emplace(&layout_);
+    for (const auto& [slot, value] : inits) {
+      init_status_.Update(CopyToSlot(*value, slot));
+    }
+  }
+
+  ConstantInputs(const ConstantInputs&) = delete;
+  ConstantInputs& operator=(const ConstantInputs&) = delete;
+
+  absl::Status status() const { return init_status_; }
+
+  // Returns the result of the condition if all its inputs are constant.
+  std::optional<bool> Evaluate(const SplitCondition& condition) const {
+    auto signatures = condition.GetInputSignatures();
+    if (signatures.empty()) {
+      return std::nullopt;
+    }
+    for (const auto& signature : signatures) {
+      size_t id = signature.id;
+      if (id >= is_constant_.size() || !is_constant_[id] ||
+          slots_[id].GetType() != signature.type) {
+        return std::nullopt;
+      }
+    }
+    return condition.EvaluateCondition(alloc_->frame(), slots_);
+  }
+
+ private:
+  absl::Status CopyToSlot(const TypedValue& value, TypedSlot slot) {
+    FramePtr frame = alloc_->frame();
+    if (value.GetType() == slot.GetType()) {
+      return value.CopyToSlot(slot, frame);
+    }
+    ASSIGN_OR_RETURN(auto presence_slot, GetPresenceSubslotFromOptional(slot));
+    ASSIGN_OR_RETURN(auto value_slot, GetValueSubslotFromOptional(slot));
+    frame.Set(presence_slot, true);
+    return value.CopyToSlot(value_slot, frame);
+  }
+
+  std::vector<TypedSlot> slots_;
+  std::vector<bool> is_constant_;
+  FrameLayout layout_;
+  std::optional<MemoryAllocation> alloc_;
+  absl::Status init_status_;
+};
+
+// Values of an input that are possible on a tree path, according to the
+// IntervalSplitConditions above.
+struct InputRange {
+  float lo = -kInf;
+  float hi = kInf;
+  // If true, the value is known to be present and not NaN.
+  bool present = false;
+};
+
+using PathConstraints = std::vector<std::pair<int, InputRange>>;
+
+InputRange GetRange(const PathConstraints& path, int input_id) {
+  for (const auto& [id, range] : path) {
+    if (id == input_id) {
+      return range;
+    }
+  }
+  return {};
+}
+
+PathConstraints WithRange(PathConstraints path, int input_id,
+                          InputRange range) {
+  for (auto& [id, old_range] : path) {
+    if (id == input_id) {
+      old_range = range;
+      return path;
+    }
+  }
+  path.emplace_back(input_id, range);
+  return path;
+}
+
+// Returns the constraints for the branch `if_true` of the condition.
+PathConstraints ConstrainPath(const PathConstraints& path,
+                              const SplitCondition& condition, bool if_true) {
+  auto* interval =
+      fast_dynamic_downcast_final<const IntervalSplitCondition*>(&condition);
+  if (interval == nullptr || std::isnan(interval->left()) ||
+      std::isnan(interval->right())) {
+    return path;
+  }
+  const float left = interval->left();
+  const float right = interval->right();
+  InputRange range = GetRange(path, interval->input_id());
+  if (if_true) {
+    range.lo = std::max(range.lo, left);
+    range.hi = std::min(range.hi, right);
+    range.present = true;
+  } else if (left == -kInf) {
+    // The value is missing, NaN or > right.
+    if (right == kInf) {
+      range.lo = kInf;
+      range.hi = -kInf;
+    } else {
+      range.lo = std::max(range.lo, std::nextafter(right, kInf));
+    }
+  } else if (right == kInf) {
+    // The value is missing, NaN or < left.
+    range.hi = std::min(range.hi, std::nextafter(left, -kInf));
+  } else {
+    return path;
+  }
+  return WithRange(path, interval->input_id(), range);
+}
+
+// Returns the result of the condition if it is known on the path.
+std::optional<bool> DecideCondition(const SplitCondition& condition,
+                                    const PathConstraints& path,
+                                    const ConstantInputs& constants) {
+  if (auto result = constants.Evaluate(condition); result.has_value()) {
+    return result;
+  }
+  auto* interval =
+      fast_dynamic_downcast_final<const IntervalSplitCondition*>(&condition);
+  if (interval == nullptr || std::isnan(interval->left()) ||
+      std::isnan(interval->right())) {
+    return std::nullopt;
+  }
+  InputRange range = GetRange(path, interval->input_id());
+  if (std::max(range.lo, interval->left()) >
+      std::min(range.hi, interval->right())) {
+    return false;
+  }
+  if (range.present && interval->left() <= range.lo &&
+      range.hi <= interval->right()) {
+    return true;
+  }
+  return std::nullopt;
+}
+
+// Split of the simplified tree. The children refer to the adjustments of the
+// original tree and to the indices of the kept splits.
+struct KeptSplit {
+  std::shared_ptr<const SplitCondition> condition;
+  DecisionTreeNodeId child_if_false;
+  DecisionTreeNodeId child_if_true;
+};
+
+// Class of equal subtrees of the simplified tree: a leaf or a split over two
+// different classes.
+struct Subtree {
+  float adjustment = 0;  // Only for leaves.
+  std::shared_ptr<const SplitCondition> condition;  // nullptr for leaves.
+  int64_t child_if_false = -1;
+  int64_t child_if_true = -1;
+};
+
+struct SplitKey {
+  const SplitCondition* condition;
+  int64_t child_if_false;
+  int64_t child_if_true;
+
+  template <typename H>
+  friend H AbslHashValue(H h, const SplitKey& key) {
+    return H::combine(std::move(h), *key.condition, key.child_if_false,
+                      key.child_if_true);
+  }
+
+  bool operator==(const SplitKey& other) const {
+    return *condition == *other.condition &&
+           child_if_false == other.child_if_false &&
+           child_if_true == other.child_if_true;
+  }
+};
+
+// Removes the splits with the results known on their paths. Returns the kept
+// splits (every split goes before its children) and the new root.
+DecisionTreeNodeId PruneKnownSplits(const DecisionTree& tree,
+                                    const ConstantInputs& constants,
+                                    std::vector<KeptSplit>& kept) {
+  DecisionTreeNodeId root;
+  struct Pending {
+    DecisionTreeNodeId id;
+    PathConstraints path;
+    int64_t parent;  // -1 for the root.
+    bool if_true;
+  };
+  std::vector<Pending> stack = {{GetTreeRootId(tree), {}, -1, false}};
+  while (!stack.empty()) {
+    Pending pending = std::move(stack.back());
+    stack.pop_back();
+    DecisionTreeNodeId id = pending.id;
+    while (!id.is_leaf()) {
+      const SplitNode& node = tree.split_nodes[id.split_node_index()];
+      auto result = DecideCondition(*node.condition, pending.path, constants);
+      if (!result.has_value()) {
+        break;
+      }
+      id = *result ? node.child_if_true : node.child_if_false;
+    }
+    DecisionTreeNodeId new_id =
+        id.is_leaf() ? id : DecisionTreeNodeId::SplitNodeId(kept.size());
+    if (pending.parent < 0) {
+      root = new_id;
+    } else if (pending.if_true) {
+      kept[pending.parent].child_if_true = new_id;
+    } else {
+      kept[pending.parent].child_if_false = new_id;
+    }
+    if (id.is_leaf()) {
+      continue;
+    }
+    const SplitNode& node = tree.split_nodes[id.split_node_index()];
+    kept.push_back({node.condition, {}, {}});
+    int64_t parent = new_id.split_node_index();
+    stack.push_back({node.child_if_false,
+                     ConstrainPath(pending.path, *node.condition, false),
+                     parent, false});
+    stack.push_back({node.child_if_true,
+                     ConstrainPath(pending.path, *node.condition, true),
+                     parent, true});
+  }
+  return root;
+}
+
+// Returns the simplified tree or std::nullopt if it is unchanged.
+std::optional<DecisionTree> SimplifyTree(const DecisionTree& tree,
+                                         const ConstantInputs& constants) {
+  if (tree.split_nodes.empty()) {
+    return std::nullopt;
+  }
+  std::vector<KeptSplit> kept;
+  DecisionTreeNodeId root = PruneKnownSplits(tree, constants, kept);
+
+  // Bottom-up: find the equal subtrees and drop the splits with equal
+  // children.
+  std::vector<Subtree> subtrees;
+  absl::flat_hash_map<uint32_t, int64_t> leaf_subtrees;
+  absl::flat_hash_map<SplitKey, int64_t> split_subtrees;
+  std::vector<int64_t> kept_subtrees(kept.size());
+  auto subtree_of = [&](DecisionTreeNodeId id) -> int64_t {
+    if (!id.is_leaf()) {
+      return kept_subtrees[id.split_node_index()];
+    }
+    float adjustment = tree.adjustments[id.adjustment_index()];
+    auto [it, inserted] = leaf_subtrees.emplace(
+        absl::bit_cast<uint32_t>(adjustment), subtrees.size());
+    if (inserted) {
+      subtrees.push_back({adjustment});
+    }
+    return it->second;
+  };
+  for (int64_t i = kept.size() - 1; i >= 0; --i) {
+    int64_t if_false = subtree_of(kept[i].child_if_false);
+    int64_t if_true = subtree_of(kept[i].child_if_true);
+    if (if_false == if_true) {
+      kept_subtrees[i] = if_false;
+      continue;
+    }
+    auto [it, inserted] = split_subtrees.emplace(
+        SplitKey{kept[i].condition.get(), if_false, if_true}, subtrees.size());
+    if (inserted) {
+      subtrees.push_back({0, kept[i].condition, if_false, if_true});
+    }
+    kept_subtrees[i] = it->second;
+  }
+  const int64_t root_subtree = subtree_of(root);
+
+  // Breadth-first from the root, so the root gets the split index 0. The
+  // equal subtrees are copied, every node of the result has one parent.
+  DecisionTree result;
+  result.weight = tree.weight;
+  result.tag = tree.tag;
+  std::vector<int64_t> queue;
+  auto add_node = [&](int64_t subtree_index) {
+    const Subtree& subtree = subtrees[subtree_index];
+    if (subtree.condition == nullptr) {
+      result.adjustments.push_back(subtree.adjustment);
+      return DecisionTreeNodeId::AdjustmentId(result.adjustments.size() - 1);
+    }
+    queue.push_back(subtree_index);
+    return DecisionTreeNodeId::SplitNodeId(queue.size() - 1);
+  };
+  add_node(root_subtree);
+  for (size_t i = 0; i < queue.size(); ++i) {
+    const Subtree& subtree = subtrees[queue[i]];
+    SplitNode node;
+    node.condition = subtree.condition;
+    node.child_if_false = add_node(subtree.child_if_false);
+    node.child_if_true = add_node(subtree.child_if_true);
+    result.split_nodes.push_back(std::move(node));
+  }
+  // Every removed split reduces the number of nodes.
+  if (result.split_nodes.size() == tree.split_nodes.size()) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+// The tree can be removed: it adds zero to every prediction.
+bool IsZeroTree(const DecisionTree& tree) {
+  return tree.weight == 0 &&
+         absl::c_all_of(tree.adjustments, [](float adjustment) {
+           return std::isfinite(adjustment);
+         });
+}
+
+}  // namespace
+
+absl::StatusOr<DecisionForestPtr> SimplifyDecisionForest(
+    DecisionForestPtr forest,
+    const absl::flat_hash_map<int, TypedValue>& constant_inputs) {
+  ConstantInputs constants(*forest, constant_inputs);
+  RETURN_IF_ERROR(constants.status());
+  bool changed = false;
+  std::vector<DecisionTree> trees;
+  trees.reserve(forest->GetTrees().size());
+  for (const DecisionTree& tree : forest->GetTrees()) {
+    if (IsZeroTree(tree)) {
+      changed = true;
+      continue;
+    }
+    if (auto simplified = SimplifyTree(tree, constants);
+        simplified.has_value()) {
+      changed = true;
+      trees.push_back(*std::move(simplified));
+    } else {
+      trees.push_back(tree);
+    }
+  }
+  if (!changed) {
+    return forest;
+  }
+  return DecisionForest::FromTrees(std::move(trees));
+}
+
+}  // namespace arolla
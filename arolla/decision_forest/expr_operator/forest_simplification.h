@@ -0,0 +1,48 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_DECISION_FOREST_EXPR_OPERATOR_FOREST_SIMPLIFICATION_H_
+#define AROLLA_DECISION_FOREST_EXPR_OPERATOR_FOREST_SIMPLIFICATION_H_
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/qtype/typed_value.h"
+
+namespace arolla {
+
+// Returns a forest that gives the same results as `forest` for the inputs
+// having the values `constant_inputs` (input id -> value), but typically has
+// fewer split nodes. Applied when ForestModel is lowered, before the forest
+// evaluator is compiled.
+//
+// The simplifications:
+//   * splits on the constant inputs are replaced with the taken branch;
+//   * IntervalSplitConditions whose result follows from the interval
+//     conditions above them on the path (e.g. `x > 5` under `x > 10`) are
+//     replaced with the taken branch;
+//   * splits with identical subtrees in both branches are replaced with the
+//     subtree;
+//   * trees with zero weight and finite adjustments are removed.
+//
+// The value of a constant input must have the type required by the forest
+// or, for optional types, its value type. Other constants are ignored.
+// Returns `forest` itself if nothing was simplified.
+absl::StatusOr<DecisionForestPtr> SimplifyDecisionForest(
+    DecisionForestPtr forest,
+    const absl::flat_hash_map<int, TypedValue>& constant_inputs = {});
+
+}  // namespace arolla
+
+#endif  // AROLLA_DECISION_FOREST_EXPR_OPERATOR_FOREST_SIMPLIFICATION_H_
@@ -0,0 +1,178 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/expr_operator/forest_simplification.h"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/split_conditions/interval_split_condition.h"
+#include "arolla/decision_forest/split_conditions/set_of_values_split_condition.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+namespace {
+
+constexpr float inf = std::numeric_limits<float>::infinity();
+constexpr auto S = DecisionTreeNodeId::SplitNodeId;
+constexpr auto A = DecisionTreeNodeId::AdjustmentId;
+
+DecisionForestPtr MakeForest(std::vector<DecisionTree> trees) {
+  return *DecisionForest::FromTrees(std::move(trees));
+}
+
+TEST(ForestSimplificationTest, Unchanged) {
+  std::vector<DecisionTree> trees(2);
+  trees[0].adjustments = {0.5, 1.5};
+  trees[0].split_nodes = {{A(0), A(1), IntervalSplit(0, 1.5, inf)}};
+  trees[1].adjustments = {5};
+  DecisionForestPtr forest = MakeForest(std::move(trees));
+  ASSERT_OK_AND_ASSIGN(auto result, SimplifyDecisionForest(forest));
+  EXPECT_EQ(result, forest);
+}
+
+TEST(ForestSimplificationTest, ConstantInputs) {
+  std::vector<DecisionTree> trees(1);
+  trees[0].adjustments = {0.5, 1.5, 2.5, 3.5};
+  trees[0].split_nodes = {
+      {S(1), S(2), IntervalSplit(0, 1.5, inf)},
+      {A(0), A(1), SetOfValuesSplit<int64_t>(1, {5}, false)},
+      {A(2), A(3), IntervalSplit(0, -inf, 10)}};
+  DecisionForestPtr forest = MakeForest(std::move(trees));
+
+  std::vector<DecisionTree> expected_trees(1);
+  expected_trees[0].adjustments = {1.5, 2.5, 3.5};
+  expected_trees[0].split_nodes = {
+      {A(0), S(1), IntervalSplit(0, 1.5, inf)},
+      {A(1), A(2), IntervalSplit(0, -inf, 10)}};
+  DecisionForestPtr expected = MakeForest(std::move(expected_trees));
+
+  // The value type of the optional input.
+  ASSERT_OK_AND_ASSIGN(
+      auto result,
+      SimplifyDecisionForest(forest, {{1, TypedValue::FromValue<int64_t>(5)}}));
+  EXPECT_EQ(result->fingerprint(), expected->fingerprint());
+  // The required type.
+  ASSERT_OK_AND_ASSIGN(
+      result,
+      SimplifyDecisionForest(
+          forest, {{1, TypedValue::FromValue(OptionalValue<int64_t>(5))}}));
+  EXPECT_EQ(result->fingerprint(), expected->fingerprint());
+  // Both inputs.
+  ASSERT_OK_AND_ASSIGN(
+      result, SimplifyDecisionForest(
+                  forest, {{0, TypedValue::FromValue(1.0f)},
+                           {1, TypedValue::FromValue<int64_t>(5)}}));
+  expected_trees.resize(1);
+  expected_trees[0].adjustments = {1.5};
+  EXPECT_EQ(result->fingerprint(),
+            MakeForest(std::move(expected_trees))->fingerprint());
+  // Values of incompatible types are ignored.
+  ASSERT_OK_AND_ASSIGN(
+      result,
+      SimplifyDecisionForest(forest, {{1, TypedValue::FromValue(5.0f)},
+                                      {7, TypedValue::FromValue(5.0f)}}));
+  EXPECT_EQ(result, forest);
+}
+
+TEST(ForestSimplificationTest, SplitsImpliedByPath) {
+  std::vector<DecisionTree> trees(1);
+  trees[0].adjustments = {0, 1, 2, 3, 4};
+  trees[0].split_nodes = {
+      {S(1), S(2), IntervalSplit(0, -inf, 1)},
+      // x is missing, NaN or > 1.
+      {S(3), A(0), IntervalSplit(0, -inf, 0)},
+      // x <= 1.
+      {A(1), A(2), IntervalSplit(0, -inf, 2)},
+      {A(3), A(4), IntervalSplit(0, 0.5, inf)},
+  };
+  DecisionForestPtr forest = MakeForest(std::move(trees));
+
+  std::vector<DecisionTree> expected_trees(1);
+  expected_trees[0].adjustments = {2, 3, 4};
+  expected_trees[0].split_nodes = {{S(1), A(0), IntervalSplit(0, -inf, 1)},
+                                   {A(1), A(2), IntervalSplit(0, 0.5, inf)}};
+  ASSERT_OK_AND_ASSIGN(auto result, SimplifyDecisionForest(forest));
+  EXPECT_EQ(result->fingerprint(),
+            MakeForest(std::move(expected_trees))->fingerprint());
+}
+
+TEST(ForestSimplificationTest, DuplicateSubtrees) {
+  std::vector<DecisionTree> trees(1);
+  trees[0].adjustments = {1, 2, 7, 1, 2, 7};
+  trees[0].split_nodes = {
+      {S(1), S(3), IntervalSplit(0, 0, 1)},
+      {S(2), A(2), IntervalSplit(1, 0, 1)},
+      {A(0), A(1), IntervalSplit(2, 0, 1)},
+      {S(4), A(5), IntervalSplit(1, 0, 1)},
+      {A(3), A(4), IntervalSplit(2, 0, 1)},
+  };
+  DecisionForestPtr forest = MakeForest(std::move(trees));
+
+  std::vector<DecisionTree> expected_trees(1);
+  expected_trees[0].adjustments = {7, 1, 2};
+  expected_trees[0].split_nodes = {{S(1), A(0), IntervalSplit(1, 0, 1)},
+                                   {A(1), A(2), IntervalSplit(2, 0, 1)}};
+  ASSERT_OK_AND_ASSIGN(auto result, SimplifyDecisionForest(forest));
+  EXPECT_EQ(result->fingerprint(),
+            MakeForest(std::move(expected_trees))->fingerprint());
+}
+
+TEST(ForestSimplificationTest, SplitWithEqualChildren) {
+  std::vector<DecisionTree> trees(1);
+  trees[0].adjustments = {3, 3};
+  trees[0].weight = 0.5;
+  trees[0].tag.submodel_id = 1;
+  trees[0].split_nodes = {{A(0), A(1), IntervalSplit(0, 0, 1)}};
+  DecisionForestPtr forest = MakeForest(std::move(trees));
+
+  std::vector<DecisionTree> expected_trees(1);
+  expected_trees[0].adjustments = {3};
+  expected_trees[0].weight = 0.5;
+  expected_trees[0].tag.submodel_id = 1;
+  ASSERT_OK_AND_ASSIGN(auto result, SimplifyDecisionForest(forest));
+  EXPECT_EQ(result->fingerprint(),
+            MakeForest(std::move(expected_trees))->fingerprint());
+}
+
+TEST(ForestSimplificationTest, ZeroWeightTrees) {
+  std::vector<DecisionTree> trees(3);
+  trees[0].adjustments = {1};
+  trees[1].adjustments = {1, 2};
+  trees[1].split_nodes = {{A(0), A(1), IntervalSplit(0, 0, 1)}};
+  trees[1].weight = 0;
+  // 0 * inf is NaN, so the tree is kept.
+  trees[2].adjustments = {inf};
+  trees[2].weight = 0;
+  DecisionForestPtr forest = MakeForest(std::move(trees));
+
+  std::vector<DecisionTree> expected_trees(2);
+  expected_trees[0].adjustments = {1};
+  expected_trees[1].adjustments = {inf};
+  expected_trees[1].weight = 0;
+  ASSERT_OK_AND_ASSIGN(auto result, SimplifyDecisionForest(forest));
+  EXPECT_EQ(result->fingerprint(),
+            MakeForest(std::move(expected_trees))->fingerprint());
+}
+
+}  // namespace
+}  // namespace arolla
@@ -191,19 +191,36 @@ inline SinglePredictor<float, LessTest<float>> CompileRandomBalanced(
   return std::move(eval_or).value();
 }
 
-inline BoostedPredictor<float, LessTest<float>, std::plus<float>>
-CompileManyRandomBalanced(int depth, int num_features, int num_trees,
-                          absl::BitGen* rnd) {
+using BoostedCompiler =
+    BoostedPredictorCompiler<float, LessTest<float>, std::plus<float>>;
+
+void FillManyRandomBalanced(int depth, int num_features, int num_trees,
+                            absl::BitGen* rnd, BoostedCompiler* compiler) {
   const int num_splits = (1 << depth) - 1;
-  BoostedPredictorCompiler<float, LessTest<float>, std::plus<float>> compiler;
   for (int i = 0; i < num_trees; ++i) {
-    auto tree_compiler = compiler.AddTree(num_splits * 2 + 1);
+    auto tree_compiler = compiler->AddTree(num_splits * 2 + 1);
     FillRandomBalanced(depth, num_features, rnd, &tree_compiler);
   }
+}
+
+inline BoostedPredictor<float, LessTest<float>, std::plus<float>>
+CompileManyRandomBalanced(int depth, int num_features, int num_trees,
+                          absl::BitGen* rnd) {
+  BoostedCompiler compiler;
+  FillManyRandomBalanced(depth, num_features, num_trees, rnd, &compiler);
   auto eval_or = compiler.Compile();
   return std::move(eval_or).value();
 }
 
+inline PackedBoostedPredictor<float, LessTest<float>, std::plus<float>>
+CompileManyRandomBalancedPacked(int depth, int num_features, int num_trees,
+                                absl::BitGen* rnd) {
+  BoostedCompiler compiler;
+  FillManyRandomBalanced(depth, num_features, num_trees, rnd, &compiler);
+  auto eval_or = compiler.CompilePacked();
+  return std::move(eval_or).value();
+}
+
 SinglePredictor<float, LessTest<float>> CompileConstBalanced(int depth,
                                                              int num_features) {
   const int num_splits = (1 << depth) - 1;
@@ -273,12 +290,20 @@ BENCHMARK(BM_LowLevel_Evaluation)
     ->ArgPair(20, 10)
     ->ArgPair(20, 20);
 
+template <bool kPacked>
 void BM_LowLevel_EvaluationBoosted(benchmark::State& state) {
   int depth = state.range(0);
   int num_trees = state.range(1);
   constexpr size_t kNumFeatures = 50;
   absl::BitGen rnd;
-  auto eval = CompileManyRandomBalanced(depth, kNumFeatures, num_trees, &rnd);
+  auto eval = [&] {
+    if constexpr (kPacked) {
+      return CompileManyRandomBalancedPacked(depth, kNumFeatures, num_trees,
+                                             &rnd);
+    } else {
+      return CompileManyRandomBalanced(depth, kNumFeatures, num_trees, &rnd);
+    }
+  }();
   for (auto _ : state) {
     state.PauseTiming();
     std::vector<float> values;
@@ -293,7 +318,23 @@ void BM_LowLevel_EvaluationBoosted(benchmark::State& state) {
   state.SetItemsProcessed(state.iterations() * num_trees);
 }
 
-BENCHMARK(BM_LowLevel_EvaluationBoosted)
+// Compares BoostedPredictor (false) with PackedBoostedPredictor (true).
+BENCHMARK_TEMPLATE(BM_LowLevel_EvaluationBoosted, false)
+    ->ArgPair(3, 10)
+    ->ArgPair(3, 20)
+    ->ArgPair(3, 1000)
+    ->ArgPair(6, 1000)
+    ->ArgPair(9, 500)
+    ->ArgPair(15, 1)
+    ->ArgPair(15, 2)
+    ->ArgPair(15, 10)
+    ->ArgPair(15, 20)
+    ->ArgPair(15, 50)
+    ->ArgPair(20, 1)
+    ->ArgPair(20, 2)
+    ->ArgPair(20, 10)
+    ->ArgPair(20, 20);
+BENCHMARK_TEMPLATE(BM_LowLevel_EvaluationBoosted, true)
     ->ArgPair(3, 10)
     ->ArgPair(3, 20)
     ->ArgPair(3, 1000)
@@ -309,12 +350,20 @@ BENCHMARK(BM_LowLevel_EvaluationBoosted)
     ->ArgPair(20, 10)
     ->ArgPair(20, 20);
 
+template <bool kPacked>
 void BM_LowLevel_ProdBenchmarks(benchmark::State& state) {
   int depth = state.range(0);
   int num_trees = state.range(1);
   constexpr size_t kNumFeatures = 10;
   absl::BitGen rnd;
-  auto eval = CompileManyRandomBalanced(depth, kNumFeatures, num_trees, &rnd);
+  auto eval = [&] {
+    if constexpr (kPacked) {
+      return CompileManyRandomBalancedPacked(depth, kNumFeatures, num_trees,
+                                             &rnd);
+    } else {
+      return CompileManyRandomBalanced(depth, kNumFeatures, num_trees, &rnd);
+    }
+  }();
   for (auto _ : state) {
     state.PauseTiming();
     std::vector<float> values;
@@ -329,7 +378,14 @@ void BM_LowLevel_ProdBenchmarks(benchmark::State& state) {
   state.SetItemsProcessed(state.iterations());
 }
 
-BENCHMARK(BM_LowLevel_ProdBenchmarks)
+BENCHMARK_TEMPLATE(BM_LowLevel_ProdBenchmarks, false)
+    ->ArgPair(5, 500)
+    ->ArgPair(3, 100)
+    ->ArgPair(3, 1000)
+    ->ArgPair(1, 4000)
+    ->ArgPair(10, 200)
+    ->ArgPair(15, 30);
+BENCHMARK_TEMPLATE(BM_LowLevel_ProdBenchmarks, true)
     ->ArgPair(5, 500)
     ->ArgPair(3, 100)
     ->ArgPair(3, 1000)
@@ -14,10 +14,12 @@
 //
 #include "arolla/decision_forest/pointwise_evaluation/bitmask_builder.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -27,6 +29,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/decision_forest/pointwise_evaluation/bitmask_eval.h"
 #include "arolla/decision_forest/pointwise_evaluation/oblivious.h"
@@ -35,6 +38,7 @@
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/util/fast_dynamic_downcast_final.h"
+#include "arolla/util/memory_usage.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
@@ -117,6 +121,42 @@ void SortSplits(IntervalSplits* splits) {
                [](const auto& a, const auto& b) { return a.left < b.left; });
 }
 
+// Converts the mask to a narrower one. The dropped bits must be zero.
+template <typename Mask, size_t N>
+Mask NarrowMask(const MultiWordMask<N>& mask) {
+  if constexpr (std::is_integral_v<Mask>) {
+    DCHECK(mask == MultiWordMask<N>(static_cast<uint64_t>(mask)));
+    return static_cast<Mask>(static_cast<uint64_t>(mask));
+  } else {
+    return Mask(mask);
+  }
+}
+
+// Sums up results of several evaluators.
+class BitmaskEvalList final : public BitmaskEval {
+ public:
+  explicit BitmaskEvalList(std::vector<std::unique_ptr<BitmaskEval>> evals)
+      : evals_(std::move(evals)) {}
+
+  void IncrementalEval(ConstFramePtr input_ctx,
+                       FramePtr output_ctx) const final {
+    for (const auto& eval : evals_) {
+      eval->IncrementalEval(input_ctx, output_ctx);
+    }
+  }
+
+  size_t memory_usage() const final {
+    size_t result = sizeof(*this) + VectorMemoryUsage(evals_);
+    for (const auto& eval : evals_) {
+      result += eval->memory_usage();
+    }
+    return result;
+  }
+
+ private:
+  std::vector<std::unique_ptr<BitmaskEval>> evals_;
+};
+
 }  // namespace
 
 bool BitmaskBuilder::IsSplitNodeSupported(const SplitNode& node) {
@@ -131,7 +171,9 @@ void BitmaskBuilder::AddSmallTree(const DecisionTree& tree, int group_id) {
   combined_adjustments_size_ += tree.adjustments.size();
   // It never happens because we check it in forest_evaluator.cc.
   DCHECK_LE(tree.adjustments.size(), kMaxRegionsForBitmask);
-  if (tree.adjustments.size() > 32) mask_type_ = MASK64;
+  if (tree.adjustments.size() > 32 && tree.adjustments.size() <= 64) {
+    mask_type_ = MASK64;
+  }
   MaskedTree masked_tree{.group_id = group_id, .tag = tree.tag};
   masked_tree.splits.reserve(tree.split_nodes.size());
   masked_tree.adjustments.reserve(tree.adjustments.size());
@@ -154,11 +196,7 @@ void BitmaskBuilder::AddSmallTree(const DecisionTree& tree, int group_id) {
     }
   };
   auto full_tree_mask = dfs_fn(GetTreeRootId(tree), dfs_fn);
-  if (tree.adjustments.size() < sizeof(0ull) * 8) {
-    DCHECK_EQ(full_tree_mask, ~(~0ull << tree.adjustments.size()));
-  } else {  // Needed because for (x << 64) doesn't work for int64_t.
-    DCHECK_EQ(full_tree_mask, ~0ull);
-  }
+  DCHECK(full_tree_mask == ~(~WideMask(0) << tree.adjustments.size()));
   DCHECK_EQ(tree.adjustments.size(), masked_tree.adjustments.size());
   DCHECK_EQ(tree.split_nodes.size(), masked_tree.splits.size());
 
@@ -167,6 +205,7 @@ void BitmaskBuilder::AddSmallTree(const DecisionTree& tree, int group_id) {
 
 void BitmaskBuilder::AddObliviousTree(ObliviousDecisionTree&& tree,
                                       int group_id) {
+  DCHECK_LE(tree.layer_splits.size(), kMaxObliviousTreeDepth);
   if (tree.layer_splits.size() > 32) mask_type_ = MASK64;
   combined_adjustments_size_ += tree.adjustments.size();
   oblivious_trees_.push_back({group_id, tree.tag, std::move(tree)});
@@ -227,7 +266,7 @@ struct BitmaskBuilder::SplitsBuildingData {
 
   absl::Status AddSplit(const MaskedSplit& split, int tree_id) {
     typename EvalImpl::SplitMeta split_meta{
-        static_cast<Mask>(split.false_branch_mask), tree_id};
+        NarrowMask<Mask>(split.false_branch_mask), tree_id};
 
     auto interval_split =
         fast_dynamic_downcast_final<const IntervalSplitCondition*>(
@@ -304,7 +343,7 @@ absl::Status BitmaskBuilder::Build_ObliviousTree(
   Mask mask = tree.tree.adjustments.size();
   for (const auto& condition : tree.tree.layer_splits) {
     mask >>= 1;
-    RETURN_IF_ERROR(splits->AddSplit({mask, condition}, tree_id));
+    RETURN_IF_ERROR(splits->AddSplit({WideMask(mask), condition}, tree_id));
   }
   data->trees_metadata_.push_back(
       {tree.tree.tag.submodel_id, data->adjustments_.size()});
@@ -327,27 +366,28 @@ void BitmaskBuilder::SortTreesByGroupAndSubmodel() {
 }
 
 template <typename Mask>
-absl::StatusOr<std::unique_ptr<BitmaskEval>> BitmaskBuilder::BuildImpl() {
+absl::StatusOr<std::unique_ptr<BitmaskEval>> BitmaskBuilder::BuildImpl(
+    absl::Span<const MaskedTree> masked_trees,
+    absl::Span<const ObliviousWithGroupId> oblivious_trees) {
   SplitsBuildingData<Mask> splits{this};
 
   auto data = absl::WrapUnique(new BitmaskEvalImpl<Mask>());
-  data->trees_metadata_.reserve(masked_trees_.size() + oblivious_trees_.size());
+  data->trees_metadata_.reserve(masked_trees.size() + oblivious_trees.size());
   data->adjustments_.reserve(combined_adjustments_size_);
 
-  SortTreesByGroupAndSubmodel();
-  auto masked_iter = masked_trees_.begin();
-  auto oblivious_iter = oblivious_trees_.begin();
+  auto masked_iter = masked_trees.begin();
+  auto oblivious_iter = oblivious_trees.begin();
   for (int group_id = 0; group_id < output_slots_.size(); ++group_id) {
     typename BitmaskEvalImpl<Mask>::GroupMetadata group{
         .output_slot = output_slots_[group_id]};
     group.regular_tree_range.first = data->trees_metadata_.size();
-    while (masked_iter != masked_trees_.end() &&
+    while (masked_iter != masked_trees.end() &&
            masked_iter->group_id == group_id) {
       RETURN_IF_ERROR(Build_MaskedTree(*masked_iter++, &splits, data.get()));
     }
     group.regular_tree_range.second = data->trees_metadata_.size();
     group.oblivious_tree_range.first = data->trees_metadata_.size();
-    while (oblivious_iter != oblivious_trees_.end() &&
+    while (oblivious_iter != oblivious_trees.end() &&
            oblivious_iter->group_id == group_id) {
       RETURN_IF_ERROR(
           Build_ObliviousTree(*oblivious_iter++, &splits, data.get()));
@@ -385,12 +425,38 @@ absl::StatusOr<std::unique_ptr<BitmaskEval>> BitmaskBuilder::BuildImpl() {
 }
 
 absl::StatusOr<std::unique_ptr<BitmaskEval>> BitmaskBuilder::Build() && {
-  if (masked_trees_.empty() && oblivious_trees_.empty()) {
+  SortTreesByGroupAndSubmodel();
+  // Stable partition keeps the trees sorted by group in both parts.
+  auto wide_trees_begin = std::stable_partition(
+      masked_trees_.begin(), masked_trees_.end(),
+      [](const MaskedTree& tree) { return tree.adjustments.size() <= 64; });
+  absl::Span<const MaskedTree> small_trees(
+      masked_trees_.data(), wide_trees_begin - masked_trees_.begin());
+  absl::Span<const MaskedTree> wide_trees(
+      masked_trees_.data() + small_trees.size(),
+      masked_trees_.size() - small_trees.size());
+
+  std::vector<std::unique_ptr<BitmaskEval>> evals;
+  if (!small_trees.empty() || !oblivious_trees_.empty()) {
+    ASSIGN_OR_RETURN(evals.emplace_back(),
+                     mask_type_ == MASK32
+                         ? BuildImpl<uint32_t>(small_trees, oblivious_trees_)
+                         : BuildImpl<uint64_t>(small_trees, oblivious_trees_));
+  }
+  if (!wide_trees.empty()) {
+    const bool fits_128 = absl::c_all_of(wide_trees, [](const auto& tree) {
+      return tree.adjustments.size() <= 128;
+    });
+    ASSIGN_OR_RETURN(evals.emplace_back(),
+                     fits_128 ? BuildImpl<MultiWordMask<2>>(wide_trees, {})
+                              : BuildImpl<MultiWordMask<4>>(wide_trees, {}));
+  }
+  if (evals.empty()) {
     return nullptr;
-  } else if (mask_type_ == MASK32) {
-    return BuildImpl<uint32_t>();
+  } else if (evals.size() == 1) {
+    return std::move(evals[0]);
   } else {
-    return BuildImpl<uint64_t>();
+    return std::make_unique<BitmaskEvalList>(std::move(evals));
   }
 }
 
@@ -35,10 +35,13 @@ namespace arolla {
 // Used to construct BitmaskEval.
 class BitmaskBuilder {
  private:
-  using WideMask = uint64_t;
+  using WideMask = MultiWordMask<4>;
 
  public:
+  // Trees with more than 64 leaves are evaluated separately using multi-word
+  // masks, so that they don't slow down evaluation of the small trees.
   static constexpr size_t kMaxRegionsForBitmask = sizeof(WideMask) * 8;
+  static constexpr size_t kMaxObliviousTreeDepth = sizeof(uint64_t) * 8;
 
   explicit BitmaskBuilder(
       absl::Span<const TypedSlot> input_slots,
@@ -86,8 +89,11 @@ class BitmaskBuilder {
 
   void SortTreesByGroupAndSubmodel();
 
+  // Builds evaluator for the given trees. The trees must be sorted by group.
   template <typename TreeMask>
-  absl::StatusOr<std::unique_ptr<BitmaskEval>> BuildImpl();
+  absl::StatusOr<std::unique_ptr<BitmaskEval>> BuildImpl(
+      absl::Span<const MaskedTree> masked_trees,
+      absl::Span<const ObliviousWithGroupId> oblivious_trees);
 
   size_t combined_adjustments_size_ = 0;
   std::vector<TypedSlot> input_slots_;
@@ -28,6 +28,7 @@
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/util/bits.h"
+#include "arolla/util/memory_usage.h"
 
 namespace arolla {
 
@@ -48,6 +49,24 @@ void ApplyMaskForRange(Iter from, Iter to,
   }
 }
 
+// Returns index of the least significant zero bit in `mask`.
+template <typename TreeMask>
+int FindLSBUnset(TreeMask mask) {
+  DCHECK_NE(~mask, 0);
+  return FindLSBSetNonZero(~mask);
+}
+
+template <size_t N>
+int FindLSBUnset(const MultiWordMask<N>& mask) {
+  for (size_t i = 0; i + 1 < N; ++i) {
+    if (ABSL_PREDICT_TRUE(~mask.words[i] != 0)) {
+      return i * 64 + FindLSBSetNonZero(~mask.words[i]);
+    }
+  }
+  DCHECK_NE(~mask.words[N - 1], 0);
+  return (N - 1) * 64 + FindLSBSetNonZero(~mask.words[N - 1]);
+}
+
 }  // namespace
 
 template <typename TreeMask>
@@ -158,12 +177,11 @@ void BitmaskEvalImpl<TreeMask>::InternalEval(const ConstFramePtr input_ctx,
   for (const auto& group : groups_) {
     *output_ctx.GetMutable(group.output_slot) +=
         process_fn(tree_masks, group.regular_tree_range,
-                   [](TreeMask mask) {
-                     DCHECK_NE(~mask, 0);
-                     return FindLSBSetNonZero(~mask);
-                   }) +
+                   [](const TreeMask& mask) { return FindLSBUnset(mask); }) +
         process_fn(tree_masks, group.oblivious_tree_range,
-                   [](TreeMask mask) { return mask; });
+                   [](const TreeMask& mask) {
+                     return static_cast<uint64_t>(mask);
+                   });
   }
 }
 
@@ -202,7 +220,42 @@ void BitmaskEvalImpl<TreeMask>::IncrementalEval(const ConstFramePtr input_ctx,
   InternalEval(input_ctx, output_ctx, process_fn);
 }
 
+template <typename TreeMask>
+size_t BitmaskEvalImpl<TreeMask>::memory_usage() const {
+  size_t result = sizeof(*this) + VectorMemoryUsage(trees_metadata_) +
+                  VectorMemoryUsage(groups_) + VectorMemoryUsage(adjustments_);
+  for (const auto* grouped_splits : {&splits_.left_splits_grouped_by_input,
+                                     &splits_.right_splits_grouped_by_input}) {
+    result += VectorMemoryUsage(*grouped_splits);
+    for (const auto& splits : *grouped_splits) {
+      result += VectorMemoryUsage(splits.metas) +
+                VectorMemoryUsage(splits.thresholds);
+    }
+  }
+  result += VectorMemoryUsage(splits_.eq_splits_grouped_by_input);
+  for (const auto& splits : splits_.eq_splits_grouped_by_input) {
+    result += VectorMemoryUsage(splits.metas) +
+              VectorMemoryUsage(splits.values) +
+              HashTableMemoryUsage(splits.value2range);
+  }
+  result += VectorMemoryUsage(splits_.range_splits_grouped_by_input);
+  for (const auto& splits : splits_.range_splits_grouped_by_input) {
+    result += VectorMemoryUsage(splits.range_splits);
+  }
+  result += VectorMemoryUsage(splits_.set_of_values_int64_grouped_by_input);
+  for (const auto& splits : splits_.set_of_values_int64_grouped_by_input) {
+    result += HashTableMemoryUsage(splits.metas) +
+              VectorMemoryUsage(splits.metas_with_default_true);
+    for (const auto& [value, metas] : splits.metas) {
+      result += VectorMemoryUsage(metas);
+    }
+  }
+  return result;
+}
+
 template class BitmaskEvalImpl<uint32_t>;
 template class BitmaskEvalImpl<uint64_t>;
+template class BitmaskEvalImpl<MultiWordMask<2>>;
+template class BitmaskEvalImpl<MultiWordMask<4>>;
 
 }  // namespace arolla
@@ -15,6 +15,8 @@
 #ifndef AROLLA_DECISION_FOREST_POINTWISE_EVALUATION_BITMASK_EVAL_H_
 #define AROLLA_DECISION_FOREST_POINTWISE_EVALUATION_BITMASK_EVAL_H_
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <utility>
@@ -27,6 +29,75 @@
 
 namespace arolla {
 
+// Bitmask of N 64-bit words. Used as TreeMask for trees with more than 64
+// leaves. Implements the subset of integer operations needed by
+// BitmaskEvalImpl and BitmaskBuilder.
+template <size_t N>
+struct MultiWordMask {
+  MultiWordMask() = default;
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  constexpr MultiWordMask(uint64_t word) : words{word} {}
+  template <size_t M>
+  explicit MultiWordMask(const MultiWordMask<M>& other) {
+    for (size_t i = 0; i < std::min(N, M); ++i) {
+      words[i] = other.words[i];
+    }
+  }
+
+  // Returns the lowest word.
+  explicit operator uint64_t() const { return words[0]; }
+
+  MultiWordMask& operator|=(const MultiWordMask& other) {
+    for (size_t i = 0; i < N; ++i) {
+      words[i] |= other.words[i];
+    }
+    return *this;
+  }
+  MultiWordMask operator|(const MultiWordMask& other) const {
+    MultiWordMask result = *this;
+    return result |= other;
+  }
+  MultiWordMask operator~() const {
+    MultiWordMask result;
+    for (size_t i = 0; i < N; ++i) {
+      result.words[i] = ~words[i];
+    }
+    return result;
+  }
+  MultiWordMask operator<<(size_t shift) const {
+    MultiWordMask result;
+    const size_t word_shift = shift / 64;
+    const size_t bit_shift = shift % 64;
+    for (size_t i = word_shift; i < N; ++i) {
+      result.words[i] = words[i - word_shift] << bit_shift;
+      if (bit_shift != 0 && i > word_shift) {
+        result.words[i] |= words[i - word_shift - 1] >> (64 - bit_shift);
+      }
+    }
+    return result;
+  }
+  MultiWordMask& operator>>=(size_t shift) {
+    MultiWordMask result;
+    const size_t word_shift = shift / 64;
+    const size_t bit_shift = shift % 64;
+    for (size_t i = 0; i + word_shift < N; ++i) {
+      result.words[i] = words[i + word_shift] >> bit_shift;
+      if (bit_shift != 0 && i + word_shift + 1 < N) {
+        result.words[i] |= words[i + word_shift + 1] << (64 - bit_shift);
+      }
+    }
+    return *this = result;
+  }
+  bool operator==(const MultiWordMask& other) const {
+    return words == other.words;
+  }
+  bool operator!=(const MultiWordMask& other) const {
+    return words != other.words;
+  }
+
+  std::array<uint64_t, N> words = {};
+};
+
 // In bit mask forest evaluation tree is represented as collection of splits.
 // We enumerate leaves of the tree by "In-order", where left child is false.
 // For each split (internal node) we precompute bit mask of leaves in
@@ -40,6 +111,9 @@ class BitmaskEval {
   // to corresponding slots in output_ctx.
   virtual void IncrementalEval(ConstFramePtr input_ctx,
                                FramePtr output_ctx) const = 0;
+
+  // Returns an estimate of the heap memory used by the evaluator.
+  virtual size_t memory_usage() const = 0;
 };
 
 template <typename TreeMask>
@@ -52,6 +126,8 @@ class BitmaskEvalImpl : public BitmaskEval {
   void IncrementalEval(ConstFramePtr input_ctx,
                        FramePtr output_ctx) const final;
 
+  size_t memory_usage() const final;
+
  private:
   BitmaskEvalImpl() = default;
   friend class BitmaskBuilder;
@@ -193,6 +269,8 @@ class BitmaskEvalImpl : public BitmaskEval {
 
 extern template class BitmaskEvalImpl<uint32_t>;
 extern template class BitmaskEvalImpl<uint64_t>;
+extern template class BitmaskEvalImpl<MultiWordMask<2>>;
+extern template class BitmaskEvalImpl<MultiWordMask<4>>;
 
 }  // namespace arolla
 
@@ -15,8 +15,14 @@
 #ifndef AROLLA_DECISION_FOREST_POINTWISE_EVALUATION_BOUND_SPLIT_CONDITIONS_H_
 #define AROLLA_DECISION_FOREST_POINTWISE_EVALUATION_BOUND_SPLIT_CONDITIONS_H_
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <type_traits>
 #include <variant>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
@@ -61,12 +67,101 @@ struct IntervalBoundCondition {
   }
 };
 
+namespace bound_split_conditions_internal {
+
+// Set of values optimized for membership tests. The representation is chosen
+// on construction:
+//  - a bitset over [min, max] for integral values with a small range,
+//  - a branchless linear scan for up to kMaxLinearSize arithmetic values,
+//  - absl::flat_hash_set otherwise.
+template <class T>
+class ValueSet {
+ public:
+  static constexpr size_t kMaxLinearSize = 8;
+  static constexpr uint64_t kMaxBitsetRange = 1024;
+
+  ValueSet() = default;
+
+  explicit ValueSet(const absl::flat_hash_set<T>& values) {
+    if constexpr (std::is_integral_v<T>) {
+      if (!values.empty()) {
+        auto [min_it, max_it] =
+            std::minmax_element(values.begin(), values.end());
+        uint64_t range =
+            static_cast<uint64_t>(*max_it) - static_cast<uint64_t>(*min_it);
+        if (range < kMaxBitsetRange) {
+          Bitset bitset{.min_value = *min_it,
+                        .words = std::vector<uint64_t>(range / 64 + 1)};
+          for (const T& v : values) {
+            uint64_t bit = bitset.BitIndex(v);
+            bitset.words[bit / 64] |= uint64_t{1} << (bit % 64);
+          }
+          impl_ = std::move(bitset);
+          return;
+        }
+      }
+    }
+    if constexpr (std::is_arithmetic_v<T>) {
+      if (!values.empty() && values.size() <= kMaxLinearSize) {
+        Linear linear;
+        // Padding with a copy of a present value keeps the scan fixed size.
+        linear.values.fill(*values.begin());
+        std::copy(values.begin(), values.end(), linear.values.begin());
+        impl_ = linear;
+        return;
+      }
+    }
+    impl_ = values;
+  }
+
+  bool contains(const T& v) const {
+    return std::visit([&v](const auto& impl) { return impl.contains(v); },
+                      impl_);
+  }
+
+ private:
+  struct Bitset {
+    T min_value;
+    std::vector<uint64_t> words;
+
+    // Unsigned arithmetic makes the subtraction well defined for any range.
+    uint64_t BitIndex(const T& v) const {
+      return static_cast<uint64_t>(v) - static_cast<uint64_t>(min_value);
+    }
+    bool contains(const T& v) const {
+      if constexpr (std::is_integral_v<T>) {
+        uint64_t bit = BitIndex(v);
+        return bit < words.size() * 64 &&
+               ((words[bit / 64] >> (bit % 64)) & 1);
+      } else {
+        return false;  // Never constructed for non-integral types.
+      }
+    }
+  };
+
+  struct Linear {
+    std::array<T, kMaxLinearSize> values;
+
+    bool contains(const T& v) const {
+      bool found = false;
+      for (const T& x : values) {
+        found |= (x == v);
+      }
+      return found;
+    }
+  };
+
+  std::variant<absl::flat_hash_set<T>, Bitset, Linear> impl_;
+};
+
+}  // namespace bound_split_conditions_internal
+
 template <class T>
 struct SetOfValuesBoundCondition {
   FrameLayout::Slot<OptionalValue<T>> input_slot =
       // should be default constructible
       FrameLayout::Slot<OptionalValue<T>>::UnsafeUninitializedSlot();
-  absl::flat_hash_set<T> values;
+  bound_split_conditions_internal::ValueSet<T> values;
   bool result_if_missed;
   bool operator()(const ConstFramePtr ctx) const {
     const OptionalValue<T>& v = ctx.Get(input_slot);
@@ -81,8 +176,10 @@ struct SetOfValuesBoundCondition {
     ASSIGN_OR_RETURN(
         auto input_slot,
         input_slots[cond->input_id()].template ToSlot<OptionalValue<T>>());
-    return SetOfValuesBoundCondition{input_slot, cond->values(),
-                                     cond->GetDefaultResultForMissedInput()};
+    return SetOfValuesBoundCondition{
+        input_slot,
+        bound_split_conditions_internal::ValueSet<T>(cond->values()),
+        cond->GetDefaultResultForMissedInput()};
   }
 };
 
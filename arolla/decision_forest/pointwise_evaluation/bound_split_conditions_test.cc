@@ -16,11 +16,13 @@
 
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_set.h"
 #include "arolla/decision_forest/split_conditions/interval_split_condition.h"
 #include "arolla/decision_forest/split_conditions/set_of_values_split_condition.h"
 #include "arolla/memory/frame.h"
@@ -91,6 +93,45 @@ TEST(BoundConditions, SetOfValuesSplitCondition) {
   EXPECT_EQ(bound_set_of_values(context), true);
 }
 
+TEST(BoundConditions, SetOfValuesSplitConditionRepresentations) {
+  constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+  constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+  absl::flat_hash_set<int64_t> large_sparse_set;
+  for (int64_t i = 0; i < 20; ++i) {
+    large_sparse_set.insert(i * 100000 - 1000000);
+  }
+
+  FrameLayout::Builder bldr;
+  auto slot = bldr.AddSlot<OptionalValue<int64_t>>();
+  std::vector<TypedSlot> typed_slots = {TypedSlot::FromSlot(slot)};
+  auto layout = std::move(bldr).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr context = alloc.frame();
+
+  // Dense range (bitset), small sparse set (linear scan), large sparse set
+  // (hash set), and an empty set.
+  for (const auto& values :
+       std::vector<absl::flat_hash_set<int64_t>>{{-5, 0, 3, 1000},
+                                                 {kMin, -7, 7, kMax},
+                                                 large_sparse_set,
+                                                 {}}) {
+    ASSERT_OK_AND_ASSIGN(
+        auto bound_set_of_values,
+        SetOfValuesBoundCondition<int64_t>::Create(
+            SetOfValuesSplit<int64_t>(0, values, false), typed_slots));
+    for (int64_t v : {kMin, kMin + 1, int64_t{-1000001}, int64_t{-1000000},
+                      int64_t{-7}, int64_t{-6}, int64_t{-5}, int64_t{0},
+                      int64_t{1}, int64_t{3}, int64_t{7}, int64_t{999},
+                      int64_t{1000}, int64_t{1001}, int64_t{800000},
+                      kMax - 1, kMax}) {
+      context.Set(slot, v);
+      EXPECT_EQ(bound_set_of_values(context), values.contains(v)) << v;
+    }
+    context.Set(slot, {});
+    EXPECT_FALSE(bound_set_of_values(context));
+  }
+}
+
 TEST(BoundConditions, VirtualBoundCondition) {
   auto set_of_values =
       SetOfValuesSplit<Bytes>(0, {Bytes("A"), Bytes("B"), Bytes("C")}, true);
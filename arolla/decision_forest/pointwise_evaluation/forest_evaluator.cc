@@ -15,15 +15,21 @@
 #include "arolla/decision_forest/pointwise_evaluation/forest_evaluator.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <memory>
+#include <new>
 #include <optional>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
@@ -36,8 +42,12 @@
 #include "arolla/decision_forest/split_condition.h"
 #include "arolla/decision_forest/split_conditions/interval_split_condition.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/fast_dynamic_downcast_final.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/memory_usage.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
@@ -74,6 +84,20 @@ absl::StatusOr<std::vector<int>> SplitTreesByGroups(
   return tree2group;
 }
 
+// Trees with equal fingerprints differ only in adjustments and weight.
+Fingerprint SplitsFingerprint(const DecisionTree& tree) {
+  FingerprintHasher hasher("arolla::ForestEvaluator::Splits");
+  hasher.CombineSpan(tree.split_nodes);
+  return std::move(hasher).Finish();
+}
+
+// Maps a node of DecisionTree to the node id used by the tree compilers:
+// split nodes keep their index, leaves follow them.
+int64_t ToCompilerNodeId(const DecisionTree& tree, DecisionTreeNodeId id) {
+  return id.is_leaf() ? id.adjustment_index() + tree.split_nodes.size()
+                      : id.split_node_index();
+}
+
 std::optional<SplitCondition::InputSignature> GetSingleInputSignature(
     const DecisionTree& tree) {
   std::optional<SplitCondition::InputSignature> input_signature;
@@ -88,6 +112,21 @@ std::optional<SplitCondition::InputSignature> GetSingleInputSignature(
   return input_signature;
 }
 
+// Frame holding the single float output of an early exit stage.
+struct StageFrame {
+  FrameLayout layout;
+  FrameLayout::Slot<float> slot;
+};
+
+const StageFrame& GetStageFrame() {
+  static const Indestructible<StageFrame> result([](void* self) {
+    FrameLayout::Builder builder;
+    auto slot = builder.AddSlot<float>();
+    new (self) StageFrame{std::move(builder).Build(), slot};
+  });
+  return *result;
+}
+
 }  // namespace
 
 class ForestEvaluator::RegularPredictorsBuilder {
@@ -143,17 +182,10 @@ class ForestEvaluator::RegularPredictorsBuilder {
         tree.tag.submodel_id);
     for (int64_t id = 0; id < tree.split_nodes.size(); ++id) {
       const auto& split_node = tree.split_nodes[id];
-      auto child_if_false = split_node.child_if_false.is_leaf()
-                                ? split_node.child_if_false.adjustment_index() +
-                                      tree.split_nodes.size()
-                                : split_node.child_if_false.split_node_index();
-      auto child_if_true = split_node.child_if_true.is_leaf()
-                               ? split_node.child_if_true.adjustment_index() +
-                                     tree.split_nodes.size()
-                               : split_node.child_if_true.split_node_index();
       ASSIGN_OR_RETURN(auto cond, create_cond(split_node.condition));
-      RETURN_IF_ERROR(
-          tree_compiler.SetNode(id, child_if_true, child_if_false, cond));
+      RETURN_IF_ERROR(tree_compiler.SetNode(
+          id, ToCompilerNodeId(tree, split_node.child_if_true),
+          ToCompilerNodeId(tree, split_node.child_if_false), cond));
     }
     for (int64_t i = 0; i < tree.adjustments.size(); ++i) {
       RETURN_IF_ERROR(tree_compiler.SetLeaf(i + tree.split_nodes.size(),
@@ -175,6 +207,26 @@ absl::StatusOr<ForestEvaluator> ForestEvaluator::Compile(
     CompilationParams params) {
   ASSIGN_OR_RETURN(auto tree2group,
                    SplitTreesByGroups(decision_forest.GetTrees(), outputs));
+  // Outputs with early exit are evaluated separately, so their trees are
+  // excluded from the main predictors. The main predictors still write zeros
+  // to their slots, which are overwritten later.
+  std::vector<EarlyExitOutput> early_exit_outputs;
+  for (int group_id = 0; group_id < outputs.size(); ++group_id) {
+    if (!outputs[group_id].early_exit_cutoff.has_value()) {
+      continue;
+    }
+    std::vector<DecisionTree> trees;
+    for (size_t i = 0; i < tree2group.size(); ++i) {
+      if (tree2group[i] == group_id) {
+        trees.push_back(decision_forest.GetTrees()[i]);
+        tree2group[i] = -1;
+      }
+    }
+    ASSIGN_OR_RETURN(auto early_exit_output,
+                     CompileEarlyExitOutput(trees, input_slots,
+                                            outputs[group_id], params));
+    early_exit_outputs.push_back(std::move(early_exit_output));
+  }
   std::vector<FrameLayout::Slot<float>> output_slots;
   output_slots.reserve(outputs.size());
   for (const auto& output : outputs) {
@@ -184,6 +236,10 @@ absl::StatusOr<ForestEvaluator> ForestEvaluator::Compile(
   BitmaskBuilder bitmask_builder(input_slots, output_slots);
   SingleInputBuilder single_input_builder(input_slots, output_slots);
   std::vector<std::map<int, double>> consts(outputs.size());
+  // Trees for the regular evaluation with identical splits, in the order of
+  // the first tree of each cluster.
+  std::vector<std::vector<size_t>> regular_clusters;
+  absl::flat_hash_map<Fingerprint, size_t> regular_cluster_ids;
   if (tree2group.size() != decision_forest.GetTrees().size()) {
     return absl::InternalError("size of tree2group doesn't match trees");
   }
@@ -219,7 +275,7 @@ absl::StatusOr<ForestEvaluator> ForestEvaluator::Compile(
                     BitmaskBuilder::IsSplitNodeSupported)) {
       auto oblivious = ToObliviousTree(tree);
       if (oblivious.has_value() && (oblivious->layer_splits.size() <=
-                                    BitmaskBuilder::kMaxRegionsForBitmask)) {
+                                    BitmaskBuilder::kMaxObliviousTreeDepth)) {
         bitmask_builder.AddObliviousTree(std::move(*oblivious), tree2group[i]);
         continue;
       }
@@ -229,13 +285,33 @@ absl::StatusOr<ForestEvaluator> ForestEvaluator::Compile(
       }
     }
 
-    if (params.enable_regular_eval) {
+    if (params.enable_regular_eval && params.enable_multi_output_eval) {
+      auto [it, inserted] = regular_cluster_ids.emplace(
+          SplitsFingerprint(tree), regular_clusters.size());
+      if (inserted) {
+        regular_clusters.emplace_back();
+      }
+      regular_clusters[it->second].push_back(i);
+    } else if (params.enable_regular_eval) {
       RETURN_IF_ERROR(regular_builder.AddTree(tree, tree2group[i]));
     } else {
       return absl::InvalidArgumentError(
           "No suitable evaluator. Use enable_regular_eval=true.");
     }
   }
+  std::vector<MultiOutputTree> multi_output_trees;
+  for (const std::vector<size_t>& cluster : regular_clusters) {
+    if (cluster.size() == 1) {
+      RETURN_IF_ERROR(regular_builder.AddTree(
+          decision_forest.GetTrees()[cluster[0]], tree2group[cluster[0]]));
+      continue;
+    }
+    ASSIGN_OR_RETURN(auto multi_output_tree,
+                     CompileMultiOutputTree(decision_forest.GetTrees(), cluster,
+                                            tree2group, outputs.size(),
+                                            input_slots));
+    multi_output_trees.push_back(std::move(multi_output_tree));
+  }
   for (int group_id = 0; group_id < consts.size(); ++group_id) {
     for (const auto& [submodel_id, value] : consts[group_id]) {
       DecisionTree tree;
@@ -251,19 +327,212 @@ absl::StatusOr<ForestEvaluator> ForestEvaluator::Compile(
                    std::move(single_input_builder).Build());
   return ForestEvaluator(std::move(output_slots), std::move(regular_predictors),
                          std::move(bitmask_predictor),
-                         std::move(single_input_predictor));
+                         std::move(single_input_predictor),
+                         std::move(multi_output_trees),
+                         std::move(early_exit_outputs));
+}
+
+absl::StatusOr<ForestEvaluator::MultiOutputTree>
+ForestEvaluator::CompileMultiOutputTree(
+    absl::Span<const DecisionTree> trees, absl::Span<const size_t> tree_ids,
+    absl::Span<const int> tree2group, int group_count,
+    absl::Span<const TypedSlot> input_slots) {
+  DCHECK(!tree_ids.empty());
+  const DecisionTree& first_tree = trees[tree_ids[0]];
+  MultiOutputTree result;
+  // Trees of the same group are summed up into a single column.
+  std::vector<int> group_to_column(group_count, -1);
+  for (size_t tree_id : tree_ids) {
+    int group_id = tree2group[tree_id];
+    if (group_to_column[group_id] == -1) {
+      group_to_column[group_id] = result.outputs.size();
+      result.outputs.push_back(group_id);
+    }
+  }
+  const size_t width = result.outputs.size();
+  result.adjustments.assign(first_tree.adjustments.size() * width, 0.0);
+  for (size_t tree_id : tree_ids) {
+    const DecisionTree& tree = trees[tree_id];
+    const int column = group_to_column[tree2group[tree_id]];
+    for (size_t leaf = 0; leaf < tree.adjustments.size(); ++leaf) {
+      result.adjustments[leaf * width + column] +=
+          tree.adjustments[leaf] * tree.weight;
+    }
+  }
+
+  internal::SingleTreeCompilationImpl<int32_t, UniversalBoundCondition>
+      compiler(first_tree.split_nodes.size() + first_tree.adjustments.size());
+  for (int64_t id = 0; id < first_tree.split_nodes.size(); ++id) {
+    const auto& split_node = first_tree.split_nodes[id];
+    ASSIGN_OR_RETURN(
+        auto cond, UniversalBoundCondition::Create(split_node.condition,
+                                                   input_slots));
+    RETURN_IF_ERROR(compiler.SetNode(
+        id, ToCompilerNodeId(first_tree, split_node.child_if_true),
+        ToCompilerNodeId(first_tree, split_node.child_if_false), cond));
+  }
+  for (int64_t i = 0; i < first_tree.adjustments.size(); ++i) {
+    RETURN_IF_ERROR(
+        compiler.SetLeaf(i + first_tree.split_nodes.size(), i));
+  }
+  ASSIGN_OR_RETURN(result.tree, compiler.Compile());
+  return result;
+}
+
+void ForestEvaluator::MultiOutputTree::Eval(ConstFramePtr input_ctx,
+                                            absl::Span<double> sums) const {
+  internal::DecisionTreeTraverser<int32_t, UniversalBoundCondition> traverser(
+      tree);
+  while (traverser.CanStep()) {
+    traverser.MakeStep(input_ctx);
+  }
+  const double* leaf_adjustments =
+      adjustments.data() + traverser.GetValue() * outputs.size();
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    sums[outputs[i]] += leaf_adjustments[i];
+  }
+}
+
+absl::StatusOr<ForestEvaluator::EarlyExitOutput>
+ForestEvaluator::CompileEarlyExitOutput(absl::Span<const DecisionTree> trees,
+                                        absl::Span<const TypedSlot> input_slots,
+                                        const Output& output,
+                                        CompilationParams params) {
+  if (params.early_exit_trees_per_stage < 1) {
+    return absl::InvalidArgumentError(
+        "early_exit_trees_per_stage must be positive");
+  }
+  struct TreeBounds {
+    const DecisionTree* tree;
+    double min;
+    double max;
+  };
+  std::vector<TreeBounds> bounds;
+  bounds.reserve(trees.size());
+  for (const DecisionTree& tree : trees) {
+    if (tree.adjustments.empty()) {
+      return absl::InvalidArgumentError("tree without adjustments");
+    }
+    auto [min_adj, max_adj] = absl::c_minmax_element(tree.adjustments);
+    double a = static_cast<double>(*min_adj) * tree.weight;
+    double b = static_cast<double>(*max_adj) * tree.weight;
+    bounds.push_back({&tree, std::min(a, b), std::max(a, b)});
+  }
+  // The trees with the widest range of adjustments go first, so the bounds
+  // on the remaining trees shrink as fast as possible.
+  absl::c_stable_sort(bounds, [](const TreeBounds& a, const TreeBounds& b) {
+    return a.max - a.min > b.max - b.min;
+  });
+
+  Output stage_output{.filter = {}, .slot = GetStageFrame().slot};
+  EarlyExitOutput result{.slot = output.slot,
+                         .cutoff = *output.early_exit_cutoff};
+  std::vector<double> stage_min;
+  std::vector<double> stage_max;
+  for (size_t begin = 0; begin < bounds.size();
+       begin += params.early_exit_trees_per_stage) {
+    size_t end = std::min<size_t>(
+        bounds.size(), begin + params.early_exit_trees_per_stage);
+    std::vector<DecisionTree> stage_trees;
+    stage_trees.reserve(end - begin);
+    double min_sum = 0;
+    double max_sum = 0;
+    for (size_t i = begin; i < end; ++i) {
+      stage_trees.push_back(*bounds[i].tree);
+      min_sum += bounds[i].min;
+      max_sum += bounds[i].max;
+    }
+    ASSIGN_OR_RETURN(auto stage_forest,
+                     DecisionForest::FromTrees(std::move(stage_trees)));
+    ASSIGN_OR_RETURN(auto stage, Compile(*stage_forest, input_slots,
+                                         {stage_output}, params));
+    result.stages.push_back(std::move(stage));
+    stage_min.push_back(min_sum);
+    stage_max.push_back(max_sum);
+  }
+  result.remaining_min.resize(stage_min.size() + 1, 0.0);
+  result.remaining_max.resize(stage_max.size() + 1, 0.0);
+  for (size_t i = stage_min.size(); i > 0; --i) {
+    result.remaining_min[i - 1] = result.remaining_min[i] + stage_min[i - 1];
+    result.remaining_max[i - 1] = result.remaining_max[i] + stage_max[i - 1];
+  }
+  return result;
+}
+
+float ForestEvaluator::EarlyExitOutput::Eval(ConstFramePtr input_ctx) const {
+  const StageFrame& stage_frame = GetStageFrame();
+  MemoryAllocation stage_alloc(&stage_frame.layout);
+  double sum = 0;
+  for (size_t i = 0; i < stages.size(); ++i) {
+    if (sum + remaining_min[i] > cutoff) {
+      // The score is above the cutoff regardless of the remaining trees.
+      float bound = static_cast<float>(sum + remaining_min[i]);
+      return bound > cutoff
+                 ? bound
+                 : std::nextafter(cutoff, std::numeric_limits<float>::max());
+    }
+    if (sum + remaining_max[i] <= cutoff) {
+      // The score is not above the cutoff regardless of the remaining trees.
+      return std::min(static_cast<float>(sum + remaining_max[i]), cutoff);
+    }
+    stages[i].Eval(input_ctx, stage_alloc.frame());
+    sum += stage_alloc.frame().Get(stage_frame.slot);
+  }
+  return static_cast<float>(sum);
 }
 
 void ForestEvaluator::Eval(const ConstFramePtr input_ctx,
                            FramePtr output_ctx) const {
-  for (size_t i = 0; i < output_slots_.size(); ++i) {
-    *output_ctx.GetMutable(output_slots_[i]) =
-        regular_predictors_[i].Predict(input_ctx);
+  if (multi_output_trees_.empty()) {
+    for (size_t i = 0; i < output_slots_.size(); ++i) {
+      *output_ctx.GetMutable(output_slots_[i]) =
+          regular_predictors_[i].Predict(input_ctx);
+    }
+  } else {
+    // Summed up with the regular predictors in double precision.
+    absl::InlinedVector<double, 4> sums(output_slots_.size(), 0.0);
+    for (const MultiOutputTree& tree : multi_output_trees_) {
+      tree.Eval(input_ctx, absl::MakeSpan(sums));
+    }
+    for (size_t i = 0; i < output_slots_.size(); ++i) {
+      *output_ctx.GetMutable(output_slots_[i]) =
+          regular_predictors_[i].Predict(input_ctx) + sums[i];
+    }
   }
   if (bitmask_predictor_) {
     bitmask_predictor_->IncrementalEval(input_ctx, output_ctx);
   }
   single_input_predictor_.IncrementalEval(input_ctx, output_ctx);
+  for (const EarlyExitOutput& output : early_exit_outputs_) {
+    *output_ctx.GetMutable(output.slot) = output.Eval(input_ctx);
+  }
+}
+
+size_t ForestEvaluator::memory_usage() const {
+  size_t result = VectorMemoryUsage(output_slots_);
+  for (const RegularPredictors& predictors : regular_predictors_) {
+    result += predictors.universal_predictor.memory_usage() +
+              predictors.interval_splits_predictor.memory_usage();
+  }
+  if (bitmask_predictor_) {
+    result += bitmask_predictor_->memory_usage();
+  }
+  result += single_input_predictor_.memory_usage();
+  result += VectorMemoryUsage(multi_output_trees_);
+  for (const MultiOutputTree& tree : multi_output_trees_) {
+    result += tree.tree.memory_usage() + VectorMemoryUsage(tree.outputs) +
+              VectorMemoryUsage(tree.adjustments);
+  }
+  result += VectorMemoryUsage(early_exit_outputs_);
+  for (const EarlyExitOutput& output : early_exit_outputs_) {
+    result += VectorMemoryUsage(output.stages) +
+              VectorMemoryUsage(output.remaining_min) +
+              VectorMemoryUsage(output.remaining_max);
+    for (const ForestEvaluator& stage : output.stages) {
+      result += stage.memory_usage();
+    }
+  }
+  return result;
 }
 
 }  // namespace arolla
@@ -15,9 +15,11 @@
 #ifndef AROLLA_DECISION_FOREST_POINTWISE_EVALUATION_FOREST_EVALUATOR_H_
 #define AROLLA_DECISION_FOREST_POINTWISE_EVALUATION_FOREST_EVALUATOR_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -45,6 +47,15 @@ class ForestEvaluator {
     bool enable_regular_eval = true;
     bool enable_bitmask_eval = true;
     bool enable_single_input_eval = true;
+    // If true, the trees evaluated by the regular evaluator that have
+    // identical splits (e.g. one tree per class of a multiclass model) are
+    // merged and traversed once, adding a vector of adjustments to their
+    // outputs. The order of the floating point additions differs from the
+    // regular evaluation, so the results may differ in the last bits.
+    bool enable_multi_output_eval = false;
+    // The number of trees evaluated between the checks of the early exit
+    // condition. See Output::early_exit_cutoff.
+    int early_exit_trees_per_stage = 8;
   };
 
   // The "outputs" argument in Compile allows to calculate results separately
@@ -55,6 +66,14 @@ class ForestEvaluator {
   struct Output {
     TreeFilter filter;
     FrameLayout::Slot<float> slot;
+    // If set, the caller is only interested whether the score exceeds the
+    // cutoff. The trees are evaluated in the order of decreasing range of
+    // their adjustments, and the evaluation stops as soon as the remaining
+    // trees can not move the score across the cutoff. In this case the
+    // result is the bound of the score (e.g. the partial sum plus minimal
+    // adjustments of the remaining trees) such that `result > cutoff` iff
+    // `score > cutoff`. Otherwise the result is the exact score.
+    std::optional<float> early_exit_cutoff = std::nullopt;
   };
 
   static absl::StatusOr<ForestEvaluator> Compile(
@@ -65,6 +84,10 @@ class ForestEvaluator {
   // Evaluates the whole forest.
   void Eval(ConstFramePtr input_ctx, FramePtr output_ctx) const;
 
+  // Returns an estimate of the heap memory used by the compiled forest. The
+  // memory owned by the split conditions (e.g. sets of values) is not counted.
+  size_t memory_usage() const;
+
  private:
   template <class T>
   using Predictor = BoostedPredictor<float, T, std::plus<double>, int>;
@@ -81,7 +104,7 @@ class ForestEvaluator {
     Predictor<UniversalBoundCondition> universal_predictor;
     Predictor<IntervalBoundCondition> interval_splits_predictor;
 
-    float Predict(ConstFramePtr input_ctx) const {
+    double Predict(ConstFramePtr input_ctx) const {
       return universal_predictor.Predict(input_ctx, 0.0) +
              interval_splits_predictor.Predict(input_ctx, 0.0);
     }
@@ -89,19 +112,64 @@ class ForestEvaluator {
   using RegularPredictorsList = absl::InlinedVector<RegularPredictors, 2>;
   class RegularPredictorsBuilder;
 
+  // An output evaluated with early exit.
+  struct EarlyExitOutput {
+    FrameLayout::Slot<float> slot;
+    float cutoff;
+    // Each stage is a part of the forest with a single output written to a
+    // frame with one float slot.
+    std::vector<ForestEvaluator> stages;
+    // Min and max sums of adjustments of stages [i, stages.size()).
+    std::vector<double> remaining_min;
+    std::vector<double> remaining_max;
+
+    float Eval(ConstFramePtr input_ctx) const;
+  };
+
+  // Trees with identical splits contributing to several outputs, merged into
+  // a single tree with a vector of adjustments in each leaf.
+  struct MultiOutputTree {
+    // Leaves store the leaf index.
+    internal::CompactDecisionTree<int32_t, UniversalBoundCondition> tree;
+    // Indices of the outputs.
+    std::vector<int> outputs;
+    // adjustments[leaf * outputs.size() + i] is added to outputs[i]. Double
+    // precision keeps exact sums of adjustments of the trees of one output.
+    std::vector<double> adjustments;
+
+    // Adds the adjustments of the leaf to sums[outputs[i]].
+    void Eval(ConstFramePtr input_ctx, absl::Span<double> sums) const;
+  };
+
+  static absl::StatusOr<MultiOutputTree> CompileMultiOutputTree(
+      absl::Span<const DecisionTree> trees, absl::Span<const size_t> tree_ids,
+      absl::Span<const int> tree2group, int group_count,
+      absl::Span<const TypedSlot> input_slots);
+
+  static absl::StatusOr<EarlyExitOutput> CompileEarlyExitOutput(
+      absl::Span<const DecisionTree> trees,
+      absl::Span<const TypedSlot> input_slots, const Output& output,
+      CompilationParams params);
+
   explicit ForestEvaluator(std::vector<FrameLayout::Slot<float>>&& output_slots,
                            RegularPredictorsList&& predictors,
                            std::unique_ptr<BitmaskEval>&& bitmask_predictor,
-                           SingleInputEval&& single_input_predictor)
+                           SingleInputEval&& single_input_predictor,
+                           std::vector<MultiOutputTree>&& multi_output_trees,
+                           std::vector<EarlyExitOutput>&& early_exit_outputs)
       : output_slots_(std::move(output_slots)),
         regular_predictors_(std::move(predictors)),
         bitmask_predictor_(std::move(bitmask_predictor)),
-        single_input_predictor_(std::move(single_input_predictor)) {}
+        single_input_predictor_(std::move(single_input_predictor)),
+        multi_output_trees_(std::move(multi_output_trees)),
+        early_exit_outputs_(std::move(early_exit_outputs)) {}
 
   std::vector<FrameLayout::Slot<float>> output_slots_;
   RegularPredictorsList regular_predictors_;
   std::unique_ptr<BitmaskEval> bitmask_predictor_;
   SingleInputEval single_input_predictor_;
+  std::vector<MultiOutputTree> multi_output_trees_;
+  std::vector<EarlyExitOutput> early_exit_outputs_;
 };
 
 // A convenience wrapper for ForestEvaluator. Doesn't support multiple outputs
@@ -15,6 +15,7 @@
 #include "arolla/decision_forest/pointwise_evaluation/forest_evaluator.h"
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
@@ -27,6 +28,7 @@
 #include "absl/random/distributions.h"
 #include "absl/random/random.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
@@ -43,6 +45,7 @@
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/bytes.h"
 #include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
 namespace {
@@ -70,6 +73,11 @@ const ForestEvaluator::CompilationParams kSingleInputEval{
     .enable_regular_eval = false,
     .enable_bitmask_eval = false,
     .enable_single_input_eval = true};
+const ForestEvaluator::CompilationParams kMultiOutputEval{
+    .enable_regular_eval = true,
+    .enable_bitmask_eval = false,
+    .enable_single_input_eval = false,
+    .enable_multi_output_eval = true};
 
 void FillArgs(FramePtr ctx, int row_id, absl::Span<const TypedSlot> slots) {}
 
@@ -362,7 +370,7 @@ TEST(ForestEvaluator, BitmaskNotPossible) {
   absl::BitGen rnd;
   auto forest =
       CreateRandomForest(&rnd, /*num_features=*/10, /*interactions=*/true,
-                         /*min_num_splits=*/70, /*max_num_splits=*/70,
+                         /*min_num_splits=*/300, /*max_num_splits=*/300,
                          /*num_trees=*/1);
   std::vector<TypedSlot> slots;
   FrameLayout::Builder layout_builder;
@@ -457,6 +465,34 @@ TEST(ForestEvaluator, TestAgainstReferenceOnSmallTrees) {
   }
 }
 
+TEST(ForestEvaluator, TestAgainstReferenceOnWideTrees) {
+  absl::BitGen rnd;
+
+  std::vector<QTypePtr> types;
+  for (int input_id = 0; input_id < 10; input_id++) {
+    types.push_back(GetOptionalQType<float>());
+  }
+  for (int input_id = 10; input_id < 15; input_id++) {
+    types.push_back(GetOptionalQType<int64_t>());
+  }
+
+  // Trees with more than 64 regions are evaluated using multi-word masks.
+  for (auto [min_splits, max_splits] : {std::pair{64, 128}, {0, 256}}) {
+    for (int iteration = 0; iteration < 5; ++iteration) {
+      std::vector<DecisionTree> trees;
+      for (int i = 0; i < 10; ++i) {
+        int num_splits = absl::Uniform<int32_t>(rnd, min_splits, max_splits);
+        trees.push_back(
+            CreateRandomTree(&rnd, /*interactions=*/true, num_splits, &types));
+      }
+
+      RandomTestAgainstReferenceImplementation(
+          SourceLocation::current(), trees,
+          {kDefaultEval, kRegularEval, kBitmaskEval}, &rnd);
+    }
+  }
+}
+
 TEST(ForestEvaluator, TestAgainstReferenceOnSingleInputTrees) {
   absl::BitGen rnd;
 
@@ -530,5 +566,195 @@ TEST(ForestEvaluator, TestAgainstReference) {
   }
 }
 
+TEST(ForestEvaluator, MultiOutputTrees) {
+  // {x < 2: [class0 = 1, class1 = 10, class2 = 100],
+  //  x >= 2: [class0 = 2, class1 = 20, class2 = 200]}
+  std::vector<DecisionTree> trees(4);
+  float scale = 1;
+  for (int i = 0; i < 3; ++i, scale *= 10) {
+    trees[i].split_nodes = {{A(0), A(1), IntervalSplit(0, 2, kInf)}};
+    trees[i].adjustments = {scale, 2 * scale};
+    trees[i].tag.submodel_id = i;
+  }
+  // A tree identical to the first one. Contributes to the same output.
+  trees[3] = trees[0];
+  trees[3].weight = 0.5;
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  std::vector<TreeFilter> groups{
+      {.submodels = {0}}, {.submodels = {1}}, {.submodels = {2}}};
+  for (auto params : {kRegularEval, kDefaultEval, kMultiOutputEval}) {
+    TestCases<float>(SourceLocation::current(), *forest, groups, params,
+                     {{1.5, 10, 100}, {3, 20, 200}, {1.5, 10, 100}},
+                     {1.0, 2.0, std::nullopt});
+  }
+}
+
+TEST(ForestEvaluator, MultiOutputTreesAgainstReference) {
+  absl::BitGen rnd;
+  std::vector<QTypePtr> types(10, GetOptionalQType<float>());
+  for (int i = 0; i < 5; ++i) {
+    types.push_back(GetOptionalQType<int64_t>());
+  }
+  std::vector<DecisionTree> trees;
+  for (int i = 0; i < 10; ++i) {
+    int num_splits = absl::Uniform<int32_t>(rnd, 0, 256);
+    DecisionTree tree =
+        CreateRandomTree(&rnd, /*interactions=*/true, num_splits, &types);
+    // One tree with the same splits for each of the submodels.
+    for (int submodel_id = 0; submodel_id < 4; ++submodel_id) {
+      for (float& adjustment : tree.adjustments) {
+        adjustment = absl::Uniform<uint8_t>(rnd);
+      }
+      trees.push_back(tree);
+    }
+  }
+  // Assigns the trees with the same splits to different submodels.
+  RandomTestAgainstReferenceImplementation(
+      SourceLocation::current(), trees,
+      {kDefaultEval, kRegularEval, kMultiOutputEval}, &rnd);
+}
+
+TEST(ForestEvaluator, EarlyExit) {
+  std::vector<DecisionTree> trees(2);
+  trees[0].adjustments = {0.0, 0.1};
+  trees[0].split_nodes = {{A(0), A(1), IntervalSplit(0, 1, kInf)}};
+  trees[1].adjustments = {-1.0, 1.0};
+  trees[1].split_nodes = {{A(0), A(1), IntervalSplit(0, 3, kInf)}};
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+
+  std::vector<TypedSlot> input_slots;
+  FrameLayout::Builder layout_builder;
+  CreateSlotsForForest(*forest, &layout_builder, &input_slots);
+  auto output_slot = layout_builder.AddSlot<float>();
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  auto input_slot = input_slots[0].ToSlot<OptionalValue<float>>().value();
+
+  auto eval = [&](float cutoff, OptionalValue<float> input) {
+    auto evaluator =
+        ForestEvaluator::Compile(
+            *forest, input_slots,
+            {{.filter = {}, .slot = output_slot, .early_exit_cutoff = cutoff}},
+            {.early_exit_trees_per_stage = 1})
+            .value();
+    frame.Set(input_slot, input);
+    evaluator.Eval(frame, frame);
+    return frame.Get(output_slot);
+  };
+  // The max possible score is 1.1, so the trees are not evaluated.
+  EXPECT_EQ(eval(2.0, 5.0), 1.1f);
+  // The min possible score is -1.
+  EXPECT_EQ(eval(-2.0, 0.0), -1.0f);
+  // The tree with the wider range goes first. After it only 0.1 may be added.
+  EXPECT_EQ(eval(0.5, 5.0), 1.0f);
+  EXPECT_EQ(eval(0.5, 2.0), -0.9f);
+  // Close to the cutoff all the trees are evaluated.
+  EXPECT_EQ(eval(1.05, 5.0), 1.1f);
+  EXPECT_EQ(eval(1.05, 4.0), 1.1f);
+  EXPECT_EQ(eval(1.05, 0.0), -0.9f);
+  EXPECT_EQ(eval(-0.95, 0.0), -1.0f);
+  EXPECT_EQ(eval(-0.95, 2.0), -0.9f);
+
+  EXPECT_THAT(ForestEvaluator::Compile(
+                  *forest, input_slots,
+                  {{.filter = {}, .slot = output_slot, .early_exit_cutoff = 0}},
+                  {.early_exit_trees_per_stage = 0})
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("early_exit_trees_per_stage")));
+}
+
+TEST(ForestEvaluator, EarlyExitAgainstReference) {
+  absl::BitGen rnd;
+  std::vector<QTypePtr> types(10, GetOptionalQType<float>());
+  std::vector<DecisionTree> trees;
+  for (int i = 0; i < 40; ++i) {
+    int num_splits = absl::Uniform<int32_t>(rnd, 0, 32);
+    trees.push_back(
+        CreateRandomTree(&rnd, /*interactions=*/true, num_splits, &types));
+    trees.back().tag.submodel_id = i % 2;
+  }
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  TreeFilter group0{.submodels{0}};
+  TreeFilter group1{.submodels{1}};
+
+  std::vector<TypedSlot> input_slots;
+  FrameLayout::Builder layout_builder;
+  CreateSlotsForForest(*forest, &layout_builder, &input_slots);
+  auto slot0 = layout_builder.AddSlot<float>();
+  auto slot1 = layout_builder.AddSlot<float>();
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+
+  for (float cutoff : {-10.0f, -1.0f, 0.0f, 0.5f, 1.0f, 10.0f}) {
+    for (int trees_per_stage : {1, 3, 100}) {
+      // Only group #0 uses early exit.
+      ASSERT_OK_AND_ASSIGN(
+          auto evaluator,
+          ForestEvaluator::Compile(
+              *forest, input_slots,
+              {{.filter = group0, .slot = slot0, .early_exit_cutoff = cutoff},
+               {.filter = group1, .slot = slot1}},
+              {.early_exit_trees_per_stage = trees_per_stage}));
+      for (int item_id = 0; item_id < 15; ++item_id) {
+        for (auto slot : input_slots) {
+          ASSERT_OK(FillWithRandomValue(slot, frame, &rnd,
+                                        /*missed_prob=*/0.25));
+        }
+        float expected0 =
+            DecisionForestNaiveEvaluation(*forest, frame, input_slots, group0);
+        float expected1 =
+            DecisionForestNaiveEvaluation(*forest, frame, input_slots, group1);
+        evaluator.Eval(frame, frame);
+        if (std::abs(expected0 - cutoff) > 1e-4) {
+          EXPECT_EQ(frame.Get(slot0) > cutoff, expected0 > cutoff)
+              << "cutoff=" << cutoff << ", score=" << expected0
+              << ", result=" << frame.Get(slot0);
+        }
+        EXPECT_FLOAT_EQ(frame.Get(slot1), expected1);
+      }
+    }
+  }
+}
+
+TEST(ForestEvaluator, MemoryUsage) {
+  absl::BitGen rnd;
+  auto small_forest =
+      CreateRandomForest(&rnd, /*num_features=*/10, /*interactions=*/true,
+                         /*min_num_splits=*/10, /*max_num_splits=*/10,
+                         /*num_trees=*/10);
+  auto large_forest =
+      CreateRandomForest(&rnd, /*num_features=*/10, /*interactions=*/true,
+                         /*min_num_splits=*/10, /*max_num_splits=*/10,
+                         /*num_trees=*/100);
+  EXPECT_GT(large_forest->memory_usage(), small_forest->memory_usage());
+  auto get_memory_usage =
+      [](const DecisionForest& forest,
+         ForestEvaluator::CompilationParams params) -> absl::StatusOr<size_t> {
+    std::vector<TypedSlot> slots;
+    FrameLayout::Builder layout_builder;
+    CreateSlotsForForest(forest, &layout_builder, &slots);
+    ASSIGN_OR_RETURN(
+        auto evaluator,
+        ForestEvaluator::Compile(forest, slots,
+                                 {{.slot = layout_builder.AddSlot<float>()}},
+                                 params));
+    return evaluator.memory_usage();
+  };
+  for (auto params : {kDefaultEval, kRegularEval, kBitmaskEval}) {
+    ASSERT_OK_AND_ASSIGN(size_t small_usage,
+                         get_memory_usage(*small_forest, params));
+    ASSERT_OK_AND_ASSIGN(size_t large_usage,
+                         get_memory_usage(*large_forest, params));
+    EXPECT_GT(small_usage, 0);
+    EXPECT_GT(large_usage, small_usage);
+  }
+}
+
 }  // namespace
 }  // namespace arolla
@@ -15,6 +15,7 @@
 #ifndef AROLLA_DECISION_FOREST_POINTWISE_EVALUATION_POINTWISE_H_
 #define AROLLA_DECISION_FOREST_POINTWISE_EVALUATION_POINTWISE_H_
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -27,6 +28,7 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "arolla/util/memory_usage.h"
 #include "arolla/util/status_macros_backport.h"
 
 // There are two ways to use library: single tree or boosted trees evaluation.
@@ -116,6 +118,10 @@ struct CompactDecisionTree {
   NodeId RootNodeId() const {
     return splits.empty() ? NodeId::Leaf(0) : NodeId::Split(0);
   }
+
+  size_t memory_usage() const {
+    return VectorMemoryUsage(splits) + VectorMemoryUsage(adjustments);
+  }
 };
 
 template <class OutT, class NodeTest>
@@ -231,6 +237,86 @@ class DecisionTreeTraverser {
 
 struct EmptyFilterTag {};
 
+// All trees of a forest packed into a single array of nodes. Nodes of each
+// tree are stored contiguously in the breadth-first order, so the top levels
+// of the tree share cache lines and the children always follow the parent.
+template <class OutT, class NodeTest>
+struct PackedForest {
+  // Reference to the next node: a positive offset from the current node's
+  // index for split nodes, or `~adjustment_id` for leaves. For the roots the
+  // offsets are from the beginning of `nodes`.
+  using NodeRef = int32_t;
+
+  struct Node {
+    NodeTest test;
+    // Indexed by the boolean result of the test.
+    std::array<NodeRef, 2> next;
+  };
+
+  std::vector<Node> nodes;
+  std::vector<OutT> adjustments;
+  std::vector<NodeRef> roots;
+
+  size_t memory_usage() const {
+    return VectorMemoryUsage(nodes) + VectorMemoryUsage(adjustments) +
+           VectorMemoryUsage(roots);
+  }
+};
+
+template <class OutT, class NodeTest>
+PackedForest<OutT, NodeTest> PackForest(
+    const std::vector<CompactDecisionTree<OutT, NodeTest>>& trees) {
+  PackedForest<OutT, NodeTest> forest;
+  size_t node_count = 0;
+  size_t adjustment_count = 0;
+  for (const auto& tree : trees) {
+    node_count += tree.splits.size();
+    adjustment_count += tree.adjustments.size();
+  }
+  forest.nodes.reserve(node_count);
+  forest.adjustments.reserve(adjustment_count);
+  forest.roots.reserve(trees.size());
+  std::vector<int32_t> queue;   // split node ids of the current tree
+  std::vector<int32_t> packed;  // split node id -> index in forest.nodes
+  for (const auto& tree : trees) {
+    const int32_t first_adjustment = forest.adjustments.size();
+    forest.adjustments.insert(forest.adjustments.end(),
+                              tree.adjustments.begin(),
+                              tree.adjustments.end());
+    NodeId root = tree.RootNodeId();
+    if (root.is_leaf()) {
+      forest.roots.push_back(~(first_adjustment + root.adjsutment_id()));
+      continue;
+    }
+    forest.roots.push_back(forest.nodes.size());
+    // Breadth-first numbering.
+    queue.assign(1, root.split_node_id());
+    packed.assign(tree.splits.size(), -1);
+    packed[root.split_node_id()] = forest.nodes.size();
+    for (size_t i = 0; i < queue.size(); ++i) {
+      for (NodeId child : tree.splits[queue[i]].next_node_ids) {
+        if (!child.is_leaf()) {
+          packed[child.split_node_id()] = forest.nodes.size() + queue.size();
+          queue.push_back(child.split_node_id());
+        }
+      }
+    }
+    for (int32_t split_id : queue) {
+      const auto& split = tree.splits[split_id];
+      const int32_t index = forest.nodes.size();
+      auto& node = forest.nodes.emplace_back();
+      node.test = split.test;
+      for (int j = 0; j < 2; ++j) {
+        NodeId child = split.next_node_ids[j];
+        node.next[j] = child.is_leaf()
+                           ? ~(first_adjustment + child.adjsutment_id())
+                           : packed[child.split_node_id()] - index;
+      }
+    }
+  }
+  return forest;
+}
+
 }  // namespace internal
 
 // =====  Predictors
@@ -313,12 +399,94 @@ class BoostedPredictor {
     return Predict(values, start, [](FilterTag tag) { return true; });
   }
 
+  // Returns an estimate of the heap memory used by the predictor.
+  size_t memory_usage() const {
+    size_t result = VectorMemoryUsage(trees_) + VectorMemoryUsage(filter_tags_);
+    for (const auto& tree : trees_) {
+      result += tree.memory_usage();
+    }
+    return result;
+  }
+
  private:
   std::vector<internal::CompactDecisionTree<TreeOutT, NodeTest>> trees_;
   std::vector<FilterTag> filter_tags_;
   BinaryOp op_;
 };
 
+// Same as BoostedPredictor, but all the trees are packed into a single array
+// (see internal::PackedForest), and the traversal state is just node indices.
+// Faster than BoostedPredictor for large forests of deep trees, because it
+// needs fewer cache lines and has no per-tree indirections.
+template <class TreeOutT, class NodeTest, class BinaryOp,
+          class FilterTag = internal::EmptyFilterTag>
+class PackedBoostedPredictor {
+ public:
+  using OutT = std::decay_t<decltype(BinaryOp()(TreeOutT(), TreeOutT()))>;
+  using NodeTestType = NodeTest;
+  explicit PackedBoostedPredictor(
+      internal::PackedForest<TreeOutT, NodeTest> forest,
+      std::vector<FilterTag> filter_tags, BinaryOp op)
+      : forest_(std::move(forest)),
+        filter_tags_(std::move(filter_tags)),
+        op_(op) {}
+
+  // See BoostedPredictor::Predict.
+  template <class FeatureContainer, class FilterFn>
+  OutT Predict(const FeatureContainer& values, OutT start,
+               FilterFn filter) const {
+    constexpr int kBatchSize = 16;
+    const auto* nodes = forest_.nodes.data();
+    const auto* adjustments = forest_.adjustments.data();
+    int32_t node_ids[kBatchSize];
+    const int tree_count = forest_.roots.size();
+    for (int first = 0; first < tree_count; first += kBatchSize) {
+      const int count = std::min<int>(tree_count - first, kBatchSize);
+      int active_count = 0;
+      for (int i = 0; i < count; ++i) {
+        if (!filter(filter_tags_[first + i])) continue;
+        const int32_t root = forest_.roots[first + i];
+        if (ABSL_PREDICT_FALSE(root < 0)) {
+          start = op_(start, adjustments[~root]);
+        } else {
+          node_ids[active_count++] = root;
+        }
+      }
+      while (ABSL_PREDICT_TRUE(active_count > 0)) {
+        int new_active_count = 0;
+        for (int i = 0; i < active_count; ++i) {
+          const int32_t node_id = node_ids[i];
+          const auto& node = nodes[node_id];
+          const int32_t next = node.next[node.test(values)];
+          if (ABSL_PREDICT_TRUE(next > 0)) {
+            node_ids[new_active_count++] = node_id + next;
+          } else {
+            start = op_(start, adjustments[~next]);
+          }
+        }
+        active_count = new_active_count;
+      }
+    }
+    return start;
+  }
+
+  template <class FeatureContainer>
+  OutT Predict(const FeatureContainer& values, OutT start = OutT()) const {
+    if (forest_.roots.empty()) return start;
+    return Predict(values, start, [](FilterTag tag) { return true; });
+  }
+
+  // Returns an estimate of the heap memory used by the predictor.
+  size_t memory_usage() const {
+    return forest_.memory_usage() + VectorMemoryUsage(filter_tags_);
+  }
+
+ private:
+  internal::PackedForest<TreeOutT, NodeTest> forest_;
+  std::vector<FilterTag> filter_tags_;
+  BinaryOp op_;
+};
+
 // =====  Compilers
 
 template <class OutT, class NodeTest>
@@ -395,6 +563,23 @@ class BoostedPredictorCompiler {
 
   absl::StatusOr<BoostedPredictor<OutT, NodeTest, BinaryOp, FilterTag>>
   Compile() {
+    ASSIGN_OR_RETURN(auto trees, CompileTrees());
+    return BoostedPredictor<OutT, NodeTest, BinaryOp, FilterTag>(
+        std::move(trees), std::move(filter_tags_), op_);
+  }
+
+  // Same as Compile(), but packs the trees into one array, see
+  // PackedBoostedPredictor.
+  absl::StatusOr<PackedBoostedPredictor<OutT, NodeTest, BinaryOp, FilterTag>>
+  CompilePacked() {
+    ASSIGN_OR_RETURN(auto trees, CompileTrees());
+    return PackedBoostedPredictor<OutT, NodeTest, BinaryOp, FilterTag>(
+        internal::PackForest(trees), std::move(filter_tags_), op_);
+  }
+
+ private:
+  absl::StatusOr<std::vector<internal::CompactDecisionTree<OutT, NodeTest>>>
+  CompileTrees() {
     if (compiled_) {
       return absl::Status(absl::StatusCode::kFailedPrecondition,
                           "Already compiled.");
@@ -407,11 +592,9 @@ class BoostedPredictorCompiler {
       RETURN_IF_ERROR(tree_or.status());
       trees.push_back(*std::move(tree_or));
     }
-    return BoostedPredictor<OutT, NodeTest, BinaryOp, FilterTag>(
-        std::move(trees), std::move(filter_tags_), op_);
+    return trees;
   }
 
- private:
   bool compiled_ = false;
   BinaryOp op_;
   // deque used to avoid invalidating pointers after push_back
@@ -20,6 +20,8 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/random/distributions.h"
+#include "absl/random/random.h"
 #include "absl/status/status.h"
 #include "absl/types/span.h"
 #include "arolla/util/testing/status_matchers_backport.h"
@@ -211,5 +213,72 @@ TEST(PointwiseTest, BoostedCompileFail) {
   }
 }
 
+TEST(PointwiseTest, PackedBoosted) {
+  BoostedPredictorCompiler<float, LessTest<float>, std::plus<float>, int>
+      compiler;
+  // Node ids are not in the breadth-first order.
+  auto tree_compiler1 = compiler.AddTree(5, 0);
+  EXPECT_OK(tree_compiler1.SetNode(0, 3, 2, {0, 10.0}));
+  EXPECT_OK(tree_compiler1.SetNode(3, 1, 4, {1, 5.0}));
+  EXPECT_OK(tree_compiler1.SetLeaf(1, 1.0));
+  EXPECT_OK(tree_compiler1.SetLeaf(2, 4.0));
+  EXPECT_OK(tree_compiler1.SetLeaf(4, 2.0));
+  auto tree_compiler2 = compiler.AddTree(1, 1);
+  EXPECT_OK(tree_compiler2.SetLeaf(0, 8.0));
+  auto tree_compiler3 = compiler.AddTree(3, 0);
+  EXPECT_OK(tree_compiler3.SetNode(0, 1, 2, {0, 20.0}));
+  EXPECT_OK(tree_compiler3.SetLeaf(1, 16.0));
+  EXPECT_OK(tree_compiler3.SetLeaf(2, 32.0));
+  ASSERT_OK_AND_ASSIGN(auto eval, compiler.CompilePacked());
+  EXPECT_THAT(compiler.CompilePacked().status(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_EQ(eval.Predict(std::vector<float>{5.0, 1.0}), 1.0 + 8.0 + 16.0);
+  EXPECT_EQ(eval.Predict(std::vector<float>{5.0, 7.0}), 2.0 + 8.0 + 16.0);
+  EXPECT_EQ(eval.Predict(std::vector<float>{15.0, 1.0}), 4.0 + 8.0 + 16.0);
+  EXPECT_EQ(eval.Predict(std::vector<float>{25.0, 7.0}), 4.0 + 8.0 + 32.0);
+  EXPECT_EQ(eval.Predict(std::vector<float>{5.0, 1.0}, 0.0,
+                         [](int x) { return x == 0; }),
+            1.0 + 16.0);
+  EXPECT_EQ(eval.Predict(std::vector<float>{5.0, 1.0}, 0.0,
+                         [](int x) { return x == 1; }),
+            8.0);
+}
+
+TEST(PointwiseTest, PackedBoostedMatchesBoosted) {
+  constexpr int kNumFeatures = 5;
+  constexpr int kDepth = 4;
+  constexpr int kNumSplits = (1 << kDepth) - 1;
+  absl::BitGen rnd;
+  BoostedPredictorCompiler<float, LessTest<float>, std::plus<float>> compiler;
+  BoostedPredictorCompiler<float, LessTest<float>, std::plus<float>>
+      packed_compiler;
+  // More than one batch of trees.
+  for (int i = 0; i < 40; ++i) {
+    auto tree_compiler = compiler.AddTree(kNumSplits * 2 + 1);
+    auto packed_tree_compiler = packed_compiler.AddTree(kNumSplits * 2 + 1);
+    for (int id = 0; id < kNumSplits; ++id) {
+      LessTest<float> test{absl::Uniform<int>(rnd, 0, kNumFeatures),
+                           absl::Uniform<float>(rnd, 0, 1)};
+      EXPECT_OK(tree_compiler.SetNode(id, id * 2 + 1, id * 2 + 2, test));
+      EXPECT_OK(packed_tree_compiler.SetNode(id, id * 2 + 1, id * 2 + 2, test));
+    }
+    for (int id = kNumSplits; id <= 2 * kNumSplits; ++id) {
+      // Integer adjustments to make the sum independent of the order.
+      float adjustment = absl::Uniform<int>(rnd, 0, 100);
+      EXPECT_OK(tree_compiler.SetLeaf(id, adjustment));
+      EXPECT_OK(packed_tree_compiler.SetLeaf(id, adjustment));
+    }
+  }
+  ASSERT_OK_AND_ASSIGN(auto eval, compiler.Compile());
+  ASSERT_OK_AND_ASSIGN(auto packed_eval, packed_compiler.CompilePacked());
+  for (int i = 0; i < 100; ++i) {
+    std::vector<float> values(kNumFeatures);
+    for (float& v : values) {
+      v = absl::Uniform<float>(rnd, 0, 1);
+    }
+    EXPECT_EQ(packed_eval.Predict(values), eval.Predict(values));
+  }
+}
+
 }  // namespace
 }  // namespace arolla
@@ -15,6 +15,7 @@
 #ifndef AROLLA_DECISION_FOREST_POINTWISE_EVALUATION_SINGLE_INPUT_EVAL_H_
 #define AROLLA_DECISION_FOREST_POINTWISE_EVALUATION_SINGLE_INPUT_EVAL_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <utility>
 #include <vector>
@@ -30,6 +31,7 @@
 #include "arolla/memory/optional_value.h"
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
+#include "arolla/util/memory_usage.h"
 
 namespace arolla {
 
@@ -53,6 +55,11 @@ class PiecewiseConstantEvaluator {
 
   float Eval(ConstFramePtr ctx) const;
 
+  size_t memory_usage() const {
+    return VectorMemoryUsage(split_points_) + VectorMemoryUsage(point_values_) +
+           VectorMemoryUsage(middle_values_);
+  }
+
  private:
   FrameLayout::Slot<OptionalValue<T>> input_slot_;
   std::vector<T> split_points_;
@@ -81,6 +88,18 @@ class PiecewiseConstantEvaluators {
  public:
   void IncrementalEval(ConstFramePtr input_ctx, FramePtr output_ctx) const;
 
+  size_t memory_usage() const {
+    size_t result = VectorMemoryUsage(float_predictors_) +
+                    VectorMemoryUsage(int64_predictors_);
+    for (const auto& predictor : float_predictors_) {
+      result += predictor.memory_usage();
+    }
+    for (const auto& predictor : int64_predictors_) {
+      result += predictor.memory_usage();
+    }
+    return result;
+  }
+
  private:
   explicit PiecewiseConstantEvaluators(
       FrameLayout::Slot<float> output_slot,
@@ -108,6 +127,15 @@ class SingleInputEval {
   // to corresponding slots in output_ctx.
   void IncrementalEval(ConstFramePtr input_ctx, FramePtr output_ctx) const;
 
+  // Returns an estimate of the heap memory used by the evaluator.
+  size_t memory_usage() const {
+    size_t result = 0;
+    for (const auto& evaluators : evaluators_) {
+      result += evaluators.memory_usage();
+    }
+    return result;
+  }
+
  private:
   SingleInputEval() = default;
   friend class SingleInputBuilder;
@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator.h"
+#include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator_cache.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/memory/frame.h"
 #include "arolla/qexpr/eval_context.h"
@@ -35,6 +37,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/tuple_qtype.h"
 #include "arolla/util/fingerprint.h"
+#include "arolla/util/memory_usage.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
@@ -42,20 +45,27 @@ namespace {
 
 class DecisionForestBoundOperator : public BoundOperator {
  public:
-  DecisionForestBoundOperator(std::shared_ptr<BatchedForestEvaluator> evaluator,
-                              absl::Span<const TypedSlot> input_slots,
-                              absl::Span<const TypedSlot> output_slots)
+  DecisionForestBoundOperator(
+      std::shared_ptr<const BatchedForestEvaluator> evaluator,
+      absl::Span<const TypedSlot> input_slots,
+      absl::Span<const TypedSlot> output_slots)
       : evaluator_(std::move(evaluator)),
         input_slots_(input_slots.begin(), input_slots.end()),
         output_slots_(output_slots.begin(), output_slots.end()) {}
 
   void Run(EvaluationContext* ctx, FramePtr frame) const final {
-    ctx->set_status(evaluator_->EvalBatch(input_slots_, output_slots_, frame,
-                                          &ctx->buffer_factory()));
+    ctx->set_status(evaluator_->EvalBatch(
+        input_slots_, output_slots_, frame, &ctx->buffer_factory(),
+        /*row_count=*/std::nullopt, ctx->cancellation_context()));
+  }
+
+  int64_t EstimateMemoryUsage() const final {
+    return evaluator_->memory_usage() + VectorMemoryUsage(input_slots_) +
+           VectorMemoryUsage(output_slots_);
   }
 
  private:
-  std::shared_ptr<BatchedForestEvaluator> evaluator_;
+  std::shared_ptr<const BatchedForestEvaluator> evaluator_;
   std::vector<TypedSlot> input_slots_;
   std::vector<TypedSlot> output_slots_;
 };
@@ -63,8 +73,8 @@ class DecisionForestBoundOperator : public BoundOperator {
 class BatchedDecisionForestOperator : public QExprOperator {
  public:
   BatchedDecisionForestOperator(
-      std::shared_ptr<BatchedForestEvaluator> evaluator, std::string op_name,
-      const QExprOperatorSignature* op_type)
+      std::shared_ptr<const BatchedForestEvaluator> evaluator,
+      std::string op_name, const QExprOperatorSignature* op_type)
       : QExprOperator(std::move(op_name), op_type),
         evaluator_(std::move(evaluator)) {}
 
@@ -81,15 +91,15 @@ class BatchedDecisionForestOperator : public QExprOperator {
         evaluator_, input_slots, output_subslots));
   }
 
-  std::shared_ptr<BatchedForestEvaluator> evaluator_;
+  std::shared_ptr<const BatchedForestEvaluator> evaluator_;
 };
 
 }  // namespace
 
 absl::StatusOr<OperatorPtr> CreateBatchedDecisionForestOperator(
     const DecisionForestPtr& decision_forest,
-    const QExprOperatorSignature* op_type,
-    absl::Span<const TreeFilter> groups) {
+    const QExprOperatorSignature* op_type, absl::Span<const TreeFilter> groups,
+    const BatchedForestEvaluator::CompilationParams& params) {
   for (const auto& kv : decision_forest->GetRequiredQTypes()) {
     if (kv.first >= op_type->GetInputTypes().size()) {
       return absl::InvalidArgumentError("not enough arguments");
@@ -107,8 +117,11 @@ absl::StatusOr<OperatorPtr> CreateBatchedDecisionForestOperator(
   }
   RETURN_IF_ERROR(ValidateBatchedDecisionForestOutputType(
       op_type->GetOutputType(), groups.size()));
+  // The same forest is often used by several models (or model versions), so
+  // the compiled evaluators are shared between them.
   ASSIGN_OR_RETURN(auto evaluator,
-                   BatchedForestEvaluator::Compile(*decision_forest, groups));
+                   BatchedForestEvaluatorCache::GetInstance().Compile(
+                       *decision_forest, groups, params));
 
   FingerprintHasher hasher("::arolla::BatchedDecisionForestOperator");
   hasher.Combine(decision_forest->fingerprint()).CombineSpan(groups);
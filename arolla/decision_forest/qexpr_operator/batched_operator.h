@@ -18,6 +18,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
+#include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/qexpr/operators.h"
 #include "arolla/qexpr/qexpr_operator_signature.h"
@@ -32,9 +33,13 @@ namespace arolla {
 // Output is a tuple of arrays of the same kind as the first input.
 // The groups argument specifies which trees should be used for each output.
 // The number of groups should be equal to the size of the output tuple.
+// `params` allow e.g. to give the operator its own threading and parallelism
+// budget (see BatchedForestEvaluator::CompilationParams).
 absl::StatusOr<OperatorPtr> CreateBatchedDecisionForestOperator(
     const DecisionForestPtr& decision_forest,
-    const QExprOperatorSignature* op_type, absl::Span<const TreeFilter> groups);
+    const QExprOperatorSignature* op_type, absl::Span<const TreeFilter> groups,
+    const BatchedForestEvaluator::CompilationParams& params =
+        BatchedForestEvaluator::CompilationParams::Default());
 
 absl::Status ValidateBatchedDecisionForestOutputType(const QTypePtr output,
                                                      int group_count);
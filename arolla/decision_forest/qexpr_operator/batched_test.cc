@@ -32,6 +32,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/tuple_qtype.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/util/threading.h"
 
 namespace arolla {
 namespace {
@@ -109,5 +110,42 @@ TEST_F(DecisionForestBatchedTest, Run) {
   EXPECT_THAT(res2, ElementsAre(0.5, 2.5, 3.5, 3.5));
 }
 
+TEST_F(DecisionForestBatchedTest, RunWithOwnThreading) {
+  QTypePtr f32 = GetDenseArrayQType<float>();
+  QTypePtr i64 = GetDenseArrayQType<int64_t>();
+  auto output_type = MakeTupleQType({f32});
+  FrameLayout::Builder bldr;
+  auto input1_slot = bldr.AddSlot<DenseArray<float>>();
+  auto input2_slot = bldr.AddSlot<DenseArray<int64_t>>();
+  auto result_tuple_slot = AddSlot(output_type, &bldr);
+  ASSERT_OK_AND_ASSIGN(
+      auto result_slot,
+      result_tuple_slot.SubSlot(0).ToSlot<DenseArray<float>>());
+
+  auto forest_op_type = QExprOperatorSignature::Get({f32, i64}, output_type);
+  ASSERT_OK_AND_ASSIGN(
+      auto forest_op,
+      CreateBatchedDecisionForestOperator(
+          forest_, forest_op_type, {{.submodels = {2}}},
+          {.threading = std::make_shared<WorkStealingThreading>(2),
+           .min_rows_per_thread = 1,
+           .max_thread_count = 2}));
+
+  ASSERT_OK_AND_ASSIGN(auto bound_forest_op,
+                       forest_op->Bind({TypedSlot::FromSlot(input1_slot),
+                                        TypedSlot::FromSlot(input2_slot)},
+                                       {result_tuple_slot}));
+
+  FrameLayout layout = std::move(bldr).Build();
+  RootEvaluationContext root_ctx(&layout);
+  EvaluationContext ctx(root_ctx);
+
+  root_ctx.Set(input1_slot, arg1_);
+  root_ctx.Set(input2_slot, arg2_);
+  bound_forest_op->Run(&ctx, root_ctx.frame());
+  EXPECT_OK(ctx.status());
+  EXPECT_THAT(root_ctx.Get(result_slot), ElementsAre(0.5, 2.5, 3.5, 3.5));
+}
+
 }  // namespace
 }  // namespace arolla
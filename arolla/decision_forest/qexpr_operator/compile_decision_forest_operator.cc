@@ -16,6 +16,7 @@
 
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
+#include "arolla/decision_forest/batched_evaluation/batched_forest_evaluator.h"
 #include "arolla/decision_forest/expr_operator/decision_forest_operator.h"
 #include "arolla/decision_forest/qexpr_operator/batched_operator.h"
 #include "arolla/decision_forest/qexpr_operator/pointwise_operator.h"
@@ -25,6 +26,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/tuple_qtype.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/util/cost_model.h"
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -58,11 +60,22 @@ std::optional<absl::Status> CompileDecisionForestOperator(
   if (is_pointwise) {
     ASSIGN_OR_RETURN(op, CreatePointwiseDecisionForestOperator(
                              forest_op->forest(), forest_op_type,
-                             forest_op->tree_filters()));
+                             forest_op->tree_filters(),
+                             forest_op->early_exit_cutoff()));
   } else {
+    BatchedForestEvaluator::CompilationParams params;
+    if (const CostModel* cost_model = args.options.cost_model;
+        cost_model != nullptr) {
+      params.optimal_splits_per_evaluator =
+          cost_model->optimal_splits_per_evaluator;
+      params.min_rows_per_thread = cost_model->min_rows_per_thread;
+      params.frame_buffer_count = cost_model->frame_buffer_count;
+    }
+    // Exact scores satisfy the early exit contract as well, so the cutoff is
+    // not used by the batched evaluation.
     ASSIGN_OR_RETURN(op, CreateBatchedDecisionForestOperator(
                              forest_op->forest(), forest_op_type,
-                             forest_op->tree_filters()));
+                             forest_op->tree_filters(), params));
   }
 
   return args.executable_builder
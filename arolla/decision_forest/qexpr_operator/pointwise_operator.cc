@@ -15,7 +15,9 @@
 #include "arolla/decision_forest/qexpr_operator/pointwise_operator.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -48,6 +50,10 @@ class DecisionForestBoundOperator : public BoundOperator {
     evaluator_.Eval(frame, frame);
   }
 
+  int64_t EstimateMemoryUsage() const final {
+    return evaluator_.memory_usage();
+  }
+
  private:
   ForestEvaluator evaluator_;
 };
@@ -57,10 +63,12 @@ class PointwiseDecisionForestOperator : public QExprOperator {
   PointwiseDecisionForestOperator(DecisionForestPtr decision_forest,
                                   std::string op_name,
                                   const QExprOperatorSignature* op_type,
-                                  absl::Span<const TreeFilter> groups)
+                                  absl::Span<const TreeFilter> groups,
+                                  std::optional<float> early_exit_cutoff)
       : QExprOperator(std::move(op_name), op_type),
         decision_forest_(std::move(decision_forest)),
-        groups_(groups.begin(), groups.end()) {}
+        groups_(groups.begin(), groups.end()),
+        early_exit_cutoff_(early_exit_cutoff) {}
 
  private:
   absl::StatusOr<std::unique_ptr<BoundOperator>> DoBind(
@@ -73,7 +81,7 @@ class PointwiseDecisionForestOperator : public QExprOperator {
     outputs.reserve(groups_.size());
     for (size_t i = 0; i < groups_.size(); ++i) {
       ASSIGN_OR_RETURN(auto slot, output_slot.SubSlot(i).ToSlot<float>());
-      outputs.push_back({groups_[i], slot});
+      outputs.push_back({groups_[i], slot, early_exit_cutoff_});
     }
     ASSIGN_OR_RETURN(
         ForestEvaluator evaluator,
@@ -86,14 +94,15 @@ class PointwiseDecisionForestOperator : public QExprOperator {
  private:
   DecisionForestPtr decision_forest_;
   std::vector<TreeFilter> groups_;
+  std::optional<float> early_exit_cutoff_;
 };
 
 }  // namespace
 
 absl::StatusOr<OperatorPtr> CreatePointwiseDecisionForestOperator(
     const DecisionForestPtr& decision_forest,
-    const QExprOperatorSignature* op_type,
-    absl::Span<const TreeFilter> groups) {
+    const QExprOperatorSignature* op_type, absl::Span<const TreeFilter> groups,
+    std::optional<float> early_exit_cutoff) {
   for (const auto& kv : decision_forest->GetRequiredQTypes()) {
     if (kv.first >= op_type->GetInputTypes().size()) {
       return absl::InvalidArgumentError(
@@ -112,11 +121,15 @@ absl::StatusOr<OperatorPtr> CreatePointwiseDecisionForestOperator(
 
   FingerprintHasher hasher("::arolla::PointwiseDecisionForestOperator");
   hasher.Combine(decision_forest->fingerprint()).CombineSpan(groups);
+  if (early_exit_cutoff.has_value()) {
+    hasher.Combine(*early_exit_cutoff);
+  }
   std::string op_name =
       absl::StrFormat("core.pointwise_decision_forest_evaluator_%s",
                       std::move(hasher).Finish().AsString());
   return OperatorPtr(std::make_shared<PointwiseDecisionForestOperator>(
-      decision_forest, std::move(op_name), op_type, groups));
+      decision_forest, std::move(op_name), op_type, groups,
+      early_exit_cutoff));
 }
 
 absl::Status ValidatePointwiseDecisionForestOutputType(const QTypePtr output,
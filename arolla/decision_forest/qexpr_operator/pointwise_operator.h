@@ -15,6 +15,8 @@
 #ifndef AROLLA_DECISION_FOREST_QEXPR_OPERATOR_POINTWISE_OPERATOR_H_
 #define AROLLA_DECISION_FOREST_QEXPR_OPERATOR_POINTWISE_OPERATOR_H_
 
+#include <optional>
+
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
@@ -31,9 +33,12 @@ namespace arolla {
 // Output is a tuple of non-optional floats.
 // The groups argument specifies which trees should be used for each output.
 // The number of groups should be equal to the size of the output tuple.
+// If early_exit_cutoff is set, the outputs are only accurate relative to the
+// cutoff, see ForestEvaluator::Output::early_exit_cutoff.
 absl::StatusOr<OperatorPtr> CreatePointwiseDecisionForestOperator(
     const DecisionForestPtr& decision_forest,
-    const QExprOperatorSignature* op_type, absl::Span<const TreeFilter> groups);
+    const QExprOperatorSignature* op_type, absl::Span<const TreeFilter> groups,
+    std::optional<float> early_exit_cutoff = std::nullopt);
 
 absl::Status ValidatePointwiseDecisionForestOutputType(const QTypePtr output,
                                                        int group_count);
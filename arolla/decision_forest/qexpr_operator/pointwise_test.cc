@@ -15,6 +15,7 @@
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -96,5 +97,42 @@ TEST_F(DecisionForestPointwiseTest, Run) {
   EXPECT_EQ(root_ctx.Get(result_slot.SubSlot(1).UnsafeToSlot<float>()), 3.5);
 }
 
+TEST_F(DecisionForestPointwiseTest, RunWithEarlyExit) {
+  auto result_type = MakeTupleQType({GetQType<float>(), GetQType<float>()});
+  FrameLayout::Builder bldr;
+  auto input1_slot = bldr.AddSlot<OptionalValue<float>>();
+  auto input2_slot = bldr.AddSlot<OptionalValue<int64_t>>();
+  auto result_slot = AddSlot(result_type, &bldr);
+  FrameLayout layout = std::move(bldr).Build();
+  auto forest_op_type = QExprOperatorSignature::Get(
+      {GetOptionalQType<float>(), GetOptionalQType<int64_t>()}, result_type);
+
+  for (auto [cutoff, expected0, expected1] :
+       std::vector<std::tuple<float, float, float>>{
+           // All the adjustments are above the cutoff.
+           {0.0f, 1.0f, 0.5f},
+           // Group #1 has to be evaluated.
+           {2.0f, 1.0f, 2.5f}}) {
+    ASSERT_OK_AND_ASSIGN(auto forest_op,
+                         CreatePointwiseDecisionForestOperator(
+                             forest_, forest_op_type,
+                             {{.submodels = {1}}, {.submodels = {2}}}, cutoff));
+    ASSERT_OK_AND_ASSIGN(auto bound_forest_op,
+                         forest_op->Bind({TypedSlot::FromSlot(input1_slot),
+                                          TypedSlot::FromSlot(input2_slot)},
+                                         {result_slot}));
+    RootEvaluationContext root_ctx(&layout);
+    EvaluationContext ctx(root_ctx);
+    root_ctx.Set(input1_slot, 1.0f);
+    root_ctx.Set(input2_slot, 2);
+    bound_forest_op->Run(&ctx, root_ctx.frame());
+    EXPECT_OK(ctx.status());
+    EXPECT_EQ(root_ctx.Get(result_slot.SubSlot(0).UnsafeToSlot<float>()),
+              expected0);
+    EXPECT_EQ(root_ctx.Get(result_slot.SubSlot(1).UnsafeToSlot<float>()),
+              expected1);
+  }
+}
+
 }  // namespace
 }  // namespace arolla
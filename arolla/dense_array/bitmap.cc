@@ -20,9 +20,45 @@
 #include <utility>
 
 #include "absl/log/check.h"
-#include "arolla/util/bits.h"
+#include "absl/numeric/bits.h"
 
 namespace arolla::bitmap {
+namespace {
+
+// Counts the set bits in `count` consecutive words. Two words are processed at
+// once, so the loop uses 64-bit popcount instructions.
+int64_t CountOnesInWords(const Word* words, int64_t count) {
+  int64_t res = 0;
+  int64_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    uint64_t w;
+    std::memcpy(&w, words + i, sizeof(w));
+    res += absl::popcount(w);
+  }
+  if (i < count) {
+    res += absl::popcount(words[i]);
+  }
+  return res;
+}
+
+// Counts the set bits in range [begin, end).
+int64_t CountOnesInRange(const Word* bitmap, int64_t begin, int64_t end) {
+  if (begin == end) {
+    return 0;
+  }
+  int64_t begin_word = begin / kWordBitCount;
+  int64_t end_word = (end - 1) / kWordBitCount;  // Word with the last bit.
+  Word first = bitmap[begin_word] & (kFullWord << (begin % kWordBitCount));
+  Word end_mask = kFullWord >> ((end_word + 1) * kWordBitCount - end);
+  if (begin_word == end_word) {
+    return absl::popcount(first & end_mask);
+  }
+  return absl::popcount(first) +
+         CountOnesInWords(bitmap + begin_word + 1, end_word - begin_word - 1) +
+         absl::popcount(bitmap[end_word] & end_mask);
+}
+
+}  // namespace
 
 bool AreAllBitsSet(const Word* bitmap, int64_t bitCount) {
   while (bitCount >= kWordBitCount) {
@@ -44,7 +80,7 @@ int64_t CountBits(const Bitmap& bitmap, int64_t offset, int64_t size) {
   const int64_t end = std::max<int64_t>(
       begin, std::min<int64_t>(bitmap.size() * kWordBitCount, offset + size));
   return size - (end - begin) +
-         GetOnesCountInRange(bitmap.span().data(), begin, end);
+         CountOnesInRange(bitmap.span().data(), begin, end);
 }
 
 void AlmostFullBuilder::CreateFullBitmap() {
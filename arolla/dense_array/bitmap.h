@@ -16,6 +16,7 @@
 #define AROLLA_DENSE_ARRAY_BITMAP_H_
 
 #include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -161,6 +162,16 @@ void IterateWord(Word word, Fn&& fn, int count = kWordBitCount) {
   }
 }
 
+// Calls fn(int bit_id, true) for all the bits of a fully present word. A
+// separate loop without the presence check allows the compiler to simplify
+// (and often vectorize) the body of `fn`.
+template <class Fn>
+void IterateFullWord(Fn&& fn) {
+  for (int i = 0; i < kWordBitCount; ++i) {
+    fn(i, true);
+  }
+}
+
 // Low-level function to iterate over given range of bits in a bitmap.
 // For better performance iterations are split into groups of 32 elements.
 // `init_group_fn(offset)` should initialize a group starting from `offset` and
@@ -184,7 +195,12 @@ void IterateByGroups(const Word* bitmap, int64_t first_bit, int64_t count,
     group_offset = first_word_size;
   }
   for (; group_offset <= count - kWordBitCount; group_offset += kWordBitCount) {
-    bitmap::IterateWord(*(bitmap++), init_group_fn(group_offset));
+    Word word = *(bitmap++);
+    if (word == kFullWord) {
+      bitmap::IterateFullWord(init_group_fn(group_offset));
+    } else {
+      bitmap::IterateWord(word, init_group_fn(group_offset));
+    }
   }
   if (group_offset != count) {
     bitmap::IterateWord(*bitmap, init_group_fn(group_offset),
@@ -206,6 +222,30 @@ void Iterate(const Bitmap& bitmap, int64_t first_bit, int64_t count, Fn&& fn) {
   }
 }
 
+// Calls fn(int64_t id) for every set bit in range [0, count) of the bitmap
+// starting from `bit_offset`, in increasing order. Empty bitmap means that all
+// the bits are set. Unlike Iterate, skips the unset bits without testing them
+// one by one, so it is much faster on sparse bitmaps.
+template <class Fn>
+void IterateSetBits(const Bitmap& bitmap, int bit_offset, int64_t count,
+                    Fn&& fn) {
+  for (int64_t base = 0; base < count; base += kWordBitCount) {
+    Word word = GetWordWithOffset(bitmap, base / kWordBitCount, bit_offset);
+    if (count - base < kWordBitCount) {
+      word &= (Word{1} << (count - base)) - 1;
+    }
+    if (word == kFullWord) {
+      for (int i = 0; i < kWordBitCount; ++i) {
+        fn(base + i);
+      }
+    } else {
+      for (; word != 0; word &= word - 1) {
+        fn(base + std::countr_zero(word));
+      }
+    }
+  }
+}
+
 // Counts the set bits in range [offset, offset+size).
 int64_t CountBits(const Bitmap& bitmap, int64_t offset, int64_t size);
 
@@ -14,9 +14,12 @@
 //
 #include <cstdint>
 #include <utility>
+#include <vector>
 
 #include "benchmark/benchmark.h"
+#include "absl/random/random.h"
 #include "arolla/dense_array/bitmap.h"
+#include "arolla/memory/buffer.h"
 
 namespace arolla::bitmap {
 namespace {
@@ -64,5 +67,87 @@ void BM_CreateAlmostFullSparseBitmap(::benchmark::State& state) {
 
 BENCHMARK(BM_CreateAlmostFullSparseBitmap)->Range(0, 1000);
 
+// Creates a bitmap of the given size with `presence_percent` of bits set.
+Bitmap CreateRandomBitmap(int64_t bit_count, int presence_percent) {
+  absl::BitGen gen;
+  Builder builder(bit_count);
+  builder.AddByGroups(bit_count, [&](int64_t) {
+    return [&](int) { return absl::Uniform(gen, 0, 100) < presence_percent; };
+  });
+  Bitmap bitmap = std::move(builder).Build();
+  if (bitmap.empty()) {
+    // All bits are present, so Builder returned an empty bitmap.
+    return CreateBuffer(std::vector<Word>(BitmapSize(bit_count), kFullWord));
+  }
+  return bitmap;
+}
+
+// Arguments: bit count, percent of present bits.
+void RunBitmapArgs(::benchmark::internal::Benchmark* b) {
+  for (int64_t size : {32, 1024, 32768}) {
+    for (int presence_percent : {0, 50, 99, 100}) {
+      b->ArgPair(size, presence_percent);
+    }
+  }
+}
+
+void BM_CountBits(::benchmark::State& state) {
+  int64_t size = state.range(0);
+  Bitmap bitmap = CreateRandomBitmap(size, state.range(1));
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(bitmap);
+    ::benchmark::DoNotOptimize(CountBits(bitmap, 3, size - 3));
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_CountBits)->Apply(&RunBitmapArgs);
+
+void BM_Iterate(::benchmark::State& state) {
+  int64_t size = state.range(0);
+  Bitmap bitmap = CreateRandomBitmap(size, state.range(1));
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(bitmap);
+    int64_t count = 0;
+    Iterate(bitmap, 0, size, [&](bool present) { count += present; });
+    ::benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_Iterate)->Apply(&RunBitmapArgs);
+
+void BM_IntersectSameOffset(::benchmark::State& state) {
+  int64_t size = state.range(0);
+  Bitmap a = CreateRandomBitmap(size, state.range(1));
+  Bitmap b = CreateRandomBitmap(size, state.range(1));
+  std::vector<Word> res(a.size());
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(a);
+    ::benchmark::DoNotOptimize(b);
+    Intersect(a, b, 0, 0, {res.data(), res.size()});
+    ::benchmark::DoNotOptimize(res);
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_IntersectSameOffset)->Apply(&RunBitmapArgs);
+
+void BM_IntersectDifferentOffsets(::benchmark::State& state) {
+  int64_t size = state.range(0);
+  Bitmap a = CreateRandomBitmap(size, state.range(1));
+  Bitmap b = CreateRandomBitmap(size, state.range(1));
+  std::vector<Word> res(a.size());
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(a);
+    ::benchmark::DoNotOptimize(b);
+    Intersect(a, b, 3, 7, {res.data(), res.size()});
+    ::benchmark::DoNotOptimize(res);
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_IntersectDifferentOffsets)->Apply(&RunBitmapArgs);
+
 }  // namespace
 }  // namespace arolla::bitmap
@@ -144,6 +144,52 @@ TEST(BitmapTest, Iterate) {
   EXPECT_EQ(bit, 17 + 32 + 69);
 }
 
+TEST(BitmapTest, IterateByGroupsWithFullWords) {
+  Bitmap bitmap = CreateBuffer<Word>({0xffffffff, 0x0f0f0f0f, 0xffffffff});
+  for (int64_t first_bit : {0, 3}) {
+    int64_t count = bitmap.size() * kWordBitCount - first_bit;
+    std::vector<bool> bits(count);
+    std::vector<int64_t> group_offsets;
+    IterateByGroups(bitmap.begin(), first_bit, count, [&](int64_t offset) {
+      group_offsets.push_back(offset);
+      return [&bits, offset](int i, bool present) {
+        bits[offset + i] = present;
+      };
+    });
+    for (int64_t i = 0; i < count; ++i) {
+      EXPECT_EQ(bits[i], GetBit(bitmap, first_bit + i))
+          << first_bit << " " << i;
+    }
+    if (first_bit == 0) {
+      EXPECT_THAT(group_offsets, testing::ElementsAre(0, 32, 64));
+    } else {
+      EXPECT_THAT(group_offsets, testing::ElementsAre(0, 29, 61));
+    }
+  }
+}
+
+TEST(BitmapTest, IterateSetBits) {
+  Bitmap bitmap =
+      CreateBuffer<Word>({0xffffffff, 0x00010010, 0xfffffffe, 0x00000003});
+  for (int first_bit : {0, 3}) {
+    for (int64_t count : {0, 17, 64, 100}) {
+      std::vector<int64_t> expected;
+      for (int64_t i = 0; i < count; ++i) {
+        if (GetBit(bitmap, first_bit + i)) {
+          expected.push_back(i);
+        }
+      }
+      std::vector<int64_t> ids;
+      IterateSetBits(bitmap, first_bit, count,
+                     [&](int64_t id) { ids.push_back(id); });
+      EXPECT_EQ(ids, expected) << first_bit << " " << count;
+    }
+  }
+  std::vector<int64_t> ids;
+  IterateSetBits(Bitmap(), 0, 5, [&](int64_t id) { ids.push_back(id); });
+  EXPECT_THAT(ids, testing::ElementsAre(0, 1, 2, 3, 4));
+}
+
 TEST(BitmapTest, Intersect) {
   Bitmap b1 = CreateBuffer<Word>({0xffff4321, 0x0, 0xf0f0f0f0, 0xffffffff});
   Bitmap b2 = CreateBuffer<Word>({0x43214321, 0x1, 0x0f0ff0f0, 0xffffffff});
@@ -15,6 +15,7 @@
 #ifndef AROLLA_DENSE_ARRAY_DENSE_ARRAY_H_
 #define AROLLA_DENSE_ARRAY_DENSE_ARRAY_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <initializer_list>
@@ -93,6 +94,12 @@ struct AROLLA_API DenseArray {
 
   bool is_owned() const { return values.is_owner() && bitmap.is_owner(); }
 
+  // Returns the memory used by the buffers of the array. The buffers can be
+  // shared with other arrays, see Buffer::memory_usage().
+  size_t memory_usage() const {
+    return values.memory_usage() + bitmap.memory_usage();
+  }
+
   // It is cheap if underlaying buffers are already owned and requires full copy
   // otherwise.
   DenseArray MakeOwned(
@@ -226,6 +233,21 @@ bool ArraysAreEquivalent(const DenseArray<T>& lhs, const DenseArray<T>& rhs) {
   return true;
 }
 
+// Returns true iff lhs and rhs are backed by the same memory, which implies
+// ArraysAreEquivalent(lhs, rhs). Unlike ArraysAreEquivalent, the check is O(1).
+template <typename T>
+bool ArraysShareBuffers(const DenseArray<T>& lhs, const DenseArray<T>& rhs) {
+  static_assert(std::is_arithmetic_v<T>,
+                "ArraysShareBuffers supports only arithmetic types");
+  auto same_buffer = [](const auto& lhs_buf, const auto& rhs_buf) {
+    return lhs_buf.size() == rhs_buf.size() &&
+           (lhs_buf.empty() || lhs_buf.span().data() == rhs_buf.span().data());
+  };
+  return same_buffer(lhs.values, rhs.values) &&
+         same_buffer(lhs.bitmap, rhs.bitmap) &&
+         lhs.bitmap_bit_offset == rhs.bitmap_bit_offset;
+}
+
 // This helper allows to get DenseArray type from optional types and references.
 // For example AsDenseArray<OptionalValue<int>&> is just DenseArray<int>.
 template <class T>
@@ -420,6 +442,14 @@ template <typename T>
 struct FingerprintHasherTraits<DenseArray<T>> {
   void operator()(FingerprintHasher* hasher, const DenseArray<T>& arg) const {
     hasher->Combine(arg.size());
+    if constexpr (std::is_arithmetic_v<T>) {
+      // Fast path: hash the values buffer in bulk when all values are
+      // present (regardless of whether the bitmap is empty or all ones).
+      if (arg.IsFull()) {
+        hasher->CombineSpan(arg.values.span());
+        return;
+      }
+    }
     for (int64_t i = 0; i < arg.size(); ++i) {
       hasher->Combine(arg[i]);
     }
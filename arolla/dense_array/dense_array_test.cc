@@ -28,6 +28,7 @@
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/util/bytes.h"
+#include "arolla/util/fingerprint.h"
 #include "arolla/util/text.h"
 #include "arolla/util/unit.h"
 
@@ -268,6 +269,14 @@ TEST(DenseArrayTest, MakeUnowned) {
   EXPECT_THAT(arr2, ElementsAre(1, 2, std::nullopt, 3));
 }
 
+TEST(DenseArrayTest, MemoryUsage) {
+  DenseArray<int64_t> full = CreateFullDenseArray<int64_t>({1, 2, 3, 4, 5});
+  EXPECT_EQ(full.memory_usage(), 5 * sizeof(int64_t));
+  DenseArray<int64_t> dense = CreateDenseArray<int64_t>({1, 2, std::nullopt});
+  EXPECT_EQ(dense.memory_usage(), 3 * sizeof(int64_t) + sizeof(uint32_t));
+  EXPECT_EQ(dense.MakeUnowned().memory_usage(), dense.memory_usage());
+}
+
 TEST(DenseArrayTest, Slice) {
   DenseArray<int> full = CreateDenseArray<int>({5, 1, 3, 4, 5});
   DenseArray<int> dense = CreateDenseArray<int>({5, 1, {}, {}, 5});
@@ -456,6 +465,42 @@ TEST(DenseArrayTest, ArraysAreEquivalent) {
   }
 }
 
+TEST(DenseArrayTest, Fingerprint) {
+  auto fingerprint = [](const auto& array) {
+    return FingerprintHasher("salt").Combine(array).Finish();
+  };
+  {
+    // Full arrays with and without bitmap.
+    DenseArray<int32_t> array1;
+    array1.values = CreateBuffer<int32_t>({1, 2, 3});
+    auto array2 = array1;
+    array2.bitmap = CreateBuffer<uint32_t>({7});
+    EXPECT_EQ(fingerprint(array1), fingerprint(array2));
+    EXPECT_NE(fingerprint(array1),
+              fingerprint(CreateDenseArray<int32_t>({1, 2, 4})));
+    EXPECT_NE(fingerprint(array1),
+              fingerprint(CreateDenseArray<int32_t>({1, 2})));
+    EXPECT_NE(fingerprint(array1),
+              fingerprint(CreateDenseArray<int32_t>({1, 2, std::nullopt})));
+  }
+  {
+    // Missing values don't affect the fingerprint.
+    DenseArray<int32_t> array1;
+    array1.values = CreateBuffer<int32_t>({1, 2, 3});
+    array1.bitmap = CreateBuffer<uint32_t>({3});
+    DenseArray<int32_t> array2;
+    array2.values = CreateBuffer<int32_t>({1, 2, 4});
+    array2.bitmap = CreateBuffer<uint32_t>({6});
+    array2.bitmap_bit_offset = 1;
+    EXPECT_EQ(fingerprint(array1), fingerprint(array2));
+  }
+  {
+    // +0.0 and -0.0 are distinguished.
+    EXPECT_NE(fingerprint(CreateDenseArray<float>({0.0f})),
+              fingerprint(CreateDenseArray<float>({-0.0f})));
+  }
+}
+
 template <typename T>
 class DenseArrayTypedTest : public ::testing::Test {
  public:
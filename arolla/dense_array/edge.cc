@@ -17,9 +17,11 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/base/optimization.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
@@ -43,6 +45,27 @@ absl::StatusOr<DenseArrayEdge> ComposeMappingEdge(
       edges.back().ToMappingEdge(buf_factory).edge_values();
   for (int i = edges.size() - 2; i >= 0; --i) {
     const auto mapping_edge = edges[i].ToMappingEdge(buf_factory);
+    if (mapping_edge.edge_values().IsFull()) {
+      // Fast path: the presence is fully determined by `mapping`, so we reuse
+      // its bitmap and only gather the values.
+      const int64_t* parent_ids = mapping_edge.edge_values().values.begin();
+      Buffer<int64_t>::Builder bldr(mapping.size(), &buf_factory);
+      int64_t* result = bldr.GetMutableSpan().begin();
+      if (mapping.IsFull()) {
+        const int64_t* ids = mapping.values.begin();
+        for (int64_t j = 0; j < mapping.size(); ++j) {
+          result[j] = parent_ids[ids[j]];
+        }
+      } else {
+        mapping.ForEachPresent([&](int64_t id, int64_t value) {
+          result[id] = parent_ids[value];
+        });
+      }
+      mapping = DenseArray<int64_t>{std::move(bldr).Build(),
+                                    std::move(mapping.bitmap),
+                                    mapping.bitmap_bit_offset};
+      continue;
+    }
     DenseArrayBuilder<int64_t> bldr(edges.back().child_size(), &buf_factory);
     mapping.ForEachPresent([&bldr, &mapping_edge](int64_t id, int64_t value) {
       bldr.Set(id, mapping_edge.edge_values()[value]);
@@ -56,20 +79,55 @@ absl::StatusOr<DenseArrayEdge> ComposeMappingEdge(
 absl::StatusOr<DenseArrayEdge> ComposeSplitPointsEdge(
     absl::Span<const DenseArrayEdge> edges, RawBufferFactory& buf_factory) {
   DCHECK_GE(edges.size(), 2);
-  Buffer<int64_t>::Builder bldr(edges.front().edge_values().size(),
-                                &buf_factory);
+  const int64_t parent_size = edges.front().parent_size();
+  Buffer<int64_t>::Builder bldr(parent_size + 1, &buf_factory);
   auto mut_bldr_span = bldr.GetMutableSpan();
-  auto previous_split_points = edges.front().edge_values().values.span();
+  DenseArraySplitPoints front_split_points(edges.front());
+  for (int64_t j = 0; j <= parent_size; ++j) {
+    mut_bldr_span[j] = front_split_points[j];
+  }
   for (size_t i = 1; i < edges.size(); ++i) {
-    auto split_points = edges[i].edge_values().values.span();
+    DenseArraySplitPoints split_points(edges[i]);
     for (size_t j = 0; j < mut_bldr_span.size(); ++j) {
-      mut_bldr_span[j] = split_points[previous_split_points[j]];
+      mut_bldr_span[j] = split_points[mut_bldr_span[j]];
     }
-    previous_split_points = mut_bldr_span;
   }
   return DenseArrayEdge::UnsafeFromSplitPoints({std::move(bldr).Build()});
 }
 
+// Returns true if the split points edge has groups of the same size.
+bool IsUniformSplitPointsEdge(const DenseArrayEdge& edge) {
+  if (edge.uniform_group_size().has_value()) {
+    return true;
+  }
+  const int64_t parent_size = edge.parent_size();
+  if (parent_size == 0) {
+    return true;
+  }
+  const int64_t group_size = edge.child_size() / parent_size;
+  if (group_size * parent_size != edge.child_size()) {
+    return false;
+  }
+  DenseArraySplitPoints splits(edge);
+  for (int64_t i = 0; i <= parent_size; ++i) {
+    if (splits[i] != i * group_size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+DenseArray<int64_t> BuildUniformSplitPoints(int64_t parent_size,
+                                            int64_t group_size,
+                                            RawBufferFactory& buf_factory) {
+  Buffer<int64_t>::Builder split_points_builder(parent_size + 1, &buf_factory);
+  auto inserter = split_points_builder.GetInserter();
+  for (int64_t i = 0; i <= parent_size; ++i) {
+    inserter.Add(i * group_size);
+  }
+  return {std::move(split_points_builder).Build()};
+}
+
 }  // namespace
 
 absl::StatusOr<DenseArrayEdge> DenseArrayEdge::FromSplitPoints(
@@ -124,10 +182,34 @@ absl::StatusOr<DenseArrayEdge> DenseArrayEdge::FromUniformGroups(
         "parent_size and group_size cannot be negative");
   }
 
-  Buffer<int64_t>::Builder split_points_builder(parent_size + 1, &buf_factory);
-  auto inserter = split_points_builder.GetInserter();
-  for (int64_t i = 0; i <= parent_size; ++i) inserter.Add(i * group_size);
-  return UnsafeFromSplitPoints({std::move(split_points_builder).Build()});
+  DenseArrayEdge result = UnsafeFromUniformGroups(parent_size, group_size);
+  if (&buf_factory != GetHeapBufferFactory()) {
+    // The lazily materialized split points would be allocated on the heap,
+    // so allocate them through the requested factory right away.
+    absl::call_once(result.uniform_->once, [&] {
+      result.uniform_->split_points =
+          BuildUniformSplitPoints(parent_size, group_size, buf_factory);
+    });
+  }
+  return result;
+}
+
+DenseArrayEdge DenseArrayEdge::UnsafeFromUniformGroups(int64_t parent_size,
+                                                       int64_t group_size) {
+  DenseArrayEdge result(DenseArrayEdge::SPLIT_POINTS, parent_size,
+                        parent_size * group_size, DenseArray<int64_t>());
+  result.uniform_ = std::make_shared<UniformSplitPoints>();
+  result.uniform_->group_size = group_size;
+  return result;
+}
+
+const DenseArray<int64_t>& DenseArrayEdge::MaterializeUniformSplitPoints()
+    const {
+  absl::call_once(uniform_->once, [this] {
+    uniform_->split_points = BuildUniformSplitPoints(
+        parent_size_, uniform_->group_size, *GetHeapBufferFactory());
+  });
+  return uniform_->split_points;
 }
 
 DenseArrayEdge DenseArrayEdge::UnsafeFromMapping(DenseArray<int64_t> mapping,
@@ -153,7 +235,7 @@ DenseArrayEdge DenseArrayEdge::ToMappingEdge(
     case DenseArrayEdge::SPLIT_POINTS: {
       Buffer<int64_t>::Builder bldr(child_size(), &buf_factory);
       int64_t* mapping = bldr.GetMutableSpan().begin();
-      const int64_t* splits = edge_values().values.begin();
+      DenseArraySplitPoints splits(*this);
       for (int64_t parent_id = 0; parent_id < parent_size(); ++parent_id) {
         std::fill(mapping + splits[parent_id], mapping + splits[parent_id + 1],
                   parent_id);
@@ -173,22 +255,27 @@ absl::StatusOr<DenseArrayEdge> DenseArrayEdge::ToSplitPointsEdge(
   }
   Buffer<int64_t>::Builder split_points_builder(parent_size() + 1,
                                                 &buf_factory);
-  auto inserter = split_points_builder.GetInserter();
-  inserter.Add(0);
+  // Split points change only at the boundaries between groups, so we scan the
+  // mapping for value changes and fill the whole run of skipped split points
+  // at once.
+  int64_t* splits = split_points_builder.GetMutableSpan().begin();
+  splits[0] = 0;
   int64_t current_bin = 0;
-  auto values = edge_values().values.span();
-  for (size_t i = 0; i < values.size(); ++i) {
+  const int64_t* values = edge_values().values.begin();
+  const int64_t size = edge_values().size();
+  for (int64_t i = 0; i < size; ++i) {
+    const int64_t value = values[i];
+    if (ABSL_PREDICT_TRUE(value == current_bin)) continue;
     // This can only happen if UnsafeFromMapping was used to construct the edge,
     // and it's the responsibility of the user to ensure it's correct.
-    DCHECK_LE(values[i], parent_size());
-    if (values[i] < current_bin) {
+    DCHECK_LE(value, parent_size());
+    if (value < current_bin) {
       return absl::InvalidArgumentError("expected a sorted mapping");
     }
-    for (; current_bin < values[i]; ++current_bin) inserter.Add(i);
-  }
-  for (; current_bin < parent_size(); ++current_bin) {
-    inserter.Add(edge_values().size());
+    std::fill(splits + current_bin + 1, splits + value + 1, i);
+    current_bin = value;
   }
+  std::fill(splits + current_bin + 1, splits + parent_size() + 1, size);
   return DenseArrayEdge::UnsafeFromSplitPoints(
       DenseArray<int64_t>{std::move(split_points_builder).Build()});
 }
@@ -198,6 +285,9 @@ bool DenseArrayEdge::IsEquivalentTo(const DenseArrayEdge& other) const {
       child_size() != other.child_size()) {
     return false;
   }
+  if (uniform_ != nullptr && other.uniform_ != nullptr) {
+    return true;  // The group sizes are determined by the sizes.
+  }
   if (edge_type() == other.edge_type()) {
     return ArraysAreEquivalent(edge_values(), other.edge_values());
   }
@@ -211,6 +301,21 @@ bool DenseArrayEdge::IsEquivalentTo(const DenseArrayEdge& other) const {
   return ArraysAreEquivalent(this_edge.edge_values(), other_edge.edge_values());
 }
 
+bool DenseArrayEdge::SharesBuffersWith(const DenseArrayEdge& other) const {
+  if (edge_type() != other.edge_type() ||
+      parent_size() != other.parent_size() ||
+      child_size() != other.child_size()) {
+    return false;
+  }
+  if (uniform_ != nullptr || other.uniform_ != nullptr) {
+    // The uniform edges have no buffers, and are identical if the group sizes
+    // match.
+    return uniform_ != nullptr && other.uniform_ != nullptr &&
+           uniform_->group_size == other.uniform_->group_size;
+  }
+  return ArraysShareBuffers(edge_values(), other.edge_values());
+}
+
 absl::StatusOr<DenseArrayEdge> DenseArrayEdge::ComposeEdges(
     absl::Span<const DenseArrayEdge> edges, RawBufferFactory& buf_factory) {
   if (edges.empty()) {
@@ -240,7 +345,20 @@ absl::StatusOr<DenseArrayEdge> DenseArrayEdge::ComposeEdges(
                DenseArrayEdge::SPLIT_POINTS) {
       split_points_end++;
     }
-    if (split_points_end - i >= 2) {
+    if (split_points_end - i >= 2 &&
+        std::all_of(edges.begin() + i, edges.begin() + split_points_end,
+                    [](const DenseArrayEdge& edge) {
+                      return edge.uniform_ != nullptr;
+                    })) {
+      // Uniform edges compose into a uniform edge.
+      int64_t group_size = 1;
+      for (size_t j = i; j < split_points_end; ++j) {
+        group_size *= edges[j].uniform_->group_size;
+      }
+      transformed_edges.push_back(
+          UnsafeFromUniformGroups(edges[i].parent_size(), group_size));
+      i = split_points_end;
+    } else if (split_points_end - i >= 2) {
       // Combine two (or more) split point edges into one.
       ASSIGN_OR_RETURN(auto composed_edge,
                        ComposeSplitPointsEdge(
@@ -264,6 +382,13 @@ absl::StatusOr<DenseArrayEdge> DenseArrayEdge::ComposeEdges(
 
 void FingerprintHasherTraits<DenseArrayEdge>::operator()(
     FingerprintHasher* hasher, const DenseArrayEdge& value) const {
+  // The uniform edges are hashed without materializing the split points, so
+  // the materialized uniform split points must be hashed the same way.
+  if (value.edge_type() == DenseArrayEdge::SPLIT_POINTS &&
+      IsUniformSplitPointsEdge(value)) {
+    hasher->Combine(value.edge_type(), value.parent_size(), value.child_size());
+    return;
+  }
   hasher->Combine(value.edge_type(), value.parent_size(), value.child_size(),
                   value.edge_values());
 }
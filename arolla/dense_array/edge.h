@@ -16,8 +16,12 @@
 #define AROLLA_DENSE_ARRAY_EDGE_H_
 
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <utility>
 
+#include "absl/base/call_once.h"
+#include "absl/base/optimization.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "arolla/dense_array/dense_array.h"
@@ -48,6 +52,12 @@ class AROLLA_API DenseArrayEdge {
   // Creates a DenseArrayEdge with a uniform number of children per parent. The
   // resulting edge is always a SPLIT_POINT edge. Requires parent_size >= 0 and
   // group_size >= 0.
+  //
+  // With the default heap `buf_factory` the edge takes O(1) memory: the split
+  // points are not stored, but computed from uniform_group_size() (see
+  // DenseArraySplitPoints), and edge_values() materializes them on the first
+  // call. With any other `buf_factory` the split points are allocated through
+  // it right away.
   static absl::StatusOr<DenseArrayEdge> FromUniformGroups(
       int64_t parent_size, int64_t group_size,
       RawBufferFactory& buf_factory = *GetHeapBufferFactory());
@@ -94,7 +104,22 @@ class AROLLA_API DenseArrayEdge {
   // Returns the raw edge values whose interpretation depends on edge_type().
   // For SPLIT_POINT edges, this will always be full and sorted. For MAPPING
   // edges, it may be sparse and/or unsorted.
-  const DenseArray<int64_t>& edge_values() const { return edge_values_; }
+  const DenseArray<int64_t>& edge_values() const {
+    if (ABSL_PREDICT_FALSE(uniform_ != nullptr)) {
+      return MaterializeUniformSplitPoints();
+    }
+    return edge_values_;
+  }
+
+  // Returns the number of children of every parent if the edge was created by
+  // FromUniformGroups (or composed from such edges), std::nullopt otherwise.
+  // The group operators use it to avoid reading the split points.
+  std::optional<int64_t> uniform_group_size() const {
+    if (uniform_ == nullptr) {
+      return std::nullopt;
+    }
+    return uniform_->group_size;
+  }
 
   // Converts the edge to a SPLIT_POINTS edge. Requires the underlying mapping
   // to be full and sorted. Split point edges will be returned as-is.
@@ -108,6 +133,10 @@ class AROLLA_API DenseArrayEdge {
   // Returns true iff this edge represents the same edge as other.
   bool IsEquivalentTo(const DenseArrayEdge& other) const;
 
+  // Returns true iff this edge and `other` are backed by the same buffers,
+  // which implies IsEquivalentTo(other). The check is O(1).
+  bool SharesBuffersWith(const DenseArrayEdge& other) const;
+
  private:
   friend class ArrayEdge;
   DenseArrayEdge(EdgeType edge_values_type, int64_t parent_size,
@@ -117,10 +146,55 @@ class AROLLA_API DenseArrayEdge {
         child_size_(child_size),
         edge_values_(std::move(edge_values)) {}
 
+  // The split points of a uniform edge, materialized on demand.
+  struct UniformSplitPoints {
+    int64_t group_size;
+    absl::once_flag once;
+    DenseArray<int64_t> split_points;
+  };
+
+  static DenseArrayEdge UnsafeFromUniformGroups(int64_t parent_size,
+                                                int64_t group_size);
+
+  const DenseArray<int64_t>& MaterializeUniformSplitPoints() const;
+
   EdgeType edge_type_;
   int64_t parent_size_;
   int64_t child_size_;
   DenseArray<int64_t> edge_values_;
+  // Not null only for the uniform edges, which keep `edge_values_` empty. The
+  // state is shared by the copies of the edge, so the split points are
+  // materialized at most once.
+  std::shared_ptr<UniformSplitPoints> uniform_;
+};
+
+// Split points of a SPLIT_POINTS edge: the children of the parent `i` are
+// [split_points[i], split_points[i + 1]). For the uniform edges they are
+// computed on the fly, without materializing edge_values(). The view must not
+// outlive the edge.
+class DenseArraySplitPoints {
+ public:
+  explicit DenseArraySplitPoints(const DenseArrayEdge& edge)
+      : values_(nullptr), size_(edge.parent_size() + 1), group_size_(0) {
+    if (auto group_size = edge.uniform_group_size(); group_size.has_value()) {
+      group_size_ = *group_size;
+    } else {
+      values_ = edge.edge_values().values.begin();
+      size_ = edge.edge_values().size();
+    }
+  }
+
+  // Returns the number of split points.
+  int64_t size() const { return size_; }
+
+  int64_t operator[](int64_t i) const {
+    return values_ != nullptr ? values_[i] : i * group_size_;
+  }
+
+ private:
+  const int64_t* values_;
+  int64_t size_;
+  int64_t group_size_;
 };
 
 // A DenseArrayGroupScalarEdge represents a mapping of a DenseArray to a scalar.
@@ -137,7 +211,9 @@ class AROLLA_API DenseArrayGroupScalarEdge {
 
 // Note that the fingerprint for two Edges representing identical mappings are
 // not guaranteed to be equal. For example, a MAPPING edge will not have the
-// same hash value as an equivalent SPLIT_POINTS edge.
+// same hash value as an equivalent SPLIT_POINTS edge. The uniform edges have
+// the same fingerprint as the equivalent SPLIT_POINTS edges with materialized
+// split points.
 AROLLA_DECLARE_FINGERPRINT_HASHER_TRAITS(DenseArrayEdge);
 AROLLA_DECLARE_FINGERPRINT_HASHER_TRAITS(DenseArrayGroupScalarEdge);
 
@@ -131,5 +131,41 @@ BENCHMARK(BM_DenseArrayEdge_ComposeEdges_MappingAndSplitPointsTail)
     ->Args({6, 10, 3})
     ->Args({6, 10, 6});
 
+void BM_DenseArrayEdge_ToMappingEdge(benchmark::State& state) {
+  const int64_t parent_size = state.range(0);
+  const int64_t num_children = state.range(1);
+  auto edge = GetSplitPointsEdge(parent_size, num_children);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(edge);
+    auto mapping_edge = edge.ToMappingEdge();
+    benchmark::DoNotOptimize(mapping_edge);
+  }
+  state.SetItemsProcessed(state.iterations() * edge.child_size());
+}
+
+BENCHMARK(BM_DenseArrayEdge_ToMappingEdge)
+    // parent size, num children.
+    ->ArgPair(1000000, 1)
+    ->ArgPair(100000, 10)
+    ->ArgPair(10, 100000);
+
+void BM_DenseArrayEdge_ToSplitPointsEdge(benchmark::State& state) {
+  const int64_t parent_size = state.range(0);
+  const int64_t num_children = state.range(1);
+  auto edge = GetMappingEdge(parent_size, num_children);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(edge);
+    auto split_points_edge = edge.ToSplitPointsEdge().value();
+    benchmark::DoNotOptimize(split_points_edge);
+  }
+  state.SetItemsProcessed(state.iterations() * edge.child_size());
+}
+
+BENCHMARK(BM_DenseArrayEdge_ToSplitPointsEdge)
+    // parent size, num children.
+    ->ArgPair(1000000, 1)
+    ->ArgPair(100000, 10)
+    ->ArgPair(10, 100000);
+
 }  // namespace
 }  // namespace arolla
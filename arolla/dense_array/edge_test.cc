@@ -30,6 +30,7 @@
 using ::arolla::testing::StatusIs;
 using ::testing::ElementsAre;
 using ::testing::Eq;
+using ::testing::Optional;
 
 namespace arolla {
 namespace {
@@ -152,9 +153,49 @@ TEST(DenseArrayEdgeTest, FromUniformGroups) {
     ASSERT_OK_AND_ASSIGN(auto edge,
                          DenseArrayEdge::FromUniformGroups(1, 1, arena));
     EXPECT_FALSE(edge.edge_values().values.is_owner());
+    EXPECT_THAT(edge.uniform_group_size(), Optional(1));
   }
 }
 
+TEST(DenseArrayEdgeTest, UniformGroupSize) {
+  ASSERT_OK_AND_ASSIGN(auto edge, DenseArrayEdge::FromUniformGroups(3, 4));
+  EXPECT_THAT(edge.uniform_group_size(), Optional(4));
+  DenseArraySplitPoints split_points(edge);
+  EXPECT_EQ(split_points[0], 0);
+  EXPECT_EQ(split_points[2], 8);
+  EXPECT_EQ(split_points[3], 12);
+
+  // Copies share the materialized split points.
+  DenseArrayEdge copy = edge;
+  EXPECT_EQ(copy.edge_values().values.span().data(),
+            edge.edge_values().values.span().data());
+  EXPECT_THAT(copy.uniform_group_size(), Optional(4));
+
+  ASSERT_OK_AND_ASSIGN(auto split_points_edge,
+                       DenseArrayEdge::FromSplitPoints(
+                           CreateDenseArray<int64_t>({0, 4, 8, 12})));
+  EXPECT_EQ(split_points_edge.uniform_group_size(), std::nullopt);
+  EXPECT_TRUE(edge.IsEquivalentTo(split_points_edge));
+  EXPECT_TRUE(split_points_edge.IsEquivalentTo(edge));
+  EXPECT_FALSE(edge.SharesBuffersWith(split_points_edge));
+  EXPECT_EQ(FingerprintHasher("salt").Combine(edge).Finish(),
+            FingerprintHasher("salt").Combine(split_points_edge).Finish());
+  ASSERT_OK_AND_ASSIGN(auto non_uniform_edge,
+                       DenseArrayEdge::FromSplitPoints(
+                           CreateDenseArray<int64_t>({0, 4, 7, 12})));
+  EXPECT_NE(FingerprintHasher("salt").Combine(edge).Finish(),
+            FingerprintHasher("salt").Combine(non_uniform_edge).Finish());
+
+  ASSERT_OK_AND_ASSIGN(auto other_edge,
+                       DenseArrayEdge::FromUniformGroups(3, 4));
+  EXPECT_TRUE(edge.SharesBuffersWith(other_edge));
+  EXPECT_EQ(FingerprintHasher("salt").Combine(edge).Finish(),
+            FingerprintHasher("salt").Combine(other_edge).Finish());
+
+  EXPECT_THAT(edge.ToMappingEdge().edge_values(),
+              ElementsAre(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2));
+}
+
 TEST(DenseArrayEdgeTest, DefaultEdge) {
   DenseArrayEdge edge;
   EXPECT_THAT(edge.edge_type(), Eq(DenseArrayEdge::MAPPING));
@@ -491,6 +532,24 @@ TEST(DenseArrayEdgeTest, ComposeEdges_Mapping) {
   }
 }
 
+TEST(DenseArrayEdgeTest, ComposeEdges_Uniform) {
+  ASSERT_OK_AND_ASSIGN(auto edge1, DenseArrayEdge::FromUniformGroups(2, 3));
+  ASSERT_OK_AND_ASSIGN(auto edge2, DenseArrayEdge::FromUniformGroups(6, 2));
+  ASSERT_OK_AND_ASSIGN(auto composed_edge,
+                       DenseArrayEdge::ComposeEdges({edge1, edge2}));
+  EXPECT_THAT(composed_edge.uniform_group_size(), Optional(6));
+  EXPECT_THAT(composed_edge.edge_values(), ElementsAre(0, 6, 12));
+
+  // Mixed with a non-uniform split points edge.
+  ASSERT_OK_AND_ASSIGN(
+      auto edge3, DenseArrayEdge::FromSplitPoints(CreateDenseArray<int64_t>(
+                      {0, 1, 1, 2, 4, 4, 5, 5, 5, 5, 5, 5, 6})));
+  ASSERT_OK_AND_ASSIGN(composed_edge,
+                       DenseArrayEdge::ComposeEdges({edge1, edge2, edge3}));
+  EXPECT_EQ(composed_edge.uniform_group_size(), std::nullopt);
+  EXPECT_THAT(composed_edge.edge_values(), ElementsAre(0, 5, 6));
+}
+
 TEST(DenseArrayEdgeTest, ComposeEdges_BufferFactory) {
   ASSERT_OK_AND_ASSIGN(auto edge1, DenseArrayEdge::FromSplitPoints(
                                        CreateDenseArray<int64_t>({0, 2})));
@@ -206,6 +206,11 @@ void BM_UniversalDenseOp_AddDenseWithOffset_SkipMissed(
                                                                 false, true);
 }
 
+void BM_UniversalDenseOp_AddFull_SkipMissed(benchmark::State& state) {
+  RunUniversalDenseOpBenchmark<DenseOpFlags::kNoSizeValidation>(state, AddFn(),
+                                                                true, false);
+}
+
 void BM_UniversalDenseOp_UnionAddDense(benchmark::State& state) {
   RunUniversalDenseOpBenchmark<DenseOpFlags::kRunOnMissing |
                                DenseOpFlags::kNoBitmapOffset |
@@ -223,6 +228,7 @@ BENCHMARK(BM_UniversalDenseOp_AddFull)->SIZES;
 BENCHMARK(BM_UniversalDenseOp_AddDense)->SIZES;
 BENCHMARK(BM_UniversalDenseOp_AddDenseWithOffset)->SIZES;
 BENCHMARK(BM_UniversalDenseOp_AddDenseWithOffset_SkipMissed)->SIZES;
+BENCHMARK(BM_UniversalDenseOp_AddFull_SkipMissed)->SIZES;
 BENCHMARK(BM_UniversalDenseOp_UnionAddDense)->SIZES;
 
 // *** Vectors
@@ -15,6 +15,7 @@
 #ifndef AROLLA_DENSE_ARRAY_OPS_DENSE_GROUP_OPS_H_
 #define AROLLA_DENSE_ARRAY_OPS_DENSE_GROUP_OPS_H_
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <type_traits>
@@ -24,12 +25,15 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/bitmap.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/ops/util.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/util/meta.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/view_types.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -53,6 +57,21 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
   static constexpr bool kIsPartial = Accumulator::IsPartial();
   static constexpr bool kIsFull = Accumulator::IsFull();
 
+  // Only aggregators write results to the parent id space, where the threads
+  // can own disjoint words of the result bitmap. The results must have fixed
+  // size, since StringsBuffer::Builder can't be used from several threads.
+  static constexpr bool kSupportsParallelism =
+      kIsAggregator && std::is_trivially_copyable_v<ResT>;
+  static constexpr bool kSupportsParallelMapping =
+      kSupportsParallelism && accumulator_has_merge_v<Accumulator>;
+  // Partial accumulators write results to the child id space, so the child
+  // rows can be split between the threads, but the groups crossing the range
+  // bounds need the state accumulated in the previous ranges (see
+  // ApplyWithSplitPointsScanInParallel).
+  static constexpr bool kSupportsParallelScan =
+      kIsPartial && std::is_trivially_copyable_v<ResT> &&
+      accumulator_has_merge_v<Accumulator>;
+
  public:
   // DenseGroupOps constructor.
   //
@@ -61,10 +80,15 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
   //  `empty_accumulator` is an Accumulator instance used as a prototype for
   //      creating new accumulators. Note that a given accumulator may be used
   //      for multiple groups within a single operation.
+  //  `parallelism` enables multithreaded evaluation of big edges, see
+  //      GroupOpParallelism. `buffer_factory` is only used in the calling
+  //      thread.
   explicit DenseGroupOpsImpl(RawBufferFactory* buffer_factory,
-                             Accumulator empty_accumulator = Accumulator())
+                             Accumulator empty_accumulator = Accumulator(),
+                             GroupOpParallelism parallelism = {})
       : buffer_factory_(buffer_factory),
-        empty_accumulator_(std::move(empty_accumulator)) {}
+        empty_accumulator_(std::move(empty_accumulator)),
+        parallelism_(parallelism) {}
 
   // Applies this group operator.
   //
@@ -85,9 +109,9 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
     }
     switch (edge.edge_type()) {
       case DenseArrayEdge::SPLIT_POINTS: {
-        const auto& split_points = edge.edge_values();
         return ApplyWithSplitPoints(edge.parent_size(), edge.child_size(),
-                                    split_points, p_args..., c_args...);
+                                    DenseArraySplitPoints(edge), p_args...,
+                                    c_args...);
       }
       case DenseArrayEdge::MAPPING: {
         const auto& mapping = edge.edge_values();
@@ -157,6 +181,18 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
       const AsDenseArray<ParentTs>&... p_values,
       const AsDenseArray<ChildTs>&... c_values) const {
     DCHECK_EQ(child_row_count, mapping.size());
+    if constexpr (kSupportsParallelMapping) {
+      // Each thread has its own accumulators for all the groups, so it is
+      // only worth it if there are many more children than parents.
+      int64_t thread_count =
+          std::min(GetThreadCount(child_row_count),
+                   child_row_count / std::max<int64_t>(parent_row_count, 1));
+      if (thread_count > 1) {
+        return ApplyWithMappingInParallel(thread_count, parent_row_count,
+                                          child_row_count, mapping,
+                                          p_values..., c_values...);
+      }
+    }
     using MappingAndChildUtil =
         DenseOpsUtil<meta::type_list<int64_t, ChildTs...>>;
 
@@ -236,20 +272,33 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
   }
 
   // Applies this group operator using a `splits` mapping from parent to child
-  // row ids. `splits` is a DenseArray having a row_count which is one greater
-  // than the parent index. It defines a mapping wherein parent id P corresponds
-  // to child ids [splits[P], splits[P+1]).
-  // splits[parent_row_count] should be equal to child_row_count.
+  // row ids. It defines a mapping wherein parent id P corresponds to child ids
+  // [splits[P], splits[P+1]). splits[parent_row_count] should be equal to
+  // child_row_count.
   template <size_t... GIs>
   absl::StatusOr<DenseArray<ResT>> ApplyWithSplitPoints(
       int64_t parent_row_count, int64_t child_row_count,
-      const DenseArray<int64_t>& splits,
-      const AsDenseArray<ParentTs>&... p_values,
+      DenseArraySplitPoints splits, const AsDenseArray<ParentTs>&... p_values,
       const AsDenseArray<ChildTs>&... c_values) const {
     if (splits.size() != parent_row_count + 1) {
       return absl::InvalidArgumentError(
           "splits row count is not compatible with parent row count");
     }
+    if constexpr (kSupportsParallelism) {
+      int64_t thread_count = GetThreadCount(child_row_count);
+      if (thread_count > 1) {
+        return ApplyWithSplitPointsInParallel(
+            thread_count, parent_row_count, child_row_count, splits,
+            p_values..., c_values...);
+      }
+    } else if constexpr (kSupportsParallelScan) {
+      int64_t thread_count = GetThreadCount(child_row_count);
+      if (thread_count > 1) {
+        return ApplyWithSplitPointsScanInParallel(
+            thread_count, parent_row_count, child_row_count, splits,
+            p_values..., c_values...);
+      }
+    }
 
     const int64_t result_row_count =
         kIsAggregator ? parent_row_count : child_row_count;
@@ -273,14 +322,12 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
   }
 
   void ProcessSingleGroupWithSplitPoints(
-      int64_t parent_id, const DenseArray<int64_t>& splits,
+      int64_t parent_id, DenseArraySplitPoints splits,
       const AsDenseArray<ChildTs>&... c_values,
       std::vector<int64_t>& processed_rows, Accumulator& accumulator,
       DenseArrayBuilder<ResT>& builder) const {
-    DCHECK(splits.present(parent_id));
-    DCHECK(splits.present(parent_id + 1));
-    int64_t child_from = splits.values[parent_id];
-    int64_t child_to = splits.values[parent_id + 1];
+    int64_t child_from = splits[parent_id];
+    int64_t child_to = splits[parent_id + 1];
 
     auto fn = [&](int64_t child_id, bool child_row_valid,
                   view_type_t<ChildTs>... args) {
@@ -307,6 +354,292 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
     }
   }
 
+  // Returns the number of threads to use for the given number of child rows.
+  int64_t GetThreadCount(int64_t child_row_count) const {
+    if (parallelism_.threading == nullptr) {
+      return 1;
+    }
+    int64_t min_rows_per_thread =
+        std::max<int64_t>(parallelism_.min_child_rows_per_thread, 1);
+    return std::clamp<int64_t>(
+        child_row_count / min_rows_per_thread, 1,
+        std::max(parallelism_.threading->GetRecommendedThreadCount(), 1));
+  }
+
+  // Splits parent ids [0, parent_row_count) into at most `range_count`
+  // contiguous ranges with approximately equal sum of `weights`. The range
+  // bounds are aligned to bitmap words, so the ranges can be written to the
+  // same DenseArrayBuilder in parallel. `cumulative_weight(i)` must be a
+  // non-decreasing function returning the total weight of parents [0, i).
+  template <typename Fn>
+  static std::vector<int64_t> SplitParentRanges(int64_t range_count,
+                                                int64_t parent_row_count,
+                                                Fn cumulative_weight) {
+    int64_t total_weight = cumulative_weight(parent_row_count);
+    std::vector<int64_t> bounds = {0};
+    for (int64_t i = 1; i < range_count; ++i) {
+      int64_t target_weight = total_weight / range_count * i;
+      // The first parent with cumulative_weight(parent) >= target_weight.
+      int64_t lo = 0, hi = parent_row_count;
+      while (lo < hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (cumulative_weight(mid) < target_weight) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      int64_t bound = lo / bitmap::kWordBitCount * bitmap::kWordBitCount;
+      if (bound > bounds.back()) {
+        bounds.push_back(bound);
+      }
+    }
+    if (parent_row_count > bounds.back()) {
+      bounds.push_back(parent_row_count);
+    }
+    return bounds;
+  }
+
+  absl::StatusOr<DenseArray<ResT>> ApplyWithSplitPointsInParallel(
+      int64_t thread_count, int64_t parent_row_count, int64_t child_row_count,
+      DenseArraySplitPoints splits, const AsDenseArray<ParentTs>&... p_values,
+      const AsDenseArray<ChildTs>&... c_values) const {
+    std::vector<int64_t> bounds = SplitParentRanges(
+        thread_count, parent_row_count,
+        [&](int64_t parent_id) { return splits[parent_id]; });
+    DenseArrayBuilder<ResT> builder(parent_row_count, buffer_factory_);
+    std::vector<absl::Status> statuses(bounds.size() - 1);
+    ParallelFor(
+        *parallelism_.threading, bounds.size() - 1, [&](int64_t range_id) {
+          Accumulator accumulator = empty_accumulator_;
+          std::vector<int64_t> processed_rows;  // Not used by aggregators.
+          ParentUtil::Iterate(
+              [&](int64_t parent_id, bool parent_valid,
+                  view_type_t<ParentTs>... args) {
+                if (parent_valid) {
+                  accumulator.Reset(args...);
+                  ProcessSingleGroupWithSplitPoints(parent_id, splits,
+                                                    c_values..., processed_rows,
+                                                    accumulator, builder);
+                }
+              },
+              bounds[range_id], bounds[range_id + 1], p_values...);
+          statuses[range_id] = accumulator.GetStatus();
+        });
+    for (const absl::Status& status : statuses) {
+      RETURN_IF_ERROR(status);
+    }
+    return std::move(builder).Build();
+  }
+
+  // Returns the parent containing the child row, i.e. the last parent_id with
+  // splits[parent_id] <= child_id.
+  static int64_t FindParent(DenseArraySplitPoints splits,
+                            int64_t parent_row_count, int64_t child_id) {
+    int64_t lo = 0, hi = parent_row_count;
+    while (lo < hi) {
+      int64_t mid = lo + (hi - lo) / 2;
+      if (splits[mid + 1] <= child_id) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  // Parallel prefix scan for partial accumulators. The child rows are split
+  // into contiguous ranges aligned to bitmap words, so even a single long
+  // group is processed by several threads:
+  //  1. Every thread accumulates the rows of the group crossing the end of its
+  //     range (if any).
+  //  2. The calling thread merges these states into the states at the start
+  //     of every range, it takes O(thread_count) merges.
+  //  3. Every thread processes its range starting from the merged state.
+  // So every child row is accumulated at most twice. The merges reorder the
+  // additions, see GroupOpParallelism for the effect on inexact accumulators.
+  absl::StatusOr<DenseArray<ResT>> ApplyWithSplitPointsScanInParallel(
+      int64_t thread_count, int64_t parent_row_count, int64_t child_row_count,
+      DenseArraySplitPoints splits, const AsDenseArray<ParentTs>&... p_values,
+      const AsDenseArray<ChildTs>&... c_values) const {
+    int64_t range_size = (child_row_count + thread_count - 1) / thread_count;
+    range_size =
+        bitmap::BitmapSize(range_size) * bitmap::kWordBitCount;  // Round up.
+    std::vector<int64_t> bounds;
+    for (int64_t i = 0; i < child_row_count; i += range_size) {
+      bounds.push_back(i);
+    }
+    bounds.push_back(child_row_count);
+    const int64_t range_count = bounds.size() - 1;
+    // first_parents[i] is the parent containing child row bounds[i], it
+    // crosses the bound if it starts before it.
+    std::vector<int64_t> first_parents(range_count + 1);
+    for (int64_t i = 0; i <= range_count; ++i) {
+      first_parents[i] = FindParent(splits, parent_row_count, bounds[i]);
+    }
+    auto crosses_bound = [&](int64_t i) {
+      return i > 0 && i < range_count &&
+             splits[first_parents[i]] < bounds[i];
+    };
+
+    // Calls `fn(parent_id)` for the valid parents intersecting child rows
+    // [child_from, child_to), after resetting `accumulator` for the parent.
+    auto for_each_parent = [&](int64_t child_from, int64_t child_to,
+                               Accumulator& accumulator, auto fn) {
+      ParentUtil::Iterate(
+          [&](int64_t parent_id, bool parent_valid,
+              view_type_t<ParentTs>... args) {
+            if (parent_valid) {
+              accumulator.Reset(args...);
+              fn(parent_id);
+            }
+          },
+          FindParent(splits, parent_row_count, child_from),
+          FindParent(splits, parent_row_count, child_to - 1) + 1, p_values...);
+    };
+
+    // Step 1: range_states[i] accumulates rows [bounds[i], bounds[i + 1]) of
+    // the group crossing bounds[i + 1].
+    std::vector<Accumulator> range_states(range_count, empty_accumulator_);
+    // Not std::vector<bool>, since it is written from several threads.
+    std::vector<char> has_range_state(range_count, false);
+    ParallelFor(*parallelism_.threading, range_count, [&](int64_t range_id) {
+      if (!crosses_bound(range_id + 1)) {
+        return;
+      }
+      int64_t parent_id = first_parents[range_id + 1];
+      int64_t child_from = std::max(splits[parent_id], bounds[range_id]);
+      Accumulator& accumulator = range_states[range_id];
+      for_each_parent(child_from, child_from + 1, accumulator, [&](int64_t) {
+        ChildUtil::Iterate(
+            [&](int64_t child_id, bool valid, view_type_t<ChildTs>... args) {
+              if (valid) Add(accumulator, child_id, args...);
+            },
+            child_from, bounds[range_id + 1], c_values...);
+        has_range_state[range_id] = true;
+      });
+    });
+
+    // Step 2: initial_states[i] is the state of the group crossing bounds[i]
+    // after the rows before bounds[i].
+    std::vector<Accumulator> initial_states(range_count, empty_accumulator_);
+    for (int64_t i = 1; i < range_count; ++i) {
+      if (!has_range_state[i - 1]) {
+        continue;
+      }
+      if (first_parents[i - 1] == first_parents[i] && crosses_bound(i - 1)) {
+        initial_states[i] = initial_states[i - 1];
+        initial_states[i].Merge(range_states[i - 1]);
+      } else {
+        initial_states[i] = range_states[i - 1];
+      }
+    }
+
+    // Step 3.
+    DenseArrayBuilder<ResT> builder(child_row_count, buffer_factory_);
+    std::vector<absl::Status> statuses(range_count);
+    ParallelFor(*parallelism_.threading, range_count, [&](int64_t range_id) {
+      Accumulator accumulator = empty_accumulator_;
+      absl::Status& status = statuses[range_id];
+      int64_t range_from = bounds[range_id];
+      int64_t range_to = bounds[range_id + 1];
+      for_each_parent(
+          range_from, range_to, accumulator, [&](int64_t parent_id) {
+            if (parent_id == first_parents[range_id] &&
+                crosses_bound(range_id)) {
+              accumulator = initial_states[range_id];
+            }
+            ChildUtil::Iterate(
+                [&](int64_t child_id, bool valid,
+                    view_type_t<ChildTs>... args) {
+                  if (valid) {
+                    Add(accumulator, child_id, args...);
+                    builder.Set(child_id, accumulator.GetResult());
+                  }
+                },
+                std::max(splits[parent_id], range_from),
+                std::min(splits[parent_id + 1], range_to), c_values...);
+            if (status.ok()) {
+              status = accumulator.GetStatus();
+            }
+          });
+    });
+    for (const absl::Status& status : statuses) {
+      RETURN_IF_ERROR(status);
+    }
+    return std::move(builder).Build();
+  }
+
+  // Each thread accumulates a contiguous range of child rows in its own set
+  // of accumulators. Then the accumulators are merged in parallel over ranges
+  // of parents.
+  absl::StatusOr<DenseArray<ResT>> ApplyWithMappingInParallel(
+      int64_t thread_count, int64_t parent_row_count, int64_t child_row_count,
+      const DenseArray<int64_t>& mapping,
+      const AsDenseArray<ParentTs>&... p_values,
+      const AsDenseArray<ChildTs>&... c_values) const {
+    using MappingAndChildUtil =
+        DenseOpsUtil<meta::type_list<int64_t, ChildTs...>>;
+    std::vector<bool> valid_groups(parent_row_count, false);
+    ParentUtil::IterateFromZero(
+        [&](int64_t group, bool valid, view_type_t<ParentTs>...) {
+          valid_groups[group] = valid;
+        },
+        parent_row_count, p_values...);
+
+    std::vector<std::vector<Accumulator>> accumulators(thread_count);
+    ParallelFor(*parallelism_.threading, thread_count, [&](int64_t thread_id) {
+      std::vector<Accumulator>& thread_accumulators = accumulators[thread_id];
+      thread_accumulators.resize(parent_row_count, empty_accumulator_);
+      ParentUtil::IterateFromZero(
+          [&](int64_t group, bool valid, view_type_t<ParentTs>... args) {
+            if (valid) thread_accumulators[group].Reset(args...);
+          },
+          parent_row_count, p_values...);
+      MappingAndChildUtil::Iterate(
+          [&](int64_t child_id, bool valid, int64_t parent_id,
+              view_type_t<ChildTs>... args) {
+            if (valid && valid_groups[parent_id]) {
+              Add(thread_accumulators[parent_id], child_id, args...);
+            }
+          },
+          child_row_count * thread_id / thread_count,
+          child_row_count * (thread_id + 1) / thread_count, mapping,
+          c_values...);
+    });
+
+    std::vector<int64_t> bounds = SplitParentRanges(
+        thread_count, parent_row_count,
+        [](int64_t parent_id) { return parent_id; });
+    DenseArrayBuilder<ResT> builder(parent_row_count, buffer_factory_);
+    std::vector<absl::Status> statuses(bounds.size() - 1);
+    ParallelFor(
+        *parallelism_.threading, bounds.size() - 1, [&](int64_t range_id) {
+          absl::Status& status = statuses[range_id];
+          for (int64_t parent_id = bounds[range_id];
+               parent_id < bounds[range_id + 1]; ++parent_id) {
+            if (!valid_groups[parent_id]) {
+              continue;
+            }
+            Accumulator& accumulator = accumulators[0][parent_id];
+            for (int64_t i = 1; i < thread_count; ++i) {
+              if (status.ok()) {
+                status = accumulators[i][parent_id].GetStatus();
+              }
+              accumulator.Merge(accumulators[i][parent_id]);
+            }
+            builder.Set(parent_id, accumulator.GetResult());
+            if (status.ok()) {
+              status = accumulator.GetStatus();
+            }
+          }
+        });
+    for (const absl::Status& status : statuses) {
+      RETURN_IF_ERROR(status);
+    }
+    return std::move(builder).Build();
+  }
+
   void Add(Accumulator& accumulator, int64_t child_id,
            view_type_t<ChildTs>... args) const {
     if constexpr (ForwardId) {
@@ -319,6 +652,7 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
 
   RawBufferFactory* buffer_factory_;
   const Accumulator empty_accumulator_;
+  GroupOpParallelism parallelism_;
 };
 
 }  // namespace dense_ops_internal
@@ -14,6 +14,8 @@
 //
 #include "arolla/dense_array/ops/dense_group_ops.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <optional>
 #include <vector>
@@ -26,9 +28,11 @@
 #include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/testing/util.h"
 #include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qexpr/aggregation_ops_interface.h"
 #include "arolla/qexpr/operators/testing/accumulators.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/text.h"
+#include "arolla/util/threading.h"
 
 namespace arolla {
 namespace {
@@ -37,6 +41,7 @@ using ::arolla::testing::CreateDenseArrayFromIdValues;
 using ::arolla::testing::IsOkAndHolds;
 using ::arolla::testing::StatusIs;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::HasSubstr;
 using ::testing::Test;
 
@@ -59,6 +64,11 @@ TEST(DenseGroupOps, FullArrayGroupSum) {
                        DenseArrayEdge::FromSplitPoints(splits));
   EXPECT_THAT(*agg.Apply(edge2, values),
               ElementsAre(std::nullopt, 13.0f, 3.0f, 6.0f));
+
+  // Test aggregation using a uniform edge.
+  ASSERT_OK_AND_ASSIGN(DenseArrayEdge edge3,
+                       DenseArrayEdge::FromUniformGroups(2, 2));
+  EXPECT_THAT(*agg.Apply(edge3, values), ElementsAre(13.0f, 9.0f));
 }
 
 TEST(DenseGroupOps, ForwardId) {
@@ -258,5 +268,167 @@ TEST(DenseGroupOps, OptionalText) {
   }
 }
 
+TEST(DenseGroupOps, ParallelAggregation) {
+  constexpr int64_t kParentCount = 300;
+  constexpr int64_t kChildCount = 10000;
+  std::vector<int64_t> mapping_values(kChildCount);
+  std::vector<int64_t> split_values = {0};
+  std::vector<std::optional<int64_t>> values(kChildCount);
+  for (int64_t i = 0; i < kChildCount; ++i) {
+    mapping_values[i] = (i * 7) % kParentCount;
+    // Uneven groups.
+    if (i * kParentCount / kChildCount >= split_values.size() &&
+        i % 3 != 0) {
+      split_values.push_back(i);
+    }
+    if (i % 5 != 0) values[i] = i;
+  }
+  while (split_values.size() <= kParentCount) {
+    split_values.push_back(kChildCount);
+  }
+  ASSERT_OK_AND_ASSIGN(
+      DenseArrayEdge mapping_edge,
+      DenseArrayEdge::FromMapping(CreateFullDenseArray(mapping_values),
+                                  kParentCount));
+  ASSERT_OK_AND_ASSIGN(
+      DenseArrayEdge splits_edge,
+      DenseArrayEdge::FromSplitPoints(CreateFullDenseArray(split_values)));
+  auto child_values = CreateDenseArray<int64_t>(values.begin(), values.end());
+
+  StdThreading threading(4);
+  GroupOpParallelism parallelism{.threading = &threading,
+                                 .min_child_rows_per_thread = 100};
+  DenseGroupOps<testing::AggSumAccumulator<int64_t>> sequential_sum(
+      GetHeapBufferFactory());
+  DenseGroupOps<testing::AggSumAccumulator<int64_t>> parallel_sum(
+      GetHeapBufferFactory(), {}, parallelism);
+  DenseGroupOps<testing::AggCountAccumulator<int64_t>> sequential_count(
+      GetHeapBufferFactory());
+  DenseGroupOps<testing::AggCountAccumulator<int64_t>> parallel_count(
+      GetHeapBufferFactory(), {}, parallelism);
+  for (const DenseArrayEdge& edge : {mapping_edge, splits_edge}) {
+    ASSERT_OK_AND_ASSIGN(auto expected_sum,
+                         sequential_sum.Apply(edge, child_values));
+    ASSERT_OK_AND_ASSIGN(auto actual_sum,
+                         parallel_sum.Apply(edge, child_values));
+    EXPECT_THAT(actual_sum, ElementsAreArray(expected_sum));
+    ASSERT_OK_AND_ASSIGN(auto expected_count,
+                         sequential_count.Apply(edge, child_values));
+    ASSERT_OK_AND_ASSIGN(auto actual_count,
+                         parallel_count.Apply(edge, child_values));
+    EXPECT_THAT(actual_count, ElementsAreArray(expected_count));
+  }
+}
+
+TEST(DenseGroupOps, ParallelScan) {
+  constexpr int64_t kChildCount = 10000;
+  // A long group crossing several ranges, small groups, empty groups and a
+  // missing group.
+  std::vector<int64_t> split_values = {0, 7000, 7000, 7010, 7100, 8000};
+  for (int64_t i = 8100; i < kChildCount; i += 100) {
+    split_values.push_back(i);
+  }
+  split_values.push_back(kChildCount);
+  std::vector<std::optional<int64_t>> offsets(split_values.size() - 1);
+  for (int64_t i = 0; i < offsets.size(); ++i) {
+    if (i != 4) offsets[i] = i * 1000;
+  }
+  std::vector<std::optional<int64_t>> values(kChildCount);
+  for (int64_t i = 0; i < kChildCount; ++i) {
+    if (i % 5 != 0) values[i] = i;
+  }
+  ASSERT_OK_AND_ASSIGN(
+      DenseArrayEdge edge,
+      DenseArrayEdge::FromSplitPoints(CreateFullDenseArray(split_values)));
+  auto parent_values =
+      CreateDenseArray<int64_t>(offsets.begin(), offsets.end());
+  auto child_values = CreateDenseArray<int64_t>(values.begin(), values.end());
+
+  StdThreading threading(4);
+  DenseGroupOps<testing::CumSumAccumulator<int64_t>> sequential_op(
+      GetHeapBufferFactory());
+  ASSERT_OK_AND_ASSIGN(
+      auto expected, sequential_op.Apply(edge, parent_values, child_values));
+  for (int64_t min_child_rows_per_thread : {100, 1000, 5000}) {
+    DenseGroupOps<testing::CumSumAccumulator<int64_t>> parallel_op(
+        GetHeapBufferFactory(), {},
+        {.threading = &threading,
+         .min_child_rows_per_thread = min_child_rows_per_thread});
+    ASSERT_OK_AND_ASSIGN(auto actual,
+                         parallel_op.Apply(edge, parent_values, child_values));
+    EXPECT_THAT(actual, ElementsAreArray(expected));
+  }
+}
+
+TEST(DenseGroupOps, ParallelScanSingleGroup) {
+  constexpr int64_t kChildCount = 10000;
+  ASSERT_OK_AND_ASSIGN(DenseArrayEdge edge,
+                       DenseArrayEdge::FromSplitPoints(
+                           CreateDenseArray<int64_t>({0, kChildCount})));
+  std::vector<int64_t> int_values(kChildCount);
+  std::vector<double> double_values(kChildCount);
+  for (int64_t i = 0; i < kChildCount; ++i) {
+    int_values[i] = i * 7 % 13;
+    double_values[i] = 0.1 * (i % 17);
+  }
+  auto int_child_values = CreateFullDenseArray(int_values);
+  auto double_child_values = CreateFullDenseArray(double_values);
+  auto int_offset = CreateDenseArray<int64_t>({5});
+  auto double_offset = CreateDenseArray<double>({0.5});
+
+  StdThreading threading(4);
+  GroupOpParallelism parallelism{.threading = &threading,
+                                 .min_child_rows_per_thread = 100};
+  DenseGroupOps<testing::CumSumAccumulator<int64_t>> sequential_int_op(
+      GetHeapBufferFactory());
+  DenseGroupOps<testing::CumSumAccumulator<int64_t>> parallel_int_op(
+      GetHeapBufferFactory(), {}, parallelism);
+  ASSERT_OK_AND_ASSIGN(
+      auto expected_ints,
+      sequential_int_op.Apply(edge, int_offset, int_child_values));
+  // The integer sums are exact.
+  EXPECT_THAT(parallel_int_op.Apply(edge, int_offset, int_child_values),
+              IsOkAndHolds(ElementsAreArray(expected_ints)));
+
+  DenseGroupOps<testing::CumSumAccumulator<double>> sequential_double_op(
+      GetHeapBufferFactory());
+  DenseGroupOps<testing::CumSumAccumulator<double>> parallel_double_op(
+      GetHeapBufferFactory(), {}, parallelism);
+  ASSERT_OK_AND_ASSIGN(
+      auto expected_doubles,
+      sequential_double_op.Apply(edge, double_offset, double_child_values));
+  ASSERT_OK_AND_ASSIGN(
+      auto actual_doubles,
+      parallel_double_op.Apply(edge, double_offset, double_child_values));
+  // The floating point sums are reordered, so only equal up to rounding.
+  ASSERT_EQ(actual_doubles.size(), kChildCount);
+  for (int64_t i = 0; i < kChildCount; ++i) {
+    ASSERT_TRUE(actual_doubles.present(i));
+    EXPECT_NEAR(actual_doubles.values[i], expected_doubles.values[i],
+                1e-9 * std::abs(expected_doubles.values[i]))
+        << i;
+  }
+}
+
+TEST(DenseGroupOps, ParallelAggregationWithErrorStatus) {
+  constexpr int64_t kChildCount = 1000;
+  std::vector<int64_t> split_values(101);
+  for (int64_t i = 0; i < split_values.size(); ++i) {
+    split_values[i] = std::min<int64_t>(i * 20, kChildCount);  // Empty tail.
+  }
+  ASSERT_OK_AND_ASSIGN(
+      DenseArrayEdge edge,
+      DenseArrayEdge::FromSplitPoints(CreateFullDenseArray(split_values)));
+  auto values = CreateFullDenseArray(std::vector<float>(kChildCount, 1.0f));
+
+  StdThreading threading(4);
+  DenseGroupOps<testing::AverageAccumulator> agg(
+      GetHeapBufferFactory(), {},
+      {.threading = &threading, .min_child_rows_per_thread = 100});
+  EXPECT_THAT(
+      agg.Apply(edge, values),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("empty group")));
+}
+
 }  // namespace
 }  // namespace arolla
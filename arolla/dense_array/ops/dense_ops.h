@@ -34,6 +34,7 @@
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/util/meta.h"
+#include "arolla/util/row_errors.h"
 #include "arolla/util/unit.h"
 #include "arolla/util/view_types.h"
 
@@ -300,8 +301,9 @@ struct ImplSwitcher {
   using Chooser = ImplChooser<Fn, flags>;
   using Impl = UniversalDenseOp<Fn, ResT, !Chooser::kRunOnMissing,
                                 Chooser::kNoBitmapOffset>;
-  static Impl Create(Fn fn, RawBufferFactory* buffer_factory) {
-    return Impl(fn, buffer_factory);
+  static Impl Create(Fn fn, RawBufferFactory* buffer_factory,
+                     RowErrors* row_errors = nullptr) {
+    return Impl(fn, buffer_factory, row_errors);
   }
 };
 
@@ -385,6 +387,24 @@ DenseOp<Fn, ResT, flags> CreateDenseOp(
                                                                    buf_factory);
 }
 
+// Creates DenseOp from a pointwise functor returning absl::StatusOr. The rows
+// where the functor fails become missing in the result and are recorded in
+// `row_errors` instead of failing the whole operation. Errors that are not
+// related to a single row (e.g. arguments size mismatch) are still returned.
+// `flags` is BITWISE OR of DenseOpFlags.
+template <int flags, class Fn,
+          class ResT = dense_ops_internal::result_base_t<Fn>>
+DenseOp<Fn, ResT, flags> CreateDenseOpWithRowErrors(
+    Fn fn, RowErrors* row_errors,
+    RawBufferFactory* buf_factory = GetHeapBufferFactory()) {
+  using fn_return_t = typename meta::function_traits<Fn>::return_type;
+  static_assert(
+      meta::is_wrapped_with<absl::StatusOr, fn_return_t>::value,
+      "row errors are only supported for functors returning absl::StatusOr");
+  return dense_ops_internal::ImplSwitcher<Fn, ResT, flags>::Create(
+      fn, buf_factory, row_errors);
+}
+
 // Creates DenseOp from unary spanwise functor
 template <class ResT, class SpanOpT>
 auto CreateDenseUnaryOpFromSpanOp(
@@ -33,6 +33,7 @@
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/operators/math/batch_arithmetic.h"
 #include "arolla/util/bytes.h"
+#include "arolla/util/row_errors.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/text.h"
 
@@ -284,6 +285,29 @@ TEST(UniversalDenseOp, UnionAdd) {
                ::testing::HasSubstr("argument sizes mismatch: (2, 4)")));
 }
 
+TEST(UniversalDenseOp, AllPresent) {
+  DenseArray<int> arr1 = CreateDenseArray<int>({1, 2, 3, 4});
+  DenseArray<int> arr2 = CreateDenseArray<int>({5, 6, 7, 8});
+  ASSERT_TRUE(arr1.bitmap.empty());
+  ASSERT_TRUE(arr2.bitmap.empty());
+
+  {
+    auto res = UniversalDenseOp<AddFn, int, true, false>(AddFn())(arr1, arr2);
+    EXPECT_TRUE(res.bitmap.empty());
+    EXPECT_THAT(res, ElementsAre(6, 8, 10, 12));
+  }
+  {
+    auto res = UniversalDenseOp<UnionAddFn, int, false, false>(UnionAddFn())(
+        arr1, arr2);
+    EXPECT_THAT(res, ElementsAre(6, 8, 10, 12));
+  }
+  {  // Only one of the arguments is full.
+    DenseArray<int> arr3 = CreateDenseArray<int>({1, {}, 2, 3});
+    auto res = UniversalDenseOp<AddFn, int, true, false>(AddFn())(arr1, arr3);
+    EXPECT_THAT(res, ElementsAre(2, std::nullopt, 5, 7));
+  }
+}
+
 TEST(UniversalDenseOp, BitOffset) {
   DenseArray<int> arr1 = CreateDenseArray<int>({1, {false, 2}, 3, 4});
   DenseArray<int> arr2 = CreateDenseArray<int>({{}, 5, 5, 5});
@@ -425,6 +449,44 @@ TEST(UniversalDenseOp, ForwardErrorStatus) {
   EXPECT_THAT(res, ElementsAre(2, std::nullopt, 3, 4));
 }
 
+TEST(DenseOps, RowErrors) {
+  std::vector<OptionalValue<int>> values(70, 1);
+  values[3] = std::nullopt;
+  values[5] = 0;
+  values[65] = 0;
+  auto arr = CreateDenseArray<int>(values);
+  auto fn = [](int a, int b) -> absl::StatusOr<int> {
+    if (b == 0) {
+      return absl::InvalidArgumentError("division by zero");
+    }
+    return a / b;
+  };
+
+  RowErrors row_errors;
+  auto op = CreateDenseOpWithRowErrors<0>(fn, &row_errors);
+  ASSERT_OK_AND_ASSIGN(auto res, op(arr, arr));
+  EXPECT_EQ(res.size(), 70);
+  EXPECT_EQ(res.PresentCount(), 67);
+  EXPECT_FALSE(res.present(3));
+  EXPECT_FALSE(res.present(5));
+  EXPECT_FALSE(res.present(65));
+  EXPECT_EQ(res[64], 1);
+  EXPECT_EQ(res[69], 1);
+  EXPECT_THAT(row_errors.row_ids(), ElementsAre(5, 65));
+  ASSERT_EQ(row_errors.errors().size(), 2);
+  EXPECT_THAT(row_errors.errors()[0].status,
+              StatusIs(absl::StatusCode::kInvalidArgument, "division by zero"));
+
+  // Errors unrelated to rows are still returned.
+  EXPECT_THAT(op(arr, CreateDenseArray<int>({1})),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // Without RowErrors the first error fails the whole operation.
+  auto strict_op = CreateDenseOpWithRowErrors<0>(fn, nullptr);
+  EXPECT_THAT(strict_op(arr, arr),
+              StatusIs(absl::StatusCode::kInvalidArgument, "division by zero"));
+}
+
 TEST(DenseOps, DenseArraysForEach) {
   using OB = ::arolla::OptionalValue<::arolla::Bytes>;
   DenseArray<float> af = CreateDenseArray<float>(
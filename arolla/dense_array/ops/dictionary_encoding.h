@@ -0,0 +1,142 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_DENSE_ARRAY_OPS_DICTIONARY_ENCODING_H_
+#define AROLLA_DENSE_ARRAY_OPS_DICTIONARY_ENCODING_H_
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "arolla/dense_array/bitmap.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/util/view_types.h"
+
+namespace arolla {
+
+// Dictionary-encoded representation of a DenseArray. Intended for arrays with
+// low cardinality, e.g. categorical string features (country, device, ...).
+//
+// Every distinct present value is stored in `dictionary` only once, and
+// `codes` contains the index of the corresponding `dictionary` element for
+// every row (or is missing if the row is missing). So rows are equal iff their
+// codes are equal, grouping can be done directly by codes, and pointwise
+// functions can be evaluated once per dictionary element (see
+// ApplyToDictionary). Note that for floating point types every NaN gets a
+// separate dictionary entry.
+template <typename T>
+struct DictionaryEncodedDenseArray {
+  // Distinct values. Missing elements are allowed, e.g. in the result of
+  // ApplyToDictionary.
+  DenseArray<T> dictionary;
+  DenseArray<int32_t> codes;
+
+  int64_t size() const { return codes.size(); }
+
+  // Decodes into a plain DenseArray. The result shares the characters
+  // buffer of the `dictionary` for Text and Bytes.
+  DenseArray<T> Decode(
+      RawBufferFactory* buf_factory = GetHeapBufferFactory()) const {
+    typename Buffer<T>::ReshuffleBuilder values_bldr(
+        size(), dictionary.values, std::nullopt, buf_factory);
+    if (dictionary.IsFull()) {
+      codes.ForEachPresent([&](int64_t id, int32_t code) {
+        values_bldr.CopyValue(id, code);
+      });
+      return {std::move(values_bldr).Build(), codes.bitmap,
+              codes.bitmap_bit_offset};
+    }
+    bitmap::RawBuilder bitmap_bldr(bitmap::BitmapSize(size()), buf_factory);
+    auto bitmap = bitmap_bldr.GetMutableSpan();
+    std::memset(bitmap.begin(), 0, bitmap.size() * sizeof(bitmap::Word));
+    codes.ForEachPresent([&](int64_t id, int32_t code) {
+      if (dictionary.present(code)) {
+        values_bldr.CopyValue(id, code);
+        bitmap::SetBit(bitmap.begin(), id);
+      }
+    });
+    return {std::move(values_bldr).Build(), std::move(bitmap_bldr).Build()};
+  }
+};
+
+// Creates dictionary-encoded representation of the `array`. The dictionary
+// elements are ordered by their first occurrence in the `array`.
+template <typename T>
+absl::StatusOr<DictionaryEncodedDenseArray<T>> DictionaryEncode(
+    const DenseArray<T>& array,
+    RawBufferFactory* buf_factory = GetHeapBufferFactory()) {
+  absl::flat_hash_map<view_type_t<T>, int32_t> index;
+  std::vector<view_type_t<T>> dictionary;
+  typename Buffer<int32_t>::Builder codes_bldr(array.size(), buf_factory);
+  auto* codes = codes_bldr.GetMutableSpan().begin();
+  bool overflow = false;
+  array.ForEach([&](int64_t id, bool present, view_type_t<T> value) {
+    if (!present) {
+      codes[id] = 0;
+      return;
+    }
+    auto [it, inserted] = index.try_emplace(value, dictionary.size());
+    if (inserted) {
+      if (dictionary.size() == std::numeric_limits<int32_t>::max()) {
+        overflow = true;
+      }
+      dictionary.push_back(value);
+    }
+    codes[id] = it->second;
+  });
+  if (overflow) {
+    return absl::InvalidArgumentError(
+        "too many distinct values for dictionary encoding");
+  }
+  // Values are copied, so the dictionary doesn't keep the original buffer
+  // alive.
+  typename Buffer<T>::Builder dict_bldr(dictionary.size(), buf_factory);
+  for (int64_t i = 0; i < dictionary.size(); ++i) {
+    dict_bldr.Set(i, dictionary[i]);
+  }
+  return DictionaryEncodedDenseArray<T>{
+      .dictionary = DenseArray<T>{std::move(dict_bldr).Build()},
+      .codes = DenseArray<int32_t>{std::move(codes_bldr).Build(), array.bitmap,
+                                   array.bitmap_bit_offset}};
+}
+
+// Evaluates `fn` once per dictionary element and returns the
+// dictionary-encoded result, sharing the codes with `array`. `fn` takes
+// view_type_t<T> and returns either ResT or OptionalValue<ResT>.
+//
+// Example (a set-of-values check evaluated once per distinct value):
+//   auto in_set = ApplyToDictionary<Unit>(encoded, [&](absl::string_view v) {
+//     return OptionalUnit(values.contains(v));
+//   });
+template <typename ResT, typename T, typename Fn>
+DictionaryEncodedDenseArray<ResT> ApplyToDictionary(
+    const DictionaryEncodedDenseArray<T>& array, Fn&& fn,
+    RawBufferFactory* buf_factory = GetHeapBufferFactory()) {
+  DenseArrayBuilder<ResT> bldr(array.dictionary.size(), buf_factory);
+  array.dictionary.ForEachPresent(
+      [&](int64_t id, view_type_t<T> value) { bldr.Set(id, fn(value)); });
+  return {.dictionary = std::move(bldr).Build(), .codes = array.codes};
+}
+
+}  // namespace arolla
+
+#endif  // AROLLA_DENSE_ARRAY_OPS_DICTIONARY_ENCODING_H_
@@ -0,0 +1,91 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/dense_array/ops/dictionary_encoding.h"
+
+#include <cstdint>
+#include <optional>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/text.h"
+#include "arolla/util/unit.h"
+
+namespace arolla {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(DictionaryEncodingTest, EncodeDecode) {
+  auto array = CreateDenseArray<Text>({Text("us"), Text("de"), std::nullopt,
+                                       Text("us"), Text(""), Text("de")});
+  ASSERT_OK_AND_ASSIGN(auto encoded, DictionaryEncode(array));
+  EXPECT_EQ(encoded.size(), 6);
+  EXPECT_THAT(encoded.dictionary,
+              ElementsAre(Text("us"), Text("de"), Text("")));
+  EXPECT_THAT(encoded.codes, ElementsAre(0, 1, std::nullopt, 0, 2, 1));
+
+  auto decoded = encoded.Decode();
+  EXPECT_THAT(decoded, ElementsAre(Text("us"), Text("de"), std::nullopt,
+                                   Text("us"), Text(""), Text("de")));
+  EXPECT_EQ(decoded.values.characters().begin(),
+            encoded.dictionary.values.characters().begin());
+}
+
+TEST(DictionaryEncodingTest, EncodeWithBitmapOffset) {
+  auto array =
+      CreateDenseArray<int64_t>({5, std::nullopt, 7, 5, std::nullopt, 7, 8})
+          .Slice(1, 5);
+  ASSERT_OK_AND_ASSIGN(auto encoded, DictionaryEncode(array));
+  EXPECT_THAT(encoded.dictionary, ElementsAre(7, 5));
+  EXPECT_THAT(encoded.codes, ElementsAre(std::nullopt, 0, 1, std::nullopt, 0));
+  EXPECT_THAT(encoded.Decode(),
+              ElementsAre(std::nullopt, 7, 5, std::nullopt, 7));
+}
+
+TEST(DictionaryEncodingTest, Empty) {
+  ASSERT_OK_AND_ASSIGN(auto encoded, DictionaryEncode(DenseArray<Bytes>()));
+  EXPECT_EQ(encoded.size(), 0);
+  EXPECT_EQ(encoded.dictionary.size(), 0);
+  EXPECT_EQ(encoded.Decode().size(), 0);
+}
+
+TEST(DictionaryEncodingTest, ApplyToDictionary) {
+  auto array = CreateDenseArray<Bytes>(
+      {Bytes("a"), Bytes("bb"), std::nullopt, Bytes("ccc"), Bytes("a")});
+  ASSERT_OK_AND_ASSIGN(auto encoded, DictionaryEncode(array));
+  absl::flat_hash_set<absl::string_view> values = {"a", "ccc"};
+  int calls = 0;
+  auto in_set = ApplyToDictionary<Unit>(encoded, [&](absl::string_view v) {
+    ++calls;
+    return OptionalUnit(values.contains(v));
+  });
+  EXPECT_EQ(calls, 3);
+  EXPECT_THAT(in_set.Decode(), ElementsAre(kUnit, std::nullopt, std::nullopt,
+                                           kUnit, kUnit));
+
+  auto lengths = ApplyToDictionary<int64_t>(encoded, [](absl::string_view v) {
+    return static_cast<int64_t>(v.size());
+  });
+  EXPECT_THAT(lengths.Decode(), ElementsAre(1, 2, std::nullopt, 3, 1));
+}
+
+}  // namespace
+}  // namespace arolla
@@ -20,9 +20,12 @@
 #include <type_traits>
 #include <utility>
 
+#include "absl/base/optimization.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "arolla/dense_array/bitmap.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/ops/util.h"
@@ -30,7 +33,10 @@
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/util/meta.h"
+#include "arolla/util/row_errors.h"
 #include "arolla/util/status_macros_backport.h"
+#include "arolla/util/unit.h"
+#include "arolla/util/view_types.h"
 
 namespace arolla::dense_ops_internal {
 
@@ -49,9 +55,12 @@ class UniversalDenseOp {
       meta::is_wrapped_with<absl::StatusOr, fn_return_t>::value;
   using fn_result_t = meta::strip_template_t<absl::StatusOr, fn_return_t>;
 
+  // If `row_errors` is not null, the rows where `fn` fails are recorded there
+  // and become missing in the result instead of failing the whole operation.
   explicit UniversalDenseOp(
-      PointwiseFn fn, RawBufferFactory* buffer_factory = GetHeapBufferFactory())
-      : fn_(fn), buffer_factory_(buffer_factory) {}
+      PointwiseFn fn, RawBufferFactory* buffer_factory = GetHeapBufferFactory(),
+      RowErrors* row_errors = nullptr)
+      : fn_(fn), buffer_factory_(buffer_factory), row_errors_(row_errors) {}
 
   template <class FirstT, class... Ts>
   std::conditional_t<kCheckStatus, absl::StatusOr<DenseArray<ResT>>,
@@ -60,6 +69,11 @@ class UniversalDenseOp {
              const DenseArray<Ts>&... args) const {
     uint64_t size = first_arg.size();
     DCHECK((args.size() == size) && ...);
+    if constexpr (CanUseFullPresenceLoop<FirstT, Ts...>()) {
+      if (first_arg.bitmap.empty() && (args.bitmap.empty() && ...)) {
+        return EvalAllPresent(size, first_arg, args...);
+      }
+    }
     typename Buffer<ResT>::Builder values_builder(size, buffer_factory_);
     bitmap::Bitmap::Builder bitmap_builder(bitmap::BitmapSize(size),
                                            buffer_factory_);
@@ -108,6 +122,41 @@ class UniversalDenseOp {
  private:
   using Util = DenseOpsUtil<fn_args, !NoBitmapOffset>;
 
+  template <class T>
+  static constexpr bool IsSpanCompatible() {
+    return !std::is_same_v<view_type_t<T>, absl::string_view> &&
+           !std::is_same_v<T, Unit>;
+  }
+
+  // Returns true if all-present inputs can be processed by a contiguous loop
+  // over the value spans.
+  template <class... Ts>
+  static constexpr bool CanUseFullPresenceLoop() {
+    return !kCheckStatus &&
+           !meta::is_wrapped_with_v<OptionalValue, fn_result_t> &&
+           IsSpanCompatible<ResT>() && (IsSpanCompatible<Ts>() && ...);
+  }
+
+  // Evaluates the op when no argument has a bitmap, so there is no presence
+  // to check and the loop body is straight-line code the compiler can
+  // vectorize. Optional arguments are passed as present.
+  template <class... Ts>
+  DenseArray<ResT> EvalAllPresent(int64_t size,
+                                  const DenseArray<Ts>&... args) const {
+    typename Buffer<ResT>::Builder values_builder(size, buffer_factory_);
+    EvalSpans(values_builder.GetMutableSpan(), fn_args(),
+              args.values.span()...);
+    return DenseArray<ResT>{std::move(values_builder).Build()};
+  }
+
+  template <class... FnArgs, class... Ts>
+  void EvalSpans(absl::Span<ResT> res, meta::type_list<FnArgs...>,
+                 absl::Span<const Ts>... args) const {
+    for (int64_t i = 0; i < res.size(); ++i) {
+      res[i] = fn_(FnArgs(args[i])...);
+    }
+  }
+
   template <class Getters, size_t... Is>
   fn_return_t EvalSingle(int64_t i, const Getters& getters,
                          std::index_sequence<Is...>) const {
@@ -134,7 +183,18 @@ class UniversalDenseOp {
       }
       fn_result_t res;
       if constexpr (kCheckStatus) {
-        ASSIGN_OR_RETURN(res, fn(i));
+        fn_return_t res_or = fn(i);
+        if (ABSL_PREDICT_FALSE(!res_or.ok())) {
+          if (row_errors_ == nullptr) {
+            return std::move(res_or).status();
+          }
+          row_errors_->Add(group * bitmap::kWordBitCount + i,
+                           std::move(res_or).status());
+          mask &= ~bit;
+          inserter.SkipN(1);
+          continue;
+        }
+        res = *std::move(res_or);
       } else {
         res = fn(i);
       }
@@ -150,6 +210,7 @@ class UniversalDenseOp {
 
   PointwiseFn fn_;
   RawBufferFactory* buffer_factory_;
+  RowErrors* row_errors_;  // Not owned, can be nullptr.
 };
 
 }  // namespace arolla::dense_ops_internal
@@ -14,14 +14,17 @@
 //
 #include "arolla/dense_array/qtype/copier.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
@@ -36,6 +39,7 @@ namespace arolla::testing {
 namespace {
 
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::HasSubstr;
 
 TEST(DenseArray2FramesCopier, ArraySizeValidation) {
@@ -231,5 +235,62 @@ TEST(Frames2DenseArrayCopier, Iterate) {
               ElementsAre(3.2, 2.2, 0.0, 1.2));
 }
 
+TEST(DenseArrayCopier, RoundTripSeveralBatches) {
+  // Rows copied in several batches; the last one is incomplete.
+  constexpr int64_t kSize = 1297;
+  std::vector<OptionalValue<int64_t>> values1(kSize);
+  std::vector<OptionalValue<int64_t>> values2(kSize);
+  for (int64_t i = 0; i < kSize; ++i) {
+    if (i % 3 != 0) values1[i] = i;
+    values2[i] = i * 2;
+  }
+  DenseArray<int64_t> arr1 = CreateDenseArray<int64_t>(values1);
+  DenseArray<int64_t> arr2 = CreateDenseArray<int64_t>(values2);
+
+  FrameLayout::Builder scalars_bldr;
+  auto scalar_slot1 = scalars_bldr.AddSlot<OptionalValue<int64_t>>();
+  auto scalar_slot2 = scalars_bldr.AddSlot<int64_t>();
+  auto scalar_layout = std::move(scalars_bldr).Build();
+
+  FrameLayout::Builder arrays_bldr;
+  auto array_slot1 = arrays_bldr.AddSlot<DenseArray<int64_t>>();
+  auto array_slot2 = arrays_bldr.AddSlot<DenseArray<int64_t>>();
+  auto arrays_layout = std::move(arrays_bldr).Build();
+
+  DenseArray2FramesCopier<int64_t> to_frames;
+  EXPECT_OK(to_frames.AddMapping(TypedRef::FromValue(arr1),
+                                 TypedSlot::FromSlot(scalar_slot1)));
+  EXPECT_OK(to_frames.AddMapping(TypedRef::FromValue(arr2),
+                                 TypedSlot::FromSlot(scalar_slot2)));
+  to_frames.Start();
+  Frames2DenseArrayCopier<int64_t> from_frames;
+  EXPECT_OK(from_frames.AddMapping(TypedSlot::FromSlot(scalar_slot1),
+                                   TypedSlot::FromSlot(array_slot1)));
+  EXPECT_OK(from_frames.AddMapping(TypedSlot::FromSlot(scalar_slot2),
+                                   TypedSlot::FromSlot(array_slot2)));
+  from_frames.Start(kSize);
+
+  constexpr int64_t kBatchSize = 251;
+  std::vector<MemoryAllocation> allocs;
+  allocs.reserve(kBatchSize);
+  std::vector<FramePtr> frames;
+  std::vector<ConstFramePtr> const_frames;
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    frames.push_back(allocs.emplace_back(&scalar_layout).frame());
+    const_frames.push_back(frames.back());
+  }
+  for (int64_t offset = 0; offset < kSize; offset += kBatchSize) {
+    int64_t count = std::min(kBatchSize, kSize - offset);
+    to_frames.CopyNextBatch(absl::MakeSpan(frames).subspan(0, count));
+    EXPECT_OK(from_frames.CopyNextBatch(
+        absl::MakeConstSpan(const_frames).subspan(0, count)));
+  }
+  MemoryAllocation arrays_ctx(&arrays_layout);
+  EXPECT_OK(from_frames.Finalize(arrays_ctx.frame()));
+
+  EXPECT_THAT(arrays_ctx.frame().Get(array_slot1), ElementsAreArray(values1));
+  EXPECT_THAT(arrays_ctx.frame().Get(array_slot2), ElementsAreArray(values2));
+}
+
 }  // namespace
 }  // namespace arolla::testing
@@ -43,6 +43,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_ref.h"
+#include "arolla/qtype/typed_value.h"
 #include "arolla/util/repr.h"
 #include "arolla/util/unit.h"
 #include "arolla/util/status_macros_backport.h"
@@ -91,6 +92,12 @@ class DenseArrayQType : public DenseArrayQTypeBase {
     return v.size();
   }
 
+  absl::StatusOr<TypedValue> CopyToBufferFactory(
+      TypedRef value, RawBufferFactory* buffer_factory) const final {
+    ASSIGN_OR_RETURN(const DenseArray<T>& v, value.As<DenseArray<T>>());
+    return TypedValue::FromValue(v.MakeUnowned().MakeOwned(buffer_factory));
+  }
+
  private:
   using DenseArrayQTypeBase::DenseArrayQTypeBase;
   friend struct QTypeTraits<DenseArray<T>>;
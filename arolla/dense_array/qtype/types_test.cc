@@ -141,6 +141,17 @@ TEST(DenseArrayTypesTest, ArraySize) {
               IsOkAndHolds(Eq(5)));
 }
 
+TEST(DenseArrayTypesTest, EstimateMemoryUsage) {
+  auto array = CreateDenseArray<int64_t>({1, std::nullopt, 4, 3, 5});
+  EXPECT_EQ(TypedRef::FromValue(array).EstimateMemoryUsage(),
+            sizeof(DenseArray<int64_t>) + array.memory_usage());
+  auto weak_float_array = CreateDenseArray<double>({1, 2});
+  EXPECT_EQ(TypedRef::UnsafeFromRawPointer(GetDenseArrayWeakFloatQType(),
+                                           &weak_float_array)
+                .EstimateMemoryUsage(),
+            sizeof(DenseArray<double>) + weak_float_array.memory_usage());
+}
+
 TEST(DenseArrayTypesTest, ValueToDenseArrayConversion) {
   QTypePtr value_type = GetQType<float>();
   QTypePtr array_qtype = GetDenseArrayQType<float>();
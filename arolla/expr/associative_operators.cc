@@ -0,0 +1,81 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/associative_operators.h"
+
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "arolla/expr/expr_operator.h"
+#include "arolla/expr/registered_expr_operator.h"
+#include "arolla/util/indestructible.h"
+
+namespace arolla::expr {
+namespace {
+
+class AssociativeOperatorRegistry {
+ public:
+  static AssociativeOperatorRegistry& instance() {
+    static Indestructible<AssociativeOperatorRegistry> result;
+    return *result;
+  }
+
+  AssociativeOperatorRegistry()
+      : names_({"math.add", "math.multiply", "math.maximum", "math.minimum",
+                "core.presence_or", "bool.logical_and", "bool.logical_or"}) {}
+
+  void Register(absl::string_view name) {
+    absl::MutexLock lock(&mutex_);
+    names_.emplace(name);
+  }
+
+  bool Contains(absl::string_view name) const {
+    absl::MutexLock lock(&mutex_);
+    return names_.contains(name);
+  }
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_set<std::string> names_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+void RegisterAssociativeOperator(absl::string_view name) {
+  AssociativeOperatorRegistry::instance().Register(name);
+}
+
+bool IsAssociativeOperator(const ExprOperatorPtr& op) {
+  const auto& registry = AssociativeOperatorRegistry::instance();
+  ExprOperatorPtr current = op;
+  // Follow the aliases, e.g. a registered alias of math.add.
+  while (IsRegisteredOperator(current)) {
+    if (registry.Contains(current->display_name())) {
+      return true;
+    }
+    auto impl = static_cast<const RegisteredOperator&>(*current)
+                    .GetImplementation();
+    if (!impl.ok()) {
+      return false;
+    }
+    current = *std::move(impl);
+  }
+  return false;
+}
+
+}  // namespace arolla::expr
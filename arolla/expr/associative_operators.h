@@ -0,0 +1,40 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_ASSOCIATIVE_OPERATORS_H_
+#define AROLLA_EXPR_ASSOCIATIVE_OPERATORS_H_
+
+#include "absl/strings/string_view.h"
+#include "arolla/expr/expr_operator.h"
+
+namespace arolla::expr {
+
+// Marks the registered operator `name` as associative for the arguments of the
+// same type, i.e. op(op(x, y), z) == op(x, op(y, z)). The compiler may
+// evaluate a chain of such operators in a different order, e.g. reduce blocks
+// of a sequence in parallel (see seq.reduce). For floating point arguments the
+// results of the reordered evaluation can differ within the rounding error.
+//
+// The operator does not need to be registered yet. Standard operators that are
+// associative (math.add, math.multiply, math.maximum, math.minimum,
+// core.presence_or, bool.logical_and, bool.logical_or) are marked by default.
+void RegisterAssociativeOperator(absl::string_view name);
+
+// Returns true if `op` is a registered operator (or an alias of one) marked by
+// RegisterAssociativeOperator().
+bool IsAssociativeOperator(const ExprOperatorPtr& /*nullable*/ op);
+
+}  // namespace arolla::expr
+
+#endif  // AROLLA_EXPR_ASSOCIATIVE_OPERATORS_H_
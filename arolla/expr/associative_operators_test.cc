@@ -0,0 +1,69 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/associative_operators.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "arolla/expr/expr_operator.h"
+#include "arolla/expr/expr_operator_signature.h"
+#include "arolla/expr/registered_expr_operator.h"
+#include "arolla/expr/testing/test_operators.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla::expr {
+namespace {
+
+using ::arolla::expr::testing::DummyOp;
+
+class AssociativeOperatorsTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_OK(InitArolla()); }
+};
+
+TEST_F(AssociativeOperatorsTest, IsAssociativeOperator) {
+  auto dummy_op = std::make_shared<DummyOp>(
+      "dummy_op", ExprOperatorSignature::MakeArgsN(2));
+  ASSERT_OK_AND_ASSIGN(auto op,
+                       RegisterOperator("test.associative_op", dummy_op));
+  ASSERT_OK_AND_ASSIGN(
+      auto alias, RegisterOperatorAlias("test.associative_op_alias",
+                                        "test.associative_op"));
+  ASSERT_OK_AND_ASSIGN(auto other_op,
+                       RegisterOperator("test.non_associative_op", dummy_op));
+  EXPECT_FALSE(IsAssociativeOperator(op));
+  EXPECT_FALSE(IsAssociativeOperator(alias));
+
+  RegisterAssociativeOperator("test.associative_op");
+  EXPECT_TRUE(IsAssociativeOperator(op));
+  EXPECT_TRUE(IsAssociativeOperator(alias));
+  EXPECT_FALSE(IsAssociativeOperator(other_op));
+  // Only the registered operators are annotated.
+  EXPECT_FALSE(IsAssociativeOperator(dummy_op));
+  EXPECT_FALSE(IsAssociativeOperator(nullptr));
+}
+
+TEST_F(AssociativeOperatorsTest, StandardOperators) {
+  EXPECT_TRUE(IsAssociativeOperator(
+      std::make_shared<RegisteredOperator>("math.add")));
+  EXPECT_TRUE(IsAssociativeOperator(
+      std::make_shared<RegisteredOperator>("core.presence_or")));
+  EXPECT_FALSE(IsAssociativeOperator(
+      std::make_shared<RegisteredOperator>("math.subtract")));
+}
+
+}  // namespace
+}  // namespace arolla::expr
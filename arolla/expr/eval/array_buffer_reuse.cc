@@ -0,0 +1,205 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/array_buffer_reuse.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/check.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/indestructible.h"
+
+namespace arolla::expr::eval_internal {
+namespace {
+
+// Backend operators that compute the i-th output value from the i-th values
+// of the arguments, and allocate the output values before any other buffer.
+bool IsArgBufferReusingOperator(absl::string_view name) {
+  static const Indestructible<absl::flat_hash_set<absl::string_view>> kOps({
+      "core._to_float32", "core._to_int32",   "core._to_int64",
+      "core._to_uint64",  "core.to_float64",  "math._pow",
+      "math.abs",         "math.add",         "math.ceil",
+      "math.divide",      "math.exp",         "math.floor",
+      "math.fmod",        "math.log",         "math.log_sigmoid",
+      "math.logit",       "math.maximum",     "math.minimum",
+      "math.multiply",    "math.neg",         "math.round",
+      "math.sigmoid",     "math.sign",        "math.subtract",
+  });
+  return kOps->contains(name);
+}
+
+// Returns the value qtype if `qtype` is a DenseArray with trivially copyable
+// numeric values, or nullptr otherwise.
+QTypePtr GetReusableValueQType(QTypePtr qtype) {
+  if (!IsDenseArrayQType(qtype)) {
+    return nullptr;
+  }
+  QTypePtr value_qtype = qtype->value_qtype();
+  if (value_qtype == GetQType<float>() || value_qtype == GetQType<double>() ||
+      value_qtype == GetQType<int32_t>() ||
+      value_qtype == GetQType<int64_t>() ||
+      value_qtype == GetQType<uint64_t>()) {
+    return value_qtype;
+  }
+  return nullptr;
+}
+
+// Hands out the donated buffer for the first allocation of exactly its size,
+// and forwards the other requests to the base factory. The pointwise kernels
+// allocate the output values first, and a bitmap is never of the same size as
+// the values of an array with two or more rows.
+class DonatedBufferFactory final : public RawBufferFactory {
+ public:
+  DonatedBufferFactory(RawBufferFactory& base, RawBufferPtr buffer, void* data,
+                       size_t nbytes)
+      : base_(base), buffer_(std::move(buffer)), data_(data), nbytes_(nbytes) {}
+
+  std::tuple<RawBufferPtr, void*> CreateRawBuffer(size_t nbytes) final {
+    if (buffer_ != nullptr && nbytes == nbytes_) {
+      return {std::move(buffer_), data_};
+    }
+    return base_.CreateRawBuffer(nbytes);
+  }
+
+  std::tuple<RawBufferPtr, void*> ReallocRawBuffer(RawBufferPtr&& old_buffer,
+                                                   void* old_data,
+                                                   size_t old_size,
+                                                   size_t new_size) final {
+    if (old_data != data_) {
+      return base_.ReallocRawBuffer(std::move(old_buffer), old_data, old_size,
+                                    new_size);
+    }
+    // The donated buffer may be allocated by another factory, so we cannot
+    // reallocate it in place.
+    auto [new_buffer, new_data] = base_.CreateRawBuffer(new_size);
+    std::memcpy(new_data, old_data, std::min(old_size, new_size));
+    return {std::move(new_buffer), new_data};
+  }
+
+ private:
+  RawBufferFactory& base_;
+  RawBufferPtr buffer_;
+  void* data_;
+  size_t nbytes_;
+};
+
+template <typename T>
+class ArgBufferReusingOperator final : public BoundOperator {
+ public:
+  ArgBufferReusingOperator(std::unique_ptr<BoundOperator> op,
+                           FrameLayout::Slot<DenseArray<T>> arg_slot)
+      : op_(std::move(op)), arg_slot_(arg_slot) {}
+
+  void Run(EvaluationContext* ctx, FramePtr frame) const final {
+    DenseArray<T>& arg = *frame.GetMutable(arg_slot_);
+    const Buffer<T>& values = arg.values;
+    if (values.size() < 2 || !values.is_uniquely_owned()) {
+      op_->Run(ctx, frame);
+    } else {
+      DonatedBufferFactory buffer_factory(
+          ctx->buffer_factory(), values.raw_buffer(),
+          const_cast<T*>(values.span().data()), values.size() * sizeof(T));
+      EvaluationContext op_ctx(*ctx, &buffer_factory);
+      op_->Run(&op_ctx, frame);
+      if (!op_ctx.status().ok()) {
+        ctx->set_status(std::move(op_ctx).status());
+      }
+    }
+    // The argument is dead, and resetting it leaves the output as the only
+    // owner of the buffer, so the next operator in a chain can reuse it too.
+    arg = DenseArray<T>();
+  }
+
+  int64_t EstimateMemoryUsage() const final {
+    return op_->EstimateMemoryUsage();
+  }
+
+ private:
+  std::unique_ptr<BoundOperator> op_;
+  FrameLayout::Slot<DenseArray<T>> arg_slot_;
+};
+
+template <typename T>
+std::unique_ptr<BoundOperator> MakeArgBufferReusingOperatorImpl(
+    std::unique_ptr<BoundOperator> op, TypedSlot arg_slot) {
+  return std::make_unique<ArgBufferReusingOperator<T>>(
+      std::move(op), arg_slot.UnsafeToSlot<DenseArray<T>>());
+}
+
+}  // namespace
+
+bool CanReuseArgBuffer(absl::string_view op_name, QTypePtr arg_qtype,
+                       QTypePtr output_qtype) {
+  if (!IsArgBufferReusingOperator(op_name)) {
+    return false;
+  }
+  QTypePtr arg_value_qtype = GetReusableValueQType(arg_qtype);
+  QTypePtr output_value_qtype = GetReusableValueQType(output_qtype);
+  return arg_value_qtype != nullptr && output_value_qtype != nullptr &&
+         arg_value_qtype->type_layout().AllocSize() ==
+             output_value_qtype->type_layout().AllocSize();
+}
+
+bool ReturnsFreshArrayBuffer(absl::string_view op_name,
+                             absl::Span<const QTypePtr> arg_qtypes,
+                             QTypePtr output_qtype) {
+  if (!IsArgBufferReusingOperator(op_name) ||
+      GetReusableValueQType(output_qtype) == nullptr) {
+    return false;
+  }
+  // A cast to the argument type may return the argument as is.
+  for (QTypePtr arg_qtype : arg_qtypes) {
+    if (arg_qtype == output_qtype && absl::StartsWith(op_name, "core.")) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<BoundOperator> MakeArgBufferReusingOperator(
+    std::unique_ptr<BoundOperator> op, TypedSlot arg_slot) {
+  QTypePtr value_qtype = GetReusableValueQType(arg_slot.GetType());
+  if (value_qtype == GetQType<float>()) {
+    return MakeArgBufferReusingOperatorImpl<float>(std::move(op), arg_slot);
+  } else if (value_qtype == GetQType<double>()) {
+    return MakeArgBufferReusingOperatorImpl<double>(std::move(op), arg_slot);
+  } else if (value_qtype == GetQType<int32_t>()) {
+    return MakeArgBufferReusingOperatorImpl<int32_t>(std::move(op), arg_slot);
+  } else if (value_qtype == GetQType<int64_t>()) {
+    return MakeArgBufferReusingOperatorImpl<int64_t>(std::move(op), arg_slot);
+  }
+  DCHECK(value_qtype == GetQType<uint64_t>());
+  return MakeArgBufferReusingOperatorImpl<uint64_t>(std::move(op), arg_slot);
+}
+
+}  // namespace arolla::expr::eval_internal
@@ -0,0 +1,60 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_ARRAY_BUFFER_REUSE_H_
+#define AROLLA_EXPR_EVAL_ARRAY_BUFFER_REUSE_H_
+
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_slot.h"
+
+namespace arolla::expr::eval_internal {
+
+// Returns true if the backend operator `op_name` returning `output_qtype` can
+// write its result into the values buffer of its argument of `arg_qtype`
+// (see MakeArgBufferReusingOperator).
+//
+// It is the case for the operators that compute the i-th output value from
+// the i-th input values only (arithmetic, casts and math functions) on
+// DenseArrays with the values of the same size.
+bool CanReuseArgBuffer(absl::string_view op_name, QTypePtr arg_qtype,
+                       QTypePtr output_qtype);
+
+// Returns true if the backend operator `op_name` always returns a DenseArray
+// with the values in a buffer allocated by the RawBufferFactory of the
+// evaluation context (or donated by MakeArgBufferReusingOperator from such an
+// array), so its result can be reused by MakeArgBufferReusingOperator.
+//
+// The other arrays must not be reused, even if uniquely owned: e.g. the input
+// arrays can wrap read-only mmap-ed memory, or memory shared with numpy.
+bool ReturnsFreshArrayBuffer(absl::string_view op_name,
+                             absl::Span<const QTypePtr> arg_qtypes,
+                             QTypePtr output_qtype);
+
+// Wraps the bound operator `op`, so that it writes the output values into the
+// values buffer of the DenseArray in `arg_slot` if no other array shares that
+// buffer. The argument must not be read after `op`: it is reset to an empty
+// array after the evaluation. Requires CanReuseArgBuffer(...) to be true for
+// the operator and the arg_slot type, and the argument to be computed by an
+// operator with ReturnsFreshArrayBuffer(...).
+std::unique_ptr<BoundOperator> MakeArgBufferReusingOperator(
+    std::unique_ptr<BoundOperator> op, TypedSlot arg_slot);
+
+}  // namespace arolla::expr::eval_internal
+
+#endif  // AROLLA_EXPR_EVAL_ARRAY_BUFFER_REUSE_H_
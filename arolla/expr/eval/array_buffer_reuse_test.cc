@@ -0,0 +1,165 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/array_buffer_reuse.h"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/ops/dense_ops.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qexpr/bound_operators.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/cancellation_context.h"
+#include "arolla/util/row_errors.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::expr::eval_internal {
+namespace {
+
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsEmpty;
+using ::testing::Ne;
+
+TEST(ArrayBufferReuseTest, CanReuseArgBuffer) {
+  EXPECT_TRUE(CanReuseArgBuffer("math.add", GetDenseArrayQType<float>(),
+                                GetDenseArrayQType<float>()));
+  EXPECT_TRUE(CanReuseArgBuffer("core._to_int32", GetDenseArrayQType<float>(),
+                                GetDenseArrayQType<int32_t>()));
+  EXPECT_FALSE(CanReuseArgBuffer("core.to_float64", GetDenseArrayQType<float>(),
+                                 GetDenseArrayQType<double>()));
+  EXPECT_FALSE(CanReuseArgBuffer("core.presence_or",
+                                 GetDenseArrayQType<float>(),
+                                 GetDenseArrayQType<float>()));
+  EXPECT_FALSE(CanReuseArgBuffer("math.add", GetQType<float>(),
+                                 GetQType<float>()));
+  EXPECT_FALSE(CanReuseArgBuffer("math.add", GetDenseArrayQType<Bytes>(),
+                                 GetDenseArrayQType<Bytes>()));
+}
+
+TEST(ArrayBufferReuseTest, ReturnsFreshArrayBuffer) {
+  EXPECT_TRUE(ReturnsFreshArrayBuffer(
+      "math.add", {GetDenseArrayQType<float>(), GetDenseArrayQType<float>()},
+      GetDenseArrayQType<float>()));
+  EXPECT_TRUE(ReturnsFreshArrayBuffer("core._to_int32",
+                                      {GetDenseArrayQType<float>()},
+                                      GetDenseArrayQType<int32_t>()));
+  EXPECT_FALSE(ReturnsFreshArrayBuffer("core._to_int32",
+                                       {GetDenseArrayQType<int32_t>()},
+                                       GetDenseArrayQType<int32_t>()));
+  EXPECT_FALSE(ReturnsFreshArrayBuffer("core.presence_or",
+                                       {GetDenseArrayQType<float>(),
+                                        GetDenseArrayQType<float>()},
+                                       GetDenseArrayQType<float>()));
+  EXPECT_FALSE(ReturnsFreshArrayBuffer(
+      "math.add", {GetQType<float>(), GetQType<float>()}, GetQType<float>()));
+}
+
+TEST(ArrayBufferReuseTest, MakeArgBufferReusingOperator) {
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto y_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto result_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto op = MakeArgBufferReusingOperator(
+      MakeBoundOperator([=](EvaluationContext* ctx, FramePtr frame) {
+        auto add = CreateDenseOp([](float x, float y) { return x + y; },
+                                 &ctx->buffer_factory());
+        ASSIGN_OR_RETURN(auto result,
+                         add(frame.Get(x_slot), frame.Get(y_slot)),
+                         ctx->set_status(std::move(_)));
+        frame.Set(result_slot, std::move(result));
+      }),
+      TypedSlot::FromSlot(x_slot));
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  EvaluationContext ctx;
+
+  frame.Set(x_slot, CreateDenseArray<float>({1.0f, std::nullopt, 3.0f}));
+  frame.Set(y_slot, CreateDenseArray<float>({10.0f, 20.0f, 30.0f}));
+  const float* x_data = frame.Get(x_slot).values.span().data();
+  op->Run(&ctx, frame);
+  ASSERT_OK(ctx.status());
+  EXPECT_THAT(frame.Get(result_slot),
+              ElementsAre(11.0f, std::nullopt, 33.0f));
+  EXPECT_THAT(frame.Get(result_slot).values.span().data(), Eq(x_data));
+  EXPECT_TRUE(frame.Get(result_slot).values.is_uniquely_owned());
+  EXPECT_THAT(frame.Get(x_slot), IsEmpty());
+
+  // The buffer is shared with another array, so it is not modified.
+  auto x = CreateDenseArray<float>({1.0f, 2.0f, 3.0f});
+  frame.Set(x_slot, x);
+  op->Run(&ctx, frame);
+  ASSERT_OK(ctx.status());
+  EXPECT_THAT(frame.Get(result_slot), ElementsAre(11.0f, 22.0f, 33.0f));
+  EXPECT_THAT(frame.Get(result_slot).values.span().data(),
+              Ne(x.values.span().data()));
+  EXPECT_THAT(x, ElementsAre(1.0f, 2.0f, 3.0f));
+  EXPECT_THAT(frame.Get(x_slot), IsEmpty());
+}
+
+TEST(ArrayBufferReuseTest, ErrorIsPropagated) {
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto op = MakeArgBufferReusingOperator(
+      MakeBoundOperator([](EvaluationContext* ctx, FramePtr) {
+        ctx->set_status(absl::InvalidArgumentError("fail"));
+      }),
+      TypedSlot::FromSlot(x_slot));
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  alloc.frame().Set(x_slot, CreateDenseArray<float>({1.0f, 2.0f}));
+  EvaluationContext ctx;
+  op->Run(&ctx, alloc.frame());
+  EXPECT_THAT(ctx.status(),
+              StatusIs(absl::StatusCode::kInvalidArgument, "fail"));
+}
+
+TEST(ArrayBufferReuseTest, ContextIsDerived) {
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<DenseArray<float>>();
+  CancellationContext cancellation_context;
+  RowErrors row_errors;
+  auto op = MakeArgBufferReusingOperator(
+      MakeBoundOperator([&](EvaluationContext* ctx, FramePtr) {
+        EXPECT_THAT(ctx->cancellation_context(), Eq(&cancellation_context));
+        EXPECT_THAT(ctx->row_errors(), Eq(&row_errors));
+        ctx->row_errors()->Add(1, absl::InvalidArgumentError("fail"));
+      }),
+      TypedSlot::FromSlot(x_slot));
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  alloc.frame().Set(x_slot, CreateDenseArray<float>({1.0f, 2.0f}));
+  EvaluationContext ctx(GetHeapBufferFactory(), &cancellation_context);
+  ctx.set_row_errors(&row_errors);
+  op->Run(&ctx, alloc.frame());
+  ASSERT_OK(ctx.status());
+  EXPECT_THAT(row_errors.row_ids(), ElementsAre(1));
+}
+
+}  // namespace
+}  // namespace arolla::expr::eval_internal
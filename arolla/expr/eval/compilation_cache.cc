@@ -0,0 +1,138 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/compilation_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/qexpr/evaluation_engine.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::expr {
+namespace {
+
+Fingerprint ComputeCacheKey(
+    const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
+    const absl::flat_hash_map<std::string, QTypePtr>& input_types) {
+  std::vector<std::pair<absl::string_view, QTypePtr>> sorted_input_types(
+      input_types.begin(), input_types.end());
+  std::sort(sorted_input_types.begin(), sorted_input_types.end());
+  FingerprintHasher hasher("arolla::expr::CompilationCache");
+  hasher.Combine(expr->fingerprint(), sorted_input_types.size());
+  for (const auto& [name, qtype] : sorted_input_types) {
+    hasher.Combine(name, qtype);
+  }
+  hasher.Combine(options.enabled_preparation_stages,
+                 options.collect_op_descriptions, options.enable_profiling,
+                 options.profile_perf_counters,
+                 reinterpret_cast<uintptr_t>(options.trace_sink),
+                 options.trace_sampling_period,
+                 options.enable_pointwise_fusion,
+                 options.enable_array_lifted_core_map,
+                 options.enable_array_lifted_pointwise_core_map,
+                 options.enable_array_where_short_circuit,
+                 options.allow_overriding_input_slots,
+                 options.release_dead_array_buffers,
+                 options.reuse_dead_array_buffers,
+                 options.fuse_scalar_operator_pairs,
+                 options.enable_group_op_fusion,
+                 options.enable_scalar_broadcast_elimination,
+                 options.enable_expr_stack_trace,
+                 reinterpret_cast<uintptr_t>(options.operator_directory),
+                 reinterpret_cast<uintptr_t>(options.literal_buffer_factory),
+                 reinterpret_cast<uintptr_t>(options.literal_interner),
+                 reinterpret_cast<uintptr_t>(options.eval_threading),
+                 options.min_parallel_eval_ops,
+                 reinterpret_cast<uintptr_t>(options.core_map_threading),
+                 options.min_parallel_core_map_rows,
+                 reinterpret_cast<uintptr_t>(options.seq_reduce_threading),
+                 options.min_parallel_seq_reduce_size);
+  // The parameters are copied during the compilation, so the models compiled
+  // with equal cost models are interchangeable.
+  if (options.cost_model != nullptr) {
+    hasher.Combine(options.cost_model->optimal_splits_per_evaluator,
+                   options.cost_model->min_rows_per_thread,
+                   options.cost_model->frame_buffer_count);
+  }
+  return std::move(hasher).Finish();
+}
+
+}  // namespace
+
+CompilationCache::CompilationCache(size_t capacity) : cache_(capacity) {}
+
+CompilationCache& CompilationCache::GetInstance() {
+  static Indestructible<CompilationCache> instance;
+  return *instance;
+}
+
+absl::StatusOr<std::shared_ptr<const CompiledExpr>> CompilationCache::Compile(
+    const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
+    const absl::flat_hash_map<std::string, QTypePtr>& input_types) {
+  // The literal buffer factory must only outlive the compilation, so its
+  // address may be reused by a different factory (e.g. one allocating on
+  // another NUMA node) and cannot identify the compiled literals.
+  if (options.optimizer.has_value() ||
+      options.literal_buffer_factory != nullptr) {
+    ASSIGN_OR_RETURN(auto compiled_expr,
+                     CompileForDynamicEvaluation(options, expr, input_types));
+    return std::shared_ptr<const CompiledExpr>(std::move(compiled_expr));
+  }
+  const Fingerprint key = ComputeCacheKey(options, expr, input_types);
+  {
+    absl::MutexLock lock(&mutex_);
+    if (const auto* compiled_expr = cache_.LookupOrNull(key)) {
+      ++stats_.hits;
+      return *compiled_expr;
+    }
+    ++stats_.misses;
+  }
+  // The lock is not held during the compilation, because it can be reentrant
+  // (e.g. literal folding uses expr::Invoke). Concurrent misses on the same key
+  // may compile the expression several times, only the first result is kept.
+  ASSIGN_OR_RETURN(auto compiled_expr,
+                   CompileForDynamicEvaluation(options, expr, input_types));
+  absl::MutexLock lock(&mutex_);
+  return *cache_.Put(key,
+                     std::shared_ptr<const CompiledExpr>(
+                         std::move(compiled_expr)));
+}
+
+CompilationCache::Stats CompilationCache::GetStats() const {
+  absl::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+void CompilationCache::Clear() {
+  absl::MutexLock lock(&mutex_);
+  cache_.Clear();
+  stats_ = Stats();
+}
+
+}  // namespace arolla::expr
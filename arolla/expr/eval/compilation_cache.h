@@ -0,0 +1,83 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_COMPILATION_CACHE_H_
+#define AROLLA_EXPR_EVAL_COMPILATION_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/qexpr/evaluation_engine.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/lru_cache.h"
+
+namespace arolla::expr {
+
+// A thread-safe bounded cache of expressions compiled for dynamic evaluation.
+//
+// The entries are keyed by the expression fingerprint, the input types and the
+// DynamicEvaluationEngineOptions. Options with a custom `optimizer` or a
+// `literal_buffer_factory` cannot be fingerprinted, so such compilations bypass
+// the cache.
+//
+// NOTE: The cache assumes that the compilation result depends only on the key.
+// Changes in the global state (e.g. registering compiler extensions) are not
+// reflected in the already cached entries, use Clear() if needed.
+class CompilationCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 1024;
+
+  struct Stats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+  };
+
+  // Constructs a cache keeping up to `capacity` compiled expressions.
+  explicit CompilationCache(size_t capacity = kDefaultCapacity);
+
+  // Process-wide cache, used by expr::Invoke.
+  static CompilationCache& GetInstance();
+
+  // Same as CompileForDynamicEvaluation, but reuses the previously compiled
+  // expression if possible. Errors are not cached.
+  absl::StatusOr<std::shared_ptr<const CompiledExpr>> Compile(
+      const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
+      const absl::flat_hash_map<std::string, QTypePtr>& input_types = {});
+
+  // Returns the number of cache hits and misses since construction or the last
+  // Clear() call. Compilations that bypass the cache are not counted.
+  Stats GetStats() const;
+
+  // Removes all the entries and resets the stats.
+  void Clear();
+
+ private:
+  mutable absl::Mutex mutex_;
+  LruCache<Fingerprint, std::shared_ptr<const CompiledExpr>> cache_
+      ABSL_GUARDED_BY(mutex_);
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace arolla::expr
+
+#endif  // AROLLA_EXPR_EVAL_COMPILATION_CACHE_H_
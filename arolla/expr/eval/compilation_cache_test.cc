@@ -0,0 +1,188 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/compilation_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/optimization/optimizer.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qexpr/evaluation_engine.h"
+#include "arolla/qtype/base_types.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla::expr {
+namespace {
+
+using ::arolla::testing::StatusIs;
+using ::testing::Eq;
+using ::testing::Field;
+using ::testing::Ne;
+
+auto StatsAre(int64_t hits, int64_t misses) {
+  return ::testing::AllOf(Field(&CompilationCache::Stats::hits, Eq(hits)),
+                          Field(&CompilationCache::Stats::misses, Eq(misses)));
+}
+
+class CompilationCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_OK(InitArolla()); }
+};
+
+TEST_F(CompilationCacheTest, HitsAndMisses) {
+  CompilationCache cache;
+  DynamicEvaluationEngineOptions options;
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(
+      auto compiled_expr,
+      cache.Compile(options, expr,
+                    {{"x", GetQType<int32_t>()}, {"y", GetQType<int32_t>()}}));
+  EXPECT_EQ(compiled_expr->output_type(), GetQType<int32_t>());
+  EXPECT_THAT(cache.GetStats(), StatsAre(0, 1));
+
+  // Structurally equal expressions share the entry.
+  ASSERT_OK_AND_ASSIGN(auto same_expr,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(
+      auto same_compiled_expr,
+      cache.Compile(options, same_expr,
+                    {{"y", GetQType<int32_t>()}, {"x", GetQType<int32_t>()}}));
+  EXPECT_EQ(same_compiled_expr, compiled_expr);
+  EXPECT_THAT(cache.GetStats(), StatsAre(1, 1));
+
+  // Different input types.
+  ASSERT_OK_AND_ASSIGN(
+      auto float_compiled_expr,
+      cache.Compile(options, expr,
+                    {{"x", GetQType<float>()}, {"y", GetQType<float>()}}));
+  EXPECT_EQ(float_compiled_expr->output_type(), GetQType<float>());
+  EXPECT_THAT(cache.GetStats(), StatsAre(1, 2));
+
+  // Different options.
+  options.collect_op_descriptions = true;
+  ASSERT_OK_AND_ASSIGN(
+      auto other_compiled_expr,
+      cache.Compile(options, expr,
+                    {{"x", GetQType<int32_t>()}, {"y", GetQType<int32_t>()}}));
+  EXPECT_NE(other_compiled_expr, compiled_expr);
+  EXPECT_THAT(cache.GetStats(), StatsAre(1, 3));
+
+  cache.Clear();
+  EXPECT_THAT(cache.GetStats(), StatsAre(0, 0));
+}
+
+TEST_F(CompilationCacheTest, Eviction) {
+  CompilationCache cache(/*capacity=*/1);
+  DynamicEvaluationEngineOptions options;
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto other_expr,
+                       CallOp("math.multiply", {Leaf("x"), Leaf("y")}));
+  absl::flat_hash_map<std::string, QTypePtr> input_types = {
+      {"x", GetQType<int32_t>()}, {"y", GetQType<int32_t>()}};
+  ASSERT_OK(cache.Compile(options, expr, input_types));
+  ASSERT_OK(cache.Compile(options, other_expr, input_types));
+  ASSERT_OK(cache.Compile(options, expr, input_types));
+  EXPECT_THAT(cache.GetStats(), StatsAre(0, 3));
+  ASSERT_OK(cache.Compile(options, expr, input_types));
+  EXPECT_THAT(cache.GetStats(), StatsAre(1, 3));
+}
+
+TEST_F(CompilationCacheTest, ErrorsAreNotCached) {
+  CompilationCache cache;
+  DynamicEvaluationEngineOptions options;
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  EXPECT_THAT(cache.Compile(options, expr, {{"x", GetQType<int32_t>()}}),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_THAT(cache.Compile(options, expr, {{"x", GetQType<int32_t>()}}),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_THAT(cache.GetStats(), StatsAre(0, 2));
+}
+
+TEST_F(CompilationCacheTest, OptimizerBypassesCache) {
+  CompilationCache cache;
+  DynamicEvaluationEngineOptions options;
+  options.optimizer = [](ExprNodePtr expr) { return expr; };
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  absl::flat_hash_map<std::string, QTypePtr> input_types = {
+      {"x", GetQType<int32_t>()}, {"y", GetQType<int32_t>()}};
+  ASSERT_OK_AND_ASSIGN(auto compiled_expr,
+                       cache.Compile(options, expr, input_types));
+  ASSERT_OK_AND_ASSIGN(auto other_compiled_expr,
+                       cache.Compile(options, expr, input_types));
+  EXPECT_THAT(other_compiled_expr, Ne(compiled_expr));
+  EXPECT_THAT(cache.GetStats(), StatsAre(0, 0));
+}
+
+TEST_F(CompilationCacheTest, LiteralBufferFactoryBypassesCache) {
+  CompilationCache cache;
+  DynamicEvaluationEngineOptions options;
+  options.literal_buffer_factory = GetHeapBufferFactory();
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  absl::flat_hash_map<std::string, QTypePtr> input_types = {
+      {"x", GetQType<int32_t>()}, {"y", GetQType<int32_t>()}};
+  ASSERT_OK_AND_ASSIGN(auto compiled_expr,
+                       cache.Compile(options, expr, input_types));
+  ASSERT_OK_AND_ASSIGN(auto other_compiled_expr,
+                       cache.Compile(options, expr, input_types));
+  EXPECT_THAT(other_compiled_expr, Ne(compiled_expr));
+  EXPECT_THAT(cache.GetStats(), StatsAre(0, 0));
+}
+
+TEST_F(CompilationCacheTest, Multithreading) {
+  CompilationCache cache;
+  DynamicEvaluationEngineOptions options;
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  absl::flat_hash_map<std::string, QTypePtr> input_types = {
+      {"x", GetQType<int32_t>()}, {"y", GetQType<int32_t>()}};
+  constexpr int kThreadCount = 4;
+  constexpr int kIterationCount = 10;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < kIterationCount; ++j) {
+        ASSERT_OK(cache.Compile(options, expr, input_types));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  CompilationCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(stats.hits + stats.misses, kThreadCount * kIterationCount);
+  EXPECT_GE(stats.misses, 1);
+  EXPECT_LE(stats.misses, kThreadCount);
+}
+
+}  // namespace
+}  // namespace arolla::expr
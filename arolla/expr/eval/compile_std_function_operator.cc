@@ -65,6 +65,7 @@ absl::Status CompileStdFunctionOperator(
       FormatOperatorCall(std_function_op.display_name(), input_slots,
                          {output_slot}),
       /*display_name=*/std::string(std_function_op.display_name()));
+  executable_builder.DeclareEvalOpSlots(ip, input_slots, {output_slot});
   executable_builder.RegisterStacktrace(ip, node);
   return absl::OkStatus();
 }
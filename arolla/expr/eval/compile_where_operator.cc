@@ -30,6 +30,8 @@
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "arolla/algorithm/control_flow_graph.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
 #include "arolla/expr/annotation_utils.h"
 #include "arolla/expr/basic_expr_operator.h"
 #include "arolla/expr/eval/dynamic_compiled_operator.h"
@@ -45,13 +47,17 @@
 #include "arolla/expr/expr_visitor.h"
 #include "arolla/expr/qtype_utils.h"
 #include "arolla/expr/registered_expr_operator.h"
+#include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/bound_operators.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/fingerprint.h"
+#include "arolla/util/unit.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr::eval_internal {
@@ -159,6 +165,18 @@ absl::Status VerifyArgQTypes(const QType* cond_qtype, const QType* true_qtype,
   return absl::OkStatus();
 }
 
+// Returns true if the node is a pointwise core.where on DenseArrays, that can
+// be short circuited in runtime when the condition is all present or all
+// missing.
+bool IsArrayWhere(const ExprNode& node) {
+  const auto& deps = node.node_deps();
+  return deps.size() == 3 &&
+         deps[0]->qtype() == GetDenseArrayQType<Unit>() &&
+         IsDenseArrayQType(deps[1]->qtype()) &&
+         deps[1]->qtype() == deps[2]->qtype() &&
+         node.qtype() == deps[1]->qtype();
+}
+
 absl::Status CheckTypesUnchangedOrStripped(
     absl::Span<const QTypePtr> expected,
     absl::Span<const ExprAttributes> given) {
@@ -177,6 +195,111 @@ absl::Status CheckTypesUnchangedOrStripped(
   return absl::OkStatus();
 }
 
+// Compiles PackedWhereOp with a DenseArray<Unit> condition. Evaluates only the
+// true (false) branch if the condition is all present (missing), and both
+// branches together with the pointwise core.where otherwise.
+absl::StatusOr<TypedSlot> CompileArrayWhereOperator(
+    const DynamicEvaluationEngineOptions& options,
+    const PackedWhereOp& where_op, absl::Span<const TypedSlot> input_slots,
+    TypedSlot output_slot,
+    eval_internal::ExecutableBuilder* executable_builder) {
+  QTypePtr output_qtype = where_op.true_op().output_qtype();
+  if (output_slot.GetType() != output_qtype) {
+    return absl::InternalError(
+        "unexpected output slot type for internal.packed_where operator");
+  }
+  ASSIGN_OR_RETURN(auto cond_slot,
+                   input_slots[0].ToSlot<DenseArray<Unit>>());
+  const OperatorDirectory& backend_operators =
+      options.operator_directory != nullptr ? *options.operator_directory
+                                            : *OperatorRegistry::GetInstance();
+  ASSIGN_OR_RETURN(
+      auto where_qexpr_op,
+      backend_operators.LookupOperator(
+          "core.where", {input_slots[0].GetType(), output_qtype, output_qtype},
+          output_qtype));
+
+  FrameLayout::Builder* layout_builder = executable_builder->layout_builder();
+  auto need_true_slot = layout_builder->AddSlot<bool>();
+  auto need_false_slot = layout_builder->AddSlot<bool>();
+  TypedSlot true_output_slot = AddSlot(output_qtype, layout_builder);
+  TypedSlot false_output_slot = AddSlot(output_qtype, layout_builder);
+  std::vector<TypedSlot> where_input_slots = {
+      input_slots[0], true_output_slot, false_output_slot};
+  ASSIGN_OR_RETURN(std::unique_ptr<BoundOperator> bound_where,
+                   where_qexpr_op->Bind(where_input_slots, output_slot));
+
+  std::vector<TypedSlot> need_slots = {TypedSlot::FromSlot(need_true_slot),
+                                       TypedSlot::FromSlot(need_false_slot)};
+  executable_builder->AddEvalOp(
+      MakeBoundOperator(
+          [cond_slot, need_true_slot, need_false_slot](EvaluationContext*,
+                                                       FramePtr frame) {
+            const auto& cond = frame.Get(cond_slot);
+            int64_t present_count = cond.PresentCount();
+            frame.Set(need_true_slot, present_count > 0);
+            frame.Set(need_false_slot,
+                      present_count < cond.size() || cond.empty());
+          }),
+      eval_internal::FormatOperatorCall("internal.where_branches",
+                                        {input_slots[0]}, need_slots),
+      "internal.where_branches");
+
+  auto true_input_slots =
+      input_slots.subspan(1, where_op.true_op().input_qtypes().size());
+  auto before_true_branch = executable_builder->SkipEvalOp();
+  RETURN_IF_ERROR(where_op.true_op().BindTo(
+      *executable_builder, true_input_slots, true_output_slot));
+
+  auto false_input_slots =
+      input_slots.subspan(1 + where_op.true_op().input_qtypes().size());
+  auto before_false_branch = executable_builder->SkipEvalOp();
+  RETURN_IF_ERROR(where_op.false_op().BindTo(
+      *executable_builder, false_input_slots, false_output_slot));
+
+  int64_t jump_over_true_branch = before_false_branch - before_true_branch - 1;
+  auto before_true_branch_op_name =
+      absl::StrFormat("jump_if_not<%+d>", jump_over_true_branch);
+  RETURN_IF_ERROR(executable_builder->SetEvalOp(
+      before_true_branch,
+      JumpIfNotBoundOperator(need_true_slot, jump_over_true_branch),
+      eval_internal::FormatOperatorCall(before_true_branch_op_name,
+                                        {need_slots[0]}, {}),
+      before_true_branch_op_name));
+  int64_t jump_over_false_branch =
+      executable_builder->current_eval_ops_size() - before_false_branch - 1;
+  auto before_false_branch_op_name =
+      absl::StrFormat("jump_if_not<%+d>", jump_over_false_branch);
+  RETURN_IF_ERROR(executable_builder->SetEvalOp(
+      before_false_branch,
+      JumpIfNotBoundOperator(need_false_slot, jump_over_false_branch),
+      eval_internal::FormatOperatorCall(before_false_branch_op_name,
+                                        {need_slots[1]}, {}),
+      before_false_branch_op_name));
+
+  executable_builder->AddEvalOp(
+      MakeBoundOperator([need_true_slot, need_false_slot, true_output_slot,
+                         false_output_slot, output_slot,
+                         bound_where = std::move(bound_where)](
+                            EvaluationContext* ctx, FramePtr frame) {
+        bool need_true = frame.Get(need_true_slot);
+        bool need_false = frame.Get(need_false_slot);
+        if (need_true && need_false) {
+          bound_where->Run(ctx, frame);
+        } else {
+          (need_true ? true_output_slot : false_output_slot)
+              .CopyTo(frame, output_slot, frame);
+        }
+      }),
+      eval_internal::FormatOperatorCall(
+          "internal.where_merge",
+          {input_slots[0], true_output_slot, false_output_slot, need_slots[0],
+           need_slots[1]},
+          {output_slot}),
+      "internal.where_merge");
+  return output_slot;
+}
+
 }  // namespace
 
 absl::StatusOr<ExprOperatorPtr> PackedWhereOp::Create(
@@ -228,7 +351,10 @@ absl::StatusOr<ExprNodePtr> WhereOperatorTransformationImpl(
     const DynamicEvaluationEngineOptions& options, ExprNodePtr node,
     const ExprDominatorTree& dominator_tree) {
   ASSIGN_OR_RETURN(auto op, DecayRegisteredOperator(node->op()));
-  if (!IsBackendOperator(op, "core._short_circuit_where")) {
+  const bool is_array_where =
+      options.enable_array_where_short_circuit &&
+      IsBackendOperator(op, "core.where") && IsArrayWhere(*node);
+  if (!is_array_where && !IsBackendOperator(op, "core._short_circuit_where")) {
     return node;
   }
   const auto& deps = node->node_deps();
@@ -242,8 +368,11 @@ absl::StatusOr<ExprNodePtr> WhereOperatorTransformationImpl(
   const ExprNodePtr& true_branch = deps[1];
   const ExprNodePtr& false_branch = deps[2];
 
-  RETURN_IF_ERROR(VerifyArgQTypes(condition_branch->qtype(),
-                                  true_branch->qtype(), false_branch->qtype()));
+  if (!is_array_where) {
+    RETURN_IF_ERROR(VerifyArgQTypes(condition_branch->qtype(),
+                                    true_branch->qtype(),
+                                    false_branch->qtype()));
+  }
 
   // Filter for "if" branch subnodes that should be short circuited.
   auto must_be_short_circuited = [&](ExprNodePtr branch_root) {
@@ -283,6 +412,9 @@ absl::StatusOr<ExprNodePtr> WhereOperatorTransformationImpl(
                    must_be_short_circuited(false_branch)(false_branch));
   if (!true_branch_must_be_short_circuited &&
       !false_branch_must_be_short_circuited) {
+    if (is_array_where) {
+      return node;
+    }
     ASSIGN_OR_RETURN(ExprOperatorPtr core_where_op,
                      LookupOperator("core.where"));
     ASSIGN_OR_RETURN(core_where_op, DecayRegisteredOperator(core_where_op));
@@ -375,6 +507,11 @@ absl::StatusOr<TypedSlot> CompileWhereOperator(
         "operator");
   }
 
+  if (input_slots[0].GetType() == GetDenseArrayQType<Unit>()) {
+    return CompileArrayWhereOperator(options, where_op, input_slots,
+                                     output_slot, executable_builder);
+  }
+
   auto true_input_slots =
       input_slots.subspan(1, where_op.true_op().input_qtypes().size());
   auto before_true_branch = executable_builder->SkipEvalOp();
@@ -27,6 +27,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "arolla/array/qtype/types.h"
+#include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/expr/eval/dynamic_compiled_operator.h"
 #include "arolla/expr/eval/eval.h"
@@ -523,6 +524,89 @@ TEST_P(WhereOperatorTest, ShortCircuit) {
                        HasSubstr("division by zero")));
 }
 
+TEST_P(WhereOperatorTest, ShortCircuitWithFusedOperators) {
+  // (cond ? x * y : x * z) + w
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr x_mul_y,
+                       CallOp("math.multiply", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr x_mul_z,
+                       CallOp("math.multiply", {Leaf("x"), Leaf("z")}));
+  ASSERT_OK_AND_ASSIGN(
+      ExprNodePtr expr,
+      CallOp("math.add",
+             {CallOp("core._short_circuit_where", {Leaf("cond"), x_mul_y,
+                                                   x_mul_z}),
+              Leaf("w")}));
+  DynamicEvaluationEngineOptions options = GetOptions();
+  options.fuse_scalar_operator_pairs = true;
+  // The last operator of the false branch must not be fused with math.add,
+  // otherwise the jump from the true branch skipped the addition.
+  for (auto [cond, expected] :
+       {std::pair{kPresent, 2.0f * 3.0f + 7.0f},
+        std::pair{kMissing, 2.0f * 5.0f + 7.0f}}) {
+    EXPECT_THAT(Invoke(expr,
+                       {{"cond", TypedValue::FromValue(cond)},
+                        {"x", TypedValue::FromValue(2.0f)},
+                        {"y", TypedValue::FromValue(3.0f)},
+                        {"z", TypedValue::FromValue(5.0f)},
+                        {"w", TypedValue::FromValue(7.0f)}},
+                       options),
+                IsOkAndHolds(TypedValueWith<float>(Eq(expected))));
+  }
+}
+
+TEST_P(WhereOperatorTest, ArrayWhereShortCircuit) {
+  // cond ? x + 1 : x // y
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr x_plus_1,
+                       CallOp("math.add", {Leaf("x"), Literal(1)}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr x_div_y,
+                       CallOp("math.floordiv", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr expr,
+                       CallOp("core.where", {Leaf("cond"), x_plus_1, x_div_y}));
+  auto all_present = CreateDenseArray<Unit>({kUnit, kUnit});
+  auto all_missing = CreateDenseArray<Unit>({std::nullopt, std::nullopt});
+  auto mixed = CreateDenseArray<Unit>({kUnit, std::nullopt});
+  auto x = TypedValue::FromValue(CreateDenseArray<int>({4, 6}));
+  auto zeros = TypedValue::FromValue(CreateDenseArray<int>({0, 0}));
+  auto y = TypedValue::FromValue(CreateDenseArray<int>({2, 3}));
+
+  // Both branches are evaluated by default.
+  EXPECT_THAT(Invoke(expr,
+                     {{"cond", TypedValue::FromValue(all_present)},
+                      {"x", x},
+                      {"y", zeros}},
+                     GetOptions()),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("division by zero")));
+
+  DynamicEvaluationEngineOptions options = GetOptions();
+  options.enable_array_where_short_circuit = true;
+  EXPECT_THAT(Invoke(expr,
+                     {{"cond", TypedValue::FromValue(all_present)},
+                      {"x", x},
+                      {"y", zeros}},
+                     options),
+              IsOkAndHolds(TypedValueWith<DenseArray<int>>(ElementsAre(5, 7))));
+  EXPECT_THAT(Invoke(expr,
+                     {{"cond", TypedValue::FromValue(all_missing)},
+                      {"x", x},
+                      {"y", y}},
+                     options),
+              IsOkAndHolds(TypedValueWith<DenseArray<int>>(ElementsAre(2, 2))));
+  EXPECT_THAT(Invoke(expr,
+                     {{"cond", TypedValue::FromValue(mixed)},
+                      {"x", x},
+                      {"y", y}},
+                     options),
+              IsOkAndHolds(TypedValueWith<DenseArray<int>>(ElementsAre(5, 2))));
+  EXPECT_THAT(Invoke(expr,
+                     {{"cond", TypedValue::FromValue(mixed)},
+                      {"x", x},
+                      {"y", zeros}},
+                     options),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("division by zero")));
+}
+
 TEST_P(WhereOperatorTest, WhereWithLiteral) {
   // cond ? x + 1 : x + 2
   ASSERT_OK_AND_ASSIGN(
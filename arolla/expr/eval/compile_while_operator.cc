@@ -14,6 +14,7 @@
 //
 #include "arolla/expr/eval/compile_while_operator.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -24,11 +25,15 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
+#include "arolla/array/array.h"
+#include "arolla/array/id_filter.h"
+#include "arolla/array/qtype/types.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/eval/evaluator_operators.h"
 #include "arolla/expr/eval/executable_builder.h"
 #include "arolla/expr/expr_operator.h"
 #include "arolla/expr/operators/while_loop/while_loop.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/eval_context.h"
@@ -36,7 +41,10 @@
 #include "arolla/qexpr/operators.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/util/unit.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr::eval_internal {
@@ -84,11 +92,13 @@ class WhileLoopBoundOperator : public BoundOperator {
       }
       operators_on_tmp_.condition->Execute(ctx, frame);
       if (!ctx->status().ok() || !frame.Get(condition_slot_)) {
-        tmp_state_slot_.CopyTo(frame, output_state_slot_, frame);
+        // The tmp state is overwritten by the body before being read again,
+        // so it can be moved out.
+        tmp_state_slot_.MoveTo(frame, output_state_slot_, frame);
         break;
       }
       operators_on_tmp_.body->Execute(ctx, frame);
-      if (!ctx->status().ok()) {
+      if (!ctx->status().ok() || ctx->CheckCancellation()) {
         break;
       }
     }
@@ -103,6 +113,169 @@ class WhileLoopBoundOperator : public BoundOperator {
   TypedSlot output_state_slot_;
 };
 
+// A field of the batched loop state (or an Array immutable argument) together
+// with the qtype used to manipulate it.
+struct BatchedLoopArray {
+  const ArrayQTypeBase* qtype;
+  TypedSlot slot;
+};
+
+// Bound operator for batched_while_loop.
+//
+// The current state holds only the rows that are still in the loop: each
+// iteration restricts the state and the Array immutable arguments to the
+// active ids, so the condition and the body are evaluated in the sparse form.
+// The finished rows are collected separately and merged into the output once
+// the loop is over.
+class BatchedWhileLoopBoundOperator : public BoundOperator {
+ public:
+  //   operators.condition: current_state_slot -> condition_slot
+  //   operators.body: current_state_slot -> next_state_slot
+  //
+  // The operators read the immutable Array arguments from
+  // `array_args[i].second` slots, which are populated from
+  // `array_args[i].first` restricted to the active ids.
+  BatchedWhileLoopBoundOperator(
+      BoundLoopOperators operators,
+      FrameLayout::Slot<Array<Unit>> condition_slot,
+      TypedSlot initial_state_slot, TypedSlot current_state_slot,
+      std::vector<BatchedLoopArray> current_state,
+      std::vector<BatchedLoopArray> next_state,
+      std::vector<BatchedLoopArray> output_state,
+      std::vector<std::pair<BatchedLoopArray, TypedSlot>> array_args)
+      : operators_(std::move(operators)),
+        condition_slot_(condition_slot),
+        initial_state_slot_(initial_state_slot),
+        current_state_slot_(current_state_slot),
+        current_state_(std::move(current_state)),
+        next_state_(std::move(next_state)),
+        output_state_(std::move(output_state)),
+        array_args_(std::move(array_args)) {}
+
+  void Run(EvaluationContext* ctx, FramePtr frame) const override {
+    ctx->set_status(RunImpl(ctx, frame));
+  }
+
+ private:
+  absl::StatusOr<int64_t> GetCommonSize(FramePtr frame) const {
+    int64_t size = -1;
+    auto check_size = [&](const BatchedLoopArray& array) -> absl::Status {
+      ASSIGN_OR_RETURN(int64_t array_size,
+                       array.qtype->ArraySize(TypedRef::FromSlot(
+                           array.slot, frame)));
+      if (size != -1 && size != array_size) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "batched while loop requires all the arrays to have the same "
+            "size, got %d and %d",
+            size, array_size));
+      }
+      size = array_size;
+      return absl::OkStatus();
+    };
+    for (const auto& field : current_state_) {
+      RETURN_IF_ERROR(check_size(field));
+    }
+    for (const auto& [arg, _] : array_args_) {
+      RETURN_IF_ERROR(check_size(arg));
+    }
+    return size;
+  }
+
+  static void WithIds(const IdFilter& ids, const BatchedLoopArray& source,
+                      const BatchedLoopArray& destination, FramePtr frame) {
+    source.qtype->UnsafeWithIds(
+        ids, frame.GetRawPointer(source.slot.byte_offset()),
+        frame.GetRawPointer(destination.slot.byte_offset()));
+  }
+
+  absl::Status RunImpl(EvaluationContext* ctx, FramePtr frame) const {
+    initial_state_slot_.CopyTo(frame, current_state_slot_, frame);
+    ASSIGN_OR_RETURN(int64_t size, GetCommonSize(frame));
+    for (const auto& [arg, restricted_slot] : array_args_) {
+      arg.slot.CopyTo(frame, restricted_slot, frame);
+    }
+
+    // Finished rows of each state field, in the order of iterations.
+    std::vector<std::vector<TypedValue>> finished(output_state_.size());
+    IdFilter active_ids = IdFilter::kFull;
+    std::vector<int64_t> continuing;
+    std::vector<int64_t> stopped;
+    for (;;) {
+      operators_.condition->Execute(ctx, frame);
+      RETURN_IF_ERROR(ctx->status());
+      const Array<Unit>& condition = frame.Get(condition_slot_);
+      if (condition.size() != size) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "batched while loop condition returned an array of size %d, "
+            "expected %d",
+            condition.size(), size));
+      }
+      // The condition values for the active rows, in the order of ids.
+      Array<Unit> active_condition =
+          condition.WithIds(active_ids, std::nullopt);
+      continuing.clear();
+      stopped.clear();
+      active_condition.dense_data().ForEach(
+          [&](int64_t offset, bool present, auto /*value*/) {
+            int64_t id = active_ids.type() == IdFilter::kFull
+                             ? offset
+                             : active_ids.IdsOffsetToId(offset);
+            (present ? continuing : stopped).push_back(id);
+          });
+      if (!stopped.empty()) {
+        IdFilter stopped_ids(size, Buffer<int64_t>::Create(stopped.begin(),
+                                                           stopped.end()));
+        for (size_t i = 0; i < output_state_.size(); ++i) {
+          // The output slot is used as a scratch space.
+          WithIds(stopped_ids, current_state_[i], output_state_[i], frame);
+          finished[i].push_back(
+              TypedValue::FromSlot(output_state_[i].slot, frame));
+        }
+      }
+      if (continuing.empty()) {
+        break;
+      }
+      active_ids = IdFilter(size, Buffer<int64_t>::Create(continuing.begin(),
+                                                          continuing.end()));
+      for (const auto& [arg, restricted_slot] : array_args_) {
+        WithIds(active_ids, arg, {arg.qtype, restricted_slot}, frame);
+      }
+      for (const auto& field : current_state_) {
+        WithIds(active_ids, field, field, frame);
+      }
+      operators_.body->Execute(ctx, frame);
+      RETURN_IF_ERROR(ctx->status());
+      for (size_t i = 0; i < current_state_.size(); ++i) {
+        WithIds(active_ids, next_state_[i], current_state_[i], frame);
+      }
+      if (ctx->CheckCancellation()) {
+        return ctx->status();
+      }
+    }
+
+    std::vector<const void*> sources;
+    for (size_t i = 0; i < output_state_.size(); ++i) {
+      sources.clear();
+      for (const auto& value : finished[i]) {
+        sources.push_back(value.GetRawPointer());
+      }
+      output_state_[i].qtype->UnsafeMergeDisjoint(
+          size, sources,
+          frame.GetRawPointer(output_state_[i].slot.byte_offset()));
+    }
+    return absl::OkStatus();
+  }
+
+  BoundLoopOperators operators_;
+  FrameLayout::Slot<Array<Unit>> condition_slot_;
+  TypedSlot initial_state_slot_;
+  TypedSlot current_state_slot_;
+  std::vector<BatchedLoopArray> current_state_;
+  std::vector<BatchedLoopArray> next_state_;
+  std::vector<BatchedLoopArray> output_state_;
+  std::vector<std::pair<BatchedLoopArray, TypedSlot>> array_args_;
+};
+
 absl::StatusOr<std::shared_ptr<BoundExpr>> CompileAndBindExprOperator(
     const DynamicEvaluationEngineOptions& options, const ExprOperatorPtr& op,
     absl::Span<const TypedSlot> input_slots,
@@ -144,6 +317,29 @@ absl::StatusOr<BoundLoopOperators> BindLoopOperators(
                             std::move(body_out_to_tmp_op)};
 }
 
+// Returns the fields of the given batched loop state slot.
+absl::StatusOr<std::vector<BatchedLoopArray>> GetBatchedLoopStateFields(
+    TypedSlot state_slot) {
+  std::vector<BatchedLoopArray> fields;
+  fields.reserve(state_slot.SubSlotCount());
+  for (int64_t i = 0; i < state_slot.SubSlotCount(); ++i) {
+    TypedSlot field = state_slot.SubSlot(i);
+    const auto* array_qtype =
+        dynamic_cast<const ArrayQTypeBase*>(field.GetType());
+    if (array_qtype == nullptr) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "batched while loop state must consist of arrays, got %s",
+          state_slot.GetType()->name()));
+    }
+    fields.push_back({array_qtype, field});
+  }
+  if (fields.empty()) {
+    return absl::InvalidArgumentError(
+        "batched while loop must have at least one mutable state variable");
+  }
+  return fields;
+}
+
 }  // namespace
 
 absl::Status CompileWhileOperator(
@@ -200,4 +396,83 @@ absl::Status CompileWhileOperator(
   return absl::OkStatus();
 }
 
+absl::Status CompileBatchedWhileOperator(
+    const DynamicEvaluationEngineOptions& options,
+    const expr_operators::BatchedWhileLoopOperator& while_op,
+    absl::Span<const TypedSlot> input_slots, TypedSlot output_slot,
+    ExecutableBuilder& executable_builder) {
+  if (input_slots.empty()) {
+    return absl::InvalidArgumentError(
+        "unexpected number of input slots: expected at least 1 slot, got 0");
+  }
+  TypedSlot initial_state_slot = input_slots[0];
+  if (output_slot.GetType() != initial_state_slot.GetType()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "unexpected type of output slot: expected %s slot, got %s",
+        initial_state_slot.GetType()->name(), output_slot.GetType()->name()));
+  }
+
+  auto* layout_builder = executable_builder.layout_builder();
+  FrameLayout::Slot<Array<Unit>> condition_slot =
+      layout_builder->AddSlot<Array<Unit>>();
+  TypedSlot current_state_slot = AddSlot(output_slot.GetType(), layout_builder);
+  TypedSlot next_state_slot = AddSlot(output_slot.GetType(), layout_builder);
+  ASSIGN_OR_RETURN(auto current_state,
+                   GetBatchedLoopStateFields(current_state_slot));
+  ASSIGN_OR_RETURN(auto next_state, GetBatchedLoopStateFields(next_state_slot));
+  ASSIGN_OR_RETURN(auto output_state, GetBatchedLoopStateFields(output_slot));
+
+  // The immutable Array arguments are restricted to the active rows on each
+  // iteration, so the loop operators read them from separate slots.
+  std::vector<std::pair<BatchedLoopArray, TypedSlot>> array_args;
+  std::vector<TypedSlot> constant_slots;
+  constant_slots.reserve(input_slots.size() - 1);
+  for (TypedSlot slot : input_slots.subspan(1)) {
+    if (const auto* array_qtype =
+            dynamic_cast<const ArrayQTypeBase*>(slot.GetType())) {
+      TypedSlot restricted_slot = AddSlot(slot.GetType(), layout_builder);
+      array_args.emplace_back(BatchedLoopArray{array_qtype, slot},
+                              restricted_slot);
+      constant_slots.push_back(restricted_slot);
+    } else {
+      constant_slots.push_back(slot);
+    }
+  }
+
+  DynamicEvaluationEngineOptions subexpression_options(options);
+  // Some preparation stages may be disabled, but we restore the defaults for
+  // the wrapped operator.
+  subexpression_options.enabled_preparation_stages =
+      DynamicEvaluationEngineOptions::PreparationStage::kAll;
+  std::vector<TypedSlot> loop_input_slots;
+  loop_input_slots.reserve(1 + constant_slots.size());
+  loop_input_slots.push_back(current_state_slot);
+  loop_input_slots.insert(loop_input_slots.end(), constant_slots.begin(),
+                          constant_slots.end());
+  ASSIGN_OR_RETURN(
+      auto condition_op,
+      CompileAndBindExprOperator(subexpression_options, while_op.condition(),
+                                 loop_input_slots,
+                                 TypedSlot::FromSlot(condition_slot),
+                                 executable_builder),
+      _ << "in loop condition");
+  ASSIGN_OR_RETURN(
+      auto body_op,
+      CompileAndBindExprOperator(subexpression_options, while_op.body(),
+                                 loop_input_slots, next_state_slot,
+                                 executable_builder),
+      _ << "in loop body");
+
+  executable_builder.AddEvalOp(
+      std::make_unique<BatchedWhileLoopBoundOperator>(
+          BoundLoopOperators{std::move(condition_op), std::move(body_op)},
+          condition_slot, initial_state_slot, current_state_slot,
+          std::move(current_state), std::move(next_state),
+          std::move(output_state), std::move(array_args)),
+      eval_internal::FormatOperatorCall("internal.batched_while_loop",
+                                        input_slots, {output_slot}),
+      "internal.batched_while_loop");
+  return absl::OkStatus();
+}
+
 }  // namespace arolla::expr::eval_internal
@@ -31,6 +31,13 @@ absl::Status CompileWhileOperator(
     absl::Span<const TypedSlot> input_slots, TypedSlot output_slot,
     ExecutableBuilder& executable_builder);
 
+// Compiles BatchedWhileLoopOperator into the executable_builder.
+absl::Status CompileBatchedWhileOperator(
+    const DynamicEvaluationEngineOptions& options,
+    const expr_operators::BatchedWhileLoopOperator& while_op,
+    absl::Span<const TypedSlot> input_slots, TypedSlot output_slot,
+    ExecutableBuilder& executable_builder);
+
 }  // namespace arolla::expr::eval_internal
 
 #endif  // AROLLA_EXPR_EVAL_COMPILE_WHILE_OPERATOR_H_
@@ -20,7 +20,12 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/log/check.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "arolla/array/array.h"
+#include "arolla/array/qtype/types.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/expr/eval/eval.h"
@@ -34,6 +39,7 @@
 #include "arolla/qtype/testing/qtype.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/util/cancellation_context.h"
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/text.h"
@@ -43,9 +49,11 @@ namespace arolla::expr::eval_internal {
 namespace {
 
 using ::arolla::testing::IsOkAndHolds;
+using ::arolla::testing::StatusIs;
 using ::arolla::testing::TypedValueWith;
 using ::testing::ElementsAre;
 using ::testing::Eq;
+using ::testing::HasSubstr;
 
 class WhileOperatorTest
     : public ::testing::TestWithParam<DynamicEvaluationEngineOptions> {
@@ -154,6 +162,118 @@ TEST_P(WhileOperatorTest, LoopWithDenseArray) {
           ElementsAre(0, 1000000, 2000000))));
 }
 
+TEST_P(WhileOperatorTest, BatchedWhile) {
+  ASSERT_OK_AND_ASSIGN(
+      auto loop_condition,
+      CallOp("core.not_equal", {Placeholder("y"), Literal<int64_t>(0)}));
+  auto new_x = Placeholder("y");
+  ASSERT_OK_AND_ASSIGN(
+      auto new_y, CallOp("math.mod", {Placeholder("x"), Placeholder("y")}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr while_loop,
+                       expr_operators::MakeBatchedWhileLoop(
+                           {{"x", Leaf("x")}, {"y", Leaf("y")}}, loop_condition,
+                           {{"x", new_x}, {"y", new_y}}));
+  ASSERT_OK_AND_ASSIGN(
+      ExprNodePtr gcd,
+      CallOp("namedtuple.get_field", {while_loop, Literal(Text("x"))}));
+
+  // Rows finish after a different number of iterations.
+  EXPECT_THAT(
+      Invoke(gcd,
+             {{"x", TypedValue::FromValue(CreateArray<int64_t>(
+                        {57, 171, 5, std::nullopt, 12, 0}))},
+              {"y", TypedValue::FromValue(CreateArray<int64_t>(
+                        {58, 285, 0, 7, 18, 0}))}},
+             GetOptions()),
+      IsOkAndHolds(TypedValueWith<Array<int64_t>>(
+          ElementsAre(1, 57, 5, 7, 6, 0))));
+  EXPECT_THAT(Invoke(gcd,
+                     {{"x", TypedValue::FromValue(Array<int64_t>())},
+                      {"y", TypedValue::FromValue(Array<int64_t>())}},
+                     GetOptions()),
+              IsOkAndHolds(TypedValueWith<Array<int64_t>>(ElementsAre())));
+  EXPECT_THAT(Invoke(gcd,
+                     {{"x", TypedValue::FromValue(CreateArray<int64_t>({1}))},
+                      {"y", TypedValue::FromValue(
+                                CreateArray<int64_t>({1, 2}))}},
+                     GetOptions()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_P(WhileOperatorTest, BatchedWhileWithImmutables) {
+  // Adds P.step to P.x until it reaches P.limit.
+  ASSERT_OK_AND_ASSIGN(
+      auto loop_condition,
+      CallOp("core.less", {Placeholder("x"), Placeholder("limit")}));
+  ASSERT_OK_AND_ASSIGN(
+      auto new_x, CallOp("math.add", {Placeholder("x"), Placeholder("step")}));
+  ASSERT_OK_AND_ASSIGN(
+      ExprNodePtr while_loop,
+      expr_operators::MakeBatchedWhileLoop(
+          {{"x", Leaf("x")}, {"limit", Leaf("limit")}, {"step", Leaf("step")}},
+          loop_condition, {{"x", new_x}}));
+  ASSERT_OK_AND_ASSIGN(
+      ExprNodePtr result,
+      CallOp("namedtuple.get_field", {while_loop, Literal(Text("x"))}));
+  EXPECT_THAT(
+      Invoke(result,
+             {{"x", TypedValue::FromValue(CreateArray<int64_t>({0, 0, 5, 0}))},
+              {"limit",
+               TypedValue::FromValue(CreateArray<int64_t>({10, 3, 1, 100}))},
+              {"step", TypedValue::FromValue(int64_t{2})}},
+             GetOptions()),
+      IsOkAndHolds(
+          TypedValueWith<Array<int64_t>>(ElementsAre(10, 4, 5, 100))));
+}
+
+TEST_P(WhileOperatorTest, BatchedWhileRequiresArrays) {
+  ASSERT_OK_AND_ASSIGN(
+      auto loop_condition,
+      CallOp("core.not_equal", {Placeholder("y"), Literal<int64_t>(0)}));
+  ASSERT_OK_AND_ASSIGN(
+      auto new_y,
+      CallOp("math.subtract", {Placeholder("y"), Literal<int64_t>(1)}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr while_loop,
+                       expr_operators::MakeBatchedWhileLoop(
+                           {{"y", Leaf("y")}}, loop_condition, {{"y", new_y}}));
+  EXPECT_THAT(Invoke(while_loop, {{"y", TypedValue::FromValue(int64_t{5})}},
+                     GetOptions()),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("must be arrays")));
+}
+
+TEST_P(WhileOperatorTest, CancelInfiniteLoop) {
+  ASSERT_OK_AND_ASSIGN(
+      auto loop_condition,
+      CallOp("core.not_equal", {Placeholder("x"), Literal<int64_t>(-1)}));
+  ASSERT_OK_AND_ASSIGN(
+      auto new_x, CallOp("math.add", {Placeholder("x"), Literal<int64_t>(1)}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr while_loop,
+                       expr_operators::MakeWhileLoop({{"x", Leaf("x")}},
+                                                     loop_condition,
+                                                     {{"x", new_x}}));
+  FrameLayout::Builder builder;
+  auto x_slot = builder.AddSlot<int64_t>();
+  ASSERT_OK_AND_ASSIGN(
+      auto bound_expr,
+      CompileAndBindForDynamicEvaluation(GetOptions(), &builder, while_loop,
+                                         {{"x", TypedSlot::FromSlot(x_slot)}}));
+  FrameLayout layout = std::move(builder).Build();
+  RootEvaluationContext ctx(&layout);
+  ASSERT_OK(bound_expr->InitializeLiterals(&ctx));
+
+  CancellationContext cancelled;
+  cancelled.Cancel();
+  ctx.set_cancellation_context(&cancelled);
+  EXPECT_THAT(bound_expr->Execute(&ctx),
+              StatusIs(absl::StatusCode::kCancelled));
+
+  CancellationContext expired(absl::Now() - absl::Seconds(1));
+  ctx.set_cancellation_context(&expired);
+  EXPECT_THAT(bound_expr->Execute(&ctx),
+              StatusIs(absl::StatusCode::kDeadlineExceeded));
+}
+
 template <typename T>
 void BM_WhileOperator(benchmark::State& state, T initial_value) {
   CHECK_OK(InitArolla());
@@ -25,6 +25,7 @@
 
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -33,6 +34,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "arolla/expr/derived_qtype_cast_operator.h"
+#include "arolla/expr/eval/array_buffer_reuse.h"
 #include "arolla/expr/eval/compile_std_function_operator.h"
 #include "arolla/expr/eval/compile_where_operator.h"
 #include "arolla/expr/eval/compile_while_operator.h"
@@ -53,12 +55,15 @@
 #include "arolla/expr/tuple_expr_operator.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/evaluation_engine.h"
 #include "arolla/qexpr/operators.h"
 #include "arolla/qexpr/operators/core/utility_operators.h"
+#include "arolla/qtype/array_like/array_like_qtype.h"
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
 #include "arolla/util/demangle.h"
 #include "arolla/util/fast_dynamic_downcast_final.h"
 #include "arolla/util/fingerprint.h"
@@ -90,6 +95,32 @@ absl::Status VerifySlotsCount(absl::string_view op_name,
   return absl::OkStatus();
 }
 
+// Resets the given slots to default constructed (i.e. empty) values, so the
+// buffers they hold are returned to the RawBufferFactory.
+class ReleaseBuffersBoundOperator : public BoundOperator {
+ public:
+  explicit ReleaseBuffersBoundOperator(std::vector<TypedSlot> slots)
+      : slots_(std::move(slots)) {
+    empty_values_.reserve(slots_.size());
+    for (const auto& slot : slots_) {
+      empty_values_.push_back(
+          TypedValue::UnsafeFromTypeDefaultConstructed(slot.GetType()));
+    }
+  }
+
+  void Run(EvaluationContext*, FramePtr frame) const final {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      slots_[i].GetType()->UnsafeCopy(
+          empty_values_[i].GetRawPointer(),
+          frame.GetRawPointer(slots_[i].byte_offset()));
+    }
+  }
+
+ private:
+  std::vector<TypedSlot> slots_;
+  std::vector<TypedValue> empty_values_;
+};
+
 class EvalVisitor {
  public:
   EvalVisitor(DynamicEvaluationEngineOptions options,
@@ -137,7 +168,11 @@ class EvalVisitor {
     // released. Also its first dep writes to `output_slot` that is not known to
     // `slot_allocator_`.
     if (node->op() != eval_internal::InternalRootOperator()) {
-      RETURN_IF_ERROR(slot_allocator_.ReleaseSlotsNotNeededAfter(node));
+      std::vector<TypedSlot> released_slots;
+      RETURN_IF_ERROR(slot_allocator_.ReleaseSlotsNotNeededAfter(
+          node,
+          options_.release_dead_array_buffers ? &released_slots : nullptr));
+      ReleaseArrayBuffers(released_slots);
     }
     return output_slot;
   }
@@ -244,6 +279,16 @@ class EvalVisitor {
               options, *while_op, input_slots, output_slot,
               *executable_builder_));
           return output_slot;
+        } else if (auto* batched_while_op = fast_dynamic_downcast_final<
+                       const expr_operators::BatchedWhileLoopOperator*>(
+                       op.get())) {
+          DynamicEvaluationEngineOptions options(options_);
+          options.allow_overriding_input_slots = false;
+          auto output_slot = maybe_add_output_slot(/*allow_recycled=*/true);
+          RETURN_IF_ERROR(eval_internal::CompileBatchedWhileOperator(
+              options, *batched_while_op, input_slots, output_slot,
+              *executable_builder_));
+          return output_slot;
         } else if (op_typeid == typeid(DerivedQTypeUpcastOperator) ||
                    op_typeid == typeid(DerivedQTypeDowncastOperator)) {
           return HandleDerivedQTypeCast(*op, node->node_deps(), input_slots,
@@ -280,6 +325,27 @@ class EvalVisitor {
                                                static_cast<int>(node->type())));
   }
 
+  // Adds an operator that releases the buffers of the dead array values in
+  // `slots`. Non-array slots are ignored.
+  void ReleaseArrayBuffers(absl::Span<const TypedSlot> slots) {
+    std::vector<TypedSlot> array_slots;
+    for (const auto& slot : slots) {
+      if (IsArrayLikeQType(slot.GetType())) {
+        array_slots.push_back(slot);
+      }
+    }
+    if (array_slots.empty()) {
+      return;
+    }
+    auto description = FormatOperatorCall("internal.release_buffers",
+                                          array_slots, /*output_slots=*/{});
+    int64_t ip = executable_builder_->AddEvalOp(
+        std::make_unique<ReleaseBuffersBoundOperator>(array_slots),
+        std::move(description), "internal.release_buffers");
+    executable_builder_->DeclareEvalOpSlots(ip, /*input_slots=*/{},
+                                            /*output_slots=*/array_slots);
+  }
+
   absl::StatusOr<TypedSlot> HandleInternalRoot(
       absl::Span<const TypedSlot> input_slots) const {
     if (input_slots.size() != 1 + side_output_names_.size()) {
@@ -363,20 +429,96 @@ class EvalVisitor {
     ASSIGN_OR_RETURN(
         auto op, GetOperatorDirectory(options_).LookupOperator(
                      name, SlotsToTypes(input_slots), output_slot.GetType()));
-    ASSIGN_OR_RETURN(auto ip, executable_builder_->BindEvalOp(*op, input_slots,
-                                                              output_slot));
+    int64_t ip;
+    if (auto reused_slot =
+            FindReusableArgBuffer(name, input_slots, output_slot, node);
+        reused_slot.has_value()) {
+      ASSIGN_OR_RETURN(auto bound_op, op->Bind(input_slots, output_slot));
+      std::string description;
+      if (options_.collect_op_descriptions) {
+        description =
+            FormatOperatorCall(op->name(), input_slots, {output_slot});
+      }
+      ip = executable_builder_->AddEvalOp(
+          MakeArgBufferReusingOperator(std::move(bound_op), *reused_slot),
+          std::move(description), std::string(op->name()));
+      // The operator resets the argument slot, so it must be ordered after
+      // its other readers.
+      executable_builder_->DeclareEvalOpSlots(ip, input_slots,
+                                              {output_slot, *reused_slot});
+    } else if (auto fused_arg = FindFusableArg(input_slots, node);
+               fused_arg.has_value()) {
+      ASSIGN_OR_RETURN(ip, executable_builder_->BindFusedEvalOp(
+                               *op, input_slots, *fused_arg, output_slot));
+    } else {
+      ASSIGN_OR_RETURN(ip, executable_builder_->BindEvalOp(*op, input_slots,
+                                                           output_slot));
+    }
     if (node != nullptr) {
       executable_builder_->RegisterStacktrace(ip, node);
+      if (options_.reuse_dead_array_buffers &&
+          ReturnsFreshArrayBuffer(name, SlotsToTypes(input_slots),
+                                  output_slot.GetType())) {
+        fresh_array_nodes_.insert(node->fingerprint());
+      }
     }
     return output_slot;
   }
 
+  // Returns an argument of the backend operator `name` that is not needed
+  // after `node`, so the operator can write its result into the argument
+  // buffer (see DynamicEvaluationEngineOptions::reuse_dead_array_buffers).
+  // Only the arguments computed by the operators from fresh_array_nodes_ are
+  // considered: the input and literal arrays may wrap foreign memory (e.g.
+  // read-only mmap-ed data, or numpy arrays) that must not be written.
+  std::optional<TypedSlot> FindReusableArgBuffer(
+      absl::string_view name, absl::Span<const TypedSlot> input_slots,
+      TypedSlot output_slot, absl::Nullable<ExprNodePtr> node) const {
+    if (!options_.reuse_dead_array_buffers || node == nullptr ||
+        node->node_deps().size() != input_slots.size()) {
+      return std::nullopt;
+    }
+    for (size_t i = 0; i < input_slots.size(); ++i) {
+      if (input_slots[i].byte_offset() != output_slot.byte_offset() &&
+          CanReuseArgBuffer(name, input_slots[i].GetType(),
+                            output_slot.GetType()) &&
+          fresh_array_nodes_.contains(node->node_deps()[i]->fingerprint()) &&
+          slot_allocator_.IsLastUsage(node->node_deps()[i], node)) {
+        return input_slots[i];
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Returns the argument of a backend operator `node` computed by another
+  // operator node with no other readers, so the two operators can be fused
+  // (see DynamicEvaluationEngineOptions::fuse_scalar_operator_pairs).
+  std::optional<size_t> FindFusableArg(absl::Span<const TypedSlot> input_slots,
+                                       absl::Nullable<ExprNodePtr> node) const {
+    if (!options_.fuse_scalar_operator_pairs || node == nullptr ||
+        node->node_deps().size() != input_slots.size()) {
+      return std::nullopt;
+    }
+    // The arguments are compiled in order, so only the last computed one can
+    // come from the immediately preceding operator.
+    for (size_t i = input_slots.size(); i-- > 0;) {
+      const auto& dep = node->node_deps()[i];
+      if (dep->is_op() && slot_allocator_.IsLastUsage(dep, node)) {
+        return i;
+      }
+    }
+    return std::nullopt;
+  }
+
   DynamicEvaluationEngineOptions options_;
   const absl::flat_hash_map<std::string, TypedSlot>& expr_input_slots_;
   OutputInfo output_info_;
   ExecutableBuilder* executable_builder_;
   const std::vector<std::string>& side_output_names_;
   absl::flat_hash_map<Fingerprint, QTypePtr> node_types_;
+  // Nodes evaluated into DenseArrays with freshly allocated values buffers,
+  // see ReturnsFreshArrayBuffer.
+  absl::flat_hash_set<Fingerprint> fresh_array_nodes_;
   eval_internal::SlotAllocator& slot_allocator_;
   CompilerExtensionSet compiler_extensions_;
 };
@@ -395,6 +537,7 @@ DynamicCompiledExpr::DynamicCompiledExpr(
                    std::move(named_output_types)),
       options_(std::move(options)),
       prepared_expr_(std::move(prepared_expr)),
+      prepared_expr_post_order_(prepared_expr_),
       side_output_names_(std::move(side_output_names)),
       types_(std::move(types)),
       stack_trace_(std::move(stack_trace)) {}
@@ -406,7 +549,16 @@ absl::StatusOr<std::unique_ptr<BoundExpr>> DynamicCompiledExpr::Bind(
   ExecutableBuilder executable_builder(
       layout_builder,
       /*collect_op_descriptions=*/options_.collect_op_descriptions,
-      stack_trace_);
+      stack_trace_, /*enable_profiling=*/options_.enable_profiling,
+      /*profile_perf_counters=*/options_.profile_perf_counters);
+  if (options_.eval_threading != nullptr) {
+    executable_builder.EnableParallelEvaluation(options_.eval_threading,
+                                                options_.min_parallel_eval_ops);
+  }
+  if (options_.trace_sink != nullptr) {
+    executable_builder.EnableExecutionTracing(options_.trace_sink,
+                                              options_.trace_sampling_period);
+  }
   if (!output_slot.has_value()) {
     output_slot = AddSlot(output_type(), layout_builder);
   }
@@ -433,13 +585,15 @@ absl::Status DynamicCompiledExpr::BindToExecutableBuilder(
   }
 
   eval_internal::SlotAllocator slot_allocator(
-      prepared_expr_, *executable_builder.layout_builder(), input_slots,
+      prepared_expr_post_order_, *executable_builder.layout_builder(),
+      input_slots,
       /*allow_reusing_leaves=*/options_.allow_overriding_input_slots);
   EvalVisitor visitor(options_, input_slots, {output_expr, output_slot},
                       &executable_builder, side_output_names_, types_,
                       slot_allocator);
   ASSIGN_OR_RETURN(TypedSlot new_output_slot,
-                   PostOrderTraverse(prepared_expr_, std::ref(visitor)));
+                   PostOrderTraverse(prepared_expr_post_order_,
+                                     std::ref(visitor)));
   if (output_slot != new_output_slot) {
     return absl::InternalError(
         absl::StrFormat("expression %s bound to a wrong output slot",
@@ -15,23 +15,29 @@
 #ifndef AROLLA_EXPR_EVAL_DYNAMIC_COMPILED_EXPR_H_
 #define AROLLA_EXPR_EVAL_DYNAMIC_COMPILED_EXPR_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/eval/executable_builder.h"
+#include "arolla/expr/eval/profiling.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_stack_trace.h"
+#include "arolla/expr/expr_visitor.h"
 #include "arolla/memory/frame.h"
 #include "arolla/qexpr/evaluation_engine.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
 #include "arolla/util/fingerprint.h"
 
 namespace arolla::expr::eval_internal {
@@ -46,6 +52,23 @@ class DynamicBoundExpr : public BoundExpr {
 
   // Descriptions of the operations performed during eval stage.
   virtual absl::Span<const std::string> eval_op_descriptions() const = 0;
+
+  // Literal values and the slots they are stored in by InitializeLiterals.
+  virtual absl::Span<const std::pair<TypedValue, TypedSlot>> literal_slots()
+      const = 0;
+
+  // Returns true if InitializeLiterals writes only the literal_slots(), e.g.
+  // there are no compiler extensions adding their own init operators.
+  virtual bool initializes_only_literal_slots() const = 0;
+
+  // Per-operator evaluation profile. Is present only if the expression is
+  // compiled with DynamicEvaluationEngineOptions::enable_profiling.
+  virtual absl::Nullable<BoundExprProfile*> profile() const = 0;
+
+  // Estimated heap memory owned by the init and eval operators, see
+  // BoundOperator::EstimateMemoryUsage. The nested expressions (e.g. while
+  // loop bodies) are not included.
+  virtual int64_t operators_memory_usage() const = 0;
 };
 
 // CompiledExpr implementation for dynamic evaluation.
@@ -83,6 +106,9 @@ class DynamicCompiledExpr : public CompiledExpr {
  private:
   DynamicEvaluationEngineOptions options_;
   ExprNodePtr prepared_expr_;
+  // Post order of prepared_expr_, computed once and reused by all the Bind
+  // calls.
+  PostOrder prepared_expr_post_order_;
   std::vector<std::string> side_output_names_;
   absl::flat_hash_map<Fingerprint, QTypePtr> types_;
   std::shared_ptr<const ExprStackTrace> stack_trace_;
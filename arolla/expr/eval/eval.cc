@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -31,23 +32,114 @@
 #include "arolla/expr/eval/dynamic_compiled_expr.h"
 #include "arolla/expr/eval/prepare_expression.h"
 #include "arolla/expr/expr.h"
+#include "arolla/expr/expr_attributes.h"
 #include "arolla/expr/expr_debug_string.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_operator.h"
 #include "arolla/expr/expr_stack_trace.h"
+#include "arolla/expr/expr_visitor.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/evaluation_engine.h"
+#include "arolla/qtype/array_like/array_like_qtype.h"
+#include "arolla/qtype/base_types.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/qtype/typed_value_interner.h"
 #include "arolla/util/fingerprint.h"
+#include "arolla/util/unit.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr {
 
-absl::StatusOr<std::unique_ptr<CompiledExpr>> CompileForDynamicEvaluation(
+namespace {
+
+// Replaces the literals of `expr` with the values returned by
+// `fn(const TypedValue&) -> absl::StatusOr<std::optional<TypedValue>>`, the
+// literals are kept if it returns std::nullopt. The new values must be equal
+// to the original ones, so the node fingerprints stay the same.
+template <typename Fn>
+absl::StatusOr<ExprNodePtr> ReplaceLiteralValues(const ExprNodePtr& expr,
+                                                 Fn&& fn) {
+  // NOTE: We cannot use Transform here because it ignores the new nodes with
+  // the same fingerprint.
+  PostOrder post_order(expr);
+  std::vector<ExprNodePtr> results(post_order.nodes_size());
+  for (size_t i = 0; i < post_order.nodes_size(); ++i) {
+    const auto& node = post_order.node(i);
+    if (node->is_literal()) {
+      ASSIGN_OR_RETURN(std::optional<TypedValue> value, fn(*node->qvalue()));
+      if (value.has_value()) {
+        results[i] = ExprNode::MakeLiteralNode(*std::move(value));
+      }
+      continue;
+    }
+    const auto& dep_indices = post_order.dep_indices(i);
+    if (!node->is_op() || absl::c_none_of(dep_indices, [&](size_t k) {
+          return results[k] != nullptr;
+        })) {
+      continue;
+    }
+    std::vector<ExprNodePtr> new_deps;
+    new_deps.reserve(dep_indices.size());
+    for (size_t j = 0; j < dep_indices.size(); ++j) {
+      const auto& new_dep = results[dep_indices[j]];
+      new_deps.push_back(new_dep != nullptr ? new_dep : node->node_deps()[j]);
+    }
+    results[i] = ExprNode::UnsafeMakeOperatorNode(
+        ExprOperatorPtr(node->op()), std::move(new_deps),
+        ExprAttributes(node->attr()));
+  }
+  return results.back() != nullptr ? results.back() : expr;
+}
+
+// Copies the array literals of `expr` into buffers allocated by
+// `buffer_factory`. The values, and so the node fingerprints, stay the same.
+absl::StatusOr<ExprNodePtr> CopyArrayLiteralsToBufferFactory(
+    const ExprNodePtr& expr, RawBufferFactory* buffer_factory) {
+  return ReplaceLiteralValues(
+      expr,
+      [&](const TypedValue& literal)
+          -> absl::StatusOr<std::optional<TypedValue>> {
+        const auto* array_qtype =
+            dynamic_cast<const ArrayLikeQType*>(literal.GetType());
+        if (array_qtype == nullptr) {
+          return std::nullopt;
+        }
+        return array_qtype->CopyToBufferFactory(literal.AsRef(),
+                                                buffer_factory);
+      });
+}
+
+// Replaces the literals of `expr` with the equal ones registered in
+// `interner`.
+absl::StatusOr<ExprNodePtr> InternLiterals(const ExprNodePtr& expr,
+                                           TypedValueInterner& interner) {
+  return ReplaceLiteralValues(
+      expr,
+      [&](const TypedValue& literal)
+          -> absl::StatusOr<std::optional<TypedValue>> {
+        if (literal.GetType()->type_layout().AllocSize() <=
+            TypedValue::kInlineSize) {
+          return std::nullopt;  // Small values are not worth sharing.
+        }
+        TypedValue interned = interner.Intern(literal);
+        if (interned.GetRawPointer() == literal.GetRawPointer()) {
+          return std::nullopt;
+        }
+        return interned;
+      });
+}
+
+// Implementation of PrepareForDynamicEvaluation, `stack_trace` can be nullptr.
+// Also returns the expression before the preparation, with the side outputs.
+absl::StatusOr<std::pair<PreparedExprForDynamicEvaluation, ExprNodePtr>>
+PrepareWithSideOutputs(
     const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
     const absl::flat_hash_map<std::string, QTypePtr>& input_types,
-    const absl::flat_hash_map<std::string, ExprNodePtr>& side_outputs) {
+    const absl::flat_hash_map<std::string, ExprNodePtr>& side_outputs,
+    std::shared_ptr<ExprStackTrace> stack_trace) {
   auto expr_with_side_outputs = expr;
 
   std::vector<std::string> side_output_names;
@@ -67,15 +159,10 @@ absl::StatusOr<std::unique_ptr<CompiledExpr>> CompileForDynamicEvaluation(
         BindOp(eval_internal::InternalRootOperator(), std::move(exprs), {}));
   }
 
-  std::shared_ptr<LightweightExprStackTrace> stack_trace = nullptr;
-  if (options.enable_expr_stack_trace) {
-    stack_trace = std::make_shared<LightweightExprStackTrace>();
-  }
-
   ASSIGN_OR_RETURN(
       ExprNodePtr prepared_expr,
       eval_internal::PrepareExpression(expr_with_side_outputs, input_types,
-                                       options, stack_trace));
+                                       options, std::move(stack_trace)));
   auto placeholder_keys = GetPlaceholderKeys(prepared_expr);
   if (!placeholder_keys.empty()) {
     return absl::FailedPreconditionError(absl::StrFormat(
@@ -83,12 +170,63 @@ absl::StatusOr<std::unique_ptr<CompiledExpr>> CompileForDynamicEvaluation(
         "evaluation: %s, got %s",
         absl::StrJoin(placeholder_keys, ","), ToDebugString(prepared_expr)));
   }
+  PreparedExprForDynamicEvaluation result;
+  if (side_output_names.empty()) {
+    result.expr = std::move(prepared_expr);
+  } else {
+    if (prepared_expr->op() != eval_internal::InternalRootOperator() ||
+        prepared_expr->node_deps().size() != side_output_names.size() + 1) {
+      return absl::InternalError(
+          "InternalRootOperator was not preserved by PrepareExpression");
+    }
+    result.expr = prepared_expr->node_deps()[0];
+    result.side_outputs.reserve(side_output_names.size());
+    for (size_t i = 0; i < side_output_names.size(); ++i) {
+      result.side_outputs.emplace_back(std::move(side_output_names[i]),
+                                       prepared_expr->node_deps()[i + 1]);
+    }
+  }
+  return std::pair(std::move(result), std::move(expr_with_side_outputs));
+}
 
+// Implementation of CompilePreparedForDynamicEvaluation. If `stack_trace` is
+// not nullptr, `original_expr` must be the expression before the preparation.
+absl::StatusOr<std::unique_ptr<CompiledExpr>> CompilePrepared(
+    const DynamicEvaluationEngineOptions& options,
+    const PreparedExprForDynamicEvaluation& prepared,
+    const ExprNodePtr& original_expr,
+    std::shared_ptr<LightweightExprStackTrace> stack_trace) {
+  if (prepared.expr == nullptr) {
+    return absl::InvalidArgumentError("prepared expression is not set");
+  }
+  ExprNodePtr expr_with_side_outputs = prepared.expr;
+  std::vector<std::string> side_output_names;
+  if (!prepared.side_outputs.empty()) {
+    std::vector<ExprNodePtr> exprs = {prepared.expr};
+    exprs.reserve(prepared.side_outputs.size() + 1);
+    side_output_names.reserve(prepared.side_outputs.size());
+    for (const auto& [name, side_output] : prepared.side_outputs) {
+      side_output_names.push_back(name);
+      exprs.push_back(side_output);
+    }
+    ASSIGN_OR_RETURN(
+        expr_with_side_outputs,
+        BindOp(eval_internal::InternalRootOperator(), std::move(exprs), {}));
+  }
   absl::flat_hash_map<Fingerprint, QTypePtr> node_types;
-  ASSIGN_OR_RETURN(prepared_expr, eval_internal::ExtractQTypesForCompilation(
-                                      prepared_expr, &node_types, stack_trace));
+  ASSIGN_OR_RETURN(ExprNodePtr prepared_expr,
+                   eval_internal::ExtractQTypesForCompilation(
+                       expr_with_side_outputs, &node_types, stack_trace));
   if (stack_trace != nullptr) {
-    stack_trace->AddRepresentations(expr_with_side_outputs, prepared_expr);
+    stack_trace->AddRepresentations(original_expr, prepared_expr);
+  }
+  if (options.literal_buffer_factory != nullptr) {
+    ASSIGN_OR_RETURN(prepared_expr,
+                     CopyArrayLiteralsToBufferFactory(
+                         prepared_expr, options.literal_buffer_factory));
+  } else if (options.literal_interner != nullptr) {
+    ASSIGN_OR_RETURN(prepared_expr,
+                     InternLiterals(prepared_expr, *options.literal_interner));
   }
   ASSIGN_OR_RETURN(auto used_input_types,
                    eval_internal::LookupLeafQTypes(prepared_expr, node_types));
@@ -118,6 +256,57 @@ absl::StatusOr<std::unique_ptr<CompiledExpr>> CompileForDynamicEvaluation(
       std::move(stack_trace)));
 }
 
+}  // namespace
+
+absl::StatusOr<PreparedExprForDynamicEvaluation> PrepareForDynamicEvaluation(
+    const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
+    const absl::flat_hash_map<std::string, QTypePtr>& input_types,
+    const absl::flat_hash_map<std::string, ExprNodePtr>& side_outputs) {
+  ASSIGN_OR_RETURN(auto result,
+                   PrepareWithSideOutputs(options, expr, input_types,
+                                          side_outputs,
+                                          /*stack_trace=*/nullptr));
+  return std::move(result.first);
+}
+
+absl::StatusOr<std::unique_ptr<CompiledExpr>>
+CompilePreparedForDynamicEvaluation(
+    const DynamicEvaluationEngineOptions& options,
+    const PreparedExprForDynamicEvaluation& prepared) {
+  return CompilePrepared(options, prepared, /*original_expr=*/nullptr,
+                         /*stack_trace=*/nullptr);
+}
+
+absl::StatusOr<std::unique_ptr<CompiledExpr>> CompileForDynamicEvaluation(
+    const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
+    const absl::flat_hash_map<std::string, QTypePtr>& input_types,
+    const absl::flat_hash_map<std::string, ExprNodePtr>& side_outputs) {
+  std::shared_ptr<LightweightExprStackTrace> stack_trace = nullptr;
+  if (options.enable_expr_stack_trace) {
+    stack_trace = std::make_shared<LightweightExprStackTrace>();
+  }
+  ASSIGN_OR_RETURN(auto prepared,
+                   PrepareWithSideOutputs(options, expr, input_types,
+                                          side_outputs, stack_trace));
+  return CompilePrepared(options, prepared.first, prepared.second,
+                         std::move(stack_trace));
+}
+
+absl::StatusOr<std::unique_ptr<CompiledExpr>>
+CompileMultipleForDynamicEvaluation(
+    const DynamicEvaluationEngineOptions& options,
+    const absl::flat_hash_map<std::string, ExprNodePtr>& named_exprs,
+    const absl::flat_hash_map<std::string, QTypePtr>& input_types) {
+  if (named_exprs.empty()) {
+    return absl::InvalidArgumentError("no expressions to compile");
+  }
+  // All the roots are compiled as side outputs of a trivial main expression,
+  // so they end up in a single program where common subexpressions are
+  // evaluated once.
+  return CompileForDynamicEvaluation(options, Literal(kUnit), input_types,
+                                     named_exprs);
+}
+
 absl::StatusOr<std::unique_ptr<BoundExpr>> CompileAndBindForDynamicEvaluation(
     const DynamicEvaluationEngineOptions& options,
     FrameLayout::Builder* layout_builder, const ExprNodePtr& expr,
@@ -19,17 +19,24 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
+#include "arolla/expr/eval/profiling.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_operator.h"
 #include "arolla/expr/optimization/optimizer.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/evaluation_engine.h"
 #include "arolla/qexpr/operators.h"
 #include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_value_interner.h"
+#include "arolla/util/cost_model.h"
+#include "arolla/util/threading.h"
 
 namespace arolla::expr {
 
@@ -55,6 +62,60 @@ struct DynamicEvaluationEngineOptions {
   // generated DynamicBoundExpr. Use it for debug/testing only.
   bool collect_op_descriptions = false;
 
+  // Collect per-operator evaluation time, allocated bytes and allocation
+  // counts in the DynamicBoundExpr::profile() of the generated
+  // DynamicBoundExpr. Adds an overhead to every operator call, use it for
+  // profiling only. The expressions compiled without the option are not
+  // affected.
+  bool enable_profiling = false;
+
+  // Also collect the hardware performance counters (cycles, instructions, LLC
+  // and branch misses) per operator in the profile, see
+  // arolla/util/perf_counters.h. Only with enable_profiling. The counters stay
+  // zero if perf_event is not available.
+  bool profile_perf_counters = false;
+
+  // If set, one in `trace_sampling_period` evaluations of the generated
+  // DynamicBoundExpr (chosen at random) runs its operators through an
+  // instrumented loop that records the duration of every operator and the
+  // sizes of the arrays it produces, and passes the ExecutionTrace to
+  // `trace_sink`, e.g. to attribute slow requests in production. The sampling
+  // decision is made once per evaluation, the other evaluations run the usual
+  // program. If specified, it must remain valid while the bound expressions
+  // are in use.
+  ExecutionTraceSink* trace_sink = nullptr;
+  int64_t trace_sampling_period = 1000;
+
+  // Fuse chains of pointwise DenseArray operators (e.g. math.add, math.exp,
+  // core.presence_and) into a single core.map call, so the chain is evaluated
+  // row by row without materializing the intermediate arrays. Only chains
+  // where every intermediate result has a single consumer are fused. Requires
+  // the core.map compiler extension to be linked, the expressions without
+  // fusible chains are not affected.
+  bool enable_pointwise_fusion = false;
+
+  // Evaluate core.map over arrays by applying the mapper to the whole
+  // arrays instead of row by row, if the mapper compiles for the array
+  // arguments and produces the same output type. The array operators process
+  // the values and the presence bitmap in tight loops, avoiding per-row
+  // dispatch. Requires the mapper to be pointwise (i.e. its array version
+  // must be equivalent to the row-wise application), otherwise the results
+  // can differ. Effectively reverts enable_pointwise_fusion, so the two
+  // options should not be combined.
+  bool enable_array_lifted_core_map = false;
+
+  // Same as enable_array_lifted_core_map, but only for the mappers that are
+  // compiled into pointwise backend operators, for which the array evaluation
+  // is guaranteed to produce the same result. Has no effect together with
+  // enable_pointwise_fusion.
+  bool enable_array_lifted_pointwise_core_map = true;
+
+  // Short circuit pointwise core.where on DenseArrays in runtime: evaluate only
+  // the true (false) branch if the condition is all present (missing), and
+  // both branches otherwise. Like for scalar conditions, only the nodes used
+  // exclusively by a branch are short circuited.
+  bool enable_array_where_short_circuit = false;
+
   // An function to apply optimizations to the expression on each iteration of
   // preprocessing. The function must keep the expression unchanged if no
   // optimizations can be applied, otherwise the compiler can fail due to
@@ -67,6 +128,59 @@ struct DynamicEvaluationEngineOptions {
   // the only (or last) reader of the input slots.
   bool allow_overriding_input_slots = false;
 
+  // If true, the compiled expression resets array (DenseArray, Array) slots
+  // right after their last reader, so the buffers are returned to
+  // RawBufferFactory before the end of the evaluation. Reduces the peak memory
+  // usage of expressions with many array intermediates at the cost of an
+  // extra operator per dead array. Together with allow_overriding_input_slots
+  // applies to the input slots as well.
+  bool release_dead_array_buffers = false;
+
+  // If true, the pointwise operators on DenseArrays (arithmetic, casts, math
+  // functions) write their result into the values buffer of an argument that
+  // is not read afterwards, if no other array shares that buffer. A chain of
+  // such operators on big arrays then needs no new allocations after the
+  // first one. Only the arrays computed by such operators are reused, never
+  // the inputs or the literals: they may wrap foreign, possibly read-only,
+  // memory.
+  bool reuse_dead_array_buffers = false;
+
+  // If true, the frequent pairs of scalar backend operators (math.multiply
+  // followed by math.add, a comparison followed by core.presence_and or
+  // core.where) are evaluated by a single fused operator if the intermediate
+  // result has no other readers. Saves an operator dispatch and a frame
+  // write/read per pair.
+  bool fuse_scalar_operator_pairs = false;
+
+  // If true, the sibling aggregations of the same DenseArray over the same
+  // edge (math._sum, array._count, math._min, math._max, e.g. coming from a
+  // mean and a count of one feature) are computed by a single
+  // math._group_stats call that traverses the input once. The results are not
+  // affected.
+  bool enable_group_op_fusion = false;
+
+  // If true, the pointwise arithmetic operators on a DenseArray and a scalar
+  // broadcasted by core.const_with_shape read the scalar directly, without
+  // materializing an array of its copies. Applies only to the backend
+  // operators that have such mixed overloads (math.add, math.subtract,
+  // math.multiply, math.divide, math.maximum, math.minimum on non-optional
+  // scalars). The results are not affected.
+  bool enable_scalar_broadcast_elimination = false;
+
+  // If set, the array (DenseArray, Array) literals are copied into buffers
+  // allocated by this factory during compilation, e.g. into
+  // HugePageBufferFactory for big embedding tables or dictionaries. Must
+  // remain valid during the compilation.
+  RawBufferFactory* literal_buffer_factory = nullptr;
+
+  // If set, the literals are replaced with the equal values registered in
+  // this interner during compilation, so the models embedding the same
+  // vocabularies, bucket boundaries or forests share one instance, e.g.
+  // &TypedValueInterner::GetInstance(). Ignored if `literal_buffer_factory` is
+  // set, because the literals are copied anyway. Must remain valid during the
+  // compilation.
+  TypedValueInterner* literal_interner = nullptr;
+
   // QExpr operator directory to use. Defaults to the global operator registry.
   // If other value is specified, it must remain valid until objects generated
   // by DynamicEvaluationEngine are bound by a CompiledExpr::Bind call.
@@ -75,7 +189,64 @@ struct DynamicEvaluationEngineOptions {
   // If set to true, will track node transformations
   // during expression compilation, map them to BoundOperators during binding,
   // and output the detailed trace if an error is thrown during evaluation.
+  // The trace is formatted only on error, but the bound expression keeps the
+  // compiled expression nodes alive.
   bool enable_expr_stack_trace = true;
+
+  // Machine dependent parameters used by the compiler instead of the fixed
+  // defaults: the decision forest splitting, the rows per thread of the
+  // batched forest evaluators and the FrameIterator buffer sizes of the
+  // batched forest evaluation and core.map. E.g. &GetCalibratedCostModel().
+  // CostModel::dense_sparsity_limit is a process-wide setting and is not
+  // applied. If specified, it must remain valid during the compilation.
+  const CostModel* cost_model = nullptr;
+
+  // If set, independent subexpressions of big expressions are prepared for
+  // compilation in parallel. It does not affect the compilation result, but
+  // all the node transformations (including `optimizer` and the registered
+  // compiler extensions) must be thread-safe. If specified, it must remain
+  // valid during the compilation.
+  ThreadingInterface* threading = nullptr;
+
+  // If set, the independent operators of the bound expression (e.g. several
+  // decision forests over the same inputs) are evaluated concurrently using
+  // up to GetRecommendedThreadCount() threads from `eval_threading`, the
+  // calling one included. The dependencies are derived from the frame slots
+  // the operators read and write. Prefer a pooled implementation (e.g.
+  // WorkStealingThreading): StdThreading starts new threads on every
+  // evaluation. If specified, it must remain valid while the bound expressions
+  // are in use.
+  //
+  // The expression is evaluated sequentially if parallelism would remove less
+  // than `min_parallel_eval_ops` operators from its critical path, if it
+  // contains operators with unknown slots (e.g. short circuit core.where or
+  // core.while_loop), if it is compiled with `enable_profiling`, or if it is
+  // evaluated with a buffer factory other than the heap one (e.g. an arena).
+  ThreadingInterface* eval_threading = nullptr;
+  int64_t min_parallel_eval_ops = 16;
+
+  // If set, core.map over arrays of at least `min_parallel_core_map_rows` rows
+  // applies the mapper to the rows concurrently using up to
+  // GetRecommendedThreadCount() threads from `core_map_threading`, the calling
+  // one included. The mapper is evaluated sequentially with a buffer factory
+  // other than the heap one. If specified, it must remain valid while the bound
+  // expressions are in use.
+  ThreadingInterface* core_map_threading = nullptr;
+  int64_t min_parallel_core_map_rows = 4096;
+
+  // If set, seq.reduce over sequences of at least
+  // `min_parallel_seq_reduce_size` elements with an associative reducer (see
+  // RegisterAssociativeOperator) is evaluated as a tree: blocks of the
+  // sequence are reduced concurrently using up to GetRecommendedThreadCount()
+  // threads from `seq_reduce_threading`, the calling one included, and then
+  // the block results are reduced in order starting from the initial value.
+  // Applies only if the elements, the initial value and the result have the
+  // same type. For floating point reducers like math.add the result can
+  // differ within the rounding error. The reduction is sequential with a
+  // buffer factory other than the heap one. If specified, it must remain valid
+  // while the bound expressions are in use.
+  ThreadingInterface* seq_reduce_threading = nullptr;
+  int64_t min_parallel_seq_reduce_size = 4096;
 };
 
 // Compiles the given expression for dynamic evaluation. The expression must not
@@ -88,6 +259,48 @@ absl::StatusOr<std::unique_ptr<CompiledExpr>> CompileForDynamicEvaluation(
     const absl::flat_hash_map<std::string, QTypePtr>& input_types = {},
     const absl::flat_hash_map<std::string, ExprNodePtr>& side_outputs = {});
 
+// Expression prepared for the dynamic evaluation: lowered to the backend
+// operators, optimized and annotated with qtypes.
+struct PreparedExprForDynamicEvaluation {
+  ExprNodePtr expr;
+  // Prepared side outputs sorted by name. They may share subexpressions with
+  // `expr`.
+  std::vector<std::pair<std::string, ExprNodePtr>> side_outputs;
+};
+
+// Runs the preparation stages of CompileForDynamicEvaluation (lowering,
+// optimization, type annotation...), which usually dominate the compilation
+// time. The result can be compiled by CompilePreparedForDynamicEvaluation,
+// possibly in another process (see prepared_expr_snapshot.h).
+absl::StatusOr<PreparedExprForDynamicEvaluation> PrepareForDynamicEvaluation(
+    const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
+    const absl::flat_hash_map<std::string, QTypePtr>& input_types = {},
+    const absl::flat_hash_map<std::string, ExprNodePtr>& side_outputs = {});
+
+// Compiles an expression prepared by PrepareForDynamicEvaluation, skipping the
+// preparation stages. `options` are expected to be the same as were used for
+// the preparation. The expression stack traces are not available for the
+// prepared expressions, even with options.enable_expr_stack_trace set.
+absl::StatusOr<std::unique_ptr<CompiledExpr>>
+CompilePreparedForDynamicEvaluation(
+    const DynamicEvaluationEngineOptions& options,
+    const PreparedExprForDynamicEvaluation& prepared);
+
+// Compiles several named expressions into a single program for dynamic
+// evaluation. The subexpressions shared between the roots (identified by node
+// fingerprints) are evaluated only once. The results are available as named
+// outputs of the resulting CompiledExpr (see CompiledExpr::named_output_types()
+// and BoundExpr::named_output_slots()), the main output is UNIT.
+//
+// Prefer it to compiling the expressions separately and binding them into the
+// same FrameLayout::Builder when the expressions share e.g. feature
+// computations.
+absl::StatusOr<std::unique_ptr<CompiledExpr>>
+CompileMultipleForDynamicEvaluation(
+    const DynamicEvaluationEngineOptions& options,
+    const absl::flat_hash_map<std::string, ExprNodePtr>& named_exprs,
+    const absl::flat_hash_map<std::string, QTypePtr>& input_types = {});
+
 // Compiles the given expression for dynamic evaluation and binds it to the
 // frame layout.
 absl::StatusOr<std::unique_ptr<BoundExpr>> CompileAndBindForDynamicEvaluation(
@@ -14,10 +14,12 @@
 //
 #include "arolla/expr/eval/eval.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <utility>
 
 #include "gmock/gmock.h"
@@ -29,12 +31,15 @@
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/expr/basic_expr_operator.h"
+#include "arolla/expr/eval/dynamic_compiled_expr.h"
 #include "arolla/expr/eval/executable_builder.h"
 #include "arolla/expr/eval/extensions.h"
 #include "arolla/expr/eval/invoke.h"
 #include "arolla/expr/eval/prepare_expression.h"
+#include "arolla/expr/eval/profiling.h"
 #include "arolla/expr/eval/side_output.h"
 #include "arolla/expr/eval/test_utils.h"
 #include "arolla/expr/expr.h"
@@ -52,6 +57,7 @@
 #include "arolla/memory/frame.h"
 #include "arolla/memory/memory_allocation.h"
 #include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/bound_operators.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/evaluation_engine.h"
@@ -61,11 +67,13 @@
 #include "arolla/qtype/testing/qtype.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/qtype/typed_value_interner.h"
 #include "arolla/util/fast_dynamic_downcast_final.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/text.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr {
@@ -80,8 +88,10 @@ using ::arolla::testing::WithExportAnnotation;
 using ::arolla::testing::WithNameAnnotation;
 using ::arolla::testing::WithQTypeAnnotation;
 using ::testing::_;
+using ::testing::AllOf;
 using ::testing::ElementsAre;
 using ::testing::Eq;
+using ::testing::Field;
 using ::testing::FloatEq;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
@@ -207,6 +217,376 @@ TEST_P(EvalVisitorParameterizedTest, ReusingInputSlots) {
   }
 }
 
+TEST_P(EvalVisitorParameterizedTest, ReusingDeadArrayBuffers) {
+  // (x + y) * y
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.multiply",
+             {CallOp("math.add", {Leaf("x"), Leaf("y")}), Leaf("y")}));
+  // Returns the bytes allocated by the evaluation.
+  auto eval = [&](bool reuse_dead_array_buffers) -> int64_t {
+    DynamicEvaluationEngineOptions options(options_);
+    options.reuse_dead_array_buffers = reuse_dead_array_buffers;
+    options.allow_overriding_input_slots = true;
+    FrameLayout::Builder layout_builder;
+    auto x_slot = layout_builder.AddSlot<DenseArray<float>>();
+    auto y_slot = layout_builder.AddSlot<DenseArray<float>>();
+    auto executable_expr =
+        CompileAndBindForDynamicEvaluation(options, &layout_builder, expr,
+                                           {{"x", TypedSlot::FromSlot(x_slot)},
+                                            {"y", TypedSlot::FromSlot(y_slot)}})
+            .value();
+    FrameLayout layout = std::move(layout_builder).Build();
+    AllocationTrackingBufferFactory buffer_factory;
+    RootEvaluationContext ctx(&layout, &buffer_factory);
+    CHECK_OK(executable_expr->InitializeLiterals(&ctx));
+    auto x = CreateDenseArray<float>({1.0f, 2.0f, 3.0f});
+    ctx.Set(x_slot, x);
+    x = DenseArray<float>();  // The input slot is the only owner.
+    ctx.Set(y_slot, CreateDenseArray<float>({10.0f, 20.0f, 30.0f}));
+    const float* x_data = ctx.Get(x_slot).values.span().data();
+    buffer_factory.ResetStats();
+    CHECK_OK(executable_expr->Execute(&ctx));
+    auto output_slot =
+        executable_expr->output_slot().ToSlot<DenseArray<float>>().value();
+    EXPECT_THAT(ctx.Get(output_slot), ElementsAre(110.0f, 440.0f, 990.0f));
+    // The input buffer is never written, even if uniquely owned.
+    EXPECT_NE(ctx.Get(output_slot).values.span().data(), x_data);
+    return buffer_factory.GetStats().allocated_bytes;
+  };
+  // math.multiply writes into the buffer allocated by math.add.
+  EXPECT_EQ(eval(/*reuse_dead_array_buffers=*/true),
+            eval(/*reuse_dead_array_buffers=*/false) - 3 * sizeof(float));
+}
+
+TEST_P(EvalVisitorParameterizedTest, FusingScalarOperatorPairs) {
+  // x * y + z
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {CallOp("math.multiply", {Leaf("x"), Leaf("y")}), Leaf("z")}));
+  DynamicEvaluationEngineOptions options(options_);
+  options.collect_op_descriptions = true;
+  options.fuse_scalar_operator_pairs = true;
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<float>();
+  auto y_slot = layout_builder.AddSlot<float>();
+  auto z_slot = layout_builder.AddSlot<float>();
+  ASSERT_OK_AND_ASSIGN(
+      auto executable_expr,
+      CompileAndBindForDynamicEvaluation(options, &layout_builder, expr,
+                                         {{"x", TypedSlot::FromSlot(x_slot)},
+                                          {"y", TypedSlot::FromSlot(y_slot)},
+                                          {"z", TypedSlot::FromSlot(z_slot)}}));
+  EXPECT_THAT(executable_expr,
+              AllOf(InitOperationsAre(),
+                    EvalOperationsAre(
+                        "FLOAT32 [0x0C] = math.multiply+math.add(FLOAT32 "
+                        "[0x00], FLOAT32 [0x04], FLOAT32 [0x08])")));
+  FrameLayout layout = std::move(layout_builder).Build();
+  RootEvaluationContext ctx(&layout);
+  ASSERT_OK(executable_expr->InitializeLiterals(&ctx));
+  ctx.Set(x_slot, 2.0f);
+  ctx.Set(y_slot, 10.0f);
+  ctx.Set(z_slot, 100.0f);
+  ASSERT_OK(executable_expr->Execute(&ctx));
+  ASSERT_OK_AND_ASSIGN(auto output_slot,
+                       executable_expr->output_slot().ToSlot<float>());
+  EXPECT_EQ(ctx.Get(output_slot), 120.0f);
+}
+
+TEST_P(EvalVisitorParameterizedTest, FusingGroupOperators) {
+  // math.max(x, edge) - math.min(x, edge)
+  ASSERT_OK_AND_ASSIGN(
+      auto expr, CallOp("math.subtract",
+                        {CallOp("math.max", {Leaf("x"), Leaf("edge")}),
+                         CallOp("math.min", {Leaf("x"), Leaf("edge")})}));
+  DynamicEvaluationEngineOptions options(options_);
+  options.collect_op_descriptions = true;
+  options.enable_group_op_fusion = true;
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto edge_slot = layout_builder.AddSlot<DenseArrayEdge>();
+  ASSERT_OK_AND_ASSIGN(
+      auto executable_expr,
+      CompileAndBindForDynamicEvaluation(
+          options, &layout_builder, expr,
+          {{"x", TypedSlot::FromSlot(x_slot)},
+           {"edge", TypedSlot::FromSlot(edge_slot)}}));
+  EXPECT_THAT(executable_expr,
+              EvalOperationsAre(HasSubstr("math._group_stats("),
+                                HasSubstr("math.subtract(")));
+  FrameLayout layout = std::move(layout_builder).Build();
+  RootEvaluationContext ctx(&layout);
+  ASSERT_OK(executable_expr->InitializeLiterals(&ctx));
+  ctx.Set(x_slot, CreateDenseArray<float>({1., 5., std::nullopt, 2.}));
+  ASSERT_OK_AND_ASSIGN(auto edge, DenseArrayEdge::FromSplitPoints(
+                                      CreateDenseArray<int64_t>({0, 3, 4, 4})));
+  ctx.Set(edge_slot, edge);
+  ASSERT_OK(executable_expr->Execute(&ctx));
+  ASSERT_OK_AND_ASSIGN(
+      auto output_slot,
+      executable_expr->output_slot().ToSlot<DenseArray<float>>());
+  EXPECT_THAT(ctx.Get(output_slot), ElementsAre(4.0f, 0.0f, std::nullopt));
+}
+
+TEST_P(EvalVisitorParameterizedTest, EliminatingScalarBroadcasts) {
+  // x * 2.0 + y
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {CallOp("math.multiply", {Leaf("x"), Literal(2.0f)}), Leaf("y")}));
+  DynamicEvaluationEngineOptions options(options_);
+  options.collect_op_descriptions = true;
+  options.enable_scalar_broadcast_elimination = true;
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto y_slot = layout_builder.AddSlot<float>();
+  ASSERT_OK_AND_ASSIGN(
+      auto executable_expr,
+      CompileAndBindForDynamicEvaluation(options, &layout_builder, expr,
+                                         {{"x", TypedSlot::FromSlot(x_slot)},
+                                          {"y", TypedSlot::FromSlot(y_slot)}}));
+  EXPECT_THAT(executable_expr,
+              EvalOperationsAre(
+                  AllOf(HasSubstr("math.multiply(DENSE_ARRAY_FLOAT32"),
+                        HasSubstr(", FLOAT32")),
+                  AllOf(HasSubstr("math.add(DENSE_ARRAY_FLOAT32"),
+                        HasSubstr(", FLOAT32"))));
+  FrameLayout layout = std::move(layout_builder).Build();
+  RootEvaluationContext ctx(&layout);
+  ASSERT_OK(executable_expr->InitializeLiterals(&ctx));
+  ctx.Set(x_slot, CreateDenseArray<float>({1., std::nullopt, 3.}));
+  ctx.Set(y_slot, 1.0f);
+  ASSERT_OK(executable_expr->Execute(&ctx));
+  ASSERT_OK_AND_ASSIGN(
+      auto output_slot,
+      executable_expr->output_slot().ToSlot<DenseArray<float>>());
+  EXPECT_THAT(ctx.Get(output_slot), ElementsAre(3.0f, std::nullopt, 7.0f));
+}
+
+TEST_P(EvalVisitorParameterizedTest,
+       EliminatingScalarBroadcastsKeepsSizeMismatch) {
+  // x + core.const_with_shape(core.shape_of(y), 1.0)
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {Leaf("x"),
+              CallOp("core.const_with_shape",
+                     {CallOp("core.shape_of", {Leaf("y")}), Literal(1.0f)})}));
+  DynamicEvaluationEngineOptions options(options_);
+  options.enable_scalar_broadcast_elimination = true;
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto y_slot = layout_builder.AddSlot<DenseArray<float>>();
+  ASSERT_OK_AND_ASSIGN(
+      auto executable_expr,
+      CompileAndBindForDynamicEvaluation(options, &layout_builder, expr,
+                                         {{"x", TypedSlot::FromSlot(x_slot)},
+                                          {"y", TypedSlot::FromSlot(y_slot)}}));
+  FrameLayout layout = std::move(layout_builder).Build();
+  RootEvaluationContext ctx(&layout);
+  ASSERT_OK(executable_expr->InitializeLiterals(&ctx));
+  ctx.Set(x_slot, CreateDenseArray<float>({1., std::nullopt, 3.}));
+  ctx.Set(y_slot, CreateDenseArray<float>({1., 2.}));
+  EXPECT_THAT(executable_expr->Execute(&ctx),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("argument sizes mismatch")));
+}
+
+TEST_P(EvalVisitorParameterizedTest, ReleasingDeadArrayBuffers) {
+  // (x + y) + y
+  ASSERT_OK_AND_ASSIGN(
+      auto expr, CallOp("math.add", {CallOp("math.add", {Leaf("x"), Leaf("y")}),
+                                     Leaf("y")}));
+  DynamicEvaluationEngineOptions options(options_);
+  options.release_dead_array_buffers = true;
+  auto create_input_slots = [](FrameLayout::Builder& layout_builder) {
+    return absl::flat_hash_map<std::string, TypedSlot>{
+        {"x", TypedSlot::FromSlot(layout_builder.AddSlot<DenseArray<float>>())},
+        {"y",
+         TypedSlot::FromSlot(layout_builder.AddSlot<DenseArray<float>>())}};
+  };
+
+  {
+    FrameLayout::Builder layout_builder;
+    auto input_slots = create_input_slots(layout_builder);
+    ASSERT_OK_AND_ASSIGN(auto executable_expr,
+                         CompileAndBindForDynamicEvaluation(
+                             options, &layout_builder, expr, input_slots));
+    EXPECT_THAT(
+        executable_expr,
+        AllOf(InitOperationsAre(),
+              EvalOperationsAre(
+                  "DENSE_ARRAY_FLOAT32 [0xD8] = math.add(DENSE_ARRAY_FLOAT32 "
+                  "[0x00], DENSE_ARRAY_FLOAT32 [0x48])",
+                  "DENSE_ARRAY_FLOAT32 [0x90] = math.add(DENSE_ARRAY_FLOAT32 "
+                  "[0xD8], DENSE_ARRAY_FLOAT32 [0x48])",
+                  // The intermediate result is released, the inputs are not.
+                  "internal.release_buffers(DENSE_ARRAY_FLOAT32 [0xD8])")));
+
+    FrameLayout layout = std::move(layout_builder).Build();
+    RootEvaluationContext ctx(&layout);
+    ASSERT_OK(executable_expr->InitializeLiterals(&ctx));
+    ASSERT_OK_AND_ASSIGN(auto x_slot,
+                         input_slots.at("x").ToSlot<DenseArray<float>>());
+    ASSERT_OK_AND_ASSIGN(auto y_slot,
+                         input_slots.at("y").ToSlot<DenseArray<float>>());
+    ctx.Set(x_slot, CreateDenseArray<float>({1.0f, 2.0f}));
+    ctx.Set(y_slot, CreateDenseArray<float>({10.0f, 20.0f}));
+    ASSERT_OK(executable_expr->Execute(&ctx));
+    ASSERT_OK_AND_ASSIGN(
+        auto output_slot,
+        executable_expr->output_slot().ToSlot<DenseArray<float>>());
+    EXPECT_THAT(ctx.Get(output_slot), ElementsAre(21.0f, 42.0f));
+    EXPECT_EQ(ctx.Get(x_slot).size(), 2);
+    EXPECT_EQ(ctx.Get(y_slot).size(), 2);
+  }
+  {
+    options.allow_overriding_input_slots = true;
+    FrameLayout::Builder layout_builder;
+    auto input_slots = create_input_slots(layout_builder);
+    EXPECT_THAT(
+        CompileAndBindForDynamicEvaluation(options, &layout_builder, expr,
+                                           input_slots),
+        IsOkAndHolds(AllOf(
+            InitOperationsAre(),
+            EvalOperationsAre(
+                "DENSE_ARRAY_FLOAT32 [0xD8] = math.add(DENSE_ARRAY_FLOAT32 "
+                "[0x00], DENSE_ARRAY_FLOAT32 [0x48])",
+                "internal.release_buffers(DENSE_ARRAY_FLOAT32 [0x00])",
+                "DENSE_ARRAY_FLOAT32 [0x90] = math.add(DENSE_ARRAY_FLOAT32 "
+                "[0xD8], DENSE_ARRAY_FLOAT32 [0x48])",
+                "internal.release_buffers(DENSE_ARRAY_FLOAT32 [0xD8], "
+                "DENSE_ARRAY_FLOAT32 [0x48])"))));
+  }
+}
+
+TEST_P(EvalVisitorParameterizedTest, LiteralBufferFactory) {
+  class CountingBufferFactory final : public RawBufferFactory {
+   public:
+    std::tuple<RawBufferPtr, void*> CreateRawBuffer(size_t nbytes) final {
+      ++buffer_count;
+      return GetHeapBufferFactory()->CreateRawBuffer(nbytes);
+    }
+    std::tuple<RawBufferPtr, void*> ReallocRawBuffer(
+        RawBufferPtr&& old_buffer, void* data, size_t old_size,
+        size_t new_size) final {
+      return GetHeapBufferFactory()->ReallocRawBuffer(
+          std::move(old_buffer), data, old_size, new_size);
+    }
+    int buffer_count = 0;
+  };
+
+  auto literal = CreateDenseArray<float>({10.0f, 20.0f});
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.add", {Leaf("x"), Literal(literal)}));
+  CountingBufferFactory buffer_factory;
+  DynamicEvaluationEngineOptions options(options_);
+  options.literal_buffer_factory = &buffer_factory;
+
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<DenseArray<float>>();
+  ASSERT_OK_AND_ASSIGN(auto executable_expr,
+                       CompileAndBindForDynamicEvaluation(
+                           options, &layout_builder, expr,
+                           {{"x", TypedSlot::FromSlot(x_slot)}}));
+  // The literal has no bitmap, so only the values are copied.
+  EXPECT_EQ(buffer_factory.buffer_count, 1);
+
+  FrameLayout layout = std::move(layout_builder).Build();
+  RootEvaluationContext ctx(&layout);
+  ASSERT_OK(executable_expr->InitializeLiterals(&ctx));
+  ctx.Set(x_slot, CreateDenseArray<float>({1.0f, 2.0f}));
+  ASSERT_OK(executable_expr->Execute(&ctx));
+  ASSERT_OK_AND_ASSIGN(
+      auto output_slot,
+      executable_expr->output_slot().ToSlot<DenseArray<float>>());
+  EXPECT_THAT(ctx.Get(output_slot), ElementsAre(11.0f, 22.0f));
+  EXPECT_EQ(buffer_factory.buffer_count, 1);
+}
+
+TEST_P(EvalVisitorParameterizedTest, LiteralInterner) {
+  TypedValueInterner interner;
+  DynamicEvaluationEngineOptions options(options_);
+  options.literal_interner = &interner;
+  // Returns the data of the literal in the compiled expression.
+  auto compile_literal =
+      [&](DenseArray<float> literal) -> absl::StatusOr<const float*> {
+    FrameLayout::Builder layout_builder;
+    ASSIGN_OR_RETURN(auto executable_expr,
+                     CompileAndBindForDynamicEvaluation(
+                         options, &layout_builder, Literal(std::move(literal)),
+                         {}));
+    FrameLayout layout = std::move(layout_builder).Build();
+    RootEvaluationContext ctx(&layout);
+    RETURN_IF_ERROR(executable_expr->InitializeLiterals(&ctx));
+    RETURN_IF_ERROR(executable_expr->Execute(&ctx));
+    ASSIGN_OR_RETURN(
+        auto output_slot,
+        executable_expr->output_slot().ToSlot<DenseArray<float>>());
+    return ctx.Get(output_slot).values.span().data();
+  };
+
+  auto literal = CreateDenseArray<float>({10.0f, 20.0f});
+  ASSERT_OK_AND_ASSIGN(const float* data1, compile_literal(literal));
+  auto equal_literal = CreateDenseArray<float>({10.0f, 20.0f});
+  auto other_literal = CreateDenseArray<float>({10.0f, 30.0f});
+  ASSERT_OK_AND_ASSIGN(const float* data2, compile_literal(equal_literal));
+  ASSERT_OK_AND_ASSIGN(const float* data3, compile_literal(other_literal));
+  EXPECT_EQ(data1, literal.values.span().data());
+  EXPECT_EQ(data2, data1);
+  EXPECT_NE(data3, data1);
+}
+
+TEST_P(EvalVisitorParameterizedTest, ParallelEvaluation) {
+  // Sum of 8 independent branches, each a chain of 4 operators.
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.multiply", {Leaf("x"), Leaf("y")}));
+  for (int64_t i = 1; i < 8; ++i) {
+    ASSERT_OK_AND_ASSIGN(
+        auto branch, CallOp("math.add", {Leaf("x"), Literal(int64_t{i})}));
+    for (int64_t j = 0; j < 3; ++j) {
+      ASSERT_OK_AND_ASSIGN(branch,
+                           CallOp("math.floordiv", {branch, Leaf("y")}));
+    }
+    ASSERT_OK_AND_ASSIGN(expr, CallOp("math.add", {expr, branch}));
+  }
+  WorkStealingThreading threading(4);
+  DynamicEvaluationEngineOptions options(options_);
+  options.eval_threading = &threading;
+  options.min_parallel_eval_ops = 0;
+
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<int64_t>();
+  auto y_slot = layout_builder.AddSlot<int64_t>();
+  ASSERT_OK_AND_ASSIGN(auto executable_expr,
+                       CompileAndBindForDynamicEvaluation(
+                           options, &layout_builder, expr,
+                           {{"x", TypedSlot::FromSlot(x_slot)},
+                            {"y", TypedSlot::FromSlot(y_slot)}}));
+  FrameLayout layout = std::move(layout_builder).Build();
+  RootEvaluationContext ctx(&layout);
+  ASSERT_OK(executable_expr->InitializeLiterals(&ctx));
+  ASSERT_OK_AND_ASSIGN(auto output_slot,
+                       executable_expr->output_slot().ToSlot<int64_t>());
+  for (int64_t x = 0; x < 100; ++x) {
+    ctx.Set(x_slot, x);
+    ctx.Set(y_slot, 2);
+    ASSERT_OK(executable_expr->Execute(&ctx));
+    int64_t expected = x * 2;
+    for (int64_t i = 1; i < 8; ++i) {
+      expected += (x + i) / 8;
+    }
+    EXPECT_EQ(ctx.Get(output_slot), expected);
+  }
+
+  ctx.Set(y_slot, 0);
+  EXPECT_THAT(executable_expr->Execute(&ctx),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("division by zero")));
+}
+
 // Tests that names are ignored for the evaluation.
 TEST_P(EvalVisitorParameterizedTest, NamedNodesTest) {
   constexpr int kIters = 10;
@@ -441,6 +821,60 @@ TEST_P(EvalVisitorParameterizedTest, EvalWithSideOutput) {
   EXPECT_EQ(ctx.Get(side_output_slot), 1000.0f);
 }
 
+TEST_P(EvalVisitorParameterizedTest, CompileMultiple) {
+  DynamicEvaluationEngineOptions options;
+  options.collect_op_descriptions = true;
+  ASSERT_OK_AND_ASSIGN(auto x_times_y,
+                       CallOp("math.multiply", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto head_1, CallOp("math.add", {x_times_y, Leaf("x")}));
+  ASSERT_OK_AND_ASSIGN(auto head_2,
+                       CallOp("math.subtract", {x_times_y, Leaf("y")}));
+
+  EXPECT_THAT(CompileMultipleForDynamicEvaluation(options, {}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("no expressions to compile")));
+
+  ASSERT_OK_AND_ASSIGN(
+      auto compiled_expr,
+      CompileMultipleForDynamicEvaluation(
+          options, {{"head_1", head_1}, {"head_2", head_2}},
+          {{"x", GetQType<float>()}, {"y", GetQType<float>()}}));
+  EXPECT_EQ(compiled_expr->output_type(), GetQType<Unit>());
+  EXPECT_THAT(compiled_expr->named_output_types(),
+              UnorderedElementsAre(Pair("head_1", GetQType<float>()),
+                                   Pair("head_2", GetQType<float>())));
+
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<float>();
+  auto y_slot = layout_builder.AddSlot<float>();
+  ASSERT_OK_AND_ASSIGN(
+      auto executable_expr,
+      compiled_expr->Bind(&layout_builder,
+                          {{"x", TypedSlot::FromSlot(x_slot)},
+                           {"y", TypedSlot::FromSlot(y_slot)}},
+                          /*output_slot=*/std::nullopt));
+  // The shared x * y is computed only once.
+  EXPECT_THAT(executable_expr,
+              EvalOperationsAre(HasSubstr("math.multiply"),
+                                HasSubstr("math.add"),
+                                HasSubstr("math.subtract")));
+
+  FrameLayout layout = std::move(layout_builder).Build();
+  RootEvaluationContext ctx(&layout);
+  EXPECT_OK(executable_expr->InitializeLiterals(&ctx));
+  ctx.Set(x_slot, 2.0f);
+  ctx.Set(y_slot, 10.0f);
+  EXPECT_THAT(executable_expr->Execute(&ctx), IsOk());
+  ASSERT_OK_AND_ASSIGN(
+      auto head_1_slot,
+      executable_expr->named_output_slots().at("head_1").ToSlot<float>());
+  ASSERT_OK_AND_ASSIGN(
+      auto head_2_slot,
+      executable_expr->named_output_slots().at("head_2").ToSlot<float>());
+  EXPECT_EQ(ctx.Get(head_1_slot), 22.0f);
+  EXPECT_EQ(ctx.Get(head_2_slot), 10.0f);
+}
+
 TEST_P(EvalVisitorParameterizedTest, EvalWithShortCircuit) {
   ASSERT_OK_AND_ASSIGN(
       auto expr,
@@ -1231,6 +1665,52 @@ TEST_P(EvalVisitorParameterizedTest, DetailedStackTrace) {
                     ", optional_int64{0})")));
 }
 
+TEST_P(EvalVisitorParameterizedTest, Profiling) {
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {CallOp("math.multiply", {Leaf("x"), Leaf("y")}), Leaf("y")}));
+  DynamicEvaluationEngineOptions options = options_;
+  options.enable_profiling = true;
+
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<float>();
+  auto y_slot = layout_builder.AddSlot<float>();
+  auto result_slot = layout_builder.AddSlot<float>();
+  ASSERT_OK_AND_ASSIGN(
+      auto executable_expr,
+      CompileAndBindForDynamicEvaluation(options, &layout_builder, expr,
+                                         {{"x", TypedSlot::FromSlot(x_slot)},
+                                          {"y", TypedSlot::FromSlot(y_slot)}},
+                                         TypedSlot::FromSlot(result_slot)));
+  auto* dynamic_expr =
+      dynamic_cast<const eval_internal::DynamicBoundExpr*>(
+          executable_expr.get());
+  ASSERT_NE(dynamic_expr, nullptr);
+  ASSERT_NE(dynamic_expr->profile(), nullptr);
+
+  FrameLayout layout = std::move(layout_builder).Build();
+  RootEvaluationContext ctx(&layout);
+  ctx.Set(x_slot, 2.0f);
+  ctx.Set(y_slot, 3.0f);
+  ASSERT_OK(executable_expr->InitializeLiterals(&ctx));
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(executable_expr->Execute(&ctx));
+  }
+  EXPECT_EQ(ctx.Get(result_slot), 9.0f);
+
+  EXPECT_THAT(
+      dynamic_expr->profile()->GetOperatorProfiles(),
+      ElementsAre(AllOf(Field(&OperatorProfile::display_name, "math.multiply"),
+                        Field(&OperatorProfile::call_count, 3)),
+                  AllOf(Field(&OperatorProfile::display_name, "math.add"),
+                        Field(&OperatorProfile::call_count, 3))));
+  EXPECT_THAT(dynamic_expr->profile()->FormatAsFoldedStacks(
+                  BoundExprProfile::Metric::kAllocatedBytes),
+              AllOf(HasSubstr("math.multiply 0\n"),
+                    HasSubstr("math.add 0\n")));
+}
+
 TEST_P(EvalVisitorParameterizedTest, OperatorWithoutProxy) {
   FrameLayout::Builder layout_builder;
   ASSERT_OK_AND_ASSIGN(
@@ -22,6 +22,8 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
@@ -33,9 +35,13 @@
 #include "absl/types/span.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/expr/eval/dynamic_compiled_expr.h"
+#include "arolla/expr/eval/fused_operators.h"
+#include "arolla/expr/eval/parallel_eval.h"
+#include "arolla/expr/eval/profiling.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_stack_trace.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/bound_operators.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/evaluation_engine.h"
@@ -43,6 +49,7 @@
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
 #include "arolla/util/text.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr::eval_internal {
@@ -64,32 +71,55 @@ class DynamicBoundExprImpl : public DynamicBoundExpr {
       absl::flat_hash_map<std::string, TypedSlot> named_output_slots,
       std::vector<std::string> init_op_descriptions,
       std::vector<std::string> eval_op_descriptions,
-      DenseArray<Text> op_display_names, DenseArray<Text> op_stack_traces)
+      DenseArray<Text> op_display_names,
+      std::shared_ptr<const BoundExprStackTrace> op_stack_traces,
+      std::vector<std::pair<TypedValue, TypedSlot>> literal_slots,
+      std::unique_ptr<BoundExprProfile> profile,
+      std::unique_ptr<const ParallelEvalPlan> parallel_eval_plan,
+      ThreadingInterface* eval_threading,
+      std::unique_ptr<const ExecutionTracer> tracer)
       : DynamicBoundExpr(std::move(input_slots), output_slot,
                          std::move(named_output_slots)),
         init_ops_(std::move(init_ops)),
         eval_ops_(std::move(eval_ops)),
+        packed_eval_ops_(eval_ops_),
         init_op_descriptions_(std::move(init_op_descriptions)),
         eval_op_descriptions_(std::move(eval_op_descriptions)),
         op_display_names_(std::move(op_display_names)),
-        op_stack_traces_(std::move(op_stack_traces)) {}
+        op_stack_traces_(std::move(op_stack_traces)),
+        literal_slots_(std::move(literal_slots)),
+        profile_(std::move(profile)),
+        parallel_eval_plan_(std::move(parallel_eval_plan)),
+        eval_threading_(eval_threading),
+        tracer_(std::move(tracer)) {}
 
   void InitializeLiterals(EvaluationContext* ctx, FramePtr frame) const final {
     RunBoundOperators(init_ops_, ctx, frame);
   }
 
   void Execute(EvaluationContext* ctx, FramePtr frame) const final {
-    int64_t last_ip = RunBoundOperators(eval_ops_, ctx, frame);
+    int64_t last_ip;
+    if (ABSL_PREDICT_FALSE(tracer_ != nullptr && tracer_->ShouldSample())) {
+      // The sampled evaluations are traced sequentially.
+      last_ip = tracer_->Run(eval_ops_, ctx, frame);
+    } else if (parallel_eval_plan_ != nullptr &&
+               &ctx->buffer_factory() == GetHeapBufferFactory()) {
+      // The parallel evaluation requires a thread-safe buffer factory, so it
+      // is not used e.g. with an arena.
+      last_ip =
+          parallel_eval_plan_->Run(*eval_threading_, eval_ops_, ctx, frame);
+    } else {
+      last_ip = packed_eval_ops_.Run(ctx, frame);
+    }
     if (!ctx->status().ok()) {
       RETURN_IF_ERROR(std::move(*ctx).status()).With([&](auto status_builder)
       {
         DCHECK_LT(last_ip, op_display_names_.size());
         status_builder << "during evaluation of operator "
           << op_display_names_[last_ip].AsOptional().value_or("");
-      if (!op_stack_traces_.empty()) {
+      if (op_stack_traces_ != nullptr) {
         status_builder << "\n"
-                       <<
-                       op_stack_traces_[last_ip].AsOptional().value_or("");
+                       << op_stack_traces_->FullTrace(last_ip).value_or("");
       }
         ctx->set_status(absl::Status(status_builder));
       });
@@ -102,16 +132,46 @@ class DynamicBoundExprImpl : public DynamicBoundExpr {
   absl::Span<const std::string> eval_op_descriptions() const final {
     return eval_op_descriptions_;
   }
+  absl::Span<const std::pair<TypedValue, TypedSlot>> literal_slots()
+      const final {
+    return literal_slots_;
+  }
+  bool initializes_only_literal_slots() const final {
+    // All the literals are initialized by a single operator, see Build().
+    return init_ops_.size() == (literal_slots_.empty() ? 0 : 1);
+  }
+  absl::Nullable<BoundExprProfile*> profile() const final {
+    return profile_.get();
+  }
+  int64_t operators_memory_usage() const final {
+    int64_t result = 0;
+    for (const auto* ops : {&init_ops_, &eval_ops_}) {
+      for (const auto& op : *ops) {
+        result += op->EstimateMemoryUsage();
+      }
+    }
+    return result;
+  }
 
  private:
   std::vector<std::unique_ptr<BoundOperator>> init_ops_;
   std::vector<std::unique_ptr<BoundOperator>> eval_ops_;
+  // Refers to eval_ops_, see PackedBoundOperators.
+  PackedBoundOperators packed_eval_ops_;
   std::vector<std::string> init_op_descriptions_;
   std::vector<std::string> eval_op_descriptions_;
   // Using DenseArray<Text> instead of std::vector<std::string> to reduce
   // standby memory usage.
   DenseArray<Text> op_display_names_;
-  DenseArray<Text> op_stack_traces_;
+  // The stack traces are formatted only on error. Null if the stack traces are
+  // disabled.
+  std::shared_ptr<const BoundExprStackTrace> op_stack_traces_;
+  std::vector<std::pair<TypedValue, TypedSlot>> literal_slots_;
+  std::unique_ptr<BoundExprProfile> profile_;
+  std::unique_ptr<const ParallelEvalPlan> parallel_eval_plan_;
+  ThreadingInterface* eval_threading_;  // Not owned. Set if the plan is set.
+  // Null if the execution tracing is disabled.
+  std::unique_ptr<const ExecutionTracer> tracer_;
 };
 
 absl::Status VerifyNoNulls(
@@ -145,14 +205,32 @@ std::string FormatOperatorCall(absl::string_view op_name,
 
 ExecutableBuilder::ExecutableBuilder(
     FrameLayout::Builder* layout_builder, bool collect_op_descriptions,
-    std::shared_ptr<const ExprStackTrace> stack_trace)
+    std::shared_ptr<const ExprStackTrace> stack_trace, bool enable_profiling,
+    bool profile_perf_counters)
     : layout_builder_(layout_builder),
-      collect_op_descriptions_(collect_op_descriptions) {
+      collect_op_descriptions_(collect_op_descriptions),
+      enable_profiling_(enable_profiling),
+      profile_perf_counters_(profile_perf_counters) {
   if (stack_trace != nullptr) {
     stack_trace_builder_ = BoundExprStackTraceBuilder(stack_trace);
   }
 }
 
+void ExecutableBuilder::EnableParallelEvaluation(ThreadingInterface* threading,
+                                                 int64_t min_parallel_ops) {
+  DCHECK(eval_ops_.empty());
+  eval_threading_ = threading;
+  min_parallel_ops_ = min_parallel_ops;
+}
+
+void ExecutableBuilder::EnableExecutionTracing(ExecutionTraceSink* sink,
+                                               int64_t sampling_period) {
+  DCHECK(eval_ops_.empty());
+  DCHECK(sink != nullptr);
+  trace_sink_ = sink;
+  trace_sampling_period_ = sampling_period;
+}
+
 absl::Status ExecutableBuilder::AddLiteralInitialization(
     const TypedValue& literal_value, TypedSlot output_slot) {
   if (literal_value.GetType() != output_slot.GetType()) {
@@ -180,8 +258,52 @@ absl::StatusOr<int64_t> ExecutableBuilder::BindEvalOp(
   if (collect_op_descriptions_) {
     description = FormatOperatorCall(op.name(), input_slots, {output_slot});
   }
-  return AddEvalOp(std::move(bound_op), std::move(description),
-                   std::string(op.name()));
+  int64_t ip = AddEvalOp(std::move(bound_op), std::move(description),
+                         std::string(op.name()));
+  DeclareEvalOpSlots(ip, input_slots, {output_slot});
+  last_bound_eval_op_ = BoundEvalOp{
+      .ip = ip,
+      .op_name = std::string(op.name()),
+      .input_slots = std::vector(input_slots.begin(), input_slots.end()),
+      .output_slot = output_slot};
+  return ip;
+}
+
+absl::StatusOr<int64_t> ExecutableBuilder::BindFusedEvalOp(
+    const QExprOperator& op, absl::Span<const TypedSlot> input_slots,
+    size_t fused_arg, TypedSlot output_slot) {
+  DCHECK_LT(fused_arg, input_slots.size());
+  if (!last_bound_eval_op_.has_value() ||
+      last_bound_eval_op_->ip + 1 != eval_ops_.size() ||
+      last_bound_eval_op_->output_slot != input_slots[fused_arg]) {
+    return BindEvalOp(op, input_slots, output_slot);
+  }
+  BoundEvalOp first = *std::move(last_bound_eval_op_);
+  std::vector<TypedSlot> fused_input_slots = first.input_slots;
+  for (size_t i = 0; i < input_slots.size(); ++i) {
+    if (i == fused_arg) {
+      continue;
+    }
+    if (input_slots[i] == input_slots[fused_arg]) {
+      return BindEvalOp(op, input_slots, output_slot);
+    }
+    fused_input_slots.push_back(input_slots[i]);
+  }
+  auto fused_op = MakeFusedOperator(first.op_name, op.name(), fused_arg,
+                                    fused_input_slots, output_slot);
+  if (fused_op == nullptr) {
+    return BindEvalOp(op, input_slots, output_slot);
+  }
+  std::string display_name = absl::StrCat(first.op_name, "+", op.name());
+  if (collect_op_descriptions_) {
+    eval_op_descriptions_[first.ip] =
+        FormatOperatorCall(display_name, fused_input_slots, {output_slot});
+  }
+  eval_ops_[first.ip] = std::move(fused_op);
+  op_display_names_[first.ip] = std::move(display_name);
+  DeclareEvalOpSlots(first.ip, fused_input_slots, {output_slot});
+  last_bound_eval_op_.reset();
+  return first.ip;
 }
 
 int64_t ExecutableBuilder::AddInitOp(std::unique_ptr<BoundOperator> op,
@@ -201,9 +323,28 @@ int64_t ExecutableBuilder::AddEvalOp(std::unique_ptr<BoundOperator> op,
   }
   eval_ops_.push_back(std::move(op));
   op_display_names_.push_back(std::move(display_name));
+  if (collect_eval_op_slots()) {
+    eval_op_slots_.emplace_back();
+  }
+  // The operator can be a jump or a branch, so the next operator must not be
+  // fused with the previous one.
+  last_bound_eval_op_.reset();
   return eval_ops_.size() - 1;
 }
 
+void ExecutableBuilder::DeclareEvalOpSlots(
+    int64_t ip, absl::Span<const TypedSlot> input_slots,
+    absl::Span<const TypedSlot> output_slots) {
+  if (!collect_eval_op_slots()) {
+    return;
+  }
+  DCHECK_GE(ip, 0);
+  DCHECK_LT(ip, eval_op_slots_.size());
+  eval_op_slots_[ip] = EvalOpSlots{
+      .inputs = std::vector(input_slots.begin(), input_slots.end()),
+      .outputs = std::vector(output_slots.begin(), output_slots.end())};
+}
+
 int64_t ExecutableBuilder::SkipEvalOp() { return AddEvalOp(nullptr, "", ""); }
 
 absl::Status ExecutableBuilder::SetEvalOp(int64_t offset,
@@ -225,6 +366,12 @@ absl::Status ExecutableBuilder::SetEvalOp(int64_t offset,
   }
   eval_ops_[offset] = std::move(op);
   op_display_names_[offset] = std::move(display_name);
+  if (collect_eval_op_slots()) {
+    eval_op_slots_[offset] = std::nullopt;
+  }
+  // A jump to the end of the sequence can skip the previous operator, so the
+  // next one must not be fused with it.
+  last_bound_eval_op_.reset();
   return absl::OkStatus();
 }
 
@@ -253,7 +400,7 @@ std::unique_ptr<BoundExpr> ExecutableBuilder::Build(
       init_literals_description_.pop_back();
     }
     AddInitOp(MakeBoundOperator(
-                  [values_and_slots = std::move(literal_values_and_slots_)](
+                  [values_and_slots = literal_values_and_slots_](
                       EvaluationContext* ctx, FramePtr frame) {
                     for (const auto& [value, slot] : values_and_slots) {
                       auto ref = value.AsRef();
@@ -267,9 +414,47 @@ std::unique_ptr<BoundExpr> ExecutableBuilder::Build(
   DCHECK_OK(VerifyNoNulls(init_ops_));
   DCHECK_OK(VerifyNoNulls(eval_ops_));
 
-  DenseArray<Text> stack_trace;
+  std::shared_ptr<const BoundExprStackTrace> stack_trace;
   if (stack_trace_builder_.has_value()) {
-    stack_trace = stack_trace_builder_->Build(eval_ops_.size());
+    stack_trace = std::move(*stack_trace_builder_).BuildLazy();
+  }
+  std::unique_ptr<BoundExprProfile> profile;
+  if (enable_profiling_) {
+    std::vector<std::string> op_stack_traces;
+    if (stack_trace != nullptr) {
+      op_stack_traces.reserve(eval_ops_.size());
+      for (int64_t i = 0; i < eval_ops_.size(); ++i) {
+        op_stack_traces.emplace_back(stack_trace->FullTrace(i).value_or(""));
+      }
+    }
+    profile = std::make_unique<BoundExprProfile>(
+        op_display_names_, std::move(op_stack_traces), profile_perf_counters_);
+    for (size_t i = 0; i < eval_ops_.size(); ++i) {
+      eval_ops_[i] = profile->WrapOperator(i, std::move(eval_ops_[i]));
+    }
+  }
+  // The profiling wrappers are not thread-safe, so the profiled programs are
+  // always evaluated sequentially.
+  std::unique_ptr<const ParallelEvalPlan> parallel_eval_plan;
+  ThreadingInterface* eval_threading = nullptr;
+  if (eval_threading_ != nullptr && !enable_profiling_) {
+    parallel_eval_plan =
+        ParallelEvalPlan::Create(eval_op_slots_, min_parallel_ops_);
+    if (parallel_eval_plan != nullptr) {
+      eval_threading = eval_threading_;
+    }
+  }
+  std::unique_ptr<const ExecutionTracer> tracer;
+  if (trace_sink_ != nullptr) {
+    std::vector<std::vector<TypedSlot>> output_slots(eval_ops_.size());
+    for (size_t i = 0; i < eval_ops_.size(); ++i) {
+      if (eval_op_slots_[i].has_value()) {
+        output_slots[i] = eval_op_slots_[i]->outputs;
+      }
+    }
+    tracer = std::make_unique<ExecutionTracer>(
+        trace_sink_, trace_sampling_period_, op_display_names_,
+        std::move(output_slots));
   }
   return std::make_unique<DynamicBoundExprImpl>(
       input_slots, output_slot, std::move(init_ops_), std::move(eval_ops_),
@@ -277,7 +462,9 @@ std::unique_ptr<BoundExpr> ExecutableBuilder::Build(
       std::move(eval_op_descriptions_),
       CreateFullDenseArray<Text>(op_display_names_.begin(),
                                  op_display_names_.end()),
-      std::move(stack_trace));
+      std::move(stack_trace), std::move(literal_values_and_slots_),
+      std::move(profile), std::move(parallel_eval_plan), eval_threading,
+      std::move(tracer));
 }
 
 }  // namespace arolla::expr::eval_internal
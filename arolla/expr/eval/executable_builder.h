@@ -15,6 +15,7 @@
 #ifndef AROLLA_EXPR_EVAL_EXECUTABLE_BUILDER_H_
 #define AROLLA_EXPR_EVAL_EXECUTABLE_BUILDER_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -27,6 +28,8 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "arolla/expr/eval/parallel_eval.h"
+#include "arolla/expr/eval/profiling.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_stack_trace.h"
 #include "arolla/memory/frame.h"
@@ -34,6 +37,7 @@
 #include "arolla/qexpr/operators.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/util/threading.h"
 
 namespace arolla::expr::eval_internal {
 
@@ -52,10 +56,29 @@ class ExecutableBuilder {
       // Populate the init_op_descriptions() / eval_op_descriptions() in the
       // generated DynamicBoundExpr.
       bool collect_op_descriptions = false,
-      std::shared_ptr<const ExprStackTrace> stack_trace = nullptr);
+      std::shared_ptr<const ExprStackTrace> stack_trace = nullptr,
+      // Wrap the eval operators to collect BoundExprProfile for the generated
+      // DynamicBoundExpr.
+      bool enable_profiling = false,
+      // Collect the hardware performance counters in the BoundExprProfile.
+      // Only with enable_profiling.
+      bool profile_perf_counters = false);
 
   FrameLayout::Builder* layout_builder() const { return layout_builder_; }
 
+  // Enables concurrent evaluation of the independent eval operators using
+  // `threading` (see DynamicEvaluationEngineOptions::eval_threading). Must be
+  // called before adding eval operators.
+  void EnableParallelEvaluation(ThreadingInterface* threading,
+                                int64_t min_parallel_ops);
+
+  // Makes one in `sampling_period` evaluations of the generated
+  // DynamicBoundExpr report an ExecutionTrace to `sink` (see
+  // DynamicEvaluationEngineOptions::trace_sink). Must be called before adding
+  // eval operators.
+  void EnableExecutionTracing(ExecutionTraceSink* sink,
+                              int64_t sampling_period);
+
   // Adds literal initialization command.
   absl::Status AddLiteralInitialization(const TypedValue& literal_value,
                                         TypedSlot output_slot);
@@ -65,6 +88,17 @@ class ExecutableBuilder {
                                      absl::Span<const TypedSlot> input_slots,
                                      TypedSlot output_slot);
 
+  // Same as BindEvalOp, but if the last added eval operator was bound by
+  // BindEvalOp to compute `input_slots[fused_arg]`, replaces it with an
+  // operator computing both (see fused_operators.h), so the intermediate result
+  // is not stored in the frame. The caller must guarantee that
+  // `input_slots[fused_arg]` is not read by any other operator. Falls back to
+  // BindEvalOp if the pair cannot be fused, or if any operator (e.g. a jump)
+  // was added or placed by AddEvalOp / SkipEvalOp / SetEvalOp since then.
+  absl::StatusOr<int64_t> BindFusedEvalOp(
+      const QExprOperator& op, absl::Span<const TypedSlot> input_slots,
+      size_t fused_arg, TypedSlot output_slot);
+
   // Appends the operator for program initialization. If collect_op_descriptions
   // was true, the `description` will be recorded.
   int64_t AddInitOp(std::unique_ptr<BoundOperator> op, std::string description);
@@ -74,6 +108,14 @@ class ExecutableBuilder {
   int64_t AddEvalOp(std::unique_ptr<BoundOperator> op, std::string description,
                     std::string display_name);
 
+  // Declares the slots read and written by the eval operator at position `ip`.
+  // Called automatically by BindEvalOp. If parallel evaluation is enabled, the
+  // program is evaluated sequentially unless the slots are declared for all
+  // the eval operators. The execution traces report the array sizes only for
+  // the declared output slots.
+  void DeclareEvalOpSlots(int64_t ip, absl::Span<const TypedSlot> input_slots,
+                          absl::Span<const TypedSlot> output_slots);
+
   // Skips one operator, returning its position so it can be placed later.
   int64_t SkipEvalOp();
 
@@ -103,12 +145,34 @@ class ExecutableBuilder {
   absl::flat_hash_map<std::string, TypedSlot> named_outputs_;
 
   bool collect_op_descriptions_;
+  bool enable_profiling_;
+  bool profile_perf_counters_;
   std::vector<std::string> init_op_descriptions_;
   std::vector<std::string> eval_op_descriptions_;
   std::vector<std::string> op_display_names_;
   std::vector<std::pair<TypedValue, TypedSlot>> literal_values_and_slots_;
   std::string init_literals_description_;
   std::optional<BoundExprStackTraceBuilder> stack_trace_builder_;
+
+  // The last operator bound by BindEvalOp, used by BindFusedEvalOp.
+  struct BoundEvalOp {
+    int64_t ip;
+    std::string op_name;
+    std::vector<TypedSlot> input_slots;
+    TypedSlot output_slot;
+  };
+  std::optional<BoundEvalOp> last_bound_eval_op_;
+
+  bool collect_eval_op_slots() const {
+    return eval_threading_ != nullptr || trace_sink_ != nullptr;
+  }
+
+  ThreadingInterface* eval_threading_ = nullptr;
+  int64_t min_parallel_ops_ = 0;
+  ExecutionTraceSink* trace_sink_ = nullptr;
+  int64_t trace_sampling_period_ = 0;
+  // Populated only if collect_eval_op_slots().
+  std::vector<std::optional<EvalOpSlots>> eval_op_slots_;
 };
 
 }  // namespace arolla::expr::eval_internal
@@ -16,11 +16,18 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/eval/dynamic_compiled_expr.h"
+#include "arolla/expr/eval/profiling.h"
 #include "arolla/expr/eval/test_utils.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/memory_allocation.h"
@@ -32,6 +39,7 @@
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
 #include "arolla/util/init_arolla.h"
+#include "arolla/util/perf_counters.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 
 namespace arolla::expr::eval_internal {
@@ -39,8 +47,11 @@ namespace {
 
 using ::arolla::testing::IsOk;
 using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::StartsWith;
 
 class ExecutableBuilderTest : public ::testing::Test {
  protected:
@@ -171,5 +182,247 @@ TEST_F(ExecutableBuilderTest, ExecuteWithError) {
                HasSubstr("foo; during evaluation of operator error_operator")));
 }
 
+TEST_F(ExecutableBuilderTest, Profiling) {
+  FrameLayout::Builder layout_builder;
+  FrameLayout::Slot<int32_t> x_slot = layout_builder.AddSlot<int32_t>();
+
+  ExecutableBuilder builder(&layout_builder, /*collect_op_descriptions=*/false,
+                            /*stack_trace=*/nullptr,
+                            /*enable_profiling=*/true);
+  builder.AddEvalOp(
+      MakeBoundOperator([x_slot](EvaluationContext* ctx, FramePtr frame) {
+        frame.Set(x_slot, frame.Get(x_slot) + 1);
+      }),
+      "inc", "inc");
+  builder.AddEvalOp(
+      MakeBoundOperator([](EvaluationContext* ctx, FramePtr frame) {
+        ctx->buffer_factory().CreateRawBuffer(100);
+      }),
+      "alloc", "alloc");
+  builder.AddEvalOp(
+      MakeBoundOperator([](EvaluationContext* ctx, FramePtr frame) {
+        // Skip the next operator.
+        ctx->set_requested_jump(1);
+      }),
+      "jump", "jump;1");
+  builder.AddEvalOp(
+      MakeBoundOperator([](EvaluationContext* ctx, FramePtr frame) {
+        ctx->set_status(absl::InvalidArgumentError("skipped"));
+      }),
+      "skipped", "skipped");
+  builder.AddEvalOp(
+      MakeBoundOperator([](EvaluationContext* ctx, FramePtr frame) {
+        ctx->set_status(absl::InvalidArgumentError("foo"));
+      }),
+      "error_operator", "error_operator");
+
+  auto bound_expr = std::move(builder).Build({}, TypedSlot::FromSlot(x_slot));
+  auto* dynamic_bound_expr = dynamic_cast<DynamicBoundExpr*>(bound_expr.get());
+  ASSERT_NE(dynamic_bound_expr, nullptr);
+  BoundExprProfile* profile = dynamic_bound_expr->profile();
+  ASSERT_NE(profile, nullptr);
+
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  for (int i = 0; i < 2; ++i) {
+    EvaluationContext ctx;
+    dynamic_bound_expr->Execute(&ctx, alloc.frame());
+    EXPECT_THAT(
+        ctx.status(),
+        StatusIs(absl::StatusCode::kInvalidArgument,
+                 HasSubstr("foo; during evaluation of operator "
+                           "error_operator")));
+  }
+  EXPECT_THAT(alloc.frame().Get(x_slot), Eq(2));
+
+  auto profiles = profile->GetOperatorProfiles();
+  ASSERT_EQ(profiles.size(), 5);
+  EXPECT_EQ(profiles[0].display_name, "inc");
+  EXPECT_EQ(profiles[0].call_count, 2);
+  EXPECT_EQ(profiles[0].allocated_bytes, 0);
+  EXPECT_EQ(profiles[1].call_count, 2);
+  EXPECT_EQ(profiles[1].allocated_bytes, 200);
+  EXPECT_EQ(profiles[1].allocation_count, 2);
+  EXPECT_EQ(profiles[2].call_count, 2);
+  EXPECT_EQ(profiles[3].call_count, 0);
+  EXPECT_EQ(profiles[4].call_count, 2);
+
+  EXPECT_EQ(
+      profile->FormatAsFoldedStacks(BoundExprProfile::Metric::kAllocatedBytes),
+      "inc 0\n"
+      "alloc 200\n"
+      "jump,1 0\n"
+      "error_operator 0\n");
+  EXPECT_EQ(
+      profile->FormatAsFoldedStacks(BoundExprProfile::Metric::kAllocationCount),
+      "inc 0\n"
+      "alloc 2\n"
+      "jump,1 0\n"
+      "error_operator 0\n");
+
+  profile->Reset();
+  EXPECT_EQ(profile->GetOperatorProfiles()[1].call_count, 0);
+  EXPECT_EQ(profile->FormatAsFoldedStacks(), "");
+}
+
+TEST_F(ExecutableBuilderTest, ProfilingPerfCounters) {
+  FrameLayout::Builder layout_builder;
+  FrameLayout::Slot<int64_t> x_slot = layout_builder.AddSlot<int64_t>();
+
+  ExecutableBuilder builder(&layout_builder, /*collect_op_descriptions=*/false,
+                            /*stack_trace=*/nullptr,
+                            /*enable_profiling=*/true,
+                            /*profile_perf_counters=*/true);
+  builder.AddEvalOp(
+      MakeBoundOperator([x_slot](EvaluationContext* ctx, FramePtr frame) {
+        volatile int64_t x = frame.Get(x_slot);
+        for (int i = 0; i < 100000; ++i) {
+          x = x + i;
+        }
+        frame.Set(x_slot, x);
+      }),
+      "loop", "loop");
+
+  auto bound_expr = std::move(builder).Build({}, TypedSlot::FromSlot(x_slot));
+  auto* dynamic_bound_expr = dynamic_cast<DynamicBoundExpr*>(bound_expr.get());
+  ASSERT_NE(dynamic_bound_expr, nullptr);
+  BoundExprProfile* profile = dynamic_bound_expr->profile();
+  ASSERT_NE(profile, nullptr);
+
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  EvaluationContext ctx;
+  dynamic_bound_expr->Execute(&ctx, alloc.frame());
+  ASSERT_OK(ctx.status());
+
+  auto profiles = profile->GetOperatorProfiles();
+  ASSERT_EQ(profiles.size(), 1);
+  EXPECT_EQ(profiles[0].call_count, 1);
+  if (PerfCountersAvailable()) {
+    EXPECT_GT(profiles[0].perf_counters.cycles, 0);
+    EXPECT_GT(profiles[0].perf_counters.instructions, 100000);
+  } else {
+    EXPECT_EQ(profiles[0].perf_counters.cycles, 0);
+    EXPECT_EQ(profiles[0].perf_counters.instructions, 0);
+  }
+  EXPECT_THAT(
+      profile->FormatAsFoldedStacks(BoundExprProfile::Metric::kInstructions),
+      StartsWith("loop "));
+}
+
+TEST_F(ExecutableBuilderTest, NoProfilingByDefault) {
+  FrameLayout::Builder layout_builder;
+  FrameLayout::Slot<int32_t> x_slot = layout_builder.AddSlot<int32_t>();
+  ExecutableBuilder builder(&layout_builder);
+  builder.AddEvalOp(Noop(), "noop", "noop");
+  auto bound_expr = std::move(builder).Build({}, TypedSlot::FromSlot(x_slot));
+  auto* dynamic_bound_expr = dynamic_cast<DynamicBoundExpr*>(bound_expr.get());
+  ASSERT_NE(dynamic_bound_expr, nullptr);
+  EXPECT_EQ(dynamic_bound_expr->profile(), nullptr);
+}
+
+class ExecutionTraceCollector final : public ExecutionTraceSink {
+ public:
+  struct Trace {
+    std::vector<std::string> display_names;
+    std::vector<std::vector<int64_t>> output_array_sizes;
+    absl::Status status;
+  };
+
+  void Record(const ExecutionTrace& trace) final {
+    Trace& result = traces.emplace_back();
+    for (const auto& op : trace.operators) {
+      result.display_names.emplace_back(op.display_name);
+      result.output_array_sizes.push_back(op.output_array_sizes);
+    }
+    result.status = trace.status;
+  }
+
+  std::vector<Trace> traces;
+};
+
+TEST_F(ExecutableBuilderTest, ExecutionTracing) {
+  FrameLayout::Builder layout_builder;
+  FrameLayout::Slot<int32_t> x_slot = layout_builder.AddSlot<int32_t>();
+  auto array_slot = layout_builder.AddSlot<DenseArray<float>>();
+
+  ExecutionTraceCollector sink;
+  ExecutableBuilder builder(&layout_builder);
+  builder.EnableExecutionTracing(&sink, /*sampling_period=*/1);
+  int64_t ip = builder.AddEvalOp(
+      MakeBoundOperator([array_slot](EvaluationContext* ctx, FramePtr frame) {
+        frame.Set(array_slot, CreateDenseArray<float>({1.0f, std::nullopt}));
+      }),
+      "make_array", "make_array");
+  builder.DeclareEvalOpSlots(ip, {}, {TypedSlot::FromSlot(array_slot)});
+  builder.AddEvalOp(
+      MakeBoundOperator([x_slot](EvaluationContext* ctx, FramePtr frame) {
+        frame.Set(x_slot, frame.Get(x_slot) + 1);
+      }),
+      "inc", "inc");
+  builder.AddEvalOp(
+      MakeBoundOperator([](EvaluationContext* ctx, FramePtr frame) {
+        ctx->set_requested_jump(1);
+      }),
+      "jump", "jump");
+  builder.AddEvalOp(
+      MakeBoundOperator([](EvaluationContext* ctx, FramePtr frame) {
+        ctx->set_status(absl::InvalidArgumentError("skipped"));
+      }),
+      "skipped", "skipped");
+  builder.AddEvalOp(
+      MakeBoundOperator([](EvaluationContext* ctx, FramePtr frame) {
+        ctx->set_status(absl::InvalidArgumentError("foo"));
+      }),
+      "error_operator", "error_operator");
+
+  auto bound_expr = std::move(builder).Build({}, TypedSlot::FromSlot(x_slot));
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  EvaluationContext ctx;
+  bound_expr->Execute(&ctx, alloc.frame());
+  EXPECT_THAT(ctx.status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("foo; during evaluation of operator "
+                                 "error_operator")));
+  EXPECT_THAT(alloc.frame().Get(x_slot), Eq(1));
+
+  ASSERT_EQ(sink.traces.size(), 1);
+  EXPECT_THAT(sink.traces[0].display_names,
+              ElementsAre("make_array", "inc", "jump", "error_operator"));
+  EXPECT_THAT(sink.traces[0].output_array_sizes,
+              ElementsAre(ElementsAre(2), IsEmpty(), IsEmpty(), IsEmpty()));
+  EXPECT_THAT(sink.traces[0].status,
+              StatusIs(absl::StatusCode::kInvalidArgument, "foo"));
+}
+
+TEST_F(ExecutableBuilderTest, ExecutionTracingSampling) {
+  FrameLayout::Builder layout_builder;
+  FrameLayout::Slot<int32_t> x_slot = layout_builder.AddSlot<int32_t>();
+
+  ExecutionTraceCollector sink;
+  ExecutableBuilder builder(&layout_builder);
+  builder.EnableExecutionTracing(&sink, /*sampling_period=*/10);
+  builder.AddEvalOp(
+      MakeBoundOperator([x_slot](EvaluationContext* ctx, FramePtr frame) {
+        frame.Set(x_slot, frame.Get(x_slot) + 1);
+      }),
+      "inc", "inc");
+
+  auto bound_expr = std::move(builder).Build({}, TypedSlot::FromSlot(x_slot));
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  constexpr int kEvaluations = 10000;
+  for (int i = 0; i < kEvaluations; ++i) {
+    EvaluationContext ctx;
+    bound_expr->Execute(&ctx, alloc.frame());
+    ASSERT_OK(ctx.status());
+  }
+  // The traced and the untraced evaluations give the same results.
+  EXPECT_EQ(alloc.frame().Get(x_slot), kEvaluations);
+  EXPECT_GT(sink.traces.size(), kEvaluations / 20);
+  EXPECT_LT(sink.traces.size(), kEvaluations / 5);
+}
+
 }  // namespace
 }  // namespace arolla::expr::eval_internal
@@ -0,0 +1,265 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/fused_operators.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/bound_operators.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qexpr/operators/core/logic_operators.h"
+#include "arolla/qtype/base_types.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/meta.h"
+
+namespace arolla::expr::eval_internal {
+namespace {
+
+template <typename T>
+bool IsPresent(const T&) {
+  return true;
+}
+template <typename T>
+bool IsPresent(const OptionalValue<T>& v) {
+  return v.present;
+}
+
+template <typename T>
+const T& GetValue(const T& v) {
+  return v;
+}
+template <typename T>
+const T& GetValue(const OptionalValue<T>& v) {
+  return v.value;
+}
+
+template <typename... Ts>
+constexpr bool kAnyOptional = (is_optional_v<Ts> || ...);
+
+// math.add(math.multiply(a, b), c), or math.add(c, math.multiply(a, b)) if
+// kProductIsLhs is false.
+template <typename A, typename B, typename C, bool kProductIsLhs>
+struct MultiplyAddOp {
+  using T = strip_optional_t<A>;
+  using Output = std::conditional_t<kAnyOptional<A, B, C>, OptionalValue<T>, T>;
+
+  static std::vector<QTypePtr> InputQTypes() {
+    return {GetQType<A>(), GetQType<B>(), GetQType<C>()};
+  }
+
+  static MultiplyAddOp Bind(absl::Span<const TypedSlot> input_slots,
+                            TypedSlot output_slot) {
+    return {input_slots[0].UnsafeToSlot<A>(), input_slots[1].UnsafeToSlot<B>(),
+            input_slots[2].UnsafeToSlot<C>(),
+            output_slot.UnsafeToSlot<Output>()};
+  }
+
+  void operator()(EvaluationContext*, FramePtr frame) const {
+    const A& a = frame.Get(a_slot);
+    const B& b = frame.Get(b_slot);
+    const C& c = frame.Get(c_slot);
+    // The product is rounded before the addition, as in the unfused
+    // operators: a contraction into FMA would change the results.
+    volatile T product = GetValue(a) * GetValue(b);
+    T result = kProductIsLhs ? product + GetValue(c) : GetValue(c) + product;
+    if constexpr (is_optional_v<Output>) {
+      frame.Set(output_slot, IsPresent(a) && IsPresent(b) && IsPresent(c)
+                                 ? Output(result)
+                                 : Output());
+    } else {
+      frame.Set(output_slot, result);
+    }
+  }
+
+  FrameLayout::Slot<A> a_slot;
+  FrameLayout::Slot<B> b_slot;
+  FrameLayout::Slot<C> c_slot;
+  FrameLayout::Slot<Output> output_slot;
+};
+
+// Evaluates a (lifted to optional) mask comparison operator.
+template <typename CompareOp, typename A, typename B>
+bool Compare(const A& a, const B& b) {
+  return IsPresent(a) && IsPresent(b) &&
+         CompareOp()(GetValue(a), GetValue(b)).present;
+}
+
+// core.presence_and(x, compare(a, b)).
+template <typename CompareOp, typename A, typename B, typename X>
+struct ComparePresenceAndOp {
+  using Output = wrap_with_optional_t<X>;
+
+  static std::vector<QTypePtr> InputQTypes() {
+    return {GetQType<A>(), GetQType<B>(), GetQType<X>()};
+  }
+
+  static ComparePresenceAndOp Bind(absl::Span<const TypedSlot> input_slots,
+                                   TypedSlot output_slot) {
+    return {input_slots[0].UnsafeToSlot<A>(), input_slots[1].UnsafeToSlot<B>(),
+            input_slots[2].UnsafeToSlot<X>(),
+            output_slot.UnsafeToSlot<Output>()};
+  }
+
+  void operator()(EvaluationContext*, FramePtr frame) const {
+    frame.Set(output_slot,
+              Compare<CompareOp>(frame.Get(a_slot), frame.Get(b_slot))
+                  ? Output(frame.Get(x_slot))
+                  : Output());
+  }
+
+  FrameLayout::Slot<A> a_slot;
+  FrameLayout::Slot<B> b_slot;
+  FrameLayout::Slot<X> x_slot;
+  FrameLayout::Slot<Output> output_slot;
+};
+
+// core.where(compare(a, b), x, y).
+template <typename CompareOp, typename A, typename B, typename X>
+struct CompareWhereOp {
+  using Output = X;
+
+  static std::vector<QTypePtr> InputQTypes() {
+    return {GetQType<A>(), GetQType<B>(), GetQType<X>(), GetQType<X>()};
+  }
+
+  static CompareWhereOp Bind(absl::Span<const TypedSlot> input_slots,
+                             TypedSlot output_slot) {
+    return {input_slots[0].UnsafeToSlot<A>(), input_slots[1].UnsafeToSlot<B>(),
+            input_slots[2].UnsafeToSlot<X>(), input_slots[3].UnsafeToSlot<X>(),
+            output_slot.UnsafeToSlot<Output>()};
+  }
+
+  void operator()(EvaluationContext*, FramePtr frame) const {
+    frame.Set(output_slot,
+              Compare<CompareOp>(frame.Get(a_slot), frame.Get(b_slot))
+                  ? frame.Get(x_slot)
+                  : frame.Get(y_slot));
+  }
+
+  FrameLayout::Slot<A> a_slot;
+  FrameLayout::Slot<B> b_slot;
+  FrameLayout::Slot<X> x_slot;
+  FrameLayout::Slot<X> y_slot;
+  FrameLayout::Slot<Output> output_slot;
+};
+
+using FusedOperatorFactory = std::unique_ptr<BoundOperator> (*)(
+    absl::Span<const TypedSlot> input_slots, TypedSlot output_slot);
+
+// (first_op_name, second_op_name, fused_arg, input_qtypes, output_qtype).
+using FusedOperatorKey = std::tuple<std::string, std::string, size_t,
+                                    std::vector<QTypePtr>, QTypePtr>;
+
+using FusedOperatorTable =
+    absl::flat_hash_map<FusedOperatorKey, FusedOperatorFactory>;
+
+template <typename FusedOp>
+std::unique_ptr<BoundOperator> BindFusedOperator(
+    absl::Span<const TypedSlot> input_slots, TypedSlot output_slot) {
+  // The fused operators are trivially copyable functors, so
+  // PackedBoundOperators can dispatch them without a virtual call.
+  return MakeBoundOperator(FusedOp::Bind(input_slots, output_slot));
+}
+
+template <typename FusedOp>
+void RegisterFusedOperator(absl::string_view first_op_name,
+                           absl::string_view second_op_name, size_t fused_arg,
+                           FusedOperatorTable& table) {
+  table.emplace(FusedOperatorKey(first_op_name, second_op_name, fused_arg,
+                                 FusedOp::InputQTypes(),
+                                 GetQType<typename FusedOp::Output>()),
+                &BindFusedOperator<FusedOp>);
+}
+
+template <typename T>
+using ScalarOrOptional = meta::type_list<T, OptionalValue<T>>;
+
+FusedOperatorTable CreateFusedOperatorTable() {
+  FusedOperatorTable table;
+  meta::foreach_type<meta::type_list<float, double>>([&](auto t) {
+    using T = typename decltype(t)::type;
+    meta::foreach_type<ScalarOrOptional<T>>([&](auto a) {
+      meta::foreach_type<ScalarOrOptional<T>>([&](auto b) {
+        meta::foreach_type<ScalarOrOptional<T>>([&](auto c) {
+          using A = typename decltype(a)::type;
+          using B = typename decltype(b)::type;
+          using C = typename decltype(c)::type;
+          RegisterFusedOperator<MultiplyAddOp<A, B, C, true>>(
+              "math.multiply", "math.add", 0, table);
+          RegisterFusedOperator<MultiplyAddOp<A, B, C, false>>(
+              "math.multiply", "math.add", 1, table);
+        });
+      });
+    });
+  });
+  auto register_compare = [&](absl::string_view compare_op_name,
+                              auto compare_op) {
+    using CompareOp = decltype(compare_op);
+    meta::foreach_type<meta::type_list<float, double, int32_t, int64_t>>(
+        [&](auto t) {
+          using T = typename decltype(t)::type;
+          meta::foreach_type<ScalarOrOptional<T>>([&](auto a) {
+            meta::foreach_type<ScalarOrOptional<T>>([&](auto b) {
+              meta::foreach_type<ScalarOrOptional<T>>([&](auto x) {
+                using A = typename decltype(a)::type;
+                using B = typename decltype(b)::type;
+                using X = typename decltype(x)::type;
+                RegisterFusedOperator<ComparePresenceAndOp<CompareOp, A, B, X>>(
+                    compare_op_name, "core.presence_and", 1, table);
+                RegisterFusedOperator<CompareWhereOp<CompareOp, A, B, X>>(
+                    compare_op_name, "core.where", 0, table);
+              });
+            });
+          });
+        });
+  };
+  register_compare("core.less", MaskLessOp());
+  register_compare("core.less_equal", MaskLessEqualOp());
+  register_compare("core.equal", MaskEqualOp());
+  return table;
+}
+
+}  // namespace
+
+std::unique_ptr<BoundOperator> MakeFusedOperator(
+    absl::string_view first_op_name, absl::string_view second_op_name,
+    size_t fused_arg, absl::Span<const TypedSlot> input_slots,
+    TypedSlot output_slot) {
+  static const Indestructible<FusedOperatorTable> kTable(
+      CreateFusedOperatorTable());
+  auto it = kTable->find(FusedOperatorKey(
+      first_op_name, second_op_name, fused_arg, SlotsToTypes(input_slots),
+      output_slot.GetType()));
+  if (it == kTable->end()) {
+    return nullptr;
+  }
+  return it->second(input_slots, output_slot);
+}
+
+}  // namespace arolla::expr::eval_internal
@@ -0,0 +1,47 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_FUSED_OPERATORS_H_
+#define AROLLA_EXPR_EVAL_FUSED_OPERATORS_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/typed_slot.h"
+
+namespace arolla::expr::eval_internal {
+
+// Returns a bound operator that evaluates the backend operator
+// `second_op_name` with its `fused_arg`-th argument computed by the backend
+// operator `first_op_name`, without storing the intermediate result in the
+// frame. Returns nullptr if the pair is not supported for these types.
+//
+// `input_slots` are the arguments of the first operator followed by the
+// remaining arguments of the second one, in their original order.
+//
+// The supported pairs are the frequent ones in the scalar models:
+//   * math.multiply -> math.add on floating point values;
+//   * core.less / core.less_equal / core.equal -> core.presence_and (mask);
+//   * core.less / core.less_equal / core.equal -> core.where (condition).
+std::unique_ptr<BoundOperator> MakeFusedOperator(
+    absl::string_view first_op_name, absl::string_view second_op_name,
+    size_t fused_arg, absl::Span<const TypedSlot> input_slots,
+    TypedSlot output_slot);
+
+}  // namespace arolla::expr::eval_internal
+
+#endif  // AROLLA_EXPR_EVAL_FUSED_OPERATORS_H_
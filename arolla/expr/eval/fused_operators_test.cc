@@ -0,0 +1,144 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/fused_operators.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qtype/base_types.h"
+#include "arolla/qtype/typed_slot.h"
+
+namespace arolla::expr::eval_internal {
+namespace {
+
+using ::testing::Eq;
+using ::testing::IsNull;
+using ::testing::NotNull;
+
+TEST(FusedOperatorsTest, MultiplyAdd) {
+  FrameLayout::Builder layout_builder;
+  auto a_slot = layout_builder.AddSlot<float>();
+  auto b_slot = layout_builder.AddSlot<OptionalValue<float>>();
+  auto c_slot = layout_builder.AddSlot<float>();
+  auto result_slot = layout_builder.AddSlot<OptionalValue<float>>();
+  auto op = MakeFusedOperator(
+      "math.multiply", "math.add", 1,
+      {TypedSlot::FromSlot(a_slot), TypedSlot::FromSlot(b_slot),
+       TypedSlot::FromSlot(c_slot)},
+      TypedSlot::FromSlot(result_slot));
+  ASSERT_THAT(op, NotNull());
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  EvaluationContext ctx;
+
+  frame.Set(a_slot, 2.0f);
+  frame.Set(b_slot, 10.0f);
+  frame.Set(c_slot, 100.0f);
+  op->Run(&ctx, frame);
+  EXPECT_THAT(frame.Get(result_slot), Eq(120.0f));
+
+  frame.Set(b_slot, std::nullopt);
+  op->Run(&ctx, frame);
+  EXPECT_THAT(frame.Get(result_slot), Eq(std::nullopt));
+}
+
+TEST(FusedOperatorsTest, ComparePresenceAnd) {
+  FrameLayout::Builder layout_builder;
+  auto a_slot = layout_builder.AddSlot<OptionalValue<int64_t>>();
+  auto b_slot = layout_builder.AddSlot<int64_t>();
+  auto x_slot = layout_builder.AddSlot<int64_t>();
+  auto result_slot = layout_builder.AddSlot<OptionalValue<int64_t>>();
+  auto op = MakeFusedOperator(
+      "core.less", "core.presence_and", 1,
+      {TypedSlot::FromSlot(a_slot), TypedSlot::FromSlot(b_slot),
+       TypedSlot::FromSlot(x_slot)},
+      TypedSlot::FromSlot(result_slot));
+  ASSERT_THAT(op, NotNull());
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  EvaluationContext ctx;
+
+  frame.Set(a_slot, 1);
+  frame.Set(b_slot, 2);
+  frame.Set(x_slot, 57);
+  op->Run(&ctx, frame);
+  EXPECT_THAT(frame.Get(result_slot), Eq(int64_t{57}));
+
+  frame.Set(a_slot, 2);
+  op->Run(&ctx, frame);
+  EXPECT_THAT(frame.Get(result_slot), Eq(std::nullopt));
+
+  frame.Set(a_slot, std::nullopt);
+  op->Run(&ctx, frame);
+  EXPECT_THAT(frame.Get(result_slot), Eq(std::nullopt));
+}
+
+TEST(FusedOperatorsTest, CompareWhere) {
+  FrameLayout::Builder layout_builder;
+  auto a_slot = layout_builder.AddSlot<double>();
+  auto b_slot = layout_builder.AddSlot<double>();
+  auto x_slot = layout_builder.AddSlot<OptionalValue<double>>();
+  auto y_slot = layout_builder.AddSlot<OptionalValue<double>>();
+  auto result_slot = layout_builder.AddSlot<OptionalValue<double>>();
+  auto op = MakeFusedOperator(
+      "core.less_equal", "core.where", 0,
+      {TypedSlot::FromSlot(a_slot), TypedSlot::FromSlot(b_slot),
+       TypedSlot::FromSlot(x_slot), TypedSlot::FromSlot(y_slot)},
+      TypedSlot::FromSlot(result_slot));
+  ASSERT_THAT(op, NotNull());
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  EvaluationContext ctx;
+
+  frame.Set(a_slot, 1.0);
+  frame.Set(b_slot, 1.0);
+  frame.Set(x_slot, 5.0);
+  frame.Set(y_slot, std::nullopt);
+  op->Run(&ctx, frame);
+  EXPECT_THAT(frame.Get(result_slot), Eq(5.0));
+
+  frame.Set(a_slot, 1.5);
+  op->Run(&ctx, frame);
+  EXPECT_THAT(frame.Get(result_slot), Eq(std::nullopt));
+}
+
+TEST(FusedOperatorsTest, UnsupportedPairs) {
+  FrameLayout::Builder layout_builder;
+  auto x_slot = TypedSlot::FromSlot(layout_builder.AddSlot<float>());
+  auto i_slot = TypedSlot::FromSlot(layout_builder.AddSlot<int32_t>());
+  EXPECT_THAT(MakeFusedOperator("math.multiply", "math.subtract", 0,
+                                {x_slot, x_slot, x_slot}, x_slot),
+              IsNull());
+  // Integer multiply-add is not in the table.
+  EXPECT_THAT(MakeFusedOperator("math.multiply", "math.add", 0,
+                                {i_slot, i_slot, i_slot}, i_slot),
+              IsNull());
+  // Inconsistent output type.
+  EXPECT_THAT(MakeFusedOperator("math.multiply", "math.add", 0,
+                                {x_slot, x_slot, x_slot}, i_slot),
+              IsNull());
+}
+
+}  // namespace
+}  // namespace arolla::expr::eval_internal
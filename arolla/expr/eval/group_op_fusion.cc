@@ -0,0 +1,301 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/group_op_fusion.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/numeric/bits.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/backend_wrapping_operator.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_operator.h"
+#include "arolla/expr/expr_stack_trace.h"
+#include "arolla/expr/expr_visitor.h"
+#include "arolla/expr/registered_expr_operator.h"
+#include "arolla/expr/tuple_expr_operator.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/tuple_qtype.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::expr::eval_internal {
+namespace {
+
+constexpr absl::string_view kGroupStatsOpName = "math._group_stats";
+
+// Fields of the math._group_stats result. Bit `1 << stat` of the `stats`
+// argument requests the corresponding field.
+enum GroupStat { kSum = 0, kCount = 1, kMin = 2, kMax = 3 };
+
+struct GroupOp {
+  GroupStat stat;
+  size_t x_index;
+  size_t edge_index;
+  // Only for kSum.
+  std::optional<size_t> initial_index;
+};
+
+absl::StatusOr<QTypePtr> GroupStatsOutputQType(
+    absl::Span<const QTypePtr> input_qtypes) {
+  if (input_qtypes.size() != 4 || !IsDenseArrayQType(input_qtypes[0])) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("unexpected arguments for %s", kGroupStatsOpName));
+  }
+  QTypePtr x_qtype = input_qtypes[0];
+  return MakeTupleQType(
+      {x_qtype, GetDenseArrayQType<int64_t>(), x_qtype, x_qtype});
+}
+
+const ExprOperatorPtr& GroupStatsOperator() {
+  static const Indestructible<ExprOperatorPtr> kOp(
+      std::make_shared<BackendWrappingOperator>(
+          kGroupStatsOpName,
+          ExprOperatorSignature{{"x"}, {"edge"}, {"initial"}, {"stats"}},
+          GroupStatsOutputQType));
+  return *kOp;
+}
+
+absl::StatusOr<std::optional<absl::string_view>> GetBackendOperatorName(
+    const ExprNodePtr& node) {
+  if (!node->is_op()) {
+    return std::nullopt;
+  }
+  ASSIGN_OR_RETURN(auto op, DecayRegisteredOperator(node->op()));
+  if (!HasBackendExprOperatorTag(op)) {
+    return std::nullopt;
+  }
+  return op->display_name();
+}
+
+// Returns the description of the node if it is one of the aggregations
+// computed by math._group_stats.
+absl::StatusOr<std::optional<GroupOp>> MatchGroupOp(
+    const PostOrder& post_order, size_t node_index) {
+  const auto& node = post_order.node(node_index);
+  ASSIGN_OR_RETURN(auto op_name, GetBackendOperatorName(node));
+  if (!op_name.has_value()) {
+    return std::nullopt;
+  }
+  absl::Span<const size_t> dep_indices = post_order.dep_indices(node_index);
+  std::optional<GroupOp> result;
+  if (*op_name == "math._sum" && dep_indices.size() == 3) {
+    result = GroupOp{kSum, dep_indices[0], dep_indices[1], dep_indices[2]};
+  } else if (*op_name == "math._min" && dep_indices.size() == 2) {
+    result = GroupOp{kMin, dep_indices[0], dep_indices[1]};
+  } else if (*op_name == "math._max" && dep_indices.size() == 2) {
+    result = GroupOp{kMax, dep_indices[0], dep_indices[1]};
+  } else if (*op_name == "array._count" && dep_indices.size() == 2) {
+    // array._count(core.has._array(x), edge)
+    size_t has_index = dep_indices[0];
+    ASSIGN_OR_RETURN(auto has_op_name,
+                     GetBackendOperatorName(post_order.node(has_index)));
+    if (has_op_name != "core.has._array" ||
+        post_order.dep_indices(has_index).size() != 1) {
+      return std::nullopt;
+    }
+    result = GroupOp{kCount, post_order.dep_indices(has_index)[0],
+                     dep_indices[1]};
+  } else {
+    return std::nullopt;
+  }
+  const QType* x_qtype = post_order.node(result->x_index)->qtype();
+  if (x_qtype == nullptr || !IsDenseArrayQType(x_qtype) ||
+      post_order.node(result->edge_index)->qtype() !=
+          GetQType<DenseArrayEdge>()) {
+    return std::nullopt;
+  }
+  // The fused operator must produce the same types as the original one.
+  QTypePtr expected_qtype =
+      result->stat == kCount ? GetDenseArrayQType<int64_t>() : x_qtype;
+  if (node->qtype() != expected_qtype) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+// Returns true if the backend implements math._group_stats for `x_qtype`.
+bool HasGroupStatsOperator(const DynamicEvaluationEngineOptions& options,
+                           QTypePtr x_qtype) {
+  const OperatorDirectory& backend_operators =
+      options.operator_directory != nullptr ? *options.operator_directory
+                                            : *OperatorRegistry::GetInstance();
+  auto optional_qtype = ToOptionalQType(x_qtype->value_qtype());
+  if (!optional_qtype.ok()) {
+    return false;
+  }
+  std::vector<QTypePtr> input_qtypes = {x_qtype, GetQType<DenseArrayEdge>(),
+                                        *optional_qtype, GetQType<int32_t>()};
+  auto output_qtype = GroupStatsOutputQType(input_qtypes);
+  return output_qtype.ok() &&
+         backend_operators
+             .LookupOperator(kGroupStatsOpName, input_qtypes, *output_qtype)
+             .ok();
+}
+
+struct FusedGroup {
+  size_t x_index;
+  size_t edge_index;
+  std::optional<size_t> initial_index;
+  int32_t stats;           // Bit mask of the requested GroupStat fields.
+  ExprNodePtr stats_node;  // Created on the first use.
+};
+
+}  // namespace
+
+absl::StatusOr<ExprNodePtr> FuseGroupOperators(
+    const DynamicEvaluationEngineOptions& options, ExprNodePtr expr,
+    std::shared_ptr<ExprStackTrace> stack_trace) {
+  PostOrder post_order(expr);
+  const size_t nodes_size = post_order.nodes_size();
+
+  // The same subexpressions share the node index in PostOrder, so the
+  // aggregations over the same input and edge are found by the indices.
+  std::vector<std::optional<GroupOp>> group_ops(nodes_size);
+  absl::flat_hash_map<std::pair<size_t, size_t>, std::vector<size_t>>
+      candidates;
+  std::vector<std::pair<size_t, size_t>> candidate_keys;
+  for (size_t i = 0; i < nodes_size; ++i) {
+    ASSIGN_OR_RETURN(group_ops[i], MatchGroupOp(post_order, i));
+    if (group_ops[i].has_value()) {
+      std::pair<size_t, size_t> key = {group_ops[i]->x_index,
+                                       group_ops[i]->edge_index};
+      auto& members = candidates[key];
+      if (members.empty()) {
+        candidate_keys.push_back(key);
+      }
+      members.push_back(i);
+    }
+  }
+
+  constexpr size_t kNotFused = ~size_t{0};
+  std::vector<size_t> fused_group_ids(nodes_size, kNotFused);
+  std::vector<FusedGroup> fused_groups;
+  for (const auto& key : candidate_keys) {
+    const std::vector<size_t>& members = candidates[key];
+    // math._group_stats is created at the first fused node, so the initial
+    // value of the sum must be computed before it.
+    size_t first_non_sum = nodes_size;
+    for (size_t i : members) {
+      if (group_ops[i]->stat != kSum) {
+        first_non_sum = std::min(first_non_sum, i);
+      }
+    }
+    std::optional<size_t> initial_index;
+    std::vector<size_t> fused_members;
+    int32_t stats = 0;
+    for (size_t i : members) {
+      const GroupOp& group_op = *group_ops[i];
+      if (group_op.stat == kSum) {
+        if (!initial_index.has_value() &&
+            *group_op.initial_index < first_non_sum) {
+          initial_index = group_op.initial_index;
+        }
+        if (group_op.initial_index != initial_index) {
+          continue;
+        }
+      }
+      stats |= int32_t{1} << group_op.stat;
+      fused_members.push_back(i);
+    }
+    if (absl::popcount(static_cast<uint32_t>(stats)) < 2 ||
+        !HasGroupStatsOperator(options, post_order.node(key.first)->qtype())) {
+      continue;
+    }
+    for (size_t i : fused_members) {
+      fused_group_ids[i] = fused_groups.size();
+    }
+    fused_groups.push_back(
+        {key.first, key.second, initial_index, stats, nullptr});
+  }
+  if (fused_groups.empty()) {
+    return expr;
+  }
+
+  std::vector<ExprNodePtr> new_nodes(nodes_size);
+  for (size_t i = 0; i < nodes_size; ++i) {
+    const auto& node = post_order.node(i);
+    if (fused_group_ids[i] != kNotFused) {
+      FusedGroup& group = fused_groups[fused_group_ids[i]];
+      if (group.stats_node == nullptr) {
+        ExprNodePtr initial;
+        if (group.initial_index.has_value()) {
+          initial = new_nodes[*group.initial_index];
+        } else {
+          const QType* x_qtype = post_order.node(group.x_index)->qtype();
+          ASSIGN_OR_RETURN(auto optional_qtype,
+                           ToOptionalQType(x_qtype->value_qtype()));
+          ASSIGN_OR_RETURN(auto missing, CreateMissingValue(optional_qtype));
+          initial = Literal(missing);
+        }
+        ASSIGN_OR_RETURN(group.stats_node,
+                         MakeOpNode(GroupStatsOperator(),
+                                    {new_nodes[group.x_index],
+                                     new_nodes[group.edge_index],
+                                     std::move(initial),
+                                     Literal(group.stats)}));
+      }
+      ASSIGN_OR_RETURN(auto get_nth_op,
+                       GetNthOperator::Make(group_ops[i]->stat));
+      ASSIGN_OR_RETURN(new_nodes[i],
+                       MakeOpNode(std::move(get_nth_op), {group.stats_node}));
+      if (new_nodes[i]->qtype() != node->qtype()) {
+        return absl::InternalError(absl::StrFormat(
+            "%s changes the output type: expected %s, got %s",
+            kGroupStatsOpName, node->qtype()->name(),
+            new_nodes[i]->qtype() == nullptr ? "nullptr"
+                                             : new_nodes[i]->qtype()->name()));
+      }
+      if (stack_trace != nullptr) {
+        stack_trace->AddTrace(new_nodes[i], node,
+                              TransformationType::kOptimization);
+      }
+      continue;
+    }
+    if (node->node_deps().empty()) {
+      new_nodes[i] = node;
+      continue;
+    }
+    std::vector<ExprNodePtr> new_deps;
+    new_deps.reserve(node->node_deps().size());
+    for (size_t dep_index : post_order.dep_indices(i)) {
+      new_deps.push_back(new_nodes[dep_index]);
+    }
+    ASSIGN_OR_RETURN(new_nodes[i],
+                     WithNewDependencies(node, std::move(new_deps)));
+    if (stack_trace != nullptr) {
+      stack_trace->AddTrace(new_nodes[i], node,
+                            TransformationType::kChildTransform);
+    }
+  }
+  return new_nodes.back();
+}
+
+}  // namespace arolla::expr::eval_internal
@@ -0,0 +1,47 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_GROUP_OP_FUSION_H_
+#define AROLLA_EXPR_EVAL_GROUP_OP_FUSION_H_
+
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_stack_trace.h"
+
+namespace arolla::expr::eval_internal {
+
+// Fuses the sibling aggregations of the same DenseArray over the same
+// DenseArrayEdge into a single math._group_stats call, so the input is
+// traversed once. E.g. mean and count of a feature, or min / max pairs.
+//
+// The fused aggregations are math._sum(x, edge, initial),
+// array._count(core.has._array(x), edge), math._min(x, edge) and
+// math._max(x, edge). Every aggregation is replaced with the corresponding
+// field of the math._group_stats result, so the outputs are unchanged. Only
+// the statistics used by the expression are computed. The groups with a single
+// kind of aggregation are kept as is.
+//
+// The transformation expects the expression to be lowered and casted. If
+// math._group_stats is not available for the argument types (e.g. the
+// operator library is not linked), the expression is kept unchanged.
+absl::StatusOr<ExprNodePtr> FuseGroupOperators(
+    const DynamicEvaluationEngineOptions& options, ExprNodePtr expr,
+    std::shared_ptr<ExprStackTrace> stack_trace = nullptr);
+
+}  // namespace arolla::expr::eval_internal
+
+#endif  // AROLLA_EXPR_EVAL_GROUP_OP_FUSION_H_
@@ -21,6 +21,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "arolla/expr/eval/compilation_cache.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/memory/frame.h"
@@ -43,8 +44,9 @@ absl::StatusOr<TypedValue> Invoke(
     leaf_types.emplace(name, value.GetType());
   }
 
-  ASSIGN_OR_RETURN(auto compiled_expr,
-                   CompileForDynamicEvaluation(options, expr, leaf_types));
+  ASSIGN_OR_RETURN(
+      auto compiled_expr,
+      CompilationCache::GetInstance().Compile(options, expr, leaf_types));
 
   FrameLayout::Builder layout_builder;
   // Note that due to optimizations, some inputs can be not used by
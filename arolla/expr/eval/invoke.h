@@ -27,8 +27,9 @@ namespace arolla::expr {
 
 // Compiles and invokes an expression on given inputs using QExpr backend.
 //
-// Do not use this function in computationally intensive situations because
-// expression compilation is expensive.
+// The compiled expressions are reused via CompilationCache::GetInstance(), but
+// the binding and frame allocation still happen on every call, so prefer
+// ModelExecutor in computationally intensive situations.
 absl::StatusOr<TypedValue> Invoke(
     const ExprNodePtr& expr,
     const absl::flat_hash_map<std::string, TypedValue>& leaf_values,
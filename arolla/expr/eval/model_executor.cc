@@ -15,6 +15,8 @@
 #include "arolla/expr/eval/model_executor.h"
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <optional>
@@ -25,18 +27,22 @@
 
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/expr/eval/dynamic_compiled_expr.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/operators/bootstrap_operators.h"
 #include "arolla/io/slot_listener.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/evaluation_engine.h"
 #include "arolla/qexpr/simple_executable.h"
@@ -45,6 +51,9 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/qtype/typed_value_interner.h"
+#include "arolla/util/fingerprint.h"
 #include "arolla/util/string.h"
 #include "arolla/util/unit.h"
 #include "arolla/util/status_macros_backport.h"
@@ -52,6 +61,14 @@
 namespace arolla::expr::model_executor_impl {
 namespace {
 
+struct ThreadLocalArena {
+  std::unique_ptr<UnsafeArenaBufferFactory> arena;
+  int64_t page_size = 0;
+  bool in_use = false;
+};
+
+thread_local ThreadLocalArena thread_local_arena;
+
 struct CompiledOutputCastings {
   std::unique_ptr<BoundExpr> casting_executable_expr;
   absl::flat_hash_map<std::string, TypedSlot> named_output_slots;
@@ -181,6 +198,8 @@ class DecayOptionalBoundExpr : public BoundExpr {
     }
   }
 
+  const BoundExpr& expr() const { return *expr_; }
+
  private:
   explicit DecayOptionalBoundExpr(std::unique_ptr<BoundExpr> expr)
       : BoundExpr(expr->input_slots(), expr->output_slot().SubSlot(1),
@@ -275,6 +294,113 @@ class CastingCompiledExpr : public CompiledExpr {
   ModelExecutorOptions options_;
 };
 
+// BoundExpr that overrides some of the literals of the wrapped expression
+// after its InitializeLiterals() call.
+class LiteralReplacingBoundExpr : public BoundExpr {
+ public:
+  LiteralReplacingBoundExpr(
+      std::shared_ptr<const BoundExpr> expr,
+      std::vector<std::pair<TypedValue, TypedSlot>> replacements)
+      : BoundExpr(expr->input_slots(), expr->output_slot(),
+                  expr->named_output_slots()),
+        expr_(std::move(expr)),
+        replacements_(std::move(replacements)) {}
+
+  void InitializeLiterals(EvaluationContext* ctx,
+                          FramePtr frame) const override {
+    expr_->InitializeLiterals(ctx, frame);
+    for (const auto& [value, slot] : replacements_) {
+      auto ref = value.AsRef();
+      ref.GetType()->UnsafeCopy(ref.GetRawPointer(),
+                                frame.GetRawPointer(slot.byte_offset()));
+    }
+  }
+
+  void Execute(EvaluationContext* ctx, FramePtr frame) const override {
+    expr_->Execute(ctx, frame);
+  }
+
+  const std::shared_ptr<const BoundExpr>& expr() const { return expr_; }
+  absl::Span<const std::pair<TypedValue, TypedSlot>> replacements() const {
+    return replacements_;
+  }
+
+ private:
+  std::shared_ptr<const BoundExpr> expr_;
+  std::vector<std::pair<TypedValue, TypedSlot>> replacements_;
+};
+
+// Appends the literals initialized by `expr` (together with their slots) to
+// `literals`, looking through the wrappers created by ModelExecutor.
+absl::Status CollectLiteralSlots(
+    const BoundExpr& expr,
+    std::vector<std::pair<TypedValue, TypedSlot>>& literals) {
+  if (const auto* dynamic_expr =
+          dynamic_cast<const eval_internal::DynamicBoundExpr*>(&expr)) {
+    literals.insert(literals.end(), dynamic_expr->literal_slots().begin(),
+                    dynamic_expr->literal_slots().end());
+    return absl::OkStatus();
+  }
+  if (const auto* decay_expr =
+          dynamic_cast<const DecayOptionalBoundExpr*>(&expr)) {
+    return CollectLiteralSlots(decay_expr->expr(), literals);
+  }
+  if (const auto* combined_expr =
+          dynamic_cast<const CombinedBoundExpr*>(&expr)) {
+    for (const auto& subexpr : combined_expr->subexprs()) {
+      RETURN_IF_ERROR(CollectLiteralSlots(*subexpr, literals));
+    }
+    return absl::OkStatus();
+  }
+  if (const auto* replacing_expr =
+          dynamic_cast<const LiteralReplacingBoundExpr*>(&expr)) {
+    size_t offset = literals.size();
+    RETURN_IF_ERROR(CollectLiteralSlots(*replacing_expr->expr(), literals));
+    absl::flat_hash_map<size_t, const TypedValue*> replaced_values;
+    for (const auto& [value, slot] : replacing_expr->replacements()) {
+      replaced_values[slot.byte_offset()] = &value;
+    }
+    for (size_t i = offset; i < literals.size(); ++i) {
+      if (auto it = replaced_values.find(literals[i].second.byte_offset());
+          it != replaced_values.end()) {
+        literals[i].first = *it->second;
+      }
+    }
+    return absl::OkStatus();
+  }
+  return absl::FailedPreconditionError(
+      "literal replacement is supported only for the models compiled for "
+      "dynamic evaluation");
+}
+
+// Returns true if InitializeLiterals() of `expr` writes only the slots
+// collected by CollectLiteralSlots, looking through the wrappers created by
+// ModelExecutor.
+bool InitializesOnlyLiteralSlots(const BoundExpr& expr) {
+  if (const auto* dynamic_expr =
+          dynamic_cast<const eval_internal::DynamicBoundExpr*>(&expr)) {
+    return dynamic_expr->initializes_only_literal_slots();
+  }
+  if (const auto* decay_expr =
+          dynamic_cast<const DecayOptionalBoundExpr*>(&expr)) {
+    return InitializesOnlyLiteralSlots(decay_expr->expr());
+  }
+  if (const auto* combined_expr =
+          dynamic_cast<const CombinedBoundExpr*>(&expr)) {
+    for (const auto& subexpr : combined_expr->subexprs()) {
+      if (!InitializesOnlyLiteralSlots(*subexpr)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (const auto* replacing_expr =
+          dynamic_cast<const LiteralReplacingBoundExpr*>(&expr)) {
+    return InitializesOnlyLiteralSlots(*replacing_expr->expr());
+  }
+  return false;
+}
+
 // absl::StrJoin formatter that returns the first element of std::pair.
 struct FirstFormatter {
   template <typename Pair>
@@ -285,6 +411,33 @@ struct FirstFormatter {
 
 }  // namespace
 
+ScopedThreadLocalArena::ScopedThreadLocalArena(int64_t page_size,
+                                               int64_t reserved_bytes,
+                                               ArenaStatsCollector& stats)
+    : stats_(stats) {
+  ThreadLocalArena& local = thread_local_arena;
+  if (local.in_use) {
+    temporary_arena_ = std::make_unique<UnsafeArenaBufferFactory>(page_size);
+    arena_ = temporary_arena_.get();
+    return;
+  }
+  if (local.arena == nullptr || local.page_size != page_size) {
+    local.arena = std::make_unique<UnsafeArenaBufferFactory>(page_size);
+    local.page_size = page_size;
+  }
+  local.arena->Reserve(reserved_bytes);
+  local.in_use = true;
+  arena_ = local.arena.get();
+}
+
+ScopedThreadLocalArena::~ScopedThreadLocalArena() {
+  stats_.Update(arena_->GetStats());
+  if (temporary_arena_ == nullptr) {
+    arena_->Reset();
+    thread_local_arena.in_use = false;
+  }
+}
+
 std::unique_ptr<CompiledExpr> CastOutputsIfNeeded(
     const CompiledExpr& expr, QTypePtr desired_output_type,
     absl::Nullable<const SlotListenerBase*> slot_listener,
@@ -304,6 +457,125 @@ std::unique_ptr<CompiledExpr> CastOutputsIfNeeded(
       std::move(expr), desired_output_type, side_output_types, options);
 }
 
+absl::StatusOr<std::vector<std::shared_ptr<const BoundExpr>>>
+ReplaceLiterals(
+    absl::Span<const std::shared_ptr<const BoundExpr>> exprs,
+    const absl::flat_hash_map<Fingerprint, TypedValue>& new_literals) {
+  std::vector<std::vector<std::pair<TypedValue, TypedSlot>>> literals(
+      exprs.size());
+  for (size_t i = 0; i < exprs.size(); ++i) {
+    if (exprs[i] != nullptr) {
+      RETURN_IF_ERROR(CollectLiteralSlots(*exprs[i], literals[i]));
+    }
+  }
+  absl::flat_hash_set<Fingerprint> found_literals;
+  std::vector<std::vector<std::pair<TypedValue, TypedSlot>>> replacements(
+      exprs.size());
+  for (size_t i = 0; i < exprs.size(); ++i) {
+    for (const auto& [value, slot] : literals[i]) {
+      Fingerprint fingerprint = value.GetFingerprint();
+      auto it = new_literals.find(fingerprint);
+      if (it == new_literals.end()) {
+        continue;
+      }
+      const TypedValue& new_value = it->second;
+      if (new_value.GetType() != slot.GetType()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "unable to replace literal %s with a value of a different type: "
+            "expected %s, got %s",
+            value.Repr(), slot.GetType()->name(), new_value.GetType()->name()));
+      }
+      found_literals.insert(fingerprint);
+      replacements[i].emplace_back(new_value, slot);
+    }
+  }
+  if (found_literals.size() != new_literals.size()) {
+    std::vector<std::string> missing_literals;
+    for (const auto& [fingerprint, value] : new_literals) {
+      if (!found_literals.contains(fingerprint)) {
+        missing_literals.push_back(fingerprint.AsString());
+      }
+    }
+    std::sort(missing_literals.begin(), missing_literals.end());
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "literals with fingerprints [%s] are not found in the compiled model; "
+        "note that the literals can be folded or deduplicated during "
+        "compilation",
+        absl::StrJoin(missing_literals, ", ")));
+  }
+  std::vector<std::shared_ptr<const BoundExpr>> result(exprs.size());
+  for (size_t i = 0; i < exprs.size(); ++i) {
+    if (exprs[i] == nullptr || replacements[i].empty()) {
+      result[i] = exprs[i];
+      continue;
+    }
+    std::shared_ptr<const BoundExpr> base = exprs[i];
+    // Avoid wrapping the replacements one into another.
+    if (const auto* replacing_expr =
+            dynamic_cast<const LiteralReplacingBoundExpr*>(base.get())) {
+      absl::flat_hash_set<size_t> replaced_offsets;
+      for (const auto& [value, slot] : replacements[i]) {
+        replaced_offsets.insert(slot.byte_offset());
+      }
+      for (const auto& [value, slot] : replacing_expr->replacements()) {
+        if (!replaced_offsets.contains(slot.byte_offset())) {
+          replacements[i].emplace_back(value, slot);
+        }
+      }
+      base = replacing_expr->expr();
+    }
+    result[i] = std::make_shared<LiteralReplacingBoundExpr>(
+        std::move(base), std::move(replacements[i]));
+  }
+  return result;
+}
+
+std::optional<std::vector<std::pair<size_t, size_t>>> GetLiteralSlotRanges(
+    const BoundExpr& expr) {
+  std::vector<std::pair<size_t, size_t>> result;
+  std::vector<std::pair<TypedValue, TypedSlot>> literals;
+  if (!CollectLiteralSlots(expr, literals).ok() ||
+      !InitializesOnlyLiteralSlots(expr)) {
+    return std::nullopt;
+  }
+  result.reserve(literals.size());
+  for (const auto& [_, slot] : literals) {
+    result.emplace_back(
+        slot.byte_offset(),
+        slot.byte_offset() + slot.GetType()->type_layout().AllocSize());
+  }
+  return result;
+}
+
+void AddBoundExprMemoryUsage(const BoundExpr& expr,
+                             absl::Nullable<const TypedValueInterner*> interner,
+                             absl::flat_hash_set<const void*>& seen_literals,
+                             ModelMemoryReport& report) {
+  auto add_literals =
+      [&](absl::Span<const std::pair<TypedValue, TypedSlot>> literals) {
+        for (const auto& [value, slot] : literals) {
+          if (!seen_literals.insert(value.GetRawPointer()).second) {
+            continue;
+          }
+          int64_t bytes = value.AsRef().EstimateMemoryUsage();
+          report.literal_bytes += bytes;
+          if (interner != nullptr && interner->IsInterned(value)) {
+            report.shared_literal_bytes += bytes;
+          }
+        }
+      };
+  if (const auto* replacing_expr =
+          dynamic_cast<const LiteralReplacingBoundExpr*>(&expr)) {
+    add_literals(replacing_expr->replacements());
+    AddBoundExprMemoryUsage(*replacing_expr->expr(), interner, seen_literals,
+                            report);
+  } else if (const auto* dynamic_expr =
+                 dynamic_cast<const DynamicBoundExpr*>(&expr)) {
+    add_literals(dynamic_expr->literal_slots());
+    report.operator_bytes += dynamic_expr->operators_memory_usage();
+  }
+}
+
 absl::Status VerifyAllNamedOutputsAreListened(
     const absl::flat_hash_map<std::string, QTypePtr>&
         available_named_output_types,
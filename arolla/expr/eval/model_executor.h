@@ -15,8 +15,12 @@
 #ifndef AROLLA_EXPR_EVAL_MODEL_EXECUTOR_H_
 #define AROLLA_EXPR_EVAL_MODEL_EXECUTOR_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -28,13 +32,16 @@
 #include "absl/base/nullability.h"
 #include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/expr/eval/eval.h"
+#include "arolla/expr/eval/model_output_cache.h"
 #include "arolla/expr/eval/side_output.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_node.h"
@@ -51,7 +58,12 @@
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/qtype/typed_value_interner.h"
+#include "arolla/util/cancellation_context.h"
 #include "arolla/util/demangle.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/row_errors.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/view_types.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -77,18 +89,145 @@ struct ModelExecutorOptions {
   bool allow_side_outputs_casting = false;
 
   // Using arena can improve performance for evaluation in batches with types
-  // using RawBufferFactory (e.g., DenseArray or Array).
+  // using RawBufferFactory (e.g., DenseArray or Array). The arena pages are
+  // kept between evaluations and only rewound (see UnsafeArenaBufferFactory
+  // for the shrink policy): Execute() uses an arena owned by the executor,
+  // ExecuteOnHeap() and ExecuteOnStack() use a thread local one.
+  // All the outputs are copied out of the arena, so the option can only be used
+  // with output types supporting ArenaTraits.
   int64_t arena_page_size = 0;  // 0 means that no arena should be used.
 
+  // The number of bytes to preallocate in the arenas reused by the executor
+  // (requires arena_page_size). Useful for models always evaluated on batches
+  // of a fixed size: set it to GetArenaStats().peak_bytes observed on such a
+  // batch, so no evaluation (including the first ones and the ones on the
+  // clones) allocates arena pages. The reserved pages are never released.
+  int64_t arena_reserved_bytes = 0;
+
   // If the provided SlotListener does not accept a named output — the default
   // implementation will raise an error. Set this option to true to silently
   // ignore such named outputs insted.
   bool ignore_not_listened_named_outputs = false;
+
+  // Subsets of the listened side outputs to compile additional variants of the
+  // model for. When Execute() is called with a non-null side_output and
+  // ModelEvaluationOptions::side_output_variant = i, only the side outputs
+  // from side_output_variants[i] are evaluated and passed to the SlotListener.
+  // So the side outputs that are requested rarely (e.g. for debugging) don't
+  // slow down the other calls. Every variant adds its operators to the frame.
+  // NOTE: The option requires a SlotListener and is only supported by
+  // ModelExecutor::Compile().
+  std::vector<std::vector<std::string>> side_output_variants;
+
+  // If true, Execute() resets the non-trivially destructible slots (e.g.
+  // DenseArray or Text) of the executor's frame after each evaluation, so the
+  // executor does not keep the last inputs and intermediate results alive
+  // until the next call. Trivially destructible slots are left as is, which
+  // makes the reset much cheaper than reinitializing the whole frame. The
+  // literal slots are kept in place. If the model initializes more than the
+  // literals (e.g. some compiler extensions add their own init operators), all
+  // the slots are reset and the literals are reinitialized instead.
+  bool reset_frame_after_execution = false;
+
+  // If true, the slots are placed into the alignment padding left by the
+  // previous ones (see FrameLayout::Builder::EnablePaddingReuse). Makes the
+  // frame smaller, so ExecuteOnStack() applies to more models.
+  bool reuse_frame_padding = false;
+
+  // Caches the outputs of the evaluations without side outputs, keyed by the
+  // fingerprint of the values loaded by the input loader, so the repeated
+  // inputs are not evaluated again. The cache is shared between the clones of
+  // the executor. The outputs must be copyable. See ModelOutputCacheOptions
+  // for details and ModelExecutor::GetOutputCacheStats() for the hit rate.
+  //
+  // NOTE: The cache assumes that the model output depends only on the loaded
+  // inputs. Do not enable it for the models with nondeterministic operators
+  // (e.g. random sampling) or the operators reading an external state (e.g.
+  // time or a mutable lookup table): the cached outputs would be returned
+  // instead of the fresh ones until they expire (see
+  // ModelOutputCacheOptions::ttl).
+  ModelOutputCacheOptions output_cache;
 };
 
 // Options for ModelExecutor::Execute.
 struct ModelEvaluationOptions {
+  // Factory for the buffers allocated during the evaluation. E.g. pass an
+  // AllocationTrackingBufferFactory to measure the allocations of a model, or
+  // compile the model with DynamicEvaluationEngineOptions::enable_profiling to
+  // attribute them to the operators. Ignored if the model uses an arena (see
+  // ModelExecutorOptions::arena_page_size).
   RawBufferFactory* buffer_factory = GetHeapBufferFactory();
+
+  // Index in ModelExecutorOptions::side_output_variants of the side outputs to
+  // evaluate if Execute() is called with a non-null side_output. Negative
+  // (default) means all the listened side outputs.
+  int side_output_variant = -1;
+
+  // If set, the long running operators (loops, sequence operations, decision
+  // forests) stop once it is cancelled or its deadline has passed, and the
+  // evaluation returns CancelledError or DeadlineExceededError. Not owned.
+  CancellationContext* cancellation_context = nullptr;
+
+  // Row level error isolation. If set, the rows where the lifted pointwise
+  // DenseArray operators fail (e.g. a parse error) become missing in their
+  // outputs and are recorded here instead of failing the evaluation. Not
+  // supported by ExecuteBatch. Not owned.
+  RowErrors* row_errors = nullptr;
+
+  // If set, the evaluation neither looks up nor fills the output cache (see
+  // ModelExecutorOptions::output_cache). E.g. the warmup evaluations use it, so
+  // every warmed executor really evaluates the samples.
+  bool bypass_output_cache = false;
+};
+
+// Options for ModelExecutor::ExecuteBatch.
+struct ModelBatchEvaluationOptions {
+  ModelEvaluationOptions eval_options;
+
+  // Threading to evaluate chunks of the batch concurrently. If nullptr, the
+  // whole batch is evaluated in the current thread.
+  //
+  // All the threads share the non-owned pointers of eval_options, so they
+  // must be thread safe: eval_options.buffer_factory must be the heap buffer
+  // factory (ExecuteBatch returns an error otherwise, the other factories,
+  // e.g. UnsafeArenaBufferFactory, are not thread safe; use
+  // ModelExecutorOptions::arena_page_size to get an arena per thread), and
+  // eval_options.cancellation_context is only used via the thread safe
+  // SoftCheck().
+  ThreadingInterface* threading = nullptr;
+
+  // The minimal number of inputs to be processed by a single thread. Starting
+  // a thread (and cloning the executor for it) is not free, so small batches
+  // should not be split too much.
+  int64_t min_inputs_per_thread = 64;
+};
+
+// An estimate of the memory used by a compiled model, see
+// ModelExecutor::GetMemoryReport. The allocator overhead is ignored.
+struct ModelMemoryReport {
+  // The frame of the executor.
+  int64_t frame_bytes = 0;
+  // The pages kept by the arena of the executor.
+  int64_t arena_bytes = 0;
+  // The literals of the model, including the memory they own (e.g. the array
+  // buffers). Shared with the clones of the executor.
+  int64_t literal_bytes = 0;
+  // The part of literal_bytes shared with the other models via a
+  // TypedValueInterner.
+  int64_t shared_literal_bytes = 0;
+  // The frame with initialized literals copied into the new frames. Shared
+  // with the clones of the executor.
+  int64_t literal_image_bytes = 0;
+  // The memory owned by the bound operators, e.g. the compiled decision
+  // forests. Shared with the clones of the executor.
+  int64_t operator_bytes = 0;
+  // The idle executors kept by ThreadSafePoolModelExecutor.
+  int64_t pool_bytes = 0;
+
+  int64_t total_bytes() const {
+    return frame_bytes + arena_bytes + literal_bytes + literal_image_bytes +
+           operator_bytes + pool_bytes;
+  }
 };
 
 namespace model_executor_impl {
@@ -100,9 +239,82 @@ std::unique_ptr<CompiledExpr> CastOutputsIfNeeded(
     absl::Nullable<const SlotListenerBase*> slot_listener,
     const ModelExecutorOptions& options);
 
+// Returns copies of `exprs` (nullptrs are preserved) that initialize the
+// literals with the given fingerprints with the new values. See
+// ModelExecutor::WithReplacedLiterals for details.
+absl::StatusOr<std::vector<std::shared_ptr<const BoundExpr>>>
+ReplaceLiterals(
+    absl::Span<const std::shared_ptr<const BoundExpr>> exprs,
+    const absl::flat_hash_map<Fingerprint, TypedValue>& new_literals);
+
+// Adds the literals and the bound operators of `expr` to `report`. The
+// literals from `seen_literals` are skipped, and the new ones are added to it.
+// If `interner` is set, the literals registered in it are also counted as
+// shared.
+void AddBoundExprMemoryUsage(const BoundExpr& expr,
+                             absl::Nullable<const TypedValueInterner*> interner,
+                             absl::flat_hash_set<const void*>& seen_literals,
+                             ModelMemoryReport& report);
+
+// Returns the byte ranges [begin, end) of the slots written by
+// InitializeLiterals() of `expr`, or std::nullopt if they are not known (e.g.
+// if `expr` initializes not only the literals).
+std::optional<std::vector<std::pair<size_t, size_t>>> GetLiteralSlotRanges(
+    const BoundExpr& expr);
+
 template <typename T>
 struct OutputTraits;
 
+// Collects arena statistics over all the clones of a ModelExecutor.
+class ArenaStatsCollector {
+ public:
+  // Must be called before resetting the arena.
+  void Update(const UnsafeArenaBufferFactory::Stats& stats) {
+    UpdateMax(peak_bytes_, stats.used_bytes);
+    UpdateMax(page_count_, stats.page_count);
+  }
+
+  UnsafeArenaBufferFactory::Stats Get() const {
+    int64_t peak_bytes = peak_bytes_.load(std::memory_order_relaxed);
+    return {.page_count = page_count_.load(std::memory_order_relaxed),
+            .used_bytes = 0,
+            .peak_bytes = peak_bytes};
+  }
+
+ private:
+  static void UpdateMax(std::atomic<int64_t>& value, int64_t candidate) {
+    int64_t current = value.load(std::memory_order_relaxed);
+    while (current < candidate &&
+           !value.compare_exchange_weak(current, candidate,
+                                        std::memory_order_relaxed)) {
+    }
+  }
+
+  std::atomic<int64_t> peak_bytes_ = 0;
+  std::atomic<int64_t> page_count_ = 0;
+};
+
+// Provides an arena for a single evaluation. Reuses the thread local arena if
+// it has the requested page size and is not used by an outer evaluation in
+// the same thread; otherwise creates a temporary one. The arena is reset on
+// destruction.
+class ScopedThreadLocalArena {
+ public:
+  ScopedThreadLocalArena(int64_t page_size, int64_t reserved_bytes,
+                         ArenaStatsCollector& stats);
+  ~ScopedThreadLocalArena();
+
+  ScopedThreadLocalArena(const ScopedThreadLocalArena&) = delete;
+  ScopedThreadLocalArena& operator=(const ScopedThreadLocalArena&) = delete;
+
+  UnsafeArenaBufferFactory& arena() { return *arena_; }
+
+ private:
+  UnsafeArenaBufferFactory* arena_;
+  std::unique_ptr<UnsafeArenaBufferFactory> temporary_arena_;
+  ArenaStatsCollector& stats_;
+};
+
 absl::Status VerifyAllInputsAreAvailable(
     const ExprNodePtr& expr,
     const absl::flat_hash_map<std::string, QTypePtr>& input_types);
@@ -179,6 +391,7 @@ class ModelExecutor {
                                     /*side_outputs=*/{}),
         _ << "while compiling the expression");
     std::unique_ptr<CompiledExpr> compiled_expr_with_side_output;
+    std::vector<std::unique_ptr<CompiledExpr>> side_output_variants;
     if (slot_listener != nullptr) {
       ASSIGN_OR_RETURN(
           side_outputs,
@@ -188,10 +401,34 @@ class ModelExecutor {
                        CompileForDynamicEvaluation(eval_options, stripped_expr,
                                                    input_types, side_outputs),
                        _ << "while compiling the expression with side outputs");
+      side_output_variants.reserve(options.side_output_variants.size());
+      for (const auto& names : options.side_output_variants) {
+        absl::flat_hash_map<std::string, ExprNodePtr> variant_side_outputs;
+        for (const auto& name : names) {
+          auto it = side_outputs.find(name);
+          if (it == side_outputs.end()) {
+            return absl::InvalidArgumentError(absl::StrFormat(
+                "side output %s from side_output_variants is not exported by "
+                "the expression or not listened",
+                name));
+          }
+          variant_side_outputs.emplace(name, it->second);
+        }
+        ASSIGN_OR_RETURN(
+            auto variant,
+            CompileForDynamicEvaluation(eval_options, stripped_expr,
+                                        input_types, variant_side_outputs),
+            _ << "while compiling a side output variant");
+        side_output_variants.push_back(std::move(variant));
+      }
+    } else if (!options.side_output_variants.empty()) {
+      return absl::InvalidArgumentError(
+          "side_output_variants require a SlotListener");
     }
-    return ModelExecutor::Bind(*compiled_expr, input_loader,
-                               compiled_expr_with_side_output.get(),
-                               slot_listener, options);
+    return ModelExecutor::BindImpl(*compiled_expr, input_loader,
+                                   compiled_expr_with_side_output.get(),
+                                   side_output_variants, slot_listener,
+                                   options);
   }
 
   // Binds compiled expression to the given input_loader and creates
@@ -203,17 +440,12 @@ class ModelExecutor {
       const CompiledExpr* compiled_expr_with_side_output = nullptr,
       const SlotListener<SideOutput>* slot_listener = nullptr,
       const ModelExecutorOptions& options = {}) {
-    FrameLayout::Builder layout_builder;
-    auto input_slots = AddSlotsMap((compiled_expr_with_side_output != nullptr
-                                        ? compiled_expr_with_side_output
-                                        : &compiled_expr)
-                                       ->input_types(),
-                                   &layout_builder);
-    ASSIGN_OR_RETURN(auto bound_loader, input_loader.Bind(input_slots),
-                     _ << "while binding the input loader");
-    return ModelExecutor::BindToSlots(
-        &layout_builder, compiled_expr, compiled_expr_with_side_output,
-        std ::move(input_slots), bound_loader, slot_listener, options);
+    if (!options.side_output_variants.empty()) {
+      return absl::InvalidArgumentError(
+          "side_output_variants are only supported by ModelExecutor::Compile");
+    }
+    return BindImpl(compiled_expr, input_loader, compiled_expr_with_side_output,
+                    /*side_output_variants=*/{}, slot_listener, options);
   }
 
   // Executes the expression on the given input.
@@ -231,23 +463,121 @@ class ModelExecutor {
                                  const Input& input,
                                  SideOutput* side_output = nullptr) {
     DCHECK(IsValid());
+    absl::StatusOr<Output> res;
     if (arena_ != nullptr) {
-      EvaluationContext ctx(arena_.get());
-      absl::StatusOr<Output> res = ExecuteOnFrame</*kInitLiterals=*/false>(
-          ctx, alloc_.frame(), input, side_output);
+      EvaluationContext ctx(arena_.get(), options.cancellation_context);
+      ctx.set_row_errors(options.row_errors);
+      res = ExecuteOnFrame</*kInitLiterals=*/false>(
+          ctx, alloc_.frame(), options.side_output_variant,
+          !options.bypass_output_cache, input, side_output);
+      shared_data_->arena_stats->Update(arena_->GetStats());
       arena_->Reset();  // reusing arena memory
-      return res;
     } else {
-      EvaluationContext ctx(options.buffer_factory);
-      return ExecuteOnFrame</*kInitLiterals=*/false>(ctx, alloc_.frame(), input,
-                                                     side_output);
+      EvaluationContext ctx(options.buffer_factory,
+                            options.cancellation_context);
+      ctx.set_row_errors(options.row_errors);
+      res = ExecuteOnFrame</*kInitLiterals=*/false>(
+          ctx, alloc_.frame(), options.side_output_variant,
+          !options.bypass_output_cache, input, side_output);
     }
+    // The trivially destructible fields are not reset, so the frames copied
+    // from the literal image need no reinitialization.
+    if (shared_data_->reset_frame_after_execution &&
+        !shared_data_->literal_image.IsValid()) {
+      FramePtr frame = alloc_.frame();
+      shared_data_->layout.ResetAlloc(frame.GetRawPointer(0),
+                                      shared_data_->reset_plan);
+      if (shared_data_->reinitialize_literals_after_reset) {
+        RETURN_IF_ERROR(InitializeLiterals(*shared_data_, frame));
+      }
+    }
+    return res;
   }
   absl::StatusOr<Output> Execute(const Input& input,
                                  SideOutput* side_output = nullptr) {
     return Execute({}, input, side_output);
   }
 
+  // Executes the expression on each of the `inputs` and stores the results
+  // into the corresponding elements of the preallocated `outputs` range.
+  //
+  // If options.threading is provided, the inputs are split into contiguous
+  // chunks that are evaluated concurrently: the first chunk by this executor
+  // in the current thread, the others by executors Clone()-d for this call.
+  // See ModelBatchEvaluationOptions::threading for the requirements on
+  // options.eval_options in this case.
+  //
+  // NOTE: FrameIterator::ForEachFrame is not used here: it iterates over the
+  // elements of array slots, while the inputs here are arbitrary Input structs
+  // loaded by the InputLoader into the frame of each executor.
+  //
+  // Returns the first error encountered (in the input order of chunks); the
+  // outputs for the failed chunks are left in unspecified state.
+  //
+  // The function is not thread safe, same as Execute().
+  absl::Status ExecuteBatch(const ModelBatchEvaluationOptions& options,
+                            absl::Span<const Input> inputs,
+                            absl::Span<Output> outputs) {
+    DCHECK(IsValid());
+    if (inputs.size() != outputs.size()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "inputs and outputs sizes mismatch: %d vs %d", inputs.size(),
+          outputs.size()));
+    }
+    if (options.eval_options.row_errors != nullptr) {
+      return absl::InvalidArgumentError(
+          "row_errors is not supported by ExecuteBatch");
+    }
+    const int64_t size = inputs.size();
+    int thread_count = 1;
+    if (options.threading != nullptr) {
+      const int64_t min_inputs_per_thread =
+          std::max<int64_t>(options.min_inputs_per_thread, 1);
+      thread_count = std::clamp<int64_t>(
+          (size + min_inputs_per_thread - 1) / min_inputs_per_thread, 1,
+          std::max(options.threading->GetRecommendedThreadCount(), 1));
+    }
+    if (thread_count > 1 && arena_ == nullptr &&
+        options.eval_options.buffer_factory != GetHeapBufferFactory()) {
+      return absl::InvalidArgumentError(
+          "ExecuteBatch with threading requires the heap buffer_factory, as "
+          "the buffer factory is shared between the threads");
+    }
+    auto execute_range = [&](ModelExecutor& executor, int64_t begin,
+                             int64_t end) -> absl::Status {
+      for (int64_t i = begin; i < end; ++i) {
+        ASSIGN_OR_RETURN(outputs[i],
+                         executor.Execute(options.eval_options, inputs[i]));
+      }
+      return absl::OkStatus();
+    };
+    if (thread_count == 1) {
+      return execute_range(*this, 0, size);
+    }
+
+    std::vector<ModelExecutor> executors;
+    executors.reserve(thread_count - 1);
+    for (int i = 1; i < thread_count; ++i) {
+      ASSIGN_OR_RETURN(auto executor, Clone());
+      executors.push_back(std::move(executor));
+    }
+    const int64_t chunk_size = (size + thread_count - 1) / thread_count;
+    std::vector<absl::Status> statuses(thread_count);
+    ParallelFor(*options.threading, thread_count, [&](int64_t i) {
+      statuses[i] = execute_range(i == 0 ? *this : executors[i - 1],
+                                  std::min(size, i * chunk_size),
+                                  std::min(size, (i + 1) * chunk_size));
+    });
+    for (auto& status : statuses) {
+      RETURN_IF_ERROR(std::move(status));
+    }
+    return absl::OkStatus();
+  }
+  absl::Status ExecuteBatch(absl::Span<const Input> inputs,
+                            absl::Span<Output> outputs) {
+    return ExecuteBatch({}, inputs, outputs);
+  }
+
   // Executes the expression on the given input allocating on heap.
   // Function is thread safe, but has the following overhead
   // 0. Heap allocation
@@ -257,12 +587,21 @@ class ModelExecutor {
       const ModelEvaluationOptions& options, const Input& input,
       SideOutput* side_output = nullptr) const {
     if (arena_ != nullptr) {
-      UnsafeArenaBufferFactory arena(shared_data_->arena_page_size);
-      EvaluationContext ctx(&arena);
-      return ExecuteOnHeapWithContext(ctx, input, side_output);
+      model_executor_impl::ScopedThreadLocalArena arena(
+          shared_data_->arena_page_size, shared_data_->arena_reserved_bytes,
+          *shared_data_->arena_stats);
+      EvaluationContext ctx(&arena.arena(), options.cancellation_context);
+      ctx.set_row_errors(options.row_errors);
+      return ExecuteOnHeapWithContext(ctx, options.side_output_variant,
+                                      !options.bypass_output_cache, input,
+                                      side_output);
     } else {
-      EvaluationContext ctx(options.buffer_factory);
-      return ExecuteOnHeapWithContext(ctx, input, side_output);
+      EvaluationContext ctx(options.buffer_factory,
+                            options.cancellation_context);
+      ctx.set_row_errors(options.row_errors);
+      return ExecuteOnHeapWithContext(ctx, options.side_output_variant,
+                                      !options.bypass_output_cache, input,
+                                      side_output);
     }
   }
 
@@ -291,12 +630,21 @@ class ModelExecutor {
         << " non standard alignment required <=" << alignof(size_t)
         << " actual:" << shared_data_->layout.AllocAlignment().value;
     if (arena_ != nullptr) {
-      UnsafeArenaBufferFactory arena(shared_data_->arena_page_size);
-      EvaluationContext ctx(&arena);
-      return ExecuteOnStackWithContext<kStackSize>(ctx, input, side_output);
+      model_executor_impl::ScopedThreadLocalArena arena(
+          shared_data_->arena_page_size, shared_data_->arena_reserved_bytes,
+          *shared_data_->arena_stats);
+      EvaluationContext ctx(&arena.arena(), options.cancellation_context);
+      ctx.set_row_errors(options.row_errors);
+      return ExecuteOnStackWithContext<kStackSize>(
+          ctx, options.side_output_variant, !options.bypass_output_cache,
+          input, side_output);
     } else {
-      EvaluationContext ctx(options.buffer_factory);
-      return ExecuteOnStackWithContext<kStackSize>(ctx, input, side_output);
+      EvaluationContext ctx(options.buffer_factory,
+                            options.cancellation_context);
+      ctx.set_row_errors(options.row_errors);
+      return ExecuteOnStackWithContext<kStackSize>(
+          ctx, options.side_output_variant, !options.bypass_output_cache,
+          input, side_output);
     }
   }
 
@@ -307,19 +655,150 @@ class ModelExecutor {
   // literals initialization.
   absl::StatusOr<ModelExecutor> Clone() const { return Create(shared_data_); }
 
+  // Creates a copy of ModelExecutor with some of the literals replaced.
+  //
+  // `new_literals` maps fingerprints of the literal values used in the model
+  // (i.e. TypedValue::GetFingerprint()) to the new values of the same QTypes.
+  // The frame layout and the bound operators are reused, only the literals
+  // initialization is changed. So it is much cheaper than compiling the
+  // updated expression from scratch, e.g. when a retrained model differs only
+  // in thresholds.
+  //
+  // NOTE: The compilation may fold or deduplicate literals, so only the
+  // literals that survived in the compiled model can be replaced, an error is
+  // returned for the others. Not supported for codegen models.
+  absl::StatusOr<ModelExecutor> WithReplacedLiterals(
+      const absl::flat_hash_map<Fingerprint, TypedValue>& new_literals) const {
+    std::vector<std::shared_ptr<const BoundExpr>> exprs = {
+        shared_data_->evaluator, shared_data_->evaluator_with_side_output};
+    for (const auto& variant : shared_data_->side_output_variants) {
+      exprs.push_back(variant.evaluator);
+    }
+    ASSIGN_OR_RETURN(auto evaluators, model_executor_impl::ReplaceLiterals(
+                                          exprs, new_literals));
+    std::vector<SideOutputVariant> side_output_variants;
+    side_output_variants.reserve(shared_data_->side_output_variants.size());
+    for (size_t i = 0; i < shared_data_->side_output_variants.size(); ++i) {
+      side_output_variants.push_back(
+          {std::move(evaluators[i + 2]),
+           shared_data_->side_output_variants[i].bound_listener});
+    }
+    auto shared_data = std::make_shared<SharedData>(
+        SharedData{.layout = shared_data_->layout,
+                   .bound_loader = shared_data_->bound_loader,
+                   .evaluator = std::move(evaluators[0]),
+                   .evaluator_with_side_output = std::move(evaluators[1]),
+                   .output_slot = shared_data_->output_slot,
+                   .bound_listener = shared_data_->bound_listener,
+                   .side_output_variants = std::move(side_output_variants),
+                   .arena_page_size = shared_data_->arena_page_size,
+                   .arena_reserved_bytes = shared_data_->arena_reserved_bytes,
+                   .reset_frame_after_execution =
+                       shared_data_->reset_frame_after_execution,
+                   .output_cache =
+                       shared_data_->output_cache != nullptr
+                           ? shared_data_->output_cache->CloneEmpty()
+                           : nullptr});
+    RETURN_IF_ERROR(InitializeLiteralImage(*shared_data));
+    InitializeResetPlan(*shared_data);
+    return Create(std::move(shared_data));
+  }
+
+  // Returns arena statistics aggregated over this executor and all its clones:
+  // the max number of bytes used by a single evaluation, and the max number of
+  // pages kept by a single arena. Zeros if the arena is not used.
+  UnsafeArenaBufferFactory::Stats GetArenaStats() const {
+    return shared_data_->arena_stats->Get();
+  }
+
+  // Returns the output cache statistics aggregated over this executor and all
+  // its clones (see ModelExecutorOptions::output_cache). Zeros if the cache is
+  // not used.
+  ModelOutputCacheStats GetOutputCacheStats() const {
+    if (shared_data_->output_cache == nullptr) {
+      return {};
+    }
+    return shared_data_->output_cache->GetStats();
+  }
+
+  // Returns an estimate of the memory owned by this executor: its frame and
+  // the pages kept by its arena. Does not include the memory shared with the
+  // clones (e.g. the bound operators) and the buffers referenced from the
+  // frame.
+  int64_t GetMemoryUsage() const {
+    int64_t result = shared_data_->layout.AllocSize();
+    if (arena_ != nullptr) {
+      result += arena_->GetStats().page_count * shared_data_->arena_page_size;
+    }
+    return result;
+  }
+
+  // Returns a breakdown of the memory used by the model. The literals
+  // registered in `interner` (e.g. the ones deduplicated by
+  // ExprCompiler::SetLiteralInterner) are also reported as shared.
+  ModelMemoryReport GetMemoryReport(
+      absl::Nullable<const TypedValueInterner*> interner = nullptr) const {
+    ModelMemoryReport report;
+    report.frame_bytes = shared_data_->layout.AllocSize();
+    if (arena_ != nullptr) {
+      report.arena_bytes =
+          arena_->GetStats().page_count * shared_data_->arena_page_size;
+    }
+    if (shared_data_->literal_image.IsValid()) {
+      report.literal_image_bytes = shared_data_->layout.AllocSize();
+    }
+    absl::flat_hash_set<const void*> seen_literals;
+    auto add_expr = [&](const std::shared_ptr<const BoundExpr>& expr) {
+      if (expr != nullptr) {
+        model_executor_impl::AddBoundExprMemoryUsage(*expr, interner,
+                                                     seen_literals, report);
+      }
+    };
+    add_expr(shared_data_->evaluator);
+    add_expr(shared_data_->evaluator_with_side_output);
+    for (const auto& variant : shared_data_->side_output_variants) {
+      add_expr(variant.evaluator);
+    }
+    return report;
+  }
+
   // Returns false if the ModelExecutor is invalid. This can happen only in case
   // of use-after-move.
   bool IsValid() const { return alloc_.IsValid() && shared_data_ != nullptr; }
 
  private:
+  struct SideOutputVariant {
+    std::shared_ptr<const BoundExpr> evaluator;
+    BoundSlotListener<SideOutput> bound_listener;
+  };
+
   struct SharedData {
     FrameLayout layout;
     BoundInputLoader<Input> bound_loader;
-    std::unique_ptr<BoundExpr> evaluator;
-    std::unique_ptr<BoundExpr> evaluator_with_side_output = nullptr;
+    std::shared_ptr<const BoundExpr> evaluator;
+    std::shared_ptr<const BoundExpr> evaluator_with_side_output = nullptr;
     typename OutputTraits::OutputSlot output_slot;
     BoundSlotListener<SideOutput> bound_listener = nullptr;
+    // See ModelExecutorOptions::side_output_variants.
+    std::vector<SideOutputVariant> side_output_variants;
     int64_t arena_page_size;  // 0 means no arena should be used
+    int64_t arena_reserved_bytes = 0;
+    bool reset_frame_after_execution = false;
+    // The slots reset after the evaluation if reset_frame_after_execution is
+    // set. If reinitialize_literals_after_reset is false, the plan excludes the
+    // literal slots.
+    FrameLayout::ResetPlan reset_plan;
+    bool reinitialize_literals_after_reset = true;
+    std::unique_ptr<model_executor_impl::ArenaStatsCollector> arena_stats =
+        std::make_unique<model_executor_impl::ArenaStatsCollector>();
+    // See ModelExecutorOptions::output_cache.
+    std::unique_ptr<model_executor_impl::ModelOutputCache<Output>>
+        output_cache = nullptr;
+    // A frame with the literals initialized, built once per model and copied
+    // bytewise into the new frames instead of initializing the literals one by
+    // one. Only set if the layout has only trivial fields (e.g. for the models
+    // on scalars), since the other fields can not be copied bytewise.
+    MemoryAllocation literal_image;
   };
 
   explicit ModelExecutor(std::shared_ptr<const SharedData> shared_data,
@@ -330,78 +809,103 @@ class ModelExecutor {
         alloc_(std::move(alloc)) {}
 
   absl::StatusOr<Output> ExecuteOnHeapWithContext(
-      EvaluationContext& ctx, const Input& input,
-      SideOutput* side_output) const {
+      EvaluationContext& ctx, int side_output_variant, bool use_output_cache,
+      const Input& input, SideOutput* side_output) const {
+    if (shared_data_->literal_image.IsValid()) {
+      auto alloc = MemoryAllocation::TrivialCopyOf(shared_data_->literal_image);
+      return ExecuteOnFrame</*kInitLiterals=*/false>(
+          ctx, alloc.frame(), side_output_variant, use_output_cache, input,
+          side_output);
+    }
     MemoryAllocation alloc(&shared_data_->layout);
-    return ExecuteOnFrame</*kInitLiterals=*/true>(ctx, alloc.frame(), input,
-                                                  side_output);
+    return ExecuteOnFrame</*kInitLiterals=*/true>(
+        ctx, alloc.frame(), side_output_variant, use_output_cache, input,
+        side_output);
   }
 
   template <size_t kStackSize>
   absl::StatusOr<Output> ExecuteOnStackWithContext(
-      EvaluationContext& ctx, const Input& input,
-      SideOutput* side_output) const {
+      EvaluationContext& ctx, int side_output_variant, bool use_output_cache,
+      const Input& input, SideOutput* side_output) const {
     DCHECK_LE(shared_data_->layout.AllocSize(), kStackSize);
     DCHECK_LE(shared_data_->layout.AllocAlignment().value, alignof(size_t));
     alignas(size_t) std::byte memory[kStackSize];  // uninitialized array
+    if (shared_data_->literal_image.IsValid()) {
+      // No destruction is needed for the trivial fields.
+      std::memcpy(memory,
+                  shared_data_->literal_image.frame().GetRawPointer(0),
+                  shared_data_->layout.AllocSize());
+      return ExecuteOnFrame</*kInitLiterals=*/false>(
+          ctx, FramePtr(&memory, &shared_data_->layout), side_output_variant,
+          use_output_cache, input, side_output);
+    }
     shared_data_->layout.InitializeAlignedAlloc(memory);
     absl::Cleanup destroy_alloc = [&] {
       shared_data_->layout.DestroyAlloc(&memory);
     };
     return ExecuteOnFrame</*kInitLiterals=*/true>(
-        ctx, FramePtr(&memory, &shared_data_->layout), input, side_output);
+        ctx, FramePtr(&memory, &shared_data_->layout), side_output_variant,
+        use_output_cache, input, side_output);
   }
 
   template <bool kInitLiterals>
   absl::StatusOr<Output> ExecuteOnFrame(
-      EvaluationContext& ctx, FramePtr frame, const Input& input,
-      ABSL_ATTRIBUTE_UNUSED SideOutput* side_output) const {
+      EvaluationContext& ctx, FramePtr frame,
+      ABSL_ATTRIBUTE_UNUSED int side_output_variant, bool use_output_cache,
+      const Input& input, ABSL_ATTRIBUTE_UNUSED SideOutput* side_output) const {
     if constexpr (std::is_same_v<SideOutput, void>) {
-      return ExecuteOnFrameWithoutSideOutput<kInitLiterals>(ctx, frame, input);
+      return ExecuteOnFrameWithoutSideOutput<kInitLiterals>(
+          ctx, frame, use_output_cache, input);
     } else {
       if (side_output == nullptr) {
-        return ExecuteOnFrameWithoutSideOutput<kInitLiterals>(ctx, frame,
-                                                              input);
+        return ExecuteOnFrameWithoutSideOutput<kInitLiterals>(
+            ctx, frame, use_output_cache, input);
       } else {
-        return ExecuteOnFrameWithSideOutput<kInitLiterals>(ctx, frame, input,
-                                                           side_output);
+        return ExecuteOnFrameWithSideOutput<kInitLiterals>(
+            ctx, frame, side_output_variant, input, side_output);
       }
     }
   }
 
   template <bool kInitLiterals>
   absl::StatusOr<Output> ExecuteOnFrameWithSideOutput(
-      EvaluationContext& ctx, FramePtr frame, const Input& input,
-      SideOutput* side_output) const {
+      EvaluationContext& ctx, FramePtr frame, int side_output_variant,
+      const Input& input, SideOutput* side_output) const {
     DCHECK(side_output != nullptr);
+    // Even without evaluator_with_side_output some of the side outputs can be
+    // evaluated, depending on the CompiledExpr passed to Bind.
+    const BoundExpr* evaluator =
+        shared_data_->evaluator_with_side_output != nullptr
+            ? shared_data_->evaluator_with_side_output.get()
+            : shared_data_->evaluator.get();
+    const BoundSlotListener<SideOutput>* bound_listener =
+        &shared_data_->bound_listener;
+    if (side_output_variant >= 0) {
+      if (static_cast<size_t>(side_output_variant) >=
+          shared_data_->side_output_variants.size()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "side_output_variant %d is out of range [0, %d)",
+            side_output_variant, shared_data_->side_output_variants.size()));
+      }
+      const auto& variant =
+          shared_data_->side_output_variants[side_output_variant];
+      evaluator = variant.evaluator.get();
+      bound_listener = &variant.bound_listener;
+    }
     ctx.set_status(
         shared_data_->bound_loader(input, frame, &ctx.buffer_factory()));
     // NOTE: Avoid using RETURN_IF_ERROR for performance reasons.
-    if (shared_data_->evaluator_with_side_output != nullptr) {
-      if constexpr (kInitLiterals) {
-        if (ctx.status().ok()) {
-          shared_data_->evaluator_with_side_output->InitializeLiterals(&ctx,
-                                                                       frame);
-        }
-      }
-      if (ctx.status().ok()) {
-        shared_data_->evaluator_with_side_output->Execute(&ctx, frame);
-      }
-    } else {
-      if constexpr (kInitLiterals) {
-        if (ctx.status().ok()) {
-          shared_data_->evaluator->InitializeLiterals(&ctx, frame);
-        }
-      }
-      // Even in this case some of the side outputs can be evaluated,
-      // depending on the CompiledExpr passed to Bind.
+    if constexpr (kInitLiterals) {
       if (ctx.status().ok()) {
-        shared_data_->evaluator->Execute(&ctx, frame);
+        evaluator->InitializeLiterals(&ctx, frame);
       }
     }
     if (ctx.status().ok()) {
-      if (shared_data_->bound_listener) {
-        ctx.set_status(shared_data_->bound_listener(frame, side_output));
+      evaluator->Execute(&ctx, frame);
+    }
+    if (ctx.status().ok()) {
+      if (*bound_listener) {
+        ctx.set_status((*bound_listener)(frame, side_output));
       } else {
         ctx.set_status(absl::InvalidArgumentError(
             "Unable to collect side output, since slot listener was not "
@@ -416,7 +920,8 @@ class ModelExecutor {
 
   template <bool kInitLiterals>
   absl::StatusOr<Output> ExecuteOnFrameWithoutSideOutput(
-      EvaluationContext& ctx, FramePtr frame, const Input& input) const {
+      EvaluationContext& ctx, FramePtr frame,
+      ABSL_ATTRIBUTE_UNUSED bool use_output_cache, const Input& input) const {
     ctx.set_status(
         shared_data_->bound_loader(input, frame, &ctx.buffer_factory()));
     // NOTE: Avoid using RETURN_IF_ERROR for performance reasons.
@@ -425,13 +930,26 @@ class ModelExecutor {
         shared_data_->evaluator->InitializeLiterals(&ctx, frame);
       }
     }
-    if (ctx.status().ok()) {
-      shared_data_->evaluator->Execute(&ctx, frame);
-    }
-    if (ctx.status().ok()) {
-      return OutputTraits::ExtractOutput(shared_data_->output_slot, frame);
+    auto evaluate = [&]() -> absl::StatusOr<Output> {
+      if (ctx.status().ok()) {
+        shared_data_->evaluator->Execute(&ctx, frame);
+      }
+      if (ctx.status().ok()) {
+        return OutputTraits::ExtractOutput(shared_data_->output_slot, frame);
+      }
+      return ctx.status();
+    };
+    if constexpr (std::is_copy_constructible_v<Output>) {
+      // NOTE: The fingerprint must be computed before the evaluation, because
+      // the compiled expression may override the input slots. The cached
+      // outputs do not carry the row errors, so the cache is bypassed when
+      // they are requested.
+      if (use_output_cache && shared_data_->output_cache != nullptr &&
+          ctx.status().ok() && ctx.row_errors() == nullptr) {
+        return shared_data_->output_cache->GetOrEvaluate(frame, evaluate);
+      }
     }
-    return ctx.status();
+    return evaluate();
   }
 
   static absl::StatusOr<ModelExecutor> Create(
@@ -448,23 +966,105 @@ class ModelExecutor {
       // of arena stored without unique_ptr will effectively make
       // RootEvaluationContext invalid.
       arena = std::make_unique<UnsafeArenaBufferFactory>(page_size);
+      arena->Reserve(shared_data->arena_reserved_bytes);
+    }
+    if (shared_data->literal_image.IsValid()) {
+      auto alloc = MemoryAllocation::TrivialCopyOf(shared_data->literal_image);
+      return ModelExecutor(std::move(shared_data), std::move(arena),
+                           std::move(alloc));
     }
-    EvaluationContext ctx;
     MemoryAllocation alloc(&shared_data->layout);
-    shared_data->evaluator->InitializeLiterals(&ctx, alloc.frame());
+    RETURN_IF_ERROR(InitializeLiterals(*shared_data, alloc.frame()));
+    return ModelExecutor(std::move(shared_data), std::move(arena),
+                         std::move(alloc));
+  }
+
+  // Initializes SharedData::literal_image if the frame can be copied bytewise.
+  static absl::Status InitializeLiteralImage(SharedData& shared_data) {
+    if (!shared_data.layout.HasOnlyTrivialFields()) {
+      return absl::OkStatus();
+    }
+    MemoryAllocation image(&shared_data.layout);
+    RETURN_IF_ERROR(InitializeLiterals(shared_data, image.frame()));
+    shared_data.literal_image = std::move(image);
+    return absl::OkStatus();
+  }
+
+  // Initializes SharedData::reset_plan if reset_frame_after_execution is set.
+  static void InitializeResetPlan(SharedData& shared_data) {
+    if (!shared_data.reset_frame_after_execution ||
+        shared_data.literal_image.IsValid()) {
+      return;
+    }
+    std::vector<std::pair<size_t, size_t>> literal_ranges;
+    bool literal_slots_known = true;
+    auto add_expr = [&](const std::shared_ptr<const BoundExpr>& expr) {
+      if (expr == nullptr || !literal_slots_known) {
+        return;
+      }
+      auto ranges = model_executor_impl::GetLiteralSlotRanges(*expr);
+      if (!ranges.has_value()) {
+        literal_slots_known = false;
+        return;
+      }
+      literal_ranges.insert(literal_ranges.end(), ranges->begin(),
+                            ranges->end());
+    };
+    add_expr(shared_data.evaluator);
+    add_expr(shared_data.evaluator_with_side_output);
+    for (const auto& variant : shared_data.side_output_variants) {
+      add_expr(variant.evaluator);
+    }
+    if (!literal_slots_known) {
+      literal_ranges.clear();
+    }
+    shared_data.reset_plan = shared_data.layout.MakeResetPlan(literal_ranges);
+    shared_data.reinitialize_literals_after_reset = !literal_slots_known;
+  }
+
+  static absl::Status InitializeLiterals(const SharedData& shared_data,
+                                         FramePtr frame) {
+    EvaluationContext ctx;
+    shared_data.evaluator->InitializeLiterals(&ctx, frame);
     RETURN_IF_ERROR(ctx.status());
-    if (shared_data->evaluator_with_side_output != nullptr) {
-      shared_data->evaluator_with_side_output->InitializeLiterals(
-          &ctx, alloc.frame());
+    if (shared_data.evaluator_with_side_output != nullptr) {
+      shared_data.evaluator_with_side_output->InitializeLiterals(&ctx, frame);
       RETURN_IF_ERROR(ctx.status());
     }
-    return ModelExecutor(std::move(shared_data), std::move(arena),
-                         std::move(alloc));
+    for (const auto& variant : shared_data.side_output_variants) {
+      variant.evaluator->InitializeLiterals(&ctx, frame);
+      RETURN_IF_ERROR(ctx.status());
+    }
+    return absl::OkStatus();
+  }
+
+  static absl::StatusOr<ModelExecutor> BindImpl(
+      const CompiledExpr& compiled_expr, const InputLoader<Input>& input_loader,
+      const CompiledExpr* compiled_expr_with_side_output,
+      absl::Span<const std::unique_ptr<CompiledExpr>> side_output_variants,
+      const SlotListener<SideOutput>* slot_listener,
+      const ModelExecutorOptions& options) {
+    FrameLayout::Builder layout_builder;
+    if (options.reuse_frame_padding) {
+      layout_builder.EnablePaddingReuse();
+    }
+    auto input_slots = AddSlotsMap((compiled_expr_with_side_output != nullptr
+                                        ? compiled_expr_with_side_output
+                                        : &compiled_expr)
+                                       ->input_types(),
+                                   &layout_builder);
+    ASSIGN_OR_RETURN(auto bound_loader, input_loader.Bind(input_slots),
+                     _ << "while binding the input loader");
+    return ModelExecutor::BindToSlots(
+        &layout_builder, compiled_expr, compiled_expr_with_side_output,
+        side_output_variants, std::move(input_slots), bound_loader,
+        slot_listener, options);
   }
 
   static absl::StatusOr<ModelExecutor> BindToSlots(
       FrameLayout::Builder* layout_builder, const CompiledExpr& compiled_expr,
       const CompiledExpr* compiled_expr_with_side_output,
+      absl::Span<const std::unique_ptr<CompiledExpr>> side_output_variant_exprs,
       absl::flat_hash_map<std::string, TypedSlot> input_slots,
       BoundInputLoader<Input> bound_loader,
       const SlotListener<SideOutput>* slot_listener,
@@ -511,21 +1111,54 @@ class ModelExecutor {
         _ << "requested output type does not correspond to the expression");
 
     BoundSlotListener<SideOutput> bound_listener = nullptr;
+    std::vector<SideOutputVariant> side_output_variants;
     if (slot_listener != nullptr) {
-      ASSIGN_OR_RETURN(auto maybe_bound_listener,
-                       slot_listener->PartialBind(
+      ASSIGN_OR_RETURN(bound_listener,
+                       PartialBindListener(
+                           *slot_listener,
                            (executable_expr_with_side_output != nullptr
                                 ? executable_expr_with_side_output
                                 : executable_expr)
-                               ->named_output_slots()),
-                       _ << "while binding the slot listener");
-      // Note: PartialBind returns missing when no slots are listened. But for
-      // us it only happens with ignore_not_listened_named_outputs = true, so
-      // we silently ignore it here.
-      bound_listener =
-          maybe_bound_listener.has_value()
-              ? *maybe_bound_listener
-              : [](ConstFramePtr, SideOutput*) { return absl::OkStatus(); };
+                               ->named_output_slots()));
+      side_output_variants.reserve(side_output_variant_exprs.size());
+      for (const auto& variant_expr : side_output_variant_exprs) {
+        auto variant_expr_with_casts = model_executor_impl::CastOutputsIfNeeded(
+            *variant_expr, output_qtype, slot_listener, options);
+        ASSIGN_OR_RETURN(std::shared_ptr<const BoundExpr> variant_evaluator,
+                         variant_expr_with_casts->Bind(
+                             layout_builder, input_slots,
+                             executable_expr->output_slot()),
+                         _ << "while binding a side output variant");
+        ASSIGN_OR_RETURN(
+            auto variant_listener,
+            PartialBindListener(*slot_listener,
+                                variant_evaluator->named_output_slots()));
+        side_output_variants.push_back(
+            {std::move(variant_evaluator), std::move(variant_listener)});
+      }
+    }
+    std::unique_ptr<model_executor_impl::ModelOutputCache<Output>>
+        output_cache;
+    if (options.output_cache.capacity > 0) {
+      if constexpr (!std::is_copy_constructible_v<Output>) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "output cache can not be used with ModelExecutor returning %s",
+            TypeName<Output>()));
+      } else {
+        std::vector<std::pair<std::string, TypedSlot>> named_input_slots(
+            input_slots.begin(), input_slots.end());
+        std::sort(
+            named_input_slots.begin(), named_input_slots.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+        std::vector<TypedSlot> cache_input_slots;
+        cache_input_slots.reserve(named_input_slots.size());
+        for (const auto& [name, slot] : named_input_slots) {
+          cache_input_slots.push_back(slot);
+        }
+        output_cache =
+            std::make_unique<model_executor_impl::ModelOutputCache<Output>>(
+                options.output_cache, std::move(cache_input_slots));
+      }
     }
     auto shared_data = std::make_shared<SharedData>(
         SharedData{.layout = std::move(*layout_builder).Build(),
@@ -535,11 +1168,33 @@ class ModelExecutor {
                        std::move(executable_expr_with_side_output),
                    .output_slot = output_slot,
                    .bound_listener = std::move(bound_listener),
-                   .arena_page_size = options.arena_page_size});
+                   .side_output_variants = std::move(side_output_variants),
+                   .arena_page_size = options.arena_page_size,
+                   .arena_reserved_bytes = options.arena_reserved_bytes,
+                   .reset_frame_after_execution =
+                       options.reset_frame_after_execution,
+                   .output_cache = std::move(output_cache)});
+    RETURN_IF_ERROR(InitializeLiteralImage(*shared_data));
+    InitializeResetPlan(*shared_data);
 
     return Create(shared_data);
   }
 
+  static absl::StatusOr<BoundSlotListener<SideOutput>> PartialBindListener(
+      const SlotListener<SideOutput>& slot_listener,
+      const absl::flat_hash_map<std::string, TypedSlot>& slots) {
+    ASSIGN_OR_RETURN(auto maybe_bound_listener,
+                     slot_listener.PartialBind(slots),
+                     _ << "while binding the slot listener");
+    // Note: PartialBind returns missing when no slots are listened. But for
+    // us it only happens with ignore_not_listened_named_outputs = true or for
+    // an empty side output variant, so we silently ignore it here.
+    if (!maybe_bound_listener.has_value()) {
+      return [](ConstFramePtr, SideOutput*) { return absl::OkStatus(); };
+    }
+    return *std::move(maybe_bound_listener);
+  }
+
   std::shared_ptr<const SharedData> shared_data_;
   std::unique_ptr<UnsafeArenaBufferFactory> arena_;
   MemoryAllocation alloc_;
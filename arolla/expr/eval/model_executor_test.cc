@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
@@ -32,10 +33,12 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/expr/eval/eval.h"
+#include "arolla/expr/eval/model_output_cache.h"
 #include "arolla/expr/eval/side_output.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_operator_signature.h"
@@ -44,6 +47,7 @@
 #include "arolla/io/accessors_input_loader.h"
 #include "arolla/io/input_loader.h"
 #include "arolla/io/slot_listener.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
@@ -55,9 +59,13 @@
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/testing/qtype.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/qtype/typed_value_interner.h"
 #include "arolla/qtype/unspecified_qtype.h"
 #include "arolla/util/bytes.h"
+#include "arolla/util/fingerprint.h"
 #include "arolla/util/init_arolla.h"
+#include "arolla/util/row_errors.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -218,6 +226,53 @@ TEST_F(ModelExecutorTest, SimpleExpr) {
   }
 }
 
+TEST_F(ModelExecutorTest, ExecuteBatch) {
+  ASSERT_OK_AND_ASSIGN(auto x_plus_y,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      (ModelExecutor<TestInputs, int64_t>::Compile(x_plus_y, *input_loader)));
+
+  std::vector<TestInputs> inputs;
+  std::vector<int64_t> expected_outputs;
+  for (int64_t i = 0; i < 1000; ++i) {
+    inputs.push_back(TestInputs{i, 2 * i});
+    expected_outputs.push_back(3 * i);
+  }
+  {  // single thread
+    std::vector<int64_t> outputs(inputs.size());
+    ASSERT_OK(executor.ExecuteBatch(inputs, absl::MakeSpan(outputs)));
+    EXPECT_EQ(outputs, expected_outputs);
+  }
+  {  // multiple threads
+    StdThreading threading(4);
+    std::vector<int64_t> outputs(inputs.size());
+    ASSERT_OK(executor.ExecuteBatch(
+        {.threading = &threading, .min_inputs_per_thread = 10}, inputs,
+        absl::MakeSpan(outputs)));
+    EXPECT_EQ(outputs, expected_outputs);
+  }
+  {  // non-heap buffer factory with threading
+    StdThreading threading(4);
+    UnsafeArenaBufferFactory arena(1024);
+    std::vector<int64_t> outputs(inputs.size());
+    EXPECT_THAT(
+        executor.ExecuteBatch({.eval_options = {.buffer_factory = &arena},
+                               .threading = &threading,
+                               .min_inputs_per_thread = 10},
+                              inputs, absl::MakeSpan(outputs)),
+        StatusIs(absl::StatusCode::kInvalidArgument,
+                 HasSubstr("requires the heap buffer_factory")));
+  }
+  {  // sizes mismatch
+    std::vector<int64_t> outputs(inputs.size() - 1);
+    EXPECT_THAT(executor.ExecuteBatch(inputs, absl::MakeSpan(outputs)),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("inputs and outputs sizes mismatch")));
+  }
+}
+
 TEST_F(ModelExecutorTest, ReturnsStdOptional) {
   ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
   {
@@ -361,6 +416,324 @@ TEST_F(ModelExecutorTest, ExternalBufferFactory) {
   EXPECT_TRUE(res.is_owned());
 }
 
+TEST_F(ModelExecutorTest, ResetFrameAfterExecution) {
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {Leaf("x"), Literal(CreateDenseArray<int64_t>({10, 20, 30}))}));
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      CreateAccessorsInputLoader<DenseArray<int64_t>>(
+          "x", [](const DenseArray<int64_t>& x) { return x; }));
+  std::vector<int64_t> values = {1, 2, 3};
+  std::weak_ptr<int> weak_holder;
+  auto make_input = [&] {
+    auto holder = std::make_shared<int>(0);
+    weak_holder = holder;
+    return DenseArray<int64_t>{Buffer<int64_t>(std::move(holder), values)};
+  };
+
+  {
+    ASSERT_OK_AND_ASSIGN(auto executor,
+                         (ModelExecutor<DenseArray<int64_t>,
+                                        DenseArray<int64_t>>::Compile(
+                             expr, *input_loader)));
+    EXPECT_THAT(executor.Execute(make_input()),
+                IsOkAndHolds(ElementsAre(11, 22, 33)));
+    // The input is still referenced from the executor's frame.
+    EXPECT_FALSE(weak_holder.expired());
+  }
+  {
+    ModelExecutorOptions options;
+    options.reset_frame_after_execution = true;
+    ASSERT_OK_AND_ASSIGN(auto executor,
+                         (ModelExecutor<DenseArray<int64_t>,
+                                        DenseArray<int64_t>>::Compile(
+                             expr, *input_loader, nullptr, options)));
+    EXPECT_THAT(executor.Execute(make_input()),
+                IsOkAndHolds(ElementsAre(11, 22, 33)));
+    EXPECT_TRUE(weak_holder.expired());
+    // The literal slot is kept in place by the reset.
+    EXPECT_THAT(executor.Execute(make_input()),
+                IsOkAndHolds(ElementsAre(11, 22, 33)));
+    EXPECT_TRUE(weak_holder.expired());
+  }
+}
+
+TEST_F(ModelExecutorTest, RowErrors) {
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.floordiv",
+             {Leaf("x"), Literal(CreateDenseArray<int64_t>({2, 0, 1, 0}))}));
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      CreateAccessorsInputLoader<DenseArray<int64_t>>(
+          "x", [](const DenseArray<int64_t>& x) { return x; }));
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      (ModelExecutor<DenseArray<int64_t>, DenseArray<int64_t>>::Compile(
+          expr, *input_loader)));
+  auto input = CreateDenseArray<int64_t>({10, 20, 30, std::nullopt});
+
+  EXPECT_THAT(executor.Execute(input),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("division by zero")));
+
+  RowErrors row_errors;
+  EXPECT_THAT(executor.Execute({.row_errors = &row_errors}, input),
+              IsOkAndHolds(ElementsAre(5, std::nullopt, 30, std::nullopt)));
+  EXPECT_THAT(row_errors.row_ids(), ElementsAre(1));
+  ASSERT_EQ(row_errors.errors().size(), 1);
+  EXPECT_THAT(row_errors.errors()[0].status,
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("division by zero")));
+
+  std::vector<DenseArray<int64_t>> inputs = {input};
+  std::vector<DenseArray<int64_t>> outputs(1);
+  EXPECT_THAT(
+      executor.ExecuteBatch({.eval_options = {.row_errors = &row_errors}},
+                            inputs, absl::MakeSpan(outputs)),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("row_errors is not supported")));
+}
+
+TEST_F(ModelExecutorTest, ScalarLiteralsOnNewFrames) {
+  // The frame has only trivial fields, so the new frames are copied from the
+  // literal image.
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {CallOp("math.multiply", {Leaf("x"), Literal<int64_t>(2)}),
+              CallOp("math.multiply", {Leaf("y"), Literal<int64_t>(3)})}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  ModelExecutorOptions options;
+  options.reset_frame_after_execution = true;
+  ASSERT_OK_AND_ASSIGN(auto executor, CompileModelExecutor<int64_t>(
+                                          expr, *input_loader, options));
+  EXPECT_THAT(executor.Execute(TestInputs{5, 7}), IsOkAndHolds(31));
+  EXPECT_THAT(executor.Execute(TestInputs{1, 1}), IsOkAndHolds(5));
+  EXPECT_THAT(executor.ExecuteOnHeap({}, TestInputs{5, 7}), IsOkAndHolds(31));
+  ASSERT_TRUE(executor.CanExecuteOnStack(1024));
+  EXPECT_THAT(executor.ExecuteOnStack<1024>({}, TestInputs{5, 7}),
+              IsOkAndHolds(31));
+  ASSERT_OK_AND_ASSIGN(auto clone, executor.Clone());
+  EXPECT_THAT(clone.Execute(TestInputs{5, 7}), IsOkAndHolds(31));
+}
+
+TEST_F(ModelExecutorTest, ReuseFramePadding) {
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("core.where",
+             {CallOp("core.less", {Leaf("x"), Leaf("y")}),
+              CallOp("math.add", {Leaf("x"), Leaf("y")}), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  ModelExecutorOptions options;
+  ASSERT_OK_AND_ASSIGN(auto executor, CompileModelExecutor<int64_t>(
+                                          expr, *input_loader, options));
+  options.reuse_frame_padding = true;
+  ASSERT_OK_AND_ASSIGN(
+      auto compact_executor,
+      CompileModelExecutor<int64_t>(expr, *input_loader, options));
+  EXPECT_LE(compact_executor.GetMemoryUsage(), executor.GetMemoryUsage());
+  EXPECT_THAT(compact_executor.Execute(TestInputs{5, 7}), IsOkAndHolds(12));
+  EXPECT_THAT(compact_executor.Execute(TestInputs{7, 5}), IsOkAndHolds(5));
+}
+
+TEST_F(ModelExecutorTest, GetMemoryReport) {
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add", {Leaf("x"), Literal(CreateFullDenseArray<int64_t>(
+                                         std::vector<int64_t>(1000, 1)))}));
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      CreateAccessorsInputLoader<DenseArray<int64_t>>(
+          "x", [](const DenseArray<int64_t>& x) { return x; }));
+  {
+    ASSERT_OK_AND_ASSIGN(auto executor,
+                         (ModelExecutor<DenseArray<int64_t>,
+                                        DenseArray<int64_t>>::Compile(
+                             expr, *input_loader)));
+    ModelMemoryReport report = executor.GetMemoryReport();
+    EXPECT_EQ(report.frame_bytes, executor.GetMemoryUsage());
+    EXPECT_GE(report.literal_bytes, 1000 * sizeof(int64_t));
+    EXPECT_EQ(report.shared_literal_bytes, 0);
+    EXPECT_EQ(report.pool_bytes, 0);
+    EXPECT_GE(report.total_bytes(), report.frame_bytes + report.literal_bytes);
+  }
+  {
+    TypedValueInterner interner;
+    ModelExecutorOptions options;
+    options.eval_options.literal_interner = &interner;
+    ASSERT_OK_AND_ASSIGN(auto executor,
+                         (ModelExecutor<DenseArray<int64_t>,
+                                        DenseArray<int64_t>>::Compile(
+                             expr, *input_loader, nullptr, options)));
+    ModelMemoryReport report = executor.GetMemoryReport(&interner);
+    EXPECT_GE(report.shared_literal_bytes, 1000 * sizeof(int64_t));
+    EXPECT_LE(report.shared_literal_bytes, report.literal_bytes);
+  }
+}
+
+TEST_F(ModelExecutorTest, OutputCache) {
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  ModelExecutorOptions options;
+  options.output_cache.capacity = 2;
+  options.output_cache.shard_count = 1;
+  options.output_cache.calibration_calls = 0;
+  ASSERT_OK_AND_ASSIGN(auto executor, CompileModelExecutor<int64_t>(
+                                          expr, *input_loader, options));
+  EXPECT_THAT(executor.Execute(TestInputs{5, 7}), IsOkAndHolds(12));
+  EXPECT_THAT(executor.Execute(TestInputs{5, 7}), IsOkAndHolds(12));
+  EXPECT_THAT(executor.ExecuteOnHeap({}, TestInputs{5, 7}), IsOkAndHolds(12));
+  EXPECT_THAT(executor.Execute(TestInputs{7, 5}), IsOkAndHolds(12));
+  EXPECT_THAT(executor.Execute(TestInputs{1, 2}), IsOkAndHolds(3));
+  // {5, 7} is evicted.
+  EXPECT_THAT(executor.Execute(TestInputs{5, 7}), IsOkAndHolds(12));
+  ModelOutputCacheStats stats = executor.GetOutputCacheStats();
+  EXPECT_EQ(stats.hits, 2);
+  EXPECT_EQ(stats.misses, 4);
+  EXPECT_TRUE(stats.enabled);
+
+  // The clones share the cache.
+  ASSERT_OK_AND_ASSIGN(auto clone, executor.Clone());
+  EXPECT_THAT(clone.Execute(TestInputs{5, 7}), IsOkAndHolds(12));
+  EXPECT_EQ(executor.GetOutputCacheStats().hits, 3);
+
+  // The outputs for the old literals must not be reused.
+  ASSERT_OK_AND_ASSIGN(auto replaced_executor,
+                       executor.WithReplacedLiterals({}));
+  EXPECT_THAT(replaced_executor.Execute(TestInputs{5, 7}), IsOkAndHolds(12));
+  EXPECT_EQ(replaced_executor.GetOutputCacheStats().hits, 0);
+}
+
+TEST_F(ModelExecutorTest, OutputCacheBypass) {
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  ModelExecutorOptions options;
+  options.output_cache.capacity = 2;
+  options.output_cache.calibration_calls = 0;
+  ASSERT_OK_AND_ASSIGN(auto executor, CompileModelExecutor<int64_t>(
+                                          expr, *input_loader, options));
+  ModelEvaluationOptions bypass_options;
+  bypass_options.bypass_output_cache = true;
+  EXPECT_THAT(executor.Execute(bypass_options, TestInputs{5, 7}),
+              IsOkAndHolds(12));
+  EXPECT_THAT(executor.ExecuteOnHeap(bypass_options, TestInputs{5, 7}),
+              IsOkAndHolds(12));
+  EXPECT_EQ(executor.GetOutputCacheStats().hits, 0);
+  EXPECT_EQ(executor.GetOutputCacheStats().misses, 0);
+  // The bypassed evaluations did not fill the cache.
+  EXPECT_THAT(executor.Execute(TestInputs{5, 7}), IsOkAndHolds(12));
+  EXPECT_EQ(executor.GetOutputCacheStats().hits, 0);
+  EXPECT_EQ(executor.GetOutputCacheStats().misses, 1);
+}
+
+TEST_F(ModelExecutorTest, OutputCacheTtl) {
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  ModelExecutorOptions options;
+  options.output_cache.capacity = 16;
+  options.output_cache.ttl = absl::ZeroDuration();
+  options.output_cache.calibration_calls = 0;
+  ASSERT_OK_AND_ASSIGN(auto executor, CompileModelExecutor<int64_t>(
+                                          expr, *input_loader, options));
+  EXPECT_THAT(executor.Execute(TestInputs{5, 7}), IsOkAndHolds(12));
+  EXPECT_THAT(executor.Execute(TestInputs{5, 7}), IsOkAndHolds(12));
+  EXPECT_EQ(executor.GetOutputCacheStats().hits, 0);
+  EXPECT_EQ(executor.GetOutputCacheStats().misses, 2);
+}
+
+TEST_F(ModelExecutorTest, OutputCacheCalibration) {
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  ModelExecutorOptions options;
+  options.output_cache.capacity = 16;
+  options.output_cache.calibration_calls = 4;
+  ASSERT_OK_AND_ASSIGN(auto executor, CompileModelExecutor<int64_t>(
+                                          expr, *input_loader, options));
+  // No hits during the calibration, so the cache is disabled.
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_THAT(executor.Execute(TestInputs{i, 1}), IsOkAndHolds(i + 1));
+  }
+  EXPECT_FALSE(executor.GetOutputCacheStats().enabled);
+  EXPECT_THAT(executor.Execute(TestInputs{0, 1}), IsOkAndHolds(1));
+  EXPECT_EQ(executor.GetOutputCacheStats().hits, 0);
+  EXPECT_EQ(executor.GetOutputCacheStats().misses, 4);
+}
+
+TEST_F(ModelExecutorTest, WithReplacedLiterals) {
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {CallOp("math.multiply", {Leaf("x"), Literal<int64_t>(2)}),
+              CallOp("math.multiply", {Leaf("y"), Literal<int64_t>(3)})}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  Fingerprint two = TypedValue::FromValue<int64_t>(2).GetFingerprint();
+  Fingerprint three = TypedValue::FromValue<int64_t>(3).GetFingerprint();
+
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      (ModelExecutor<TestInputs, int64_t>::Compile(expr, *input_loader)));
+  EXPECT_THAT(executor.Execute(TestInputs{5, 7}), IsOkAndHolds(31));
+
+  ASSERT_OK_AND_ASSIGN(auto replaced_executor,
+                       executor.WithReplacedLiterals(
+                           {{two, TypedValue::FromValue<int64_t>(10)}}));
+  EXPECT_THAT(replaced_executor.Execute(TestInputs{5, 7}), IsOkAndHolds(71));
+  EXPECT_THAT(replaced_executor.ExecuteOnHeap({}, TestInputs{5, 7}),
+              IsOkAndHolds(71));
+  // The original executor is not affected.
+  EXPECT_THAT(executor.Execute(TestInputs{5, 7}), IsOkAndHolds(31));
+  {
+    ASSERT_OK_AND_ASSIGN(auto clone, replaced_executor.Clone());
+    EXPECT_THAT(clone.Execute(TestInputs{5, 7}), IsOkAndHolds(71));
+  }
+
+  // The literals are looked up by their current values.
+  {
+    Fingerprint ten = TypedValue::FromValue<int64_t>(10).GetFingerprint();
+    ASSERT_OK_AND_ASSIGN(auto twice_replaced_executor,
+                         replaced_executor.WithReplacedLiterals(
+                             {{ten, TypedValue::FromValue<int64_t>(20)},
+                              {three, TypedValue::FromValue<int64_t>(1)}}));
+    EXPECT_THAT(twice_replaced_executor.Execute(TestInputs{5, 7}),
+                IsOkAndHolds(107));
+    EXPECT_THAT(replaced_executor.WithReplacedLiterals(
+                    {{two, TypedValue::FromValue<int64_t>(20)}}),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("are not found in the compiled model")));
+  }
+
+  // With output casting.
+  {
+    ModelExecutorOptions options;
+    options.allow_output_casting = true;
+    ASSERT_OK_AND_ASSIGN(
+        auto casting_executor,
+        (ModelExecutor<TestInputs, OptionalValue<int64_t>>::Compile(
+            expr, *input_loader, nullptr, options)));
+    ASSERT_OK_AND_ASSIGN(auto replaced_casting_executor,
+                         casting_executor.WithReplacedLiterals(
+                             {{three, TypedValue::FromValue<int64_t>(0)}}));
+    EXPECT_THAT(replaced_casting_executor.Execute(TestInputs{5, 7}),
+                IsOkAndHolds(OptionalValue<int64_t>(10)));
+  }
+
+  EXPECT_THAT(executor.WithReplacedLiterals(
+                  {{two, TypedValue::FromValue<int32_t>(10)}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unable to replace literal int64{2} with a "
+                                 "value of a different type: expected INT64, "
+                                 "got INT32")));
+  EXPECT_THAT(
+      executor.WithReplacedLiterals(
+          {{TypedValue::FromValue<int64_t>(57).GetFingerprint(),
+            TypedValue::FromValue<int64_t>(10)}}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("can be folded or deduplicated during compilation")));
+}
+
 TEST_F(ModelExecutorTest, ReturnsNonOptional) {
   ASSERT_OK_AND_ASSIGN(
       auto input_loader,
@@ -665,6 +1038,103 @@ TEST_F(ModelExecutorTest, SimpleExprWithSlotListener) {
   }
 }
 
+TEST_F(ModelExecutorTest, WithReplacedLiteralsAndSlotListener) {
+  ASSERT_OK_AND_ASSIGN(
+      auto x_times_two,
+      WithExportAnnotation(
+          CallOp("math.multiply", {Leaf("x"), Literal<int64_t>(2)}), "out_x"));
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {x_times_two,
+              CallOp("math.multiply", {Leaf("y"), Literal<int64_t>(3)})}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  TestSlotListener<int64_t, int64_t> slot_listener{
+      {{"out_x", GetQType<int64_t>()}}};
+
+  ASSERT_OK_AND_ASSIGN(
+      auto executor, (ModelExecutor<TestInputs, int64_t, SideOutput>::Compile(
+                         expr, *input_loader, &slot_listener)));
+  ASSERT_OK_AND_ASSIGN(
+      auto replaced_executor,
+      executor.WithReplacedLiterals(
+          {{TypedValue::FromValue<int64_t>(2).GetFingerprint(),
+            TypedValue::FromValue<int64_t>(10)}}));
+  SideOutput side_output;
+  EXPECT_THAT(replaced_executor.Execute(TestInputs{5, 7}, &side_output),
+              IsOkAndHolds(71));
+  EXPECT_EQ(side_output.out_x.value, 50);
+  EXPECT_THAT(replaced_executor.Execute(TestInputs{5, 7}), IsOkAndHolds(71));
+}
+
+TEST_F(ModelExecutorTest, SideOutputVariants) {
+  ASSERT_OK_AND_ASSIGN(auto x, WithExportAnnotation(Leaf("x"), "out_x"));
+  auto y = Leaf("y");
+  ASSERT_OK_AND_ASSIGN(
+      auto x_plus_y,
+      WithExportAnnotation(CallOp("math.add", {x, y}), "out_xpy"));
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.add", {x_plus_y, y}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  TestSlotListener<int64_t, int64_t> slot_listener;
+
+  ModelExecutorOptions options;
+  options.side_output_variants = {{}, {"out_xpy"}};
+  ASSERT_OK_AND_ASSIGN(
+      auto executor, (ModelExecutor<TestInputs, int64_t, SideOutput>::Compile(
+                         expr, *input_loader, &slot_listener, options)));
+  {
+    SideOutput side_output;
+    EXPECT_THAT(executor.Execute(TestInputs{5, 7}, &side_output),
+                IsOkAndHolds(19));
+    EXPECT_EQ(side_output.out_x.value, 5);
+    EXPECT_EQ(side_output.out_xpy.value, 12);
+  }
+  {
+    SideOutput side_output;
+    EXPECT_THAT(executor.Execute({.side_output_variant = 0}, TestInputs{5, 7},
+                                 &side_output),
+                IsOkAndHolds(19));
+    EXPECT_EQ(side_output.out_x, std::nullopt);
+    EXPECT_EQ(side_output.out_xpy, std::nullopt);
+  }
+  {
+    SideOutput side_output;
+    EXPECT_THAT(executor.Execute({.side_output_variant = 1}, TestInputs{5, 7},
+                                 &side_output),
+                IsOkAndHolds(19));
+    EXPECT_EQ(side_output.out_x, std::nullopt);
+    EXPECT_EQ(side_output.out_xpy.value, 12);
+  }
+  {
+    SideOutput side_output;
+    EXPECT_THAT(executor.ExecuteOnHeap({.side_output_variant = 1},
+                                       TestInputs{5, 7}, &side_output),
+                IsOkAndHolds(19));
+    EXPECT_EQ(side_output.out_x, std::nullopt);
+    EXPECT_EQ(side_output.out_xpy.value, 12);
+  }
+  {
+    SideOutput side_output;
+    EXPECT_THAT(executor.Execute({.side_output_variant = 2}, TestInputs{5, 7},
+                                 &side_output),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("side_output_variant 2 is out of range")));
+  }
+
+  options.side_output_variants = {{"out_y"}};
+  EXPECT_THAT((ModelExecutor<TestInputs, int64_t, SideOutput>::Compile(
+                  expr, *input_loader, &slot_listener, options)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("side output out_y from side_output_variants "
+                                 "is not exported")));
+  options.side_output_variants = {{"out_x"}};
+  EXPECT_THAT((ModelExecutor<TestInputs, int64_t, SideOutput>::Compile(
+                  expr, *input_loader, /*slot_listener=*/nullptr, options)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("side_output_variants require a "
+                                 "SlotListener")));
+}
+
 TEST_F(ModelExecutorTest, SimpleExprBindWithSlotListener) {
   ASSERT_OK_AND_ASSIGN(auto x, WithExportAnnotation(Leaf("x"), "out_x"));
   auto y = Leaf("y");
@@ -946,6 +1416,31 @@ TEST_F(ModelExecutorTest, ArenaPropagated) {
     EXPECT_EQ(kLastLoaderUsedFactory, prev_used_loader_factory);
     EXPECT_EQ(kLastLoaderAllocatedBuffer, prev_allocated_loader_buffer);
   }
+  EXPECT_EQ(executor.GetArenaStats().page_count, 1);
+  EXPECT_GT(executor.GetArenaStats().peak_bytes, 0);
+
+  // The arena used by ExecuteOnHeap is also reused between the calls.
+  EXPECT_THAT(executor.ExecuteOnHeap({}, TestInputs{5, 7}), IsOkAndHolds(5));
+  prev_used_op_factory = kLastOpUsedFactory;
+  prev_allocated_op_buffer = kLastOpAllocatedBuffer;
+  EXPECT_THAT(executor.ExecuteOnHeap({}, TestInputs{5, 7}), IsOkAndHolds(5));
+  EXPECT_EQ(kLastOpUsedFactory, prev_used_op_factory);
+  EXPECT_EQ(kLastOpAllocatedBuffer, prev_allocated_op_buffer);
+}
+
+TEST_F(ModelExecutorTest, ArenaReservedBytes) {
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  ModelExecutorOptions options;
+  options.arena_page_size = 1024;
+  options.arena_reserved_bytes = 4000;
+  ASSERT_OK_AND_ASSIGN(auto executor, CompileModelExecutor<int64_t>(
+                                          expr, *input_loader, options));
+  EXPECT_THAT(executor.Execute(TestInputs{5, 7}), IsOkAndHolds(12));
+  // The reserved pages are kept even though the evaluation does not use them.
+  EXPECT_EQ(executor.GetArenaStats().page_count, 4);
+  EXPECT_THAT(executor.ExecuteOnHeap({}, TestInputs{5, 7}), IsOkAndHolds(12));
+  EXPECT_EQ(executor.GetArenaStats().page_count, 4);
 }
 
 }  // namespace
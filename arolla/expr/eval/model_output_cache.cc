@@ -0,0 +1,87 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/model_output_cache.h"
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "arolla/memory/frame.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/fingerprint.h"
+
+namespace arolla::expr::model_executor_impl {
+
+ModelOutputCacheBase::ModelOutputCacheBase(
+    const ModelOutputCacheOptions& options, std::vector<TypedSlot> input_slots)
+    : options_(options), input_slots_(std::move(input_slots)) {}
+
+Fingerprint ModelOutputCacheBase::FingerprintInputs(
+    ConstFramePtr frame) const {
+  FingerprintHasher hasher("arolla::expr::ModelOutputCache");
+  for (const TypedSlot& slot : input_slots_) {
+    slot.GetType()->UnsafeCombineToFingerprintHasher(
+        frame.GetRawPointer(slot.byte_offset()), &hasher);
+  }
+  return std::move(hasher).Finish();
+}
+
+ModelOutputCacheStats ModelOutputCacheBase::GetStats() const {
+  return {.hits = hits_.load(std::memory_order_relaxed),
+          .misses = misses_.load(std::memory_order_relaxed),
+          .enabled = enabled()};
+}
+
+bool ModelOutputCacheBase::RecordHit(int64_t fingerprint_ns) {
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  return RecordCall(fingerprint_ns);
+}
+
+bool ModelOutputCacheBase::RecordMiss(int64_t fingerprint_ns,
+                                      int64_t evaluation_ns) {
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  if (evaluation_ns != 0) {
+    evaluation_ns_.fetch_add(evaluation_ns, std::memory_order_relaxed);
+  }
+  return RecordCall(fingerprint_ns);
+}
+
+bool ModelOutputCacheBase::RecordCall(int64_t fingerprint_ns) {
+  if (fingerprint_ns != 0) {
+    fingerprint_ns_.fetch_add(fingerprint_ns, std::memory_order_relaxed);
+  }
+  if (calls_.fetch_add(1, std::memory_order_relaxed) + 1 !=
+      options_.calibration_calls) {
+    return false;
+  }
+  // The concurrent calls may be not accounted yet, so the numbers below are
+  // approximate. It is fine for the decision.
+  int64_t hits = hits_.load(std::memory_order_relaxed);
+  int64_t misses = misses_.load(std::memory_order_relaxed);
+  double mean_evaluation_ns =
+      misses == 0 ? 0.0
+                  : static_cast<double>(
+                        evaluation_ns_.load(std::memory_order_relaxed)) /
+                        misses;
+  double saved_ns = hits * mean_evaluation_ns;
+  if (saved_ns > fingerprint_ns_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  enabled_.store(false, std::memory_order_relaxed);
+  return true;
+}
+
+}  // namespace arolla::expr::model_executor_impl
@@ -0,0 +1,218 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_MODEL_OUTPUT_CACHE_H_
+#define AROLLA_EXPR_EVAL_MODEL_OUTPUT_CACHE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/numeric/int128.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "arolla/memory/frame.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/lru_cache.h"
+
+namespace arolla::expr {
+
+// Options of the ModelExecutor output cache (see
+// ModelExecutorOptions::output_cache). The cache is only correct for the models
+// whose output is a function of the loaded inputs.
+struct ModelOutputCacheOptions {
+  // The max number of cached outputs. 0 (default) disables the cache.
+  int64_t capacity = 0;
+
+  // The number of independently locked parts of the cache, so the concurrent
+  // evaluations (ExecuteOnHeap() or the clones) don't contend for a single
+  // mutex. The capacity is split evenly between the shards.
+  int64_t shard_count = 16;
+
+  // How long a cached output can be returned after its evaluation.
+  absl::Duration ttl = absl::InfiniteDuration();
+
+  // The number of the first evaluations used to decide whether the cache is
+  // worth it. The cache measures the time spent on fingerprinting the inputs
+  // and on the evaluations, and disables itself for good if the evaluations
+  // saved by the hits did not pay for the fingerprinting of all the inputs.
+  // 0 means that the cache is never disabled.
+  int64_t calibration_calls = 256;
+};
+
+// Statistics of the ModelExecutor output cache, aggregated over the executor
+// and all its clones. The calls after the cache was disabled are not counted.
+struct ModelOutputCacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+  // False if the cache was disabled after the calibration (see
+  // ModelOutputCacheOptions::calibration_calls).
+  bool enabled = true;
+
+  double hit_rate() const {
+    return hits + misses == 0 ? 0.0
+                              : static_cast<double>(hits) / (hits + misses);
+  }
+};
+
+namespace model_executor_impl {
+
+// The part of ModelOutputCache independent of the output type.
+class ModelOutputCacheBase {
+ public:
+  // `input_slots` are the slots populated by the input loader.
+  ModelOutputCacheBase(const ModelOutputCacheOptions& options,
+                       std::vector<TypedSlot> input_slots);
+
+  // Returns the fingerprint of the values in the input slots.
+  Fingerprint FingerprintInputs(ConstFramePtr frame) const;
+
+  ModelOutputCacheStats GetStats() const;
+
+ protected:
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+  bool calibrating() const {
+    return calls_.load(std::memory_order_relaxed) < options_.calibration_calls;
+  }
+
+  // Record a call. The times are only measured while calibrating(). Returns
+  // true if the call has disabled the cache.
+  bool RecordHit(int64_t fingerprint_ns);
+  bool RecordMiss(int64_t fingerprint_ns, int64_t evaluation_ns);
+
+  ModelOutputCacheOptions options_;
+  std::vector<TypedSlot> input_slots_;
+
+ private:
+  bool RecordCall(int64_t fingerprint_ns);
+
+  std::atomic<bool> enabled_ = true;
+  std::atomic<int64_t> hits_ = 0;
+  std::atomic<int64_t> misses_ = 0;
+  std::atomic<int64_t> calls_ = 0;
+  std::atomic<int64_t> fingerprint_ns_ = 0;
+  std::atomic<int64_t> evaluation_ns_ = 0;
+};
+
+// Thread safe cache of the model outputs keyed by the fingerprint of the
+// loaded inputs. Requires a copyable Output that does not refer to the frame
+// or to an arena (see OutputTraits::ExtractOutput).
+template <typename Output>
+class ModelOutputCache : public ModelOutputCacheBase {
+ public:
+  ModelOutputCache(const ModelOutputCacheOptions& options,
+                   std::vector<TypedSlot> input_slots)
+      : ModelOutputCacheBase(options, std::move(input_slots)) {
+    int64_t shard_count =
+        std::max<int64_t>(1, std::min(options_.shard_count, options_.capacity));
+    int64_t shard_capacity =
+        (options_.capacity + shard_count - 1) / shard_count;
+    shards_.reserve(shard_count);
+    for (int64_t i = 0; i < shard_count; ++i) {
+      shards_.push_back(std::make_unique<Shard>(shard_capacity));
+    }
+  }
+
+  // Returns a new empty cache with the same options, e.g. for a model with
+  // different literals.
+  std::unique_ptr<ModelOutputCache> CloneEmpty() const {
+    return std::make_unique<ModelOutputCache>(options_, input_slots_);
+  }
+
+  // Returns the cached output for the inputs loaded into the frame, or calls
+  // `evaluate` and caches the result if it is ok.
+  template <typename EvaluateFn>
+  absl::StatusOr<Output> GetOrEvaluate(ConstFramePtr frame,
+                                       EvaluateFn&& evaluate) {
+    if (!enabled()) {
+      return evaluate();
+    }
+    const bool measure = calibrating();
+    int64_t start_ns = measure ? absl::GetCurrentTimeNanos() : 0;
+    Fingerprint key = FingerprintInputs(frame);
+    int64_t fingerprint_ns =
+        measure ? absl::GetCurrentTimeNanos() - start_ns : 0;
+    // With the infinite TTL the entries never expire, so the clock is not read.
+    const bool has_ttl = options_.ttl != absl::InfiniteDuration();
+    absl::Time now = has_ttl ? absl::Now() : absl::InfinitePast();
+    Shard& shard = *shards_[absl::Uint128Low64(key.value) % shards_.size()];
+    std::optional<Output> cached_output;
+    {
+      absl::MutexLock lock(&shard.mutex);
+      if (const Entry* entry = shard.cache.LookupOrNull(key);
+          entry != nullptr) {
+        if (entry->expiration > now) {
+          cached_output = entry->output;
+        } else {
+          shard.cache.Erase(key);
+        }
+      }
+    }
+    if (cached_output.has_value()) {
+      if (RecordHit(fingerprint_ns)) {
+        Clear();
+      }
+      return *std::move(cached_output);
+    }
+    start_ns = measure ? absl::GetCurrentTimeNanos() : 0;
+    absl::StatusOr<Output> result = evaluate();
+    int64_t evaluation_ns =
+        measure ? absl::GetCurrentTimeNanos() - start_ns : 0;
+    if (result.ok()) {
+      absl::Time expiration =
+          has_ttl ? now + options_.ttl : absl::InfiniteFuture();
+      absl::MutexLock lock(&shard.mutex);
+      (void)shard.cache.Put(key, Entry{*result, expiration});
+    }
+    if (RecordMiss(fingerprint_ns, evaluation_ns)) {
+      Clear();
+    }
+    return result;
+  }
+
+ private:
+  struct Entry {
+    Output output;
+    absl::Time expiration;
+  };
+
+  struct Shard {
+    explicit Shard(int64_t capacity) : cache(capacity) {}
+
+    absl::Mutex mutex;
+    LruCache<Fingerprint, Entry> cache ABSL_GUARDED_BY(mutex);
+  };
+
+  void Clear() {
+    for (auto& shard : shards_) {
+      absl::MutexLock lock(&shard->mutex);
+      shard->cache.Clear();
+    }
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace model_executor_impl
+}  // namespace arolla::expr
+
+#endif  // AROLLA_EXPR_EVAL_MODEL_OUTPUT_CACHE_H_
@@ -0,0 +1,270 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/parallel_eval.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "arolla/memory/frame.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/row_errors.h"
+#include "arolla/util/threading.h"
+
+namespace arolla::expr::eval_internal {
+namespace {
+
+size_t SlotEnd(const TypedSlot& slot) {
+  return slot.byte_offset() + slot.GetType()->type_layout().AllocSize();
+}
+
+}  // namespace
+
+std::unique_ptr<ParallelEvalPlan> ParallelEvalPlan::Create(
+    absl::Span<const std::optional<EvalOpSlots>> op_slots,
+    int64_t min_parallel_ops) {
+  const int64_t op_count = op_slots.size();
+  if (op_count < 2 || op_count > std::numeric_limits<int32_t>::max()) {
+    return nullptr;
+  }
+  size_t frame_size = 0;
+  for (const auto& slots : op_slots) {
+    if (!slots.has_value()) {
+      return nullptr;
+    }
+    for (const auto& slot : slots->inputs) {
+      frame_size = std::max(frame_size, SlotEnd(slot));
+    }
+    for (const auto& slot : slots->outputs) {
+      frame_size = std::max(frame_size, SlotEnd(slot));
+    }
+  }
+
+  // The dependencies are tracked per byte, so the overlapping slots (e.g. a
+  // tuple and its fields) are handled correctly.
+  std::vector<int32_t> last_writer(frame_size, -1);
+  std::vector<std::vector<int32_t>> readers_since_write(frame_size);
+  std::vector<std::vector<int32_t>> predecessors(op_count);
+  for (int32_t i = 0; i < op_count; ++i) {
+    const EvalOpSlots& slots = *op_slots[i];
+    auto& deps = predecessors[i];
+    for (const auto& slot : slots.inputs) {
+      for (size_t b = slot.byte_offset(); b < SlotEnd(slot); ++b) {
+        if (last_writer[b] >= 0) {
+          deps.push_back(last_writer[b]);
+        }
+      }
+    }
+    for (const auto& slot : slots.outputs) {
+      for (size_t b = slot.byte_offset(); b < SlotEnd(slot); ++b) {
+        if (last_writer[b] >= 0) {
+          deps.push_back(last_writer[b]);
+        }
+        deps.insert(deps.end(), readers_since_write[b].begin(),
+                    readers_since_write[b].end());
+      }
+    }
+    for (const auto& slot : slots.inputs) {
+      for (size_t b = slot.byte_offset(); b < SlotEnd(slot); ++b) {
+        if (readers_since_write[b].empty() ||
+            readers_since_write[b].back() != i) {
+          readers_since_write[b].push_back(i);
+        }
+      }
+    }
+    for (const auto& slot : slots.outputs) {
+      for (size_t b = slot.byte_offset(); b < SlotEnd(slot); ++b) {
+        last_writer[b] = i;
+        readers_since_write[b].clear();
+      }
+    }
+    std::sort(deps.begin(), deps.end());
+    deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+  }
+
+  // As-soon-as-possible schedule: level[i] is the length of the longest
+  // dependency chain ending at the operator i.
+  std::vector<int64_t> levels(op_count, 1);
+  int64_t critical_path_length = 0;
+  for (int32_t i = 0; i < op_count; ++i) {
+    for (int32_t dep : predecessors[i]) {
+      levels[i] = std::max(levels[i], levels[dep] + 1);
+    }
+    critical_path_length = std::max(critical_path_length, levels[i]);
+  }
+  if (op_count - critical_path_length < min_parallel_ops) {
+    return nullptr;
+  }
+  std::vector<int64_t> level_widths(critical_path_length + 1, 0);
+  for (int64_t level : levels) {
+    ++level_widths[level];
+  }
+
+  auto plan = std::unique_ptr<ParallelEvalPlan>(new ParallelEvalPlan());
+  plan->critical_path_length_ = critical_path_length;
+  plan->max_parallelism_ =
+      *std::max_element(level_widths.begin(), level_widths.end());
+  plan->predecessor_counts_.resize(op_count);
+  plan->successor_offsets_.assign(op_count + 1, 0);
+  for (int32_t i = 0; i < op_count; ++i) {
+    plan->predecessor_counts_[i] = predecessors[i].size();
+    for (int32_t dep : predecessors[i]) {
+      ++plan->successor_offsets_[dep + 1];
+    }
+    if (predecessors[i].empty()) {
+      plan->roots_.push_back(i);
+    }
+  }
+  for (int32_t i = 0; i < op_count; ++i) {
+    plan->successor_offsets_[i + 1] += plan->successor_offsets_[i];
+  }
+  plan->successors_.resize(plan->successor_offsets_.back());
+  std::vector<int32_t> next_successor(plan->successor_offsets_.begin(),
+                                      plan->successor_offsets_.end() - 1);
+  for (int32_t i = 0; i < op_count; ++i) {
+    for (int32_t dep : predecessors[i]) {
+      plan->successors_[next_successor[dep]++] = i;
+    }
+  }
+  // The roots are taken from the back of the ready queue, so we reverse them
+  // to start from the operators that come first in the sequential order.
+  std::reverse(plan->roots_.begin(), plan->roots_.end());
+  return plan;
+}
+
+int64_t ParallelEvalPlan::Run(
+    ThreadingInterface& threading,
+    absl::Span<const std::unique_ptr<BoundOperator>> ops,
+    EvaluationContext* ctx, FramePtr frame) const {
+  DCHECK_EQ(ops.size(), predecessor_counts_.size());
+  DCHECK_OK(ctx->status());
+  const int64_t op_count = ops.size();
+  auto pending_predecessors =
+      std::make_unique<std::atomic<int32_t>[]>(op_count);
+  for (int64_t i = 0; i < op_count; ++i) {
+    pending_predecessors[i].store(predecessor_counts_[i],
+                                  std::memory_order_relaxed);
+  }
+  std::atomic<int64_t> pending_ops = op_count;
+  std::atomic<bool> failed = false;
+
+  absl::Mutex mutex;
+  absl::CondVar has_ready_ops;
+  std::vector<int32_t> ready_ops = roots_;  // Guarded by mutex.
+  absl::Status status;                      // Guarded by mutex.
+  int64_t failed_ip = -1;                   // Guarded by mutex.
+
+  const int64_t thread_count = std::max<int64_t>(
+      1, std::min<int64_t>(threading.GetRecommendedThreadCount(),
+                           max_parallelism_));
+  // RowErrors is not thread-safe, so each worker records the failed rows
+  // separately, and they are merged after the evaluation.
+  std::vector<std::unique_ptr<RowErrors>> worker_row_errors(thread_count);
+
+  auto worker = [&](int64_t worker_id) {
+    EvaluationContext worker_ctx(*ctx, &ctx->buffer_factory());
+    if (ctx->row_errors() != nullptr) {
+      worker_row_errors[worker_id] =
+          std::make_unique<RowErrors>(ctx->row_errors()->max_statuses());
+      worker_ctx.set_row_errors(worker_row_errors[worker_id].get());
+    }
+    std::vector<int32_t> newly_ready_ops;
+    int32_t ip = -1;
+    while (true) {
+      if (ip < 0) {
+        absl::MutexLock lock(&mutex);
+        while (ready_ops.empty() &&
+               pending_ops.load(std::memory_order_acquire) > 0 &&
+               !failed.load(std::memory_order_relaxed)) {
+          has_ready_ops.Wait(&mutex);
+        }
+        if (ready_ops.empty() || failed.load(std::memory_order_relaxed)) {
+          return;
+        }
+        ip = ready_ops.back();
+        ready_ops.pop_back();
+      } else if (ABSL_PREDICT_FALSE(failed.load(std::memory_order_relaxed))) {
+        return;
+      }
+      ops[ip]->Run(&worker_ctx, frame);
+      if (ABSL_PREDICT_FALSE(worker_ctx.signal_received())) {
+        // The operators performing jumps are never planned.
+        DCHECK_EQ(worker_ctx.requested_jump(), 0);
+        if (!worker_ctx.status().ok()) {
+          absl::MutexLock lock(&mutex);
+          if (!failed.load(std::memory_order_relaxed)) {
+            failed.store(true, std::memory_order_relaxed);
+            status = std::move(worker_ctx).status();
+            failed_ip = ip;
+          }
+          has_ready_ops.SignalAll();
+          return;
+        }
+        worker_ctx.ResetSignals();
+      }
+      newly_ready_ops.clear();
+      for (int32_t i = successor_offsets_[ip]; i < successor_offsets_[ip + 1];
+           ++i) {
+        const int32_t successor = successors_[i];
+        if (pending_predecessors[successor].fetch_sub(
+                1, std::memory_order_acq_rel) == 1) {
+          newly_ready_ops.push_back(successor);
+        }
+      }
+      // Continue with one of the ready successors in the same thread, so the
+      // chains of dependent operators don't touch the shared queue.
+      ip = -1;
+      if (!newly_ready_ops.empty()) {
+        ip = newly_ready_ops.back();
+        newly_ready_ops.pop_back();
+      }
+      const bool is_last_op =
+          pending_ops.fetch_sub(1, std::memory_order_acq_rel) == 1;
+      if (!newly_ready_ops.empty() || is_last_op) {
+        absl::MutexLock lock(&mutex);
+        ready_ops.insert(ready_ops.end(), newly_ready_ops.begin(),
+                         newly_ready_ops.end());
+        has_ready_ops.SignalAll();
+      }
+    }
+  };
+  ParallelFor(threading, thread_count, worker);
+  for (const auto& row_errors : worker_row_errors) {
+    if (row_errors != nullptr) {
+      ctx->row_errors()->Merge(*row_errors);
+    }
+  }
+
+  if (failed.load(std::memory_order_relaxed)) {
+    ctx->set_status(std::move(status));
+    return failed_ip;
+  }
+  return op_count - 1;
+}
+
+}  // namespace arolla::expr::eval_internal
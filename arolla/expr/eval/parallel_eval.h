@@ -0,0 +1,88 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_PARALLEL_EVAL_H_
+#define AROLLA_EXPR_EVAL_PARALLEL_EVAL_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "arolla/memory/frame.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/threading.h"
+
+namespace arolla::expr::eval_internal {
+
+// Frame slots read and written by an eval operator.
+struct EvalOpSlots {
+  std::vector<TypedSlot> inputs;
+  std::vector<TypedSlot> outputs;
+};
+
+// Dependency graph of the eval operators of a program, used to evaluate the
+// independent operators concurrently.
+//
+// An operator depends on an earlier one if they access overlapping bytes of
+// the frame and at least one of them writes there, so the slots reused by
+// SlotAllocator are handled as well.
+class ParallelEvalPlan {
+ public:
+  // Creates a plan for the operators with the given slots. Returns nullptr if
+  // some of the operators have unknown slots (e.g. the operators performing
+  // jumps), or if running the independent operators concurrently would remove
+  // less than `min_parallel_ops` operators from the critical path.
+  static std::unique_ptr<ParallelEvalPlan> Create(
+      absl::Span<const std::optional<EvalOpSlots>> op_slots,
+      int64_t min_parallel_ops);
+
+  // The number of operators on the longest dependency chain.
+  int64_t critical_path_length() const { return critical_path_length_; }
+
+  // The max number of operators that can be evaluated concurrently in the
+  // as-soon-as-possible schedule.
+  int64_t max_parallelism() const { return max_parallelism_; }
+
+  // Runs `ops` (that must correspond to the `op_slots` the plan was created
+  // for) using up to `max_parallelism()` threads from `threading`, the calling
+  // thread included. Each thread uses its own EvaluationContext derived from
+  // `ctx`, so `ctx->buffer_factory()` must be thread-safe. The rows failed in
+  // the threads are merged into `ctx->row_errors()`, if set. On error sets
+  // `ctx->status()` and returns the index of the failed operator; the other
+  // threads stop once their current operators finish.
+  int64_t Run(ThreadingInterface& threading,
+              absl::Span<const std::unique_ptr<BoundOperator>> ops,
+              EvaluationContext* ctx, FramePtr frame) const;
+
+ private:
+  ParallelEvalPlan() = default;
+
+  // Successors of the operator i are
+  // successors_[successor_offsets_[i]:successor_offsets_[i + 1]].
+  std::vector<int32_t> successor_offsets_;
+  std::vector<int32_t> successors_;
+  std::vector<int32_t> predecessor_counts_;
+  // Operators without predecessors.
+  std::vector<int32_t> roots_;
+  int64_t critical_path_length_ = 0;
+  int64_t max_parallelism_ = 0;
+};
+
+}  // namespace arolla::expr::eval_internal
+
+#endif  // AROLLA_EXPR_EVAL_PARALLEL_EVAL_H_
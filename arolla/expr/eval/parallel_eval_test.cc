@@ -0,0 +1,265 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/parallel_eval.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qexpr/bound_operators.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/base_types.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/cancellation_context.h"
+#include "arolla/util/row_errors.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/threading.h"
+
+namespace arolla::expr::eval_internal {
+namespace {
+
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsNull;
+using ::testing::NotNull;
+
+EvalOpSlots MakeOpSlots(std::vector<FrameLayout::Slot<int64_t>> inputs,
+                        std::vector<FrameLayout::Slot<int64_t>> outputs) {
+  EvalOpSlots result;
+  for (auto slot : inputs) {
+    result.inputs.push_back(TypedSlot::FromSlot(slot));
+  }
+  for (auto slot : outputs) {
+    result.outputs.push_back(TypedSlot::FromSlot(slot));
+  }
+  return result;
+}
+
+TEST(ParallelEvalPlanTest, Chain) {
+  FrameLayout::Builder layout_builder;
+  auto x = layout_builder.AddSlot<int64_t>();
+  auto y = layout_builder.AddSlot<int64_t>();
+  auto z = layout_builder.AddSlot<int64_t>();
+  std::vector<std::optional<EvalOpSlots>> op_slots = {
+      MakeOpSlots({x}, {y}),
+      MakeOpSlots({y}, {z}),
+  };
+  EXPECT_THAT(ParallelEvalPlan::Create(op_slots, /*min_parallel_ops=*/1),
+              IsNull());
+  auto plan = ParallelEvalPlan::Create(op_slots, /*min_parallel_ops=*/0);
+  ASSERT_THAT(plan, NotNull());
+  EXPECT_THAT(plan->critical_path_length(), Eq(2));
+  EXPECT_THAT(plan->max_parallelism(), Eq(1));
+}
+
+TEST(ParallelEvalPlanTest, IndependentBranches) {
+  FrameLayout::Builder layout_builder;
+  auto x = layout_builder.AddSlot<int64_t>();
+  auto a = layout_builder.AddSlot<int64_t>();
+  auto b = layout_builder.AddSlot<int64_t>();
+  auto c = layout_builder.AddSlot<int64_t>();
+  auto result = layout_builder.AddSlot<int64_t>();
+  std::vector<std::optional<EvalOpSlots>> op_slots = {
+      MakeOpSlots({x}, {a}),
+      MakeOpSlots({x}, {b}),
+      MakeOpSlots({x}, {c}),
+      MakeOpSlots({a, b, c}, {result}),
+  };
+  auto plan = ParallelEvalPlan::Create(op_slots, /*min_parallel_ops=*/2);
+  ASSERT_THAT(plan, NotNull());
+  EXPECT_THAT(plan->critical_path_length(), Eq(2));
+  EXPECT_THAT(plan->max_parallelism(), Eq(3));
+}
+
+TEST(ParallelEvalPlanTest, ReusedSlots) {
+  FrameLayout::Builder layout_builder;
+  auto x = layout_builder.AddSlot<int64_t>();
+  auto y = layout_builder.AddSlot<int64_t>();
+  auto z = layout_builder.AddSlot<int64_t>();
+  std::vector<std::optional<EvalOpSlots>> op_slots = {
+      MakeOpSlots({x}, {y}),
+      // Overrides the slot read by the previous operator.
+      MakeOpSlots({z}, {x}),
+      // Overrides the slot written by the first operator.
+      MakeOpSlots({z}, {y}),
+  };
+  auto plan = ParallelEvalPlan::Create(op_slots, /*min_parallel_ops=*/0);
+  ASSERT_THAT(plan, NotNull());
+  EXPECT_THAT(plan->critical_path_length(), Eq(2));
+  // Both the last operators depend on the first one only.
+  EXPECT_THAT(plan->max_parallelism(), Eq(2));
+}
+
+TEST(ParallelEvalPlanTest, UnknownSlots) {
+  FrameLayout::Builder layout_builder;
+  auto x = layout_builder.AddSlot<int64_t>();
+  auto y = layout_builder.AddSlot<int64_t>();
+  auto z = layout_builder.AddSlot<int64_t>();
+  std::vector<std::optional<EvalOpSlots>> op_slots = {
+      MakeOpSlots({x}, {y}),
+      std::nullopt,
+      MakeOpSlots({x}, {z}),
+  };
+  EXPECT_THAT(ParallelEvalPlan::Create(op_slots, /*min_parallel_ops=*/0),
+              IsNull());
+}
+
+class ParallelEvalPlanRunTest : public ::testing::Test {
+ protected:
+  // Creates `branch_count` independent chains of `branch_length` increments of
+  // the input, followed by an operator summing the results of the chains.
+  void SetUpBranches(int64_t branch_count, int64_t branch_length) {
+    input_ = layout_builder_.AddSlot<int64_t>();
+    std::vector<FrameLayout::Slot<int64_t>> branch_outputs;
+    for (int64_t i = 0; i < branch_count; ++i) {
+      auto input = input_;
+      for (int64_t j = 0; j < branch_length; ++j) {
+        auto output = layout_builder_.AddSlot<int64_t>();
+        ops_.push_back(MakeBoundOperator(
+            [input, output](EvaluationContext*, FramePtr frame) {
+              frame.Set(output, frame.Get(input) + 1);
+            }));
+        op_slots_.push_back(MakeOpSlots({input}, {output}));
+        input = output;
+      }
+      branch_outputs.push_back(input);
+    }
+    output_ = layout_builder_.AddSlot<int64_t>();
+    ops_.push_back(MakeBoundOperator(
+        [branch_outputs, output = output_](EvaluationContext*,
+                                           FramePtr frame) {
+          int64_t sum = 0;
+          for (auto slot : branch_outputs) {
+            sum += frame.Get(slot);
+          }
+          frame.Set(output, sum);
+        }));
+    op_slots_.push_back(MakeOpSlots(branch_outputs, {output_}));
+  }
+
+  FrameLayout::Builder layout_builder_;
+  FrameLayout::Slot<int64_t> input_ =
+      FrameLayout::Slot<int64_t>::UnsafeUninitializedSlot();
+  FrameLayout::Slot<int64_t> output_ =
+      FrameLayout::Slot<int64_t>::UnsafeUninitializedSlot();
+  std::vector<std::unique_ptr<BoundOperator>> ops_;
+  std::vector<std::optional<EvalOpSlots>> op_slots_;
+};
+
+TEST_F(ParallelEvalPlanRunTest, Run) {
+  SetUpBranches(/*branch_count=*/8, /*branch_length=*/10);
+  auto layout = std::move(layout_builder_).Build();
+  auto plan = ParallelEvalPlan::Create(op_slots_, /*min_parallel_ops=*/0);
+  ASSERT_THAT(plan, NotNull());
+  EXPECT_THAT(plan->critical_path_length(), Eq(11));
+  EXPECT_THAT(plan->max_parallelism(), Eq(8));
+
+  StdThreading threading(4);
+  for (int64_t input = 0; input < 100; ++input) {
+    MemoryAllocation alloc(&layout);
+    alloc.frame().Set(input_, input);
+    EvaluationContext ctx;
+    EXPECT_THAT(plan->Run(threading, ops_, &ctx, alloc.frame()),
+                Eq(ops_.size() - 1));
+    ASSERT_OK(ctx.status());
+    EXPECT_THAT(alloc.frame().Get(output_), Eq(8 * (input + 10)));
+  }
+}
+
+TEST_F(ParallelEvalPlanRunTest, Error) {
+  SetUpBranches(/*branch_count=*/4, /*branch_length=*/3);
+  auto failing_input = layout_builder_.AddSlot<int64_t>();
+  auto failing_output = layout_builder_.AddSlot<int64_t>();
+  ops_.push_back(MakeBoundOperator([](EvaluationContext* ctx, FramePtr) {
+    ctx->set_status(absl::InvalidArgumentError("failed"));
+  }));
+  op_slots_.push_back(MakeOpSlots({failing_input}, {failing_output}));
+  auto layout = std::move(layout_builder_).Build();
+  auto plan = ParallelEvalPlan::Create(op_slots_, /*min_parallel_ops=*/0);
+  ASSERT_THAT(plan, NotNull());
+
+  StdThreading threading(4);
+  MemoryAllocation alloc(&layout);
+  EvaluationContext ctx;
+  EXPECT_THAT(plan->Run(threading, ops_, &ctx, alloc.frame()),
+              Eq(ops_.size() - 1));
+  EXPECT_THAT(ctx.status(),
+              StatusIs(absl::StatusCode::kInvalidArgument, "failed"));
+}
+
+TEST_F(ParallelEvalPlanRunTest, Cancellation) {
+  SetUpBranches(/*branch_count=*/4, /*branch_length=*/3);
+  auto input = layout_builder_.AddSlot<int64_t>();
+  auto output = layout_builder_.AddSlot<int64_t>();
+  ops_.push_back(MakeBoundOperator([](EvaluationContext* ctx, FramePtr) {
+    ctx->CheckCancellation();
+  }));
+  op_slots_.push_back(MakeOpSlots({input}, {output}));
+  auto layout = std::move(layout_builder_).Build();
+  auto plan = ParallelEvalPlan::Create(op_slots_, /*min_parallel_ops=*/0);
+  ASSERT_THAT(plan, NotNull());
+
+  StdThreading threading(4);
+  MemoryAllocation alloc(&layout);
+  CancellationContext cancellation_context;
+  cancellation_context.Cancel();
+  EvaluationContext ctx(GetHeapBufferFactory(), &cancellation_context);
+  EXPECT_THAT(plan->Run(threading, ops_, &ctx, alloc.frame()),
+              Eq(ops_.size() - 1));
+  EXPECT_THAT(ctx.status(), StatusIs(absl::StatusCode::kCancelled));
+}
+
+TEST_F(ParallelEvalPlanRunTest, RowErrors) {
+  SetUpBranches(/*branch_count=*/4, /*branch_length=*/3);
+  // Independent operators reporting failed rows.
+  for (int64_t row_id = 0; row_id < 8; ++row_id) {
+    auto input = layout_builder_.AddSlot<int64_t>();
+    auto output = layout_builder_.AddSlot<int64_t>();
+    ops_.push_back(
+        MakeBoundOperator([row_id](EvaluationContext* ctx, FramePtr) {
+          ctx->row_errors()->Add(row_id * 10,
+                                 absl::InvalidArgumentError("failed"));
+        }));
+    op_slots_.push_back(MakeOpSlots({input}, {output}));
+  }
+  auto layout = std::move(layout_builder_).Build();
+  auto plan = ParallelEvalPlan::Create(op_slots_, /*min_parallel_ops=*/0);
+  ASSERT_THAT(plan, NotNull());
+
+  StdThreading threading(4);
+  MemoryAllocation alloc(&layout);
+  RowErrors row_errors(/*max_statuses=*/5);
+  EvaluationContext ctx;
+  ctx.set_row_errors(&row_errors);
+  EXPECT_THAT(plan->Run(threading, ops_, &ctx, alloc.frame()),
+              Eq(ops_.size() - 1));
+  ASSERT_OK(ctx.status());
+  EXPECT_THAT(row_errors.row_ids(),
+              ElementsAre(0, 10, 20, 30, 40, 50, 60, 70));
+  EXPECT_THAT(row_errors.errors().size(), Eq(5));
+}
+
+}  // namespace
+}  // namespace arolla::expr::eval_internal
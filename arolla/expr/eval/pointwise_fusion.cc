@@ -0,0 +1,331 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/pointwise_fusion.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/eval/extensions.h"
+#include "arolla/expr/eval/prepare_expression.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/expr_debug_string.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_operator.h"
+#include "arolla/expr/expr_operator_signature.h"
+#include "arolla/expr/expr_stack_trace.h"
+#include "arolla/expr/expr_visitor.h"
+#include "arolla/expr/lambda_expr_operator.h"
+#include "arolla/expr/registered_expr_operator.h"
+#include "arolla/qtype/base_types.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::expr::eval_internal {
+namespace {
+
+// Backend operators that are known to be applied independently to every row
+// of their DenseArray arguments.
+bool IsPointwiseBackendOperator(absl::string_view name) {
+  static const Indestructible<absl::flat_hash_set<absl::string_view>> kOps({
+      "core.equal",        "core.less",        "core.less_equal",
+      "core.not_equal",    "core.presence_and", "core.presence_or",
+      "math._pow",         "math.abs",         "math.add",
+      "math.ceil",         "math.divide",      "math.exp",
+      "math.floor",        "math.fmod",        "math.is_finite",
+      "math.is_inf",       "math.is_nan",      "math.log",
+      "math.log_sigmoid",  "math.logit",       "math.maximum",
+      "math.minimum",      "math.multiply",    "math.neg",
+      "math.round",        "math.sigmoid",     "math.sign",
+      "math.subtract",
+  });
+  return kOps->contains(name);
+}
+
+bool IsScalarOrOptionalQType(const QType* qtype) {
+  return IsScalarQType(qtype) || IsOptionalQType(qtype);
+}
+
+absl::StatusOr<std::optional<std::string>> GetPointwiseOperatorName(
+    const ExprNodePtr& node) {
+  if (!node->is_op() || !IsDenseArrayQType(node->qtype())) {
+    return std::nullopt;
+  }
+  ASSIGN_OR_RETURN(auto op, DecayRegisteredOperator(node->op()));
+  if (!HasBackendExprOperatorTag(op) ||
+      !IsPointwiseBackendOperator(op->display_name())) {
+    return std::nullopt;
+  }
+  for (const auto& dep : node->node_deps()) {
+    if (!IsDenseArrayQType(dep->qtype()) &&
+        !IsScalarOrOptionalQType(dep->qtype())) {
+      return std::nullopt;
+    }
+  }
+  return std::string(op->display_name());
+}
+
+// Returns the scalar argument if the node broadcasts it to an array shape.
+absl::StatusOr<std::optional<size_t>> GetBroadcastedScalarIndex(
+    const PostOrder& post_order, size_t node_index) {
+  const auto& node = post_order.node(node_index);
+  if (!node->is_op() || node->node_deps().size() != 2) {
+    return std::nullopt;
+  }
+  ASSIGN_OR_RETURN(auto op, DecayRegisteredOperator(node->op()));
+  if (!absl::StartsWith(op->display_name(), "core.const_with_shape") ||
+      !IsScalarOrOptionalQType(node->node_deps()[1]->qtype())) {
+    return std::nullopt;
+  }
+  return post_order.dep_indices(node_index)[1];
+}
+
+// Builds core.map node that evaluates the group of operators rooted at
+// `root_index`. `new_nodes` contain the already transformed nodes outside of
+// the group.
+absl::StatusOr<ExprNodePtr> FuseGroup(
+    const DynamicEvaluationEngineOptions& options, const PostOrder& post_order,
+    const std::vector<size_t>& group_roots,
+    const std::vector<std::string>& op_names, size_t root_index,
+    const std::vector<ExprNodePtr>& new_nodes) {
+  // Collect the external inputs, in the order of their first usage.
+  std::vector<size_t> members;
+  std::vector<size_t> inputs;
+  {
+    std::vector<bool> visited(post_order.nodes_size(), false);
+    std::vector<size_t> stack = {root_index};
+    visited[root_index] = true;
+    while (!stack.empty()) {
+      size_t i = stack.back();
+      stack.pop_back();
+      members.push_back(i);
+      for (size_t dep_index : post_order.dep_indices(i)) {
+        if (visited[dep_index]) {
+          continue;
+        }
+        visited[dep_index] = true;
+        if (group_roots[dep_index] == root_index) {
+          stack.push_back(dep_index);
+        } else {
+          inputs.push_back(dep_index);
+        }
+      }
+    }
+  }
+  std::sort(members.begin(), members.end());
+
+  // Scalars broadcasted to arrays can be passed to core.map directly, as long
+  // as at least one array argument remains to define the result shape.
+  std::vector<std::optional<size_t>> broadcasted_scalars(inputs.size());
+  bool has_array_input = false;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    ASSIGN_OR_RETURN(broadcasted_scalars[i],
+                     GetBroadcastedScalarIndex(post_order, inputs[i]));
+    has_array_input |= !broadcasted_scalars[i].has_value() &&
+                       IsDenseArrayQType(post_order.node(inputs[i])->qtype());
+  }
+  if (!has_array_input) {
+    broadcasted_scalars.assign(inputs.size(), std::nullopt);
+  }
+
+  std::vector<ExprNodePtr> lambda_nodes(post_order.nodes_size());
+  ExprOperatorSignature signature;
+  std::vector<ExprNodePtr> map_deps;
+  map_deps.reserve(inputs.size() + 1);
+  map_deps.push_back(nullptr);  // for the fused operator
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    std::string param_name =
+        absl::StrFormat("p%d", signature.parameters.size());
+    signature.parameters.push_back({param_name});
+    lambda_nodes[inputs[i]] = Placeholder(param_name);
+    map_deps.push_back(broadcasted_scalars[i].has_value()
+                           ? new_nodes[*broadcasted_scalars[i]]
+                           : new_nodes[inputs[i]]);
+  }
+  std::vector<absl::string_view> member_op_names;
+  member_op_names.reserve(members.size());
+  for (size_t i : members) {
+    std::vector<ExprNodePtr> deps;
+    deps.reserve(post_order.dep_indices(i).size());
+    for (size_t dep_index : post_order.dep_indices(i)) {
+      deps.push_back(lambda_nodes[dep_index]);
+    }
+    ASSIGN_OR_RETURN(lambda_nodes[i],
+                     MakeOpNode(post_order.node(i)->op(), std::move(deps)));
+    member_op_names.push_back(op_names[i]);
+  }
+
+  ASSIGN_OR_RETURN(
+      ExprOperatorPtr fused_op,
+      LambdaOperator::Make(
+          absl::StrFormat("fused_pointwise[%s]",
+                          absl::StrJoin(member_op_names, ", ")),
+          std::move(signature), lambda_nodes[root_index]));
+  map_deps[0] = Literal(std::move(fused_op));
+  ASSIGN_OR_RETURN(auto map_node, BindOp("core.map", map_deps, {}));
+  const auto& original_node = post_order.node(root_index);
+  if (map_node->qtype() != original_node->qtype()) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "core.map changes the output type of %s: expected %s, got %s",
+        GetDebugSnippet(original_node), original_node->qtype()->name(),
+        map_node->qtype() == nullptr ? "nullptr" : map_node->qtype()->name()));
+  }
+  ASSIGN_OR_RETURN(auto packed_node,
+                   CompilerExtensionRegistry::GetInstance()
+                       .GetCompilerExtensionSet()
+                       .node_transformation_fn(options, map_node));
+  if (packed_node->fingerprint() == map_node->fingerprint()) {
+    return absl::FailedPreconditionError(
+        "core.map is not supported by the registered compiler extensions");
+  }
+  return packed_node;
+}
+
+}  // namespace
+
+absl::StatusOr<ExprNodePtr> FusePointwiseOperators(
+    const DynamicEvaluationEngineOptions& options, ExprNodePtr expr,
+    std::shared_ptr<ExprStackTrace> stack_trace) {
+  PostOrder post_order(expr);
+  const size_t nodes_size = post_order.nodes_size();
+
+  std::vector<std::string> op_names(nodes_size);
+  std::vector<bool> is_pointwise(nodes_size, false);
+  for (size_t i = 0; i < nodes_size; ++i) {
+    ASSIGN_OR_RETURN(auto op_name,
+                     GetPointwiseOperatorName(post_order.node(i)));
+    if (op_name.has_value()) {
+      is_pointwise[i] = true;
+      op_names[i] = *std::move(op_name);
+    }
+  }
+
+  // A node can be fused into its parent only if the parent is the single
+  // consumer of its result.
+  constexpr size_t kNoParent = ~size_t{0};
+  constexpr size_t kManyParents = kNoParent - 1;
+  std::vector<size_t> parents(nodes_size, kNoParent);
+  for (size_t i = 0; i < nodes_size; ++i) {
+    for (size_t dep_index : post_order.dep_indices(i)) {
+      if (parents[dep_index] == kNoParent) {
+        parents[dep_index] = i;
+      } else if (parents[dep_index] != i) {
+        parents[dep_index] = kManyParents;
+      }
+    }
+  }
+
+  // Assign every pointwise node to a group identified by the group root index.
+  // The parents have greater indices in post order, so we go in reverse.
+  std::vector<size_t> group_roots(nodes_size, kNoParent);
+  std::vector<size_t> group_sizes(nodes_size, 0);
+  for (size_t i = nodes_size; i-- > 0;) {
+    if (!is_pointwise[i]) {
+      continue;
+    }
+    size_t parent = parents[i];
+    group_roots[i] = (parent < nodes_size && is_pointwise[parent])
+                         ? group_roots[parent]
+                         : i;
+    ++group_sizes[group_roots[i]];
+  }
+
+  std::vector<ExprNodePtr> new_nodes(nodes_size);
+  for (size_t i = 0; i < nodes_size; ++i) {
+    const auto& node = post_order.node(i);
+    if (group_roots[i] == i && group_sizes[i] > 1) {
+      // NOTE: The nodes that cannot be fused (e.g. due to the missing
+      // core.map support for some of the operators) are kept as is.
+      if (auto fused_node = FuseGroup(options, post_order, group_roots,
+                                      op_names, i, new_nodes);
+          fused_node.ok()) {
+        new_nodes[i] = *std::move(fused_node);
+        if (stack_trace != nullptr) {
+          stack_trace->AddTrace(new_nodes[i], node,
+                                TransformationType::kOptimization);
+        }
+        continue;
+      }
+    }
+    if (node->node_deps().empty()) {
+      new_nodes[i] = node;
+      continue;
+    }
+    std::vector<ExprNodePtr> new_deps;
+    new_deps.reserve(node->node_deps().size());
+    for (size_t dep_index : post_order.dep_indices(i)) {
+      new_deps.push_back(new_nodes[dep_index]);
+    }
+    ASSIGN_OR_RETURN(new_nodes[i],
+                     WithNewDependencies(node, std::move(new_deps)));
+    if (stack_trace != nullptr) {
+      stack_trace->AddTrace(new_nodes[i], node,
+                            TransformationType::kChildTransform);
+    }
+  }
+  return new_nodes.back();
+}
+
+absl::StatusOr<bool> IsPointwiseOperator(
+    const DynamicEvaluationEngineOptions& options, const ExprOperatorPtr& op,
+    absl::Span<const QTypePtr> input_qtypes) {
+  std::vector<ExprNodePtr> leaves;
+  absl::flat_hash_map<std::string, QTypePtr> leaf_qtypes;
+  leaves.reserve(input_qtypes.size());
+  for (size_t i = 0; i < input_qtypes.size(); ++i) {
+    std::string leaf_key = absl::StrFormat("arg_%d", i);
+    leaves.push_back(Leaf(leaf_key));
+    leaf_qtypes.emplace(std::move(leaf_key), input_qtypes[i]);
+  }
+  ASSIGN_OR_RETURN(auto expr, BindOp(op, std::move(leaves), {}));
+  DynamicEvaluationEngineOptions prepare_options(options);
+  prepare_options.enable_pointwise_fusion = false;
+  ASSIGN_OR_RETURN(auto prepared_expr,
+                   PrepareExpression(expr, leaf_qtypes, prepare_options));
+  for (const auto& node : VisitorOrder(prepared_expr)) {
+    if (!node->is_op()) {
+      continue;
+    }
+    ASSIGN_OR_RETURN(auto node_op, DecayRegisteredOperator(node->op()));
+    if (!HasBackendExprOperatorTag(node_op)) {
+      return false;
+    }
+    // The casting stage converts the scalar arguments to optionals.
+    if (node_op->display_name() != "core.to_optional._scalar" &&
+        !IsPointwiseBackendOperator(node_op->display_name())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace arolla::expr::eval_internal
@@ -0,0 +1,54 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_POINTWISE_FUSION_H_
+#define AROLLA_EXPR_EVAL_POINTWISE_FUSION_H_
+
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_operator.h"
+#include "arolla/expr/expr_stack_trace.h"
+#include "arolla/qtype/qtype.h"
+
+namespace arolla::expr::eval_internal {
+
+// Fuses chains of pointwise backend operators on DenseArrays into a single
+// core.map call, so the chain is evaluated in one pass over the rows without
+// materializing the intermediate arrays.
+//
+// A pointwise operator is absorbed into its parent if the parent is pointwise
+// too and is the only consumer of its result. Scalar arguments broadcasted
+// with core.const_with_shape are passed to the fused operator directly.
+//
+// The transformation expects the expression to be lowered and casted, and
+// relies on the compiler extension for core.map. If a chain cannot be packed
+// (e.g. the extension is not linked), the chain is kept unchanged.
+absl::StatusOr<ExprNodePtr> FusePointwiseOperators(
+    const DynamicEvaluationEngineOptions& options, ExprNodePtr expr,
+    std::shared_ptr<ExprStackTrace> stack_trace = nullptr);
+
+// Returns true if `op` called with the arguments of `input_qtypes` is compiled
+// into the pointwise backend operators only (see FusePointwiseOperators), so
+// applying it to arrays is equivalent to applying it row by row.
+absl::StatusOr<bool> IsPointwiseOperator(
+    const DynamicEvaluationEngineOptions& options, const ExprOperatorPtr& op,
+    absl::Span<const QTypePtr> input_qtypes);
+
+}  // namespace arolla::expr::eval_internal
+
+#endif  // AROLLA_EXPR_EVAL_POINTWISE_FUSION_H_
@@ -14,7 +14,10 @@
 //
 #include "arolla/expr/eval/prepare_expression.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <set>
@@ -36,7 +39,10 @@
 #include "arolla/expr/eval/compile_where_operator.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/eval/extensions.h"
+#include "arolla/expr/eval/group_op_fusion.h"
 #include "arolla/expr/eval/invoke.h"
+#include "arolla/expr/eval/pointwise_fusion.h"
+#include "arolla/expr/eval/scalar_broadcast_elimination.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_attributes.h"
 #include "arolla/expr/expr_debug_string.h"
@@ -49,6 +55,7 @@
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/indestructible.h"
 #include "arolla/util/string.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr::eval_internal {
@@ -245,8 +252,10 @@ absl::StatusOr<ExprNodePtr> ApplyNodeTransformations(
     const DynamicEvaluationEngineOptions& options, ExprNodePtr expr,
     absl::Span<const std::pair<TransformationType, NodeTransformationFn>>
         transformations,
-    std::shared_ptr<ExprStackTrace> stack_trace) {
-  return DeepTransform(
+    std::shared_ptr<ExprStackTrace> stack_trace,
+    const absl::flat_hash_map<Fingerprint, ExprNodePtr>& known_results,
+    absl::flat_hash_map<Fingerprint, ExprNodePtr>* new_results) {
+  return DeepTransformWithKnownResults(
       expr,
       [&options, &transformations,
        &stack_trace](ExprNodePtr node) -> absl::StatusOr<ExprNodePtr> {
@@ -272,6 +281,7 @@ absl::StatusOr<ExprNodePtr> ApplyNodeTransformations(
         }
         return node;
       },
+      known_results, new_results,
       /*new_deps_trace_logger=*/
       [&stack_trace](ExprNodePtr node, ExprNodePtr prev_node,
                      DeepTransformStage stage) {
@@ -289,6 +299,132 @@ absl::StatusOr<ExprNodePtr> ApplyNodeTransformations(
       });
 }
 
+// ExprStackTrace that stores the traces to replay them later in another
+// thread.
+class RecordingExprStackTrace final : public ExprStackTrace {
+ public:
+  void AddTrace(ExprNodePtr target_node, ExprNodePtr source_node,
+                TransformationType t) final {
+    traces_.push_back({std::move(target_node), std::move(source_node), t});
+  }
+
+  std::string FullTrace(Fingerprint fp) const final { return ""; }
+
+  void ReplayTo(ExprStackTrace& stack_trace) && {
+    for (auto& trace : traces_) {
+      stack_trace.AddTrace(std::move(trace.target_node),
+                           std::move(trace.source_node), trace.type);
+    }
+    traces_.clear();
+  }
+
+ private:
+  struct Trace {
+    ExprNodePtr target_node;
+    ExprNodePtr source_node;
+    TransformationType type;
+  };
+  std::vector<Trace> traces_;
+};
+
+// Expressions smaller than this are always prepared in a single thread.
+constexpr int64_t kMinNodeCountForParallelPreparation = 4096;
+// The minimal (approximate) number of nodes to prepare in a single task.
+constexpr int64_t kMinParallelPreparationTaskSize = 256;
+
+// Same as ApplyNodeTransformations, but processes independent subexpressions
+// in parallel.
+//
+// The expression is split into tasks in post order: a node becomes a task root
+// once its subexpression, excluding the subexpressions of the task roots below,
+// is big enough (the shared nodes are counted multiple times, so it is just an
+// estimate). A task is scheduled in the round after all the task roots in its
+// subexpression are processed, and it reuses their results via
+// DeepTransformWithKnownResults. Node transformations depend only on the node
+// itself, so the result is the same as in the single-threaded version; the
+// shared nodes may be just transformed more than once.
+absl::StatusOr<ExprNodePtr> ApplyNodeTransformationsInParallel(
+    ThreadingInterface& threading,
+    const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
+    absl::Span<const std::pair<TransformationType, NodeTransformationFn>>
+        transformations,
+    std::shared_ptr<ExprStackTrace> stack_trace) {
+  const PostOrder post_order(expr);
+  const int64_t node_count = post_order.nodes_size();
+  const int64_t thread_count = threading.GetRecommendedThreadCount();
+  if (thread_count <= 1 || node_count < kMinNodeCountForParallelPreparation) {
+    return ApplyNodeTransformations(options, expr, transformations,
+                                    std::move(stack_trace),
+                                    /*known_results=*/{},
+                                    /*new_results=*/nullptr);
+  }
+
+  const int64_t task_size = std::max(kMinParallelPreparationTaskSize,
+                                     node_count / (thread_count * 8));
+  std::vector<int64_t> residual_sizes(node_count);
+  // The number of rounds needed to process all the task roots in the node's
+  // subexpression.
+  std::vector<size_t> round_counts(node_count);
+  std::vector<std::vector<ExprNodePtr>> rounds;
+  // The root is processed separately in the end.
+  for (int64_t i = 0; i + 1 < node_count; ++i) {
+    int64_t residual_size = 1;
+    size_t round = 0;
+    for (size_t dep : post_order.dep_indices(i)) {
+      residual_size += residual_sizes[dep];
+      round = std::max(round, round_counts[dep]);
+    }
+    if (residual_size >= task_size) {
+      if (round >= rounds.size()) {
+        rounds.resize(round + 1);
+      }
+      rounds[round].push_back(post_order.node(i));
+      residual_sizes[i] = 0;
+      round_counts[i] = round + 1;
+    } else {
+      residual_sizes[i] = residual_size;
+      round_counts[i] = round;
+    }
+  }
+
+  absl::flat_hash_map<Fingerprint, ExprNodePtr> known_results;
+  for (const std::vector<ExprNodePtr>& tasks : rounds) {
+    std::vector<absl::flat_hash_map<Fingerprint, ExprNodePtr>> task_results(
+        tasks.size());
+    std::vector<absl::Status> task_statuses(tasks.size());
+    std::vector<std::shared_ptr<RecordingExprStackTrace>> task_stack_traces(
+        tasks.size());
+    std::atomic<size_t> next_task = 0;
+    ParallelFor(
+        threading, std::min<int64_t>(thread_count, tasks.size()),
+        [&](int64_t) {
+          for (size_t i = next_task++; i < tasks.size(); i = next_task++) {
+            if (stack_trace != nullptr) {
+              task_stack_traces[i] =
+                  std::make_shared<RecordingExprStackTrace>();
+            }
+            task_statuses[i] =
+                ApplyNodeTransformations(options, tasks[i], transformations,
+                                         task_stack_traces[i], known_results,
+                                         &task_results[i])
+                    .status();
+          }
+        });
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      RETURN_IF_ERROR(task_statuses[i]);
+      if (task_stack_traces[i] != nullptr) {
+        std::move(*task_stack_traces[i]).ReplayTo(*stack_trace);
+      }
+      for (auto& [fingerprint, result] : task_results[i]) {
+        known_results.emplace(fingerprint, std::move(result));
+      }
+    }
+  }
+  return ApplyNodeTransformations(options, expr, transformations,
+                                  std::move(stack_trace), known_results,
+                                  /*new_results=*/nullptr);
+}
+
 absl::StatusOr<ExprNodePtr> PrepareSingleLeafExpression(
     const ExprNodePtr& expr,
     const absl::flat_hash_map<std::string, QTypePtr>& input_types,
@@ -365,9 +501,40 @@ absl::StatusOr<ExprNodePtr> PrepareExpression(
                                             .node_transformation_fn});
   }
 
-  ASSIGN_OR_RETURN(current_expr,
-                   ApplyNodeTransformations(options, current_expr,
-                                            transformations, stack_trace));
+  if (options.threading != nullptr) {
+    ASSIGN_OR_RETURN(current_expr, ApplyNodeTransformationsInParallel(
+                                       *options.threading, options,
+                                       current_expr, transformations,
+                                       stack_trace));
+  } else {
+    ASSIGN_OR_RETURN(
+        current_expr,
+        ApplyNodeTransformations(options, current_expr, transformations,
+                                 stack_trace, /*known_results=*/{},
+                                 /*new_results=*/nullptr));
+  }
+
+  if (options.enable_group_op_fusion &&
+      options.enabled_preparation_stages & Stage::kOptimization) {
+    ASSIGN_OR_RETURN(current_expr,
+                     FuseGroupOperators(options, current_expr, stack_trace));
+  }
+
+  // The fusion relies on the core.map compiler extension, and it must go before
+  // the where operators transformation that hides the branches from it.
+  if (options.enable_pointwise_fusion &&
+      options.enabled_preparation_stages & Stage::kExtensions) {
+    ASSIGN_OR_RETURN(current_expr, FusePointwiseOperators(
+                                       options, current_expr, stack_trace));
+  }
+
+  // Goes after the pointwise fusion that already passes the broadcasted
+  // scalars to core.map directly.
+  if (options.enable_scalar_broadcast_elimination &&
+      options.enabled_preparation_stages & Stage::kOptimization) {
+    ASSIGN_OR_RETURN(current_expr, EliminateScalarBroadcasts(
+                                       options, current_expr, stack_trace));
+  }
 
   if (options.enabled_preparation_stages &
       Stage::kWhereOperatorsTransformation) {
@@ -16,13 +16,17 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/expr/annotation_expr_operators.h"
@@ -45,6 +49,8 @@
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/text.h"
+#include "arolla/util/threading.h"
+#include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr::eval_internal {
 namespace {
@@ -188,6 +194,62 @@ TEST_F(PrepareExpressionTest, Optimizations) {
   }
 }
 
+// Returns a balanced sum of `summand_count` subexpressions that need lowering,
+// literal folding and qtype population.
+absl::StatusOr<ExprNodePtr> MakeBigExpression(int64_t summand_count) {
+  ASSIGN_OR_RETURN(
+      auto add_1_lambda,
+      MakeLambdaOperator(ExprOperatorSignature{{"x"}},
+                         CallOp("math.add", {Placeholder("x"), Literal(1)})));
+  std::vector<ExprNodePtr> summands;
+  summands.reserve(summand_count);
+  for (int64_t i = 0; i < summand_count; ++i) {
+    ASSIGN_OR_RETURN(
+        auto summand,
+        CallOp("math.multiply",
+               {CallOp(add_1_lambda, {Leaf(absl::StrCat("x", i % 10))}),
+                CallOp("math.add", {Literal<int32_t>(i % 7), Literal(1)})}));
+    summands.push_back(std::move(summand));
+  }
+  while (summands.size() > 1) {
+    std::vector<ExprNodePtr> next_summands;
+    for (size_t i = 0; i + 1 < summands.size(); i += 2) {
+      ASSIGN_OR_RETURN(auto sum,
+                       CallOp("math.add", {summands[i], summands[i + 1]}));
+      next_summands.push_back(std::move(sum));
+    }
+    if (summands.size() % 2 == 1) {
+      next_summands.push_back(summands.back());
+    }
+    summands = std::move(next_summands);
+  }
+  return summands[0];
+}
+
+TEST_F(PrepareExpressionTest, ParallelPreparation) {
+  ASSERT_OK_AND_ASSIGN(auto expr, MakeBigExpression(5000));
+  absl::flat_hash_map<std::string, QTypePtr> input_qtypes;
+  for (int i = 0; i < 10; ++i) {
+    input_qtypes[absl::StrCat("x", i)] = GetQType<int32_t>();
+  }
+  ASSERT_OK_AND_ASSIGN(auto expected_expr,
+                       PrepareExpression(expr, input_qtypes,
+                                         DynamicEvaluationEngineOptions{}));
+
+  StdThreading threading(4);
+  DynamicEvaluationEngineOptions options{.threading = &threading};
+  EXPECT_THAT(PrepareExpression(expr, input_qtypes, options),
+              IsOkAndHolds(EqualsExpr(expected_expr)));
+  EXPECT_THAT(PrepareExpression(expr, input_qtypes, options,
+                                std::make_shared<LightweightExprStackTrace>()),
+              IsOkAndHolds(EqualsExpr(expected_expr)));
+
+  input_qtypes.erase("x3");
+  EXPECT_THAT(PrepareExpression(expr, input_qtypes, options),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("missing QType information for inputs {x3}")));
+}
+
 TEST_F(PrepareExpressionTest, DetailedStackTraceBuilding) {
   ASSERT_OK_AND_ASSIGN(
       auto add_2_lambda,
@@ -327,6 +389,10 @@ TEST_F(PrepareExpressionTest, StackTraceBuildingNoTransformations) {
   stack_trace_builder.RegisterIp(0, prepared_expr);
   auto bound_stack_trace = stack_trace_builder.Build(/*num_operators=*/10);
   EXPECT_EQ(bound_stack_trace[0], "");
+
+  auto lazy_stack_trace = std::move(stack_trace_builder).BuildLazy();
+  EXPECT_EQ(lazy_stack_trace->FullTrace(0), "");
+  EXPECT_EQ(lazy_stack_trace->FullTrace(1), std::nullopt);
 }
 
 TEST_F(PrepareExpressionTest, StackTraceAnnotationCycle) {
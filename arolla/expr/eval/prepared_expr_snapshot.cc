@@ -0,0 +1,212 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/prepared_expr_snapshot.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr_debug_string.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_operator_signature.h"
+#include "arolla/expr/expr_visitor.h"
+#include "arolla/expr/lambda_expr_operator.h"
+#include "arolla/expr/registered_expr_operator.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/serialization/decode.h"
+#include "arolla/serialization/encode.h"
+#include "arolla/serialization_base/base.pb.h"
+#include "arolla/util/demangle.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/text.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::expr {
+
+using ::arolla::serialization_base::ContainerProto;
+
+Fingerprint GetExprOperatorRegistryFingerprint() {
+  const auto& registry = *ExprOperatorRegistry::GetInstance();
+  std::vector<absl::string_view> names = registry.ListRegisteredOperators();
+  std::sort(names.begin(), names.end());
+  FingerprintHasher hasher("arolla::expr::ExprOperatorRegistryFingerprint");
+  hasher.Combine(names.size());
+  for (absl::string_view name : names) {
+    hasher.Combine(name);
+    auto op = registry.LookupOperatorOrNull(name);
+    if (op == nullptr) {
+      continue;
+    }
+    auto op_impl = DecayRegisteredOperator(op);
+    if (!op_impl.ok()) {
+      // A placeholder registered without implementation.
+      hasher.Combine(false);
+      continue;
+    }
+    hasher.Combine(true, TypeName(typeid(**op_impl)));
+    if (auto signature = (*op_impl)->GetSignature(); signature.ok()) {
+      hasher.Combine(GetExprOperatorSignatureSpec(*signature));
+    }
+    if (const auto* lambda_op =
+            dynamic_cast<const LambdaOperator*>(op_impl->get())) {
+      hasher.Combine(ToDebugString(lambda_op->lambda_body()));
+    }
+  }
+  return std::move(hasher).Finish();
+}
+
+Fingerprint GetQExprOperatorRegistryFingerprint() {
+  auto& registry = *OperatorRegistry::GetInstance();
+  std::vector<std::string> names = registry.ListRegisteredOperators();
+  std::sort(names.begin(), names.end());
+  FingerprintHasher hasher("arolla::expr::QExprOperatorRegistryFingerprint");
+  hasher.Combine(names.size());
+  for (const std::string& name : names) {
+    auto overloads = registry.ListRegisteredOperatorOverloads(name);
+    hasher.Combine(name, overloads.size());
+    for (const auto& op : overloads) {
+      hasher.Combine(op->GetQType()->name(), TypeName(typeid(*op)));
+    }
+  }
+  return std::move(hasher).Finish();
+}
+
+namespace {
+
+// Returns a fingerprint of the options affecting the preparation. The
+// optimizer, the operator directory and the cost model cannot be compared
+// across processes, so only their presence is taken into account.
+Fingerprint GetPreparationOptionsFingerprint(
+    const DynamicEvaluationEngineOptions& options) {
+  return FingerprintHasher("arolla::expr::PreparationOptionsFingerprint")
+      .Combine(options.enabled_preparation_stages,
+               options.optimizer.has_value(), options.enable_pointwise_fusion,
+               options.enable_array_lifted_core_map,
+               options.enable_array_lifted_pointwise_core_map,
+               options.enable_array_where_short_circuit,
+               options.fuse_scalar_operator_pairs,
+               options.enable_group_op_fusion,
+               options.enable_scalar_broadcast_elimination,
+               options.operator_directory != nullptr,
+               options.cost_model != nullptr)
+      .Finish();
+}
+
+Fingerprint GetSnapshotFingerprint(
+    const DynamicEvaluationEngineOptions& options) {
+  return FingerprintHasher("arolla::expr::PreparedExprSnapshot")
+      .Combine(GetExprOperatorRegistryFingerprint(),
+               GetQExprOperatorRegistryFingerprint(),
+               GetPreparationOptionsFingerprint(options))
+      .Finish();
+}
+
+// Returns an error naming the first operator in `exprs` that cannot be
+// serialized, or `status` if there are none.
+absl::Status NonSerializableOperatorError(absl::Span<const ExprNodePtr> exprs,
+                                          absl::Status status) {
+  absl::flat_hash_set<Fingerprint> visited;
+  for (const auto& expr : exprs) {
+    for (const auto& node : PostOrder(expr).nodes()) {
+      if (!node->is_op() || !visited.insert(node->op()->fingerprint()).second) {
+        continue;
+      }
+      if (!serialization::Encode({TypedValue::FromValue(node->op())}, {})
+               .ok()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "prepared expression contains operator %s that cannot be "
+            "serialized; expressions with core.map, short circuit core.where "
+            "or while loops can be snapshotted only with the corresponding "
+            "preparation stages disabled; %s",
+            node->op()->display_name(), status.message()));
+      }
+    }
+  }
+  return status;
+}
+
+}  // namespace
+
+// The container stores the snapshot fingerprint and the side output names as
+// TEXT values, and the main expression followed by the side outputs.
+absl::StatusOr<ContainerProto> EncodePreparedExprSnapshot(
+    const DynamicEvaluationEngineOptions& options,
+    const PreparedExprForDynamicEvaluation& prepared) {
+  if (prepared.expr == nullptr) {
+    return absl::InvalidArgumentError("prepared expression is not set");
+  }
+  std::vector<TypedValue> values;
+  std::vector<ExprNodePtr> exprs;
+  values.reserve(prepared.side_outputs.size() + 1);
+  exprs.reserve(prepared.side_outputs.size() + 1);
+  values.push_back(
+      TypedValue::FromValue(Text(GetSnapshotFingerprint(options).AsString())));
+  exprs.push_back(prepared.expr);
+  for (const auto& [name, side_output] : prepared.side_outputs) {
+    values.push_back(TypedValue::FromValue(Text(name)));
+    exprs.push_back(side_output);
+  }
+  auto result = serialization::Encode(values, exprs);
+  if (!result.ok()) {
+    return NonSerializableOperatorError(exprs, std::move(result).status());
+  }
+  return result;
+}
+
+absl::StatusOr<PreparedExprForDynamicEvaluation> DecodePreparedExprSnapshot(
+    const DynamicEvaluationEngineOptions& options,
+    const ContainerProto& container_proto) {
+  ASSIGN_OR_RETURN(auto decode_result, serialization::Decode(container_proto));
+  auto& [values, exprs] = decode_result;
+  if (values.empty() || values.size() != exprs.size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "malformed prepared expression snapshot: got %d values and %d "
+        "expressions",
+        values.size(), exprs.size()));
+  }
+  std::vector<Text> texts;
+  texts.reserve(values.size());
+  for (const auto& value : values) {
+    ASSIGN_OR_RETURN(const Text& text, value.As<Text>(),
+                     _ << "malformed prepared expression snapshot");
+    texts.push_back(text);
+  }
+  if (texts[0].view() != GetSnapshotFingerprint(options).AsString()) {
+    return absl::FailedPreconditionError(
+        "prepared expression snapshot was created with a different operator "
+        "registry or DynamicEvaluationEngineOptions");
+  }
+  PreparedExprForDynamicEvaluation result;
+  result.expr = std::move(exprs[0]);
+  result.side_outputs.reserve(exprs.size() - 1);
+  for (size_t i = 1; i < exprs.size(); ++i) {
+    result.side_outputs.emplace_back(std::string(texts[i].view()),
+                                     std::move(exprs[i]));
+  }
+  return result;
+}
+
+}  // namespace arolla::expr
@@ -0,0 +1,68 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_PREPARED_EXPR_SNAPSHOT_H_
+#define AROLLA_EXPR_EVAL_PREPARED_EXPR_SNAPSHOT_H_
+
+#include "absl/status/statusor.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/serialization_base/base.pb.h"
+#include "arolla/util/fingerprint.h"
+
+namespace arolla::expr {
+
+// Returns a fingerprint of the operators in ExprOperatorRegistry: their names,
+// implementation classes, signatures and, for lambda operators, bodies. Unlike
+// the operator fingerprints, it is stable across the processes running the
+// same binary, and so can be used to check that a serialized prepared
+// expression is compatible with the current process.
+Fingerprint GetExprOperatorRegistryFingerprint();
+
+// Returns a fingerprint of the operators in the QExpr OperatorRegistry: their
+// names and, for the operators registered individually, the signatures and
+// implementation classes of the overloads. Operator families contribute only
+// their names. Stable across the processes running the same binary.
+Fingerprint GetQExprOperatorRegistryFingerprint();
+
+// Serializes the expression prepared by PrepareForDynamicEvaluation with
+// `options`, together with the fingerprints of both operator registries and
+// of the options affecting the preparation. A server can store the snapshot
+// and, on startup, load it with DecodePreparedExprSnapshot and pass to
+// CompilePreparedForDynamicEvaluation, skipping the expensive preparation
+// stages.
+//
+// The expression must be serializable, i.e. all its operators and literals
+// must be supported by the linked serialization codecs. Note that some of the
+// preparation stages produce operators holding compiled programs (e.g. core.map
+// with a precompiled mapper, the short circuit core.where or core.while_loop),
+// the function fails with InvalidArgumentError for such expressions.
+absl::StatusOr<serialization_base::ContainerProto> EncodePreparedExprSnapshot(
+    const DynamicEvaluationEngineOptions& options,
+    const PreparedExprForDynamicEvaluation& prepared);
+
+// Deserializes a snapshot created by EncodePreparedExprSnapshot. Returns
+// FailedPreconditionError if the operator registries of the current process or
+// `options` differ from the ones the snapshot was created with, in that case
+// the expression must be prepared again.
+//
+// The optimizer, the operator directory and the cost model of the options
+// cannot be compared across processes, only their presence is checked. They
+// must be the same as the ones used for the preparation.
+absl::StatusOr<PreparedExprForDynamicEvaluation> DecodePreparedExprSnapshot(
+    const DynamicEvaluationEngineOptions& options,
+    const serialization_base::ContainerProto& container_proto);
+
+}  // namespace arolla::expr
+
+#endif  // AROLLA_EXPR_EVAL_PREPARED_EXPR_SNAPSHOT_H_
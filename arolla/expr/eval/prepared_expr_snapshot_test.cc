@@ -0,0 +1,192 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/prepared_expr_snapshot.h"
+
+#include <optional>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/expr_operator_signature.h"
+#include "arolla/expr/lambda_expr_operator.h"
+#include "arolla/expr/registered_expr_operator.h"
+#include "arolla/expr/testing/testing.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operator_factory.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/base_types.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::expr {
+namespace {
+
+using ::arolla::testing::EqualsExpr;
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Pair;
+
+class PreparedExprSnapshotTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_OK(InitArolla()); }
+};
+
+TEST_F(PreparedExprSnapshotTest, RoundTrip) {
+  // x + y * 2.0, with side output x * y
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {Leaf("x"), CallOp("math.multiply", {Leaf("y"), Literal(2.0f)})}));
+  ASSERT_OK_AND_ASSIGN(auto side_output,
+                       CallOp("math.multiply", {Leaf("x"), Leaf("y")}));
+  DynamicEvaluationEngineOptions options;
+  ASSERT_OK_AND_ASSIGN(
+      auto prepared,
+      PrepareForDynamicEvaluation(
+          options, expr, {{"x", GetQType<float>()}, {"y", GetQType<float>()}},
+          {{"x_times_y", side_output}}));
+
+  ASSERT_OK_AND_ASSIGN(auto container_proto,
+                       EncodePreparedExprSnapshot(options, prepared));
+  ASSERT_OK_AND_ASSIGN(auto decoded,
+                       DecodePreparedExprSnapshot(options, container_proto));
+  EXPECT_THAT(decoded.expr, EqualsExpr(prepared.expr));
+  ASSERT_THAT(decoded.side_outputs,
+              ElementsAre(Pair("x_times_y", EqualsExpr(
+                                                prepared.side_outputs[0]
+                                                    .second))));
+
+  ASSERT_OK_AND_ASSIGN(auto compiled_expr,
+                       CompilePreparedForDynamicEvaluation(options, decoded));
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<float>();
+  auto y_slot = layout_builder.AddSlot<float>();
+  ASSERT_OK_AND_ASSIGN(
+      auto executable_expr,
+      compiled_expr->Bind(&layout_builder,
+                          {{"x", TypedSlot::FromSlot(x_slot)},
+                           {"y", TypedSlot::FromSlot(y_slot)}},
+                          /*output_slot=*/std::nullopt));
+  FrameLayout layout = std::move(layout_builder).Build();
+  RootEvaluationContext ctx(&layout);
+  ASSERT_OK(executable_expr->InitializeLiterals(&ctx));
+  ctx.Set(x_slot, 3.0f);
+  ctx.Set(y_slot, 5.0f);
+  ASSERT_OK(executable_expr->Execute(&ctx));
+  ASSERT_OK_AND_ASSIGN(auto output_slot,
+                       executable_expr->output_slot().ToSlot<float>());
+  EXPECT_EQ(ctx.Get(output_slot), 13.0f);
+  ASSERT_OK_AND_ASSIGN(
+      auto side_output_slot,
+      executable_expr->named_output_slots().at("x_times_y").ToSlot<float>());
+  EXPECT_EQ(ctx.Get(side_output_slot), 15.0f);
+}
+
+TEST_F(PreparedExprSnapshotTest, RegistryMismatch) {
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.add", {Leaf("x"), Literal(1.0f)}));
+  DynamicEvaluationEngineOptions options;
+  ASSERT_OK_AND_ASSIGN(
+      auto prepared,
+      PrepareForDynamicEvaluation(options, expr, {{"x", GetQType<float>()}}));
+  ASSERT_OK_AND_ASSIGN(auto container_proto,
+                       EncodePreparedExprSnapshot(options, prepared));
+  auto fingerprint = GetExprOperatorRegistryFingerprint();
+  EXPECT_EQ(GetExprOperatorRegistryFingerprint(), fingerprint);
+
+  ASSERT_OK_AND_ASSIGN(auto op,
+                       MakeLambdaOperator(ExprOperatorSignature{{"x"}},
+                                          Placeholder("x")));
+  ASSERT_OK(RegisterOperator("test.prepared_expr_snapshot.identity", op));
+  EXPECT_NE(GetExprOperatorRegistryFingerprint(), fingerprint);
+  EXPECT_THAT(DecodePreparedExprSnapshot(options, container_proto),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       "prepared expression snapshot was created with a "
+                       "different operator registry or "
+                       "DynamicEvaluationEngineOptions"));
+}
+
+TEST_F(PreparedExprSnapshotTest, QExprRegistryMismatch) {
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.add", {Leaf("x"), Literal(1.0f)}));
+  DynamicEvaluationEngineOptions options;
+  ASSERT_OK_AND_ASSIGN(
+      auto prepared,
+      PrepareForDynamicEvaluation(options, expr, {{"x", GetQType<float>()}}));
+  ASSERT_OK_AND_ASSIGN(auto container_proto,
+                       EncodePreparedExprSnapshot(options, prepared));
+  auto fingerprint = GetQExprOperatorRegistryFingerprint();
+  EXPECT_EQ(GetQExprOperatorRegistryFingerprint(), fingerprint);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto qexpr_op,
+      OperatorFactory()
+          .WithName("test.prepared_expr_snapshot.qexpr_identity")
+          .BuildFromFunction([](float x) { return x; }));
+  ASSERT_OK(OperatorRegistry::GetInstance()->RegisterOperator(qexpr_op));
+  EXPECT_NE(GetQExprOperatorRegistryFingerprint(), fingerprint);
+  EXPECT_THAT(DecodePreparedExprSnapshot(options, container_proto),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(PreparedExprSnapshotTest, OptionsMismatch) {
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       CallOp("math.add", {Leaf("x"), Literal(1.0f)}));
+  DynamicEvaluationEngineOptions options;
+  ASSERT_OK_AND_ASSIGN(
+      auto prepared,
+      PrepareForDynamicEvaluation(options, expr, {{"x", GetQType<float>()}}));
+  ASSERT_OK_AND_ASSIGN(auto container_proto,
+                       EncodePreparedExprSnapshot(options, prepared));
+
+  // The options not affecting the preparation are ignored.
+  DynamicEvaluationEngineOptions other_options = options;
+  other_options.enable_profiling = true;
+  EXPECT_OK(DecodePreparedExprSnapshot(other_options, container_proto));
+
+  other_options.enable_pointwise_fusion = true;
+  EXPECT_THAT(DecodePreparedExprSnapshot(other_options, container_proto),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(PreparedExprSnapshotTest, NonSerializableOperator) {
+  // The short circuit core.where is compiled during the preparation.
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("core.where",
+             {Leaf("c"), CallOp("math.add", {Leaf("x"), Literal(1.0f)}),
+              CallOp("math.subtract", {Leaf("x"), Literal(1.0f)})}));
+  DynamicEvaluationEngineOptions options;
+  ASSERT_OK_AND_ASSIGN(
+      auto prepared,
+      PrepareForDynamicEvaluation(options, expr,
+                                  {{"c", GetQType<OptionalUnit>()},
+                                   {"x", GetQType<float>()}}));
+  EXPECT_THAT(EncodePreparedExprSnapshot(options, prepared),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("that cannot be serialized")));
+}
+
+}  // namespace
+}  // namespace arolla::expr
@@ -0,0 +1,284 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/profiling.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/types/span.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/array_like/array_like_qtype.h"
+#include "arolla/qtype/typed_ref.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/perf_counters.h"
+
+namespace arolla::expr {
+namespace {
+
+std::string SanitizeFrame(absl::string_view frame) {
+  return absl::StrReplaceAll(frame, {{";", ","}, {"\n", " "}});
+}
+
+}  // namespace
+
+class BoundExprProfile::ProfilingBoundOperator final : public BoundOperator {
+ public:
+  ProfilingBoundOperator(std::unique_ptr<BoundOperator> op,
+                         Counters& counters, bool collect_perf_counters)
+      : op_(std::move(op)),
+        counters_(counters),
+        collect_perf_counters_(collect_perf_counters) {}
+
+  int64_t EstimateMemoryUsage() const final {
+    return op_->EstimateMemoryUsage();
+  }
+
+  void Run(EvaluationContext* ctx, FramePtr frame) const final {
+    // The operator is run in a separate context in order to intercept its
+    // allocations. The signals are forwarded to the parent context.
+    AllocationTrackingBufferFactory buffer_factory(ctx->buffer_factory());
+    EvaluationContext op_ctx(*ctx, &buffer_factory);
+    PerfCounterValues start_perf_counters;
+    if (collect_perf_counters_) {
+      start_perf_counters = ReadThreadPerfCounters();
+    }
+    int64_t start_nanos = absl::GetCurrentTimeNanos();
+    op_->Run(&op_ctx, frame);
+    int64_t elapsed_nanos = absl::GetCurrentTimeNanos() - start_nanos;
+    if (collect_perf_counters_) {
+      PerfCounterValues perf_counters =
+          ReadThreadPerfCounters() - start_perf_counters;
+      counters_.cycles.fetch_add(perf_counters.cycles,
+                                 std::memory_order_relaxed);
+      counters_.instructions.fetch_add(perf_counters.instructions,
+                                       std::memory_order_relaxed);
+      counters_.llc_misses.fetch_add(perf_counters.llc_misses,
+                                     std::memory_order_relaxed);
+      counters_.branch_misses.fetch_add(perf_counters.branch_misses,
+                                        std::memory_order_relaxed);
+    }
+    counters_.call_count.fetch_add(1, std::memory_order_relaxed);
+    counters_.total_nanos.fetch_add(elapsed_nanos, std::memory_order_relaxed);
+    auto allocation_stats = buffer_factory.GetStats();
+    counters_.allocated_bytes.fetch_add(allocation_stats.allocated_bytes,
+                                        std::memory_order_relaxed);
+    counters_.allocation_count.fetch_add(
+        allocation_stats.create_count + allocation_stats.realloc_count,
+        std::memory_order_relaxed);
+    if (op_ctx.signal_received()) {
+      if (op_ctx.requested_jump() != 0) {
+        ctx->set_requested_jump(op_ctx.requested_jump());
+      }
+      if (!op_ctx.status().ok()) {
+        ctx->set_status(std::move(op_ctx).status());
+      }
+    }
+  }
+
+ private:
+  std::unique_ptr<BoundOperator> op_;
+  Counters& counters_;
+  bool collect_perf_counters_;
+};
+
+BoundExprProfile::BoundExprProfile(std::vector<std::string> display_names,
+                                   std::vector<std::string> stack_traces,
+                                   bool collect_perf_counters)
+    : collect_perf_counters_(collect_perf_counters),
+      display_names_(std::move(display_names)),
+      stack_traces_(std::move(stack_traces)),
+      counters_(display_names_.size()) {
+  DCHECK(stack_traces_.empty() ||
+         stack_traces_.size() == display_names_.size());
+}
+
+std::unique_ptr<BoundOperator> BoundExprProfile::WrapOperator(
+    int64_t index, std::unique_ptr<BoundOperator> op) {
+  DCHECK_GE(index, 0);
+  DCHECK_LT(index, counters_.size());
+  return std::make_unique<ProfilingBoundOperator>(
+      std::move(op), counters_[index], collect_perf_counters_);
+}
+
+std::vector<OperatorProfile> BoundExprProfile::GetOperatorProfiles() const {
+  std::vector<OperatorProfile> result(counters_.size());
+  for (size_t i = 0; i < counters_.size(); ++i) {
+    result[i].display_name = display_names_[i];
+    if (!stack_traces_.empty()) {
+      result[i].stack_trace = stack_traces_[i];
+    }
+    result[i].call_count =
+        counters_[i].call_count.load(std::memory_order_relaxed);
+    result[i].total_nanos =
+        counters_[i].total_nanos.load(std::memory_order_relaxed);
+    result[i].allocated_bytes =
+        counters_[i].allocated_bytes.load(std::memory_order_relaxed);
+    result[i].allocation_count =
+        counters_[i].allocation_count.load(std::memory_order_relaxed);
+    result[i].perf_counters.cycles =
+        counters_[i].cycles.load(std::memory_order_relaxed);
+    result[i].perf_counters.instructions =
+        counters_[i].instructions.load(std::memory_order_relaxed);
+    result[i].perf_counters.llc_misses =
+        counters_[i].llc_misses.load(std::memory_order_relaxed);
+    result[i].perf_counters.branch_misses =
+        counters_[i].branch_misses.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+std::string BoundExprProfile::FormatAsFoldedStacks(Metric metric) const {
+  std::string result;
+  for (const auto& profile : GetOperatorProfiles()) {
+    if (profile.call_count == 0) {
+      continue;
+    }
+    std::vector<std::string> frames;
+    for (absl::string_view line :
+         absl::StrSplit(profile.stack_trace, '\n', absl::SkipWhitespace())) {
+      frames.push_back(SanitizeFrame(line));
+    }
+    frames.push_back(SanitizeFrame(profile.display_name));
+    int64_t value = 0;
+    switch (metric) {
+      case Metric::kTime:
+        value = profile.total_nanos;
+        break;
+      case Metric::kAllocatedBytes:
+        value = profile.allocated_bytes;
+        break;
+      case Metric::kAllocationCount:
+        value = profile.allocation_count;
+        break;
+      case Metric::kCycles:
+        value = profile.perf_counters.cycles;
+        break;
+      case Metric::kInstructions:
+        value = profile.perf_counters.instructions;
+        break;
+      case Metric::kLlcMisses:
+        value = profile.perf_counters.llc_misses;
+        break;
+      case Metric::kBranchMisses:
+        value = profile.perf_counters.branch_misses;
+        break;
+    }
+    absl::StrAppend(&result, absl::StrJoin(frames, ";"), " ", value, "\n");
+  }
+  return result;
+}
+
+void BoundExprProfile::Reset() {
+  for (auto& counters : counters_) {
+    counters.call_count.store(0, std::memory_order_relaxed);
+    counters.total_nanos.store(0, std::memory_order_relaxed);
+    counters.allocated_bytes.store(0, std::memory_order_relaxed);
+    counters.allocation_count.store(0, std::memory_order_relaxed);
+    counters.cycles.store(0, std::memory_order_relaxed);
+    counters.instructions.store(0, std::memory_order_relaxed);
+    counters.llc_misses.store(0, std::memory_order_relaxed);
+    counters.branch_misses.store(0, std::memory_order_relaxed);
+  }
+}
+
+ExecutionTracer::ExecutionTracer(
+    ExecutionTraceSink* sink, int64_t sampling_period,
+    std::vector<std::string> display_names,
+    std::vector<std::vector<TypedSlot>> output_slots)
+    : sink_(sink),
+      sampling_period_(sampling_period),
+      display_names_(std::move(display_names)),
+      output_slots_(std::move(output_slots)) {
+  DCHECK(sink_ != nullptr);
+  DCHECK_EQ(display_names_.size(), output_slots_.size());
+}
+
+bool ExecutionTracer::ShouldSample() const {
+  if (sampling_period_ <= 1) {
+    return true;
+  }
+  // xorshift64*, seeded by the address of the thread-local state so that the
+  // threads do not sample in lockstep.
+  thread_local uint64_t state = 0;
+  if (ABSL_PREDICT_FALSE(state == 0)) {
+    state = reinterpret_cast<uintptr_t>(&state) | 1;
+  }
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return (state * 0x2545F4914F6CDD1DULL) % sampling_period_ == 0;
+}
+
+int64_t ExecutionTracer::Run(
+    absl::Span<const std::unique_ptr<BoundOperator>> ops,
+    EvaluationContext* ctx, FramePtr frame) const {
+  DCHECK_OK(ctx->status());
+  DCHECK_EQ(ctx->requested_jump(), 0);
+  DCHECK(!ctx->signal_received());
+  DCHECK_EQ(ops.size(), display_names_.size());
+  ExecutionTrace trace;
+  trace.operators.reserve(ops.size());
+  const int64_t start_nanos = absl::GetCurrentTimeNanos();
+  size_t ip = 0;
+  for (; ip < ops.size(); ++ip) {
+    const int64_t op_start_nanos = absl::GetCurrentTimeNanos();
+    ops[ip]->Run(ctx, frame);
+    OperatorTrace& op_trace = trace.operators.emplace_back();
+    op_trace.nanos = absl::GetCurrentTimeNanos() - op_start_nanos;
+    op_trace.ip = ip;
+    op_trace.display_name = display_names_[ip];
+    for (TypedSlot slot : output_slots_[ip]) {
+      if (IsArrayLikeQType(slot.GetType())) {
+        if (auto size = GetArraySize(TypedRef::FromSlot(slot, frame));
+            size.ok()) {
+          op_trace.output_array_sizes.push_back(*size);
+        }
+      }
+    }
+    if (ABSL_PREDICT_FALSE(ctx->signal_received())) {
+      if (ctx->requested_jump() != 0) {
+        ip += ctx->requested_jump();
+        DCHECK_LT(ip, ops.size());
+      }
+      if (!ctx->status().ok()) {
+        break;
+      }
+      ctx->ResetSignals();
+    }
+  }
+  trace.total_nanos = absl::GetCurrentTimeNanos() - start_nanos;
+  trace.status = ctx->status();
+  sink_->Record(trace);
+  return ip < ops.size() ? ip : ip - 1;
+}
+
+}  // namespace arolla::expr
@@ -0,0 +1,180 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_PROFILING_H_
+#define AROLLA_EXPR_EVAL_PROFILING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/memory/frame.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/perf_counters.h"
+
+namespace arolla::expr {
+
+// Evaluation statistics of a single operator of a DynamicBoundExpr.
+struct OperatorProfile {
+  // Name of the operator, as in DynamicBoundExpr error messages.
+  std::string display_name;
+  // ExprStackTrace of the operator, empty if not available.
+  std::string stack_trace;
+
+  int64_t call_count = 0;
+  int64_t total_nanos = 0;
+  // Bytes allocated through EvaluationContext::buffer_factory().
+  int64_t allocated_bytes = 0;
+  // CreateRawBuffer and ReallocRawBuffer calls on
+  // EvaluationContext::buffer_factory().
+  int64_t allocation_count = 0;
+  // Hardware performance counters of the operator evaluations. Only if
+  // compiled with DynamicEvaluationEngineOptions::profile_perf_counters and
+  // PerfCountersAvailable().
+  PerfCounterValues perf_counters;
+};
+
+// Per-operator profile of a DynamicBoundExpr compiled with
+// DynamicEvaluationEngineOptions::enable_profiling. The counters are
+// aggregated over all the evaluations, including the concurrent ones.
+class BoundExprProfile {
+ public:
+  enum class Metric {
+    kTime,
+    kAllocatedBytes,
+    kAllocationCount,
+    kCycles,
+    kInstructions,
+    kLlcMisses,
+    kBranchMisses,
+  };
+
+  // `display_names` and `stack_traces` (if not empty) must have an element per
+  // profiled operator. With `collect_perf_counters` the operators also record
+  // the hardware performance counters of the evaluating thread, which costs
+  // two extra syscalls per call.
+  BoundExprProfile(std::vector<std::string> display_names,
+                   std::vector<std::string> stack_traces,
+                   bool collect_perf_counters = false);
+
+  // Wraps `op` so that its evaluations are recorded into the profile of the
+  // `index`-th operator. The profile must outlive the returned operator.
+  std::unique_ptr<BoundOperator> WrapOperator(
+      int64_t index, std::unique_ptr<BoundOperator> op);
+
+  // Returns the collected statistics, one item per operator.
+  std::vector<OperatorProfile> GetOperatorProfiles() const;
+
+  // Formats the profile in the "folded stacks" format (one "frame;frame value"
+  // line per operator) accepted by flamegraph.pl and most profile viewers. The
+  // frames are the lines of the operator stack trace (e.g. the original node,
+  // then the compiled one) followed by the operator name. Operators that were
+  // never called are omitted.
+  std::string FormatAsFoldedStacks(Metric metric = Metric::kTime) const;
+
+  // Resets all the counters.
+  void Reset();
+
+ private:
+  struct Counters {
+    std::atomic<int64_t> call_count = 0;
+    std::atomic<int64_t> total_nanos = 0;
+    std::atomic<int64_t> allocated_bytes = 0;
+    std::atomic<int64_t> allocation_count = 0;
+    std::atomic<int64_t> cycles = 0;
+    std::atomic<int64_t> instructions = 0;
+    std::atomic<int64_t> llc_misses = 0;
+    std::atomic<int64_t> branch_misses = 0;
+  };
+  class ProfilingBoundOperator;
+
+  bool collect_perf_counters_;
+  std::vector<std::string> display_names_;
+  std::vector<std::string> stack_traces_;
+  std::vector<Counters> counters_;
+};
+
+// A single operator evaluation recorded in an ExecutionTrace.
+struct OperatorTrace {
+  // Position of the operator in the program.
+  int64_t ip = 0;
+  // Name of the operator, as in DynamicBoundExpr error messages. Valid only
+  // during the ExecutionTraceSink::Record call.
+  absl::string_view display_name;
+  int64_t nanos = 0;
+  // Sizes of the arrays (DenseArray, Array) written by the operator. Empty if
+  // the operator does not produce arrays or its outputs are not declared.
+  std::vector<int64_t> output_array_sizes;
+};
+
+// A trace of a single sampled evaluation of a DynamicBoundExpr, see
+// DynamicEvaluationEngineOptions::trace_sink.
+struct ExecutionTrace {
+  // The evaluated operators, in the evaluation order. The operators skipped by
+  // jumps are not included.
+  std::vector<OperatorTrace> operators;
+  int64_t total_nanos = 0;
+  // The evaluation status, without the operator context added by
+  // DynamicBoundExpr.
+  absl::Status status;
+};
+
+// Receives the traces of the sampled evaluations.
+class ExecutionTraceSink {
+ public:
+  virtual ~ExecutionTraceSink() = default;
+
+  // Called by the evaluating thread at the end of every sampled evaluation.
+  // Must be thread-safe, and should be fast because it delays the evaluation
+  // result.
+  virtual void Record(const ExecutionTrace& trace) = 0;
+};
+
+// Traces one in `sampling_period` evaluations of a DynamicBoundExpr. The
+// decision is made per evaluation by ShouldSample(), the sampled evaluations
+// run the same operators through the instrumented loop in Run().
+class ExecutionTracer {
+ public:
+  // `display_names` and `output_slots` must have an element per operator of the
+  // program. `sink` must outlive the tracer.
+  ExecutionTracer(ExecutionTraceSink* sink, int64_t sampling_period,
+                  std::vector<std::string> display_names,
+                  std::vector<std::vector<TypedSlot>> output_slots);
+
+  // Returns true for a random one in `sampling_period` calls (always if
+  // `sampling_period` is 1 or less). Uses a thread-local generator, so the
+  // concurrent evaluations do not contend.
+  bool ShouldSample() const;
+
+  // Same as RunBoundOperators, but records the evaluation into the sink.
+  int64_t Run(absl::Span<const std::unique_ptr<BoundOperator>> ops,
+              EvaluationContext* ctx, FramePtr frame) const;
+
+ private:
+  ExecutionTraceSink* sink_;
+  int64_t sampling_period_;
+  std::vector<std::string> display_names_;
+  std::vector<std::vector<TypedSlot>> output_slots_;
+};
+
+}  // namespace arolla::expr
+
+#endif  // AROLLA_EXPR_EVAL_PROFILING_H_
@@ -0,0 +1,196 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/scalar_broadcast_elimination.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/backend_wrapping_operator.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_operator.h"
+#include "arolla/expr/expr_operator_signature.h"
+#include "arolla/expr/expr_stack_trace.h"
+#include "arolla/expr/expr_visitor.h"
+#include "arolla/expr/registered_expr_operator.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::expr::eval_internal {
+namespace {
+
+// Backend operators that have (DenseArray<T>, T) and (T, DenseArray<T>)
+// overloads returning DenseArray<T>.
+bool HasMixedOverloads(absl::string_view name) {
+  static const Indestructible<absl::flat_hash_set<absl::string_view>> kOps({
+      "math.add",
+      "math.divide",
+      "math.maximum",
+      "math.minimum",
+      "math.multiply",
+      "math.subtract",
+  });
+  return kOps->contains(name);
+}
+
+absl::StatusOr<std::optional<absl::string_view>> GetBackendOperatorName(
+    const ExprNodePtr& node) {
+  if (!node->is_op()) {
+    return std::nullopt;
+  }
+  ASSIGN_OR_RETURN(auto op, DecayRegisteredOperator(node->op()));
+  if (!HasBackendExprOperatorTag(op)) {
+    return std::nullopt;
+  }
+  return op->display_name();
+}
+
+// Returns true if `node` is core.shape_of(`array`) after lowering, i.e.
+// core._array_shape_of(core.has._array(array)) or core._array_shape_of(array).
+absl::StatusOr<bool> IsShapeOf(const ExprNodePtr& node,
+                               const ExprNodePtr& array) {
+  ASSIGN_OR_RETURN(auto op_name, GetBackendOperatorName(node));
+  if (op_name != "core._array_shape_of" || node->node_deps().size() != 1) {
+    return false;
+  }
+  const ExprNodePtr& arg = node->node_deps()[0];
+  if (arg->fingerprint() == array->fingerprint()) {
+    return true;
+  }
+  ASSIGN_OR_RETURN(auto arg_op_name, GetBackendOperatorName(arg));
+  return arg_op_name == "core.has._array" && arg->node_deps().size() == 1 &&
+         arg->node_deps()[0]->fingerprint() == array->fingerprint();
+}
+
+// Returns the broadcasted scalar if the node is
+// core.const_with_shape(core.shape_of(array), scalar) with a non-optional
+// scalar. Broadcasting to other shapes is kept, so the size mismatch errors
+// are still reported.
+absl::StatusOr<std::optional<ExprNodePtr>> GetBroadcastedScalar(
+    const ExprNodePtr& node, const ExprNodePtr& array) {
+  ASSIGN_OR_RETURN(auto op_name, GetBackendOperatorName(node));
+  if (!op_name.has_value() ||
+      !absl::StartsWith(*op_name, "core.const_with_shape") ||
+      node->node_deps().size() != 2 ||
+      !IsScalarQType(node->node_deps()[1]->qtype())) {
+    return std::nullopt;
+  }
+  ASSIGN_OR_RETURN(bool is_shape_of, IsShapeOf(node->node_deps()[0], array));
+  if (!is_shape_of) {
+    return std::nullopt;
+  }
+  return node->node_deps()[1];
+}
+
+// Returns the node with one of the broadcasted arguments replaced by the
+// scalar, or std::nullopt if there is no suitable backend overload.
+absl::StatusOr<std::optional<ExprNodePtr>> ReadBroadcastedScalar(
+    const DynamicEvaluationEngineOptions& options, const ExprNodePtr& node,
+    std::vector<ExprNodePtr> new_deps) {
+  ASSIGN_OR_RETURN(auto op_name, GetBackendOperatorName(node));
+  if (!op_name.has_value() || !HasMixedOverloads(*op_name) ||
+      new_deps.size() != 2 || !IsDenseArrayQType(node->qtype())) {
+    return std::nullopt;
+  }
+  const OperatorDirectory& backend_operators =
+      options.operator_directory != nullptr ? *options.operator_directory
+                                            : *OperatorRegistry::GetInstance();
+  // If both arguments are broadcasted, the first one is kept as the array.
+  for (size_t scalar_index : {1, 0}) {
+    const ExprNodePtr& array = new_deps[1 - scalar_index];
+    ASSIGN_OR_RETURN(auto scalar,
+                     GetBroadcastedScalar(new_deps[scalar_index], array));
+    if (!scalar.has_value() || array->qtype() != node->qtype() ||
+        (*scalar)->qtype() != node->qtype()->value_qtype()) {
+      continue;
+    }
+    new_deps[scalar_index] = *std::move(scalar);
+    std::vector<QTypePtr> input_qtypes = {new_deps[0]->qtype(),
+                                          new_deps[1]->qtype()};
+    if (!backend_operators
+             .LookupOperator(*op_name, input_qtypes, node->qtype())
+             .ok()) {
+      return std::nullopt;
+    }
+    QTypePtr output_qtype = node->qtype();
+    auto op = std::make_shared<BackendWrappingOperator>(
+        *op_name, ExprOperatorSignature{{"x"}, {"y"}},
+        [output_qtype](absl::Span<const QTypePtr>) { return output_qtype; });
+    return MakeOpNode(std::move(op), std::move(new_deps));
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+absl::StatusOr<ExprNodePtr> EliminateScalarBroadcasts(
+    const DynamicEvaluationEngineOptions& options, ExprNodePtr expr,
+    std::shared_ptr<ExprStackTrace> stack_trace) {
+  PostOrder post_order(expr);
+  std::vector<ExprNodePtr> new_nodes(post_order.nodes_size());
+  for (size_t i = 0; i < post_order.nodes_size(); ++i) {
+    const auto& node = post_order.node(i);
+    if (node->node_deps().empty()) {
+      new_nodes[i] = node;
+      continue;
+    }
+    std::vector<ExprNodePtr> new_deps;
+    new_deps.reserve(node->node_deps().size());
+    for (size_t dep_index : post_order.dep_indices(i)) {
+      new_deps.push_back(new_nodes[dep_index]);
+    }
+    ASSIGN_OR_RETURN(auto optimized,
+                     ReadBroadcastedScalar(options, node, new_deps));
+    if (optimized.has_value()) {
+      if ((*optimized)->qtype() != node->qtype()) {
+        return absl::InternalError(absl::StrFormat(
+            "scalar broadcast elimination changes the output type of %s: "
+            "expected %s, got %s",
+            node->op()->display_name(), node->qtype()->name(),
+            (*optimized)->qtype() == nullptr ? "nullptr"
+                                             : (*optimized)->qtype()->name()));
+      }
+      new_nodes[i] = *std::move(optimized);
+      if (stack_trace != nullptr) {
+        stack_trace->AddTrace(new_nodes[i], node,
+                              TransformationType::kOptimization);
+      }
+      continue;
+    }
+    ASSIGN_OR_RETURN(new_nodes[i],
+                     WithNewDependencies(node, std::move(new_deps)));
+    if (stack_trace != nullptr) {
+      stack_trace->AddTrace(new_nodes[i], node,
+                            TransformationType::kChildTransform);
+    }
+  }
+  return new_nodes.back();
+}
+
+}  // namespace arolla::expr::eval_internal
@@ -0,0 +1,47 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_SCALAR_BROADCAST_ELIMINATION_H_
+#define AROLLA_EXPR_EVAL_SCALAR_BROADCAST_ELIMINATION_H_
+
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_stack_trace.h"
+
+namespace arolla::expr::eval_internal {
+
+// Replaces the scalars broadcasted by core.const_with_shape in the arguments
+// of the pointwise binary arithmetic operators on DenseArrays with the scalars
+// themselves, e.g.
+//
+//   math.add(x, core.const_with_shape._array_shape(core.shape_of(x), 1.0))
+//
+// becomes math.add(x, 1.0), evaluated by the DenseArray-scalar backend
+// overload. So the scalar is read from its slot instead of from an array of
+// its N copies that had to be allocated and filled first.
+//
+// Only the non-optional scalars broadcasted to the shape of the other argument
+// are handled, so the transformation does not hide size mismatches. The nodes
+// for which the backend has no mixed overload are kept unchanged. The
+// transformation expects the expression to be lowered and casted.
+absl::StatusOr<ExprNodePtr> EliminateScalarBroadcasts(
+    const DynamicEvaluationEngineOptions& options, ExprNodePtr expr,
+    std::shared_ptr<ExprStackTrace> stack_trace = nullptr);
+
+}  // namespace arolla::expr::eval_internal
+
+#endif  // AROLLA_EXPR_EVAL_SCALAR_BROADCAST_ELIMINATION_H_
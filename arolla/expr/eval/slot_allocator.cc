@@ -23,6 +23,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "arolla/expr/expr_debug_string.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_visitor.h"
@@ -37,9 +38,16 @@ SlotAllocator::SlotAllocator(
     const ExprNodePtr& root, FrameLayout::Builder& layout_builder,
     const absl::flat_hash_map<std::string, TypedSlot>& input_slots,
     bool allow_reusing_leaves)
+    : SlotAllocator(PostOrder(root), layout_builder, input_slots,
+                    allow_reusing_leaves) {}
+
+SlotAllocator::SlotAllocator(
+    const PostOrder& post_order, FrameLayout::Builder& layout_builder,
+    const absl::flat_hash_map<std::string, TypedSlot>& input_slots,
+    bool allow_reusing_leaves)
     : layout_builder_(&layout_builder),
       allow_reusing_leaves_(allow_reusing_leaves) {
-  auto node_order = VisitorOrder(root);
+  absl::Span<const ExprNodePtr> node_order = post_order.nodes();
   last_usages_.reserve(node_order.size());
   for (int64_t i = 0; i < node_order.size(); ++i) {
     const auto& node = node_order[i];
@@ -97,7 +105,7 @@ absl::Status SlotAllocator::ExtendSlotLifetime(const ExprNodePtr& of,
 }
 
 absl::Status SlotAllocator::ReleaseSlotsNotNeededAfter(
-    const ExprNodePtr& node) {
+    const ExprNodePtr& node, std::vector<TypedSlot>* released_slots) {
   absl::flat_hash_set<Fingerprint> processed_deps;
   for (ExprNodePtr dep : node->node_deps()) {
     if (node_origin_.contains(dep->fingerprint())) {
@@ -120,6 +128,9 @@ absl::Status SlotAllocator::ReleaseSlotsNotNeededAfter(
             "missing slot information for node %s", GetDebugSnippet(dep)));
       }
       reusable_slots_[slot_it->second.GetType()].push_back(slot_it->second);
+      if (released_slots != nullptr) {
+        released_slots->push_back(slot_it->second);
+      }
       node_result_slot_.erase(slot_it);
       last_usages_.erase(last_usage_it);
     }
@@ -127,6 +138,22 @@ absl::Status SlotAllocator::ReleaseSlotsNotNeededAfter(
   return absl::OkStatus();
 }
 
+bool SlotAllocator::IsLastUsage(const ExprNodePtr& dep,
+                                const ExprNodePtr& node) const {
+  const ExprNodePtr* origin = &dep;
+  if (auto it = node_origin_.find(dep->fingerprint());
+      it != node_origin_.end()) {
+    origin = &it->second;
+  }
+  if (!(*origin)->is_op() && !((*origin)->is_leaf() && allow_reusing_leaves_)) {
+    return false;
+  }
+  auto last_usage_it = last_usages_.find((*origin)->fingerprint());
+  return last_usage_it != last_usages_.end() &&
+         last_usage_it->second.node_fingerprint == node->fingerprint() &&
+         node_result_slot_.contains((*origin)->fingerprint());
+}
+
 std::vector<TypedSlot> SlotAllocator::ReusableSlots() const {
   std::vector<TypedSlot> result;
   for (const auto& [_, slots] : reusable_slots_) {
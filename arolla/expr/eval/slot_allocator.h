@@ -22,6 +22,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_visitor.h"
 #include "arolla/memory/frame.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
@@ -51,6 +52,13 @@ class SlotAllocator {
                 const absl::flat_hash_map<std::string, TypedSlot>& input_slots,
                 bool allow_reusing_leaves);
 
+  // Same as above, but reuses an already computed post order of the
+  // expression (which coincides with its VisitorOrder).
+  SlotAllocator(const PostOrder& post_order,
+                FrameLayout::Builder& layout_builder,
+                const absl::flat_hash_map<std::string, TypedSlot>& input_slots,
+                bool allow_reusing_leaves);
+
   // Creates or returns a reused slot of type `type`. Always creates a new slot
   // if `allow_recycled=false`.
   TypedSlot AddSlotForNode(const ExprNodePtr& node, QTypePtr type,
@@ -61,8 +69,16 @@ class SlotAllocator {
   // ReleaseSlotsNotNeededAfter for the current last usage of `of`.
   absl::Status ExtendSlotLifetime(const ExprNodePtr& of, const ExprNodePtr& to);
 
-  // Releases all the slots last used by `node`.
-  absl::Status ReleaseSlotsNotNeededAfter(const ExprNodePtr& node);
+  // Releases all the slots last used by `node`. If `released_slots` is not
+  // null, the released slots are appended to it, so the caller can e.g. free
+  // the resources held by the dead values.
+  absl::Status ReleaseSlotsNotNeededAfter(
+      const ExprNodePtr& node,
+      std::vector<TypedSlot>* released_slots = nullptr);
+
+  // Returns true if the result slot of `dep` is last used by `node`, i.e. it
+  // will be released by the ReleaseSlotsNotNeededAfter(node) call.
+  bool IsLastUsage(const ExprNodePtr& dep, const ExprNodePtr& node) const;
 
   // Returns a current list of reusable slots. The list may be useful for
   // cleanup operations at the end of the program. However the returned slots
@@ -15,6 +15,7 @@
 #include "arolla/expr/eval/slot_allocator.h"
 
 #include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -167,5 +168,32 @@ TEST_F(SlotAllocatorTest, CompilerWorkflowWithReusedLeaves) {
                        HasSubstr("missing last usage for node")));
 }
 
+TEST_F(SlotAllocatorTest, ReportsReleasedSlots) {
+  ASSERT_OK_AND_ASSIGN(auto x1_x2,
+                       CallOp("math.add", {Leaf("x1"), Leaf("x2")}));
+  ASSERT_OK_AND_ASSIGN(auto x1_x2_x2, CallOp("math.add", {x1_x2, Leaf("x2")}));
+  FrameLayout::Builder layout_builder;
+  absl::flat_hash_map<std::string, TypedSlot> input_slots{
+      {"x1", TypedSlot::FromSlot(layout_builder.AddSlot<float>())},
+      {"x2", TypedSlot::FromSlot(layout_builder.AddSlot<float>())},
+  };
+  SlotAllocator allocator(x1_x2_x2, layout_builder, input_slots,
+                          /*allow_reusing_leaves=*/true);
+
+  std::vector<TypedSlot> released_slots;
+  TypedSlot x1_x2_slot = allocator.AddSlotForNode(x1_x2, GetQType<float>(),
+                                                  /*allow_recycled=*/true);
+  EXPECT_THAT(allocator.ReleaseSlotsNotNeededAfter(x1_x2, &released_slots),
+              IsOk());
+  EXPECT_THAT(released_slots, ElementsAre(input_slots.at("x1")));
+
+  released_slots.clear();
+  allocator.AddSlotForNode(x1_x2_x2, GetQType<float>(),
+                           /*allow_recycled=*/true);
+  EXPECT_THAT(allocator.ReleaseSlotsNotNeededAfter(x1_x2_x2, &released_slots),
+              IsOk());
+  EXPECT_THAT(released_slots, ElementsAre(x1_x2_slot, input_slots.at("x2")));
+}
+
 }  // namespace
 }  // namespace arolla::expr::eval_internal
@@ -15,21 +15,59 @@
 #ifndef AROLLA_EXPR_EVAL_THREAD_SAFE_MODEL_EXECUTOR_H_
 #define AROLLA_EXPR_EVAL_THREAD_SAFE_MODEL_EXECUTOR_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/log/check.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "arolla/expr/eval/model_executor.h"
+#include "arolla/qtype/typed_value_interner.h"
+#include "arolla/util/numa.h"
 #include "arolla/util/threadlocal.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr {
 
+// Schedules a task for asynchronous execution, e.g. on the worker pool of an
+// RPC framework. Must run every scheduled task exactly once.
+using AsyncScheduler = std::function<void(absl::AnyInvocable<void() &&>)>;
+
+// Evaluates `model(input)` in a task scheduled on `scheduler` and passes the
+// result to `done(absl::StatusOr<Output>)` in the same task.
+//
+// `model` can be any thread-safe model, e.g. a function compiled by
+// ExprCompiler or ThreadSafePoolModelExecutor. It is copied into the task,
+// which is cheap for them, since the copies share the compiled model. `input`
+// is moved into the task, so if it is a view (e.g. absl::Span), the referenced
+// data must outlive the task.
+//
+// NOTE: the evaluation itself is not interruptible, so a long evaluation (e.g.
+// of core.while_loop or seq.map) occupies the scheduler thread till the end.
+// Split big batches (see ModelExecutor::ExecuteBatch) to bound the task time.
+template <typename Model, typename Input, typename DoneFn>
+void ExecuteAsync(const AsyncScheduler& scheduler, Model model, Input input,
+                  DoneFn done) {
+  scheduler([model = std::move(model), input = std::move(input),
+             done = std::move(done)]() mutable {
+    std::move(done)(model(input));
+  });
+}
+
 // A wrapper around ModelExecutor that is thread safe.
 //
 // Check ThreadSafeModelExecutorPolicy for parallelization options.
@@ -93,8 +131,147 @@ class ThreadSafeModelExecutor {
       thread_local_executor_;
 };
 
+namespace thread_safe_model_executor_impl {
+
+// A pool of idle executors that can release some of them on request.
+class IdleExecutorPool {
+ public:
+  virtual ~IdleExecutorPool() = default;
+
+  // Destroys the idle executors that were not needed since the previous call.
+  virtual void TrimIdleExecutors() = 0;
+};
+
+// Evaluates `executor` on every sample input, so its arenas grow to the sizes
+// needed by the samples and the literals used by them are paged in. The output
+// cache is bypassed, otherwise only the first executor would evaluate.
+template <typename Executor, typename Input>
+absl::Status EvaluateWarmupSamples(Executor& executor,
+                                   absl::Span<const Input> sample_inputs) {
+  ModelEvaluationOptions options;
+  options.bypass_output_cache = true;
+  for (const auto& input : sample_inputs) {
+    RETURN_IF_ERROR(executor.Execute(options, input).status())
+        << "during the model warmup";
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace thread_safe_model_executor_impl
+
+// A memory budget for the idle executors of ThreadSafePoolModelExecutor-s,
+// usually shared by all the models in the process. A pool keeps a returned
+// executor only if its memory (see ModelExecutor::GetMemoryUsage) fits into
+// the budget, otherwise the executor is destroyed. So the memory kept by the
+// idle executors stays bounded regardless of the number of the models. The
+// executors in use are not limited.
+//
+// The class is thread safe.
+class ExecutorPoolMemoryBudget {
+  using IdleExecutorPool = thread_safe_model_executor_impl::IdleExecutorPool;
+
+ public:
+  explicit ExecutorPoolMemoryBudget(int64_t budget_bytes)
+      : budget_bytes_(budget_bytes) {}
+
+  ExecutorPoolMemoryBudget(const ExecutorPoolMemoryBudget&) = delete;
+  ExecutorPoolMemoryBudget& operator=(const ExecutorPoolMemoryBudget&) =
+      delete;
+
+  // Reserves `bytes` of the budget. Returns false (and reserves nothing) if
+  // the budget would be exceeded.
+  bool TryAcquire(int64_t bytes) {
+    int64_t used = used_bytes_.load(std::memory_order_relaxed);
+    do {
+      if (used + bytes > budget_bytes_) {
+        return false;
+      }
+    } while (!used_bytes_.compare_exchange_weak(used, used + bytes,
+                                                std::memory_order_relaxed));
+    return true;
+  }
+
+  // Returns `bytes` previously reserved by TryAcquire.
+  void Release(int64_t bytes) {
+    used_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  int64_t budget_bytes() const { return budget_bytes_; }
+  int64_t used_bytes() const {
+    return used_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Trims all the alive pools using the budget, see
+  // ThreadSafePoolModelExecutor::TrimIdleExecutors. Supposed to be called
+  // periodically, e.g. from a background task of the server.
+  void TrimIdlePools() {
+    std::vector<std::shared_ptr<IdleExecutorPool>> pools;
+    {
+      absl::MutexLock l(&mutex_);
+      pools.reserve(pools_.size());
+      auto alive_end = std::remove_if(
+          pools_.begin(), pools_.end(),
+          [](const auto& pool) { return pool.expired(); });
+      pools_.erase(alive_end, pools_.end());
+      for (const auto& pool : pools_) {
+        if (auto locked_pool = pool.lock()) {
+          pools.push_back(std::move(locked_pool));
+        }
+      }
+    }
+    for (const auto& pool : pools) {
+      pool->TrimIdleExecutors();
+    }
+  }
+
+  // Registers a pool for TrimIdlePools. Called by ThreadSafePoolModelExecutor.
+  void RegisterPool(std::weak_ptr<IdleExecutorPool> pool) {
+    absl::MutexLock l(&mutex_);
+    pools_.push_back(std::move(pool));
+  }
+
+ private:
+  const int64_t budget_bytes_;
+  std::atomic<int64_t> used_bytes_ = 0;
+  absl::Mutex mutex_;
+  std::vector<std::weak_ptr<IdleExecutorPool>> pools_ ABSL_GUARDED_BY(mutex_);
+};
+
+struct ThreadSafePoolModelExecutorOptions {
+  static constexpr size_t kDefaultMaximumCacheSize = 400;
+
+  // The maximum number of idle executors kept by the pool. Zero disables the
+  // pool, so every call clones a new executor.
+  size_t maximum_cache_size = kDefaultMaximumCacheSize;
+
+  // If set, the idle executors are kept only while they fit into the budget.
+  std::shared_ptr<ExecutorPoolMemoryBudget> memory_budget = nullptr;
+
+  // If positive, the pool calls TrimIdleExecutors by itself, at most once per
+  // the interval, when an executor is returned to it. Otherwise the executors
+  // are trimmed only by explicit TrimIdleExecutors / TrimIdlePools calls.
+  absl::Duration idle_trim_interval = absl::ZeroDuration();
+};
+
+// Statistics of a ThreadSafePoolModelExecutor.
+struct ThreadSafePoolModelExecutorStats {
+  // The number of executors kept in the pool.
+  int64_t idle_executors = 0;
+  // The number of executors currently evaluating the model.
+  int64_t executors_in_use = 0;
+  // The memory kept by the idle executors, see ModelExecutor::GetMemoryUsage.
+  int64_t idle_memory_bytes = 0;
+  // The max of executors_in_use since the previous TrimIdleExecutors call.
+  int64_t peak_executors_in_use = 0;
+};
+
 // An object-pool based wrapper around ModelExecutor that is thread safe.
 //
+// The pool adapts to the observed concurrency: TrimIdleExecutors keeps only as
+// many executors as were used simultaneously since its previous call, and
+// destroys the rest together with their frames and arenas. The total memory of
+// the idle executors across models can be bounded by ExecutorPoolMemoryBudget.
+//
 // DO NOT USE directly, prefer ExprCompiler instead.
 //
 template <typename Input, typename Output, typename SideOutput = void>
@@ -102,13 +279,25 @@ class ThreadSafePoolModelExecutor {
   using WrappedModelExecutor = ModelExecutor<Input, Output, SideOutput>;
 
  public:
-  static constexpr size_t kDefaultMaximumCacheSize = 400;
+  static constexpr size_t kDefaultMaximumCacheSize =
+      ThreadSafePoolModelExecutorOptions::kDefaultMaximumCacheSize;
 
   explicit ThreadSafePoolModelExecutor(
       WrappedModelExecutor&& prototype_executor,
       size_t maximum_cache_size = kDefaultMaximumCacheSize)
+      : ThreadSafePoolModelExecutor(
+            std::move(prototype_executor),
+            ThreadSafePoolModelExecutorOptions{.maximum_cache_size =
+                                                   maximum_cache_size}) {}
+
+  ThreadSafePoolModelExecutor(WrappedModelExecutor&& prototype_executor,
+                              ThreadSafePoolModelExecutorOptions options)
       : shared_data_(std::make_shared<SharedData>(
-            maximum_cache_size, std::move(prototype_executor))) {}
+            std::move(options), std::move(prototype_executor))) {
+    if (shared_data_->memory_budget != nullptr) {
+      shared_data_->memory_budget->RegisterPool(shared_data_);
+    }
+  }
 
   absl::StatusOr<Output> operator()(const ModelEvaluationOptions& options,
                                     const Input& input,
@@ -130,6 +319,79 @@ class ThreadSafePoolModelExecutor {
     return Execute({}, input);
   }
 
+  // Evaluates the model on `input` asynchronously, see expr::ExecuteAsync.
+  template <typename DoneFn>
+  void ExecuteAsync(const AsyncScheduler& scheduler, Input input,
+                    DoneFn done) const {
+    expr::ExecuteAsync(scheduler, *this, std::move(input), std::move(done));
+  }
+
+  // Prepares the pool for the first requests after the model is loaded:
+  // clones `executor_count` executors, evaluates each of them on all the
+  // `sample_inputs` (see EvaluateWarmupSamples) and puts them to the pool, as
+  // long as they fit into maximum_cache_size and the memory budget. Use the
+  // expected number of the concurrent callers as `executor_count`.
+  absl::Status Warmup(absl::Span<const Input> sample_inputs,
+                      int64_t executor_count) const {
+    DCHECK(IsValid());
+    SharedData& shared_data = *shared_data_;
+    for (int64_t i = 0; i < executor_count; ++i) {
+      ASSIGN_OR_RETURN(auto new_executor,
+                       shared_data.prototype_executor.Clone());
+      auto local_executor =
+          std::make_unique<WrappedModelExecutor>(std::move(new_executor));
+      RETURN_IF_ERROR(thread_safe_model_executor_impl::EvaluateWarmupSamples(
+          *local_executor, sample_inputs));
+      const int64_t memory_bytes = local_executor->GetMemoryUsage();
+      absl::MutexLock l(&shared_data.mutex);
+      if (shared_data.executors_pool.size() >= shared_data.maximum_cache_size ||
+          (shared_data.memory_budget != nullptr &&
+           !shared_data.memory_budget->TryAcquire(memory_bytes))) {
+        break;
+      }
+      shared_data.idle_memory_bytes += memory_bytes;
+      shared_data.executors_pool.push_back(
+          {std::move(local_executor), memory_bytes});
+      // Otherwise the next TrimIdleExecutors() would destroy the executors.
+      shared_data.peak_executors_in_use =
+          std::max<int64_t>(shared_data.peak_executors_in_use,
+                            shared_data.executors_pool.size());
+    }
+    return absl::OkStatus();
+  }
+
+  // Destroys the idle executors above the peak number of the executors used
+  // simultaneously since the previous call, and resets the peak.
+  void TrimIdleExecutors() const {
+    DCHECK(IsValid());
+    shared_data_->TrimIdleExecutors();
+  }
+
+  ThreadSafePoolModelExecutorStats GetStats() const {
+    DCHECK(IsValid());
+    absl::MutexLock l(&shared_data_->mutex);
+    return {
+        .idle_executors =
+            static_cast<int64_t>(shared_data_->executors_pool.size()),
+        .executors_in_use = shared_data_->executors_in_use,
+        .idle_memory_bytes = shared_data_->idle_memory_bytes,
+        .peak_executors_in_use = shared_data_->peak_executors_in_use};
+  }
+
+  // Returns a breakdown of the memory used by the model, see
+  // ModelExecutor::GetMemoryReport. The frame and the arena are the ones of a
+  // single executor, the memory of the idle executors is reported as
+  // pool_bytes.
+  ModelMemoryReport GetMemoryReport(
+      absl::Nullable<const TypedValueInterner*> interner = nullptr) const {
+    DCHECK(IsValid());
+    ModelMemoryReport report =
+        shared_data_->prototype_executor.GetMemoryReport(interner);
+    absl::MutexLock l(&shared_data_->mutex);
+    report.pool_bytes = shared_data_->idle_memory_bytes;
+    return report;
+  }
+
   bool IsValid() const {
     return shared_data_ != nullptr &&
            shared_data_->prototype_executor.IsValid();
@@ -140,14 +402,224 @@ class ThreadSafePoolModelExecutor {
                                  const Input& input,
                                  SideOutput* side_output = nullptr) const {
     DCHECK(IsValid());
+    SharedData& shared_data = *shared_data_;
 
     std::unique_ptr<WrappedModelExecutor> local_executor;
-    if (shared_data_->maximum_cache_size != 0) {
-      absl::MutexLock l(&shared_data_->mutex);
-      if (!shared_data_->executors_pool.empty()) {
-        local_executor = std::move(shared_data_->executors_pool.back());
-        shared_data_->executors_pool.pop_back();
+    if (shared_data.maximum_cache_size != 0) {
+      absl::MutexLock l(&shared_data.mutex);
+      if (!shared_data.executors_pool.empty()) {
+        auto& idle_executor = shared_data.executors_pool.back();
+        local_executor = std::move(idle_executor.executor);
+        shared_data.ReleaseIdleMemory(idle_executor.memory_bytes);
+        shared_data.executors_pool.pop_back();
       }
+      ++shared_data.executors_in_use;
+      shared_data.peak_executors_in_use = std::max(
+          shared_data.peak_executors_in_use, shared_data.executors_in_use);
+    }
+    if (local_executor == nullptr) {
+      auto new_executor = shared_data.prototype_executor.Clone();
+      if (!new_executor.ok()) {
+        if (shared_data.maximum_cache_size != 0) {
+          absl::MutexLock l(&shared_data.mutex);
+          --shared_data.executors_in_use;
+        }
+        return std::move(new_executor).status();
+      }
+      local_executor =
+          std::make_unique<WrappedModelExecutor>(*std::move(new_executor));
+    }
+    auto result = local_executor->Execute(options, input, side_output);
+    if (shared_data.maximum_cache_size != 0) {
+      const int64_t memory_bytes = local_executor->GetMemoryUsage();
+      bool trim_is_due = false;
+      {
+        absl::MutexLock l(&shared_data.mutex);
+        --shared_data.executors_in_use;
+        if (shared_data.executors_pool.size() <
+                shared_data.maximum_cache_size &&
+            (shared_data.memory_budget == nullptr ||
+             shared_data.memory_budget->TryAcquire(memory_bytes))) {
+          shared_data.idle_memory_bytes += memory_bytes;
+          shared_data.executors_pool.push_back(
+              {std::move(local_executor), memory_bytes});
+        }
+        trim_is_due =
+            shared_data.idle_trim_interval > absl::ZeroDuration() &&
+            absl::Now() - shared_data.last_trim_time >=
+                shared_data.idle_trim_interval;
+      }
+      // Not kept executor (if any) is destroyed outside of the lock.
+      local_executor.reset();
+      if (trim_is_due) {
+        shared_data.TrimIdleExecutors();
+      }
+    }
+    return result;
+  }
+
+  struct IdleExecutor {
+    std::unique_ptr<WrappedModelExecutor> executor;
+    int64_t memory_bytes;
+  };
+
+  struct SharedData final
+      : thread_safe_model_executor_impl::IdleExecutorPool {
+    SharedData(ThreadSafePoolModelExecutorOptions options,
+               WrappedModelExecutor prototype_executor)
+        : maximum_cache_size(options.maximum_cache_size),
+          memory_budget(std::move(options.memory_budget)),
+          idle_trim_interval(options.idle_trim_interval),
+          prototype_executor(std::move(prototype_executor)),
+          last_trim_time(absl::Now()) {}
+
+    ~SharedData() override {
+      if (memory_budget != nullptr) {
+        memory_budget->Release(idle_memory_bytes);
+      }
+    }
+
+    void TrimIdleExecutors() final {
+      std::vector<IdleExecutor> trimmed_executors;
+      {
+        absl::MutexLock l(&mutex);
+        const size_t executors_to_keep = static_cast<size_t>(std::max<int64_t>(
+            peak_executors_in_use - executors_in_use, 0));
+        while (executors_pool.size() > executors_to_keep) {
+          ReleaseIdleMemory(executors_pool.back().memory_bytes);
+          trimmed_executors.push_back(std::move(executors_pool.back()));
+          executors_pool.pop_back();
+        }
+        peak_executors_in_use = executors_in_use;
+        last_trim_time = absl::Now();
+      }
+      // trimmed_executors are destroyed outside of the lock.
+    }
+
+    void ReleaseIdleMemory(int64_t memory_bytes)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+      idle_memory_bytes -= memory_bytes;
+      if (memory_budget != nullptr) {
+        memory_budget->Release(memory_bytes);
+      }
+    }
+
+    const size_t maximum_cache_size;
+    const std::shared_ptr<ExecutorPoolMemoryBudget> memory_budget;
+    const absl::Duration idle_trim_interval;
+    WrappedModelExecutor prototype_executor;
+    absl::Mutex mutex;
+    std::vector<IdleExecutor> executors_pool ABSL_GUARDED_BY(mutex);
+    int64_t executors_in_use ABSL_GUARDED_BY(mutex) = 0;
+    int64_t peak_executors_in_use ABSL_GUARDED_BY(mutex) = 0;
+    int64_t idle_memory_bytes ABSL_GUARDED_BY(mutex) = 0;
+    absl::Time last_trim_time ABSL_GUARDED_BY(mutex);
+  };
+
+  std::shared_ptr<SharedData> shared_data_;
+};
+
+// An object-pool based wrapper around ModelExecutor that is thread safe and
+// does not take locks.
+//
+// The pool is a fixed array of slots, each holding at most one idle executor.
+// Every thread has a preferred slot (derived from its id), so in the absence
+// of contention a thread keeps reusing "its own" executor, like a per-thread
+// cache. If the preferred slot is empty (or occupied on return), the
+// neighbouring slots are probed, and as the last resort a new executor is
+// cloned (or the returned one is destroyed).
+//
+// Compared to ThreadSafePoolModelExecutor it scales better with the number of
+// serving threads, but may keep up to `slot_count` idle executors.
+//
+// DO NOT USE directly, prefer ExprCompiler instead.
+//
+template <typename Input, typename Output, typename SideOutput = void>
+class ThreadSafeLockFreePoolModelExecutor {
+  using WrappedModelExecutor = ModelExecutor<Input, Output, SideOutput>;
+
+ public:
+  // Zero means 2 * std::thread::hardware_concurrency().
+  static constexpr size_t kDefaultSlotCount = 0;
+  // Number of slots to probe before cloning / destroying an executor.
+  static constexpr size_t kProbeCount = 4;
+
+  explicit ThreadSafeLockFreePoolModelExecutor(
+      WrappedModelExecutor&& prototype_executor,
+      size_t slot_count = kDefaultSlotCount)
+      : shared_data_(std::make_shared<SharedData>(
+            slot_count != 0
+                ? slot_count
+                : std::max<size_t>(2 * std::thread::hardware_concurrency(), 1),
+            std::move(prototype_executor))) {}
+
+  absl::StatusOr<Output> operator()(const ModelEvaluationOptions& options,
+                                    const Input& input,
+                                    SideOutput* side_output) const {
+    return Execute(options, input, side_output);
+  }
+
+  absl::StatusOr<Output> operator()(const ModelEvaluationOptions& options,
+                                    const Input& input) const {
+    return Execute(options, input);
+  }
+
+  absl::StatusOr<Output> operator()(const Input& input,
+                                    SideOutput* side_output) const {
+    return Execute({}, input, side_output);
+  }
+
+  absl::StatusOr<Output> operator()(const Input& input) const {
+    return Execute({}, input);
+  }
+
+  // Prepares the pool for the first requests after the model is loaded:
+  // clones up to `executor_count` executors (at most one per slot), evaluates
+  // each of them on all the `sample_inputs` (see EvaluateWarmupSamples) and
+  // puts them to the slots spread evenly over the pool, so the serving threads
+  // find them within kProbeCount probes.
+  absl::Status Warmup(absl::Span<const Input> sample_inputs,
+                      int64_t executor_count) const {
+    DCHECK(IsValid());
+    const size_t slot_count = shared_data_->slot_count;
+    const size_t count = static_cast<size_t>(
+        std::clamp<int64_t>(executor_count, 0, slot_count));
+    for (size_t i = 0; i < count; ++i) {
+      ASSIGN_OR_RETURN(auto new_executor,
+                       shared_data_->prototype_executor.Clone());
+      auto local_executor =
+          std::make_unique<WrappedModelExecutor>(std::move(new_executor));
+      RETURN_IF_ERROR(thread_safe_model_executor_impl::EvaluateWarmupSamples(
+          *local_executor, sample_inputs));
+      WrappedModelExecutor* expected = nullptr;
+      if (shared_data_->slots[i * slot_count / count].compare_exchange_strong(
+              expected, local_executor.get(), std::memory_order_release,
+              std::memory_order_relaxed)) {
+        local_executor.release();
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  bool IsValid() const {
+    return shared_data_ != nullptr &&
+           shared_data_->prototype_executor.IsValid();
+  }
+
+ private:
+  absl::StatusOr<Output> Execute(const ModelEvaluationOptions& options,
+                                 const Input& input,
+                                 SideOutput* side_output = nullptr) const {
+    DCHECK(IsValid());
+    const size_t slot_count = shared_data_->slot_count;
+    const size_t preferred_slot = PreferredSlot() % slot_count;
+    const size_t probe_count = std::min(kProbeCount, slot_count);
+
+    std::unique_ptr<WrappedModelExecutor> local_executor;
+    for (size_t i = 0; i < probe_count && local_executor == nullptr; ++i) {
+      local_executor.reset(
+          shared_data_->slots[(preferred_slot + i) % slot_count].exchange(
+              nullptr, std::memory_order_acquire));
     }
     if (local_executor == nullptr) {
       ASSIGN_OR_RETURN(auto new_executor,
@@ -156,32 +628,123 @@ class ThreadSafePoolModelExecutor {
           std::make_unique<WrappedModelExecutor>(std::move(new_executor));
     }
     auto result = local_executor->Execute(options, input, side_output);
-    if (shared_data_->maximum_cache_size != 0) {
-      absl::MutexLock l(&shared_data_->mutex);
-      if (shared_data_->executors_pool.size() <
-          shared_data_->maximum_cache_size) {
-        shared_data_->executors_pool.emplace_back(std::move(local_executor));
+    for (size_t i = 0; i < probe_count; ++i) {
+      WrappedModelExecutor* expected = nullptr;
+      if (shared_data_->slots[(preferred_slot + i) % slot_count]
+              .compare_exchange_strong(expected, local_executor.get(),
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+        local_executor.release();
+        break;
       }
     }
     return result;
   }
 
+  static size_t PreferredSlot() {
+    static thread_local const size_t slot =
+        std::hash<std::thread::id>()(std::this_thread::get_id());
+    return slot;
+  }
+
   struct SharedData {
-    SharedData(size_t maximum_cache_size,
-               WrappedModelExecutor prototype_executor)
-        : maximum_cache_size(maximum_cache_size),
-          prototype_executor(std::move(prototype_executor)) {}
+    SharedData(size_t slot_count, WrappedModelExecutor prototype_executor)
+        : slot_count(slot_count),
+          prototype_executor(std::move(prototype_executor)),
+          slots(std::make_unique<std::atomic<WrappedModelExecutor*>[]>(
+              slot_count)) {}
+
+    ~SharedData() {
+      for (size_t i = 0; i < slot_count; ++i) {
+        delete slots[i].load(std::memory_order_acquire);
+      }
+    }
 
-    size_t maximum_cache_size;
+    size_t slot_count;
     WrappedModelExecutor prototype_executor;
-    absl::Mutex mutex;
-    std::vector<std::unique_ptr<WrappedModelExecutor>> executors_pool
-        ABSL_GUARDED_BY(mutex);
+    std::unique_ptr<std::atomic<WrappedModelExecutor*>[]> slots;
   };
 
   std::shared_ptr<SharedData> shared_data_;
 };
 
+// A thread safe wrapper around ModelExecutor that keeps a replica of the model
+// per NUMA node, each with its own ThreadSafeLockFreePoolModelExecutor, and
+// routes every call to the replica of the node the calling thread runs on. The
+// executors are cloned by the calling threads, so their frames are allocated
+// in the local memory; the replicas may also hold node-local literals (see
+// ExprCompiler::SetNumaPoolThreadSafetyPolicy).
+//
+// DO NOT USE directly, prefer ExprCompiler instead.
+//
+template <typename Input, typename Output, typename SideOutput = void>
+class ThreadSafeNumaPoolModelExecutor {
+  using WrappedModelExecutor = ModelExecutor<Input, Output, SideOutput>;
+  using PoolModelExecutor =
+      ThreadSafeLockFreePoolModelExecutor<Input, Output, SideOutput>;
+
+ public:
+  // `replicas[i]` serves the threads running on the NUMA node i (modulo the
+  // number of replicas). `replicas` must not be empty.
+  explicit ThreadSafeNumaPoolModelExecutor(
+      std::vector<WrappedModelExecutor> replicas) {
+    DCHECK(!replicas.empty());
+    const size_t replica_count = std::max<size_t>(replicas.size(), 1);
+    // The same total number of slots as for a single lock-free pool.
+    const size_t slot_count = std::max<size_t>(
+        2 * std::thread::hardware_concurrency() / replica_count, 1);
+    auto pools = std::make_shared<std::vector<PoolModelExecutor>>();
+    pools->reserve(replicas.size());
+    for (auto& replica : replicas) {
+      pools->emplace_back(std::move(replica), slot_count);
+    }
+    pools_ = std::move(pools);
+  }
+
+  absl::StatusOr<Output> operator()(const ModelEvaluationOptions& options,
+                                    const Input& input,
+                                    SideOutput* side_output) const {
+    return LocalPool()(options, input, side_output);
+  }
+
+  absl::StatusOr<Output> operator()(const ModelEvaluationOptions& options,
+                                    const Input& input) const {
+    return LocalPool()(options, input);
+  }
+
+  absl::StatusOr<Output> operator()(const Input& input,
+                                    SideOutput* side_output) const {
+    return LocalPool()(input, side_output);
+  }
+
+  absl::StatusOr<Output> operator()(const Input& input) const {
+    return LocalPool()(input);
+  }
+
+  // Warms up the pool of the calling thread's NUMA node (see
+  // ThreadSafeLockFreePoolModelExecutor::Warmup), so the executors' frames are
+  // allocated in the node-local memory. Call it from a thread on every node
+  // that serves the model.
+  absl::Status Warmup(absl::Span<const Input> sample_inputs,
+                      int64_t executor_count) const {
+    return LocalPool().Warmup(sample_inputs, executor_count);
+  }
+
+  bool IsValid() const {
+    return pools_ != nullptr && !pools_->empty() &&
+           std::all_of(pools_->begin(), pools_->end(),
+                       [](const auto& pool) { return pool.IsValid(); });
+  }
+
+ private:
+  const PoolModelExecutor& LocalPool() const {
+    DCHECK(IsValid());
+    return (*pools_)[GetCurrentNumaNode() % pools_->size()];
+  }
+
+  std::shared_ptr<const std::vector<PoolModelExecutor>> pools_;
+};
+
 // A wrapper around ModelExecutor that is thread-unsafe, but copyable. The
 // original ModelExecutor is not copyable because it may be expensive, and can
 // also return an error. But in case we want to wrap ModelExecutor into a
@@ -232,6 +795,14 @@ class CopyableThreadUnsafeModelExecutor {
     return Execute({}, input);
   }
 
+  // Evaluates the executor on all the `sample_inputs`, see
+  // EvaluateWarmupSamples.
+  absl::Status Warmup(absl::Span<const Input> sample_inputs) const {
+    RETURN_IF_ERROR(model_executor_.status());
+    return thread_safe_model_executor_impl::EvaluateWarmupSamples(
+        *model_executor_, sample_inputs);
+  }
+
   bool IsValid() const {
     return model_executor_.ok() && model_executor_->IsValid();
   }
@@ -0,0 +1,84 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Measures contention of the thread safe model executors. Use
+//   --benchmark_filter=BM_.*/threads:64
+// to see the behaviour under heavy contention.
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/status/statusor.h"
+#include "arolla/expr/eval/model_executor.h"
+#include "arolla/expr/eval/thread_safe_model_executor.h"
+#include "arolla/expr/expr.h"
+#include "arolla/io/accessors_input_loader.h"
+#include "arolla/io/input_loader.h"
+#include "arolla/util/init_arolla.h"
+
+namespace arolla::expr {
+namespace {
+
+struct TestInput {
+  int64_t x;
+  int64_t y;
+};
+
+ModelExecutor<TestInput, int64_t> CreateTestExecutor() {
+  CHECK_OK(InitArolla());
+  auto input_loader = CreateAccessorsInputLoader<TestInput>(
+      "x", [](const TestInput& in) { return in.x; },  //
+      "y", [](const TestInput& in) { return in.y; });
+  CHECK_OK(input_loader.status());
+  auto expr = CallOp("math.add", {Leaf("x"), Leaf("y")});
+  CHECK_OK(expr.status());
+  auto executor = CompileModelExecutor<int64_t>(*expr, **input_loader);
+  CHECK_OK(executor.status());
+  return *std::move(executor);
+}
+
+template <typename ThreadSafeExecutor>
+void BM_ThreadSafeExecutor(benchmark::State& state) {
+  // The executor is shared between all the benchmark threads.
+  static ThreadSafeExecutor* executor = nullptr;
+  if (state.thread_index() == 0) {
+    executor = new ThreadSafeExecutor(CreateTestExecutor());
+  }
+  // The benchmark loop starts (and finishes) simultaneously in all threads.
+  for (auto _ : state) {
+    auto result = (*executor)(TestInput{.x = 1, .y = 2});
+    benchmark::DoNotOptimize(result);
+  }
+  if (state.thread_index() == 0) {
+    delete executor;
+  }
+}
+
+BENCHMARK(BM_ThreadSafeExecutor<
+              ThreadSafePoolModelExecutor<TestInput, int64_t>>)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK(BM_ThreadSafeExecutor<
+              ThreadSafeLockFreePoolModelExecutor<TestInput, int64_t>>)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK(BM_ThreadSafeExecutor<ThreadSafeModelExecutor<TestInput, int64_t>>)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace arolla::expr
@@ -17,13 +17,16 @@
 #include <cstdint>
 #include <functional>
 #include <future>  // NOLINT
+#include <memory>
 #include <numeric>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/status/statusor.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
@@ -41,6 +44,8 @@ constexpr int kNumIterations = 100;
 constexpr int kNumThreads = 10;
 
 using ::arolla::testing::IsOkAndHolds;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
 using ::testing::IsFalse;
 using ::testing::IsTrue;
 using ::testing::UnorderedElementsAreArray;
@@ -338,6 +343,260 @@ TEST_F(ThreadSafePoolModelExecutorTest, ExecuteManyOnDenseArraysWithArena) {
               UnorderedElementsAreArray(Iota(kNumThreads * kNumIterations)));
 }
 
+TEST_F(ThreadSafePoolModelExecutorTest, ExecuteAsync) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (CompileModelExecutor<int64_t>(ast, *input_loader)));
+  ThreadSafePoolModelExecutor<TestInput, int64_t> thread_safe_executor(
+      std::move(executor));
+
+  std::vector<absl::AnyInvocable<void() &&>> tasks;
+  AsyncScheduler scheduler = [&tasks](absl::AnyInvocable<void() &&> task) {
+    tasks.push_back(std::move(task));
+  };
+  std::vector<absl::StatusOr<int64_t>> results;
+  auto done = [&results](absl::StatusOr<int64_t> result) {
+    results.push_back(std::move(result));
+  };
+  thread_safe_executor.ExecuteAsync(scheduler, TestInput{57}, done);
+  ExecuteAsync(scheduler, thread_safe_executor, TestInput{42}, done);
+  // Nothing is evaluated until the scheduler runs the tasks.
+  EXPECT_THAT(results, IsEmpty());
+  ASSERT_EQ(tasks.size(), 2);
+  for (auto& task : tasks) {
+    std::move(task)();
+  }
+  EXPECT_THAT(results, ElementsAre(IsOkAndHolds(57), IsOkAndHolds(42)));
+}
+
+TEST_F(ThreadSafePoolModelExecutorTest, ExecuteAsyncMany) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (CompileModelExecutor<int64_t>(ast, *input_loader)));
+  ThreadSafePoolModelExecutor<TestInput, int64_t> thread_safe_executor(
+      std::move(executor));
+
+  std::vector<std::future<void>> futures;
+  AsyncScheduler scheduler = [&futures](absl::AnyInvocable<void() &&> task) {
+    futures.push_back(std::async(std::launch::async, std::move(task)));
+  };
+  std::vector<std::promise<absl::StatusOr<int64_t>>> promises(kNumThreads);
+  for (int i = 0; i < kNumThreads; ++i) {
+    thread_safe_executor.ExecuteAsync(
+        scheduler, TestInput{i},
+        [&promise = promises[i]](absl::StatusOr<int64_t> result) {
+          promise.set_value(std::move(result));
+        });
+  }
+  for (int i = 0; i < kNumThreads; ++i) {
+    EXPECT_THAT(promises[i].get_future().get(), IsOkAndHolds(i));
+  }
+}
+
+TEST_F(ThreadSafePoolModelExecutorTest, TrimIdleExecutors) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (CompileModelExecutor<int64_t>(ast, *input_loader)));
+  ThreadSafePoolModelExecutor<TestInput, int64_t> thread_safe_executor(
+      std::move(executor));
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(thread_safe_executor(TestInput{i}), IsOkAndHolds(i));
+  }
+  auto stats = thread_safe_executor.GetStats();
+  EXPECT_EQ(stats.idle_executors, 1);
+  EXPECT_EQ(stats.executors_in_use, 0);
+  EXPECT_EQ(stats.peak_executors_in_use, 1);
+  EXPECT_GT(stats.idle_memory_bytes, 0);
+
+  // The executor was used since the previous trim, so it is kept.
+  thread_safe_executor.TrimIdleExecutors();
+  stats = thread_safe_executor.GetStats();
+  EXPECT_EQ(stats.idle_executors, 1);
+  EXPECT_EQ(stats.peak_executors_in_use, 0);
+
+  thread_safe_executor.TrimIdleExecutors();
+  stats = thread_safe_executor.GetStats();
+  EXPECT_EQ(stats.idle_executors, 0);
+  EXPECT_EQ(stats.idle_memory_bytes, 0);
+
+  EXPECT_THAT(thread_safe_executor(TestInput{57}), IsOkAndHolds(57));
+  EXPECT_EQ(thread_safe_executor.GetStats().idle_executors, 1);
+}
+
+TEST_F(ThreadSafePoolModelExecutorTest, Warmup) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateDenseArrayTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      (CompileModelExecutor<DenseArray<int64_t>>(ast, *input_loader)));
+  ThreadSafePoolModelExecutor<TestInput, DenseArray<int64_t>>
+      thread_safe_executor(std::move(executor), /*maximum_cache_size=*/3);
+
+  std::vector<TestInput> samples = {TestInput{1}, TestInput{2}};
+  ASSERT_OK(thread_safe_executor.Warmup(samples, /*executor_count=*/5));
+  auto stats = thread_safe_executor.GetStats();
+  EXPECT_EQ(stats.idle_executors, 3);
+  EXPECT_EQ(stats.executors_in_use, 0);
+  EXPECT_EQ(stats.peak_executors_in_use, 3);
+
+  // The warmed up executors survive the first trim.
+  thread_safe_executor.TrimIdleExecutors();
+  EXPECT_EQ(thread_safe_executor.GetStats().idle_executors, 3);
+  EXPECT_THAT(thread_safe_executor(TestInput{57}),
+              IsOkAndHolds(ElementsAre(57, 57, 57)));
+  EXPECT_EQ(thread_safe_executor.GetStats().idle_executors, 3);
+}
+
+TEST_F(ThreadSafePoolModelExecutorTest, MemoryBudget) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (CompileModelExecutor<int64_t>(ast, *input_loader)));
+  const int64_t executor_memory = executor.GetMemoryUsage();
+  ASSERT_GT(executor_memory, 0);
+
+  auto budget = std::make_shared<ExecutorPoolMemoryBudget>(executor_memory);
+  ASSERT_OK_AND_ASSIGN(auto executor_clone, executor.Clone());
+  ThreadSafePoolModelExecutor<TestInput, int64_t> first_executor(
+      std::move(executor),
+      ThreadSafePoolModelExecutorOptions{.memory_budget = budget});
+  std::optional<ThreadSafePoolModelExecutor<TestInput, int64_t>>
+      second_executor(
+          std::in_place, std::move(executor_clone),
+          ThreadSafePoolModelExecutorOptions{.memory_budget = budget});
+
+  EXPECT_THAT((*second_executor)(TestInput{1}), IsOkAndHolds(1));
+  EXPECT_EQ(second_executor->GetStats().idle_executors, 1);
+  EXPECT_EQ(budget->used_bytes(), executor_memory);
+
+  // The budget is exhausted by the second model.
+  EXPECT_THAT(first_executor(TestInput{2}), IsOkAndHolds(2));
+  EXPECT_EQ(first_executor.GetStats().idle_executors, 0);
+  EXPECT_EQ(budget->used_bytes(), executor_memory);
+
+  // Destroying the pool returns its memory to the budget.
+  second_executor.reset();
+  EXPECT_EQ(budget->used_bytes(), 0);
+  EXPECT_THAT(first_executor(TestInput{3}), IsOkAndHolds(3));
+  EXPECT_EQ(first_executor.GetStats().idle_executors, 1);
+  EXPECT_EQ(budget->used_bytes(), executor_memory);
+
+  budget->TrimIdlePools();
+  budget->TrimIdlePools();
+  EXPECT_EQ(first_executor.GetStats().idle_executors, 0);
+  EXPECT_EQ(budget->used_bytes(), 0);
+}
+
+class ThreadSafeLockFreePoolModelExecutorTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_OK(InitArolla()); }
+};
+
+TEST_F(ThreadSafeLockFreePoolModelExecutorTest, Move) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (CompileModelExecutor<int64_t>(ast, *input_loader)));
+
+  ThreadSafeLockFreePoolModelExecutor<TestInput, int64_t> thread_safe_executor(
+      std::move(executor));
+  ASSERT_THAT(thread_safe_executor.IsValid(), IsTrue());
+  EXPECT_THAT(thread_safe_executor(TestInput{57}), IsOkAndHolds(57));
+  ThreadSafeLockFreePoolModelExecutor<TestInput, int64_t>
+      other_thread_safe_executor(std::move(thread_safe_executor));
+  ASSERT_THAT(other_thread_safe_executor.IsValid(), IsTrue());
+  EXPECT_THAT(other_thread_safe_executor(TestInput{57}), IsOkAndHolds(57));
+  // NOLINTNEXTLINE(bugprone-use-after-move)
+  EXPECT_THAT(thread_safe_executor.IsValid(), IsFalse());
+}
+
+TEST_F(ThreadSafeLockFreePoolModelExecutorTest, Copy) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (CompileModelExecutor<int64_t>(ast, *input_loader)));
+
+  ThreadSafeLockFreePoolModelExecutor<TestInput, int64_t> thread_safe_executor(
+      std::move(executor));
+  ThreadSafeLockFreePoolModelExecutor<TestInput, int64_t>
+      other_thread_safe_executor(thread_safe_executor);
+  ASSERT_THAT(other_thread_safe_executor.IsValid(), IsTrue());
+  EXPECT_THAT(other_thread_safe_executor(TestInput{57}), IsOkAndHolds(57));
+  EXPECT_THAT(thread_safe_executor.IsValid(), IsTrue());
+}
+
+TEST_F(ThreadSafeLockFreePoolModelExecutorTest, ExecuteMany) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateDenseArrayTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      (CompileModelExecutor<DenseArray<int64_t>>(ast, *input_loader)));
+
+  // Less slots than threads to exercise both the cloning fallback and the
+  // slot reuse.
+  ThreadSafeLockFreePoolModelExecutor<TestInput, DenseArray<int64_t>>
+      thread_safe_executor(std::move(executor), /*slot_count=*/3);
+  absl::flat_hash_set<int64_t> seen_results;
+  for (auto& result_or :
+       RunMany(thread_safe_executor, /*copy_for_each_thread=*/false)) {
+    ASSERT_OK_AND_ASSIGN(auto result, result_or);
+    seen_results.insert(result[0].value);
+  }
+  EXPECT_THAT(seen_results,
+              UnorderedElementsAreArray(Iota(kNumThreads * kNumIterations)));
+}
+
+class ThreadSafeNumaPoolModelExecutorTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_OK(InitArolla()); }
+};
+
+TEST_F(ThreadSafeNumaPoolModelExecutorTest, Copy) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (CompileModelExecutor<int64_t>(ast, *input_loader)));
+  ASSERT_OK_AND_ASSIGN(auto replica, executor.Clone());
+  std::vector<ModelExecutor<TestInput, int64_t>> replicas;
+  replicas.push_back(std::move(executor));
+  replicas.push_back(std::move(replica));
+
+  ThreadSafeNumaPoolModelExecutor<TestInput, int64_t> thread_safe_executor(
+      std::move(replicas));
+  ASSERT_THAT(thread_safe_executor.IsValid(), IsTrue());
+  EXPECT_THAT(thread_safe_executor(TestInput{57}), IsOkAndHolds(57));
+  ThreadSafeNumaPoolModelExecutor<TestInput, int64_t>
+      other_thread_safe_executor(thread_safe_executor);
+  ASSERT_THAT(other_thread_safe_executor.IsValid(), IsTrue());
+  EXPECT_THAT(other_thread_safe_executor(TestInput{57}), IsOkAndHolds(57));
+  EXPECT_THAT(thread_safe_executor.IsValid(), IsTrue());
+}
+
+TEST_F(ThreadSafeNumaPoolModelExecutorTest, ExecuteMany) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateDenseArrayTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      (CompileModelExecutor<DenseArray<int64_t>>(ast, *input_loader)));
+  std::vector<ModelExecutor<TestInput, DenseArray<int64_t>>> replicas;
+  replicas.push_back(std::move(executor));
+
+  ThreadSafeNumaPoolModelExecutor<TestInput, DenseArray<int64_t>>
+      thread_safe_executor(std::move(replicas));
+  absl::flat_hash_set<int64_t> seen_results;
+  for (auto& result_or :
+       RunMany(thread_safe_executor, /*copy_for_each_thread=*/false)) {
+    ASSERT_OK_AND_ASSIGN(auto result, result_or);
+    seen_results.insert(result[0].value);
+  }
+  EXPECT_THAT(seen_results,
+              UnorderedElementsAreArray(Iota(kNumThreads * kNumIterations)));
+}
+
 class CopyableThreadUnsafeModelExecutorTest : public ::testing::Test {
  protected:
   void SetUp() override { ASSERT_OK(InitArolla()); }
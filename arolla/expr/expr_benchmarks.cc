@@ -13,16 +13,24 @@
 // limitations under the License.
 //
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "benchmark/benchmark.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/strings/str_format.h"
+#include "arolla/expr/eval/eval.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_operator_signature.h"
+#include "arolla/expr/lambda_expr_operator.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
 #include "arolla/util/init_arolla.h"
+#include "arolla/util/threading.h"
 
 namespace arolla::expr {
 namespace {
@@ -50,5 +58,91 @@ void BM_AddN_Create(benchmark::State& state) {
 
 BENCHMARK(BM_AddN_Create)->Range(1, 10000);
 
+// Same as BM_AddN_Create, but the leaves have known qtypes, so qtype inference
+// runs for every created node.
+void BM_AddN_CreateWithQTypes(benchmark::State& state) {
+  CHECK_OK(InitArolla());
+  int64_t summand_count = state.range(0);
+  DCHECK_GE(summand_count, 1);
+
+  std::vector<ExprNodePtr> leaves;
+  leaves.reserve(summand_count);
+  for (int64_t i = 0; i < summand_count; ++i) {
+    leaves.push_back(*CallOp(
+        "annotation.qtype",
+        {Leaf(absl::StrFormat("v%d", i)), Literal(GetQType<float>())}));
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(leaves);
+    ExprNodePtr expr = leaves[0];
+    for (int64_t i = 1; i < summand_count; ++i) {
+      expr = *CallOp("math.add", {std::move(expr), leaves[i]});
+    }
+    benchmark::DoNotOptimize(expr);
+  }
+  state.SetItemsProcessed(state.iterations() * (summand_count - 1));
+}
+
+BENCHMARK(BM_AddN_CreateWithQTypes)->Range(1, 10000);
+
+// Compiles a balanced sum of `summand_count` subexpressions that need
+// lowering, literal folding and qtype population, using `thread_count` threads
+// for the expression preparation (0 means no ThreadingInterface).
+void BM_Compile_BalancedExpr(benchmark::State& state) {
+  CHECK_OK(InitArolla());
+  int64_t summand_count = state.range(0);
+  int64_t thread_count = state.range(1);
+
+  auto add_1_lambda = *MakeLambdaOperator(
+      ExprOperatorSignature{{"x"}},
+      CallOp("math.add", {Placeholder("x"), Literal(1)}));
+  absl::flat_hash_map<std::string, QTypePtr> input_types;
+  std::vector<ExprNodePtr> summands;
+  summands.reserve(summand_count);
+  for (int64_t i = 0; i < summand_count; ++i) {
+    std::string leaf_name = absl::StrFormat("v%d", i % 100);
+    input_types[leaf_name] = GetQType<float>();
+    summands.push_back(*CallOp(
+        "math.multiply",
+        {CallOp(add_1_lambda, {Leaf(leaf_name)}),
+         CallOp("math.add", {Literal<float>(i % 7), Literal<float>(1)})}));
+  }
+  while (summands.size() > 1) {
+    std::vector<ExprNodePtr> next_summands;
+    for (size_t i = 0; i + 1 < summands.size(); i += 2) {
+      next_summands.push_back(
+          *CallOp("math.add", {summands[i], summands[i + 1]}));
+    }
+    if (summands.size() % 2 == 1) {
+      next_summands.push_back(summands.back());
+    }
+    summands = std::move(next_summands);
+  }
+  ExprNodePtr expr = summands[0];
+
+  std::unique_ptr<WorkStealingThreading> threading;
+  DynamicEvaluationEngineOptions options;
+  if (thread_count > 0) {
+    threading = std::make_unique<WorkStealingThreading>(thread_count);
+    options.threading = threading.get();
+  }
+  for (auto _ : state) {
+    auto compiled_expr =
+        CompileForDynamicEvaluation(options, expr, input_types);
+    CHECK_OK(compiled_expr.status());
+    benchmark::DoNotOptimize(compiled_expr);
+  }
+  state.SetItemsProcessed(state.iterations() * summand_count);
+}
+
+BENCHMARK(BM_Compile_BalancedExpr)
+    ->ArgPair(1000, 0)
+    ->ArgPair(1000, 4)
+    ->ArgPair(10000, 0)
+    ->ArgPair(10000, 4)
+    ->ArgPair(40000, 0)
+    ->ArgPair(40000, 4);
+
 }  // namespace
 }  // namespace arolla::expr
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/optimization.h"
 #include "absl/cleanup/cleanup.h"
 #include "absl/log/check.h"
 #include "absl/strings/string_view.h"
@@ -50,31 +51,77 @@ std::ostream& operator<<(std::ostream& os, ExprNodeType t) {
   return os << "ExprNodeType(" << static_cast<int>(t) << ")";
 }
 
+namespace {
+
+thread_local ExprNodeDeduplicationScope* /*nullable*/
+    current_deduplication_scope = nullptr;
+
+}  // namespace
+
+ExprNodeDeduplicationScope::ExprNodeDeduplicationScope()
+    : outer_scope_(current_deduplication_scope) {
+  current_deduplication_scope = this;
+}
+
+ExprNodeDeduplicationScope::~ExprNodeDeduplicationScope() {
+  DCHECK_EQ(current_deduplication_scope, this);
+  current_deduplication_scope = outer_scope_;
+}
+
+const ExprNodePtr* /*nullable*/ ExprNode::LookupDeduplicated(
+    const Fingerprint& fingerprint) {
+  if (ABSL_PREDICT_TRUE(current_deduplication_scope == nullptr)) {
+    return nullptr;
+  }
+  const auto& nodes = current_deduplication_scope->nodes_;
+  auto it = nodes.find(fingerprint);
+  return it != nodes.end() ? &it->second : nullptr;
+}
+
+ExprNodePtr ExprNode::Deduplicate(ExprNodePtr&& node) {
+  if (ABSL_PREDICT_FALSE(current_deduplication_scope != nullptr)) {
+    current_deduplication_scope->nodes_.emplace(node->fingerprint(), node);
+  }
+  return std::move(node);
+}
+
 ExprNodePtr ExprNode::MakeLiteralNode(TypedValue&& qvalue) {
   FingerprintHasher hasher("LiteralNode");
   hasher.Combine(qvalue.GetFingerprint());
+  auto fingerprint = std::move(hasher).Finish();
+  if (const auto* node = LookupDeduplicated(fingerprint)) {
+    return *node;
+  }
   auto self = std::make_unique<ExprNode>(PrivateConstructorTag());
   self->type_ = ExprNodeType::kLiteral;
   self->attr_ = ExprAttributes(std::move(qvalue));
-  self->fingerprint_ = std::move(hasher).Finish();
-  return ExprNodePtr::Own(std::move(self));
+  self->fingerprint_ = fingerprint;
+  return Deduplicate(ExprNodePtr::Own(std::move(self)));
 }
 
 ExprNodePtr ExprNode::MakeLeafNode(absl::string_view leaf_key) {
+  auto fingerprint = FingerprintHasher("LeafNode").Combine(leaf_key).Finish();
+  if (const auto* node = LookupDeduplicated(fingerprint)) {
+    return *node;
+  }
   auto self = std::make_unique<ExprNode>(PrivateConstructorTag());
   self->type_ = ExprNodeType::kLeaf;
   self->leaf_key_ = std::string(leaf_key);
-  self->fingerprint_ = FingerprintHasher("LeafNode").Combine(leaf_key).Finish();
-  return ExprNodePtr::Own(std::move(self));
+  self->fingerprint_ = fingerprint;
+  return Deduplicate(ExprNodePtr::Own(std::move(self)));
 }
 
 ExprNodePtr ExprNode::MakePlaceholderNode(absl::string_view placeholder_key) {
+  auto fingerprint =
+      FingerprintHasher("PlaceholderNode").Combine(placeholder_key).Finish();
+  if (const auto* node = LookupDeduplicated(fingerprint)) {
+    return *node;
+  }
   auto self = std::make_unique<ExprNode>(PrivateConstructorTag());
   self->type_ = ExprNodeType::kPlaceholder;
   self->placeholder_key_ = std::string(placeholder_key);
-  self->fingerprint_ =
-      FingerprintHasher("PlaceholderNode").Combine(placeholder_key).Finish();
-  return ExprNodePtr::Own(std::move(self));
+  self->fingerprint_ = fingerprint;
+  return Deduplicate(ExprNodePtr::Own(std::move(self)));
 }
 
 ExprNodePtr ExprNode::UnsafeMakeOperatorNode(
@@ -88,13 +135,17 @@ ExprNodePtr ExprNode::UnsafeMakeOperatorNode(
     hasher.Combine(node_dep->fingerprint());
   }
   hasher.Combine(attr);
+  auto fingerprint = std::move(hasher).Finish();
+  if (const auto* node = LookupDeduplicated(fingerprint)) {
+    return *node;
+  }
   auto self = std::make_unique<ExprNode>(PrivateConstructorTag());
   self->type_ = ExprNodeType::kOperator;
   self->op_ = std::move(op);
   self->node_deps_ = std::move(node_deps);
   self->attr_ = std::move(attr);
-  self->fingerprint_ = std::move(hasher).Finish();
-  return ExprNodePtr::Own(std::move(self));
+  self->fingerprint_ = fingerprint;
+  return Deduplicate(ExprNodePtr::Own(std::move(self)));
 }
 
 // Implement non-recursive destruction to avoid potential stack overflow on
@@ -15,12 +15,14 @@
 #ifndef AROLLA_EXPR_EXPR_NODE_H_
 #define AROLLA_EXPR_EXPR_NODE_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <iosfwd>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "arolla/expr/expr_attributes.h"
 #include "arolla/expr/expr_node_ptr.h"
@@ -89,6 +91,14 @@ class ExprNode : public RefcountedBase {
   const Fingerprint& fingerprint() const { return fingerprint_; }
 
  private:
+  // Returns the node with the given fingerprint from the current
+  // ExprNodeDeduplicationScope, or nullptr.
+  static const ExprNodePtr* /*nullable*/ LookupDeduplicated(
+      const Fingerprint& fingerprint);
+
+  // Stores the node in the current ExprNodeDeduplicationScope, if any.
+  static ExprNodePtr Deduplicate(ExprNodePtr&& node);
+
   ExprNodeType type_;
   std::string leaf_key_;
   std::string placeholder_key_;
@@ -98,6 +108,41 @@ class ExprNode : public RefcountedBase {
   Fingerprint fingerprint_;
 };
 
+// Deduplicates expression nodes created in the current thread.
+//
+// While the scope is alive, the ExprNode factories return a previously
+// created node with the same fingerprint, if any, instead of allocating a new
+// one. It reduces the memory footprint of expressions with many structurally
+// identical subtrees that are built independently.
+//
+// The scope keeps all the nodes created within it alive until it is
+// destroyed. Scopes can be nested; the innermost one is used.
+//
+// Usage:
+//
+//   ExprNodeDeduplicationScope dedup_scope;
+//   ASSIGN_OR_RETURN(auto expr, BuildMyLargeExpr());
+//
+class ExprNodeDeduplicationScope {
+ public:
+  ExprNodeDeduplicationScope();
+  ~ExprNodeDeduplicationScope();
+
+  // Non-copyable, non-movable.
+  ExprNodeDeduplicationScope(const ExprNodeDeduplicationScope&) = delete;
+  ExprNodeDeduplicationScope& operator=(const ExprNodeDeduplicationScope&) =
+      delete;
+
+  // Returns the number of unique nodes created within the scope.
+  size_t size() const { return nodes_.size(); }
+
+ private:
+  friend class ExprNode;
+
+  ExprNodeDeduplicationScope* /*nullable*/ const outer_scope_;
+  absl::flat_hash_map<Fingerprint, ExprNodePtr> nodes_;
+};
+
 }  // namespace arolla::expr
 
 #endif  // AROLLA_EXPR_EXPR_NODE_H_
@@ -22,6 +22,8 @@
 #include "arolla/expr/expr_operator.h"
 #include "arolla/expr/expr_operator_signature.h"
 #include "arolla/expr/testing/test_operators.h"
+#include "arolla/qtype/base_types.h"
+#include "arolla/qtype/typed_value.h"
 #include "arolla/util/init_arolla.h"
 
 namespace arolla::expr {
@@ -71,5 +73,33 @@ TEST_F(ExprNodeTest, DeepTreeNoStackOverflow) {
   }
 }
 
+TEST_F(ExprNodeTest, DeduplicationScope) {
+  ExprOperatorPtr op = std::make_shared<DummyOp>(
+      "op.name", ExprOperatorSignature::MakeVariadicArgs());
+  auto make_expr = [&] {
+    return ExprNode::UnsafeMakeOperatorNode(
+        ExprOperatorPtr(op),
+        {ExprNode::MakeLeafNode("a"), ExprNode::MakePlaceholderNode("b"),
+         ExprNode::MakeLiteralNode(TypedValue::FromValue(1))},
+        {});
+  };
+  EXPECT_NE(make_expr(), make_expr());
+  {
+    ExprNodeDeduplicationScope scope;
+    auto expr = make_expr();
+    EXPECT_EQ(scope.size(), 4);
+    EXPECT_EQ(make_expr(), expr);
+    EXPECT_EQ(scope.size(), 4);
+    {
+      ExprNodeDeduplicationScope inner_scope;
+      EXPECT_NE(make_expr(), expr);
+      EXPECT_EQ(inner_scope.size(), 4);
+    }
+    EXPECT_EQ(make_expr(), expr);
+    EXPECT_EQ(scope.size(), 4);
+  }
+  EXPECT_NE(make_expr(), make_expr());
+}
+
 }  // namespace
 }  // namespace arolla::expr
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
@@ -171,17 +172,18 @@ void LightweightExprStackTrace::AddTrace(ExprNodePtr target_node,
 
 void LightweightExprStackTrace::AddRepresentations(ExprNodePtr compiled_node,
                                                    ExprNodePtr original_node) {
-  auto compiled_post_order = PostOrder(compiled_node);
-  for (const auto& node : compiled_post_order.nodes()) {
-    repr_.insert({node->fingerprint(), node});
-  }
-  auto original_post_order = PostOrder(original_node);
-  for (const auto& node : original_post_order.nodes()) {
-    repr_.insert({node->fingerprint(), node});
-  }
+  represented_roots_.push_back(std::move(compiled_node));
+  represented_roots_.push_back(std::move(original_node));
 }
 
 std::string LightweightExprStackTrace::GetRepr(Fingerprint fp) const {
+  absl::call_once(repr_once_, [this] {
+    for (const auto& root : represented_roots_) {
+      for (const auto& node : PostOrder(root).nodes()) {
+        repr_.insert({node->fingerprint(), node});
+      }
+    }
+  });
   if (auto it = repr_.find(fp); it != repr_.end()) {
     return GetDebugSnippet(it->second);
   } else {
@@ -208,6 +210,19 @@ void BoundExprStackTraceBuilder::RegisterIp(int64_t ip,
   ip_to_fingerprint_.insert({ip, node->fingerprint()});
 }
 
+std::optional<std::string> BoundExprStackTrace::FullTrace(int64_t ip) const {
+  if (auto it = ip_to_fingerprint_.find(ip); it != ip_to_fingerprint_.end()) {
+    return stack_trace_->FullTrace(it->second);
+  }
+  return std::nullopt;
+}
+
+std::shared_ptr<const BoundExprStackTrace>
+BoundExprStackTraceBuilder::BuildLazy() && {
+  return std::make_shared<BoundExprStackTrace>(std::move(stack_trace_),
+                                               std::move(ip_to_fingerprint_));
+}
+
 DenseArray<Text> BoundExprStackTraceBuilder::Build(
     int64_t num_operators) const {
   DenseArrayBuilder<Text> traces_array_builder(num_operators);
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/container/flat_hash_map.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/expr/expr_node.h"
@@ -135,7 +136,8 @@ class LightweightExprStackTrace : public ExprStackTrace {
 
   // Adds representations of all required nodes given compiled expr and original
   // expr. Note: AddTrace does not add representations so calling this function
-  // at the end of compilation is necessary.
+  // at the end of compilation is necessary. The nodes are indexed lazily on the
+  // first FullTrace call, so the function must not be called after it.
   void AddRepresentations(ExprNodePtr compiled_node, ExprNodePtr original_node);
 
  private:
@@ -144,7 +146,29 @@ class LightweightExprStackTrace : public ExprStackTrace {
   std::string GetRepr(Fingerprint fp) const;
 
   absl::flat_hash_map<Fingerprint, Fingerprint> original_node_mapping_;
-  absl::flat_hash_map<Fingerprint, ExprNodePtr> repr_;
+  std::vector<ExprNodePtr> represented_roots_;
+  mutable absl::once_flag repr_once_;
+  mutable absl::flat_hash_map<Fingerprint, ExprNodePtr> repr_;
+};
+
+// Stack traces of the operators of a bound expression. The traces are formatted
+// on demand, so until an error actually happens the bound expression pays only
+// for the instruction pointer to fingerprint mapping.
+class BoundExprStackTrace {
+ public:
+  BoundExprStackTrace(
+      std::shared_ptr<const ExprStackTrace> stack_trace,
+      absl::flat_hash_map<int64_t, Fingerprint> ip_to_fingerprint)
+      : stack_trace_(std::move(stack_trace)),
+        ip_to_fingerprint_(std::move(ip_to_fingerprint)) {}
+
+  // Returns the stack trace for the operator with the given instruction
+  // pointer, or nullopt if it was not registered.
+  std::optional<std::string> FullTrace(int64_t ip) const;
+
+ private:
+  std::shared_ptr<const ExprStackTrace> stack_trace_;
+  absl::flat_hash_map<int64_t, Fingerprint> ip_to_fingerprint_;
 };
 
 // Bound Stack Trace takes an Expr Stack Traces and matches instruction pointers
@@ -162,6 +186,10 @@ class BoundExprStackTraceBuilder {
 
   DenseArray<Text> Build(int64_t num_operators) const;
 
+  // Same as Build, but the traces are formatted only when requested. Keeps
+  // the underlying ExprStackTrace alive.
+  std::shared_ptr<const BoundExprStackTrace> BuildLazy() &&;
+
  private:
   std::shared_ptr<const ExprStackTrace> stack_trace_;
   absl::flat_hash_map<int64_t, Fingerprint> ip_to_fingerprint_;
@@ -32,6 +32,7 @@
 #include "arolla/expr/expr_debug_string.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/util/fingerprint.h"
+#include "arolla/util/refcount_ptr.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr {
@@ -134,6 +135,20 @@ absl::StatusOr<ExprNodePtr> DeepTransform(
     absl::FunctionRef<absl::StatusOr<ExprNodePtr>(ExprNodePtr)> transform_fn,
     std::optional<LogTransformationFn> log_transformation_fn,
     size_t processed_node_limit) {
+  return DeepTransformWithKnownResults(root, transform_fn,
+                                       /*known_results=*/{},
+                                       /*new_results=*/nullptr,
+                                       log_transformation_fn,
+                                       processed_node_limit);
+}
+
+absl::StatusOr<ExprNodePtr> DeepTransformWithKnownResults(
+    const ExprNodePtr& root,
+    absl::FunctionRef<absl::StatusOr<ExprNodePtr>(ExprNodePtr)> transform_fn,
+    const absl::flat_hash_map<Fingerprint, ExprNodePtr>& known_results,
+    absl::flat_hash_map<Fingerprint, ExprNodePtr>* new_results,
+    std::optional<LogTransformationFn> log_transformation_fn,
+    size_t processed_node_limit) {
   // This function implements a non-recursive version of the following
   // algorithm:
   //
@@ -185,17 +200,39 @@ absl::StatusOr<ExprNodePtr> DeepTransform(
         GetDebugSnippet(node)));
   };
 
+  // The frames only borrow the nodes, to avoid the refcount traffic: a node is
+  // owned either by the caller (root), by its parent node (dependencies), or
+  // by the `transformed_new_node` field of the frame below it.
   struct Frame {
-    ExprNodePtr node;
+    BorrowedRefcountPtr<const ExprNode> node;
     size_t dep_idx = 0;
     Fingerprint new_node_fingerprint;
-    Fingerprint transformed_new_node_fingerprint;
+    ExprNodePtr transformed_new_node = nullptr;
     // The closest transformed node on the current node's ancestor path.
-    std::optional<ExprNodePtr> original_node = std::nullopt;
+    std::optional<BorrowedRefcountPtr<const ExprNode>> original_node =
+        std::nullopt;
   };
   absl::flat_hash_map<Fingerprint, ExprNodePtr> cache;
+  // Inserts a nullptr placeholder into the cache, unless the node is already
+  // there or in known_results. Returns the cache iterator and whether the
+  // placeholder was inserted.
+  auto cache_emplace = [&](const Fingerprint& fingerprint) {
+    auto result = cache.emplace(fingerprint, nullptr);
+    if (result.second) {
+      if (auto it = known_results.find(fingerprint);
+          it != known_results.end()) {
+        result.first->second = it->second;
+        result.second = false;
+      }
+    }
+    return result;
+  };
+  if (auto it = known_results.find(root->fingerprint());
+      it != known_results.end()) {
+    return it->second;
+  }
   std::stack<Frame> stack;
-  cache.emplace(root->fingerprint(), nullptr);
+  cache_emplace(root->fingerprint());
   stack.emplace(Frame{.node = root});
   while (!stack.empty()) {
     auto& frame = stack.top();
@@ -210,7 +247,7 @@ absl::StatusOr<ExprNodePtr> DeepTransform(
       const auto& deps = frame.node->node_deps();
       while (
           frame.dep_idx < deps.size() &&
-          !cache.emplace(deps[frame.dep_idx]->fingerprint(), nullptr).second) {
+          !cache_emplace(deps[frame.dep_idx]->fingerprint()).second) {
         ++frame.dep_idx;
       }
       if (frame.dep_idx < deps.size()) {
@@ -239,7 +276,7 @@ absl::StatusOr<ExprNodePtr> DeepTransform(
                                  DeepTransformStage::kWithNewDeps);
       }
       if (new_node->fingerprint() != frame.node->fingerprint()) {
-        if (auto [it, miss] = cache.emplace(new_node->fingerprint(), nullptr);
+        if (auto [it, miss] = cache_emplace(new_node->fingerprint());
             !miss) {
           // Return statement (1).
           if (it->second == nullptr) {
@@ -263,8 +300,7 @@ absl::StatusOr<ExprNodePtr> DeepTransform(
         stack.pop();
         continue;
       }
-      if (auto [it, miss] =
-              cache.emplace(transformed_new_node->fingerprint(), nullptr);
+      if (auto [it, miss] = cache_emplace(transformed_new_node->fingerprint());
           !miss) {
         // The early case of return statement (3), when transformed_new_node is
         // already in the cache, and no recursive call (B) needed.
@@ -280,16 +316,16 @@ absl::StatusOr<ExprNodePtr> DeepTransform(
       }
       frame.dep_idx = kSkipFirstStage;
       frame.new_node_fingerprint = new_node->fingerprint();
-      frame.transformed_new_node_fingerprint =
-          transformed_new_node->fingerprint();
+      frame.transformed_new_node = std::move(transformed_new_node);
       // Recursive call (B).
-      stack.emplace(Frame{.node = transformed_new_node,
-                          .original_node = transformed_new_node});
+      stack.emplace(Frame{.node = frame.transformed_new_node,
+                          .original_node = frame.transformed_new_node});
       continue;
     }
     // Second stage.
     // Return case (3), after the recursive call (B).
-    const auto& node_result = cache.at(frame.transformed_new_node_fingerprint);
+    const auto& node_result =
+        cache.at(frame.transformed_new_node->fingerprint());
     DCHECK_NE(node_result, nullptr);
     cache[frame.node->fingerprint()] = node_result;
     if (frame.new_node_fingerprint != frame.node->fingerprint()) {
@@ -297,9 +333,16 @@ absl::StatusOr<ExprNodePtr> DeepTransform(
     }
     stack.pop();
   }
-  auto& root_result = cache.at(root->fingerprint());
+  ExprNodePtr root_result = cache.at(root->fingerprint());
   DCHECK_NE(root_result, nullptr);
-  return std::move(root_result);
+  if (new_results != nullptr) {
+    if (new_results->empty()) {
+      *new_results = std::move(cache);
+    } else {
+      new_results->insert(cache.begin(), cache.end());
+    }
+  }
+  return root_result;
 }
 
 }  // namespace arolla::expr
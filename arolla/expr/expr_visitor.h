@@ -23,6 +23,7 @@
 
 #include "absl/algorithm/container.h"
 #include "absl/base/attributes.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/status/statusor.h"
@@ -30,6 +31,7 @@
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_debug_string.h"
 #include "arolla/expr/expr_node.h"
+#include "arolla/util/fingerprint.h"
 #include "arolla/util/meta.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -298,6 +300,22 @@ absl::StatusOr<ExprNodePtr> DeepTransform(
     std::optional<LogTransformationFn> log_transformation_fn = std::nullopt,
     size_t processed_node_limit = 10'000'000);
 
+// Same as DeepTransform, but allows transforming an expression incrementally,
+// e.g. to transform its independent subexpressions separately first.
+//
+// The nodes having fingerprints in `known_results` are considered as already
+// transformed to the corresponding values, which must be fixed points of
+// `transform_fn`. The results for all the nodes processed by the call are
+// added to `new_results` (if not nullptr), so it can be used as
+// `known_results` for the subsequent calls.
+absl::StatusOr<ExprNodePtr> DeepTransformWithKnownResults(
+    const ExprNodePtr& root,
+    absl::FunctionRef<absl::StatusOr<ExprNodePtr>(ExprNodePtr)> transform_fn,
+    const absl::flat_hash_map<Fingerprint, ExprNodePtr>& known_results,
+    absl::flat_hash_map<Fingerprint, ExprNodePtr>* new_results,
+    std::optional<LogTransformationFn> log_transformation_fn = std::nullopt,
+    size_t processed_node_limit = 10'000'000);
+
 template <typename VisitorResultType>
 struct ExprVisitorResultTraits {
   using ResultType = VisitorResultType;
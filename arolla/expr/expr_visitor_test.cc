@@ -24,6 +24,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -313,6 +314,26 @@ TEST_F(DeepTransformTest, CacheHitCoverage) {
   }
 }
 
+TEST_F(DeepTransformTest, KnownResults) {
+  auto sub_expr = A(S());
+  auto expr = B(A(A()), sub_expr);
+  auto expected = B(B(B()), B(B()));
+  // The same transform_fn fails on duplicate calls, so the second
+  // DeepTransformWithKnownResults must not process sub_expr again.
+  auto transform_fn = SabTransform();
+  absl::flat_hash_map<Fingerprint, ExprNodePtr> results;
+  ASSERT_THAT(DeepTransformWithKnownResults(sub_expr, transform_fn,
+                                            /*known_results=*/{}, &results),
+              IsOkAndHolds(EqualsExpr(B(B()))));
+  EXPECT_THAT(results[sub_expr->fingerprint()], EqualsExpr(B(B())));
+  ASSERT_THAT(DeepTransformWithKnownResults(expr, transform_fn, results,
+                                            /*new_results=*/nullptr),
+              IsOkAndHolds(EqualsExpr(expected)));
+  ASSERT_THAT(DeepTransformWithKnownResults(sub_expr, transform_fn, results,
+                                            /*new_results=*/nullptr),
+              IsOkAndHolds(EqualsExpr(B(B()))));
+}
+
 TEST_F(DeepTransformTest, TooManyProcessedNodes) {
   ASSERT_THAT(DeepTransform(
                   Literal<int>(0),
@@ -14,14 +14,18 @@
 //
 #include "arolla/expr/operator_loader/generic_operator_overload_condition.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "arolla/expr/eval/model_executor.h"
 #include "arolla/expr/expr.h"
@@ -33,6 +37,7 @@
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/tuple_qtype.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/util/lru_cache.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::operator_loader {
@@ -68,8 +73,24 @@ MakeGenericOperatorOverloadConditionFn(
         "unexpected return qtype: expected %s, got %s",
         expected_output_qtype->name(), actual_output.GetType()->name()));
   }
-  return [model_executor = std::move(model_executor)](
+  // The conditions depend only on the input qtypes, so we memoize the
+  // results, because operators evaluate them on every attribute inference.
+  static constexpr size_t kCacheCapacity = 64;
+  struct ResultCache {
+    absl::Mutex mutex;
+    LruCache<QTypePtr, std::vector<bool>> cache ABSL_GUARDED_BY(mutex){
+        kCacheCapacity};
+  };
+  return [model_executor = std::move(model_executor),
+          result_cache = std::make_shared<ResultCache>()](
              QTypePtr input_tuple_qtype) -> absl::StatusOr<std::vector<bool>> {
+    {
+      absl::MutexLock lock(&result_cache->mutex);
+      if (const auto* result =
+              result_cache->cache.LookupOrNull(input_tuple_qtype)) {
+        return *result;
+      }
+    }
     ASSIGN_OR_RETURN(auto qvalue,
                      model_executor.ExecuteOnHeap(ModelEvaluationOptions{},
                                                   input_tuple_qtype));
@@ -78,7 +99,8 @@ MakeGenericOperatorOverloadConditionFn(
     for (int64_t i = 0; i < n; ++i) {
       result[i] = qvalue.GetField(i).UnsafeAs<OptionalUnit>().present;
     }
-    return result;
+    absl::MutexLock lock(&result_cache->mutex);
+    return *result_cache->cache.Put(input_tuple_qtype, std::move(result));
   };
 }
 
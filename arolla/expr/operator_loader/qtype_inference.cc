@@ -14,14 +14,20 @@
 //
 #include "arolla/expr/operator_loader/qtype_inference.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_debug_string.h"
@@ -32,6 +38,7 @@
 #include "arolla/expr/qtype_utils.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
+#include "arolla/util/lru_cache.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::operator_loader {
@@ -67,6 +74,36 @@ absl::StatusOr<ExprNodePtr> NormalizeQTypeInferenceExpr(ExprNodePtr expr) {
       GetQTypeQType()->name(), output_qtype->name(), ToDebugString(expr)));
 }
 
+// A cache of the successfully inferred qtypes, keyed by the parameter qtypes
+// sorted by name.
+class QTypeInferenceCache {
+ public:
+  using Key = std::vector<std::pair<std::string, QTypePtr>>;
+
+  static Key MakeKey(const ParameterQTypes& parameter_qtypes) {
+    Key result(parameter_qtypes.begin(), parameter_qtypes.end());
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  QTypePtr /*nullable*/ Lookup(const Key& key) {
+    absl::MutexLock lock(&mutex_);
+    const auto* result = cache_.LookupOrNull(key);
+    return result != nullptr ? *result : nullptr;
+  }
+
+  void Put(Key&& key, QTypePtr qtype) {
+    absl::MutexLock lock(&mutex_);
+    (void)cache_.Put(std::move(key), qtype);
+  }
+
+ private:
+  static constexpr size_t kCapacity = 64;
+
+  absl::Mutex mutex_;
+  LruCache<Key, QTypePtr> cache_ ABSL_GUARDED_BY(mutex_){kCapacity};
+};
+
 }  // namespace
 
 absl::StatusOr<QTypeInferenceFn> MakeQTypeInferenceFn(
@@ -81,8 +118,15 @@ absl::StatusOr<QTypeInferenceFn> MakeQTypeInferenceFn(
   return
       [qtype_constraint_fn = std::move(qtype_constraint_fn),
        executor = std::move(executor),
-       qtype_inference_expr = std::move(qtype_inference_expr)](
+       qtype_inference_expr = std::move(qtype_inference_expr),
+       cache = std::make_shared<QTypeInferenceCache>()](
           const ParameterQTypes& parameter_qtypes) -> absl::StatusOr<QTypePtr> {
+        // The result depends only on the parameter qtypes, so we memoize it,
+        // because operators infer it on every attribute inference.
+        auto key = QTypeInferenceCache::MakeKey(parameter_qtypes);
+        if (auto* qtype = cache->Lookup(key)) {
+          return qtype;
+        }
         RETURN_IF_ERROR(qtype_constraint_fn(parameter_qtypes));
         ASSIGN_OR_RETURN(auto qtype_typed_value, executor(parameter_qtypes));
         DCHECK_EQ(
@@ -95,6 +139,7 @@ absl::StatusOr<QTypeInferenceFn> MakeQTypeInferenceFn(
               ToDebugString(qtype_inference_expr),
               FormatParameterQTypes(parameter_qtypes)));
         }
+        cache->Put(std::move(key), qtype);
         return qtype;
       };
 }
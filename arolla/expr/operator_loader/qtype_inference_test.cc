@@ -69,6 +69,27 @@ TEST_F(QTypeInferenceTest, Ok) {
               IsOkAndHolds(GetQType<int64_t>()));
 }
 
+TEST_F(QTypeInferenceTest, RepeatedCalls) {
+  ASSERT_OK_AND_ASSIGN(auto fn, SampleInferenceFn());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(fn({
+                    {"x", GetQType<int64_t>()},
+                    {"y", GetQType<int32_t>()},
+                }),
+                IsOkAndHolds(GetQType<int64_t>()));
+    EXPECT_THAT(fn({
+                    {"x", GetQType<float>()},
+                    {"y", GetQType<double>()},
+                }),
+                IsOkAndHolds(GetQType<double>()));
+    EXPECT_THAT(fn({
+                    {"x", GetQType<int32_t>()},
+                    {"y", GetQType<ScalarShape>()},
+                }),
+                StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
 TEST_F(QTypeInferenceTest, ErrorMessage) {
   ASSERT_OK_AND_ASSIGN(auto fn, SampleInferenceFn());
   EXPECT_THAT(
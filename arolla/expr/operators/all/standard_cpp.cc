@@ -13,6 +13,8 @@
 // limitations under the License.
 //
 #include "absl/status/status.h"
+#include "arolla/expr/operators/half/register_operators.h"
+#include "arolla/expr/operators/quantized/register_operators.h"
 #include "arolla/expr/operators/register_operators.h"
 #include "arolla/expr/operators/strings/register_operators.h"
 #include "arolla/util/init_arolla.h"
@@ -28,6 +30,8 @@ AROLLA_REGISTER_INITIALIZER(kRegisterExprOperatorsStandardCpp,
                               RETURN_IF_ERROR(InitCore());
                               RETURN_IF_ERROR(InitMath());
                               RETURN_IF_ERROR(InitStrings());
+                              RETURN_IF_ERROR(InitQuantized());
+                              RETURN_IF_ERROR(InitHalf());
                               return absl::OkStatus();
                             });
 
@@ -0,0 +1,90 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/operators/half/register_operators.h"
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "arolla/expr/expr_operator_signature.h"
+#include "arolla/expr/operators/register_operators.h"
+#include "arolla/expr/operators/registration.h"
+#include "arolla/expr/operators/type_meta_eval_strategies.h"
+#include "arolla/qtype/half/half_types.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::expr_operators {
+namespace {
+
+using ::arolla::expr::ExprOperatorSignature;
+
+namespace tm = ::arolla::expr_operators::type_meta;
+
+using tm::Chain;
+using tm::LiftResultType;
+using tm::ScalarTypeIsOneOf;
+using tm::Unary;
+
+// Returns the result type of a conversion of x with the scalar type checked by
+// `scalar_type_strategy` to `result_scalar_qtype`.
+tm::Strategy ConversionStrategy(tm::Strategy scalar_type_strategy,
+                                QTypePtr result_scalar_qtype) {
+  return Chain(Unary, std::move(scalar_type_strategy),
+               LiftResultType(result_scalar_qtype));
+}
+
+}  // namespace
+
+AROLLA_DEFINE_EXPR_OPERATOR(
+    HalfToFloat32,
+    RegisterBackendOperator(
+        "half.to_float32", ExprOperatorSignature{{"x"}},
+        ConversionStrategy(ScalarTypeIsOneOf<Float16, BFloat16>,
+                           GetQType<float>()),
+        "Converts FLOAT16 / BFLOAT16 to FLOAT32 exactly."));
+
+AROLLA_DEFINE_EXPR_OPERATOR(
+    HalfToFloat16,
+    RegisterBackendOperator(
+        "half.to_float16", ExprOperatorSignature{{"x"}},
+        ConversionStrategy(ScalarTypeIsOneOf<float, double>,
+                           GetQType<Float16>()),
+        "Converts FLOAT32 / FLOAT64 to FLOAT16, rounding to nearest even."));
+
+AROLLA_DEFINE_EXPR_OPERATOR(
+    HalfToBFloat16,
+    RegisterBackendOperator(
+        "half.to_bfloat16", ExprOperatorSignature{{"x"}},
+        ConversionStrategy(ScalarTypeIsOneOf<float, double>,
+                           GetQType<BFloat16>()),
+        "Converts FLOAT32 / FLOAT64 to BFLOAT16, rounding to nearest even."));
+
+absl::Status InitHalf() {
+  static Indestructible<absl::Status> init_status([]() -> absl::Status {
+    RETURN_IF_ERROR(InitCore());
+    RETURN_IF_ERROR(InitArray());
+
+    RETURN_IF_ERROR(RegisterHalfToFloat32());
+    RETURN_IF_ERROR(RegisterHalfToFloat16());
+    RETURN_IF_ERROR(RegisterHalfToBFloat16());
+
+    return absl::OkStatus();
+  }());
+  return *init_status;
+}
+
+}  // namespace arolla::expr_operators
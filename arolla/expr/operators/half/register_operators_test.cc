@@ -0,0 +1,85 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/operators/half/register_operators.h"
+
+#include <optional>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/testing/testing.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/half/half_types.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla::expr_operators {
+namespace {
+
+using ::arolla::expr::CallOp;
+using ::arolla::expr::Leaf;
+using ::arolla::testing::InvokeExprOperator;
+using ::arolla::testing::IsOkAndHolds;
+using ::arolla::testing::StatusIs;
+using ::arolla::testing::WithQTypeAnnotation;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+class HalfOperatorsTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite() { CHECK_OK(InitArolla()); }
+};
+
+TEST_F(HalfOperatorsTest, ToFloat32) {
+  EXPECT_THAT(InvokeExprOperator<float>("half.to_float32", Float16(1.5f)),
+              IsOkAndHolds(1.5f));
+  EXPECT_THAT(InvokeExprOperator<OptionalValue<float>>(
+                  "half.to_float32", OptionalValue<BFloat16>(-2.0f)),
+              IsOkAndHolds(-2.0f));
+  EXPECT_THAT(InvokeExprOperator<DenseArray<float>>(
+                  "half.to_float32",
+                  CreateDenseArray<Float16>({Float16(0.25f), std::nullopt})),
+              IsOkAndHolds(ElementsAre(0.25f, std::nullopt)));
+  EXPECT_THAT(
+      CallOp("half.to_float32",
+             {WithQTypeAnnotation(Leaf("x"), GetQType<float>())}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("expected scalar type to be FLOAT16 or BFLOAT16, "
+                         "got FLOAT32")));
+}
+
+TEST_F(HalfOperatorsTest, ToHalf) {
+  EXPECT_THAT(InvokeExprOperator<Float16>("half.to_float16", 0.5f),
+              IsOkAndHolds(Float16(0.5f)));
+  EXPECT_THAT(InvokeExprOperator<BFloat16>("half.to_bfloat16", 3.0),
+              IsOkAndHolds(BFloat16(3.0f)));
+  EXPECT_THAT(InvokeExprOperator<DenseArray<BFloat16>>(
+                  "half.to_bfloat16",
+                  CreateDenseArray<float>({1.0f, std::nullopt})),
+              IsOkAndHolds(ElementsAre(BFloat16(1.0f), std::nullopt)));
+  EXPECT_THAT(
+      CallOp("half.to_float16",
+             {WithQTypeAnnotation(Leaf("x"), GetQType<Float16>())}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("expected scalar type to be FLOAT32 or FLOAT64, "
+                         "got FLOAT16")));
+}
+
+}  // namespace
+}  // namespace arolla::expr_operators
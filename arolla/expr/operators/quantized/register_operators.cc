@@ -0,0 +1,122 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/operators/quantized/register_operators.h"
+
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/edge.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/expr_operator_signature.h"
+#include "arolla/expr/operators/register_operators.h"
+#include "arolla/expr/operators/registration.h"
+#include "arolla/expr/operators/type_meta_eval_strategies.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/quantized/quantized_types.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::expr_operators {
+namespace {
+
+using ::arolla::expr::ExprOperatorSignature;
+
+namespace tm = ::arolla::expr_operators::type_meta;
+
+using tm::Chain;
+using tm::EdgeParentShapeQType;
+using tm::Floating;
+using tm::Is;
+using tm::IsDenseArray;
+using tm::LiftResultType;
+using tm::Nth;
+using tm::NthMatch;
+using tm::Or;
+using tm::ScalarTypeIsOneOf;
+using tm::Shaped;
+
+// Verifies that all arguments store INT8 or INT16 values.
+constexpr auto QuantizedValues = ScalarTypeIsOneOf<int8_t, int16_t>;
+
+// Returns the result type of quantized.quantize_* / quantized.dequantize with
+// the given scalar result type and the value argument type checked by
+// `value_strategy`. The scale and the zero point are scalars.
+tm::Strategy QuantizationStrategy(tm::Strategy value_strategy,
+                                  QTypePtr result_scalar_qtype) {
+  return Chain(NthMatch(0, std::move(value_strategy)), NthMatch(1, Is<float>),
+               NthMatch(2, Is<int32_t>), Nth(0),
+               LiftResultType(result_scalar_qtype));
+}
+
+const ExprOperatorSignature& QuantizationSignature() {
+  static const Indestructible<ExprOperatorSignature> result(
+      ExprOperatorSignature{{"x"}, {"scale"}, {"zero_point"}});
+  return *result;
+}
+
+}  // namespace
+
+AROLLA_DEFINE_EXPR_OPERATOR(
+    QuantizedDequantize,
+    RegisterBackendOperator(
+        "quantized.dequantize", QuantizationSignature(),
+        QuantizationStrategy(QuantizedValues, GetQType<float>()),
+        "Returns (x - zero_point) * scale as FLOAT32."));
+
+AROLLA_DEFINE_EXPR_OPERATOR(
+    QuantizedQuantizeInt8,
+    RegisterBackendOperator(
+        "quantized.quantize_int8", QuantizationSignature(),
+        QuantizationStrategy(Floating, GetQType<int8_t>()),
+        "Returns round(x / scale) + zero_point saturated to INT8."));
+
+AROLLA_DEFINE_EXPR_OPERATOR(
+    QuantizedQuantizeInt16,
+    RegisterBackendOperator(
+        "quantized.quantize_int16", QuantizationSignature(),
+        QuantizationStrategy(Floating, GetQType<int16_t>()),
+        "Returns round(x / scale) + zero_point saturated to INT16."));
+
+AROLLA_DEFINE_EXPR_OPERATOR(
+    QuantizedDot,
+    RegisterBackendOperator(
+        "quantized._dot",
+        ExprOperatorSignature{
+            {"x"}, {"y"}, {"edge"}, {"scale"}, {"zero_point"}},
+        Chain(NthMatch(0, Chain(IsDenseArray, QuantizedValues)),
+              NthMatch(1, Is<DenseArray<float>>), NthMatch(3, Is<float>),
+              NthMatch(4, Is<int32_t>), Nth(2),
+              Or(Is<DenseArrayEdge>, Is<DenseArrayGroupScalarEdge>),
+              EdgeParentShapeQType, Shaped<float>),
+        "Returns math._dot(quantized.dequantize(x, scale, zero_point), y, "
+        "edge)."));
+
+absl::Status InitQuantized() {
+  static Indestructible<absl::Status> init_status([]() -> absl::Status {
+    RETURN_IF_ERROR(InitCore());
+    RETURN_IF_ERROR(InitArray());
+
+    RETURN_IF_ERROR(RegisterQuantizedDequantize());
+    RETURN_IF_ERROR(RegisterQuantizedQuantizeInt8());
+    RETURN_IF_ERROR(RegisterQuantizedQuantizeInt16());
+    RETURN_IF_ERROR(RegisterQuantizedDot());
+
+    return absl::OkStatus();
+  }());
+  return *init_status;
+}
+
+}  // namespace arolla::expr_operators
@@ -0,0 +1,35 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_OPERATORS_QUANTIZED_REGISTER_OPERATORS_H_
+#define AROLLA_EXPR_OPERATORS_QUANTIZED_REGISTER_OPERATORS_H_
+
+#include "absl/status/status.h"
+#include "arolla/expr/operators/registration.h"
+
+namespace arolla::expr_operators {
+
+// Initialize "quantized" operators.
+absl::Status InitQuantized();
+
+// go/keep-sorted start
+AROLLA_DECLARE_EXPR_OPERATOR(QuantizedDequantize);
+AROLLA_DECLARE_EXPR_OPERATOR(QuantizedDot);
+AROLLA_DECLARE_EXPR_OPERATOR(QuantizedQuantizeInt16);
+AROLLA_DECLARE_EXPR_OPERATOR(QuantizedQuantizeInt8);
+// go/keep-sorted end
+
+}  // namespace arolla::expr_operators
+
+#endif  // AROLLA_EXPR_OPERATORS_QUANTIZED_REGISTER_OPERATORS_H_
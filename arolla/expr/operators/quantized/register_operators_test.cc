@@ -0,0 +1,95 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/operators/quantized/register_operators.h"
+
+#include <cstdint>
+#include <optional>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/edge.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/testing/testing.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/quantized/quantized_types.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla::expr_operators {
+namespace {
+
+using ::arolla::expr::CallOp;
+using ::arolla::expr::Leaf;
+using ::arolla::testing::InvokeExprOperator;
+using ::arolla::testing::IsOkAndHolds;
+using ::arolla::testing::StatusIs;
+using ::arolla::testing::WithQTypeAnnotation;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+class QuantizedOperatorsTest : public ::testing::Test {
+ public:
+  static void SetUpTestSuite() { CHECK_OK(InitArolla()); }
+};
+
+TEST_F(QuantizedOperatorsTest, Dequantize) {
+  EXPECT_THAT(InvokeExprOperator<float>("quantized.dequantize", int8_t{5},
+                                        0.5f, int32_t{1}),
+              IsOkAndHolds(2.0f));
+  EXPECT_THAT(InvokeExprOperator<DenseArray<float>>(
+                  "quantized.dequantize",
+                  CreateDenseArray<int16_t>({-300, std::nullopt}), 0.25f,
+                  int32_t{0}),
+              IsOkAndHolds(ElementsAre(-75.0f, std::nullopt)));
+  EXPECT_THAT(
+      CallOp("quantized.dequantize",
+             {WithQTypeAnnotation(Leaf("x"), GetQType<float>()),
+              WithQTypeAnnotation(Leaf("scale"), GetQType<float>()),
+              WithQTypeAnnotation(Leaf("zero_point"), GetQType<int32_t>())}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("expected scalar type to be INT8 or INT16, got FLOAT32")));
+}
+
+TEST_F(QuantizedOperatorsTest, Quantize) {
+  EXPECT_THAT(InvokeExprOperator<int8_t>("quantized.quantize_int8", 2.0f,
+                                         0.5f, int32_t{1}),
+              IsOkAndHolds(int8_t{5}));
+  EXPECT_THAT(InvokeExprOperator<OptionalValue<int16_t>>(
+                  "quantized.quantize_int16", OptionalValue<double>(1000.0),
+                  1.0f, int32_t{0}),
+              IsOkAndHolds(int16_t{1000}));
+}
+
+TEST_F(QuantizedOperatorsTest, Dot) {
+  ASSERT_OK_AND_ASSIGN(auto edge, DenseArrayEdge::FromSplitPoints(
+                                      CreateDenseArray<int64_t>({0, 2, 3})));
+  auto x = CreateDenseArray<int8_t>({2, 3, 5});
+  auto y = CreateDenseArray<float>({1.0f, 2.0f, 4.0f});
+  EXPECT_THAT(InvokeExprOperator<DenseArray<float>>(
+                  "quantized._dot", x, y, edge, 0.5f, int32_t{1}),
+              IsOkAndHolds(ElementsAre(2.5f, 8.0f)));
+  EXPECT_THAT(InvokeExprOperator<OptionalValue<float>>(
+                  "quantized._dot", x, y, DenseArrayGroupScalarEdge(3), 0.5f,
+                  int32_t{1}),
+              IsOkAndHolds(10.5f));
+}
+
+}  // namespace
+}  // namespace arolla::expr_operators
@@ -15,9 +15,12 @@
 #include "arolla/expr/operators/strings/register_operators.h"
 
 #include <memory>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/qtype/types.h"
 #include "arolla/expr/backend_wrapping_operator.h"
 #include "arolla/expr/expr_operator.h"
 #include "arolla/expr/expr_operator_signature.h"
@@ -26,7 +29,9 @@
 #include "arolla/expr/operators/registration.h"
 #include "arolla/expr/operators/strings/string_operators.h"
 #include "arolla/expr/operators/type_meta_eval_strategies.h"
+#include "arolla/expr/overloaded_expr_operator.h"
 #include "arolla/expr/registered_expr_operator.h"
+#include "arolla/qtype/qtype.h"
 #include "arolla/qtype/strings/regex.h"
 #include "arolla/util/indestructible.h"
 #include "arolla/util/text.h"
@@ -47,6 +52,7 @@ using tm::Is;
 using tm::LiftNthType;
 using tm::Nth;
 using tm::NthMatch;
+using tm::QTypes;
 using tm::Returns;
 using tm::ScalarOrOptional;
 using tm::ScalarTypeIs;
@@ -55,6 +61,25 @@ using tm::ToOptional;
 using tm::ToTestResult;
 using tm::Unary;
 
+// Matches strings._join_with_separator(sep, *parts) with a scalar separator
+// and all the parts being dense arrays of the same type.
+absl::StatusOr<QTypes> JoinDenseArrayParts(absl::Span<const QTypePtr> types) {
+  if (types.size() < 2 || !IsDenseArrayQType(types[1])) {
+    return absl::InvalidArgumentError("expected dense array parts");
+  }
+  for (QTypePtr t : types.subspan(2)) {
+    if (t != types[1]) {
+      return absl::InvalidArgumentError(
+          "expected all parts to have the same type");
+    }
+  }
+  if (types[1]->value_qtype() != types[0]) {
+    return absl::InvalidArgumentError(
+        "expected the separator to match the parts value type");
+  }
+  return QTypes{types[1]};
+}
+
 }  // namespace
 
 AROLLA_DEFINE_EXPR_OPERATOR(StringsCompileRegex,
@@ -62,14 +87,25 @@ AROLLA_DEFINE_EXPR_OPERATOR(StringsCompileRegex,
                                                     Chain(Unary, Is<Text>,
                                                           Returns<Regex>)));
 AROLLA_DEFINE_EXPR_OPERATOR(
-    StringsJoinWithSeparator,
-    RegisterOperator(
-        "strings._join_with_separator",
-        LiftDynamically(std::make_shared<expr::BackendWrappingOperator>(
-            "strings._join_with_separator",
-            ExprOperatorSignature::MakeVariadicArgs(),
-            CallableStrategy(Chain(ScalarOrOptional, String,
-                                   LiftNthType(0)))))));
+    StringsJoinWithSeparator, []() -> absl::StatusOr<expr::ExprOperatorPtr> {
+      ASSIGN_OR_RETURN(
+          auto lifted_op,
+          LiftDynamically(std::make_shared<expr::BackendWrappingOperator>(
+              "strings._join_with_separator",
+              ExprOperatorSignature::MakeVariadicArgs(),
+              CallableStrategy(
+                  Chain(ScalarOrOptional, String, LiftNthType(0))))));
+      // The backend joins dense arrays in batch, without core.map.
+      auto dense_array_op = std::make_shared<expr::BackendWrappingOperator>(
+          "strings._join_with_separator",
+          ExprOperatorSignature::MakeVariadicArgs(),
+          CallableStrategy(JoinDenseArrayParts));
+      return RegisterOperator(
+          "strings._join_with_separator",
+          expr::MakeOverloadedOperator("strings._join_with_separator",
+                                       std::move(dense_array_op),
+                                       std::move(lifted_op)));
+    }());
 
 AROLLA_DEFINE_EXPR_OPERATOR(
     StringsContainsRegex, []() -> absl::StatusOr<expr::ExprOperatorPtr> {
@@ -86,6 +122,27 @@ AROLLA_DEFINE_EXPR_OPERATOR(
       return RegisterOperator("strings.contains_regex", MakeContainsRegexOp());
     }());
 
+AROLLA_DEFINE_EXPR_OPERATOR(StringsCompileRegexSet,
+                            RegisterBackendOperator(
+                                "strings._compile_regex_set",
+                                ExprOperatorSignature::MakeVariadicArgs(),
+                                Chain(Is<Text>, Returns<RegexSet>)));
+
+AROLLA_DEFINE_EXPR_OPERATOR(
+    StringsMatchAny, []() -> absl::StatusOr<expr::ExprOperatorPtr> {
+      RETURN_IF_ERROR(
+          RegisterOperator(
+              "strings._match_any",
+              LiftDynamically(std::make_shared<expr::BackendWrappingOperator>(
+                  "strings._match_any",
+                  ExprOperatorSignature{{"s"}, {"regex_set"}},
+                  CallableStrategy(Chain(Binary, NthMatch(1, Is<RegexSet>),
+                                         Nth(0), ScalarOrOptional,
+                                         ScalarTypeIs<Text>, ToTestResult)))))
+              .status());
+      return RegisterOperator("strings.match_any", MakeMatchAnyOp());
+    }());
+
 AROLLA_DEFINE_EXPR_OPERATOR(
     StringsExtractRegex, []() -> absl::StatusOr<expr::ExprOperatorPtr> {
       RETURN_IF_ERROR(
@@ -110,9 +167,11 @@ absl::Status InitStrings() {
     RETURN_IF_ERROR(InitArray());
 
     RETURN_IF_ERROR(RegisterStringsCompileRegex());
+    RETURN_IF_ERROR(RegisterStringsCompileRegexSet());
     RETURN_IF_ERROR(RegisterStringsJoinWithSeparator());
     RETURN_IF_ERROR(RegisterStringsContainsRegex());
     RETURN_IF_ERROR(RegisterStringsExtractRegex());
+    RETURN_IF_ERROR(RegisterStringsMatchAny());
     RETURN_IF_ERROR(RegisterStringsJoin());
 
     return absl::OkStatus();
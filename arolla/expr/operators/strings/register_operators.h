@@ -25,10 +25,12 @@ absl::Status InitStrings();
 
 // go/keep-sorted start
 AROLLA_DECLARE_EXPR_OPERATOR(StringsCompileRegex);
+AROLLA_DECLARE_EXPR_OPERATOR(StringsCompileRegexSet);
 AROLLA_DECLARE_EXPR_OPERATOR(StringsContainsRegex);
 AROLLA_DECLARE_EXPR_OPERATOR(StringsExtractRegex);
 AROLLA_DECLARE_EXPR_OPERATOR(StringsJoin);
 AROLLA_DECLARE_EXPR_OPERATOR(StringsJoinWithSeparator);
+AROLLA_DECLARE_EXPR_OPERATOR(StringsMatchAny);
 // go/keep-sorted end
 
 }  // namespace arolla::expr_operators
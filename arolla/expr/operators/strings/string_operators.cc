@@ -15,6 +15,7 @@
 #include "arolla/expr/operators/strings/string_operators.h"
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -40,6 +41,7 @@ namespace arolla::expr_operators {
 namespace {
 
 using ::arolla::expr::BasicExprOperator;
+using ::arolla::expr::BindOp;
 using ::arolla::expr::CallOp;
 using ::arolla::expr::ExprNodePtr;
 using ::arolla::expr::ExprOperatorPtr;
@@ -102,6 +104,58 @@ class JoinOp final : public BasicExprOperator {
   }
 };
 
+// strings.match_any(s, *patterns) operator tests whether `s` contains a match
+// for any of the regular expressions in `patterns`.
+class MatchAnyOp final : public BasicExprOperator {
+ public:
+  MatchAnyOp()
+      : BasicExprOperator(
+            "strings.match_any",
+            ExprOperatorSignature{
+                {"s"},
+                {.name = "patterns",
+                 .kind = ExprOperatorSignature::Parameter::Kind::
+                     kVariadicPositional}},
+            "Returns present if `s` contains a match for any of the regular "
+            "expressions in `patterns`.\n\nAll the patterns are tested in a "
+            "single pass over `s`.",
+            FingerprintHasher("::arolla::expr_operators::MatchAnyOp")
+                .Finish()) {}
+
+  // Converts: MatchAny(s, *patterns)
+  // into:     _MatchAny(s, _CompileRegexSet(*patterns))
+  absl::StatusOr<ExprNodePtr> ToLowerLevel(
+      const ExprNodePtr& node) const final {
+    const auto& deps = node->node_deps();
+    if (deps.size() < 2) {
+      return absl::InvalidArgumentError(
+          "strings.match_any operator requires at least one pattern");
+    }
+    ASSIGN_OR_RETURN(auto regex_set,
+                     BindOp("strings._compile_regex_set",
+                            absl::MakeConstSpan(deps).subspan(1), {}));
+    return BindOp("strings._match_any", {deps[0], std::move(regex_set)}, {});
+  }
+
+  absl::StatusOr<QTypePtr> GetOutputQType(
+      absl::Span<const QTypePtr> input_qtypes) const final {
+    if (input_qtypes.size() < 2) {
+      return absl::InvalidArgumentError(
+          "strings.match_any operator requires at least one pattern");
+    }
+    for (const auto* pattern_qtype : input_qtypes.subspan(1)) {
+      if (pattern_qtype != GetQType<Text>()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "expected all patterns to be TEXT, got %s", pattern_qtype->name()));
+      }
+    }
+    auto strategy = CallableStrategy(
+        tm::Chain(tm::ScalarOrOptional, tm::ScalarTypeIs<Text>,
+                  tm::ToTestResult));
+    return strategy(input_qtypes.first(1));
+  }
+};
+
 }  // namespace
 
 absl::StatusOr<ExprOperatorPtr> MakeJoinOp() {
@@ -119,6 +173,10 @@ absl::StatusOr<ExprOperatorPtr> MakeContainsRegexOp() {
              {s, CallOp("strings._compile_regex", {pattern})}));
 }
 
+absl::StatusOr<ExprOperatorPtr> MakeMatchAnyOp() {
+  return std::make_shared<MatchAnyOp>();
+}
+
 // Converts: ExtractRegex(s, pattern)
 // into:     _ExtractRegex(s, CompileRegex(pattern))
 absl::StatusOr<ExprOperatorPtr> MakeExtractRegexOp() {
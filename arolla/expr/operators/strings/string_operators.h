@@ -26,6 +26,9 @@ absl::StatusOr<expr::ExprOperatorPtr> MakeContainsRegexOp();
 // Constructs strings.extract_regex operator.
 absl::StatusOr<expr::ExprOperatorPtr> MakeExtractRegexOp();
 
+// Constructs strings.match_any operator.
+absl::StatusOr<expr::ExprOperatorPtr> MakeMatchAnyOp();
+
 // Constructs strings.join operator.
 absl::StatusOr<expr::ExprOperatorPtr> MakeJoinOp();
 
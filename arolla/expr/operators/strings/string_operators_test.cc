@@ -66,6 +66,36 @@ TEST_F(StringOperatorsTest, ContainsRegex) {
                                        std::nullopt)));
 }
 
+TEST_F(StringOperatorsTest, MatchAny) {
+  EXPECT_THAT(InvokeExprOperator<OptionalUnit>("strings.match_any",
+                                               Text{"aaabccc"}, Text{"x.z"},
+                                               Text{"a.c"}),
+              IsOkAndHolds(kPresent));
+  EXPECT_THAT(InvokeExprOperator<OptionalUnit>("strings.match_any",
+                                               Text{"cccbaaa"}, Text{"x.z"},
+                                               Text{"a.c"}),
+              IsOkAndHolds(kMissing));
+  EXPECT_THAT(InvokeExprOperator<OptionalUnit>(
+                  "strings.match_any", OptionalValue<Text>{}, Text{"a.c"}),
+              IsOkAndHolds(kMissing));
+  EXPECT_THAT(InvokeExprOperator<DenseArray<Unit>>(
+                  "strings.match_any",
+                  CreateDenseArray<Text>({Text("aaabccc"), Text("xyz"),
+                                          Text("ac"), std::nullopt}),
+                  Text{"a.c"}, Text{"^x"}),
+              IsOkAndHolds(ElementsAre(kUnit, kUnit, std::nullopt,
+                                       std::nullopt)));
+  EXPECT_THAT(InvokeExprOperator<OptionalUnit>("strings.match_any",
+                                               Text{"aaabccc"}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("requires at least one pattern")));
+  EXPECT_THAT(InvokeExprOperator<OptionalUnit>(
+                  "strings.match_any", Text{"aaabccc"}, Text{"a.c"},
+                  Text{"ab\\αcd"}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Invalid regular expression")));
+}
+
 TEST_F(StringOperatorsTest, ExtractRegex) {
   EXPECT_THAT(
       InvokeExprOperator<OptionalValue<Text>>("strings.extract_regex",
@@ -25,6 +25,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "arolla/expr/backend_wrapping_operator.h"
@@ -292,6 +293,27 @@ absl::StatusOr<QTypes> ScalarTypeIs(absl::Span<const QTypePtr> types) {
   return QTypes{types.begin(), types.end()};
 }
 
+// Verifies that all arguments are of one of the scalar types Ts. Unlike
+// Or(ScalarTypeIs<T1>, ScalarTypeIs<T2>), the error lists all the accepted
+// types.
+template <typename... Ts>
+absl::StatusOr<QTypes> ScalarTypeIsOneOf(absl::Span<const QTypePtr> types) {
+  for (size_t i = 0; i < types.size(); ++i) {
+    ASSIGN_OR_RETURN(auto scalar_type, GetScalarQType(types[i]),
+                     _ << " in argument " << i);
+    if (((scalar_type != GetQType<Ts>()) && ...)) {
+      std::string arg_msg =
+          types.size() == 1 ? "" : absl::StrFormat(" of argument %d", i);
+      std::vector<absl::string_view> names = {GetQType<Ts>()->name()...};
+      return absl::Status(
+          absl::StatusCode::kInvalidArgument,
+          absl::StrFormat("expected scalar type%s to be %s, got %s", arg_msg,
+                          absl::StrJoin(names, " or "), scalar_type->name()));
+    }
+  }
+  return QTypes{types.begin(), types.end()};
+}
+
 // Verifies that all QTypes are edge qtypes, and returns the array shape qtype
 // corresponding to the parent shape of the edge.
 absl::StatusOr<QTypes> EdgeParentShapeQType(absl::Span<const QTypePtr> types);
@@ -67,6 +67,7 @@ using ::arolla::expr_operators::type_meta::OptionalLike;
 using ::arolla::expr_operators::type_meta::Scalar;
 using ::arolla::expr_operators::type_meta::ScalarOrOptional;
 using ::arolla::expr_operators::type_meta::ScalarTypeIs;
+using ::arolla::expr_operators::type_meta::ScalarTypeIsOneOf;
 using ::arolla::expr_operators::type_meta::ToOptional;
 using ::arolla::expr_operators::type_meta::ToShape;
 using ::arolla::expr_operators::type_meta::Unary;
@@ -400,6 +401,21 @@ TEST_F(TypeMetaEvalStrategiesTest, ScalarTypeIs) {
                "expected scalar type of argument 0 to be INT64, got INT32"));
 }
 
+TEST_F(TypeMetaEvalStrategiesTest, ScalarTypeIsOneOf) {
+  std::vector<QTypePtr> types = {GetQType<int32_t>(),
+                                 GetDenseArrayQType<int64_t>()};
+  EXPECT_THAT((ScalarTypeIsOneOf<int32_t, int64_t>(types)),
+              IsOkAndHolds(ElementsAreArray(types)));
+  EXPECT_THAT((ScalarTypeIsOneOf<int64_t, float>(types)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "expected scalar type of argument 0 to be INT64 or "
+                       "FLOAT32, got INT32"));
+  EXPECT_THAT((ScalarTypeIsOneOf<int32_t, float>({GetQType<double>()})),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "expected scalar type to be INT32 or FLOAT32, got "
+                       "FLOAT64"));
+}
+
 TEST_F(TypeMetaEvalStrategiesTest, Unary) {
   auto single_arg_type = CallableStrategy(Unary);
   EXPECT_THAT(single_arg_type({GetQType<int32_t>()}),
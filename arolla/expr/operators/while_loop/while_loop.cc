@@ -26,6 +26,7 @@
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -34,6 +35,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "arolla/array/qtype/types.h"
 #include "arolla/expr/basic_expr_operator.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_attributes.h"
@@ -49,6 +51,7 @@
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/text.h"
+#include "arolla/util/unit.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr_operators {
@@ -64,6 +67,8 @@ using ::arolla::expr::Literal;
 using ::arolla::expr::Placeholder;
 
 constexpr absl::string_view kDefaultOperatorName = "anonymous.while_loop";
+constexpr absl::string_view kDefaultBatchedOperatorName =
+    "anonymous.batched_while_loop";
 constexpr absl::string_view kLoopStatePlaceholderName = "loop_state";
 
 // Extracts (sorted) names from named_expressions.
@@ -129,7 +134,10 @@ absl::StatusOr<NamedExpressions> AddImplicitCastsToInitialState(
 // Moves subexpressions that do not depend on placeholders (aka immutable in
 // the while_loop context) from `condition` and `body` into new items in
 // initial_state map. Replaces the moved parts with newly created placeholders.
-// All three arguments can be modified.
+// The state variables that are not updated by `body` are loop-invariant as
+// well, so the subexpressions depending on them are moved too, with their
+// placeholders substituted by the initial values. All three arguments can be
+// modified.
 absl::Status MoveImmutablesIntoInitialState(NamedExpressions& initial_state,
                                             ExprNodePtr& condition,
                                             NamedExpressions& body) {
@@ -142,6 +150,24 @@ absl::Status MoveImmutablesIntoInitialState(NamedExpressions& initial_state,
     }
   }
 
+  NamedExpressions invariant_state;
+  absl::flat_hash_set<std::string> invariant_state_names;
+  for (const auto& [name, expr] : initial_state) {
+    if (!body.contains(name)) {
+      invariant_state.emplace(name, expr);
+      invariant_state_names.insert(name);
+    }
+  }
+  auto hoist_immutables = [&](NamedExpressions immutables) -> absl::Status {
+    for (auto& [name, expr] : immutables) {
+      ASSIGN_OR_RETURN(expr,
+                       SubstitutePlaceholders(expr, invariant_state,
+                                              /*must_substitute_all=*/true));
+    }
+    initial_state.merge(std::move(immutables));
+    return absl::OkStatus();
+  };
+
   absl::flat_hash_map<Fingerprint, std::string> immutable_names;
   auto immutable_naming_function = [&](const ExprNodePtr& node) -> std::string {
     if (auto it = immutable_names.find(node->fingerprint());
@@ -157,16 +183,17 @@ absl::Status MoveImmutablesIntoInitialState(NamedExpressions& initial_state,
   for (auto& [name, expr] : body) {
     ASSIGN_OR_RETURN(
         (auto [converted_expr, immutables]),
-        while_loop_impl::ExtractImmutables(expr, immutable_naming_function));
+        while_loop_impl::ExtractImmutables(expr, immutable_naming_function,
+                                           invariant_state_names));
     expr = std::move(converted_expr);
-    initial_state.merge(std::move(immutables));
+    RETURN_IF_ERROR(hoist_immutables(std::move(immutables)));
   }
   ASSIGN_OR_RETURN(
       (auto [converted_condition, condition_immutables]),
-      while_loop_impl::ExtractImmutables(condition, immutable_naming_function));
+      while_loop_impl::ExtractImmutables(condition, immutable_naming_function,
+                                         invariant_state_names));
   condition = std::move(converted_condition);
-  initial_state.merge(std::move(condition_immutables));
-  return absl::OkStatus();
+  return hoist_immutables(std::move(condition_immutables));
 }
 
 // Essentially checks that the first argument contains each element of the
@@ -185,11 +212,13 @@ absl::Status CheckAllStateFieldsAreInitialized(
   return absl::OkStatus();
 }
 
-}  // namespace
+using MakeLoopOperatorFn = absl::FunctionRef<absl::StatusOr<ExprOperatorPtr>(
+    const ExprOperatorSignature& signature, const ExprOperatorPtr& condition,
+    const ExprOperatorPtr& body)>;
 
-absl::StatusOr<ExprNodePtr> MakeWhileLoop(NamedExpressions initial_state,
-                                          ExprNodePtr condition,
-                                          NamedExpressions body) {
+absl::StatusOr<ExprNodePtr> MakeWhileLoopImpl(
+    NamedExpressions initial_state, ExprNodePtr condition,
+    NamedExpressions body, MakeLoopOperatorFn make_loop_operator) {
   RETURN_IF_ERROR(
       MoveImmutablesIntoInitialState(initial_state, condition, body));
 
@@ -256,20 +285,16 @@ absl::StatusOr<ExprNodePtr> MakeWhileLoop(NamedExpressions initial_state,
 
   ASSIGN_OR_RETURN(
       ExprOperatorPtr while_op,
-      WhileLoopOperator::Make(operators_signature, condition_op, body_op));
+      make_loop_operator(operators_signature, condition_op, body_op));
   ASSIGN_OR_RETURN(auto while_node, BindOp(while_op, init_deps, {}));
   return while_node;
 }
 
-absl::StatusOr<std::shared_ptr<WhileLoopOperator>> WhileLoopOperator::Make(
-    const ExprOperatorSignature& signature, const ExprOperatorPtr& condition,
-    const ExprOperatorPtr& body) {
-  return Make(kDefaultOperatorName, signature, condition, body);
-}
-
-absl::StatusOr<std::shared_ptr<WhileLoopOperator>> WhileLoopOperator::Make(
-    absl::string_view name, const ExprOperatorSignature& signature,
-    const ExprOperatorPtr& condition, const ExprOperatorPtr& body) {
+// Verifies that the loop signature matches the signatures of its body and
+// condition.
+absl::Status ValidateLoopSignatures(const ExprOperatorSignature& signature,
+                                    const ExprOperatorPtr& condition,
+                                    const ExprOperatorPtr& body) {
   if (signature.parameters.empty()) {
     return absl::InvalidArgumentError(
         "WhileLoopOperator must at least have one parameter, got 0");
@@ -292,6 +317,79 @@ absl::StatusOr<std::shared_ptr<WhileLoopOperator>> WhileLoopOperator::Make(
         "loop signature does not match its condition signature: `%s` vs `%s`",
         signature_spec, condition_signature_spec));
   }
+  return absl::OkStatus();
+}
+
+// Infers the output attributes of a loop operator, verifying that the
+// condition returns `condition_qtype` and the body preserves the state type.
+absl::StatusOr<ExprAttributes> InferLoopAttributes(
+    absl::string_view display_name, const ExprOperatorPtr& condition,
+    const ExprOperatorPtr& body, QTypePtr condition_qtype,
+    absl::Span<const ExprAttributes> inputs) {
+  // Clean up literal values for mutable state as it is going to change on every
+  // iteration.
+  std::vector<ExprAttributes> new_inputs;
+  new_inputs.reserve(inputs.size());
+  new_inputs.emplace_back(inputs[0].qtype());
+  new_inputs.insert(new_inputs.end(), inputs.begin() + 1, inputs.end());
+  ASSIGN_OR_RETURN(
+      auto condition_attr, condition->InferAttributes(new_inputs),
+      _ << "in condition of `" << display_name << "` while loop");
+  if (condition_attr.qtype() && condition_attr.qtype() != condition_qtype) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "incorrect return type of the condition of `%s` while loop for input "
+        "types %s: expected %s, got %s",
+        display_name, FormatTypeVector(GetAttrQTypes(inputs)),
+        condition_qtype->name(), condition_attr.qtype()->name()));
+  }
+  ASSIGN_OR_RETURN(auto body_attr, body->InferAttributes(new_inputs),
+                   _ << "in body of `" << display_name << "` while loop");
+  if (body_attr.qtype() && body_attr.qtype() != inputs[0].qtype()) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "incorrect return type of the body of `%s` while loop for input types "
+        "%s: expected %s, got %s",
+        display_name, FormatTypeVector(GetAttrQTypes(inputs)),
+        inputs[0].qtype()->name(), body_attr.qtype()->name()));
+  }
+  return ExprAttributes(inputs[0].qtype());
+}
+
+}  // namespace
+
+absl::StatusOr<ExprNodePtr> MakeWhileLoop(NamedExpressions initial_state,
+                                          ExprNodePtr condition,
+                                          NamedExpressions body) {
+  return MakeWhileLoopImpl(
+      std::move(initial_state), std::move(condition), std::move(body),
+      [](const ExprOperatorSignature& signature,
+         const ExprOperatorPtr& condition,
+         const ExprOperatorPtr& body) -> absl::StatusOr<ExprOperatorPtr> {
+        return WhileLoopOperator::Make(signature, condition, body);
+      });
+}
+
+absl::StatusOr<ExprNodePtr> MakeBatchedWhileLoop(NamedExpressions initial_state,
+                                                 ExprNodePtr condition,
+                                                 NamedExpressions body) {
+  return MakeWhileLoopImpl(
+      std::move(initial_state), std::move(condition), std::move(body),
+      [](const ExprOperatorSignature& signature,
+         const ExprOperatorPtr& condition,
+         const ExprOperatorPtr& body) -> absl::StatusOr<ExprOperatorPtr> {
+        return BatchedWhileLoopOperator::Make(signature, condition, body);
+      });
+}
+
+absl::StatusOr<std::shared_ptr<WhileLoopOperator>> WhileLoopOperator::Make(
+    const ExprOperatorSignature& signature, const ExprOperatorPtr& condition,
+    const ExprOperatorPtr& body) {
+  return Make(kDefaultOperatorName, signature, condition, body);
+}
+
+absl::StatusOr<std::shared_ptr<WhileLoopOperator>> WhileLoopOperator::Make(
+    absl::string_view name, const ExprOperatorSignature& signature,
+    const ExprOperatorPtr& condition, const ExprOperatorPtr& body) {
+  RETURN_IF_ERROR(ValidateLoopSignatures(signature, condition, body));
   return std::make_shared<WhileLoopOperator>(PrivateConstrutorTag(), name,
                                              signature, condition, body);
 }
@@ -317,33 +415,64 @@ absl::StatusOr<ExprAttributes> WhileLoopOperator::InferAttributes(
   if (!inputs[0].qtype()) {
     return ExprAttributes{};
   }
-  // Clean up literal values for mutable state as it is going to change on every
-  // iteration.
-  std::vector<ExprAttributes> new_inputs;
-  new_inputs.reserve(inputs.size());
-  new_inputs.emplace_back(inputs[0].qtype());
-  new_inputs.insert(new_inputs.end(), inputs.begin() + 1, inputs.end());
-  ASSIGN_OR_RETURN(
-      auto condition_attr, condition_->InferAttributes(new_inputs),
-      _ << "in condition of `" << display_name() << "` while loop");
-  if (condition_attr.qtype() &&
-      condition_attr.qtype() != GetQType<OptionalUnit>()) {
-    return absl::FailedPreconditionError(absl::StrFormat(
-        "incorrect return type of the condition of `%s` while loop for input "
-        "types %s: expected %s, got %s",
-        display_name(), FormatTypeVector(GetAttrQTypes(inputs)),
-        GetQType<OptionalUnit>()->name(), condition_attr.qtype()->name()));
+  return InferLoopAttributes(display_name(), condition_, body_,
+                             GetQType<OptionalUnit>(), inputs);
+}
+
+absl::StatusOr<std::shared_ptr<BatchedWhileLoopOperator>>
+BatchedWhileLoopOperator::Make(const ExprOperatorSignature& signature,
+                               const ExprOperatorPtr& condition,
+                               const ExprOperatorPtr& body) {
+  return Make(kDefaultBatchedOperatorName, signature, condition, body);
+}
+
+absl::StatusOr<std::shared_ptr<BatchedWhileLoopOperator>>
+BatchedWhileLoopOperator::Make(absl::string_view name,
+                               const ExprOperatorSignature& signature,
+                               const ExprOperatorPtr& condition,
+                               const ExprOperatorPtr& body) {
+  RETURN_IF_ERROR(ValidateLoopSignatures(signature, condition, body));
+  return std::make_shared<BatchedWhileLoopOperator>(
+      PrivateConstrutorTag(), name, signature, condition, body);
+}
+
+BatchedWhileLoopOperator::BatchedWhileLoopOperator(
+    PrivateConstrutorTag, absl::string_view name,
+    const ExprOperatorSignature& signature, const ExprOperatorPtr& condition,
+    const ExprOperatorPtr& body)
+    : ExprOperatorWithFixedSignature(
+          name, signature,
+          "",  // TODO: doc-string
+          FingerprintHasher("arolla::expr_operators::BatchedWhileLoopOperator")
+              .Combine(name, condition->fingerprint(), body->fingerprint())
+              .Finish()),
+      condition_(condition),
+      body_(body) {}
+
+absl::StatusOr<ExprAttributes> BatchedWhileLoopOperator::InferAttributes(
+    absl::Span<const ExprAttributes> inputs) const {
+  RETURN_IF_ERROR(ValidateOpInputsCount(inputs));
+  DCHECK_GE(inputs.size(), 1);
+  if (!inputs[0].qtype()) {
+    return ExprAttributes{};
   }
-  ASSIGN_OR_RETURN(auto body_attr, body_->InferAttributes(new_inputs),
-                   _ << "in body of `" << display_name() << "` while loop");
-  if (body_attr.qtype() && body_attr.qtype() != inputs[0].qtype()) {
-    return absl::FailedPreconditionError(absl::StrFormat(
-        "incorrect return type of the body of `%s` while loop for input types "
-        "%s: expected %s, got %s",
-        display_name(), FormatTypeVector(GetAttrQTypes(inputs)),
-        inputs[0].qtype()->name(), body_attr.qtype()->name()));
+  const auto& state_fields = inputs[0].qtype()->type_fields();
+  if (state_fields.empty()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "`%s` batched while loop must have at least one mutable state "
+        "variable",
+        display_name()));
   }
-  return ExprAttributes(inputs[0].qtype());
+  for (const auto& field : state_fields) {
+    if (!IsArrayQType(field.GetType())) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "mutable state variables of `%s` batched while loop must be "
+          "arrays, got %s",
+          display_name(), inputs[0].qtype()->name()));
+    }
+  }
+  return InferLoopAttributes(display_name(), condition_, body_,
+                             GetArrayQType<Unit>(), inputs);
 }
 
 }  // namespace arolla::expr_operators
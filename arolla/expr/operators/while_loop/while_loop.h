@@ -65,6 +65,30 @@ absl::StatusOr<expr::ExprNodePtr> MakeWhileLoop(NamedExpressions initial_state,
                                                 expr::ExprNodePtr condition,
                                                 NamedExpressions body);
 
+// Constructs an expression that runs the loop independently for each row of
+// the given Arrays.
+//
+// The arguments are the same as in MakeWhileLoop, but the mutable state
+// variables (keys in body map) must be Arrays of the same size, and the
+// condition must return ARRAY_UNIT. A row stays in the loop while the
+// condition is present for it. Each iteration evaluates the condition and the
+// body only on the rows that are still in the loop, and the loop finishes
+// when no rows remain.
+//
+// The expressions must be pointwise: the value of each row can depend only on
+// the same row of the Array arguments (but may depend on scalars).
+//
+// Usage example (computes GCD of L.a and L.b, both ARRAY_INT64):
+//
+//   gcd = MakeBatchedWhileLoop(
+//       initial_state={{"x", L.a}, {"y", L.b}},
+//       condition=P.y != 0,  // ARRAY_UNIT
+//       body={{"x", P.y}, {"y", P.x % P.y}})['x']
+//
+absl::StatusOr<expr::ExprNodePtr> MakeBatchedWhileLoop(
+    NamedExpressions initial_state, expr::ExprNodePtr condition,
+    NamedExpressions body);
+
 // While loop Expr operator.
 //
 // NOTE: Consider using MakeWhileLoop instead. It provides essential syntactic
@@ -116,6 +140,55 @@ class WhileLoopOperator final : public expr::BuiltinExprOperatorTag,
   expr::ExprOperatorPtr body_;
 };
 
+// Row-wise while loop Expr operator over Arrays.
+//
+// NOTE: Consider using MakeBatchedWhileLoop instead. It provides essential
+// syntactic sugar.
+//
+// Same as WhileLoopOperator, but the first argument must be a tuple of Arrays
+// of the same size, and the condition must return ARRAY_UNIT. The loop is
+// executed independently for each row, so the result contains (for each row)
+// the state after the first iteration for which the condition was missing.
+//
+class BatchedWhileLoopOperator final
+    : public expr::BuiltinExprOperatorTag,
+      public expr::ExprOperatorWithFixedSignature {
+  struct PrivateConstrutorTag {};
+
+ public:
+  // Creates a batched loop operator with the given signature, condition, body
+  // and (optional) operator name. The requirements are the same as in
+  // WhileLoopOperator::Make.
+  static absl::StatusOr<std::shared_ptr<BatchedWhileLoopOperator>> Make(
+      const expr::ExprOperatorSignature& signature,
+      const expr::ExprOperatorPtr& condition,
+      const expr::ExprOperatorPtr& body);
+  static absl::StatusOr<std::shared_ptr<BatchedWhileLoopOperator>> Make(
+      absl::string_view name, const expr::ExprOperatorSignature& signature,
+      const expr::ExprOperatorPtr& condition,
+      const expr::ExprOperatorPtr& body);
+
+  // Private constructor, use Make() instead.
+  BatchedWhileLoopOperator(PrivateConstrutorTag, absl::string_view name,
+                           const expr::ExprOperatorSignature& signature,
+                           const expr::ExprOperatorPtr& condition,
+                           const expr::ExprOperatorPtr& body);
+
+  absl::StatusOr<expr::ExprAttributes> InferAttributes(
+      absl::Span<const expr::ExprAttributes> inputs) const final;
+
+  const expr::ExprOperatorPtr& condition() const { return condition_; }
+  const expr::ExprOperatorPtr& body() const { return body_; }
+
+  absl::string_view py_qvalue_specialization_key() const final {
+    return "::arolla::expr_operators::BatchedWhileLoopOperator";
+  }
+
+ private:
+  expr::ExprOperatorPtr condition_;
+  expr::ExprOperatorPtr body_;
+};
+
 }  // namespace arolla::expr_operators
 
 #endif  // AROLLA_EXPR_OPERATORS_WHILE_LOOP_WHILE_LOOP_H_
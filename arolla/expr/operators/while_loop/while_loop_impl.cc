@@ -20,6 +20,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
@@ -38,7 +39,8 @@ using ::arolla::expr::Placeholder;
 
 absl::StatusOr<std::pair<ExprNodePtr, NamedExpressions>> ExtractImmutables(
     const ExprNodePtr& expr, std::function<std::string(const ExprNodePtr& node)>
-                                 immutable_naming_function) {
+                                 immutable_naming_function,
+    const absl::flat_hash_set<std::string>& invariant_placeholders) {
   NamedExpressions immutables;
   struct Visit {
     ExprNodePtr expr;
@@ -51,6 +53,12 @@ absl::StatusOr<std::pair<ExprNodePtr, NamedExpressions>> ExtractImmutables(
           expr,
           [&](const ExprNodePtr& node,
               absl::Span<const Visit* const> visits) -> absl::StatusOr<Visit> {
+            if (node->is_placeholder() &&
+                invariant_placeholders.contains(node->placeholder_key())) {
+              return Visit{.expr = node,
+                           .has_placeholder_dep = false,
+                           .has_leaf_dep = true};
+            }
             if (node->is_placeholder()) {
               return Visit{.expr = node,
                            .has_placeholder_dep = true,
@@ -77,7 +85,8 @@ absl::StatusOr<std::pair<ExprNodePtr, NamedExpressions>> ExtractImmutables(
             std::vector<ExprNodePtr> new_deps;
             new_deps.reserve(visits.size());
             for (const auto& visit : visits) {
-              if (visit->has_placeholder_dep || !visit->has_leaf_dep) {
+              if (visit->has_placeholder_dep || !visit->has_leaf_dep ||
+                  visit->expr->is_placeholder()) {
                 new_deps.push_back(visit->expr);
               } else {
                 auto placeholder_key = immutable_naming_function(visit->expr);
@@ -92,7 +101,7 @@ absl::StatusOr<std::pair<ExprNodePtr, NamedExpressions>> ExtractImmutables(
                          .has_leaf_dep = has_leaf_dep};
           }));
 
-  if (!has_placeholder_dep) {
+  if (!has_placeholder_dep && !converted_expr->is_placeholder()) {
     // If the expression root itself is immutable, no immutables should have
     // been extracted from it.
     DCHECK(immutables.empty());
@@ -22,6 +22,7 @@
 #include <string>
 #include <utility>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/operators/while_loop/while_loop.h"
@@ -32,10 +33,18 @@ namespace arolla::expr_operators::while_loop_impl {
 // immutable in the while_loop context). The subexpressions are replaced with
 // placeholders named using naming_function. The mapping from the placeholder
 // name to the immutable subexpression is returned as a second result.
+//
+// Placeholders listed in `invariant_placeholders` refer to the state variables
+// that are never updated by the loop body. They are treated as immutable, so
+// the subexpressions depending only on them (and on leaves) are extracted too.
+// The extracted subexpressions keep referring to such placeholders, it is
+// the caller's responsibility to substitute them. A standalone placeholder is
+// never extracted.
 absl::StatusOr<std::pair<expr::ExprNodePtr, NamedExpressions>>
 ExtractImmutables(
     const expr::ExprNodePtr& expr,
-    std::function<std::string(const expr::ExprNodePtr& node)> naming_function);
+    std::function<std::string(const expr::ExprNodePtr& node)> naming_function,
+    const absl::flat_hash_set<std::string>& invariant_placeholders = {});
 
 }  // namespace arolla::expr_operators::while_loop_impl
 
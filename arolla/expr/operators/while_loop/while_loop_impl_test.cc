@@ -160,5 +160,50 @@ TEST_F(WhileLoopImplTest, ExtractImmutables) {
   }
 }
 
+TEST_F(WhileLoopImplTest, ExtractImmutablesWithInvariantPlaceholders) {
+  auto immutable_naming_function = [](const ExprNodePtr& node) -> std::string {
+    return absl::StrFormat("_immutable_%s", node->fingerprint().AsString());
+  };
+  {
+    // Standalone invariant placeholders are not extracted.
+    auto expr = Placeholder("a");
+    EXPECT_THAT(ExtractImmutables(expr, immutable_naming_function, {"a"}),
+                IsOkAndHolds(Pair(EqualsExpr(expr), IsEmpty())));
+  }
+  {
+    // Subexpressions depending on invariant placeholders are extracted.
+    ASSERT_OK_AND_ASSIGN(auto invariant,
+                         CallOp("math.multiply",
+                                {Placeholder("a"), Literal<int64_t>(2)}));
+    ASSERT_OK_AND_ASSIGN(auto expr,
+                         CallOp("math.add", {Placeholder("x"), invariant}));
+    auto name = immutable_naming_function(invariant);
+    EXPECT_THAT(
+        ExtractImmutables(expr, immutable_naming_function, {"a"}),
+        IsOkAndHolds(Pair(
+            EqualsExpr(CallOp("math.add",
+                              {Placeholder("x"), Placeholder(name)})),
+            UnorderedElementsAre(Pair(name, EqualsExpr(invariant))))));
+    // Without the hint the expression is kept.
+    EXPECT_THAT(ExtractImmutables(expr, immutable_naming_function),
+                IsOkAndHolds(Pair(EqualsExpr(expr), IsEmpty())));
+  }
+  {
+    // Invariant subexpressions may depend on leaves too.
+    ASSERT_OK_AND_ASSIGN(
+        auto invariant,
+        CallOp("math.add", {Placeholder("a"), Leaf("b")}));
+    ASSERT_OK_AND_ASSIGN(auto expr,
+                         CallOp("math.add", {invariant, Placeholder("x")}));
+    auto name = immutable_naming_function(invariant);
+    EXPECT_THAT(
+        ExtractImmutables(expr, immutable_naming_function, {"a"}),
+        IsOkAndHolds(Pair(
+            EqualsExpr(CallOp("math.add",
+                              {Placeholder(name), Placeholder("x")})),
+            UnorderedElementsAre(Pair(name, EqualsExpr(invariant))))));
+  }
+}
+
 }  // namespace
 }  // namespace arolla::expr_operators::while_loop_impl
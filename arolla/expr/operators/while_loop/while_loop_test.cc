@@ -19,6 +19,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "arolla/array/qtype/types.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_attributes.h"
 #include "arolla/expr/expr_node.h"
@@ -52,6 +53,7 @@ using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::HasSubstr;
 using ::testing::NotNull;
+using ::testing::SizeIs;
 using Attr = ::arolla::expr::ExprAttributes;
 
 class WhileLoopTest : public ::testing::Test {
@@ -134,6 +136,31 @@ TEST_F(WhileLoopTest, WhileLoopOperatorWrongBody) {
                          "(INT64): expected INT64, got FLOAT64")));
 }
 
+TEST_F(WhileLoopTest, BatchedWhileLoopOperatorMake) {
+  ASSERT_OK_AND_ASSIGN(auto body, MakeLambdaOperator(Placeholder("param")));
+  ASSERT_OK_AND_ASSIGN(
+      auto condition,
+      MakeLambdaOperator(CallOp(
+          "core.equal", {CallOp("core.get_nth",
+                                {Placeholder("param"), Literal<int64_t>(0)}),
+                         Literal<int64_t>(0)})));
+  ASSERT_OK_AND_ASSIGN(auto loop_operator,
+                       BatchedWhileLoopOperator::Make(
+                           condition->GetSignature().value(), condition, body));
+  EXPECT_THAT(loop_operator->display_name(),
+              Eq("anonymous.batched_while_loop"));
+  auto array_state_qtype = MakeTupleQType({GetArrayQType<int64_t>()});
+  EXPECT_THAT(loop_operator->InferAttributes({Attr(array_state_qtype)}),
+              IsOkAndHolds(EqualsAttr(array_state_qtype)));
+  EXPECT_THAT(
+      loop_operator->InferAttributes(
+          {Attr(MakeTupleQType({GetQType<int64_t>()}))}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("mutable state variables of "
+                         "`anonymous.batched_while_loop` batched while loop "
+                         "must be arrays")));
+}
+
 TEST_F(WhileLoopTest, MakeWhileLoop) {
   auto init_x = Leaf("x");
   auto init_y = Leaf("y");
@@ -212,6 +239,58 @@ TEST_F(WhileLoopTest, MakeWhileLoop) {
                                  "while loop")));
 }
 
+TEST_F(WhileLoopTest, MakeWhileLoopHoistsInvariants) {
+  ASSERT_OK_AND_ASSIGN(
+      auto limit,
+      CallOp("math.multiply", {Placeholder("a"), Literal<int64_t>(10)}));
+  ASSERT_OK_AND_ASSIGN(auto loop_condition,
+                       CallOp("core.less", {Placeholder("x"), limit}));
+  ASSERT_OK_AND_ASSIGN(
+      auto step,
+      CallOp("math.multiply", {Placeholder("a"), Literal<int64_t>(2)}));
+  ASSERT_OK_AND_ASSIGN(auto new_x,
+                       CallOp("math.add", {Placeholder("x"), step}));
+  ASSERT_OK_AND_ASSIGN(
+      ExprNodePtr while_loop,
+      MakeWhileLoop({{"x", Leaf("x")}, {"a", Leaf("a")}}, loop_condition,
+                    {{"x", new_x}}));
+
+  // The invariant subexpressions are computed before the loop, with the
+  // immutable state variable replaced by its initial value.
+  ASSERT_THAT(while_loop->node_deps(), SizeIs(4));
+  EXPECT_THAT(while_loop->node_deps()[1],
+              EqualsExpr(CallOp("math.multiply",
+                                {Leaf("a"), Literal<int64_t>(2)})));
+  EXPECT_THAT(while_loop->node_deps()[2],
+              EqualsExpr(CallOp("math.multiply",
+                                {Leaf("a"), Literal<int64_t>(10)})));
+  EXPECT_THAT(while_loop->node_deps()[3], EqualsExpr(Leaf("a")));
+
+  auto while_loop_op =
+      dynamic_cast<const WhileLoopOperator*>(while_loop->op().get());
+  ASSERT_THAT(while_loop_op, NotNull());
+  ASSERT_OK_AND_ASSIGN(
+      auto state_field_0,
+      CallOp("core.get_nth", {Placeholder("loop_state"), Literal<int64_t>(0)}));
+  auto condition_op =
+      dynamic_cast<const LambdaOperator*>(while_loop_op->condition().get());
+  ASSERT_THAT(condition_op, NotNull());
+  EXPECT_THAT(condition_op->lambda_body(),
+              EqualsExpr(CallOp("core.less",
+                                {state_field_0,
+                                 Placeholder("_while_loop_immutable_1")})));
+  auto body_op =
+      dynamic_cast<const LambdaOperator*>(while_loop_op->body().get());
+  ASSERT_THAT(body_op, NotNull());
+  EXPECT_THAT(
+      body_op->lambda_body(),
+      EqualsExpr(CallOp(
+          "namedtuple.make",
+          {Literal(Text("x")),
+           CallOp("math.add",
+                  {state_field_0, Placeholder("_while_loop_immutable_0")})})));
+}
+
 TEST_F(WhileLoopTest, MakeWhileLoopErrors) {
   auto leaf_x = Leaf("x");
 
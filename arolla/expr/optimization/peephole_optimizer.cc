@@ -113,6 +113,8 @@ class PatternOptimization : public PeepholeOptimization {
     return data_.key;
   }
 
+  const ExprNodePtr& from() const { return data_.from; }
+
   absl::StatusOr<ExprNodePtr> ApplyToRoot(
       const ExprNodePtr& root) const override {
     // maps Fingerprint in `from` optimization to the corresponded node in
@@ -328,9 +330,59 @@ PeepholeOptimization::CreateTransformOptimization(
   return std::make_unique<TransformOptimization>(std::move(transform_fn));
 }
 
+namespace {
+
+// Pattern optimization with the precomputed keys of the pattern children,
+// used to skip the candidates that surely do not match before calling the
+// (relatively expensive) ApplyToRoot.
+struct IndexedOptimization {
+  std::unique_ptr<PeepholeOptimization> optimization;
+  // Number of the pattern root deps, or -1 if the pattern is unknown.
+  int64_t arity = -1;
+  // PatternKeys of the pattern root deps, nullopt for placeholders.
+  std::vector<std::optional<PeepholeOptimization::PatternKey>> dep_keys;
+
+  bool MayMatch(absl::Span<const PeepholeOptimization::PatternKey>
+                    node_dep_keys) const {
+    if (arity < 0) {
+      return true;
+    }
+    if (node_dep_keys.size() != arity) {
+      return false;
+    }
+    for (int64_t i = 0; i < arity; ++i) {
+      if (dep_keys[i].has_value() && *dep_keys[i] != node_dep_keys[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+// Pattern optimizations with the same PatternKey of the root, in the original
+// order, indexed by the key of the first dep.
+struct OptimizationGroup {
+  std::vector<IndexedOptimization> optimizations;
+  // Indices in `optimizations` of the patterns with the given first dep key.
+  absl::flat_hash_map<PeepholeOptimization::PatternKey, std::vector<int64_t>>
+      by_first_dep;
+  // Indices in `optimizations` of the patterns that can match any first dep.
+  std::vector<int64_t> any_first_dep;
+};
+
+std::vector<PeepholeOptimization::PatternKey> DepKeys(const ExprNodePtr& node) {
+  std::vector<PeepholeOptimization::PatternKey> keys;
+  keys.reserve(node->node_deps().size());
+  for (const auto& dep : node->node_deps()) {
+    keys.emplace_back(dep);
+  }
+  return keys;
+}
+
+}  // namespace
+
 struct PeepholeOptimizer::Data {
-  absl::flat_hash_map<PeepholeOptimization::PatternKey,
-                      std::vector<std::unique_ptr<PeepholeOptimization>>>
+  absl::flat_hash_map<PeepholeOptimization::PatternKey, OptimizationGroup>
       pattern_optimizations;
   std::vector<std::unique_ptr<PeepholeOptimization>> transform_optimizations;
 };
@@ -341,8 +393,50 @@ absl::StatusOr<ExprNodePtr> PeepholeOptimizer::ApplyToNode(
   PeepholeOptimization::PatternKey key(node);
   if (auto it = pattern_optimizations.find(key);
       it != pattern_optimizations.end()) {
-    for (const auto& optimization : it->second) {
-      ASSIGN_OR_RETURN(node, optimization->ApplyToRoot(node));
+    const OptimizationGroup& group = it->second;
+    const std::vector<int64_t> no_candidates;
+    std::vector<PeepholeOptimization::PatternKey> dep_keys;
+    const std::vector<int64_t>* first_dep_candidates = nullptr;
+    auto update_node_keys = [&] {
+      dep_keys = DepKeys(node);
+      first_dep_candidates = &no_candidates;
+      if (!dep_keys.empty()) {
+        if (auto dep_it = group.by_first_dep.find(dep_keys[0]);
+            dep_it != group.by_first_dep.end()) {
+          first_dep_candidates = &dep_it->second;
+        }
+      }
+    };
+    update_node_keys();
+    // Merge the two sorted candidate lists to apply the optimizations in the
+    // original order.
+    const std::vector<int64_t>& any_candidates = group.any_first_dep;
+    size_t a = 0;
+    size_t b = 0;
+    while (a < first_dep_candidates->size() || b < any_candidates.size()) {
+      int64_t i;
+      if (b == any_candidates.size() ||
+          (a < first_dep_candidates->size() &&
+           (*first_dep_candidates)[a] < any_candidates[b])) {
+        i = (*first_dep_candidates)[a++];
+      } else {
+        i = any_candidates[b++];
+      }
+      const IndexedOptimization& optimization = group.optimizations[i];
+      if (!optimization.MayMatch(dep_keys)) {
+        continue;
+      }
+      ASSIGN_OR_RETURN(ExprNodePtr new_node,
+                       optimization.optimization->ApplyToRoot(node));
+      if (new_node->fingerprint() != node->fingerprint()) {
+        // Like before the indexing, the rest of the group is still tried on
+        // the new node, so we refresh the candidates.
+        node = std::move(new_node);
+        update_node_keys();
+        a = std::upper_bound(first_dep_candidates->begin(),
+                             first_dep_candidates->end(), i) -
+            first_dep_candidates->begin();
+      }
     }
   }
   for (const auto& optimization : data_->transform_optimizations) {
@@ -367,12 +461,33 @@ absl::StatusOr<std::unique_ptr<PeepholeOptimizer>> PeepholeOptimizer::Create(
   auto data = std::make_unique<Data>();
   for (auto& opt : optimizations) {
     std::optional<PeepholeOptimization::PatternKey> key = opt->GetKey();
-    if (key.has_value()) {
-      auto& opt_list = data->pattern_optimizations[*key];
-      opt_list.push_back(std::move(opt));
-    } else {
+    if (!key.has_value()) {
       data->transform_optimizations.push_back(std::move(opt));
+      continue;
+    }
+    OptimizationGroup& group = data->pattern_optimizations[*key];
+    IndexedOptimization indexed{.optimization = std::move(opt)};
+    if (const auto* pattern_optimization =
+            dynamic_cast<const PatternOptimization*>(
+                indexed.optimization.get());
+        pattern_optimization != nullptr &&
+        pattern_optimization->from()->is_op()) {
+      const auto& from_deps = pattern_optimization->from()->node_deps();
+      indexed.arity = from_deps.size();
+      for (const auto& dep : from_deps) {
+        indexed.dep_keys.push_back(
+            dep->is_placeholder()
+                ? std::nullopt
+                : std::make_optional(PeepholeOptimization::PatternKey(dep)));
+      }
+    }
+    int64_t index = group.optimizations.size();
+    if (!indexed.dep_keys.empty() && indexed.dep_keys[0].has_value()) {
+      group.by_first_dep[*indexed.dep_keys[0]].push_back(index);
+    } else {
+      group.any_first_dep.push_back(index);
     }
+    group.optimizations.push_back(std::move(indexed));
   }
   return absl::WrapUnique(new PeepholeOptimizer(std::move(data)));
 }
@@ -159,6 +159,10 @@ class PeepholeOptimizer {
   // several times while expression keep changing.
   absl::StatusOr<ExprNodePtr> Apply(ExprNodePtr root) const;
 
+  // Applies optimizations to the root of the expression. The pattern
+  // optimizations are indexed by the PatternKeys of the pattern root and its
+  // children, so only the ones that can match the node are tried, in the
+  // order they were passed to Create.
   absl::StatusOr<ExprNodePtr> ApplyToNode(ExprNodePtr node) const;
 
   static absl::StatusOr<std::unique_ptr<PeepholeOptimizer>> Create(
@@ -496,6 +496,71 @@ TEST_F(Optimization, TwoOptimizations) {
               IsOkAndHolds(EqualsExpr(expected_cubic_square2_optimized)));
 }
 
+TEST_F(Optimization, OptimizationsWithSameRoot) {
+  // All the optimizations have math.add root, and are dispatched by the
+  // children.
+  ExprNodePtr a = Placeholder("a");
+  ExprNodePtr b = Placeholder("b");
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr a_plus_0,
+                       CallOpReference("math.add", {a, Literal(0.f)}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr zero_plus_a,
+                       CallOpReference("math.add", {Literal(0.f), a}));
+  ASSERT_OK_AND_ASSIGN(
+      ExprNodePtr a_mul_b_plus_a,
+      CallOpReference("math.add",
+                      {CallOpReference("math.multiply", {a, b}), a}));
+  ASSERT_OK_AND_ASSIGN(
+      ExprNodePtr a_mul_b_plus_1,
+      CallOpReference("math.multiply",
+                      {a, CallOpReference("math.add", {b, Literal(1.f)})}));
+  PeepholeOptimizationPack optimizations;
+  ASSERT_OK_AND_ASSIGN(
+      optimizations.emplace_back(),
+      PeepholeOptimization::CreatePatternOptimization(a_plus_0, a));
+  ASSERT_OK_AND_ASSIGN(
+      optimizations.emplace_back(),
+      PeepholeOptimization::CreatePatternOptimization(zero_plus_a, a));
+  ASSERT_OK_AND_ASSIGN(optimizations.emplace_back(),
+                       PeepholeOptimization::CreatePatternOptimization(
+                           a_mul_b_plus_a, a_mul_b_plus_1));
+  ASSERT_OK_AND_ASSIGN(auto optimizer,
+                       PeepholeOptimizer::Create(std::move(optimizations)));
+
+  ExprNodePtr x = Leaf("x");
+  ExprNodePtr y = Leaf("y");
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr x_plus_0,
+                       CallOp("math.add", {x, Literal(0.f)}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr zero_plus_x,
+                       CallOp("math.add", {Literal(0.f), x}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr one_plus_x,
+                       CallOp("math.add", {Literal(1.f), x}));
+  EXPECT_THAT(optimizer->ApplyToNode(x_plus_0), IsOkAndHolds(EqualsExpr(x)));
+  EXPECT_THAT(optimizer->ApplyToNode(zero_plus_x),
+              IsOkAndHolds(EqualsExpr(x)));
+  EXPECT_THAT(optimizer->ApplyToNode(one_plus_x),
+              IsOkAndHolds(EqualsExpr(one_plus_x)));
+
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr x_mul_y, CallOp("math.multiply", {x, y}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr x_mul_y_plus_y,
+                       CallOp("math.add", {x_mul_y, y}));
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr x_mul_y_plus_x,
+                       CallOp("math.add", {x_mul_y, x}));
+  ASSERT_OK_AND_ASSIGN(
+      ExprNodePtr x_mul_y_plus_1,
+      CallOp("math.multiply", {x, CallOp("math.add", {y, Literal(1.f)})}));
+  EXPECT_THAT(optimizer->ApplyToNode(x_mul_y_plus_y),
+              IsOkAndHolds(EqualsExpr(x_mul_y_plus_y)));
+  EXPECT_THAT(optimizer->ApplyToNode(x_mul_y_plus_x),
+              IsOkAndHolds(EqualsExpr(x_mul_y_plus_1)));
+
+  // The first optimization produces `0 + x`, and the second one is applied to
+  // the result.
+  ASSERT_OK_AND_ASSIGN(ExprNodePtr zero_plus_x_plus_0,
+                       CallOp("math.add", {zero_plus_x, Literal(0.f)}));
+  EXPECT_THAT(optimizer->ApplyToNode(zero_plus_x_plus_0),
+              IsOkAndHolds(EqualsExpr(x)));
+}
+
 // Returns transformation converting `a + b` and `a * b` to `a`.
 absl::StatusOr<std::unique_ptr<PeepholeOptimization>>
 RemoveArithmeticOptimization() {
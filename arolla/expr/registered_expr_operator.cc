@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/call_once.h"
 #include "absl/base/optimization.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -115,6 +116,61 @@ thread_local int CircularDependencyDetector::thread_local_depth_ = 0;
 thread_local absl::flat_hash_set<Fingerprint>
     CircularDependencyDetector::thread_local_visited_;
 
+// A stub stored in the registry instead of the implementation of a lazily
+// registered operator. RegisteredOperator::GetImplementation() replaces it
+// with the result of the loader.
+class LazyOperatorStub final : public ExprOperator {
+ public:
+  LazyOperatorStub(absl::string_view name,
+                   ExprOperatorRegistry::OperatorLoaderFn loader)
+      : ExprOperator(name, FingerprintHasher("arolla::expr::LazyOperatorStub")
+                               .Combine(name)
+                               .Finish()),
+        loader_(std::move(loader)) {}
+
+  // Returns the result of the loader, calls it only once.
+  absl::StatusOr<ExprOperatorPtr> Load() const {
+    absl::call_once(once_, [this] {
+      result_ = loader_();
+      if (result_.ok() && *result_ == nullptr) {
+        result_ = absl::InvalidArgumentError(absl::StrFormat(
+            "operator loader returned nullptr: op_name=%s", display_name()));
+      }
+      loader_ = nullptr;
+    });
+    return result_;
+  }
+
+  // The stub is never returned by RegisteredOperator::GetImplementation(), the
+  // methods are for completeness only.
+  absl::StatusOr<ExprOperatorSignature> GetSignature() const final {
+    ASSIGN_OR_RETURN(auto op_impl, Load());
+    return op_impl->GetSignature();
+  }
+
+  absl::StatusOr<std::string> GetDoc() const final {
+    ASSIGN_OR_RETURN(auto op_impl, Load());
+    return op_impl->GetDoc();
+  }
+
+  absl::StatusOr<ExprAttributes> InferAttributes(
+      absl::Span<const ExprAttributes> inputs) const final {
+    ASSIGN_OR_RETURN(auto op_impl, Load());
+    return op_impl->InferAttributes(inputs);
+  }
+
+  absl::StatusOr<ExprNodePtr> ToLowerLevel(
+      const ExprNodePtr& node) const final {
+    ASSIGN_OR_RETURN(auto op_impl, Load());
+    return op_impl->ToLowerLevel(node);
+  }
+
+ private:
+  mutable absl::once_flag once_;
+  mutable ExprOperatorRegistry::OperatorLoaderFn loader_;
+  mutable absl::StatusOr<ExprOperatorPtr> result_;
+};
+
 }  // namespace
 
 absl::StatusOr<RegisteredOperatorPtr> LookupOperator(absl::string_view name) {
@@ -195,6 +251,11 @@ absl::StatusOr<ExprOperatorPtr> RegisteredOperator::GetImplementation() const {
     return absl::NotFoundError(absl::StrFormat("operator '%s' not found",
                                                absl::CEscape(display_name())));
   }
+  if (const auto* stub =
+          fast_dynamic_downcast_final<const LazyOperatorStub*>(result.get());
+      ABSL_PREDICT_FALSE(stub != nullptr)) {
+    return stub->Load();
+  }
   return result;
 }
 
@@ -281,6 +342,21 @@ absl::StatusOr<RegisteredOperatorPtr> ExprOperatorRegistry::Register(
   if (op_impl == nullptr) {
     return absl::InvalidArgumentError("op_impl=nullptr");
   }
+  return RegisterImplementation(name, std::move(op_impl));
+}
+
+absl::StatusOr<RegisteredOperatorPtr> ExprOperatorRegistry::RegisterLazily(
+    absl::string_view name, OperatorLoaderFn loader) {
+  if (loader == nullptr) {
+    return absl::InvalidArgumentError("loader=nullptr");
+  }
+  return RegisterImplementation(
+      name, std::make_shared<LazyOperatorStub>(name, std::move(loader)));
+}
+
+absl::StatusOr<RegisteredOperatorPtr>
+ExprOperatorRegistry::RegisterImplementation(absl::string_view name,
+                                             ExprOperatorPtr op_impl) {
   if (!IsOperatorName(name)) {
     return absl::InvalidArgumentError(absl::StrFormat(
         "attempt to register an operator with invalid name: '%s'",
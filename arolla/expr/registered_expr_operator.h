@@ -24,6 +24,7 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
@@ -94,6 +95,21 @@ class ExprOperatorRegistry final {
                                                  ExprOperatorPtr op_impl)
       ABSL_LOCKS_EXCLUDED(mx_);
 
+  // A function that creates the implementation of a lazily registered
+  // operator.
+  using OperatorLoaderFn =
+      absl::AnyInvocable<absl::StatusOr<ExprOperatorPtr>()>;
+
+  // Adds an operator to the registry without creating its implementation.
+  // `loader` is called once, when the implementation is requested for the
+  // first time (e.g. by RegisteredOperator::GetSignature()); the lookups by
+  // name do not trigger it. If the loader fails, the error is returned on
+  // every access to the implementation. The loader must not access the
+  // operator being loaded.
+  absl::StatusOr<RegisteredOperatorPtr> RegisterLazily(absl::string_view name,
+                                                       OperatorLoaderFn loader)
+      ABSL_LOCKS_EXCLUDED(mx_);
+
   // Returns registered operator instance, if the operator is present in
   // the registry, or nullptr.
   RegisteredOperatorPtr /*nullable*/ LookupOperatorOrNull(
@@ -156,6 +172,10 @@ class ExprOperatorRegistry final {
     ThreadSafeSharedPtr<const ExprOperator> operator_implementation;
   };
 
+  // Stores the implementation (or the lazy loading stub) of a new operator.
+  absl::StatusOr<RegisteredOperatorPtr> RegisterImplementation(
+      absl::string_view name, ExprOperatorPtr op_impl) ABSL_LOCKS_EXCLUDED(mx_);
+
   // Returns the singleton record for the given name.
   //
   // If the record does not exist, this method will create it and any missing
@@ -115,6 +115,64 @@ TEST_F(RegisteredOperatorTest, OpNullPtr) {
               StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST_F(RegisteredOperatorTest, RegisterLazily) {
+  ExprOperatorRegistry registry;
+  int loader_calls = 0;
+  ASSERT_OK_AND_ASSIGN(
+      auto reg_op,
+      registry.RegisterLazily("test.lazy_op", [&]() -> absl::StatusOr<
+                                                        ExprOperatorPtr> {
+        ++loader_calls;
+        return std::make_shared<DummyOp>(
+            "dummy_op", ExprOperatorSignature::MakeArgsN(2), "dummy_docstring");
+      }));
+  // The lookups by name do not load the operator.
+  EXPECT_THAT(registry.LookupOperatorOrNull("test.lazy_op"), NotNull());
+  EXPECT_THAT(registry.ListRegisteredOperators(), ElementsAre("test.lazy_op"));
+  EXPECT_EQ(loader_calls, 0);
+
+  ASSERT_OK_AND_ASSIGN(auto signature, reg_op->GetSignature());
+  EXPECT_EQ(signature.parameters.size(), 2);
+  EXPECT_THAT(reg_op->GetDoc(), IsOkAndHolds("dummy_docstring"));
+  ASSERT_OK_AND_ASSIGN(auto op_impl, reg_op->GetImplementation());
+  EXPECT_EQ(typeid(*op_impl), typeid(DummyOp));
+  EXPECT_EQ(loader_calls, 1);
+
+  EXPECT_THAT(
+      registry.RegisterLazily("test.lazy_op",
+                              []() -> absl::StatusOr<ExprOperatorPtr> {
+                                return nullptr;
+                              }),
+      StatusIs(absl::StatusCode::kAlreadyExists,
+               "operator 'test.lazy_op' already exists"));
+  EXPECT_THAT(registry.RegisterLazily("test.lazy_op_2", nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument, "loader=nullptr"));
+}
+
+TEST_F(RegisteredOperatorTest, RegisterLazily_Error) {
+  ExprOperatorRegistry registry;
+  ASSERT_OK_AND_ASSIGN(
+      auto failing_op,
+      registry.RegisterLazily(
+          "test.failing_op", []() -> absl::StatusOr<ExprOperatorPtr> {
+            return absl::InvalidArgumentError("unable to load");
+          }));
+  EXPECT_THAT(failing_op->GetSignature(),
+              StatusIs(absl::StatusCode::kInvalidArgument, "unable to load"));
+  EXPECT_THAT(DecayRegisteredOperator(failing_op),
+              StatusIs(absl::StatusCode::kInvalidArgument, "unable to load"));
+
+  ASSERT_OK_AND_ASSIGN(
+      auto null_op,
+      registry.RegisterLazily("test.null_op",
+                              []() -> absl::StatusOr<ExprOperatorPtr> {
+                                return nullptr;
+                              }));
+  EXPECT_THAT(null_op->GetImplementation(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("operator loader returned nullptr")));
+}
+
 TEST_F(RegisteredOperatorTest, RegistrationOrder) {
   ExprOperatorRegistry registry;
   ASSERT_OK_AND_ASSIGN(auto op, MakeLambdaOperator(Placeholder("x")));
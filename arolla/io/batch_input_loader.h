@@ -0,0 +1,145 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_IO_BATCH_INPUT_LOADER_H_
+#define AROLLA_IO_BATCH_INPUT_LOADER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/io/input_loader.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qtype/array_like/frame_iter.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+
+// InputLoader for a batch of inputs. For each input supported by
+// `scalar_loader` it loads a DenseArray with one element per input in the
+// batch. Inputs of type T and OptionalValue<T> are loaded as DenseArray<T>;
+// the inputs of other types are not supported.
+//
+// The scalar loader is invoked for each element of the batch on a small
+// buffer of scalar frames (see FrameIterator), and the loaded values are
+// copied into the arrays column by column. This replaces gathering the batch
+// into arrays by hand, and allows to evaluate an array model on the whole
+// batch instead of a scalar model on each of the elements.
+template <class T>
+class BatchInputLoader final : public InputLoader<absl::Span<const T>> {
+  using Input = absl::Span<const T>;
+
+ public:
+  static absl::StatusOr<InputLoaderPtr<Input>> Create(
+      InputLoaderPtr<T> scalar_loader) {
+    if (scalar_loader == nullptr) {
+      return absl::InvalidArgumentError("scalar_loader must not be null");
+    }
+    // Not using make_shared to avoid binary size blowup.
+    return InputLoaderPtr<Input>(static_cast<InputLoader<Input>*>(
+        new BatchInputLoader(std::move(scalar_loader))));
+  }
+
+  absl::Nullable<const QType*> GetQTypeOf(absl::string_view name) const final {
+    const QType* scalar_qtype = scalar_loader_->GetQTypeOf(name);
+    if (scalar_qtype == nullptr) {
+      return nullptr;
+    }
+    auto array_qtype =
+        GetDenseArrayQTypeByValueQType(DecayOptionalQType(scalar_qtype));
+    return array_qtype.ok() ? *array_qtype : nullptr;
+  }
+
+  std::vector<std::string> SuggestAvailableNames() const final {
+    std::vector<std::string> names;
+    for (auto& name : scalar_loader_->SuggestAvailableNames()) {
+      if (GetQTypeOf(name) != nullptr) {
+        names.push_back(std::move(name));
+      }
+    }
+    return names;
+  }
+
+ private:
+  explicit BatchInputLoader(InputLoaderPtr<T> scalar_loader)
+      : scalar_loader_(std::move(scalar_loader)) {}
+
+  absl::StatusOr<BoundInputLoader<Input>> BindImpl(
+      const absl::flat_hash_map<std::string, TypedSlot>& output_slots)
+      const final {
+    FrameLayout::Builder scalar_layout_builder;
+    absl::flat_hash_map<std::string, TypedSlot> scalar_slots;
+    std::vector<TypedSlot> scalar_slots_in_order;
+    std::vector<TypedSlot> array_slots_in_order;
+    scalar_slots.reserve(output_slots.size());
+    scalar_slots_in_order.reserve(output_slots.size());
+    array_slots_in_order.reserve(output_slots.size());
+    for (const auto& [name, array_slot] : output_slots) {
+      TypedSlot scalar_slot =
+          AddSlot(scalar_loader_->GetQTypeOf(name), &scalar_layout_builder);
+      scalar_slots.emplace(name, scalar_slot);
+      scalar_slots_in_order.push_back(scalar_slot);
+      array_slots_in_order.push_back(array_slot);
+    }
+    ASSIGN_OR_RETURN(BoundInputLoader<T> bound_scalar_loader,
+                     scalar_loader_->Bind(scalar_slots));
+    auto scalar_layout = std::make_shared<FrameLayout>(
+        std::move(scalar_layout_builder).Build());
+    return BoundInputLoader<Input>(
+        [bound_scalar_loader = std::move(bound_scalar_loader),
+         scalar_layout = std::move(scalar_layout),
+         scalar_slots = std::move(scalar_slots_in_order),
+         array_slots = std::move(array_slots_in_order)](
+            const Input& inputs, FramePtr frame,
+            RawBufferFactory* factory) -> absl::Status {
+          ASSIGN_OR_RETURN(
+              FrameIterator frame_iterator,
+              FrameIterator::Create(
+                  /*input_arrays=*/{}, /*input_scalar_slots=*/{}, array_slots,
+                  scalar_slots, scalar_layout.get(),
+                  {.row_count = static_cast<int64_t>(inputs.size()),
+                   .buffer_factory = factory}));
+          absl::Status status;
+          int64_t row_id = 0;
+          frame_iterator.ForEachFrame([&](FramePtr scalar_frame) {
+            if (status.ok()) {
+              status = bound_scalar_loader(inputs[row_id], scalar_frame,
+                                           factory);
+            }
+            ++row_id;
+          });
+          RETURN_IF_ERROR(status);
+          return frame_iterator.StoreOutput(frame);
+        });
+  }
+
+  InputLoaderPtr<T> scalar_loader_;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_IO_BATCH_INPUT_LOADER_H_
@@ -0,0 +1,135 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/io/batch_input_loader.h"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/io/accessors_input_loader.h"
+#include "arolla/io/input_loader.h"
+#include "arolla/io/testing/matchers.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::InputLoaderSupports;
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+struct TestStruct {
+  int32_t a;
+  OptionalValue<float> b;
+  Bytes c;
+  DenseArray<int64_t> d;
+};
+
+InputLoaderPtr<TestStruct> CreateScalarLoader() {
+  return CreateAccessorsInputLoader<TestStruct>(
+             "a", [](const TestStruct& s) { return s.a; },  //
+             "b", [](const TestStruct& s) { return s.b; },  //
+             "c", [](const TestStruct& s) { return s.c; },  //
+             "d", [](const TestStruct& s) { return s.d; })
+      .value();
+}
+
+TEST(BatchInputLoaderTest, Basic) {
+  ASSERT_OK_AND_ASSIGN(auto input_loader,
+                       BatchInputLoader<TestStruct>::Create(
+                           CreateScalarLoader()));
+  // Arrays are not supported as scalars, so "d" is not available.
+  EXPECT_THAT(input_loader,
+              InputLoaderSupports({{"a", GetDenseArrayQType<int32_t>()},
+                                   {"b", GetDenseArrayQType<float>()},
+                                   {"c", GetDenseArrayQType<Bytes>()}}));
+  EXPECT_EQ(input_loader->GetQTypeOf("d"), nullptr);
+
+  FrameLayout::Builder layout_builder;
+  auto a_slot = layout_builder.AddSlot<DenseArray<int32_t>>();
+  auto b_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto c_slot = layout_builder.AddSlot<DenseArray<Bytes>>();
+  ASSERT_OK_AND_ASSIGN(auto bound_input_loader,
+                       input_loader->Bind({
+                           {"a", TypedSlot::FromSlot(a_slot)},
+                           {"b", TypedSlot::FromSlot(b_slot)},
+                           {"c", TypedSlot::FromSlot(c_slot)},
+                       }));
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+
+  // More elements than FrameIterator keeps in its buffer.
+  std::vector<TestStruct> inputs;
+  for (int i = 0; i < 100; ++i) {
+    inputs.push_back({.a = i,
+                      .b = i % 2 == 0 ? OptionalValue<float>(0.5f * i)
+                                      : OptionalValue<float>(),
+                      .c = Bytes(i == 7 ? "seven" : "")});
+  }
+  MemoryAllocation alloc(&memory_layout);
+  ASSERT_OK(bound_input_loader(inputs, alloc.frame()));
+
+  const auto& a = alloc.frame().Get(a_slot);
+  const auto& b = alloc.frame().Get(b_slot);
+  const auto& c = alloc.frame().Get(c_slot);
+  ASSERT_EQ(a.size(), 100);
+  ASSERT_EQ(b.size(), 100);
+  ASSERT_EQ(c.size(), 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(a[i], i);
+    EXPECT_EQ(b[i], inputs[i].b);
+    EXPECT_EQ(c[i], inputs[i].c);
+  }
+
+  absl::Span<const TestStruct> inputs_span = inputs;
+  ASSERT_OK(bound_input_loader(inputs_span.subspan(5, 3), alloc.frame()));
+  EXPECT_THAT(alloc.frame().Get(a_slot), ElementsAre(5, 6, 7));
+  EXPECT_THAT(alloc.frame().Get(c_slot),
+              ElementsAre(Bytes(""), Bytes(""), Bytes("seven")));
+
+  ASSERT_OK(bound_input_loader({}, alloc.frame()));
+  EXPECT_EQ(alloc.frame().Get(a_slot).size(), 0);
+}
+
+TEST(BatchInputLoaderTest, Errors) {
+  EXPECT_THAT(BatchInputLoader<TestStruct>::Create(nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("scalar_loader must not be null")));
+
+  ASSERT_OK_AND_ASSIGN(auto input_loader,
+                       BatchInputLoader<TestStruct>::Create(
+                           CreateScalarLoader()));
+  FrameLayout::Builder layout_builder;
+  auto a_slot = layout_builder.AddSlot<int32_t>();
+  EXPECT_THAT(input_loader->Bind({{"a", TypedSlot::FromSlot(a_slot)}}),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       HasSubstr("slot types mismatch")));
+}
+
+}  // namespace
+}  // namespace arolla
@@ -0,0 +1,156 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_IO_BATCH_SLOT_LISTENER_H_
+#define AROLLA_IO_BATCH_SLOT_LISTENER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/io/slot_listener.h"
+#include "arolla/memory/frame.h"
+#include "arolla/qtype/array_like/frame_iter.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_ref.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+
+// SlotListener for a batch of outputs, the reverse of BatchInputLoader. For
+// each output supported by `scalar_listener` it accepts a DenseArray with one
+// element per output in the batch, and scatters the elements into the
+// corresponding outputs using `scalar_listener`.
+//
+// A scalar output of type OptionalValue<T> or T corresponds to DenseArray<T>.
+// Note that for the outputs of type T missing array elements are passed to
+// `scalar_listener` as T{}.
+//
+// All the listened arrays must have the same size as the output span.
+template <class T>
+class BatchSlotListener final : public SlotListener<absl::Span<T* const>> {
+  using Output = absl::Span<T* const>;
+
+ public:
+  static absl::StatusOr<std::unique_ptr<SlotListener<Output>>> Create(
+      std::unique_ptr<SlotListener<T>> scalar_listener) {
+    if (scalar_listener == nullptr) {
+      return absl::InvalidArgumentError("scalar_listener must not be null");
+    }
+    return std::unique_ptr<SlotListener<Output>>(
+        new BatchSlotListener(std::move(scalar_listener)));
+  }
+
+  absl::Nullable<const QType*> GetQTypeOf(
+      absl::string_view name,
+      absl::Nullable<const QType*> desired_qtype) const final {
+    const QType* desired_scalar_qtype = nullptr;
+    if (desired_qtype != nullptr && IsDenseArrayQType(desired_qtype)) {
+      auto optional_qtype = ToOptionalQType(desired_qtype->value_qtype());
+      desired_scalar_qtype = optional_qtype.ok() ? *optional_qtype : nullptr;
+    }
+    const QType* scalar_qtype =
+        scalar_listener_->GetQTypeOf(name, desired_scalar_qtype);
+    if (scalar_qtype == nullptr) {
+      return nullptr;
+    }
+    auto array_qtype =
+        GetDenseArrayQTypeByValueQType(DecayOptionalQType(scalar_qtype));
+    return array_qtype.ok() ? *array_qtype : nullptr;
+  }
+
+  std::vector<std::string> SuggestAvailableNames() const final {
+    return scalar_listener_->SuggestAvailableNames();
+  }
+
+ private:
+  explicit BatchSlotListener(std::unique_ptr<SlotListener<T>> scalar_listener)
+      : scalar_listener_(std::move(scalar_listener)) {}
+
+  absl::StatusOr<BoundSlotListener<Output>> BindImpl(
+      const absl::flat_hash_map<std::string, TypedSlot>& input_slots)
+      const final {
+    FrameLayout::Builder scalar_layout_builder;
+    absl::flat_hash_map<std::string, TypedSlot> scalar_slots;
+    std::vector<TypedSlot> scalar_slots_in_order;
+    std::vector<TypedSlot> array_slots_in_order;
+    scalar_slots.reserve(input_slots.size());
+    scalar_slots_in_order.reserve(input_slots.size());
+    array_slots_in_order.reserve(input_slots.size());
+    for (const auto& [name, array_slot] : input_slots) {
+      ASSIGN_OR_RETURN(
+          const QType* desired_scalar_qtype,
+          ToOptionalQType(array_slot.GetType()->value_qtype()));
+      TypedSlot scalar_slot = AddSlot(
+          scalar_listener_->GetQTypeOf(name, desired_scalar_qtype),
+          &scalar_layout_builder);
+      scalar_slots.emplace(name, scalar_slot);
+      scalar_slots_in_order.push_back(scalar_slot);
+      array_slots_in_order.push_back(array_slot);
+    }
+    ASSIGN_OR_RETURN(BoundSlotListener<T> bound_scalar_listener,
+                     scalar_listener_->Bind(scalar_slots));
+    auto scalar_layout = std::make_shared<FrameLayout>(
+        std::move(scalar_layout_builder).Build());
+    return BoundSlotListener<Output>(
+        [bound_scalar_listener = std::move(bound_scalar_listener),
+         scalar_layout = std::move(scalar_layout),
+         scalar_slots = std::move(scalar_slots_in_order),
+         array_slots = std::move(array_slots_in_order)](
+            ConstFramePtr frame, Output* outputs) -> absl::Status {
+          std::vector<TypedRef> arrays;
+          arrays.reserve(array_slots.size());
+          for (const TypedSlot& array_slot : array_slots) {
+            arrays.push_back(TypedRef::FromSlot(array_slot, frame));
+          }
+          ASSIGN_OR_RETURN(FrameIterator frame_iterator,
+                           FrameIterator::Create(
+                               arrays, scalar_slots,
+                               /*output_array_slots=*/{},
+                               /*output_scalar_slots=*/{}, scalar_layout.get(),
+                               {.row_count = static_cast<int64_t>(
+                                    outputs->size())}),
+                           _ << absl::StrFormat(
+                               "while listening to a batch of %d outputs",
+                               outputs->size()));
+          absl::Status status;
+          int64_t row_id = 0;
+          frame_iterator.ForEachFrame([&](FramePtr scalar_frame) {
+            if (status.ok()) {
+              status = bound_scalar_listener(scalar_frame, (*outputs)[row_id]);
+            }
+            ++row_id;
+          });
+          return status;
+        });
+  }
+
+  std::unique_ptr<SlotListener<T>> scalar_listener_;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_IO_BATCH_SLOT_LISTENER_H_
@@ -0,0 +1,129 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/io/batch_slot_listener.h"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/io/accessors_slot_listener.h"
+#include "arolla/io/slot_listener.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+struct TestStruct {
+  int32_t a = -1;
+  OptionalValue<float> b;
+};
+
+std::unique_ptr<SlotListener<TestStruct>> CreateScalarListener() {
+  return CreateAccessorsSlotListener<TestStruct>(
+             "a", [](int32_t a, TestStruct* s) { s->a = a; },  //
+             "b", [](OptionalValue<float> b, TestStruct* s) { s->b = b; })
+      .value();
+}
+
+TEST(BatchSlotListenerTest, Basic) {
+  ASSERT_OK_AND_ASSIGN(
+      auto slot_listener,
+      BatchSlotListener<TestStruct>::Create(CreateScalarListener()));
+  EXPECT_EQ(slot_listener->GetQTypeOf("a"), GetDenseArrayQType<int32_t>());
+  EXPECT_EQ(slot_listener->GetQTypeOf("b"), GetDenseArrayQType<float>());
+  EXPECT_EQ(slot_listener->GetQTypeOf("c"), nullptr);
+  EXPECT_THAT(slot_listener->SuggestAvailableNames(), ElementsAre("a", "b"));
+
+  FrameLayout::Builder layout_builder;
+  auto a_slot = layout_builder.AddSlot<DenseArray<int32_t>>();
+  auto b_slot = layout_builder.AddSlot<DenseArray<float>>();
+  ASSERT_OK_AND_ASSIGN(auto bound_slot_listener,
+                       slot_listener->Bind({
+                           {"a", TypedSlot::FromSlot(a_slot)},
+                           {"b", TypedSlot::FromSlot(b_slot)},
+                       }));
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+
+  // More elements than FrameIterator keeps in its buffer.
+  constexpr int kSize = 100;
+  std::vector<OptionalValue<int32_t>> a_values(kSize);
+  std::vector<OptionalValue<float>> b_values(kSize);
+  for (int i = 0; i < kSize; ++i) {
+    a_values[i] = i;
+    b_values[i] = i % 3 == 0 ? OptionalValue<float>() : 0.5f * i;
+  }
+  alloc.frame().Set(a_slot, CreateDenseArray<int32_t>(a_values));
+  alloc.frame().Set(b_slot, CreateDenseArray<float>(b_values));
+
+  std::vector<TestStruct> structs(kSize);
+  std::vector<TestStruct*> outputs;
+  for (auto& s : structs) {
+    outputs.push_back(&s);
+  }
+  absl::Span<TestStruct* const> outputs_span = outputs;
+  ASSERT_OK(bound_slot_listener(alloc.frame(), &outputs_span));
+  for (int i = 0; i < kSize; ++i) {
+    EXPECT_EQ(structs[i].a, i);
+    EXPECT_EQ(structs[i].b, b_values[i]);
+  }
+}
+
+TEST(BatchSlotListenerTest, Errors) {
+  EXPECT_THAT(BatchSlotListener<TestStruct>::Create(nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("scalar_listener must not be null")));
+
+  ASSERT_OK_AND_ASSIGN(
+      auto slot_listener,
+      BatchSlotListener<TestStruct>::Create(CreateScalarListener()));
+  FrameLayout::Builder layout_builder;
+  auto a_slot = layout_builder.AddSlot<DenseArray<int32_t>>();
+  auto a_scalar_slot = layout_builder.AddSlot<int32_t>();
+  EXPECT_THAT(slot_listener->Bind({{"a", TypedSlot::FromSlot(a_scalar_slot)}}),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       HasSubstr("slot types mismatch")));
+
+  ASSERT_OK_AND_ASSIGN(
+      auto bound_slot_listener,
+      slot_listener->Bind({{"a", TypedSlot::FromSlot(a_slot)}}));
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  alloc.frame().Set(a_slot, CreateDenseArray<int32_t>({1, 2, 3}));
+  TestStruct s;
+  std::vector<TestStruct*> outputs = {&s};
+  absl::Span<TestStruct* const> outputs_span = outputs;
+  EXPECT_THAT(bound_slot_listener(alloc.frame(), &outputs_span),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("while listening to a batch of 1 outputs")));
+}
+
+}  // namespace
+}  // namespace arolla
@@ -0,0 +1,186 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/io/columnar_input_loader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/config.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/bitmap.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/io/input_loader.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/meta.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+
+namespace {
+
+using SupportedTypes =
+    meta::type_list<int32_t, int64_t, uint64_t, float, double>;
+
+// Loads a single column into the frame.
+using ColumnLoaderFn = std::function<void(
+    const ColumnView&, int64_t row_count, const RawBufferPtr& owner,
+    FramePtr frame, RawBufferFactory* factory)>;
+
+// Returns presence bitmap of the column (empty if all values are present) and
+// sets `bit_offset` to the offset of the first row in it.
+bitmap::Bitmap LoadValidity(const ColumnView& column, int64_t row_count,
+                            const RawBufferPtr& owner,
+                            RawBufferFactory* factory, int* bit_offset) {
+  *bit_offset = 0;
+  if (column.validity == nullptr || row_count == 0) {
+    return bitmap::Bitmap();
+  }
+  const uint8_t* first_word =
+      column.validity +
+      (column.validity_bit_offset / bitmap::kWordBitCount) *
+          sizeof(bitmap::Word);
+  int offset = column.validity_bit_offset % bitmap::kWordBitCount;
+  // LSB-first bytes form the arolla bitmap words directly if the platform is
+  // little-endian.
+#ifdef ABSL_IS_LITTLE_ENDIAN
+  if (reinterpret_cast<uintptr_t>(first_word) % alignof(bitmap::Word) == 0) {
+    *bit_offset = offset;
+    return bitmap::Bitmap(
+        owner, absl::Span<const bitmap::Word>(
+                   reinterpret_cast<const bitmap::Word*>(first_word),
+                   bitmap::BitmapSize(row_count + offset)));
+  }
+#endif
+  bitmap::Builder builder(row_count, factory);
+  int64_t begin = column.validity_bit_offset;
+  builder.AddByGroups(row_count, [&](int64_t group_offset) {
+    return [&, group_offset](int i) {
+      int64_t bit = begin + group_offset + i;
+      return ((column.validity[bit >> 3] >> (bit & 7)) & 1) != 0;
+    };
+  });
+  return std::move(builder).Build();
+}
+
+template <class T>
+ColumnLoaderFn CreateColumnLoader(FrameLayout::Slot<DenseArray<T>> slot) {
+  return [slot](const ColumnView& column, int64_t row_count,
+                const RawBufferPtr& owner, FramePtr frame,
+                RawBufferFactory* factory) {
+    DenseArray<T> array;
+    array.values = Buffer<T>(
+        owner,
+        absl::Span<const T>(static_cast<const T*>(column.values), row_count));
+    array.bitmap = LoadValidity(column, row_count, owner, factory,
+                                &array.bitmap_bit_offset);
+    frame.Set(slot, std::move(array));
+  };
+}
+
+absl::StatusOr<ColumnLoaderFn> CreateColumnLoader(TypedSlot slot) {
+  absl::StatusOr<ColumnLoaderFn> result = absl::InvalidArgumentError(
+      absl::StrFormat("unsupported column type: %s", slot.GetType()->name()));
+  meta::foreach_type<SupportedTypes>([&](auto meta_type) {
+    using T = typename decltype(meta_type)::type;
+    if (slot.GetType() == GetDenseArrayQType<T>()) {
+      result = CreateColumnLoader(slot.UnsafeToSlot<DenseArray<T>>());
+    }
+  });
+  return result;
+}
+
+class ColumnarInputLoader : public StaticInputLoader<ColumnarBatch> {
+ public:
+  explicit ColumnarInputLoader(
+      std::vector<std::pair<std::string, QTypePtr>> columns)
+      : StaticInputLoader<ColumnarBatch>(std::move(columns)) {}
+
+ private:
+  absl::StatusOr<BoundInputLoader<ColumnarBatch>> BindImpl(
+      const absl::flat_hash_map<std::string, TypedSlot>& output_slots)
+      const override {
+    std::vector<size_t> column_ids;
+    std::vector<ColumnLoaderFn> loaders;
+    column_ids.reserve(output_slots.size());
+    loaders.reserve(output_slots.size());
+    for (size_t i = 0; i != types_in_order().size(); ++i) {
+      if (auto it = output_slots.find(types_in_order()[i].first);
+          it != output_slots.end()) {
+        column_ids.push_back(i);
+        ASSIGN_OR_RETURN(loaders.emplace_back(),
+                         CreateColumnLoader(it->second));
+      }
+    }
+    return BoundInputLoader<ColumnarBatch>(
+        [column_ids = std::move(column_ids), loaders = std::move(loaders),
+         expected_column_count = types_in_order().size()](
+            const ColumnarBatch& batch, FramePtr frame,
+            RawBufferFactory* factory) -> absl::Status {
+          if (batch.columns.size() != expected_column_count) {
+            return absl::InvalidArgumentError(absl::StrFormat(
+                "unexpected column count: expected %d, got %d",
+                expected_column_count, batch.columns.size()));
+          }
+          if (batch.row_count < 0) {
+            return absl::InvalidArgumentError(absl::StrFormat(
+                "negative row count: %d", batch.row_count));
+          }
+          for (size_t i = 0; i < loaders.size(); ++i) {
+            const ColumnView& column = batch.columns[column_ids[i]];
+            if (column.values == nullptr && batch.row_count > 0) {
+              return absl::InvalidArgumentError(absl::StrFormat(
+                  "missing values buffer for column #%d", column_ids[i]));
+            }
+            loaders[i](column, batch.row_count, batch.owner, frame, factory);
+          }
+          return absl::OkStatus();
+        });
+  }
+};
+
+}  // namespace
+
+absl::StatusOr<InputLoaderPtr<ColumnarBatch>> CreateColumnarInputLoader(
+    std::vector<std::pair<std::string, QTypePtr>> columns) {
+  for (const auto& [name, qtype] : columns) {
+    bool supported = false;
+    meta::foreach_type<SupportedTypes>([&](auto meta_type) {
+      using T = typename decltype(meta_type)::type;
+      supported = supported || qtype == GetDenseArrayQType<T>();
+    });
+    if (!supported) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("unsupported type %s for column %s",
+                          qtype->name(), name));
+    }
+  }
+  return std::make_unique<ColumnarInputLoader>(std::move(columns));
+}
+
+}  // namespace arolla
@@ -0,0 +1,67 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_IO_COLUMNAR_INPUT_LOADER_H_
+#define AROLLA_IO_COLUMNAR_INPUT_LOADER_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "arolla/io/input_loader.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qtype/qtype.h"
+
+namespace arolla {
+
+// Non-owning view of a single fixed-width column stored in the Apache Arrow
+// columnar layout.
+struct ColumnView {
+  // `row_count` contiguous values of the column type, starting from the first
+  // row of the batch (i.e. Arrow array offset is already applied).
+  const void* values = nullptr;
+  // LSB-first validity bitmap. nullptr means that all the values are present.
+  // The buffer must be readable up to the 4-byte boundary following the last
+  // row, which is guaranteed by the Arrow padding requirements.
+  const uint8_t* validity = nullptr;
+  // Index of the bit in `validity` corresponding to the first row.
+  int64_t validity_bit_offset = 0;
+};
+
+// A batch of columns sharing the same row count.
+struct ColumnarBatch {
+  int64_t row_count = 0;
+  std::vector<ColumnView> columns;
+  // Keeps memory of all the columns alive. Loaded DenseArrays share the
+  // ownership, so the batch itself may be destroyed right after loading.
+  RawBufferPtr owner;
+};
+
+// InputLoader for ColumnarBatch that loads columns into DenseArray slots
+// without copying the values. Validity bitmaps are also reused whenever
+// possible, i.e. on little-endian platforms if the corresponding 32-bit word
+// is properly aligned, and copied otherwise.
+//
+// `columns` specifies names and DenseArray qtypes of the columns in the order
+// of ColumnarBatch::columns. Only DenseArrays of int32, int64, uint64, float
+// and double are supported, because other types have incompatible memory
+// layouts.
+absl::StatusOr<InputLoaderPtr<ColumnarBatch>> CreateColumnarInputLoader(
+    std::vector<std::pair<std::string, QTypePtr>> columns);
+
+}  // namespace arolla
+
+#endif  // AROLLA_IO_COLUMNAR_INPUT_LOADER_H_
@@ -0,0 +1,169 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/io/columnar_input_loader.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/io/input_loader.h"
+#include "arolla/io/testing/matchers.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::InputLoaderSupports;
+using ::arolla::testing::IsOk;
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+// Column memory in the Arrow layout.
+struct ColumnData {
+  std::vector<float> floats = {1.f, 2.f, 3.f, 4.f, 5.f};
+  std::vector<int64_t> ints = {10, 20, 30, 40, 50};
+  // 8-byte aligned and padded validity bitmap for `ints`.
+  alignas(8) uint8_t validity[8] = {0b10110110};
+};
+
+TEST(ColumnarInputLoaderTest, Load) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      CreateColumnarInputLoader({{"a", GetDenseArrayQType<float>()},
+                                 {"b", GetDenseArrayQType<int64_t>()}}));
+  EXPECT_THAT(input_loader,
+              InputLoaderSupports({{"a", GetDenseArrayQType<float>()},
+                                   {"b", GetDenseArrayQType<int64_t>()}}));
+
+  FrameLayout::Builder layout_builder;
+  auto a_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto b_slot = layout_builder.AddSlot<DenseArray<int64_t>>();
+  ASSERT_OK_AND_ASSIGN(BoundInputLoader<ColumnarBatch> bound_input_loader,
+                       input_loader->Bind({
+                           {"a", TypedSlot::FromSlot(a_slot)},
+                           {"b", TypedSlot::FromSlot(b_slot)},
+                       }));
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+
+  auto data = std::make_shared<ColumnData>();
+  std::weak_ptr<ColumnData> weak_data = data;
+  {
+    ColumnarBatch batch{
+        .row_count = 4,
+        .columns = {{.values = data->floats.data()},
+                    {.values = data->ints.data() + 1,
+                     .validity = data->validity,
+                     .validity_bit_offset = 1}},
+        .owner = std::move(data)};
+    ASSERT_THAT(bound_input_loader(batch, alloc.frame()), IsOk());
+  }
+  const auto& a = alloc.frame().Get(a_slot);
+  const auto& b = alloc.frame().Get(b_slot);
+  EXPECT_THAT(a, ElementsAre(1.f, 2.f, 3.f, 4.f));
+  EXPECT_THAT(b, ElementsAre(20, 30, std::nullopt, 50));
+  EXPECT_TRUE(a.bitmap.empty());
+  EXPECT_EQ(b.bitmap_bit_offset, 1);
+
+  // The values and the bitmap are not copied.
+  ASSERT_FALSE(weak_data.expired());
+  EXPECT_EQ(a.values.span().data(), weak_data.lock()->floats.data());
+  EXPECT_EQ(b.values.span().data(), weak_data.lock()->ints.data() + 1);
+  EXPECT_EQ(static_cast<const void*>(b.bitmap.span().data()),
+            weak_data.lock()->validity);
+
+  alloc = MemoryAllocation(&memory_layout);
+  EXPECT_TRUE(weak_data.expired());
+}
+
+TEST(ColumnarInputLoaderTest, UnalignedValidity) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      CreateColumnarInputLoader({{"b", GetDenseArrayQType<int64_t>()}}));
+  FrameLayout::Builder layout_builder;
+  auto b_slot = layout_builder.AddSlot<DenseArray<int64_t>>();
+  ASSERT_OK_AND_ASSIGN(
+      BoundInputLoader<ColumnarBatch> bound_input_loader,
+      input_loader->Bind({{"b", TypedSlot::FromSlot(b_slot)}}));
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+
+  ColumnData data;
+  data.validity[1] = 0b00000101;
+  ColumnarBatch batch{.row_count = 5,
+                      .columns = {{.values = data.ints.data(),
+                                   .validity = data.validity + 1,
+                                   .validity_bit_offset = 0}}};
+  ASSERT_THAT(bound_input_loader(batch, alloc.frame()), IsOk());
+  EXPECT_THAT(alloc.frame().Get(b_slot),
+              ElementsAre(10, std::nullopt, 30, std::nullopt, std::nullopt));
+}
+
+TEST(ColumnarInputLoaderTest, Errors) {
+  EXPECT_THAT(
+      CreateColumnarInputLoader({{"a", GetDenseArrayQType<bool>()}}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("unsupported type DENSE_ARRAY_BOOLEAN for column a")));
+  EXPECT_THAT(CreateColumnarInputLoader({{"a", GetQType<float>()}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unsupported type FLOAT32 for column a")));
+
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      CreateColumnarInputLoader({{"a", GetDenseArrayQType<float>()},
+                                 {"b", GetDenseArrayQType<int64_t>()}}));
+  FrameLayout::Builder layout_builder;
+  auto b_slot = layout_builder.AddSlot<DenseArray<int64_t>>();
+  ASSERT_OK_AND_ASSIGN(
+      BoundInputLoader<ColumnarBatch> bound_input_loader,
+      input_loader->Bind({{"b", TypedSlot::FromSlot(b_slot)}}));
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+
+  ColumnData data;
+  EXPECT_THAT(
+      bound_input_loader(ColumnarBatch{.row_count = 5, .columns = {{}}},
+                         alloc.frame()),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               "unexpected column count: expected 2, got 1"));
+  EXPECT_THAT(
+      bound_input_loader(ColumnarBatch{.row_count = 5, .columns = {{}, {}}},
+                         alloc.frame()),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               "missing values buffer for column #1"));
+  // The unused column is not validated.
+  EXPECT_THAT(
+      bound_input_loader(
+          ColumnarBatch{.row_count = 5,
+                        .columns = {{}, {.values = data.ints.data()}}},
+          alloc.frame()),
+      IsOk());
+  EXPECT_THAT(alloc.frame().Get(b_slot), ElementsAre(10, 20, 30, 40, 50));
+}
+
+}  // namespace
+}  // namespace arolla
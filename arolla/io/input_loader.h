@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <memory>
@@ -39,6 +40,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/status_macros_backport.h"
+#include "arolla/util/threading.h"
 
 namespace arolla {
 
@@ -405,6 +407,58 @@ class ChainInputLoader final : public InputLoader<Input> {
     return absl::OkStatus();
   }
 
+  // Returns InvokeBoundLoadersFn that invokes the bound loaders concurrently
+  // using `threading`. The loaders must be thread-safe, which is the case for
+  // the codegen loaders (e.g. shards generated with `sharding_info`); they are
+  // already required to write disjoint slots.
+  //
+  // `is_large_input` decides whether the input is worth the threading
+  // overhead; nullptr means that the loaders are always run in parallel.
+  // The loaders are invoked sequentially if `factory` is not the heap buffer
+  // factory, because other factories (e.g. UnsafeArenaBufferFactory) are not
+  // thread-safe.
+  //
+  // `threading` must outlive all the loaders created with the returned
+  // function.
+  static InvokeBoundLoadersFn MakeParallelInvokeBoundLoadersFn(
+      absl::Nonnull<ThreadingInterface*> threading,
+      std::function<bool(const Input&)> is_large_input = nullptr) {
+    return [threading, is_large_input(std::move(is_large_input))](
+               absl::Span<const BoundInputLoader<Input>> bound_loaders,
+               const Input& input, FramePtr frame,
+               RawBufferFactory* factory) -> absl::Status {
+      const int64_t thread_count = std::min<int64_t>(
+          bound_loaders.size(), threading->GetRecommendedThreadCount());
+      if (thread_count <= 1 || factory != GetHeapBufferFactory() ||
+          (is_large_input != nullptr && !is_large_input(input))) {
+        return InvokeBoundLoaders(bound_loaders, input, frame, factory);
+      }
+      // Thread `i` invokes the loaders i, i + thread_count, ...
+      auto invoke_loaders = [&](int64_t thread_id) -> absl::Status {
+        for (int64_t i = thread_id; i < bound_loaders.size();
+             i += thread_count) {
+          RETURN_IF_ERROR(bound_loaders[i](input, frame, factory));
+        }
+        return absl::OkStatus();
+      };
+      std::vector<absl::Status> statuses(thread_count);
+      threading->WithThreading([&] {
+        std::vector<std::function<void()>> join_fns;
+        join_fns.reserve(thread_count - 1);
+        for (int64_t i = 1; i < thread_count; ++i) {
+          join_fns.push_back(threading->StartThread(
+              [&, i] { statuses[i] = invoke_loaders(i); }));
+        }
+        statuses[0] = invoke_loaders(0);
+        for (auto& join : join_fns) join();
+      });
+      for (auto& status : statuses) {
+        RETURN_IF_ERROR(std::move(status));
+      }
+      return absl::OkStatus();
+    };
+  }
+
   // Creates ChainInputLoader with customizable `invoke_bound_loaders` strategy.
   // This may run loaders in parallel or perform additional logging.
   // NOTE: as an optimization, this function is not going to be used
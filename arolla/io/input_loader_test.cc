@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -23,6 +24,7 @@
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 #include "arolla/io/accessors_input_loader.h"
 #include "arolla/io/testing/matchers.h"
@@ -31,6 +33,8 @@
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 
 namespace arolla {
@@ -401,6 +405,51 @@ TEST(InputLoaderTest, ChainInputLoaderWithCustomInvoke) {
   EXPECT_EQ(alloc.frame().Get(c_slot), 3.5 * 3.5);
 }
 
+TEST(InputLoaderTest, ChainInputLoaderWithParallelInvoke) {
+  constexpr int kLoaderCount = 10;
+  FrameLayout::Builder layout_builder;
+  std::vector<FrameLayout::Slot<int>> slots;
+  absl::flat_hash_map<std::string, TypedSlot> typed_slots;
+  std::vector<InputLoaderPtr<TestStruct>> input_loaders;
+  for (int i = 0; i < kLoaderCount; ++i) {
+    std::string name = absl::StrCat("x", i);
+    slots.push_back(layout_builder.AddSlot<int>());
+    typed_slots.emplace(name, TypedSlot::FromSlot(slots.back()));
+    ASSERT_OK_AND_ASSIGN(
+        input_loaders.emplace_back(),
+        CreateAccessorsInputLoader<TestStruct>(
+            name, [i](const TestStruct& s) { return s.a * i; }));
+  }
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+
+  StdThreading threading(4);
+  ASSERT_OK_AND_ASSIGN(
+      auto chain_input_loader,
+      ChainInputLoader<TestStruct>::Build(
+          std::move(input_loaders),
+          ChainInputLoader<TestStruct>::MakeParallelInvokeBoundLoadersFn(
+              &threading,
+              [](const TestStruct& s) { return s.a > 0; })));
+  ASSERT_OK_AND_ASSIGN(auto bound_input_loader,
+                       chain_input_loader->Bind(typed_slots));
+
+  for (int a : {5, -3}) {  // In parallel and sequentially.
+    MemoryAllocation alloc(&memory_layout);
+    ASSERT_OK(bound_input_loader({a, 3.5}, alloc.frame()));
+    for (int i = 0; i < kLoaderCount; ++i) {
+      EXPECT_EQ(alloc.frame().Get(slots[i]), a * i);
+    }
+  }
+  {  // Arena factory is not thread-safe, so the loaders run sequentially.
+    UnsafeArenaBufferFactory arena(1024);
+    MemoryAllocation alloc(&memory_layout);
+    ASSERT_OK(bound_input_loader({7, 3.5}, alloc.frame(), &arena));
+    for (int i = 0; i < kLoaderCount; ++i) {
+      EXPECT_EQ(alloc.frame().Get(slots[i]), 7 * i);
+    }
+  }
+}
+
 TEST(InputLoaderTest, ChainInputLoaderWithCustomInvokeOptimized) {
   auto i32 = GetQType<int32_t>();
   auto f64 = GetQType<double>();
@@ -16,7 +16,9 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <variant>
@@ -27,28 +29,36 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/match.h"
-#include "absl/strings/numbers.h"
-#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
-#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
-#include "absl/strings/strip.h"
 #include "absl/types/span.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
+#include "google/protobuf/reflection.h"
 #include "arolla/io/input_loader.h"
+#include "arolla/io/proto/protopath.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/proto/reflection/reader.h"
 #include "arolla/proto/types.h"
 #include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/text.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
 namespace {
 
+using ::google::protobuf::FieldDescriptor;
+using ::google::protobuf::Message;
+using ::google::protobuf::Reflection;
+
 using proto::ProtoTypeReader;
+using proto_input_loader_impl::IsScalarProtopath;
+using proto_input_loader_impl::ParsedProtopath;
+using proto_input_loader_impl::ParseProtopath;
 using proto::StringFieldType;
 
 absl::StatusOr<std::unique_ptr<ProtoTypeReader>> CreateReaderWithStringType(
@@ -76,112 +86,221 @@ absl::StatusOr<std::unique_ptr<ProtoTypeReader>> CreateReaderWithStringType(
   }
 }
 
-// Returns field name and extra access information
-absl::StatusOr<std::pair<std::string, proto::ProtoFieldAccessInfo>>
-ParseProtopathElement(absl::string_view path_element) {
-  bool is_size_element = absl::ConsumeSuffix(&path_element, "@size");
-  if (!absl::StrContains(path_element, '[') &&
-      !absl::StrContains(path_element, ']')) {
-    if (is_size_element) {
-      return std::pair{std::string(path_element),
-                       proto::RepeatedFieldSizeAccess{}};
-    } else {
-      return std::pair{std::string(path_element),
-                       proto::ProtoFieldAccessInfo{}};
+absl::StatusOr<std::unique_ptr<proto::ProtoTypeReader>> ParseProtopathToReader(
+    const google::protobuf::Descriptor* const descr, absl::string_view protopath,
+    proto::StringFieldType string_type) {
+  ASSIGN_OR_RETURN(auto parsed, ParseProtopath(descr, protopath));
+  return CreateReaderWithStringType(
+      parsed.fields, std::move(parsed.access_infos), string_type);
+}
+
+// Returns the element `index` of the repeated `field` or the value of the
+// singular `field`. Returns nullptr if the submessage is missing.
+const Message* GetSubMessage(const Reflection& ref, const Message& m,
+                             const FieldDescriptor* field, size_t index) {
+  if (field->is_repeated()) {
+    if (index < static_cast<size_t>(ref.FieldSize(m, field))) {
+      return &ref.GetRepeatedMessage(m, field, index);
     }
+    return nullptr;
   }
-  if (is_size_element) {
-    return absl::FailedPreconditionError(absl::StrFormat(
-        "@size accessor does not accept field access by index, got %s",
-        path_element));
-  }
-  // Parsing index access in form of "field_name[\d+]".
-  std::vector<absl::string_view> splits =
-      absl::StrSplit(path_element, absl::ByAnyChar("[]"), absl::SkipEmpty());
-  auto error = [&]() {
-    return absl::FailedPreconditionError(absl::StrCat(
-        "cannot parse access by index protopath element: ", path_element));
+  return ref.HasField(m, field) ? &ref.GetMessage(m, field) : nullptr;
+}
+
+// Reads a scalar field of an already resolved message into an OptionalValue
+// slot. The read function is specialized for the field type at bind time, so
+// that no type dispatching happens during loading.
+struct ScalarFieldReader {
+  // `m` is nullptr if one of the intermediate submessages is missing.
+  using ReadFn = void (*)(const ScalarFieldReader& reader,
+                          const Reflection* ref, const Message* m,
+                          FramePtr frame);
+
+  const FieldDescriptor* field;
+  size_t index;  // Index in the repeated field, ignored for singular fields.
+  size_t slot_offset;
+  ReadFn read_fn;
+};
+
+#define AROLLA_PROTO_SCALAR_GETTER(TYPE)                             \
+  struct ProtoGetter##TYPE {                                         \
+    static auto Get(const Reflection* ref, const Message& m,         \
+                    const FieldDescriptor* field, std::string*) {    \
+      return ref->Get##TYPE(m, field);                               \
+    }                                                                \
+    static auto GetRepeated(const Reflection* ref, const Message& m, \
+                            const FieldDescriptor* field, int index, \
+                            std::string*) {                          \
+      return ref->GetRepeated##TYPE(m, field, index);                \
+    }                                                                \
   };
-  if (splits.size() != 2) {
-    return error();
-  }
-  std::string field_name(splits[0]);
 
-  size_t idx = static_cast<size_t>(-1);
-  if (!absl::SimpleAtoi(splits[1], &idx)) {
-    return error();
-  }
-  if (absl::StrFormat("%s[%d]", field_name, idx) != path_element) {
-    return error();
-  }
-  return std::pair{field_name, proto::RepeatedFieldIndexAccess{idx}};
-}
+AROLLA_PROTO_SCALAR_GETTER(Int32);
+AROLLA_PROTO_SCALAR_GETTER(Int64);
+AROLLA_PROTO_SCALAR_GETTER(UInt32);
+AROLLA_PROTO_SCALAR_GETTER(UInt64);
+AROLLA_PROTO_SCALAR_GETTER(Float);
+AROLLA_PROTO_SCALAR_GETTER(Double);
+AROLLA_PROTO_SCALAR_GETTER(Bool);
 
-absl::StatusOr<std::unique_ptr<proto::ProtoTypeReader>> ParseProtopathToReader(
-    const google::protobuf::Descriptor* const descr, absl::string_view protopath,
-    proto::StringFieldType string_type) {
-  if (!absl::ConsumePrefix(&protopath, "/")) {
-    return absl::FailedPreconditionError(absl::StrFormat(
-        "protopath must start with '/', got: \"%s\"", protopath));
+#undef AROLLA_PROTO_SCALAR_GETTER
+
+// Avoids copying the string into a temporary std::string when possible.
+struct ProtoGetterString {
+  static const std::string& Get(const Reflection* ref, const Message& m,
+                                const FieldDescriptor* field,
+                                std::string* scratch) {
+    return ref->GetStringReference(m, field, scratch);
   }
-  std::vector<std::string> elements = absl::StrSplit(protopath, '/');
-  if (elements.empty()) {
-    return absl::FailedPreconditionError(
-        absl::StrFormat("empty protopath: %s", protopath));
+  static const std::string& GetRepeated(const Reflection* ref,
+                                        const Message& m,
+                                        const FieldDescriptor* field, int index,
+                                        std::string* scratch) {
+    return ref->GetRepeatedStringReference(m, field, index, scratch);
   }
-  if (elements.back() == "@size" && elements.size() > 1) {
-    elements.pop_back();
-    elements.back().append("@size");
+};
+
+template <class T, class ProtoGetter>
+void ReadScalarField(const ScalarFieldReader& reader, const Reflection* ref,
+                     const Message* m, FramePtr frame) {
+  auto& res = *frame.GetMutable(
+      FrameLayout::Slot<OptionalValue<T>>::UnsafeSlotFromOffset(
+          reader.slot_offset));
+  if (m == nullptr) {
+    res = std::nullopt;
+    return;
   }
-  std::vector<const google::protobuf::FieldDescriptor*> fields;
-  std::vector<proto::ProtoFieldAccessInfo> access_infos;
-  const google::protobuf::FieldDescriptor* previous_field = nullptr;
-  for (absl::string_view path_element : elements) {
-    ASSIGN_OR_RETURN((auto [field_name, access_info]),
-                     ParseProtopathElement(path_element));
-    const google::protobuf::Descriptor* current_descr;
-    if (previous_field != nullptr) {
-      current_descr = previous_field->message_type();
-      if (current_descr == nullptr) {
-        return absl::FailedPreconditionError(absl::StrFormat(
-            "unexpected type of the field `%s` in the protopath "
-            "`%s`: expected a message",
-            previous_field->name(), protopath));
-      }
+  std::string scratch;
+  const auto* field = reader.field;
+  if (field->is_repeated()) {
+    if (reader.index < static_cast<size_t>(ref->FieldSize(*m, field))) {
+      res = T(ProtoGetter::GetRepeated(ref, *m, field, reader.index, &scratch));
     } else {
-      current_descr = descr;
+      res = std::nullopt;
     }
-    const google::protobuf::FieldDescriptor* field_descriptor =
-        current_descr->FindFieldByName(field_name);
-    if (field_descriptor == nullptr) {
-      return absl::FailedPreconditionError(absl::StrFormat(
-          "unknown field `%s` in the message `%s` in the protopath `%s`.",
-          field_name, current_descr->full_name(), protopath));
+  } else {
+    if (ref->HasField(*m, field)) {
+      res = T(ProtoGetter::Get(ref, *m, field, &scratch));
+    } else {
+      res = std::nullopt;
     }
-    if (field_descriptor->enum_type() != nullptr ||
-        field_descriptor->is_extension()) {
+  }
+}
+
+template <class T, class ProtoGetter>
+absl::StatusOr<ScalarFieldReader> CreateScalarFieldReader(
+    const FieldDescriptor* field, size_t index, TypedSlot slot) {
+  ASSIGN_OR_RETURN(auto typed_slot, slot.ToSlot<OptionalValue<T>>());
+  return ScalarFieldReader{.field = field,
+                           .index = index,
+                           .slot_offset = typed_slot.byte_offset(),
+                           .read_fn = &ReadScalarField<T, ProtoGetter>};
+}
+
+// Returns ScalarFieldReader for the field, the type mapping must be consistent
+// with proto::ProtoTypeReader.
+absl::StatusOr<ScalarFieldReader> CreateScalarFieldReader(
+    const FieldDescriptor* field, size_t index, TypedSlot slot,
+    StringFieldType string_type) {
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      return CreateScalarFieldReader<int32_t, ProtoGetterInt32>(field, index,
+                                                                slot);
+    case FieldDescriptor::CPPTYPE_INT64:
+      return CreateScalarFieldReader<int64_t, ProtoGetterInt64>(field, index,
+                                                                slot);
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return CreateScalarFieldReader<int64_t, ProtoGetterUInt32>(field, index,
+                                                                 slot);
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return CreateScalarFieldReader<uint64_t, ProtoGetterUInt64>(field, index,
+                                                                  slot);
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return CreateScalarFieldReader<float, ProtoGetterFloat>(field, index,
+                                                              slot);
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return CreateScalarFieldReader<double, ProtoGetterDouble>(field, index,
+                                                                slot);
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return CreateScalarFieldReader<bool, ProtoGetterBool>(field, index, slot);
+    case FieldDescriptor::CPPTYPE_STRING:
+      if (field->type() == FieldDescriptor::TYPE_STRING &&
+          string_type == StringFieldType::kText) {
+        return CreateScalarFieldReader<Text, ProtoGetterString>(field, index,
+                                                                slot);
+      }
+      return CreateScalarFieldReader<Bytes, ProtoGetterString>(field, index,
+                                                               slot);
+    default:
       return absl::FailedPreconditionError(absl::StrFormat(
-          "unsupported type `%s` of the field `%s` in the protopath `%s`.",
-          field_descriptor->type_name(), field_descriptor->name(), protopath));
+          "unsupported type `%s` of the field `%s`", field->type_name(),
+          field->full_name()));
+  }
+}
+
+// Tree of the scalar protopaths bound to the loader. Protopaths with a common
+// prefix share the node, so every submessage is resolved only once per input.
+class MessageNode {
+ public:
+  MessageNode() = default;
+  MessageNode(const FieldDescriptor* field, size_t index)
+      : field_(field), index_(index) {}
+
+  absl::Status AddProtopath(const ParsedProtopath& protopath, TypedSlot slot,
+                            StringFieldType string_type) {
+    MessageNode* node = this;
+    for (size_t i = 0; i + 1 < protopath.fields.size(); ++i) {
+      node = &node->GetOrAddChild(protopath.fields[i],
+                                  GetIndex(protopath.access_infos[i]));
+    }
+    ASSIGN_OR_RETURN(
+        auto reader,
+        CreateScalarFieldReader(protopath.fields.back(),
+                                GetIndex(protopath.access_infos.back()), slot,
+                                string_type));
+    node->scalar_readers_.push_back(reader);
+    return absl::OkStatus();
+  }
+
+  // Reads all the fields in the subtree. `m` corresponds to this node and is
+  // nullptr if the submessage is missing.
+  void Read(const Message* m, FramePtr frame) const {
+    const Reflection* ref = m == nullptr ? nullptr : m->GetReflection();
+    for (const auto& reader : scalar_readers_) {
+      reader.read_fn(reader, ref, m, frame);
     }
-    if (field_descriptor->is_repeated() &&
-        std::holds_alternative<proto::RegularFieldAccess>(access_info)) {
-      access_info = proto::RepeatedFieldAccess{};
+    for (const auto& child : children_) {
+      child.Read(m == nullptr
+                     ? nullptr
+                     : GetSubMessage(*ref, *m, child.field_, child.index_),
+                 frame);
     }
-    fields.push_back(field_descriptor);
-    access_infos.push_back(access_info);
-    previous_field = field_descriptor;
   }
-  bool is_size_protopath =
-      std::holds_alternative<proto::RepeatedFieldSizeAccess>(
-          access_infos.back());
-  if (previous_field->message_type() != nullptr && !is_size_protopath) {
-    return absl::FailedPreconditionError(absl::StrCat(
-        "unexpected type of the last field in protopath `%s`", protopath));
+
+  bool empty() const { return scalar_readers_.empty() && children_.empty(); }
+
+ private:
+  static size_t GetIndex(const proto::ProtoFieldAccessInfo& access_info) {
+    const auto* index_access =
+        std::get_if<proto::RepeatedFieldIndexAccess>(&access_info);
+    return index_access == nullptr ? 0 : index_access->idx;
+  }
+
+  MessageNode& GetOrAddChild(const FieldDescriptor* field,
+                             size_t index) {
+    for (auto& child : children_) {
+      if (child.field_ == field && child.index_ == index) {
+        return child;
+      }
+    }
+    return children_.emplace_back(field, index);
   }
-  return CreateReaderWithStringType(fields, std::move(access_infos),
-                                    string_type);
-}
+
+  const FieldDescriptor* field_ = nullptr;  // nullptr for the root.
+  size_t index_ = 0;  // Index in the repeated field, ignored for singular.
+  std::vector<ScalarFieldReader> scalar_readers_;
+  std::vector<MessageNode> children_;
+};
 
 }  // namespace
 
@@ -209,32 +328,43 @@ std::vector<std::string> ProtoFieldsLoader::SuggestAvailableNames() const {
 
 absl::StatusOr<BoundInputLoader<google::protobuf::Message>> ProtoFieldsLoader::BindImpl(
     const absl::flat_hash_map<std::string, TypedSlot>& output_slots) const {
+  MessageNode scalars_root;
   std::vector<ProtoTypeReader::BoundReadFn> readers;
 
   for (const auto& [name, slot] : output_slots) {
+    ASSIGN_OR_RETURN(auto protopath, ParseProtopath(descr_, name));
     ASSIGN_OR_RETURN(const auto& reader,
-                     ParseProtopathToReader(descr_, name, string_type_));
+                     CreateReaderWithStringType(protopath.fields,
+                                                protopath.access_infos,
+                                                string_type_));
     if (reader->qtype() != slot.GetType()) {
       return absl::FailedPreconditionError(
           absl::StrFormat("invalid type for slot %s: expected %s, got %s", name,
                           slot.GetType()->name(), reader->qtype()->name()));
     }
-    // TODO: combine readers with the same QType.
+    if (IsScalarProtopath(protopath)) {
+      RETURN_IF_ERROR(scalars_root.AddProtopath(protopath, slot, string_type_));
+      continue;
+    }
     ASSIGN_OR_RETURN(auto read_fn, reader->BindReadFn(slot));
     readers.push_back(read_fn);
   }
   // Load data from provided input into the frame.
   return BoundInputLoader<google::protobuf::Message>(
-      [descr_(this->descr_), readers_(std::move(readers))](
+      [descr_(this->descr_), scalars_root_(std::move(scalars_root)),
+       readers_(std::move(readers))](
           const google::protobuf::Message& m, FramePtr frame,
-          RawBufferFactory*) -> absl::Status {
+          RawBufferFactory* buffer_factory) -> absl::Status {
         if (descr_ != m.GetDescriptor()) {
           return absl::FailedPreconditionError(
               "message must have the same descriptor as provided during "
               "construction of ProtoFieldsLoader");
         }
+        if (!scalars_root_.empty()) {
+          scalars_root_.Read(&m, frame);
+        }
         for (const auto& r : readers_) {
-          r(m, frame);
+          r(m, frame, buffer_factory);
         }
         return absl::OkStatus();
       });
@@ -31,6 +31,10 @@
 namespace arolla {
 
 // Dynamic loader from `google::protobuf::Message` based on proto reflection.
+//
+// On Bind, protopaths selecting scalar values are compiled into a tree that
+// resolves every shared submessage once per input and reads the leaf fields
+// using readers specialized for their type.
 class ProtoFieldsLoader : public InputLoader<google::protobuf::Message> {
   struct PrivateConstructorTag {};
 
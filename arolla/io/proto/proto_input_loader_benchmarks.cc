@@ -13,11 +13,28 @@
 // limitations under the License.
 //
 
+#include <string>
+#include <utility>
+
 #include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/message.h"
+#include "arolla/io/input_loader.h"
+#include "arolla/io/proto/benchmark_codegen_nested_proto_input_loader.h"
+#include "arolla/io/proto/benchmark_codegen_proto_input_loader.h"
 #include "arolla/io/proto/proto_input_loader.h"
+#include "arolla/io/proto/proto_wire_format_input_loader.h"
 #include "arolla/io/proto/testing/benchmark_util.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/optional_value.h"
 #include "arolla/proto/test.pb.h"
+#include "arolla/qtype/typed_slot.h"
 
 namespace arolla {
 namespace {
@@ -31,5 +48,114 @@ void BM_LoadProtoIntoScalars(::benchmark::State& state) {
 
 BENCHMARK(BM_LoadProtoIntoScalars);
 
+// Baseline: the same fields loaded by the codegen loader.
+void BM_LoadProtoIntoScalars_Codegen(::benchmark::State& state) {
+  InputLoaderPtr<::testing_namespace::Root> input_loader =
+      ::arolla_benchmark::GetBenchCodegenProtoLoader();
+  testing::benchmark::LoadProtoIntoScalars(input_loader, state);
+}
+
+BENCHMARK(BM_LoadProtoIntoScalars_Codegen);
+
+void BM_LoadNestedDepth4ProtoIntoScalars(::benchmark::State& state) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      ProtoFieldsLoader::Create(::testing_namespace::Root::descriptor()));
+  testing::benchmark::LoadNestedDepth4ProtoIntoScalars(input_loader, state);
+}
+
+BENCHMARK(BM_LoadNestedDepth4ProtoIntoScalars);
+
+// Baseline: the same fields loaded by the codegen loader.
+void BM_LoadNestedDepth4ProtoIntoScalars_Codegen(::benchmark::State& state) {
+  InputLoaderPtr<::testing_namespace::Root> input_loader =
+      ::arolla_benchmark::GetBenchCodegenNestedProtoLoader();
+  testing::benchmark::LoadNestedDepth4ProtoIntoScalars(input_loader, state);
+}
+
+BENCHMARK(BM_LoadNestedDepth4ProtoIntoScalars_Codegen);
+
+// Returns serialized Root with x0, x1... x9 set and a lot of unused data.
+std::string SerializedProtoWithManyUnusedFields() {
+  ::testing_namespace::Root r;
+  r.set_x0(0);
+  r.set_x1(1);
+  r.set_x2(2);
+  r.set_x3(3);
+  r.set_x4(4);
+  r.set_x5(5);
+  r.set_x6(6);
+  r.set_x7(7);
+  r.set_x8(8);
+  r.set_x9(9);
+  for (int i = 0; i < 100; ++i) {
+    r.add_ys(i);
+    r.add_repeated_doubles(i);
+    r.add_repeated_str(absl::StrCat("unused string ", i));
+    auto* inner = r.add_inners();
+    inner->set_a(i);
+    inner->set_str(absl::StrCat("unused inner string ", i));
+  }
+  return r.SerializeAsString();
+}
+
+// Loads x0, x1... x9 from SerializedProtoWithManyUnusedFields into scalar
+// slots using `load_fn(bound_input_loader, serialized_proto, frame)`.
+template <class Input, class LoadFn>
+void LoadSerializedProtoIntoScalars(const InputLoaderPtr<Input>& input_loader,
+                                    LoadFn load_fn, ::benchmark::State& state) {
+  FrameLayout::Builder layout_builder;
+  absl::flat_hash_map<std::string, TypedSlot> slots;
+  for (int i = 0; i < 10; ++i) {
+    auto slot = layout_builder.AddSlot<OptionalValue<int>>();
+    slots.emplace(absl::StrCat("/x", i), TypedSlot::FromSlot(slot));
+  }
+  ASSERT_OK_AND_ASSIGN(auto bound_input_loader, input_loader->Bind(slots));
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  FramePtr frame = alloc.frame();
+
+  std::string serialized_proto = SerializedProtoWithManyUnusedFields();
+  while (state.KeepRunningBatch(10)) {
+    ::benchmark::DoNotOptimize(serialized_proto);
+    CHECK_OK(load_fn(bound_input_loader, serialized_proto, frame));
+  }
+}
+
+void BM_LoadSerializedProtoIntoScalars_WireFormat(::benchmark::State& state) {
+  ASSERT_OK_AND_ASSIGN(auto input_loader,
+                       ProtoWireFormatLoader::Create(
+                           ::testing_namespace::Root::descriptor()));
+  LoadSerializedProtoIntoScalars(
+      input_loader,
+      [](const BoundInputLoader<absl::string_view>& bound_input_loader,
+         absl::string_view serialized_proto, FramePtr frame) {
+        return bound_input_loader(serialized_proto, frame);
+      },
+      state);
+}
+
+BENCHMARK(BM_LoadSerializedProtoIntoScalars_WireFormat);
+
+// Baseline: parse the whole message and load from it using reflection.
+void BM_LoadSerializedProtoIntoScalars_ParseAndReflection(
+    ::benchmark::State& state) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      ProtoFieldsLoader::Create(::testing_namespace::Root::descriptor()));
+  LoadSerializedProtoIntoScalars(
+      input_loader,
+      [](const BoundInputLoader<google::protobuf::Message>& bound_input_loader,
+         absl::string_view serialized_proto, FramePtr frame) -> absl::Status {
+        ::testing_namespace::Root r;
+        CHECK(r.ParseFromArray(serialized_proto.data(),
+                               serialized_proto.size()));
+        return bound_input_loader(r, frame);
+      },
+      state);
+}
+
+BENCHMARK(BM_LoadSerializedProtoIntoScalars_ParseAndReflection);
+
 }  // namespace
 }  // namespace arolla
@@ -181,6 +181,63 @@ TEST(ProtoFieldsLoaderTest, ProtopathIndexAccess) {
   EXPECT_EQ(frame.Get(inners_as_def_slot), std::nullopt);
 }
 
+TEST(ProtoFieldsLoaderTest, ProtopathsWithCommonPrefix) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      ProtoFieldsLoader::Create(::testing_namespace::Root::descriptor()));
+  using OInt = ::arolla::OptionalValue<int>;
+  using DAInt = arolla::DenseArray<int>;
+
+  FrameLayout::Builder layout_builder;
+  auto inner_a_slot = layout_builder.AddSlot<OInt>();
+  auto inner_inner2_z_slot = layout_builder.AddSlot<OInt>();
+  auto inner_as_slot = layout_builder.AddSlot<DAInt>();
+  auto inners_0_a_slot = layout_builder.AddSlot<OInt>();
+  auto inners_1_a_slot = layout_builder.AddSlot<OInt>();
+  ASSERT_OK_AND_ASSIGN(
+      auto bound_input_loader,
+      input_loader->Bind({
+          {"/inner/a", TypedSlot::FromSlot(inner_a_slot)},
+          {"/inner/inner2/z", TypedSlot::FromSlot(inner_inner2_z_slot)},
+          {"/inner/as", TypedSlot::FromSlot(inner_as_slot)},
+          {"/inners[0]/a", TypedSlot::FromSlot(inners_0_a_slot)},
+          {"/inners[1]/a", TypedSlot::FromSlot(inners_1_a_slot)},
+      }));
+
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  FramePtr frame = alloc.frame();
+
+  ::testing_namespace::Root r;
+  r.mutable_inner()->set_a(57);
+  r.mutable_inner()->add_as(3);
+  r.mutable_inner()->mutable_inner2()->set_z(2);
+  r.add_inners()->set_a(17);
+  r.add_inners()->set_a(19);
+  ASSERT_OK(bound_input_loader(r, frame));
+  EXPECT_EQ(frame.Get(inner_a_slot), 57);
+  EXPECT_EQ(frame.Get(inner_inner2_z_slot), 2);
+  EXPECT_THAT(frame.Get(inner_as_slot), ElementsAre(3));
+  EXPECT_EQ(frame.Get(inners_0_a_slot), 17);
+  EXPECT_EQ(frame.Get(inners_1_a_slot), 19);
+
+  r.mutable_inner()->clear_inner2();
+  r.mutable_inners()->RemoveLast();
+  ASSERT_OK(bound_input_loader(r, frame));
+  EXPECT_EQ(frame.Get(inner_a_slot), 57);
+  EXPECT_EQ(frame.Get(inner_inner2_z_slot), std::nullopt);
+  EXPECT_EQ(frame.Get(inners_0_a_slot), 17);
+  EXPECT_EQ(frame.Get(inners_1_a_slot), std::nullopt);
+
+  r.mutable_inner()->clear_as();
+  r.clear_inners();
+  ASSERT_OK(bound_input_loader(r, frame));
+  EXPECT_EQ(frame.Get(inner_a_slot), 57);
+  EXPECT_THAT(frame.Get(inner_as_slot), IsEmpty());
+  EXPECT_EQ(frame.Get(inners_0_a_slot), std::nullopt);
+  EXPECT_EQ(frame.Get(inners_1_a_slot), std::nullopt);
+}
+
 TEST(ProtoFieldsLoaderTest, ProtopathRepeatedAccess) {
   ASSERT_OK_AND_ASSIGN(
       auto input_loader,
@@ -0,0 +1,553 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/io/proto/proto_wire_format_input_loader.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/base/casts.h"
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/descriptor.h"
+#include "arolla/io/input_loader.h"
+#include "arolla/io/proto/protopath.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/proto/reflection/reader.h"
+#include "arolla/proto/types.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/text.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::google::protobuf::FieldDescriptor;
+
+using proto::StringFieldType;
+using proto_input_loader_impl::IsScalarProtopath;
+using proto_input_loader_impl::ParsedProtopath;
+using proto_input_loader_impl::ParseProtopath;
+
+// See https://protobuf.dev/programming-guides/encoding/.
+enum WireType : uint32_t {
+  kVarint = 0,
+  kFixed64 = 1,
+  kLengthDelimited = 2,
+  kStartGroup = 3,
+  kEndGroup = 4,
+  kFixed32 = 5,
+};
+
+absl::Status MalformedInputError() {
+  return absl::InvalidArgumentError("malformed serialized proto");
+}
+
+// Minimal sequential reader of the proto wire format. All the functions
+// return false if the input is truncated or malformed.
+class WireReader {
+ public:
+  explicit WireReader(absl::string_view data)
+      : ptr_(data.data()), end_(data.data() + data.size()) {}
+
+  bool empty() const { return ptr_ == end_; }
+
+  bool ReadVarint(uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && ptr_ != end_; shift += 7) {
+      uint8_t byte = static_cast<uint8_t>(*ptr_++);
+      result |= uint64_t{byte & 0x7fu} << shift;
+      if (byte < 0x80) {
+        *value = result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadFixed(size_t size, uint64_t* value) {
+    if (static_cast<size_t>(end_ - ptr_) < size) {
+      return false;
+    }
+    uint64_t result = 0;
+    for (size_t i = 0; i < size; ++i) {
+      result |= uint64_t{static_cast<uint8_t>(ptr_[i])} << (8 * i);
+    }
+    ptr_ += size;
+    *value = result;
+    return true;
+  }
+
+  bool ReadLengthDelimited(absl::string_view* value) {
+    uint64_t size;
+    if (!ReadVarint(&size) || static_cast<uint64_t>(end_ - ptr_) < size) {
+      return false;
+    }
+    *value = absl::string_view(ptr_, size);
+    ptr_ += size;
+    return true;
+  }
+
+  // Reads a non length delimited value of the given wire type.
+  bool ReadScalar(uint32_t wire_type, uint64_t* value) {
+    switch (wire_type) {
+      case kVarint:
+        return ReadVarint(value);
+      case kFixed64:
+        return ReadFixed(8, value);
+      case kFixed32:
+        return ReadFixed(4, value);
+      default:
+        return false;
+    }
+  }
+
+  // Skips the value of the field with the given tag.
+  bool SkipField(uint64_t tag) {
+    uint64_t unused_value;
+    absl::string_view unused_payload;
+    switch (tag & 7) {
+      case kVarint:
+      case kFixed64:
+      case kFixed32:
+        return ReadScalar(tag & 7, &unused_value);
+      case kLengthDelimited:
+        return ReadLengthDelimited(&unused_payload);
+      case kStartGroup:
+        return SkipGroup();
+      default:
+        return false;
+    }
+  }
+
+ private:
+  // Skips the rest of a group, including nested groups.
+  bool SkipGroup() {
+    for (int depth = 1; depth > 0;) {
+      uint64_t tag;
+      if (!ReadVarint(&tag)) {
+        return false;
+      }
+      if ((tag & 7) == kStartGroup) {
+        ++depth;
+      } else if ((tag & 7) == kEndGroup) {
+        --depth;
+      } else if (!SkipField(tag)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const char* ptr_;
+  const char* end_;
+};
+
+// Sets the decoded value into the OptionalValue slot at the given offset.
+// `raw` holds the value for varint and fixed wire types, `payload` for length
+// delimited.
+using SetValueFn = void (*)(uint64_t raw, absl::string_view payload,
+                            size_t slot_offset, FramePtr frame);
+using ClearValueFn = void (*)(size_t slot_offset, FramePtr frame);
+
+template <class T>
+FrameLayout::Slot<OptionalValue<T>> SlotFromOffset(size_t slot_offset) {
+  return FrameLayout::Slot<OptionalValue<T>>::UnsafeSlotFromOffset(
+      slot_offset);
+}
+
+template <class T, T (*kDecode)(uint64_t)>
+void SetNumericValue(uint64_t raw, absl::string_view, size_t slot_offset,
+                     FramePtr frame) {
+  frame.Set(SlotFromOffset<T>(slot_offset), kDecode(raw));
+}
+
+template <class T>
+void SetStringValue(uint64_t, absl::string_view payload, size_t slot_offset,
+                    FramePtr frame) {
+  frame.Set(SlotFromOffset<T>(slot_offset), T(payload));
+}
+
+template <class T>
+void ClearValue(size_t slot_offset, FramePtr frame) {
+  frame.Set(SlotFromOffset<T>(slot_offset), std::nullopt);
+}
+
+int32_t DecodeInt32(uint64_t raw) { return static_cast<int32_t>(raw); }
+int64_t DecodeInt64(uint64_t raw) { return static_cast<int64_t>(raw); }
+int64_t DecodeUInt32(uint64_t raw) { return static_cast<uint32_t>(raw); }
+uint64_t DecodeUInt64(uint64_t raw) { return raw; }
+int32_t DecodeSInt32(uint64_t raw) {
+  uint32_t n = static_cast<uint32_t>(raw);
+  return static_cast<int32_t>((n >> 1) ^ (~(n & 1) + 1));
+}
+int64_t DecodeSInt64(uint64_t raw) {
+  return static_cast<int64_t>((raw >> 1) ^ (~(raw & 1) + 1));
+}
+bool DecodeBool(uint64_t raw) { return raw != 0; }
+float DecodeFloat(uint64_t raw) {
+  return absl::bit_cast<float>(static_cast<uint32_t>(raw));
+}
+double DecodeDouble(uint64_t raw) { return absl::bit_cast<double>(raw); }
+
+// Describes how to decode a scalar field.
+struct ScalarCodec {
+  QTypePtr qtype;
+  // Wire type of a single (not packed) value.
+  uint32_t wire_type;
+  SetValueFn set_value;
+  ClearValueFn clear_value;
+};
+
+template <class T, T (*kDecode)(uint64_t)>
+ScalarCodec NumericCodec(uint32_t wire_type) {
+  return ScalarCodec{.qtype = GetOptionalQType<T>(),
+                     .wire_type = wire_type,
+                     .set_value = &SetNumericValue<T, kDecode>,
+                     .clear_value = &ClearValue<T>};
+}
+
+template <class T>
+ScalarCodec StringCodec() {
+  return ScalarCodec{.qtype = GetOptionalQType<T>(),
+                     .wire_type = kLengthDelimited,
+                     .set_value = &SetStringValue<T>,
+                     .clear_value = &ClearValue<T>};
+}
+
+// The type mapping must be consistent with proto::ProtoTypeReader.
+absl::StatusOr<ScalarCodec> GetScalarCodec(const FieldDescriptor* field,
+                                           StringFieldType string_type) {
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_INT32:
+      return NumericCodec<int32_t, DecodeInt32>(kVarint);
+    case FieldDescriptor::TYPE_SINT32:
+      return NumericCodec<int32_t, DecodeSInt32>(kVarint);
+    case FieldDescriptor::TYPE_SFIXED32:
+      return NumericCodec<int32_t, DecodeInt32>(kFixed32);
+    case FieldDescriptor::TYPE_INT64:
+      return NumericCodec<int64_t, DecodeInt64>(kVarint);
+    case FieldDescriptor::TYPE_SINT64:
+      return NumericCodec<int64_t, DecodeSInt64>(kVarint);
+    case FieldDescriptor::TYPE_SFIXED64:
+      return NumericCodec<int64_t, DecodeInt64>(kFixed64);
+    case FieldDescriptor::TYPE_UINT32:
+      return NumericCodec<int64_t, DecodeUInt32>(kVarint);
+    case FieldDescriptor::TYPE_FIXED32:
+      return NumericCodec<int64_t, DecodeUInt32>(kFixed32);
+    case FieldDescriptor::TYPE_UINT64:
+      return NumericCodec<uint64_t, DecodeUInt64>(kVarint);
+    case FieldDescriptor::TYPE_FIXED64:
+      return NumericCodec<uint64_t, DecodeUInt64>(kFixed64);
+    case FieldDescriptor::TYPE_DOUBLE:
+      return NumericCodec<double, DecodeDouble>(kFixed64);
+    case FieldDescriptor::TYPE_FLOAT:
+      return NumericCodec<float, DecodeFloat>(kFixed32);
+    case FieldDescriptor::TYPE_BOOL:
+      return NumericCodec<bool, DecodeBool>(kVarint);
+    case FieldDescriptor::TYPE_STRING:
+      if (string_type == StringFieldType::kText) {
+        return StringCodec<Text>();
+      }
+      return StringCodec<Bytes>();
+    case FieldDescriptor::TYPE_BYTES:
+      return StringCodec<Bytes>();
+    default:
+      return absl::FailedPreconditionError(absl::StrFormat(
+          "unsupported type `%s` of the field `%s`", field->type_name(),
+          field->full_name()));
+  }
+}
+
+// Parses the protopath and verifies that ProtoWireFormatLoader supports it.
+absl::StatusOr<ParsedProtopath> ParseSupportedProtopath(
+    const google::protobuf::Descriptor* descr, absl::string_view protopath) {
+  ASSIGN_OR_RETURN(auto parsed, ParseProtopath(descr, protopath));
+  if (!IsScalarProtopath(parsed)) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "only protopaths selecting a single scalar value are supported by "
+        "ProtoWireFormatLoader, got `%s`",
+        protopath));
+  }
+  for (const FieldDescriptor* field : parsed.fields) {
+    if (field->type() == FieldDescriptor::TYPE_GROUP) {
+      return absl::FailedPreconditionError(absl::StrFormat(
+          "groups are not supported by ProtoWireFormatLoader, got `%s`",
+          protopath));
+    }
+  }
+  return parsed;
+}
+
+std::optional<size_t> GetIndex(const proto::ProtoFieldAccessInfo& access_info) {
+  if (const auto* index_access =
+          std::get_if<proto::RepeatedFieldIndexAccess>(&access_info)) {
+    return index_access->idx;
+  }
+  return std::nullopt;
+}
+
+// Requested fields organized in a tree by protopath prefixes, so that every
+// (sub)message in the input is scanned at most once.
+class WireFormatScanner {
+ public:
+  WireFormatScanner() : nodes_(1) {}
+
+  absl::Status AddProtopath(absl::string_view name,
+                            const ParsedProtopath& protopath, TypedSlot slot,
+                            StringFieldType string_type) {
+    size_t node_id = 0;
+    for (size_t i = 0; i + 1 < protopath.fields.size(); ++i) {
+      FieldEntry& entry = GetOrAddEntry(node_id, protopath.fields[i]);
+      std::optional<size_t> index = GetIndex(protopath.access_infos[i]);
+      auto child = std::find_if(
+          entry.children.begin(), entry.children.end(),
+          [&](const MessageChild& child) { return child.index == index; });
+      if (child != entry.children.end()) {
+        node_id = child->node_id;
+        continue;
+      }
+      // NOTE: `entry` is invalidated by adding a node.
+      size_t child_id = nodes_.size();
+      entry.children.push_back({.index = index, .node_id = child_id});
+      nodes_.emplace_back();
+      node_id = child_id;
+    }
+    const FieldDescriptor* field = protopath.fields.back();
+    ASSIGN_OR_RETURN(auto codec, GetScalarCodec(field, string_type));
+    if (codec.qtype != slot.GetType()) {
+      return absl::FailedPreconditionError(
+          absl::StrFormat("invalid type for slot %s: expected %s, got %s", name,
+                          slot.GetType()->name(), codec.qtype->name()));
+    }
+    FieldEntry& entry = GetOrAddEntry(node_id, field);
+    entry.wire_type = codec.wire_type;
+    entry.is_packable = field->is_repeated() &&
+                        codec.wire_type != kLengthDelimited;
+    entry.leaves.push_back(
+        {.index = GetIndex(protopath.access_infos.back()),
+         .slot_offset = slot.byte_offset(),
+         .set_value = codec.set_value});
+    clear_fns_.push_back({codec.clear_value, slot.byte_offset()});
+    return absl::OkStatus();
+  }
+
+  absl::Status Scan(absl::string_view data, FramePtr frame) const {
+    for (const auto& [clear_value, slot_offset] : clear_fns_) {
+      clear_value(slot_offset, frame);
+    }
+    // Number of the processed occurrences of every field entry.
+    absl::InlinedVector<size_t, 32> counters(entries_count_, 0);
+    return ScanMessage(nodes_[0], data, absl::MakeSpan(counters), frame);
+  }
+
+ private:
+  struct ScalarLeaf {
+    std::optional<size_t> index;  // nullopt for singular fields.
+    size_t slot_offset;
+    SetValueFn set_value;
+  };
+
+  struct MessageChild {
+    std::optional<size_t> index;  // nullopt for singular fields.
+    size_t node_id;
+  };
+
+  // Requested field of a message. It is either a scalar field with `leaves`
+  // or a message field with `children`.
+  struct FieldEntry {
+    size_t counter_id;
+    uint32_t wire_type = kLengthDelimited;
+    bool is_packable = false;
+    std::vector<ScalarLeaf> leaves;
+    std::vector<MessageChild> children;
+  };
+
+  struct MessageNode {
+    // Small field numbers are looked up in a vector, the rest in a hash map.
+    static constexpr uint64_t kMaxDenseFieldNumber = 4096;
+
+    // Returns index of the entry for the field or -1 if it is not requested.
+    int FindId(uint64_t field_number) const {
+      if (field_number < dense_index.size()) {
+        return dense_index[field_number];
+      }
+      if (sparse_index.empty()) {
+        return -1;
+      }
+      auto it = sparse_index.find(field_number);
+      return it == sparse_index.end() ? -1 : it->second;
+    }
+
+    const FieldEntry* Find(uint64_t field_number) const {
+      int id = FindId(field_number);
+      return id < 0 ? nullptr : &entries[id];
+    }
+
+    std::vector<FieldEntry> entries;
+    std::vector<int> dense_index;
+    absl::flat_hash_map<uint64_t, int> sparse_index;
+  };
+
+  FieldEntry& GetOrAddEntry(size_t node_id, const FieldDescriptor* field) {
+    MessageNode& node = nodes_[node_id];
+    uint64_t number = field->number();
+    if (int id = node.FindId(number); id >= 0) {
+      return node.entries[id];
+    }
+    int id = node.entries.size();
+    node.entries.push_back({.counter_id = entries_count_++});
+    if (number < MessageNode::kMaxDenseFieldNumber) {
+      if (node.dense_index.size() <= number) {
+        node.dense_index.resize(number + 1, -1);
+      }
+      node.dense_index[number] = id;
+    } else {
+      node.sparse_index[number] = id;
+    }
+    return node.entries.back();
+  }
+
+  static void SetLeaves(const FieldEntry& entry, uint64_t raw,
+                        absl::string_view payload, size_t occurrence,
+                        FramePtr frame) {
+    for (const auto& leaf : entry.leaves) {
+      if (!leaf.index.has_value() || *leaf.index == occurrence) {
+        leaf.set_value(raw, payload, leaf.slot_offset, frame);
+      }
+    }
+  }
+
+  absl::Status ScanMessage(const MessageNode& node, absl::string_view data,
+                           absl::Span<size_t> counters, FramePtr frame) const {
+    WireReader reader(data);
+    while (!reader.empty()) {
+      uint64_t tag;
+      if (!reader.ReadVarint(&tag)) {
+        return MalformedInputError();
+      }
+      const FieldEntry* entry = node.Find(tag >> 3);
+      uint32_t wire_type = tag & 7;
+      if (entry == nullptr ||
+          (wire_type != entry->wire_type &&
+           !(entry->is_packable && wire_type == kLengthDelimited))) {
+        // Not requested or has unexpected wire type, so would be an unknown
+        // field for the proto parser.
+        if (!reader.SkipField(tag)) {
+          return MalformedInputError();
+        }
+        continue;
+      }
+      size_t& counter = counters[entry->counter_id];
+      if (wire_type != kLengthDelimited) {
+        uint64_t raw;
+        if (!reader.ReadScalar(wire_type, &raw)) {
+          return MalformedInputError();
+        }
+        SetLeaves(*entry, raw, {}, counter++, frame);
+        continue;
+      }
+      absl::string_view payload;
+      if (!reader.ReadLengthDelimited(&payload)) {
+        return MalformedInputError();
+      }
+      if (entry->wire_type != kLengthDelimited) {  // Packed repeated field.
+        WireReader packed_reader(payload);
+        while (!packed_reader.empty()) {
+          uint64_t raw;
+          if (!packed_reader.ReadScalar(entry->wire_type, &raw)) {
+            return MalformedInputError();
+          }
+          SetLeaves(*entry, raw, {}, counter++, frame);
+        }
+        continue;
+      }
+      size_t occurrence = counter++;
+      SetLeaves(*entry, 0, payload, occurrence, frame);
+      for (const auto& child : entry->children) {
+        if (!child.index.has_value() || *child.index == occurrence) {
+          RETURN_IF_ERROR(
+              ScanMessage(nodes_[child.node_id], payload, counters, frame));
+        }
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  std::vector<MessageNode> nodes_;  // nodes_[0] is the root.
+  size_t entries_count_ = 0;
+  std::vector<std::pair<ClearValueFn, size_t>> clear_fns_;
+};
+
+}  // namespace
+
+ProtoWireFormatLoader::ProtoWireFormatLoader(PrivateConstructorTag,
+                                             const google::protobuf::Descriptor* descr,
+                                             proto::StringFieldType string_type)
+    : descr_(descr), string_type_(string_type) {}
+
+absl::StatusOr<InputLoaderPtr<absl::string_view>> ProtoWireFormatLoader::Create(
+    const google::protobuf::Descriptor* descr, proto::StringFieldType string_type) {
+  return std::make_unique<ProtoWireFormatLoader>(PrivateConstructorTag{},
+                                                 descr, string_type);
+}
+
+absl::Nullable<const QType*> ProtoWireFormatLoader::GetQTypeOf(
+    absl::string_view name) const {
+  ASSIGN_OR_RETURN(auto protopath, ParseSupportedProtopath(descr_, name),
+                   nullptr);
+  ASSIGN_OR_RETURN(auto codec,
+                   GetScalarCodec(protopath.fields.back(), string_type_),
+                   nullptr);
+  return codec.qtype;
+}
+
+std::vector<std::string> ProtoWireFormatLoader::SuggestAvailableNames() const {
+  return {};
+}
+
+absl::StatusOr<BoundInputLoader<absl::string_view>>
+ProtoWireFormatLoader::BindImpl(
+    const absl::flat_hash_map<std::string, TypedSlot>& output_slots) const {
+  WireFormatScanner scanner;
+  for (const auto& [name, slot] : output_slots) {
+    ASSIGN_OR_RETURN(auto protopath, ParseSupportedProtopath(descr_, name));
+    RETURN_IF_ERROR(scanner.AddProtopath(name, protopath, slot, string_type_));
+  }
+  return BoundInputLoader<absl::string_view>(
+      [scanner(std::move(scanner))](absl::string_view input, FramePtr frame,
+                                    RawBufferFactory*) -> absl::Status {
+        return scanner.Scan(input, frame);
+      });
+}
+
+}  // namespace arolla
@@ -0,0 +1,80 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_IO_PROTO_PROTO_WIRE_FORMAT_INPUT_LOADER_H_
+#define AROLLA_IO_PROTO_PROTO_WIRE_FORMAT_INPUT_LOADER_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
+#include "arolla/io/input_loader.h"
+#include "arolla/proto/types.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_slot.h"
+
+namespace arolla {
+
+// Dynamic loader from a serialized proto message. The loader scans the wire
+// format for the requested fields and skips everything else, so no
+// `google::protobuf::Message` is ever constructed.
+//
+// Protopaths have the same syntax and produce the same values as in
+// ProtoFieldsLoader, but only the ones selecting a single scalar value are
+// supported, e.g. `/foo/bar`, `/foo[1]/bar`, `/foo/bar[0]`. Groups are not
+// supported.
+//
+// The usual proto parsing rules apply: the last occurrence of a singular
+// scalar field wins, occurrences of a singular submessage field are merged,
+// repeated scalar fields may be either packed or not.
+//
+// The input is validated only to the extent needed to scan it: a truncated or
+// malformed input results in an error, but e.g. invalid UTF-8 in the skipped
+// fields does not.
+class ProtoWireFormatLoader : public InputLoader<absl::string_view> {
+  struct PrivateConstructorTag {};
+
+ public:
+  // Constructs InputLoader for the proto message descriptor.
+  //
+  // `google::protobuf::Descriptor` pointer is stored inside of `ProtoWireFormatLoader`
+  // and `BoundInputLoader`. `google::protobuf::Descriptor` MUST outlive both of them.
+  static absl::StatusOr<InputLoaderPtr<absl::string_view>> Create(
+      const google::protobuf::Descriptor* descr,
+      proto::StringFieldType string_type = proto::StringFieldType::kText);
+
+  absl::Nullable<const QType*> GetQTypeOf(absl::string_view name) const final;
+  std::vector<std::string> SuggestAvailableNames() const final;
+
+  // private
+  explicit ProtoWireFormatLoader(PrivateConstructorTag,
+                                 const google::protobuf::Descriptor* descr,
+                                 proto::StringFieldType string_type);
+
+ private:
+  absl::StatusOr<BoundInputLoader<absl::string_view>> BindImpl(
+      const absl::flat_hash_map<std::string, TypedSlot>& output_slots)
+      const override;
+
+  const google::protobuf::Descriptor* descr_;
+  proto::StringFieldType string_type_;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_IO_PROTO_PROTO_WIRE_FORMAT_INPUT_LOADER_H_
@@ -0,0 +1,286 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/io/proto/proto_wire_format_input_loader.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "arolla/io/input_loader.h"
+#include "arolla/io/testing/matchers.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/proto/test.pb.h"
+#include "arolla/proto/types.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/text.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::InputLoaderSupports;
+using ::arolla::testing::StatusIs;
+using ::testing::HasSubstr;
+using ::testing::IsNull;
+
+TEST(ProtoWireFormatLoaderTest, LoadScalars) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      ProtoWireFormatLoader::Create(::testing_namespace::Root::descriptor()));
+  EXPECT_THAT(input_loader,
+              InputLoaderSupports({
+                  {"/x", GetOptionalQType<int32_t>()},
+                  {"/x_int64", GetOptionalQType<int64_t>()},
+                  {"/x_uint32", GetOptionalQType<int64_t>()},
+                  {"/x_uint64", GetOptionalQType<uint64_t>()},
+                  {"/x_fixed64", GetOptionalQType<uint64_t>()},
+                  {"/x_float", GetOptionalQType<float>()},
+                  {"/x_double", GetOptionalQType<double>()},
+                  {"/str", GetOptionalQType<Text>()},
+                  {"/raw_bytes", GetOptionalQType<Bytes>()},
+                  {"/inner/inner2/z", GetOptionalQType<int32_t>()},
+              }));
+
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  auto x_int64_slot = layout_builder.AddSlot<OptionalValue<int64_t>>();
+  auto x_uint32_slot = layout_builder.AddSlot<OptionalValue<int64_t>>();
+  auto x_uint64_slot = layout_builder.AddSlot<OptionalValue<uint64_t>>();
+  auto x_fixed64_slot = layout_builder.AddSlot<OptionalValue<uint64_t>>();
+  auto x_float_slot = layout_builder.AddSlot<OptionalValue<float>>();
+  auto x_double_slot = layout_builder.AddSlot<OptionalValue<double>>();
+  auto str_slot = layout_builder.AddSlot<OptionalValue<Text>>();
+  auto raw_bytes_slot = layout_builder.AddSlot<OptionalValue<Bytes>>();
+  auto inner_a_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  auto inner_inner2_z_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  ASSERT_OK_AND_ASSIGN(
+      auto bound_input_loader,
+      input_loader->Bind({
+          {"/x", TypedSlot::FromSlot(x_slot)},
+          {"/x_int64", TypedSlot::FromSlot(x_int64_slot)},
+          {"/x_uint32", TypedSlot::FromSlot(x_uint32_slot)},
+          {"/x_uint64", TypedSlot::FromSlot(x_uint64_slot)},
+          {"/x_fixed64", TypedSlot::FromSlot(x_fixed64_slot)},
+          {"/x_float", TypedSlot::FromSlot(x_float_slot)},
+          {"/x_double", TypedSlot::FromSlot(x_double_slot)},
+          {"/str", TypedSlot::FromSlot(str_slot)},
+          {"/raw_bytes", TypedSlot::FromSlot(raw_bytes_slot)},
+          {"/inner/a", TypedSlot::FromSlot(inner_a_slot)},
+          {"/inner/inner2/z", TypedSlot::FromSlot(inner_inner2_z_slot)},
+      }));
+
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  FramePtr frame = alloc.frame();
+
+  ::testing_namespace::Root r;
+  r.set_x(-19);
+  r.set_x_int64(-(int64_t{1} << 40));
+  r.set_x_uint32(uint32_t{1} << 31);
+  r.set_x_uint64(uint64_t{1} << 63);
+  r.set_x_fixed64(57);
+  r.set_x_float(0.5);
+  r.set_x_double(-2.5);
+  r.set_str("3");
+  r.set_raw_bytes("37");
+  r.mutable_inner()->set_a(57);
+  r.mutable_inner()->mutable_inner2()->set_z(2);
+  r.mutable_inner()->set_str("unused");
+  r.add_inners()->set_a(1);
+  r.set_x9(9);
+  ASSERT_OK(bound_input_loader(r.SerializeAsString(), frame));
+  EXPECT_EQ(frame.Get(x_slot), -19);
+  EXPECT_EQ(frame.Get(x_int64_slot), -(int64_t{1} << 40));
+  EXPECT_EQ(frame.Get(x_uint32_slot), int64_t{1} << 31);
+  EXPECT_EQ(frame.Get(x_uint64_slot), uint64_t{1} << 63);
+  EXPECT_EQ(frame.Get(x_fixed64_slot), uint64_t{57});
+  EXPECT_EQ(frame.Get(x_float_slot), 0.5f);
+  EXPECT_EQ(frame.Get(x_double_slot), -2.5);
+  EXPECT_EQ(frame.Get(str_slot), Text("3"));
+  EXPECT_EQ(frame.Get(raw_bytes_slot), Bytes("37"));
+  EXPECT_EQ(frame.Get(inner_a_slot), 57);
+  EXPECT_EQ(frame.Get(inner_inner2_z_slot), 2);
+
+  r.clear_x();
+  r.clear_str();
+  r.mutable_inner()->clear_inner2();
+  ASSERT_OK(bound_input_loader(r.SerializeAsString(), frame));
+  EXPECT_EQ(frame.Get(x_slot), std::nullopt);
+  EXPECT_EQ(frame.Get(str_slot), std::nullopt);
+  EXPECT_EQ(frame.Get(inner_a_slot), 57);
+  EXPECT_EQ(frame.Get(inner_inner2_z_slot), std::nullopt);
+
+  ASSERT_OK(bound_input_loader("", frame));
+  EXPECT_EQ(frame.Get(x_int64_slot), std::nullopt);
+  EXPECT_EQ(frame.Get(raw_bytes_slot), std::nullopt);
+  EXPECT_EQ(frame.Get(inner_a_slot), std::nullopt);
+}
+
+TEST(ProtoWireFormatLoaderTest, LoadStringsAsBytes) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      ProtoWireFormatLoader::Create(::testing_namespace::Root::descriptor(),
+                                    proto::StringFieldType::kBytes));
+  EXPECT_THAT(input_loader,
+              InputLoaderSupports({{"/str", GetOptionalQType<Bytes>()}}));
+}
+
+TEST(ProtoWireFormatLoaderTest, IndexAccess) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      ProtoWireFormatLoader::Create(::testing_namespace::Root::descriptor()));
+
+  FrameLayout::Builder layout_builder;
+  auto ys_0_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  auto ys_2_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  auto inners_1_a_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  auto inners_1_as_1_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  auto repeated_str_1_slot = layout_builder.AddSlot<OptionalValue<Text>>();
+  ASSERT_OK_AND_ASSIGN(
+      auto bound_input_loader,
+      input_loader->Bind({
+          {"/ys[0]", TypedSlot::FromSlot(ys_0_slot)},
+          {"/ys[2]", TypedSlot::FromSlot(ys_2_slot)},
+          {"/inners[1]/a", TypedSlot::FromSlot(inners_1_a_slot)},
+          {"/inners[1]/as[1]", TypedSlot::FromSlot(inners_1_as_1_slot)},
+          {"/repeated_str[1]", TypedSlot::FromSlot(repeated_str_1_slot)},
+      }));
+
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  FramePtr frame = alloc.frame();
+
+  ::testing_namespace::Root r;
+  r.add_ys(5);
+  r.add_ys(7);
+  r.add_ys(9);
+  r.add_inners()->set_a(1);
+  r.add_inners()->set_a(3);
+  r.mutable_inners(1)->add_as(17);
+  r.mutable_inners(1)->add_as(19);
+  r.add_repeated_str("a");
+  r.add_repeated_str("b");
+  ASSERT_OK(bound_input_loader(r.SerializeAsString(), frame));
+  EXPECT_EQ(frame.Get(ys_0_slot), 5);
+  EXPECT_EQ(frame.Get(ys_2_slot), 9);
+  EXPECT_EQ(frame.Get(inners_1_a_slot), 3);
+  EXPECT_EQ(frame.Get(inners_1_as_1_slot), 19);
+  EXPECT_EQ(frame.Get(repeated_str_1_slot), Text("b"));
+
+  r.mutable_ys()->RemoveLast();
+  r.mutable_inners()->RemoveLast();
+  r.mutable_repeated_str()->RemoveLast();
+  ASSERT_OK(bound_input_loader(r.SerializeAsString(), frame));
+  EXPECT_EQ(frame.Get(ys_0_slot), 5);
+  EXPECT_EQ(frame.Get(ys_2_slot), std::nullopt);
+  EXPECT_EQ(frame.Get(inners_1_a_slot), std::nullopt);
+  EXPECT_EQ(frame.Get(inners_1_as_1_slot), std::nullopt);
+  EXPECT_EQ(frame.Get(repeated_str_1_slot), std::nullopt);
+
+  // Packed encoding of ys = [5, 7, 300].
+  ASSERT_OK(bound_input_loader(std::string("\x12\x04\x05\x07\xac\x02", 6),
+                               frame));
+  EXPECT_EQ(frame.Get(ys_0_slot), 5);
+  EXPECT_EQ(frame.Get(ys_2_slot), 300);
+}
+
+TEST(ProtoWireFormatLoaderTest, MergedMessages) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      ProtoWireFormatLoader::Create(::testing_namespace::Root::descriptor()));
+
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  auto inner_a_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  auto inner_as_1_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  ASSERT_OK_AND_ASSIGN(
+      auto bound_input_loader,
+      input_loader->Bind({
+          {"/x", TypedSlot::FromSlot(x_slot)},
+          {"/inner/a", TypedSlot::FromSlot(inner_a_slot)},
+          {"/inner/as[1]", TypedSlot::FromSlot(inner_as_1_slot)},
+      }));
+
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  FramePtr frame = alloc.frame();
+
+  // Concatenation of serialized messages is equivalent to merging them.
+  ::testing_namespace::Root r1;
+  r1.set_x(1);
+  r1.mutable_inner()->set_a(3);
+  r1.mutable_inner()->add_as(5);
+  ::testing_namespace::Root r2;
+  r2.set_x(2);
+  r2.mutable_inner()->add_as(7);
+  std::string input = r1.SerializeAsString() + r2.SerializeAsString();
+  ::testing_namespace::Root merged;
+  ASSERT_TRUE(merged.ParseFromString(input));
+
+  ASSERT_OK(bound_input_loader(input, frame));
+  EXPECT_EQ(frame.Get(x_slot), merged.x());
+  EXPECT_EQ(frame.Get(inner_a_slot), merged.inner().a());
+  EXPECT_EQ(frame.Get(inner_as_1_slot), merged.inner().as(1));
+}
+
+TEST(ProtoWireFormatLoaderTest, Errors) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      ProtoWireFormatLoader::Create(::testing_namespace::Root::descriptor()));
+  EXPECT_THAT(input_loader->GetQTypeOf("/ys"), IsNull());
+  EXPECT_THAT(input_loader->GetQTypeOf("/ys/@size"), IsNull());
+  EXPECT_THAT(input_loader->GetQTypeOf("/inner"), IsNull());
+  EXPECT_THAT(input_loader->GetQTypeOf("/unknown_field"), IsNull());
+
+  FrameLayout::Builder layout_builder;
+  auto x_slot = layout_builder.AddSlot<OptionalValue<int32_t>>();
+  auto int64_slot = layout_builder.AddSlot<OptionalValue<int64_t>>();
+  EXPECT_THAT(input_loader->Bind({{"/ys", TypedSlot::FromSlot(x_slot)}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unknown inputs: /ys")));
+  EXPECT_THAT(input_loader->Bind({{"/x", TypedSlot::FromSlot(int64_slot)}}),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       HasSubstr("slot types mismatch")));
+
+  ASSERT_OK_AND_ASSIGN(
+      auto bound_input_loader,
+      input_loader->Bind({{"/x", TypedSlot::FromSlot(x_slot)}}));
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  FramePtr frame = alloc.frame();
+
+  ::testing_namespace::Root r;
+  r.set_x(1);
+  r.set_str("abc");
+  std::string input = r.SerializeAsString();
+  EXPECT_THAT(bound_input_loader(input.substr(0, input.size() - 1), frame),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("malformed serialized proto")));
+  EXPECT_THAT(bound_input_loader("\xff", frame),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("malformed serialized proto")));
+}
+
+}  // namespace
+}  // namespace arolla
@@ -0,0 +1,158 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/io/proto/protopath.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "google/protobuf/descriptor.h"
+#include "arolla/proto/reflection/reader.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::proto_input_loader_impl {
+namespace {
+
+// Returns field name and extra access information
+absl::StatusOr<std::pair<std::string, proto::ProtoFieldAccessInfo>>
+ParseProtopathElement(absl::string_view path_element) {
+  bool is_size_element = absl::ConsumeSuffix(&path_element, "@size");
+  if (!absl::StrContains(path_element, '[') &&
+      !absl::StrContains(path_element, ']')) {
+    if (is_size_element) {
+      return std::pair{std::string(path_element),
+                       proto::RepeatedFieldSizeAccess{}};
+    } else {
+      return std::pair{std::string(path_element),
+                       proto::ProtoFieldAccessInfo{}};
+    }
+  }
+  if (is_size_element) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "@size accessor does not accept field access by index, got %s",
+        path_element));
+  }
+  // Parsing index access in form of "field_name[\d+]".
+  std::vector<absl::string_view> splits =
+      absl::StrSplit(path_element, absl::ByAnyChar("[]"), absl::SkipEmpty());
+  auto error = [&]() {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "cannot parse access by index protopath element: ", path_element));
+  };
+  if (splits.size() != 2) {
+    return error();
+  }
+  std::string field_name(splits[0]);
+
+  size_t idx = static_cast<size_t>(-1);
+  if (!absl::SimpleAtoi(splits[1], &idx)) {
+    return error();
+  }
+  if (absl::StrFormat("%s[%d]", field_name, idx) != path_element) {
+    return error();
+  }
+  return std::pair{field_name, proto::RepeatedFieldIndexAccess{idx}};
+}
+
+}  // namespace
+
+absl::StatusOr<ParsedProtopath> ParseProtopath(
+    const google::protobuf::Descriptor* descr, absl::string_view protopath) {
+  if (!absl::ConsumePrefix(&protopath, "/")) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "protopath must start with '/', got: \"%s\"", protopath));
+  }
+  std::vector<std::string> elements = absl::StrSplit(protopath, '/');
+  if (elements.empty()) {
+    return absl::FailedPreconditionError(
+        absl::StrFormat("empty protopath: %s", protopath));
+  }
+  if (elements.back() == "@size" && elements.size() > 1) {
+    elements.pop_back();
+    elements.back().append("@size");
+  }
+  std::vector<const google::protobuf::FieldDescriptor*> fields;
+  std::vector<proto::ProtoFieldAccessInfo> access_infos;
+  const google::protobuf::FieldDescriptor* previous_field = nullptr;
+  for (absl::string_view path_element : elements) {
+    ASSIGN_OR_RETURN((auto [field_name, access_info]),
+                     ParseProtopathElement(path_element));
+    const google::protobuf::Descriptor* current_descr;
+    if (previous_field != nullptr) {
+      current_descr = previous_field->message_type();
+      if (current_descr == nullptr) {
+        return absl::FailedPreconditionError(absl::StrFormat(
+            "unexpected type of the field `%s` in the protopath "
+            "`%s`: expected a message",
+            previous_field->name(), protopath));
+      }
+    } else {
+      current_descr = descr;
+    }
+    const google::protobuf::FieldDescriptor* field_descriptor =
+        current_descr->FindFieldByName(field_name);
+    if (field_descriptor == nullptr) {
+      return absl::FailedPreconditionError(absl::StrFormat(
+          "unknown field `%s` in the message `%s` in the protopath `%s`.",
+          field_name, current_descr->full_name(), protopath));
+    }
+    if (field_descriptor->enum_type() != nullptr ||
+        field_descriptor->is_extension()) {
+      return absl::FailedPreconditionError(absl::StrFormat(
+          "unsupported type `%s` of the field `%s` in the protopath `%s`.",
+          field_descriptor->type_name(), field_descriptor->name(), protopath));
+    }
+    if (field_descriptor->is_repeated() &&
+        std::holds_alternative<proto::RegularFieldAccess>(access_info)) {
+      access_info = proto::RepeatedFieldAccess{};
+    }
+    fields.push_back(field_descriptor);
+    access_infos.push_back(access_info);
+    previous_field = field_descriptor;
+  }
+  bool is_size_protopath =
+      std::holds_alternative<proto::RepeatedFieldSizeAccess>(
+          access_infos.back());
+  if (previous_field->message_type() != nullptr && !is_size_protopath) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "unexpected type of the last field in protopath `%s`", protopath));
+  }
+  return ParsedProtopath{std::move(fields), std::move(access_infos)};
+}
+
+bool IsScalarProtopath(const ParsedProtopath& protopath) {
+  return std::all_of(protopath.access_infos.begin(),
+                     protopath.access_infos.end(),
+                     [](const proto::ProtoFieldAccessInfo& access_info) {
+                       return std::holds_alternative<
+                                  proto::RegularFieldAccess>(access_info) ||
+                              std::holds_alternative<
+                                  proto::RepeatedFieldIndexAccess>(access_info);
+                     });
+}
+
+}  // namespace arolla::proto_input_loader_impl
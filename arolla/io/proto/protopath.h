@@ -0,0 +1,44 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_IO_PROTO_PROTOPATH_H_
+#define AROLLA_IO_PROTO_PROTOPATH_H_
+
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
+#include "arolla/proto/reflection/reader.h"
+
+namespace arolla::proto_input_loader_impl {
+
+// Fields and access information corresponding to a protopath.
+struct ParsedProtopath {
+  std::vector<const google::protobuf::FieldDescriptor*> fields;
+  std::vector<proto::ProtoFieldAccessInfo> access_infos;
+};
+
+// Parses protopath in the format documented in ProtoFieldsLoader and resolves
+// its fields starting from the descriptor `descr`.
+absl::StatusOr<ParsedProtopath> ParseProtopath(
+    const google::protobuf::Descriptor* descr, absl::string_view protopath);
+
+// Returns true if the protopath selects at most one scalar value, i.e. it can
+// be read into an OptionalValue.
+bool IsScalarProtopath(const ParsedProtopath& protopath);
+
+}  // namespace arolla::proto_input_loader_impl
+
+#endif  // AROLLA_IO_PROTO_PROTOPATH_H_
@@ -16,6 +16,7 @@
 #define AROLLA_IO_PROTO_TESTING_BENCHMARK_UTIL_H_
 
 #include <cstddef>
+#include <string>
 #include <utility>
 
 #include "benchmark/benchmark.h"
@@ -30,6 +31,8 @@
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/proto/test.pb.h"
 #include "arolla/qtype/qtype.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/testing/benchmark_perf_counters.h"
 
 namespace arolla::testing {
 namespace benchmark {
@@ -82,6 +85,7 @@ void LoadProtoIntoScalars(const InputLoaderPtr<T>& input_loader,
   r.set_x8(8);
   r.set_x9(9);
 
+  BenchmarkPerfCounters perf_counters(state);
   while (state.KeepRunningBatch(10)) {
     ::benchmark::DoNotOptimize(r);
     CHECK_OK(bound_input_loader(r, frame));
@@ -97,9 +101,62 @@ void WriteScalarsIntoProto(
 // Uses the given InputLoader to load fields under inner/inner2/root_reference
 // x0, x1... x9 of proto/test.proto into scalar slots of a FrameLayout
 // for a benchmark test.
-void LoadNestedDepth4ProtoIntoScalars(
-    const InputLoaderPtr<::testing_namespace::Root>& input_loader,
-    ::benchmark::State& state);
+template <class T>
+void LoadNestedDepth4ProtoIntoScalars(const InputLoaderPtr<T>& input_loader,
+                                      ::benchmark::State& state) {
+  using oint = ::arolla::OptionalValue<int>;
+
+  FrameLayout::Builder layout_builder;
+  auto x0_slot = layout_builder.AddSlot<oint>();
+  auto x1_slot = layout_builder.AddSlot<oint>();
+  auto x2_slot = layout_builder.AddSlot<oint>();
+  auto x3_slot = layout_builder.AddSlot<oint>();
+  auto x4_slot = layout_builder.AddSlot<oint>();
+  auto x5_slot = layout_builder.AddSlot<oint>();
+  auto x6_slot = layout_builder.AddSlot<oint>();
+  auto x7_slot = layout_builder.AddSlot<oint>();
+  auto x8_slot = layout_builder.AddSlot<oint>();
+  auto x9_slot = layout_builder.AddSlot<oint>();
+  std::string prefix = "/inner/inner2/root_reference/";
+  auto bound_input_loader =
+      input_loader
+          ->Bind({
+              {prefix + "x0", TypedSlot::FromSlot(x0_slot)},
+              {prefix + "x1", TypedSlot::FromSlot(x1_slot)},
+              {prefix + "x2", TypedSlot::FromSlot(x2_slot)},
+              {prefix + "x3", TypedSlot::FromSlot(x3_slot)},
+              {prefix + "x4", TypedSlot::FromSlot(x4_slot)},
+              {prefix + "x5", TypedSlot::FromSlot(x5_slot)},
+              {prefix + "x6", TypedSlot::FromSlot(x6_slot)},
+              {prefix + "x7", TypedSlot::FromSlot(x7_slot)},
+              {prefix + "x8", TypedSlot::FromSlot(x8_slot)},
+              {prefix + "x9", TypedSlot::FromSlot(x9_slot)},
+          })
+          .value();
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  FramePtr frame = alloc.frame();
+
+  ::testing_namespace::Root root;
+  ::testing_namespace::Root& r =
+      *root.mutable_inner()->mutable_inner2()->mutable_root_reference();
+  r.set_x0(0);
+  r.set_x1(1);
+  r.set_x2(2);
+  r.set_x3(3);
+  r.set_x4(4);
+  r.set_x5(5);
+  r.set_x6(6);
+  r.set_x7(7);
+  r.set_x8(8);
+  r.set_x9(9);
+
+  BenchmarkPerfCounters perf_counters(state);
+  while (state.KeepRunningBatch(10)) {
+    ::benchmark::DoNotOptimize(root);
+    CHECK_OK(bound_input_loader(root, frame));
+  }
+}
 
 // Uses the given InputLoader to load fields under
 // Ext::testing_extension_namespace.BenchmarkExtension.bench_ext
@@ -164,6 +221,7 @@ void LoadProtoIntoArrays(
   inners1->set_a(7);
   inners1->mutable_inner2()->set_z(7);
 
+  BenchmarkPerfCounters perf_counters(state);
   while (state.KeepRunningBatch(5)) {
     ::benchmark::DoNotOptimize(r);
     CHECK_OK(bound_input_loader(r, frame, buffer_factory));
@@ -89,23 +89,67 @@ StructIO::StructIO(
       offsets_other_[t].emplace_back(struct_offset, frame_offset);
     }
   }
+  CoalesceTriviallyCopyableOffsets();
   // Optimization; doesn't affect the behavior. The idea is that sorting should
   // reduce cache misses when accessing a huge struct.
-  std::sort(offsets_bool_.begin(), offsets_bool_.end());
-  std::sort(offsets_32bits_.begin(), offsets_32bits_.end());
-  std::sort(offsets_64bits_.begin(), offsets_64bits_.end());
   for (auto& [_, v] : offsets_other_) {
     std::sort(v.begin(), v.end());
   }
-  // NOTE: Idea for future optimization: find sequential 32bits
-  // offsets (i.e. o1.first+4==o2.first && o1.second+4==o2.second) and move them
-  // to offsets_64bits_.
-  // NOTE: Consider to concatenate all offsets*_ into a single
-  // vector and a starting offset for each size.
+}
+
+// Merges bool, 32 and 64 bits values that are adjacent both in the struct and
+// in the frame into a single range. E.g. two neighbour int32_t fields become a
+// single 64 bits copy, and long runs of fields become a single memcpy.
+void StructIO::CoalesceTriviallyCopyableOffsets() {
+  std::vector<CopyRange> values;
+  values.reserve(offsets_bool_.size() + offsets_32bits_.size() +
+                 offsets_64bits_.size());
+  for (const auto& [offsets, size] :
+       {std::pair{&offsets_bool_, sizeof(bool)},
+        std::pair{&offsets_32bits_, size_t{4}},
+        std::pair{&offsets_64bits_, size_t{8}}}) {
+    for (const auto& [struct_offset, frame_offset] : *offsets) {
+      values.push_back({struct_offset, frame_offset, size});
+    }
+    offsets->clear();
+  }
+  // Sorting by the struct offset also reduces cache misses when accessing
+  // a huge struct.
+  std::sort(values.begin(), values.end(),
+            [](const CopyRange& a, const CopyRange& b) {
+              return a.struct_offset < b.struct_offset;
+            });
+  auto flush = [this](const CopyRange& range) {
+    switch (range.size) {
+      case sizeof(bool):
+        offsets_bool_.emplace_back(range.struct_offset, range.frame_offset);
+        break;
+      case 4:
+        offsets_32bits_.emplace_back(range.struct_offset, range.frame_offset);
+        break;
+      case 8:
+        offsets_64bits_.emplace_back(range.struct_offset, range.frame_offset);
+        break;
+      default:
+        ranges_.push_back(range);
+    }
+  };
+  for (size_t i = 0; i < values.size();) {
+    CopyRange range = values[i++];
+    while (i < values.size() &&
+           values[i].struct_offset == range.struct_offset + range.size &&
+           values[i].frame_offset == range.frame_offset + range.size) {
+      range.size += values[i++].size;
+    }
+    flush(range);
+  }
 }
 
 void StructIO::CopyStructToFrame(const void* struct_ptr, FramePtr frame) const {
   const char* src_base = reinterpret_cast<const char*>(struct_ptr);
+  for (const auto& [src, dst, size] : ranges_) {
+    std::memcpy(frame.GetRawPointer(dst), src_base + src, size);
+  }
   for (const auto& [src, dst] : offsets_bool_) {
     std::memcpy(frame.GetRawPointer(dst), src_base + src, sizeof(bool));
   }
@@ -124,6 +168,9 @@ void StructIO::CopyStructToFrame(const void* struct_ptr, FramePtr frame) const {
 
 void StructIO::CopyFrameToStruct(ConstFramePtr frame, void* struct_ptr) const {
   char* dst_base = reinterpret_cast<char*>(struct_ptr);
+  for (const auto& [dst, src, size] : ranges_) {
+    std::memcpy(dst_base + dst, frame.GetRawPointer(src), size);
+  }
   for (const auto& [dst, src] : offsets_bool_) {
     std::memcpy(dst_base + dst, frame.GetRawPointer(src), sizeof(bool));
   }
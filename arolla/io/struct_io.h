@@ -50,6 +50,16 @@ class StructIO {
 
  private:
   using Offsets = std::vector<std::pair<size_t, size_t>>;
+  // Memory range that is contiguous both in the struct and in the frame.
+  struct CopyRange {
+    size_t struct_offset;
+    size_t frame_offset;
+    size_t size;
+  };
+
+  void CoalesceTriviallyCopyableOffsets();
+
+  std::vector<CopyRange> ranges_;
   Offsets offsets_bool_;
   Offsets offsets_32bits_;
   Offsets offsets_64bits_;
@@ -198,6 +198,94 @@ TEST(StructIO, ComplicatedQType) {
   EXPECT_EQ(ts.f, Bytes("abacaba"));
 }
 
+struct AdjacentFieldsStruct {
+  int32_t a = 1;
+  int32_t b = 2;
+  float c = 3.0f;
+  bool d = true;
+  bool e = false;
+  int64_t f = 6;
+  OptionalValue<int32_t> g = 7;
+  int32_t h = 8;
+};
+
+TEST(StructIO, AdjacentFields) {
+  absl::flat_hash_map<std::string, TypedSlot> struct_slots{
+    STRUCT_SLOT(AdjacentFieldsStruct, a),
+    STRUCT_SLOT(AdjacentFieldsStruct, b),
+    STRUCT_SLOT(AdjacentFieldsStruct, c),
+    STRUCT_SLOT(AdjacentFieldsStruct, d),
+    STRUCT_SLOT(AdjacentFieldsStruct, e),
+    STRUCT_SLOT(AdjacentFieldsStruct, f),
+    STRUCT_SLOT(AdjacentFieldsStruct, g),
+    STRUCT_SLOT(AdjacentFieldsStruct, h),
+  };
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      StructInputLoader<AdjacentFieldsStruct>::Create(struct_slots));
+  ASSERT_OK_AND_ASSIGN(
+      auto slot_listener,
+      StructSlotListener<AdjacentFieldsStruct>::Create(struct_slots));
+
+  // a, b, c, d are adjacent in both the struct and the frame. "e" is not
+  // bound, so it must not be touched. f, g, h are adjacent again.
+  FrameLayout::Builder bldr;
+  auto a_slot = bldr.AddSlot<int32_t>();
+  auto b_slot = bldr.AddSlot<int32_t>();
+  auto c_slot = bldr.AddSlot<float>();
+  auto d_slot = bldr.AddSlot<bool>();
+  auto f_slot = bldr.AddSlot<int64_t>();
+  auto g_slot = bldr.AddSlot<OptionalValue<int32_t>>();
+  auto h_slot = bldr.AddSlot<int32_t>();
+  FrameLayout layout = std::move(bldr).Build();
+
+  absl::flat_hash_map<std::string, TypedSlot> frame_slots{
+    {"a", TypedSlot::FromSlot(a_slot)},
+    {"b", TypedSlot::FromSlot(b_slot)},
+    {"c", TypedSlot::FromSlot(c_slot)},
+    {"d", TypedSlot::FromSlot(d_slot)},
+    {"f", TypedSlot::FromSlot(f_slot)},
+    {"g", TypedSlot::FromSlot(g_slot)},
+    {"h", TypedSlot::FromSlot(h_slot)},
+  };
+  ASSERT_OK_AND_ASSIGN(auto bound_loader, input_loader->Bind(frame_slots));
+  ASSERT_OK_AND_ASSIGN(auto bound_listener, slot_listener->Bind(frame_slots));
+
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  AdjacentFieldsStruct s;
+
+  ASSERT_OK(bound_loader(s, frame));
+
+  EXPECT_EQ(frame.Get(a_slot), 1);
+  EXPECT_EQ(frame.Get(b_slot), 2);
+  EXPECT_EQ(frame.Get(c_slot), 3.0f);
+  EXPECT_EQ(frame.Get(d_slot), true);
+  EXPECT_EQ(frame.Get(f_slot), 6);
+  EXPECT_EQ(frame.Get(g_slot), 7);
+  EXPECT_EQ(frame.Get(h_slot), 8);
+
+  frame.Set(a_slot, 10);
+  frame.Set(b_slot, 20);
+  frame.Set(c_slot, 30.0f);
+  frame.Set(d_slot, false);
+  frame.Set(f_slot, 60);
+  frame.Set(g_slot, std::nullopt);
+  frame.Set(h_slot, 80);
+  s.e = true;
+
+  ASSERT_OK(bound_listener(frame, &s));
+
+  EXPECT_EQ(s.a, 10);
+  EXPECT_EQ(s.b, 20);
+  EXPECT_EQ(s.c, 30.0f);
+  EXPECT_EQ(s.d, false);
+  EXPECT_EQ(s.e, true);
+  EXPECT_EQ(s.f, 60);
+  EXPECT_EQ(s.g, std::nullopt);
+  EXPECT_EQ(s.h, 80);
+}
+
 TEST(StructIO, Errors) {
   absl::flat_hash_map<std::string, TypedSlot> struct_slots1{
       {"a", TypedSlot::UnsafeFromOffset(GetQType<int32_t>(), 0)},
@@ -12,13 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <algorithm>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
 #include "arolla/io/accessors_input_loader.h"
 #include "arolla/io/input_loader.h"
 #include "arolla/io/wildcard_input_loader.h"
@@ -175,5 +179,64 @@ void BM_LoadWildcardFromMap(::benchmark::State& state) {
 
 BENCHMARK(BM_LoadWildcardFromMap);
 
+using KeyValue = std::pair<std::string, float>;
+
+// Loads 300 of the features from an input with 10000 entries, either via
+// lookups or via a single pass over the input (BuildFromMapIteration).
+template <class Input, bool kIterate>
+void BM_LoadWildcardFromLargeMap(::benchmark::State& state) {
+  constexpr int kInputSize = 10000;
+  constexpr int kRequestedSize = 300;
+
+  InputLoaderPtr<Input> input_loader;
+  if constexpr (kIterate) {
+    input_loader =
+        WildcardInputLoader<Input>::BuildFromMapIteration(0.0f).value();
+  } else {
+    input_loader =
+        WildcardInputLoader<Input>::Build([](const Input& i,
+                                             const std::string& k) {
+          if constexpr (std::is_same_v<Input, std::vector<KeyValue>>) {
+            auto it = std::find_if(i.begin(), i.end(), [&](const auto& kv) {
+              return kv.first == k;
+            });
+            return it == i.end() ? 0.0f : it->second;
+          } else {
+            auto it = i.find(k);
+            return it == i.end() ? 0.0f : it->second;
+          }
+        }).value();
+  }
+
+  FrameLayout::Builder layout_builder;
+  absl::flat_hash_map<std::string, TypedSlot> slots;
+  for (int i = 0; i < kRequestedSize; ++i) {
+    slots.emplace(absl::StrCat("x", i * (kInputSize / kRequestedSize)),
+                  TypedSlot::FromSlot(layout_builder.AddSlot<float>()));
+  }
+  auto bound_input_loader = input_loader->Bind(slots).value();
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  FramePtr frame = alloc.frame();
+
+  Input r;
+  for (int i = 0; i < kInputSize; ++i) {
+    r.insert(r.end(), {absl::StrCat("x", i), 0.5f * i});
+  }
+  while (state.KeepRunningBatch(kRequestedSize)) {
+    ::benchmark::DoNotOptimize(r);
+    CHECK_OK(bound_input_loader(r, frame));
+  }
+}
+
+BENCHMARK(BM_LoadWildcardFromLargeMap<absl::flat_hash_map<std::string, float>,
+                                      /*kIterate=*/false>);
+BENCHMARK(BM_LoadWildcardFromLargeMap<absl::flat_hash_map<std::string, float>,
+                                      /*kIterate=*/true>);
+BENCHMARK(BM_LoadWildcardFromLargeMap<std::vector<KeyValue>,
+                                      /*kIterate=*/false>);
+BENCHMARK(BM_LoadWildcardFromLargeMap<std::vector<KeyValue>,
+                                      /*kIterate=*/true>);
+
 }  // namespace
 }  // namespace arolla
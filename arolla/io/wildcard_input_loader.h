@@ -327,6 +327,41 @@ class WildcardInputLoader final : public InputLoader<Input> {
                                  std::move(name_suggestions));
   }
 
+  // Creates WildcardInputLoader for a map-like Input, i.e. iterable over
+  // (key, value) pairs with keys convertible to absl::string_view and values
+  // convertible to OutT. E.g. absl::flat_hash_map<std::string, float>,
+  // std::vector<std::pair<std::string, float>> or a proto map field.
+  //
+  // Instead of looking up each of the requested keys in the input, the bound
+  // loader indexes the requested keys during Bind and dispatches the input
+  // entries to their slots in a single pass over the input. This is
+  // beneficial for inputs without efficient lookup (e.g. vectors of pairs)
+  // or when a large fraction of the input entries is requested. For a hash
+  // map with a small fraction of requested keys Build with a `find` accessor
+  // is faster (see BM_LoadWildcardFromLargeMap). If a key occurs in the input
+  // several times, the last value wins.
+  //
+  // Args:
+  //  missing_value: the value to set for the keys missing in the input.
+  //  name_format: used to convert lookup key into the input name.
+  //
+  template <class OutT>
+  static absl::StatusOr<InputLoaderPtr<Input>> BuildFromMapIteration(
+      OutT missing_value,
+      absl::ParsedFormat<'s'> name_format = absl::ParsedFormat<'s'>("%s")) {
+    auto name2key = input_loader_impl::MakeNameToKeyFn(name_format);
+    auto get_output_qtype_fn = [name2key](absl::string_view name) {
+      return name2key(name).has_value() ? GetQType<OutT>() : nullptr;
+    };
+    // Not using make_unique to avoid binary size blowup.
+    return InputLoaderPtr<Input>(
+        static_cast<InputLoader<Input>*>(new WildcardInputLoader(
+            CreateMapIterationBindFn(std::move(missing_value),
+                                     std::move(name2key)),
+            std::move(get_output_qtype_fn),
+            {absl::StrFormat(name_format, "*")})));
+  }
+
   absl::Nullable<const QType*> GetQTypeOf(absl::string_view name) const final {
     return get_qtype_of_fn_(name);
   }
@@ -455,6 +490,44 @@ class WildcardInputLoader final : public InputLoader<Input> {
     };
   }
 
+  template <typename OutT, typename Name2KeyFn>
+  static auto CreateMapIterationBindFn(OutT missing_value,
+                                       Name2KeyFn name2key) {
+    return [missing_value(std::move(missing_value)),
+            name2key(std::move(name2key))](
+               const absl::flat_hash_map<std::string, TypedSlot>& output_slots)
+               -> absl::StatusOr<BoundInputLoader<Input>> {
+      absl::flat_hash_map<std::string, FrameLayout::Slot<OutT>> key_to_slot;
+      std::vector<FrameLayout::Slot<OutT>> slots;
+      key_to_slot.reserve(output_slots.size());
+      slots.reserve(output_slots.size());
+      for (const auto& [slot_name, typed_slot] : output_slots) {
+        auto key = name2key(slot_name);
+        if (!key.has_value()) {
+          continue;
+        }
+        ASSIGN_OR_RETURN(auto slot, typed_slot.template ToSlot<OutT>());
+        key_to_slot.emplace(*std::move(key), slot);
+        slots.push_back(slot);
+      }
+      return BoundInputLoader<Input>(
+          [key_to_slot(std::move(key_to_slot)), slots(std::move(slots)),
+           missing_value](const Input& input, FramePtr frame,
+                          RawBufferFactory*) -> absl::Status {
+            for (const auto& slot : slots) {
+              frame.Set(slot, missing_value);
+            }
+            for (const auto& [key, value] : input) {
+              if (auto it = key_to_slot.find(absl::string_view(key));
+                  it != key_to_slot.end()) {
+                frame.Set(it->second, OutT(value));
+              }
+            }
+            return absl::OkStatus();
+          });
+    };
+  }
+
   std::function<absl::StatusOr<BoundInputLoader<Input>>(
       const absl::flat_hash_map<std::string, TypedSlot>&)>
       bind_fn_;
@@ -193,6 +193,56 @@ TEST(WildcardInputLoaderTest, FromMapNoError) {
   EXPECT_EQ(alloc.frame().Get(b_slot), std::nullopt);
 }
 
+TEST(WildcardInputLoaderTest, FromMapIteration) {
+  using OInt = OptionalValue<int>;
+  auto oi32 = GetQType<OInt>();
+  using Input = std::vector<std::pair<std::string, int>>;
+  ASSERT_OK_AND_ASSIGN(auto input_loader,
+                       WildcardInputLoader<Input>::BuildFromMapIteration(
+                           OInt{}, absl::ParsedFormat<'s'>("from_map_%s")));
+  EXPECT_THAT(input_loader, InputLoaderSupports(
+                                {{"from_map_a", oi32}, {"from_map_b", oi32}}));
+  EXPECT_THAT(input_loader->SuggestAvailableNames(), ElementsAre("from_map_*"));
+
+  FrameLayout::Builder layout_builder;
+  auto a_slot = layout_builder.AddSlot<OInt>();
+  auto b_slot = layout_builder.AddSlot<OInt>();
+  ASSERT_OK_AND_ASSIGN(BoundInputLoader<Input> bound_input_loader,
+                       input_loader->Bind({
+                           {"from_map_a", TypedSlot::FromSlot(a_slot)},
+                           {"from_map_b", TypedSlot::FromSlot(b_slot)},
+                       }));
+
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+
+  ASSERT_OK(bound_input_loader({{"a", 5}, {"c", 6}, {"b", 7}}, alloc.frame()));
+  EXPECT_EQ(alloc.frame().Get(a_slot), 5);
+  EXPECT_EQ(alloc.frame().Get(b_slot), 7);
+
+  ASSERT_OK(bound_input_loader({{"a", 7}, {"a", 8}}, alloc.frame()));
+  EXPECT_EQ(alloc.frame().Get(a_slot), 8);
+  EXPECT_EQ(alloc.frame().Get(b_slot), std::nullopt);
+
+  using MapInput = absl::flat_hash_map<std::string, int>;
+  ASSERT_OK_AND_ASSIGN(
+      auto map_input_loader,
+      WildcardInputLoader<MapInput>::BuildFromMapIteration(-1));
+  FrameLayout::Builder map_layout_builder;
+  auto x_slot = map_layout_builder.AddSlot<int>();
+  auto y_slot = map_layout_builder.AddSlot<int>();
+  ASSERT_OK_AND_ASSIGN(auto bound_map_input_loader,
+                       map_input_loader->Bind({
+                           {"x", TypedSlot::FromSlot(x_slot)},
+                           {"y", TypedSlot::FromSlot(y_slot)},
+                       }));
+  FrameLayout map_memory_layout = std::move(map_layout_builder).Build();
+  MemoryAllocation map_alloc(&map_memory_layout);
+  ASSERT_OK(bound_map_input_loader({{"x", 1}, {"z", 2}}, map_alloc.frame()));
+  EXPECT_EQ(map_alloc.frame().Get(x_slot), 1);
+  EXPECT_EQ(map_alloc.frame().Get(y_slot), -1);
+}
+
 TEST(WildcardInputLoaderTest, AccessorExecutionOrderIsDetemenistic) {
   std::vector<std::string> accessor_calls_order;
   auto accessor = [&](const DummyInput& input, const std::string& key) -> int {
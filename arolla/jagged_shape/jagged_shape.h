@@ -18,13 +18,16 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/util/fingerprint.h"
@@ -207,13 +210,18 @@ class JaggedShape : public RefcountedBase {
     EdgeVec new_edges;
     new_edges.reserve(rank() - (to - from) + 1);
     new_edges.insert(new_edges.end(), edges_.begin(), edges_.begin() + from);
-    if (from == to) {
+    if (from == rank()) {
+      // Append a unit-edge.
+      new_edges.push_back(GetSuffixEdge(from, buf_factory));
+    } else if (from == to) {
       // Insert a unit-edge at `from`.
       int64_t parent_size = from == 0 ? 1 : edges_[from - 1].child_size();
       auto unit_edge =
           Edge::FromUniformGroups(parent_size, /*group_size=*/1, buf_factory);
       DCHECK_OK(unit_edge.status());  // Cannot fail for valid shapes.
       new_edges.push_back(std::move(*unit_edge));
+    } else if (to == rank()) {
+      new_edges.push_back(GetSuffixEdge(from, buf_factory));
     } else {
       auto composed_edge = Edge::ComposeEdges(
           absl::MakeConstSpan(edges_).subspan(from, to - from), buf_factory);
@@ -262,8 +270,17 @@ class JaggedShape : public RefcountedBase {
             JaggedShapeFastEquivalenceResult::kNotEq);
       }
     }
+    // Shapes derived from one another (e.g. through RemoveDims or AddDims)
+    // share the edge buffers, which allows us to report exact equivalence.
+    // Note: the first edge is fully determined by its child_size.
+    for (size_t i = 1; i < rnk; ++i) {
+      if (!edges_[i].SharesBuffersWith(other.edges_[i])) {
+        return JaggedShapeFastEquivalenceResult(
+            JaggedShapeFastEquivalenceResult::kSizesEq);
+      }
+    }
     return JaggedShapeFastEquivalenceResult(
-        JaggedShapeFastEquivalenceResult::kSizesEq);
+        JaggedShapeFastEquivalenceResult::kEq);
   }
 
   // Checks if this_shape == that_shape.
@@ -309,17 +326,48 @@ class JaggedShape : public RefcountedBase {
       const JaggedShape& other,
       RawBufferFactory& buf_factory = *GetHeapBufferFactory()) const {
     DCHECK(IsBroadcastableTo(other));
-    if (rank() == other.rank()) {
-      auto unit_edge =
-          Edge::FromUniformGroups(size(), /*group_size=*/1, buf_factory);
-      DCHECK_OK(unit_edge.status());
-      return std::move(*unit_edge);
-    } else {
-      auto res_edge = Edge::ComposeEdges(
-          absl::MakeConstSpan(other.edges_).subspan(rank()), buf_factory);
-      DCHECK_OK(res_edge.status());
-      return std::move(*res_edge);
+    return other.GetSuffixEdge(rank(), buf_factory);
+  }
+
+  // Returns the composition of the edges [from, rank()), i.e. an edge mapping
+  // the rows of the `from - 1`th dimension (or a single row for `from == 0`)
+  // to the rows of the last dimension. For `from == rank()`, returns a unit
+  // edge of size(). Requires `0 <= from <= rank()`.
+  //
+  // The shape is immutable, so the edges allocated by the heap buffer factory
+  // are computed once per shape and cached. The function is thread-safe.
+  Edge GetSuffixEdge(
+      size_t from,
+      RawBufferFactory& buf_factory = *GetHeapBufferFactory()) const {
+    DCHECK_LE(from, rank());
+    if (from + 1 == rank()) {
+      return edges_[from];
+    }
+    // Edges allocated by other factories (e.g. arenas) may not outlive the
+    // shape, so they are not cached.
+    const bool cacheable = &buf_factory == GetHeapBufferFactory();
+    if (cacheable) {
+      absl::MutexLock lock(&suffix_edges_mutex_);
+      if (!suffix_edges_.empty() && suffix_edges_[from].has_value()) {
+        return *suffix_edges_[from];
+      }
     }
+    absl::StatusOr<Edge> result =
+        from == rank()
+            ? Edge::FromUniformGroups(size(), /*group_size=*/1, buf_factory)
+            : Edge::ComposeEdges(absl::MakeConstSpan(edges_).subspan(from),
+                                 buf_factory);
+    DCHECK_OK(result.status());  // Cannot fail for valid shapes.
+    if (cacheable) {
+      absl::MutexLock lock(&suffix_edges_mutex_);
+      if (suffix_edges_.empty()) {
+        suffix_edges_.resize(rank() + 1);
+      }
+      if (!suffix_edges_[from].has_value()) {
+        suffix_edges_[from] = *result;
+      }
+    }
+    return *std::move(result);
   }
 
   // Creates an empty shape (rank 0, size 0).
@@ -330,6 +378,11 @@ class JaggedShape : public RefcountedBase {
 
  private:
   EdgeVec edges_;
+
+  // Cache for GetSuffixEdge, indexed by `from`. Empty until the first use.
+  mutable absl::Mutex suffix_edges_mutex_;
+  mutable std::vector<std::optional<Edge>> suffix_edges_
+      ABSL_GUARDED_BY(suffix_edges_mutex_);
 };
 
 template <typename Edge>
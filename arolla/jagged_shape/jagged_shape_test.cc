@@ -559,8 +559,22 @@ TYPED_TEST(JaggedShapeTest, FastEquivalenceCheck) {
     ASSERT_OK_AND_ASSIGN(auto shape2, Shape::FromEdges({edge1, edge2, edge3}));
     EXPECT_EQ(shape1->FastEquivalenceCheck(*shape1), kEq)
         << "the same pointer must be exact equal";
-    EXPECT_EQ(shape1->FastEquivalenceCheck(*shape2), kEqSizes);
-    EXPECT_EQ(shape2->FastEquivalenceCheck(*shape1), kEqSizes);
+    EXPECT_EQ(shape1->FastEquivalenceCheck(*shape2), kEq)
+        << "shared edge buffers must be exact equal";
+    EXPECT_EQ(shape2->FastEquivalenceCheck(*shape1), kEq);
+
+    // Derived shapes share the edge buffers.
+    auto shape3 = shape1->RemoveDims(2);
+    ASSERT_OK_AND_ASSIGN(auto shape4, shape3->AddDims({edge3}));
+    EXPECT_EQ(shape1->FastEquivalenceCheck(*shape4), kEq);
+
+    // Equal edges with different buffers.
+    ASSERT_OK_AND_ASSIGN(auto edge3_new,
+                         Helper::EdgeFromSplitPoints({0, 1, 2, 4}));
+    ASSERT_OK_AND_ASSIGN(auto shape5,
+                         Shape::FromEdges({edge1, edge2, edge3_new}));
+    EXPECT_EQ(shape1->FastEquivalenceCheck(*shape5), kEqSizes);
+    EXPECT_EQ(shape5->FastEquivalenceCheck(*shape1), kEqSizes);
   }
   {
     SCOPED_TRACE("Different shapes.");
@@ -753,6 +767,42 @@ TYPED_TEST(JaggedShapeTest, GetBroadcastEdge) {
   }
 }
 
+TYPED_TEST(JaggedShapeTest, GetSuffixEdge) {
+  using Shape = typename TestFixture::Shape;
+  using Helper = typename TestFixture::Helper;
+  ASSERT_OK_AND_ASSIGN(auto edge1, Helper::EdgeFromSplitPoints({0, 2}));
+  ASSERT_OK_AND_ASSIGN(auto edge2, Helper::EdgeFromSplitPoints({0, 1, 3}));
+  ASSERT_OK_AND_ASSIGN(auto edge3, Helper::EdgeFromSplitPoints({0, 1, 2, 4}));
+  ASSERT_OK_AND_ASSIGN(auto shape, Shape::FromEdges({edge1, edge2, edge3}));
+  EXPECT_TRUE(shape->GetSuffixEdge(0).IsEquivalentTo(
+      *Helper::EdgeFromSplitPoints({0, 4})));
+  EXPECT_TRUE(shape->GetSuffixEdge(1).IsEquivalentTo(
+      *Helper::EdgeFromSplitPoints({0, 1, 4})));
+  EXPECT_TRUE(shape->GetSuffixEdge(2).IsEquivalentTo(edge3));
+  EXPECT_TRUE(shape->GetSuffixEdge(3).IsEquivalentTo(
+      *Helper::EdgeFromSplitPoints({0, 1, 2, 3, 4})));
+  {
+    // Heap allocated edges are cached.
+    auto edge = shape->GetSuffixEdge(1);
+    EXPECT_TRUE(Helper::GetSplitPoints(edge).is_owner());
+    EXPECT_TRUE(edge.SharesBuffersWith(shape->GetSuffixEdge(1)));
+    EXPECT_TRUE(edge.SharesBuffersWith(shape->FlattenDims(1, 3)->edges()[1]));
+  }
+  {
+    // Arena allocated edges are not cached.
+    UnsafeArenaBufferFactory arena{128};
+    auto edge = shape->GetSuffixEdge(1, arena);
+    EXPECT_FALSE(Helper::GetSplitPoints(edge).is_owner());
+    EXPECT_TRUE(edge.IsEquivalentTo(*Helper::EdgeFromSplitPoints({0, 1, 4})));
+    EXPECT_TRUE(Helper::GetSplitPoints(shape->GetSuffixEdge(1)).is_owner());
+  }
+  {
+    // Empty shape.
+    auto edge = Shape::Empty()->GetSuffixEdge(0);
+    EXPECT_TRUE(edge.IsEquivalentTo(*Helper::EdgeFromSplitPoints({0, 1})));
+  }
+}
+
 TYPED_TEST(JaggedShapeTest, EdgeT) {
   using Edge = typename TestFixture::Shape::Edge;
   using TestEdge = typename TestFixture::Helper::Edge;
@@ -928,6 +978,37 @@ BENCHMARK(BM_JaggedShape_FastEquivalenceCheck<JaggedDenseArrayShapeHelper>)
     ->ArgPair(1, 100)
     ->ArgPair(4, 100);
 
+template <typename ShapeHelper>
+void BM_JaggedShape_FastEquivalenceCheck_SharedEdges(benchmark::State& state) {
+  const int rank = state.range(0);
+  const int num_children = state.range(1);
+  auto shape1 = GetShape<ShapeHelper>(rank, num_children);
+  typename ShapeHelper::Shape::EdgeVec edges(shape1->edges().begin(),
+                                             shape1->edges().end());
+  auto shape2 = *ShapeHelper::Shape::FromEdges(std::move(edges));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(shape1);
+    benchmark::DoNotOptimize(shape2);
+    auto eq = shape1->FastEquivalenceCheck(*shape2);
+    benchmark::DoNotOptimize(eq);
+  }
+}
+
+BENCHMARK(
+    BM_JaggedShape_FastEquivalenceCheck_SharedEdges<JaggedArrayShapeHelper>)
+    // Rank, num children.
+    ->ArgPair(1, 1)
+    ->ArgPair(100, 1)
+    ->ArgPair(1, 100)
+    ->ArgPair(4, 100);
+BENCHMARK(BM_JaggedShape_FastEquivalenceCheck_SharedEdges<
+              JaggedDenseArrayShapeHelper>)
+    // Rank, num children.
+    ->ArgPair(1, 1)
+    ->ArgPair(100, 1)
+    ->ArgPair(1, 100)
+    ->ArgPair(4, 100);
+
 template <typename ShapeHelper>
 void BM_JaggedShape_IsEquivalentTo(benchmark::State& state) {
   const int rank = state.range(0);
@@ -1080,6 +1161,32 @@ BENCHMARK(BM_JaggedShape_IsBroadcastableTo_SameObj<JaggedDenseArrayShapeHelper>)
     ->Args({1, 5})
     ->Args({4, 5});
 
+template <typename ShapeHelper>
+void BM_JaggedShape_GetBroadcastEdge(benchmark::State& state) {
+  const int rank_1 = state.range(0);
+  const int rank_2 = state.range(1);
+  const int num_children = state.range(2);
+  auto shape2 = GetShape<ShapeHelper>(rank_2, num_children);
+  auto shape1 = shape2->RemoveDims(rank_1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(shape1);
+    benchmark::DoNotOptimize(shape2);
+    auto edge = shape1->GetBroadcastEdge(*shape2);
+    benchmark::DoNotOptimize(edge);
+  }
+}
+
+BENCHMARK(BM_JaggedShape_GetBroadcastEdge<JaggedArrayShapeHelper>)
+    // Rank shape_1, rank shape_2, num children.
+    ->Args({1, 1, 5})
+    ->Args({1, 5, 5})
+    ->Args({4, 6, 5});
+BENCHMARK(BM_JaggedShape_GetBroadcastEdge<JaggedDenseArrayShapeHelper>)
+    // Rank shape_1, rank shape_2, num children.
+    ->Args({1, 1, 5})
+    ->Args({1, 5, 5})
+    ->Args({4, 6, 5});
+
 template <typename ShapeHelper>
 void BM_JaggedShape_Copying(benchmark::State& state) {
   // Tests that the result of `FromEdges` is fast to copy.
@@ -17,6 +17,7 @@
 #include <memory>
 #include <utility>
 
+#include "absl/base/call_once.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -26,6 +27,7 @@
 #include "arolla/qtype/typed_value.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/repr.h"
+#include "arolla/util/threading.h"
 
 namespace arolla {
 namespace {
@@ -45,6 +47,16 @@ class LazyValue final : public Lazy {
   TypedValue value_;
 };
 
+absl::StatusOr<TypedValue> CheckLazyCallableResult(
+    QTypePtr value_qtype, absl::StatusOr<TypedValue>&& result) {
+  if (result.ok() && result->GetType() != value_qtype) {
+    return absl::FailedPreconditionError(
+        absl::StrFormat("expected a lazy callable to return %s, got %s",
+                        value_qtype->name(), result->GetType()->name()));
+  }
+  return std::move(result);
+}
+
 // The implementation of LazyFromCallable.
 class LazyCallable final : public Lazy {
  public:
@@ -55,19 +67,71 @@ class LazyCallable final : public Lazy {
         callable_(std::move(callable)) {}
 
   absl::StatusOr<TypedValue> Get() const final {
-    auto result = callable_();
-    if (result.ok() && result->GetType() != value_qtype()) {
-      return absl::FailedPreconditionError(
-          absl::StrFormat("expected a lazy callable to return %s, got %s",
-                          value_qtype()->name(), result->GetType()->name()));
-    }
-    return result;
+    return CheckLazyCallableResult(value_qtype(), callable_());
   }
 
  private:
   Callable callable_;
 };
 
+// The implementation of MemoizedLazyFromCallable.
+class LazyMemoizedCallable final : public Lazy {
+ public:
+  using Callable = absl::AnyInvocable<absl::StatusOr<TypedValue>()>;
+
+  explicit LazyMemoizedCallable(QTypePtr value_qtype, Callable&& callable)
+      : Lazy(value_qtype, RandomFingerprint()),
+        callable_(std::move(callable)) {}
+
+  absl::StatusOr<TypedValue> Get() const final {
+    absl::call_once(once_, [this] {
+      result_ = CheckLazyCallableResult(value_qtype(), callable_());
+      callable_ = nullptr;
+    });
+    return result_;
+  }
+
+ private:
+  mutable absl::once_flag once_;
+  mutable Callable callable_;
+  mutable absl::StatusOr<TypedValue> result_;
+};
+
+// The implementation of AsyncLazyFromCallable.
+class LazyAsyncCallable final : public Lazy {
+ public:
+  using Callable = absl::AnyInvocable<absl::StatusOr<TypedValue>()>;
+
+  LazyAsyncCallable(ThreadingInterface& threading, QTypePtr value_qtype,
+                    Callable&& callable)
+      : Lazy(value_qtype, RandomFingerprint()) {
+    // The thread only writes `result_`, which is read after joining.
+    join_fn_ = threading.StartThread(
+        [this, callable = std::make_shared<Callable>(std::move(callable))] {
+          result_ = CheckLazyCallableResult(this->value_qtype(), (*callable)());
+        });
+  }
+
+  ~LazyAsyncCallable() final { Join(); }
+
+  absl::StatusOr<TypedValue> Get() const final {
+    Join();
+    return result_;
+  }
+
+ private:
+  void Join() const {
+    absl::call_once(once_, [this] {
+      join_fn_();
+      join_fn_ = nullptr;
+    });
+  }
+
+  mutable absl::once_flag once_;
+  mutable ThreadingInterface::JoinFn join_fn_;
+  absl::StatusOr<TypedValue> result_;
+};
+
 }  // namespace
 
 LazyPtr MakeLazyFromQValue(TypedValue value) {
@@ -79,6 +143,19 @@ LazyPtr MakeLazyFromCallable(QTypePtr value_qtype,
   return std::make_shared<LazyCallable>(value_qtype, std::move(callable));
 }
 
+LazyPtr MakeMemoizedLazyFromCallable(QTypePtr value_qtype,
+                                     LazyMemoizedCallable::Callable callable) {
+  return std::make_shared<LazyMemoizedCallable>(value_qtype,
+                                                std::move(callable));
+}
+
+LazyPtr MakeAsyncLazyFromCallable(ThreadingInterface& threading,
+                                  QTypePtr value_qtype,
+                                  LazyAsyncCallable::Callable callable) {
+  return std::make_shared<LazyAsyncCallable>(threading, value_qtype,
+                                             std::move(callable));
+}
+
 void FingerprintHasherTraits<LazyPtr>::operator()(FingerprintHasher* hasher,
                                                   const LazyPtr& value) const {
   if (value != nullptr) {
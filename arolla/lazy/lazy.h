@@ -26,6 +26,8 @@
 
 namespace arolla {
 
+class ThreadingInterface;
+
 // A "lazy" type representing a value with deferred/on-demand computation.
 //
 // NOTE: There is no promise that the value will be cached after the first
@@ -66,6 +68,24 @@ LazyPtr MakeLazyFromCallable(
     QTypePtr value_qtype,
     absl::AnyInvocable<absl::StatusOr<TypedValue>() const> callable);
 
+// Returns a "lazy" object that acts as a proxy for a callable object, calling
+// it at most once and caching the result (including an error).
+//
+// Concurrent Get() calls block until the first one finishes.
+LazyPtr MakeMemoizedLazyFromCallable(
+    QTypePtr value_qtype,
+    absl::AnyInvocable<absl::StatusOr<TypedValue>()> callable);
+
+// Returns a "lazy" object that starts the callable immediately in a new thread
+// and caches the result. Get() waits for the thread to finish.
+//
+// Use it to overlap expensive computations (e.g. remote lookups) that are
+// known to be needed with other work. `threading` must outlive the returned
+// object; destruction of the object waits for the callable to finish.
+LazyPtr MakeAsyncLazyFromCallable(
+    ThreadingInterface& threading, QTypePtr value_qtype,
+    absl::AnyInvocable<absl::StatusOr<TypedValue>()> callable);
+
 AROLLA_DECLARE_FINGERPRINT_HASHER_TRAITS(LazyPtr);
 AROLLA_DECLARE_REPR(LazyPtr);
 
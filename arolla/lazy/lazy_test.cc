@@ -14,9 +14,13 @@
 //
 #include "arolla/lazy/lazy.h"
 
+#include <atomic>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/notification.h"
+#include "arolla/qtype/base_types.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/testing/qtype.h"
 #include "arolla/qtype/typed_value.h"
@@ -24,6 +28,7 @@
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/repr.h"
 #include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/threading.h"
 
 namespace arolla {
 namespace {
@@ -81,6 +86,68 @@ TEST_F(LazyTest, LazyCallableError) {
   EXPECT_THAT(x->Get(), StatusIs(absl::StatusCode::kInvalidArgument, "error"));
 }
 
+TEST_F(LazyTest, MakeMemoizedLazyFromCallable) {
+  int call_count = 0;
+  auto x = MakeMemoizedLazyFromCallable(GetQTypeQType(), [&] {
+    ++call_count;
+    return TypedValue::FromValue(GetNothingQType());
+  });
+  EXPECT_EQ(x->value_qtype(), GetQTypeQType());
+  EXPECT_EQ(Repr(x), "lazy[QTYPE]");
+  EXPECT_EQ(call_count, 0);
+  EXPECT_THAT(x->Get(),
+              IsOkAndHolds(TypedValueWith<QTypePtr>(GetNothingQType())));
+  EXPECT_THAT(x->Get(),
+              IsOkAndHolds(TypedValueWith<QTypePtr>(GetNothingQType())));
+  EXPECT_EQ(call_count, 1);
+}
+
+TEST_F(LazyTest, MemoizedLazyCallableError) {
+  int call_count = 0;
+  auto x = MakeMemoizedLazyFromCallable(GetQTypeQType(), [&] {
+    ++call_count;
+    return TypedValue::FromValue(1.0f);
+  });
+  EXPECT_THAT(x->Get(), StatusIs(absl::StatusCode::kFailedPrecondition,
+                                 "expected a lazy callable to return QTYPE, "
+                                 "got FLOAT32"));
+  EXPECT_THAT(x->Get(), StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_EQ(call_count, 1);
+}
+
+TEST_F(LazyTest, MakeAsyncLazyFromCallable) {
+  StdThreading threading(2);
+  absl::Notification started;
+  absl::Notification unblock;
+  std::atomic<int> call_count = 0;
+  auto x = MakeAsyncLazyFromCallable(threading, GetQTypeQType(), [&] {
+    started.Notify();
+    unblock.WaitForNotification();
+    ++call_count;
+    return TypedValue::FromValue(GetNothingQType());
+  });
+  EXPECT_EQ(x->value_qtype(), GetQTypeQType());
+  EXPECT_EQ(Repr(x), "lazy[QTYPE]");
+  // The callable starts without waiting for Get().
+  started.WaitForNotification();
+  unblock.Notify();
+  EXPECT_THAT(x->Get(),
+              IsOkAndHolds(TypedValueWith<QTypePtr>(GetNothingQType())));
+  EXPECT_THAT(x->Get(),
+              IsOkAndHolds(TypedValueWith<QTypePtr>(GetNothingQType())));
+  EXPECT_EQ(call_count, 1);
+}
+
+TEST_F(LazyTest, AsyncLazyDestroyedWithoutGet) {
+  StdThreading threading(2);
+  std::atomic<int> call_count = 0;
+  MakeAsyncLazyFromCallable(threading, GetQTypeQType(), [&] {
+    ++call_count;
+    return absl::InvalidArgumentError("error");
+  });
+  EXPECT_EQ(call_count, 1);
+}
+
 TEST_F(LazyTest, Nullptr) {
   LazyPtr x;
   EXPECT_EQ(Repr(x), "lazy[?]{nullptr}");
@@ -327,6 +327,22 @@ TEST_F(BufferTest, UnownedBuffer) {
   EXPECT_THAT(deep_copy, ElementsAre(1.0f, 2.0f, 3.0f, 4.0f, 5.0f));
 }
 
+TEST_F(BufferTest, UniquelyOwned) {
+  EXPECT_FALSE(Buffer<float>().is_uniquely_owned());
+  float values[] = {1.0f, 2.0f, 3.0f};
+  EXPECT_FALSE(Buffer<float>(nullptr, values).is_uniquely_owned());
+
+  auto buffer = Buffer<float>::Create({1.0f, 2.0f, 3.0f});
+  EXPECT_TRUE(buffer.is_uniquely_owned());
+  {
+    auto slice = buffer.Slice(1, 2);
+    EXPECT_FALSE(buffer.is_uniquely_owned());
+    EXPECT_FALSE(slice.is_uniquely_owned());
+    EXPECT_EQ(slice.raw_buffer(), buffer.raw_buffer());
+  }
+  EXPECT_TRUE(buffer.is_uniquely_owned());
+}
+
 TEST_F(BufferTest, SupportsAbslHash) {
   Buffer<float> empty;
   std::array<float, 5> values = {1, 2, 3, 4, 5};
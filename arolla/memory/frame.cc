@@ -25,6 +25,7 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "arolla/util/algorithms.h"
 #include "arolla/util/memory.h"
 
@@ -53,6 +54,35 @@ FrameLayout::FieldFactory FrameLayout::FieldFactory::Derive(
   return res;
 }
 
+FrameLayout::FieldFactory FrameLayout::FieldFactory::WithoutFieldsIn(
+    absl::Span<const std::pair<size_t, size_t>> ranges) const {
+  FieldFactory res = *this;
+  res.offsets_.clear();
+  for (size_t offset : offsets_) {
+    if (std::none_of(ranges.begin(), ranges.end(), [&](const auto& range) {
+          return range.first <= offset && offset < range.second;
+        })) {
+      res.offsets_.push_back(offset);
+    }
+  }
+  return res;
+}
+
+FrameLayout::ResetPlan FrameLayout::MakeResetPlan(
+    absl::Span<const std::pair<size_t, size_t>> kept_ranges) const {
+  ResetPlan plan;
+  for (const auto& factory : initializers_.factories) {
+    if (!factory.NeedsReset()) {
+      continue;
+    }
+    auto reset_factory = factory.WithoutFieldsIn(kept_ranges);
+    if (!reset_factory.empty()) {
+      plan.factories_.push_back(std::move(reset_factory));
+    }
+  }
+  return plan;
+}
+
 void FrameLayout::FieldInitializers::AddOffsetToFactory(
     size_t offset, FieldFactory empty_factory) {
   auto it = type2factory.find(empty_factory.type_index());
@@ -85,11 +115,8 @@ void FrameLayout::FieldInitializers::AddDerived(
 // Allocates storage in the layout for holding a sub-frame.
 FrameLayout::Slot<void> FrameLayout::Builder::AddSubFrame(
     const FrameLayout& subframe) {
-  alloc_size_ = RoundUp(alloc_size_, subframe.AllocAlignment().value);
-  size_t offset = alloc_size_;
-  alloc_size_ += subframe.AllocSize();
-  alloc_alignment_ =
-      std::max(alloc_alignment_, subframe.AllocAlignment().value);
+  size_t offset =
+      Allocate(subframe.AllocSize(), subframe.AllocAlignment().value);
   initializers_.AddDerived(offset, subframe.initializers_);
 #ifndef NDEBUG
   for (const auto& [field_offset, field_type] : subframe.registered_fields_) {
@@ -99,6 +126,45 @@ FrameLayout::Slot<void> FrameLayout::Builder::AddSubFrame(
   return FrameLayout::Slot<void>(offset);
 }
 
+size_t FrameLayout::Builder::AllocateReusingPadding(size_t size,
+                                                   size_t alignment) {
+  constexpr size_t kModulo = 16;
+  auto add_padding = [&](size_t begin, size_t length) {
+    if (length > 0) {
+      padding_[begin % kModulo * kModulo + length].push_back(begin);
+    }
+  };
+  if (padding_.empty()) {
+    padding_.resize(kModulo * kModulo);
+  }
+  if (size > 0 && alignment <= kModulo) {
+    // The shortest suitable range first, to keep the longer ones for the
+    // bigger fields.
+    for (size_t length = size; length < kModulo; ++length) {
+      for (size_t residue = 0; residue < kModulo; ++residue) {
+        auto& bucket = padding_[residue * kModulo + length];
+        // `alignment` divides kModulo, so the alignment padding depends only
+        // on the residue.
+        size_t pad = RoundUp(residue, alignment) - residue;
+        if (bucket.empty() || pad + size > length) {
+          continue;
+        }
+        size_t begin = bucket.back();
+        bucket.pop_back();
+        add_padding(begin, pad);
+        add_padding(begin + pad + size, length - pad - size);
+        return begin + pad;
+      }
+    }
+  }
+  size_t offset = RoundUp(alloc_size_, alignment);
+  if (alignment <= kModulo) {
+    add_padding(alloc_size_, offset - alloc_size_);
+  }
+  alloc_size_ = offset + size;
+  return offset;
+}
+
 absl::Status FrameLayout::Builder::RegisterUnsafeSlot(
     size_t byte_offset, size_t byte_size, const std::type_info& type) {
   return RegisterSlot(byte_offset, byte_size, type);
@@ -29,6 +29,7 @@
 #include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
@@ -94,10 +95,37 @@ class FrameLayout {
   // InitializeAllocN() was previously called on the alloc.
   void DestroyAllocN(void* alloc, size_t n) const;
 
+  // Resets all the non-trivially destructible fields within the provided block
+  // of memory to default constructed values, releasing the resources they
+  // hold. Unlike DestroyAlloc() followed by InitializeAlignedAlloc(), the
+  // memory is not zeroed and the trivially destructible fields keep their
+  // values. Assumes InitializeAlignedAlloc() was previously called on the
+  // alloc.
+  void ResetAlloc(void* alloc) const;
+
+  // A subset of the fields to be reset by ResetAlloc(), see MakeResetPlan().
+  class ResetPlan;
+
+  // Returns a plan to reset only the non-trivially destructible fields outside
+  // of the given byte ranges [begin, end), e.g. to keep the literal slots of a
+  // program in place.
+  ResetPlan MakeResetPlan(
+      absl::Span<const std::pair<size_t, size_t>> kept_ranges) const;
+
+  // Same as ResetAlloc(alloc), but resets only the fields selected by `plan`.
+  // The plan must be created by MakeResetPlan() of this layout.
+  void ResetAlloc(void* alloc, const ResetPlan& plan) const;
+
   // Returns true iff the field registered by the given offset and type.
   // This can be used to perform runtime type checking.
   bool HasField(size_t offset, const std::type_info& type) const;
 
+  // Returns true if all the fields are trivially destructible and don't need
+  // construction besides zeroing the memory, so InitializeAlignedAlloc() is
+  // just a memset and DestroyAlloc() is no-op. Such allocs can be copied
+  // bytewise (see MemoryAllocation::TrivialCopyOf).
+  bool HasOnlyTrivialFields() const { return initializers_.factories.empty(); }
+
  private:
   // Called by FrameLayout::Builder::Build().
   explicit FrameLayout(Builder&& builder);
@@ -266,10 +294,18 @@ class FrameLayout::FieldFactory {
     // Trivially destructible types types don't need extra de-initialization.
     FactoryFn destruct;
     FactoryNFn destruct_n;
+    FactoryFn reset = nullptr;
     if constexpr (std::is_trivially_destructible<T>()) {
       destruct = [](void*, absl::Span<const size_t>) {};
       destruct_n = [](void*, absl::Span<const size_t>, size_t, size_t) {};
     } else {
+      reset = [](void* ptr, absl::Span<const size_t> offsets) {
+        for (size_t offset : offsets) {
+          void* shifted_ptr = static_cast<char*>(ptr) + offset;
+          static_cast<T*>(shifted_ptr)->~T();
+          new (shifted_ptr) T();
+        }
+      };
       destruct = [](void* ptr, absl::Span<const size_t> offsets) {
         for (size_t offset : offsets) {
           void* shifted_ptr = static_cast<char*>(ptr) + offset;
@@ -288,7 +324,7 @@ class FrameLayout::FieldFactory {
       };
     }
     return FieldFactory(std::type_index(typeid(T)), construct, destruct,
-                        construct_n, destruct_n);
+                        construct_n, destruct_n, reset);
   }
 
   // Returns type associated with the FieldFactory.
@@ -303,6 +339,18 @@ class FrameLayout::FieldFactory {
   // Returns a copy of the factory with adjusted offset.
   FieldFactory Derive(size_t offset) const;
 
+  // Returns a copy of the factory without the fields within the given byte
+  // ranges [begin, end).
+  FieldFactory WithoutFieldsIn(
+      absl::Span<const std::pair<size_t, size_t>> ranges) const;
+
+  // Returns true if the factory has no fields.
+  bool empty() const { return offsets_.empty(); }
+
+  // Returns true if the fields need to be reset in order to release resources
+  // they hold, i.e. the fields are not trivially destructible.
+  bool NeedsReset() const { return reset_ != nullptr; }
+
   // Initializes fields within the provided block of storage.
   void Construct(void* ptr) const { construct_(ptr, offsets_); }
 
@@ -319,17 +367,22 @@ class FrameLayout::FieldFactory {
     destruct_n_(ptr, offsets_, block_size, n);
   }
 
+  // Resets fields within the provided block of storage to default constructed
+  // values. Must be called only if NeedsReset().
+  void Reset(void* ptr) const { reset_(ptr, offsets_); }
+
  private:
   using FactoryFn = void (*)(void*, absl::Span<const size_t>);
   using FactoryNFn = void (*)(void*, absl::Span<const size_t>, size_t, size_t);
 
   FieldFactory(std::type_index tpe, FactoryFn construct, FactoryFn destruct,
-               FactoryNFn construct_n, FactoryNFn destruct_n)
+               FactoryNFn construct_n, FactoryNFn destruct_n, FactoryFn reset)
       : type_(tpe),
         construct_(construct),
         destruct_(destruct),
         construct_n_(construct_n),
-        destruct_n_(destruct_n) {}
+        destruct_n_(destruct_n),
+        reset_(reset) {}
 
   std::type_index type_;
   FactoryFn construct_;
@@ -337,6 +390,15 @@ class FrameLayout::FieldFactory {
   std::vector<size_t> offsets_;
   FactoryNFn construct_n_;
   FactoryNFn destruct_n_;
+  FactoryFn reset_;  // nullptr for trivially destructible types.
+};
+
+class FrameLayout::ResetPlan {
+ private:
+  friend class FrameLayout;
+
+  // Only the factories that NeedsReset().
+  std::vector<FieldFactory> factories_;
 };
 
 template <class T>
@@ -360,6 +422,20 @@ inline void FrameLayout::DestroyAlloc(void* alloc) const {
   }
 }
 
+inline void FrameLayout::ResetAlloc(void* alloc) const {
+  for (const auto& factory : initializers_.factories) {
+    if (factory.NeedsReset()) {
+      factory.Reset(alloc);
+    }
+  }
+}
+
+inline void FrameLayout::ResetAlloc(void* alloc, const ResetPlan& plan) const {
+  for (const auto& factory : plan.factories_) {
+    factory.Reset(alloc);
+  }
+}
+
 inline void FrameLayout::InitializeAlignedAllocN(void* alloc, size_t n) const {
   DCHECK(IsAlignedPtr(alloc_alignment_, alloc)) << "invalid alloc alignment";
   memset(alloc, 0, alloc_size_ * n);
@@ -379,17 +455,15 @@ class FrameLayout::Builder {
  public:
   // Allocates storage in the layout for holding a type T parameter.
   // Consecutive calls of AddSlot<T> with the same T guaranteed to form a layout
-  // that is compatible with std::array<T>.
+  // that is compatible with std::array<T> (unless EnablePaddingReuse() was
+  // called).
   template <typename T>
   ABSL_ATTRIBUTE_ALWAYS_INLINE Slot<T> AddSlot() {
     // TODO: Consider supporting strongly aligned types.
     static_assert(alignof(T) <= 16,
                   "Types with strong alignments are not supported.");
-    alloc_size_ = RoundUp(alloc_size_, alignof(T));
-    size_t offset = alloc_size_;
+    size_t offset = Allocate(sizeof(T), alignof(T));
     Slot<T> slot(offset);
-    alloc_size_ += sizeof(T);
-    alloc_alignment_ = std::max(alloc_alignment_, alignof(T));
     if constexpr (!is_bzero_constructible<T>() ||
                   !std::is_trivially_destructible<T>()) {
       initializers_.Add<T>(offset);
@@ -407,6 +481,18 @@ class FrameLayout::Builder {
   // Allocates storage in the layout for holding a sub-frame.
   Slot<void> AddSubFrame(const FrameLayout& subframe);
 
+  // Makes the following AddSlot and AddSubFrame calls place the new slots into
+  // the alignment padding left before the previous ones, when they fit. The
+  // offsets of the already added slots don't change. Reduces the frame size
+  // when the slots of different alignments are interleaved (e.g. bool,
+  // OptionalValue<float> and DenseArray slots added by the compiled
+  // operators).
+  //
+  // NOTE: With padding reuse the consecutive AddSlot<T> calls don't form a
+  // layout compatible with std::array<T>, so the option must not be used if
+  // the caller relies on it.
+  void EnablePaddingReuse() { reuse_padding_ = true; }
+
   // Register additional slot to pass runtime type checks.
   // Non-trivial fields registered this way are expected to be initialized and
   // destroyed by their containing object.
@@ -473,12 +559,31 @@ class FrameLayout::Builder {
                             const std::type_info& type,
                             bool allow_duplicates = false);
 
+  // Returns the offset of a new field with the given size and alignment.
+  ABSL_ATTRIBUTE_ALWAYS_INLINE size_t Allocate(size_t size, size_t alignment) {
+    alloc_alignment_ = std::max(alloc_alignment_, alignment);
+    if (ABSL_PREDICT_FALSE(reuse_padding_)) {
+      return AllocateReusingPadding(size, alignment);
+    }
+    alloc_size_ = RoundUp(alloc_size_, alignment);
+    size_t offset = alloc_size_;
+    alloc_size_ += size;
+    return offset;
+  }
+
+  size_t AllocateReusingPadding(size_t size, size_t alignment);
+
 #ifndef NDEBUG
   absl::flat_hash_set<std::pair<size_t, std::type_index>> registered_fields_;
 #endif
   FieldInitializers initializers_;
   size_t alloc_size_{0};
   size_t alloc_alignment_{1};
+  bool reuse_padding_ = false;
+  // Unused byte ranges before alloc_size_, only tracked with reuse_padding_.
+  // padding_[begin % 16 * 16 + length] holds the `begin`s of the ranges.
+  // Every range comes from an alignment padding, so it is shorter than 16.
+  std::vector<std::vector<size_t>> padding_;
 };
 
 // Creates a frame layout for type `T`.
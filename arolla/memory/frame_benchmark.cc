@@ -44,4 +44,74 @@ BENCHMARK_TEMPLATE(BM_Initialize, OptionalValue<float>)->Range(1, 4000);
 BENCHMARK_TEMPLATE(BM_Initialize, std::shared_ptr<void>)->Range(1, 4000);
 BENCHMARK_TEMPLATE(BM_Initialize, std::string)->Range(1, 4000);
 
+// Reinitializes the same memory the way it is done for a new evaluation.
+template <class T>
+void BM_DestroyAndInitialize(benchmark::State& state) {
+  int64_t cnt = state.range(0);
+  FrameLayout::Builder builder;
+  for (int64_t i = 0; i != cnt; ++i) {
+    builder.AddSlot<T>();
+  }
+  auto layout = std::move(builder).Build();
+  auto alloc = MemoryAllocation(&layout);
+  void* ptr = alloc.frame().GetRawPointer(0);
+  while (state.KeepRunningBatch(cnt)) {
+    layout.DestroyAlloc(ptr);
+    layout.InitializeAlignedAlloc(ptr);
+    benchmark::ClobberMemory();
+  }
+}
+
+// Resets only the non-trivially destructible fields, without zeroing memory.
+template <class T>
+void BM_Reset(benchmark::State& state) {
+  int64_t cnt = state.range(0);
+  FrameLayout::Builder builder;
+  for (int64_t i = 0; i != cnt; ++i) {
+    builder.AddSlot<T>();
+  }
+  auto layout = std::move(builder).Build();
+  auto alloc = MemoryAllocation(&layout);
+  void* ptr = alloc.frame().GetRawPointer(0);
+  while (state.KeepRunningBatch(cnt)) {
+    layout.ResetAlloc(ptr);
+    benchmark::ClobberMemory();
+  }
+}
+
+// Resets only the `written` slots out of 4000, keeping the rest (e.g. the
+// literals) in place.
+template <class T>
+void BM_ResetWrittenSlots(benchmark::State& state) {
+  constexpr int64_t kSlotCount = 4000;
+  int64_t written = state.range(0);
+  FrameLayout::Builder builder;
+  size_t first_written_offset = 0;
+  for (int64_t i = 0; i != kSlotCount; ++i) {
+    auto slot = builder.AddSlot<T>();
+    if (i == kSlotCount - written) {
+      first_written_offset = slot.byte_offset();
+    }
+  }
+  auto layout = std::move(builder).Build();
+  auto plan = layout.MakeResetPlan({{0, first_written_offset}});
+  auto alloc = MemoryAllocation(&layout);
+  void* ptr = alloc.frame().GetRawPointer(0);
+  while (state.KeepRunningBatch(kSlotCount)) {
+    layout.ResetAlloc(ptr, plan);
+    benchmark::ClobberMemory();
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_DestroyAndInitialize, float)->Range(1, 4000);
+BENCHMARK_TEMPLATE(BM_DestroyAndInitialize, OptionalValue<float>)
+    ->Range(1, 4000);
+BENCHMARK_TEMPLATE(BM_DestroyAndInitialize, std::string)->Range(1, 4000);
+
+BENCHMARK_TEMPLATE(BM_Reset, float)->Range(1, 4000);
+BENCHMARK_TEMPLATE(BM_Reset, OptionalValue<float>)->Range(1, 4000);
+BENCHMARK_TEMPLATE(BM_Reset, std::string)->Range(1, 4000);
+
+BENCHMARK_TEMPLATE(BM_ResetWrittenSlots, std::string)->Range(1, 4000);
+
 }  // namespace arolla
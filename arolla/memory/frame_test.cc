@@ -428,6 +428,48 @@ TEST(FrameLayoutTest, AddSubFrameAllocAlignment) {
   EXPECT_EQ(frame_layout.AllocAlignment().value, 16);
 }
 
+TEST(FrameLayoutTest, PaddingReuse) {
+  {
+    FrameLayout::Builder builder;
+    builder.AddSlot<bool>();
+    builder.AddSlot<double>();
+    EXPECT_EQ(builder.AddSlot<bool>().byte_offset(), 16);
+    EXPECT_EQ(builder.AddSlot<int32_t>().byte_offset(), 20);
+    EXPECT_EQ(builder.AddSlot<bool>().byte_offset(), 24);
+    EXPECT_EQ(std::move(builder).Build().AllocSize(), 32);
+  }
+  FrameLayout::Builder builder;
+  builder.EnablePaddingReuse();
+  auto bool_slot1 = builder.AddSlot<bool>();
+  auto double_slot = builder.AddSlot<double>();
+  auto bool_slot2 = builder.AddSlot<bool>();
+  auto int_slot = builder.AddSlot<int32_t>();
+  auto bool_slot3 = builder.AddSlot<bool>();
+  auto string_slot = builder.AddSlot<std::string>();
+  EXPECT_EQ(bool_slot1.byte_offset(), 0);
+  EXPECT_EQ(double_slot.byte_offset(), 8);
+  EXPECT_EQ(bool_slot2.byte_offset(), 1);
+  EXPECT_EQ(int_slot.byte_offset(), 4);
+  EXPECT_EQ(bool_slot3.byte_offset(), 2);
+  EXPECT_EQ(string_slot.byte_offset(), 16);
+  auto layout = std::move(builder).Build();
+  EXPECT_EQ(layout.AllocSize(), 16 + sizeof(std::string));
+
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  frame.Set(bool_slot1, true);
+  frame.Set(double_slot, 1.5);
+  frame.Set(bool_slot2, true);
+  frame.Set(int_slot, 57);
+  frame.Set(string_slot, "abc");
+  EXPECT_TRUE(frame.Get(bool_slot1));
+  EXPECT_EQ(frame.Get(double_slot), 1.5);
+  EXPECT_TRUE(frame.Get(bool_slot2));
+  EXPECT_EQ(frame.Get(int_slot), 57);
+  EXPECT_FALSE(frame.Get(bool_slot3));
+  EXPECT_EQ(frame.Get(string_slot), "abc");
+}
+
 TEST(FrameLayoutTest, ArrayCompatibility) {
   FrameLayout::Builder builder;
   builder.AddSlot<std::aligned_storage_t<16, 16>>();
@@ -497,6 +539,58 @@ struct is_bzero_constructible<::arolla::testing::IsBZeroConstructible>
 namespace arolla::testing {
 namespace {
 
+TEST(FrameLayoutTest, ResetAlloc) {
+  FrameLayout::Builder builder;
+  auto int_slot = builder.AddSlot<int>();
+  auto ptr_slot = builder.AddSlot<std::unique_ptr<int>>();
+  auto str_slot = builder.AddSlot<std::string>();
+  auto layout = std::move(builder).Build();
+
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  frame.Set(int_slot, 57);
+  frame.Set(ptr_slot, std::make_unique<int>(12));
+  frame.Set(str_slot, "It was a dark and stormy night.");
+
+  layout.ResetAlloc(frame.GetRawPointer(0));
+  // Trivially destructible fields are not zeroed.
+  EXPECT_THAT(frame.Get(int_slot), Eq(57));
+  EXPECT_THAT(frame.Get(ptr_slot), Eq(nullptr));
+  EXPECT_THAT(frame.Get(str_slot), IsEmpty());
+}
+
+TEST(FrameLayoutTest, ResetAllocWithPlan) {
+  FrameLayout::Builder builder;
+  auto kept_slot = builder.AddSlot<std::string>();
+  auto str_slot = builder.AddSlot<std::string>();
+  auto layout = std::move(builder).Build();
+  auto plan = layout.MakeResetPlan(
+      {{kept_slot.byte_offset(),
+        kept_slot.byte_offset() + sizeof(std::string)}});
+
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  frame.Set(kept_slot, "kept");
+  frame.Set(str_slot, "reset");
+
+  layout.ResetAlloc(frame.GetRawPointer(0), plan);
+  EXPECT_THAT(frame.Get(kept_slot), Eq("kept"));
+  EXPECT_THAT(frame.Get(str_slot), IsEmpty());
+}
+
+TEST(FrameLayoutTest, HasOnlyTrivialFields) {
+  EXPECT_TRUE(FrameLayout().HasOnlyTrivialFields());
+  EXPECT_TRUE(MakeTypeLayout<int>().HasOnlyTrivialFields());
+  EXPECT_TRUE(MakeTypeLayout<double>().HasOnlyTrivialFields());
+  EXPECT_FALSE(MakeTypeLayout<std::string>().HasOnlyTrivialFields());
+  EXPECT_FALSE(MakeTypeLayout<IsBZeroConstructible>().HasOnlyTrivialFields());
+
+  FrameLayout::Builder builder;
+  builder.AddSlot<int>();
+  builder.AddSubFrame(MakeTypeLayout<std::string>());
+  EXPECT_FALSE(std::move(builder).Build().HasOnlyTrivialFields());
+}
+
 TEST(FrameLayoutTest, IsBZeroConstructibleHandling) {
   ASSERT_FALSE(IsBZeroConstructible::ctor_called);
   ASSERT_FALSE(IsBZeroConstructible::dtor_called);
@@ -15,6 +15,7 @@
 #ifndef AROLLA_UTIL_MEMORY_ALLOCATION_H_
 #define AROLLA_UTIL_MEMORY_ALLOCATION_H_
 
+#include <cstring>
 #include <utility>
 
 #include "absl/log/check.h"
@@ -39,6 +40,23 @@ class MemoryAllocation {
     layout_->InitializeAlignedAlloc(alloc_.get());
   }
 
+  // Allocates memory for the layout of `other` and copies its contents
+  // bytewise, which is faster than initializing the fields one by one. E.g.
+  // to create frames from a prototype with the literals initialized. Requires
+  // other.IsValid() and a layout with only trivial fields (see
+  // FrameLayout::HasOnlyTrivialFields).
+  static MemoryAllocation TrivialCopyOf(const MemoryAllocation& other) {
+    DCHECK(other.IsValid());
+    DCHECK(other.layout_->HasOnlyTrivialFields());
+    MemoryAllocation result;
+    result.layout_ = other.layout_;
+    result.alloc_ = AlignedAlloc(other.layout_->AllocAlignment(),
+                                 other.layout_->AllocSize());
+    std::memcpy(result.alloc_.get(), other.alloc_.get(),
+                other.layout_->AllocSize());
+    return result;
+  }
+
   MemoryAllocation(const MemoryAllocation&) = delete;
   MemoryAllocation& operator=(const MemoryAllocation&) = delete;
 
@@ -29,6 +29,25 @@ struct DeleteCounter {
 };
 int DeleteCounter::deletions = 0;
 
+TEST(MemoryAllocationTest, TrivialCopyOf) {
+  FrameLayout::Builder builder;
+  auto int_slot = builder.AddSlot<int>();
+  auto double_slot = builder.AddSlot<double>();
+  auto layout = std::move(builder).Build();
+  ASSERT_TRUE(layout.HasOnlyTrivialFields());
+
+  MemoryAllocation alloc(&layout);
+  alloc.frame().Set(int_slot, 57);
+  alloc.frame().Set(double_slot, 2.5);
+  MemoryAllocation copy = MemoryAllocation::TrivialCopyOf(alloc);
+  EXPECT_TRUE(copy.IsValid());
+  EXPECT_NE(copy.frame().GetRawPointer(0), alloc.frame().GetRawPointer(0));
+  EXPECT_EQ(copy.frame().Get(int_slot), 57);
+  EXPECT_EQ(copy.frame().Get(double_slot), 2.5);
+  copy.frame().Set(int_slot, 43);
+  EXPECT_EQ(alloc.frame().Get(int_slot), 57);
+}
+
 TEST(MemoryAllocationTest, TestEmptyValues) {
   FrameLayout::Builder builder;
   // Object with non-trivial destructor.
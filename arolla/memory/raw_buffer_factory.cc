@@ -15,7 +15,9 @@
 #include "arolla/memory/raw_buffer_factory.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
@@ -27,6 +29,12 @@
 #include "absl/hash/hash.h"  // IWYU pragma: keep
 #include "absl/log/check.h"
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // __linux__
+
 namespace arolla {
 
 namespace {
@@ -59,8 +67,102 @@ void InitializeMemoryForSanitizer(void* data, size_t size) {
 }
 #endif  // AROLLA_INITIALIZE_MEMORY_FOR_SANITIZER
 
+#ifdef __linux__
+
+constexpr size_t kHugePageSize = size_t{2} << 20;
+
+// Sets NUMA memory policy for the range. Must be called before the pages are
+// touched. We call mbind via syscall in order not to depend on libnuma.
+void SetNumaPolicy(void* data, size_t size, bool interleave, int numa_node) {
+#ifdef SYS_mbind
+  // Constants from linux/mempolicy.h.
+  constexpr int kMpolPreferred = 1;
+  constexpr int kMpolInterleave = 3;
+  using NodeMask = unsigned long;  // NOLINT(runtime/int)
+  constexpr int kNodeMaskBits = sizeof(NodeMask) * 8;
+  int mode;
+  NodeMask node_mask;
+  if (numa_node >= 0) {
+    if (numa_node >= kNodeMaskBits) {
+      return;
+    }
+    mode = kMpolPreferred;
+    node_mask = NodeMask{1} << numa_node;
+  } else if (interleave) {
+    mode = kMpolInterleave;
+    // The kernel intersects the mask with the nodes allowed for the process.
+    node_mask = ~NodeMask{0};
+  } else {
+    return;
+  }
+  // NOTE: the kernel expects the mask size in bits plus one.
+  syscall(SYS_mbind, data, size, mode, &node_mask, kNodeMaskBits + 1, 0);
+#endif  // SYS_mbind
+}
+
+// Maps `size` bytes (a multiple of kHugePageSize) aligned by kHugePageSize,
+// so all the range can be backed by huge pages. Returns nullptr on failure.
+void* MapAlignedToHugePage(size_t size) {
+  const size_t mapped_size = size + kHugePageSize;
+  void* mapped = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED) {
+    return nullptr;
+  }
+  const size_t begin = reinterpret_cast<size_t>(mapped);
+  const size_t aligned_begin =
+      (begin + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  // Unmap the unaligned head and the rest of the tail.
+  const size_t head_size = aligned_begin - begin;
+  if (head_size > 0) {
+    munmap(mapped, head_size);
+  }
+  munmap(reinterpret_cast<char*>(aligned_begin) + size,
+         kHugePageSize - head_size);
+  return reinterpret_cast<void*>(aligned_begin);
+}
+
+#endif  // __linux__
+
 }  // namespace
 
+std::tuple<RawBufferPtr, void*> HugePageBufferFactory::CreateRawBuffer(
+    size_t nbytes) {
+  if (nbytes == 0 || nbytes < options_.min_huge_page_buffer_size) {
+    return GetHeapBufferFactory()->CreateRawBuffer(nbytes);
+  }
+#ifdef __linux__
+  const size_t size =
+      (nbytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  void* data = MapAlignedToHugePage(size);
+  if (ABSL_PREDICT_FALSE(data == nullptr)) {
+    return GetHeapBufferFactory()->CreateRawBuffer(nbytes);
+  }
+  madvise(data, size, MADV_HUGEPAGE);
+  SetNumaPolicy(data, size, options_.numa_interleave, options_.numa_node);
+  return {std::shared_ptr<void>(data, [size](void* p) { munmap(p, size); }),
+          data};
+#else   // __linux__
+  return GetHeapBufferFactory()->CreateRawBuffer(nbytes);
+#endif  // __linux__
+}
+
+std::tuple<RawBufferPtr, void*> HugePageBufferFactory::ReallocRawBuffer(
+    RawBufferPtr&& old_buffer, void* old_data, size_t old_size,
+    size_t new_size) {
+  if (new_size == 0) return {nullptr, nullptr};
+  if (old_size == 0) return CreateRawBuffer(new_size);
+  if (new_size < options_.min_huge_page_buffer_size &&
+      std::get_deleter<decltype(&free)>(old_buffer) != nullptr) {
+    // Allocated on heap.
+    return GetHeapBufferFactory()->ReallocRawBuffer(
+        std::move(old_buffer), old_data, old_size, new_size);
+  }
+  auto [new_buffer, new_data] = CreateRawBuffer(new_size);
+  memcpy(new_data, old_data, std::min(old_size, new_size));
+  return {std::move(new_buffer), new_data};
+}
+
 std::tuple<RawBufferPtr, void*> HeapBufferFactory::CreateRawBuffer(
     size_t nbytes) {
   if (ABSL_PREDICT_FALSE(nbytes == 0)) return {nullptr, nullptr};
@@ -146,8 +248,39 @@ std::tuple<RawBufferPtr, void*> UnsafeArenaBufferFactory::ReallocRawBuffer(
   return {nullptr, last_alloc};
 }
 
-void UnsafeArenaBufferFactory::Reset() {
+int64_t UnsafeArenaBufferFactory::UsedBytes() const {
+  int64_t used = big_allocs_bytes_;
   if (page_id_ >= 0) {
+    used += page_id_ * page_size_ +
+            (current_ - reinterpret_cast<char*>(std::get<1>(pages_[page_id_])));
+  }
+  return used;
+}
+
+UnsafeArenaBufferFactory::Stats UnsafeArenaBufferFactory::GetStats() const {
+  int64_t used_bytes = UsedBytes();
+  return Stats{.page_count = static_cast<int64_t>(pages_.size()),
+               .used_bytes = used_bytes,
+               .peak_bytes = std::max(peak_bytes_, used_bytes)};
+}
+
+void UnsafeArenaBufferFactory::Reset() {
+  peak_bytes_ = std::max(peak_bytes_, UsedBytes());
+  pages_used_in_shrink_period_ =
+      std::max(pages_used_in_shrink_period_, page_id_ + 1);
+  if (++resets_in_shrink_period_ >= kShrinkPeriod) {
+    int64_t pages_to_keep =
+        std::max(pages_used_in_shrink_period_, reserved_page_count_);
+    if (static_cast<int64_t>(pages_.size()) > pages_to_keep) {
+      pages_.resize(pages_to_keep);
+    }
+    resets_in_shrink_period_ = 0;
+    pages_used_in_shrink_period_ = 0;
+  }
+  if (pages_.empty()) {
+    page_id_ = -1;
+    current_ = end_ = reinterpret_cast<char*>(0x8);
+  } else if (page_id_ >= 0) {
     page_id_ = 0;
     current_ = reinterpret_cast<char*>(std::get<1>(pages_[0]));
 #ifdef AROLLA_INITIALIZE_MEMORY_FOR_SANITIZER
@@ -156,6 +289,18 @@ void UnsafeArenaBufferFactory::Reset() {
     end_ = current_ + page_size_;
   }
   big_allocs_.clear();
+  big_allocs_bytes_ = 0;
+}
+
+void UnsafeArenaBufferFactory::Reserve(int64_t nbytes) {
+  if (nbytes <= 0) {
+    return;
+  }
+  reserved_page_count_ =
+      std::max(reserved_page_count_, (nbytes + page_size_ - 1) / page_size_);
+  while (static_cast<int64_t>(pages_.size()) < reserved_page_count_) {
+    pages_.push_back(base_factory_.CreateRawBuffer(page_size_));
+  }
 }
 
 ABSL_ATTRIBUTE_NOINLINE void* UnsafeArenaBufferFactory::SlowAlloc(
@@ -167,6 +312,7 @@ ABSL_ATTRIBUTE_NOINLINE void* UnsafeArenaBufferFactory::SlowAlloc(
     InitializeMemoryForSanitizer(memory, nbytes);
 #endif  // AROLLA_INITIALIZE_MEMORY_FOR_SANITIZER
     big_allocs_.emplace_back(std::move(holder), memory);
+    big_allocs_bytes_ += nbytes;
     return memory;
   }
   NextPage();
@@ -190,4 +336,113 @@ void UnsafeArenaBufferFactory::NextPage() {
   end_ = current_ + page_size_;
 }
 
+class AllocationTrackingBufferFactory::TrackedBuffer {
+ public:
+  TrackedBuffer(RawBufferPtr buffer, size_t nbytes,
+                std::shared_ptr<LiveBytes> live_bytes)
+      : buffer_(std::move(buffer)),
+        nbytes_(nbytes),
+        live_bytes_(std::move(live_bytes)) {
+    int64_t live =
+        live_bytes_->live_bytes.fetch_add(nbytes_, std::memory_order_relaxed) +
+        nbytes_;
+    int64_t peak = live_bytes_->peak_live_bytes.load(std::memory_order_relaxed);
+    while (peak < live && !live_bytes_->peak_live_bytes.compare_exchange_weak(
+                              peak, live, std::memory_order_relaxed)) {
+    }
+  }
+
+  TrackedBuffer(const TrackedBuffer&) = delete;
+  TrackedBuffer& operator=(const TrackedBuffer&) = delete;
+
+  ~TrackedBuffer() {
+    live_bytes_->live_bytes.fetch_sub(nbytes_, std::memory_order_relaxed);
+  }
+
+  // Takes the underlying buffer away, the caller is responsible for the
+  // accounting of the released bytes.
+  RawBufferPtr Release() && {
+    live_bytes_->live_bytes.fetch_sub(nbytes_, std::memory_order_relaxed);
+    nbytes_ = 0;
+    return std::move(buffer_);
+  }
+
+ private:
+  RawBufferPtr buffer_;
+  size_t nbytes_;
+  std::shared_ptr<LiveBytes> live_bytes_;
+};
+
+AllocationTrackingBufferFactory::AllocationTrackingBufferFactory(
+    RawBufferFactory& base_factory, bool track_live_bytes)
+    : base_factory_(base_factory),
+      live_bytes_(track_live_bytes ? std::make_shared<LiveBytes>() : nullptr) {
+}
+
+RawBufferPtr AllocationTrackingBufferFactory::Track(RawBufferPtr buffer,
+                                                    size_t nbytes) {
+  // Unowned buffers (e.g. from UnsafeArenaBufferFactory) must stay nullptr.
+  if (live_bytes_ == nullptr || buffer == nullptr) {
+    return buffer;
+  }
+  return std::make_shared<TrackedBuffer>(std::move(buffer), nbytes,
+                                         live_bytes_);
+}
+
+std::tuple<RawBufferPtr, void*>
+AllocationTrackingBufferFactory::CreateRawBuffer(size_t nbytes) {
+  create_count_.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes_.fetch_add(nbytes, std::memory_order_relaxed);
+  auto [buffer, data] = base_factory_.CreateRawBuffer(nbytes);
+  return {Track(std::move(buffer), nbytes), data};
+}
+
+std::tuple<RawBufferPtr, void*>
+AllocationTrackingBufferFactory::ReallocRawBuffer(RawBufferPtr&& old_buffer,
+                                                  void* data, size_t old_size,
+                                                  size_t new_size) {
+  realloc_count_.fetch_add(1, std::memory_order_relaxed);
+  if (new_size > old_size) {
+    allocated_bytes_.fetch_add(new_size - old_size, std::memory_order_relaxed);
+  }
+  if (live_bytes_ != nullptr && old_buffer != nullptr) {
+    // The buffer is uniquely owned and was created by this factory.
+    auto* tracked = const_cast<TrackedBuffer*>(
+        static_cast<const TrackedBuffer*>(old_buffer.get()));
+    RawBufferPtr base_buffer = std::move(*tracked).Release();
+    old_buffer = nullptr;
+    auto [buffer, new_data] = base_factory_.ReallocRawBuffer(
+        std::move(base_buffer), data, old_size, new_size);
+    return {Track(std::move(buffer), new_size), new_data};
+  }
+  auto [buffer, new_data] = base_factory_.ReallocRawBuffer(
+      std::move(old_buffer), data, old_size, new_size);
+  return {Track(std::move(buffer), new_size), new_data};
+}
+
+AllocationTrackingBufferFactory::Stats
+AllocationTrackingBufferFactory::GetStats() const {
+  Stats stats{
+      .create_count = create_count_.load(std::memory_order_relaxed),
+      .realloc_count = realloc_count_.load(std::memory_order_relaxed),
+      .allocated_bytes = allocated_bytes_.load(std::memory_order_relaxed)};
+  if (live_bytes_ != nullptr) {
+    stats.live_bytes = live_bytes_->live_bytes.load(std::memory_order_relaxed);
+    stats.peak_live_bytes =
+        live_bytes_->peak_live_bytes.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void AllocationTrackingBufferFactory::ResetStats() {
+  create_count_.store(0, std::memory_order_relaxed);
+  realloc_count_.store(0, std::memory_order_relaxed);
+  allocated_bytes_.store(0, std::memory_order_relaxed);
+  if (live_bytes_ != nullptr) {
+    live_bytes_->peak_live_bytes.store(
+        live_bytes_->live_bytes.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  }
+}
+
 }  // namespace arolla
@@ -15,6 +15,7 @@
 #ifndef AROLLA_MEMORY_RAW_BUFFER_FACTORY_H_
 #define AROLLA_MEMORY_RAW_BUFFER_FACTORY_H_
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -81,6 +82,45 @@ inline RawBufferFactory* GetHeapBufferFactory() {
   return factory.get();
 }
 
+struct HugePageBufferFactoryOptions {
+  // Smaller buffers are allocated on heap.
+  size_t min_huge_page_buffer_size = size_t{2} << 20;
+  // Interleave the pages of the buffers over all the NUMA nodes available to
+  // the process.
+  bool numa_interleave = false;
+  // If non-negative, the pages are preferably allocated on the given NUMA
+  // node. Overrides `numa_interleave`.
+  int numa_node = -1;
+};
+
+// Buffer factory for big long-living buffers, like the model literals
+// (embedding tables, dictionaries, decision forests). The buffers are backed
+// by transparent huge pages, which reduces TLB misses on random access. With
+// `numa_interleave` the pages are spread over all NUMA nodes, so on
+// multi-socket hosts all the threads see the same average latency instead of
+// some of them accessing remote memory only.
+//
+// Huge pages and interleaving are hints: if the kernel does not support them,
+// the buffers are still usable. On platforms other than Linux all the buffers
+// are allocated on heap. The factory is thread safe.
+class HugePageBufferFactory final : public RawBufferFactory {
+ public:
+  HugePageBufferFactory() = default;
+  explicit HugePageBufferFactory(HugePageBufferFactoryOptions options)
+      : options_(options) {}
+
+  std::tuple<RawBufferPtr, void*> CreateRawBuffer(size_t nbytes) final;
+
+  // NOTE: the huge page buffers are always reallocated with a copy.
+  std::tuple<RawBufferPtr, void*> ReallocRawBuffer(RawBufferPtr&& old_buffer,
+                                                   void* old_data,
+                                                   size_t old_size,
+                                                   size_t new_size) final;
+
+ private:
+  HugePageBufferFactoryOptions options_;
+};
+
 // Provides BufferFactory interface for google::protobuf::Arena. All buffers will be
 // allocated inside the given google::protobuf::Arena. The arena should outlive
 // the BufferFactory.
@@ -131,12 +171,39 @@ class UnsafeArenaBufferFactory : public RawBufferFactory {
   // Reset internal state. All previously allocated buffers become invalid and
   // memory will be reused for next allocations. To release the memory Arena
   // should destroyed or recreated (e.g. arena=UnsafeArenaBufferFactory(size)).
+  //
+  // The pages are kept between resets, but every kShrinkPeriod resets the
+  // arena releases the pages that were not used during the period (i.e. the
+  // pages above the high-water mark).
   void Reset();
 
+  // Preallocates pages (via `base_factory`) for at least `nbytes` of
+  // allocations, so e.g. the first evaluations of a model on a batch of a
+  // known size do not hit the base factory. Allocations larger than the page
+  // size still go to the base factory. The reserved pages are not released by
+  // the shrink policy of Reset().
+  void Reserve(int64_t nbytes);
+
+  static constexpr int64_t kShrinkPeriod = 256;
+
+  struct Stats {
+    // The number of pages currently owned by the arena.
+    int64_t page_count = 0;
+    // The number of bytes used since the last reset. Includes the allocations
+    // that didn't fit into a page.
+    int64_t used_bytes = 0;
+    // The max value of used_bytes during the arena lifetime.
+    int64_t peak_bytes = 0;
+  };
+
+  Stats GetStats() const;
+
  private:
   using Alloc = std::tuple<RawBufferPtr, void*>;
   void NextPage();
   void* SlowAlloc(size_t nbytes);
+  // The number of bytes used since the last reset.
+  int64_t UsedBytes() const;
 
   int64_t page_id_ = -1;
 
@@ -149,6 +216,77 @@ class UnsafeArenaBufferFactory : public RawBufferFactory {
   RawBufferFactory& base_factory_;
   absl::InlinedVector<Alloc, 16> pages_;
   absl::InlinedVector<Alloc, 16> big_allocs_;
+  int64_t big_allocs_bytes_ = 0;
+
+  int64_t peak_bytes_ = 0;
+  int64_t resets_in_shrink_period_ = 0;
+  int64_t pages_used_in_shrink_period_ = 0;
+  int64_t reserved_page_count_ = 0;
+};
+
+// Buffer factory that forwards the calls to `base_factory` and counts them.
+// Can be used to measure the allocations of a model evaluation:
+//
+//   AllocationTrackingBufferFactory factory;
+//   ASSIGN_OR_RETURN(auto result,
+//                    model({.buffer_factory = &factory}, input));
+//   LOG(INFO) << factory.GetStats().allocated_bytes;
+//
+// With `track_live_bytes` the returned buffers are wrapped in order to observe
+// their destruction (it costs an extra allocation per buffer), which enables
+// the live_bytes and peak_live_bytes stats. Such a factory can reallocate only
+// the buffers it has created itself, as required by the RawBufferFactory
+// contract anyway. Unowned buffers (e.g. allocated in an
+// UnsafeArenaBufferFactory) are not tracked.
+//
+// The counters are thread safe, so the factory is thread safe if
+// `base_factory` is.
+class AllocationTrackingBufferFactory final : public RawBufferFactory {
+ public:
+  struct Stats {
+    // The number of CreateRawBuffer calls.
+    int64_t create_count = 0;
+    // The number of ReallocRawBuffer calls.
+    int64_t realloc_count = 0;
+    // Bytes requested by CreateRawBuffer plus the growth requested by
+    // ReallocRawBuffer.
+    int64_t allocated_bytes = 0;
+    // Bytes in the buffers that are still alive. Only with track_live_bytes.
+    int64_t live_bytes = 0;
+    // The max value of live_bytes. Only with track_live_bytes.
+    int64_t peak_live_bytes = 0;
+  };
+
+  explicit AllocationTrackingBufferFactory(
+      RawBufferFactory& base_factory = *GetHeapBufferFactory(),
+      bool track_live_bytes = false);
+
+  std::tuple<RawBufferPtr, void*> CreateRawBuffer(size_t nbytes) final;
+
+  std::tuple<RawBufferPtr, void*> ReallocRawBuffer(RawBufferPtr&& old_buffer,
+                                                   void* data, size_t old_size,
+                                                   size_t new_size) final;
+
+  Stats GetStats() const;
+
+  // Resets the counters. peak_live_bytes is reset to the current live_bytes.
+  void ResetStats();
+
+ private:
+  // Shared with the wrapped buffers, which can outlive the factory.
+  struct LiveBytes {
+    std::atomic<int64_t> live_bytes = 0;
+    std::atomic<int64_t> peak_live_bytes = 0;
+  };
+  class TrackedBuffer;
+
+  RawBufferPtr Track(RawBufferPtr buffer, size_t nbytes);
+
+  RawBufferFactory& base_factory_;
+  std::atomic<int64_t> create_count_ = 0;
+  std::atomic<int64_t> realloc_count_ = 0;
+  std::atomic<int64_t> allocated_bytes_ = 0;
+  std::shared_ptr<LiveBytes> live_bytes_;  // nullptr if not tracked.
 };
 
 // Types that can be unowned should overload ArenaTraits. Should be used
@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -112,6 +113,73 @@ TEST(ProtobufArenaBufferFactory, CreateAndResize) {
   VerifyCanReadUninitialized(d + 1, 2);
 }
 
+TEST(HugePageBufferFactory, CreateRawBuffer) {
+  HugePageBufferFactory factory;
+  {
+    auto [buf, data] = factory.CreateRawBuffer(0);
+    EXPECT_EQ(buf, nullptr);
+    EXPECT_EQ(data, nullptr);
+  }
+  for (size_t size : {size_t{13}, size_t{3} << 20}) {
+    auto [buf, data] = factory.CreateRawBuffer(size);
+    EXPECT_NE(buf, nullptr);
+    EXPECT_EQ(reinterpret_cast<size_t>(data) & 7, 0);  // Check alignment.
+    memset(data, 1, size);
+  }
+#ifdef __linux__
+  auto [buf, data] = factory.CreateRawBuffer(size_t{3} << 20);
+  EXPECT_EQ(reinterpret_cast<size_t>(data) % (size_t{2} << 20), 0);
+#endif  // __linux__
+}
+
+TEST(HugePageBufferFactory, NumaInterleave) {
+  HugePageBufferFactory factory(
+      {.min_huge_page_buffer_size = 4096, .numa_interleave = true});
+  auto [buf, data] = factory.CreateRawBuffer(10000);
+  EXPECT_NE(buf, nullptr);
+  memset(data, 1, 10000);
+  EXPECT_EQ(static_cast<char*>(data)[9999], 1);
+}
+
+TEST(HugePageBufferFactory, NumaNode) {
+  HugePageBufferFactory factory(
+      {.min_huge_page_buffer_size = 4096, .numa_node = 0});
+  auto [buf, data] = factory.CreateRawBuffer(10000);
+  EXPECT_NE(buf, nullptr);
+  memset(data, 1, 10000);
+  EXPECT_EQ(static_cast<char*>(data)[9999], 1);
+}
+
+TEST(HugePageBufferFactory, ReallocRawBuffer) {
+  HugePageBufferFactory factory({.min_huge_page_buffer_size = 1000});
+  size_t size = 13;
+  auto [buf, data_ptr] = factory.CreateRawBuffer(size);
+  char* data = static_cast<char*>(data_ptr);
+  auto resize_fn = [&](size_t new_size) {
+    auto res = factory.ReallocRawBuffer(std::move(buf), data, size, new_size);
+    buf = std::get<0>(res);
+    data = reinterpret_cast<char*>(std::get<1>(res));
+    size = new_size;
+  };
+
+  data[0] = 5;
+  resize_fn(145);  // heap -> heap
+  EXPECT_EQ(data[0], 5);
+  data[144] = 7;
+  resize_fn(5000);  // heap -> huge pages
+  EXPECT_EQ(data[0], 5);
+  EXPECT_EQ(data[144], 7);
+  data[4999] = 9;
+  resize_fn(10000);  // huge pages -> huge pages
+  EXPECT_EQ(data[0], 5);
+  EXPECT_EQ(data[4999], 9);
+  resize_fn(145);  // huge pages -> heap
+  EXPECT_EQ(data[0], 5);
+  EXPECT_EQ(data[144], 7);
+  resize_fn(0);
+  EXPECT_EQ(buf, nullptr);
+}
+
 TEST(UnsafeArenaBufferFactory, CreateEmptyBuffer) {
   UnsafeArenaBufferFactory arena(25);
 
@@ -165,6 +233,65 @@ TEST(UnsafeArenaBufferFactory, CreateRawBuffer) {
   }
 }
 
+TEST(UnsafeArenaBufferFactory, Stats) {
+  UnsafeArenaBufferFactory arena(32);
+  EXPECT_EQ(arena.GetStats().page_count, 0);
+  EXPECT_EQ(arena.GetStats().peak_bytes, 0);
+
+  auto [buf1, data1] = arena.CreateRawBuffer(24);
+  auto [buf2, data2] = arena.CreateRawBuffer(16);  // on the second page
+  auto [buf3, data3] = arena.CreateRawBuffer(40);  // big alloc
+  EXPECT_EQ(arena.GetStats().page_count, 2);
+  EXPECT_EQ(arena.GetStats().used_bytes, 32 + 16 + 40);
+  EXPECT_EQ(arena.GetStats().peak_bytes, 32 + 16 + 40);
+
+  arena.Reset();
+  auto [buf4, data4] = arena.CreateRawBuffer(8);
+  EXPECT_EQ(data4, data1);  // the first page is reused
+  EXPECT_EQ(arena.GetStats().page_count, 2);
+  EXPECT_EQ(arena.GetStats().used_bytes, 8);
+  EXPECT_EQ(arena.GetStats().peak_bytes, 32 + 16 + 40);
+}
+
+TEST(UnsafeArenaBufferFactory, ShrinkToHighWaterMark) {
+  UnsafeArenaBufferFactory arena(32);
+  for (int i = 0; i < 3; ++i) {
+    arena.CreateRawBuffer(32);
+  }
+  EXPECT_EQ(arena.GetStats().page_count, 3);
+  arena.Reset();
+  // The current shrink period has a high-water mark of 3 pages, so nothing is
+  // released at its end. The next period uses only one page, so the two other
+  // pages are released.
+  for (int64_t i = 0; i < 2 * UnsafeArenaBufferFactory::kShrinkPeriod; ++i) {
+    arena.CreateRawBuffer(16);
+    arena.Reset();
+  }
+  EXPECT_EQ(arena.GetStats().page_count, 1);
+  auto [buf, data] = arena.CreateRawBuffer(16);
+  EXPECT_NE(data, nullptr);
+}
+
+TEST(UnsafeArenaBufferFactory, Reserve) {
+  UnsafeArenaBufferFactory arena(32);
+  arena.Reserve(80);
+  EXPECT_EQ(arena.GetStats().page_count, 3);
+  EXPECT_EQ(arena.GetStats().used_bytes, 0);
+  for (int i = 0; i < 3; ++i) {
+    auto [buf, data] = arena.CreateRawBuffer(32);
+    EXPECT_NE(data, nullptr);
+  }
+  EXPECT_EQ(arena.GetStats().page_count, 3);  // no new pages
+  arena.Reserve(16);  // already reserved
+  EXPECT_EQ(arena.GetStats().page_count, 3);
+
+  // The reserved pages are kept even if they are not used.
+  for (int64_t i = 0; i < 2 * UnsafeArenaBufferFactory::kShrinkPeriod; ++i) {
+    arena.Reset();
+  }
+  EXPECT_EQ(arena.GetStats().page_count, 3);
+}
+
 TEST(UnsafeArenaBufferFactory, ReallocRawBuffer) {
   UnsafeArenaBufferFactory arena1(25);
 
@@ -298,5 +425,72 @@ TEST(UnsafeArenaBufferFactory, BaseFactory) {
   EXPECT_GT(ptr_after, ptr_big);
 }
 
+TEST(AllocationTrackingBufferFactory, CountsCalls) {
+  AllocationTrackingBufferFactory factory;
+  auto [buf1, data1] = factory.CreateRawBuffer(16);
+  auto [buf2, data2] = factory.CreateRawBuffer(8);
+  std::tie(buf2, data2) =
+      factory.ReallocRawBuffer(std::move(buf2), data2, 8, 32);
+  std::tie(buf2, data2) =
+      factory.ReallocRawBuffer(std::move(buf2), data2, 32, 4);
+
+  auto stats = factory.GetStats();
+  EXPECT_EQ(stats.create_count, 2);
+  EXPECT_EQ(stats.realloc_count, 2);
+  EXPECT_EQ(stats.allocated_bytes, 16 + 8 + 24);
+  EXPECT_EQ(stats.live_bytes, 0);
+  EXPECT_EQ(stats.peak_live_bytes, 0);
+
+  factory.ResetStats();
+  stats = factory.GetStats();
+  EXPECT_EQ(stats.create_count, 0);
+  EXPECT_EQ(stats.realloc_count, 0);
+  EXPECT_EQ(stats.allocated_bytes, 0);
+}
+
+TEST(AllocationTrackingBufferFactory, LiveBytes) {
+  AllocationTrackingBufferFactory factory(*GetHeapBufferFactory(),
+                                          /*track_live_bytes=*/true);
+  auto [buf1, data1] = factory.CreateRawBuffer(16);
+  auto [buf2, data2] = factory.CreateRawBuffer(8);
+  std::memset(data2, 7, 8);
+  EXPECT_EQ(factory.GetStats().live_bytes, 24);
+
+  std::tie(buf2, data2) =
+      factory.ReallocRawBuffer(std::move(buf2), data2, 8, 64);
+  EXPECT_EQ(static_cast<char*>(data2)[7], 7);
+  EXPECT_EQ(factory.GetStats().live_bytes, 80);
+  EXPECT_EQ(factory.GetStats().peak_live_bytes, 80);
+
+  buf2 = nullptr;
+  EXPECT_EQ(factory.GetStats().live_bytes, 16);
+  EXPECT_EQ(factory.GetStats().peak_live_bytes, 80);
+
+  factory.ResetStats();
+  EXPECT_EQ(factory.GetStats().peak_live_bytes, 16);
+
+  // The buffers can outlive the factory.
+  {
+    AllocationTrackingBufferFactory short_lived_factory(
+        *GetHeapBufferFactory(), /*track_live_bytes=*/true);
+    std::tie(buf2, data2) = short_lived_factory.CreateRawBuffer(8);
+  }
+  buf2 = nullptr;
+}
+
+TEST(AllocationTrackingBufferFactory, UnownedBuffers) {
+  UnsafeArenaBufferFactory arena(1024);
+  AllocationTrackingBufferFactory factory(arena, /*track_live_bytes=*/true);
+  auto [buf, data] = factory.CreateRawBuffer(16);
+  EXPECT_EQ(buf, nullptr);
+  std::tie(buf, data) = factory.ReallocRawBuffer(std::move(buf), data, 16, 32);
+  EXPECT_EQ(buf, nullptr);
+  auto stats = factory.GetStats();
+  EXPECT_EQ(stats.create_count, 1);
+  EXPECT_EQ(stats.realloc_count, 1);
+  EXPECT_EQ(stats.allocated_bytes, 32);
+  EXPECT_EQ(stats.live_bytes, 0);
+}
+
 }  // namespace
 }  // namespace arolla
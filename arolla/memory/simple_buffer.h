@@ -320,6 +320,17 @@ class SimpleBuffer final {
   // attempts to DeepCopy empty buffers.
   bool is_owner() const { return empty() || (raw_buffer_ != nullptr); }
 
+  // Returns true if no other Buffer object shares the underlying data, so it
+  // can be modified in place once this buffer is not needed anymore. Unowned
+  // and empty buffers are never uniquely owned.
+  bool is_uniquely_owned() const {
+    return !empty() && raw_buffer_ != nullptr && raw_buffer_.use_count() == 1;
+  }
+
+  // Returns the object controlling the lifetime of the underlying data, or
+  // nullptr if the buffer is unowned.
+  const RawBufferPtr& raw_buffer() const { return raw_buffer_; }
+
   // Returns true if the buffer length is 0.
   bool empty() const { return span_.empty(); }
 
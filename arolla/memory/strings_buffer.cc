@@ -21,6 +21,7 @@
 #include <limits>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "absl/strings/string_view.h"
@@ -72,6 +73,13 @@ StringsBuffer::ReshuffleBuilder::ReshuffleBuilder(
   }
 }
 
+StringsBuffer::SubstringsBuilder::SubstringsBuilder(
+    int64_t max_size, const StringsBuffer& buffer,
+    RawBufferFactory* buf_factory)
+    : offsets_bldr_(max_size, buf_factory),
+      characters_(buffer.characters()),
+      base_offset_(buffer.base_offset()) {}
+
 StringsBuffer StringsBuffer::Builder::Build(int64_t size) && {
   DCHECK_LE(size, offsets_.size());
   if (num_chars_ != characters_.size()) {
@@ -104,6 +112,92 @@ void StringsBuffer::Builder::InitDataPointers(
       characters_size);
 }
 
+StringsBuffer::ChunkedBuilder::ChunkedBuilder(int64_t size_hint,
+                                              RawBufferFactory* factory)
+    : factory_(factory) {
+  if (size_hint > 0) {
+    ResizeOffsets(size_hint);
+    StartPage(std::min(size_hint * 16, kMaxPageSize));
+  }
+}
+
+void StringsBuffer::ChunkedBuilder::StartPage(size_t min_size) {
+  FinishPage();
+  int64_t page_size = std::clamp<int64_t>(page_base_, kMinPageSize,
+                                          kMaxPageSize);
+  page_size = std::max<int64_t>(page_size, min_size);
+  DCHECK_LT(page_base_ + page_size, std::numeric_limits<offset_type>::max());
+  auto [buf, data] = factory_->CreateRawBuffer(page_size);
+  page_buf_ = std::move(buf);
+  page_ = absl::Span<char>(static_cast<char*>(data), page_size);
+}
+
+void StringsBuffer::ChunkedBuilder::FinishPage() {
+  if (page_used_ > 0) {
+    pages_.emplace_back(std::move(page_buf_), page_.subspan(0, page_used_));
+    page_base_ += page_used_;
+  }
+  page_buf_ = nullptr;
+  page_ = absl::Span<char>();
+  page_used_ = 0;
+}
+
+void StringsBuffer::ChunkedBuilder::ResizeOffsets(int64_t new_size) {
+  auto [buf, data] = factory_->ReallocRawBuffer(
+      std::move(offsets_buf_), offsets_.data(),
+      offsets_.size() * sizeof(Offsets), new_size * sizeof(Offsets));
+  offsets_buf_ = std::move(buf);
+  offsets_ = absl::Span<Offsets>(static_cast<Offsets*>(data), new_size);
+}
+
+void StringsBuffer::ChunkedBuilder::AddAll(const StringsBuffer& buffer) {
+  if (buffer.empty()) {
+    return;
+  }
+  FinishPage();
+  if (size_ + buffer.size() > offsets_.size()) {
+    ResizeOffsets(std::max(size_ + buffer.size(),
+                           static_cast<int64_t>(offsets_.size()) * 2));
+  }
+  const offset_type shift = page_base_ - buffer.base_offset();
+  for (const Offsets& o : buffer.offsets()) {
+    offsets_[size_++] = {o.start + shift, o.end + shift};
+  }
+  if (!buffer.characters().empty()) {
+    pages_.push_back(buffer.characters());
+    page_base_ += buffer.characters().size();
+  }
+}
+
+StringsBuffer StringsBuffer::ChunkedBuilder::Build() && {
+  if (size_ == 0) {
+    return StringsBuffer();
+  }
+  if (pages_.empty() && page_used_ > 0 && page_used_ < page_.size()) {
+    // The page becomes the characters buffer, so we release the unused tail.
+    auto [buf, data] = factory_->ReallocRawBuffer(
+        std::move(page_buf_), page_.data(), page_.size(), page_used_);
+    page_buf_ = std::move(buf);
+    page_ = absl::Span<char>(static_cast<char*>(data), page_used_);
+  }
+  FinishPage();
+  SimpleBuffer<char> characters;
+  if (pages_.size() == 1) {
+    characters = std::move(pages_[0]);
+  } else if (pages_.size() > 1) {
+    SimpleBuffer<char>::Builder bldr(page_base_, factory_);
+    char* data = bldr.GetMutableSpan().data();
+    for (const auto& page : pages_) {
+      data = std::copy(page.begin(), page.end(), data);
+    }
+    characters = std::move(bldr).Build();
+  }
+  pages_.clear();
+  SimpleBuffer<Offsets> offsets(std::move(offsets_buf_),
+                                offsets_.subspan(0, size_));
+  return StringsBuffer(std::move(offsets), std::move(characters));
+}
+
 StringsBuffer::StringsBuffer(SimpleBuffer<StringsBuffer::Offsets> offsets,
                              SimpleBuffer<char> characters,
                              offset_type base_offset)
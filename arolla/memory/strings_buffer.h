@@ -24,6 +24,7 @@
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "absl/strings/cord.h"
@@ -196,6 +197,132 @@ class StringsBuffer {
     offset_type base_offset_;
   };
 
+  // Allows to create a buffer of substrings of the strings stored in another
+  // buffer. The characters buffer of the original buffer is shared, only the
+  // new offsets are allocated.
+  class SubstringsBuilder {
+   public:
+    explicit SubstringsBuilder(
+        int64_t max_size, const StringsBuffer& buffer,
+        RawBufferFactory* buf_factory = GetHeapBufferFactory());
+
+    // Returns true if `v` references characters of the original buffer, and
+    // so can be passed to Set().
+    bool Contains(absl::string_view v) const {
+      return v.empty() || (v.data() >= characters_.begin() &&
+                           v.data() + v.size() <= characters_.end());
+    }
+
+    // Sets the value at `offset`. `v` must reference characters of the
+    // original buffer, see Contains().
+    void Set(int64_t offset, absl::string_view v) {
+      DCHECK(Contains(v));
+      if (v.empty()) {
+        offsets_bldr_.Set(offset, {base_offset_, base_offset_});
+      } else {
+        offset_type start = v.data() - characters_.begin() + base_offset_;
+        offsets_bldr_.Set(offset,
+                          {start, start + static_cast<offset_type>(v.size())});
+      }
+    }
+
+    StringsBuffer Build(int64_t size) && {
+      return StringsBuffer(std::move(offsets_bldr_).Build(size),
+                           std::move(characters_), base_offset_);
+    }
+
+    StringsBuffer Build() && {
+      return StringsBuffer(std::move(offsets_bldr_).Build(),
+                           std::move(characters_), base_offset_);
+    }
+
+   private:
+    SimpleBuffer<Offsets>::Builder offsets_bldr_;
+    SimpleBuffer<char> characters_;
+    offset_type base_offset_;
+  };
+
+  // Builds a buffer by appending values when neither the number of values nor
+  // the total size of the characters is known in advance. The characters are
+  // written into pages of geometrically growing size allocated from the buffer
+  // factory, so the previously added characters are never moved. Build()
+  // copies the pages into a single characters buffer only if there is more
+  // than one of them.
+  class ChunkedBuilder {
+   public:
+    static constexpr int64_t kMinPageSize = 256;
+    static constexpr int64_t kMaxPageSize = int64_t{1} << 20;
+
+    // `size_hint` is the expected number of values; it is used to choose the
+    // initial capacity.
+    explicit ChunkedBuilder(
+        int64_t size_hint = 0,
+        RawBufferFactory* factory = GetHeapBufferFactory());
+
+    ChunkedBuilder(ChunkedBuilder&&) = default;
+    ChunkedBuilder& operator=(ChunkedBuilder&&) = default;
+
+    // Number of the added values.
+    int64_t size() const { return size_; }
+
+    void Add(absl::string_view v) {
+      char* data = AllocateCharacters(v.size());
+      std::copy(v.begin(), v.end(), data);
+      AddOffsets(v.size());
+    }
+
+    void Add(const absl::Cord& v) {
+      char* data = AllocateCharacters(v.size());
+      for (absl::string_view chunk : v.Chunks()) {
+        data = std::copy(chunk.begin(), chunk.end(), data);
+      }
+      AddOffsets(v.size());
+    }
+
+    // Appends all values of `buffer`. Its characters buffer is shared rather
+    // than copied; if it is the only one, it becomes the characters buffer of
+    // the result as is.
+    void AddAll(const StringsBuffer& buffer);
+
+    StringsBuffer Build() &&;
+
+   private:
+    // Returns a pointer to `size` characters in the current page, which will
+    // be used by the next value.
+    char* AllocateCharacters(size_t size) {
+      if (size > page_.size() - page_used_) {
+        StartPage(size);
+      }
+      return page_.data() + page_used_;
+    }
+
+    void AddOffsets(size_t size) {
+      if (size_ == offsets_.size()) {
+        ResizeOffsets(std::max<int64_t>(offsets_.size() * 2, 16));
+      }
+      offset_type start = page_base_ + page_used_;
+      page_used_ += size;
+      offsets_[size_++] = {start, start + static_cast<offset_type>(size)};
+    }
+
+    void StartPage(size_t min_size);
+    void FinishPage();
+    void ResizeOffsets(int64_t new_size);
+
+    RawBufferFactory* factory_;
+    RawBufferPtr offsets_buf_;
+    absl::Span<Offsets> offsets_;
+    int64_t size_ = 0;
+    // Finished pages, each one truncated to the used characters. The offsets
+    // are relative to the concatenation of the pages.
+    std::vector<SimpleBuffer<char>> pages_;
+    RawBufferPtr page_buf_;
+    absl::Span<char> page_;
+    offset_type page_used_ = 0;
+    // Total size of the finished pages.
+    offset_type page_base_ = 0;
+  };
+
   // Returns buffer of the given size with uninitialized values (empty strings).
   static StringsBuffer CreateUninitialized(
       size_t size, RawBufferFactory* factory = GetHeapBufferFactory()) {
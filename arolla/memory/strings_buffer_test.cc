@@ -23,6 +23,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/hash/hash_testing.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "arolla/memory/buffer.h"
@@ -327,5 +328,81 @@ TEST(StringsBufferBuilder, ReshuffleBuilder) {
   }
 }
 
+TEST(StringsBufferBuilder, SubstringsBuilder) {
+  auto buf = CreateBuffer<std::string>({"hello", "world", "", "abc"});
+  Buffer<std::string>::SubstringsBuilder bldr(5, buf);
+  bldr.Set(0, buf[0].substr(1, 3));
+  bldr.Set(1, buf[1].substr(3));
+  bldr.Set(2, buf[2]);
+  bldr.Set(3, buf[3]);
+  bldr.Set(4, absl::string_view());
+  EXPECT_TRUE(bldr.Contains(buf[1].substr(2, 2)));
+  EXPECT_TRUE(bldr.Contains(""));
+  std::string other = "abc";
+  EXPECT_FALSE(bldr.Contains(other));
+  auto res = std::move(bldr).Build();
+  EXPECT_THAT(res, ElementsAre("ell", "ld", "", "abc", ""));
+  EXPECT_EQ(res.characters().begin(), buf.characters().begin());
+
+  auto sliced = buf.Slice(1);
+  Buffer<std::string>::SubstringsBuilder sliced_bldr(2, sliced);
+  sliced_bldr.Set(0, sliced[2].substr(1));
+  sliced_bldr.Set(1, sliced[0].substr(0, 1));
+  EXPECT_THAT(std::move(sliced_bldr).Build(), ElementsAre("bc", "w"));
+}
+
+TEST(StringsBufferBuilder, ChunkedBuilder) {
+  Buffer<std::string>::ChunkedBuilder bldr;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 1000; ++i) {
+    expected.push_back(std::string(i % 37, 'a' + i % 26));
+    if (i % 2 == 0) {
+      bldr.Add(expected.back());
+    } else {
+      bldr.Add(absl::Cord(expected.back()));
+    }
+  }
+  EXPECT_EQ(bldr.size(), 1000);
+  auto res = std::move(bldr).Build();
+  EXPECT_THAT(res, ElementsAreArray(expected));
+  EXPECT_TRUE(res.is_owner());
+
+  EXPECT_THAT(Buffer<std::string>::ChunkedBuilder().Build(), IsEmpty());
+}
+
+TEST(StringsBufferBuilder, ChunkedBuilderSinglePage) {
+  Buffer<std::string>::ChunkedBuilder bldr(/*size_hint=*/3);
+  bldr.Add("abc");
+  bldr.Add("");
+  bldr.Add("de");
+  auto res = std::move(bldr).Build();
+  EXPECT_THAT(res, ElementsAre("abc", "", "de"));
+  EXPECT_EQ(res.characters().size(), 5);
+}
+
+TEST(StringsBufferBuilder, ChunkedBuilderAddAll) {
+  auto buf = CreateBuffer<std::string>({"hello", "world", "", "abc"});
+  auto sliced = buf.Slice(1).DeepCopy();
+  ASSERT_NE(sliced.base_offset(), 0);
+  {
+    Buffer<std::string>::ChunkedBuilder bldr;
+    bldr.AddAll(sliced);
+    auto res = std::move(bldr).Build();
+    EXPECT_THAT(res, ElementsAre("world", "", "abc"));
+    // The characters are not copied.
+    EXPECT_EQ(res.characters().begin(), sliced.characters().begin());
+  }
+  {
+    Buffer<std::string>::ChunkedBuilder bldr;
+    bldr.Add("x");
+    bldr.AddAll(sliced);
+    bldr.Add("yz");
+    bldr.AddAll(buf);
+    EXPECT_THAT(std::move(bldr).Build(),
+                ElementsAre("x", "world", "", "abc", "yz", "hello", "world",
+                            "", "abc"));
+  }
+}
+
 }  // namespace
 }  // namespace arolla
@@ -37,6 +37,7 @@
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/proto/types.h"
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
@@ -59,6 +60,7 @@ using ::arolla::GetDenseArrayQType;
 using ::arolla::GetOptionalQType;
 using ::arolla::GetQType;
 using ::arolla::OptionalValue;
+using ::arolla::RawBufferFactory;
 using ::arolla::QTypePtr;
 using ::arolla::Text;
 using ::arolla::TypedSlot;
@@ -329,7 +331,7 @@ class Traverser {
 // message after resolving all intermediate submessages.
 template <class T>
 struct OptionalReader {
-  void operator()(const Message& m, FramePtr frame) const {
+  void operator()(const Message& m, FramePtr frame, RawBufferFactory*) const {
     const Message* last_message = traverser.GetLastSubMessage(m);
     if (last_message == nullptr) {
       frame.Set(slot, {});
@@ -360,12 +362,14 @@ struct OptionalReaderFactory {
 // ::arolla::DenseArray<arolla_size_t>. Note that Traverser works
 // on std::vector behind the scenes, then converts to ::arolla::DenseArray.
 struct ArraySizeReader {
-  void operator()(const Message& m, FramePtr frame) const {
+  void operator()(const Message& m, FramePtr frame,
+                  RawBufferFactory* buffer_factory) const {
     std::vector<arolla_size_t> res;
     traverser.TraverseSubmessages(m, last_push_back_fn, &res);
+    ::arolla::Buffer<arolla_size_t>::Builder bldr(res.size(), buffer_factory);
+    std::copy(res.begin(), res.end(), bldr.GetMutableSpan().begin());
     frame.Set(slot,
-              ::arolla::DenseArray<arolla_size_t>{
-                  ::arolla::Buffer<arolla_size_t>::Create(std::move(res))});
+              ::arolla::DenseArray<arolla_size_t>{std::move(bldr).Build()});
   }
 
   Traverser traverser;
@@ -390,7 +394,7 @@ struct ArraySizeReaderFactory {
 // ShapeSizeReader for setting size of the last field into
 // ::arolla::DenseArrayShape.
 struct ShapeSizeReader {
-  void operator()(const Message& m, FramePtr frame) const {
+  void operator()(const Message& m, FramePtr frame, RawBufferFactory*) const {
     DenseArrayShape res;
     traverser.TraverseSubmessages(m, last_push_back_fn, &res);
     frame.Set(slot, res);
@@ -419,12 +423,13 @@ struct ShapeSizeReaderFactory {
 // on std::vector behind the scenes, then converts to ::arolla::DenseArray.
 template <class T>
 struct DenseArrayReader {
-  void operator()(const Message& m, FramePtr frame) const {
+  void operator()(const Message& m, FramePtr frame,
+                  RawBufferFactory* buffer_factory) const {
     std::vector<OptionalValue<T>> res;
     traverser.TraverseSubmessages(m, last_push_back_fn, &res);
     // CreateDenseArray since direct transfer of ownership from std::vector is
     // impossible with bool or arolla::Bytes.
-    frame.Set(slot, ::arolla::CreateDenseArray<T>(res));
+    frame.Set(slot, ::arolla::CreateDenseArray<T>(res, buffer_factory));
   }
 
   Traverser traverser;
@@ -445,6 +450,39 @@ struct DenseArrayReaderFactory {
   PushbackFn last_push_back_fn;
 };
 
+// Reader for a numeric repeated field of the root message. Copies the values
+// straight into the DenseArray buffer: all of them are present, so neither an
+// intermediate std::vector nor a bitmap is needed.
+template <class T, class ProtoGetFn>
+struct RepeatedFieldReader {
+  void operator()(const Message& m, FramePtr frame,
+                  RawBufferFactory* buffer_factory) const {
+    // NO_CDC: reflection based library
+    const auto* ref = m.GetReflection();
+    const auto values = getter.GetRepeated(ref, m, field);
+    typename ::arolla::Buffer<T>::Builder bldr(values.size(), buffer_factory);
+    std::copy(values.begin(), values.end(), bldr.GetMutableSpan().begin());
+    frame.Set(slot, ::arolla::DenseArray<T>{std::move(bldr).Build()});
+  }
+
+  const FieldDescriptor* field;
+  FrameLayout::Slot<::arolla::DenseArray<T>> slot;
+  ProtoGetFn getter;
+};
+
+// Factory for RepeatedFieldReader.
+template <class T, class ProtoGetFn>
+struct RepeatedFieldReaderFactory {
+  absl::StatusOr<ProtoTypeReader::BoundReadFn> operator()(
+      TypedSlot typed_slot) const {
+    ASSIGN_OR_RETURN(auto slot, typed_slot.ToSlot<::arolla::DenseArray<T>>());
+    return RepeatedFieldReader<T, ProtoGetFn>{field, slot, getter};
+  }
+
+  const FieldDescriptor* field;
+  ProtoGetFn getter;
+};
+
 // Call Callback with corresponding std::decay<T> and kProtoGetter* object
 // Callback must return absl::StatusOr<R>.
 template <class CallBackFn>
@@ -594,6 +632,14 @@ class DenseArrayReaderCallback {
     const FieldDescriptor* last_field = fields_.back();
     PushbackFn pb_fn;
     if (std::holds_alternative<RepeatedFieldAccess>(last_access_info)) {
+      if constexpr (std::is_arithmetic_v<ResultT>) {
+        if (fields_.size() == 1) {
+          return std::make_unique<ProtoTypeReader>(
+              GetQType<DenseArrayResultT>(),
+              RepeatedFieldReaderFactory<ResultT, ProtoFieldGetter>{
+                  last_field, last_field_getter});
+        }
+      }
       pb_fn = ManyPushBackFn<ResultT, ProtoFieldGetter>{last_field,
                                                         last_field_getter};
     } else if (std::holds_alternative<RepeatedFieldSizeAccess>(
@@ -27,6 +27,7 @@
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/proto/types.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/qtype.h"
@@ -50,7 +51,10 @@ using ProtoFieldAccessInfo =
 
 class ProtoTypeReader {
  public:
-  using BoundReadFn = std::function<void(const google::protobuf::Message&, FramePtr)>;
+  // Reads the field into the frame. DenseArrays are allocated using the
+  // provided buffer factory.
+  using BoundReadFn = std::function<void(const google::protobuf::Message&, FramePtr,
+                                         RawBufferFactory*)>;
 
   // Creates a reader reading to the OptionalValue.
   // Reader doesn't respect proto default values.
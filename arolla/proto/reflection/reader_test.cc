@@ -34,6 +34,7 @@
 #include "arolla/memory/frame.h"
 #include "arolla/memory/memory_allocation.h"
 #include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/proto/test.pb.h"
 #include "arolla/proto/types.h"
 #include "arolla/qtype/qtype_traits.h"
@@ -84,7 +85,7 @@ absl::StatusOr<T> ReadValue(const ProtoTypeReader& reader,
   FramePtr frame = alloc.frame();
   frame.Set(slot, garbage);
 
-  read_fn(m, frame);
+  read_fn(m, frame, GetHeapBufferFactory());
   return frame.Get(slot);
 }
 
@@ -425,6 +426,43 @@ TEST(ProtoTypeReader, CreateRepeatedAccessOptionalReader) {
       IsOkAndHolds(ElementsAre(ProtoRoot::SECOND_VALUE, ProtoRoot::DEFAULT)));
 }
 
+TEST(ProtoTypeReader, RepeatedAccessReaderUsesBufferFactory) {
+  ::testing_namespace::Root m;
+  m.add_repeated_floats(19.0f);
+  m.add_repeated_floats(17.0f);
+  m.add_inners()->add_as(57);
+  m.add_inners()->add_as(3);
+
+  FrameLayout::Builder layout_builder;
+  auto floats_slot = layout_builder.AddSlot<::arolla::DenseArray<float>>();
+  auto as_slot = layout_builder.AddSlot<::arolla::DenseArray<int32_t>>();
+  ASSERT_OK_AND_ASSIGN(auto floats_reader,
+                       ProtoTypeReader::CreateDenseArrayReader(
+                           BuildDescriptorSequence({"repeated_floats"}),
+                           {RepeatedFieldAccess{}}));
+  ASSERT_OK_AND_ASSIGN(auto read_floats, floats_reader->BindReadFn(
+                                             TypedSlot::FromSlot(floats_slot)));
+  ASSERT_OK_AND_ASSIGN(
+      auto as_reader,
+      ProtoTypeReader::CreateDenseArrayReader(
+          BuildDescriptorSequence({"inners", "as"}),
+          {RepeatedFieldAccess{}, RepeatedFieldAccess{}}));
+  ASSERT_OK_AND_ASSIGN(auto read_as,
+                       as_reader->BindReadFn(TypedSlot::FromSlot(as_slot)));
+  FrameLayout memory_layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&memory_layout);
+  FramePtr frame = alloc.frame();
+
+  UnsafeArenaBufferFactory arena(1024);
+  read_floats(m, frame, &arena);
+  read_as(m, frame, &arena);
+  EXPECT_THAT(frame.Get(floats_slot), ElementsAre(19.0f, 17.0f));
+  EXPECT_TRUE(frame.Get(floats_slot).bitmap.empty());
+  EXPECT_FALSE(frame.Get(floats_slot).values.is_owner());
+  EXPECT_THAT(frame.Get(as_slot), ElementsAre(57, 3));
+  EXPECT_FALSE(frame.Get(as_slot).values.is_owner());
+}
+
 absl::StatusOr<::arolla::DenseArray<proto::arolla_size_t>>
 ReadTopLevelSizeAsArray(const std::string& field_name,
                         const google::protobuf::Message& m) {
@@ -16,10 +16,13 @@
 #define AROLLA_QEXPR_AGGREGATION_OPS_INTERFACE_H_
 
 #include <cstdint>
+#include <type_traits>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "arolla/util/meta.h"
+#include "arolla/util/threading.h"  // IWYU pragma: export
 #include "arolla/util/view_types.h"
 
 namespace arolla {
@@ -160,6 +163,10 @@ struct Accumulator<TYPE, RESULT_T, meta::type_list<PARENT_Ts...>,
   virtual ~Accumulator() = default;
 };
 
+// Aggregators can optionally define a non-virtual Merge method that allows
+// group operations to run in parallel, see accumulator_has_merge and
+// GroupOpParallelism in util/threading.h.
+
 // Create an `Accumulator` using its `Create` method if it exists, and
 // otherwise using it's constructor. The Create method is presumed to return
 // StatusOr<T>. This helper exists so that Accumulators which validate their
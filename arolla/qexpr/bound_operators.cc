@@ -14,14 +14,74 @@
 //
 #include "arolla/qexpr/bound_operators.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
+#include "absl/log/check.h"
+#include "absl/types/span.h"
 #include "arolla/memory/frame.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/operators.h"
 
 namespace arolla {
+namespace {
+
+void RunVirtual(const void* op, EvaluationContext* ctx, FramePtr frame) {
+  static_cast<const BoundOperator*>(op)->Run(ctx, frame);
+}
+
+size_t AlignUp(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+PackedBoundOperators::PackedBoundOperators(
+    absl::Span<const std::unique_ptr<BoundOperator>> ops) {
+  std::vector<const PackableBoundOperator*> packable_ops(ops.size());
+  size_t states_size = 0;
+  for (size_t i = 0; i < ops.size(); ++i) {
+    const auto* op = dynamic_cast<const PackableBoundOperator*>(ops[i].get());
+    if (op == nullptr || op->PackedStateSize() == 0 ||
+        op->PackedStateAlignment() > alignof(std::max_align_t)) {
+      continue;
+    }
+    packable_ops[i] = op;
+    states_size = AlignUp(states_size, op->PackedStateAlignment()) +
+                  op->PackedStateSize();
+  }
+  states_ = std::make_unique<std::max_align_t[]>(
+      AlignUp(states_size, sizeof(std::max_align_t)) /
+      sizeof(std::max_align_t));
+  auto* states = reinterpret_cast<char*>(states_.get());
+  instructions_.reserve(ops.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < ops.size(); ++i) {
+    if (const auto* op = packable_ops[i]) {
+      offset = AlignUp(offset, op->PackedStateAlignment());
+      void* state = states + offset;
+      instructions_.push_back({op->PackTo(state), state});
+      offset += op->PackedStateSize();
+      ++packed_count_;
+    } else {
+      instructions_.push_back({&RunVirtual, ops[i].get()});
+    }
+  }
+  DCHECK_EQ(offset, states_size);
+}
+
+size_t PackedBoundOperators::HandleSignal(EvaluationContext* ctx,
+                                          size_t ip) const {
+  if (ctx->requested_jump() != 0) {
+    ip += ctx->requested_jump();
+    DCHECK_LT(ip, instructions_.size());
+  }
+  if (ctx->status().ok()) {
+    ctx->ResetSignals();
+  }
+  return ip;
+}
 
 std::unique_ptr<BoundOperator> JumpBoundOperator(int64_t jump) {
   return MakeBoundOperator([=](EvaluationContext* ctx, FramePtr frame) {
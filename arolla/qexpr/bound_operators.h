@@ -15,10 +15,13 @@
 #ifndef AROLLA_QEXPR_BOUND_OPERATORS_H_
 #define AROLLA_QEXPR_BOUND_OPERATORS_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/base/optimization.h"
 #include "absl/container/inlined_vector.h"
@@ -60,9 +63,36 @@ inline int64_t RunBoundOperators(
   return ip - 1;
 }
 
+// (internal) A bound operator that can copy its state into
+// PackedBoundOperators, to be run there without a virtual call.
+class PackableBoundOperator : public BoundOperator {
+ public:
+  // Runs the operator on the state copied by PackTo().
+  using PackedRunFn = void (*)(const void* state, EvaluationContext* ctx,
+                               FramePtr frame);
+
+  // Returns the size of the packed state, or 0 if the operator cannot be
+  // packed.
+  virtual size_t PackedStateSize() const = 0;
+
+  // Returns the alignment of the packed state.
+  virtual size_t PackedStateAlignment() const = 0;
+
+  // Copies the state into `dst` (of at least PackedStateSize() bytes and
+  // the PackedStateAlignment()) and returns the function to run it. The copy
+  // is never destroyed.
+  virtual PackedRunFn PackTo(void* dst) const = 0;
+};
+
 // Implementation of BoundOperator interface based on the provided functor.
 template <typename Functor>
-class FunctorBoundOperator final : public BoundOperator {
+class FunctorBoundOperator final : public PackableBoundOperator {
+  // The functors with trivial copying and destruction (e.g. lambdas capturing
+  // slots) can be copied as is into PackedBoundOperators.
+  static constexpr bool kIsPackable =
+      std::is_trivially_copy_constructible_v<Functor> &&
+      std::is_trivially_destructible_v<Functor>;
+
  public:
   explicit FunctorBoundOperator(Functor functor)
       : functor_(std::move(functor)) {}
@@ -73,6 +103,24 @@ class FunctorBoundOperator final : public BoundOperator {
     functor_(ctx, frame);
   }
 
+  size_t PackedStateSize() const final {
+    return kIsPackable ? sizeof(Functor) : 0;
+  }
+
+  size_t PackedStateAlignment() const final { return alignof(Functor); }
+
+  PackedRunFn PackTo(void* dst) const final {
+    if constexpr (kIsPackable) {
+      new (dst) Functor(functor_);
+      return [](const void* state, EvaluationContext* ctx, FramePtr frame) {
+        (*static_cast<const Functor*>(state))(ctx, frame);
+      };
+    } else {
+      DCHECK(false) << "the functor cannot be packed";
+      return nullptr;
+    }
+  }
+
  public:
   Functor functor_;
 };
@@ -91,6 +139,64 @@ std::unique_ptr<BoundOperator> MakeBoundOperator(Functor functor) {
       new FunctorBoundOperator<Functor>(std::move(functor)));
 }
 
+// A sequence of bound operators prepared for repeated evaluation.
+//
+// The states of the packable operators (see PackableBoundOperator) are copied
+// into a contiguous buffer, and the operators are called directly via
+// function pointers stored next to their states. This avoids the virtual
+// dispatch and improves memory locality for long sequences of small
+// operators. Other operators are called through BoundOperator::Run().
+//
+// Run() has the same semantics as RunBoundOperators(). `ops` must outlive the
+// object.
+class PackedBoundOperators {
+ public:
+  PackedBoundOperators() = default;
+  explicit PackedBoundOperators(
+      absl::Span<const std::unique_ptr<BoundOperator>> ops);
+
+  PackedBoundOperators(PackedBoundOperators&&) = default;
+  PackedBoundOperators& operator=(PackedBoundOperators&&) = default;
+
+  // Runs the operators. Returns the index of the operator at which the
+  // execution stops (see RunBoundOperators).
+  int64_t Run(EvaluationContext* ctx, FramePtr frame) const {
+    DCHECK_OK(ctx->status());
+    DCHECK_EQ(ctx->requested_jump(), 0);
+    DCHECK(!ctx->signal_received());
+    const Instruction* instructions = instructions_.data();
+    const size_t size = instructions_.size();
+    for (size_t ip = 0; ip < size; ++ip) {
+      instructions[ip].run(instructions[ip].state, ctx, frame);
+      if (ABSL_PREDICT_FALSE(ctx->signal_received())) {
+        ip = HandleSignal(ctx, ip);
+        if (ctx->signal_received()) {
+          return ip;
+        }
+      }
+    }
+    return static_cast<int64_t>(size) - 1;
+  }
+
+  // Returns the number of the operators called without the virtual dispatch.
+  size_t packed_count() const { return packed_count_; }
+
+ private:
+  struct Instruction {
+    PackableBoundOperator::PackedRunFn run;
+    const void* state;
+  };
+
+  // Handles a jump or an error signalled by the operator at `ip`, and returns
+  // the updated `ip`. Resets the signals unless the execution must stop.
+  ABSL_ATTRIBUTE_NOINLINE size_t HandleSignal(EvaluationContext* ctx,
+                                              size_t ip) const;
+
+  std::vector<Instruction> instructions_;
+  std::unique_ptr<std::max_align_t[]> states_;
+  size_t packed_count_ = 0;
+};
+
 // Bound operator that resets a target value to its initial state.
 class ResetBoundOperator : public BoundOperator {
  public:
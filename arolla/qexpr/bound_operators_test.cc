@@ -171,6 +171,83 @@ TEST(BoundOperators, RunBoundOperators_WithJump) {
   EXPECT_THAT(ctx.status(), IsOk());
 }
 
+TEST(BoundOperators, PackedBoundOperators) {
+  FrameLayout::Builder layout_builder;
+  Slot<int32_t> x_slot = layout_builder.AddSlot<int32_t>();
+  Slot<float> y_slot = layout_builder.AddSlot<float>();
+  Slot<OptionalValue<float>> z_slot =
+      layout_builder.AddSlot<OptionalValue<float>>();
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  alloc.frame().Set(y_slot, 2.0f);
+
+  auto make_increment_operator = [x_slot](int32_t increment) {
+    return MakeBoundOperator(
+        [x_slot, increment](EvaluationContext* ctx, FramePtr frame) {
+          frame.Set(x_slot, frame.Get(x_slot) + increment);
+        });
+  };
+
+  std::vector<std::unique_ptr<BoundOperator>> bound_operators;
+  bound_operators.push_back(make_increment_operator(1));
+  // A non-packable operator.
+  ASSERT_OK_AND_ASSIGN(
+      bound_operators.emplace_back(),
+      CreateAddFloatsBoundOp(
+          {TypedSlot::FromSlot(y_slot), TypedSlot::FromSlot(y_slot)}, z_slot));
+  bound_operators.push_back(JumpBoundOperator(1));
+  bound_operators.push_back(make_increment_operator(10));
+  bound_operators.push_back(make_increment_operator(100));
+
+  PackedBoundOperators packed_operators(bound_operators);
+  EXPECT_EQ(packed_operators.packed_count(), 4);
+  // Packed operators do not depend on the original ones.
+  bound_operators[0] = make_increment_operator(1000);
+
+  for (int i = 1; i <= 2; ++i) {
+    EvaluationContext ctx;
+    EXPECT_EQ(packed_operators.Run(&ctx, alloc.frame()), 4);
+    EXPECT_THAT(alloc.frame().Get(x_slot), Eq(101 * i));
+    EXPECT_THAT(alloc.frame().Get(z_slot), Eq(4.0f));
+    EXPECT_THAT(ctx.status(), IsOk());
+  }
+  {
+    EvaluationContext ctx;
+    EXPECT_EQ(PackedBoundOperators().Run(&ctx, alloc.frame()), -1);
+  }
+}
+
+TEST(BoundOperators, PackedBoundOperators_WithError) {
+  FrameLayout::Builder layout_builder;
+  Slot<int32_t> x_slot = layout_builder.AddSlot<int32_t>();
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+
+  auto make_increment_operator = [x_slot](int32_t increment) {
+    return MakeBoundOperator(
+        [x_slot, increment](EvaluationContext* ctx, FramePtr frame) {
+          frame.Set(x_slot, frame.Get(x_slot) + increment);
+        });
+  };
+
+  std::vector<std::unique_ptr<BoundOperator>> bound_operators;
+  bound_operators.push_back(make_increment_operator(1));
+  bound_operators.push_back(JumpBoundOperator(1));
+  bound_operators.push_back(make_increment_operator(10));
+  bound_operators.push_back(
+      MakeBoundOperator([](EvaluationContext* ctx, FramePtr frame) {
+        ctx->set_status(absl::InvalidArgumentError("foo"));
+      }));
+  bound_operators.push_back(make_increment_operator(100));
+
+  PackedBoundOperators packed_operators(bound_operators);
+  EvaluationContext ctx;
+  EXPECT_EQ(packed_operators.Run(&ctx, alloc.frame()), 3);
+  EXPECT_THAT(alloc.frame().Get(x_slot), Eq(1));
+  EXPECT_THAT(ctx.status(),
+              StatusIs(absl::StatusCode::kInvalidArgument, "foo"));
+}
+
 // Exercise WhereAllBoundOperator by adding mixture of optional and
 // non-optional floats.
 TEST(BoundOperators, WhereAll) {
@@ -19,11 +19,14 @@
 #include <type_traits>
 #include <utility>
 
+#include "absl/base/optimization.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/memory_allocation.h"
 #include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/util/cancellation_context.h"
+#include "arolla/util/row_errors.h"
 
 namespace arolla {
 
@@ -133,11 +136,29 @@ class RootEvaluationContext {
   ConstFramePtr frame() const { return alloc_.frame(); }
   RawBufferFactory& buffer_factory() const { return *buffer_factory_; }
 
+  // Token to stop long evaluations in the contexts created from this one (see
+  // EvaluationContext::CheckCancellation), nullptr if not set. Must remain
+  // valid for the lifetime of this RootEvaluationContext.
+  CancellationContext* cancellation_context() const {
+    return cancellation_context_;
+  }
+  void set_cancellation_context(CancellationContext* cancellation_context) {
+    cancellation_context_ = cancellation_context;
+  }
+
+  // If set, the pointwise array operators record the failed rows there instead
+  // of failing (see EvaluationContext::row_errors). Must remain valid for the
+  // lifetime of this RootEvaluationContext.
+  RowErrors* row_errors() const { return row_errors_; }
+  void set_row_errors(RowErrors* row_errors) { row_errors_ = row_errors; }
+
   bool IsValid() const { return alloc_.IsValid(); }
 
  private:
   MemoryAllocation alloc_;
-  RawBufferFactory* buffer_factory_ = nullptr;  // Not owned.
+  RawBufferFactory* buffer_factory_ = nullptr;           // Not owned.
+  CancellationContext* cancellation_context_ = nullptr;  // Not owned.
+  RowErrors* row_errors_ = nullptr;                      // Not owned.
 };
 
 // EvaluationContext contains all the data QExpr operator may need in runtime.
@@ -145,9 +166,27 @@ class EvaluationContext {
  public:
   EvaluationContext() = default;
   explicit EvaluationContext(RootEvaluationContext& root_ctx)
-      : buffer_factory_(root_ctx.buffer_factory()) {}
-  explicit EvaluationContext(RawBufferFactory* buffer_factory)
-      : buffer_factory_(*buffer_factory) {
+      : buffer_factory_(root_ctx.buffer_factory()),
+        cancellation_context_(root_ctx.cancellation_context()),
+        row_errors_(root_ctx.row_errors()) {}
+  // `cancellation_context`, if not null, must remain valid for the lifetime
+  // of this EvaluationContext.
+  explicit EvaluationContext(
+      RawBufferFactory* buffer_factory,
+      CancellationContext* cancellation_context = nullptr)
+      : buffer_factory_(*buffer_factory),
+        cancellation_context_(cancellation_context) {
+    DCHECK(buffer_factory);
+  }
+  // Creates a context to evaluate a part of the program on behalf of `parent`,
+  // e.g. with another buffer factory or in another thread. Shares the
+  // cancellation context and the row errors of `parent`. The signals are not
+  // forwarded to `parent` automatically.
+  EvaluationContext(const EvaluationContext& parent,
+                    RawBufferFactory* buffer_factory)
+      : buffer_factory_(*buffer_factory),
+        cancellation_context_(parent.cancellation_context()),
+        row_errors_(parent.row_errors()) {
     DCHECK(buffer_factory);
   }
 
@@ -211,6 +250,32 @@ class EvaluationContext {
 
   RawBufferFactory& buffer_factory() { return buffer_factory_; }
 
+  // Token for the cooperative cancellation, nullptr if not set.
+  CancellationContext* cancellation_context() const {
+    return cancellation_context_;
+  }
+
+  // Returns true if the evaluation is cancelled or its deadline has passed; in
+  // this case also sets the corresponding error status. Long running
+  // operators (e.g. loops) should call it between the iterations and stop if
+  // it returns true. Cheap enough to be called on every iteration.
+  bool CheckCancellation() {
+    if (ABSL_PREDICT_TRUE(cancellation_context_ == nullptr) ||
+        ABSL_PREDICT_TRUE(!cancellation_context_->SoftCheck())) {
+      return false;
+    }
+    set_status(cancellation_context_->GetStatus());
+    return true;
+  }
+
+  // Row level error isolation, nullptr if disabled. If set, the lifted
+  // pointwise DenseArray operators returning absl::StatusOr mark the failed
+  // rows as missing in their outputs and record them here instead of failing
+  // the evaluation. Must remain valid for the lifetime of this
+  // EvaluationContext.
+  RowErrors* row_errors() const { return row_errors_; }
+  void set_row_errors(RowErrors* row_errors) { row_errors_ = row_errors; }
+
   // requested_jump tells the evaluation engine to jump by the given (positive
   // or negative) number of operators. One must take into account that the
   // instruction pointer is shifted by 1 after every instruction, so e.g. to
@@ -239,6 +304,8 @@ class EvaluationContext {
   int64_t jump_ = 0;
   absl::Status status_;
   RawBufferFactory& buffer_factory_ = *GetHeapBufferFactory();  // Not owned.
+  CancellationContext* cancellation_context_ = nullptr;         // Not owned.
+  RowErrors* row_errors_ = nullptr;                             // Not owned.
 };
 
 }  // namespace arolla
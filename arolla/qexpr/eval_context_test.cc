@@ -24,7 +24,10 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qtype/base_types.h"
+#include "arolla/util/cancellation_context.h"
+#include "arolla/util/row_errors.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -221,6 +224,41 @@ TEST(EvalContextTest, Jump) {
   EXPECT_THAT(ctx.requested_jump(), Eq(0));
 }
 
+TEST(EvalContextTest, CheckCancellation) {
+  EvaluationContext ctx_without_cancellation;
+  EXPECT_THAT(ctx_without_cancellation.CheckCancellation(), IsFalse());
+
+  CancellationContext cancellation_context;
+  FrameLayout layout = FrameLayout::Builder().Build();
+  RootEvaluationContext root_ctx(&layout);
+  root_ctx.set_cancellation_context(&cancellation_context);
+  EvaluationContext ctx(root_ctx);
+  EXPECT_THAT(ctx.cancellation_context(), Eq(&cancellation_context));
+  EXPECT_THAT(ctx.CheckCancellation(), IsFalse());
+  EXPECT_THAT(ctx.signal_received(), IsFalse());
+
+  cancellation_context.Cancel();
+  EXPECT_THAT(ctx.CheckCancellation(), IsTrue());
+  EXPECT_THAT(ctx.signal_received(), IsTrue());
+  EXPECT_THAT(ctx.status(), StatusIs(absl::StatusCode::kCancelled));
+}
+
+TEST(EvalContextTest, DerivedContext) {
+  CancellationContext cancellation_context;
+  RowErrors row_errors;
+  EvaluationContext parent(GetHeapBufferFactory(), &cancellation_context);
+  parent.set_row_errors(&row_errors);
+  UnsafeArenaBufferFactory arena(1024);
+  EvaluationContext ctx(parent, &arena);
+  EXPECT_THAT(&ctx.buffer_factory(), Eq(&arena));
+  EXPECT_THAT(ctx.cancellation_context(), Eq(&cancellation_context));
+  EXPECT_THAT(ctx.row_errors(), Eq(&row_errors));
+
+  ctx.set_status(absl::InvalidArgumentError("error"));
+  EXPECT_THAT(parent.signal_received(), IsFalse());
+  EXPECT_THAT(parent.status(), IsOk());
+}
+
 #ifndef NDEBUG
 // Evaluation context performs runtime type checks in debug builds only.
 TEST(EvalContextDeathTest, TypeMismatch) {
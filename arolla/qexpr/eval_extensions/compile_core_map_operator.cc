@@ -12,13 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
@@ -31,6 +34,7 @@
 #include "arolla/expr/eval/extensions.h"
 #include "arolla/expr/expr_operator.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/eval_extensions/prepare_core_map_operator.h"
 #include "arolla/qexpr/evaluation_engine.h"
@@ -42,7 +46,10 @@
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/util/cost_model.h"
 #include "arolla/util/init_arolla.h"
+#include "arolla/util/row_errors.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/unit.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -60,7 +67,9 @@ class MapBoundOperator : public BoundOperator {
                    std::vector<TypedSlot>&& mapper_input_slots,
                    std::vector<FrameLayout::Slot<bool>>&& presence_slots,
                    std::vector<int>&& broadcast_arg_ids,
-                   TypedSlot scalar_out_slot, TypedSlot mapper_output_slot)
+                   TypedSlot scalar_out_slot, TypedSlot mapper_output_slot,
+                   ThreadingInterface* threading, int64_t min_parallel_rows,
+                   int64_t frame_buffer_count)
       : mapper_bound_expr_(std::move(mapper_bound_expr)),
         input_slots_(input_slots.begin(), input_slots.end()),
         output_slot_(output_slot),
@@ -70,7 +79,10 @@ class MapBoundOperator : public BoundOperator {
         presence_slots_(std::move(presence_slots)),
         broadcast_arg_ids_(std::move(broadcast_arg_ids)),
         scalar_out_slot_(scalar_out_slot),
-        mapper_output_slot_(mapper_output_slot) {}
+        mapper_output_slot_(mapper_output_slot),
+        threading_(threading),
+        min_parallel_rows_(min_parallel_rows),
+        frame_buffer_count_(frame_buffer_count) {}
 
   void Run(EvaluationContext* ctx, FramePtr frame) const override {
     // Construct FrameIterator.
@@ -86,10 +98,21 @@ class MapBoundOperator : public BoundOperator {
       }
     }
 
+    // The worker threads allocate using the heap buffer factory, so with any
+    // other one (e.g. a non thread-safe arena) the rows are evaluated in the
+    // calling thread.
+    const int thread_count =
+        threading_ != nullptr &&
+                &ctx->buffer_factory() == GetHeapBufferFactory()
+            ? std::max(threading_->GetRecommendedThreadCount(), 1)
+            : 1;
     auto frame_iterator_or = FrameIterator::Create(
         input_arrays, optional_scalar_input_slots_, {output_slot_},
         {scalar_out_slot_}, &scalar_layout_,
-        FrameIterator::Options{.buffer_factory = &ctx->buffer_factory()});
+        FrameIterator::Options{
+            .frame_buffer_count = frame_buffer_count_ * thread_count,
+            .buffer_factory = &ctx->buffer_factory(),
+            .cancellation_context = ctx->cancellation_context()});
     if (!frame_iterator_or.ok()) {
       ctx->set_status(std::move(frame_iterator_or).status());
       return;
@@ -107,16 +130,11 @@ class MapBoundOperator : public BoundOperator {
       }
     });
 
-    // Evaluate the operator.
+    std::optional<FrameLayout::Slot<bool>> presence_out_slot;
     if (presence_slots_.empty()) {
       DCHECK_EQ(scalar_out_slot_, mapper_output_slot_);
       // Here we don't care about presence bit because either scalar_out_slot_
       // is not optional, or the presence bit is set by the op itself.
-      frame_iterator.ForEachFrame([&](FramePtr scalar_frame) {
-        if (ctx->status().ok()) {
-          mapper_bound_expr_->Execute(ctx, scalar_frame);
-        }
-      });
     } else {
       // TODO: This branch is not needed with the current
       // implementation of Expr-level operator. We need to either remove the
@@ -127,19 +145,61 @@ class MapBoundOperator : public BoundOperator {
         ctx->set_status(std::move(presence_out_slot_or).status());
         return;
       }
-      FrameLayout::Slot<bool>& presence_out_slot = *presence_out_slot_or;
-      frame_iterator.ForEachFrame([&](FramePtr scalar_frame) {
+      presence_out_slot = *presence_out_slot_or;
+    }
+    auto eval_row = [&](EvaluationContext* row_ctx, FramePtr scalar_frame) {
+      if (presence_out_slot.has_value()) {
         bool valid_args = true;
         for (auto slot : presence_slots_) {
           valid_args = valid_args && scalar_frame.Get(slot);
         }
-        scalar_frame.Set(presence_out_slot, valid_args);
-        if (valid_args && ctx->status().ok()) {
-          mapper_bound_expr_->Execute(ctx, scalar_frame);
+        scalar_frame.Set(*presence_out_slot, valid_args);
+        if (!valid_args) {
+          return;
         }
-      });
+      }
+      if (row_ctx->status().ok()) {
+        mapper_bound_expr_->Execute(row_ctx, scalar_frame);
+      }
+    };
+
+    // Evaluate the operator.
+    if (thread_count > 1 && frame_iterator.row_count() >= min_parallel_rows_) {
+      std::vector<std::unique_ptr<EvaluationContext>> worker_ctxs;
+      worker_ctxs.reserve(thread_count);
+      for (int i = 0; i < thread_count; ++i) {
+        worker_ctxs.push_back(
+            std::make_unique<EvaluationContext>(*ctx, &ctx->buffer_factory()));
+      }
+      // RowErrors is not thread-safe, so each worker records the failed rows
+      // separately, and they are merged after the evaluation.
+      std::vector<std::unique_ptr<RowErrors>> worker_row_errors;
+      if (ctx->row_errors() != nullptr) {
+        worker_row_errors.reserve(thread_count);
+        for (int i = 0; i < thread_count; ++i) {
+          worker_row_errors.push_back(
+              std::make_unique<RowErrors>(ctx->row_errors()->max_statuses()));
+          worker_ctxs[i]->set_row_errors(worker_row_errors.back().get());
+        }
+      }
+      frame_iterator.ForEachFrame(
+          [&](FramePtr scalar_frame, int worker_id) {
+            eval_row(worker_ctxs[worker_id].get(), scalar_frame);
+          },
+          *threading_, thread_count);
+      for (int i = 0; i < thread_count && ctx->status().ok(); ++i) {
+        ctx->set_status(std::move(*worker_ctxs[i]).status());
+      }
+      for (const auto& row_errors : worker_row_errors) {
+        ctx->row_errors()->Merge(*row_errors);
+      }
+    } else {
+      frame_iterator.ForEachFrame(
+          [&](FramePtr scalar_frame) { eval_row(ctx, scalar_frame); });
     }
-    if (ctx->status().ok()) {
+    // FrameIterator stops early on cancellation, leaving the output
+    // incomplete.
+    if (ctx->status().ok() && !ctx->CheckCancellation()) {
       ctx->set_status(frame_iterator.StoreOutput(frame));
     }
   }
@@ -176,6 +236,13 @@ class MapBoundOperator : public BoundOperator {
 
   // Scalar output slot of the op operator.
   TypedSlot mapper_output_slot_;
+
+  // Optional threading to evaluate the rows of big arrays concurrently. Not
+  // owned.
+  ThreadingInterface* threading_;
+  int64_t min_parallel_rows_;
+  // The number of frames processed at once by a single thread.
+  int64_t frame_buffer_count_;
 };
 
 // expr/eval extension to bind PackedCoreMapOperator
@@ -187,6 +254,16 @@ std::optional<absl::Status> CompilePackedCoreMapOperator(
   if (map_op == nullptr) {
     return std::nullopt;
   }
+  if (const auto& array_mapper = map_op->array_mapper();
+      array_mapper.has_value() &&
+      absl::c_equal(array_mapper->input_qtypes(), args.input_slots,
+                    [](QTypePtr qtype, TypedSlot slot) {
+                      return qtype == slot.GetType();
+                    }) &&
+      array_mapper->output_qtype() == args.output_slot.GetType()) {
+    return array_mapper->BindTo(*args.executable_builder, args.input_slots,
+                                args.output_slot);
+  }
   const auto& mapper = map_op->mapper();
 
   if (mapper.input_qtypes().size() != args.input_slots.size()) {
@@ -279,7 +356,12 @@ std::optional<absl::Status> CompilePackedCoreMapOperator(
           std::move(scalar_layout_builder).Build(),
           std::move(optional_scalar_input_slots), std::move(mapper_input_slots),
           std::move(presence_slots), std::move(broadcast_arg_ids),
-          scalar_out_slot, mapper_output_slot),
+          scalar_out_slot, mapper_output_slot,
+          args.options.core_map_threading,
+          args.options.min_parallel_core_map_rows,
+          args.options.cost_model != nullptr
+              ? args.options.cost_model->frame_buffer_count
+              : CostModel().frame_buffer_count),
       op_description,
       /*display_name=*/"core.map");
 
@@ -16,13 +16,19 @@
 // py/arolla/operator_tests/core_map_test.py
 
 #include <cstdint>
+#include <optional>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "arolla/array/qtype/types.h"
+#include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/expr/annotation_expr_operators.h"
 #include "arolla/expr/eval/eval.h"
+#include "arolla/expr/eval/invoke.h"
 #include "arolla/expr/eval/prepare_expression.h"
 #include "arolla/expr/eval/test_utils.h"
 #include "arolla/expr/expr.h"
@@ -32,22 +38,33 @@
 #include "arolla/expr/registered_expr_operator.h"
 #include "arolla/expr/testing/testing.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/eval_extensions/prepare_core_map_operator.h"
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/testing/qtype.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/util/cancellation_context.h"
 #include "arolla/util/init_arolla.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr::eval_internal {
 namespace {
 
 using ::arolla::testing::EqualsExpr;
 using ::arolla::testing::IsOkAndHolds;
+using ::arolla::testing::StatusIs;
+using ::arolla::testing::TypedValueWith;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::Eq;
 using ::testing::NotNull;
+using ::testing::SizeIs;
 
 class MapOperatorTest : public ::testing::Test {
  protected:
@@ -101,7 +118,9 @@ TEST_F(MapOperatorTest, CompilePackedCoreMapOperator) {
   FrameLayout::Builder layout_builder;
   auto xs_slot = AddSlot(ai32, &layout_builder);
   auto y_slot = AddSlot(GetQType<int32_t>(), &layout_builder);
-  DynamicEvaluationEngineOptions options{.collect_op_descriptions = true};
+  DynamicEvaluationEngineOptions options{
+      .collect_op_descriptions = true,
+      .enable_array_lifted_pointwise_core_map = false};
   EXPECT_THAT(
       CompileAndBindForDynamicEvaluation(options, &layout_builder, expr,
                                          {{"xs", xs_slot}, {"y", y_slot}}),
@@ -121,5 +140,241 @@ TEST_F(MapOperatorTest, CompilePackedCoreMapOperator) {
               "}(DENSE_ARRAY_INT32 [0x00], INT32 [0x48])"))));
 }
 
+TEST_F(MapOperatorTest, ArrayLiftedCoreMap) {
+  ASSERT_OK_AND_ASSIGN(
+      ExprOperatorPtr x_plus_y_mul_2,
+      MakeLambdaOperator(
+          "x_plus_y_mul_2", ExprOperatorSignature::Make("x, y"),
+          CallOp("math.multiply",
+                 {CallOp("math.add", {Placeholder("x"), Placeholder("y")}),
+                  Literal(int32_t{2})})));
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("core.map", {Literal(x_plus_y_mul_2),
+                                                      Leaf("xs"), Leaf("y")}));
+  QTypePtr ai32 = GetDenseArrayQType<int32_t>();
+  {
+    ASSERT_OK_AND_ASSIGN(
+        auto prepared_expr,
+        PrepareExpression(expr, {{"xs", ai32}, {"y", GetQType<int32_t>()}},
+                          DynamicEvaluationEngineOptions{
+                              .enable_array_lifted_pointwise_core_map =
+                                  false}));
+    auto packed_op =
+        dynamic_cast<const PackedCoreMapOperator*>(prepared_expr->op().get());
+    ASSERT_THAT(packed_op, NotNull());
+    EXPECT_THAT(packed_op->array_mapper(), Eq(std::nullopt));
+  }
+  DynamicEvaluationEngineOptions options{
+      .enable_array_lifted_core_map = true,
+      .enable_array_lifted_pointwise_core_map = false};
+  ASSERT_OK_AND_ASSIGN(
+      auto prepared_expr,
+      PrepareExpression(expr, {{"xs", ai32}, {"y", GetQType<int32_t>()}},
+                        options));
+  auto packed_op =
+      dynamic_cast<const PackedCoreMapOperator*>(prepared_expr->op().get());
+  ASSERT_THAT(packed_op, NotNull());
+  ASSERT_TRUE(packed_op->array_mapper().has_value());
+  EXPECT_THAT(packed_op->array_mapper()->input_qtypes(),
+              ElementsAre(ai32, GetQType<int32_t>()));
+  EXPECT_THAT(packed_op->array_mapper()->output_qtype(), Eq(ai32));
+
+  auto xs = CreateDenseArray<int32_t>({1, std::nullopt, 3});
+  EXPECT_THAT(Invoke(expr,
+                     {{"xs", TypedValue::FromValue(xs)},
+                      {"y", TypedValue::FromValue(int32_t{5})}},
+                     options),
+              IsOkAndHolds(TypedValueWith<DenseArray<int32_t>>(
+                  ElementsAre(12, std::nullopt, 16))));
+}
+
+TEST_F(MapOperatorTest, ParallelCoreMap) {
+  ASSERT_OK_AND_ASSIGN(
+      ExprOperatorPtr x_plus_y_mul_2,
+      MakeLambdaOperator(
+          "x_plus_y_mul_2", ExprOperatorSignature::Make("x, y"),
+          CallOp("math.multiply",
+                 {CallOp("math.add", {Placeholder("x"), Placeholder("y")}),
+                  Literal(int32_t{2})})));
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("core.map", {Literal(x_plus_y_mul_2),
+                                                      Leaf("xs"), Leaf("y")}));
+  std::vector<OptionalValue<int32_t>> xs_values(10000);
+  std::vector<OptionalValue<int32_t>> expected_values(xs_values.size());
+  for (int32_t i = 0; i < xs_values.size(); ++i) {
+    if (i % 7 != 0) {
+      xs_values[i] = i;
+      expected_values[i] = (i + 5) * 2;
+    }
+  }
+  auto xs = CreateDenseArray<int32_t>(xs_values);
+  StdThreading threading(4);
+  for (int64_t min_parallel_rows : {int64_t{1}, int64_t{1} << 20}) {
+    DynamicEvaluationEngineOptions options{
+        .enable_array_lifted_pointwise_core_map = false,
+        .core_map_threading = &threading,
+        .min_parallel_core_map_rows = min_parallel_rows};
+    EXPECT_THAT(Invoke(expr,
+                       {{"xs", TypedValue::FromValue(xs)},
+                        {"y", TypedValue::FromValue(int32_t{5})}},
+                       options),
+                IsOkAndHolds(TypedValueWith<DenseArray<int32_t>>(
+                    ElementsAreArray(expected_values))));
+  }
+}
+
+TEST_F(MapOperatorTest, CancelCoreMap) {
+  ASSERT_OK_AND_ASSIGN(
+      ExprOperatorPtr x_plus_y,
+      MakeLambdaOperator(
+          "x_plus_y", ExprOperatorSignature::Make("x, y"),
+          CallOp("math.add", {Placeholder("x"), Placeholder("y")})));
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("core.map", {Literal(x_plus_y),
+                                                      Leaf("xs"), Leaf("y")}));
+  std::vector<OptionalValue<int32_t>> xs_values(10000, 1);
+  auto xs = CreateDenseArray<int32_t>(xs_values);
+  StdThreading threading(4);
+  for (int64_t min_parallel_rows : {int64_t{1}, int64_t{1} << 20}) {
+    DynamicEvaluationEngineOptions options{
+        .enable_array_lifted_pointwise_core_map = false,
+        .core_map_threading = &threading,
+        .min_parallel_core_map_rows = min_parallel_rows};
+    FrameLayout::Builder layout_builder;
+    auto xs_slot = layout_builder.AddSlot<DenseArray<int32_t>>();
+    auto y_slot = layout_builder.AddSlot<int32_t>();
+    ASSERT_OK_AND_ASSIGN(
+        auto bound_expr,
+        CompileAndBindForDynamicEvaluation(
+            options, &layout_builder, expr,
+            {{"xs", TypedSlot::FromSlot(xs_slot)},
+             {"y", TypedSlot::FromSlot(y_slot)}}));
+    FrameLayout layout = std::move(layout_builder).Build();
+    RootEvaluationContext ctx(&layout);
+    ASSERT_OK(bound_expr->InitializeLiterals(&ctx));
+    ctx.Set(xs_slot, xs);
+    ctx.Set(y_slot, 5);
+
+    CancellationContext cancelled;
+    cancelled.Cancel();
+    ctx.set_cancellation_context(&cancelled);
+    EXPECT_THAT(bound_expr->Execute(&ctx),
+                StatusIs(absl::StatusCode::kCancelled));
+
+    ctx.set_cancellation_context(nullptr);
+    ASSERT_OK(bound_expr->Execute(&ctx));
+  }
+}
+
+TEST_F(MapOperatorTest, PointwiseCoreMapIsArrayLiftedByDefault) {
+  QTypePtr ai32 = GetDenseArrayQType<int32_t>();
+  auto is_array_lifted =
+      [&](const ExprOperatorPtr& mapper,
+          const DynamicEvaluationEngineOptions& options)
+      -> absl::StatusOr<bool> {
+    ASSIGN_OR_RETURN(auto expr, CallOp("core.map", {Literal(mapper),
+                                                    Leaf("xs"), Leaf("y")}));
+    ASSIGN_OR_RETURN(
+        auto prepared_expr,
+        PrepareExpression(expr, {{"xs", ai32}, {"y", GetQType<int32_t>()}},
+                          options));
+    auto packed_op =
+        dynamic_cast<const PackedCoreMapOperator*>(prepared_expr->op().get());
+    if (packed_op == nullptr) {
+      return absl::InternalError("expected PackedCoreMapOperator");
+    }
+    return packed_op->array_mapper().has_value();
+  };
+
+  ASSERT_OK_AND_ASSIGN(
+      ExprOperatorPtr pointwise_op,
+      MakeLambdaOperator(
+          "pointwise_op", ExprOperatorSignature::Make("x, y"),
+          CallOp("math.maximum",
+                 {CallOp("math.add", {Placeholder("x"), Placeholder("y")}),
+                  Literal(int32_t{2})})));
+  EXPECT_THAT(is_array_lifted(pointwise_op, DynamicEvaluationEngineOptions{}),
+              IsOkAndHolds(true));
+  EXPECT_THAT(is_array_lifted(pointwise_op,
+                              DynamicEvaluationEngineOptions{
+                                  .enable_pointwise_fusion = true}),
+              IsOkAndHolds(false));
+
+  // math.floordiv is not in the list of the known pointwise operators.
+  ASSERT_OK_AND_ASSIGN(
+      ExprOperatorPtr unknown_op,
+      MakeLambdaOperator(
+          "unknown_op", ExprOperatorSignature::Make("x, y"),
+          CallOp("math.floordiv", {Placeholder("x"), Placeholder("y")})));
+  EXPECT_THAT(is_array_lifted(unknown_op, DynamicEvaluationEngineOptions{}),
+              IsOkAndHolds(false));
+
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("core.map", {Literal(pointwise_op),
+                                                      Leaf("xs"), Leaf("y")}));
+  auto xs = CreateDenseArray<int32_t>({1, std::nullopt, -7});
+  EXPECT_THAT(Invoke(expr, {{"xs", TypedValue::FromValue(xs)},
+                            {"y", TypedValue::FromValue(int32_t{3})}}),
+              IsOkAndHolds(TypedValueWith<DenseArray<int32_t>>(
+                  ElementsAre(4, std::nullopt, 2))));
+}
+
+TEST_F(MapOperatorTest, PointwiseFusion) {
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {CallOp("math.multiply", {Leaf("x"), Leaf("y")}),
+              CallOp("math.exp", {CallOp("math.neg", {Leaf("x")})})}));
+  QTypePtr af32 = GetDenseArrayQType<float>();
+  {
+    ASSERT_OK_AND_ASSIGN(
+        auto prepared_expr,
+        PrepareExpression(expr, {{"x", af32}, {"y", af32}},
+                          DynamicEvaluationEngineOptions{}));
+    EXPECT_THAT(
+        dynamic_cast<const PackedCoreMapOperator*>(prepared_expr->op().get()),
+        Eq(nullptr));
+  }
+  ASSERT_OK_AND_ASSIGN(auto prepared_expr,
+                       PrepareExpression(expr, {{"x", af32}, {"y", af32}},
+                                         DynamicEvaluationEngineOptions{
+                                             .enable_pointwise_fusion = true}));
+  EXPECT_THAT(prepared_expr->qtype(), Eq(af32));
+  auto packed_op =
+      dynamic_cast<const PackedCoreMapOperator*>(prepared_expr->op().get());
+  ASSERT_THAT(packed_op, NotNull());
+  EXPECT_THAT(packed_op->mapper().display_name(),
+              Eq("fused_pointwise[math.multiply, math.neg, math.exp, "
+                 "math.add]"));
+  EXPECT_THAT(packed_op->mapper().input_qtypes(),
+              ElementsAre(GetOptionalQType<float>(),
+                          GetOptionalQType<float>()));
+  EXPECT_THAT(
+      prepared_expr->node_deps(),
+      ElementsAre(EqualsExpr(CallOp(QTypeAnnotation::Make(),
+                                    {Leaf("x"), Literal(af32)})),
+                  EqualsExpr(CallOp(QTypeAnnotation::Make(),
+                                    {Leaf("y"), Literal(af32)}))));
+}
+
+TEST_F(MapOperatorTest, PointwiseFusionKeepsSharedIntermediates) {
+  QTypePtr af32 = GetDenseArrayQType<float>();
+  ASSERT_OK_AND_ASSIGN(auto x_plus_y,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.maximum",
+             {CallOp("math.exp", {x_plus_y}), CallOp("math.neg", {x_plus_y})}));
+  ASSERT_OK_AND_ASSIGN(auto prepared_expr,
+                       PrepareExpression(expr, {{"x", af32}, {"y", af32}},
+                                         DynamicEvaluationEngineOptions{
+                                             .enable_pointwise_fusion = true}));
+  auto packed_op =
+      dynamic_cast<const PackedCoreMapOperator*>(prepared_expr->op().get());
+  ASSERT_THAT(packed_op, NotNull());
+  EXPECT_THAT(packed_op->mapper().display_name(),
+              Eq("fused_pointwise[math.exp, math.neg, math.maximum]"));
+  // x + y is used twice, so it is evaluated separately.
+  ASSERT_THAT(prepared_expr->node_deps(), SizeIs(1));
+  EXPECT_THAT(prepared_expr->node_deps()[0]->op()->display_name(),
+              Eq("math.add"));
+}
+
 }  // namespace
 }  // namespace arolla::expr::eval_internal
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,6 +29,7 @@
 #include "arolla/expr/eval/dynamic_compiled_operator.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/eval/extensions.h"
+#include "arolla/expr/eval/pointwise_fusion.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_attributes.h"
 #include "arolla/expr/expr_node.h"
@@ -96,10 +98,47 @@ absl::StatusOr<ExprNodePtr> MoveNonArrayLiteralArgumentsIntoOp(
   return WithNewDependencies(node, std::move(new_deps));
 }
 
+// Returns true if the array evaluation of core.map is allowed by the options.
+bool IsArrayLiftingEnabled(const DynamicEvaluationEngineOptions& options,
+                           const ExprOperatorPtr& mapper,
+                           absl::Span<const QTypePtr> mapper_input_qtypes) {
+  if (options.enable_array_lifted_core_map) {
+    return true;
+  }
+  // The core.map nodes created by the pointwise fusion must not be reverted.
+  if (!options.enable_array_lifted_pointwise_core_map ||
+      options.enable_pointwise_fusion) {
+    return false;
+  }
+  auto is_pointwise = IsPointwiseOperator(options, mapper, mapper_input_qtypes);
+  return is_pointwise.ok() && *is_pointwise;
+}
+
+// Precompiles the mapper for the array arguments of core.map if it is enabled
+// in the options and the result has the same type as core.map. Returns
+// std::nullopt otherwise, so core.map falls back to the row-wise evaluation.
+std::optional<DynamicCompiledOperator> MaybeBuildArrayMapper(
+    const DynamicEvaluationEngineOptions& options,
+    const ExprOperatorPtr& mapper,
+    absl::Span<const QTypePtr> mapper_input_qtypes,
+    std::vector<QTypePtr> dep_qtypes, QTypePtr output_qtype) {
+  if (!IsArrayLikeQType(output_qtype) ||
+      !IsArrayLiftingEnabled(options, mapper, mapper_input_qtypes)) {
+    return std::nullopt;
+  }
+  auto array_mapper =
+      DynamicCompiledOperator::Build(options, mapper, std::move(dep_qtypes));
+  if (!array_mapper.ok() || array_mapper->output_qtype() != output_qtype) {
+    return std::nullopt;
+  }
+  return *std::move(array_mapper);
+}
+
 }  // namespace
 
-PackedCoreMapOperator::PackedCoreMapOperator(DynamicCompiledOperator mapper,
-                                             ExprAttributes attr)
+PackedCoreMapOperator::PackedCoreMapOperator(
+    DynamicCompiledOperator mapper, ExprAttributes attr,
+    std::optional<DynamicCompiledOperator> array_mapper)
     : ExprOperatorWithFixedSignature(
           absl::StrFormat("packed_core_map[%s]", mapper.display_name()),
           ExprOperatorSignature{
@@ -110,9 +149,13 @@ PackedCoreMapOperator::PackedCoreMapOperator(DynamicCompiledOperator mapper,
           "Applies a QExpr operator pointwise to the *args.",
           FingerprintHasher(
               "::arolla::expr::eval_internal::PackedCoreMapOperator")
-              .Combine(mapper.fingerprint(), attr)
+              .Combine(mapper.fingerprint(), attr,
+                       array_mapper.has_value()
+                           ? array_mapper->fingerprint()
+                           : Fingerprint{})
               .Finish()),
       mapper_(std::move(mapper)),
+      array_mapper_(std::move(array_mapper)),
       attr_(std::move(attr)) {}
 
 absl::StatusOr<ExprAttributes> PackedCoreMapOperator::InferAttributes(
@@ -155,7 +198,9 @@ absl::StatusOr<ExprNodePtr> MapOperatorTransformation(
   ASSIGN_OR_RETURN(const ExprOperatorPtr& mapper,
                    evaluand_attr.qvalue()->As<ExprOperatorPtr>());
   std::vector<QTypePtr> mapper_input_qtypes;
+  std::vector<QTypePtr> dep_qtypes;
   mapper_input_qtypes.reserve(data_deps.size());
+  dep_qtypes.reserve(data_deps.size());
   for (const auto& d : data_deps) {
     if (d->qtype() == nullptr) {
       return absl::InternalError(
@@ -169,6 +214,7 @@ absl::StatusOr<ExprNodePtr> MapOperatorTransformation(
     // non-array deps are already embedded in
     // MoveNonArrayLiteralArgumentsIntoOp.
     mapper_input_qtypes.emplace_back(mapper_input_type);
+    dep_qtypes.emplace_back(d->qtype());
   }
 
   DynamicEvaluationEngineOptions mapper_options(options);
@@ -178,7 +224,9 @@ absl::StatusOr<ExprNodePtr> MapOperatorTransformation(
                    DynamicCompiledOperator::Build(mapper_options, mapper,
                                                   mapper_input_qtypes));
   ExprOperatorPtr prepared_map_op = std::make_shared<PackedCoreMapOperator>(
-      std::move(precompiled_mapper), node->attr());
+      std::move(precompiled_mapper), node->attr(),
+      MaybeBuildArrayMapper(mapper_options, mapper, mapper_input_qtypes,
+                            std::move(dep_qtypes), node->qtype()));
   return MakeOpNode(
       std::move(prepared_map_op),
       std::vector<ExprNodePtr>(data_deps.begin(), data_deps.end()));
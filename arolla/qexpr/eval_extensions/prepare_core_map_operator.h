@@ -15,6 +15,8 @@
 #ifndef AROLLA_QEXPR_EVAL_EXTENSIONS_PREPARE_CORE_MAP_OPERATOR_H_
 #define AROLLA_QEXPR_EVAL_EXTENSIONS_PREPARE_CORE_MAP_OPERATOR_H_
 
+#include <optional>
+
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "arolla/expr/basic_expr_operator.h"
@@ -25,20 +27,27 @@
 namespace arolla::expr::eval_internal {
 
 // Preprocessed version of core.map operator that holds precompiled "mapper"
-// operator inside.
+// operator inside. If `array_mapper` is set, it is the mapper precompiled for
+// the array arguments, and it is applied to the whole arrays instead of the
+// row-wise evaluation.
 class PackedCoreMapOperator final : public BuiltinExprOperatorTag,
                                     public ExprOperatorWithFixedSignature {
  public:
-  explicit PackedCoreMapOperator(DynamicCompiledOperator mapper,
-                                 ExprAttributes attr);
+  explicit PackedCoreMapOperator(
+      DynamicCompiledOperator mapper, ExprAttributes attr,
+      std::optional<DynamicCompiledOperator> array_mapper = std::nullopt);
 
   absl::StatusOr<ExprAttributes> InferAttributes(
       absl::Span<const ExprAttributes> inputs) const final;
 
   const DynamicCompiledOperator& mapper() const { return mapper_; }
+  const std::optional<DynamicCompiledOperator>& array_mapper() const {
+    return array_mapper_;
+  }
 
  private:
   DynamicCompiledOperator mapper_;
+  std::optional<DynamicCompiledOperator> array_mapper_;
   ExprAttributes attr_;
 };
 
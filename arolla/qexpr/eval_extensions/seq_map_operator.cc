@@ -178,15 +178,14 @@ std::optional<absl::Status> CompilePackedSeqMapOperator(
           }
           seq_size = seq.size();
         }
-        const size_t output_value_size =
-            mapper_output_slot.GetType()->type_layout().AllocSize();
-
         ASSIGN_OR_RETURN(
             auto mutable_sequence,
             MutableSequence::Make(mapper_output_slot.GetType(), *seq_size),
             ctx->set_status(std::move(_)));
 
-        for (size_t i = 0; i < seq_size && ctx->status().ok(); ++i) {
+        for (size_t i = 0;
+             i < seq_size && ctx->status().ok() && !ctx->CheckCancellation();
+             ++i) {
           for (size_t arg_id = 0; arg_id < input_slots.size(); ++arg_id) {
             const auto& cur_slot = input_slots[arg_id];
             const auto& seq = frame.Get(cur_slot.UnsafeToSlot<Sequence>());
@@ -195,9 +194,10 @@ std::optional<absl::Status> CompilePackedSeqMapOperator(
                 .IgnoreError();
           }
           mapper_bound_expr->Execute(ctx, frame);
-          mapper_output_slot.GetType()->UnsafeCopy(
-              frame.GetRawPointer(mapper_output_slot.byte_offset()),
-              mutable_sequence.RawAt(i, output_value_size));
+          // The mapper overwrites its output slot on every iteration, so we
+          // can move the value out instead of copying it.
+          mutable_sequence.UnsafeMoveFromRawPointer(
+              i, frame.GetRawPointer(mapper_output_slot.byte_offset()));
         }
         frame.Set(output_slot.UnsafeToSlot<Sequence>(),
                   std::move(mutable_sequence).Finish());
@@ -14,7 +14,9 @@
 //
 #include "arolla/qexpr/eval_extensions/seq_reduce_operator.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -27,6 +29,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
+#include "arolla/expr/associative_operators.h"
 #include "arolla/expr/basic_expr_operator.h"
 #include "arolla/expr/eval/dynamic_compiled_expr.h"
 #include "arolla/expr/eval/eval.h"
@@ -40,6 +43,8 @@
 #include "arolla/expr/registered_expr_operator.h"
 #include "arolla/expr/seq_reduce_expr_operator.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/bound_operators.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/evaluation_engine.h"
@@ -48,8 +53,10 @@
 #include "arolla/qtype/typed_value.h"
 #include "arolla/sequence/sequence.h"
 #include "arolla/sequence/sequence_qtype.h"
+#include "arolla/util/cancellation_context.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/init_arolla.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::expr::eval_internal {
@@ -89,6 +96,69 @@ absl::StatusOr<ExprNodePtr> SeqReduceOperatorTransformation(
       std::vector<ExprNodePtr>(node_deps.begin() + 1, node_deps.end()));
 }
 
+// The reducer compiled into a standalone frame layout, so the blocks of a
+// sequence can be reduced concurrently, each in its own frame. Used only for
+// the associative reducers with the same argument and output types.
+struct BlockReducer {
+  // Returns the reduction of the non-empty seq[begin:end], without the
+  // initial value.
+  absl::StatusOr<TypedValue> Reduce(
+      const Sequence& seq, size_t begin, size_t end,
+      CancellationContext* cancellation_context) const {
+    MemoryAllocation alloc(&layout);
+    FramePtr frame = alloc.frame();
+    EvaluationContext ctx(GetHeapBufferFactory(), cancellation_context);
+    bound_expr->InitializeLiterals(&ctx, frame);
+    const auto* value_qtype = seq.value_qtype();
+    const size_t value_size = value_qtype->type_layout().AllocSize();
+    void* output = frame.GetRawPointer(output_slot.byte_offset());
+    void* arg_1 = frame.GetRawPointer(arg_1_slot.byte_offset());
+    void* arg_2 = frame.GetRawPointer(arg_2_slot.byte_offset());
+    value_qtype->UnsafeCopy(seq.RawAt(begin, value_size), output);
+    for (size_t i = begin + 1;
+         i < end && ctx.status().ok() && !ctx.CheckCancellation(); ++i) {
+      value_qtype->UnsafeMove(output, arg_1);
+      value_qtype->UnsafeCopy(seq.RawAt(i, value_size), arg_2);
+      bound_expr->Execute(&ctx, frame);
+    }
+    RETURN_IF_ERROR(std::move(ctx).status());
+    return TypedValue::FromSlot(output_slot, frame);
+  }
+
+  std::shared_ptr<BoundExpr> bound_expr;
+  FrameLayout layout;
+  TypedSlot arg_1_slot;
+  TypedSlot arg_2_slot;
+  TypedSlot output_slot;
+  ThreadingInterface* threading;
+  int64_t min_size;
+};
+
+// Returns the BlockReducer for the seq.reduce, or nullptr if it cannot be
+// evaluated in parallel.
+absl::StatusOr<std::shared_ptr<const BlockReducer>> CompileBlockReducer(
+    const DynamicEvaluationEngineOptions& options, const ExprOperatorPtr& op,
+    QTypePtr value_qtype, QTypePtr output_qtype) {
+  if (options.seq_reduce_threading == nullptr ||
+      options.seq_reduce_threading->GetRecommendedThreadCount() <= 1 ||
+      value_qtype != output_qtype || !IsAssociativeOperator(op)) {
+    return nullptr;
+  }
+  FrameLayout::Builder layout_builder;
+  auto arg_1_slot = AddSlot(value_qtype, &layout_builder);
+  auto arg_2_slot = AddSlot(value_qtype, &layout_builder);
+  auto output_slot = AddSlot(value_qtype, &layout_builder);
+  ASSIGN_OR_RETURN(auto bound_expr,
+                   CompileAndBindExprOperator(options, &layout_builder, op,
+                                              {arg_1_slot, arg_2_slot},
+                                              output_slot));
+  return std::make_shared<const BlockReducer>(
+      BlockReducer{std::move(bound_expr), std::move(layout_builder).Build(),
+                   arg_1_slot, arg_2_slot, output_slot,
+                   options.seq_reduce_threading,
+                   options.min_parallel_seq_reduce_size});
+}
+
 // Compiles SeqReduceOperator into the executable_builder.
 std::optional<absl::Status> CompilePackedSeqReduceOperator(
     const CompileOperatorFnArgs& args) {
@@ -134,6 +204,9 @@ std::optional<absl::Status> CompilePackedSeqReduceOperator(
           subexpression_options, args.executable_builder->layout_builder(),
           reduce_op->op(), {reducer_arg_1_slot, reducer_arg_2_slot},
           args.output_slot));
+  ASSIGN_OR_RETURN(auto block_reducer,
+                   CompileBlockReducer(subexpression_options, reduce_op->op(),
+                                       value_qtype, output_qtype));
 
   std::string init_op_description;
   std::string eval_op_description;
@@ -162,16 +235,59 @@ std::optional<absl::Status> CompilePackedSeqReduceOperator(
       init_op_description);
   args.executable_builder->AddEvalOp(
       MakeBoundOperator(
-          [reducer_bound_expr, initial_slot, seq_slot,
+          [reducer_bound_expr, block_reducer, initial_slot, seq_slot,
            output_slot = args.output_slot, reducer_arg_1_slot,
            reducer_arg_2_slot](EvaluationContext* ctx, FramePtr frame) {
             const auto& seq = frame.Get(seq_slot.UnsafeToSlot<Sequence>());
             const auto* value_qtype = seq.value_qtype();
             const size_t seq_size = seq.size();
             const size_t value_size = value_qtype->type_layout().AllocSize();
+            // The block reducers allocate using the heap buffer factory, so
+            // with any other one (e.g. a non thread-safe arena) the sequence
+            // is reduced in the calling thread.
+            if (block_reducer != nullptr &&
+                seq_size >= block_reducer->min_size &&
+                &ctx->buffer_factory() == GetHeapBufferFactory()) {
+              const int64_t block_count = std::min<int64_t>(
+                  block_reducer->threading->GetRecommendedThreadCount(),
+                  seq_size);
+              std::vector<absl::StatusOr<TypedValue>> block_results(
+                  block_count);
+              ParallelFor(
+                  *block_reducer->threading, block_count, [&](int64_t block) {
+                    block_results[block] = block_reducer->Reduce(
+                        seq, seq_size * block / block_count,
+                        seq_size * (block + 1) / block_count,
+                        ctx->cancellation_context());
+                  });
+              initial_slot.CopyTo(frame, output_slot, frame);
+              for (auto& block_result : block_results) {
+                if (!block_result.ok()) {
+                  ctx->set_status(std::move(block_result).status());
+                  return;
+                }
+                output_slot.GetType()->UnsafeMove(
+                    frame.GetRawPointer(output_slot.byte_offset()),
+                    frame.GetRawPointer(reducer_arg_1_slot.byte_offset()));
+                value_qtype->UnsafeCopy(
+                    block_result->GetRawPointer(),
+                    frame.GetRawPointer(reducer_arg_2_slot.byte_offset()));
+                reducer_bound_expr->Execute(ctx, frame);
+                if (!ctx->status().ok()) {
+                  return;
+                }
+              }
+              return;
+            }
             initial_slot.CopyTo(frame, output_slot, frame);
-            for (size_t i = 0; i < seq_size && ctx->status().ok(); ++i) {
-              output_slot.CopyTo(frame, reducer_arg_1_slot, frame);
+            for (size_t i = 0; i < seq_size && ctx->status().ok() &&
+                               !ctx->CheckCancellation();
+                 ++i) {
+              // The reducer overwrites output_slot, so the accumulator can be
+              // moved out of it.
+              output_slot.GetType()->UnsafeMove(
+                  frame.GetRawPointer(output_slot.byte_offset()),
+                  frame.GetRawPointer(reducer_arg_1_slot.byte_offset()));
               value_qtype->UnsafeCopy(
                   seq.RawAt(i, value_size),
                   frame.GetRawPointer(reducer_arg_2_slot.byte_offset()));
@@ -18,11 +18,14 @@
 #include "arolla/qexpr/eval_extensions/seq_reduce_operator.h"
 
 #include <cstdint>
+#include <utility>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "arolla/expr/annotation_expr_operators.h"
+#include "arolla/expr/associative_operators.h"
 #include "arolla/expr/eval/eval.h"
+#include "arolla/expr/eval/invoke.h"
 #include "arolla/expr/eval/prepare_expression.h"
 #include "arolla/expr/eval/test_utils.h"
 #include "arolla/expr/expr.h"
@@ -34,16 +37,21 @@
 #include "arolla/memory/frame.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/testing/qtype.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/sequence/mutable_sequence.h"
 #include "arolla/sequence/sequence_qtype.h"
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/threading.h"
 
 namespace arolla::expr::eval_internal {
 namespace {
 
 using ::arolla::testing::EqualsExpr;
 using ::arolla::testing::IsOkAndHolds;
+using ::arolla::testing::TypedValueWith;
 using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::NotNull;
@@ -110,5 +118,34 @@ TEST_F(SeqReduceOperatorTest, CompilePackedSeqReduceOperator) {
               "}(SEQUENCE[INT32] [0x00], INT32 [0x24])"))));
 }
 
+TEST_F(SeqReduceOperatorTest, ParallelReduction) {
+  constexpr int64_t kSize = 10000;
+  ASSERT_OK_AND_ASSIGN(auto mutable_seq,
+                       MutableSequence::Make(GetQType<int64_t>(), kSize));
+  auto values = mutable_seq.UnsafeSpan<int64_t>();
+  for (int64_t i = 0; i < kSize; ++i) {
+    values[i] = i;
+  }
+  ASSERT_OK_AND_ASSIGN(
+      auto xs, TypedValue::FromValueWithQType(std::move(mutable_seq).Finish(),
+                                              GetSequenceQType<int64_t>()));
+  StdThreading threading(4);
+  DynamicEvaluationEngineOptions options;
+  options.seq_reduce_threading = &threading;
+  options.min_parallel_seq_reduce_size = 16;
+  for (const char* op_name : {"math.add", "math.subtract"}) {
+    SCOPED_TRACE(op_name);
+    ASSERT_OK_AND_ASSIGN(ExprOperatorPtr op, LookupOperator(op_name));
+    ASSERT_OK_AND_ASSIGN(
+        auto expr,
+        CallOp("seq.reduce", {Literal(op), Leaf("xs"), Literal(int64_t{1})}));
+    // math.subtract is not associative, so it is reduced sequentially.
+    const int64_t sum = kSize * (kSize - 1) / 2;
+    const int64_t expected = IsAssociativeOperator(op) ? 1 + sum : 1 - sum;
+    EXPECT_THAT(Invoke(expr, {{"xs", xs}}, options),
+                IsOkAndHolds(TypedValueWith<int64_t>(expected)));
+  }
+}
+
 }  // namespace
 }  // namespace arolla::expr::eval_internal
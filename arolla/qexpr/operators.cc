@@ -14,12 +14,15 @@
 //
 #include "arolla/qexpr/operators.h"
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -61,14 +64,24 @@ class CombinedOperatorFamily : public OperatorFamily {
       return op->second;
     }
 
-    ASSIGN_OR_RETURN(const QExprOperatorSignature* matching_qtype,
-                     FindMatchingSignature(
-                         QExprOperatorSignature::Get(input_types, output_type),
-                         supported_qtypes_, name_));
-
-    return operators_.at(
+    const auto* requested_qtype =
+        QExprOperatorSignature::Get(input_types, output_type);
+    {
+      absl::ReaderMutexLock lock(&casting_cache_mutex_);
+      if (auto it = casting_cache_.find(requested_qtype);
+          it != casting_cache_.end()) {
+        return it->second;
+      }
+    }
+    ASSIGN_OR_RETURN(
+        const QExprOperatorSignature* matching_qtype,
+        FindMatchingSignature(requested_qtype, supported_qtypes_, name_));
+    auto result = operators_.at(
         std::vector<QTypePtr>(matching_qtype->GetInputTypes().begin(),
                               matching_qtype->GetInputTypes().end()));
+    absl::WriterMutexLock lock(&casting_cache_mutex_);
+    casting_cache_.emplace(requested_qtype, result);
+    return result;
   }
 
   // Tries to insert an operator. Returns an error if an operator with the
@@ -88,13 +101,34 @@ class CombinedOperatorFamily : public OperatorFamily {
       return absl::OkStatus();
     }
     supported_qtypes_.push_back(inserted.first->second->GetQType());
+    // A new overload may be a better match for the cached signatures.
+    absl::WriterMutexLock lock(&casting_cache_mutex_);
+    casting_cache_.clear();
     return absl::OkStatus();
   }
 
+  // Returns the registered operators in the registration order.
+  std::vector<OperatorPtr> operators() const {
+    std::vector<OperatorPtr> result;
+    result.reserve(supported_qtypes_.size());
+    for (const auto* qtype : supported_qtypes_) {
+      auto input_types = qtype->GetInputTypes();
+      result.push_back(operators_.at(
+          std::vector<QTypePtr>(input_types.begin(), input_types.end())));
+    }
+    return result;
+  }
+
  private:
   std::string name_;
   absl::flat_hash_map<std::vector<QTypePtr>, OperatorPtr> operators_;
   std::vector<const QExprOperatorSignature*> supported_qtypes_;
+
+  // Operators resolved via FindMatchingSignature, i.e. those requiring
+  // implicit casting of the inputs, by the requested signature.
+  mutable absl::Mutex casting_cache_mutex_;
+  mutable absl::flat_hash_map<const QExprOperatorSignature*, OperatorPtr>
+      casting_cache_ ABSL_GUARDED_BY(casting_cache_mutex_);
 };
 
 }  // namespace
@@ -116,6 +150,7 @@ absl::Status OperatorRegistry::RegisterOperatorFamily(
             "trying to register non-static QExpr operator family %s twice",
             name));
   }
+  snapshot_.store(nullptr, std::memory_order_release);
   return absl::OkStatus();
 }
 
@@ -133,6 +168,7 @@ absl::Status OperatorRegistry::RegisterOperator(OperatorPtr op) {
         op->name(),
         std::make_unique<CombinedOperatorFamily>(std::string(op->name())));
     found = inserted.first;
+    snapshot_.store(nullptr, std::memory_order_release);
   }
 
   if (auto* combined_family =
@@ -158,17 +194,50 @@ std::vector<std::string> OperatorRegistry::ListRegisteredOperators() {
   return names;
 }
 
-absl::StatusOr<const OperatorFamily*> OperatorRegistry::LookupOperatorFamily(
-    absl::string_view name) const {
+std::vector<OperatorPtr> OperatorRegistry::ListRegisteredOperatorOverloads(
+    absl::string_view name) {
   absl::ReaderMutexLock lock(&mutex_);
 
-  auto iter = families_.find(name);
-  if (iter == families_.end()) {
+  auto found = families_.find(name);
+  if (found == families_.end()) {
+    return {};
+  }
+  if (auto* combined_family =
+          dynamic_cast<const CombinedOperatorFamily*>(found->second.get())) {
+    return combined_family->operators();
+  }
+  return {};
+}
+
+const OperatorRegistry::FamiliesSnapshot&
+OperatorRegistry::GetFamiliesSnapshot() const {
+  if (auto* snapshot = snapshot_.load(std::memory_order_acquire);
+      ABSL_PREDICT_TRUE(snapshot != nullptr)) {
+    return *snapshot;
+  }
+  absl::MutexLock lock(&mutex_);
+  if (auto* snapshot = snapshot_.load(std::memory_order_relaxed)) {
+    return *snapshot;  // Created concurrently.
+  }
+  auto snapshot = std::make_unique<FamiliesSnapshot>();
+  snapshot->reserve(families_.size());
+  for (const auto& [name, family] : families_) {
+    snapshot->emplace(name, family.get());
+  }
+  snapshot_.store(snapshot.get(), std::memory_order_release);
+  return *snapshots_.emplace_back(std::move(snapshot));
+}
+
+absl::StatusOr<const OperatorFamily*> OperatorRegistry::LookupOperatorFamily(
+    absl::string_view name) const {
+  const auto& snapshot = GetFamiliesSnapshot();
+  auto iter = snapshot.find(name);
+  if (iter == snapshot.end()) {
     return absl::Status(absl::StatusCode::kNotFound,
                         absl::StrFormat("QExpr operator %s not found; %s", name,
                                         SuggestMissingDependency()));
   }
-  return iter->second.get();
+  return iter->second;
 }
 
 absl::StatusOr<OperatorPtr> OperatorRegistry::DoLookupOperator(
@@ -15,6 +15,8 @@
 #ifndef AROLLA_QEXPR_OPERATORS_H_
 #define AROLLA_QEXPR_OPERATORS_H_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -22,6 +24,7 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -50,6 +53,10 @@ class BoundOperator {
   // to check the status before calling another operation using the same
   // `ctx`.
   virtual void Run(EvaluationContext* ctx, FramePtr frame) const = 0;
+
+  // Returns an estimate of the heap memory owned by the operator, e.g. by a
+  // compiled decision forest. The memory in the frame is not included.
+  virtual int64_t EstimateMemoryUsage() const { return 0; }
 };
 
 class QExprOperator {
@@ -180,6 +187,13 @@ class OperatorRegistry final : public OperatorDirectory {
   // Returns list of all registered operators.
   std::vector<std::string> ListRegisteredOperators();
 
+  // Returns the overloads registered via RegisterOperator under the given
+  // name, in the registration order. Returns an empty list for the operator
+  // families registered via RegisterOperatorFamily, because they don't have a
+  // finite list of overloads.
+  std::vector<OperatorPtr> ListRegisteredOperatorOverloads(
+      absl::string_view name);
+
   // Get the OperatorRegistry instance.
   static OperatorRegistry* GetInstance();
 
@@ -191,8 +205,29 @@ class OperatorRegistry final : public OperatorDirectory {
   absl::StatusOr<const OperatorFamily*> LookupOperatorFamily(
       absl::string_view name) const;
 
-  absl::flat_hash_map<std::string, std::unique_ptr<OperatorFamily>> families_
+  // An immutable index of `families_`, used for lookups without locking.
+  using FamiliesSnapshot =
+      absl::flat_hash_map<absl::string_view, const OperatorFamily*>;
+
+  // Returns the up-to-date snapshot, creating it if needed.
+  const FamiliesSnapshot& GetFamiliesSnapshot() const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Note: node_hash_map keeps the keys in place, so they can be referenced
+  // from the snapshots.
+  absl::node_hash_map<std::string, std::unique_ptr<OperatorFamily>> families_
       ABSL_GUARDED_BY(mutex_);
+
+  // The snapshot of the current `families_`, or nullptr if a family was added
+  // since it was created.
+  mutable std::atomic<const FamiliesSnapshot*> snapshot_ = nullptr;
+
+  // All the created snapshots. They are never deleted because lookups may
+  // still be using them. Snapshots are created only on a lookup after a new
+  // family registration, so normally there are only a few of them.
+  mutable std::vector<std::unique_ptr<const FamiliesSnapshot>> snapshots_
+      ABSL_GUARDED_BY(mutex_);
+
   mutable absl::Mutex mutex_;
 };
 
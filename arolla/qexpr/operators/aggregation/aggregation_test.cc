@@ -12,11 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <limits>
 #include <optional>
 #include <set>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -25,19 +28,29 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/edge.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/aggregation_ops_interface.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators/aggregation/dot_product.h"
 #include "arolla/qexpr/operators/aggregation/group_op_accumulators.h"
+#include "arolla/qexpr/operators/aggregation/group_stats.h"
+#include "arolla/qexpr/operators/aggregation/hash_table_presizer.h"
 #include "arolla/util/bytes.h"
+#include "arolla/util/text.h"
 #include "arolla/util/meta.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 
 namespace arolla {
 namespace {
 
+using ::arolla::testing::IsOkAndHolds;
 using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
 using ::testing::FloatEq;
 using ::testing::HasSubstr;
 
@@ -105,6 +118,68 @@ TEST(OpInterface, CreateWithMethod) {
                        HasSubstr("Expected integer, got 'foo'")));
 }
 
+TEST(Accumulator, Merge) {
+  static_assert(accumulator_has_merge_v<SumAggregator<float>>);
+  static_assert(accumulator_has_merge_v<MinAggregator<float>>);
+  static_assert(!accumulator_has_merge_v<ProdAggregator<float>>);
+  static_assert(!accumulator_has_merge_v<TestAccumulator>);
+  {
+    SumAggregator<int64_t> acc1(10), acc2(10);
+    acc1.Reset();
+    acc2.Reset();
+    acc1.Add(1);
+    acc2.AddN(2, 3);
+    acc1.Merge(acc2);
+    EXPECT_EQ(acc1.GetResult(), int64_t{17});
+  }
+  {
+    SumAggregator<int64_t> acc1, acc2;
+    acc1.Reset();
+    acc2.Reset();
+    acc1.Merge(acc2);
+    EXPECT_EQ(acc1.GetResult(), std::nullopt);
+    acc2.Add(5);
+    acc1.Merge(acc2);
+    EXPECT_EQ(acc1.GetResult(), int64_t{5});
+  }
+  {
+    MaxAggregator<float> acc1, acc2;
+    acc1.Reset();
+    acc2.Reset();
+    acc2.Add(3.0f);
+    acc1.Merge(acc2);
+    EXPECT_EQ(acc1.GetResult(), 3.0f);
+    acc2.Add(5.0f);
+    acc1.Add(4.0f);
+    acc1.Merge(acc2);
+    EXPECT_EQ(acc1.GetResult(), 5.0f);
+  }
+  {
+    CollapseAccumulator<float> acc1, acc2;
+    acc1.Reset();
+    acc2.Reset();
+    acc2.Add(NAN);
+    acc1.Merge(acc2);
+    EXPECT_TRUE(std::isnan(acc1.GetResult().value));
+    acc2.Reset();
+    acc2.Add(1.0f);
+    acc1.Merge(acc2);
+    EXPECT_EQ(acc1.GetResult(), std::nullopt);
+  }
+  {
+    LogicalAllAggregator acc1, acc2;
+    acc1.Reset();
+    acc2.Reset();
+    acc1.Add(true);
+    acc2.Add(std::nullopt);
+    acc1.Merge(acc2);
+    EXPECT_EQ(acc1.GetResult(), std::nullopt);
+    acc2.Add(false);
+    acc1.Merge(acc2);
+    EXPECT_EQ(acc1.GetResult(), false);
+  }
+}
+
 TEST(Accumulator, LogicalAdd) {
   // All present true -> true
   // All present true and at least one missing -> missing
@@ -254,6 +329,45 @@ TEST(Accumulator, GroupBy) {
   EXPECT_EQ(acc.GetResult(), 13);
 }
 
+TEST(Accumulator, GroupByWithSizeHint) {
+  constexpr int64_t kSize = 100000;
+  for (int64_t cardinality : {int64_t{10}, int64_t{1000}, kSize}) {
+    int64_t group_counter = 0;
+    GroupByAccumulator<int64_t> acc(&group_counter, kSize);
+    for (int pass = 0; pass < 2; ++pass) {
+      acc.Reset();
+      int64_t expected_groups = group_counter;
+      for (int64_t i = 0; i < kSize; ++i) {
+        acc.Add((i * 7919) % cardinality);
+        int64_t group = acc.GetResult();
+        if (i < cardinality) {
+          EXPECT_EQ(group, expected_groups);
+          expected_groups++;
+        }
+      }
+      EXPECT_EQ(group_counter, expected_groups);
+      EXPECT_EQ(group_counter, (pass + 1) * cardinality);
+    }
+  }
+}
+
+TEST(HashTablePresizer, EstimateDistinctCount) {
+  EXPECT_EQ(EstimateDistinctCount(0, 0, 100), 100);
+  EXPECT_EQ(EstimateDistinctCount(1000, 1000, 1000000), 1000000);
+  // Low cardinality: all the distinct values are seen in the prefix.
+  EXPECT_NEAR(EstimateDistinctCount(10, 1000, 1000000), 10, 1);
+  // Uniform values from [0, N): the prefix of size m is expected to contain
+  // N(1 - exp(-m/N)) distinct values.
+  for (double n : {1e4, 1e5, 1e6}) {
+    int64_t prefix_distinct = n * -std::expm1(-1e5 / n);
+    EXPECT_NEAR(EstimateDistinctCount(prefix_distinct, 100000, 1000000),
+                n * -std::expm1(-1e6 / n), 0.01 * n)
+        << n;
+  }
+  // Never exceeds the size.
+  EXPECT_LE(EstimateDistinctCount(999, 1000, 2000), 2000);
+}
+
 TEST(Accumulator, PermuteInt) {
   ArrayTakeOverAccumulator<int> acc;
   // Simple permutation.
@@ -402,6 +516,207 @@ TEST(Accumulator, OrdinalRank_Descending) {
   EXPECT_EQ(acc.GetResult(), 3);
 }
 
+TEST(Accumulator, OrdinalRank_LargeGroup) {
+  // Large groups use radix sort, verify it against std::sort.
+  constexpr int64_t kSize = 5000;
+  std::vector<std::tuple<float, int64_t, int64_t>> elems;
+  for (int64_t i = 0; i < kSize; ++i) {
+    float value = static_cast<float>((i * 37) % 101 - 50) / 4;
+    if (value == 0 && i % 2 == 0) {
+      value = -0.f;
+    }
+    elems.emplace_back(value, (i * 13) % 7 - 3, i);
+  }
+  elems.emplace_back(std::numeric_limits<float>::quiet_NaN(), 0, kSize);
+  for (bool descending : {false, true}) {
+    OrdinalRankAccumulator<float, int64_t> acc(descending);
+    for (const auto& [value, tie_breaker, _] : elems) {
+      acc.Add(value, tie_breaker);
+    }
+    acc.FinalizeFullGroup();
+
+    auto sorted = elems;
+    std::sort(sorted.begin(), sorted.end() - 1,
+              [descending](const auto& a, const auto& b) {
+                if (std::get<0>(a) != std::get<0>(b)) {
+                  return descending ? std::get<0>(a) > std::get<0>(b)
+                                    : std::get<0>(a) < std::get<0>(b);
+                }
+                return std::tie(std::get<1>(a), std::get<2>(a)) <
+                       std::tie(std::get<1>(b), std::get<2>(b));
+              });
+    std::vector<int64_t> expected(sorted.size());
+    for (size_t rank = 0; rank < sorted.size(); ++rank) {
+      expected[std::get<2>(sorted[rank])] = rank;
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_EQ(acc.GetResult(), expected[i]) << descending << " " << i;
+    }
+  }
+}
+
+TEST(Accumulator, TopK) {
+  TopKAccumulator<float, int> acc(/*k=*/3, /*descending=*/true);
+  acc.Add(7, 10);
+  acc.Add(7, 9);
+  acc.Add(std::numeric_limits<float>::quiet_NaN(), 10);
+  acc.Add(1, 10);
+  acc.Add(2, 10);
+  acc.Add(2, 10);
+  acc.FinalizeFullGroup();
+  EXPECT_EQ(acc.GetResult(), int64_t{1});
+  EXPECT_EQ(acc.GetResult(), int64_t{0});
+  EXPECT_EQ(acc.GetResult(), std::nullopt);
+  EXPECT_EQ(acc.GetResult(), std::nullopt);
+  EXPECT_EQ(acc.GetResult(), int64_t{2});
+  EXPECT_EQ(acc.GetResult(), std::nullopt);
+  EXPECT_OK(acc.GetStatus());
+
+  // k larger than the group.
+  acc = TopKAccumulator<float, int>(/*k=*/10);
+  acc.Reset();
+  acc.Add(std::numeric_limits<float>::quiet_NaN(), 0);
+  acc.Add(5, 0);
+  acc.FinalizeFullGroup();
+  EXPECT_EQ(acc.GetResult(), int64_t{1});
+  EXPECT_EQ(acc.GetResult(), int64_t{0});
+
+  acc = TopKAccumulator<float, int>(/*k=*/-1);
+  acc.Reset();
+  acc.Add(5, 0);
+  acc.FinalizeFullGroup();
+  EXPECT_EQ(acc.GetResult(), std::nullopt);
+  EXPECT_THAT(acc.GetStatus(), StatusIs(absl::StatusCode::kInvalidArgument,
+                                        "k must be non-negative, got -1"));
+}
+
+TEST(Accumulator, TopK_LargeGroup) {
+  // The result must match the filtered ordinal rank.
+  constexpr int64_t kSize = 20000;
+  std::vector<std::pair<float, int64_t>> elems;
+  for (int64_t i = 0; i < kSize; ++i) {
+    float value = (i % 1000 == 0) ? std::numeric_limits<float>::quiet_NaN()
+                                  : static_cast<float>((i * 37) % 101 - 50);
+    elems.emplace_back(value, (i * 13) % 7 - 3);
+  }
+  for (bool descending : {false, true}) {
+    OrdinalRankAccumulator<float, int64_t> rank_acc(descending);
+    for (const auto& [value, tie_breaker] : elems) {
+      rank_acc.Add(value, tie_breaker);
+    }
+    rank_acc.FinalizeFullGroup();
+    std::vector<int64_t> ranks(kSize);
+    for (auto& rank : ranks) {
+      rank = rank_acc.GetResult();
+    }
+    for (int64_t k : {int64_t{0}, int64_t{1}, int64_t{100}, kSize - 10,
+                      kSize + 10}) {
+      TopKAccumulator<float, int64_t> acc(k, descending);
+      acc.Reset();
+      for (const auto& [value, tie_breaker] : elems) {
+        acc.Add(value, tie_breaker);
+      }
+      acc.FinalizeFullGroup();
+      for (int64_t i = 0; i < kSize; ++i) {
+        OptionalValue<int64_t> expected;
+        if (ranks[i] < k) {
+          expected = ranks[i];
+        }
+        ASSERT_EQ(acc.GetResult(), expected) << descending << " " << k << " "
+                                             << i;
+      }
+    }
+  }
+}
+
+TEST(Accumulator, ApproxCountDistinct) {
+  static_assert(
+      accumulator_has_merge_v<ApproxCountDistinctAggregator<int64_t>>);
+  EXPECT_THAT(CreateAccumulator<ApproxCountDistinctAggregator<int64_t>>(
+                  int64_t{20}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "precision must be in range [4, 16], got 20"));
+  ASSERT_OK_AND_ASSIGN(
+      auto acc1,
+      CreateAccumulator<ApproxCountDistinctAggregator<int64_t>>(int64_t{12}));
+  auto acc2 = acc1;
+  acc1.Reset();
+  EXPECT_EQ(acc1.GetResult(), 0);
+  for (int64_t i = 0; i < 100; ++i) {
+    acc1.Add(i % 10);
+  }
+  acc1.AddN(5, 10);
+  EXPECT_EQ(acc1.GetResult(), 11);
+  acc2.Reset();
+  acc2.Add(5);
+  acc2.Add(20);
+  acc1.Merge(acc2);
+  EXPECT_EQ(acc1.GetResult(), 12);
+}
+
+TEST(Accumulator, HyperLogLogSketch) {
+  ASSERT_OK_AND_ASSIGN(auto sketch_acc,
+                       CreateAccumulator<HyperLogLogSketchAggregator<Bytes>>(
+                           int64_t{10}));
+  ASSERT_OK_AND_ASSIGN(
+      auto merge_acc,
+      CreateAccumulator<HyperLogLogMergeAggregator>(int64_t{10}));
+  merge_acc.Reset();
+  for (int group = 0; group < 3; ++group) {
+    sketch_acc.Reset();
+    for (int i = 0; i < 1000; ++i) {
+      sketch_acc.Add(absl::StrCat(group * 500 + i));
+    }
+    merge_acc.Add(sketch_acc.GetResult());
+  }
+  // Groups contain values [0, 1000), [500, 1500) and [1000, 2000).
+  ASSERT_OK_AND_ASSIGN(int64_t estimate,
+                       HyperLogLogEstimateOp()(merge_acc.GetResult()));
+  EXPECT_NEAR(estimate, 2000, 200);
+  EXPECT_OK(merge_acc.GetStatus());
+
+  merge_acc.Add("invalid");
+  EXPECT_THAT(merge_acc.GetStatus(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "invalid HyperLogLog sketch"));
+
+  ASSERT_OK_AND_ASSIGN(
+      merge_acc, CreateAccumulator<HyperLogLogMergeAggregator>(int64_t{12}));
+  merge_acc.Reset();
+  merge_acc.Add(sketch_acc.GetResult());
+  EXPECT_THAT(merge_acc.GetStatus(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "expected HyperLogLog sketches with precision 12, "
+                       "got 10"));
+}
+
+TEST(Accumulator, ApproxMostFrequent) {
+  static_assert(accumulator_has_merge_v<ApproxMostFrequentAggregator<Text>>);
+  EXPECT_THAT(
+      CreateAccumulator<ApproxMostFrequentAggregator<Text>>(int64_t{0}),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               "capacity must be positive, got 0"));
+  ASSERT_OK_AND_ASSIGN(
+      auto acc1,
+      CreateAccumulator<ApproxMostFrequentAggregator<Text>>(int64_t{4}));
+  auto acc2 = acc1;
+  acc1.Reset();
+  EXPECT_EQ(acc1.GetResult(), std::nullopt);
+  std::vector<std::string> values;
+  for (int i = 0; i < 100; ++i) {
+    values.push_back(i % 3 == 0 ? "frequent" : absl::StrCat("rare", i));
+  }
+  for (const auto& value : values) {
+    acc1.Add(value);
+  }
+  EXPECT_EQ(acc1.GetResult(), absl::string_view("frequent"));
+
+  acc2.Reset();
+  acc2.AddN(50, "other");
+  acc1.Merge(acc2);
+  EXPECT_EQ(acc1.GetResult(), absl::string_view("other"));
+}
+
 TEST(Accumulator, DenseRank) {
   DenseRankAccumulator<int> acc;
 
@@ -509,5 +824,279 @@ TEST(Accumulator, AggMedianNan) {
   EXPECT_TRUE(std::isnan(acc.GetResult().value));
 }
 
+TEST(Accumulator, ApproxInverseCdf) {
+  ApproxInverseCdfAccumulator<int> acc(0.5);
+  EXPECT_EQ(acc.GetResult(), std::nullopt);
+
+  // Small groups are exact.
+  acc.Reset();
+  acc.Add(7);
+  acc.Add(1);
+  acc.Add(1);
+  acc.Add(2);
+  EXPECT_EQ(acc.GetResult(), 1);
+
+  acc.Reset();
+  acc.Add(7);
+  acc.Add(1);
+  acc.Add(2);
+  EXPECT_EQ(acc.GetResult(), 2);
+
+  // Large groups are approximate.
+  constexpr int kSize = 100000;
+  for (float cdf : {0.f, 0.1f, 0.5f, 0.9f, 1.f}) {
+    ApproxInverseCdfAccumulator<int> acc(cdf);
+    acc.Reset();
+    for (int i = 0; i < kSize; ++i) {
+      // A permutation of [0, kSize).
+      acc.Add(static_cast<int>((int64_t{i} * 7919) % kSize));
+    }
+    auto res = acc.GetResult();
+    ASSERT_TRUE(res.present);
+    EXPECT_NEAR(res.value, cdf * kSize, 0.01 * kSize) << cdf;
+  }
+}
+
+TEST(Accumulator, ApproxInverseCdfResetIsComplete) {
+  ApproxInverseCdfAccumulator<int> acc(0.5);
+  auto add_group = [&acc]() {
+    acc.Reset();
+    // A single compaction.
+    constexpr int kSize = 300;
+    for (int i = 0; i < kSize; ++i) {
+      acc.Add(static_cast<int>((int64_t{i} * 7919) % kSize));
+    }
+    return acc.GetResult();
+  };
+  auto first = add_group();
+  // The result of a group must not depend on the previous groups.
+  EXPECT_EQ(add_group(), first);
+  EXPECT_EQ(add_group(), first);
+}
+
+TEST(Accumulator, ApproxInverseCdfNan) {
+  ApproxInverseCdfAccumulator<float> acc(0.5);
+  acc.Add(7);
+  acc.Add(1);
+  acc.Add(std::numeric_limits<float>::quiet_NaN());
+  EXPECT_TRUE(std::isnan(acc.GetResult().value));
+
+  acc.Reset();
+  acc.Add(7);
+  acc.Add(1);
+  acc.Add(2);
+  EXPECT_EQ(acc.GetResult(), 2.f);
+}
+
+TEST(Accumulator, GatherSum) {
+  static_assert(accumulator_has_merge_v<GatherSumAggregator<float>>);
+  constexpr int kTableSize = 1000;
+  std::vector<OptionalValue<float>> table_values(kTableSize);
+  for (int i = 0; i < kTableSize; ++i) {
+    if (i % 10 != 0) {
+      table_values[i] = 0.5f * i;
+    }
+  }
+  auto table = CreateDenseArray<float>(table_values);
+
+  GatherSumAggregator<float> acc(table);
+  acc.Reset();
+  EXPECT_EQ(acc.GetResult(), std::nullopt);
+
+  // More ids than the prefetch distance, including missing table values.
+  acc.Reset();
+  double expected = 0;
+  for (int i = 0; i < 100; ++i) {
+    int64_t id = (i * 7919) % kTableSize;
+    acc.Add(id);
+    if (table_values[id].present) {
+      expected += table_values[id].value;
+    }
+  }
+  EXPECT_EQ(acc.GetResult(), static_cast<float>(expected));
+
+  acc.Reset();
+  acc.Add(1);
+  acc.AddN(3, 2);
+  acc.Add(10);  // missing
+  EXPECT_EQ(acc.GetResult(), 3.5f);
+
+  acc.Reset();
+  acc.Add(10);  // missing
+  EXPECT_EQ(acc.GetResult(), std::nullopt);
+  EXPECT_OK(acc.GetStatus());
+
+  // Ids pending from an abandoned group are dropped.
+  acc.Reset();
+  acc.Add(1);
+  acc.Add(2);
+  acc.Reset();
+  acc.Add(3);
+  EXPECT_EQ(acc.GetResult(), 1.5f);
+
+  acc.Reset();
+  acc.Add(1);
+  acc.Add(kTableSize);
+  EXPECT_EQ(acc.GetResult(), 0.5f);
+  EXPECT_THAT(acc.GetStatus(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "array index 1000 out of range [0, 1000)"));
+}
+
+TEST(Accumulator, GatherMean) {
+  auto table = CreateDenseArray<double>({1., 2., std::nullopt, 4.});
+  GatherMeanAggregator<double> acc1(table), acc2(table);
+  acc1.Reset();
+  acc2.Reset();
+  acc1.Add(0);
+  acc1.Add(2);
+  acc2.Add(1);
+  acc2.Add(3);
+  acc2.Add(3);
+  EXPECT_EQ(acc2.GetResult(), 10. / 3);
+  acc1.Merge(acc2);
+  EXPECT_EQ(acc1.GetResult(), 11. / 4);
+
+  // The mean is computed in double even for float tables.
+  GatherMeanAggregator<float> float_acc(
+      CreateDenseArray<float>({16777216.f, 1.f, 0.f}));
+  float_acc.Reset();
+  for (int64_t id : {0, 1, 2, 2, 2}) {
+    float_acc.Add(id);
+  }
+  EXPECT_EQ(float_acc.GetResult(), static_cast<float>(16777217. / 5));
+}
+
+TEST(Accumulator, DotProduct) {
+  static_assert(accumulator_has_merge_v<DotProductAggregator<float>>);
+  DotProductAggregator<float> acc1, acc2;
+  acc1.Reset();
+  EXPECT_EQ(acc1.GetResult(), std::nullopt);
+  acc1.Add(1.f, 2.f);
+  acc1.AddN(3, 0.5f, -1.f);
+  EXPECT_EQ(acc1.GetResult(), 0.5f);
+  acc2.Reset();
+  acc2.Add(4.f, 0.25f);
+  acc1.Merge(acc2);
+  EXPECT_EQ(acc1.GetResult(), 1.5f);
+}
+
+TEST(DenseArrayDotOp, SplitPointsEdge) {
+  EvaluationContext ctx;
+  ASSERT_OK_AND_ASSIGN(auto edge, DenseArrayEdge::FromSplitPoints(
+                                      CreateDenseArray<int64_t>({0, 3, 3, 5})));
+  auto x = CreateDenseArray<float>({1., 2., 3., 4., 5.});
+  auto y = CreateDenseArray<float>({1., 0.5, -1., 2., 0.});
+  // Full arguments are processed by the vectorized path.
+  ASSERT_OK_AND_ASSIGN(auto res, DenseArrayDotOp()(&ctx, x, y, edge));
+  EXPECT_THAT(res, ElementsAre(-1.f, std::nullopt, 8.f));
+
+  // A missing value is skipped by the fallback path.
+  auto sparse_y = CreateDenseArray<float>({1., 0.5, std::nullopt, 2., 0.});
+  ASSERT_OK_AND_ASSIGN(res, DenseArrayDotOp()(&ctx, x, sparse_y, edge));
+  EXPECT_THAT(res, ElementsAre(2.f, std::nullopt, 8.f));
+
+  EXPECT_THAT(DenseArrayDotOp()(&ctx, x, CreateDenseArray<float>({1.}), edge),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("argument sizes mismatch")));
+}
+
+TEST(DenseArrayDotOp, MappingEdge) {
+  EvaluationContext ctx;
+  ASSERT_OK_AND_ASSIGN(auto edge,
+                       DenseArrayEdge::FromMapping(
+                           CreateDenseArray<int64_t>({1, 0, 1, std::nullopt}),
+                           /*parent_size=*/3));
+  auto x = CreateDenseArray<double>({1., 2., 3., 4.});
+  auto y = CreateDenseArray<double>({1., 2., 3., 4.});
+  ASSERT_OK_AND_ASSIGN(auto res, DenseArrayDotOp()(&ctx, x, y, edge));
+  EXPECT_THAT(res, ElementsAre(4., 10., std::nullopt));
+}
+
+TEST(DenseArrayDotOp, ScalarEdge) {
+  EvaluationContext ctx;
+  auto x = CreateDenseArray<float>({1., 2., 3.});
+  auto y = CreateDenseArray<float>({3., 2., 1.});
+  EXPECT_THAT(DenseArrayDotOp()(&ctx, x, y, DenseArrayGroupScalarEdge(3)),
+              IsOkAndHolds(OptionalValue<float>(10.f)));
+  EXPECT_THAT(DenseArrayDotOp()(&ctx, CreateDenseArray<float>({}),
+                                CreateDenseArray<float>({}),
+                                DenseArrayGroupScalarEdge(0)),
+              IsOkAndHolds(OptionalValue<float>()));
+  auto sparse_x = CreateDenseArray<float>({1., std::nullopt, 3.});
+  EXPECT_THAT(
+      DenseArrayDotOp()(&ctx, sparse_x, y, DenseArrayGroupScalarEdge(3)),
+      IsOkAndHolds(OptionalValue<float>(6.f)));
+}
+
+TEST(DenseArrayGroupStatsOp, SplitPointsEdge) {
+  EvaluationContext ctx;
+  constexpr int32_t kAllStats = DenseArrayGroupStatsOp::kAllStats;
+  ASSERT_OK_AND_ASSIGN(auto edge, DenseArrayEdge::FromSplitPoints(
+                                      CreateDenseArray<int64_t>({0, 3, 3, 5})));
+  auto x = CreateDenseArray<float>({1., std::nullopt, 3., -4., 5.});
+  ASSERT_OK_AND_ASSIGN(auto res,
+                       DenseArrayGroupStatsOp()(&ctx, x, edge,
+                                                OptionalValue<float>(),
+                                                kAllStats));
+  auto [sum, count, min, max] = res;
+  EXPECT_THAT(sum, ElementsAre(4.f, std::nullopt, 1.f));
+  EXPECT_THAT(count, ElementsAre(2, 0, 2));
+  EXPECT_THAT(min, ElementsAre(1.f, std::nullopt, -4.f));
+  EXPECT_THAT(max, ElementsAre(3.f, std::nullopt, 5.f));
+
+  // `initial` only affects the sum.
+  ASSERT_OK_AND_ASSIGN(res, DenseArrayGroupStatsOp()(&ctx, x, edge,
+                                                     OptionalValue<float>(10.f),
+                                                     kAllStats));
+  EXPECT_THAT(std::get<0>(res), ElementsAre(14.f, 10.f, 11.f));
+  EXPECT_THAT(std::get<2>(res), ElementsAre(1.f, std::nullopt, -4.f));
+
+  EXPECT_THAT(DenseArrayGroupStatsOp()(&ctx, CreateDenseArray<float>({1.}),
+                                       edge, OptionalValue<float>(),
+                                       kAllStats),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("argument sizes mismatch")));
+  EXPECT_THAT(DenseArrayGroupStatsOp()(&ctx, x, edge, OptionalValue<float>(),
+                                       kAllStats + 1),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "unexpected stats: 16"));
+}
+
+TEST(DenseArrayGroupStatsOp, MappingEdge) {
+  EvaluationContext ctx;
+  ASSERT_OK_AND_ASSIGN(auto edge,
+                       DenseArrayEdge::FromMapping(
+                           CreateDenseArray<int64_t>({1, 0, 1, std::nullopt}),
+                           /*parent_size=*/3));
+  auto x = CreateDenseArray<int64_t>({1, 2, 3, 4});
+  ASSERT_OK_AND_ASSIGN(
+      auto res, DenseArrayGroupStatsOp()(&ctx, x, edge,
+                                         OptionalValue<int64_t>(),
+                                         DenseArrayGroupStatsOp::kAllStats));
+  auto [sum, count, min, max] = res;
+  EXPECT_THAT(sum, ElementsAre(2, 4, std::nullopt));
+  EXPECT_THAT(count, ElementsAre(1, 2, 0));
+  EXPECT_THAT(min, ElementsAre(2, 1, std::nullopt));
+  EXPECT_THAT(max, ElementsAre(2, 3, std::nullopt));
+}
+
+TEST(DenseArrayGroupStatsOp, RequestedStatsOnly) {
+  EvaluationContext ctx;
+  ASSERT_OK_AND_ASSIGN(auto edge, DenseArrayEdge::FromSplitPoints(
+                                      CreateDenseArray<int64_t>({0, 3, 5})));
+  auto x = CreateDenseArray<float>({1., std::nullopt, 3., -4., 5.});
+  ASSERT_OK_AND_ASSIGN(
+      auto res,
+      DenseArrayGroupStatsOp()(
+          &ctx, x, edge, OptionalValue<float>(),
+          DenseArrayGroupStatsOp::kCount | DenseArrayGroupStatsOp::kMax));
+  auto [sum, count, min, max] = res;
+  EXPECT_THAT(sum, ElementsAre(std::nullopt, std::nullopt));
+  EXPECT_THAT(count, ElementsAre(2, 2));
+  EXPECT_THAT(min, ElementsAre(std::nullopt, std::nullopt));
+  EXPECT_THAT(max, ElementsAre(3.f, 5.f));
+}
+
 }  // namespace
 }  // namespace arolla
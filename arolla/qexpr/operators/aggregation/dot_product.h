@@ -0,0 +1,90 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QEXPR_OPERATORS_AGGREGATION_DOT_PRODUCT_H_
+#define AROLLA_QEXPR_OPERATORS_AGGREGATION_DOT_PRODUCT_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/edge.h"
+#include "arolla/dense_array/ops/dense_group_ops.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators/aggregation/group_op_accumulators.h"
+#include "arolla/qexpr/operators/math/batch_arithmetic.h"
+
+namespace arolla {
+
+// math._dot operator for DenseArrays.
+//
+// The operator computes the whole group with BatchDot when both arguments are
+// full and the edge is a SPLIT_POINTS or a scalar edge, so the common case of
+// dense features (e.g. embeddings or linear model weights) is vectorized and
+// doesn't materialize the intermediate products. Otherwise it falls back to
+// DotProductAggregator.
+struct DenseArrayDotOp {
+  template <typename T>
+  absl::StatusOr<DenseArray<T>> operator()(EvaluationContext* ctx,
+                                           const DenseArray<T>& x,
+                                           const DenseArray<T>& y,
+                                           const DenseArrayEdge& edge) const {
+    static_assert(std::is_floating_point_v<T>);
+    if (edge.edge_type() == DenseArrayEdge::SPLIT_POINTS && x.IsFull() &&
+        y.IsFull() && x.size() == edge.child_size() &&
+        y.size() == edge.child_size()) {
+      DenseArraySplitPoints splits(edge);
+      absl::Span<const T> x_values = x.values.span();
+      absl::Span<const T> y_values = y.values.span();
+      DenseArrayBuilder<T> builder(edge.parent_size(), &ctx->buffer_factory());
+      for (int64_t i = 0; i < edge.parent_size(); ++i) {
+        int64_t begin = splits[i];
+        int64_t size = splits[i + 1] - begin;
+        if (size > 0) {
+          builder.Set(i, static_cast<T>(
+                             BatchDot(x_values.subspan(begin, size),
+                                      y_values.subspan(begin, size))));
+        }
+      }
+      return std::move(builder).Build();
+    }
+    DenseGroupOps<DotProductAggregator<T>> agg(&ctx->buffer_factory());
+    return agg.Apply(edge, x, y);
+  }
+
+  template <typename T>
+  absl::StatusOr<OptionalValue<T>> operator()(
+      EvaluationContext* ctx, const DenseArray<T>& x, const DenseArray<T>& y,
+      const DenseArrayGroupScalarEdge& edge) const {
+    static_assert(std::is_floating_point_v<T>);
+    if (x.IsFull() && y.IsFull() && x.size() == edge.child_size() &&
+        y.size() == edge.child_size()) {
+      if (edge.child_size() == 0) {
+        return OptionalValue<T>();
+      }
+      return OptionalValue<T>(
+          static_cast<T>(BatchDot(x.values.span(), y.values.span())));
+    }
+    DenseGroupOps<DotProductAggregator<T>> agg(&ctx->buffer_factory());
+    return agg.Apply(edge, x, y);
+  }
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_QEXPR_OPERATORS_AGGREGATION_DOT_PRODUCT_H_
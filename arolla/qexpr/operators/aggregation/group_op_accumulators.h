@@ -18,7 +18,10 @@
 #define AROLLA_QEXPR_OPERATORS_AGGREGATION_GROUP_OP_ACCUMULATORS_H_
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <limits>
 #include <optional>
@@ -29,6 +32,7 @@
 #include <vector>
 
 #include "absl/base/optimization.h"
+#include "absl/base/prefetch.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -36,10 +40,14 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "arolla/dense_array/dense_array.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/aggregation_ops_interface.h"
 #include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators/aggregation/hash_table_presizer.h"
+#include "arolla/qexpr/operators/aggregation/sketches.h"
 #include "arolla/qexpr/operators/math/arithmetic.h"
+#include "arolla/util/bytes.h"
 #include "arolla/util/meta.h"
 #include "arolla/util/unit.h"
 #include "arolla/util/view_types.h"
@@ -54,6 +62,9 @@ struct SimpleCountAccumulator
   void Reset() final { accumulator = 0; }
   void Add(Unit) final { accumulator += 1; }
   void AddN(int64_t n, Unit) final { accumulator += n; }
+  void Merge(const SimpleCountAccumulator& other) {
+    accumulator += other.accumulator;
+  }
   int64_t GetResult() final { return accumulator; }
 
   int64_t accumulator{0};
@@ -73,6 +84,9 @@ struct CountAccumulator
   void Reset() final { accumulator = 0; }
   void Add(Unit) final { accumulator += 1; }
   void AddN(int64_t n, Unit) final { accumulator += n; }
+  void Merge(const CountAccumulator& other) {
+    accumulator += other.accumulator;
+  }
   OptionalValue<int64_t> GetResult() final {
     if (initial.present) {
       return initial.value + accumulator;
@@ -96,6 +110,9 @@ struct AnyAccumulator : Accumulator<TYPE, OptionalValue<Unit>,
   void Reset() final { accumulator = false; };
   void Add(Unit value) final { accumulator = true; }
   void AddN(int64_t, Unit value) final { accumulator = true; }
+  void Merge(const AnyAccumulator& other) {
+    accumulator = accumulator || other.accumulator;
+  }
   OptionalValue<Unit> GetResult() final { return {accumulator, Unit{}}; }
   bool accumulator;
 };
@@ -114,6 +131,9 @@ struct AllAccumulator
   void AddN(int64_t, OptionalUnit value) final {
     accumulator = accumulator && value.present;
   }
+  void Merge(const AllAccumulator& other) {
+    accumulator = accumulator && other.accumulator;
+  }
   OptionalValue<Unit> GetResult() final { return {accumulator, Unit{}}; }
   bool accumulator;
 };
@@ -134,6 +154,10 @@ struct LogicalAllAccumulator
     has_missing = has_missing || !v.present;
   }
   void AddN(int64_t, OptionalValue<bool> v) final { Add(v); }
+  void Merge(const LogicalAllAccumulator& other) {
+    has_false = has_false || other.has_false;
+    has_missing = has_missing || other.has_missing;
+  }
   OptionalValue<bool> GetResult() final {
     return {has_false || !has_missing, !has_false};
   }
@@ -158,6 +182,10 @@ struct LogicalAnyAccumulator
     has_missing = has_missing || !v.present;
   }
   void AddN(int64_t, OptionalValue<bool> v) final { Add(v); }
+  void Merge(const LogicalAnyAccumulator& other) {
+    has_true = has_true || other.has_true;
+    has_missing = has_missing || other.has_missing;
+  }
   OptionalValue<bool> GetResult() final {
     return {has_true || !has_missing, has_true};
   }
@@ -214,6 +242,15 @@ struct SumAccumulator
                           MultiplyOp()(static_cast<AccumulatorT>(value),
                                        static_cast<AccumulatorT>(n)));
   }
+  // Note that for floating point types the result can differ from the
+  // sequential one due to a different order of additions.
+  void Merge(const SumAccumulator& other) {
+    if (other.accumulator.present) {
+      accumulator = AddOp()(
+          accumulator.value,
+          other.accumulator.value - static_cast<AccumulatorT>(initial.value));
+    }
+  }
   OptionalValue<ValueT> GetResult() final {
     return {accumulator.present, static_cast<ValueT>(accumulator.value)};
   }
@@ -227,6 +264,133 @@ using SumAggregator = SumAccumulator<ValueT, AccumulatorType::kAggregator>;
 template <typename ValueT>
 using SumPartialAccumulator = SumAccumulator<ValueT, AccumulatorType::kPartial>;
 
+// Gathers the values of `table` by the child ids and sums (or averages, if
+// kMean) them within groups, i.e. it is a fused version of
+// math._sum(array.at(table, ids), edge) that does not materialize the
+// gathered array. The result type is double for double tables and float
+// otherwise, so the table can also be stored in 16-bit floating point types
+// (Float16, BFloat16), which are converted to float on read.
+//
+// The table is usually a big literal (e.g. an embedding) and the ids are
+// random, so the accumulator keeps a small queue of ids: each id is prefetched
+// when it is added, and its value is read kPrefetchDistance ids later. The
+// values are still accumulated in the order of the ids, so the result is the
+// same as of the unfused version.
+template <typename TableT, bool kMean>
+class GatherPoolingAggregator final
+    : public Accumulator<
+          AccumulatorType::kAggregator,
+          OptionalValue<std::conditional_t<std::is_same_v<TableT, double>,
+                                           double, float>>,
+          meta::type_list<>, meta::type_list<int64_t>> {
+ public:
+  using ResultT =
+      std::conditional_t<std::is_same_v<TableT, double>, double, float>;
+  static constexpr size_t kPrefetchDistance = 8;
+
+  explicit GatherPoolingAggregator(DenseArray<TableT> table)
+      : table_(std::move(table)) {}
+
+  void Reset() final {
+    sum_ = 0;
+    count_ = 0;
+    // Drop the ids left from the previous group, e.g. if it was abandoned
+    // without calling GetResult().
+    pending_begin_ = 0;
+    pending_count_ = 0;
+  }
+
+  void Add(int64_t id) final {
+    if (pending_count_ == kPrefetchDistance) {
+      AddNow(pending_ids_[pending_begin_]);
+      pending_begin_ = (pending_begin_ + 1) % kPrefetchDistance;
+      --pending_count_;
+    }
+    if (ABSL_PREDICT_TRUE(static_cast<uint64_t>(id) <
+                          static_cast<uint64_t>(table_.size()))) {
+      absl::PrefetchToLocalCache(table_.values.span().data() + id);
+    }
+    pending_ids_[(pending_begin_ + pending_count_) % kPrefetchDistance] = id;
+    ++pending_count_;
+  }
+
+  void AddN(int64_t n, int64_t id) final {
+    Flush();
+    if (std::optional<ResultT> value = Lookup(id)) {
+      sum_ += static_cast<double>(*value) * n;
+      count_ += n;
+    }
+  }
+
+  // Note that for floating point types the result can differ from the
+  // sequential one due to a different order of additions.
+  void Merge(const GatherPoolingAggregator& other) {
+    Flush();
+    sum_ += other.sum_;
+    count_ += other.count_;
+    for (size_t i = 0; i < other.pending_count_; ++i) {
+      AddNow(other.pending_ids_[(other.pending_begin_ + i) %
+                                kPrefetchDistance]);
+    }
+  }
+
+  OptionalValue<ResultT> GetResult() final {
+    Flush();
+    if (count_ == 0) {
+      return std::nullopt;
+    }
+    if constexpr (kMean) {
+      return static_cast<ResultT>(sum_ / count_);
+    } else {
+      return static_cast<ResultT>(sum_);
+    }
+  }
+
+  absl::Status GetStatus() final { return status_; }
+
+ private:
+  std::optional<ResultT> Lookup(int64_t id) {
+    if (ABSL_PREDICT_FALSE(id < 0 || id >= table_.size())) {
+      if (status_.ok()) {
+        status_ = absl::InvalidArgumentError(absl::StrFormat(
+            "array index %d out of range [0, %d)", id, table_.size()));
+      }
+      return std::nullopt;
+    }
+    if (!table_.present(id)) {
+      return std::nullopt;
+    }
+    return static_cast<ResultT>(table_.values[id]);
+  }
+
+  void AddNow(int64_t id) {
+    if (std::optional<ResultT> value = Lookup(id)) {
+      sum_ += static_cast<double>(*value);
+      ++count_;
+    }
+  }
+
+  void Flush() {
+    for (; pending_count_ > 0; --pending_count_) {
+      AddNow(pending_ids_[pending_begin_]);
+      pending_begin_ = (pending_begin_ + 1) % kPrefetchDistance;
+    }
+  }
+
+  DenseArray<TableT> table_;
+  double sum_ = 0;
+  int64_t count_ = 0;
+  int64_t pending_ids_[kPrefetchDistance];
+  size_t pending_begin_ = 0;
+  size_t pending_count_ = 0;
+  absl::Status status_;
+};
+
+template <typename TableT>
+using GatherSumAggregator = GatherPoolingAggregator<TableT, /*kMean=*/false>;
+template <typename TableT>
+using GatherMeanAggregator = GatherPoolingAggregator<TableT, /*kMean=*/true>;
+
 // TODO: renew this class comment.
 template <typename ValueT, AccumulatorType AccumulatorType, typename FunctorT,
           template <typename...> class ResultTypeTraits,
@@ -263,6 +427,20 @@ struct FunctorAccumulator
       for (int64_t i = 0; i < n; ++i) Add(value);
     }
   }
+  // Only supported for idempotent functors (e.g. min and max), where merging
+  // with `initial` accumulated twice doesn't change the result.
+  template <bool kEnabled = IgnoreRepeating,
+            std::enable_if_t<kEnabled, int> = 0>
+  void Merge(const FunctorAccumulator& other) {
+    if (!other.accumulator.present) {
+      return;
+    }
+    if (accumulator.present) {
+      accumulator = FunctorT()(accumulator.value, other.accumulator.value);
+    } else {
+      accumulator = other.accumulator;
+    }
+  }
   OptionalValue<ResultT> GetResult() final {
     return {accumulator.present, static_cast<ResultT>(accumulator.value)};
   }
@@ -323,6 +501,110 @@ struct InverseCdfAccumulator
   float cdf;
 };
 
+// Approximate version of InverseCdfAccumulator with bounded memory.
+//
+// Values are kept in a stack of compactors (a simplified KLL sketch). All the
+// compactors have capacity `kCompactorSize`; a value stored at level `h`
+// represents 2^h input values. When a compactor gets full, it is sorted and
+// every other element is promoted to the next level. The offset alternates
+// between compactions, so the result is deterministic.
+//
+// The memory is O(kCompactorSize * log(N / kCompactorSize)) and the rank error
+// is O(N * log(N / kCompactorSize) / kCompactorSize). For groups with fewer
+// than kCompactorSize values, the result is exactly the same as for
+// InverseCdfAccumulator. If any value is NaN, the result is NaN.
+template <typename T>
+struct ApproxInverseCdfAccumulator
+    : Accumulator<AccumulatorType::kAggregator, OptionalValue<T>,
+                  meta::type_list<>, meta::type_list<T>> {
+  static constexpr size_t kCompactorSize = 256;
+
+  explicit ApproxInverseCdfAccumulator(float cdf) : cdf(cdf) {}
+
+  void Reset() final {
+    // Keep the allocated compactors to reuse them for the next group.
+    for (auto& compactor : compactors) {
+      compactor.clear();
+    }
+    count = 0;
+    has_nan = false;
+    // Otherwise the result for a group would depend on the previous groups.
+    compaction_offset = 0;
+  };
+
+  void Add(view_type_t<T> v) final {
+    ++count;
+    if constexpr (std::numeric_limits<T>::has_quiet_NaN) {
+      if (ABSL_PREDICT_FALSE(std::isnan(v))) {
+        has_nan = true;
+        return;
+      }
+    }
+    if (compactors.empty()) {
+      compactors.emplace_back().reserve(kCompactorSize);
+    }
+    compactors[0].push_back(v);
+    for (size_t level = 0; compactors[level].size() >= kCompactorSize;
+         ++level) {
+      Compact(level);
+    }
+  }
+
+  OptionalValue<view_type_t<T>> GetResult() final {
+    if (count == 0) {
+      return std::nullopt;
+    }
+    if constexpr (std::numeric_limits<T>::has_quiet_NaN) {
+      if (has_nan) {
+        return std::numeric_limits<T>::quiet_NaN();
+      }
+    }
+    // The same offset as in InverseCdfAccumulator.
+    int64_t offset = static_cast<int64_t>(ceil(cdf * count) - 1);
+    offset = std::clamp<int64_t>(offset, 0, count - 1);
+    weighted_values.clear();
+    for (size_t level = 0; level < compactors.size(); ++level) {
+      for (const auto& v : compactors[level]) {
+        weighted_values.emplace_back(v, int64_t{1} << level);
+      }
+    }
+    std::sort(weighted_values.begin(), weighted_values.end());
+    int64_t rank = 0;
+    for (const auto& [v, weight] : weighted_values) {
+      rank += weight;
+      if (rank > offset) {
+        return v;
+      }
+    }
+    // Unreachable: the compactions preserve the total weight.
+    return weighted_values.back().first;
+  }
+
+  void Compact(size_t level) {
+    if (level + 1 == compactors.size()) {
+      compactors.emplace_back().reserve(kCompactorSize);
+    }
+    auto& compactor = compactors[level];
+    auto& next_compactor = compactors[level + 1];
+    std::sort(compactor.begin(), compactor.end());
+    for (size_t i = compaction_offset; i < compactor.size(); i += 2) {
+      next_compactor.push_back(compactor[i]);
+    }
+    compaction_offset ^= 1;
+    compactor.clear();
+  }
+
+  std::vector<std::vector<view_type_t<T>>> compactors;
+  // A buffer to gather all the weighted values in GetResult.
+  std::vector<std::pair<view_type_t<T>, int64_t>> weighted_values;
+  // Total number of values added since the last Reset.
+  int64_t count = 0;
+  bool has_nan = false;
+  size_t compaction_offset = 0;
+  // CDF values to use for each result.
+  float cdf;
+};
+
 template <typename T>
 class CollapseAccumulator
     : public Accumulator<AccumulatorType::kAggregator, OptionalValue<T>,
@@ -354,6 +636,21 @@ class CollapseAccumulator
 
   void AddN(int64_t, view_type_t<T> value) final { return Add(value); }
 
+  void Merge(const CollapseAccumulator& other) {
+    if (!other.present_) {
+      return;
+    }
+    if (!present_) {
+      value_ = other.value_;
+      present_ = true;
+      all_equal_ = other.all_equal_;
+      is_nan_ = other.is_nan_;
+      return;
+    }
+    all_equal_ = all_equal_ && other.all_equal_ && is_nan_ == other.is_nan_ &&
+                 (is_nan_ || other.value_ == value_);
+  }
+
   OptionalValue<view_type_t<T>> GetResult() final {
     if (present_ && all_equal_) {
       return value_;
@@ -464,12 +761,19 @@ class GroupByAccumulator final
   // group_counter is supposed to be shared across several instances of
   // GroupByAccumulator that process different input groups. Needed to avoid
   // group_id collisions in the output mapping.
-  explicit GroupByAccumulator(int64_t* group_counter)
-      : group_counter_(group_counter), status_(absl::OkStatus()) {}
+  //
+  // If `group_size_hint` is the number of values in each group (e.g. when
+  // there is only one group), it is used to pre-size the index.
+  explicit GroupByAccumulator(int64_t* group_counter,
+                              int64_t group_size_hint = 0)
+      : group_counter_(group_counter),
+        presizer_(group_size_hint),
+        status_(absl::OkStatus()) {}
   void Reset() final {
     // `clear` is not used in order to reuse memory.
     unique_values_index_.erase(unique_values_index_.begin(),
                                unique_values_index_.end());
+    presizer_.Reset();
   }
   void Add(view_type_t<T> v) final {
     if constexpr (std::is_floating_point_v<T>) {
@@ -483,6 +787,7 @@ class GroupByAccumulator final
         unique_values_index_.try_emplace(v, *group_counter_);
     if (inserted) (*group_counter_)++;
     next_result_ = iter->second;
+    presizer_.Update(unique_values_index_);
   }
   int64_t GetResult() final { return next_result_; }
 
@@ -492,6 +797,7 @@ class GroupByAccumulator final
   absl::flat_hash_map<view_type_t<T>, int64_t> unique_values_index_;
   int64_t* group_counter_;
   int64_t next_result_;
+  HashTablePresizer presizer_;
   absl::Status status_;
 };
 
@@ -630,6 +936,45 @@ class WeightedAverageAccumulator
   AccumulatorT weighted_value_sum_, weight_sum_;
 };
 
+// Implements math._dot: sum of x * y over the rows where both are present.
+// The result is missing if there are no such rows. See also DenseArrayDotOp
+// that has a vectorized implementation for full DenseArrays.
+template <typename ValueT>
+class DotProductAggregator
+    : public Accumulator<AccumulatorType::kAggregator, OptionalValue<ValueT>,
+                         meta::type_list<>, meta::type_list<ValueT, ValueT>> {
+  using AccumulatorT = typename WideAccumulator<ValueT>::type;
+
+ public:
+  void Reset() final {
+    sum_ = 0;
+    present_ = false;
+  };
+
+  void Add(ValueT x, ValueT y) final {
+    sum_ += static_cast<AccumulatorT>(x) * static_cast<AccumulatorT>(y);
+    present_ = true;
+  }
+
+  void AddN(int64_t n, ValueT x, ValueT y) final {
+    sum_ += static_cast<AccumulatorT>(x) * static_cast<AccumulatorT>(y) * n;
+    present_ = true;
+  }
+
+  void Merge(const DotProductAggregator& other) {
+    sum_ += other.sum_;
+    present_ = present_ || other.present_;
+  }
+
+  OptionalValue<ValueT> GetResult() final {
+    return {present_, static_cast<ValueT>(sum_)};
+  }
+
+ private:
+  AccumulatorT sum_ = 0;
+  bool present_ = false;
+};
+
 template <typename T>
 struct CDFTypeTraits {
   using return_type = float;
@@ -732,10 +1077,20 @@ class OrdinalRankAccumulator
           [](const Element& elem) { return !std::isnan(elem.value); });
     }
 
-    if (descending_) {
-      std::sort(elems_.begin(), sort_end, DescendingComparator());
+    if constexpr (kCanUseRadixSort) {
+      if (sort_end - elems_.begin() >= kRadixSortThreshold) {
+        RadixSort(sort_end - elems_.begin());
+      } else if (descending_) {
+        std::sort(elems_.begin(), sort_end, DescendingComparator());
+      } else {
+        std::sort(elems_.begin(), sort_end, AscendingComparator());
+      }
     } else {
-      std::sort(elems_.begin(), sort_end, AscendingComparator());
+      if (descending_) {
+        std::sort(elems_.begin(), sort_end, DescendingComparator());
+      } else {
+        std::sort(elems_.begin(), sort_end, AscendingComparator());
+      }
     }
 
     int64_t current_rank = 0;
@@ -753,6 +1108,82 @@ class OrdinalRankAccumulator
     int64_t position;
   };
 
+  // LSD radix sort is used for numeric values and integral tie breakers on
+  // large groups. It gives the same order as the comparators below.
+  static constexpr bool kCanUseRadixSort =
+      std::is_arithmetic_v<T> && std::is_integral_v<TieBreaker>;
+  static constexpr int64_t kRadixSortThreshold = 1024;
+
+  // Returns an unsigned key that has the same order as `value`. -0.0 and 0.0
+  // get the same key. NaNs must be excluded beforehand.
+  template <typename V>
+  static uint64_t RadixKey(V value) {
+    if constexpr (std::is_floating_point_v<V>) {
+      using Bits = std::conditional_t<sizeof(V) == 4, uint32_t, uint64_t>;
+      static_assert(sizeof(V) == sizeof(Bits));
+      if (value == 0) {
+        value = 0;  // Normalize -0.0.
+      }
+      Bits bits;
+      std::memcpy(&bits, &value, sizeof(V));
+      constexpr Bits kSignBit = Bits{1} << (sizeof(Bits) * 8 - 1);
+      return (bits & kSignBit) ? Bits(~bits) : Bits(bits | kSignBit);
+    } else if constexpr (std::is_signed_v<V>) {
+      using U = std::make_unsigned_t<V>;
+      constexpr U kSignBit = U{1} << (sizeof(U) * 8 - 1);
+      return static_cast<U>(static_cast<U>(value) ^ kSignBit);
+    } else {
+      return static_cast<uint64_t>(value);
+    }
+  }
+
+  // Sorts the first `size` elements by (value, tie_breaker, position), with
+  // value order reversed if descending_. Each pass is stable, so sorting by
+  // tie_breaker bytes and then by value bytes (least significant first) keeps
+  // the original position order between equal keys.
+  void RadixSort(int64_t size) {
+    radix_buffer_.resize(size);
+    Element* src = elems_.data();
+    Element* dst = radix_buffer_.data();
+    auto pass = [&](auto get_key, int shift) {
+      int64_t offsets[256] = {0};
+      for (int64_t i = 0; i < size; ++i) {
+        ++offsets[(get_key(src[i]) >> shift) & 0xFF];
+      }
+      // Skip the pass if all the elements have the same digit.
+      if (offsets[(get_key(src[0]) >> shift) & 0xFF] == size) {
+        return;
+      }
+      int64_t total = 0;
+      for (int64_t& offset : offsets) {
+        int64_t count = offset;
+        offset = total;
+        total += count;
+      }
+      for (int64_t i = 0; i < size; ++i) {
+        dst[offsets[(get_key(src[i]) >> shift) & 0xFF]++] = src[i];
+      }
+      std::swap(src, dst);
+    };
+    auto tie_breaker_key = [](const Element& e) {
+      return RadixKey(e.tie_breaker);
+    };
+    for (int shift = 0; shift < 8 * static_cast<int>(sizeof(TieBreaker));
+         shift += 8) {
+      pass(tie_breaker_key, shift);
+    }
+    const uint64_t value_mask = descending_ ? ~uint64_t{0} : 0;
+    auto value_key = [value_mask](const Element& e) {
+      return RadixKey(e.value) ^ value_mask;
+    };
+    for (int shift = 0; shift < 8 * static_cast<int>(sizeof(T)); shift += 8) {
+      pass(value_key, shift);
+    }
+    if (src != elems_.data()) {
+      std::copy(src, src + size, elems_.data());
+    }
+  }
+
   struct AscendingComparator {
     bool operator()(const Element& a, const Element& b) const {
       return std::tie(a.value, a.tie_breaker, a.position) <
@@ -785,6 +1216,8 @@ class OrdinalRankAccumulator
   int64_t return_id_;
   bool descending_;
   std::vector<Element> elems_;
+  // Scratch space for RadixSort.
+  std::vector<Element> radix_buffer_;
   std::vector<int64_t> ranks_;
 };
 
@@ -845,6 +1278,272 @@ class DenseRankAccumulator
   std::vector<int64_t> ranks_;
 };
 
+// Implements array._top_k. Returns the ordinal rank of a child row (in the
+// same order as OrdinalRankAccumulator, so ties are resolved by tie_breaker
+// and then by the row position) if it is less than `k`, and missing
+// otherwise. The values and child ids of the selected rows can be obtained by
+// filtering on the result presence.
+//
+// Unlike OrdinalRankAccumulator, only the `k` selected elements are sorted
+// after std::nth_element, so a group of size N takes O(N + k log k) time.
+template <typename T, typename TieBreaker>
+class TopKAccumulator
+    : public Accumulator<AccumulatorType::kFull, OptionalValue<int64_t>,
+                         meta::type_list<>, meta::type_list<T, TieBreaker>> {
+ public:
+  explicit TopKAccumulator(int64_t k, bool descending = false)
+      : k_(k), descending_(descending) {}
+
+  void Reset() final {
+    elems_.clear();
+    return_id_ = 0;
+  };
+
+  void Add(view_type_t<T> value, view_type_t<TieBreaker> tie_breaker) final {
+    elems_.push_back({value, tie_breaker, static_cast<int64_t>(elems_.size())});
+  }
+
+  void FinalizeFullGroup() final {
+    ranks_.assign(elems_.size(), std::nullopt);
+    if (k_ <= 0) {
+      return;
+    }
+    // NaNs go after all the other values in the original order, like in
+    // OrdinalRankAccumulator.
+    auto sort_end = elems_.end();
+    if constexpr (std::numeric_limits<T>::has_quiet_NaN) {
+      sort_end = std::stable_partition(
+          elems_.begin(), sort_end,
+          [](const Element& elem) { return !std::isnan(elem.value); });
+    }
+    if (descending_) {
+      PartialSort(sort_end, DescendingComparator());
+    } else {
+      PartialSort(sort_end, AscendingComparator());
+    }
+    const int64_t selected_count =
+        std::min<int64_t>(k_, static_cast<int64_t>(elems_.size()));
+    for (int64_t i = 0; i < selected_count; ++i) {
+      ranks_[elems_[i].position] = i;
+    }
+  }
+
+  OptionalValue<int64_t> GetResult() final { return ranks_[return_id_++]; }
+
+  absl::Status GetStatus() final {
+    if (k_ < 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("k must be non-negative, got %d", k_));
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  struct Element {
+    view_type_t<T> value;
+    view_type_t<TieBreaker> tie_breaker;
+    int64_t position;
+  };
+
+  using ElementIterator = typename std::vector<Element>::iterator;
+
+  // Moves the smallest min(k_, size) elements of [begin, end) according to
+  // `comparator` to the beginning of the range in sorted order.
+  template <typename Comparator>
+  void PartialSort(ElementIterator end, Comparator comparator) {
+    auto begin = elems_.begin();
+    if (end - begin > k_) {
+      std::nth_element(begin, begin + k_, end, comparator);
+      end = begin + k_;
+    }
+    std::sort(begin, end, comparator);
+  }
+
+  struct AscendingComparator {
+    bool operator()(const Element& a, const Element& b) const {
+      return std::tie(a.value, a.tie_breaker, a.position) <
+             std::tie(b.value, b.tie_breaker, b.position);
+    }
+  };
+
+  // See OrdinalRankAccumulator::DescendingComparator.
+  struct DescendingComparator {
+    bool operator()(const Element& a, const Element& b) const {
+      return std::tie(a.value, b.tie_breaker, b.position) >
+             std::tie(b.value, a.tie_breaker, a.position);
+    }
+  };
+
+  int64_t k_;
+  bool descending_;
+  int64_t return_id_ = 0;
+  std::vector<Element> elems_;
+  std::vector<OptionalValue<int64_t>> ranks_;
+};
+
+// Implements array._approx_count_distinct: the approximate number of distinct
+// values in the group, computed with HyperLogLogSketch.
+template <typename T>
+class ApproxCountDistinctAggregator
+    : public Accumulator<AccumulatorType::kAggregator, int64_t,
+                         meta::type_list<>, meta::type_list<T>> {
+ public:
+  static absl::StatusOr<ApproxCountDistinctAggregator> Create(
+      int64_t precision) {
+    ASSIGN_OR_RETURN(auto sketch, HyperLogLogSketch::Create(precision));
+    return ApproxCountDistinctAggregator(std::move(sketch));
+  }
+
+  void Reset() final { sketch_.Clear(); }
+
+  void Add(view_type_t<T> value) final {
+    sketch_.AddHash(StableSketchHash(value));
+  }
+
+  void AddN(int64_t, view_type_t<T> value) final { Add(value); }
+
+  void Merge(const ApproxCountDistinctAggregator& other) {
+    sketch_.Merge(other.sketch_);
+  }
+
+  int64_t GetResult() final { return sketch_.Estimate(); }
+
+ private:
+  explicit ApproxCountDistinctAggregator(HyperLogLogSketch sketch)
+      : sketch_(std::move(sketch)) {}
+
+  HyperLogLogSketch sketch_;
+};
+
+// Implements array._hll_sketch: returns the serialized HyperLogLogSketch of
+// the group values. The sketches can be stored, combined with
+// array._hll_merge, and evaluated with array._hll_estimate.
+template <typename T>
+class HyperLogLogSketchAggregator
+    : public Accumulator<AccumulatorType::kAggregator, Bytes, meta::type_list<>,
+                         meta::type_list<T>> {
+ public:
+  static absl::StatusOr<HyperLogLogSketchAggregator> Create(
+      int64_t precision) {
+    ASSIGN_OR_RETURN(auto sketch, HyperLogLogSketch::Create(precision));
+    return HyperLogLogSketchAggregator(std::move(sketch));
+  }
+
+  void Reset() final { sketch_.Clear(); }
+
+  void Add(view_type_t<T> value) final {
+    sketch_.AddHash(StableSketchHash(value));
+  }
+
+  void AddN(int64_t, view_type_t<T> value) final { Add(value); }
+
+  absl::string_view GetResult() final {
+    // Must return a reference to a member field, not a local.
+    result_ = sketch_.Serialize();
+    return result_;
+  }
+
+ private:
+  explicit HyperLogLogSketchAggregator(HyperLogLogSketch sketch)
+      : sketch_(std::move(sketch)) {}
+
+  HyperLogLogSketch sketch_;
+  std::string result_;
+};
+
+// Implements array._hll_merge: merges serialized HyperLogLogSketches with the
+// given precision.
+class HyperLogLogMergeAggregator
+    : public Accumulator<AccumulatorType::kAggregator, Bytes, meta::type_list<>,
+                         meta::type_list<Bytes>> {
+ public:
+  static absl::StatusOr<HyperLogLogMergeAggregator> Create(int64_t precision) {
+    ASSIGN_OR_RETURN(auto sketch, HyperLogLogSketch::Create(precision));
+    return HyperLogLogMergeAggregator(std::move(sketch));
+  }
+
+  void Reset() final { sketch_.Clear(); }
+
+  void Add(absl::string_view serialized_sketch) final {
+    auto sketch = HyperLogLogSketch::Deserialize(serialized_sketch);
+    if (!sketch.ok()) {
+      status_.Update(sketch.status());
+    } else if (sketch->precision() != sketch_.precision()) {
+      status_.Update(absl::InvalidArgumentError(absl::StrFormat(
+          "expected HyperLogLog sketches with precision %d, got %d",
+          sketch_.precision(), sketch->precision())));
+    } else {
+      sketch_.Merge(*sketch);
+    }
+  }
+
+  void AddN(int64_t, absl::string_view serialized_sketch) final {
+    Add(serialized_sketch);
+  }
+
+  void Merge(const HyperLogLogMergeAggregator& other) {
+    sketch_.Merge(other.sketch_);
+    status_.Update(other.status_);
+  }
+
+  absl::string_view GetResult() final {
+    result_ = sketch_.Serialize();
+    return result_;
+  }
+
+  absl::Status GetStatus() final { return status_; }
+
+ private:
+  explicit HyperLogLogMergeAggregator(HyperLogLogSketch sketch)
+      : sketch_(std::move(sketch)) {}
+
+  HyperLogLogSketch sketch_;
+  std::string result_;
+  absl::Status status_;
+};
+
+// Implements array._approx_most_frequent: returns the approximately most
+// frequent value in the group, using SpaceSavingSketch with `capacity`
+// counters. A value that occurs in more than 1 / capacity of the group rows
+// is never missed.
+template <typename T>
+class ApproxMostFrequentAggregator
+    : public Accumulator<AccumulatorType::kAggregator, OptionalValue<T>,
+                         meta::type_list<>, meta::type_list<T>> {
+ public:
+  static absl::StatusOr<ApproxMostFrequentAggregator> Create(
+      int64_t capacity) {
+    if (capacity <= 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("capacity must be positive, got %d", capacity));
+    }
+    return ApproxMostFrequentAggregator(capacity);
+  }
+
+  void Reset() final { sketch_.Clear(); }
+
+  void Add(view_type_t<T> value) final { sketch_.Add(value); }
+
+  void AddN(int64_t n, view_type_t<T> value) final { sketch_.Add(value, n); }
+
+  void Merge(const ApproxMostFrequentAggregator& other) {
+    sketch_.Merge(other.sketch_);
+  }
+
+  OptionalValue<view_type_t<T>> GetResult() final {
+    auto result = sketch_.MostFrequent();
+    if (!result.has_value()) {
+      return std::nullopt;
+    }
+    return *result;
+  }
+
+ private:
+  explicit ApproxMostFrequentAggregator(int64_t capacity) : sketch_(capacity) {}
+
+  SpaceSavingSketch<T> sketch_;
+};
+
 template <typename T>
 class MedianAggregator
     : public Accumulator<AccumulatorType::kAggregator, OptionalValue<T>,
@@ -0,0 +1,195 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QEXPR_OPERATORS_AGGREGATION_GROUP_STATS_H_
+#define AROLLA_QEXPR_OPERATORS_AGGREGATION_GROUP_STATS_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/edge.h"
+#include "arolla/dense_array/ops/util.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators/aggregation/group_op_accumulators.h"
+#include "arolla/util/meta.h"
+#include "arolla/util/status.h"
+#include "arolla/util/unit.h"
+
+namespace arolla {
+
+// math._group_stats(x, edge, initial, stats) operator.
+//
+// Computes math._sum(x, edge, initial), array._count(core.has._array(x), edge),
+// math._min(x, edge) and math._max(x, edge) in a single pass over `x`. The
+// expression compiler uses it to fuse sibling aggregations over the same input
+// and edge (see group_op_fusion.h), the results are identical to the ones of
+// the separate operators.
+//
+// Bit i of `stats` requests the i-th field of the result. Only the requested
+// statistics are computed, the other fields are filled with missing values.
+struct DenseArrayGroupStatsOp {
+  template <typename T>
+  using Result = std::tuple<DenseArray<T>, DenseArray<int64_t>, DenseArray<T>,
+                            DenseArray<T>>;
+
+  static constexpr int32_t kSum = 1 << 0;
+  static constexpr int32_t kCount = 1 << 1;
+  static constexpr int32_t kMin = 1 << 2;
+  static constexpr int32_t kMax = 1 << 3;
+  static constexpr int32_t kAllStats = kSum | kCount | kMin | kMax;
+
+  template <typename T>
+  absl::StatusOr<Result<T>> operator()(EvaluationContext* ctx,
+                                       const DenseArray<T>& x,
+                                       const DenseArrayEdge& edge,
+                                       const OptionalValue<T>& initial,
+                                       int32_t stats) const {
+    if (x.size() != edge.child_size()) {
+      return SizeMismatchError({edge.child_size(), x.size()});
+    }
+    if ((stats & ~kAllStats) != 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("unexpected stats: %d", stats));
+    }
+    return Dispatch(ctx, x, edge, initial, stats,
+                    std::make_index_sequence<kAllStats + 1>());
+  }
+
+ private:
+  // Instantiates Compute for every combination of the statistics, so that the
+  // loops over `x` contain only the requested accumulators.
+  template <typename T, size_t... kStats>
+  static absl::StatusOr<Result<T>> Dispatch(EvaluationContext* ctx,
+                                            const DenseArray<T>& x,
+                                            const DenseArrayEdge& edge,
+                                            const OptionalValue<T>& initial,
+                                            int32_t stats,
+                                            std::index_sequence<kStats...>) {
+    using ComputeFn = absl::StatusOr<Result<T>> (*)(
+        EvaluationContext*, const DenseArray<T>&, const DenseArrayEdge&,
+        const OptionalValue<T>&);
+    static constexpr ComputeFn kComputeFns[] = {&Compute<kStats, T>...};
+    return kComputeFns[stats](ctx, x, edge, initial);
+  }
+
+  template <int32_t kStats, typename T>
+  static absl::StatusOr<Result<T>> Compute(EvaluationContext* ctx,
+                                           const DenseArray<T>& x,
+                                           const DenseArrayEdge& edge,
+                                           const OptionalValue<T>& initial) {
+    const int64_t parent_size = edge.parent_size();
+    std::vector<GroupStats<kStats, T>> stats(parent_size,
+                                             GroupStats<kStats, T>(initial));
+    for (auto& group : stats) {
+      group.Reset();
+    }
+    switch (edge.edge_type()) {
+      case DenseArrayEdge::SPLIT_POINTS: {
+        DenseArraySplitPoints splits(edge);
+        for (int64_t parent_id = 0; parent_id < parent_size; ++parent_id) {
+          GroupStats<kStats, T>& group = stats[parent_id];
+          dense_ops_internal::DenseOpsUtil<meta::type_list<T>>::Iterate(
+              [&](int64_t, bool valid, T value) {
+                if (valid) group.Add(value);
+              },
+              splits[parent_id], splits[parent_id + 1], x);
+        }
+        break;
+      }
+      case DenseArrayEdge::MAPPING: {
+        dense_ops_internal::DenseOpsUtil<meta::type_list<int64_t, T>>::Iterate(
+            [&](int64_t, bool valid, int64_t parent_id, T value) {
+              if (valid) stats[parent_id].Add(value);
+            },
+            0, x.size(), edge.edge_values(), x);
+        break;
+      }
+      default:
+        return absl::InvalidArgumentError("unsupported edge type");
+    }
+
+    RawBufferFactory& factory = ctx->buffer_factory();
+    return Result<T>(
+        BuildField<T, (kStats & kSum) != 0>(
+            stats, factory, [](auto& group) { return group.sum.GetResult(); }),
+        BuildField<int64_t, (kStats & kCount) != 0>(
+            stats, factory,
+            [](auto& group) { return group.count.GetResult(); }),
+        BuildField<T, (kStats & kMin) != 0>(
+            stats, factory, [](auto& group) { return group.min.GetResult(); }),
+        BuildField<T, (kStats & kMax) != 0>(
+            stats, factory, [](auto& group) { return group.max.GetResult(); }));
+  }
+
+  // Collects the results returned by `get_result` for every group, or returns
+  // an array of missing values if the statistic is not requested.
+  template <typename ValueT, bool kRequested, typename Group,
+            typename GetResultFn>
+  static DenseArray<ValueT> BuildField(std::vector<Group>& stats,
+                                       RawBufferFactory& factory,
+                                       GetResultFn get_result) {
+    const int64_t parent_size = stats.size();
+    if constexpr (!kRequested) {
+      return CreateEmptyDenseArray<ValueT>(parent_size, &factory);
+    } else {
+      DenseArrayBuilder<ValueT> builder(parent_size, &factory);
+      for (int64_t parent_id = 0; parent_id < parent_size; ++parent_id) {
+        builder.Set(parent_id, get_result(stats[parent_id]));
+      }
+      return std::move(builder).Build();
+    }
+  }
+
+  template <int32_t kStats, typename T>
+  struct GroupStats {
+    static constexpr bool kHasSum = (kStats & kSum) != 0;
+    static constexpr bool kHasCount = (kStats & kCount) != 0;
+    static constexpr bool kHasMin = (kStats & kMin) != 0;
+    static constexpr bool kHasMax = (kStats & kMax) != 0;
+
+    explicit GroupStats(const OptionalValue<T>& initial) : sum(initial) {}
+
+    void Reset() {
+      if constexpr (kHasSum) sum.Reset();
+      if constexpr (kHasCount) count.Reset();
+      if constexpr (kHasMin) min.Reset();
+      if constexpr (kHasMax) max.Reset();
+    }
+
+    void Add(T value) {
+      if constexpr (kHasSum) sum.Add(value);
+      if constexpr (kHasCount) count.Add(kUnit);
+      if constexpr (kHasMin) min.Add(value);
+      if constexpr (kHasMax) max.Add(value);
+    }
+
+    SumAggregator<T> sum;
+    SimpleCountAggregator count;
+    MinAggregator<T> min;
+    MaxAggregator<T> max;
+  };
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_QEXPR_OPERATORS_AGGREGATION_GROUP_STATS_H_
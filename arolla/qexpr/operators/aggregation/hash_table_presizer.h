@@ -0,0 +1,102 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QEXPR_OPERATORS_AGGREGATION_HASH_TABLE_PRESIZER_H_
+#define AROLLA_QEXPR_OPERATORS_AGGREGATION_HASH_TABLE_PRESIZER_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "absl/base/optimization.h"
+
+namespace arolla {
+
+// Estimates the number of distinct values in a sequence of `size` values,
+// given that its first `prefix_size` values contain `prefix_distinct` distinct
+// ones. Assumes that the values are drawn uniformly from an unknown number N
+// of distinct values, so that a prefix of size m is expected to contain
+// N * (1 - exp(-m / N)) of them.
+inline int64_t EstimateDistinctCount(int64_t prefix_distinct,
+                                     int64_t prefix_size, int64_t size) {
+  if (prefix_distinct >= prefix_size) {
+    return size;
+  }
+  const double d = prefix_distinct;
+  const double m = prefix_size;
+  // The expected number of distinct values in the prefix is monotonic in N, so
+  // we find N by bisection (in the logarithmic scale).
+  double lo = d;
+  double hi = 1e18;
+  for (int i = 0; i < 64; ++i) {
+    double mid = std::sqrt(lo * hi);
+    if (mid * -std::expm1(-m / mid) < d) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  double estimate = lo * -std::expm1(-static_cast<double>(size) / lo);
+  return static_cast<int64_t>(std::min<double>(estimate, size));
+}
+
+// Reserves the capacity of a hash table that collects the distinct values of a
+// sequence of the known size.
+//
+// Reserving `size` elements upfront makes the low cardinality cases several
+// times slower (the table does not fit into cache anymore), while not
+// reserving anything causes log(N) rehashings of the table in the high
+// cardinality cases. So we look at the number of distinct values in a prefix
+// of the sequence and reserve the table for the estimated total.
+//
+// Usage:
+//   HashTablePresizer presizer(values.size());
+//   for (const auto& value : values) {
+//     table.insert(value);
+//     presizer.Update(table);
+//   }
+//
+class HashTablePresizer {
+ public:
+  // The sequences shorter than kMinProbeSize * kProbeFraction are processed
+  // without pre-sizing.
+  static constexpr int64_t kMinProbeSize = 1024;
+  static constexpr int64_t kProbeFraction = 16;
+
+  explicit HashTablePresizer(int64_t size)
+      : size_(size),
+        probe_size_(size / kProbeFraction >= kMinProbeSize
+                        ? size / kProbeFraction
+                        : -1) {}
+
+  // Restarts the sequence, e.g. when the table is reused for another group.
+  void Reset() { processed_ = 0; }
+
+  // Must be called after processing every value of the sequence.
+  template <typename Table>
+  void Update(Table& table) {
+    if (ABSL_PREDICT_FALSE(++processed_ == probe_size_)) {
+      table.reserve(EstimateDistinctCount(table.size(), processed_, size_));
+    }
+  }
+
+ private:
+  int64_t size_;
+  int64_t probe_size_;
+  int64_t processed_ = 0;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_QEXPR_OPERATORS_AGGREGATION_HASH_TABLE_PRESIZER_H_
@@ -0,0 +1,239 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qexpr/operators/aggregation/sketches.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/numeric/bits.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "cityhash/city.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+namespace {
+
+constexpr uint64_t kStringHashSeed = 0x9be4a5fba2d83b1bULL;
+
+// Serialization format:
+//   byte 0: format version;
+//   byte 1: precision;
+//   byte 2: kSparse or kDense;
+//   kSparse: little-endian 64-bit hashes;
+//   kDense: 2^precision registers.
+constexpr char kFormatVersion = 1;
+constexpr char kSparse = 0;
+constexpr char kDense = 1;
+constexpr size_t kHeaderSize = 3;
+
+}  // namespace
+
+uint64_t StableSketchHash(uint64_t bits) {
+  // The finalizer of MurmurHash3.
+  bits ^= bits >> 33;
+  bits *= 0xff51afd7ed558ccdULL;
+  bits ^= bits >> 33;
+  bits *= 0xc4ceb9fe1a85ec53ULL;
+  bits ^= bits >> 33;
+  return bits;
+}
+
+uint64_t StableSketchHash(absl::string_view value) {
+  // HyperLogLog relies on the high bits being uniform, so we apply the
+  // finalizer on top of CityHash.
+  return StableSketchHash(static_cast<uint64_t>(cityhash::CityHash64WithSeed(
+      value.data(), value.size(), kStringHashSeed)));
+}
+
+HyperLogLogSketch::HyperLogLogSketch(int precision) : precision_(precision) {
+  DCHECK_GE(precision, kMinPrecision);
+  DCHECK_LE(precision, kMaxPrecision);
+}
+
+absl::StatusOr<HyperLogLogSketch> HyperLogLogSketch::Create(
+    int64_t precision) {
+  if (precision < kMinPrecision || precision > kMaxPrecision) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("precision must be in range [%d, %d], got %d",
+                        kMinPrecision, kMaxPrecision, precision));
+  }
+  return HyperLogLogSketch(precision);
+}
+
+void HyperLogLogSketch::Clear() {
+  hashes_.clear();
+  registers_.clear();
+}
+
+void HyperLogLogSketch::AddHash(uint64_t hash) {
+  if (!sparse()) {
+    AddHashToRegisters(hash);
+    return;
+  }
+  hashes_.push_back(hash);
+  // The sparse mode keeps at most sparse_limit distinct hashes (the memory
+  // of the registers) plus as many not yet deduplicated ones.
+  const size_t sparse_limit = (size_t{1} << precision_) / sizeof(uint64_t);
+  if (hashes_.size() >= 2 * sparse_limit) {
+    hashes_ = SortedUniqueHashes();
+    if (hashes_.size() > sparse_limit) {
+      Densify();
+    }
+  }
+}
+
+void HyperLogLogSketch::AddHashToRegisters(uint64_t hash) {
+  const size_t index = hash >> (64 - precision_);
+  const uint64_t rest = hash << precision_;
+  const uint8_t rank =
+      rest == 0 ? 64 - precision_ + 1
+                : std::min(absl::countl_zero(rest) + 1, 64 - precision_ + 1);
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+std::vector<uint64_t> HyperLogLogSketch::SortedUniqueHashes() const {
+  std::vector<uint64_t> result = hashes_;
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+void HyperLogLogSketch::Densify() {
+  registers_.assign(size_t{1} << precision_, 0);
+  for (uint64_t hash : hashes_) {
+    AddHashToRegisters(hash);
+  }
+  hashes_.clear();
+  hashes_.shrink_to_fit();
+}
+
+void HyperLogLogSketch::Merge(const HyperLogLogSketch& other) {
+  DCHECK_EQ(precision_, other.precision_);
+  if (other.sparse()) {
+    for (uint64_t hash : other.hashes_) {
+      AddHash(hash);
+    }
+    return;
+  }
+  if (sparse()) {
+    Densify();
+  }
+  for (size_t i = 0; i < registers_.size(); ++i) {
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+  }
+}
+
+int64_t HyperLogLogSketch::Estimate() const {
+  if (sparse()) {
+    return SortedUniqueHashes().size();
+  }
+  const double m = registers_.size();
+  double inverse_sum = 0;
+  int64_t zero_count = 0;
+  for (uint8_t r : registers_) {
+    inverse_sum += std::ldexp(1.0, -r);
+    zero_count += (r == 0);
+  }
+  double alpha;
+  switch (registers_.size()) {
+    case 16:
+      alpha = 0.673;
+      break;
+    case 32:
+      alpha = 0.697;
+      break;
+    case 64:
+      alpha = 0.709;
+      break;
+    default:
+      alpha = 0.7213 / (1 + 1.079 / m);
+  }
+  double estimate = alpha * m * m / inverse_sum;
+  // Linear counting is more precise for small cardinalities.
+  if (estimate <= 2.5 * m && zero_count > 0) {
+    estimate = m * std::log(m / zero_count);
+  }
+  return std::llround(estimate);
+}
+
+std::string HyperLogLogSketch::Serialize() const {
+  std::string result = {kFormatVersion, static_cast<char>(precision_),
+                        sparse() ? kSparse : kDense};
+  if (sparse()) {
+    std::vector<uint64_t> hashes = SortedUniqueHashes();
+    result.reserve(kHeaderSize + hashes.size() * sizeof(uint64_t));
+    for (uint64_t hash : hashes) {
+      for (size_t byte = 0; byte < sizeof(uint64_t); ++byte) {
+        result.push_back(static_cast<char>(hash >> (8 * byte)));
+      }
+    }
+  } else {
+    result.append(registers_.begin(), registers_.end());
+  }
+  return result;
+}
+
+absl::StatusOr<HyperLogLogSketch> HyperLogLogSketch::Deserialize(
+    absl::string_view data) {
+  if (data.size() < kHeaderSize || data[0] != kFormatVersion) {
+    return absl::InvalidArgumentError("invalid HyperLogLog sketch");
+  }
+  auto result = Create(static_cast<unsigned char>(data[1]));
+  if (!result.ok()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "invalid HyperLogLog sketch: %s", result.status().message()));
+  }
+  absl::string_view payload = data.substr(kHeaderSize);
+  if (data[2] == kSparse) {
+    if (payload.size() % sizeof(uint64_t) != 0) {
+      return absl::InvalidArgumentError("invalid HyperLogLog sketch");
+    }
+    for (size_t i = 0; i < payload.size(); i += sizeof(uint64_t)) {
+      uint64_t hash = 0;
+      for (size_t byte = 0; byte < sizeof(uint64_t); ++byte) {
+        hash |= uint64_t{static_cast<unsigned char>(payload[i + byte])}
+                << (8 * byte);
+      }
+      result->AddHash(hash);
+    }
+    return result;
+  }
+  const int max_rank = 64 - result->precision_ + 1;
+  if (data[2] != kDense ||
+      payload.size() != (size_t{1} << result->precision_) ||
+      std::any_of(payload.begin(), payload.end(), [&](char r) {
+        return static_cast<unsigned char>(r) > max_rank;
+      })) {
+    return absl::InvalidArgumentError("invalid HyperLogLog sketch");
+  }
+  result->registers_.assign(payload.begin(), payload.end());
+  return result;
+}
+
+absl::StatusOr<int64_t> HyperLogLogEstimateOp::operator()(
+    absl::string_view sketch) const {
+  ASSIGN_OR_RETURN(auto hll, HyperLogLogSketch::Deserialize(sketch));
+  return hll.Estimate();
+}
+
+}  // namespace arolla
@@ -0,0 +1,221 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Probabilistic sketches used by the approximate aggregation operators.
+#ifndef AROLLA_QEXPR_OPERATORS_AGGREGATION_SKETCHES_H_
+#define AROLLA_QEXPR_OPERATORS_AGGREGATION_SKETCHES_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "arolla/util/view_types.h"
+
+namespace arolla {
+
+// Returns a 64-bit hash of the value that is stable across processes, so
+// sketches built from it can be serialized and merged later. Numerically equal
+// floating point values (including 0.0 and -0.0) have the same hash, all NaNs
+// have the same hash.
+uint64_t StableSketchHash(absl::string_view value);
+uint64_t StableSketchHash(uint64_t bits);
+
+template <typename T>
+uint64_t StableSketchHash(T value) {
+  static_assert(std::is_arithmetic_v<T>);
+  if constexpr (std::is_floating_point_v<T>) {
+    double double_value = value;
+    if (double_value == 0) {
+      double_value = 0;  // Normalize -0.0.
+    } else if (double_value != double_value) {
+      double_value = std::numeric_limits<double>::quiet_NaN();
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &double_value, sizeof(bits));
+    return StableSketchHash(bits);
+  } else {
+    return StableSketchHash(static_cast<uint64_t>(value));
+  }
+}
+
+// HyperLogLog sketch for the approximate count of distinct values, with
+// 2^precision one-byte registers. The relative standard error of the estimate
+// is about 1.04 / sqrt(2^precision), e.g. 1.6% for the default precision 12.
+//
+// While the number of distinct hashes is small, the sketch stores them as is
+// (using at most twice the memory of the registers) and the estimate is exact
+// up to hash collisions. So the sketches of small groups are cheap.
+class HyperLogLogSketch {
+ public:
+  static constexpr int kMinPrecision = 4;
+  static constexpr int kMaxPrecision = 16;
+  static constexpr int kDefaultPrecision = 12;
+
+  // Requires kMinPrecision <= precision <= kMaxPrecision.
+  explicit HyperLogLogSketch(int precision = kDefaultPrecision);
+
+  // Returns InvalidArgumentError if the precision is out of range.
+  static absl::StatusOr<HyperLogLogSketch> Create(int64_t precision);
+
+  int precision() const { return precision_; }
+
+  void Clear();
+
+  void AddHash(uint64_t hash);
+
+  // Adds the values from `other`, which must have the same precision.
+  void Merge(const HyperLogLogSketch& other);
+
+  // Returns the estimated number of distinct added hashes.
+  int64_t Estimate() const;
+
+  // Serializes the sketch into a compact binary string. The format is stable,
+  // so the result can be stored and merged in another process.
+  std::string Serialize() const;
+
+  static absl::StatusOr<HyperLogLogSketch> Deserialize(absl::string_view data);
+
+ private:
+  bool sparse() const { return registers_.empty(); }
+  // Returns the sorted distinct hashes of the sparse mode.
+  std::vector<uint64_t> SortedUniqueHashes() const;
+  void Densify();
+  void AddHashToRegisters(uint64_t hash);
+
+  int precision_;
+  // Hashes added in the sparse mode, may contain duplicates.
+  std::vector<uint64_t> hashes_;
+  // 2^precision registers in the dense mode, empty in the sparse mode.
+  std::vector<uint8_t> registers_;
+};
+
+// array._hll_estimate operator: returns the estimated count of distinct values
+// from a serialized HyperLogLogSketch.
+struct HyperLogLogEstimateOp {
+  absl::StatusOr<int64_t> operator()(absl::string_view sketch) const;
+};
+
+// SpaceSaving sketch for finding the most frequent values ("heavy hitters")
+// with a fixed number of counters.
+//
+// Any value that occurs more than N / capacity times among N added values is
+// guaranteed to keep a counter, and its count is overestimated by at most
+// N / capacity.
+template <typename T>
+class SpaceSavingSketch {
+ public:
+  explicit SpaceSavingSketch(int64_t capacity) : capacity_(capacity) {}
+
+  void Clear() {
+    counters_.clear();
+    index_.clear();
+    min_candidates_.clear();
+    min_count_ = 0;
+  }
+
+  void Add(view_type_t<T> value, int64_t count = 1) {
+    if (auto it = index_.find(value); it != index_.end()) {
+      counters_[it->second].count += count;
+      return;
+    }
+    if (static_cast<int64_t>(counters_.size()) < capacity_) {
+      index_.emplace(value, counters_.size());
+      counters_.push_back({value, count});
+      min_candidates_.clear();  // The minimum may have changed.
+      return;
+    }
+    if (capacity_ <= 0) {
+      return;
+    }
+    // Replace the value with the minimal count, the new value inherits it.
+    size_t i = PopMinCounter();
+    index_.erase(counters_[i].value);
+    counters_[i].value = value;
+    counters_[i].count += count;
+    index_.emplace(value, i);
+  }
+
+  // Adds the counters from `other`.
+  void Merge(const SpaceSavingSketch& other) {
+    for (const auto& counter : other.counters_) {
+      Add(counter.value, counter.count);
+    }
+  }
+
+  // Returns the value with the largest count, or std::nullopt if nothing was
+  // added. Ties are broken in favor of the smaller value.
+  std::optional<view_type_t<T>> MostFrequent() const {
+    const Counter* best = nullptr;
+    for (const auto& counter : counters_) {
+      if (best == nullptr || counter.count > best->count ||
+          (counter.count == best->count && counter.value < best->value)) {
+        best = &counter;
+      }
+    }
+    if (best == nullptr) {
+      return std::nullopt;
+    }
+    return best->value;
+  }
+
+ private:
+  struct Counter {
+    view_type_t<T> value;
+    int64_t count;
+  };
+
+  // Returns an index of a counter with the minimal count. The counters never
+  // decrease, so the candidates found by one scan stay valid until their
+  // counts change.
+  size_t PopMinCounter() {
+    while (true) {
+      while (!min_candidates_.empty()) {
+        size_t i = min_candidates_.back();
+        min_candidates_.pop_back();
+        if (counters_[i].count == min_count_) {
+          return i;
+        }
+      }
+      min_count_ = counters_[0].count;
+      for (const auto& counter : counters_) {
+        min_count_ = std::min(min_count_, counter.count);
+      }
+      for (size_t i = 0; i < counters_.size(); ++i) {
+        if (counters_[i].count == min_count_) {
+          min_candidates_.push_back(i);
+        }
+      }
+    }
+  }
+
+  int64_t capacity_;
+  std::vector<Counter> counters_;
+  absl::flat_hash_map<view_type_t<T>, size_t> index_;
+  std::vector<size_t> min_candidates_;
+  int64_t min_count_ = 0;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_QEXPR_OPERATORS_AGGREGATION_SKETCHES_H_
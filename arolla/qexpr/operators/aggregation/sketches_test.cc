@@ -0,0 +1,156 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qexpr/operators/aggregation/sketches.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::IsOkAndHolds;
+using ::arolla::testing::StatusIs;
+using ::testing::HasSubstr;
+using ::testing::Optional;
+
+TEST(StableSketchHashTest, Normalization) {
+  EXPECT_EQ(StableSketchHash(0.0), StableSketchHash(-0.0));
+  EXPECT_EQ(StableSketchHash(0.0f), StableSketchHash(-0.0));
+  EXPECT_EQ(StableSketchHash(std::numeric_limits<float>::quiet_NaN()),
+            StableSketchHash(-std::numeric_limits<double>::quiet_NaN()));
+  EXPECT_NE(StableSketchHash(1.0), StableSketchHash(2.0));
+  EXPECT_NE(StableSketchHash(int64_t{1}), StableSketchHash(int64_t{2}));
+  EXPECT_EQ(StableSketchHash(absl::string_view("abc")),
+            StableSketchHash(absl::string_view(std::string("abc"))));
+}
+
+TEST(HyperLogLogSketchTest, Create) {
+  EXPECT_OK(HyperLogLogSketch::Create(4));
+  EXPECT_OK(HyperLogLogSketch::Create(16));
+  EXPECT_THAT(HyperLogLogSketch::Create(3),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "precision must be in range [4, 16], got 3"));
+  EXPECT_THAT(HyperLogLogSketch::Create(17),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(HyperLogLogSketchTest, SmallCardinalityIsExact) {
+  HyperLogLogSketch sketch;
+  EXPECT_EQ(sketch.Estimate(), 0);
+  for (int i = 0; i < 1000; ++i) {
+    sketch.AddHash(StableSketchHash(int64_t{i % 300}));
+  }
+  EXPECT_EQ(sketch.Estimate(), 300);
+}
+
+TEST(HyperLogLogSketchTest, Accuracy) {
+  for (int precision : {8, 12, 14}) {
+    const double relative_error = 1.04 / std::sqrt(1 << precision);
+    for (int64_t cardinality : {1000, 10000, 200000}) {
+      HyperLogLogSketch sketch(precision);
+      for (int64_t i = 0; i < 2 * cardinality; ++i) {
+        sketch.AddHash(StableSketchHash(i % cardinality));
+      }
+      EXPECT_NEAR(sketch.Estimate(), cardinality,
+                  4 * relative_error * cardinality)
+          << precision << " " << cardinality;
+    }
+  }
+}
+
+TEST(HyperLogLogSketchTest, Merge) {
+  for (int64_t size : {100, 100000}) {
+    HyperLogLogSketch a, b, all;
+    for (int64_t i = 0; i < size; ++i) {
+      (i % 3 == 0 ? a : b).AddHash(StableSketchHash(i));
+      all.AddHash(StableSketchHash(i));
+    }
+    HyperLogLogSketch merged = a;
+    merged.Merge(b);
+    EXPECT_EQ(merged.Estimate(), all.Estimate());
+    merged = b;
+    merged.Merge(a);
+    EXPECT_EQ(merged.Estimate(), all.Estimate());
+  }
+}
+
+TEST(HyperLogLogSketchTest, Serialization) {
+  for (int64_t size : {0, 10, 100000}) {
+    HyperLogLogSketch sketch(10);
+    for (int64_t i = 0; i < size; ++i) {
+      sketch.AddHash(StableSketchHash(i));
+    }
+    std::string serialized = sketch.Serialize();
+    ASSERT_OK_AND_ASSIGN(auto deserialized,
+                         HyperLogLogSketch::Deserialize(serialized));
+    EXPECT_EQ(deserialized.precision(), 10);
+    EXPECT_EQ(deserialized.Estimate(), sketch.Estimate());
+    EXPECT_EQ(deserialized.Serialize(), serialized);
+    EXPECT_THAT(HyperLogLogEstimateOp()(serialized),
+                IsOkAndHolds(sketch.Estimate()));
+    if (!serialized.empty()) {
+      EXPECT_THAT(HyperLogLogSketch::Deserialize(
+                      serialized.substr(0, serialized.size() - 1)),
+                  StatusIs(absl::StatusCode::kInvalidArgument,
+                           "invalid HyperLogLog sketch"));
+    }
+  }
+  EXPECT_THAT(HyperLogLogSketch::Deserialize(""),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "invalid HyperLogLog sketch"));
+  EXPECT_THAT(HyperLogLogSketch::Deserialize(std::string("\x01\x20\x00", 3)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("precision must be in range")));
+}
+
+TEST(SpaceSavingSketchTest, MostFrequent) {
+  SpaceSavingSketch<int64_t> sketch(/*capacity=*/8);
+  EXPECT_EQ(sketch.MostFrequent(), std::nullopt);
+  // 7 occurs in 20% of the rows, the other values are distinct.
+  for (int64_t i = 0; i < 10000; ++i) {
+    sketch.Add(i % 5 == 0 ? 7 : 1000 + i);
+  }
+  EXPECT_THAT(sketch.MostFrequent(), Optional(7));
+
+  SpaceSavingSketch<int64_t> other(/*capacity=*/8);
+  other.Add(3, 5000);
+  sketch.Merge(other);
+  EXPECT_THAT(sketch.MostFrequent(), Optional(3));
+
+  sketch.Clear();
+  sketch.Add(5);
+  sketch.Add(4);
+  EXPECT_THAT(sketch.MostFrequent(), Optional(4));
+}
+
+TEST(SpaceSavingSketchTest, Strings) {
+  SpaceSavingSketch<std::string> sketch(/*capacity=*/3);
+  std::string values[] = {"a", "b", "c", "b", "d", "b", "e"};
+  for (const auto& value : values) {
+    sketch.Add(value);
+  }
+  EXPECT_THAT(sketch.MostFrequent(), Optional(absl::string_view("b")));
+}
+
+}  // namespace
+}  // namespace arolla
@@ -0,0 +1,287 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Benchmarks of all the QExpr operators in OperatorRegistry.
+//
+// For every overload registered via OperatorRegistry::RegisterOperator whose
+// inputs are scalars, optionals, DenseArrays or Arrays of the basic types,
+// defines a benchmark "BM_Operator/<name><signature>", fed with random inputs.
+// The signatures with arrays are run for every combination of
+// --array_sizes and --presence_percents. The benchmarks report the time per
+// array element ("per_element"), the number and size of the buffer
+// allocations per evaluation ("allocs" and "alloc_bytes") and the hardware
+// performance counters if available (see BenchmarkPerfCounters).
+//
+// Use --benchmark_filter to select the operators, e.g.
+//   --benchmark_filter='BM_Operator/math\.add\(DENSE_ARRAY'
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/log/check.h"
+#include "absl/random/random.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "arolla/array/array.h"
+#include "arolla/array/qtype/types.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/base_types.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/meta.h"
+#include "arolla/util/testing/benchmark_perf_counters.h"
+#include "arolla/util/text.h"
+#include "arolla/util/unit.h"
+
+ABSL_FLAG(std::vector<std::string>, array_sizes,
+          std::vector<std::string>({"1", "100", "10000"}),
+          "Sizes of the DenseArray and Array inputs.");
+ABSL_FLAG(std::vector<std::string>, presence_percents,
+          std::vector<std::string>({"100", "50"}),
+          "Percents of the present elements in the optional, DenseArray and "
+          "Array inputs.");
+
+namespace arolla {
+namespace {
+
+using GeneratedValueTypes =
+    meta::type_list<Unit, bool, int32_t, int64_t, float, double, Bytes, Text>;
+
+template <typename T>
+T RandomValue(absl::BitGen& gen) {
+  if constexpr (std::is_same_v<T, Unit>) {
+    return kUnit;
+  } else if constexpr (std::is_same_v<T, bool>) {
+    return absl::Bernoulli(gen, 0.5);
+  } else if constexpr (std::is_same_v<T, Bytes> || std::is_same_v<T, Text>) {
+    return T(absl::StrCat(absl::Uniform<int32_t>(gen, 0, 1000000)));
+  } else if constexpr (std::is_integral_v<T>) {
+    // Positive and small, so most of the arithmetic operators succeed.
+    return absl::Uniform<T>(gen, 1, 100);
+  } else {
+    return absl::Uniform<T>(gen, 0.5, 100.0);
+  }
+}
+
+template <typename T>
+DenseArray<T> RandomDenseArray(int64_t size, double presence,
+                               absl::BitGen& gen) {
+  DenseArrayBuilder<T> builder(size);
+  for (int64_t i = 0; i < size; ++i) {
+    if (absl::Bernoulli(gen, presence)) {
+      builder.Set(i, RandomValue<T>(gen));
+    }
+  }
+  return std::move(builder).Build();
+}
+
+// Generates a random input of the given size. The size is ignored for the
+// scalar and optional inputs.
+using InputGenerator = std::function<TypedValue(
+    int64_t size, double presence, absl::BitGen& gen)>;
+
+struct InputGenerators {
+  absl::flat_hash_map<QTypePtr, InputGenerator> generators;
+  absl::flat_hash_set<QTypePtr> array_qtypes;
+  absl::flat_hash_set<QTypePtr> optional_qtypes;
+};
+
+const InputGenerators& GetInputGenerators() {
+  static const Indestructible<InputGenerators> kGenerators([] {
+    InputGenerators result;
+    meta::foreach_type(GeneratedValueTypes(), [&](auto meta_type) {
+      using T = typename decltype(meta_type)::type;
+      result.generators[GetQType<T>()] = [](int64_t, double,
+                                           absl::BitGen& gen) {
+        return TypedValue::FromValue(RandomValue<T>(gen));
+      };
+      result.generators[GetOptionalQType<T>()] =
+          [](int64_t, double presence, absl::BitGen& gen) {
+            OptionalValue<T> value;
+            if (absl::Bernoulli(gen, presence)) {
+              value = RandomValue<T>(gen);
+            }
+            return TypedValue::FromValue(std::move(value));
+          };
+      result.generators[GetDenseArrayQType<T>()] =
+          [](int64_t size, double presence, absl::BitGen& gen) {
+            return TypedValue::FromValue(
+                RandomDenseArray<T>(size, presence, gen));
+          };
+      result.generators[GetArrayQType<T>()] =
+          [](int64_t size, double presence, absl::BitGen& gen) {
+            return TypedValue::FromValue(
+                Array<T>(RandomDenseArray<T>(size, presence, gen)));
+          };
+      result.array_qtypes.insert(GetDenseArrayQType<T>());
+      result.array_qtypes.insert(GetArrayQType<T>());
+      result.optional_qtypes.insert(GetOptionalQType<T>());
+    });
+    return result;
+  }());
+  return *kGenerators;
+}
+
+// `size_arg` and `presence_arg` are the indices of the benchmark args with the
+// array size and the presence percent, or -1 if the operator doesn't have
+// array or optional inputs respectively.
+void BM_Operator(benchmark::State& state, OperatorPtr op, int size_arg,
+                 int presence_arg) {
+  const int64_t size = size_arg >= 0 ? state.range(size_arg) : 1;
+  const double presence =
+      presence_arg >= 0 ? state.range(presence_arg) / 100.0 : 1.0;
+  const auto& generators = GetInputGenerators().generators;
+  const auto* signature = op->GetQType();
+
+  FrameLayout::Builder layout_builder;
+  std::vector<TypedSlot> input_slots;
+  for (QTypePtr input_type : signature->GetInputTypes()) {
+    input_slots.push_back(AddSlot(input_type, &layout_builder));
+  }
+  TypedSlot output_slot =
+      AddSlot(signature->GetOutputType(), &layout_builder);
+  auto bound_op = op->Bind(input_slots, output_slot);
+  if (!bound_op.ok()) {
+    state.SkipWithError(bound_op.status().ToString().c_str());
+    return;
+  }
+  FrameLayout layout = std::move(layout_builder).Build();
+
+  // The inputs are allocated on the heap, only the evaluation allocations are
+  // counted.
+  AllocationTrackingBufferFactory buffer_factory;
+  RootEvaluationContext root_ctx(&layout, &buffer_factory);
+  absl::BitGen gen;
+  for (const auto& slot : input_slots) {
+    TypedValue input = generators.at(slot.GetType())(size, presence, gen);
+    CHECK_OK(input.CopyToSlot(slot, root_ctx.frame()));
+  }
+
+  // Some operators fail on random inputs, e.g. on an out of range index.
+  {
+    EvaluationContext ctx(root_ctx);
+    (*bound_op)->Run(&ctx, root_ctx.frame());
+    if (!ctx.status().ok()) {
+      state.SkipWithError(ctx.status().ToString().c_str());
+      return;
+    }
+  }
+
+  buffer_factory.ResetStats();
+  testing::BenchmarkPerfCounters perf_counters(state);
+  for (auto _ : state) {
+    EvaluationContext ctx(root_ctx);
+    (*bound_op)->Run(&ctx, root_ctx.frame());
+    benchmark::DoNotOptimize(ctx.status());
+  }
+
+  auto stats = buffer_factory.GetStats();
+  state.counters["per_element"] = benchmark::Counter(
+      size, benchmark::Counter::kIsIterationInvariantRate |
+                benchmark::Counter::kInvert);
+  state.counters["allocs"] =
+      benchmark::Counter(stats.create_count + stats.realloc_count,
+                         benchmark::Counter::kAvgIterations);
+  state.counters["alloc_bytes"] = benchmark::Counter(
+      stats.allocated_bytes, benchmark::Counter::kAvgIterations);
+}
+
+std::vector<int64_t> ParseIntListFlag(
+    const absl::Flag<std::vector<std::string>>& flag) {
+  std::vector<int64_t> result;
+  for (const auto& value : absl::GetFlag(flag)) {
+    int64_t parsed;
+    CHECK(absl::SimpleAtoi(value, &parsed))
+        << "expected an integer, got " << value;
+    result.push_back(parsed);
+  }
+  return result;
+}
+
+// Registers a benchmark for every supported operator overload.
+void RegisterOperatorBenchmarks() {
+  const std::vector<int64_t> array_sizes = ParseIntListFlag(FLAGS_array_sizes);
+  const std::vector<int64_t> presence_percents =
+      ParseIntListFlag(FLAGS_presence_percents);
+  const auto& input_generators = GetInputGenerators();
+  auto* registry = OperatorRegistry::GetInstance();
+  for (const auto& name : registry->ListRegisteredOperators()) {
+    for (auto& op : registry->ListRegisteredOperatorOverloads(name)) {
+      bool supported = true;
+      bool has_arrays = false;
+      bool has_optionals = false;
+      for (QTypePtr input_type : op->GetQType()->GetInputTypes()) {
+        supported &= input_generators.generators.contains(input_type);
+        has_arrays |= input_generators.array_qtypes.contains(input_type);
+        has_optionals |= input_generators.optional_qtypes.contains(input_type);
+      }
+      if (!supported) {
+        continue;
+      }
+      std::vector<std::vector<int64_t>> args;
+      int size_arg = -1;
+      int presence_arg = -1;
+      if (has_arrays) {
+        size_arg = args.size();
+        args.push_back(array_sizes);
+      }
+      if (has_arrays || has_optionals) {
+        presence_arg = args.size();
+        args.push_back(presence_percents);
+      }
+      auto* benchmark = benchmark::RegisterBenchmark(
+          absl::StrCat("BM_Operator/", name, op->GetQType()->name()).c_str(),
+          [op, size_arg, presence_arg](benchmark::State& state) {
+            BM_Operator(state, op, size_arg, presence_arg);
+          });
+      if (!args.empty()) {
+        benchmark->ArgsProduct(args);
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace arolla
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  absl::ParseCommandLine(argc, argv);
+  CHECK_OK(arolla::InitArolla());
+  arolla::RegisterOperatorBenchmarks();
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -36,9 +36,11 @@
 #include "arolla/memory/buffer.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators/aggregation/hash_table_presizer.h"
 #include "arolla/qexpr/operators/dense_array/array_ops.h"
 #include "arolla/util/unit.h"
 #include "arolla/util/view_types.h"
+#include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
 
@@ -155,7 +157,7 @@ struct ArrayConcatOp {
         EstimateResultDenseDataSize(qblock1, qblock2, best_missing_id_value);
 
     int64_t size = qblock1.size() + qblock2.size();
-    if (estimated_dense_data_size > size * IdFilter::kDenseSparsityLimit) {
+    if (estimated_dense_data_size > size * IdFilter::DenseSparsityLimit()) {
       // Use dense form
       DenseArrayBuilder<T> builder(size, &ctx->buffer_factory());
       qblock1.ForEachPresent(
@@ -328,10 +330,12 @@ struct ArrayUniqueOp {
                                      &ctx->buffer_factory());
     auto inserter = bldr.GetInserter();
     absl::flat_hash_set<view_type_t<T>> unique_values;
+    HashTablePresizer presizer(input.PresentCount());
     input.ForEachPresent([&](int64_t /*index*/, const auto& value) {
       if (auto [it, inserted] = unique_values.insert(value); inserted) {
         inserter.Add(value);
       }
+      presizer.Update(unique_values);
     });
     return Array<T>(DenseArray<T>{std::move(bldr).Build(unique_values.size())});
   }
@@ -361,6 +365,12 @@ struct ArraySelectOp {
     if (input.IsConstForm()) {
       return Array<T>(size, input.missing_id_value());
     }
+    if (filter.IsDenseForm() && input.IsDenseForm()) {
+      ASSIGN_OR_RETURN(
+          DenseArray<T> res,
+          DenseArraySelectOp()(ctx, input.dense_data(), filter.dense_data()));
+      return Array<T>(std::move(res));
+    }
 
     DenseArrayBuilder<T> dense_builder(size);
     int64_t offset = 0;
@@ -12,12 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <algorithm>
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "arolla/array/array.h"
 #include "arolla/array/qtype/types.h"  // IWYU pragma: keep
 #include "arolla/dense_array/qtype/types.h"
@@ -31,6 +34,7 @@ namespace arolla::testing {
 namespace {
 
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 
 class ArrayOpsTest : public ::testing::Test {
   void SetUp() final { ASSERT_OK(InitArolla()); }
@@ -156,6 +160,35 @@ TEST_F(ArrayOpsTest, Select) {
   EXPECT_THAT(result.dense_data(), ElementsAre(3, 2, 1));
 }
 
+TEST_F(ArrayOpsTest, Select_DenseForm) {
+  constexpr int kSize = 100;
+  std::vector<OptionalValue<int>> values(kSize);
+  std::vector<OptionalValue<Unit>> filter_values(kSize);
+  std::vector<OptionalValue<int>> expected;
+  for (int i = 0; i < kSize; ++i) {
+    if (i % 7 != 0) values[i] = i;
+    // A fully present word, a sparse word and a dense word.
+    if (i < 32 || (i < 64 && i % 5 == 0) || (i >= 64 && i % 5 != 0)) {
+      filter_values[i] = kPresent;
+      expected.push_back(values[i]);
+    }
+  }
+  for (int64_t offset : {0, 3}) {
+    auto input = CreateArray<int>(values).Slice(offset, kSize - offset);
+    auto filter =
+        CreateArray<Unit>(filter_values).Slice(offset, kSize - offset);
+    ASSERT_TRUE(input.IsDenseForm());
+    ASSERT_TRUE(filter.IsDenseForm());
+    ASSERT_OK_AND_ASSIGN(Array<int> result,
+                         InvokeOperator<Array<int>>("array.select", input,
+                                                    filter));
+    auto expected_slice = absl::MakeConstSpan(expected).subspan(
+        std::count_if(filter_values.begin(), filter_values.begin() + offset,
+                      [](const auto& v) { return v.present; }));
+    EXPECT_THAT(result, ElementsAreArray(expected_slice)) << offset;
+  }
+}
+
 TEST_F(ArrayOpsTest, Select_AllMissingFormFilter) {
   auto full = CreateArray<int>({1, 3, 2, 1}).ToSparseForm(1);
   auto filter = CreateArray<Unit>({kMissing, kMissing, kMissing, kMissing})
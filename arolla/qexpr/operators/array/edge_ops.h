@@ -21,6 +21,7 @@
 #include <memory>
 #include <numeric>
 #include <optional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -480,8 +481,14 @@ struct ArrayGroupByOp {
                                        const Array<T>& series,
                                        const Edge& over) const {
     int64_t group_counter = 0;
+    // With a scalar edge all the values belong to the same group.
+    int64_t group_size_hint = 0;
+    if constexpr (std::is_same_v<Edge, ArrayGroupScalarEdge>) {
+      group_size_hint = series.PresentCount();
+    }
     ArrayGroupOp<GroupByAccumulator<T>> op(
-        &ctx->buffer_factory(), GroupByAccumulator<T>(&group_counter));
+        &ctx->buffer_factory(),
+        GroupByAccumulator<T>(&group_counter, group_size_hint));
     ASSIGN_OR_RETURN(Array<int64_t> mapping, op.Apply(over, series));
     return ArrayEdge::UnsafeFromMapping(std::move(mapping), group_counter);
   }
@@ -15,6 +15,7 @@
 #ifndef AROLLA_OPERATORS_CORE_CAST_OPERATOR_H_
 #define AROLLA_OPERATORS_CORE_CAST_OPERATOR_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <tuple>
@@ -23,6 +24,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/util/meta.h"
 #include "arolla/util/repr.h"
@@ -41,6 +43,37 @@ struct CastOp {
 
   static_assert(meta::contains_v<DstTypes, DST>);
 
+  // Casting to the same type returns the argument as is (see
+  // DenseArrayLifter).
+  using is_identity_on_same_type = std::true_type;
+
+  // Vectorizable implementation for DenseArrays (see DenseArrayLifter). Casts
+  // all the values and returns false if some of them are out of the safe range;
+  // the out of range values are replaced with zeros.
+  struct batch_op {
+    template <typename SRC>
+    bool operator()(absl::Span<DST> res, absl::Span<const SRC> src) const {
+      constexpr auto src_range = safe_range<SRC>();
+      if constexpr (std::tuple_size_v<decltype(src_range)> == 0) {
+        for (size_t i = 0; i < res.size(); ++i) {
+          res[i] = static_cast<DST>(src[i]);
+        }
+        return true;
+      } else {
+        const auto& [range_min, range_max] = src_range;
+        bool all_in_range = true;
+        for (size_t i = 0; i < res.size(); ++i) {
+          SRC x = src[i];
+          // Note: NaN is out of range.
+          bool in_range = range_min <= x && x <= range_max;
+          res[i] = static_cast<DST>(in_range ? x : SRC{0});
+          all_in_range &= in_range;
+        }
+        return all_in_range;
+      }
+    }
+  };
+
   // Returns the maximal value of SRC type, that can be safely casted to DST.
   //
   // The formula for the value:
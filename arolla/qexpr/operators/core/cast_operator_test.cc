@@ -19,10 +19,12 @@
 #include <limits>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "arolla/util/meta.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 
@@ -31,6 +33,7 @@ namespace {
 
 using ::arolla::testing::IsOkAndHolds;
 using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 
 TEST(CastOperatorTest, CastToInt32UB) {
@@ -56,6 +59,37 @@ TEST(CastOperatorTest, CastToInt32UB) {
                        "cannot cast float64{2147483648} to int32"));
 }
 
+TEST(CastOperatorTest, BatchOp) {
+  {
+    std::vector<int32_t> src = {1, -2, 3};
+    std::vector<double> res(src.size());
+    EXPECT_TRUE(CastOp<double>::batch_op()(absl::MakeSpan(res),
+                                           absl::MakeConstSpan(src)));
+    EXPECT_THAT(res, ElementsAre(1., -2., 3.));
+  }
+  {
+    std::vector<double> src = {1.5, -2., 3.};
+    std::vector<int32_t> res(src.size());
+    EXPECT_TRUE(CastOp<int32_t>::batch_op()(absl::MakeSpan(res),
+                                            absl::MakeConstSpan(src)));
+    EXPECT_THAT(res, ElementsAre(1, -2, 3));
+  }
+  {
+    std::vector<double> src = {1., 1e10, NAN, 4.};
+    std::vector<int32_t> res(src.size());
+    EXPECT_FALSE(CastOp<int32_t>::batch_op()(absl::MakeSpan(res),
+                                             absl::MakeConstSpan(src)));
+    EXPECT_THAT(res, ElementsAre(1, 0, 0, 4));
+  }
+  {
+    std::vector<int64_t> src = {1, -1};
+    std::vector<uint64_t> res(src.size());
+    EXPECT_FALSE(CastOp<uint64_t>::batch_op()(absl::MakeSpan(res),
+                                              absl::MakeConstSpan(src)));
+    EXPECT_THAT(res, ElementsAre(1, 0));
+  }
+}
+
 TEST(CastOperatorTest, CastFromUInt64) {
   EXPECT_THAT((CastOp<int32_t>()(uint64_t{1})), IsOkAndHolds(int32_t{1}));
   EXPECT_THAT((CastOp<float>()(uint64_t{1})), Eq(1.0f));
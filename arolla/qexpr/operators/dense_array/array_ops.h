@@ -19,9 +19,11 @@
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <type_traits>
 #include <utility>
 
 #include "absl/base/optimization.h"
+#include "absl/base/prefetch.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -34,6 +36,7 @@
 #include "arolla/memory/buffer.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators/aggregation/hash_table_presizer.h"
 #include "arolla/util/unit.h"
 #include "arolla/util/view_types.h"
 #include "arolla/util/status_macros_backport.h"
@@ -64,22 +67,79 @@ struct DenseArrayAtOp {
   template <typename T>
   DenseArray<T> operator()(EvaluationContext* ctx, const DenseArray<T>& arr,
                            const DenseArray<int64_t>& ids) const {
-    auto fn = [ctx, &arr](int64_t id) -> OptionalValue<view_type_t<T>> {
-      if (ABSL_PREDICT_FALSE(id < 0 || id >= arr.size())) {
-        ReportIndexOutOfRangeError(ctx, id, arr.size());
-        return std::nullopt;
-      }
-      if (!arr.present(id)) {
-        return std::nullopt;
-      }
-      return arr.values[id];
-    };
-    auto op = CreateDenseOp<DenseOpFlags::kNoBitmapOffset, decltype(fn), T>(
-        fn, &ctx->buffer_factory());
-    return op(ids);
+    if constexpr (std::is_arithmetic_v<T>) {
+      return Gather(ctx, arr, ids);
+    } else {
+      auto fn = [ctx, &arr](int64_t id) -> OptionalValue<view_type_t<T>> {
+        if (ABSL_PREDICT_FALSE(id < 0 || id >= arr.size())) {
+          ReportIndexOutOfRangeError(ctx, id, arr.size());
+          return std::nullopt;
+        }
+        if (!arr.present(id)) {
+          return std::nullopt;
+        }
+        return arr.values[id];
+      };
+      auto op = CreateDenseOp<DenseOpFlags::kNoBitmapOffset, decltype(fn), T>(
+          fn, &ctx->buffer_factory());
+      return op(ids);
+    }
   }
 
  private:
+  // Number of ids looked ahead when prefetching the gathered values.
+  static constexpr int64_t kPrefetchDistance = 2 * bitmap::kWordBitCount;
+
+  // Specialized implementation for the numeric types. Large random gathers are
+  // bound by the memory latency, so the values and the presence words for the
+  // ids kPrefetchDistance ahead are prefetched, and the result bitmap is built
+  // word by word from the presence of the ids and of the values.
+  template <typename T>
+  static DenseArray<T> Gather(EvaluationContext* ctx, const DenseArray<T>& arr,
+                              const DenseArray<int64_t>& ids) {
+    const int64_t size = ids.size();
+    const uint64_t arr_size = arr.size();
+    const T* values = arr.values.span().data();
+    const bitmap::Word* arr_bitmap = arr.bitmap.span().data();
+    const int64_t* id_values = ids.values.span().data();
+    typename Buffer<T>::Builder values_bldr(size, &ctx->buffer_factory());
+    T* result = values_bldr.GetMutableSpan().data();
+    bitmap::Builder bitmap_bldr(size, &ctx->buffer_factory());
+    bitmap_bldr.AddByGroups(size, [&](int64_t offset) {
+      for (int64_t i = offset + kPrefetchDistance,
+                   end = std::min(size, i + bitmap::kWordBitCount);
+           i < end; ++i) {
+        const uint64_t id = id_values[i];
+        if (id < arr_size) {
+          absl::PrefetchToLocalCache(values + id);
+          if (arr_bitmap != nullptr) {
+            absl::PrefetchToLocalCache(
+                arr_bitmap +
+                (id + arr.bitmap_bit_offset) / bitmap::kWordBitCount);
+          }
+        }
+      }
+      const bitmap::Word ids_word = bitmap::GetWordWithOffset(
+          ids.bitmap, offset / bitmap::kWordBitCount, ids.bitmap_bit_offset);
+      return [ctx, &arr, values, arr_size, ids_word,
+              ids_group = id_values + offset,
+              result_group = result + offset](int i) {
+        const int64_t id = ids_group[i];
+        const bool id_present = bitmap::GetBit(ids_word, i);
+        if (ABSL_PREDICT_TRUE(static_cast<uint64_t>(id) < arr_size)) {
+          result_group[i] = values[id];
+          return id_present && arr.present(id);
+        }
+        result_group[i] = T{};
+        if (id_present) {
+          ReportIndexOutOfRangeError(ctx, id, arr.size());
+        }
+        return false;
+      };
+    });
+    return {std::move(values_bldr).Build(), std::move(bitmap_bldr).Build()};
+  }
+
   // The function must be in *.cc to guarantee that it is not inlined for
   // performance reasons.
   static void ReportIndexOutOfRangeError(EvaluationContext* ctx, int64_t index,
@@ -116,11 +176,27 @@ struct DenseArrayConcatOp {
   template <typename T>
   DenseArray<T> operator()(EvaluationContext* ctx, const DenseArray<T>& arr1,
                            const DenseArray<T>& arr2) const {
+    // Concatenation with an empty array shares the buffers of the other one.
+    // Note: we use ForceNoBimapBitOffset because for performance reasons
+    // `lift_to_dense_array` has NoBitmapOffset=true.
+    if (arr1.empty()) {
+      return arr2.ForceNoBitmapBitOffset(&ctx->buffer_factory());
+    }
+    if (arr2.empty()) {
+      return arr1.ForceNoBitmapBitOffset(&ctx->buffer_factory());
+    }
     typename Buffer<T>::Builder values_bldr(arr1.size() + arr2.size(),
                                             &ctx->buffer_factory());
-    auto values_inserter = values_bldr.GetInserter();
-    for (const auto& v : arr1.values) values_inserter.Add(v);
-    for (const auto& v : arr2.values) values_inserter.Add(v);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      auto values = values_bldr.GetMutableSpan();
+      std::copy(arr1.values.begin(), arr1.values.end(), values.begin());
+      std::copy(arr2.values.begin(), arr2.values.end(),
+                values.begin() + arr1.size());
+    } else {
+      auto values_inserter = values_bldr.GetInserter();
+      for (const auto& v : arr1.values) values_inserter.Add(v);
+      for (const auto& v : arr2.values) values_inserter.Add(v);
+    }
     if (arr1.bitmap.empty() && arr2.bitmap.empty()) {
       return {std::move(values_bldr).Build()};
     }
@@ -152,11 +228,8 @@ class DenseArrayPresentIndicesOp {
         bitmap::CountBits(input.bitmap, input.bitmap_bit_offset, input.size());
     Buffer<int64_t>::Builder buffer_builder(count, &ctx->buffer_factory());
     auto inserter = buffer_builder.GetInserter();
-    input.ForEach([&](int64_t index, bool present, const auto& /*value*/) {
-      if (present) {
-        inserter.Add(index);
-      }
-    });
+    bitmap::IterateSetBits(input.bitmap, input.bitmap_bit_offset, input.size(),
+                           [&](int64_t index) { inserter.Add(index); });
     return DenseArray<int64_t>{std::move(buffer_builder).Build(count)};
   }
 };
@@ -171,11 +244,9 @@ class DenseArrayPresentValuesOp {
         bitmap::CountBits(input.bitmap, input.bitmap_bit_offset, input.size());
     typename Buffer<T>::Builder buffer_builder(count, &ctx->buffer_factory());
     auto inserter = buffer_builder.GetInserter();
-    input.ForEach([&](int64_t /*index*/, bool present, const auto& value) {
-      if (present) {
-        inserter.Add(value);
-      }
-    });
+    bitmap::IterateSetBits(
+        input.bitmap, input.bitmap_bit_offset, input.size(),
+        [&](int64_t index) { inserter.Add(input.values[index]); });
     return DenseArray<T>{std::move(buffer_builder).Build(count)};
   }
 };
@@ -216,10 +287,12 @@ struct DenseArrayUniqueOp {
     typename Buffer<T>::Builder bldr(input.size(), &ctx->buffer_factory());
     auto inserter = bldr.GetInserter();
     absl::flat_hash_set<view_type_t<T>> unique_values;
+    HashTablePresizer presizer(input.PresentCount());
     input.ForEachPresent([&](int64_t /*index*/, const auto& value) {
       if (auto [it, inserted] = unique_values.insert(value); inserted) {
         inserter.Add(value);
       }
+      presizer.Update(unique_values);
     });
     return DenseArray<T>{std::move(bldr).Build(unique_values.size())};
   }
@@ -243,16 +316,26 @@ struct DenseArraySelectOp {
       return DenseArray<T>();
     }
 
-    DenseArrayBuilder<T> builder(count);
-
+    typename Buffer<T>::Builder values_builder(count, &ctx->buffer_factory());
+    auto inserter = values_builder.GetInserter();
+    if (input.bitmap.empty()) {
+      bitmap::IterateSetBits(
+          filter.bitmap, filter.bitmap_bit_offset, filter.size(),
+          [&](int64_t id) { inserter.Add(input.values[id]); });
+      return DenseArray<T>{std::move(values_builder).Build()};
+    }
+    bitmap::AlmostFullBuilder bitmap_builder(count, &ctx->buffer_factory());
     int64_t offset = 0;
-    using view_type = arolla::view_type_t<T>;
-    auto fn = [&](int64_t id, Unit mask, OptionalValue<view_type> value) {
-      builder.Set(offset++, value);
-    };
-
-    RETURN_IF_ERROR(DenseArraysForEachPresent(fn, filter, input));
-    return std::move(builder).Build();
+    bitmap::IterateSetBits(filter.bitmap, filter.bitmap_bit_offset,
+                           filter.size(), [&](int64_t id) {
+                             inserter.Add(input.values[id]);
+                             if (!input.present(id)) {
+                               bitmap_builder.AddMissed(offset);
+                             }
+                             ++offset;
+                           });
+    return DenseArray<T>{std::move(values_builder).Build(),
+                         std::move(bitmap_builder).Build()};
   }
 };
 
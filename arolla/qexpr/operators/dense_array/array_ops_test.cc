@@ -14,6 +14,7 @@
 //
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -24,6 +25,7 @@
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/operators.h"
 #include "arolla/util/init_arolla.h"
+#include "arolla/util/text.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 
 namespace arolla::testing {
@@ -31,6 +33,8 @@ namespace {
 
 using ::arolla::testing::StatusIs;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::HasSubstr;
 
 class ArrayOpsTest : public ::testing::Test {
   void SetUp() final { ASSERT_OK(InitArolla()); }
@@ -62,6 +66,46 @@ TEST_F(ArrayOpsTest, DenseArrayAtOp) {
                "array index 4 out of range [0, 4)"));
 }
 
+TEST_F(ArrayOpsTest, DenseArrayAtOpGather) {
+  std::vector<std::optional<int>> values(1000);
+  for (int i = 0; i < values.size(); ++i) {
+    if (i % 7 != 0) {
+      values[i] = i;
+    }
+  }
+  std::vector<std::optional<int64_t>> ids(517);
+  for (int64_t i = 0; i < ids.size(); ++i) {
+    if (i % 5 != 0) {
+      ids[i] = (i * 389) % values.size();
+    }
+  }
+  // Slicing gives non-zero bitmap bit offsets.
+  auto arr = CreateDenseArray<int>(values).Slice(3, 990);
+  auto ids_arr = CreateDenseArray<int64_t>(ids).Slice(5, 500);
+  std::vector<std::optional<int>> expected;
+  for (int64_t i = 0; i < ids_arr.size(); ++i) {
+    const auto id = ids_arr[i];
+    expected.push_back(id.present && id.value < arr.size()
+                           ? arr[id.value].AsOptional()
+                           : std::nullopt);
+  }
+  // Make all the ids valid.
+  std::vector<std::optional<int64_t>> valid_ids;
+  for (int64_t i = 0; i < ids_arr.size(); ++i) {
+    const auto id = ids_arr[i];
+    valid_ids.push_back(id.present && id.value < arr.size()
+                            ? std::optional<int64_t>(id.value)
+                            : std::nullopt);
+  }
+  EXPECT_THAT(InvokeOperator<DenseArray<int>>(
+                  "array.at", arr,
+                  CreateDenseArray<int64_t>(valid_ids).Slice(0, 500)),
+              IsOkAndHolds(ElementsAreArray(expected)));
+  EXPECT_THAT(InvokeOperator<DenseArray<int>>("array.at", arr, ids_arr),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("out of range [0, 990)")));
+}
+
 TEST_F(ArrayOpsTest, TestArrayTakeOver) {
   auto x = CreateDenseArray<int>({1, 2, 3, std::nullopt, 5, 6, 7, 8});
   auto offsets = CreateDenseArray<int64_t>({0, 3, 2, 1, 4, 5, 6, std::nullopt});
@@ -165,6 +209,25 @@ TEST_F(ArrayOpsTest, Concat) {
               IsOkAndHolds(ElementsAre(1, 2, 3)));
   EXPECT_THAT(InvokeOperator<DenseArray<int>>("array.concat", z, y),
               IsOkAndHolds(ElementsAre(std::nullopt, 4)));
+  {
+    // Concatenation with an empty array doesn't copy the other one.
+    ASSERT_OK_AND_ASSIGN(auto res,
+                         InvokeOperator<DenseArray<int>>("array.concat", y, z));
+    EXPECT_EQ(res.values.span().data(), y.values.span().data());
+    EXPECT_EQ(res.bitmap.span().data(), y.bitmap.span().data());
+  }
+  {
+    // Bitmap offsets are dropped in the result.
+    auto sliced_y = CreateDenseArray<int>({1, std::nullopt, 4}).Slice(1, 2);
+    ASSERT_NE(sliced_y.bitmap_bit_offset, 0);
+    ASSERT_OK_AND_ASSIGN(auto res, InvokeOperator<DenseArray<int>>(
+                                       "array.concat", z, sliced_y));
+    EXPECT_EQ(res.bitmap_bit_offset, 0);
+    EXPECT_THAT(res, ElementsAre(std::nullopt, 4));
+  }
+  auto t = CreateDenseArray<Text>({Text("a"), std::nullopt});
+  EXPECT_THAT(InvokeOperator<DenseArray<Text>>("array.concat", t, t),
+              IsOkAndHolds(ElementsAre("a", std::nullopt, "a", std::nullopt)));
 }
 
 }  // namespace
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -25,6 +26,7 @@
 #include "arolla/dense_array/bitmap.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/edge.h"
+#include "arolla/dense_array/ops/dense_group_ops.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/dense_array/testing/util.h"
 #include "arolla/memory/buffer.h"
@@ -33,7 +35,9 @@
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/operators.h"
+#include "arolla/qexpr/operators/aggregation/group_op_accumulators.h"
 #include "arolla/qexpr/operators/core/logic_operators.h"
+#include "arolla/qexpr/operators/dense_array/array_ops.h"
 #include "arolla/qexpr/operators/dense_array/edge_ops.h"
 #include "arolla/qexpr/operators/dense_array/lifter.h"
 #include "arolla/qexpr/operators/dense_array/logic_ops.h"
@@ -248,6 +252,63 @@ BENCHMARK(BM_PresenceOr_Const<Sparsity::Empty>)->Arg(32)->Arg(320);
 BENCHMARK(BM_PresenceOr_Const<Sparsity::Full>)->Arg(32)->Arg(320);
 BENCHMARK(BM_PresenceOr_Const<Sparsity::Sparse>)->Arg(32)->Arg(320);
 
+// Presence operators on text arrays touch only the bitmaps, so the time must
+// not depend on the length of the strings (the second argument).
+template <typename Fn>
+void BM_TextPresence(benchmark::State& state, Fn fn) {
+  CHECK_OK(InitArolla());
+
+  int64_t size = state.range(0);
+  int64_t text_length = state.range(1);
+  absl::BitGen gen;
+  DenseArray<float> x = RandomDenseArray<float>(size, false, 0, gen);
+  DenseArray<Text> text = CreateConstDenseArray<Text>(
+      size, Text(std::string(text_length, 'a')));
+  text.bitmap = x.bitmap;
+  DenseArray<Unit> mask = {VoidBuffer(size), x.bitmap};
+  UnsafeArenaBufferFactory arena(1024 * 1024);
+  FrameLayout frame_layout;
+  RootEvaluationContext root_ctx(&frame_layout, &arena);
+  EvaluationContext ctx(root_ctx);
+
+  for (auto s : state) {
+    arena.Reset();
+    auto res = fn(&ctx, text, mask);
+    benchmark::DoNotOptimize(res);
+  }
+  state.SetItemsProcessed(size * state.iterations());
+}
+
+void BM_TextHas(benchmark::State& state) {
+  BM_TextPresence(state, [](EvaluationContext*, const DenseArray<Text>& text,
+                            const DenseArray<Unit>&) {
+    return DenseArrayHasOp()(text);
+  });
+}
+
+void BM_TextPresenceNot(benchmark::State& state) {
+  BM_TextPresence(state, [](EvaluationContext* ctx,
+                            const DenseArray<Text>& text,
+                            const DenseArray<Unit>&) {
+    return DenseArrayPresenceNotOp()(ctx, text);
+  });
+}
+
+void BM_TextPresenceAnd(benchmark::State& state) {
+  BM_TextPresence(state, [](EvaluationContext* ctx,
+                            const DenseArray<Text>& text,
+                            const DenseArray<Unit>& mask) {
+    return DenseArrayPresenceAndOp()(ctx, text, mask);
+  });
+}
+
+#define TEXT_PRESENCE_ARGS \
+  ArgPair(320, 1)->ArgPair(320, 1000)->ArgPair(32000, 1)->ArgPair(32000, 1000)
+
+BENCHMARK(BM_TextHas)->TEXT_PRESENCE_ARGS;
+BENCHMARK(BM_TextPresenceNot)->TEXT_PRESENCE_ARGS;
+BENCHMARK(BM_TextPresenceAnd)->TEXT_PRESENCE_ARGS;
+
 template <typename T>
 void BM_Expand(benchmark::State& state, const T& value, bool sparse) {
   int64_t parent_size = state.range(0);
@@ -320,5 +381,74 @@ BENCHMARK(BM_ExpandInt_sparse)->Apply(kExpandArgsFn);
 BENCHMARK(BM_ExpandText_full)->Apply(kExpandArgsFn);
 BENCHMARK(BM_ExpandText_sparse)->Apply(kExpandArgsFn);
 
+// Args: total size, group size. Groups of at least 1024 elements use radix
+// sort.
+void BM_OrdinalRank(benchmark::State& state) {
+  int64_t size = state.range(0);
+  int64_t group_size = state.range(1);
+  absl::BitGen gen;
+  DenseArrayBuilder<float> values_bldr(size);
+  DenseArrayBuilder<int64_t> tie_breakers_bldr(size);
+  for (int64_t i = 0; i < size; ++i) {
+    values_bldr.Set(i, absl::Uniform<float>(gen, 0, 1000));
+    tie_breakers_bldr.Set(i, absl::Uniform<int64_t>(gen, 0, 10));
+  }
+  auto values = std::move(values_bldr).Build();
+  auto tie_breakers = std::move(tie_breakers_bldr).Build();
+  auto edge = DenseArrayEdge::FromUniformGroups(size / group_size, group_size)
+                  .value();
+  DenseGroupOps<OrdinalRankAccumulator<float, int64_t>> op(
+      GetHeapBufferFactory());
+  for (auto s : state) {
+    benchmark::DoNotOptimize(values);
+    auto res = op.Apply(edge, values, tie_breakers);
+    benchmark::DoNotOptimize(res);
+  }
+  state.SetItemsProcessed(size * state.iterations());
+}
+
+BENCHMARK(BM_OrdinalRank)
+    ->ArgPair(1 << 20, 16)
+    ->ArgPair(1 << 20, 1 << 10)
+    ->ArgPair(1 << 20, 1 << 20);
+
+// Args: values size, ids size. Both arrays have ~10% missing elements.
+void BM_DenseArrayAtGather(benchmark::State& state) {
+  int64_t values_size = state.range(0);
+  int64_t ids_size = state.range(1);
+  absl::BitGen gen;
+  DenseArrayBuilder<float> values_bldr(values_size);
+  for (int64_t i = 0; i < values_size; ++i) {
+    if (absl::Bernoulli(gen, 0.9)) {
+      values_bldr.Set(i, i);
+    }
+  }
+  DenseArrayBuilder<int64_t> ids_bldr(ids_size);
+  for (int64_t i = 0; i < ids_size; ++i) {
+    if (absl::Bernoulli(gen, 0.9)) {
+      ids_bldr.Set(i, absl::Uniform<int64_t>(gen, 0, values_size));
+    }
+  }
+  auto values = std::move(values_bldr).Build();
+  auto ids = std::move(ids_bldr).Build();
+
+  FrameLayout frame_layout;
+  RootEvaluationContext root_ctx(&frame_layout, GetHeapBufferFactory());
+  EvaluationContext ctx(root_ctx);
+  DenseArrayAtOp op;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(values);
+    benchmark::DoNotOptimize(ids);
+    auto res = op(&ctx, values, ids);
+    benchmark::DoNotOptimize(res);
+  }
+  state.SetItemsProcessed(ids_size * state.iterations());
+}
+
+BENCHMARK(BM_DenseArrayAtGather)
+    ->ArgPair(1 << 10, 1 << 20)
+    ->ArgPair(1 << 20, 1 << 20)
+    ->ArgPair(50'000'000, 1 << 20);
+
 }  // namespace
 }  // namespace arolla::testing
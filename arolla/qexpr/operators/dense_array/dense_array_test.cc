@@ -14,13 +14,19 @@
 //
 #include "arolla/dense_array/dense_array.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <type_traits>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
@@ -30,6 +36,7 @@
 #include "arolla/qexpr/operators/dense_array/lifter.h"
 #include "arolla/qexpr/operators/testing/accumulators.h"
 #include "arolla/util/meta.h"
+#include "arolla/util/row_errors.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/text.h"
 
@@ -90,6 +97,126 @@ TEST(Lifter, UnaryOperation) {
   EXPECT_THAT(res, ElementsAre(2, std::nullopt, 3, 4));
 }
 
+struct AddOneWithBatchOpFn {
+  // Produces a different result so that the test can tell which implementation
+  // was used.
+  struct BatchAddTen {
+    void operator()(absl::Span<int> res, absl::Span<const int> arg) const {
+      for (size_t i = 0; i < res.size(); ++i) {
+        res[i] = arg[i] + 10;
+      }
+    }
+  };
+  using batch_op = BatchAddTen;
+
+  int operator()(int a) const { return a + 1; }
+};
+
+TEST(Lifter, UnaryOperationWithBatchOp) {
+  DenseArray<int> arr = CreateDenseArray<int>({1, {}, 2, 3});
+
+  FrameLayout frame_layout;
+  RootEvaluationContext root_ctx(&frame_layout, GetHeapBufferFactory());
+  EvaluationContext ctx(root_ctx);
+  auto op = DenseArrayLifter<AddOneWithBatchOpFn, meta::type_list<int>>();
+  ASSERT_OK_AND_ASSIGN(DenseArray<int> res, op(&ctx, arr));
+
+  EXPECT_THAT(res, ElementsAre(11, std::nullopt, 12, 13));
+}
+
+struct CheckedAddOneWithBatchOpFn {
+  // Rejects the values that the pointwise implementation would fail on,
+  // including the ones in missing rows.
+  struct BatchAddTen {
+    bool operator()(absl::Span<int64_t> res, absl::Span<const int> arg) const {
+      bool ok = true;
+      for (size_t i = 0; i < res.size(); ++i) {
+        res[i] = arg[i] + 10;
+        ok &= arg[i] >= 0;
+      }
+      return ok;
+    }
+  };
+  using batch_op = BatchAddTen;
+
+  absl::StatusOr<int64_t> operator()(int a) const {
+    if (a < 0) {
+      return absl::InvalidArgumentError("negative");
+    }
+    return a + 1;
+  }
+};
+
+TEST(Lifter, UnaryOperationWithFallibleBatchOp) {
+  FrameLayout frame_layout;
+  RootEvaluationContext root_ctx(&frame_layout, GetHeapBufferFactory());
+  EvaluationContext ctx(root_ctx);
+  auto op =
+      DenseArrayLifter<CheckedAddOneWithBatchOpFn, meta::type_list<int>>();
+  {
+    ASSERT_OK_AND_ASSIGN(DenseArray<int64_t> res,
+                         op(&ctx, CreateDenseArray<int>({1, {}, 2, 3})));
+    EXPECT_THAT(res, ElementsAre(11, std::nullopt, 12, 13));
+  }
+  {
+    // The batch op rejects a missing value, so the pointwise implementation
+    // is used.
+    DenseArray<int> arr = CreateDenseArray<int>({1, {}, 2, 3});
+    arr.values = CreateBuffer<int>({1, -1, 2, 3});
+    ASSERT_OK_AND_ASSIGN(DenseArray<int64_t> res, op(&ctx, arr));
+    EXPECT_THAT(res, ElementsAre(2, std::nullopt, 3, 4));
+  }
+  EXPECT_THAT(op(&ctx, CreateDenseArray<int>({1, -1})),
+              StatusIs(absl::StatusCode::kInvalidArgument, "negative"));
+}
+
+TEST(Lifter, RowErrors) {
+  FrameLayout frame_layout;
+  RootEvaluationContext root_ctx(&frame_layout, GetHeapBufferFactory());
+  RowErrors row_errors;
+  root_ctx.set_row_errors(&row_errors);
+  EvaluationContext ctx(root_ctx);
+  auto op =
+      DenseArrayLifter<CheckedAddOneWithBatchOpFn, meta::type_list<int>>();
+  ASSERT_OK_AND_ASSIGN(DenseArray<int64_t> res,
+                       op(&ctx, CreateDenseArray<int>({1, -1, {}, 3, -5})));
+  EXPECT_THAT(res, ElementsAre(2, std::nullopt, std::nullopt, 4, std::nullopt));
+  EXPECT_THAT(row_errors.row_ids(), ElementsAre(1, 4));
+  ASSERT_EQ(row_errors.errors().size(), 2);
+  EXPECT_THAT(row_errors.errors()[0].status,
+              StatusIs(absl::StatusCode::kInvalidArgument, "negative"));
+  EXPECT_TRUE(ctx.status().ok());
+}
+
+struct IdentityOnSameTypeFn {
+  using is_identity_on_same_type = std::true_type;
+
+  template <typename T>
+  int64_t operator()(T a) const {
+    return a;
+  }
+};
+
+TEST(Lifter, IdentityOnSameType) {
+  FrameLayout frame_layout;
+  RootEvaluationContext root_ctx(&frame_layout, GetHeapBufferFactory());
+  EvaluationContext ctx(root_ctx);
+  {
+    DenseArray<int64_t> arr = CreateDenseArray<int64_t>({1, {}, 2});
+    auto op = DenseArrayLifter<IdentityOnSameTypeFn,
+                               meta::type_list<int64_t>>();
+    ASSERT_OK_AND_ASSIGN(DenseArray<int64_t> res, op(&ctx, arr));
+    EXPECT_THAT(res, ElementsAre(1, std::nullopt, 2));
+    EXPECT_EQ(res.values.span().data(), arr.values.span().data());
+  }
+  {
+    DenseArray<int> arr = CreateDenseArray<int>({1, {}, 2});
+    auto op = DenseArrayLifter<IdentityOnSameTypeFn, meta::type_list<int>>();
+    ASSERT_OK_AND_ASSIGN(DenseArray<int64_t> res, op(&ctx, arr));
+    EXPECT_THAT(res, ElementsAre(1, std::nullopt, 2));
+  }
+}
+
 TEST(Lifter, NonLiftableArg) {
   DenseArray<int> arr = CreateDenseArray<int>({1, {}, 2, 3});
 
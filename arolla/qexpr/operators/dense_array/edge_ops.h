@@ -20,6 +20,7 @@
 #include <cstring>
 #include <memory>
 #include <numeric>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -223,9 +224,19 @@ struct DenseArrayExpandOp {
           {edge.parent_size(), parent_array.size()});
     }
     if (edge.edge_type() == DenseArrayEdge::EdgeType::SPLIT_POINTS) {
-      absl::Span<const int64_t> split_points = edge.edge_values().values.span();
+      // Uniform edges don't store the split points, so they are computed on
+      // the fly.
+      DenseArraySplitPoints split_points(edge);
+      if (auto group_size = edge.uniform_group_size();
+          group_size.has_value() ? *group_size == 1
+                                 : IsIdentitySplitPoints(
+                                       edge.edge_values().values.span())) {
+        // Note: we use ForceNoBimapBitOffset because for performance reasons
+        // `lift_to_dense_array` has NoBitmapOffset=true.
+        return parent_array.ForceNoBitmapBitOffset(&ctx->buffer_factory());
+      }
       typename Buffer<T>::ReshuffleBuilder values_bldr(
-          split_points.back(), parent_array.values, {}, &ctx->buffer_factory());
+          edge.child_size(), parent_array.values, {}, &ctx->buffer_factory());
       if (parent_array.bitmap.empty()) {
         for (size_t i = 0; i < parent_array.size(); ++i) {
           values_bldr.CopyValueToRange(split_points[i], split_points[i + 1], i);
@@ -233,16 +244,24 @@ struct DenseArrayExpandOp {
         return DenseArray<T>{std::move(values_bldr).Build()};
       } else {
         bitmap::Bitmap::Builder bitmap_bldr(
-            bitmap::BitmapSize(split_points.back()), &ctx->buffer_factory());
+            bitmap::BitmapSize(edge.child_size()), &ctx->buffer_factory());
         absl::Span<bitmap::Word> bits = bitmap_bldr.GetMutableSpan();
         std::memset(bits.begin(), 0, bits.size() * sizeof(bitmap::Word));
-        for (size_t i = 0; i < parent_array.size(); ++i) {
-          if (parent_array.present(i)) {
-            values_bldr.CopyValueToRange(split_points[i], split_points[i + 1],
-                                         i);
-            SetBitsInRange(bits.begin(), split_points[i], split_points[i + 1]);
-          }
-        }
+        // Each present parent is expanded with a run fill of the values and of
+        // the presence bits.
+        bitmap::IterateByGroups(
+            parent_array.bitmap.begin(), parent_array.bitmap_bit_offset,
+            parent_array.size(), [&](int64_t offset) {
+              return [&values_bldr, bits = bits.begin(), split_points,
+                      offset](int i, bool present) {
+                if (present) {
+                  int64_t from = split_points[offset + i];
+                  int64_t to = split_points[offset + i + 1];
+                  values_bldr.CopyValueToRange(from, to, offset + i);
+                  SetBitsInRange(bits, from, to);
+                }
+              };
+            });
         return DenseArray<T>{std::move(values_bldr).Build(),
                              std::move(bitmap_bldr).Build()};
       }
@@ -276,6 +295,22 @@ struct DenseArrayExpandOp {
                                       &ctx->buffer_factory());
     }
   }
+
+ private:
+  // Returns true if every group consists of exactly one child, so the
+  // expansion does not change the array.
+  static bool IsIdentitySplitPoints(absl::Span<const int64_t> split_points) {
+    const int64_t size = split_points.size();
+    if (split_points.back() != size - 1) {
+      return false;
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      if (split_points[i] != i) {
+        return false;
+      }
+    }
+    return true;
+  }
 };
 
 // Returns an edge that maps the unique values of the input array to the same
@@ -286,8 +321,14 @@ struct DenseArrayGroupByOp {
                                             const DenseArray<T>& series,
                                             const Edge& over) const {
     int64_t group_counter = 0;
+    // With a scalar edge all the values belong to the same group.
+    int64_t group_size_hint = 0;
+    if constexpr (std::is_same_v<Edge, DenseArrayGroupScalarEdge>) {
+      group_size_hint = series.PresentCount();
+    }
     DenseGroupOps<GroupByAccumulator<T>> op(
-        &ctx->buffer_factory(), GroupByAccumulator<T>(&group_counter));
+        &ctx->buffer_factory(),
+        GroupByAccumulator<T>(&group_counter, group_size_hint));
     ASSIGN_OR_RETURN(DenseArray<int64_t> mapping, op.Apply(over, series));
     return DenseArrayEdge::UnsafeFromMapping(std::move(mapping), group_counter);
   }
@@ -15,6 +15,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -37,6 +38,7 @@ namespace {
 using ::arolla::testing::IsOkAndHolds;
 using ::arolla::testing::StatusIs;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::HasSubstr;
 
 class EdgeOpsTest : public ::testing::Test {
@@ -189,6 +191,61 @@ TEST_F(EdgeOpsTest, ExpandOverSplitPointsNoBitmap) {
   EXPECT_EQ(values[1].value.begin(), res[6].value.begin());
 }
 
+TEST_F(EdgeOpsTest, ExpandOverSplitPointsLarge) {
+  // More than one bitmap word, with a non-zero bitmap offset.
+  std::vector<std::optional<int>> parent_values(100);
+  std::vector<int64_t> split_points = {0};
+  std::vector<std::optional<int>> expected;
+  for (int i = 0; i < parent_values.size(); ++i) {
+    if (i % 3 != 0) {
+      parent_values[i] = i;
+    }
+  }
+  auto values = CreateDenseArray<int>(parent_values).Slice(5, 90);
+  for (int64_t i = 0; i < values.size(); ++i) {
+    split_points.push_back(split_points.back() + i % 4);
+    for (int64_t j = 0; j < i % 4; ++j) {
+      expected.push_back(values[i].AsOptional());
+    }
+  }
+  ASSERT_OK_AND_ASSIGN(auto edge, DenseArrayEdge::FromSplitPoints(
+                                      CreateFullDenseArray(split_points)));
+  EXPECT_THAT(InvokeOperator<DenseArray<int>>("array._expand", values, edge),
+              IsOkAndHolds(ElementsAreArray(expected)));
+}
+
+TEST_F(EdgeOpsTest, ExpandOverIdentitySplitPoints) {
+  auto values = CreateDenseArray<int>({1, std::nullopt, 3});
+  ASSERT_OK_AND_ASSIGN(auto edge, DenseArrayEdge::FromSplitPoints(
+                                      CreateDenseArray<int64_t>({0, 1, 2, 3})));
+  ASSERT_OK_AND_ASSIGN(auto res, InvokeOperator<DenseArray<int>>(
+                                     "array._expand", values, edge));
+  EXPECT_THAT(res, ElementsAre(1, std::nullopt, 3));
+  // The buffers are shared with the input.
+  EXPECT_EQ(res.values.span().data(), values.values.span().data());
+  EXPECT_EQ(res.bitmap.span().data(), values.bitmap.span().data());
+}
+
+TEST_F(EdgeOpsTest, ExpandOverUniformGroups) {
+  auto values = CreateDenseArray<int>({1, std::nullopt, 3});
+  ASSERT_OK_AND_ASSIGN(auto edge, DenseArrayEdge::FromUniformGroups(3, 2));
+  EXPECT_THAT(InvokeOperator<DenseArray<int>>("array._expand", values, edge),
+              IsOkAndHolds(
+                  ElementsAre(1, 1, std::nullopt, std::nullopt, 3, 3)));
+  EXPECT_THAT(
+      InvokeOperator<DenseArray<int>>(
+          "array._expand", CreateFullDenseArray<int>({1, 2, 3}), edge),
+      IsOkAndHolds(ElementsAre(1, 1, 2, 2, 3, 3)));
+
+  // Groups of size 1 share the buffers with the input.
+  ASSERT_OK_AND_ASSIGN(auto identity_edge,
+                       DenseArrayEdge::FromUniformGroups(3, 1));
+  ASSERT_OK_AND_ASSIGN(auto res, InvokeOperator<DenseArray<int>>(
+                                     "array._expand", values, identity_edge));
+  EXPECT_THAT(res, ElementsAre(1, std::nullopt, 3));
+  EXPECT_EQ(res.values.span().data(), values.values.span().data());
+}
+
 TEST_F(EdgeOpsTest, ExpandGroupScalarEdge) {
   auto edge = DenseArrayGroupScalarEdge(3);
 
@@ -13,6 +13,7 @@
 // limitations under the License.
 //
 #include <cstdint>
+#include <limits>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -21,8 +22,10 @@
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
 #include "arolla/qexpr/operators.h"
+#include "arolla/qexpr/operators/dense_array/random.h"
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/unit.h"
 
 namespace arolla {
@@ -30,8 +33,14 @@ namespace {
 
 using ::arolla::testing::IsOkAndHolds;
 using ::arolla::testing::StatusIs;
+using ::testing::AllOf;
+using ::testing::Contains;
+using ::testing::Each;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Le;
 
 class FactoryOpsTest : public ::testing::Test {
  protected:
@@ -67,5 +76,49 @@ TEST_F(FactoryOpsTest, ResizeArrayShape_DenseArray) {
               StatusIs(absl::StatusCode::kInvalidArgument, "bad size: -1"));
 }
 
+TEST_F(FactoryOpsTest, CounterBasedRandIntWithShape) {
+  ASSERT_OK_AND_ASSIGN(auto res, InvokeOperator<DenseArray<int64_t>>(
+                                     "array._counter_based_randint_with_shape",
+                                     DenseArrayShape{1000}, int64_t{-5},
+                                     int64_t{5}, int64_t{57}));
+  ASSERT_EQ(res.size(), 1000);
+  EXPECT_TRUE(res.IsFull());
+  EXPECT_THAT(res.values, Each(AllOf(Ge(-5), Le(5))));
+  EXPECT_THAT(res.values, Contains(-5));
+  EXPECT_THAT(res.values, Contains(5));
+
+  // Prefixes coincide for different sizes.
+  ASSERT_OK_AND_ASSIGN(
+      auto prefix, InvokeOperator<DenseArray<int64_t>>(
+                       "array._counter_based_randint_with_shape",
+                       DenseArrayShape{7}, int64_t{-5}, int64_t{5},
+                       int64_t{57}));
+  EXPECT_THAT(prefix.values, ElementsAreArray(res.values.span().subspan(0, 7)));
+
+  // Full int64 range.
+  EXPECT_OK(InvokeOperator<DenseArray<int64_t>>(
+      "array._counter_based_randint_with_shape", DenseArrayShape{10},
+      std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(),
+      int64_t{57}));
+
+  EXPECT_THAT(InvokeOperator<DenseArray<int64_t>>(
+                  "array._counter_based_randint_with_shape",
+                  DenseArrayShape{10}, int64_t{5}, int64_t{4}, int64_t{57}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "low=5 is greater than high=4"));
+}
+
+TEST_F(FactoryOpsTest, CounterBasedRandIntWithShape_Threading) {
+  DenseArrayShape shape{(1 << 18) + 3};
+  ASSERT_OK_AND_ASSIGN(auto expected,
+                       CounterBasedRandIntWithDenseArrayShape::Generate(
+                           shape, 0, 1000, 57, /*threading=*/nullptr));
+  StdThreading threading(5);
+  ASSERT_OK_AND_ASSIGN(auto res,
+                       CounterBasedRandIntWithDenseArrayShape::Generate(
+                           shape, 0, 1000, 57, &threading));
+  EXPECT_THAT(res.values, ElementsAreArray(expected.values));
+}
+
 }  // namespace
 }  // namespace arolla
@@ -15,11 +15,14 @@
 #ifndef AROLLA_QEXPR_OPERATORS_DENSE_ARRAY_LIFTER_H_
 #define AROLLA_QEXPR_OPERATORS_DENSE_ARRAY_LIFTER_H_
 
+#include <optional>
 #include <type_traits>
 
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/ops/dense_ops.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/lifting.h"
@@ -32,6 +35,20 @@ namespace arolla {
 // SimpleOperator. Fn is a pointwise functor.
 // If the operator is cheaper than a single conditional jump, it is recommended
 // to add "using run_on_missing = std::true_type;" to the functor definition.
+// A unary functor without side effects may also provide a vectorized
+// implementation via "using batch_op = SpanFn;", where SpanFn is default
+// constructible and callable as `SpanFn()(absl::Span<R> res,
+// absl::Span<const T> arg)`. It is applied to all the values, including the
+// missing ones. If SpanFn returns bool, `false` means that some of the values
+// (potentially a missing one) cannot be processed, and the operator falls back
+// to the pointwise implementation.
+// If Fn returns absl::StatusOr and EvaluationContext::row_errors() is set, the
+// rows where Fn fails become missing in the output and are recorded in
+// row_errors() instead of failing the operator.
+// A unary functor returning its argument unchanged if the argument and the
+// output types coincide may declare "using is_identity_on_same_type =
+// std::true_type;". The lifted operator then returns the argument as is,
+// sharing its buffers.
 // Limitations on Fn:
 // 1) If operator has an argument of type `DenseArray<T>`, then the
 //   corresponding argument of Fn should have type `view_type_t<T>` or
@@ -53,6 +70,35 @@ template <class T>
 struct IsRunOnMissingOp<T, std::void_t<typename T::run_on_missing>>
     : std::true_type {};
 
+template <class, class = void>
+struct HasBatchOp : std::false_type {};
+template <class T>
+struct HasBatchOp<T, std::void_t<typename T::batch_op>> : std::true_type {};
+
+template <class, class = void>
+struct IsIdentityOnSameTypeOp : std::false_type {};
+template <class T>
+struct IsIdentityOnSameTypeOp<T,
+                              std::void_t<typename T::is_identity_on_same_type>>
+    : T::is_identity_on_same_type {};
+
+template <class Fn, class ResT, class ArgT, class = void>
+struct BatchOpResult {
+  using type = void;
+  static constexpr bool kApplicable = false;
+};
+template <class Fn, class ResT, class ArgT>
+struct BatchOpResult<
+    Fn, ResT, ArgT,
+    std::void_t<std::invoke_result_t<const typename Fn::batch_op&,
+                                     absl::Span<ResT>,
+                                     absl::Span<const ArgT>>>> {
+  using type = std::invoke_result_t<const typename Fn::batch_op&,
+                                    absl::Span<ResT>, absl::Span<const ArgT>>;
+  static constexpr bool kApplicable =
+      std::is_void_v<type> || std::is_same_v<type, bool>;
+};
+
 template <class Fn, bool NoBitmapOffset, class... Args>
 class DenseArrayLifter<Fn, meta::type_list<Args...>, NoBitmapOffset> {
  private:
@@ -84,6 +130,23 @@ class DenseArrayLifter<Fn, meta::type_list<Args...>, NoBitmapOffset> {
       decltype(Fn()(
           std::declval<meta::strip_template_t<DoNotLiftTag, Args>>()...))>>;
 
+  static constexpr bool kIsIdentity =
+      IsIdentityOnSameTypeOp<Fn>::value && sizeof...(Args) == 1 &&
+      (std::is_same_v<Args, OutputValueT> && ...);
+
+  static constexpr bool kReturnsStatus = meta::is_wrapped_with_v<
+      absl::StatusOr,
+      decltype(Fn()(
+          std::declval<meta::strip_template_t<DoNotLiftTag, Args>>()...))>;
+
+  static constexpr int kDenseOpFlags =
+      (NoBitmapOffset ? DenseOpFlags::kNoBitmapOffset : 0) |
+      (IsRunOnMissingOp<Fn>::value ? DenseOpFlags::kRunOnMissing : 0);
+
+  static constexpr bool kUseBatchOp =
+      sizeof...(Args) == 1 &&
+      (BatchOpResult<Fn, OutputValueT, Args>::kApplicable && ...);
+
  public:
   // Create an operation that captures all arguments marked with `DoNotLiftTag`
   // and accept other arguments as `DenseArray` in the same order.
@@ -94,19 +157,65 @@ class DenseArrayLifter<Fn, meta::type_list<Args...>, NoBitmapOffset> {
     using Tools = LiftingTools<Args...>;
     auto strict_fn = Tools::template CreateFnWithDontLiftCaptured<view_type_t>(
         Fn(), args...);
-    constexpr int flags =
-        ExtraFlags | (NoBitmapOffset ? DenseOpFlags::kNoBitmapOffset : 0) |
-        (IsRunOnMissingOp<Fn>::value ? DenseOpFlags::kRunOnMissing : 0);
-    return CreateDenseOp<flags, decltype(strict_fn), OutputValueT>(
-        strict_fn, &ctx->buffer_factory());
+    return CreateDenseOp<ExtraFlags | kDenseOpFlags, decltype(strict_fn),
+                         OutputValueT>(strict_fn, &ctx->buffer_factory());
   }
 
   auto operator()(EvaluationContext* ctx,
                   const LiftedType<Args>&... args) const {
-    using Tools = LiftingTools<Args...>;
     using ResT = absl::StatusOr<DenseArray<OutputValueT>>;
+    if constexpr (kIsIdentity) {
+      return ResT(args...);
+    } else if constexpr (kUseBatchOp) {
+      if constexpr ((std::is_same_v<
+                         typename BatchOpResult<Fn, OutputValueT, Args>::type,
+                         bool> &&
+                     ...)) {
+        if (auto res = TryBatchOp(ctx, args...); res.has_value()) {
+          return ResT(*std::move(res));
+        }
+        return ApplyPointwise(ctx, args...);
+      } else {
+        auto op = CreateDenseUnaryOpFromSpanOp<OutputValueT>(
+            typename Fn::batch_op(), &ctx->buffer_factory());
+        return ResT(op(args...));
+      }
+    } else {
+      return ApplyPointwise(ctx, args...);
+    }
+  }
+
+ private:
+  absl::StatusOr<DenseArray<OutputValueT>> ApplyPointwise(
+      EvaluationContext* ctx, const LiftedType<Args>&... args) const {
+    using Tools = LiftingTools<Args...>;
+    if constexpr (kReturnsStatus) {
+      if (ctx->row_errors() != nullptr) {
+        auto strict_fn =
+            Tools::template CreateFnWithDontLiftCaptured<view_type_t>(Fn(),
+                                                                      args...);
+        auto op = CreateDenseOpWithRowErrors<kDenseOpFlags, decltype(strict_fn),
+                                             OutputValueT>(
+            strict_fn, ctx->row_errors(), &ctx->buffer_factory());
+        return Tools::CallOnLiftedArgs(op, args...);
+      }
+    }
     auto op = CreateDenseOpWithCapturedScalars<0>(ctx, args...);
-    return ResT(Tools::CallOnLiftedArgs(op, args...));
+    return Tools::CallOnLiftedArgs(op, args...);
+  }
+
+  // Applies the batch op returning bool to all the values. Returns nullopt if
+  // the batch op has rejected some of them.
+  template <class ArgT>
+  static std::optional<DenseArray<OutputValueT>> TryBatchOp(
+      EvaluationContext* ctx, const DenseArray<ArgT>& arg) {
+    typename Buffer<OutputValueT>::Builder builder(arg.size(),
+                                                   &ctx->buffer_factory());
+    if (!typename Fn::batch_op()(builder.GetMutableSpan(), arg.values.span())) {
+      return std::nullopt;
+    }
+    return DenseArray<OutputValueT>{std::move(builder).Build(), arg.bitmap,
+                                    arg.bitmap_bit_offset};
   }
 };
 
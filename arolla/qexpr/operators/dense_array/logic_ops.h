@@ -15,8 +15,10 @@
 #ifndef AROLLA_QEXPR_OPERATORS_DENSE_ARRAY_LOGIC_OPS_H_
 #define AROLLA_QEXPR_OPERATORS_DENSE_ARRAY_LOGIC_OPS_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <type_traits>
 #include <utility>
 
 #include "absl/base/optimization.h"
@@ -28,11 +30,72 @@
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
 #include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/util/unit.h"
 #include "arolla/util/view_types.h"
 
 namespace arolla {
+namespace dense_array_logic_ops_impl {
+
+// Returns the presence bits
+// [index * kWordBitCount, (index + 1) * kWordBitCount) of the array. All bits
+// are set if the array has no bitmap.
+template <typename T>
+bitmap::Word GetPresenceWord(const DenseArray<T>& array, int64_t index) {
+  return array.bitmap.empty()
+             ? bitmap::kFullWord
+             : bitmap::GetWordWithOffset(array.bitmap, index,
+                                         array.bitmap_bit_offset);
+}
+
+// True if the values are stored in SimpleBuffer, so they can be copied by
+// whole words.
+template <typename T>
+constexpr bool kHasSimpleValues = std::is_same_v<Buffer<T>, SimpleBuffer<T>>;
+
+// core.presence_or on arrays of the same size with simple values. Processes
+// the presence word by word, so the values of a block of kWordBitCount rows
+// are copied at once unless both arguments contribute to the block.
+template <typename T, typename RhsWordFn, typename CopyRhsFn>
+DenseArray<T> PresenceOrByWords(const DenseArray<T>& lhs,
+                                RhsWordFn rhs_word_fn, CopyRhsFn copy_rhs_fn,
+                                RawBufferFactory* buffer_factory) {
+  const int64_t size = lhs.size();
+  typename Buffer<T>::Builder values_bldr(size, buffer_factory);
+  absl::Span<T> values = values_bldr.GetMutableSpan();
+  absl::Span<const T> lhs_values = lhs.values.span();
+  bitmap::RawBuilder bitmap_bldr(bitmap::BitmapSize(size), buffer_factory);
+  absl::Span<bitmap::Word> bitmap = bitmap_bldr.GetMutableSpan();
+  bool full = true;
+  for (int64_t w = 0; w < bitmap.size(); ++w) {
+    const int64_t offset = w * bitmap::kWordBitCount;
+    const int count = std::min<int64_t>(bitmap::kWordBitCount, size - offset);
+    const bitmap::Word valid_bits =
+        bitmap::kFullWord >> (bitmap::kWordBitCount - count);
+    const bitmap::Word lhs_word = GetPresenceWord(lhs, w) & valid_bits;
+    if (lhs_word == valid_bits) {
+      std::copy_n(lhs_values.begin() + offset, count, values.begin() + offset);
+    } else {
+      copy_rhs_fn(values.subspan(offset, count), offset);
+      if (lhs_word != 0) {
+        for (int i = 0; i < count; ++i) {
+          if (bitmap::GetBit(lhs_word, i)) {
+            values[offset + i] = lhs_values[offset + i];
+          }
+        }
+      }
+    }
+    bitmap[w] = lhs_word | (rhs_word_fn(w) & valid_bits);
+    full = full && bitmap[w] == valid_bits;
+  }
+  if (full) {
+    return {std::move(values_bldr).Build()};
+  }
+  return {std::move(values_bldr).Build(), std::move(bitmap_bldr).Build()};
+}
+
+}  // namespace dense_array_logic_ops_impl
 
 // Convert DenseArray<T> into DenseArray<Unit>, retaining only the presence
 // data.
@@ -112,8 +175,34 @@ struct DenseArrayPresenceOrOp {
     }
     if (lhs.bitmap.empty()) {
       return lhs;
-    } else if (bitmap::AreAllBitsUnset(lhs.bitmap.begin(), lhs.size())) {
+    }
+    const int64_t lhs_present_count =
+        bitmap::CountBits(lhs.bitmap, lhs.bitmap_bit_offset, lhs.size());
+    if (lhs_present_count == lhs.size()) {
+      return lhs;
+    } else if (lhs_present_count == 0) {
       return rhs;
+    }
+    using dense_array_logic_ops_impl::GetPresenceWord;
+    if constexpr (std::is_same_v<T, Unit>) {
+      if (rhs.bitmap.empty()) {
+        return DenseArray<Unit>{VoidBuffer(lhs.size())};
+      }
+      bitmap::RawBuilder bldr(bitmap::BitmapSize(lhs.size()),
+                              &ctx->buffer_factory());
+      absl::Span<bitmap::Word> bitmap = bldr.GetMutableSpan();
+      for (int64_t w = 0; w < bitmap.size(); ++w) {
+        bitmap[w] = GetPresenceWord(lhs, w) | GetPresenceWord(rhs, w);
+      }
+      return DenseArray<Unit>{VoidBuffer(lhs.size()), std::move(bldr).Build()};
+    } else if constexpr (dense_array_logic_ops_impl::kHasSimpleValues<T>) {
+      return dense_array_logic_ops_impl::PresenceOrByWords(
+          lhs, [&](int64_t w) { return GetPresenceWord(rhs, w); },
+          [&](absl::Span<T> values, int64_t offset) {
+            std::copy_n(rhs.values.begin() + offset, values.size(),
+                        values.begin());
+          },
+          &ctx->buffer_factory());
     } else {
       auto fn = [&](OptionalValue<view_type_t<T>> a,
                     OptionalValue<view_type_t<T>> b) {
@@ -123,7 +212,6 @@ struct DenseArrayPresenceOrOp {
                                              a.present ? a.value : b.value};
       };
       return CreateDenseOp<DenseOpFlags::kRunOnMissing |
-                               DenseOpFlags::kNoBitmapOffset |
                                DenseOpFlags::kNoSizeValidation,
                            decltype(fn), T>(fn, &ctx->buffer_factory())(lhs,
                                                                         rhs);
@@ -135,15 +223,29 @@ struct DenseArrayPresenceOrOp {
                            const OptionalValue<T>& rhs) const {
     if (!rhs.present || lhs.bitmap.empty()) {
       return lhs;
-    } else if (bitmap::AreAllBitsUnset(lhs.bitmap.begin(), lhs.size())) {
+    }
+    const int64_t lhs_present_count =
+        bitmap::CountBits(lhs.bitmap, lhs.bitmap_bit_offset, lhs.size());
+    if (lhs_present_count == lhs.size()) {
+      return lhs;
+    } else if (lhs_present_count == 0) {
       return CreateConstDenseArray<T>(/*size=*/lhs.size(), rhs.value,
                                       &ctx->buffer_factory());
+    }
+    if constexpr (std::is_same_v<T, Unit>) {
+      return DenseArray<Unit>{VoidBuffer(lhs.size())};
+    } else if constexpr (dense_array_logic_ops_impl::kHasSimpleValues<T>) {
+      return dense_array_logic_ops_impl::PresenceOrByWords(
+          lhs, [](int64_t) { return bitmap::kFullWord; },
+          [&](absl::Span<T> values, int64_t) {
+            std::fill(values.begin(), values.end(), rhs.value);
+          },
+          &ctx->buffer_factory());
     } else {
       auto fn = [value = rhs.value](OptionalValue<view_type_t<T>> a) {
         return a.present ? a.value : value;
       };
       return CreateDenseOp<DenseOpFlags::kRunOnMissing |
-                               DenseOpFlags::kNoBitmapOffset |
                                DenseOpFlags::kNoSizeValidation,
                            decltype(fn), T>(fn, &ctx->buffer_factory())(lhs);
     }
@@ -13,6 +13,7 @@
 // limitations under the License.
 //
 
+#include <cstdint>
 #include <optional>
 #include <vector>
 
@@ -20,8 +21,12 @@
 #include "gtest/gtest.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/operators.h"
+#include "arolla/qexpr/operators/dense_array/logic_ops.h"
+#include "arolla/util/bytes.h"
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/unit.h"
@@ -31,6 +36,7 @@ namespace {
 
 using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
 
 class LogicOpsTest : public ::testing::Test {
   void SetUp() final { ASSERT_OK(InitArolla()); }
@@ -138,6 +144,72 @@ TEST_F(LogicOpsTest, DenseArrayPresenceOrWithOptionalOp) {
               IsOkAndHolds(ElementsAre(std::nullopt, std::nullopt)));
 }
 
+TEST_F(LogicOpsTest, DenseArrayPresenceOrOpByWords) {
+  // Covers full, empty and mixed bitmap words, and a bitmap offset.
+  std::vector<OptionalValue<int64_t>> lhs_values, rhs_values, expected;
+  for (int64_t i = 0; i < 200; ++i) {
+    bool lhs_present = (i < 64) || (i >= 128 && i % 3 == 0);
+    bool rhs_present = (i >= 32 && i < 96) || i % 2 == 0;
+    lhs_values.push_back(lhs_present ? OptionalValue<int64_t>(i)
+                                     : OptionalValue<int64_t>());
+    rhs_values.push_back(rhs_present ? OptionalValue<int64_t>(-i)
+                                     : OptionalValue<int64_t>());
+    expected.push_back(lhs_present ? OptionalValue<int64_t>(i)
+                                   : rhs_values.back());
+  }
+  auto lhs = CreateDenseArray<int64_t>(lhs_values);
+  auto rhs = CreateDenseArray<int64_t>(rhs_values);
+  EvaluationContext ctx;
+  ASSERT_OK_AND_ASSIGN(auto res, DenseArrayPresenceOrOp()(&ctx, lhs, rhs));
+  EXPECT_THAT(res, ElementsAreArray(expected));
+  ASSERT_OK_AND_ASSIGN(res, DenseArrayPresenceOrOp()(&ctx, lhs.Slice(5, 150),
+                                                      rhs.Slice(5, 150)));
+  EXPECT_THAT(res, ElementsAreArray(expected.begin() + 5,
+                                    expected.begin() + 155));
+
+  std::vector<OptionalValue<int64_t>> expected_with_const;
+  for (const auto& v : lhs_values) {
+    expected_with_const.push_back(v.present ? v : OptionalValue<int64_t>(7));
+  }
+  res = DenseArrayPresenceOrOp()(&ctx, lhs.Slice(5, 150),
+                                 OptionalValue<int64_t>(7));
+  EXPECT_THAT(res.bitmap, IsEmpty());
+  EXPECT_THAT(res, ElementsAreArray(expected_with_const.begin() + 5,
+                                    expected_with_const.begin() + 155));
+}
+
+TEST_F(LogicOpsTest, DenseArrayPresenceOrOpShortcuts) {
+  EvaluationContext ctx;
+  auto lhs = CreateDenseArray<Bytes>(
+      {std::nullopt, Bytes("a"), Bytes("b"), std::nullopt});
+  auto rhs = CreateDenseArray<Bytes>(
+      {Bytes("x"), Bytes("y"), std::nullopt, std::nullopt});
+  // All present or all missing after the slice.
+  ASSERT_OK_AND_ASSIGN(auto res, DenseArrayPresenceOrOp()(
+                                     &ctx, lhs.Slice(1, 2), rhs.Slice(1, 2)));
+  EXPECT_THAT(res, ElementsAre(Bytes("a"), Bytes("b")));
+  ASSERT_OK_AND_ASSIGN(res, DenseArrayPresenceOrOp()(&ctx, lhs.Slice(3, 1),
+                                                      rhs.Slice(3, 1)));
+  EXPECT_THAT(res, ElementsAre(std::nullopt));
+  ASSERT_OK_AND_ASSIGN(res, DenseArrayPresenceOrOp()(&ctx, lhs, rhs));
+  EXPECT_THAT(res, ElementsAre(Bytes("x"), Bytes("a"), Bytes("b"),
+                               std::nullopt));
+
+  auto lhs_mask = CreateDenseArray<Unit>({std::nullopt, kUnit, std::nullopt});
+  auto rhs_mask = CreateDenseArray<Unit>({kUnit, std::nullopt, std::nullopt});
+  ASSERT_OK_AND_ASSIGN(auto mask,
+                       DenseArrayPresenceOrOp()(&ctx, lhs_mask, rhs_mask));
+  EXPECT_THAT(mask, ElementsAre(kUnit, kUnit, std::nullopt));
+  ASSERT_OK_AND_ASSIGN(
+      mask, DenseArrayPresenceOrOp()(
+                &ctx, lhs_mask, CreateDenseArray<Unit>({kUnit, kUnit, kUnit})));
+  EXPECT_THAT(mask.bitmap, IsEmpty());
+  EXPECT_THAT(mask, ElementsAre(kUnit, kUnit, kUnit));
+  mask = DenseArrayPresenceOrOp()(&ctx, lhs_mask, OptionalValue<Unit>(kUnit));
+  EXPECT_THAT(mask.bitmap, IsEmpty());
+  EXPECT_THAT(mask, ElementsAre(kUnit, kUnit, kUnit));
+}
+
 TEST_F(LogicOpsTest, HasOp) {
   auto array = CreateDenseArray<float>({1.0, {}, 2.0, {}, 3.0});
   ASSERT_OK_AND_ASSIGN(
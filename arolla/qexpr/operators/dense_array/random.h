@@ -15,6 +15,7 @@
 #ifndef AROLLA_OPERATORS_DENSE_ARRAY_RANDOM_H_
 #define AROLLA_OPERATORS_DENSE_ARRAY_RANDOM_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <random>
 #include <utility>
@@ -25,7 +26,10 @@
 #include "absl/strings/str_format.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
+#include "absl/types/span.h"
 #include "arolla/memory/buffer.h"
+#include "arolla/qexpr/operators/random/philox.h"
+#include "arolla/util/threading.h"
 
 namespace arolla {
 
@@ -55,6 +59,68 @@ class RandIntWithDenseArrayShape {
   }
 };
 
+// array._counter_based_randint_with_shape generates a pseudo-random sequence
+// using the Philox counter-based generator. The i-th element depends only on
+// (seed, i), so the values can be generated in parallel, and the prefixes of
+// the results for different sizes coincide.
+//
+// The values are mapped into [low, high] using multiply-shift, which has a
+// bias of at most (high - low + 1) / 2^64.
+class CounterBasedRandIntWithDenseArrayShape {
+ public:
+  absl::StatusOr<DenseArray<int64_t>> operator()(const DenseArrayShape& shape,
+                                                 int64_t low, int64_t high,
+                                                 int64_t seed) const {
+    return Generate(shape, low, high, seed, /*threading=*/nullptr);
+  }
+
+  // Same as operator(), but splits the generation between the threads of
+  // `threading` (if not nullptr). The result does not depend on the split.
+  static absl::StatusOr<DenseArray<int64_t>> Generate(
+      const DenseArrayShape& shape, int64_t low, int64_t high, int64_t seed,
+      ThreadingInterface* threading) {
+    int64_t size = shape.size;
+    if (size < 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("size=%d is negative", size));
+    }
+    if (low > high) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("low=%d is greater than high=%d", low, high));
+    }
+    Buffer<int64_t>::Builder builder(size);
+    absl::Span<int64_t> values = builder.GetMutableSpan();
+    auto fill_range = [&](int64_t begin, int64_t end) {
+      absl::Span<int64_t> range = values.subspan(begin, end - begin);
+      // Reuse the output memory for the raw 64-bit values.
+      absl::Span<uint64_t> raw(reinterpret_cast<uint64_t*>(range.data()),
+                               range.size());
+      PhiloxFillUint64(static_cast<uint64_t>(seed),
+                       static_cast<uint64_t>(begin), raw);
+      for (size_t i = 0; i < range.size(); ++i) {
+        range[i] = UniformIntFromUint64(raw[i], low, high);
+      }
+    };
+    int64_t task_count = 1;
+    if (threading != nullptr) {
+      task_count = std::min<int64_t>(threading->GetRecommendedThreadCount(),
+                                     size / kMinValuesPerThread);
+    }
+    if (task_count > 1) {
+      ParallelFor(*threading, task_count, [&](int64_t task_id) {
+        fill_range(size * task_id / task_count,
+                   size * (task_id + 1) / task_count);
+      });
+    } else {
+      fill_range(0, size);
+    }
+    return DenseArray<int64_t>{std::move(builder).Build()};
+  }
+
+ private:
+  static constexpr int64_t kMinValuesPerThread = 1 << 16;
+};
+
 }  // namespace arolla
 
 #endif  // AROLLA_OPERATORS_DENSE_ARRAY_RANDOM_H_
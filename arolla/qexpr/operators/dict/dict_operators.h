@@ -15,10 +15,14 @@
 #ifndef AROLLA_OPERATORS_EXPERIMENTAL_DICT_H_
 #define AROLLA_OPERATORS_EXPERIMENTAL_DICT_H_
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <type_traits>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -27,15 +31,24 @@
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/eval_context.h"
+#include "arolla/qtype/dict/bloom_filter.h"
 #include "arolla/qtype/dict/dict_types.h"
+#include "arolla/util/stable_hash.h"
+#include "arolla/util/unit.h"
 #include "arolla/util/view_types.h"
+#include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
 
 // dict._make_key_to_row_dict operator constructs a dict from an array of keys
 // into their positions in the array. Returns an error in case of duplicated
 // keys.
+//
+// Large dicts with integral keys use the compact KeyToRowDict backend, which
+// takes up to 2x less memory.
 struct MakeKeyToRowDictOp {
+  static constexpr int64_t kMinCompactDictSize = 1 << 20;
+
   template <typename Key>
   absl::StatusOr<KeyToRowDict<Key>> operator()(
       const DenseArray<Key>& keys) const {
@@ -60,11 +73,15 @@ struct MakeKeyToRowDictOp {
         // status = absl::InvalidArgumentError("missing key in the dict");
       }
     });
-    if (status.ok()) {
-      return KeyToRowDict<Key>(std::move(dict));
-    } else {
+    if (!status.ok()) {
       return status;
     }
+    if constexpr (KeyToRowDict<Key>::kSupportsCompact) {
+      if (dict.size() >= kMinCompactDictSize) {
+        return KeyToRowDict<Key>::CreateCompact(dict);
+      }
+    }
+    return KeyToRowDict<Key>(std::move(dict));
   }
 };
 
@@ -74,12 +91,56 @@ class DictGetRowOp {
   template <typename Key>
   OptionalValue<int64_t> operator()(const KeyToRowDict<Key>& dict,
                                     view_type_t<Key> key) const {
-    if (auto iter = dict.map().find(key); iter != dict.map().end()) {
-      return iter->second;
-    } else {
-      return std::nullopt;
+    return dict.Find(key);
+  }
+
+  // Batched implementation for DenseArray keys. For large dicts the lookups
+  // are pipelined in blocks: while resolving a block we prefetch the slots for
+  // it and the first level of the dict for the next block, so that the cache
+  // misses of the independent lookups overlap.
+  template <typename Key>
+  DenseArray<int64_t> operator()(EvaluationContext* ctx,
+                                 const KeyToRowDict<Key>& dict,
+                                 const DenseArray<Key>& keys) const {
+    DenseArrayBuilder<int64_t> builder(keys.size(), &ctx->buffer_factory());
+    if (dict.size() < kMinPrefetchDictSize) {
+      keys.ForEachPresent([&](int64_t id, view_type_t<Key> key) {
+        builder.Set(id, dict.Find(key));
+      });
+      return std::move(builder).Build();
+    }
+    auto for_each_present = [&](int64_t begin, int64_t end, auto fn) {
+      end = std::min<int64_t>(end, keys.size());
+      for (int64_t id = begin; id < end; ++id) {
+        if (keys.present(id)) {
+          fn(id, keys.values[id]);
+        }
+      }
+    };
+    for_each_present(0, kBlockSize, [&](int64_t, view_type_t<Key> key) {
+      dict.Prefetch(key);
+    });
+    for (int64_t begin = 0; begin < keys.size(); begin += kBlockSize) {
+      int64_t end = begin + kBlockSize;
+      for_each_present(end, end + kBlockSize,
+                       [&](int64_t, view_type_t<Key> key) {
+                         dict.Prefetch(key);
+                       });
+      for_each_present(begin, end, [&](int64_t, view_type_t<Key> key) {
+        dict.PrefetchSlot(key);
+      });
+      for_each_present(begin, end, [&](int64_t id, view_type_t<Key> key) {
+        builder.Set(id, dict.Find(key));
+      });
     }
+    return std::move(builder).Build();
   }
+
+ private:
+  // Smaller dicts are likely to be cache resident, so the prefetching makes
+  // no sense for them.
+  static constexpr size_t kMinPrefetchDictSize = 1 << 16;
+  static constexpr int64_t kBlockSize = 32;
 };
 
 // dict._contains operator implementation.
@@ -88,7 +149,112 @@ class DictContainsOp {
   template <typename Key>
   OptionalUnit operator()(const KeyToRowDict<Key>& dict,
                           view_type_t<Key> key) const {
-    return OptionalUnit{dict.map().contains(key)};
+    return OptionalUnit{dict.Contains(key)};
+  }
+};
+
+// dict._make_bloom_filter operator constructs a BloomFilter from the present
+// keys with the given false positive rate.
+struct MakeBloomFilterOp {
+  template <typename Key>
+  absl::StatusOr<BloomFilter> operator()(const DenseArray<Key>& keys,
+                                         double false_positive_rate) const {
+    ASSIGN_OR_RETURN(auto builder,
+                     BloomFilter::Builder::Create(keys.PresentCount(),
+                                                  false_positive_rate));
+    keys.ForEachPresent(
+        [&](int64_t /*id*/, view_type_t<Key> key) { builder.Add(key); });
+    return std::move(builder).Build();
+  }
+};
+
+namespace dict_impl {
+
+// Calls fn(id, key) for the present keys that may be contained in the filter.
+// For large filters the lookups are done in blocks: we prefetch the filter
+// blocks for all the keys in a block before checking them, so that the cache
+// misses of the independent lookups overlap.
+template <typename Key, typename Fn>
+void ForEachMayContain(const BloomFilter& filter, const DenseArray<Key>& keys,
+                       Fn&& fn) {
+  // Smaller filters are likely to be cache resident, so the prefetching makes
+  // no sense for them.
+  constexpr size_t kMinPrefetchFilterByteSize = 1 << 20;
+  constexpr int64_t kBlockSize = 32;
+  if (filter.ByteSize() < kMinPrefetchFilterByteSize) {
+    keys.ForEachPresent([&](int64_t id, view_type_t<Key> key) {
+      if (filter.MayContain(key)) {
+        fn(id, key);
+      }
+    });
+    return;
+  }
+  std::array<uint64_t, kBlockSize> hashes;
+  for (int64_t begin = 0; begin < keys.size(); begin += kBlockSize) {
+    int64_t end = std::min<int64_t>(begin + kBlockSize, keys.size());
+    // Missing keys are hashed too, their values are valid but ignored.
+    for (int64_t id = begin; id < end; ++id) {
+      hashes[id - begin] = StableHash(view_type_t<Key>(keys.values[id]));
+      filter.PrefetchHash(hashes[id - begin]);
+    }
+    for (int64_t id = begin; id < end; ++id) {
+      if (keys.present(id) && filter.MayContainHash(hashes[id - begin])) {
+        fn(id, keys.values[id]);
+      }
+    }
+  }
+}
+
+}  // namespace dict_impl
+
+// dict._bloom_filter_contains operator returns present if the key may be
+// contained in the filter. False positives are possible, see BloomFilter.
+class BloomFilterContainsOp {
+ public:
+  template <typename Key>
+  OptionalUnit operator()(const BloomFilter& filter, const Key& key) const {
+    return OptionalUnit{filter.MayContain(key)};
+  }
+
+  template <typename Key>
+  DenseArray<Unit> operator()(EvaluationContext* ctx,
+                              const BloomFilter& filter,
+                              const DenseArray<Key>& keys) const {
+    DenseArrayBuilder<Unit> builder(keys.size(), &ctx->buffer_factory());
+    dict_impl::ForEachMayContain(
+        filter, keys,
+        [&](int64_t id, view_type_t<Key> /*key*/) { builder.Set(id, kUnit); });
+    return std::move(builder).Build();
+  }
+};
+
+// dict._contains_with_bloom_filter(dict, filter, key) operator is equivalent
+// to dict._contains(dict, key), but checks the filter first: most of the
+// missing keys are rejected by the (cache resident) filter and don't probe the
+// dict. The filter must contain all the dict keys, so it is normally built
+// with dict._make_bloom_filter from the same keys.
+class ContainsWithBloomFilterOp {
+ public:
+  template <typename Key>
+  OptionalUnit operator()(const KeyToRowDict<Key>& dict,
+                          const BloomFilter& filter,
+                          view_type_t<Key> key) const {
+    return OptionalUnit{filter.MayContain(key) && dict.Contains(key)};
+  }
+
+  template <typename Key>
+  DenseArray<Unit> operator()(EvaluationContext* ctx,
+                              const KeyToRowDict<Key>& dict,
+                              const BloomFilter& filter,
+                              const DenseArray<Key>& keys) const {
+    DenseArrayBuilder<Unit> builder(keys.size(), &ctx->buffer_factory());
+    dict_impl::ForEachMayContain(filter, keys,
+                                 [&](int64_t id, view_type_t<Key> key) {
+                                   if (dict.Contains(key)) {
+                                     builder.Set(id, kUnit);
+                                   }
+                                 });
+    return std::move(builder).Build();
   }
 };
 
@@ -98,14 +264,18 @@ class DictKeysOp {
   template <typename Key>
   absl::StatusOr<DenseArray<Key>> operator()(
       EvaluationContext* ctx, const KeyToRowDict<Key>& dict) const {
-    DenseArrayBuilder<Key> result_builder(dict.map().size(),
-                                          &ctx->buffer_factory());
-    for (const auto& [key, row] : dict.map()) {
-      if (row < 0 || row >= dict.map().size()) {
-        return absl::InternalError(
-            "unexpected row ids in the key-to-row mapping in the dict");
+    DenseArrayBuilder<Key> result_builder(dict.size(), &ctx->buffer_factory());
+    bool unexpected_row_ids = false;
+    dict.ForEach([&](view_type_t<Key> key, int64_t row) {
+      if (row < 0 || row >= dict.size()) {
+        unexpected_row_ids = true;
+        return;
       }
       result_builder.Set(row, key);
+    });
+    if (unexpected_row_ids) {
+      return absl::InternalError(
+          "unexpected row ids in the key-to-row mapping in the dict");
     }
 
     DenseArray<Key> result = std::move(result_builder).Build();
@@ -14,17 +14,21 @@
 //
 #include <cstdint>
 #include <optional>
+#include <utility>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "arolla/array/array.h"
 #include "arolla/array/qtype/types.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/operators.h"
+#include "arolla/qexpr/operators/dict/dict_operators.h"
 #include "arolla/qtype/base_types.h"
+#include "arolla/qtype/dict/bloom_filter.h"
 #include "arolla/qtype/dict/dict_types.h"
 #include "arolla/util/bytes.h"
 #include "arolla/util/init_arolla.h"
@@ -39,27 +43,31 @@ using ::arolla::testing::StatusIs;
 using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::HasSubstr;
-using ::testing::Pair;
-using ::testing::Property;
-using ::testing::UnorderedElementsAre;
 
 class DictOperatorsTest : public ::testing::Test {
   void SetUp() final { ASSERT_OK(InitArolla()); }
 };
 
 TEST_F(DictOperatorsTest, MakeKeyToRowDict) {
-  EXPECT_THAT(
-      InvokeOperator<KeyToRowDict<int32_t>>("dict._make_key_to_row_dict",
-                                            CreateDenseArray<int32_t>({2, 57})),
-      IsOkAndHolds(Property(&KeyToRowDict<int32_t>::map,
-                            UnorderedElementsAre(Pair(2, 0), Pair(57, 1)))));
-  EXPECT_THAT(
-      InvokeOperator<KeyToRowDict<Bytes>>(
-          "dict._make_key_to_row_dict",
-          CreateDenseArray<Bytes>({Bytes("foo"), Bytes("bar")})),
-      IsOkAndHolds(Property(
-          &KeyToRowDict<Bytes>::map,
-          UnorderedElementsAre(Pair(Bytes("foo"), 0), Pair(Bytes("bar"), 1)))));
+  using ORI = OptionalValue<int64_t>;
+  {
+    ASSERT_OK_AND_ASSIGN(auto dict, InvokeOperator<KeyToRowDict<int32_t>>(
+                                        "dict._make_key_to_row_dict",
+                                        CreateDenseArray<int32_t>({2, 57})));
+    EXPECT_FALSE(dict.is_compact());
+    EXPECT_EQ(dict.size(), 2);
+    EXPECT_EQ(dict.Find(2), ORI(0));
+    EXPECT_EQ(dict.Find(57), ORI(1));
+  }
+  {
+    ASSERT_OK_AND_ASSIGN(
+        auto dict, InvokeOperator<KeyToRowDict<Bytes>>(
+                       "dict._make_key_to_row_dict",
+                       CreateDenseArray<Bytes>({Bytes("foo"), Bytes("bar")})));
+    EXPECT_EQ(dict.size(), 2);
+    EXPECT_EQ(dict.Find("foo"), ORI(0));
+    EXPECT_EQ(dict.Find("bar"), ORI(1));
+  }
   EXPECT_THAT(InvokeOperator<KeyToRowDict<Bytes>>(
                   "dict._make_key_to_row_dict",
                   CreateDenseArray<Bytes>({Bytes("foo"), Bytes("foo")})),
@@ -103,6 +111,57 @@ TEST_F(DictOperatorsTest, GetRow) {
   }
 }
 
+TEST_F(DictOperatorsTest, GetRowFromLargeDict) {
+  // Large enough to use the batched lookup with prefetching.
+  const int64_t size = 1 << 16;
+  KeyToRowDict<Bytes>::Map map;
+  for (int64_t i = 0; i < size; ++i) {
+    map.emplace(absl::StrCat("key", i), i);
+  }
+  KeyToRowDict<Bytes> dict(std::move(map));
+  DenseArrayBuilder<Bytes> keys_bldr(size + 2);
+  for (int64_t i = 0; i < size; ++i) {
+    keys_bldr.Set(i + 1, absl::StrCat("key", size - i - 1));
+  }
+  keys_bldr.Set(0, Bytes("unknown"));
+  DenseArray<Bytes> keys = std::move(keys_bldr).Build();
+  ASSERT_OK_AND_ASSIGN(auto res, InvokeOperator<DenseArray<int64_t>>(
+                                     "dict._get_row", dict, keys));
+  ASSERT_EQ(res.size(), size + 2);
+  EXPECT_FALSE(res.present(0));
+  EXPECT_FALSE(res.present(size + 1));
+  for (int64_t i = 0; i < size; ++i) {
+    ASSERT_EQ(res[i + 1], OptionalValue<int64_t>(size - i - 1));
+  }
+}
+
+TEST_F(DictOperatorsTest, MakeCompactKeyToRowDict) {
+  using ORI = OptionalValue<int64_t>;
+  const int64_t size = MakeKeyToRowDictOp::kMinCompactDictSize;
+  DenseArrayBuilder<int64_t> keys_bldr(size);
+  for (int64_t i = 0; i < size; ++i) {
+    keys_bldr.Set(i, size - 2 * i);
+  }
+  ASSERT_OK_AND_ASSIGN(auto dict, InvokeOperator<KeyToRowDict<int64_t>>(
+                                      "dict._make_key_to_row_dict",
+                                      std::move(keys_bldr).Build()));
+  EXPECT_TRUE(dict.is_compact());
+  EXPECT_EQ(dict.size(), size);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto res,
+      InvokeOperator<DenseArray<int64_t>>(
+          "dict._get_row", dict,
+          CreateDenseArray<int64_t>({size, size - 1, size - 4, std::nullopt,
+                                     -size + 2, -size})));
+  EXPECT_THAT(res, ElementsAre(0, std::nullopt, 2, std::nullopt, size - 1,
+                               std::nullopt));
+  EXPECT_THAT(InvokeOperator<OptionalUnit>("dict._contains", dict, size - 2),
+              IsOkAndHolds(kPresent));
+  EXPECT_THAT(InvokeOperator<ORI>("dict._get_row", dict, int64_t{3}),
+              IsOkAndHolds(ORI()));
+}
+
 TEST_F(DictOperatorsTest, Contains) {
   KeyToRowDict<Bytes> dict({{Bytes("foo"), 5}, {Bytes("bar"), 7}});
 
@@ -134,6 +193,74 @@ TEST_F(DictOperatorsTest, Contains) {
   }
 }
 
+TEST_F(DictOperatorsTest, BloomFilter) {
+  ASSERT_OK_AND_ASSIGN(
+      auto filter,
+      InvokeOperator<BloomFilter>(
+          "dict._make_bloom_filter",
+          CreateDenseArray<Bytes>({Bytes("foo"), std::nullopt, Bytes("bar")}),
+          0.01));
+  EXPECT_EQ(filter.size(), 2);
+  EXPECT_THAT(InvokeOperator<OptionalUnit>("dict._bloom_filter_contains",
+                                           filter, Bytes("foo")),
+              IsOkAndHolds(Eq(kPresent)));
+  EXPECT_THAT(InvokeOperator<OptionalUnit>("dict._bloom_filter_contains",
+                                           filter, OptionalValue<Bytes>()),
+              IsOkAndHolds(Eq(kMissing)));
+  EXPECT_THAT(
+      InvokeOperator<BloomFilter>("dict._make_bloom_filter",
+                                  CreateDenseArray<int64_t>({1, 2}), 1.5),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("false_positive_rate must be in range (0, 1)")));
+
+  KeyToRowDict<Bytes> dict({{Bytes("foo"), 0}, {Bytes("bar"), 2}});
+  DenseArray<Bytes> keys = CreateDenseArray<Bytes>(
+      {Bytes("foo"), Bytes("unknown"), std::nullopt, Bytes("bar")});
+  EXPECT_THAT(InvokeOperator<OptionalUnit>("dict._contains_with_bloom_filter",
+                                           dict, filter, Bytes("unknown")),
+              IsOkAndHolds(Eq(kMissing)));
+  EXPECT_THAT(InvokeOperator<DenseArray<Unit>>(
+                  "dict._contains_with_bloom_filter", dict, filter, keys),
+              IsOkAndHolds(
+                  ElementsAre(kPresent, kMissing, kMissing, kPresent)));
+  EXPECT_THAT(
+      InvokeOperator<Array<Unit>>("dict._contains_with_bloom_filter", dict,
+                                  filter, Array<Bytes>(keys)),
+      IsOkAndHolds(ElementsAre(kPresent, kMissing, kMissing, kPresent)));
+}
+
+TEST_F(DictOperatorsTest, LargeBloomFilter) {
+  // Large enough to use the batched lookup with prefetching.
+  const int64_t size = 1 << 20;
+  DenseArrayBuilder<int64_t> keys_bldr(size);
+  for (int64_t i = 0; i < size; ++i) {
+    keys_bldr.Set(i, 2 * i);
+  }
+  ASSERT_OK_AND_ASSIGN(auto filter,
+                       InvokeOperator<BloomFilter>("dict._make_bloom_filter",
+                                                   std::move(keys_bldr).Build(),
+                                                   0.01));
+  ASSERT_GE(filter.ByteSize(), 1 << 20);
+  DenseArrayBuilder<int64_t> queries_bldr(size + 1);
+  for (int64_t i = 0; i < size; ++i) {
+    queries_bldr.Set(i, i);
+  }
+  ASSERT_OK_AND_ASSIGN(auto res, InvokeOperator<DenseArray<Unit>>(
+                                     "dict._bloom_filter_contains", filter,
+                                     std::move(queries_bldr).Build()));
+  ASSERT_EQ(res.size(), size + 1);
+  EXPECT_FALSE(res.present(size));
+  int64_t false_positives = 0;
+  for (int64_t i = 0; i < size; ++i) {
+    if (i % 2 == 0) {
+      ASSERT_TRUE(res.present(i)) << i;
+    } else {
+      false_positives += res.present(i);
+    }
+  }
+  EXPECT_LT(false_positives, 0.015 * size / 2);
+}
+
 TEST_F(DictOperatorsTest, Keys) {
   EXPECT_THAT(InvokeOperator<DenseArray<Bytes>>(
                   "dict._keys",
@@ -15,13 +15,23 @@
 #ifndef AROLLA_QEXPR_OPERATORS_EXPERIMENTAL_DENSE_ARRAY_TIMESERIES_H_
 #define AROLLA_QEXPR_OPERATORS_EXPERIMENTAL_DENSE_ARRAY_TIMESERIES_H_
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <deque>
+#include <limits>
 #include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/ops/dense_group_ops.h"
@@ -31,8 +41,88 @@
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/util/meta.h"
 #include "arolla/util/view_types.h"
+#include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
+namespace timeseries_state_impl {
+
+// Little-endian binary encoding of the accumulator states (see
+// TimeseriesStream).
+class StateWriter {
+ public:
+  void WriteInt64(int64_t value) { WriteBits(static_cast<uint64_t>(value)); }
+  void WriteDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteBits(bits);
+  }
+  void WriteBool(bool value) { data_.push_back(value ? 1 : 0); }
+
+  std::string Finish() && { return std::move(data_); }
+
+ private:
+  void WriteBits(uint64_t bits) {
+    for (size_t byte = 0; byte < sizeof(uint64_t); ++byte) {
+      data_.push_back(static_cast<char>(bits >> (8 * byte)));
+    }
+  }
+
+  std::string data_;
+};
+
+// Reads the data written by StateWriter. All the methods return false if the
+// data is truncated or malformed.
+class StateReader {
+ public:
+  explicit StateReader(absl::string_view data) : data_(data) {}
+
+  bool ReadInt64(int64_t* value) {
+    uint64_t bits;
+    if (!ReadBits(&bits)) return false;
+    *value = static_cast<int64_t>(bits);
+    return true;
+  }
+  bool ReadDouble(double* value) {
+    uint64_t bits;
+    if (!ReadBits(&bits)) return false;
+    std::memcpy(value, &bits, sizeof(bits));
+    return true;
+  }
+  bool ReadBool(bool* value) {
+    if (data_.empty() || static_cast<unsigned char>(data_[0]) > 1) {
+      return false;
+    }
+    *value = data_[0] != 0;
+    data_.remove_prefix(1);
+    return true;
+  }
+  // Reads the number of the following elements of `element_size` bytes each.
+  // The check against the remaining data protects from huge allocations on
+  // malformed input.
+  bool ReadSize(size_t element_size, int64_t* size) {
+    return ReadInt64(size) && *size >= 0 &&
+           static_cast<uint64_t>(*size) <= data_.size() / element_size;
+  }
+
+  bool AtEnd() const { return data_.empty(); }
+
+ private:
+  bool ReadBits(uint64_t* bits) {
+    if (data_.size() < sizeof(uint64_t)) return false;
+    *bits = 0;
+    for (size_t byte = 0; byte < sizeof(uint64_t); ++byte) {
+      *bits |= uint64_t{static_cast<unsigned char>(data_[byte])}
+               << (8 * byte);
+    }
+    data_.remove_prefix(sizeof(uint64_t));
+    return true;
+  }
+
+  absl::string_view data_;
+};
+
+}  // namespace timeseries_state_impl
+
 namespace moving_average_operator_impl {
 
 template <typename ScalarT>
@@ -68,6 +158,29 @@ class MovingAverageAccumulator final
     }
   }
 
+  // Serialization of the state for TimeseriesStream. The window size is not
+  // stored, the window sum is recomputed from the values.
+  void SaveState(timeseries_state_impl::StateWriter& writer) const {
+    writer.WriteInt64(current_window_.size());
+    for (ScalarT value : current_window_) {
+      writer.WriteDouble(value);
+    }
+  }
+  bool LoadState(timeseries_state_impl::StateReader& reader) {
+    Reset();
+    int64_t size;
+    if (!reader.ReadSize(sizeof(double), &size) || size > window_size_) {
+      return false;
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      double value;
+      if (!reader.ReadDouble(&value)) return false;
+      current_window_.push_back(static_cast<ScalarT>(value));
+      window_sum_ += current_window_.back();
+    }
+    return true;
+  }
+
  private:
   std::deque<ScalarT> current_window_;
   int window_size_;
@@ -94,6 +207,447 @@ struct AggMovingAverageOp {
   }
 };
 
+namespace moving_window_operator_impl {
+
+// Aggregations supported by the moving window operators.
+enum class MovingWindowAgg { kSum, kMean, kMin, kMax, kCount, kStd };
+
+// State of a moving window aggregation within a single group.
+//
+// Keeps the present values of the window ordered by time, as well as the
+// running aggregates, so every step is O(1) amortized. The window for time `t`
+// contains the values with time in (t - window_duration, t].
+//
+// Non-finite values are only counted and never enter the running sums, so
+// they do not poison the state after leaving the window. The sum uses
+// compensated summation. Removing values from the running aggregates still
+// accumulates rounding errors, so they are recomputed from the window once the
+// number of removals reaches the window size.
+template <typename ScalarT, MovingWindowAgg kAgg>
+class MovingWindowState {
+ public:
+  explicit MovingWindowState(int64_t window_duration)
+      : window_duration_(window_duration) {}
+
+  void Reset() {
+    window_.clear();
+    extremes_.clear();
+    next_id_ = 0;
+    nan_count_ = 0;
+    pos_inf_count_ = 0;
+    neg_inf_count_ = 0;
+    removals_since_recompute_ = 0;
+    sum_ = 0;
+    sum_compensation_ = 0;
+    mean_ = 0;
+    m2_ = 0;
+  }
+
+  // Adds a value, which is expected to have time not less than all the
+  // previously added values, and evicts the values outside of the window.
+  void Add(int64_t time, OptionalValue<ScalarT> value) {
+    if (value.present) {
+      Push(time, value.value);
+    }
+    // Unsigned arithmetic avoids overflows, the difference is non-negative.
+    while (!window_.empty() &&
+           static_cast<uint64_t>(time) -
+                   static_cast<uint64_t>(window_.front().time) >=
+               static_cast<uint64_t>(window_duration_)) {
+      Pop();
+    }
+  }
+
+  OptionalValue<ScalarT> GetResult() const {
+    if constexpr (kAgg == MovingWindowAgg::kCount) {
+      return static_cast<ScalarT>(window_.size());
+    } else {
+      if (window_.empty()) {
+        return std::nullopt;
+      }
+      if (nan_count_ > 0) {
+        return std::numeric_limits<ScalarT>::quiet_NaN();
+      }
+      if constexpr (kAgg == MovingWindowAgg::kSum ||
+                    kAgg == MovingWindowAgg::kMean) {
+        if (pos_inf_count_ > 0 && neg_inf_count_ > 0) {
+          return std::numeric_limits<ScalarT>::quiet_NaN();
+        } else if (pos_inf_count_ > 0) {
+          return std::numeric_limits<ScalarT>::infinity();
+        } else if (neg_inf_count_ > 0) {
+          return -std::numeric_limits<ScalarT>::infinity();
+        }
+        return static_cast<ScalarT>(
+            kAgg == MovingWindowAgg::kSum ? sum_ + sum_compensation_ : mean_);
+      } else if constexpr (kAgg == MovingWindowAgg::kStd) {
+        if (pos_inf_count_ > 0 || neg_inf_count_ > 0) {
+          return std::numeric_limits<ScalarT>::quiet_NaN();
+        }
+        // Population standard deviation.
+        return static_cast<ScalarT>(std::sqrt(std::max(m2_, 0.) /
+                                              window_.size()));
+      } else {
+        return extremes_.front().value;
+      }
+    }
+  }
+
+  // Serialization of the state for TimeseriesStream. The window duration is
+  // not stored. The running aggregates are stored as is rather than recomputed
+  // from the window, so a restored state produces exactly the same results.
+  void SaveState(timeseries_state_impl::StateWriter& writer) const {
+    writer.WriteInt64(next_id_);
+    writer.WriteInt64(nan_count_);
+    writer.WriteInt64(pos_inf_count_);
+    writer.WriteInt64(neg_inf_count_);
+    writer.WriteInt64(removals_since_recompute_);
+    writer.WriteDouble(sum_);
+    writer.WriteDouble(sum_compensation_);
+    writer.WriteDouble(mean_);
+    writer.WriteDouble(m2_);
+    SaveEntries(writer, window_);
+    SaveEntries(writer, extremes_);
+  }
+  bool LoadState(timeseries_state_impl::StateReader& reader) {
+    Reset();
+    if (!reader.ReadInt64(&next_id_) || !reader.ReadInt64(&nan_count_) ||
+        !reader.ReadInt64(&pos_inf_count_) ||
+        !reader.ReadInt64(&neg_inf_count_) ||
+        !reader.ReadInt64(&removals_since_recompute_) ||
+        !reader.ReadDouble(&sum_) || !reader.ReadDouble(&sum_compensation_) ||
+        !reader.ReadDouble(&mean_) || !reader.ReadDouble(&m2_) ||
+        !LoadEntries(reader, window_) || !LoadEntries(reader, extremes_)) {
+      return false;
+    }
+    const int64_t window_size = window_.size();
+    // GetResult() relies on `extremes_` being non-empty iff the window has
+    // a non-NaN value.
+    return nan_count_ >= 0 && pos_inf_count_ >= 0 && neg_inf_count_ >= 0 &&
+           removals_since_recompute_ >= 0 &&
+           nan_count_ + pos_inf_count_ + neg_inf_count_ <= window_size &&
+           (!kIsExtremum || (pos_inf_count_ == 0 && neg_inf_count_ == 0 &&
+                             extremes_.empty() == (nan_count_ == window_size)));
+  }
+
+ private:
+  struct Entry {
+    int64_t time;
+    int64_t id;  // Sequential number of the entry.
+    ScalarT value;
+  };
+
+  static void SaveEntries(timeseries_state_impl::StateWriter& writer,
+                          const std::deque<Entry>& entries) {
+    writer.WriteInt64(entries.size());
+    for (const Entry& entry : entries) {
+      writer.WriteInt64(entry.time);
+      writer.WriteInt64(entry.id);
+      writer.WriteDouble(entry.value);
+    }
+  }
+  static bool LoadEntries(timeseries_state_impl::StateReader& reader,
+                          std::deque<Entry>& entries) {
+    int64_t size;
+    if (!reader.ReadSize(3 * sizeof(int64_t), &size)) return false;
+    for (int64_t i = 0; i < size; ++i) {
+      Entry entry;
+      double value;
+      if (!reader.ReadInt64(&entry.time) || !reader.ReadInt64(&entry.id) ||
+          !reader.ReadDouble(&value)) {
+        return false;
+      }
+      entry.value = static_cast<ScalarT>(value);
+      entries.push_back(entry);
+    }
+    return true;
+  }
+
+  static constexpr bool kIsExtremum =
+      kAgg == MovingWindowAgg::kMin || kAgg == MovingWindowAgg::kMax;
+
+  void Push(int64_t time, ScalarT value) {
+    const Entry entry{time, next_id_++, value};
+    window_.push_back(entry);
+    if (std::isnan(value)) {
+      ++nan_count_;
+      return;
+    }
+    if constexpr (kIsExtremum) {
+      // Monotonic deque: the front holds the extremum of the window.
+      while (!extremes_.empty() && !IsBetter(extremes_.back().value, value)) {
+        extremes_.pop_back();
+      }
+      extremes_.push_back(entry);
+    } else if (std::isinf(value)) {
+      ++(value > 0 ? pos_inf_count_ : neg_inf_count_);
+    } else if constexpr (kAgg == MovingWindowAgg::kSum) {
+      AddToSum(value);
+    } else if constexpr (kAgg == MovingWindowAgg::kMean ||
+                         kAgg == MovingWindowAgg::kStd) {
+      // Welford's algorithm.
+      const int64_t n = FiniteCount();
+      const double delta = value - mean_;
+      mean_ += delta / n;
+      m2_ += delta * (value - mean_);
+    }
+  }
+
+  void Pop() {
+    const Entry entry = window_.front();
+    window_.pop_front();
+    if (std::isnan(entry.value)) {
+      --nan_count_;
+      return;
+    }
+    if constexpr (kIsExtremum) {
+      // The front of `extremes_` is the oldest entry in it, and all the
+      // entries there are not older than `entry`.
+      if (!extremes_.empty() && extremes_.front().id == entry.id) {
+        extremes_.pop_front();
+      }
+    } else if (std::isinf(entry.value)) {
+      --(entry.value > 0 ? pos_inf_count_ : neg_inf_count_);
+    } else if constexpr (kAgg != MovingWindowAgg::kCount) {
+      const int64_t n = FiniteCount();
+      if (n == 0) {
+        removals_since_recompute_ = 0;
+        sum_ = 0;
+        sum_compensation_ = 0;
+        mean_ = 0;
+        m2_ = 0;
+      } else if (++removals_since_recompute_ >=
+                 static_cast<int64_t>(window_.size())) {
+        Recompute();
+      } else if constexpr (kAgg == MovingWindowAgg::kSum) {
+        AddToSum(-entry.value);
+      } else {
+        const double delta = entry.value - mean_;
+        mean_ -= delta / n;
+        m2_ -= delta * (entry.value - mean_);
+      }
+    }
+  }
+
+  // Number of the finite values in the window, not used for extremums.
+  int64_t FiniteCount() const {
+    return window_.size() - nan_count_ - pos_inf_count_ - neg_inf_count_;
+  }
+
+  // Neumaier's compensated summation.
+  void AddToSum(double value) {
+    const double sum = sum_ + value;
+    if (std::abs(sum_) >= std::abs(value)) {
+      sum_compensation_ += (sum_ - sum) + value;
+    } else {
+      sum_compensation_ += (value - sum) + sum_;
+    }
+    sum_ = sum;
+  }
+
+  // Recomputes the running aggregates from the finite values of the window.
+  // Costs O(window size), but is called at most once per window size
+  // removals.
+  void Recompute() {
+    removals_since_recompute_ = 0;
+    sum_ = 0;
+    sum_compensation_ = 0;
+    for (const Entry& entry : window_) {
+      if (std::isfinite(entry.value)) {
+        AddToSum(entry.value);
+      }
+    }
+    if constexpr (kAgg == MovingWindowAgg::kMean ||
+                  kAgg == MovingWindowAgg::kStd) {
+      // Two-pass algorithm.
+      mean_ = (sum_ + sum_compensation_) / FiniteCount();
+      m2_ = 0;
+      for (const Entry& entry : window_) {
+        if (std::isfinite(entry.value)) {
+          const double delta = entry.value - mean_;
+          m2_ += delta * delta;
+        }
+      }
+    }
+  }
+
+  // Returns true if `a` must stay in front of the newer `b` in `extremes_`.
+  static bool IsBetter(ScalarT a, ScalarT b) {
+    if constexpr (kAgg == MovingWindowAgg::kMin) {
+      return a < b;
+    } else {
+      return a > b;
+    }
+  }
+
+  int64_t window_duration_;
+  std::deque<Entry> window_;
+  std::deque<Entry> extremes_;
+  int64_t next_id_ = 0;
+  int64_t nan_count_ = 0;
+  // Infinities are not counted for min and max.
+  int64_t pos_inf_count_ = 0;
+  int64_t neg_inf_count_ = 0;
+  int64_t removals_since_recompute_ = 0;
+  double sum_ = 0;
+  double sum_compensation_ = 0;
+  double mean_ = 0;
+  double m2_ = 0;
+};
+
+// Row-based moving window: the window for a row contains the `window_size`
+// last rows of the group, including the row itself.
+template <typename ScalarT, MovingWindowAgg kAgg>
+class MovingWindowAccumulator final
+    : public Accumulator<AccumulatorType::kPartial, OptionalValue<ScalarT>,
+                         meta::type_list<>,
+                         meta::type_list<OptionalValue<ScalarT>>> {
+ public:
+  explicit MovingWindowAccumulator(int64_t window_size)
+      : state_(window_size) {}
+
+  void Reset() final {
+    state_.Reset();
+    row_id_ = 0;
+  }
+
+  void Add(OptionalValue<ScalarT> value) final {
+    state_.Add(row_id_++, value);
+  }
+
+  OptionalValue<ScalarT> GetResult() final { return state_.GetResult(); }
+
+  void SaveState(timeseries_state_impl::StateWriter& writer) const {
+    state_.SaveState(writer);
+    writer.WriteInt64(row_id_);
+  }
+  bool LoadState(timeseries_state_impl::StateReader& reader) {
+    return state_.LoadState(reader) && reader.ReadInt64(&row_id_);
+  }
+
+ private:
+  MovingWindowState<ScalarT, kAgg> state_;
+  int64_t row_id_ = 0;
+};
+
+// Time-based moving window: the window for a row with time `t` contains the
+// rows of the group with time in (t - window_duration, t]. The times must be
+// non-decreasing within each group; rows with missing time are skipped and get
+// a missing result.
+template <typename ScalarT, MovingWindowAgg kAgg>
+class TimeMovingWindowAccumulator final
+    : public Accumulator<
+          AccumulatorType::kPartial, OptionalValue<ScalarT>, meta::type_list<>,
+          meta::type_list<OptionalValue<ScalarT>, OptionalValue<int64_t>>> {
+ public:
+  explicit TimeMovingWindowAccumulator(int64_t window_duration)
+      : state_(window_duration) {}
+
+  void Reset() final {
+    state_.Reset();
+    last_time_ = std::numeric_limits<int64_t>::min();
+  }
+
+  void Add(OptionalValue<ScalarT> value, OptionalValue<int64_t> time) final {
+    time_present_ = time.present;
+    if (!time.present) {
+      return;
+    }
+    if (time.value < last_time_) {
+      status_ = absl::InvalidArgumentError(absl::StrFormat(
+          "times must be non-decreasing within a group, got %d after %d",
+          time.value, last_time_));
+      return;
+    }
+    last_time_ = time.value;
+    state_.Add(time.value, value);
+  }
+
+  OptionalValue<ScalarT> GetResult() final {
+    if (!time_present_) {
+      return std::nullopt;
+    }
+    return state_.GetResult();
+  }
+
+  absl::Status GetStatus() final { return status_; }
+
+  // The status is not stored, TimeseriesStream doesn't serialize failed
+  // states.
+  void SaveState(timeseries_state_impl::StateWriter& writer) const {
+    state_.SaveState(writer);
+    writer.WriteInt64(last_time_);
+    writer.WriteBool(time_present_);
+  }
+  bool LoadState(timeseries_state_impl::StateReader& reader) {
+    status_ = absl::OkStatus();
+    return state_.LoadState(reader) && reader.ReadInt64(&last_time_) &&
+           reader.ReadBool(&time_present_);
+  }
+
+ private:
+  MovingWindowState<ScalarT, kAgg> state_;
+  int64_t last_time_ = std::numeric_limits<int64_t>::min();
+  bool time_present_ = false;
+  absl::Status status_;
+};
+
+}  // namespace moving_window_operator_impl
+
+// Moving window aggregation operators.
+//
+// Take in the (time-series) values and return, for each row, the aggregate of
+// the present values in its trailing window within the group. The window is
+// either `window_size` last rows, or, if `times` are provided, the rows with
+// time in (t - window_duration, t]. The result is missing for empty windows
+// (except for count) and NaN if the window contains a NaN. Every row is
+// processed in O(1) amortized time.
+template <moving_window_operator_impl::MovingWindowAgg kAgg>
+struct AggMovingWindowOp {
+  template <typename ScalarT>
+  absl::StatusOr<DenseArray<ScalarT>> operator()(
+      EvaluationContext* ctx,
+      const DenseArray<ScalarT>& series,  // detail array
+      const int64_t window_size, const DenseArrayEdge& edge) const {
+    if (window_size < 0) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "window_size must be non-negative, got %d", window_size));
+    }
+    using Acc =
+        moving_window_operator_impl::MovingWindowAccumulator<ScalarT, kAgg>;
+    DenseGroupOps<Acc> agg(&ctx->buffer_factory(), Acc(window_size));
+    return agg.Apply(edge, series);
+  }
+
+  template <typename ScalarT>
+  absl::StatusOr<DenseArray<ScalarT>> operator()(
+      EvaluationContext* ctx,
+      const DenseArray<ScalarT>& series,  // detail array
+      const DenseArray<int64_t>& times, const int64_t window_duration,
+      const DenseArrayEdge& edge) const {
+    if (window_duration < 0) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "window_duration must be non-negative, got %d", window_duration));
+    }
+    using Acc =
+        moving_window_operator_impl::TimeMovingWindowAccumulator<ScalarT, kAgg>;
+    DenseGroupOps<Acc> agg(&ctx->buffer_factory(), Acc(window_duration));
+    return agg.Apply(edge, series, times);
+  }
+};
+
+using AggMovingSumOp =
+    AggMovingWindowOp<moving_window_operator_impl::MovingWindowAgg::kSum>;
+using AggMovingMeanOp =
+    AggMovingWindowOp<moving_window_operator_impl::MovingWindowAgg::kMean>;
+using AggMovingMinOp =
+    AggMovingWindowOp<moving_window_operator_impl::MovingWindowAgg::kMin>;
+using AggMovingMaxOp =
+    AggMovingWindowOp<moving_window_operator_impl::MovingWindowAgg::kMax>;
+using AggMovingCountOp =
+    AggMovingWindowOp<moving_window_operator_impl::MovingWindowAgg::kCount>;
+using AggMovingStdOp =
+    AggMovingWindowOp<moving_window_operator_impl::MovingWindowAgg::kStd>;
+
 // Exponential weighted average operator.
 //
 // Takes in the (time-series) values and returns the exponential weighted moving
@@ -192,6 +746,214 @@ struct ExponentialWeightedMovingAverageOp {
   }
 };
 
+namespace ewma_operator_impl {
+
+// Incremental version of ExponentialWeightedMovingAverageOp for
+// TimeseriesStream. The result for a present value is the same as the one of
+// the operator. The result for a missing value is missing, while the operator
+// fills it with the previous average if a present value follows.
+template <typename ScalarT>
+class ExponentialWeightedMovingAverageAccumulator final
+    : public Accumulator<AccumulatorType::kPartial, OptionalValue<ScalarT>,
+                         meta::type_list<>,
+                         meta::type_list<OptionalValue<ScalarT>>> {
+ public:
+  static absl::StatusOr<ExponentialWeightedMovingAverageAccumulator> Create(
+      double alpha, bool adjust = true, bool ignore_missing = false) {
+    if (alpha <= 0 || alpha > 1) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("alpha must be in range (0, 1], got %f", alpha));
+    }
+    return ExponentialWeightedMovingAverageAccumulator(alpha, adjust,
+                                                       ignore_missing);
+  }
+
+  void Reset() final {
+    has_previous_ = false;
+    present_ = false;
+    numerator_ = 0;
+    denominator_ = 0;
+    previous_weight_ = 1. - alpha_;
+    previous_value_ = 0;
+  }
+
+  // Follows ExponentialWeightedMovingAverageOp::AdjustedEWMA and
+  // UnadjustedEWMA step by step, so the results are bitwise identical.
+  void Add(OptionalValue<ScalarT> value) final {
+    present_ = value.present;
+    if (!value.present) {
+      if (has_previous_ && !ignore_missing_) {
+        if (adjust_) {
+          numerator_ *= (1. - alpha_);
+          denominator_ *= (1. - alpha_);
+        } else {
+          previous_weight_ *= (1. - alpha_);
+        }
+      }
+      return;
+    }
+    if (adjust_) {
+      numerator_ = value.value + (1. - alpha_) * numerator_;
+      denominator_ = 1. + (1. - alpha_) * denominator_;
+      previous_value_ = numerator_ / denominator_;
+    } else {
+      if (!has_previous_) {
+        previous_value_ = value.value;
+      }
+      previous_value_ =
+          (alpha_ * value.value + previous_weight_ * previous_value_) /
+          (alpha_ + previous_weight_);
+      previous_weight_ = 1. - alpha_;
+    }
+    has_previous_ = true;
+  }
+
+  OptionalValue<ScalarT> GetResult() final {
+    if (!present_) {
+      return std::nullopt;
+    }
+    return static_cast<ScalarT>(previous_value_);
+  }
+
+  // Serialization of the state for TimeseriesStream. The parameters are not
+  // stored.
+  void SaveState(timeseries_state_impl::StateWriter& writer) const {
+    writer.WriteBool(has_previous_);
+    writer.WriteBool(present_);
+    writer.WriteDouble(numerator_);
+    writer.WriteDouble(denominator_);
+    writer.WriteDouble(previous_weight_);
+    writer.WriteDouble(previous_value_);
+  }
+  bool LoadState(timeseries_state_impl::StateReader& reader) {
+    return reader.ReadBool(&has_previous_) && reader.ReadBool(&present_) &&
+           reader.ReadDouble(&numerator_) &&
+           reader.ReadDouble(&denominator_) &&
+           reader.ReadDouble(&previous_weight_) &&
+           reader.ReadDouble(&previous_value_);
+  }
+
+ private:
+  ExponentialWeightedMovingAverageAccumulator(double alpha, bool adjust,
+                                              bool ignore_missing)
+      : alpha_(alpha), adjust_(adjust), ignore_missing_(ignore_missing) {}
+
+  double alpha_;
+  bool adjust_;
+  bool ignore_missing_;
+  bool has_previous_ = false;
+  bool present_ = false;
+  double numerator_ = 0;
+  double denominator_ = 0;
+  double previous_weight_ = 0;
+  double previous_value_ = 0;
+};
+
+}  // namespace ewma_operator_impl
+
+// Streaming evaluation of a time-series accumulator over many entities (e.g.
+// users or devices), for incremental feature generation.
+//
+// Every entity has its own accumulator that keeps the state between the calls,
+// so a new event of an entity is processed in O(1) amortized time instead of
+// reprocessing its full history. The result for an event is the one the
+// corresponding operator returns for the last row of the group containing the
+// entity history (see ExponentialWeightedMovingAverageAccumulator for the
+// only difference).
+//
+// Supports the accumulators defined in this file: MovingAverageAccumulator,
+// MovingWindowAccumulator, TimeMovingWindowAccumulator and
+// ExponentialWeightedMovingAverageAccumulator. The state of an entity can be
+// serialized, e.g. to keep it in a key-value storage between the processes,
+// and restored into a stream with the same accumulator parameters.
+//
+// If an event fails (e.g. its time is less than the previous one), the entity
+// keeps the error for all the following events, same as the whole group fails
+// in the operator, until its state is restored or erased.
+//
+// The class is not thread safe.
+template <typename Accumulator>
+class TimeseriesStream {
+  static_assert(
+      std::is_same_v<typename Accumulator::parent_types, meta::type_list<>>,
+      "TimeseriesStream supports only the accumulators without parent "
+      "arguments, i.e. the ones with Reset() taking no arguments");
+
+ public:
+  using ResultT = typename Accumulator::result_type;
+
+  // `empty_accumulator` is the prototype copied for every new entity.
+  explicit TimeseriesStream(Accumulator empty_accumulator)
+      : empty_accumulator_(std::move(empty_accumulator)) {
+    empty_accumulator_.Reset();
+  }
+
+  // Processes the next event of the entity. The arguments are the ones of
+  // Accumulator::Add.
+  template <typename... Args>
+  absl::StatusOr<ResultT> Add(absl::string_view key, const Args&... args) {
+    auto it = entities_.find(key);
+    if (it == entities_.end()) {
+      it = entities_.emplace(key, Entity{empty_accumulator_}).first;
+    }
+    Entity& entity = it->second;
+    RETURN_IF_ERROR(entity.status);
+    entity.accumulator.Add(args...);
+    ResultT result(entity.accumulator.GetResult());
+    entity.status = entity.accumulator.GetStatus();
+    RETURN_IF_ERROR(entity.status);
+    return result;
+  }
+
+  // Returns the serialized state of the entity. Returns NotFoundError if the
+  // stream has no state for the entity, and the error of the entity if it has
+  // failed.
+  absl::StatusOr<std::string> SerializeState(absl::string_view key) const {
+    auto it = entities_.find(key);
+    if (it == entities_.end()) {
+      return absl::NotFoundError(
+          absl::StrFormat("no timeseries state for entity %s", key));
+    }
+    RETURN_IF_ERROR(it->second.status);
+    timeseries_state_impl::StateWriter writer;
+    writer.WriteInt64(kFormatVersion);
+    it->second.accumulator.SaveState(writer);
+    return std::move(writer).Finish();
+  }
+
+  // Replaces the state of the entity with the one returned by
+  // SerializeState().
+  absl::Status RestoreState(absl::string_view key, absl::string_view data) {
+    Entity entity{empty_accumulator_};
+    timeseries_state_impl::StateReader reader(data);
+    int64_t version;
+    if (!reader.ReadInt64(&version) || version != kFormatVersion ||
+        !entity.accumulator.LoadState(reader) || !reader.AtEnd()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("invalid timeseries state for entity %s", key));
+    }
+    entities_.insert_or_assign(key, std::move(entity));
+    return absl::OkStatus();
+  }
+
+  // Drops the state of the entity, the following events start a new history.
+  // Returns false if the stream has no state for the entity.
+  bool Erase(absl::string_view key) { return entities_.erase(key) > 0; }
+
+  int64_t entity_count() const { return entities_.size(); }
+
+ private:
+  static constexpr int64_t kFormatVersion = 1;
+
+  struct Entity {
+    Accumulator accumulator;
+    absl::Status status;
+  };
+
+  Accumulator empty_accumulator_;
+  absl::flat_hash_map<std::string, Entity> entities_;
+};
+
 }  // namespace arolla
 
 #endif  // AROLLA_QEXPR_OPERATORS_EXPERIMENTAL_DENSE_ARRAY_TIMESERIES_H_
@@ -13,9 +13,13 @@
 // limitations under the License.
 //
 
+#include <cmath>
 #include <cstdint>
 #include <initializer_list>
+#include <limits>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -25,7 +29,10 @@
 #include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/operators.h"
+#include "arolla/qexpr/operators/experimental/dense_array/timeseries.h"
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 
@@ -35,6 +42,8 @@ namespace {
 using ::arolla::testing::IsOkAndHolds;
 using ::arolla::testing::StatusIs;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::HasSubstr;
 
 class AggMovingAverage : public ::testing::Test {
   void SetUp() final { ASSERT_OK(InitArolla()); }
@@ -48,6 +57,8 @@ absl::StatusOr<DenseArrayEdge> CreateEdgeFromSplitPoints(
 const char kAggMovingAverage[] = "experimental.agg_moving_average";
 constexpr auto NA = std::nullopt;
 
+MATCHER(IsNan, "") { return arg.present && std::isnan(arg.value); }
+
 TEST_F(AggMovingAverage, FullTimeSeries) {
   // moving_average([1, 2, 3, 4, 5, 6, 7, 8], 3) -> [None, None, 2, 3, 4, 5, 6,
   // 7]
@@ -116,6 +127,125 @@ TEST_F(AggMovingAverage, FullTimeSeriesWithTwoGroups) {
               IsOkAndHolds(ElementsAre(NA, NA, 2, 3, NA, NA, 6, 7)));
 }
 
+class AggMovingWindow : public ::testing::Test {
+  void SetUp() final { ASSERT_OK(InitArolla()); }
+};
+
+TEST_F(AggMovingWindow, RowBased) {
+  const auto series = CreateDenseArray<float>({1, 5, NA, 2, 4, 3, 7, 8});
+  ASSERT_OK_AND_ASSIGN(auto edge, CreateEdgeFromSplitPoints({0, 6, 8}));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("experimental.agg_moving_sum",
+                                                series, int64_t{3}, edge),
+              IsOkAndHolds(ElementsAre(1, 6, 6, 7, 6, 9, 7, 15)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("experimental.agg_moving_mean",
+                                                series, int64_t{3}, edge),
+              IsOkAndHolds(ElementsAre(1, 3, 3, 3.5, 3, 3, 7, 7.5)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("experimental.agg_moving_min",
+                                                series, int64_t{3}, edge),
+              IsOkAndHolds(ElementsAre(1, 1, 1, 2, 2, 2, 7, 7)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("experimental.agg_moving_max",
+                                                series, int64_t{3}, edge),
+              IsOkAndHolds(ElementsAre(1, 5, 5, 5, 4, 4, 7, 8)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>(
+                  "experimental.agg_moving_count", series, int64_t{3}, edge),
+              IsOkAndHolds(ElementsAre(1, 2, 2, 2, 2, 3, 1, 2)));
+}
+
+TEST_F(AggMovingWindow, RowBasedStd) {
+  const auto series = CreateDenseArray<double>({1, 3, 5, NA, 9});
+  ASSERT_OK_AND_ASSIGN(auto edge, CreateEdgeFromSplitPoints({0, 5}));
+  EXPECT_THAT(InvokeOperator<DenseArray<double>>("experimental.agg_moving_std",
+                                                 series, int64_t{2}, edge),
+              IsOkAndHolds(ElementsAre(0, 1, 1, 0, 0)));
+}
+
+TEST_F(AggMovingWindow, RowBasedEmptyWindows) {
+  const auto series = CreateDenseArray<float>({1, NA, NA, 4});
+  ASSERT_OK_AND_ASSIGN(auto edge, CreateEdgeFromSplitPoints({0, 4}));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("experimental.agg_moving_max",
+                                                series, int64_t{2}, edge),
+              IsOkAndHolds(ElementsAre(1, 1, NA, 4)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>(
+                  "experimental.agg_moving_count", series, int64_t{0}, edge),
+              IsOkAndHolds(ElementsAre(0, 0, 0, 0)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("experimental.agg_moving_sum",
+                                                series, int64_t{-1}, edge),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "window_size must be non-negative, got -1"));
+}
+
+TEST_F(AggMovingWindow, RowBasedNonFiniteValues) {
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+  const auto series =
+      CreateDenseArray<float>({1, kInf, 2, 3, -kInf, kInf, 4, kNaN, 5, 6});
+  ASSERT_OK_AND_ASSIGN(auto edge, CreateEdgeFromSplitPoints({0, 10}));
+  // Non-finite values do not affect the results after leaving the window.
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("experimental.agg_moving_sum",
+                                                series, int64_t{2}, edge),
+              IsOkAndHolds(ElementsAre(1, kInf, kInf, 5, -kInf, IsNan(), kInf,
+                                       IsNan(), IsNan(), 11)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("experimental.agg_moving_mean",
+                                                series, int64_t{2}, edge),
+              IsOkAndHolds(ElementsAre(1, kInf, kInf, 2.5, -kInf, IsNan(),
+                                       kInf, IsNan(), IsNan(), 5.5)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("experimental.agg_moving_std",
+                                                series, int64_t{2}, edge),
+              IsOkAndHolds(ElementsAre(0, IsNan(), IsNan(), 0.5, IsNan(),
+                                       IsNan(), IsNan(), IsNan(), IsNan(),
+                                       0.5)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("experimental.agg_moving_max",
+                                                series, int64_t{2}, edge),
+              IsOkAndHolds(ElementsAre(1, kInf, kInf, 3, 3, kInf, kInf,
+                                       IsNan(), IsNan(), 6)));
+}
+
+TEST_F(AggMovingWindow, RowBasedPrecision) {
+  // Naive running aggregates lose the small values next to the large one and
+  // would keep the error after the large value leaves the window.
+  const auto series = CreateDenseArray<double>({1e16, 1, 1, 1, 2, 3});
+  ASSERT_OK_AND_ASSIGN(auto edge, CreateEdgeFromSplitPoints({0, 6}));
+  EXPECT_THAT(InvokeOperator<DenseArray<double>>("experimental.agg_moving_sum",
+                                                 series, int64_t{2}, edge),
+              IsOkAndHolds(ElementsAre(1e16, 1e16 + 1, 2, 2, 3, 5)));
+  EXPECT_THAT(InvokeOperator<DenseArray<double>>("experimental.agg_moving_mean",
+                                                 series, int64_t{2}, edge),
+              IsOkAndHolds(ElementsAre(1e16, 5e15, 1, 1, 1.5, 2.5)));
+  EXPECT_THAT(InvokeOperator<DenseArray<double>>("experimental.agg_moving_std",
+                                                 series, int64_t{2}, edge),
+              IsOkAndHolds(ElementsAre(0, 5e15, 0, 0, 0.5, 0.5)));
+}
+
+TEST_F(AggMovingWindow, TimeBased) {
+  const auto series = CreateDenseArray<float>({1, 2, 3, 4, 5, 6});
+  const auto times = CreateDenseArray<int64_t>({0, 1, 1, 5, NA, 7});
+  ASSERT_OK_AND_ASSIGN(auto edge, CreateEdgeFromSplitPoints({0, 6}));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>(
+                  "experimental.agg_moving_sum_over_time", series, times,
+                  int64_t{3}, edge),
+              IsOkAndHolds(ElementsAre(1, 3, 6, 4, NA, 10)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>(
+                  "experimental.agg_moving_max_over_time", series, times,
+                  int64_t{3}, edge),
+              IsOkAndHolds(ElementsAre(1, 2, 3, 4, NA, 6)));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>(
+                  "experimental.agg_moving_count_over_time", series, times,
+                  int64_t{1}, edge),
+              IsOkAndHolds(ElementsAre(1, 1, 2, 1, NA, 1)));
+}
+
+TEST_F(AggMovingWindow, TimeBasedUnsortedTimes) {
+  const auto series = CreateDenseArray<float>({1, 2, 3});
+  const auto times = CreateDenseArray<int64_t>({0, 2, 1});
+  ASSERT_OK_AND_ASSIGN(auto edge, CreateEdgeFromSplitPoints({0, 3}));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>(
+                  "experimental.agg_moving_min_over_time", series, times,
+                  int64_t{3}, edge),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "times must be non-decreasing within a group, got 1 "
+                       "after 2"));
+}
+
 class ExponentialWeightedMovingAverageOpTest : public ::testing::Test {
   void SetUp() final { ASSERT_OK(InitArolla()); }
 };
@@ -355,5 +485,155 @@ TEST_F(ExponentialWeightedMovingAverageOpTest, AlphaEqualsOne_FirstMissing) {
               IsOkAndHolds(ElementsAre(NA, 2, 3, 3, 5)));
 }
 
+template <typename T>
+std::vector<OptionalValue<T>> ToVector(const DenseArray<T>& array) {
+  return std::vector<OptionalValue<T>>(array.begin(), array.end());
+}
+
+TEST(TimeseriesStream, MovingWindow) {
+  using moving_window_operator_impl::MovingWindowAccumulator;
+  using moving_window_operator_impl::MovingWindowAgg;
+  using Acc = MovingWindowAccumulator<float, MovingWindowAgg::kMax>;
+  const auto a_series = CreateDenseArray<float>({1, 5, NA, 2, 4, 3});
+  const auto b_series = CreateDenseArray<float>({7, 8});
+  TimeseriesStream<Acc> stream(Acc(/*window_size=*/3));
+  // The events of the entities are interleaved.
+  std::vector<OptionalValue<float>> a_results, b_results;
+  for (int64_t i = 0; i < a_series.size(); ++i) {
+    ASSERT_OK_AND_ASSIGN(auto a_result, stream.Add("a", a_series[i]));
+    a_results.push_back(a_result);
+    if (i < b_series.size()) {
+      ASSERT_OK_AND_ASSIGN(auto b_result, stream.Add("b", b_series[i]));
+      b_results.push_back(b_result);
+    }
+  }
+  EXPECT_EQ(stream.entity_count(), 2);
+
+  EvaluationContext ctx;
+  ASSERT_OK_AND_ASSIGN(auto a_edge, CreateEdgeFromSplitPoints({0, 6}));
+  ASSERT_OK_AND_ASSIGN(auto b_edge, CreateEdgeFromSplitPoints({0, 2}));
+  ASSERT_OK_AND_ASSIGN(auto a_expected,
+                       AggMovingMaxOp()(&ctx, a_series, 3, a_edge));
+  ASSERT_OK_AND_ASSIGN(auto b_expected,
+                       AggMovingMaxOp()(&ctx, b_series, 3, b_edge));
+  EXPECT_THAT(a_results, ElementsAreArray(ToVector(a_expected)));
+  EXPECT_THAT(b_results, ElementsAreArray(ToVector(b_expected)));
+}
+
+TEST(TimeseriesStream, MovingAverage) {
+  using Acc = moving_average_operator_impl::MovingAverageAccumulator<float>;
+  const auto series = CreateDenseArray<float>({1, 2, 3, 4, NA, 6, 7, 8});
+  TimeseriesStream<Acc> stream(Acc(/*window_size=*/3));
+  std::vector<OptionalValue<float>> results;
+  for (const auto& value : series) {
+    ASSERT_OK_AND_ASSIGN(auto result, stream.Add("a", value));
+    results.push_back(result);
+  }
+  EXPECT_THAT(results, ElementsAre(NA, NA, 2, 3, NA, NA, NA, 7));
+}
+
+TEST(TimeseriesStream, MovingAverageSerializeState) {
+  using Acc = moving_average_operator_impl::MovingAverageAccumulator<float>;
+  TimeseriesStream<Acc> stream(Acc(/*window_size=*/3));
+  ASSERT_OK(stream.Add("a", OptionalValue<float>(1)).status());
+  ASSERT_OK(stream.Add("a", OptionalValue<float>(2)).status());
+  ASSERT_OK_AND_ASSIGN(std::string state, stream.SerializeState("a"));
+
+  TimeseriesStream<Acc> restored_stream(Acc(/*window_size=*/3));
+  ASSERT_OK(restored_stream.RestoreState("a", state));
+  EXPECT_THAT(restored_stream.Add("a", OptionalValue<float>(6)),
+              IsOkAndHolds(3));
+  EXPECT_THAT(restored_stream.Add("a", OptionalValue<float>(7)),
+              IsOkAndHolds(5));
+}
+
+TEST(TimeseriesStream, ExponentialWeightedMovingAverage) {
+  using Acc = ewma_operator_impl::ExponentialWeightedMovingAverageAccumulator<
+      double>;
+  EXPECT_THAT(Acc::Create(0.),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "alpha must be in range (0, 1], got 0.000000"));
+  const auto series = CreateDenseArray<double>({NA, 1, 2, NA, NA, 5, NA, 7});
+  for (bool adjust : {false, true}) {
+    for (bool ignore_missing : {false, true}) {
+      ASSERT_OK_AND_ASSIGN(auto acc, Acc::Create(0.6, adjust, ignore_missing));
+      TimeseriesStream<Acc> stream(acc);
+      ASSERT_OK_AND_ASSIGN(
+          auto expected, ExponentialWeightedMovingAverageOp()(
+                             series, 0.6, adjust, ignore_missing));
+      for (int64_t i = 0; i < series.size(); ++i) {
+        ASSERT_OK_AND_ASSIGN(auto result, stream.Add("a", series[i]));
+        // The operator fills the missing values with the previous averages.
+        EXPECT_EQ(result, series.present(i) ? expected[i] : NA)
+            << i << " " << adjust << " " << ignore_missing;
+      }
+    }
+  }
+}
+
+TEST(TimeseriesStream, SerializeState) {
+  using moving_window_operator_impl::MovingWindowAgg;
+  using moving_window_operator_impl::TimeMovingWindowAccumulator;
+  using Acc = TimeMovingWindowAccumulator<double, MovingWindowAgg::kStd>;
+  const auto series =
+      CreateDenseArray<double>({1, 2.5, NA, 4, 0.1, 9, 7, 3.3, 2});
+  const auto times = CreateDenseArray<int64_t>({0, 1, 1, 5, 6, 6, 7, 10, 11});
+  TimeseriesStream<Acc> stream(Acc(/*window_duration=*/4));
+  for (int64_t i = 0; i < 5; ++i) {
+    ASSERT_OK(stream.Add("a", series[i], times[i]).status());
+  }
+  EXPECT_THAT(stream.SerializeState("b"),
+              StatusIs(absl::StatusCode::kNotFound,
+                       "no timeseries state for entity b"));
+  ASSERT_OK_AND_ASSIGN(std::string state, stream.SerializeState("a"));
+
+  TimeseriesStream<Acc> restored_stream(Acc(/*window_duration=*/4));
+  ASSERT_OK(restored_stream.RestoreState("a", state));
+  for (int64_t i = 5; i < series.size(); ++i) {
+    ASSERT_OK_AND_ASSIGN(auto expected, stream.Add("a", series[i], times[i]));
+    EXPECT_THAT(restored_stream.Add("a", series[i], times[i]),
+                IsOkAndHolds(expected));
+  }
+
+  EXPECT_THAT(
+      restored_stream.RestoreState("a", state.substr(0, state.size() - 1)),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               "invalid timeseries state for entity a"));
+  EXPECT_THAT(restored_stream.RestoreState("a", state + "x"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(restored_stream.RestoreState("a", ""),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(TimeseriesStream, FailedEntity) {
+  using moving_window_operator_impl::MovingWindowAgg;
+  using moving_window_operator_impl::TimeMovingWindowAccumulator;
+  using Acc = TimeMovingWindowAccumulator<float, MovingWindowAgg::kSum>;
+  TimeseriesStream<Acc> stream(Acc(/*window_duration=*/3));
+  ASSERT_OK(stream.Add("a", OptionalValue<float>(1), OptionalValue<int64_t>(2))
+                .status());
+  ASSERT_OK_AND_ASSIGN(std::string state, stream.SerializeState("a"));
+  EXPECT_THAT(
+      stream.Add("a", OptionalValue<float>(2), OptionalValue<int64_t>(1)),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("times must be non-decreasing")));
+  // The error is kept until the state is restored or erased.
+  EXPECT_THAT(
+      stream.Add("a", OptionalValue<float>(3), OptionalValue<int64_t>(3)),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(stream.SerializeState("a"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  ASSERT_OK(stream.RestoreState("a", state));
+  EXPECT_THAT(
+      stream.Add("a", OptionalValue<float>(3), OptionalValue<int64_t>(3)),
+      IsOkAndHolds(4.f));
+  EXPECT_TRUE(stream.Erase("a"));
+  EXPECT_FALSE(stream.Erase("a"));
+  EXPECT_EQ(stream.entity_count(), 0);
+  EXPECT_THAT(
+      stream.Add("a", OptionalValue<float>(3), OptionalValue<int64_t>(1)),
+      IsOkAndHolds(3.f));
+}
+
 }  // namespace
 }  // namespace arolla
@@ -0,0 +1,57 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QEXPR_OPERATORS_HALF_HALF_H_
+#define AROLLA_QEXPR_OPERATORS_HALF_HALF_H_
+
+#include <type_traits>
+
+#include "arolla/qtype/half/half_types.h"
+
+namespace arolla {
+
+// Converts FLOAT16 / BFLOAT16 to FLOAT32. The conversion is exact, so lifted
+// to DenseArray it is the "load as half, compute as float" step: the arrays
+// stay half-sized in memory and are widened batch by batch.
+struct HalfToFloat32Op {
+  using run_on_missing = std::true_type;
+  template <typename T>
+  float operator()(T x) const {
+    return static_cast<float>(x);
+  }
+};
+
+// Converts FLOAT32 / FLOAT64 to FLOAT16, rounding to nearest even. Values out
+// of the FLOAT16 range become infinities. FLOAT64 is rounded to FLOAT32 first.
+struct ToFloat16Op {
+  using run_on_missing = std::true_type;
+  template <typename T>
+  Float16 operator()(T x) const {
+    return Float16(static_cast<float>(x));
+  }
+};
+
+// Converts FLOAT32 / FLOAT64 to BFLOAT16, rounding to nearest even. FLOAT64 is
+// rounded to FLOAT32 first.
+struct ToBFloat16Op {
+  using run_on_missing = std::true_type;
+  template <typename T>
+  BFloat16 operator()(T x) const {
+    return BFloat16(static_cast<float>(x));
+  }
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_QEXPR_OPERATORS_HALF_HALF_H_
@@ -0,0 +1,71 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <limits>
+#include <optional>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/half/half_types.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::IsOkAndHolds;
+using ::testing::ElementsAre;
+
+class HalfOperatorsTest : public ::testing::Test {
+  void SetUp() final { ASSERT_OK(InitArolla()); }
+};
+
+TEST_F(HalfOperatorsTest, ToFloat32) {
+  EXPECT_THAT(InvokeOperator<float>("half.to_float32", Float16(1.5f)),
+              IsOkAndHolds(1.5f));
+  EXPECT_THAT(InvokeOperator<float>("half.to_float32", BFloat16(-3.0f)),
+              IsOkAndHolds(-3.0f));
+  EXPECT_THAT(InvokeOperator<OptionalValue<float>>(
+                  "half.to_float32", OptionalValue<Float16>()),
+              IsOkAndHolds(std::nullopt));
+}
+
+TEST_F(HalfOperatorsTest, FromFloat) {
+  ASSERT_OK_AND_ASSIGN(auto f16,
+                       InvokeOperator<Float16>("half.to_float16", 1.001f));
+  EXPECT_EQ(static_cast<float>(f16), 1.0009765625f);
+  ASSERT_OK_AND_ASSIGN(auto bf16,
+                       InvokeOperator<BFloat16>("half.to_bfloat16", 1.001));
+  EXPECT_EQ(static_cast<float>(bf16), 1.0f);
+}
+
+TEST_F(HalfOperatorsTest, DenseArray) {
+  auto weights =
+      CreateDenseArray<float>({0.5f, std::nullopt, -2.0f, 65536.0f});
+  ASSERT_OK_AND_ASSIGN(auto f16, InvokeOperator<DenseArray<Float16>>(
+                                     "half.to_float16", weights));
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("half.to_float32", f16),
+              IsOkAndHolds(ElementsAre(0.5f, std::nullopt, -2.0f, kInf)));
+  ASSERT_OK_AND_ASSIGN(auto bf16, InvokeOperator<DenseArray<BFloat16>>(
+                                      "half.to_bfloat16", weights));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("half.to_float32", bf16),
+              IsOkAndHolds(ElementsAre(0.5f, std::nullopt, -2.0f, 65536.0f)));
+}
+
+}  // namespace
+}  // namespace arolla
@@ -15,18 +15,25 @@
 #ifndef AROLLA_QEXPR_OPERATORS_MATH_BATCH_ARITHMETIC_H_
 #define AROLLA_QEXPR_OPERATORS_MATH_BATCH_ARITHMETIC_H_
 
+#include <cmath>
+#include <cstddef>
+#include <limits>
 #include <type_traits>
 
 #include "absl/log/check.h"
 #include "absl/types/span.h"
 #include "Eigen/Core"
 
-// Implements basic operations +,-,* for spans using eigen3.
+// Implements basic operations +,-,* and some transcendental functions for
+// spans using eigen3.
 // Usage examples:
 //   BatchAdd<float>()(mutable_span_res, span1, span2);
 //   BatchSub<int64_t>()(mutable_span_res, span1, span2);
 //   BatchProd<double>()(mutable_span_res, span1, span2);
+//   BatchLog()(mutable_span_res, span);
 //   float sum = BatchAggSum<float>(span);
+//   double dot = BatchDot<float>(span1, span2);
+//   BatchMatVec<float>(mutable_span_res, matrix_span, vector_span);
 
 namespace arolla {
 
@@ -83,6 +90,60 @@ struct SubOp {
   }
 };
 
+// Unary elementwise function on float/double spans. Eigen evaluates it with
+// SIMD polynomial approximations for the instruction set the binary is
+// compiled for, so the results may differ from libm. Measured against glibc:
+//   log:   <= 1 ULP for float and double;
+//   exp:   <= 2 ULP while the result is a normal number, subnormal results
+//          are flushed to zero;
+//   log1p, expm1: <= 2 ULP for float; Eigen 3.4 has no packet implementation
+//          for double, so it calls libm for each element.
+template <class OP>
+struct UnaryEigenOperation {
+  template <typename T>
+  void operator()(absl::Span<T> result, absl::Span<const T> a) const {
+    static_assert(std::is_floating_point_v<T>);
+    auto size = a.size();
+    DCHECK_EQ(size, result.size());
+    DynamicEigenVectorView<T> eigen_a(a.data(), size);
+    DynamicMutableEigenVectorView<T> eigen_result(result.data(), size);
+    OP::Apply(eigen_a, &eigen_result);
+  }
+};
+
+struct LogOp {
+  template <typename T, typename RT>
+  static void Apply(const T& a, RT* c) {
+    *c = a.log();
+  }
+};
+
+struct Log1pOp {
+  template <typename T, typename RT>
+  static void Apply(const T& a, RT* c) {
+    *c = a.log1p();
+  }
+};
+
+struct ExpOp {
+  template <typename T, typename RT>
+  static void Apply(const T& a, RT* c) {
+    using Scalar = typename T::Scalar;
+    *c = a.exp();
+    // Eigen's exp does not underflow correctly for the inputs below
+    // log(min normal), so we flush such results to zero.
+    const Scalar min_arg = std::log(std::numeric_limits<Scalar>::min());
+    *c = (a < min_arg).select(Scalar{0}, *c);
+  }
+};
+
+struct Expm1Op {
+  template <typename T, typename RT>
+  static void Apply(const T& a, RT* c) {
+    *c = a.expm1();
+  }
+};
+
 template <typename T>
 static auto MakeUnsignedIfIntegralFn() {
   if constexpr (std::is_integral_v<T>) {
@@ -114,6 +175,18 @@ using BatchProd = batch_arithmetic_internal::BinaryEigenOperation<
     T, batch_arithmetic_internal::ProdOp,
     batch_arithmetic_internal::UnsignedIfIntegral<T>>;
 
+using BatchLog = batch_arithmetic_internal::UnaryEigenOperation<
+    batch_arithmetic_internal::LogOp>;
+
+using BatchLog1p = batch_arithmetic_internal::UnaryEigenOperation<
+    batch_arithmetic_internal::Log1pOp>;
+
+using BatchExp = batch_arithmetic_internal::UnaryEigenOperation<
+    batch_arithmetic_internal::ExpOp>;
+
+using BatchExpm1 = batch_arithmetic_internal::UnaryEigenOperation<
+    batch_arithmetic_internal::Expm1Op>;
+
 template <typename T>
 T BatchAggSum(absl::Span<const T> data) {
   batch_arithmetic_internal::DynamicEigenVectorView<T> e_data(data.data(),
@@ -121,6 +194,61 @@ T BatchAggSum(absl::Span<const T> data) {
   return e_data.sum();
 }
 
+// Returns the dot product of `a` and `b`. The products are accumulated in
+// double, like math._sum does for floating point values.
+template <typename T>
+double BatchDot(absl::Span<const T> a, absl::Span<const T> b) {
+  static_assert(std::is_floating_point_v<T>);
+  DCHECK_EQ(a.size(), b.size());
+  if constexpr (std::is_same_v<T, double>) {
+    batch_arithmetic_internal::DynamicEigenVectorView<T> e_a(a.data(),
+                                                             a.size());
+    batch_arithmetic_internal::DynamicEigenVectorView<T> e_b(b.data(),
+                                                             b.size());
+    return e_a.matrix().dot(e_b.matrix());
+  } else {
+    // Eigen doesn't vectorize the float -> double cast without AVX, so we use
+    // independent accumulators that the compiler can vectorize instead.
+    constexpr size_t kLanes = 8;
+    const T* a_data = a.data();
+    const T* b_data = b.data();
+    const size_t size = a.size();
+    double sums[kLanes] = {};
+    size_t i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+      for (size_t j = 0; j < kLanes; ++j) {
+        sums[j] += static_cast<double>(a_data[i + j]) *
+                   static_cast<double>(b_data[i + j]);
+      }
+    }
+    double result = ((sums[0] + sums[4]) + (sums[1] + sums[5])) +
+                    ((sums[2] + sums[6]) + (sums[3] + sums[7]));
+    for (; i < size; ++i) {
+      result += static_cast<double>(a_data[i]) * static_cast<double>(b_data[i]);
+    }
+    return result;
+  }
+}
+
+// Computes `result = matrix * vector`, where `matrix` is stored in row-major
+// order and has result.size() rows and vector.size() columns. Unlike BatchDot,
+// the products are accumulated in T, which allows Eigen to use its
+// vectorized matrix-vector kernel.
+template <typename T>
+void BatchMatVec(absl::Span<T> result, absl::Span<const T> matrix,
+                 absl::Span<const T> vector) {
+  static_assert(std::is_floating_point_v<T>);
+  DCHECK_EQ(matrix.size(), result.size() * vector.size());
+  using RowMajorMatrix =
+      Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using Vector = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+  Eigen::Map<const RowMajorMatrix> e_matrix(matrix.data(), result.size(),
+                                            vector.size());
+  Eigen::Map<const Vector> e_vector(vector.data(), vector.size());
+  Eigen::Map<Vector> e_result(result.data(), result.size());
+  e_result.noalias() = e_matrix * e_vector;
+}
+
 }  // namespace arolla
 
 #endif  // AROLLA_QEXPR_OPERATORS_MATH_BATCH_ARITHMETIC_H_
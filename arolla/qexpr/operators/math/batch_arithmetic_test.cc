@@ -14,7 +14,9 @@
 //
 #include "arolla/qexpr/operators/math/batch_arithmetic.h"
 
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -48,10 +50,67 @@ TEST(BatchArithmetic, BatchProd) {
   EXPECT_THAT(res, testing::ElementsAre(3.5, 4.5, 4.0));
 }
 
+TEST(BatchArithmetic, BatchLog) {
+  std::vector<float> arg{1., 2., 0., -1.};
+  std::vector<float> res(4);
+  BatchLog()(absl::Span<float>(res), absl::Span<const float>(arg));
+  EXPECT_THAT(res, testing::ElementsAre(
+                       0., testing::FloatEq(std::log(2.f)),
+                       -std::numeric_limits<float>::infinity(),
+                       testing::IsNan()));
+}
+
+TEST(BatchArithmetic, BatchLog1p) {
+  std::vector<double> arg{0., 1e-10, 1.};
+  std::vector<double> res(3);
+  BatchLog1p()(absl::Span<double>(res), absl::Span<const double>(arg));
+  EXPECT_THAT(res,
+              testing::ElementsAre(0., testing::DoubleEq(std::log1p(1e-10)),
+                                   testing::DoubleEq(std::log1p(1.))));
+}
+
+TEST(BatchArithmetic, BatchExp) {
+  std::vector<double> arg{0., 1., -1000., 1000.};
+  std::vector<double> res(4);
+  BatchExp()(absl::Span<double>(res), absl::Span<const double>(arg));
+  EXPECT_THAT(res, testing::ElementsAre(
+                       1., testing::DoubleEq(std::exp(1.)), 0.,
+                       std::numeric_limits<double>::infinity()));
+}
+
+TEST(BatchArithmetic, BatchExpm1) {
+  std::vector<float> arg{0., 1e-6, 1.};
+  std::vector<float> res(3);
+  BatchExpm1()(absl::Span<float>(res), absl::Span<const float>(arg));
+  EXPECT_THAT(res,
+              testing::ElementsAre(0., testing::FloatEq(std::expm1(1e-6f)),
+                                   testing::FloatEq(std::expm1(1.f))));
+}
+
 TEST(BatchArithmetic, AggSum) {
   std::vector<float> arg{1., 3., 2.};
   EXPECT_EQ(BatchAggSum<float>(arg), 6.);
 }
 
+TEST(BatchArithmetic, Dot) {
+  std::vector<float> arg1{1., 3., 2.};
+  std::vector<float> arg2{0.5, -1., 4.};
+  EXPECT_EQ(BatchDot<float>(arg1, arg2), 5.5);
+  EXPECT_EQ(BatchDot<float>({}, {}), 0.);
+  // Accumulated in double.
+  std::vector<float> arg3{1e10f, 1.f, -1e10f};
+  std::vector<float> arg4{1.f, 1.f, 1.f};
+  EXPECT_EQ(BatchDot<float>(arg3, arg4), 1.);
+}
+
+TEST(BatchArithmetic, MatVec) {
+  // 2x3 matrix in row-major order.
+  std::vector<double> matrix{1., 2., 3., 4., 5., 6.};
+  std::vector<double> vector{1., 0., -1.};
+  std::vector<double> res(2);
+  BatchMatVec<double>(absl::MakeSpan(res), matrix, vector);
+  EXPECT_THAT(res, testing::ElementsAre(-2., -2.));
+}
+
 }  // namespace
 }  // namespace arolla
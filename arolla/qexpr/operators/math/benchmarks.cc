@@ -21,7 +21,10 @@
 #include <vector>
 
 #include "benchmark/benchmark.h"
+#include "absl/types/span.h"
 #include "arolla/qexpr/operators/math/arithmetic.h"
+#include "arolla/qexpr/operators/math/batch_arithmetic.h"
+#include "arolla/qexpr/operators/math/math.h"
 
 namespace arolla {
 
@@ -120,6 +123,181 @@ void BM_StdFminNoNan_Float64(benchmark::State& state) {
                        [](double x, double y) { return std::fmin(x, y); });
 }
 
+template <typename T, typename Fn>
+void ScalarUnaryBenchmark(benchmark::State& state, Fn fn) {
+  auto values = RandomVector01<T>(state.range(0));
+  std::vector<T> result(values.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(values.data());
+    for (size_t i = 0; i < values.size(); ++i) {
+      result[i] = fn(values[i]);
+    }
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+template <typename T, typename BatchFn>
+void BatchUnaryBenchmark(benchmark::State& state, BatchFn fn) {
+  auto values = RandomVector01<T>(state.range(0));
+  std::vector<T> result(values.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(values.data());
+    fn(absl::Span<T>(result), absl::Span<const T>(values));
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+void BM_LogOp_Float32(benchmark::State& state) {
+  ScalarUnaryBenchmark<float>(state, LogOp());
+}
+
+void BM_BatchLog_Float32(benchmark::State& state) {
+  BatchUnaryBenchmark<float>(state, BatchLog());
+}
+
+void BM_LogOp_Float64(benchmark::State& state) {
+  ScalarUnaryBenchmark<double>(state, LogOp());
+}
+
+void BM_BatchLog_Float64(benchmark::State& state) {
+  BatchUnaryBenchmark<double>(state, BatchLog());
+}
+
+void BM_Log1pOp_Float32(benchmark::State& state) {
+  ScalarUnaryBenchmark<float>(state, Log1pOp());
+}
+
+void BM_BatchLog1p_Float32(benchmark::State& state) {
+  BatchUnaryBenchmark<float>(state, BatchLog1p());
+}
+
+void BM_ExpOp_Float32(benchmark::State& state) {
+  ScalarUnaryBenchmark<float>(state, ExpOp());
+}
+
+void BM_BatchExp_Float32(benchmark::State& state) {
+  BatchUnaryBenchmark<float>(state, BatchExp());
+}
+
+void BM_ExpOp_Float64(benchmark::State& state) {
+  ScalarUnaryBenchmark<double>(state, ExpOp());
+}
+
+void BM_BatchExp_Float64(benchmark::State& state) {
+  BatchUnaryBenchmark<double>(state, BatchExp());
+}
+
+void BM_Expm1Op_Float32(benchmark::State& state) {
+  ScalarUnaryBenchmark<float>(state, Expm1Op());
+}
+
+void BM_BatchExpm1_Float32(benchmark::State& state) {
+  BatchUnaryBenchmark<float>(state, BatchExpm1());
+}
+
+template <typename T>
+void ScalarDotBenchmark(benchmark::State& state) {
+  const int64_t group_size = state.range(0);
+  auto x = RandomVector01<T>(65536);
+  auto y = RandomVector01<T>(65536);
+  std::vector<T> result(x.size() / group_size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x.data());
+    benchmark::DoNotOptimize(y.data());
+    for (size_t g = 0; g < result.size(); ++g) {
+      double sum = 0;
+      for (int64_t i = g * group_size; i < (g + 1) * group_size; ++i) {
+        sum += static_cast<double>(x[i]) * static_cast<double>(y[i]);
+      }
+      result[g] = sum;
+    }
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+template <typename T>
+void BatchDotBenchmark(benchmark::State& state) {
+  const int64_t group_size = state.range(0);
+  auto x = RandomVector01<T>(65536);
+  auto y = RandomVector01<T>(65536);
+  std::vector<T> result(x.size() / group_size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x.data());
+    benchmark::DoNotOptimize(y.data());
+    for (size_t g = 0; g < result.size(); ++g) {
+      result[g] = BatchDot<T>(absl::MakeConstSpan(x).subspan(g * group_size,
+                                                             group_size),
+                              absl::MakeConstSpan(y).subspan(g * group_size,
+                                                             group_size));
+    }
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+void BM_ScalarDot_Float32(benchmark::State& state) {
+  ScalarDotBenchmark<float>(state);
+}
+
+void BM_BatchDot_Float32(benchmark::State& state) {
+  BatchDotBenchmark<float>(state);
+}
+
+void BM_ScalarDot_Float64(benchmark::State& state) {
+  ScalarDotBenchmark<double>(state);
+}
+
+void BM_BatchDot_Float64(benchmark::State& state) {
+  BatchDotBenchmark<double>(state);
+}
+
+template <typename T>
+void ScalarMatVecBenchmark(benchmark::State& state) {
+  const int64_t rows = state.range(0);
+  const int64_t cols = state.range(1);
+  auto matrix = RandomVector01<T>(rows * cols);
+  auto vector = RandomVector01<T>(cols);
+  std::vector<T> result(rows);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(matrix.data());
+    for (int64_t r = 0; r < rows; ++r) {
+      T sum = 0;
+      for (int64_t c = 0; c < cols; ++c) {
+        sum += matrix[r * cols + c] * vector[c];
+      }
+      result[r] = sum;
+    }
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * matrix.size());
+}
+
+template <typename T>
+void BatchMatVecBenchmark(benchmark::State& state) {
+  const int64_t rows = state.range(0);
+  const int64_t cols = state.range(1);
+  auto matrix = RandomVector01<T>(rows * cols);
+  auto vector = RandomVector01<T>(cols);
+  std::vector<T> result(rows);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(matrix.data());
+    BatchMatVec<T>(absl::MakeSpan(result), matrix, vector);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * matrix.size());
+}
+
+void BM_ScalarMatVec_Float32(benchmark::State& state) {
+  ScalarMatVecBenchmark<float>(state);
+}
+
+void BM_BatchMatVec_Float32(benchmark::State& state) {
+  BatchMatVecBenchmark<float>(state);
+}
+
 BENCHMARK(BM_MinOp_Float32);
 BENCHMARK(BM_MinOp_Float64);
 BENCHMARK(BM_MinNoNan_Float32);
@@ -130,5 +308,23 @@ BENCHMARK(BM_StdMinNoNan_Float32);
 BENCHMARK(BM_StdMinNoNan_Float64);
 BENCHMARK(BM_StdFminNoNan_Float32);
 BENCHMARK(BM_StdFminNoNan_Float64);
+BENCHMARK(BM_LogOp_Float32)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_BatchLog_Float32)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_LogOp_Float64)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_BatchLog_Float64)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_Log1pOp_Float32)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_BatchLog1p_Float32)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_ExpOp_Float32)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_BatchExp_Float32)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_ExpOp_Float64)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_BatchExp_Float64)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_Expm1Op_Float32)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_BatchExpm1_Float32)->Arg(1024)->Arg(65536);
+BENCHMARK(BM_ScalarDot_Float32)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(BM_BatchDot_Float32)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(BM_ScalarDot_Float64)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(BM_BatchDot_Float64)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(BM_ScalarMatVec_Float32)->Args({16, 16})->Args({64, 256});
+BENCHMARK(BM_BatchMatVec_Float32)->Args({16, 16})->Args({64, 256});
 
 }  // namespace arolla
@@ -17,7 +17,9 @@
 
 #include <cstdint>
 #include <optional>
+#include <utility>
 
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "arolla/array/array.h"
@@ -26,6 +28,7 @@
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/ops/dense_ops.h"
 #include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/util/binary_search.h"
@@ -44,6 +47,24 @@ struct SearchSortedOp {
                : LowerBound(needle, haystack.values.span());
   }
 
+  // Searches all the values of a full `needle` in one batch.
+  template <typename T>
+  static DenseArray<int64_t> SearchFull(EvaluationContext* ctx,
+                                        const DenseArray<T>& haystack,
+                                        const DenseArray<T>& needle,
+                                        OptionalValue<bool> right) {
+    DCHECK(needle.IsFull());
+    Buffer<int64_t>::Builder builder(needle.size(), &ctx->buffer_factory());
+    if (right.present && right.value) {
+      BatchUpperBound(needle.values.span(), haystack.values.span(),
+                      builder.GetMutableSpan());
+    } else {
+      BatchLowerBound(needle.values.span(), haystack.values.span(),
+                      builder.GetMutableSpan());
+    }
+    return DenseArray<int64_t>{std::move(builder).Build()};
+  }
+
   template <typename T>
   static absl::Status VerifyHaystack(const DenseArray<T>& haystack) {
     if (!haystack.IsFull()) {
@@ -77,6 +98,9 @@ struct SearchSortedOp {
       EvaluationContext* ctx, const DenseArray<T>& haystack,
       const DenseArray<T>& needle, OptionalValue<bool> right) const {
     RETURN_IF_ERROR(VerifyHaystack(haystack));
+    if (needle.IsFull()) {
+      return SearchFull(ctx, haystack, needle, right);
+    }
     auto op = CreateDenseOp<DenseOpFlags::kNoBitmapOffset>(
         [&](view_type_t<T> needle) -> int64_t {
           return SearchFull(haystack, needle, right);
@@ -91,6 +115,10 @@ struct SearchSortedOp {
                                             const Array<T>& needle,
                                             OptionalValue<bool> right) const {
     RETURN_IF_ERROR(VerifyHaystack(haystack));
+    if (needle.IsFullForm()) {
+      return Array<int64_t>(
+          SearchFull(ctx, haystack, needle.dense_data(), right));
+    }
     auto op = CreateArrayOp<DenseOpFlags::kNoBitmapOffset>(
         [&](view_type_t<T> needle) -> int64_t {
           return SearchFull(haystack, needle, right);
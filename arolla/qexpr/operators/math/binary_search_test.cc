@@ -14,22 +14,28 @@
 //
 #include "arolla/qexpr/operators/math/binary_search.h"
 
+#include <cstdint>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "arolla/array/array.h"
 #include "arolla/dense_array/bitmap.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/memory/buffer.h"
+#include "arolla/qexpr/eval_context.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 
 namespace arolla {
 namespace {
 
 using ::arolla::testing::IsOk;
+using ::arolla::testing::IsOkAndHolds;
 using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
 
 TEST(BinarySearch, VerifyHaystackFullBitmap) {
   Buffer<float> values(CreateBuffer(std::vector<float>{1., 2., 3.}));
@@ -58,5 +64,39 @@ TEST(BinarySearch, VerifyHaystackRaisesNotFullBitmap) {
                "math.searchsorted operator supports only full haystacks"));
 }
 
+TEST(BinarySearch, SearchSortedDenseArray) {
+  auto haystack = CreateDenseArray<float>({1., 2., 2., 3.});
+  EvaluationContext ctx;
+  {
+    auto needle = CreateDenseArray<float>({0., 2., 2.5, 3., 4.});
+    EXPECT_THAT(SearchSortedOp()(&ctx, haystack, needle, false),
+                IsOkAndHolds(ElementsAre(0, 1, 3, 3, 4)));
+    EXPECT_THAT(SearchSortedOp()(&ctx, haystack, needle, true),
+                IsOkAndHolds(ElementsAre(0, 3, 3, 4, 4)));
+  }
+  {
+    auto needle = CreateDenseArray<float>({0., std::nullopt, 2., 4.});
+    EXPECT_THAT(SearchSortedOp()(&ctx, haystack, needle, false),
+                IsOkAndHolds(ElementsAre(0, std::nullopt, 1, 4)));
+    EXPECT_THAT(SearchSortedOp()(&ctx, haystack, needle, true),
+                IsOkAndHolds(ElementsAre(0, std::nullopt, 3, 4)));
+  }
+}
+
+TEST(BinarySearch, SearchSortedArray) {
+  auto haystack = CreateDenseArray<int64_t>({1, 2, 2, 3});
+  EvaluationContext ctx;
+  {
+    auto needle = CreateArray<int64_t>({0, 2, 3, 4});
+    EXPECT_THAT(SearchSortedOp()(&ctx, haystack, needle, false),
+                IsOkAndHolds(ElementsAre(0, 1, 3, 4)));
+  }
+  {
+    auto needle = CreateArray<int64_t>({0, std::nullopt, 3, 4});
+    EXPECT_THAT(SearchSortedOp()(&ctx, haystack, needle, true),
+                IsOkAndHolds(ElementsAre(0, std::nullopt, 4, 4)));
+  }
+}
+
 }  // namespace
 }  // namespace arolla
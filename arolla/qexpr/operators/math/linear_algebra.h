@@ -0,0 +1,63 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QEXPR_OPERATORS_MATH_LINEAR_ALGEBRA_H_
+#define AROLLA_QEXPR_OPERATORS_MATH_LINEAR_ALGEBRA_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators/math/batch_arithmetic.h"
+
+namespace arolla {
+
+// math._matvec(matrix, vector) operator.
+//
+// Multiplies a small dense matrix by a vector. The matrix is stored in
+// row-major order, its number of columns is vector.size() and the number of
+// rows is matrix.size() / vector.size(). Both arguments must be full.
+struct MatVecOp {
+  template <typename T>
+  absl::StatusOr<DenseArray<T>> operator()(EvaluationContext* ctx,
+                                           const DenseArray<T>& matrix,
+                                           const DenseArray<T>& vector) const {
+    static_assert(std::is_floating_point_v<T>);
+    if (!matrix.IsFull() || !vector.IsFull()) {
+      return absl::InvalidArgumentError(
+          "math._matvec operator supports only full arguments");
+    }
+    const int64_t cols = vector.size();
+    if (cols == 0 || matrix.size() % cols != 0) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "matrix size %d is not a multiple of vector size %d", matrix.size(),
+          cols));
+    }
+    const int64_t rows = matrix.size() / cols;
+    typename Buffer<T>::Builder builder(rows, &ctx->buffer_factory());
+    BatchMatVec<T>(builder.GetMutableSpan(), matrix.values.span(),
+                   vector.values.span());
+    return DenseArray<T>{std::move(builder).Build()};
+  }
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_QEXPR_OPERATORS_MATH_LINEAR_ALGEBRA_H_
@@ -0,0 +1,61 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qexpr/operators/math/linear_algebra.h"
+
+#include <optional>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+
+TEST(LinearAlgebraTest, MatVec) {
+  EvaluationContext ctx;
+  // 3x2 matrix in row-major order.
+  auto matrix = CreateDenseArray<float>({1., 2., 3., 4., 5., 6.});
+  auto vector = CreateDenseArray<float>({1., -1.});
+  ASSERT_OK_AND_ASSIGN(auto res, MatVecOp()(&ctx, matrix, vector));
+  EXPECT_THAT(res, ElementsAre(-1.f, -1.f, -1.f));
+
+  ASSERT_OK_AND_ASSIGN(
+      res, MatVecOp()(&ctx, CreateDenseArray<float>({}), vector));
+  EXPECT_THAT(res, ElementsAre());
+}
+
+TEST(LinearAlgebraTest, MatVecErrors) {
+  EvaluationContext ctx;
+  auto matrix = CreateDenseArray<double>({1., 2., 3.});
+  EXPECT_THAT(MatVecOp()(&ctx, matrix, CreateDenseArray<double>({1., 2.})),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "matrix size 3 is not a multiple of vector size 2"));
+  EXPECT_THAT(MatVecOp()(&ctx, matrix, CreateDenseArray<double>({})),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "matrix size 3 is not a multiple of vector size 0"));
+  EXPECT_THAT(MatVecOp()(&ctx, matrix,
+                         CreateDenseArray<double>({1., std::nullopt, 3.})),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "math._matvec operator supports only full arguments"));
+}
+
+}  // namespace
+}  // namespace arolla
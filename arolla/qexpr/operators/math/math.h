@@ -17,9 +17,15 @@
 
 #include <cmath>
 
+#include "arolla/qexpr/operators/math/batch_arithmetic.h"
+
 namespace arolla {
 
+// NOTE: `batch_op` (see DenseArrayLifter) provides a vectorized implementation
+// used for DenseArray arguments.
+
 struct LogOp {
+  using batch_op = BatchLog;
   float operator()(float x) const { return std::log(x); }
   double operator()(double x) const {
     return std::log(x);
@@ -41,6 +47,7 @@ struct Log10Op {
 };
 
 struct Log1pOp {
+  using batch_op = BatchLog1p;
   template <typename T>
   T operator()(T x) const {
     return std::log1p(x);
@@ -55,6 +62,7 @@ struct Symlog1pOp {
 };
 
 struct ExpOp {
+  using batch_op = BatchExp;
   float operator()(float x) const {
     return std::exp(x);
   }
@@ -64,6 +72,7 @@ struct ExpOp {
 };
 
 struct Expm1Op {
+  using batch_op = BatchExpm1;
   template <typename T>
   T operator()(T x) const {
     return std::expm1(x);
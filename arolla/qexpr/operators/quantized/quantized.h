@@ -0,0 +1,227 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QEXPR_OPERATORS_QUANTIZED_QUANTIZED_H_
+#define AROLLA_QEXPR_OPERATORS_QUANTIZED_QUANTIZED_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/edge.h"
+#include "arolla/dense_array/ops/util.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qtype/quantized/quantized_types.h"
+#include "arolla/util/meta.h"
+#include "arolla/util/status.h"
+
+namespace arolla {
+
+// Converts a quantized INT8 / INT16 value to FLOAT32:
+//   (x - zero_point) * scale.
+// Lifted to DenseArray it is the "load quantized, compute as float" step: the
+// arrays stay 1 or 2 bytes per value in memory and are widened batch by batch.
+struct DequantizeOp {
+  using run_on_missing = std::true_type;
+  template <typename Q>
+  float operator()(Q x, float scale, int32_t zero_point) const {
+    return static_cast<float>(int64_t{x} - zero_point) * scale;
+  }
+};
+
+// Quantizes FLOAT32 / FLOAT64 to Q (INT8 or INT16):
+//   round(x / scale) + zero_point,
+// rounding half to even and saturating to the range of Q. NaN is quantized
+// to zero_point.
+template <typename Q>
+struct QuantizeOp {
+  using run_on_missing = std::true_type;
+  template <typename T>
+  Q operator()(T x, float scale, int32_t zero_point) const {
+    double q = std::nearbyint(static_cast<double>(x) / scale) + zero_point;
+    if (std::isnan(q)) {
+      q = zero_point;
+    }
+    constexpr double kMin = std::numeric_limits<Q>::min();
+    constexpr double kMax = std::numeric_limits<Q>::max();
+    return static_cast<Q>(q < kMin ? kMin : (q > kMax ? kMax : q));
+  }
+};
+
+// Returns sum((x[i] - zero_point) * y[i]). The values are widened to double
+// and summed in several independent lanes, which the compiler vectorizes. The
+// accumulation is in double, like on the path over the present pairs in
+// DenseArrayQuantizedDotOp, so both paths round the same way up to the order
+// of the additions.
+template <typename Q>
+double QuantizedDot(absl::Span<const Q> x, absl::Span<const float> y,
+                    int32_t zero_point) {
+  static_assert(std::is_integral_v<Q> && sizeof(Q) <= 2);
+  DCHECK_EQ(x.size(), y.size());
+  constexpr size_t kLanes = 8;
+  const Q* x_data = x.data();
+  const float* y_data = y.data();
+  const size_t size = x.size();
+  const double zp = zero_point;
+  double sums[kLanes] = {};
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    for (size_t j = 0; j < kLanes; ++j) {
+      sums[j] += (static_cast<double>(x_data[i + j]) - zp) *
+                 static_cast<double>(y_data[i + j]);
+    }
+  }
+  double result = 0.0;
+  for (double sum : sums) {
+    result += sum;
+  }
+  for (; i < size; ++i) {
+    result += (static_cast<double>(x_data[i]) - zp) *
+              static_cast<double>(y_data[i]);
+  }
+  return result;
+}
+
+// quantized._dot(x, y, edge, scale, zero_point) operator for DenseArrays.
+//
+// Computes math._dot(quantized.dequantize(x, scale, zero_point), y, edge)
+// without materializing the dequantized array: per group it sums
+// (x - zero_point) * y in double and multiplies the result by scale. It is
+// the linear model / embedding lookup kernel for the weights stored in
+// INT8 / INT16. The result is missing for the groups without present pairs.
+//
+// Full arguments on a SPLIT_POINTS or a scalar edge go through QuantizedDot,
+// the other cases iterate over the present pairs.
+struct DenseArrayQuantizedDotOp {
+  template <typename Q>
+  absl::StatusOr<DenseArray<float>> operator()(
+      EvaluationContext* ctx, const DenseArray<Q>& x,
+      const DenseArray<float>& y, const DenseArrayEdge& edge, float scale,
+      int32_t zero_point) const {
+    if (x.size() != edge.child_size() || y.size() != edge.child_size()) {
+      return SizeMismatchError({edge.child_size(), x.size(), y.size()});
+    }
+    const int64_t parent_size = edge.parent_size();
+    DenseArrayBuilder<float> builder(parent_size, &ctx->buffer_factory());
+    switch (edge.edge_type()) {
+      case DenseArrayEdge::SPLIT_POINTS: {
+        DenseArraySplitPoints splits(edge);
+        const bool full = x.IsFull() && y.IsFull();
+        absl::Span<const Q> x_values = x.values.span();
+        absl::Span<const float> y_values = y.values.span();
+        for (int64_t i = 0; i < parent_size; ++i) {
+          int64_t begin = splits[i];
+          int64_t size = splits[i + 1] - begin;
+          if (full) {
+            if (size > 0) {
+              double dot = QuantizedDot(x_values.subspan(begin, size),
+                                        y_values.subspan(begin, size),
+                                        zero_point);
+              builder.Set(i, static_cast<float>(scale * dot));
+            }
+          } else if (auto sum =
+                         SumPresent(x, y, begin, begin + size, zero_point);
+                     sum.present) {
+            builder.Set(i, static_cast<float>(scale * sum.value));
+          }
+        }
+        break;
+      }
+      case DenseArrayEdge::MAPPING: {
+        std::vector<double> sums(parent_size, 0.0);
+        std::vector<bool> present(parent_size, false);
+        const double zp = zero_point;
+        dense_ops_internal::DenseOpsUtil<
+            meta::type_list<int64_t, Q, float>>::Iterate(
+            [&](int64_t, bool valid, int64_t parent_id, Q x_value,
+                float y_value) {
+              if (valid) {
+                sums[parent_id] += (static_cast<double>(x_value) - zp) *
+                                   static_cast<double>(y_value);
+                present[parent_id] = true;
+              }
+            },
+            0, x.size(), edge.edge_values(), x, y);
+        for (int64_t i = 0; i < parent_size; ++i) {
+          if (present[i]) {
+            builder.Set(i, static_cast<float>(scale * sums[i]));
+          }
+        }
+        break;
+      }
+      default:
+        return absl::InvalidArgumentError("unsupported edge type");
+    }
+    return std::move(builder).Build();
+  }
+
+  template <typename Q>
+  absl::StatusOr<OptionalValue<float>> operator()(
+      EvaluationContext* ctx, const DenseArray<Q>& x,
+      const DenseArray<float>& y, const DenseArrayGroupScalarEdge& edge,
+      float scale, int32_t zero_point) const {
+    if (x.size() != edge.child_size() || y.size() != edge.child_size()) {
+      return SizeMismatchError({edge.child_size(), x.size(), y.size()});
+    }
+    if (x.IsFull() && y.IsFull()) {
+      if (edge.child_size() == 0) {
+        return OptionalValue<float>();
+      }
+      return OptionalValue<float>(static_cast<float>(
+          scale *
+          QuantizedDot(x.values.span(), y.values.span(), zero_point)));
+    }
+    auto sum = SumPresent(x, y, 0, x.size(), zero_point);
+    if (!sum.present) {
+      return OptionalValue<float>();
+    }
+    return OptionalValue<float>(static_cast<float>(scale * sum.value));
+  }
+
+ private:
+  // Returns sum((x[i] - zero_point) * y[i]) over the present pairs in
+  // [begin, end), missing if there are none.
+  template <typename Q>
+  static OptionalValue<double> SumPresent(const DenseArray<Q>& x,
+                                          const DenseArray<float>& y,
+                                          int64_t begin, int64_t end,
+                                          int32_t zero_point) {
+    OptionalValue<double> result;
+    const double zp = zero_point;
+    dense_ops_internal::DenseOpsUtil<meta::type_list<Q, float>>::Iterate(
+        [&](int64_t, bool valid, Q x_value, float y_value) {
+          if (valid) {
+            result.value += (static_cast<double>(x_value) - zp) *
+                            static_cast<double>(y_value);
+            result.present = true;
+          }
+        },
+        begin, end, x, y);
+    return result;
+  }
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_QEXPR_OPERATORS_QUANTIZED_QUANTIZED_H_
@@ -0,0 +1,150 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/edge.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/quantized/quantized_types.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::IsOkAndHolds;
+using ::testing::ElementsAre;
+
+class QuantizedOperatorsTest : public ::testing::Test {
+  void SetUp() final { ASSERT_OK(InitArolla()); }
+};
+
+TEST_F(QuantizedOperatorsTest, Dequantize) {
+  EXPECT_THAT(InvokeOperator<float>("quantized.dequantize", int8_t{5}, 0.5f,
+                                    int32_t{1}),
+              IsOkAndHolds(2.0f));
+  EXPECT_THAT(InvokeOperator<float>("quantized.dequantize", int16_t{-300},
+                                    0.25f, int32_t{0}),
+              IsOkAndHolds(-75.0f));
+  EXPECT_THAT(InvokeOperator<OptionalValue<float>>(
+                  "quantized.dequantize", OptionalValue<int8_t>(), 0.5f,
+                  int32_t{1}),
+              IsOkAndHolds(std::nullopt));
+}
+
+TEST_F(QuantizedOperatorsTest, Quantize) {
+  EXPECT_THAT(InvokeOperator<int8_t>("quantized.quantize_int8", 2.0f, 0.5f,
+                                     int32_t{1}),
+              IsOkAndHolds(int8_t{5}));
+  // Saturation.
+  EXPECT_THAT(InvokeOperator<int8_t>("quantized.quantize_int8", 1000.0f, 1.0f,
+                                     int32_t{0}),
+              IsOkAndHolds(int8_t{127}));
+  EXPECT_THAT(InvokeOperator<int8_t>("quantized.quantize_int8", -1000.0, 1.0f,
+                                     int32_t{0}),
+              IsOkAndHolds(int8_t{-128}));
+  EXPECT_THAT(InvokeOperator<int16_t>("quantized.quantize_int16", 1000.0f,
+                                      1.0f, int32_t{0}),
+              IsOkAndHolds(int16_t{1000}));
+  // Rounding half to even.
+  EXPECT_THAT(InvokeOperator<int8_t>("quantized.quantize_int8", 2.5f, 1.0f,
+                                     int32_t{0}),
+              IsOkAndHolds(int8_t{2}));
+}
+
+TEST_F(QuantizedOperatorsTest, DenseArray) {
+  auto weights = CreateDenseArray<float>({0.5f, std::nullopt, -2.0f, 100.0f});
+  ASSERT_OK_AND_ASSIGN(
+      auto q, InvokeOperator<DenseArray<int8_t>>("quantized.quantize_int8",
+                                                 weights, 0.5f, int32_t{-10}));
+  EXPECT_THAT(q, ElementsAre(-9, std::nullopt, -14, 127));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("quantized.dequantize", q,
+                                                0.5f, int32_t{-10}),
+              IsOkAndHolds(ElementsAre(0.5f, std::nullopt, -2.0f, 68.5f)));
+}
+
+TEST_F(QuantizedOperatorsTest, Dot) {
+  // (x - 1) * 0.5 = [0.5, 1, 1.5, 2, 2.5]
+  auto x = CreateDenseArray<int8_t>(
+      {int8_t{2}, int8_t{3}, int8_t{4}, int8_t{5}, int8_t{6}});
+  auto y = CreateDenseArray<float>({1.0f, 2.0f, 3.0f, 4.0f, 5.0f});
+  ASSERT_OK_AND_ASSIGN(auto splits,
+                       DenseArrayEdge::FromSplitPoints(
+                           CreateDenseArray<int64_t>({0, 2, 2, 5})));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("quantized._dot", x, y, splits,
+                                                0.5f, int32_t{1}),
+              IsOkAndHolds(ElementsAre(2.5f, std::nullopt, 25.0f)));
+  EXPECT_THAT(InvokeOperator<OptionalValue<float>>(
+                  "quantized._dot", x, y, DenseArrayGroupScalarEdge(5), 0.5f,
+                  int32_t{1}),
+              IsOkAndHolds(27.5f));
+
+  // Missing values are skipped.
+  auto sparse_y =
+      CreateDenseArray<float>({1.0f, std::nullopt, 3.0f, 4.0f, std::nullopt});
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("quantized._dot", x, sparse_y,
+                                                splits, 0.5f, int32_t{1}),
+              IsOkAndHolds(ElementsAre(0.5f, std::nullopt, 12.5f)));
+  ASSERT_OK_AND_ASSIGN(auto mapping,
+                       DenseArrayEdge::FromMapping(
+                           CreateDenseArray<int64_t>({1, 0, 1, 0, 1}), 3));
+  EXPECT_THAT(InvokeOperator<DenseArray<float>>("quantized._dot", x, sparse_y,
+                                                mapping, 0.5f, int32_t{1}),
+              IsOkAndHolds(ElementsAre(8.0f, 5.0f, std::nullopt)));
+}
+
+TEST_F(QuantizedOperatorsTest, DotFullAndPartialPathsAgree) {
+  constexpr int64_t kSize = 1001;
+  // `extra` adds a pair with only `x` present, so the arrays are not full,
+  // but the pair is skipped and the dot product is the same.
+  auto make_args = [&](bool extra) {
+    int64_t size = extra ? kSize + 1 : kSize;
+    DenseArrayBuilder<int16_t> x(size);
+    DenseArrayBuilder<float> y(size);
+    for (int64_t i = 0; i < kSize; ++i) {
+      x.Set(i, static_cast<int16_t>(i * 37 % 2001 - 1000));
+      y.Set(i, 0.1f * (i % 17) - 0.7f);
+    }
+    if (extra) {
+      x.Set(kSize, int16_t{1});
+    }
+    return std::make_pair(std::move(x).Build(), std::move(y).Build());
+  };
+  auto [full_x, full_y] = make_args(/*extra=*/false);
+  auto [partial_x, partial_y] = make_args(/*extra=*/true);
+  ASSERT_TRUE(full_y.IsFull());
+  ASSERT_FALSE(partial_y.IsFull());
+
+  ASSERT_OK_AND_ASSIGN(
+      auto full, InvokeOperator<OptionalValue<float>>(
+                     "quantized._dot", full_x, full_y,
+                     DenseArrayGroupScalarEdge(kSize), 0.01f, int32_t{3}));
+  ASSERT_OK_AND_ASSIGN(
+      auto partial,
+      InvokeOperator<OptionalValue<float>>(
+          "quantized._dot", partial_x, partial_y,
+          DenseArrayGroupScalarEdge(kSize + 1), 0.01f, int32_t{3}));
+  ASSERT_TRUE(full.present && partial.present);
+  EXPECT_FLOAT_EQ(full.value, partial.value);
+}
+
+}  // namespace
+}  // namespace arolla
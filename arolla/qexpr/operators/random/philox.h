@@ -0,0 +1,100 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QEXPR_OPERATORS_RANDOM_PHILOX_H_
+#define AROLLA_QEXPR_OPERATORS_RANDOM_PHILOX_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/numeric/int128.h"
+#include "absl/types/span.h"
+
+namespace arolla {
+
+// Philox4x32-10 counter-based random number generator from
+// J. K. Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3" (SC'11).
+//
+// Unlike the stateful engines from <random>, the i-th value of a stream is a
+// pure function of (seed, i), so a range of values can be generated
+// independently from the others, e.g. in a different thread, and the loops
+// have no dependency between iterations.
+using PhiloxCounter = std::array<uint32_t, 4>;
+using PhiloxKey = std::array<uint32_t, 2>;
+
+inline PhiloxCounter Philox4x32(PhiloxCounter counter, PhiloxKey key) {
+  constexpr uint32_t kMultiplier0 = 0xD2511F53;
+  constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+  constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  constexpr uint32_t kWeyl1 = 0xBB67AE85;
+  for (int round = 0; round < 10; ++round) {
+    const uint64_t product0 = uint64_t{kMultiplier0} * counter[0];
+    const uint64_t product1 = uint64_t{kMultiplier1} * counter[2];
+    counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+               static_cast<uint32_t>(product1),
+               static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+               static_cast<uint32_t>(product0)};
+    key[0] += kWeyl0;
+    key[1] += kWeyl1;
+  }
+  return counter;
+}
+
+// Writes the values [offset, offset + result.size()) of the 64-bit random
+// stream identified by `seed` into `result`.
+inline void PhiloxFillUint64(uint64_t seed, uint64_t offset,
+                             absl::Span<uint64_t> result) {
+  const PhiloxKey key = {static_cast<uint32_t>(seed),
+                         static_cast<uint32_t>(seed >> 32)};
+  // Each Philox block provides two 64-bit values.
+  auto block = [&key](uint64_t block_id) {
+    return Philox4x32({static_cast<uint32_t>(block_id),
+                       static_cast<uint32_t>(block_id >> 32), 0, 0},
+                      key);
+  };
+  size_t i = 0;
+  if (offset % 2 == 1 && !result.empty()) {
+    const auto r = block(offset / 2);
+    result[i++] = (uint64_t{r[3]} << 32) | r[2];
+  }
+  const uint64_t first_block = (offset + i) / 2;
+  for (; i + 1 < result.size(); i += 2) {
+    const auto r = block(first_block + i / 2);
+    result[i] = (uint64_t{r[1]} << 32) | r[0];
+    result[i + 1] = (uint64_t{r[3]} << 32) | r[2];
+  }
+  if (i < result.size()) {
+    const auto r = block(first_block + i / 2);
+    result[i] = (uint64_t{r[1]} << 32) | r[0];
+  }
+}
+
+// Maps a uniformly distributed 64-bit value to [low, high] using
+// multiply-shift. The bias is at most (high - low + 1) / 2^64.
+inline int64_t UniformIntFromUint64(uint64_t value, int64_t low,
+                                    int64_t high) {
+  // The range size modulo 2^64; zero means the full int64 range.
+  const uint64_t range =
+      static_cast<uint64_t>(high) - static_cast<uint64_t>(low) + 1;
+  if (range == 0) {
+    return static_cast<int64_t>(value);
+  }
+  const uint64_t scaled = absl::Uint128High64(absl::uint128(value) * range);
+  return static_cast<int64_t>(static_cast<uint64_t>(low) + scaled);
+}
+
+}  // namespace arolla
+
+#endif  // AROLLA_QEXPR_OPERATORS_RANDOM_PHILOX_H_
@@ -16,14 +16,14 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <iterator>
 #include <string>
-#include <vector>
+#include <utility>
 
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/util/bytes.h"
+#include "arolla/util/string.h"
 #include "arolla/util/text.h"
 
 namespace arolla {
@@ -55,35 +55,15 @@ bool AdjustIndexes(int64_t ssize, OptionalValue<int64_t>& start,
   return start.value <= end.value;
 }
 
-// Returns number of bytes in a UTF-8 encoded codepoint at `src`.
-inline int32_t UTF8CharLen(const char* src) {
-  return "\1\1\1\1\1\1\1\1\1\1\1\1\2\2\3\4"[(*src & 0xFF) >> 4];
-}
-
-// Returns a vector of byte offsets corresponding to the sequence of codepoints
-// in the UTF8 string `str`. The length of the returned vector is equal to the
-// number of complete codepoints in `str` plus 1, with the i'th value containing
-// the offset of the i'th codepoint, plus one extra value containing str.size().
-std::vector<int32_t> UTF8StringIndex(absl::string_view str) {
-  std::vector<int32_t> index;
-  // At most one codepoint per byte; could be fewer, but value is short-lived,
-  // so it doesn't matter.
-  index.reserve(str.length() + 1);
-  const char* data = str.data();
-  int32_t offset = 0;
-  while (offset < str.size()) {
-    index.push_back(offset);
-    offset += UTF8CharLen(data + offset);
-  }
-  if (offset > str.size()) {
-    // UTF8 string is invalid; final code-point is incomplete.
-    index.pop_back();
-  }
-
-  // Having an extra value at the end is useful for converting offsets
-  // corresponding to the end of the string.
-  index.push_back(str.length());
-  return index;
+// Converts the codepoint range [start, end) of the UTF-8 string `str` to the
+// byte offsets. The codepoints are counted in blocks (see
+// Utf8CodePointOffset), without building an index of all of them.
+std::pair<int64_t, int64_t> Utf8ByteRange(absl::string_view str, int64_t start,
+                                          int64_t end) {
+  int64_t byte_start = Utf8CodePointOffset(str, start);
+  int64_t byte_end =
+      byte_start + Utf8CodePointOffset(str.substr(byte_start), end - start);
+  return {byte_start, byte_end};
 }
 
 }  // namespace
@@ -135,15 +115,23 @@ OptionalValue<int64_t> FindSubstringOp::operator()(
 OptionalValue<int64_t> FindSubstringOp::operator()(
     const Text& str, const Text& substr, OptionalValue<int64_t> start,
     OptionalValue<int64_t> end) const {
-  auto index = UTF8StringIndex(absl::string_view(str));
-  if (AdjustIndexes(index.size() - 1, start, end)) {
+  // Codepoint offsets of an ascii string are equal to the byte offsets, so we
+  // don't need to build the index.
+  if (IsAscii(str)) {
+    if (AdjustIndexes(str.view().size(), start, end)) {
+      return FindSubstring(str, substr, start.value, end.value);
+    }
+    return {};
+  }
+  if (AdjustIndexes(Utf8CodePointCount(str), start, end)) {
+    auto [byte_start, byte_end] = Utf8ByteRange(str, start.value, end.value);
     auto byte_offset =
         FindSubstring(absl::string_view(str), absl::string_view(substr),
-                      index[start.value], index[end.value]);
+                      byte_start, byte_end);
     if (byte_offset.present) {
-      return std::distance(
-          index.begin(),
-          std::lower_bound(index.begin(), index.end(), byte_offset.value));
+      return start.value +
+             Utf8CodePointCount(absl::string_view(str).substr(
+                 byte_start, byte_offset.value - byte_start));
     }
   }
   return {};
@@ -177,15 +165,21 @@ OptionalValue<int64_t> FindLastSubstringOp::operator()(
 OptionalValue<int64_t> FindLastSubstringOp::operator()(
     const Text& str, const Text& substr, OptionalValue<int64_t> start,
     OptionalValue<int64_t> end) const {
-  auto index = UTF8StringIndex(absl::string_view(str));
-  if (AdjustIndexes(index.size() - 1, start, end)) {
+  if (IsAscii(str)) {
+    if (AdjustIndexes(str.view().size(), start, end)) {
+      return FindLastSubstring(str, substr, start.value, end.value);
+    }
+    return {};
+  }
+  if (AdjustIndexes(Utf8CodePointCount(str), start, end)) {
+    auto [byte_start, byte_end] = Utf8ByteRange(str, start.value, end.value);
     auto byte_offset =
         FindLastSubstring(absl::string_view(str), absl::string_view(substr),
-                          index[start.value], index[end.value]);
+                          byte_start, byte_end);
     if (byte_offset.present) {
-      return std::distance(
-          index.begin(),
-          std::lower_bound(index.begin(), index.end(), byte_offset.value));
+      return start.value +
+             Utf8CodePointCount(absl::string_view(str).substr(
+                 byte_start, byte_offset.value - byte_start));
     }
   }
   return {};
@@ -217,11 +211,13 @@ Bytes SubstringOp::operator()(const Bytes& str, OptionalValue<int64_t> start,
 
 Text SubstringOp::operator()(const Text& str, OptionalValue<int64_t> start,
                              OptionalValue<int64_t> end) const {
-  auto index = UTF8StringIndex(absl::string_view(str));
+  if (IsAscii(str)) {
+    return Text((*this)(absl::string_view(str), start, end));
+  }
   std::string substr;
-  if (AdjustIndexes(index.size() - 1, start, end)) {
-    substr =
-        Substring(absl::string_view(str), index[start.value], index[end.value]);
+  if (AdjustIndexes(Utf8CodePointCount(str), start, end)) {
+    auto [byte_start, byte_end] = Utf8ByteRange(str, start.value, end.value);
+    substr = Substring(absl::string_view(str), byte_start, byte_end);
   }
   return Text(substr);
 }
@@ -16,13 +16,13 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -58,16 +58,21 @@ using Slot = FrameLayout::Slot<T>;
 // Currently only required for Bytes (which is converted to string_view).
 class ValueHolder {
  public:
+  // `capacity` is the maximum number of values to be added.
+  explicit ValueHolder(size_t capacity) { values_.reserve(capacity); }
+
   // Adds a value to this object, and returns a reference to it. The reference
   // will remain valid for the lifetime of this object.
   const absl::string_view& AddValue(absl::string_view value) {
+    // Exceeding the reserved capacity would move the values.
+    DCHECK_LT(values_.size(), values_.capacity());
     return values_.emplace_back(value);
   }
 
  private:
-  // Important to use a container type for which appending doesn't move values,
-  // ie. not std::vector.
-  std::deque<absl::string_view> values_;
+  // Usually fits into the inline storage, so there are no heap allocations
+  // per evaluation.
+  absl::InlinedVector<absl::string_view, 8> values_;
 };
 
 // Wrap a typed ref of a particular type. The default implementation returns
@@ -149,8 +154,9 @@ class FormatBoundOperator : public BoundOperator {
   void Run(EvaluationContext* ctx, FramePtr frame) const override {
     absl::string_view fmt_spec = frame.Get(format_spec_slot_);
     absl::UntypedFormatSpec fmt(fmt_spec);
-    ValueHolder value_holder;
-    std::vector<absl::FormatArg> fmt_args;
+    // Each formatter adds at most one value.
+    ValueHolder value_holder(slot_formatters_.size());
+    absl::InlinedVector<absl::FormatArg, 8> fmt_args;
     fmt_args.reserve(slot_formatters_.size());
     for (const auto& slot_formatter : slot_formatters_) {
       fmt_args.push_back(slot_formatter.Format(frame, &value_holder));
@@ -14,18 +14,29 @@
 //
 #include "arolla/qexpr/operators/strings/join.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/inlined_vector.h"
+#include "absl/log/check.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "arolla/dense_array/bitmap.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/memory/simple_buffer.h"
 #include "arolla/qexpr/bound_operators.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/operator_errors.h"
@@ -36,6 +47,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/util/bytes.h"
+#include "arolla/util/status.h"
 #include "arolla/util/text.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -126,6 +138,122 @@ class JoinOperator : public QExprOperator {
   }
 };
 
+// BoundOperator implementation for join of dense array parts. The first pass
+// computes the exact size of the result characters, and the second one writes
+// them into a single preallocated buffer, so there are no per-row
+// allocations.
+template <class StringType>
+class JoinDenseArrayBoundOperator : public BoundOperator {
+ public:
+  JoinDenseArrayBoundOperator(
+      Slot<StringType> delimiter_slot,
+      std::vector<Slot<DenseArray<StringType>>> part_slots,
+      Slot<DenseArray<StringType>> output_slot)
+      : delimiter_slot_(delimiter_slot),
+        part_slots_(std::move(part_slots)),
+        output_slot_(output_slot) {}
+
+  void Run(EvaluationContext* ctx, FramePtr frame) const override {
+    absl::string_view delimiter = frame.Get(delimiter_slot_);
+    absl::InlinedVector<const DenseArray<StringType>*, 10> parts;
+    parts.reserve(part_slots_.size());
+    for (auto& s : part_slots_) {
+      parts.push_back(&frame.Get(s));
+    }
+    const int64_t size = parts[0]->size();
+    for (const auto* part : parts) {
+      if (part->size() != size) {
+        ctx->set_status(SizeMismatchError({size, part->size()}));
+        return;
+      }
+    }
+    RawBufferFactory& factory = ctx->buffer_factory();
+
+    // The result is present iff all the parts are present.
+    bitmap::AlmostFullBuilder presence_bldr(size, &factory);
+    for (const auto* part : parts) {
+      if (part->bitmap.empty()) continue;
+      for (int64_t i = 0; i < size; ++i) {
+        if (!part->present(i)) {
+          presence_bldr.AddMissed(i);
+        }
+      }
+    }
+    bitmap::Bitmap presence = std::move(presence_bldr).Build();
+
+    int64_t num_chars = 0;
+    int64_t present_count = size;
+    if (!presence.empty()) {
+      present_count = bitmap::CountBits(presence, 0, size);
+    }
+    num_chars += present_count * static_cast<int64_t>(delimiter.size()) *
+                 static_cast<int64_t>(parts.size() - 1);
+    for (const auto* part : parts) {
+      for (int64_t i = 0; i < size; ++i) {
+        if (bitmap::GetBit(presence, i)) {
+          num_chars += part->values[i].size();
+        }
+      }
+    }
+
+    SimpleBuffer<StringsBuffer::Offsets>::Builder offsets_bldr(size, &factory);
+    SimpleBuffer<char>::Builder characters_bldr(num_chars, &factory);
+    auto offsets = offsets_bldr.GetMutableSpan();
+    char* begin = characters_bldr.GetMutableSpan().data();
+    char* out = begin;
+    for (int64_t i = 0; i < size; ++i) {
+      offsets[i].start = out - begin;
+      if (bitmap::GetBit(presence, i)) {
+        for (size_t j = 0; j < parts.size(); ++j) {
+          if (j > 0) {
+            out = std::copy(delimiter.begin(), delimiter.end(), out);
+          }
+          absl::string_view v = parts[j]->values[i];
+          out = std::copy(v.begin(), v.end(), out);
+        }
+      }
+      offsets[i].end = out - begin;
+    }
+    DCHECK_EQ(out - begin, num_chars);
+    frame.Set(output_slot_,
+              DenseArray<StringType>{
+                  Buffer<StringType>(std::move(offsets_bldr).Build(),
+                                     std::move(characters_bldr).Build()),
+                  std::move(presence)});
+  }
+
+ private:
+  Slot<StringType> delimiter_slot_;
+  std::vector<Slot<DenseArray<StringType>>> part_slots_;
+  Slot<DenseArray<StringType>> output_slot_;
+};
+
+// Operator implementation for join of dense array parts.
+template <class StringType>
+class JoinDenseArrayOperator : public QExprOperator {
+ public:
+  explicit JoinDenseArrayOperator(const QExprOperatorSignature* type)
+      : QExprOperator(std::string(kJoinOperatorName), type) {}
+
+ private:
+  absl::StatusOr<std::unique_ptr<BoundOperator>> DoBind(
+      absl::Span<const TypedSlot> typed_input_slots,
+      TypedSlot typed_output_slot) const final {
+    ASSIGN_OR_RETURN(Slot<StringType> delimiter_slot,
+                     typed_input_slots[0].ToSlot<StringType>());
+    std::vector<Slot<DenseArray<StringType>>> part_slots;
+    part_slots.reserve(typed_input_slots.size() - 1);
+    for (const auto& s : typed_input_slots.subspan(1)) {
+      ASSIGN_OR_RETURN(auto part_slot, s.ToSlot<DenseArray<StringType>>());
+      part_slots.push_back(part_slot);
+    }
+    ASSIGN_OR_RETURN(Slot<DenseArray<StringType>> output_slot,
+                     typed_output_slot.ToSlot<DenseArray<StringType>>());
+    return {std::make_unique<JoinDenseArrayBoundOperator<StringType>>(
+        delimiter_slot, std::move(part_slots), output_slot)};
+  }
+};
+
 }  // unnamed namespace
 
 template <class StringType>
@@ -135,6 +263,10 @@ absl::StatusOr<OperatorPtr> GetJoinOperator(
       std::any_of(input_types.begin(), input_types.end(),
                   [](QTypePtr qtype) { return IsOptionalQType(qtype); });
   const QTypePtr part_type = DecayOptionalQType(input_types[1]);
+  if (part_type == GetDenseArrayQType<StringType>()) {
+    return OperatorPtr(std::make_unique<JoinDenseArrayOperator<StringType>>(
+        QExprOperatorSignature::Get(input_types, part_type)));
+  }
   QTypePtr output_type = part_type;
   if (has_optional) {
     ASSIGN_OR_RETURN(output_type, ToOptionalQType(output_type));
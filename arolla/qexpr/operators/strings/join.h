@@ -59,6 +59,9 @@ class JoinOperatorFamily : public OperatorFamily {
   //
   // The result type will be either the same as the delimiter type, or
   // optional wrapped with delimiter type.
+  //
+  // Alternatively, all the joined parts can be dense arrays of the delimiter
+  // type; then the result is a dense array, missing where any part is missing.
   absl::StatusOr<OperatorPtr> DoGetOperator(
       absl::Span<const QTypePtr> input_types, QTypePtr output_type) const final;
 };
@@ -14,6 +14,7 @@
 //
 #include "arolla/qexpr/operators/strings/join.h"
 
+#include <optional>
 #include <tuple>
 #include <type_traits>
 
@@ -21,13 +22,17 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/operators.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/util/bytes.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/text.h"
+#include "arolla/util/status_macros_backport.h"
 
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 
 namespace arolla {
@@ -149,5 +154,30 @@ INSTANTIATE_TYPED_TEST_SUITE_P(BytesFunctor, JoinStringsTest, BytesEvalFunctor);
 using TextEvalFunctor = std::tuple<Bytes, std::bool_constant<true>>;
 INSTANTIATE_TYPED_TEST_SUITE_P(TextFunctor, JoinStringsTest, TextEvalFunctor);
 
+TEST(JoinStringsTest, JoinDenseArrays) {
+  auto first = CreateDenseArray<Text>(
+      {Text("a"), std::nullopt, Text("ccc"), Text("")});
+  auto second =
+      CreateDenseArray<Text>({Text("x"), Text("y"), Text("z"), Text("")});
+  ASSERT_OK_AND_ASSIGN(auto result,
+                       InvokeOperator<DenseArray<Text>>(
+                           "strings._join_with_separator", Text("--"), first,
+                           second, first));
+  EXPECT_THAT(result, ElementsAre(Text("a--x--a"), std::nullopt,
+                                  Text("ccc--z--ccc"), Text("----")));
+  // All the rows are written into a single exactly sized buffer.
+  EXPECT_EQ(result.values.characters().size(), 7 + 11 + 4);
+
+  EXPECT_THAT(InvokeOperator<DenseArray<Text>>(
+                  "strings._join_with_separator", Text("--"), first,
+                  CreateDenseArray<Text>({Text("x")})),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("argument sizes mismatch")));
+  EXPECT_THAT(InvokeOperator<DenseArray<Bytes>>(
+                  "strings._join_with_separator", Text("--"),
+                  CreateDenseArray<Bytes>({Bytes("x")})),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
 }  // namespace
 }  // namespace arolla
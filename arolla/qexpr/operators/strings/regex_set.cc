@@ -0,0 +1,92 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qexpr/operators/strings/regex_set.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/memory/frame.h"
+#include "arolla/qexpr/bound_operators.h"
+#include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operator_errors.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qexpr/qexpr_operator_signature.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/strings/regex.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/text.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+namespace {
+
+constexpr absl::string_view kCompileRegexSetOperatorName =
+    "strings._compile_regex_set";
+
+class CompileRegexSetOperator final : public QExprOperator {
+ public:
+  explicit CompileRegexSetOperator(const QExprOperatorSignature* signature)
+      : QExprOperator(std::string(kCompileRegexSetOperatorName), signature) {}
+
+ private:
+  absl::StatusOr<std::unique_ptr<BoundOperator>> DoBind(
+      absl::Span<const TypedSlot> input_slots,
+      TypedSlot output_slot) const final {
+    std::vector<FrameLayout::Slot<Text>> pattern_slots;
+    pattern_slots.reserve(input_slots.size());
+    for (const auto& input_slot : input_slots) {
+      ASSIGN_OR_RETURN(auto pattern_slot, input_slot.ToSlot<Text>());
+      pattern_slots.push_back(pattern_slot);
+    }
+    ASSIGN_OR_RETURN(auto result_slot, output_slot.ToSlot<RegexSet>());
+    return MakeBoundOperator(
+        [pattern_slots = std::move(pattern_slots), result_slot](
+            EvaluationContext* ctx, FramePtr frame) {
+          absl::InlinedVector<absl::string_view, 16> patterns;
+          patterns.reserve(pattern_slots.size());
+          for (const auto& pattern_slot : pattern_slots) {
+            patterns.push_back(frame.Get(pattern_slot));
+          }
+          ASSIGN_OR_RETURN(auto regex_set, RegexSet::FromPatterns(patterns),
+                           ctx->set_status(std::move(_)));
+          frame.Set(result_slot, std::move(regex_set));
+        });
+  }
+};
+
+}  // namespace
+
+absl::StatusOr<OperatorPtr> CompileRegexSetOperatorFamily::DoGetOperator(
+    absl::Span<const QTypePtr> input_types, QTypePtr output_type) const {
+  for (const QTypePtr input_type : input_types) {
+    if (input_type != GetQType<Text>()) {
+      return OperatorNotDefinedError(kCompileRegexSetOperatorName, input_types,
+                                     "expected all arguments to be TEXT");
+    }
+  }
+  return EnsureOutputQTypeMatches(
+      OperatorPtr(std::make_shared<CompileRegexSetOperator>(
+          QExprOperatorSignature::Get(input_types, GetQType<RegexSet>()))),
+      input_types, output_type);
+}
+
+}  // namespace arolla
@@ -0,0 +1,35 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QEXPR_OPERATORS_STRINGS_REGEX_SET_H_
+#define AROLLA_QEXPR_OPERATORS_STRINGS_REGEX_SET_H_
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/qtype.h"
+
+namespace arolla {
+
+// strings._compile_regex_set(*patterns) operator family. Compiles TEXT
+// `patterns` into a REGEX_SET. Returns an error if any of the patterns is
+// not a valid regular expression.
+class CompileRegexSetOperatorFamily final : public OperatorFamily {
+  absl::StatusOr<OperatorPtr> DoGetOperator(
+      absl::Span<const QTypePtr> input_types, QTypePtr output_type) const final;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_QEXPR_OPERATORS_STRINGS_REGEX_SET_H_
@@ -15,6 +15,7 @@
 #ifndef AROLLA_QEXPR_OPERATORS_STRINGS_SPLIT_H_
 #define AROLLA_QEXPR_OPERATORS_STRINGS_SPLIT_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <tuple>
 #include <utility>
@@ -31,6 +32,7 @@
 #include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/qtype/types.h"  // IWYU pragma: keep
 #include "arolla/memory/buffer.h"
+#include "arolla/memory/strings_buffer.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qtype/base_types.h"  // IWYU pragma: keep
 #include "arolla/util/status_macros_backport.h"
@@ -45,14 +47,13 @@ struct ArrayTraits {};
 template <>
 struct ArrayTraits<DenseArray> {
   template <typename T>
-  static DenseArray<T> CreateFromVector(
-      const std::vector<OptionalValue<T>>& v) {
-    return CreateDenseArray(absl::Span<const OptionalValue<T>>(v));
+  static DenseArray<T> CreateFromBuffer(const Buffer<T>& buffer) {
+    return {buffer};
   }
 
   template <typename T>
-  static DenseArray<T> CreateFromBuffer(const Buffer<T>& buffer) {
-    return {buffer};
+  static const Buffer<T>& ValuesBuffer(const DenseArray<T>& array) {
+    return array.values;
   }
 
   using edge_type = DenseArrayEdge;
@@ -61,22 +62,47 @@ struct ArrayTraits<DenseArray> {
 template <>
 struct ArrayTraits<Array> {
   template <typename T>
-  static Array<T> CreateFromVector(const std::vector<OptionalValue<T>>& v) {
-    return CreateArray(absl::Span<const OptionalValue<T>>(v));
+  static Array<T> CreateFromBuffer(const Buffer<T>& buffer) {
+    return Array<T>(buffer);
   }
 
   template <typename T>
-  static Array<T> CreateFromBuffer(const Buffer<T>& buffer) {
-    return Array<T>(buffer);
+  static const Buffer<T>& ValuesBuffer(const Array<T>& array) {
+    return array.dense_data().values;
   }
 
   using edge_type = ArrayEdge;
 };
 
+// Creates a buffer with the given substrings of the `source` strings. Shares
+// the characters of `source` if possible.
+template <typename StringType>
+Buffer<StringType> BuildSplitsBuffer(
+    const Buffer<StringType>& source,
+    absl::Span<const absl::string_view> splits) {
+  StringsBuffer::SubstringsBuilder substrings_bldr(splits.size(), source);
+  if (std::all_of(splits.begin(), splits.end(), [&](absl::string_view v) {
+        return substrings_bldr.Contains(v);
+      })) {
+    for (int64_t i = 0; i < splits.size(); ++i) {
+      substrings_bldr.Set(i, splits[i]);
+    }
+    return std::move(substrings_bldr).Build();
+  }
+  // Some of the splits come from a value outside of `source` (e.g.
+  // Array::missing_id_value), so we have to copy the characters.
+  StringsBuffer::Builder bldr(splits.size());
+  for (int64_t i = 0; i < splits.size(); ++i) {
+    bldr.Set(i, splits[i]);
+  }
+  return std::move(bldr).Build();
+}
+
 }  // namespace split_operators_impl
+
 // strings.split splits the string with the given separator, and returns the
 // array of split substrings and the edge that maps it to the original array in
-// a tuple.
+// a tuple. The substrings share the characters buffer of the input array.
 struct SplitOp {
   template <template <typename T> class ArrayType, typename StringType>
   absl::StatusOr<std::tuple<
@@ -86,7 +112,7 @@ struct SplitOp {
              const OptionalValue<StringType>& separator) const {
     std::vector<int64_t> splits_per_string{0};
     splits_per_string.reserve(array.size());
-    std::vector<OptionalValue<StringType>> splits;
+    std::vector<absl::string_view> splits;
     splits.reserve(array.size());
     array.ForEach([&](int64_t id, bool present, absl::string_view value) {
       if (!present) {
@@ -102,9 +128,7 @@ struct SplitOp {
         }
         splits_per_string.push_back(splits_per_string.back() +
                                     new_splits.size());
-        for (auto it = new_splits.begin(); it != new_splits.end(); ++it) {
-          splits.emplace_back(*it);
-        }
+        splits.insert(splits.end(), new_splits.begin(), new_splits.end());
       }
     });
     ASSIGN_OR_RETURN(
@@ -114,9 +138,11 @@ struct SplitOp {
                 split_operators_impl::ArrayTraits<ArrayType>::
                     template CreateFromBuffer<int64_t>(Buffer<int64_t>::Create(
                         std::move(splits_per_string)))));
+    using Traits = split_operators_impl::ArrayTraits<ArrayType>;
     return std::make_tuple(
-        split_operators_impl::ArrayTraits<ArrayType>::template CreateFromVector<
-            StringType>(splits),
+        Traits::template CreateFromBuffer<StringType>(
+            split_operators_impl::BuildSplitsBuffer<StringType>(
+                Traits::ValuesBuffer(array), splits)),
         edge);
   }
 };
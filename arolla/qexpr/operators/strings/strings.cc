@@ -19,25 +19,29 @@
 #include <limits>
 #include <optional>
 #include <string>
+#include <utility>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "icu4c/source/common/unicode/bytestream.h"
 #include "icu4c/source/common/unicode/casemap.h"
 #include "icu4c/source/common/unicode/errorcode.h"
 #include "icu4c/source/common/unicode/stringoptions.h"
-#include "icu4c/source/common/unicode/umachine.h"
-#include "icu4c/source/common/unicode/utf8.h"
 #include "double-conversion/double-to-string.h"
 #include "double-conversion/utils.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qtype/strings/regex.h"
 #include "arolla/util/bytes.h"
 #include "arolla/util/indestructible.h"
+#include "arolla/util/lru_cache.h"
+#include "arolla/util/string.h"
 #include "arolla/util/text.h"
 #include "arolla/util/unit.h"
 #include "re2/re2.h"
@@ -47,18 +51,10 @@ namespace arolla {
 namespace {
 
 absl::Status ValidateUtf8(absl::string_view bytes) {
-  if (bytes.size() > size_t{std::numeric_limits<int32_t>::max()}) {
-    return absl::UnimplementedError("string is too long to convert to UTF-8");
-  }
-  int32_t offset = 0;
-  while (offset < bytes.size()) {
-    UChar32 character;
-    int32_t previous_offset = offset;
-    U8_NEXT(bytes.data(), offset, bytes.size(), character);
-    if (character < 0) {
-      return absl::InvalidArgumentError(absl::StrFormat(
-          "invalid UTF-8 sequence at position %d", previous_offset));
-    }
+  if (size_t valid_size = Utf8ValidPrefixSize(bytes);
+      valid_size != bytes.size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "invalid UTF-8 sequence at position %d", valid_size));
   }
   return absl::OkStatus();
 }
@@ -67,6 +63,11 @@ absl::Status ValidateUtf8(absl::string_view bytes) {
 
 absl::StatusOr<Text> LowerOp::operator()(
     absl::string_view in, std::optional<absl::string_view> locale) const {
+  // Locale-independent case mapping of ascii strings is a byte-wise table
+  // lookup, so we skip ICU for them.
+  if (!locale.has_value() && IsAscii(in)) {
+    return Text(absl::AsciiStrToLower(in));
+  }
   std::string result;
   icu::StringByteSink<std::string> sink(&result);
   icu::ErrorCode error_code;
@@ -84,6 +85,9 @@ absl::StatusOr<Text> LowerOp::operator()(
 
 absl::StatusOr<Text> UpperOp::operator()(
     absl::string_view in, std::optional<absl::string_view> locale) const {
+  if (!locale.has_value() && IsAscii(in)) {
+    return Text(absl::AsciiStrToUpper(in));
+  }
   std::string result;
   icu::StringByteSink<std::string> sink(&result);
   icu::ErrorCode error_code;
@@ -134,6 +138,24 @@ absl::StatusOr<std::string> ReplaceOp::operator()(
   return res;
 }
 
+absl::StatusOr<Regex> CompileRegexOp::operator()(const Text& pattern) const {
+  static constexpr size_t kCacheCapacity = 1024;
+  struct RegexCache {
+    absl::Mutex mutex;
+    LruCache<std::string, Regex> cache ABSL_GUARDED_BY(mutex){kCacheCapacity};
+  };
+  static Indestructible<RegexCache> regex_cache;
+  {
+    absl::MutexLock lock(&regex_cache->mutex);
+    if (const auto* regex = regex_cache->cache.LookupOrNull(pattern.view())) {
+      return *regex;
+    }
+  }
+  ASSIGN_OR_RETURN(auto regex, Regex::FromPattern(pattern));
+  absl::MutexLock lock(&regex_cache->mutex);
+  return *regex_cache->cache.Put(std::string(pattern.view()), std::move(regex));
+}
+
 OptionalUnit ContainsRegexOp::operator()(const Text& text,
                                          const Regex& regexp) const {
   return OptionalUnit{
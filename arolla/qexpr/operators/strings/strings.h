@@ -15,14 +15,19 @@
 #ifndef AROLLA_QEXPR_OPERATORS_STRINGS_STRINGS_H_
 #define AROLLA_QEXPR_OPERATORS_STRINGS_STRINGS_H_
 
+#include <algorithm>
+#include <bit>
 #include <bitset>
 #include <cctype>
 #include <charconv>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <optional>
 #include <string>
 #include <system_error>  // NOLINT(build/c++11): needed for absl::from_chars.
+#include <type_traits>
 #include <utility>
 
 #include "absl/container/flat_hash_set.h"
@@ -33,7 +38,6 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "icu4c/source/common/unicode/uchar.h"
-#include "icu4c/source/common/unicode/unistr.h"
 #include "icu4c/source/common/unicode/utf16.h"
 #include "icu4c/source/common/unicode/utf8.h"
 #include "icu4c/source/common/unicode/utypes.h"
@@ -41,6 +45,7 @@
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/strings/regex.h"
 #include "arolla/util/bytes.h"
+#include "arolla/util/string.h"
 #include "arolla/util/text.h"
 #include "arolla/util/unit.h"
 #include "arolla/util/status_macros_backport.h"
@@ -112,27 +117,16 @@ struct ReplaceOp {
 struct LStripOp {
   Bytes operator()(const Bytes& bytes,
                    const OptionalValue<Bytes>& chars) const {
-    auto do_lstrip = [](absl::string_view s, auto strip_test) {
-      const char* b = s.data();
-      const char* e = s.data() + s.length() - 1;
-      while (b <= e && strip_test(*b)) {
-        ++b;
-      }
-      return absl::string_view(b, e - b + 1);
-    };
-    if (chars.present) {
-      std::bitset<256> char_set(256);
-      for (char c : absl::string_view(chars.value)) {
-        char_set.set(static_cast<int>(c));
-      }
-      return Bytes(do_lstrip(bytes, [&](char c) { return char_set.test(c); }));
-    } else {
-      return Bytes(
-          do_lstrip(bytes, [&](char c) { return absl::ascii_isspace(c); }));
-    }
+    return Bytes(StripBytes(bytes, chars));
   }
 
   Text operator()(const Text& text, const OptionalValue<Text>& chars) const {
+    // Every byte of an ascii string is a separate codepoint, so we can use
+    // the byte-wise implementation (ascii whitespaces coincide with the
+    // unicode ones in the ascii range).
+    if (IsAscii(text) && (!chars.present || IsAscii(chars.value))) {
+      return Text(StripBytes(text, chars));
+    }
     auto do_lstrip = [](absl::string_view s, auto strip_test) {
       int pref = 0;
       for (int i = 0; i < s.length();) {
@@ -160,34 +154,46 @@ struct LStripOp {
     }
     return Text(do_lstrip(text, [&](UChar32 c) { return set.contains(c); }));
   }
-};
 
-// strings.rstrip eliminates trailing whitespaces,
-// or trailing specified characters.
-struct RStripOp {
-  Bytes operator()(const Bytes& bytes,
-                   const OptionalValue<Bytes>& chars) const {
-    auto do_rstrip = [](absl::string_view s, auto strip_test) {
+ private:
+  template <typename StringT>
+  static absl::string_view StripBytes(absl::string_view s,
+                                      const OptionalValue<StringT>& chars) {
+    auto do_lstrip = [](absl::string_view s, auto strip_test) {
       const char* b = s.data();
       const char* e = s.data() + s.length() - 1;
-      while (b <= e && strip_test(*e)) {
-        --e;
+      while (b <= e && strip_test(*b)) {
+        ++b;
       }
       return absl::string_view(b, e - b + 1);
     };
     if (chars.present) {
-      std::bitset<256> char_set(256);
+      std::bitset<256> char_set;
       for (char c : absl::string_view(chars.value)) {
-        char_set.set(static_cast<int>(c));
+        char_set.set(static_cast<unsigned char>(c));
       }
-      return Bytes(do_rstrip(bytes, [&](char c) { return char_set.test(c); }));
+      return do_lstrip(s, [&](char c) {
+        return char_set.test(static_cast<unsigned char>(c));
+      });
     } else {
-      return Bytes(
-          do_rstrip(bytes, [&](char c) { return absl::ascii_isspace(c); }));
+      return do_lstrip(s, [&](char c) { return absl::ascii_isspace(c); });
     }
   }
+};
+
+// strings.rstrip eliminates trailing whitespaces,
+// or trailing specified characters.
+struct RStripOp {
+  Bytes operator()(const Bytes& bytes,
+                   const OptionalValue<Bytes>& chars) const {
+    return Bytes(StripBytes(bytes, chars));
+  }
 
   Text operator()(const Text& text, const OptionalValue<Text>& chars) const {
+    // See LStripOp for the ascii fast path rationale.
+    if (IsAscii(text) && (!chars.present || IsAscii(chars.value))) {
+      return Text(StripBytes(text, chars));
+    }
     auto do_rstrip = [](absl::string_view s, auto strip_test) {
       int len = s.length();
       for (int i = s.length(); i > 0;) {
@@ -215,6 +221,31 @@ struct RStripOp {
     }
     return Text(do_rstrip(text, [&](UChar32 c) { return set.contains(c); }));
   }
+
+ private:
+  template <typename StringT>
+  static absl::string_view StripBytes(absl::string_view s,
+                                      const OptionalValue<StringT>& chars) {
+    auto do_rstrip = [](absl::string_view s, auto strip_test) {
+      const char* b = s.data();
+      const char* e = s.data() + s.length() - 1;
+      while (b <= e && strip_test(*e)) {
+        --e;
+      }
+      return absl::string_view(b, e - b + 1);
+    };
+    if (chars.present) {
+      std::bitset<256> char_set;
+      for (char c : absl::string_view(chars.value)) {
+        char_set.set(static_cast<unsigned char>(c));
+      }
+      return do_rstrip(s, [&](char c) {
+        return char_set.test(static_cast<unsigned char>(c));
+      });
+    } else {
+      return do_rstrip(s, [&](char c) { return absl::ascii_isspace(c); });
+    }
+  }
 };
 
 // strings.strip eliminates leading and trailing whitespaces, or leading and
@@ -243,7 +274,7 @@ struct BytesLengthOp {
 // Returns the length in code-points of a Text object.
 struct TextLengthOp {
   int32_t operator()(absl::string_view s) const {
-    return icu::UnicodeString::fromUTF8(s).countChar32();
+    return Utf8CodePointCount(s);
   }
 
   int32_t operator()(const Text& text) const {
@@ -292,10 +323,11 @@ struct DecodeOp {
 
 // Compile `pattern` into a regular expression. Returns an error if `pattern`
 // is not a valid regular expression.
+//
+// The compiled regular expressions are kept in a process-wide LRU cache, so
+// patterns that arrive as data are not recompiled on every evaluation.
 struct CompileRegexOp {
-  absl::StatusOr<Regex> operator()(const Text& pattern) const {
-    return Regex::FromPattern(pattern);
-  }
+  absl::StatusOr<Regex> operator()(const Text& pattern) const;
 };
 
 // Returns kPresent if `s` contains the regular expression contained in
@@ -308,6 +340,18 @@ struct ContainsRegexOp {
   }
 };
 
+// Returns kPresent if `s` contains a match for any of the regular expressions
+// in `regex_set`.
+struct MatchAnyOp {
+  OptionalUnit operator()(const Text& text, const RegexSet& regex_set) const {
+    return OptionalUnit{regex_set.PartialMatchAny(text.view())};
+  }
+  OptionalUnit operator()(const OptionalValue<Text>& text,
+                          const RegexSet& regex_set) const {
+    return text.present ? (*this)(text.value, regex_set) : kMissing;
+  }
+};
+
 // Given a `regexp` with a single capturing group, if `text` contains the
 // pattern represented by `regexp`, then return the matched value from the
 // capturing group, otherwise missing. Returns an error if `regexp` does not
@@ -321,6 +365,126 @@ struct ExtractRegexOp {
   }
 };
 
+namespace strings_internal {
+
+// Returns true if all the 8 characters packed into `chunk` (in little endian
+// order) are decimal digits.
+inline bool IsEightDigits(uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+          (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+// Returns the value of the 8 decimal digits packed into `chunk` (in little
+// endian order), using 3 multiplications instead of 8.
+inline uint32_t ParseEightDigits(uint64_t chunk) {
+  constexpr uint64_t kMask = 0x000000FF000000FF;
+  constexpr uint64_t kMul1 = 100 + (1000000ull << 32);
+  constexpr uint64_t kMul2 = 1 + (10000ull << 32);
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return static_cast<uint32_t>(
+      (((chunk & kMask) * kMul1) + (((chunk >> 16) & kMask) * kMul2)) >> 32);
+}
+
+// Consumes at most `max_digits` decimal digits from [begin, end), appending
+// them to `value`. Returns the position after the consumed digits.
+inline const char* ConsumeDigits(const char* begin, const char* end,
+                                 int max_digits, uint64_t& value) {
+  const char* limit = begin + std::min<std::ptrdiff_t>(end - begin, max_digits);
+  const char* p = begin;
+  if constexpr (std::endian::native == std::endian::little) {
+    while (limit - p >= 8) {
+      uint64_t chunk;
+      std::memcpy(&chunk, p, sizeof(chunk));
+      if (!IsEightDigits(chunk)) {
+        break;
+      }
+      value = value * 100000000 + ParseEightDigits(chunk);
+      p += 8;
+    }
+  }
+  for (; p < limit && absl::ascii_isdigit(*p); ++p) {
+    value = value * 10 + (*p - '0');
+  }
+  return p;
+}
+
+// Fast path for ParseIntT: handles decimal numbers of at most 18 digits.
+// Returns false if the string is invalid or has to be parsed by the general
+// algorithm.
+template <typename IntT>
+bool FastParseIntT(absl::string_view str, IntT& result) {
+  static_assert(std::is_signed_v<IntT> && sizeof(IntT) <= sizeof(int64_t));
+  const char* p = str.data();
+  const char* end = p + str.size();
+  const bool negative = p < end && *p == '-';
+  p += negative;
+  uint64_t value = 0;
+  const char* digits_end = ConsumeDigits(p, end, /*max_digits=*/18, value);
+  if (digits_end == p || digits_end != end) {
+    return false;
+  }
+  // Can't overflow because value < 10^18.
+  int64_t signed_value = negative ? -static_cast<int64_t>(value)
+                                  : static_cast<int64_t>(value);
+  if (signed_value < std::numeric_limits<IntT>::min() ||
+      signed_value > std::numeric_limits<IntT>::max()) {
+    return false;
+  }
+  result = static_cast<IntT>(signed_value);
+  return true;
+}
+
+// Fast path for ParseFloatT: handles "[-]digits[.digits]" if the digits, as
+// an integer, and the power of ten of the fractional part are exactly
+// representable in FloatT. Then a single correctly rounded division gives the
+// correctly rounded result (Clinger's fast path), the same as from_chars().
+// Returns false if the string has to be parsed by the general algorithm.
+template <typename FloatT>
+bool FastParseFloatT(absl::string_view str, FloatT& result) {
+  static_assert(std::is_same_v<FloatT, float> ||
+                std::is_same_v<FloatT, double>);
+  constexpr uint64_t kMaxExactMantissa = uint64_t{1}
+                                         << std::numeric_limits<FloatT>::digits;
+  constexpr int kMaxExactPow10 = std::is_same_v<FloatT, float> ? 10 : 22;
+  constexpr double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                               1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                               1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                               1e18, 1e19, 1e20, 1e21, 1e22};
+  constexpr int kMaxDigits = 19;  // So that the mantissa fits into uint64_t.
+  const char* p = str.data();
+  const char* end = p + str.size();
+  const bool negative = p < end && *p == '-';
+  p += negative;
+  uint64_t mantissa = 0;
+  const char* int_end = ConsumeDigits(p, end, kMaxDigits, mantissa);
+  if (int_end == p) {
+    return false;
+  }
+  int frac_digits = 0;
+  if (int_end < end && *int_end == '.') {
+    const char* frac_begin = int_end + 1;
+    const char* frac_end = ConsumeDigits(
+        frac_begin, end, kMaxDigits - (int_end - p), mantissa);
+    if (frac_end == frac_begin) {
+      return false;
+    }
+    frac_digits = frac_end - frac_begin;
+    int_end = frac_end;
+  }
+  if (int_end != end || mantissa > kMaxExactMantissa ||
+      frac_digits > kMaxExactPow10) {
+    return false;
+  }
+  FloatT value = static_cast<FloatT>(mantissa) /
+                 static_cast<FloatT>(kPow10[frac_digits]);
+  result = negative ? -value : value;
+  return true;
+}
+
+}  // namespace strings_internal
+
 // Parses a floating number from a string representation.
 // Returns true if the parsing was successful.
 //
@@ -353,6 +517,9 @@ bool ParseFloatT(absl::string_view str, FloatT& result) {
       return false;
     }
   }
+  if (strings_internal::FastParseFloatT(str, result)) {
+    return true;
+  }
   // Invoke the parser.
   auto [ptr, ec] =
       absl::from_chars(str.data(), str.data() + str.size(), result);
@@ -395,6 +562,9 @@ bool ParseIntT(absl::string_view str, IntT& result) {
       return false;  // Forbid: +-
     }
   }
+  if (strings_internal::FastParseIntT(str, result)) {
+    return true;
+  }
   auto [ptr, ec] =
       std::from_chars(str.data(), str.data() + str.size(), result, 10);
   return ec == std::errc() && ptr == str.data() + str.size();
@@ -13,15 +13,21 @@
 // limitations under the License.
 //
 #include <cstdint>
+#include <limits>
+#include <optional>
 #include <string>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "arolla/array/array.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/operators.h"
+#include "arolla/qexpr/operators/strings/find.h"
+#include "arolla/qexpr/operators/strings/split.h"
+#include "arolla/qexpr/operators/strings/strings.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/strings/regex.h"
 #include "arolla/util/bytes.h"
@@ -133,6 +139,65 @@ TEST_F(StringsTest, UpperWithLocale) {
               IsOkAndHolds(Text("İSTANBUL")));
 }
 
+TEST_F(StringsTest, LowerUpperNonAscii) {
+  // The non-ascii strings skip the ascii fast path.
+  EXPECT_THAT(InvokeOperator<Text>("strings.lower", Text("ÆSOP Hello")),
+              IsOkAndHolds(Text("æsop hello")));
+  EXPECT_THAT(InvokeOperator<Text>("strings.upper", Text("æsop hello")),
+              IsOkAndHolds(Text("ÆSOP HELLO")));
+}
+
+TEST_F(StringsTest, LowerOnDenseArray) {
+  EXPECT_THAT(
+      InvokeOperator<DenseArray<Text>>(
+          "strings.lower",
+          CreateDenseArray<Text>(
+              {Text("ABC"), std::nullopt, Text("ÀBC"), Text("")})),
+      IsOkAndHolds(ElementsAre(Text("abc"), std::nullopt, Text("àbc"),
+                               Text(""))));
+}
+
+TEST_F(StringsTest, StripText) {
+  EXPECT_EQ(StripOp()(Text(" \t abc \n"), std::nullopt).value(), Text("abc"));
+  EXPECT_EQ(StripOp()(Text("\bab\b"), Text("a")).value(), Text("\bab\b"));
+  EXPECT_EQ(StripOp()(Text("xyabcyx"), Text("xy")).value(), Text("abc"));
+  EXPECT_EQ(LStripOp()(Text("ééabcé"), Text("é")), Text("abcé"));
+  EXPECT_EQ(RStripOp()(Text("abc\u3000"), std::nullopt), Text("abc"));
+}
+
+TEST_F(StringsTest, FindText) {
+  const OptionalValue<int64_t> kMissing;
+  EXPECT_EQ(FindSubstringOp()(Text("abcabc"), Text("c"), 3, kMissing, -1), 5);
+  EXPECT_EQ(FindSubstringOp()(Text("ééabcabc"), Text("c"), 5, kMissing, -1),
+            7);
+  EXPECT_EQ(FindSubstringOp()(Text("abcabc"), Text("d"), 0, kMissing, -1), -1);
+  EXPECT_EQ(
+      FindLastSubstringOp()(Text("abcabc"), Text("a"), kMissing, -3, -1), 0);
+  EXPECT_EQ(SubstringOp()(Text("abcdef"), 1, -1), Text("bcde"));
+  EXPECT_EQ(SubstringOp()(Text("éabcdef"), 1, -1), Text("abcde"));
+}
+
+TEST_F(StringsTest, SplitSharesCharacters) {
+  auto array = CreateDenseArray<Text>(
+      {Text("a bc"), std::nullopt, Text(""), Text("  d ")});
+  ASSERT_OK_AND_ASSIGN(auto res, SplitOp()(array, OptionalValue<Text>()));
+  const auto& [splits, edge] = res;
+  EXPECT_THAT(splits, ElementsAre(Text("a"), Text("bc"), Text("d")));
+  EXPECT_THAT(edge.edge_values(), ElementsAre(0, 2, 2, 2, 3));
+  EXPECT_EQ(splits.values.characters().begin(),
+            array.values.characters().begin());
+}
+
+TEST_F(StringsTest, SplitArrayWithMissingIdValue) {
+  auto array = CreateArray<Text>({Text("a,b"), Text("c,d"), Text("c,d")})
+                   .ToSparseForm(Text("c,d"));
+  ASSERT_OK_AND_ASSIGN(auto res,
+                       SplitOp()(array, OptionalValue<Text>(Text(","))));
+  const auto& [splits, edge] = res;
+  EXPECT_THAT(splits, ElementsAre(Text("a"), Text("b"), Text("c"), Text("d"),
+                                  Text("c"), Text("d")));
+}
+
 TEST_F(StringsTest, BytesLength) {
   EXPECT_THAT(InvokeOperator<int32_t>("strings.length",
                                       Bytes("古池や蛙飛び込む水の音")),
@@ -159,6 +224,66 @@ TEST_F(StringsTest, ContainsRegex) {
               IsOkAndHolds(kMissing));
 }
 
+TEST_F(StringsTest, CompileRegexIsCached) {
+  ASSERT_OK_AND_ASSIGN(
+      Regex regex1, InvokeOperator<Regex>("strings._compile_regex",
+                                          Text("cached: \\d+")));
+  ASSERT_OK_AND_ASSIGN(
+      Regex regex2, InvokeOperator<Regex>("strings._compile_regex",
+                                          Text("cached: \\d+")));
+  EXPECT_EQ(&regex1.value(), &regex2.value());
+}
+
+TEST_F(StringsTest, MatchAny) {
+  ASSERT_OK_AND_ASSIGN(
+      RegexSet regex_set,
+      InvokeOperator<RegexSet>("strings._compile_regex_set",
+                               Text("^\\d{1,3} bottles"), Text("of beer$")));
+  EXPECT_THAT(InvokeOperator<OptionalUnit>("strings._match_any",
+                                           Text("999 bottles of wine"),
+                                           regex_set),
+              IsOkAndHolds(kPresent));
+  EXPECT_THAT(InvokeOperator<OptionalUnit>("strings._match_any",
+                                           Text("a glass of beer"), regex_set),
+              IsOkAndHolds(kPresent));
+  EXPECT_THAT(InvokeOperator<OptionalUnit>("strings._match_any",
+                                           Text("a glass of wine"), regex_set),
+              IsOkAndHolds(kMissing));
+  EXPECT_THAT(InvokeOperator<RegexSet>("strings._compile_regex_set",
+                                       Text("abc"), Text("ab\\αcd")),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Invalid regular expression: \"ab\\αcd\"; ")));
+}
+
+TEST_F(StringsTest, ParseNumbersFastPath) {
+  // The fast path must agree with the general algorithm on the boundaries.
+  EXPECT_THAT(StringsParseInt64()(Bytes("123456789012345678")),
+              IsOkAndHolds(123456789012345678));
+  EXPECT_THAT(StringsParseInt64()(Bytes("-9223372036854775808")),
+              IsOkAndHolds(std::numeric_limits<int64_t>::min()));
+  EXPECT_THAT(StringsParseInt64()(Bytes("9223372036854775808")),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(StringsParseInt32()(Bytes("-2147483648")),
+              IsOkAndHolds(std::numeric_limits<int32_t>::min()));
+  EXPECT_THAT(StringsParseInt32()(Bytes("2147483648")),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(StringsParseInt32()(Bytes("1234567a")),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  EXPECT_THAT(StringsParseFloat32()(Bytes("007.50")), IsOkAndHolds(7.5f));
+  EXPECT_THAT(StringsParseFloat32()(Bytes("16777217")),
+              IsOkAndHolds(16777216.0f));
+  EXPECT_THAT(StringsParseFloat32()(Bytes("0.1")), IsOkAndHolds(0.1f));
+  EXPECT_THAT(StringsParseFloat64()(Bytes("-1234.5678")),
+              IsOkAndHolds(-1234.5678));
+  EXPECT_THAT(StringsParseFloat64()(Bytes("9007199254740993")),
+              IsOkAndHolds(9007199254740992.0));
+  EXPECT_THAT(StringsParseFloat64()(Bytes("1.")), IsOkAndHolds(1.0));
+  EXPECT_THAT(StringsParseFloat64()(Bytes(".5")), IsOkAndHolds(0.5));
+  EXPECT_THAT(StringsParseFloat64()(Bytes("1.2.3")),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST_F(StringsTest, ExtractRegex) {
   using OT = OptionalValue<Text>;
 
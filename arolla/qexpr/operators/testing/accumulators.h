@@ -42,6 +42,9 @@ class AggSumAccumulator final
  public:
   void Reset() final { accumulator_ = {false, 0}; }
   void Add(T value) final { accumulator_ = accumulator_.value + value; }
+  void Merge(const AggSumAccumulator& other) {
+    if (other.accumulator_.present) Add(other.accumulator_.value);
+  }
   OptionalValue<T> GetResult() final { return accumulator_; }
 
  private:
@@ -56,12 +59,31 @@ class AggCountAccumulator final
  public:
   void Reset() final { count_ = 0; }
   void Add(T value) final { count_++; }
+  void Merge(const AggCountAccumulator& other) { count_ += other.count_; }
   int64_t GetResult() final { return count_; }
 
  private:
   int64_t count_ = 12345;  // to test that Reset() is used before first Add.
 };
 
+// Cumulative sum starting from a per-group offset.
+template <typename T>
+class CumSumAccumulator final
+    : public Accumulator<AccumulatorType::kPartial, T, meta::type_list<T>,
+                         meta::type_list<T>> {
+ public:
+  void Reset(T offset) final { offset_ = accumulator_ = offset; }
+  void Add(T value) final { accumulator_ += value; }
+  void Merge(const CumSumAccumulator& other) {
+    accumulator_ += other.accumulator_ - other.offset_;
+  }
+  T GetResult() final { return accumulator_; }
+
+ private:
+  T offset_ = 0;
+  T accumulator_ = 0;
+};
+
 // Average with a status.
 class AverageAccumulator final
     : public Accumulator<AccumulatorType::kAggregator, float, meta::type_list<>,
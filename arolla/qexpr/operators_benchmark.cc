@@ -61,5 +61,18 @@ void BM_AddDouble(benchmark::State& state) { BM_Add<double>(state); }
 BENCHMARK(BM_AddFloat)->Apply(&RunBenchmark);
 BENCHMARK(BM_AddDouble)->Apply(&RunBenchmark);
 
+// Microbenchmark for concurrent operator lookups.
+void BM_LookupOperator(benchmark::State& state) {
+  CHECK_OK(InitArolla());
+  auto* registry = OperatorRegistry::GetInstance();
+  auto qtype = GetQType<float>();
+  for (auto _ : state) {
+    auto op = registry->LookupOperator("test.add", {qtype, qtype}, qtype);
+    benchmark::DoNotOptimize(op);
+  }
+}
+
+BENCHMARK(BM_LookupOperator)->ThreadRange(1, 8);
+
 }  // namespace
 }  // namespace arolla
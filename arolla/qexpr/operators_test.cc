@@ -25,6 +25,7 @@
 #include "arolla/codegen/qexpr/testing/test_operators.h"
 #include "arolla/memory/frame.h"
 #include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operator_factory.h"
 #include "arolla/qexpr/qexpr_operator_signature.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/qtype.h"
@@ -221,6 +222,68 @@ TEST_F(OperatorsTest, OperatorNotFound) {
                                   "\".*\" build dependency may help")));
 }
 
+TEST_F(OperatorsTest, RegisterOperatorAfterLookup) {
+  auto* registry = OperatorRegistry::GetInstance();
+  QTypePtr i64_type = GetQType<int64_t>();
+  EXPECT_THAT(registry->LookupOperator("test.registered_after_lookup",
+                                       {i64_type}, i64_type),
+              StatusIs(absl::StatusCode::kNotFound));
+
+  ASSERT_OK_AND_ASSIGN(
+      auto op, OperatorFactory()
+                   .WithName("test.registered_after_lookup")
+                   .BuildFromFunction([](int64_t x) { return x + 1; }));
+  ASSERT_OK(registry->RegisterOperator(op));
+  EXPECT_THAT(registry->LookupOperator("test.registered_after_lookup",
+                                       {i64_type}, i64_type),
+              IsOkAndHolds(Eq(op)));
+}
+
+TEST_F(OperatorsTest, RegisterBetterOverloadAfterLookup) {
+  auto* registry = OperatorRegistry::GetInstance();
+  QTypePtr f32_type = GetQType<float>();
+  QTypePtr f64_type = GetQType<double>();
+  ASSERT_OK_AND_ASSIGN(
+      auto f64_f64_op,
+      OperatorFactory()
+          .WithName("test.better_overload_after_lookup")
+          .BuildFromFunction([](double x, double y) { return x + y; }));
+  ASSERT_OK(registry->RegisterOperator(f64_f64_op));
+  EXPECT_THAT(registry->LookupOperator("test.better_overload_after_lookup",
+                                       {f32_type, f32_type}, f64_type),
+              IsOkAndHolds(Eq(f64_f64_op)));
+
+  ASSERT_OK_AND_ASSIGN(
+      auto f32_f64_op,
+      OperatorFactory()
+          .WithName("test.better_overload_after_lookup")
+          .BuildFromFunction([](float x, double y) { return x + y; }));
+  ASSERT_OK(registry->RegisterOperator(f32_f64_op));
+  EXPECT_THAT(registry->LookupOperator("test.better_overload_after_lookup",
+                                       {f32_type, f32_type}, f64_type),
+              IsOkAndHolds(Eq(f32_f64_op)));
+}
+
+TEST_F(OperatorsTest, ListRegisteredOperatorOverloads) {
+  auto* registry = OperatorRegistry::GetInstance();
+  ASSERT_OK_AND_ASSIGN(
+      auto i64_op, OperatorFactory()
+                       .WithName("test.list_registered_overloads")
+                       .BuildFromFunction([](int64_t x) { return x + 1; }));
+  ASSERT_OK_AND_ASSIGN(
+      auto i32_op, OperatorFactory()
+                       .WithName("test.list_registered_overloads")
+                       .BuildFromFunction([](int32_t x) { return x + 1; }));
+  ASSERT_OK(registry->RegisterOperator(i64_op));
+  ASSERT_OK(registry->RegisterOperator(i32_op));
+  EXPECT_THAT(
+      registry->ListRegisteredOperatorOverloads(
+          "test.list_registered_overloads"),
+      ElementsAre(Eq(i64_op), Eq(i32_op)));
+  EXPECT_THAT(registry->ListRegisteredOperatorOverloads("test.not_registered"),
+              ElementsAre());
+}
+
 TEST_F(OperatorsTest, OperatorOverloadNotFound) {
   QTypePtr bool_type = GetQType<bool>();
   QTypePtr float_type = GetQType<float>();
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
 #include "arolla/memory/frame.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/evaluation_engine.h"
@@ -72,6 +73,10 @@ class CombinedBoundExpr : public BoundExpr {
 
   void Execute(EvaluationContext* ctx, FramePtr frame) const override;
 
+  absl::Span<const std::unique_ptr<BoundExpr>> subexprs() const {
+    return subexprs_;
+  }
+
  private:
   std::vector<std::unique_ptr<BoundExpr>> subexprs_;
 };
@@ -35,6 +35,7 @@
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/util/testing/benchmark_perf_counters.h"
 
 namespace arolla::testing {
 
@@ -130,6 +131,7 @@ void BenchmarkBinaryOperator(const QExprOperator& op, int num_inputs,
 
   if (use_arena) {
     int64_t iter = 0;
+    BenchmarkPerfCounters perf_counters(state);
     for (auto _ : state) {
       if (((++iter) & 0xff) == 0) {
         arena.Reset();
@@ -139,6 +141,7 @@ void BenchmarkBinaryOperator(const QExprOperator& op, int num_inputs,
       ::benchmark::DoNotOptimize(x);
     }
   } else {
+    BenchmarkPerfCounters perf_counters(state);
     for (auto _ : state) {
       auto x =
           NoInlineRunBoundOperators(bound_operators, &ctx, root_ctx.frame());
@@ -38,6 +38,7 @@
 #include "arolla/qtype/simple_qtype.h"
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
 #include "arolla/util/api.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/indestructible.h"
@@ -179,6 +180,12 @@ class AROLLA_API ArrayLikeQType : public SimpleQType {
   virtual std::unique_ptr<BatchFromFramesCopier> CreateBatchFromFramesCopier(
       RawBufferFactory* buffer_factory) const = 0;
 
+  // Returns a copy of the array with all the buffers allocated by
+  // `buffer_factory`, even if `value` already owns its buffers. Can be used to
+  // move long-living arrays to a special memory, e.g. HugePageBufferFactory.
+  virtual absl::StatusOr<TypedValue> CopyToBufferFactory(
+      TypedRef value, RawBufferFactory* buffer_factory) const = 0;
+
  protected:
   template <typename T>
   ArrayLikeQType(meta::type<T> type, std::string type_name,
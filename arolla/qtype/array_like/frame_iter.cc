@@ -34,6 +34,7 @@
 #include "arolla/qtype/array_like/array_like_qtype.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_ref.h"
+#include "arolla/util/cancellation_context.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
@@ -141,18 +142,21 @@ absl::StatusOr<FrameIterator> FrameIterator::Create(
                         *row_count, *options.row_count));
   }
   return FrameIterator(std::move(input_copiers), std::move(output_copiers),
-                       *row_count, options.frame_buffer_count, scalar_layout);
+                       *row_count, options.frame_buffer_count, scalar_layout,
+                       options.cancellation_context);
 }
 
 FrameIterator::FrameIterator(
     std::vector<std::unique_ptr<BatchToFramesCopier>>&& input_copiers,
     std::vector<std::unique_ptr<BatchFromFramesCopier>>&& output_copiers,
     size_t row_count, size_t frame_buffer_count,
-    const FrameLayout* scalar_layout)
+    const FrameLayout* scalar_layout,
+    CancellationContext* cancellation_context)
     : row_count_(row_count),
       input_copiers_(std::move(input_copiers)),
       output_copiers_(std::move(output_copiers)),
-      scalar_layout_(scalar_layout) {
+      scalar_layout_(scalar_layout),
+      cancellation_context_(cancellation_context) {
   frame_buffer_count = std::min(row_count, frame_buffer_count);
   // Should be aligned by 8 bytes to access double and int64_t efficiently.
   // TODO: Maybe calculate the optimal alignment in FrameLayout.
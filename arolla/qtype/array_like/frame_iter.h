@@ -21,6 +21,7 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
 #include "absl/log/check.h"
@@ -32,6 +33,7 @@
 #include "arolla/qtype/array_like/array_like_qtype.h"
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/util/cancellation_context.h"
 #include "arolla/util/threading.h"
 
 namespace arolla {
@@ -68,6 +70,10 @@ class FrameIterator {
     int64_t frame_buffer_count = 64;
     // Buffer factory for output arrays allocation.
     RawBufferFactory* buffer_factory = nullptr;
+    // If set, ForEachFrame stops between the buffers of frames once the
+    // evaluation is cancelled. The outputs are incomplete in this case, so
+    // StoreOutput must not be called.
+    CancellationContext* cancellation_context = nullptr;
   };
 
   // Creates FrameIterator from lists of arrays and scalar slots.
@@ -100,6 +106,9 @@ class FrameIterator {
   template <typename Fn>
   void ForEachFrame(Fn&& fn) {
     for (int64_t offset = 0; offset < row_count_; offset += frames_.size()) {
+      if (ShouldStop()) {
+        break;
+      }
       int64_t count = std::min<int64_t>(frames_.size(), row_count_ - offset);
       PreloadFrames(count);
       for (int64_t i = 0; i < count; ++i) {
@@ -109,7 +118,9 @@ class FrameIterator {
     }
   }
 
-  // The same as ForEachFrame(fn), but can use several threads.
+  // The same as ForEachFrame(fn), but can use several threads. If `fn` accepts
+  // (FramePtr, int), the id of the calling worker in range [0, thread_count)
+  // is passed as the second argument, e.g. to use per-thread state.
   template <typename Fn>
   void ForEachFrame(Fn&& fn, ThreadingInterface& threading, int thread_count) {
     DCHECK_GE(thread_count, 1);
@@ -124,17 +135,29 @@ class FrameIterator {
       }
     };
 
+    // Written by worker 0 only, the barrier makes it visible to the others.
+    bool stop = false;
     auto worker_fn = [&](int worker_id) {
       for (int64_t offset = 0; offset < row_count_; offset += frames_.size()) {
         int64_t count = std::min<int64_t>(frames_.size(), row_count_ - offset);
         if (worker_id == 0) {
-          PreloadFrames(count);
+          stop = ShouldStop();
+          if (!stop) {
+            PreloadFrames(count);
+          }
         }
         BarrierSync(barrier1);
+        if (stop) {
+          break;
+        }
         for (int64_t i = worker_id * frames_per_worker;
              i < std::min<int64_t>(count, (worker_id + 1) * frames_per_worker);
              ++i) {
-          fn(frames_[i]);
+          if constexpr (std::is_invocable_v<Fn&, FramePtr, int>) {
+            fn(frames_[i], worker_id);
+          } else {
+            fn(frames_[i]);
+          }
         }
         BarrierSync(barrier2);
         if (worker_id == 0) {
@@ -164,6 +187,11 @@ class FrameIterator {
     return buffer_.data() + index * dense_scalar_layout_size_;
   }
 
+  bool ShouldStop() {
+    return cancellation_context_ != nullptr &&
+           cancellation_context_->SoftCheck();
+  }
+
   void PreloadFrames(size_t frames_count);
   void SaveOutputsOfProcessedFrames(size_t frames_count);
 
@@ -171,7 +199,8 @@ class FrameIterator {
       std::vector<std::unique_ptr<BatchToFramesCopier>>&& input_copiers,
       std::vector<std::unique_ptr<BatchFromFramesCopier>>&& output_copiers,
       size_t row_count, size_t frame_buffer_count,
-      const FrameLayout* scalar_layout);
+      const FrameLayout* scalar_layout,
+      CancellationContext* cancellation_context);
 
   int64_t row_count_;
 
@@ -185,6 +214,7 @@ class FrameIterator {
   std::vector<char> buffer_;
   const FrameLayout* scalar_layout_;
   size_t dense_scalar_layout_size_;
+  CancellationContext* cancellation_context_;  // Not owned, can be nullptr.
 };
 
 }  // namespace arolla
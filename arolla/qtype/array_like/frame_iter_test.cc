@@ -123,6 +123,29 @@ TEST(FrameIterator, Iterate) {
     frame_iterator.ForEachFrame(scalar_processing_fn, threading, threads);
     check_output_fn(frame_iterator);
   }
+
+  // with worker ids
+  for (int threads = 1; threads <= 4; ++threads) {
+    ASSERT_OK_AND_ASSIGN(
+        auto frame_iterator,
+        FrameIterator::Create(input_refs, scalar_slots, output_slots,
+                              scalar_slots, &scalar_layout,
+                              {.frame_buffer_count = 3}));
+    std::vector<int64_t> rows_per_worker(threads, 0);
+    frame_iterator.ForEachFrame(
+        [&](FramePtr frame, int worker_id) {
+          ASSERT_GE(worker_id, 0);
+          ASSERT_LT(worker_id, threads);
+          // Each worker only touches its own counter.
+          rows_per_worker[worker_id]++;
+          scalar_processing_fn(frame);
+        },
+        threading, threads);
+    check_output_fn(frame_iterator);
+    int64_t total_rows = 0;
+    for (int64_t rows : rows_per_worker) total_rows += rows;
+    EXPECT_EQ(total_rows, 4);
+  }
 }
 
 TEST(FrameIterator, EmptyArrays) {
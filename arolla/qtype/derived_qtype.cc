@@ -38,6 +38,7 @@ BasicDerivedQType::BasicDerivedQType(ConstructorArgs args)
           .type_fields = args.base_qtype->type_fields(),
           .value_qtype = args.value_qtype,
           .qtype_specialization_key = std::move(args.qtype_specialization_key),
+          .is_trivially_copyable = args.base_qtype->is_trivially_copyable(),
       }),
       base_qtype_(args.base_qtype) {
   CHECK_OK(VerifyDerivedQType(this));
@@ -53,6 +54,15 @@ void BasicDerivedQType::UnsafeCopy(const void* source,
   base_qtype_->UnsafeCopy(source, destination);
 }
 
+void BasicDerivedQType::UnsafeMove(void* source, void* destination) const {
+  base_qtype_->UnsafeMove(source, destination);
+}
+
+int64_t BasicDerivedQType::UnsafeEstimateHeapMemoryUsage(
+    const void* source) const {
+  return base_qtype_->UnsafeEstimateHeapMemoryUsage(source);
+}
+
 void BasicDerivedQType::UnsafeCombineToFingerprintHasher(
     const void* source, FingerprintHasher* hasher) const {
   base_qtype_->UnsafeCombineToFingerprintHasher(source, hasher);
@@ -66,6 +66,8 @@ class BasicDerivedQType : public QType, public DerivedQTypeInterface {
   void UnsafeCombineToFingerprintHasher(const void* source,
                                         FingerprintHasher* hasher) const final;
   void UnsafeCopy(const void* source, void* destination) const final;
+  void UnsafeMove(void* source, void* destination) const final;
+  int64_t UnsafeEstimateHeapMemoryUsage(const void* source) const final;
 
   QTypePtr GetBaseQType() const final { return base_qtype_; }
 
@@ -0,0 +1,121 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qtype/dict/bloom_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "arolla/qtype/simple_qtype.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/repr.h"
+
+namespace arolla {
+namespace {
+
+// The block index is computed from 32 bits of the hash.
+constexpr size_t kMaxNumBlocks = size_t{1} << 32;
+
+// Returns the false positive rate of the filter with the given average number
+// of keys per block. The number of keys in a block follows Poisson
+// distribution, and its variance noticeably increases the rate compared to
+// the estimate for the average load.
+double FalsePositiveRate(double keys_per_block) {
+  double result = 0;
+  double probability = std::exp(-keys_per_block);  // P(block has k keys).
+  const int max_keys = keys_per_block + 12 * std::sqrt(keys_per_block) + 12;
+  for (int k = 0; k <= max_keys; ++k) {
+    // All eight bits must be set, and a bit in a 32-bit word is set by
+    // one key with probability 1/32.
+    result += probability * std::pow(1 - std::pow(31.0 / 32, k), 8);
+    probability *= keys_per_block / (k + 1);
+  }
+  return result;
+}
+
+}  // namespace
+
+absl::StatusOr<BloomFilter::Builder> BloomFilter::Builder::Create(
+    int64_t expected_size, double false_positive_rate) {
+  if (!(false_positive_rate > 0 && false_positive_rate < 1)) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "false_positive_rate must be in range (0, 1), got %f",
+        false_positive_rate));
+  }
+  // Binary search for the maximal load that satisfies false_positive_rate.
+  double min_load = 0;
+  double max_load = 256;  // FalsePositiveRate(256) > 0.99.
+  for (int i = 0; i < 64; ++i) {
+    double load = (min_load + max_load) / 2;
+    (FalsePositiveRate(load) <= false_positive_rate ? min_load : max_load) =
+        load;
+  }
+  double num_blocks = std::ceil(std::max<int64_t>(expected_size, 1) /
+                                std::max(min_load, 1e-9));
+  if (num_blocks > kMaxNumBlocks) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Bloom filter for %d keys with false_positive_rate %f is too large",
+        expected_size, false_positive_rate));
+  }
+  return Builder(static_cast<size_t>(num_blocks));
+}
+
+void BloomFilter::Builder::AddHash(uint64_t hash) {
+  uint32_t* block = impl_.Block(hash);
+  uint32_t key = static_cast<uint32_t>(hash);
+  for (size_t i = 0; i < kWordsPerBlock; ++i) {
+    block[i] |= Mask(key, i);
+  }
+  ++impl_.size;
+}
+
+BloomFilter BloomFilter::Builder::Build() && {
+  return BloomFilter(std::make_shared<const Impl>(std::move(impl_)));
+}
+
+absl::StatusOr<BloomFilter> BloomFilter::FromWords(
+    int64_t size, std::vector<uint32_t> words) {
+  if (words.empty() || words.size() % kWordsPerBlock != 0 ||
+      words.size() / kWordsPerBlock > kMaxNumBlocks) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "invalid number of Bloom filter words: %d", words.size()));
+  }
+  if (size < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("invalid Bloom filter size: %d", size));
+  }
+  return BloomFilter(std::make_shared<const Impl>(size, std::move(words)));
+}
+
+void FingerprintHasherTraits<BloomFilter>::operator()(
+    FingerprintHasher* hasher, const BloomFilter& value) const {
+  hasher->Combine(value.size()).CombineSpan(value.words());
+}
+
+ReprToken ReprTraits<BloomFilter>::operator()(const BloomFilter& value) const {
+  return ReprToken{absl::StrFormat("bloom_filter{size=%d, bytes=%d}",
+                                   value.size(), value.ByteSize())};
+}
+
+AROLLA_DEFINE_SIMPLE_QTYPE(BLOOM_FILTER, BloomFilter);
+
+}  // namespace arolla
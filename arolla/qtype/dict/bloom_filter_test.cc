@@ -0,0 +1,133 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qtype/dict/bloom_filter.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/repr.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::StatusIs;
+using ::testing::HasSubstr;
+
+TEST(BloomFilterTest, QType) {
+  EXPECT_EQ(GetQType<BloomFilter>()->name(), "BLOOM_FILTER");
+  EXPECT_EQ(Repr(BloomFilter()), "bloom_filter{size=0, bytes=0}");
+}
+
+TEST(BloomFilterTest, Empty) {
+  EXPECT_FALSE(BloomFilter().MayContain(int64_t{5}));
+  ASSERT_OK_AND_ASSIGN(auto builder, BloomFilter::Builder::Create(0, 0.01));
+  BloomFilter filter = std::move(builder).Build();
+  EXPECT_EQ(filter.size(), 0);
+  EXPECT_EQ(filter.ByteSize(), 32);
+  EXPECT_FALSE(filter.MayContain(int64_t{5}));
+  EXPECT_FALSE(filter.MayContain(absl::string_view("abc")));
+}
+
+TEST(BloomFilterTest, CreateErrors) {
+  EXPECT_THAT(BloomFilter::Builder::Create(10, 0),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("false_positive_rate must be in range")));
+  EXPECT_THAT(BloomFilter::Builder::Create(10, 1),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(BloomFilter::Builder::Create(int64_t{1} << 40, 1e-9),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("is too large")));
+  EXPECT_THAT(BloomFilter::FromWords(0, {}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("invalid number of Bloom filter words")));
+  EXPECT_THAT(BloomFilter::FromWords(0, std::vector<uint32_t>(7)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(BloomFilter::FromWords(-1, std::vector<uint32_t>(8)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("invalid Bloom filter size")));
+}
+
+TEST(BloomFilterTest, FalsePositiveRate) {
+  constexpr int64_t kSize = 100000;
+  for (double rate : {0.1, 0.01, 0.001}) {
+    ASSERT_OK_AND_ASSIGN(auto builder,
+                         BloomFilter::Builder::Create(kSize, rate));
+    for (int64_t i = 0; i < kSize; ++i) {
+      builder.Add(i * 2);
+    }
+    BloomFilter filter = std::move(builder).Build();
+    EXPECT_EQ(filter.size(), kSize);
+    int64_t false_positives = 0;
+    for (int64_t i = 0; i < kSize; ++i) {
+      ASSERT_TRUE(filter.MayContain(i * 2));
+      false_positives += filter.MayContain(i * 2 + 1);
+    }
+    EXPECT_LT(false_positives, 1.5 * rate * kSize) << rate;
+  }
+}
+
+TEST(BloomFilterTest, KeyTypes) {
+  ASSERT_OK_AND_ASSIGN(auto builder, BloomFilter::Builder::Create(100, 0.01));
+  builder.Add(int32_t{57});
+  builder.Add(absl::string_view("abc"));
+  builder.Add(true);
+  BloomFilter filter = std::move(builder).Build();
+  EXPECT_TRUE(filter.MayContain(int32_t{57}));
+  EXPECT_TRUE(filter.MayContain(int64_t{57}));
+  EXPECT_TRUE(filter.MayContain(uint64_t{57}));
+  EXPECT_TRUE(filter.MayContain(absl::string_view("abc")));
+  EXPECT_TRUE(filter.MayContain(std::string("abc")));
+  EXPECT_TRUE(filter.MayContain(true));
+  int64_t false_positives = 0;
+  for (int i = 0; i < 1000; ++i) {
+    false_positives +=
+        filter.MayContain(absl::string_view(absl::StrCat("x", i)));
+  }
+  EXPECT_LT(false_positives, 30);
+}
+
+TEST(BloomFilterTest, FromWords) {
+  ASSERT_OK_AND_ASSIGN(auto builder, BloomFilter::Builder::Create(1000, 0.01));
+  for (int64_t i = 0; i < 1000; ++i) {
+    builder.Add(i);
+  }
+  BloomFilter filter = std::move(builder).Build();
+  ASSERT_OK_AND_ASSIGN(
+      BloomFilter copy,
+      BloomFilter::FromWords(filter.size(),
+                             std::vector<uint32_t>(filter.words().begin(),
+                                                   filter.words().end())));
+  EXPECT_EQ(copy.size(), 1000);
+  for (int64_t i = 0; i < 2000; ++i) {
+    EXPECT_EQ(copy.MayContain(i), filter.MayContain(i));
+  }
+  EXPECT_EQ(FingerprintHasher("salt").Combine(copy).Finish(),
+            FingerprintHasher("salt").Combine(filter).Finish());
+  EXPECT_NE(FingerprintHasher("salt").Combine(copy).Finish(),
+            FingerprintHasher("salt").Combine(BloomFilter()).Finish());
+}
+
+}  // namespace
+}  // namespace arolla
@@ -15,7 +15,10 @@
 #ifndef AROLLA_QTYPE_DICT_DICT_TYPES_H_
 #define AROLLA_QTYPE_DICT_DICT_TYPES_H_
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <sstream>
@@ -24,9 +27,15 @@
 #include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/prefetch.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/log/check.h"
+#include "absl/numeric/int128.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/qtype.h"
@@ -35,7 +44,7 @@
 #include "arolla/util/bytes.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/indestructible.h"
-#include "arolla/util/map.h"
+#include "arolla/util/memory_usage.h"
 #include "arolla/util/meta.h"
 #include "arolla/util/repr.h"
 #include "arolla/util/text.h"
@@ -48,6 +57,12 @@ namespace arolla {
 bool IsDictQType(const QType* /*nullable*/ qtype);
 
 // KeyToRowDict from Key to row id.
+//
+// The dict has three immutable backends: a hash map (default), a compact
+// perfect hash table, available for integral keys (see
+// KeyToRowDict::CreateCompact), and sorted arrays owned by the caller (see
+// KeyToRowDict::CreateStatic). Use the Find / Contains / ForEach methods in
+// order to support all of them.
 template <typename Key>
 class KeyToRowDict {
   // We are using default hasher and equality from flat_hash_map with view type
@@ -62,6 +77,10 @@ class KeyToRowDict {
  public:
   using Map = absl::flat_hash_map<Key, int64_t, Hasher, KeyEqual>;
 
+  // Whether the compact backend supports the Key type.
+  static constexpr bool kSupportsCompact =
+      std::is_integral_v<Key> && !std::is_same_v<Key, bool>;
+
   KeyToRowDict() = default;
   explicit KeyToRowDict(Map dict)
       : dict_(std::make_shared<Map>(std::move(dict))) {}
@@ -69,15 +88,308 @@ class KeyToRowDict {
   KeyToRowDict(std::initializer_list<typename Map::value_type> dict)
       : dict_(std::make_shared<Map>(std::move(dict))) {}
 
-  // Returns underlying data or empty map if not initialized.
+  // Creates a dict with the compact backend: a perfect hash table without
+  // control bytes. It needs ~18.5 bytes per element (the hash map needs 17-34
+  // bytes depending on the load factor), and every lookup reads one element
+  // of the pilots array and one slot. Construction is a few times slower than
+  // for the hash map. In the (very unlikely) case if the perfect hash table
+  // cannot be built within a bounded number of attempts, falls back to the
+  // hash map backend; check is_compact() if it matters.
+  static KeyToRowDict CreateCompact(const Map& dict) {
+    static_assert(kSupportsCompact);
+    auto compact = std::make_shared<Compact>();
+    if (!compact->Build(dict)) {
+      return KeyToRowDict(dict);
+    }
+    KeyToRowDict result;
+    result.compact_ = std::move(compact);
+    return result;
+  }
+
+  // Creates a dict referencing the given arrays without copying them: the
+  // strictly increasing `sorted_keys` and the corresponding `rows`. Lookups
+  // are binary searches. Used by codegen, which emits the arrays as constant
+  // static data, so the dict costs nothing at initialization. The arrays must
+  // outlive the dict and all its copies.
+  static KeyToRowDict CreateStatic(
+      absl::Span<const view_type_t<Key>> sorted_keys,
+      absl::Span<const int64_t> rows) {
+    DCHECK_EQ(sorted_keys.size(), rows.size());
+    DCHECK(std::adjacent_find(sorted_keys.begin(), sorted_keys.end(),
+                              std::greater_equal<>()) == sorted_keys.end());
+    KeyToRowDict result;
+    result.static_keys_ = sorted_keys;
+    result.static_rows_ = rows.data();
+    return result;
+  }
+
+  // Returns the underlying hash map or an empty map if not initialized.
+  //
+  // Deprecated: supported only by the hash map backend, use size(), Find(),
+  // Contains() or ForEach() instead. For a non-empty dict with the compact or
+  // the static backend it fails a DCHECK and returns an empty map.
+  ABSL_DEPRECATED("Use size(), Find(), Contains() or ForEach() instead.")
   const Map& map() const {
+    DCHECK(dict_ != nullptr || size() == 0)
+        << "KeyToRowDict::map() is not supported by the "
+        << (is_compact() ? "compact" : "static") << " backend";
     static const Indestructible<Map> empty;
     return dict_ != nullptr ? *dict_ : *empty;
   }
 
+  bool is_compact() const { return compact_ != nullptr; }
+  bool is_static() const { return static_rows_ != nullptr; }
+
+  // Returns an estimate of the memory used by the backend. The backend is
+  // shared by the copies of the dict. The arrays of the static backend are not
+  // owned by the dict and are not counted.
+  size_t memory_usage() const {
+    size_t result = 0;
+    if (compact_ != nullptr) {
+      result = VectorMemoryUsage(compact_->pilots) +
+               VectorMemoryUsage(compact_->slots);
+    } else if (dict_ != nullptr) {
+      result = HashTableMemoryUsage(*dict_);
+    } else {
+      return 0;
+    }
+    if constexpr (std::is_same_v<view_type_t<Key>, absl::string_view>) {
+      ForEach([&](view_type_t<Key> key, int64_t) { result += key.size(); });
+    }
+    return result;
+  }
+
+  size_t size() const {
+    if (compact_ != nullptr) {
+      return compact_->size;
+    }
+    if (dict_ != nullptr) {
+      return dict_->size();
+    }
+    return static_keys_.size();
+  }
+
+  // Returns the row for the given key, or missing if not found.
+  OptionalValue<int64_t> Find(view_type_t<Key> key) const {
+    if (compact_ != nullptr) {
+      return compact_->Find(key);
+    }
+    if (dict_ != nullptr) {
+      if (auto it = dict_->find(key); it != dict_->end()) {
+        return it->second;
+      }
+      return std::nullopt;
+    }
+    auto it = std::lower_bound(static_keys_.begin(), static_keys_.end(), key);
+    if (it != static_keys_.end() && *it == key) {
+      return static_rows_[it - static_keys_.begin()];
+    }
+    return std::nullopt;
+  }
+
+  bool Contains(view_type_t<Key> key) const { return Find(key).present; }
+
+  // Software prefetching for batched lookups into large dicts. It is done in
+  // two stages: Prefetch(key) requests the first level of the data structure
+  // (the hash map control bytes or the perfect hash pilot), and
+  // PrefetchSlot(key), which should be called once that memory has likely
+  // arrived, requests the element itself (no-op for the hash map backend).
+  // Both are no-ops for the static backend.
+  void Prefetch(view_type_t<Key> key) const {
+    if (compact_ != nullptr) {
+      compact_->Prefetch(key);
+    } else if (dict_ != nullptr) {
+      dict_->prefetch(key);
+    }
+  }
+
+  void PrefetchSlot(view_type_t<Key> key) const {
+    if (compact_ != nullptr) {
+      compact_->PrefetchSlot(key);
+    }
+  }
+
+  // Calls fn(view_type_t<Key> key, int64_t row) for every element, in no
+  // particular order.
+  template <typename Fn>
+  void ForEach(Fn&& fn) const {
+    if (compact_ != nullptr) {
+      for (size_t i = 0; i < compact_->slots.size(); ++i) {
+        const auto& [key, row] = compact_->slots[i];
+        if (compact_->Position(key) == i) {
+          fn(view_type_t<Key>(key), row);
+        }
+      }
+    } else if (dict_ != nullptr) {
+      for (const auto& [key, row] : *dict_) {
+        fn(view_type_t<Key>(key), row);
+      }
+    } else {
+      for (size_t i = 0; i < static_keys_.size(); ++i) {
+        fn(static_keys_[i], static_rows_[i]);
+      }
+    }
+  }
+
  private:
-  // shared_ptr in order to perform fast copying
+  // Perfect hash table, a simplified version of PTHash
+  // (https://arxiv.org/abs/2104.10402). Keys are split into buckets; for every
+  // bucket we find a "pilot" value that maps all its keys to free slots.
+  struct Compact {
+    static constexpr size_t kAverageBucketSize = 2;
+    // Limits on the construction work. With the spare slots below a pilot is
+    // normally found within a few dozens of attempts, so the limits are only
+    // reached for degenerate inputs (e.g. keys with colliding hashes).
+    static constexpr uint32_t kMaxPilotAttempts = 1 << 16;
+    static constexpr int kMaxBuildAttempts = 4;
+
+    // Returns false if failed to find pilots within the limits.
+    bool Build(const Map& dict) {
+      size = dict.size();
+      if (dict.empty()) {
+        return true;
+      }
+      std::vector<std::pair<Key, int64_t>> elements(dict.begin(), dict.end());
+      // Start with ~3% of spare slots and increase it in the (unlikely) case
+      // if we failed to find pilots.
+      size_t spare = size / 32 + 1;
+      for (int attempt = 0; attempt < kMaxBuildAttempts; ++attempt) {
+        if (TryBuild(elements, size + spare)) {
+          return true;
+        }
+        spare *= 2;
+      }
+      return false;
+    }
+
+    OptionalValue<int64_t> Find(view_type_t<Key> key) const {
+      if (slots.empty()) {
+        return std::nullopt;
+      }
+      const auto& [slot_key, row] = slots[Position(key)];
+      if (slot_key == key) {
+        return row;
+      }
+      return std::nullopt;
+    }
+
+    void Prefetch(view_type_t<Key> key) const {
+      if (!pilots.empty()) {
+        absl::PrefetchToLocalCache(
+            &pilots[FastRange(absl::HashOf(key), pilots.size())]);
+      }
+    }
+
+    void PrefetchSlot(view_type_t<Key> key) const {
+      if (!slots.empty()) {
+        absl::PrefetchToLocalCache(&slots[Position(key)]);
+      }
+    }
+
+    size_t Position(view_type_t<Key> key) const {
+      uint64_t hash = absl::HashOf(key);
+      return Position(hash, pilots[FastRange(hash, pilots.size())]);
+    }
+
+    size_t size = 0;
+    std::vector<uint32_t> pilots;
+    // Unused slots contain a copy of some used one; since a key has only one
+    // possible position in the table, it never causes false positives.
+    std::vector<std::pair<Key, int64_t>> slots;
+
+   private:
+    // Maps `x` to [0, n) uniformly.
+    static size_t FastRange(uint64_t x, size_t n) {
+      return absl::Uint128High64(absl::uint128(x) * n);
+    }
+
+    size_t Position(uint64_t hash, uint32_t pilot) const {
+      // Mixing function from splitmix64.
+      uint64_t x = hash ^ (uint64_t{pilot} * 0x9e3779b97f4a7c15);
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+      return FastRange(x ^ (x >> 31), slots.size());
+    }
+
+    bool TryBuild(const std::vector<std::pair<Key, int64_t>>& elements,
+                  size_t num_slots) {
+      size_t num_buckets = std::max<size_t>(1, size / kAverageBucketSize);
+      pilots.assign(num_buckets, 0);
+      slots.assign(num_slots, elements[0]);
+      std::vector<uint64_t> hashes(size);
+      std::vector<size_t> buckets(size);
+      // bucket_begin[b] .. bucket_begin[b + 1] is the range of the bucket `b`
+      // in `order`.
+      std::vector<size_t> bucket_begin(num_buckets + 1);
+      for (size_t i = 0; i < size; ++i) {
+        hashes[i] = absl::HashOf(view_type_t<Key>(elements[i].first));
+        buckets[i] = FastRange(hashes[i], num_buckets);
+        ++bucket_begin[buckets[i] + 1];
+      }
+      size_t max_bucket_size = 0;
+      for (size_t b = 0; b < num_buckets; ++b) {
+        max_bucket_size = std::max(max_bucket_size, bucket_begin[b + 1]);
+        bucket_begin[b + 1] += bucket_begin[b];
+      }
+      std::vector<size_t> order(size);
+      {
+        std::vector<size_t> next(bucket_begin.begin(), bucket_begin.end() - 1);
+        for (size_t i = 0; i < size; ++i) {
+          order[next[buckets[i]]++] = i;
+        }
+      }
+      // Hashes in the bucket order, for better memory locality.
+      std::vector<uint64_t> ordered_hashes(size);
+      for (size_t i = 0; i < size; ++i) {
+        ordered_hashes[i] = hashes[order[i]];
+      }
+      // Larger buckets are processed first.
+      std::vector<std::vector<size_t>> buckets_by_size(max_bucket_size + 1);
+      for (size_t b = 0; b < num_buckets; ++b) {
+        buckets_by_size[bucket_begin[b + 1] - bucket_begin[b]].push_back(b);
+      }
+      std::vector<bool> taken(num_slots);
+      std::vector<size_t> positions;
+      for (size_t bucket_size = max_bucket_size; bucket_size > 0;
+           --bucket_size) {
+        for (size_t bucket : buckets_by_size[bucket_size]) {
+          size_t begin = bucket_begin[bucket];
+          size_t end = begin + bucket_size;
+          for (uint32_t pilot = 0;; ++pilot) {
+            if (pilot == kMaxPilotAttempts) {
+              return false;
+            }
+            positions.clear();
+            for (size_t i = begin; i < end; ++i) {
+              size_t pos = Position(ordered_hashes[i], pilot);
+              if (taken[pos] || std::find(positions.begin(), positions.end(),
+                                          pos) != positions.end()) {
+                break;
+              }
+              positions.push_back(pos);
+            }
+            if (positions.size() == bucket_size) {
+              pilots[bucket] = pilot;
+              for (size_t i = begin; i < end; ++i) {
+                taken[positions[i - begin]] = true;
+                slots[positions[i - begin]] = elements[order[i]];
+              }
+              break;
+            }
+          }
+        }
+      }
+      return true;
+    }
+  };
+
+  // shared_ptr in order to perform fast copying; at most one of the backends
+  // is set.
   std::shared_ptr<const Map> dict_;
+  std::shared_ptr<const Compact> compact_;
+  // Not owned, see CreateStatic.
+  absl::Span<const view_type_t<Key>> static_keys_;
+  const int64_t* static_rows_ = nullptr;
 };
 
 namespace dict_impl {
@@ -141,8 +453,14 @@ struct ReprTraits<KeyToRowDict<Key>,
   ReprToken operator()(const KeyToRowDict<Key>& dict) const {
     std::ostringstream oss;
     oss << "dict{";
-    for (const auto& key : SortedMapKeys(dict.map())) {
-      oss << Repr(Key(key)) << ":" << Repr(dict.map().at(key)) << ",";
+    std::vector<std::pair<view_type_t<Key>, int64_t>> elements;
+    elements.reserve(dict.size());
+    dict.ForEach([&](view_type_t<Key> key, int64_t row) {
+      elements.emplace_back(key, row);
+    });
+    std::sort(elements.begin(), elements.end());
+    for (const auto& [key, row] : elements) {
+      oss << Repr(Key(key)) << ":" << Repr(row) << ",";
     }
     oss << "}";
     return ReprToken{std::move(oss).str()};
@@ -154,8 +472,11 @@ template <class Key>
 struct FingerprintHasherTraits<KeyToRowDict<Key>> {
   void operator()(FingerprintHasher* hasher,
                   const KeyToRowDict<Key>& dict) const {
-    std::vector<std::pair<view_type_t<Key>, int64_t>> elements(
-        dict.map().begin(), dict.map().end());
+    std::vector<std::pair<view_type_t<Key>, int64_t>> elements;
+    elements.reserve(dict.size());
+    dict.ForEach([&](view_type_t<Key> key, int64_t row) {
+      elements.emplace_back(key, row);
+    });
     std::sort(elements.begin(), elements.end());
     hasher->Combine(elements.size());
     for (const auto& [k, v] : elements) {
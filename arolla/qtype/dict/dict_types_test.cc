@@ -15,17 +15,25 @@
 #include "arolla/qtype/dict/dict_types.h"
 
 #include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/optional_value.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/bytes.h"
+#include "arolla/util/fingerprint.h"
 #include "arolla/util/repr.h"
+#include "arolla/util/text.h"
 #include "arolla/util/testing/status_matchers_backport.h"
 #include "arolla/util/unit.h"
 
@@ -119,5 +127,112 @@ TEST(DictTypes, ReprTraits) {
             "dict{b'key':int64{2},}");
 }
 
+TEST(DictTypes, KeyToRowDict) {
+  KeyToRowDict<Bytes> dict{{Bytes("a"), 1}, {Bytes("b"), 0}};
+  EXPECT_FALSE(dict.is_compact());
+  EXPECT_EQ(dict.size(), 2);
+  EXPECT_EQ(dict.Find("a"), OptionalValue<int64_t>(1));
+  EXPECT_EQ(dict.Find("c"), std::nullopt);
+  EXPECT_TRUE(dict.Contains("b"));
+  EXPECT_FALSE(dict.Contains("c"));
+  EXPECT_EQ(KeyToRowDict<Bytes>().size(), 0);
+  EXPECT_EQ(KeyToRowDict<Bytes>().Find("a"), std::nullopt);
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+TEST(DictTypes, KeyToRowDictDeprecatedMap) {
+  KeyToRowDict<Bytes> dict{{Bytes("a"), 1}, {Bytes("b"), 0}};
+  EXPECT_THAT(dict.map(), ::testing::UnorderedElementsAre(
+                              ::testing::Pair(Bytes("a"), 1),
+                              ::testing::Pair(Bytes("b"), 0)));
+  EXPECT_TRUE(KeyToRowDict<Bytes>().map().empty());
+  EXPECT_TRUE(KeyToRowDict<int64_t>::CreateCompact({}).map().empty());
+}
+#pragma GCC diagnostic pop
+
+TEST(DictTypes, CompactKeyToRowDict) {
+  for (int64_t n : {0, 1, 2, 3, 7, 8, 9, 100, 1000}) {
+    SCOPED_TRACE(n);
+    KeyToRowDict<int64_t>::Map map;
+    for (int64_t i = 0; i < n; ++i) {
+      map.emplace(i * 3 - 50, i);
+    }
+    auto dict = KeyToRowDict<int64_t>::CreateCompact(map);
+    EXPECT_TRUE(dict.is_compact());
+    EXPECT_EQ(dict.size(), n);
+    for (int64_t key = -60; key < n * 3; ++key) {
+      if (map.contains(key)) {
+        ASSERT_EQ(dict.Find(key), OptionalValue<int64_t>(map.at(key))) << key;
+      } else {
+        ASSERT_EQ(dict.Find(key), std::nullopt) << key;
+      }
+    }
+    int64_t count = 0;
+    dict.ForEach([&](int64_t key, int64_t row) {
+      ++count;
+      EXPECT_EQ(map.at(key), row);
+    });
+    EXPECT_EQ(count, n);
+    EXPECT_EQ(FingerprintHasher("salt").Combine(dict).Finish(),
+              FingerprintHasher("salt")
+                  .Combine(KeyToRowDict<int64_t>(map))
+                  .Finish());
+  }
+  EXPECT_EQ(Repr(KeyToRowDict<int32_t>::CreateCompact({{5, 1}, {2, 0}})),
+            "dict{2:int64{0},5:int64{1},}");
+  EXPECT_EQ(KeyToRowDict<int32_t>::CreateCompact({}).Find(1), std::nullopt);
+}
+
+TEST(DictTypes, StaticKeyToRowDict) {
+  static constexpr int64_t kKeys[] = {-3, 0, 5, 7};
+  static constexpr int64_t kRows[] = {2, 0, 3, 1};
+  auto dict = KeyToRowDict<int64_t>::CreateStatic(kKeys, kRows);
+  EXPECT_TRUE(dict.is_static());
+  EXPECT_FALSE(dict.is_compact());
+  EXPECT_EQ(dict.size(), 4);
+  EXPECT_EQ(dict.Find(-3), OptionalValue<int64_t>(2));
+  EXPECT_EQ(dict.Find(7), OptionalValue<int64_t>(1));
+  EXPECT_EQ(dict.Find(1), std::nullopt);
+  EXPECT_EQ(dict.Find(8), std::nullopt);
+  EXPECT_EQ(Repr(dict),
+            "dict{int64{-3}:int64{2},int64{0}:int64{0},int64{5}:int64{3},"
+            "int64{7}:int64{1},}");
+  EXPECT_EQ(FingerprintHasher("salt").Combine(dict).Finish(),
+            FingerprintHasher("salt")
+                .Combine(KeyToRowDict<int64_t>{{5, 3}, {-3, 2}, {7, 1}, {0, 0}})
+                .Finish());
+
+  static constexpr absl::string_view kTextKeys[] = {"a", "b", "c"};
+  static constexpr int64_t kTextRows[] = {1, 0, 2};
+  auto text_dict = KeyToRowDict<Text>::CreateStatic(kTextKeys, kTextRows);
+  EXPECT_EQ(text_dict.Find("b"), OptionalValue<int64_t>(0));
+  EXPECT_EQ(text_dict.Find("d"), std::nullopt);
+  EXPECT_EQ(KeyToRowDict<Text>::CreateStatic({}, {}).Find("a"), std::nullopt);
+}
+
+TEST(DictTypes, MemoryUsage) {
+  KeyToRowDict<int64_t>::Map map;
+  for (int64_t i = 0; i < 100; ++i) {
+    map.emplace(i, i);
+  }
+  KeyToRowDict<int64_t> dict(map);
+  EXPECT_GE(dict.memory_usage(), 100 * sizeof(std::pair<int64_t, int64_t>));
+  EXPECT_GE(KeyToRowDict<int64_t>::CreateCompact(map).memory_usage(),
+            100 * sizeof(std::pair<int64_t, int64_t>));
+  EXPECT_EQ(KeyToRowDict<int64_t>().memory_usage(), 0);
+
+  static constexpr int64_t kKeys[] = {-3, 0, 5, 7};
+  static constexpr int64_t kRows[] = {2, 0, 3, 1};
+  EXPECT_EQ(KeyToRowDict<int64_t>::CreateStatic(kKeys, kRows).memory_usage(),
+            0);
+
+  std::string long_key(1000, 'x');
+  KeyToRowDict<Bytes> bytes_dict{{Bytes(long_key), 0}};
+  EXPECT_GE(bytes_dict.memory_usage(), long_key.size());
+  EXPECT_EQ(TypedRef::FromValue(bytes_dict).EstimateMemoryUsage(),
+            sizeof(KeyToRowDict<Bytes>) + bytes_dict.memory_usage());
+}
+
 }  // namespace
 }  // namespace arolla
@@ -0,0 +1,73 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qtype/half/half_types.h"
+
+#include <cstdint>
+
+#include "absl/base/casts.h"
+#include "absl/strings/str_cat.h"
+#include "arolla/array/qtype/types.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/simple_qtype.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/repr.h"
+
+namespace arolla {
+
+void FingerprintHasherTraits<Float16>::operator()(
+    FingerprintHasher* hasher, const Float16& value) const {
+  hasher->Combine(absl::bit_cast<uint16_t>(value));
+}
+
+void FingerprintHasherTraits<BFloat16>::operator()(
+    FingerprintHasher* hasher, const BFloat16& value) const {
+  hasher->Combine(absl::bit_cast<uint16_t>(value));
+}
+
+ReprToken ReprTraits<Float16>::operator()(const Float16& value) const {
+  return ReprToken{absl::StrCat("float16{", static_cast<float>(value), "}")};
+}
+
+ReprToken ReprTraits<BFloat16>::operator()(const BFloat16& value) const {
+  return ReprToken{absl::StrCat("bfloat16{", static_cast<float>(value), "}")};
+}
+
+ReprToken ReprTraits<OptionalValue<Float16>>::operator()(
+    const OptionalValue<Float16>& value) const {
+  return ReprToken{value.present ? absl::StrCat("optional_", Repr(value.value))
+                                 : "optional_float16{NA}"};
+}
+
+ReprToken ReprTraits<OptionalValue<BFloat16>>::operator()(
+    const OptionalValue<BFloat16>& value) const {
+  return ReprToken{value.present ? absl::StrCat("optional_", Repr(value.value))
+                                 : "optional_bfloat16{NA}"};
+}
+
+AROLLA_DEFINE_SIMPLE_QTYPE(FLOAT16, Float16);
+AROLLA_DEFINE_SIMPLE_QTYPE(BFLOAT16, BFloat16);
+
+AROLLA_DEFINE_OPTIONAL_QTYPE(FLOAT16, Float16);
+AROLLA_DEFINE_OPTIONAL_QTYPE(BFLOAT16, BFloat16);
+
+AROLLA_DEFINE_DENSE_ARRAY_QTYPE(FLOAT16, Float16);
+AROLLA_DEFINE_DENSE_ARRAY_QTYPE(BFLOAT16, BFloat16);
+
+AROLLA_DEFINE_ARRAY_QTYPE(FLOAT16, Float16);
+AROLLA_DEFINE_ARRAY_QTYPE(BFLOAT16, BFloat16);
+
+}  // namespace arolla
@@ -0,0 +1,65 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QTYPE_HALF_HALF_TYPES_H_
+#define AROLLA_QTYPE_HALF_HALF_TYPES_H_
+
+// IWYU pragma: always_keep, the file defines QTypeTraits<T> specializations.
+
+#include "Eigen/Core"
+#include "arolla/array/qtype/types.h"  // IWYU pragma: export
+#include "arolla/dense_array/qtype/types.h"  // IWYU pragma: export
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/optional_qtype.h"  // IWYU pragma: export
+#include "arolla/qtype/simple_qtype.h"  // IWYU pragma: export
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/repr.h"
+
+namespace arolla {
+
+// 16-bit floating point types for storing large tables of weights or
+// embeddings with half of the memory footprint of float.
+//
+// The types are meant for storage only: there are no arithmetic operators
+// on them, use half.to_float32 to compute in float and half.to_float16 /
+// half.to_bfloat16 to convert the results back.
+//
+// IEEE 754 binary16: 5 exponent bits, 10 mantissa bits.
+using Float16 = Eigen::half;
+// bfloat16: 8 exponent bits (the same range as float), 7 mantissa bits.
+using BFloat16 = Eigen::bfloat16;
+
+AROLLA_DECLARE_FINGERPRINT_HASHER_TRAITS(Float16);
+AROLLA_DECLARE_FINGERPRINT_HASHER_TRAITS(BFloat16);
+
+AROLLA_DECLARE_REPR(Float16);
+AROLLA_DECLARE_REPR(BFloat16);
+AROLLA_DECLARE_REPR(OptionalValue<Float16>);
+AROLLA_DECLARE_REPR(OptionalValue<BFloat16>);
+
+AROLLA_DECLARE_SIMPLE_QTYPE(FLOAT16, Float16);
+AROLLA_DECLARE_SIMPLE_QTYPE(BFLOAT16, BFloat16);
+
+AROLLA_DECLARE_OPTIONAL_QTYPE(FLOAT16, Float16);
+AROLLA_DECLARE_OPTIONAL_QTYPE(BFLOAT16, BFloat16);
+
+AROLLA_DECLARE_DENSE_ARRAY_QTYPE(FLOAT16, Float16);
+AROLLA_DECLARE_DENSE_ARRAY_QTYPE(BFLOAT16, BFloat16);
+
+AROLLA_DECLARE_ARRAY_QTYPE(FLOAT16, Float16);
+AROLLA_DECLARE_ARRAY_QTYPE(BFLOAT16, BFloat16);
+
+}  // namespace arolla
+
+#endif  // AROLLA_QTYPE_HALF_HALF_TYPES_H_
@@ -0,0 +1,92 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qtype/half/half_types.h"
+
+#include <optional>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "arolla/array/array.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/repr.h"
+
+namespace arolla {
+namespace {
+
+TEST(HalfTypes, QTypes) {
+  EXPECT_EQ(GetQType<Float16>()->name(), "FLOAT16");
+  EXPECT_EQ(GetQType<BFloat16>()->name(), "BFLOAT16");
+  EXPECT_EQ(GetQType<Float16>()->type_layout().AllocSize(), 2);
+  EXPECT_EQ(GetQType<BFloat16>()->type_layout().AllocSize(), 2);
+
+  EXPECT_EQ(GetOptionalQType<Float16>()->name(), "OPTIONAL_FLOAT16");
+  EXPECT_EQ(GetOptionalQType<BFloat16>()->name(), "OPTIONAL_BFLOAT16");
+  EXPECT_TRUE(IsOptionalQType(GetOptionalQType<Float16>()));
+
+  EXPECT_EQ(GetDenseArrayQType<Float16>()->name(), "DENSE_ARRAY_FLOAT16");
+  EXPECT_EQ(GetDenseArrayQType<BFloat16>()->name(), "DENSE_ARRAY_BFLOAT16");
+  EXPECT_EQ(GetArrayQType<Float16>()->name(), "ARRAY_FLOAT16");
+  EXPECT_EQ(GetArrayQType<BFloat16>()->name(), "ARRAY_BFLOAT16");
+  EXPECT_EQ(GetDenseArrayQType<Float16>()->value_qtype(),
+            GetQType<Float16>());
+}
+
+TEST(HalfTypes, Precision) {
+  // float16 has more mantissa bits, bfloat16 has the range of float.
+  EXPECT_EQ(static_cast<float>(Float16(1.001f)), 1.0009765625f);
+  EXPECT_EQ(static_cast<float>(BFloat16(1.001f)), 1.0f);
+  EXPECT_TRUE(Eigen::numext::isinf(Float16(1e6f)));
+  EXPECT_EQ(static_cast<float>(BFloat16(1e6f)), 999424.0f);
+}
+
+TEST(HalfTypes, Repr) {
+  EXPECT_EQ(Repr(Float16(1.5f)), "float16{1.5}");
+  EXPECT_EQ(Repr(BFloat16(-2.0f)), "bfloat16{-2}");
+  EXPECT_EQ(Repr(OptionalValue<Float16>(Float16(0.25f))),
+            "optional_float16{0.25}");
+  EXPECT_EQ(Repr(OptionalValue<BFloat16>()), "optional_bfloat16{NA}");
+}
+
+TEST(HalfTypes, Fingerprint) {
+  auto fingerprint = [](auto value) {
+    return FingerprintHasher("salt").Combine(value).Finish();
+  };
+  EXPECT_EQ(fingerprint(Float16(1.5f)), fingerprint(Float16(1.5f)));
+  EXPECT_NE(fingerprint(Float16(1.5f)), fingerprint(Float16(2.5f)));
+  EXPECT_NE(fingerprint(BFloat16(1.5f)), fingerprint(BFloat16(2.5f)));
+}
+
+TEST(HalfTypes, Arrays) {
+  auto dense_array = CreateDenseArray<Float16>(
+      {Float16(1.0f), std::nullopt, Float16(3.0f)});
+  EXPECT_EQ(dense_array.size(), 3);
+  EXPECT_EQ(dense_array.values.span().size_bytes(), 6);
+  EXPECT_FALSE(dense_array.present(1));
+  EXPECT_EQ(static_cast<float>(dense_array.values[2]), 3.0f);
+
+  Array<BFloat16> array(CreateDenseArray<BFloat16>(
+      {BFloat16(1.0f), std::nullopt, BFloat16(3.0f)}));
+  EXPECT_EQ(array.size(), 3);
+  EXPECT_FALSE(array[1].present);
+  EXPECT_EQ(static_cast<float>(array[2].value), 3.0f);
+}
+
+}  // namespace
+}  // namespace arolla
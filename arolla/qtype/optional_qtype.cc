@@ -14,9 +14,12 @@
 //
 #include "arolla/qtype/optional_qtype.h"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
-#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -42,30 +45,47 @@ class OptionalQTypeMaps {
     absl::MutexLock l(&lock_);
     to_optional_[qtype] = optional_qtype;
     to_optional_[optional_qtype] = optional_qtype;
-    optional_qtypes_.insert(optional_qtype);
+    // Invalidates the per-thread caches, the negative results in particular.
+    generation_.fetch_add(1, std::memory_order_release);
   }
 
-  // Given a qtype, return corresponding optional qtype if it exists.
-  absl::StatusOr<QTypePtr> ToOptionalQType(QTypePtr qtype) {
-    absl::ReaderMutexLock l(&lock_);
-    auto iter = to_optional_.find(qtype);
-    if (iter == to_optional_.end()) {
-      return absl::InvalidArgumentError(
-          absl::StrCat("no optional qtype for ", qtype->name()));
+  // Given a qtype, return corresponding optional qtype if it exists, or
+  // nullptr. The optional qtypes are mapped to themselves.
+  //
+  // The lookups are called very often (e.g. by every IsOptionalQType), so
+  // the calling thread caches the results to avoid contention on `lock_`.
+  const QType* /*nullable*/ LookupOptionalQType(const QType* qtype) {
+    static constexpr size_t kMaxThreadCacheSize = 1024;
+    struct ThreadCache {
+      int64_t generation = -1;
+      absl::flat_hash_map<const QType*, const QType*> to_optional;
+    };
+    thread_local ThreadCache cache;
+    const int64_t generation = generation_.load(std::memory_order_acquire);
+    if (cache.generation != generation ||
+        cache.to_optional.size() >= kMaxThreadCacheSize) {
+      cache.to_optional.clear();
+      cache.generation = generation;
     }
-    return iter->second;
-  }
-
-  // Check whether the given QType is an optional QType.
-  bool IsOptionalQType(QTypePtr qtype) {
-    absl::ReaderMutexLock l(&lock_);
-    return optional_qtypes_.contains(qtype);
+    if (auto it = cache.to_optional.find(qtype);
+        it != cache.to_optional.end()) {
+      return it->second;
+    }
+    const QType* result = nullptr;
+    {
+      absl::ReaderMutexLock l(&lock_);
+      if (auto it = to_optional_.find(qtype); it != to_optional_.end()) {
+        result = it->second;
+      }
+    }
+    cache.to_optional.emplace(qtype, result);
+    return result;
   }
 
  private:
   absl::Mutex lock_;
   absl::flat_hash_map<QTypePtr, QTypePtr> to_optional_ ABSL_GUARDED_BY(lock_);
-  absl::flat_hash_set<QTypePtr> optional_qtypes_ ABSL_GUARDED_BY(lock_);
+  std::atomic<int64_t> generation_ = 0;
 };
 
 OptionalQTypeMaps* GetOptionalQTypeMaps() {
@@ -94,7 +114,12 @@ void RegisterOptionalQType(QTypePtr optional_qtype) {
 }
 
 absl::StatusOr<QTypePtr> ToOptionalQType(QTypePtr qtype) {
-  return GetOptionalQTypeMaps()->ToOptionalQType(qtype);
+  const QType* result = GetOptionalQTypeMaps()->LookupOptionalQType(qtype);
+  if (result == nullptr) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("no optional qtype for ", qtype->name()));
+  }
+  return result;
 }
 
 const QType* /*nullable*/ DecayOptionalQType(const QType* /*nullable*/ qtype) {
@@ -102,7 +127,8 @@ const QType* /*nullable*/ DecayOptionalQType(const QType* /*nullable*/ qtype) {
 }
 
 bool IsOptionalQType(const QType* /*nullable*/ qtype) {
-  return GetOptionalQTypeMaps()->IsOptionalQType(qtype);
+  return qtype != nullptr &&
+         GetOptionalQTypeMaps()->LookupOptionalQType(qtype) == qtype;
 }
 
 absl::StatusOr<FrameLayout::Slot<bool>> GetPresenceSubslotFromOptional(
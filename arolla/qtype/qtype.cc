@@ -41,7 +41,8 @@ QType::QType(ConstructorArgs args)
       type_layout_(std::move(args.type_layout)),
       type_fields_(std::move(args.type_fields)),
       value_qtype_(args.value_qtype),
-      qtype_specialization_key_(std::move(args.qtype_specialization_key)) {}
+      qtype_specialization_key_(std::move(args.qtype_specialization_key)),
+      is_trivially_copyable_(args.is_trivially_copyable) {}
 
 QType::QType(std::string name, const std::type_info& type_info,
              FrameLayout type_layout)
@@ -62,6 +63,19 @@ ReprToken QType::UnsafeReprToken(const void* source) const {
   return ReprToken{absl::StrFormat("<value of %s at %p>", name(), source)};
 }
 
+void QType::UnsafeMove(void* source, void* destination) const {
+  UnsafeCopy(source, destination);
+}
+
+int64_t QType::UnsafeEstimateHeapMemoryUsage(const void* source) const {
+  int64_t result = 0;
+  for (const TypedSlot& field : type_fields_) {
+    result += field.GetType()->UnsafeEstimateHeapMemoryUsage(
+        static_cast<const char*>(source) + field.byte_offset());
+  }
+  return result;
+}
+
 absl::string_view QType::UnsafePyQValueSpecializationKey(
     const void* /*source*/) const {
   return "";
@@ -88,6 +102,7 @@ class QTypeQType final : public QType {
             .name = "QTYPE",
             .type_info = typeid(QTypePtr),
             .type_layout = MakeTypeLayout<QTypePtr>(),
+            .is_trivially_copyable = true,
         }) {}
 
   ReprToken UnsafeReprToken(const void* source) const final {
@@ -15,6 +15,7 @@
 #ifndef AROLLA_QTYPE_QTYPE_H_
 #define AROLLA_QTYPE_QTYPE_H_
 
+#include <cstdint>
 #include <ostream>
 #include <string>
 #include <typeinfo>
@@ -70,6 +71,10 @@ class QType {
   // Returns qtype of values for container types, nullptr otherwise.
   const QType* /*nullable*/ value_qtype() const { return value_qtype_; }
 
+  // Returns true if the values of the type can be copied with memcpy and
+  // require no destruction (i.e. the C++ type is trivially copyable).
+  bool is_trivially_copyable() const { return is_trivially_copyable_; }
+
   // Returns the "official" string representation of an object.
   //
   // It is used e.g. for printing TypedValue objects that contain this QType.
@@ -87,6 +92,16 @@ class QType {
   // otherwise the behaviour is undefined.
   virtual void UnsafeCopy(const void* source, void* destination) const = 0;
 
+  // Move value from source to destination. Both source and destination
+  // must be allocated and initialized with type corresponding to the QType.
+  // After the call, `source` stays initialized, but its value is unspecified.
+  //
+  // The default implementation falls back to UnsafeCopy.
+  //
+  // NOTE: `source` must point to a value compatible with the given qtype;
+  // otherwise the behaviour is undefined.
+  virtual void UnsafeMove(void* source, void* destination) const;
+
   // Combine source value to the hasher state.
   //
   // NOTE: `source` must point to a value compatible with the given qtype;
@@ -94,6 +109,17 @@ class QType {
   virtual void UnsafeCombineToFingerprintHasher(
       const void* source, FingerprintHasher* hasher) const = 0;
 
+  // Returns an estimate of the heap memory owned by the value in addition to
+  // type_layout().AllocSize(), e.g. the buffers of an array (see
+  // arolla/util/memory_usage.h). The memory shared with other values is
+  // counted too.
+  //
+  // The default implementation sums up the estimates of type_fields().
+  //
+  // NOTE: `source` must point to a value compatible with the given qtype;
+  // otherwise the behaviour is undefined.
+  virtual int64_t UnsafeEstimateHeapMemoryUsage(const void* source) const;
+
   // Returns a specialization key for the QType, or an empty string if no
   // specialization is supported.
   //
@@ -139,6 +165,7 @@ class QType {
     const QType* value_qtype = nullptr;  // nullptr for non-containers
     std::string
         qtype_specialization_key;  // qvalue specialization key for *qtype*
+    bool is_trivially_copyable = false;
   };
 
   explicit QType(ConstructorArgs args);
@@ -154,6 +181,7 @@ class QType {
   // For container types, represents the type stored inside container.
   const QType* /*nullable*/ value_qtype_;
   std::string qtype_specialization_key_;
+  bool is_trivially_copyable_;
 };
 
 AROLLA_DECLARE_REPR(QTypePtr);
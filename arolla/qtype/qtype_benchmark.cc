@@ -14,7 +14,9 @@
 //
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 #include "arolla/memory/frame.h"
@@ -23,9 +25,12 @@
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/slice_qtype.h"
+#include "arolla/qtype/tuple_qtype.h"
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/qtype/unspecified_qtype.h"
 #include "arolla/util/bytes.h"
 
 namespace arolla {
@@ -139,5 +144,89 @@ void BM_TypedValueFromRValueLongBytes(benchmark::State& state) {
 
 BENCHMARK(BM_TypedValueFromRValueLongBytes);
 
+template <class T>
+void BM_TypedValueCopy(benchmark::State& state) {
+  auto v = TypedValue::FromValue(T{});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(v);
+    TypedValue x = v;
+    benchmark::DoNotOptimize(x);
+  }
+}
+
+BENCHMARK(BM_TypedValueCopy<int64_t>);
+BENCHMARK(BM_TypedValueCopy<OptionalValue<float>>);
+BENCHMARK(BM_TypedValueCopy<Bytes>);
+
+template <class T>
+void BM_TypedValueFingerprint(benchmark::State& state) {
+  T v{};
+  benchmark::DoNotOptimize(v);
+  for (auto _ : state) {
+    auto x = TypedValue::FromValue(v);
+    benchmark::DoNotOptimize(x.GetFingerprint());
+  }
+}
+
+BENCHMARK(BM_TypedValueFingerprint<int64_t>);
+BENCHMARK(BM_TypedValueFingerprint<OptionalValue<float>>);
+BENCHMARK(BM_TypedValueFingerprint<Bytes>);
+
+// Derived qtype lookups, concurrently from many threads.
+
+void BM_ToOptionalQType(benchmark::State& state) {
+  QTypePtr qtype = GetQType<float>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(qtype);
+    auto x = ToOptionalQType(qtype);
+    benchmark::DoNotOptimize(x);
+  }
+}
+
+void BM_IsOptionalQType(benchmark::State& state) {
+  QTypePtr qtype = GetOptionalQType<float>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(qtype);
+    bool x = IsOptionalQType(qtype);
+    benchmark::DoNotOptimize(x);
+  }
+}
+
+void BM_MakeTupleQType(benchmark::State& state) {
+  const std::vector<QTypePtr> field_qtypes = {
+      GetQType<int32_t>(), GetQType<float>(), GetOptionalQType<Bytes>()};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(field_qtypes);
+    auto x = MakeTupleQType(field_qtypes);
+    benchmark::DoNotOptimize(x);
+  }
+}
+
+void BM_MakeNamedTupleQType(benchmark::State& state) {
+  const std::vector<std::string> field_names = {"a", "b", "c"};
+  QTypePtr tuple_qtype = MakeTupleQType(
+      {GetQType<int32_t>(), GetQType<float>(), GetOptionalQType<Bytes>()});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tuple_qtype);
+    auto x = MakeNamedTupleQType(field_names, tuple_qtype);
+    benchmark::DoNotOptimize(x);
+  }
+}
+
+void BM_MakeSliceQType(benchmark::State& state) {
+  QTypePtr qtype = GetOptionalQType<int64_t>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(qtype);
+    auto x = MakeSliceQType(qtype, qtype, GetUnspecifiedQType());
+    benchmark::DoNotOptimize(x);
+  }
+}
+
+BENCHMARK(BM_ToOptionalQType)->ThreadRange(1, 32);
+BENCHMARK(BM_IsOptionalQType)->ThreadRange(1, 32);
+BENCHMARK(BM_MakeTupleQType)->ThreadRange(1, 32);
+BENCHMARK(BM_MakeNamedTupleQType)->ThreadRange(1, 32);
+BENCHMARK(BM_MakeSliceQType)->ThreadRange(1, 32);
+
 }  // namespace
 }  // namespace arolla
@@ -0,0 +1,61 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qtype/quantized/quantized_types.h"
+
+#include <cstdint>
+
+#include "absl/strings/str_cat.h"
+#include "arolla/array/qtype/types.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/simple_qtype.h"
+#include "arolla/util/repr.h"
+
+namespace arolla {
+
+ReprToken ReprTraits<int8_t>::operator()(const int8_t& value) const {
+  return ReprToken{absl::StrCat("int8{", static_cast<int32_t>(value), "}")};
+}
+
+ReprToken ReprTraits<int16_t>::operator()(const int16_t& value) const {
+  return ReprToken{absl::StrCat("int16{", static_cast<int32_t>(value), "}")};
+}
+
+ReprToken ReprTraits<OptionalValue<int8_t>>::operator()(
+    const OptionalValue<int8_t>& value) const {
+  return ReprToken{value.present ? absl::StrCat("optional_", Repr(value.value))
+                                 : "optional_int8{NA}"};
+}
+
+ReprToken ReprTraits<OptionalValue<int16_t>>::operator()(
+    const OptionalValue<int16_t>& value) const {
+  return ReprToken{value.present ? absl::StrCat("optional_", Repr(value.value))
+                                 : "optional_int16{NA}"};
+}
+
+AROLLA_DEFINE_SIMPLE_QTYPE(INT8, int8_t);
+AROLLA_DEFINE_SIMPLE_QTYPE(INT16, int16_t);
+
+AROLLA_DEFINE_OPTIONAL_QTYPE(INT8, int8_t);
+AROLLA_DEFINE_OPTIONAL_QTYPE(INT16, int16_t);
+
+AROLLA_DEFINE_DENSE_ARRAY_QTYPE(INT8, int8_t);
+AROLLA_DEFINE_DENSE_ARRAY_QTYPE(INT16, int16_t);
+
+AROLLA_DEFINE_ARRAY_QTYPE(INT8, int8_t);
+AROLLA_DEFINE_ARRAY_QTYPE(INT16, int16_t);
+
+}  // namespace arolla
@@ -0,0 +1,57 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QTYPE_QUANTIZED_QUANTIZED_TYPES_H_
+#define AROLLA_QTYPE_QUANTIZED_QUANTIZED_TYPES_H_
+
+// IWYU pragma: always_keep, the file defines QTypeTraits<T> specializations.
+
+#include <cstdint>
+
+#include "arolla/array/qtype/types.h"  // IWYU pragma: export
+#include "arolla/dense_array/qtype/types.h"  // IWYU pragma: export
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/optional_qtype.h"  // IWYU pragma: export
+#include "arolla/qtype/simple_qtype.h"  // IWYU pragma: export
+#include "arolla/util/repr.h"
+
+namespace arolla {
+
+// 8-bit and 16-bit integer types for storing quantized tables of weights or
+// embeddings with a quarter (or a half) of the memory footprint of float.
+//
+// The types are meant for storage only: the quantization parameters (scale
+// and zero point) are passed to the quantized.* operators separately, e.g.
+// quantized.dequantize(x, scale, zero_point) computes
+// (x - zero_point) * scale in FLOAT32.
+AROLLA_DECLARE_REPR(int8_t);
+AROLLA_DECLARE_REPR(int16_t);
+AROLLA_DECLARE_REPR(OptionalValue<int8_t>);
+AROLLA_DECLARE_REPR(OptionalValue<int16_t>);
+
+AROLLA_DECLARE_SIMPLE_QTYPE(INT8, int8_t);
+AROLLA_DECLARE_SIMPLE_QTYPE(INT16, int16_t);
+
+AROLLA_DECLARE_OPTIONAL_QTYPE(INT8, int8_t);
+AROLLA_DECLARE_OPTIONAL_QTYPE(INT16, int16_t);
+
+AROLLA_DECLARE_DENSE_ARRAY_QTYPE(INT8, int8_t);
+AROLLA_DECLARE_DENSE_ARRAY_QTYPE(INT16, int16_t);
+
+AROLLA_DECLARE_ARRAY_QTYPE(INT8, int8_t);
+AROLLA_DECLARE_ARRAY_QTYPE(INT16, int16_t);
+
+}  // namespace arolla
+
+#endif  // AROLLA_QTYPE_QUANTIZED_QUANTIZED_TYPES_H_
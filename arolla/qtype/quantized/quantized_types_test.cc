@@ -0,0 +1,83 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qtype/quantized/quantized_types.h"
+
+#include <cstdint>
+#include <optional>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "arolla/array/array.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/optional_qtype.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/repr.h"
+
+namespace arolla {
+namespace {
+
+TEST(QuantizedTypes, QTypes) {
+  EXPECT_EQ(GetQType<int8_t>()->name(), "INT8");
+  EXPECT_EQ(GetQType<int16_t>()->name(), "INT16");
+  EXPECT_EQ(GetQType<int8_t>()->type_layout().AllocSize(), 1);
+  EXPECT_EQ(GetQType<int16_t>()->type_layout().AllocSize(), 2);
+
+  EXPECT_EQ(GetOptionalQType<int8_t>()->name(), "OPTIONAL_INT8");
+  EXPECT_EQ(GetOptionalQType<int16_t>()->name(), "OPTIONAL_INT16");
+  EXPECT_TRUE(IsOptionalQType(GetOptionalQType<int8_t>()));
+
+  EXPECT_EQ(GetDenseArrayQType<int8_t>()->name(), "DENSE_ARRAY_INT8");
+  EXPECT_EQ(GetDenseArrayQType<int16_t>()->name(), "DENSE_ARRAY_INT16");
+  EXPECT_EQ(GetArrayQType<int8_t>()->name(), "ARRAY_INT8");
+  EXPECT_EQ(GetArrayQType<int16_t>()->name(), "ARRAY_INT16");
+  EXPECT_EQ(GetDenseArrayQType<int8_t>()->value_qtype(), GetQType<int8_t>());
+}
+
+TEST(QuantizedTypes, Repr) {
+  EXPECT_EQ(Repr(int8_t{-5}), "int8{-5}");
+  EXPECT_EQ(Repr(int16_t{1000}), "int16{1000}");
+  EXPECT_EQ(Repr(OptionalValue<int8_t>(int8_t{7})), "optional_int8{7}");
+  EXPECT_EQ(Repr(OptionalValue<int16_t>()), "optional_int16{NA}");
+}
+
+TEST(QuantizedTypes, Fingerprint) {
+  auto fingerprint = [](auto value) {
+    return FingerprintHasher("salt").Combine(value).Finish();
+  };
+  EXPECT_EQ(fingerprint(int8_t{3}), fingerprint(int8_t{3}));
+  EXPECT_NE(fingerprint(int8_t{3}), fingerprint(int8_t{4}));
+  EXPECT_NE(fingerprint(int16_t{3}), fingerprint(int16_t{4}));
+}
+
+TEST(QuantizedTypes, Arrays) {
+  auto dense_array =
+      CreateDenseArray<int8_t>({int8_t{1}, std::nullopt, int8_t{-3}});
+  EXPECT_EQ(dense_array.size(), 3);
+  EXPECT_EQ(sizeof(dense_array.values[0]), 1);
+  EXPECT_FALSE(dense_array.present(1));
+  EXPECT_EQ(dense_array.values[2], -3);
+
+  Array<int16_t> array(
+      CreateDenseArray<int16_t>({int16_t{1}, std::nullopt, int16_t{300}}));
+  EXPECT_EQ(array.size(), 3);
+  EXPECT_FALSE(array[1].present);
+  EXPECT_EQ(array[2].value, 300);
+}
+
+}  // namespace
+}  // namespace arolla
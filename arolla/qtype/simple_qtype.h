@@ -35,6 +35,7 @@
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/indestructible.h"  // IWYU pragma: keep
+#include "arolla/util/memory_usage.h"
 #include "arolla/util/meta.h"
 #include "arolla/util/repr.h"
 #include "arolla/util/struct_field.h"
@@ -59,6 +60,8 @@ namespace arolla {
 //
 //  * arolla::ReprTraits<T> to redefine the default QType::UnsafeReprToken
 //      behavior (see the documentation in qtype.h).
+//  * arolla::MemoryUsageTraits<T> or T::memory_usage method to define
+//      QType::UnsafeEstimateHeapMemoryUsage (see arolla/util/memory_usage.h).
 //  * arolla::StructFieldTraits or T::ArollaStructFields to define
 //      QType::type_fields and NamedFieldQTypeInterface implementation (see
 //      StructFieldTraits documentation).
@@ -78,6 +81,7 @@ class SimpleQType : public QType, public NamedFieldQTypeInterface {
             .type_fields = GenTypeFields<CppType>(),
             .value_qtype = value_qtype,
             .qtype_specialization_key = std::move(qtype_specialization_key),
+            .is_trivially_copyable = std::is_trivially_copyable_v<CppType>,
         }),
         field_names_(GenFieldNames<CppType>()) {
     CHECK_OK(InitNameMap());
@@ -90,10 +94,20 @@ class SimpleQType : public QType, public NamedFieldQTypeInterface {
       *static_cast<CppType*>(destination) =
           *static_cast<const CppType*>(source);
     };
+    unsafe_move_fn_ = [](void* source, void* destination) {
+      *static_cast<CppType*>(destination) =
+          std::move(*static_cast<CppType*>(source));
+    };
     unsafe_combine_to_fingerprint_hasher_fn_ = [](const void* source,
                                                   FingerprintHasher* hasher) {
       hasher->Combine(*static_cast<const CppType*>(source));
     };
+    if constexpr (std::is_invocable_v<MemoryUsageTraits<CppType>, CppType>) {
+      unsafe_estimate_heap_memory_usage_fn_ = [](const void* source) {
+        return static_cast<int64_t>(MemoryUsageTraits<CppType>()(
+            *static_cast<const CppType*>(source)));
+      };
+    }
   }
 
  protected:
@@ -119,11 +133,24 @@ class SimpleQType : public QType, public NamedFieldQTypeInterface {
     }
   }
 
+  void UnsafeMove(void* source, void* destination) const final {
+    if (source != destination) {
+      return unsafe_move_fn_(source, destination);
+    }
+  }
+
   void UnsafeCombineToFingerprintHasher(const void* source,
                                         FingerprintHasher* hasher) const final {
     return unsafe_combine_to_fingerprint_hasher_fn_(source, hasher);
   }
 
+  int64_t UnsafeEstimateHeapMemoryUsage(const void* source) const final {
+    if (unsafe_estimate_heap_memory_usage_fn_) {
+      return unsafe_estimate_heap_memory_usage_fn_(source);
+    }
+    return QType::UnsafeEstimateHeapMemoryUsage(source);
+  }
+
   template <typename CppType>
   ABSL_ATTRIBUTE_ALWAYS_INLINE static std::vector<std::string> GenFieldNames() {
     std::vector<std::string> result;
@@ -152,8 +179,10 @@ class SimpleQType : public QType, public NamedFieldQTypeInterface {
  private:
   using UnsafeReprTokenFn = ReprToken (*)(const void* source);
   using UnsafeCopyFn = void (*)(const void* source, void* destination);
+  using UnsafeMoveFn = void (*)(void* source, void* destination);
   using UnsafeCombineToFingerprintHasherFn =
       void (*)(const void* source, FingerprintHasher* hasher);
+  using UnsafeEstimateHeapMemoryUsageFn = int64_t (*)(const void* source);
   using Name2IdMap = absl::flat_hash_map<std::string, size_t>;
 
   Name2IdMap name2index_;
@@ -163,8 +192,11 @@ class SimpleQType : public QType, public NamedFieldQTypeInterface {
   // unsafe_repr_token_fn_ can not be considered a source of truth.
   UnsafeReprTokenFn unsafe_repr_token_fn_ = nullptr;
   UnsafeCopyFn unsafe_copy_fn_ = nullptr;
+  UnsafeMoveFn unsafe_move_fn_ = nullptr;
   UnsafeCombineToFingerprintHasherFn unsafe_combine_to_fingerprint_hasher_fn_ =
       nullptr;
+  UnsafeEstimateHeapMemoryUsageFn unsafe_estimate_heap_memory_usage_fn_ =
+      nullptr;
 };
 
 // Template for declaring QTypeTraits for simple types.
@@ -14,6 +14,7 @@
 //
 #include "arolla/qtype/slice_qtype.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -67,6 +68,28 @@ class SliceQTypeRegistry {
 
   QTypePtr GetQType(QTypePtr start, QTypePtr stop, QTypePtr step)
       ABSL_LOCKS_EXCLUDED(lock_) {
+    // The qtypes are never removed from the registry, so the calling thread
+    // caches the lookups to avoid contention on `lock_`.
+    thread_local absl::flat_hash_map<RegistryKey, QTypePtr> thread_cache;
+    const RegistryKey key = {start, stop, step};
+    if (const auto it = thread_cache.find(key); it != thread_cache.end()) {
+      return it->second;
+    }
+    QTypePtr result = GetOrCreateQType(start, stop, step);
+    if (thread_cache.size() >= kMaxThreadCacheSize) {
+      thread_cache.clear();
+    }
+    thread_cache.emplace(key, result);
+    return result;
+  }
+
+ private:
+  using RegistryKey = std::tuple<QTypePtr, QTypePtr, QTypePtr>;
+
+  static constexpr size_t kMaxThreadCacheSize = 1024;
+
+  QTypePtr GetOrCreateQType(QTypePtr start, QTypePtr stop, QTypePtr step)
+      ABSL_LOCKS_EXCLUDED(lock_) {
     {  // Fast look-up without memory allocation.
       absl::ReaderMutexLock guard(&lock_);
       if (const auto it = registry_.find({start, stop, step});
@@ -80,9 +103,6 @@ class SliceQTypeRegistry {
         .first->second.get();
   }
 
- private:
-  using RegistryKey = std::tuple<QTypePtr, QTypePtr, QTypePtr>;
-
   absl::Mutex lock_;
   absl::flat_hash_map<RegistryKey, std::unique_ptr<SliceQType>> registry_
       ABSL_GUARDED_BY(lock_);
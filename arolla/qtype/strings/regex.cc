@@ -16,16 +16,21 @@
 
 #include <memory>
 #include <ostream>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/simple_qtype.h"
 #include "arolla/util/fingerprint.h"
 #include "re2/re2.h"
+#include "re2/set.h"
 
 namespace arolla {
 
@@ -61,4 +66,48 @@ void FingerprintHasherTraits<Regex>::operator()(FingerprintHasher* hasher,
 AROLLA_DEFINE_SIMPLE_QTYPE(REGEX, Regex);
 AROLLA_DEFINE_OPTIONAL_QTYPE(REGEX, Regex);
 
+absl::StatusOr<RegexSet> RegexSet::FromPatterns(
+    absl::Span<const absl::string_view> patterns) {
+  if (patterns.empty()) {
+    return RegexSet();
+  }
+  RE2::Options options;
+  options.set_log_errors(false);
+  auto impl = std::make_shared<Impl>(
+      std::vector<std::string>(patterns.begin(), patterns.end()), options);
+  for (absl::string_view pattern : patterns) {
+    std::string error;
+    if (impl->set.Add(pattern, &error) < 0) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Invalid regular expression: \"%s\"; %s.", pattern, error));
+    }
+  }
+  if (!impl->set.Compile()) {
+    return absl::ResourceExhaustedError(absl::StrFormat(
+        "Failed to compile the set of %d regular expressions; the patterns "
+        "are too large.",
+        patterns.size()));
+  }
+  return RegexSet(std::move(impl));
+}
+
+std::ostream& operator<<(std::ostream& stream, const RegexSet& regex_set) {
+  if (regex_set.patterns().empty()) {
+    return stream << "RegexSet{}";
+  }
+  return stream << "RegexSet{\""
+                << absl::StrJoin(regex_set.patterns(), "\", \"") << "\"}";
+}
+
+void FingerprintHasherTraits<RegexSet>::operator()(
+    FingerprintHasher* hasher, const RegexSet& value) const {
+  const auto patterns = value.patterns();
+  hasher->Combine(patterns.size());
+  for (const auto& pattern : patterns) {
+    hasher->Combine(pattern);
+  }
+}
+
+AROLLA_DEFINE_SIMPLE_QTYPE(REGEX_SET, RegexSet);
+
 }  // namespace arolla
@@ -17,16 +17,20 @@
 
 #include <memory>
 #include <ostream>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/simple_qtype.h"
 #include "arolla/util/fingerprint.h"
 #include "re2/re2.h"
+#include "re2/set.h"
 
 namespace arolla {
 
@@ -66,6 +70,49 @@ AROLLA_DECLARE_FINGERPRINT_HASHER_TRAITS(Regex);
 AROLLA_DECLARE_SIMPLE_QTYPE(REGEX, Regex);
 AROLLA_DECLARE_OPTIONAL_QTYPE(REGEX, Regex);
 
+// A compiled set of valid regular expressions, that allows to test a text
+// against all of them in a single pass (see RE2::Set).
+class RegexSet {
+ public:
+  // Default constructor creates an empty set which matches nothing.
+  RegexSet() {}
+
+  // Returns a RegexSet corresponding to `patterns`, or an error if any of
+  // the patterns is not a valid regular expression.
+  static absl::StatusOr<RegexSet> FromPatterns(
+      absl::Span<const absl::string_view> patterns);
+
+  // Returns the patterns of the set.
+  absl::Span<const std::string> patterns() const {
+    return impl_ != nullptr ? absl::Span<const std::string>(impl_->patterns)
+                            : absl::Span<const std::string>();
+  }
+
+  // Returns true if `text` contains a match for any of the patterns.
+  bool PartialMatchAny(absl::string_view text) const {
+    return impl_ != nullptr && impl_->set.Match(text, nullptr);
+  }
+
+ private:
+  struct Impl {
+    Impl(std::vector<std::string> patterns, const RE2::Options& options)
+        : patterns(std::move(patterns)), set(options, RE2::UNANCHORED) {}
+
+    std::vector<std::string> patterns;
+    RE2::Set set;
+  };
+
+  explicit RegexSet(std::shared_ptr<const Impl> impl)
+      : impl_(std::move(impl)) {}
+
+  std::shared_ptr<const Impl> impl_;
+};
+
+std::ostream& operator<<(std::ostream& stream, const RegexSet& regex_set);
+
+AROLLA_DECLARE_FINGERPRINT_HASHER_TRAITS(RegexSet);
+AROLLA_DECLARE_SIMPLE_QTYPE(REGEX_SET, RegexSet);
+
 }  // namespace arolla
 
 #endif  // AROLLA_QTYPE_STRINGS_REGEX_H_
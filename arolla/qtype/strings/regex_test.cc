@@ -23,6 +23,7 @@
 #include "re2/re2.h"
 
 using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 
 namespace arolla {
@@ -54,5 +55,33 @@ TEST(Regex, FromPattern) {
                        HasSubstr("Invalid regular expression: \"ab\\αcd\"; ")));
 }
 
+TEST(RegexSet, DefaultConstructor) {
+  RegexSet regex_set;
+  EXPECT_TRUE(regex_set.patterns().empty());
+  EXPECT_FALSE(regex_set.PartialMatchAny("some string"));
+  EXPECT_FALSE(regex_set.PartialMatchAny(""));
+
+  std::stringstream out;
+  out << regex_set;
+  EXPECT_EQ(out.str(), "RegexSet{}");
+}
+
+TEST(RegexSet, FromPatterns) {
+  ASSERT_OK_AND_ASSIGN(auto regex_set,
+                       RegexSet::FromPatterns({"^\\d+ bottles", "of beer$"}));
+  EXPECT_THAT(regex_set.patterns(),
+              ElementsAre("^\\d+ bottles", "of beer$"));
+  EXPECT_TRUE(regex_set.PartialMatchAny("100 bottles of wine"));
+  EXPECT_TRUE(regex_set.PartialMatchAny("a glass of beer"));
+  EXPECT_FALSE(regex_set.PartialMatchAny("a glass of wine"));
+  std::stringstream out;
+  out << regex_set;
+  EXPECT_EQ(out.str(), "RegexSet{\"^\\d+ bottles\", \"of beer$\"}");
+
+  EXPECT_THAT(RegexSet::FromPatterns({"abc", "ab\\αcd"}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Invalid regular expression: \"ab\\αcd\"; ")));
+}
+
 }  // namespace
 }  // namespace arolla
@@ -119,6 +119,17 @@ class TupleQType final : public QType {
     }
   }
 
+  void UnsafeMove(void* source, void* destination) const override {
+    if (source == destination) {
+      return;
+    }
+    FramePtr source_frame(source, &type_layout());
+    FramePtr destination_frame(destination, &type_layout());
+    for (const auto& field : type_fields()) {
+      field.MoveTo(source_frame, field, destination_frame);
+    }
+  }
+
   void UnsafeCombineToFingerprintHasher(
       const void* source, FingerprintHasher* hasher) const override {
     hasher->Combine(type_fields().size());
@@ -156,6 +167,28 @@ class TupleQTypeRegistry {
 
   QTypePtr GetQType(absl::Span<const QTypePtr> field_qtypes)
       ABSL_LOCKS_EXCLUDED(lock_) {
+    // The qtypes are never removed from the registry, so the calling thread
+    // caches the lookups to avoid contention on `lock_`.
+    thread_local absl::flat_hash_map<absl::Span<const QTypePtr>,
+                                     const TupleQType*>
+        thread_cache;
+    if (const auto it = thread_cache.find(field_qtypes);
+        it != thread_cache.end()) {
+      return it->second;
+    }
+    const TupleQType* result = GetOrCreateQType(field_qtypes);
+    if (thread_cache.size() >= kMaxThreadCacheSize) {
+      thread_cache.clear();
+    }
+    thread_cache.emplace(result->field_qtypes(), result);
+    return result;
+  }
+
+ private:
+  static constexpr size_t kMaxThreadCacheSize = 1024;
+
+  const TupleQType* GetOrCreateQType(absl::Span<const QTypePtr> field_qtypes)
+      ABSL_LOCKS_EXCLUDED(lock_) {
     {  // Fast look-up without memory allocation.
       absl::ReaderMutexLock guard(&lock_);
       if (const auto it = registry_.find(field_qtypes); it != registry_.end()) {
@@ -169,7 +202,6 @@ class TupleQTypeRegistry {
         .first->second.get();
   }
 
- private:
   absl::Mutex lock_;
   // NOTE: The map's keys are owned by the (TupleQType) values.
   absl::flat_hash_map<absl::Span<const QTypePtr>, std::unique_ptr<TupleQType>>
@@ -261,6 +293,31 @@ class NamedTupleQTypeRegistry {
 
   QTypePtr GetQType(absl::Span<const std::string> field_names,
                     QTypePtr tuple_qtype) ABSL_LOCKS_EXCLUDED(lock_) {
+    // The qtypes are never removed from the registry, so the calling thread
+    // caches the lookups to avoid contention on `lock_`.
+    thread_local absl::flat_hash_map<RegistryKey, const NamedTupleQType*>
+        thread_cache;
+    if (const auto it = thread_cache.find({field_names, tuple_qtype});
+        it != thread_cache.end()) {
+      return it->second;
+    }
+    const NamedTupleQType* result = GetOrCreateQType(field_names, tuple_qtype);
+    if (thread_cache.size() >= kMaxThreadCacheSize) {
+      thread_cache.clear();
+    }
+    thread_cache.emplace(RegistryKey{result->GetFieldNames(), tuple_qtype},
+                         result);
+    return result;
+  }
+
+ private:
+  using RegistryKey = std::pair<absl::Span<const std::string>, QTypePtr>;
+
+  static constexpr size_t kMaxThreadCacheSize = 1024;
+
+  const NamedTupleQType* GetOrCreateQType(
+      absl::Span<const std::string> field_names, QTypePtr tuple_qtype)
+      ABSL_LOCKS_EXCLUDED(lock_) {
     {  // Fast look-up without memory allocation.
       absl::ReaderMutexLock guard(&lock_);
       if (const auto it = registry_.find({field_names, tuple_qtype});
@@ -277,9 +334,6 @@ class NamedTupleQTypeRegistry {
         .first->second.get();
   }
 
- private:
-  using RegistryKey = std::pair<absl::Span<const std::string>, QTypePtr>;
-
   absl::Mutex lock_;
   // NOTE: The map's keys are owned by the (NamedTupleQType) values.
   absl::flat_hash_map<RegistryKey, std::unique_ptr<NamedTupleQType>> registry_
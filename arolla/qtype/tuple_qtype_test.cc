@@ -18,6 +18,8 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -25,12 +27,15 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/derived_qtype.h"
 #include "arolla/qtype/named_field_qtype.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_ref.h"
+#include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
 #include "arolla/util/bytes.h"
 #include "arolla/util/testing/repr_token_eq.h"
@@ -43,6 +48,7 @@ namespace {
 using ::arolla::testing::IsOkAndHolds;
 using ::arolla::testing::ReprTokenEq;
 using ::arolla::testing::StatusIs;
+using ::testing::Each;
 using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 using ::testing::HasSubstr;
@@ -106,6 +112,26 @@ TEST(TupleQType, CopyTo) {
   EXPECT_THAT(copy.GenReprToken(), ReprTokenEq("(34, float64{17}, b'Hello')"));
 }
 
+TEST(TupleQType, MoveTo) {
+  auto value =
+      MakeTupleFromFields(int32_t{34}, MakeTupleFromFields(Bytes("Hello")));
+  FrameLayout::Builder layout_builder;
+  TypedSlot source_slot = AddSlot(value.GetType(), &layout_builder);
+  TypedSlot destination_slot = AddSlot(value.GetType(), &layout_builder);
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  ASSERT_OK(value.CopyToSlot(source_slot, frame));
+
+  source_slot.MoveTo(frame, destination_slot, frame);
+  EXPECT_EQ(TypedValue::FromSlot(destination_slot, frame).GetFingerprint(),
+            value.GetFingerprint());
+  // Moving to itself keeps the value.
+  destination_slot.MoveTo(frame, destination_slot, frame);
+  EXPECT_EQ(TypedValue::FromSlot(destination_slot, frame).GetFingerprint(),
+            value.GetFingerprint());
+}
+
 TEST(TupleQType, QValueFromFields) {
   auto qtype = MakeTupleQType({GetQType<int>(), GetQType<float>()});
   {  // From typed_refs.
@@ -138,6 +164,33 @@ TEST(TupleQType, QValueFromFields) {
   }
 }
 
+TEST(TupleQType, ConcurrentLookups) {
+  // Every thread caches the lookups, but the qtypes are still singletons.
+  constexpr int kThreadCount = 8;
+  std::vector<QTypePtr> tuple_qtypes(kThreadCount);
+  std::vector<QTypePtr> named_tuple_qtypes(kThreadCount);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&, i] {
+      for (int j = 0; j < 100; ++j) {
+        tuple_qtypes[i] = MakeTupleQType(
+            {GetQType<int64_t>(), GetQType<Bytes>(), GetQType<double>()});
+        named_tuple_qtypes[i] =
+            MakeNamedTupleQType({"a", "b", "c"}, tuple_qtypes[i]).value();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  QTypePtr tuple_qtype = MakeTupleQType(
+      {GetQType<int64_t>(), GetQType<Bytes>(), GetQType<double>()});
+  EXPECT_THAT(tuple_qtypes, Each(Eq(tuple_qtype)));
+  EXPECT_THAT(named_tuple_qtypes,
+              Each(Eq(MakeNamedTupleQType({"a", "b", "c"}, tuple_qtype)
+                          .value())));
+}
+
 TEST(NamedTupleQType, Empty) {
   auto tuple_qtype = MakeTupleQType({});
   ASSERT_OK_AND_ASSIGN(auto qtype, MakeNamedTupleQType({}, tuple_qtype));
@@ -128,6 +128,14 @@ class TypedRef {
     return type_->UnsafePyQValueSpecializationKey(value_ptr_);
   }
 
+  // Returns an estimate of the memory occupied by the value: its
+  // type_layout() size and the heap memory it owns (see
+  // QType::UnsafeEstimateHeapMemoryUsage).
+  int64_t EstimateMemoryUsage() const {
+    return type_->type_layout().AllocSize() +
+           type_->UnsafeEstimateHeapMemoryUsage(value_ptr_);
+  }
+
  private:
   TypedRef(QTypePtr type, const void* value_ptr)
       : type_(type), value_ptr_(value_ptr) {}
@@ -15,6 +15,7 @@
 #include "arolla/qtype/typed_slot.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <optional>
 #include <string>
 #include <typeinfo>
@@ -124,10 +125,32 @@ std::vector<std::pair<std::string, TypedSlot>> AddNamedSlots(
 absl::flat_hash_map<std::string, TypedSlot> AddSlotsMap(
     const absl::flat_hash_map<std::string, const QType*>& types,
     FrameLayout::Builder* layout_builder) {
+  // Iteration order of `types` is arbitrary, so we order the slots explicitly.
+  // Placing the most aligned slots first avoids padding between them, and
+  // ordering by name keeps the related inputs (e.g. "x0", "x1", ...) next to
+  // each other, which usually matches the order in which the input loaders
+  // write them.
+  std::vector<const std::pair<const std::string, const QType*>*> sorted_types;
+  sorted_types.reserve(types.size());
+  for (const auto& name_type : types) {
+    sorted_types.push_back(&name_type);
+  }
+  std::sort(sorted_types.begin(), sorted_types.end(),
+            [](const auto* a, const auto* b) {
+              size_t a_alignment =
+                  a->second->type_layout().AllocAlignment().value;
+              size_t b_alignment =
+                  b->second->type_layout().AllocAlignment().value;
+              if (a_alignment != b_alignment) {
+                return a_alignment > b_alignment;
+              }
+              return a->first < b->first;
+            });
   absl::flat_hash_map<std::string, TypedSlot> slots;
   slots.reserve(types.size());
-  for (const auto& name_type : types) {
-    slots.insert({name_type.first, AddSlot(name_type.second, layout_builder)});
+  for (const auto* name_type : sorted_types) {
+    slots.insert(
+        {name_type->first, AddSlot(name_type->second, layout_builder)});
   }
   return slots;
 }
@@ -114,6 +114,19 @@ class TypedSlot {
         destination_frame.GetRawPointer(destination_slot.byte_offset_));
   }
 
+  // Moves data to the destination TypedSlot, which must be same type. After
+  // the call the source slot stays initialized, but its value is unspecified.
+  void MoveTo(FramePtr source_frame, TypedSlot destination_slot,
+              FramePtr destination_frame) const {
+    DCHECK_EQ(type_, destination_slot.type_) << "Type mismatch";
+    source_frame.DCheckFieldType(byte_offset_, type_->type_info());
+    destination_frame.DCheckFieldType(destination_slot.byte_offset_,
+                                      destination_slot.type_->type_info());
+    type_->UnsafeMove(
+        source_frame.GetRawPointer(byte_offset_),
+        destination_frame.GetRawPointer(destination_slot.byte_offset_));
+  }
+
   // Resets value referenced by TypedSlot to its initial state.
   void Reset(FramePtr frame) const {
     frame.DCheckFieldType(byte_offset_, type_->type_info());
@@ -200,7 +213,8 @@ std::vector<std::pair<std::string, TypedSlot>> AddNamedSlots(
     absl::Span<const std::pair<std::string, QTypePtr>> types,
     FrameLayout::Builder* layout_builder);
 
-// Adds named slots of the requested types to the memory layout.
+// Adds named slots of the requested types to the memory layout. The slots are
+// placed in a deterministic order: by decreasing alignment, then by name.
 absl::flat_hash_map<std::string, TypedSlot> AddSlotsMap(
     const absl::flat_hash_map<std::string, QTypePtr>& types,
     FrameLayout::Builder* layout_builder);
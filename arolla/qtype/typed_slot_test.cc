@@ -130,6 +130,24 @@ TEST(TypedSlotTest, AddSlotsMap) {
   EXPECT_EQ(i64, slots.at("b").GetType());
 }
 
+TEST(TypedSlotTest, AddSlotsMapLayout) {
+  FrameLayout::Builder layout_builder;
+  const QType* b = GetQType<bool>();
+  const QType* i32 = GetQType<int32_t>();
+  const QType* i64 = GetQType<int64_t>();
+  absl::flat_hash_map<std::string, TypedSlot> slots = AddSlotsMap(
+      {{"x0", b}, {"x1", i64}, {"x2", b}, {"x3", i32}, {"x4", i64}},
+      &layout_builder);
+  // The slots are ordered by decreasing alignment and then by name, so there
+  // is no padding between them.
+  EXPECT_EQ(slots.at("x1").byte_offset(), 0);
+  EXPECT_EQ(slots.at("x4").byte_offset(), 8);
+  EXPECT_EQ(slots.at("x3").byte_offset(), 16);
+  EXPECT_EQ(slots.at("x0").byte_offset(), 20);
+  EXPECT_EQ(slots.at("x2").byte_offset(), 21);
+  EXPECT_EQ(std::move(layout_builder).Build().AllocSize(), 24);
+}
+
 TEST(TypedSlotTest, RegisterUnsafeSlots) {
   FrameLayout::Builder layout_builder;
   layout_builder.AddSlot<int64_t>();
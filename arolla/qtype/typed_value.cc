@@ -69,6 +69,13 @@ void InitCompound(QTypePtr compound_qtype,
   }
 }
 
+Fingerprint GenFingerprint(QTypePtr qtype, const void* data) {
+  FingerprintHasher hasher("TypedValue");
+  hasher.Combine(qtype);
+  qtype->UnsafeCombineToFingerprintHasher(data, &hasher);
+  return std::move(hasher).Finish();
+}
+
 }  // namespace
 
 TypedValue::Impl* TypedValue::AllocRawImpl(QTypePtr qtype) {
@@ -92,6 +99,11 @@ TypedValue::Impl* TypedValue::AllocImpl(QTypePtr qtype, const void* value) {
 }
 
 TypedValue TypedValue::UnsafeFromTypeDefaultConstructed(QTypePtr qtype) {
+  if (IsInlineable(qtype)) {
+    TypedValue result(InlineTag{}, qtype);
+    qtype->type_layout().InitializeAlignedAlloc(result.inline_data_);
+    return result;
+  }
   auto* impl = AllocRawImpl(qtype);
   qtype->type_layout().InitializeAlignedAlloc(impl->data);
   return TypedValue(impl);
@@ -119,14 +131,14 @@ absl::StatusOr<TypedValue> TypedValue::FromFields(
   return TypedValue(impl);
 }
 
-const Fingerprint& TypedValue::GetFingerprint() const {
+Fingerprint TypedValue::GetFingerprint() const {
+  if (is_inline()) {
+    return GenFingerprint(inline_qtype_, inline_data_);
+  }
   // The fingerprint computation is expensive.
   // We compute it only on-demand, and do cache the result.
   absl::call_once(impl_->fingerprint_once, [impl = impl_] {
-    FingerprintHasher hasher("TypedValue");
-    hasher.Combine(impl->qtype);
-    impl->qtype->UnsafeCombineToFingerprintHasher(impl->data, &hasher);
-    impl->fingerprint = std::move(hasher).Finish();
+    impl->fingerprint = GenFingerprint(impl->qtype, impl->data);
   });
   return impl_->fingerprint;
 }
@@ -15,7 +15,9 @@
 #ifndef AROLLA_QTYPE_TYPED_VALUE_H_
 #define AROLLA_QTYPE_TYPED_VALUE_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <new>  // IWYU pragma: keep
 #include <string>
@@ -39,8 +41,21 @@
 
 namespace arolla {
 
+class TypedValueInterner;
+
 // Container for a single immutable value of a given QType. Allows values
 // to be read from and written to TypedSlots generically.
+//
+// Values of trivially copyable types that fit into kInlineSize bytes (e.g.
+// float, int32_t and bool scalars) are stored inline; other values are stored
+// in a heap-allocated reference-counted block shared between the copies.
+//
+// The inline buffer shares the space with the pointer to the heap block, so
+// the inline storage costs one extra pointer (for the qtype of the inline
+// value): sizeof(TypedValue) is 16 bytes instead of 8.
+//
+// NOTE: Because of the inline storage, GetRawPointer(), AsRef() and the other
+// references into the value are invalidated when TypedValue is moved.
 class TypedValue {
  public:
   // Creates a TypedValue containing `value`. Requires that `value`'s
@@ -95,23 +110,34 @@ class TypedValue {
   TypedValue(const TypedValue& rhs) noexcept;
   TypedValue& operator=(const TypedValue& rhs) noexcept;
 
+  // The max size of a value stored inline.
+  static constexpr size_t kInlineSize = 4;
+
   // Returns the type of the stored value.
   QTypePtr GetType() const;
 
   // Returns a pointer to the value stored inside of the instance.
+  //
+  // NOTE: For an inline value the pointer is invalidated by a move.
   const void* GetRawPointer() const ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Returns a typed reference to the value stored within this object.
+  //
+  // NOTE: For an inline value the reference is invalidated by a move.
   TypedRef AsRef() const ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
-  // Returns fingerprint of the stored value.
-  const Fingerprint& GetFingerprint() const ABSL_ATTRIBUTE_LIFETIME_BOUND;
+  // Returns fingerprint of the stored value. The fingerprint of a value stored
+  // out of line is computed on the first call and cached; the fingerprint of
+  // an inline value is cheap and is computed on every call.
+  Fingerprint GetFingerprint() const;
 
   // Returns the number of fields in the type.
   int64_t GetFieldCount() const;
 
   // Returns references to the values from the corresponding to the
   // QType::SubSlot(i)
+  //
+  // NOTE: For an inline value the reference is invalidated by a move.
   TypedRef GetField(int64_t index) const ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Copy of this value into the provided `slot` within `frame`.
@@ -119,12 +145,16 @@ class TypedValue {
 
   // Returns value as given type. Returns an error if type does not match
   // the given type `T` exactly.
+  //
+  // NOTE: For an inline value the reference is invalidated by a move.
   template <typename T>
   absl::StatusOr<std::reference_wrapper<const T>> As() const
       ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Casts the pointer to the given type T. It's safe to use this method only if
   // you have just checked that value's qtype is GetQType<T>().
+  //
+  // NOTE: For an inline value the reference is invalidated by a move.
   template <typename T>
   const T& UnsafeAs() const ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
@@ -140,6 +170,8 @@ class TypedValue {
       ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
  private:
+  static constexpr size_t kInlineAlignment = 4;
+
   struct Impl {
     Refcount refcount;
     absl::once_flag fingerprint_once;
@@ -148,17 +180,64 @@ class TypedValue {
     Fingerprint fingerprint;
   };
 
+  struct InlineTag {};
+
+  template <typename T>
+  static constexpr bool kIsInlineable = std::is_trivially_copyable_v<T> &&
+                                        sizeof(T) <= kInlineSize &&
+                                        alignof(T) <= kInlineAlignment;
+
+  // Returns true if values of the given qtype are stored inline.
+  static bool IsInlineable(QTypePtr qtype) {
+    const auto& type_layout = qtype->type_layout();
+    return qtype->is_trivially_copyable() &&
+           type_layout.AllocSize() <= kInlineSize &&
+           type_layout.AllocAlignment().value <= kInlineAlignment;
+  }
+
   TypedValue(Impl* impl) noexcept : impl_(impl) {}
 
+  // Creates an instance with zero-filled inline storage.
+  TypedValue(InlineTag, QTypePtr qtype) noexcept
+      : inline_data_{}, inline_qtype_(qtype) {}
+
   // Returns a instance with uninitialized data.
   static Impl* AllocRawImpl(QTypePtr qtype);
 
   // Returns a instance with initialized data.
   static Impl* AllocImpl(QTypePtr qtype, const void* value);
 
-  Impl* impl_;
+  bool is_inline() const { return inline_qtype_ != nullptr; }
+
+  // Returns true if the value is stored out of line and this instance holds
+  // the only reference to it.
+  bool is_sole_owner() const {
+    return !is_inline() && impl_ != nullptr && impl_->refcount.IsOne();
+  }
+
+  friend class TypedValueInterner;
+
+  // Swaps the values. The union members are trivially copyable, so the union
+  // is swapped bytewise whichever of them is active.
+  void Swap(TypedValue& other) noexcept {
+    static_assert(kInlineSize <= sizeof(Impl*));
+    char tmp[sizeof(Impl*)];
+    std::memcpy(tmp, &impl_, sizeof(Impl*));
+    std::memcpy(&impl_, &other.impl_, sizeof(Impl*));
+    std::memcpy(&other.impl_, tmp, sizeof(Impl*));
+    std::swap(inline_qtype_, other.inline_qtype_);
+  }
+
+  union {
+    Impl* impl_;
+    alignas(kInlineAlignment) char inline_data_[kInlineSize];
+  };
+  // The type of the inline value, or nullptr if the value is stored in impl_.
+  QTypePtr inline_qtype_ = nullptr;
 };
 
+static_assert(sizeof(TypedValue) == 2 * sizeof(void*));
+
 //
 // Implementations.
 //
@@ -167,8 +246,12 @@ template <typename T>
 TypedValue TypedValue::FromValue(T&& value) {
   using V = std::decay_t<T>;
   static const QTypePtr qtype = GetQType<V>();
-  if constexpr (std::is_copy_constructible_v<V> ||
-                std::is_move_constructible_v<V>) {
+  if constexpr (kIsInlineable<V>) {
+    TypedValue result(InlineTag{}, qtype);
+    new (result.inline_data_) V(std::forward<T>(value));
+    return result;
+  } else if constexpr (std::is_copy_constructible_v<V> ||
+                       std::is_move_constructible_v<V>) {
     // We assume that the copy/move constructor leads to the same state as
     // qtype->UnsafeCopy().
     auto* raw_impl = AllocRawImpl(qtype);
@@ -182,7 +265,11 @@ TypedValue TypedValue::FromValue(T&& value) {
 template <typename T>
 TypedValue TypedValue::FromValue(const T& value) {
   static const QTypePtr qtype = GetQType<T>();
-  if constexpr (std::is_copy_constructible_v<T>) {
+  if constexpr (kIsInlineable<T>) {
+    TypedValue result(InlineTag{}, qtype);
+    new (result.inline_data_) T(value);
+    return result;
+  } else if constexpr (std::is_copy_constructible_v<T>) {
     // We assume that the copy constructor leads to the same state as
     // qtype->UnsafeCopy().
     auto* raw_impl = AllocRawImpl(qtype);
@@ -200,8 +287,12 @@ absl::StatusOr<TypedValue> TypedValue::FromValueWithQType(T&& value,
   if (auto status = VerifyQTypeTypeInfo(qtype, typeid(V)); !status.ok()) {
     return status;
   }
-  if constexpr (std::is_copy_constructible_v<V> ||
-                std::is_move_constructible_v<V>) {
+  if constexpr (kIsInlineable<V>) {
+    TypedValue result(InlineTag{}, qtype);
+    new (result.inline_data_) V(std::forward<T>(value));
+    return result;
+  } else if constexpr (std::is_copy_constructible_v<V> ||
+                       std::is_move_constructible_v<V>) {
     // We assume that the copy/move constructor leads to the same state as
     // qtype->UnsafeCopy().
     auto* raw_impl = AllocRawImpl(qtype);
@@ -218,7 +309,11 @@ absl::StatusOr<TypedValue> TypedValue::FromValueWithQType(const T& value,
   if (auto status = VerifyQTypeTypeInfo(qtype, typeid(T)); !status.ok()) {
     return status;
   }
-  if constexpr (std::is_copy_constructible_v<T>) {
+  if constexpr (kIsInlineable<T>) {
+    TypedValue result(InlineTag{}, qtype);
+    new (result.inline_data_) T(value);
+    return result;
+  } else if constexpr (std::is_copy_constructible_v<T>) {
     // We assume that the copy constructor leads to the same state as
     // qtype->UnsafeCopy().
     auto* raw_impl = AllocRawImpl(qtype);
@@ -233,53 +328,77 @@ inline TypedValue TypedValue::FromSlot(TypedSlot slot, ConstFramePtr frame) {
   return TypedValue(TypedRef::FromSlot(slot, frame));
 }
 
-inline TypedValue::TypedValue(TypedRef value_ref)
-    : impl_(AllocImpl(value_ref.GetType(), value_ref.GetRawPointer())) {}
+inline TypedValue::TypedValue(TypedRef value_ref) {
+  const QTypePtr qtype = value_ref.GetType();
+  if (IsInlineable(qtype)) {
+    std::memset(inline_data_, 0, kInlineSize);
+    std::memcpy(inline_data_, value_ref.GetRawPointer(),
+                qtype->type_layout().AllocSize());
+    inline_qtype_ = qtype;
+  } else {
+    impl_ = AllocImpl(qtype, value_ref.GetRawPointer());
+  }
+}
 
 inline TypedValue::~TypedValue() noexcept {
   // TODO: Investigate the performance implications of using
   // `decrement()` here.
-  if (impl_ != nullptr && !impl_->refcount.skewed_decrement()) {
+  if (!is_inline() && impl_ != nullptr &&
+      !impl_->refcount.skewed_decrement()) {
     impl_->qtype->type_layout().DestroyAlloc(impl_->data);
     impl_->~Impl();
     ::operator delete(impl_);
   }
 }
 
-inline TypedValue::TypedValue(TypedValue&& rhs) noexcept : impl_(rhs.impl_) {
-  rhs.impl_ = nullptr;
+inline TypedValue::TypedValue(TypedValue&& rhs) noexcept
+    : inline_qtype_(rhs.inline_qtype_) {
+  if (is_inline()) {
+    std::memcpy(inline_data_, rhs.inline_data_, kInlineSize);
+  } else {
+    impl_ = rhs.impl_;
+    rhs.impl_ = nullptr;
+  }
 }
 
 inline TypedValue& TypedValue::operator=(TypedValue&& rhs) noexcept {
-  using std::swap;  // go/using-std-swap
-  swap(impl_, rhs.impl_);
+  Swap(rhs);
   return *this;
 }
 
 inline TypedValue::TypedValue(const TypedValue& rhs) noexcept
-    : impl_(rhs.impl_) {
-  if (impl_ != nullptr) {
-    impl_->refcount.increment();
+    : inline_qtype_(rhs.inline_qtype_) {
+  if (is_inline()) {
+    std::memcpy(inline_data_, rhs.inline_data_, kInlineSize);
+  } else {
+    impl_ = rhs.impl_;
+    if (impl_ != nullptr) {
+      impl_->refcount.increment();
+    }
   }
 }
 
 inline TypedValue& TypedValue::operator=(const TypedValue& rhs) noexcept {
-  if (impl_ != rhs.impl_) {
+  if (this != &rhs) {
     *this = TypedValue(rhs);
   }
   return *this;
 }
 
-inline QTypePtr TypedValue::GetType() const { return impl_->qtype; }
+inline QTypePtr TypedValue::GetType() const {
+  return is_inline() ? inline_qtype_ : impl_->qtype;
+}
 
-inline const void* TypedValue::GetRawPointer() const { return impl_->data; }
+inline const void* TypedValue::GetRawPointer() const {
+  return is_inline() ? inline_data_ : impl_->data;
+}
 
 inline TypedRef TypedValue::AsRef() const {
-  return TypedRef::UnsafeFromRawPointer(impl_->qtype, impl_->data);
+  return TypedRef::UnsafeFromRawPointer(GetType(), GetRawPointer());
 }
 
 inline int64_t TypedValue::GetFieldCount() const {
-  return impl_->qtype->type_fields().size();
+  return GetType()->type_fields().size();
 }
 
 inline TypedRef TypedValue::GetField(int64_t index) const {
@@ -0,0 +1,79 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qtype/typed_value_interner.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/util/indestructible.h"
+
+namespace arolla {
+
+TypedValueInterner& TypedValueInterner::GetInstance() {
+  static Indestructible<TypedValueInterner> instance;
+  return *instance;
+}
+
+TypedValue TypedValueInterner::Intern(TypedValue value) {
+  if (value.is_inline()) {
+    return value;
+  }
+  const Fingerprint& fingerprint = value.GetFingerprint();
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = values_.try_emplace(fingerprint, value);
+  if (!inserted) {
+    return it->second;
+  }
+  if (values_.size() >= next_sweep_size_) {
+    SweepLocked();
+  }
+  return value;
+}
+
+bool TypedValueInterner::IsInterned(const TypedValue& value) const {
+  if (value.is_inline()) {
+    return false;
+  }
+  const Fingerprint& fingerprint = value.GetFingerprint();
+  absl::MutexLock lock(&mutex_);
+  auto it = values_.find(fingerprint);
+  return it != values_.end() &&
+         it->second.GetRawPointer() == value.GetRawPointer();
+}
+
+void TypedValueInterner::Sweep() {
+  absl::MutexLock lock(&mutex_);
+  SweepLocked();
+}
+
+void TypedValueInterner::SweepLocked() {
+  // The stored values are copied only under the mutex, so a value owned only
+  // by the registry cannot gain a new owner concurrently.
+  absl::erase_if(values_, [](const auto& entry) {
+    return entry.second.is_sole_owner();
+  });
+  next_sweep_size_ = std::max(kMinSweepSize, 2 * values_.size());
+}
+
+size_t TypedValueInterner::size() const {
+  absl::MutexLock lock(&mutex_);
+  return values_.size();
+}
+
+}  // namespace arolla
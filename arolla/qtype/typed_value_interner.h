@@ -0,0 +1,77 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QTYPE_TYPED_VALUE_INTERNER_H_
+#define AROLLA_QTYPE_TYPED_VALUE_INTERNER_H_
+
+#include <cstddef>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/util/fingerprint.h"
+
+namespace arolla {
+
+// Thread-safe registry that deduplicates equal TypedValues by fingerprint, so
+// e.g. the same vocabularies or decision forests embedded as literals into
+// many models share a single instance.
+//
+// The registry does not extend the values' lifetime indefinitely: a value
+// that is referenced only by the registry is dropped by the next Sweep().
+// Sweep() is also called automatically once the number of the registered
+// values doubles since the previous one, so the cost is amortized over
+// Intern() calls.
+//
+// Values stored inline in TypedValue (see TypedValue::kInlineSize) are
+// returned as is, they are never shared.
+class TypedValueInterner {
+ public:
+  // Returns the process-wide instance.
+  static TypedValueInterner& GetInstance();
+
+  TypedValueInterner() = default;
+
+  // Not copyable or movable.
+  TypedValueInterner(const TypedValueInterner&) = delete;
+  TypedValueInterner& operator=(const TypedValueInterner&) = delete;
+
+  // Returns a registered value with the same fingerprint as `value`, or
+  // registers and returns `value` itself.
+  TypedValue Intern(TypedValue value);
+
+  // Returns true if `value` is the very instance registered for its
+  // fingerprint, i.e. it is shared via the registry.
+  bool IsInterned(const TypedValue& value) const;
+
+  // Drops the values that are not referenced outside of the registry.
+  void Sweep();
+
+  // Returns the number of the registered values.
+  size_t size() const;
+
+ private:
+  static constexpr size_t kMinSweepSize = 1024;
+
+  void SweepLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<Fingerprint, TypedValue> values_ ABSL_GUARDED_BY(mutex_);
+  size_t next_sweep_size_ ABSL_GUARDED_BY(mutex_) = kMinSweepSize;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_QTYPE_TYPED_VALUE_INTERNER_H_
@@ -0,0 +1,87 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qtype/typed_value_interner.h"
+
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "arolla/qtype/base_types.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/util/bytes.h"
+
+namespace arolla {
+namespace {
+
+TEST(TypedValueInternerTest, SharesEqualValues) {
+  TypedValueInterner interner;
+  TypedValue a =
+      interner.Intern(TypedValue::FromValue(Bytes(std::string(100, 'x'))));
+  TypedValue b =
+      interner.Intern(TypedValue::FromValue(Bytes(std::string(100, 'x'))));
+  TypedValue c =
+      interner.Intern(TypedValue::FromValue(Bytes(std::string(100, 'y'))));
+  EXPECT_EQ(a.GetRawPointer(), b.GetRawPointer());
+  EXPECT_NE(a.GetRawPointer(), c.GetRawPointer());
+  EXPECT_EQ(a.UnsafeAs<Bytes>(), std::string(100, 'x'));
+  EXPECT_EQ(c.UnsafeAs<Bytes>(), std::string(100, 'y'));
+  EXPECT_EQ(interner.size(), 2);
+}
+
+TEST(TypedValueInternerTest, IsInterned) {
+  TypedValueInterner interner;
+  TypedValue a =
+      interner.Intern(TypedValue::FromValue(Bytes(std::string(100, 'x'))));
+  EXPECT_TRUE(interner.IsInterned(a));
+  EXPECT_FALSE(
+      interner.IsInterned(TypedValue::FromValue(Bytes(std::string(100, 'x')))));
+  EXPECT_FALSE(
+      interner.IsInterned(TypedValue::FromValue(Bytes(std::string(100, 'y')))));
+  EXPECT_FALSE(interner.IsInterned(TypedValue::FromValue(int32_t{57})));
+}
+
+TEST(TypedValueInternerTest, InlineValues) {
+  TypedValueInterner interner;
+  TypedValue value = interner.Intern(TypedValue::FromValue(int32_t{57}));
+  EXPECT_EQ(value.UnsafeAs<int32_t>(), 57);
+  EXPECT_EQ(interner.size(), 0);
+}
+
+TEST(TypedValueInternerTest, Sweep) {
+  TypedValueInterner interner;
+  TypedValue a = interner.Intern(TypedValue::FromValue(Bytes("a")));
+  { interner.Intern(TypedValue::FromValue(Bytes("b"))); }
+  EXPECT_EQ(interner.size(), 2);
+  interner.Sweep();
+  EXPECT_EQ(interner.size(), 1);
+  TypedValue a2 = interner.Intern(TypedValue::FromValue(Bytes("a")));
+  EXPECT_EQ(a.GetRawPointer(), a2.GetRawPointer());
+}
+
+TEST(TypedValueInternerTest, AutomaticSweep) {
+  TypedValueInterner interner;
+  for (int i = 0; i < 10000; ++i) {
+    interner.Intern(TypedValue::FromValue(Bytes(std::to_string(i))));
+  }
+  EXPECT_LT(interner.size(), 2048);
+}
+
+TEST(TypedValueInternerTest, GetInstance) {
+  EXPECT_EQ(&TypedValueInterner::GetInstance(),
+            &TypedValueInterner::GetInstance());
+}
+
+}  // namespace
+}  // namespace arolla
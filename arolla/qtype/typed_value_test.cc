@@ -26,8 +26,10 @@
 #include "arolla/memory/memory_allocation.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qtype/base_types.h"
+#include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/bytes.h"
 #include "arolla/util/fingerprint.h"
@@ -229,6 +231,75 @@ TEST(TypedValueTest, MoveOperator) {
   EXPECT_EQ(y.GetRawPointer(), x_raw_ptr);
 }
 
+TEST(TypedValueTest, InlineStorage) {
+  TypedValue x = TypedValue::FromValue<int32_t>(1);
+  const char* x_begin = reinterpret_cast<const char*>(&x);
+  const char* x_raw_ptr = static_cast<const char*>(x.GetRawPointer());
+  EXPECT_GE(x_raw_ptr, x_begin);
+  EXPECT_LT(x_raw_ptr, x_begin + sizeof(x));
+
+  TypedValue y = x;
+  EXPECT_NE(y.GetRawPointer(), x.GetRawPointer());
+  EXPECT_THAT(y.As<int32_t>(), IsOkAndHolds(1));
+  EXPECT_EQ(y.GetFingerprint(), x.GetFingerprint());
+
+  TypedValue z = std::move(y);
+  EXPECT_THAT(z.As<int32_t>(), IsOkAndHolds(1));
+  EXPECT_EQ(z.GetFingerprint(), x.GetFingerprint());
+}
+
+TEST(TypedValueTest, NoInlineStorageForLargeValues) {
+  for (const auto& x : {TypedValue::FromValue<int64_t>(1),
+                        TypedValue::FromValue(OptionalValue<float>(1.0f))}) {
+    TypedValue y = x;
+    EXPECT_EQ(y.GetRawPointer(), x.GetRawPointer());
+  }
+}
+
+TEST(TypedValueTest, InlineStorageAssignment) {
+  TypedValue x = TypedValue::FromValue(1.0f);
+  TypedValue y = TypedValue::FromValue(OptionalValue<bool>(true));
+  TypedValue y_copy = y;
+  EXPECT_NE(y.GetFingerprint(), x.GetFingerprint());
+  y = x;
+  EXPECT_THAT(y.As<float>(), IsOkAndHolds(1.0f));
+  EXPECT_EQ(y.GetFingerprint(), x.GetFingerprint());
+  y = std::move(y_copy);
+  ASSERT_OK_AND_ASSIGN(OptionalValue<bool> y_optional,
+                       y.As<OptionalValue<bool>>());
+  EXPECT_EQ(y_optional, OptionalValue<bool>(true));
+  y = TypedValue::FromValue(Bytes("bytes"));
+  ASSERT_OK_AND_ASSIGN(Bytes y_bytes, y.As<Bytes>());
+  EXPECT_EQ(y_bytes, Bytes("bytes"));
+  y = TypedValue::FromValue(2.0f);
+  EXPECT_THAT(y.As<float>(), IsOkAndHolds(2.0f));
+}
+
+TEST(TypedValueTest, MoveOperatorSelfAssignment) {
+  for (auto x :
+       {TypedValue::FromValue(1.0f), TypedValue::FromValue(Bytes("1"))}) {
+    TypedValue expected = x;
+    auto& x_ref = x;  // Avoids -Wself-move.
+    x = std::move(x_ref);
+    EXPECT_EQ(x.GetType(), expected.GetType());
+    EXPECT_EQ(x.GetFingerprint(), expected.GetFingerprint());
+  }
+}
+
+TEST(TypedValueTest, InlineStorageFromRef) {
+  OptionalValue<bool> value(true);
+  TypedValue x(TypedRef::FromValue(value));
+  ASSERT_OK_AND_ASSIGN(OptionalValue<bool> x_value,
+                       x.As<OptionalValue<bool>>());
+  EXPECT_EQ(x_value, value);
+  EXPECT_EQ(x.GetFingerprint(), TypedValue::FromValue(value).GetFingerprint());
+  auto y = TypedValue::UnsafeFromTypeDefaultConstructed(
+      GetOptionalQType<bool>());
+  ASSERT_OK_AND_ASSIGN(OptionalValue<bool> y_value,
+                       y.As<OptionalValue<bool>>());
+  EXPECT_EQ(y_value, OptionalValue<bool>());
+}
+
 TEST(TypedValueTest, CopyFromValue) {
   const Bytes bytes("data");
   TypedValue x = TypedValue::FromValue(bytes);
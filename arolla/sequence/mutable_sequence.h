@@ -71,6 +71,11 @@ class MutableSequence {
   // Stores a new element value.
   void UnsafeSetRef(size_t i, TypedRef value);
 
+  // Moves a new element value from `source`, which must point to an
+  // initialized value of value_qtype(). The value left in `source` is
+  // unspecified.
+  void UnsafeMoveFromRawPointer(size_t i, void* source);
+
   // Returns an immutable sequence instance.
   [[nodiscard]] Sequence Finish() &&;
 
@@ -120,6 +125,13 @@ inline void MutableSequence::UnsafeSetRef(size_t i, TypedRef value) {
                            data + i * value_qtype_->type_layout().AllocSize());
 }
 
+inline void MutableSequence::UnsafeMoveFromRawPointer(size_t i, void* source) {
+  DCHECK_LT(i, size_) << "index is out of range: " << i << " >= size=" << size_;
+  char* const data = reinterpret_cast<char*>(data_.get());
+  value_qtype_->UnsafeMove(source,
+                           data + i * value_qtype_->type_layout().AllocSize());
+}
+
 inline Sequence MutableSequence::Finish() && {
   return Sequence(value_qtype_, size_, std::move(data_));
 }
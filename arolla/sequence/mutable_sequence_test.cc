@@ -20,6 +20,7 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "arolla/qtype/base_types.h"
@@ -98,6 +99,19 @@ TEST_F(MutableSequenceTest, SetRef) {
   }
 }
 
+TEST_F(MutableSequenceTest, MoveFromRawPointer) {
+  ASSERT_OK_AND_ASSIGN(auto seq, MutableSequence::Make(GetQType<Bytes>(), 3));
+  for (int i = 0; i < 3; ++i) {
+    Bytes value(absl::StrCat("a long enough value to be heap allocated #", i));
+    seq.UnsafeMoveFromRawPointer(i, &value);
+  }
+  EXPECT_THAT(seq.UnsafeSpan<Bytes>(),
+              ::testing::ElementsAre(
+                  "a long enough value to be heap allocated #0",
+                  "a long enough value to be heap allocated #1",
+                  "a long enough value to be heap allocated #2"));
+}
+
 TEST_F(MutableSequenceTest, Finish) {
   ASSERT_OK_AND_ASSIGN(auto seq,
                        MutableSequence::Make(GetQType<int32_t>(), 100));
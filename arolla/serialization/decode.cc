@@ -16,6 +16,7 @@
 
 #include <string>
 #include <utility>
+#include <variant>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
@@ -24,10 +25,13 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "google/protobuf/io/zero_copy_stream.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/qtype/typed_value.h"
 #include "arolla/serialization_base/base.pb.h"
 #include "arolla/serialization_base/decode.h"
+#include "arolla/serialization_base/payload.h"
 #include "arolla/util/indestructible.h"
 #include "arolla/util/status_macros_backport.h"
 
@@ -35,7 +39,11 @@ namespace arolla::serialization {
 namespace {
 
 using ::arolla::serialization_base::ContainerProto;
+using ::arolla::serialization_base::PayloadSection;
+using ::arolla::serialization_base::PayloadValueDecoder;
 using ::arolla::serialization_base::ValueDecoder;
+using ::arolla::serialization_base::ValueDecoderProvider;
+using ::arolla::serialization_base::ValueProto;
 
 // The global registry of value decoders.
 class ValueDecoderRegistry {
@@ -55,21 +63,53 @@ class ValueDecoderRegistry {
     return absl::OkStatus();
   }
 
-  ValueDecoder LookupValueDecoder(absl::string_view codec_name) {
+  absl::Status RegisterPayloadValueDecoder(absl::string_view codec_name,
+                                           PayloadValueDecoder value_decoder) {
+    if (value_decoder == nullptr) {
+      return absl::InvalidArgumentError("value_decoder is empty");
+    }
+    absl::MutexLock lock(&mutex_);
+    registry_[codec_name] = std::move(value_decoder);
+    return absl::OkStatus();
+  }
+
+  // Returns the value decoder for the codec, with `payload_section` bound to
+  // it if it is a PayloadValueDecoder.
+  ValueDecoder LookupValueDecoder(absl::string_view codec_name,
+                                  const PayloadSection* payload_section) {
     absl::MutexLock lock(&mutex_);
     auto it = registry_.find(codec_name);
     if (it == registry_.end()) {
       return nullptr;
     }
-    return it->second;
+    if (const auto* value_decoder = std::get_if<ValueDecoder>(&it->second)) {
+      return *value_decoder;
+    }
+    return [value_decoder = std::get<PayloadValueDecoder>(it->second),
+            payload_section](
+               const ValueProto& value_proto,
+               absl::Span<const TypedValue> input_values,
+               absl::Span<const expr::ExprNodePtr> input_exprs) {
+      return value_decoder(value_proto, input_values, input_exprs,
+                           payload_section);
+    };
   }
 
  private:
   absl::Mutex mutex_;
-  absl::flat_hash_map<std::string, ValueDecoder> registry_
-      ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string,
+                      std::variant<ValueDecoder, PayloadValueDecoder>>
+      registry_ ABSL_GUARDED_BY(mutex_);
 };
 
+ValueDecoderProvider GetValueDecoderProvider(const DecodingOptions& options) {
+  return [payload_section = options.payload_section](
+             absl::string_view codec_name) {
+    return ValueDecoderRegistry::instance().LookupValueDecoder(
+        codec_name, payload_section);
+  };
+}
+
 }  // namespace
 
 absl::Status RegisterValueDecoder(absl::string_view codec_name,
@@ -78,14 +118,23 @@ absl::Status RegisterValueDecoder(absl::string_view codec_name,
       codec_name, std::move(value_decoder));
 }
 
+absl::Status RegisterPayloadValueDecoder(absl::string_view codec_name,
+                                         PayloadValueDecoder value_decoder) {
+  return ValueDecoderRegistry::instance().RegisterPayloadValueDecoder(
+      codec_name, std::move(value_decoder));
+}
+
 absl::StatusOr<DecodeResult> Decode(const ContainerProto& container_proto,
                                     const DecodingOptions& options) {
   return arolla::serialization_base::Decode(
-      container_proto,
-      [](absl::string_view codec_name) {
-        return ValueDecoderRegistry::instance().LookupValueDecoder(codec_name);
-      },
-      options);
+      container_proto, GetValueDecoderProvider(options), options);
+}
+
+absl::StatusOr<DecodeResult> DecodeFromStream(
+    google::protobuf::io::ZeroCopyInputStream* input,
+    const DecodingOptions& options) {
+  return arolla::serialization_base::DecodeFromStream(
+      input, GetValueDecoderProvider(options), options);
 }
 
 absl::StatusOr<expr::ExprNodePtr> DecodeExpr(
@@ -18,6 +18,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "google/protobuf/io/zero_copy_stream.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/qtype/typed_value.h"
 #include "arolla/serialization_base/base.pb.h"
@@ -34,6 +35,13 @@ absl::StatusOr<DecodeResult> Decode(
     const arolla::serialization_base::ContainerProto& container_proto,
     const DecodingOptions& options = {});
 
+// Decodes values and expressions from a serialized ContainerProto read from
+// `input` using all value decoders from the global registry. See
+// serialization_base::DecodeFromStream() for details.
+absl::StatusOr<DecodeResult> DecodeFromStream(
+    google::protobuf::io::ZeroCopyInputStream* input,
+    const DecodingOptions& options = {});
+
 // Decodes an expression from the container, returns an error if there is not
 // just one expression.
 absl::StatusOr<arolla::expr::ExprNodePtr> DecodeExpr(
@@ -51,6 +59,12 @@ absl::Status RegisterValueDecoder(
     absl::string_view codec_name,
     arolla::serialization_base::ValueDecoder value_decoder);
 
+// Add a value decoder resolving PayloadRefProto references to the global
+// registry. It gets DecodingOptions::payload_section of the Decode() call.
+absl::Status RegisterPayloadValueDecoder(
+    absl::string_view codec_name,
+    arolla::serialization_base::PayloadValueDecoder value_decoder);
+
 }  // namespace arolla::serialization
 
 #endif  // AROLLA_SERIALIZATION_DECODE_H_
@@ -36,6 +36,7 @@
 #include "arolla/serialization_base/encode.h"
 #include "arolla/util/indestructible.h"
 #include "arolla/util/status_macros_backport.h"
+#include "google/protobuf/io/zero_copy_stream.h"
 
 namespace arolla::serialization {
 namespace {
@@ -168,11 +169,27 @@ class ValueEncoderRegistry {
 
 absl::StatusOr<ContainerProto> Encode(
     absl::Span<const TypedValue> values,
-    absl::Span<const expr::ExprNodePtr> exprs) {
+    absl::Span<const expr::ExprNodePtr> exprs,
+    const EncodingOptions& options) {
   return arolla::serialization_base::Encode(
-      values, exprs, [](TypedRef value, Encoder& encoder) {
+      values, exprs,
+      [](TypedRef value, Encoder& encoder) {
         return ValueEncoderRegistry::instance().EncodeValue(value, encoder);
-      });
+      },
+      options);
+}
+
+absl::Status EncodeToStream(
+    absl::Span<const TypedValue> values,
+    absl::Span<const expr::ExprNodePtr> exprs,
+    google::protobuf::io::ZeroCopyOutputStream* output,
+    const EncodingOptions& options) {
+  return arolla::serialization_base::EncodeToStream(
+      values, exprs,
+      [](TypedRef value, Encoder& encoder) {
+        return ValueEncoderRegistry::instance().EncodeValue(value, encoder);
+      },
+      output, options);
 }
 
 absl::Status RegisterValueEncoderByQType(QTypePtr qtype,
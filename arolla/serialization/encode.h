@@ -24,13 +24,25 @@
 #include "arolla/qtype/typed_value.h"
 #include "arolla/serialization_base/base.pb.h"
 #include "arolla/serialization_base/encode.h"
+#include "google/protobuf/io/zero_copy_stream.h"
 
 namespace arolla::serialization {
 
+using ::arolla::serialization_base::EncodingOptions;
+
 // Encodes the given values and expressions using all known codecs.
 absl::StatusOr<arolla::serialization_base::ContainerProto> Encode(
     absl::Span<const TypedValue> values,
-    absl::Span<const expr::ExprNodePtr> exprs);
+    absl::Span<const expr::ExprNodePtr> exprs,
+    const EncodingOptions& options = {});
+
+// Encodes the given values and expressions using all known codecs and writes
+// the serialized ContainerProto to `output` incrementally. See
+// serialization_base::EncodeToStream() for details.
+absl::Status EncodeToStream(absl::Span<const TypedValue> values,
+                            absl::Span<const expr::ExprNodePtr> exprs,
+                            google::protobuf::io::ZeroCopyOutputStream* output,
+                            const EncodingOptions& options = {});
 
 // The dispatching algorithm for the value encoders:
 //
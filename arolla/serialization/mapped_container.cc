@@ -0,0 +1,232 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/serialization/mapped_container.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/serialization/decode.h"
+#include "arolla/serialization_base/base.pb.h"
+#include "arolla/serialization_base/payload.h"
+
+namespace arolla::serialization {
+namespace {
+
+using ::arolla::serialization_base::ContainerProto;
+using ::arolla::serialization_base::PayloadRefProto;
+using ::arolla::serialization_base::PayloadSection;
+using ::google::protobuf::FieldDescriptor;
+using ::google::protobuf::Message;
+using ::google::protobuf::Reflection;
+
+constexpr absl::string_view kMagic = "AROLLAMC";
+constexpr int64_t kHeaderSize = kMagic.size() + 3 * sizeof(uint64_t);
+// Alignment of the payload section within the file.
+constexpr int64_t kPageSize = 4096;
+// Alignment of the individual payloads within the payload section; enough for
+// any of the value types and for cache lines.
+constexpr int64_t kPayloadAlignment = 64;
+
+int64_t RoundUp(int64_t value, int64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+void AppendUInt64(uint64_t value, std::string& out) {
+  for (size_t i = 0; i < sizeof(value); ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+uint64_t ReadUInt64(const char* data) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < sizeof(result); ++i) {
+    result |= uint64_t{static_cast<unsigned char>(data[i])} << (8 * i);
+  }
+  return result;
+}
+
+// Moves large bytes fields of a message tree into the payload section.
+class PayloadWriter {
+ public:
+  explicit PayloadWriter(int64_t min_payload_size)
+      : min_payload_size_(min_payload_size) {}
+
+  void Process(Message& message) {
+    const Reflection* reflection = message.GetReflection();
+    std::vector<const FieldDescriptor*> fields;
+    // Includes the extensions, which is where the codecs store their data.
+    reflection->ListFields(message, &fields);
+    for (const FieldDescriptor* field : fields) {
+      if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+        if (field->is_repeated()) {
+          for (int i = 0; i < reflection->FieldSize(message, field); ++i) {
+            Process(*reflection->MutableRepeatedMessage(&message, field, i));
+          }
+        } else {
+          Process(*reflection->MutableMessage(&message, field));
+        }
+      } else if (field->type() == FieldDescriptor::TYPE_BYTES &&
+                 !field->is_repeated() && !field->is_extension()) {
+        MaybeMoveToPayload(message, field);
+      }
+    }
+  }
+
+  std::string& payload() { return payload_; }
+
+ private:
+  void MaybeMoveToPayload(Message& message, const FieldDescriptor* field) {
+    const FieldDescriptor* ref_field =
+        field->containing_type()->FindFieldByName(
+            absl::StrCat(field->name(), "_ref"));
+    if (ref_field == nullptr || ref_field->is_repeated() ||
+        ref_field->message_type() != PayloadRefProto::descriptor()) {
+      return;
+    }
+    const Reflection* reflection = message.GetReflection();
+    std::string scratch;
+    const std::string& value =
+        reflection->GetStringReference(message, field, &scratch);
+    if (static_cast<int64_t>(value.size()) < min_payload_size_) {
+      return;
+    }
+    payload_.resize(RoundUp(payload_.size(), kPayloadAlignment), '\0');
+    PayloadRefProto ref;
+    ref.set_offset(payload_.size());
+    ref.set_size(value.size());
+    payload_.append(value);
+    reflection->MutableMessage(&message, ref_field)->CopyFrom(ref);
+    reflection->ClearField(&message, field);
+  }
+
+  int64_t min_payload_size_;
+  std::string payload_;
+};
+
+}  // namespace
+
+absl::StatusOr<std::string> EncodeMappedContainer(
+    ContainerProto container_proto, int64_t min_payload_size) {
+  PayloadWriter payload_writer(min_payload_size);
+  payload_writer.Process(container_proto);
+  std::string serialized_proto;
+  if (!container_proto.SerializeToString(&serialized_proto)) {
+    return absl::InvalidArgumentError("failed to serialize ContainerProto");
+  }
+  const std::string& payload = payload_writer.payload();
+  const int64_t payload_offset =
+      RoundUp(kHeaderSize + serialized_proto.size(), kPageSize);
+  std::string result;
+  result.reserve(payload_offset + payload.size());
+  result.append(kMagic.data(), kMagic.size());
+  AppendUInt64(serialized_proto.size(), result);
+  AppendUInt64(payload_offset, result);
+  AppendUInt64(payload.size(), result);
+  result.append(serialized_proto);
+  result.resize(payload_offset, '\0');
+  result.append(payload);
+  return result;
+}
+
+absl::StatusOr<MappedContainer> ParseMappedContainer(RawBufferPtr owner,
+                                                     absl::string_view data) {
+  if (static_cast<int64_t>(data.size()) < kHeaderSize ||
+      !absl::StartsWith(data, kMagic)) {
+    return absl::InvalidArgumentError("not a mapped container");
+  }
+  const uint64_t proto_size = ReadUInt64(data.data() + kMagic.size());
+  const uint64_t payload_offset =
+      ReadUInt64(data.data() + kMagic.size() + sizeof(uint64_t));
+  const uint64_t payload_size =
+      ReadUInt64(data.data() + kMagic.size() + 2 * sizeof(uint64_t));
+  if (proto_size > data.size() - kHeaderSize ||
+      payload_offset < kHeaderSize + proto_size ||
+      payload_offset > data.size() ||
+      payload_size > data.size() - payload_offset) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "corrupted mapped container: proto size %d, payload [%d, %d), file "
+        "size %d",
+        proto_size, payload_offset, payload_offset + payload_size,
+        data.size()));
+  }
+  MappedContainer result;
+  if (!result.container_proto.ParseFromArray(data.data() + kHeaderSize,
+                                             proto_size)) {
+    return absl::InvalidArgumentError(
+        "corrupted mapped container: unable to parse ContainerProto");
+  }
+  result.payload_section = PayloadSection{
+      std::move(owner), data.substr(payload_offset, payload_size)};
+  return result;
+}
+
+absl::StatusOr<MappedContainer> MapContainerFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("unable to open ", path));
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    int error = errno;
+    close(fd);
+    return absl::ErrnoToStatus(error, absl::StrCat("unable to stat ", path));
+  }
+  const size_t size = file_stat.st_size;
+  if (size < kHeaderSize) {
+    close(fd);
+    return absl::InvalidArgumentError(
+        absl::StrCat("not a mapped container: ", path));
+  }
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  int error = errno;
+  // The mapping stays valid after closing the file.
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return absl::ErrnoToStatus(error, absl::StrCat("unable to mmap ", path));
+  }
+  RawBufferPtr mapping(addr, [size](const void* addr) {
+    munmap(const_cast<void*>(addr), size);
+  });
+  return ParseMappedContainer(
+      std::move(mapping),
+      absl::string_view(static_cast<const char*>(addr), size));
+}
+
+absl::StatusOr<DecodeResult> DecodeMappedContainer(
+    const MappedContainer& container, DecodingOptions options) {
+  options.payload_section = &container.payload_section;
+  return Decode(container.container_proto, options);
+}
+
+}  // namespace arolla::serialization
@@ -0,0 +1,76 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_SERIALIZATION_MAPPED_CONTAINER_H_
+#define AROLLA_SERIALIZATION_MAPPED_CONTAINER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/serialization/decode.h"
+#include "arolla/serialization_base/base.pb.h"
+#include "arolla/serialization_base/payload.h"
+
+namespace arolla::serialization {
+
+// Mapped container is a file format for ContainerProto designed to be loaded
+// using mmap. Large payloads (see PayloadRefProto) are stored in
+// a page-aligned section after the proto, so that the decoded values can refer
+// to the mapped memory directly instead of copying it. The pages are loaded
+// lazily and are shared between the processes mapping the same file.
+//
+// Layout:
+//   [magic][proto size][payload offset][payload size]  -- little-endian uint64
+//   [serialized ContainerProto]
+//   [padding up to the page boundary]
+//   [payload section]
+
+// Bytes fields smaller than this are kept within the proto.
+constexpr int64_t kMappedContainerMinPayloadSize = 4096;
+
+// Serializes the container into the mapped container format. Moves bytes
+// fields of at least `min_payload_size` bytes that have a `<name>_ref`
+// PayloadRefProto counterpart into the payload section. E.g. DenseArrays have
+// such fields only if encoded with EncodingOptions::dense_array_raw_values.
+absl::StatusOr<std::string> EncodeMappedContainer(
+    arolla::serialization_base::ContainerProto container_proto,
+    int64_t min_payload_size = kMappedContainerMinPayloadSize);
+
+// Mapped container, ready for decoding.
+struct MappedContainer {
+  arolla::serialization_base::ContainerProto container_proto;
+  // Payload section referencing the mapped memory and keeping it alive.
+  arolla::serialization_base::PayloadSection payload_section;
+};
+
+// Parses a mapped container stored in `data`. The payload section refers
+// to `data` and shares ownership with `owner`.
+absl::StatusOr<MappedContainer> ParseMappedContainer(RawBufferPtr owner,
+                                                     absl::string_view data);
+
+// Maps the file into memory (read-only) and parses it. The mapping is kept
+// alive while the container or any of the values decoded from it exist.
+absl::StatusOr<MappedContainer> MapContainerFile(const std::string& path);
+
+// Decodes values and expressions from the mapped container using all value
+// decoders from the global registry.
+absl::StatusOr<DecodeResult> DecodeMappedContainer(
+    const MappedContainer& container, DecodingOptions options = {});
+
+}  // namespace arolla::serialization
+
+#endif  // AROLLA_SERIALIZATION_MAPPED_CONTAINER_H_
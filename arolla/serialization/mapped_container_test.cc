@@ -0,0 +1,152 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/serialization/mapped_container.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/serialization/encode.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/threading.h"
+
+namespace arolla::serialization {
+namespace {
+
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::SizeIs;
+
+class MappedContainerTest : public ::testing::Test {
+  void SetUp() override { ASSERT_OK(InitArolla()); }
+};
+
+// Returns true if `ptr` points within `data`.
+bool IsWithin(const void* ptr, absl::string_view data) {
+  auto* p = static_cast<const char*>(ptr);
+  return p >= data.data() && p < data.data() + data.size();
+}
+
+TEST_F(MappedContainerTest, MapFile) {
+  std::vector<float> floats(10000);
+  std::iota(floats.begin(), floats.end(), 0.f);
+  auto float_array = CreateFullDenseArray<float>(floats);
+  std::vector<Bytes> strings(2000, Bytes("abc"));
+  auto bytes_array = CreateFullDenseArray<Bytes>(strings);
+  auto small_array = CreateDenseArray<int32_t>({1, std::nullopt, 3});
+  ASSERT_OK_AND_ASSIGN(
+      auto container_proto,
+      Encode({TypedValue::FromValue(float_array),
+              TypedValue::FromValue(bytes_array),
+              TypedValue::FromValue(small_array)},
+             {}, {.dense_array_raw_values = true}));
+  ASSERT_OK_AND_ASSIGN(std::string encoded,
+                       EncodeMappedContainer(container_proto));
+  const std::string path = ::testing::TempDir() + "/mapped_container";
+  std::ofstream(path, std::ios::binary) << encoded;
+
+  ASSERT_OK_AND_ASSIGN(auto mapped_container, MapContainerFile(path));
+  // The large arrays are moved out of the proto.
+  EXPECT_LT(mapped_container.container_proto.ByteSizeLong(), 1000);
+  ASSERT_OK_AND_ASSIGN(auto decode_result,
+                       DecodeMappedContainer(mapped_container));
+  ASSERT_THAT(decode_result.values, SizeIs(3));
+  ASSERT_OK_AND_ASSIGN(auto decoded_floats,
+                       decode_result.values[0].As<DenseArray<float>>());
+  ASSERT_OK_AND_ASSIGN(auto decoded_bytes,
+                       decode_result.values[1].As<DenseArray<Bytes>>());
+  ASSERT_OK_AND_ASSIGN(auto decoded_ints,
+                       decode_result.values[2].As<DenseArray<int32_t>>());
+  EXPECT_EQ(decode_result.values[0].GetFingerprint(),
+            TypedValue::FromValue(float_array).GetFingerprint());
+  EXPECT_EQ(decode_result.values[1].GetFingerprint(),
+            TypedValue::FromValue(bytes_array).GetFingerprint());
+  EXPECT_THAT(decoded_ints.get(), ElementsAre(1, std::nullopt, 3));
+
+  // The payloads are not copied.
+  const absl::string_view payload = mapped_container.payload_section.data;
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(payload.data()) % 4096, 0);
+  EXPECT_TRUE(IsWithin(decoded_floats.get().values.span().data(), payload));
+  EXPECT_TRUE(IsWithin(decoded_bytes.get().values.characters().span().data(),
+                       payload));
+
+  // The values keep the mapping alive.
+  DenseArray<float> floats_copy = decoded_floats.get();
+  mapped_container = {};
+  decode_result = {};
+  EXPECT_EQ(floats_copy.values[9999], 9999.f);
+}
+
+TEST_F(MappedContainerTest, InMemory) {
+  auto float_array = CreateFullDenseArray<float>(std::vector<float>(2000, 1.f));
+  ASSERT_OK_AND_ASSIGN(auto container_proto,
+                       Encode({TypedValue::FromValue(float_array)}, {},
+                              {.dense_array_raw_values = true}));
+  ASSERT_OK_AND_ASSIGN(auto encoded, EncodeMappedContainer(container_proto));
+  auto owner = std::make_shared<std::string>(std::move(encoded));
+  ASSERT_OK_AND_ASSIGN(auto mapped_container,
+                       ParseMappedContainer(owner, *owner));
+  ASSERT_OK_AND_ASSIGN(auto decode_result,
+                       DecodeMappedContainer(mapped_container));
+  ASSERT_THAT(decode_result.values, SizeIs(1));
+  EXPECT_EQ(decode_result.values[0].GetFingerprint(),
+            TypedValue::FromValue(float_array).GetFingerprint());
+
+  // The payload section reaches the decoders running in other threads.
+  StdThreading threading(4);
+  ASSERT_OK_AND_ASSIGN(
+      decode_result,
+      DecodeMappedContainer(mapped_container, {.threading = &threading}));
+  ASSERT_THAT(decode_result.values, SizeIs(1));
+  EXPECT_EQ(decode_result.values[0].GetFingerprint(),
+            TypedValue::FromValue(float_array).GetFingerprint());
+
+  // Without the payload section the references cannot be resolved.
+  EXPECT_THAT(Decode(mapped_container.container_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("no payload section is provided")));
+}
+
+TEST_F(MappedContainerTest, Errors) {
+  EXPECT_THAT(ParseMappedContainer(nullptr, "something else"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "not a mapped container"));
+  ASSERT_OK_AND_ASSIGN(auto encoded, EncodeMappedContainer({}));
+  EXPECT_THAT(ParseMappedContainer(nullptr, absl::string_view(encoded).substr(
+                                                0, encoded.size() - 1)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("corrupted mapped container")));
+  EXPECT_THAT(MapContainerFile(::testing::TempDir() + "/non_existing_file"),
+              StatusIs(absl::StatusCode::kNotFound,
+                       HasSubstr("unable to open")));
+}
+
+}  // namespace
+}  // namespace arolla::serialization
@@ -14,8 +14,11 @@
 //
 #include "arolla/serialization_base/decode.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <string>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -27,14 +30,21 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/message_lite.h"
+#include "google/protobuf/repeated_ptr_field.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_attributes.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_operator.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/qtype/typed_value_interner.h"
 #include "arolla/serialization_base/base.pb.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::serialization_base {
@@ -48,71 +58,260 @@ using ::arolla::expr::Leaf;
 using ::arolla::expr::Literal;
 using ::arolla::expr::MakeOpNode;
 using ::arolla::expr::Placeholder;
+using ::google::protobuf::MessageLite;
+using ::google::protobuf::io::CodedInputStream;
+
+// Wire types of the protobuf encoding.
+enum class WireType {
+  kVarint = 0,
+  kFixed64 = 1,
+  kLengthDelimited = 2,
+  kFixed32 = 5,
+};
 
 // A helper class that holds together the decoder's state.
 class Decoder {
+  using DecodingStepResult =
+      std::variant<std::monostate, TypedValue, ExprNodePtr>;
+
  public:
-  absl::StatusOr<DecodeResult> Run(
-      const ContainerProto& container_proto,
-      const ValueDecoderProvider& value_decoder_provider,
-      const DecodingOptions& options) {
-    options_ = options;
-    RETURN_IF_ERROR(InitValueDecoders(container_proto, value_decoder_provider));
-    for (int decoding_step_idx = 0;
-         decoding_step_idx < container_proto.decoding_steps_size();
-         ++decoding_step_idx) {
-      RETURN_IF_ERROR(
-          HandleDecodingStep(container_proto.decoding_steps(decoding_step_idx)))
-          << "while handling decoding_steps[" << decoding_step_idx << "]";
+  Decoder(const ValueDecoderProvider& value_decoder_provider,
+          const DecodingOptions& options)
+      : value_decoder_provider_(value_decoder_provider), options_(options) {}
+
+  absl::StatusOr<DecodeResult> Run(const ContainerProto& container_proto) {
+    RETURN_IF_ERROR(InitValueDecoders(container_proto.codecs()));
+    if (options_.threading != nullptr &&
+        options_.threading->GetRecommendedThreadCount() > 1 &&
+        container_proto.decoding_steps().size() > 1) {
+      RETURN_IF_ERROR(AddDecodingStepsInParallel(
+          container_proto.decoding_steps(), *options_.threading));
+    } else {
+      for (const auto& decoding_step_proto :
+           container_proto.decoding_steps()) {
+        RETURN_IF_ERROR(AddDecodingStep(decoding_step_proto));
+      }
+    }
+    return Finish(container_proto.output_value_indices(),
+                  container_proto.output_expr_indices());
+  }
+
+  // Initializes value decoders for the given codecs. Can be called multiple
+  // times; the new codecs get the subsequent indices.
+  template <typename Codecs>
+  absl::Status InitValueDecoders(const Codecs& codecs) {
+    std::vector<absl::string_view> unknown_codecs;
+    for (const CodecProto& codec : codecs) {
+      auto value_decoder = value_decoder_provider_(codec.name());
+      if (value_decoder == nullptr) {
+        unknown_codecs.push_back(codec.name());
+      } else {
+        codec_names_.push_back(codec.name());
+        value_decoders_.push_back(std::move(value_decoder));
+      }
     }
+    if (!unknown_codecs.empty()) {
+      constexpr absl::string_view suggested_dependency =
+          "adding "
+          "\"@arolla://arolla/qexpr/serialization_codecs:all_decoders\" "
+          "build dependency may help";
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "unknown codecs: %s; %s.", absl::StrJoin(unknown_codecs, ", "),
+          suggested_dependency));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status AddDecodingStep(const DecodingStepProto& decoding_step_proto) {
+    const size_t decoding_step_idx = decoding_step_results_.size();
+    ASSIGN_OR_RETURN(
+        auto decoding_step_result, HandleDecodingStep(decoding_step_proto),
+        _ << "while handling decoding_steps[" << decoding_step_idx << "]");
+    decoding_step_results_.push_back(std::move(decoding_step_result));
+    return absl::OkStatus();
+  }
+
+  // Decodes the given steps on `threading`. Every step is decoded once all
+  // the steps it references are ready, in any order otherwise.
+  //
+  // After a failure, the steps with lower indices are still decoded, so the
+  // reported error is the one of the lowest failing step, the same as with
+  // the sequential decoding.
+  absl::Status AddDecodingStepsInParallel(
+      const google::protobuf::RepeatedPtrField<DecodingStepProto>&
+          decoding_step_protos,
+      ThreadingInterface& threading) {
+    const int64_t offset = decoding_step_results_.size();
+    const int64_t step_count = decoding_step_protos.size();
+    // The number of not yet decoded references for each step, and the steps
+    // referring to each step.
+    std::vector<int64_t> pending_deps(step_count, 0);
+    std::vector<std::vector<int64_t>> dependents(step_count);
+    for (int64_t i = 0; i < step_count; ++i) {
+      for (int64_t dep : GetStepReferences(decoding_step_protos[i])) {
+        if (dep < offset) {
+          continue;  // Already decoded or invalid; validated when loaded.
+        }
+        if (dep >= offset + i) {
+          // A forward reference; fall back to the sequential decoding to
+          // produce the same error.
+          for (const auto& decoding_step_proto : decoding_step_protos) {
+            RETURN_IF_ERROR(AddDecodingStep(decoding_step_proto));
+          }
+          return absl::OkStatus();
+        }
+        pending_deps[i] += 1;
+        dependents[dep - offset].push_back(i);
+      }
+    }
+    decoding_step_results_.resize(offset + step_count);
+
+    absl::Mutex mutex;
+    absl::CondVar cond_var;
+    std::deque<int64_t> ready_steps;
+    int64_t running_steps = 0;
+    int64_t failed_step = step_count;
+    absl::Status status;
+    for (int64_t i = 0; i < step_count; ++i) {
+      if (pending_deps[i] == 0) {
+        ready_steps.push_back(i);
+      }
+    }
+    auto worker = [&](int64_t /*worker_id*/) {
+      for (;;) {
+        int64_t i;
+        {
+          absl::MutexLock lock(&mutex);
+          for (;;) {
+            // Steps after a failed one are not needed anymore.
+            while (!ready_steps.empty() && ready_steps.front() > failed_step) {
+              ready_steps.pop_front();
+            }
+            if (!ready_steps.empty() || running_steps == 0) {
+              break;
+            }
+            cond_var.Wait(&mutex);
+          }
+          if (ready_steps.empty()) {
+            // Nothing is running, so no more steps can become ready.
+            return;
+          }
+          i = ready_steps.front();
+          ready_steps.pop_front();
+          running_steps += 1;
+        }
+        // The results of the referenced steps were stored under `mutex` before
+        // this step became ready, and nobody modifies them anymore.
+        auto decoding_step_result = HandleDecodingStep(decoding_step_protos[i]);
+        absl::MutexLock lock(&mutex);
+        running_steps -= 1;
+        if (!decoding_step_result.ok()) {
+          if (i < failed_step) {
+            failed_step = i;
+            status = std::move(decoding_step_result).status();
+          }
+          cond_var.SignalAll();
+          continue;
+        }
+        decoding_step_results_[offset + i] = *std::move(decoding_step_result);
+        for (int64_t dependent : dependents[i]) {
+          if (--pending_deps[dependent] == 0) {
+            ready_steps.push_back(dependent);
+          }
+        }
+        cond_var.SignalAll();
+      }
+    };
+    ParallelFor(threading,
+                std::min<int64_t>(threading.GetRecommendedThreadCount(),
+                                  step_count),
+                worker);
+    if (!status.ok()) {
+      decoding_step_results_.resize(offset);
+      RETURN_IF_ERROR(status)
+          << "while handling decoding_steps[" << offset + failed_step << "]";
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<DecodeResult> Finish(
+      absl::Span<const int64_t> output_value_indices,
+      absl::Span<const int64_t> output_expr_indices) const {
     DecodeResult result;
-    ASSIGN_OR_RETURN(result.values,
-                     LoadDecodedValues(container_proto.output_value_indices()),
+    ASSIGN_OR_RETURN(result.values, LoadDecodedValues(output_value_indices),
                      _ << "while loading output values");
-    ASSIGN_OR_RETURN(result.exprs,
-                     LoadDecodedExprs(container_proto.output_expr_indices()),
+    ASSIGN_OR_RETURN(result.exprs, LoadDecodedExprs(output_expr_indices),
                      _ << "while loading output expressions");
     return result;
   }
 
  private:
-  absl::Status HandleDecodingStep(
+  // Returns the indices of the decoding steps referenced by the given step.
+  static std::vector<int64_t> GetStepReferences(
       const DecodingStepProto& decoding_step_proto) {
+    std::vector<int64_t> result;
+    switch (decoding_step_proto.type_case()) {
+      case DecodingStepProto::kLiteralNode:
+        if (decoding_step_proto.literal_node().has_literal_value_index()) {
+          result.push_back(
+              decoding_step_proto.literal_node().literal_value_index());
+        }
+        break;
+      case DecodingStepProto::kOperatorNode: {
+        const auto& operator_node = decoding_step_proto.operator_node();
+        if (operator_node.has_operator_value_index()) {
+          result.push_back(operator_node.operator_value_index());
+        }
+        result.insert(result.end(), operator_node.input_expr_indices().begin(),
+                      operator_node.input_expr_indices().end());
+        break;
+      }
+      case DecodingStepProto::kValue: {
+        const auto& value = decoding_step_proto.value();
+        result.insert(result.end(), value.input_value_indices().begin(),
+                      value.input_value_indices().end());
+        result.insert(result.end(), value.input_expr_indices().begin(),
+                      value.input_expr_indices().end());
+        break;
+      }
+      default:
+        break;
+    }
+    return result;
+  }
+
+  absl::StatusOr<DecodingStepResult> HandleDecodingStep(
+      const DecodingStepProto& decoding_step_proto) const {
     switch (decoding_step_proto.type_case()) {
       case DecodingStepProto::kLiteralNode: {
         ASSIGN_OR_RETURN(auto expr,
                          DecodeLiteralNode(decoding_step_proto.literal_node()),
                          _ << "decoding_step.type=LITERAL_NODE");
-        decoding_step_results_.emplace_back(std::move(expr));
-        return absl::OkStatus();
+        return expr;
       }
       case DecodingStepProto::kLeafNode: {
         ASSIGN_OR_RETURN(auto expr,
                          DecodeLeafNode(decoding_step_proto.leaf_node()),
                          _ << "decoding_step.type=LEAF_NODE");
-        decoding_step_results_.emplace_back(std::move(expr));
-        return absl::OkStatus();
+        return expr;
       }
       case DecodingStepProto::kPlaceholderNode: {
         ASSIGN_OR_RETURN(
             auto expr,
             DecodePlaceholderNode(decoding_step_proto.placeholder_node()),
             _ << "decoding_step.type=PLACEHOLDER_NODE");
-        decoding_step_results_.emplace_back(std::move(expr));
-        return absl::OkStatus();
+        return expr;
       }
       case DecodingStepProto::kOperatorNode: {
         ASSIGN_OR_RETURN(
             auto expr, DecodeOperatorNode(decoding_step_proto.operator_node()),
             _ << "decoding_step.type=OPERATOR_NODE");
-        decoding_step_results_.emplace_back(std::move(expr));
-        return absl::OkStatus();
+        return expr;
       }
       case DecodingStepProto::kValue: {
         ASSIGN_OR_RETURN(auto value, DecodeValue(decoding_step_proto.value()),
                          _ << "decoding_step.type=VALUE");
-        decoding_step_results_.emplace_back(std::move(value));
-        return absl::OkStatus();
+        return value;
       }
       case DecodingStepProto::TYPE_NOT_SET: {
         return absl::InvalidArgumentError("missing decoding_step.type");
@@ -134,6 +333,9 @@ class Decoder {
         LoadDecodedValues({literal_node_proto.literal_value_index()}));
     DCHECK(!values.empty());  // values.size() is exactly 1 because we pass
                               // one value index
+    if (options_.literal_interner != nullptr) {
+      return Literal(options_.literal_interner->Intern(values.front()));
+    }
     return Literal(values.front());
   }
 
@@ -278,45 +480,105 @@ class Decoder {
     return result;
   }
 
-  // Initializes value decoder indexing.
-  absl::Status InitValueDecoders(
-      const ContainerProto& container_proto,
-      const ValueDecoderProvider& value_decoder_provider) {
-    codec_names_.reserve(container_proto.codecs_size());
-    value_decoders_.reserve(container_proto.codecs_size());
-    std::vector<absl::string_view> unknown_codecs;
-    for (const auto& codec : container_proto.codecs()) {
-      auto value_decoder = value_decoder_provider(codec.name());
-      if (value_decoder == nullptr) {
-        unknown_codecs.push_back(codec.name());
-      } else {
-        codec_names_.push_back(codec.name());
-        value_decoders_.push_back(std::move(value_decoder));
-      }
-    }
-    if (!unknown_codecs.empty()) {
-      constexpr absl::string_view suggested_dependency =
-          "adding "
-          "\"@arolla://arolla/qexpr/serialization_codecs:all_decoders\" "
-          "build dependency may help";
-      return absl::InvalidArgumentError(absl::StrFormat(
-          "unknown codecs: %s; %s.", absl::StrJoin(unknown_codecs, ", "),
-          suggested_dependency));
-    }
-    return absl::OkStatus();
-  }
-
+  const ValueDecoderProvider& value_decoder_provider_;
   DecodingOptions options_;
 
   // Active codecs.
-  std::vector<absl::string_view> codec_names_;
+  std::vector<std::string> codec_names_;
   std::vector<ValueDecoder> value_decoders_;
 
-  // Past decoding step results.
-  using DecodingStepResult = std::variant<TypedValue, ExprNodePtr>;
+  // Past decoding step results. The steps that are not decoded yet (only in
+  // the parallel mode) hold std::monostate.
   std::vector<DecodingStepResult> decoding_step_results_;
 };
 
+absl::Status CheckContainerVersion(int64_t version) {
+  if (version != kContainerVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("expected container.version to be %d, got %d",
+                        kContainerVersion, version));
+  }
+  return absl::OkStatus();
+}
+
+// Reads a length-delimited message from the stream.
+absl::Status ReadMessage(CodedInputStream& input, MessageLite& message) {
+  uint32_t length;
+  if (!input.ReadVarint32(&length)) {
+    return absl::InvalidArgumentError("unable to read message length");
+  }
+  auto limit = input.PushLimit(length);
+  if (!message.ParseFromCodedStream(&input) ||
+      input.BytesUntilLimit() != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("unable to parse %s", message.GetTypeName()));
+  }
+  input.PopLimit(limit);
+  return absl::OkStatus();
+}
+
+// Reads a repeated int64 field in either packed or non-packed encoding.
+absl::Status ReadInt64s(CodedInputStream& input, WireType wire_type,
+                        std::vector<int64_t>& result) {
+  uint64_t value;
+  if (wire_type == WireType::kVarint) {
+    if (!input.ReadVarint64(&value)) {
+      return absl::InvalidArgumentError("unable to read int64");
+    }
+    result.push_back(static_cast<int64_t>(value));
+    return absl::OkStatus();
+  }
+  if (wire_type != WireType::kLengthDelimited) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "unexpected wire type for int64: %d", static_cast<int>(wire_type)));
+  }
+  uint32_t length;
+  if (!input.ReadVarint32(&length)) {
+    return absl::InvalidArgumentError("unable to read packed int64s length");
+  }
+  auto limit = input.PushLimit(length);
+  while (input.BytesUntilLimit() > 0) {
+    if (!input.ReadVarint64(&value)) {
+      return absl::InvalidArgumentError("unable to read packed int64s");
+    }
+    result.push_back(static_cast<int64_t>(value));
+  }
+  input.PopLimit(limit);
+  return absl::OkStatus();
+}
+
+// Skips a field with the given wire type.
+absl::Status SkipField(CodedInputStream& input, WireType wire_type) {
+  uint64_t varint;
+  uint32_t length;
+  switch (wire_type) {
+    case WireType::kVarint:
+      if (input.ReadVarint64(&varint)) {
+        return absl::OkStatus();
+      }
+      break;
+    case WireType::kFixed64:
+      if (input.Skip(8)) {
+        return absl::OkStatus();
+      }
+      break;
+    case WireType::kLengthDelimited:
+      if (input.ReadVarint32(&length) && input.Skip(length)) {
+        return absl::OkStatus();
+      }
+      break;
+    case WireType::kFixed32:
+      if (input.Skip(4)) {
+        return absl::OkStatus();
+      }
+      break;
+    default:
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "unsupported wire type: %d", static_cast<int>(wire_type)));
+  }
+  return absl::InvalidArgumentError("unable to skip an unknown field");
+}
+
 }  // namespace
 
 absl::StatusOr<DecodeResult> Decode(
@@ -326,12 +588,83 @@ absl::StatusOr<DecodeResult> Decode(
   if (!container_proto.has_version()) {
     return absl::InvalidArgumentError("missing container.version");
   }
-  if (container_proto.version() != kContainerVersion) {
-    return absl::InvalidArgumentError(
-        absl::StrFormat("expected container.version to be %d, got %d",
-                        kContainerVersion, container_proto.version()));
+  RETURN_IF_ERROR(CheckContainerVersion(container_proto.version()));
+  return Decoder(value_decoder_provider, options).Run(container_proto);
+}
+
+absl::StatusOr<DecodeResult> DecodeFromStream(
+    google::protobuf::io::ZeroCopyInputStream* input,
+    const ValueDecoderProvider& value_decoder_provider,
+    const DecodingOptions& options) {
+  Decoder decoder(value_decoder_provider, options);
+  bool has_version = false;
+  std::vector<int64_t> output_value_indices;
+  std::vector<int64_t> output_expr_indices;
+  CodecProto codec_proto;
+  DecodingStepProto decoding_step_proto;
+  for (;;) {
+    // CodedInputStream limits the total number of bytes it reads, so we use
+    // a fresh one for each field; it returns the unread data to `input` on
+    // destruction.
+    CodedInputStream coded_input(input);
+    const uint32_t tag = coded_input.ReadTag();
+    if (tag == 0) {
+      if (!coded_input.ConsumedEntireMessage()) {
+        return absl::InvalidArgumentError("unable to read ContainerProto");
+      }
+      break;
+    }
+    const int field_number = static_cast<int>(tag >> 3);
+    const auto wire_type = static_cast<WireType>(tag & 7);
+    // In a serialized ContainerProto the version goes first, so we can
+    // validate it before handling any other field.
+    if (!has_version && field_number != ContainerProto::kVersionFieldNumber) {
+      return absl::InvalidArgumentError("missing container.version");
+    }
+    switch (field_number) {
+      case ContainerProto::kVersionFieldNumber: {
+        uint64_t version;
+        if (wire_type != WireType::kVarint ||
+            !coded_input.ReadVarint64(&version)) {
+          return absl::InvalidArgumentError(
+              "unable to read container.version");
+        }
+        RETURN_IF_ERROR(CheckContainerVersion(static_cast<int64_t>(version)));
+        has_version = true;
+        break;
+      }
+      case ContainerProto::kCodecsFieldNumber: {
+        RETURN_IF_ERROR(ReadMessage(coded_input, codec_proto))
+            << "while reading container.codecs";
+        RETURN_IF_ERROR(decoder.InitValueDecoders(
+            absl::Span<const CodecProto>(&codec_proto, 1)));
+        break;
+      }
+      case ContainerProto::kDecodingStepsFieldNumber: {
+        RETURN_IF_ERROR(ReadMessage(coded_input, decoding_step_proto))
+            << "while reading container.decoding_steps";
+        RETURN_IF_ERROR(decoder.AddDecodingStep(decoding_step_proto));
+        break;
+      }
+      case ContainerProto::kOutputValueIndicesFieldNumber: {
+        RETURN_IF_ERROR(
+            ReadInt64s(coded_input, wire_type, output_value_indices))
+            << "while reading container.output_value_indices";
+        break;
+      }
+      case ContainerProto::kOutputExprIndicesFieldNumber: {
+        RETURN_IF_ERROR(ReadInt64s(coded_input, wire_type, output_expr_indices))
+            << "while reading container.output_expr_indices";
+        break;
+      }
+      default:
+        RETURN_IF_ERROR(SkipField(coded_input, wire_type));
+    }
+  }
+  if (!has_version) {
+    return absl::InvalidArgumentError("missing container.version");
   }
-  return Decoder().Run(container_proto, value_decoder_provider, options);
+  return decoder.Finish(output_value_indices, output_expr_indices);
 }
 
 }  // namespace arolla::serialization_base
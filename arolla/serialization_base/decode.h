@@ -22,9 +22,13 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "google/protobuf/io/zero_copy_stream.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/qtype/typed_value_interner.h"
 #include "arolla/serialization_base/base.pb.h"
+#include "arolla/serialization_base/payload.h"
+#include "arolla/util/threading.h"
 
 namespace arolla::serialization_base {
 
@@ -53,6 +57,14 @@ using ValueDecoder = std::function<absl::StatusOr<ValueDecoderResult>(
     const ValueProto& value_proto, absl::Span<const TypedValue> input_values,
     absl::Span<const arolla::expr::ExprNodePtr> input_exprs)>;
 
+// A value decoder that can resolve the PayloadRefProto references in
+// `value_proto` using ResolvePayloadRef(). `payload_section` is
+// DecodingOptions::payload_section of the Decode() call, or nullptr.
+using PayloadValueDecoder = std::function<absl::StatusOr<ValueDecoderResult>(
+    const ValueProto& value_proto, absl::Span<const TypedValue> input_values,
+    absl::Span<const arolla::expr::ExprNodePtr> input_exprs,
+    const PayloadSection* payload_section)>;
+
 // A provider for value decoders. Returns ValueDecoder{nullptr} if no decoder
 // available.
 using ValueDecoderProvider =
@@ -66,6 +78,29 @@ struct DecodingOptions {
   // NOTE: This option should be removed after switching to expression
   // attributes.
   bool generate_metadata_for_operator_nodes = true;
+
+  // Payload section for PayloadRefProto references in the container. Must
+  // outlive the Decode() call; the decoded values may share its ownership.
+  //
+  // NOTE: The value decoder provider is responsible for passing it to
+  // the PayloadValueDecoders, e.g. serialization::Decode() does it for the
+  // decoders registered with RegisterPayloadValueDecoder().
+  const PayloadSection* payload_section = nullptr;
+
+  // If set, Decode() decodes the independent decoding steps concurrently: a
+  // step starts as soon as all the steps it references are decoded. The
+  // result is identical to the sequential one, but the value decoders must be
+  // thread-safe. If specified, it must remain valid during the Decode() call.
+  //
+  // NOTE: DecodeFromStream() ignores this option.
+  ThreadingInterface* threading = nullptr;
+
+  // If set, the values of the decoded literal nodes are interned in this
+  // registry, so the identical literals of different containers (e.g.
+  // vocabularies shared by many models) share one instance. E.g.
+  // &TypedValueInterner::GetInstance(). If specified, it must remain valid
+  // during the Decode() call.
+  TypedValueInterner* literal_interner = nullptr;
 };
 
 // Return type for Decode().
@@ -80,6 +115,23 @@ absl::StatusOr<DecodeResult> Decode(
     const ValueDecoderProvider& value_decoder_provider,
     const DecodingOptions& options = DecodingOptions());
 
+// Decodes values and expressions from a serialized ContainerProto read from
+// `input`.
+//
+// Unlike Decode(), it doesn't keep the whole ContainerProto in memory: each
+// decoding step is parsed and decoded as soon as it's read from the stream
+// and its proto is discarded right after. So the decoding can overlap with
+// the data transfer, and the memory footprint is proportional to the decoded
+// values rather than to the serialized container.
+//
+// The container fields are expected in the canonical serialization order
+// (i.e. `version` goes first and `codecs` precede the decoding steps that
+// use them), which is what the protobuf serializer produces.
+absl::StatusOr<DecodeResult> DecodeFromStream(
+    google::protobuf::io::ZeroCopyInputStream* input,
+    const ValueDecoderProvider& value_decoder_provider,
+    const DecodingOptions& options = DecodingOptions());
+
 }  // namespace arolla::serialization_base
 
 #endif  // AROLLA_EXPERIMENTAL_PB_SERIALIZE_BASE_DECODE_H_
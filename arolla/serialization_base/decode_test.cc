@@ -14,16 +14,20 @@
 //
 #include "arolla/serialization_base/decode.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_attributes.h"
 #include "arolla/expr/expr_node.h"
@@ -34,8 +38,12 @@
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/testing/qtype.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/qtype/typed_value_interner.h"
 #include "arolla/serialization_base/base.pb.h"
+#include "arolla/util/bytes.h"
 #include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/threading.h"
+#include "arolla/util/status_macros_backport.h"
 
 namespace arolla::serialization_base {
 namespace {
@@ -45,6 +53,7 @@ using ::arolla::serialization_base::ValueProto;
 using ::arolla::testing::EqualsExpr;
 using ::arolla::testing::StatusIs;
 using ::arolla::testing::TypedValueWith;
+using ::testing::_;
 using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
@@ -104,6 +113,30 @@ TEST_F(DecodeTest, LiteralNode) {
   EXPECT_THAT(output.exprs, ElementsAre(EqualsExpr(expected_output)));
 }
 
+TEST_F(DecodeTest, LiteralNode_Interned) {
+  container_proto_.add_codecs()->set_name("mock_codec");
+  container_proto_.add_decoding_steps()->mutable_value()->set_codec_index(0);
+  container_proto_.add_decoding_steps()
+      ->mutable_literal_node()
+      ->set_literal_value_index(0);
+  container_proto_.add_output_expr_indices(1);
+  EXPECT_CALL(mock_value_decoder_, Call(_, _, _))
+      .WillRepeatedly(
+          [](auto&&...) { return TypedValue::FromValue(Bytes("vocabulary")); });
+  TypedValueInterner interner;
+  DecodingOptions options;
+  options.literal_interner = &interner;
+  ASSERT_OK_AND_ASSIGN(auto output1,
+                       Decode(container_proto_, codecs(), options));
+  ASSERT_OK_AND_ASSIGN(auto output2,
+                       Decode(container_proto_, codecs(), options));
+  auto expected_output = expr::Literal(Bytes("vocabulary"));
+  ASSERT_THAT(output1.exprs, ElementsAre(EqualsExpr(expected_output)));
+  ASSERT_THAT(output2.exprs, ElementsAre(EqualsExpr(expected_output)));
+  EXPECT_EQ(output1.exprs[0]->qvalue()->GetRawPointer(),
+            output2.exprs[0]->qvalue()->GetRawPointer());
+}
+
 TEST_F(DecodeTest, LeafNode) {
   container_proto_.add_decoding_steps()->mutable_leaf_node()->set_leaf_key(
       "leaf_key");
@@ -565,5 +598,212 @@ TEST_F(DecodeTest, Error_Output_OutputExprIndexPointsToValue) {
                     "while loading output expressions")));
 }
 
+// Decodes a float value as the sum of its inputs plus one.
+absl::StatusOr<ValueDecoderResult> DecodeSumPlusOne(
+    const ValueProto&, absl::Span<const TypedValue> input_values,
+    absl::Span<const expr::ExprNodePtr>) {
+  float result = 1.0f;
+  for (const auto& input_value : input_values) {
+    ASSIGN_OR_RETURN(float x, input_value.As<float>());
+    result += x;
+  }
+  return TypedValue::FromValue(result);
+}
+
+TEST_F(DecodeTest, ParallelDecoding) {
+  codecs_["sum_codec"] = DecodeSumPlusOne;
+  container_proto_.add_codecs()->set_name("sum_codec");
+  // Independent chains of values, each referring to the previous value in the
+  // chain, and a final value summing up all the chains.
+  constexpr int kChainCount = 16;
+  constexpr int kChainLength = 32;
+  ValueProto sum_value_proto;
+  sum_value_proto.set_codec_index(0);
+  for (int i = 0; i < kChainCount; ++i) {
+    int64_t previous_index = -1;
+    for (int j = 0; j < kChainLength; ++j) {
+      auto* value_proto =
+          container_proto_.add_decoding_steps()->mutable_value();
+      value_proto->set_codec_index(0);
+      if (previous_index >= 0) {
+        value_proto->add_input_value_indices(previous_index);
+      }
+      previous_index = container_proto_.decoding_steps_size() - 1;
+    }
+    sum_value_proto.add_input_value_indices(previous_index);
+    container_proto_.add_decoding_steps()->mutable_leaf_node()->set_leaf_key(
+        absl::StrCat("leaf_", i));
+    container_proto_.add_output_expr_indices(
+        container_proto_.decoding_steps_size() - 1);
+  }
+  *container_proto_.add_decoding_steps()->mutable_value() =
+      std::move(sum_value_proto);
+  container_proto_.add_output_value_indices(
+      container_proto_.decoding_steps_size() - 1);
+  container_proto_.add_output_value_indices(0);
+
+  StdThreading threading(4);
+  DecodingOptions options;
+  options.threading = &threading;
+  ASSERT_OK_AND_ASSIGN(auto output,
+                       Decode(container_proto_, codecs(), options));
+  EXPECT_THAT(output.values,
+              ElementsAre(TypedValueWith<float>(kChainCount * kChainLength + 1),
+                          TypedValueWith<float>(1.0f)));
+  ASSERT_EQ(output.exprs.size(), kChainCount);
+  for (int i = 0; i < kChainCount; ++i) {
+    EXPECT_THAT(output.exprs[i],
+                EqualsExpr(expr::Leaf(absl::StrCat("leaf_", i))));
+  }
+}
+
+TEST_F(DecodeTest, ParallelDecoding_Errors) {
+  StdThreading threading(4);
+  DecodingOptions options;
+  options.threading = &threading;
+  codecs_["sum_codec"] = DecodeSumPlusOne;
+  container_proto_.add_codecs()->set_name("sum_codec");
+  container_proto_.add_decoding_steps()->mutable_value()->set_codec_index(0);
+  container_proto_.add_decoding_steps()->mutable_leaf_node()->set_leaf_key(
+      "leaf_key");
+  {
+    // The value decoder fails on an expression input.
+    ContainerProto container_proto = container_proto_;
+    auto* value_proto = container_proto.add_decoding_steps()->mutable_value();
+    value_proto->set_codec_index(0);
+    value_proto->add_input_value_indices(1);
+    EXPECT_THAT(Decode(container_proto, codecs(), options),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("expected a value in decoding_steps[1], got "
+                                   "an expression; "
+                                   "decoding_step.type=VALUE; "
+                                   "while handling decoding_steps[2]")));
+  }
+  {
+    // A forward reference.
+    ContainerProto container_proto = container_proto_;
+    container_proto.mutable_decoding_steps(0)
+        ->mutable_value()
+        ->add_input_value_indices(2);
+    container_proto.add_decoding_steps()->mutable_value()->set_codec_index(0);
+    EXPECT_THAT(Decode(container_proto, codecs(), options),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("value index is out of range: 2; "
+                                   "decoding_step.type=VALUE; "
+                                   "while handling decoding_steps[0]")));
+  }
+  {
+    // The lowest failing step ends a long chain, while many later
+    // independent steps fail right away. The reported error is the same as
+    // with the sequential decoding.
+    ContainerProto container_proto = container_proto_;
+    int64_t previous_index = 0;
+    for (int i = 0; i < 64; ++i) {
+      auto* value_proto = container_proto.add_decoding_steps()->mutable_value();
+      value_proto->set_codec_index(0);
+      value_proto->add_input_value_indices(previous_index);
+      previous_index = container_proto.decoding_steps_size() - 1;
+    }
+    container_proto.mutable_decoding_steps(previous_index)
+        ->mutable_value()
+        ->add_input_value_indices(1);
+    for (int i = 0; i < 64; ++i) {
+      auto* value_proto = container_proto.add_decoding_steps()->mutable_value();
+      value_proto->set_codec_index(0);
+      value_proto->add_input_value_indices(1);
+    }
+    auto status = Decode(container_proto, codecs(), options).status();
+    EXPECT_THAT(
+        status,
+        StatusIs(absl::StatusCode::kInvalidArgument,
+                 HasSubstr(absl::StrCat("while handling decoding_steps[",
+                                        previous_index, "]"))));
+    EXPECT_EQ(status, Decode(container_proto, codecs()).status());
+  }
+}
+
+TEST_F(DecodeTest, DecodeFromStream) {
+  container_proto_.add_codecs()->set_name("mock_codec");
+  container_proto_.add_decoding_steps()->mutable_value()->set_codec_index(0);
+  container_proto_.add_decoding_steps()->mutable_leaf_node()->set_leaf_key(
+      "leaf_key");
+  auto* operator_node_proto =
+      container_proto_.add_decoding_steps()->mutable_operator_node();
+  operator_node_proto->set_operator_value_index(0);
+  operator_node_proto->add_input_expr_indices(1);
+  operator_node_proto->add_input_expr_indices(1);
+  container_proto_.add_output_expr_indices(2);
+  container_proto_.add_output_value_indices(0);
+  EXPECT_CALL(mock_value_decoder_, Call(_, IsEmpty(), IsEmpty()))
+      .WillOnce(Return(TypedValue::FromValue(dummy_op_)));
+  // Unknown fields are skipped.
+  const std::string serialized = container_proto_.SerializeAsString() +
+                                 "\xa0\x06\x05";  // field 100: varint 5
+  // Use a small block size to test reading across the block boundaries.
+  google::protobuf::io::ArrayInputStream input(serialized.data(),
+                                               serialized.size(),
+                                               /*block_size=*/3);
+  ASSERT_OK_AND_ASSIGN(auto output, DecodeFromStream(&input, codecs()));
+  EXPECT_THAT(output.values,
+              ElementsAre(TypedValueWith<expr::ExprOperatorPtr>(dummy_op_)));
+  auto leaf = expr::Leaf("leaf_key");
+  auto expected_output = expr::ExprNode::UnsafeMakeOperatorNode(
+      expr::ExprOperatorPtr(dummy_op_), {leaf, leaf}, expr::ExprAttributes{});
+  EXPECT_THAT(output.exprs, ElementsAre(EqualsExpr(expected_output)));
+}
+
+TEST_F(DecodeTest, DecodeFromStream_Errors) {
+  auto decode_from_string = [&](const std::string& serialized) {
+    google::protobuf::io::ArrayInputStream input(serialized.data(),
+                                                 serialized.size());
+    return DecodeFromStream(&input, codecs());
+  };
+  EXPECT_THAT(decode_from_string(""),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("missing container.version")));
+  {
+    ContainerProto container_proto;
+    container_proto.add_codecs()->set_name("mock_codec");
+    EXPECT_THAT(decode_from_string(container_proto.SerializeAsString()),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("missing container.version")));
+  }
+  {
+    ContainerProto container_proto = container_proto_;
+    container_proto.set_version(-1);
+    EXPECT_THAT(
+        decode_from_string(container_proto.SerializeAsString()),
+        StatusIs(absl::StatusCode::kInvalidArgument,
+                 HasSubstr("expected container.version to be 1, got -1")));
+  }
+  {
+    ContainerProto container_proto = container_proto_;
+    container_proto.add_codecs()->set_name("foo");
+    EXPECT_THAT(decode_from_string(container_proto.SerializeAsString()),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("unknown codecs: foo")));
+  }
+  {
+    ContainerProto container_proto = container_proto_;
+    container_proto.add_decoding_steps()->mutable_leaf_node()->set_leaf_key(
+        "leaf_key");
+    container_proto.add_decoding_steps();
+    EXPECT_THAT(decode_from_string(container_proto.SerializeAsString()),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("missing decoding_step.type; while "
+                                   "handling decoding_steps[1]")));
+  }
+  {
+    ContainerProto container_proto = container_proto_;
+    container_proto.add_decoding_steps()->mutable_leaf_node()->set_leaf_key(
+        "leaf_key");
+    std::string serialized = container_proto.SerializeAsString();
+    serialized.pop_back();
+    EXPECT_THAT(decode_from_string(serialized),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("unable to parse")));
+  }
+}
+
 }  // namespace
 }  // namespace arolla::serialization_base
@@ -14,10 +14,11 @@
 //
 #include "arolla/serialization_base/encode.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <utility>
 
-#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
@@ -29,6 +30,9 @@
 #include "arolla/serialization_base/base.pb.h"
 #include "arolla/serialization_base/decode.h"
 #include "arolla/util/status_macros_backport.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/message_lite.h"
 
 namespace arolla::serialization_base {
 
@@ -37,34 +41,167 @@ using ::arolla::expr::ExprNodePtr;
 using ::arolla::expr::ExprNodeType;
 using ::arolla::expr::VisitorOrder;
 
+namespace {
+
+// Wire types of the protobuf encoding.
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeLengthDelimited = 2;
+
+constexpr uint32_t MakeTag(int field_number, uint32_t wire_type) {
+  return (static_cast<uint32_t>(field_number) << 3) | wire_type;
+}
+
+}  // namespace
+
+ContainerProtoBuilder::ContainerProtoBuilder(ContainerProto& container_proto)
+    : container_proto_(container_proto) {
+  container_proto_.set_version(kContainerVersion);
+}
+
+absl::Status ContainerProtoBuilder::AddCodec(CodecProto codec_proto) {
+  *container_proto_.add_codecs() = std::move(codec_proto);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<int64_t> ContainerProtoBuilder::AddDecodingStep(
+    DecodingStepProto decoding_step_proto) {
+  *container_proto_.add_decoding_steps() = std::move(decoding_step_proto);
+  return container_proto_.decoding_steps().size() - 1;
+}
+
+absl::Status ContainerProtoBuilder::AddOutputValueIndex(int64_t value_index) {
+  container_proto_.add_output_value_indices(value_index);
+  return absl::OkStatus();
+}
+
+absl::Status ContainerProtoBuilder::AddOutputExprIndex(int64_t expr_index) {
+  container_proto_.add_output_expr_indices(expr_index);
+  return absl::OkStatus();
+}
+
+ContainerStreamBuilder::ContainerStreamBuilder(
+    google::protobuf::io::ZeroCopyOutputStream* output)
+    : output_(output) {
+  // The version goes first, so that the reader can check it before decoding
+  // the first step.
+  output_.WriteTag(
+      MakeTag(ContainerProto::kVersionFieldNumber, kWireTypeVarint));
+  output_.WriteVarint64(kContainerVersion);
+}
+
+absl::Status ContainerStreamBuilder::AddCodec(CodecProto codec_proto) {
+  return WriteMessage(ContainerProto::kCodecsFieldNumber, codec_proto);
+}
+
+absl::StatusOr<int64_t> ContainerStreamBuilder::AddDecodingStep(
+    DecodingStepProto decoding_step_proto) {
+  RETURN_IF_ERROR(WriteMessage(ContainerProto::kDecodingStepsFieldNumber,
+                               decoding_step_proto));
+  return decoding_step_count_++;
+}
+
+absl::Status ContainerStreamBuilder::AddOutputValueIndex(int64_t value_index) {
+  return WriteInt64(ContainerProto::kOutputValueIndicesFieldNumber,
+                    value_index);
+}
+
+absl::Status ContainerStreamBuilder::AddOutputExprIndex(int64_t expr_index) {
+  return WriteInt64(ContainerProto::kOutputExprIndicesFieldNumber, expr_index);
+}
+
+absl::Status ContainerStreamBuilder::Finish() {
+  output_.Trim();
+  return CheckOutput();
+}
+
+absl::Status ContainerStreamBuilder::WriteMessage(
+    int field_number, const google::protobuf::MessageLite& message) {
+  const size_t message_size = message.ByteSizeLong();
+  output_.WriteTag(MakeTag(field_number, kWireTypeLengthDelimited));
+  output_.WriteVarint64(message_size);
+  // ByteSizeLong() has populated the cached sizes.
+  message.SerializeWithCachedSizes(&output_);
+  return CheckOutput();
+}
+
+absl::Status ContainerStreamBuilder::WriteInt64(int field_number,
+                                                int64_t value) {
+  output_.WriteTag(MakeTag(field_number, kWireTypeVarint));
+  output_.WriteVarint64(static_cast<uint64_t>(value));
+  return CheckOutput();
+}
+
+absl::Status ContainerStreamBuilder::CheckOutput() {
+  if (output_.HadError()) {
+    return absl::DataLossError("failed to write to the output stream");
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<ContainerProto> Encode(absl::Span<const TypedValue> values,
                                       absl::Span<const ExprNodePtr> exprs,
-                                      ValueEncoder value_encoder) {
+                                      ValueEncoder value_encoder,
+                                      const EncodingOptions& options) {
   ContainerProto result;
-  Encoder encoder(value_encoder, result);
+  ContainerProtoBuilder container_builder(result);
+  RETURN_IF_ERROR(Encode(values, exprs, std::move(value_encoder),
+                         container_builder, options));
+  return result;
+}
+
+absl::Status Encode(absl::Span<const TypedValue> values,
+                    absl::Span<const ExprNodePtr> exprs,
+                    ValueEncoder value_encoder,
+                    ContainerBuilder& container_builder,
+                    const EncodingOptions& options) {
+  Encoder encoder(std::move(value_encoder), container_builder, options);
   for (const auto& value : values) {
     ASSIGN_OR_RETURN(auto value_idx, encoder.EncodeValue(value));
-    result.add_output_value_indices(value_idx);
+    RETURN_IF_ERROR(container_builder.AddOutputValueIndex(value_idx));
   }
   for (const auto& expr : exprs) {
     ASSIGN_OR_RETURN(auto expr_idx, encoder.EncodeExpr(expr));
-    result.add_output_expr_indices(expr_idx);
+    RETURN_IF_ERROR(container_builder.AddOutputExprIndex(expr_idx));
   }
-  return result;
+  return absl::OkStatus();
 }
 
-Encoder::Encoder(ValueEncoder value_encoder, ContainerProto& container_proto)
-    : value_encoder_(std::move(value_encoder)),
-      container_proto_(container_proto) {
-  container_proto_.set_version(kContainerVersion);
+absl::Status EncodeToStream(
+    absl::Span<const TypedValue> values, absl::Span<const ExprNodePtr> exprs,
+    ValueEncoder value_encoder,
+    google::protobuf::io::ZeroCopyOutputStream* output,
+    const EncodingOptions& options) {
+  ContainerStreamBuilder container_builder(output);
+  RETURN_IF_ERROR(Encode(values, exprs, std::move(value_encoder),
+                         container_builder, options));
+  return container_builder.Finish();
 }
 
+Encoder::Encoder(ValueEncoder value_encoder, ContainerProto& container_proto,
+                 const EncodingOptions& options)
+    : value_encoder_(std::move(value_encoder)),
+      options_(options),
+      owned_container_builder_(
+          std::make_unique<ContainerProtoBuilder>(container_proto)),
+      container_builder_(*owned_container_builder_) {}
+
+Encoder::Encoder(ValueEncoder value_encoder,
+                 ContainerBuilder& container_builder,
+                 const EncodingOptions& options)
+    : value_encoder_(std::move(value_encoder)),
+      options_(options),
+      container_builder_(container_builder) {}
+
 int64_t Encoder::EncodeCodec(absl::string_view codec) {
   auto it = known_codecs_.find(codec);
   if (it == known_codecs_.end()) {
     it = known_codecs_.emplace(codec, known_codecs_.size()).first;
-    DCHECK(container_proto_.codecs().size() == it->second);
-    container_proto_.add_codecs()->set_name(codec.data(), codec.size());
+    CodecProto codec_proto;
+    codec_proto.set_name(codec.data(), codec.size());
+    auto status = container_builder_.AddCodec(std::move(codec_proto));
+    if (!status.ok() && codec_status_.ok()) {
+      codec_status_ = std::move(status);
+    }
   }
   return it->second;
 }
@@ -74,11 +211,13 @@ absl::StatusOr<int64_t> Encoder::EncodeValue(const TypedValue& value) {
   auto it = known_values_.find(fingerprint);
   if (it == known_values_.end()) {
     ASSIGN_OR_RETURN(auto value_proto, value_encoder_(value.AsRef(), *this));
-    *container_proto_.add_decoding_steps()->mutable_value() =
-        std::move(value_proto);
-    it = known_values_
-             .emplace(fingerprint, container_proto_.decoding_steps().size() - 1)
-             .first;
+    RETURN_IF_ERROR(codec_status_);
+    DecodingStepProto decoding_step;
+    *decoding_step.mutable_value() = std::move(value_proto);
+    ASSIGN_OR_RETURN(
+        auto value_index,
+        container_builder_.AddDecodingStep(std::move(decoding_step)));
+    it = known_values_.emplace(fingerprint, value_index).first;
   }
   return it->second;
 }
@@ -118,28 +257,33 @@ absl::Status Encoder::EncodeExprNode(const ExprNode& expr_node) {
 
 absl::Status Encoder::EncodeLiteralNode(const ExprNode& expr_node) {
   ASSIGN_OR_RETURN(auto value_index, EncodeValue(*expr_node.qvalue()));
-  container_proto_.add_decoding_steps()
-      ->mutable_literal_node()
-      ->set_literal_value_index(value_index);
-  known_exprs_.emplace(expr_node.fingerprint(),
-                       container_proto_.decoding_steps().size() - 1);
+  DecodingStepProto decoding_step;
+  decoding_step.mutable_literal_node()->set_literal_value_index(value_index);
+  ASSIGN_OR_RETURN(
+      auto expr_index,
+      container_builder_.AddDecodingStep(std::move(decoding_step)));
+  known_exprs_.emplace(expr_node.fingerprint(), expr_index);
   return absl::OkStatus();
 }
 
 absl::Status Encoder::EncodeLeafNode(const ExprNode& expr_node) {
-  container_proto_.add_decoding_steps()->mutable_leaf_node()->set_leaf_key(
-      expr_node.leaf_key());
-  known_exprs_.emplace(expr_node.fingerprint(),
-                       container_proto_.decoding_steps().size() - 1);
+  DecodingStepProto decoding_step;
+  decoding_step.mutable_leaf_node()->set_leaf_key(expr_node.leaf_key());
+  ASSIGN_OR_RETURN(
+      auto expr_index,
+      container_builder_.AddDecodingStep(std::move(decoding_step)));
+  known_exprs_.emplace(expr_node.fingerprint(), expr_index);
   return absl::OkStatus();
 }
 
 absl::Status Encoder::EncodePlaceholderNode(const ExprNode& expr_node) {
-  container_proto_.add_decoding_steps()
-      ->mutable_placeholder_node()
-      ->set_placeholder_key(expr_node.placeholder_key());
-  known_exprs_.emplace(expr_node.fingerprint(),
-                       container_proto_.decoding_steps().size() - 1);
+  DecodingStepProto decoding_step;
+  decoding_step.mutable_placeholder_node()->set_placeholder_key(
+      expr_node.placeholder_key());
+  ASSIGN_OR_RETURN(
+      auto expr_index,
+      container_builder_.AddDecodingStep(std::move(decoding_step)));
+  known_exprs_.emplace(expr_node.fingerprint(), expr_index);
   return absl::OkStatus();
 }
 
@@ -157,9 +301,10 @@ absl::Status Encoder::EncodeOperatorNode(const ExprNode& expr_node) {
     }
     operator_node_proto->add_input_expr_indices(it->second);
   }
-  *container_proto_.add_decoding_steps() = std::move(decoding_step);
-  known_exprs_.emplace(expr_node.fingerprint(),
-                       container_proto_.decoding_steps().size() - 1);
+  ASSIGN_OR_RETURN(
+      auto expr_index,
+      container_builder_.AddDecodingStep(std::move(decoding_step)));
+  known_exprs_.emplace(expr_node.fingerprint(), expr_index);
   return absl::OkStatus();
 }
 
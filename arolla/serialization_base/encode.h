@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
@@ -29,11 +30,29 @@
 #include "arolla/qtype/typed_value.h"
 #include "arolla/serialization_base/base.pb.h"
 #include "arolla/util/fingerprint.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/message_lite.h"
 
 namespace arolla::serialization_base {
 
 class Encoder;
 
+// Extra options for encoding.
+struct EncodingOptions {
+  // Encode the large DenseArrays of numbers and strings using the raw
+  // little-endian fields (see DenseArrayV1Proto.raw_values). It speeds up
+  // decoding, but the decoders built before the fields were introduced cannot
+  // read the result.
+  bool dense_array_raw_values = false;
+
+  // Encode the large decision forests in the columnar form (see
+  // DecisionForestV1Proto.CompactDecisionForest). It is smaller and faster to
+  // decode, but the decoders built before the form was introduced cannot read
+  // the result.
+  bool compact_decision_forests = false;
+};
+
 // Returns a ValueProto corresponding to the `value`.
 //
 // This type represents a stateless value-encoder. The value-encoder can
@@ -50,11 +69,94 @@ class Encoder;
 using ValueEncoder =
     std::function<absl::StatusOr<ValueProto>(TypedRef value, Encoder& encoder)>;
 
+// A sink for the parts of a ContainerProto produced by the Encoder.
+//
+// The parts arrive in a valid decoding order: each codec and decoding step is
+// added before the first decoding step that refers to it.
+class ContainerBuilder {
+ public:
+  virtual ~ContainerBuilder() = default;
+
+  // Adds a codec; its index is the number of previously added codecs.
+  virtual absl::Status AddCodec(CodecProto codec_proto) = 0;
+
+  // Adds a decoding step and returns its index.
+  virtual absl::StatusOr<int64_t> AddDecodingStep(
+      DecodingStepProto decoding_step_proto) = 0;
+
+  // Marks the given decoding step as an output value.
+  virtual absl::Status AddOutputValueIndex(int64_t value_index) = 0;
+
+  // Marks the given decoding step as an output expression.
+  virtual absl::Status AddOutputExprIndex(int64_t expr_index) = 0;
+};
+
+// ContainerBuilder that stores the parts into a ContainerProto.
+class ContainerProtoBuilder final : public ContainerBuilder {
+ public:
+  explicit ContainerProtoBuilder(ContainerProto& container_proto);
+
+  absl::Status AddCodec(CodecProto codec_proto) final;
+  absl::StatusOr<int64_t> AddDecodingStep(
+      DecodingStepProto decoding_step_proto) final;
+  absl::Status AddOutputValueIndex(int64_t value_index) final;
+  absl::Status AddOutputExprIndex(int64_t expr_index) final;
+
+ private:
+  ContainerProto& container_proto_;
+};
+
+// ContainerBuilder that writes the parts to a stream as they arrive.
+//
+// The stream content is the wire format of a ContainerProto, so it can be read
+// back with DecodeFromStream() or parsed as a regular ContainerProto. Only one
+// decoding step is kept in memory at a time.
+class ContainerStreamBuilder final : public ContainerBuilder {
+ public:
+  explicit ContainerStreamBuilder(
+      google::protobuf::io::ZeroCopyOutputStream* output);
+
+  absl::Status AddCodec(CodecProto codec_proto) final;
+  absl::StatusOr<int64_t> AddDecodingStep(
+      DecodingStepProto decoding_step_proto) final;
+  absl::Status AddOutputValueIndex(int64_t value_index) final;
+  absl::Status AddOutputExprIndex(int64_t expr_index) final;
+
+  // Flushes the buffered data to the underlying stream. No parts can be added
+  // after this call.
+  absl::Status Finish();
+
+ private:
+  absl::Status WriteMessage(int field_number,
+                            const google::protobuf::MessageLite& message);
+  absl::Status WriteInt64(int field_number, int64_t value);
+  absl::Status CheckOutput();
+
+  google::protobuf::io::CodedOutputStream output_;
+  int64_t decoding_step_count_ = 0;
+};
+
 // Encodes values and expressions to ContainerProto.
 absl::StatusOr<ContainerProto> Encode(
     absl::Span<const TypedValue> values,
     absl::Span<const arolla::expr::ExprNodePtr> exprs,
-    ValueEncoder value_encoder);
+    ValueEncoder value_encoder,
+    const EncodingOptions& options = EncodingOptions());
+
+// Encodes values and expressions into the given container builder.
+absl::Status Encode(absl::Span<const TypedValue> values,
+                    absl::Span<const arolla::expr::ExprNodePtr> exprs,
+                    ValueEncoder value_encoder,
+                    ContainerBuilder& container_builder,
+                    const EncodingOptions& options = EncodingOptions());
+
+// Encodes values and expressions and writes the resulting ContainerProto to
+// the `output` stream incrementally, without materializing it in memory.
+absl::Status EncodeToStream(absl::Span<const TypedValue> values,
+                            absl::Span<const arolla::expr::ExprNodePtr> exprs,
+                            ValueEncoder value_encoder,
+                            google::protobuf::io::ZeroCopyOutputStream* output,
+                            const EncodingOptions& options = EncodingOptions());
 
 // Encoder class.
 //
@@ -85,7 +187,13 @@ absl::StatusOr<ContainerProto> Encode(
 class Encoder {
  public:
   // Construct an instance that writes data to the given `container_proto`.
-  explicit Encoder(ValueEncoder value_encoder, ContainerProto& container_proto);
+  explicit Encoder(ValueEncoder value_encoder, ContainerProto& container_proto,
+                   const EncodingOptions& options = EncodingOptions());
+
+  // Construct an instance that passes data to the given `container_builder`.
+  explicit Encoder(ValueEncoder value_encoder,
+                   ContainerBuilder& container_builder,
+                   const EncodingOptions& options = EncodingOptions());
   virtual ~Encoder() = default;
 
   // Non-copyable/non-movable.
@@ -93,6 +201,9 @@ class Encoder {
   Encoder& operator=(const Encoder&) = delete;
 
   // Encodes a codec name and returns its index.
+  //
+  // If the container builder fails to store the codec, the error is reported
+  // by the subsequent EncodeValue() / EncodeExpr() call.
   int64_t EncodeCodec(absl::string_view codec);
 
   // Encodes a value and returns its index.
@@ -104,6 +215,9 @@ class Encoder {
   // Encodes an expression and returns its index.
   absl::StatusOr<int64_t> EncodeExpr(const arolla::expr::ExprNodePtr& expr);
 
+  // Options of the encoding; value encoders use them to choose the format.
+  const EncodingOptions& options() const { return options_; }
+
  private:
   // Serializes 'push' of a single EXPR node (all dependencies have to be
   // pre-serialized).
@@ -120,8 +234,16 @@ class Encoder {
   // Value encoder.
   ValueEncoder value_encoder_;
 
-  // Target proto container.
-  ContainerProto& container_proto_;
+  EncodingOptions options_;
+
+  // Owned builder for the ContainerProto constructor.
+  std::unique_ptr<ContainerProtoBuilder> owned_container_builder_;
+
+  // Target container.
+  ContainerBuilder& container_builder_;
+
+  // The first error reported by the container builder from EncodeCodec().
+  absl::Status codec_status_;
 
   // Mapping from a codec name to its index.
   absl::flat_hash_map<std::string, int64_t> known_codecs_;
@@ -15,6 +15,7 @@
 #include "arolla/serialization_base/encode.h"
 
 #include <memory>
+#include <string>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -30,6 +31,7 @@
 #include "arolla/serialization_base/base.pb.h"
 #include "arolla/util/testing/equals_proto.h"
 #include "arolla/util/testing/status_matchers_backport.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 
 namespace arolla::serialization_base {
 namespace {
@@ -206,5 +208,41 @@ TEST_F(EncoderTest, EncodeValue) {
                           )pb"));
 }
 
+absl::StatusOr<ValueProto> EncodeValueWithCodec(TypedRef, Encoder& encoder) {
+  ValueProto value_proto;
+  value_proto.set_codec_index(encoder.EncodeCodec("codec"));
+  return value_proto;
+}
+
+TEST(EncodeToStreamTest, MatchesEncode) {
+  ExprOperatorPtr dummy_op = std::make_shared<DummyOp>(
+      "dummy_op", ExprOperatorSignature::MakeVariadicArgs());
+  ASSERT_OK_AND_ASSIGN(
+      auto expr, BindOp(dummy_op, {Leaf("x"), Literal(1.0f), Placeholder("p")},
+                        {}));
+  const TypedValue values[] = {TypedValue::FromValue(2.0f),
+                               TypedValue::FromValue(1.0f)};
+  ASSERT_OK_AND_ASSIGN(auto expected_proto,
+                       Encode(values, {expr}, EncodeValueWithCodec));
+
+  std::string buffer;
+  {
+    google::protobuf::io::StringOutputStream output(&buffer);
+    ASSERT_OK(EncodeToStream(values, {expr}, EncodeValueWithCodec, &output));
+  }
+  ContainerProto actual_proto;
+  ASSERT_TRUE(actual_proto.ParseFromString(buffer));
+  EXPECT_EQ(actual_proto.SerializeAsString(),
+            expected_proto.SerializeAsString());
+}
+
+TEST(EncodeToStreamTest, OutputError) {
+  char buffer[4];
+  google::protobuf::io::ArrayOutputStream output(buffer, sizeof(buffer));
+  EXPECT_THAT(EncodeToStream({TypedValue::FromValue(1.0f)}, {},
+                             EncodeValueWithCodec, &output),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
 }  // namespace
 }  // namespace arolla::serialization_base
@@ -0,0 +1,43 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/serialization_base/payload.h"
+
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "arolla/serialization_base/base.pb.h"
+
+namespace arolla::serialization_base {
+
+absl::StatusOr<PayloadSection> ResolvePayloadRef(
+    const PayloadSection* payload_section, const PayloadRefProto& ref) {
+  if (payload_section == nullptr) {
+    return absl::InvalidArgumentError(
+        "payload reference found, but no payload section is provided");
+  }
+  const int64_t section_size = payload_section->data.size();
+  if (ref.offset() < 0 || ref.size() < 0 || ref.offset() > section_size ||
+      ref.size() > section_size - ref.offset()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "payload reference [%d, %d) is out of the payload section of size %d",
+        ref.offset(), ref.offset() + ref.size(), section_size));
+  }
+  return PayloadSection{payload_section->owner,
+                        payload_section->data.substr(ref.offset(), ref.size())};
+}
+
+}  // namespace arolla::serialization_base
@@ -0,0 +1,43 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_SERIALIZATION_BASE_PAYLOAD_H_
+#define AROLLA_SERIALIZATION_BASE_PAYLOAD_H_
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/serialization_base/base.pb.h"
+
+namespace arolla::serialization_base {
+
+// A memory region that stores large value payloads outside of ContainerProto.
+// Value protos refer to it using PayloadRefProto.
+struct PayloadSection {
+  // Keeps `data` alive; can be shared with the decoded values to avoid
+  // copying the payloads.
+  RawBufferPtr owner;
+  absl::string_view data;
+};
+
+// Returns the part of `payload_section` referenced by `ref`. Returns an error
+// if `payload_section` is nullptr or if the reference is out of its bounds.
+//
+// Intended to be called from PayloadValueDecoders (see decode.h).
+absl::StatusOr<PayloadSection> ResolvePayloadRef(
+    const PayloadSection* payload_section, const PayloadRefProto& ref);
+
+}  // namespace arolla::serialization_base
+
+#endif  // AROLLA_SERIALIZATION_BASE_PAYLOAD_H_
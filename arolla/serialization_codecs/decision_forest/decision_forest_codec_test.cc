@@ -34,6 +34,7 @@
 #include "arolla/serialization/encode.h"
 #include "arolla/serialization_base/base.pb.h"
 #include "arolla/serialization_base/decode.h"
+#include "arolla/serialization_codecs/decision_forest/decision_forest_codec.pb.h"
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/testing/equals_proto.h"
 #include "arolla/util/testing/status_matchers_backport.h"
@@ -198,5 +199,74 @@ TEST(DecisionForestCodec, DecisionForestQType) {
               TypedValueWith<QTypePtr>(GetQType<DecisionForestPtr>()));
 }
 
+// A forest big enough to be encoded as CompactDecisionForest.
+DecisionForestPtr CreateBigForest() {
+  constexpr int kTreeCount = 200;
+  std::vector<DecisionTree> trees(kTreeCount);
+  for (int i = 0; i < kTreeCount; ++i) {
+    DecisionTree& tree = trees[i];
+    tree.adjustments = {0.5f * i, 1.5, 2.5, 3.5, -1.0f * i};
+    tree.split_nodes = {
+        {S(1), S(2), IntervalSplit(0, 1.5, kInf)},
+        {A(0), S(3), SetOfValuesSplit<int64_t>(1, {5, i}, i % 2 == 0)},
+        {A(2), A(3), IntervalSplit(i % 3, -kInf, i)},
+        {A(1), A(4), IntervalSplit(2, -1, 1)}};
+    tree.weight = 0.25f * i;
+    tree.tag.step = i / 10;
+    tree.tag.submodel_id = i % 2;
+  }
+  return DecisionForest::FromTrees(std::move(trees)).value();
+}
+
+TEST(DecisionForestCodec, CompactDecisionForest) {
+  ASSERT_OK(InitArolla());
+  DecisionForestPtr forest = CreateBigForest();
+  {
+    // The compact form is opt-in, so the older decoders can read the default
+    // output.
+    ASSERT_OK_AND_ASSIGN(
+        arolla::serialization_base::ContainerProto proto,
+        serialization::Encode({TypedValue::FromValue(forest)}, {}));
+    ASSERT_EQ(proto.decoding_steps_size(), 1);
+    EXPECT_TRUE(proto.decoding_steps(0)
+                    .value()
+                    .GetExtension(
+                        serialization_codecs::DecisionForestV1Proto::extension)
+                    .has_forest());
+  }
+  ASSERT_OK_AND_ASSIGN(
+      arolla::serialization_base::ContainerProto proto,
+      serialization::Encode({TypedValue::FromValue(forest)}, {},
+                            {.compact_decision_forests = true}));
+  ASSERT_EQ(proto.decoding_steps_size(), 1);
+  const auto& forest_proto = proto.decoding_steps(0).value().GetExtension(
+      serialization_codecs::DecisionForestV1Proto::extension);
+  ASSERT_TRUE(forest_proto.has_compact_forest());
+  EXPECT_EQ(forest_proto.compact_forest().weights_size(), 200);
+  ASSERT_OK_AND_ASSIGN(serialization_base::DecodeResult res,
+                       serialization::Decode(proto));
+  ASSERT_EQ(res.values.size(), 1);
+  ASSERT_OK_AND_ASSIGN(DecisionForestPtr res_forest,
+                       res.values[0].As<DecisionForestPtr>());
+  EXPECT_EQ(forest->fingerprint(), res_forest->fingerprint())
+      << ToDebugString(*forest) << "\nvs\n"
+      << ToDebugString(*res_forest);
+  // Identical interval conditions are shared.
+  EXPECT_EQ(res_forest->GetTrees()[0].split_nodes[0].condition,
+            res_forest->GetTrees()[1].split_nodes[0].condition);
+
+  proto.mutable_decoding_steps(0)
+      ->mutable_value()
+      ->MutableExtension(serialization_codecs::DecisionForestV1Proto::extension)
+      ->mutable_compact_forest()
+      ->mutable_interval_lefts()
+      ->pop_back();
+  EXPECT_THAT(serialization::Decode(proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       ::testing::HasSubstr(
+                           "CompactDecisionForest.interval_lefts: expected "
+                           "2400 bytes, got 2399")));
+}
+
 }  // namespace
 }  // namespace arolla::testing
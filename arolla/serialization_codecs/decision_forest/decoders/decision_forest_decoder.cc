@@ -12,16 +12,23 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/decision_forest/expr_operator/forest_model.h"
@@ -58,6 +65,11 @@ DecisionTreeNodeId NodeIdFromProto(const DecisionForestV1Proto::NodeId id) {
   }
 }
 
+DecisionTreeNodeId NodeIdFromRawIndex(int64_t raw_index) {
+  return raw_index < 0 ? DecisionTreeNodeId::AdjustmentId(-raw_index - 1)
+                       : DecisionTreeNodeId::SplitNodeId(raw_index);
+}
+
 absl::StatusOr<std::shared_ptr<const SplitCondition>> SplitConditionFromProto(
     const DecisionForestV1Proto::SplitNode& node_proto) {
   switch (node_proto.condition_case()) {
@@ -103,6 +115,169 @@ absl::StatusOr<DecisionForestPtr> DecisionForestFromProto(
   return DecisionForest::FromTrees(std::move(trees));
 }
 
+// A little-endian column of CompactDecisionForest.
+template <typename T>
+class Column {
+ public:
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  static absl::StatusOr<Column> Create(absl::string_view name,
+                                       absl::string_view data, int64_t size) {
+    if (data.size() != size * sizeof(T)) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "CompactDecisionForest.%s: expected %d bytes, got %d", name,
+          size * sizeof(T), data.size()));
+    }
+    return Column(data);
+  }
+
+  T operator[](int64_t i) const {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, data_.data() + i * sizeof(T), sizeof(T));
+    if constexpr (std::endian::native == std::endian::big) {
+      std::reverse(bytes, bytes + sizeof(T));
+    }
+    T result;
+    std::memcpy(&result, bytes, sizeof(T));
+    return result;
+  }
+
+ private:
+  explicit Column(absl::string_view data) : data_(data) {}
+
+  absl::string_view data_;
+};
+
+absl::StatusOr<DecisionForestPtr> DecisionForestFromCompactProto(
+    const DecisionForestV1Proto::CompactDecisionForest& proto) {
+  const int64_t tree_count = proto.weights_size();
+  if (proto.steps_size() != tree_count ||
+      proto.submodel_ids_size() != tree_count ||
+      proto.split_node_counts_size() != tree_count ||
+      proto.adjustment_counts_size() != tree_count) {
+    return absl::InvalidArgumentError(
+        "CompactDecisionForest: inconsistent number of trees");
+  }
+  int64_t split_node_count = 0;
+  int64_t adjustment_count = 0;
+  for (int64_t i = 0; i < tree_count; ++i) {
+    if (proto.split_node_counts(i) < 0 || proto.adjustment_counts(i) < 0) {
+      return absl::InvalidArgumentError(
+          "CompactDecisionForest: negative number of nodes");
+    }
+    split_node_count += proto.split_node_counts(i);
+    adjustment_count += proto.adjustment_counts(i);
+  }
+  ASSIGN_OR_RETURN(auto children_if_false,
+                   Column<int32_t>::Create("children_if_false",
+                                           proto.children_if_false(),
+                                           split_node_count));
+  ASSIGN_OR_RETURN(auto children_if_true,
+                   Column<int32_t>::Create("children_if_true",
+                                           proto.children_if_true(),
+                                           split_node_count));
+  ASSIGN_OR_RETURN(auto input_ids,
+                   Column<int32_t>::Create("input_ids", proto.input_ids(),
+                                           split_node_count));
+  ASSIGN_OR_RETURN(auto condition_kinds,
+                   Column<uint8_t>::Create("condition_kinds",
+                                           proto.condition_kinds(),
+                                           split_node_count));
+  ASSIGN_OR_RETURN(auto adjustments,
+                   Column<float>::Create("adjustments", proto.adjustments(),
+                                         adjustment_count));
+  const int64_t set_count = std::count(
+      proto.condition_kinds().begin(), proto.condition_kinds().end(),
+      static_cast<char>(DecisionForestV1Proto::SET_OF_VALUES_INT64));
+  const int64_t interval_count = split_node_count - set_count;
+  ASSIGN_OR_RETURN(auto interval_lefts,
+                   Column<float>::Create("interval_lefts",
+                                         proto.interval_lefts(),
+                                         interval_count));
+  ASSIGN_OR_RETURN(auto interval_rights,
+                   Column<float>::Create("interval_rights",
+                                         proto.interval_rights(),
+                                         interval_count));
+  ASSIGN_OR_RETURN(auto set_results_if_missed,
+                   Column<uint8_t>::Create("set_results_if_missed",
+                                           proto.set_results_if_missed(),
+                                           set_count));
+  if (proto.set_value_counts_size() != set_count) {
+    return absl::InvalidArgumentError(
+        "CompactDecisionForest: inconsistent number of set_value_counts");
+  }
+
+  // Nodes with the same interval condition share one SplitCondition instance,
+  // which saves allocations for forests with the quantized thresholds.
+  absl::flat_hash_map<std::tuple<int32_t, uint32_t, uint32_t>,
+                      std::shared_ptr<const SplitCondition>>
+      interval_conditions;
+  std::vector<DecisionTree> trees(tree_count);
+  int64_t node_offset = 0;
+  int64_t adjustment_offset = 0;
+  int64_t interval_offset = 0;
+  int64_t set_offset = 0;
+  int64_t set_value_offset = 0;
+  for (int64_t i = 0; i < tree_count; ++i) {
+    DecisionTree& tree = trees[i];
+    tree.weight = proto.weights(i);
+    tree.tag.step = proto.steps(i);
+    tree.tag.submodel_id = proto.submodel_ids(i);
+    tree.adjustments.resize(proto.adjustment_counts(i));
+    for (float& adjustment : tree.adjustments) {
+      adjustment = adjustments[adjustment_offset++];
+    }
+    tree.split_nodes.resize(proto.split_node_counts(i));
+    for (SplitNode& node : tree.split_nodes) {
+      const int64_t j = node_offset++;
+      node.child_if_false = NodeIdFromRawIndex(children_if_false[j]);
+      node.child_if_true = NodeIdFromRawIndex(children_if_true[j]);
+      switch (condition_kinds[j]) {
+        case DecisionForestV1Proto::INTERVAL: {
+          const float left = interval_lefts[interval_offset];
+          const float right = interval_rights[interval_offset];
+          ++interval_offset;
+          auto& condition = interval_conditions[std::tuple(
+              input_ids[j], std::bit_cast<uint32_t>(left),
+              std::bit_cast<uint32_t>(right))];
+          if (condition == nullptr) {
+            condition = IntervalSplit(input_ids[j], left, right);
+          }
+          node.condition = condition;
+          break;
+        }
+        case DecisionForestV1Proto::SET_OF_VALUES_INT64: {
+          const int64_t value_count = proto.set_value_counts(set_offset);
+          if (value_count < 0 ||
+              value_count > proto.set_values_size() - set_value_offset) {
+            return absl::InvalidArgumentError(
+                "CompactDecisionForest: set_values is too short");
+          }
+          auto values_begin = proto.set_values().begin() + set_value_offset;
+          node.condition = SetOfValuesSplit(
+              input_ids[j],
+              absl::flat_hash_set<int64_t>(values_begin,
+                                           values_begin + value_count),
+              set_results_if_missed[set_offset] != 0);
+          set_value_offset += value_count;
+          ++set_offset;
+          break;
+        }
+        default:
+          return absl::InvalidArgumentError(absl::StrFormat(
+              "CompactDecisionForest: unknown condition kind %d",
+              condition_kinds[j]));
+      }
+    }
+  }
+  if (set_value_offset != proto.set_values_size()) {
+    return absl::InvalidArgumentError(
+        "CompactDecisionForest: unexpected number of set_values");
+  }
+  // `FromTrees` validates the tree structure.
+  return DecisionForest::FromTrees(std::move(trees));
+}
+
 absl::StatusOr<TypedValue> DecodeForestModel(
     const DecisionForestV1Proto::ForestModel& proto,
     absl::Span<const TypedValue> input_values,
@@ -177,6 +352,12 @@ absl::StatusOr<ValueDecoderResult> DecodeDecisionForest(
                        DecisionForestFromProto(forest_proto.forest()));
       return TypedValue::FromValue(std::move(forest));
     }
+    case DecisionForestV1Proto::kCompactForest: {
+      ASSIGN_OR_RETURN(
+          DecisionForestPtr forest,
+          DecisionForestFromCompactProto(forest_proto.compact_forest()));
+      return TypedValue::FromValue(std::move(forest));
+    }
     case DecisionForestV1Proto::kForestModel: {
       return DecodeForestModel(forest_proto.forest_model(), input_values,
                                input_exprs);
@@ -12,7 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -45,6 +50,31 @@ using ::arolla::serialization_base::Encoder;
 using ::arolla::serialization_base::ValueProto;
 using ::arolla::serialization_codecs::DecisionForestV1Proto;
 
+// If EncodingOptions::compact_decision_forests is set, forests with at least
+// this number of split nodes are encoded as CompactDecisionForest. The smaller
+// ones keep the per-node encoding, since the columns don't pay off for them.
+constexpr int64_t kCompactForestMinSplitNodes = 1024;
+
+// Appends `value` to a little-endian column of CompactDecisionForest.
+template <typename T>
+void AppendToColumn(T value, std::string& column) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  if constexpr (std::endian::native == std::endian::big) {
+    std::reverse(bytes, bytes + sizeof(T));
+  }
+  column.append(bytes, sizeof(T));
+}
+
+int64_t SplitNodeCount(const DecisionForest& forest) {
+  int64_t result = 0;
+  for (const auto& tree : forest.GetTrees()) {
+    result += tree.split_nodes.size();
+  }
+  return result;
+}
+
 void NodeIdToProto(const DecisionTreeNodeId node_id,
                    DecisionForestV1Proto::NodeId& proto) {
   if (node_id.is_leaf()) {
@@ -98,6 +128,61 @@ absl::Status DecisionForestToProto(
   return absl::OkStatus();
 }
 
+absl::Status DecisionForestToCompactProto(
+    const DecisionForest& forest,
+    DecisionForestV1Proto::CompactDecisionForest& proto) {
+  const int64_t split_node_count = SplitNodeCount(forest);
+  proto.mutable_children_if_false()->reserve(split_node_count * 4);
+  proto.mutable_children_if_true()->reserve(split_node_count * 4);
+  proto.mutable_input_ids()->reserve(split_node_count * 4);
+  proto.mutable_condition_kinds()->reserve(split_node_count);
+  for (const auto& tree : forest.GetTrees()) {
+    proto.add_weights(tree.weight);
+    proto.add_steps(tree.tag.step);
+    proto.add_submodel_ids(tree.tag.submodel_id);
+    proto.add_split_node_counts(tree.split_nodes.size());
+    proto.add_adjustment_counts(tree.adjustments.size());
+    for (float v : tree.adjustments) {
+      AppendToColumn(v, *proto.mutable_adjustments());
+    }
+    for (const auto& node : tree.split_nodes) {
+      AppendToColumn<int32_t>(node.child_if_false.raw_index(),
+                              *proto.mutable_children_if_false());
+      AppendToColumn<int32_t>(node.child_if_true.raw_index(),
+                              *proto.mutable_children_if_true());
+      const SplitCondition& condition = *node.condition;
+      if (const auto* as_interval =
+              fast_dynamic_downcast_final<const IntervalSplitCondition*>(
+                  &condition)) {
+        AppendToColumn<int32_t>(as_interval->input_id(),
+                                *proto.mutable_input_ids());
+        AppendToColumn<uint8_t>(DecisionForestV1Proto::INTERVAL,
+                                *proto.mutable_condition_kinds());
+        AppendToColumn(as_interval->left(), *proto.mutable_interval_lefts());
+        AppendToColumn(as_interval->right(), *proto.mutable_interval_rights());
+      } else if (const auto* as_set_int64 = fast_dynamic_downcast_final<
+                     const SetOfValuesSplitCondition<int64_t>*>(&condition)) {
+        AppendToColumn<int32_t>(as_set_int64->input_id(),
+                                *proto.mutable_input_ids());
+        AppendToColumn<uint8_t>(DecisionForestV1Proto::SET_OF_VALUES_INT64,
+                                *proto.mutable_condition_kinds());
+        const auto values = as_set_int64->ValuesAsVector();
+        proto.add_set_value_counts(values.size());
+        for (int64_t v : values) {
+          proto.add_set_values(v);
+        }
+        AppendToColumn<uint8_t>(
+            as_set_int64->GetDefaultResultForMissedInput(),
+            *proto.mutable_set_results_if_missed());
+      } else {
+        return absl::InvalidArgumentError(
+            absl::StrCat("unknown split condition: ", condition.ToString()));
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<ValueProto> EncodeForestModel(const ForestModel& op,
                                              Encoder& encoder) {
   if (op.oob_filters().has_value()) {
@@ -162,8 +247,14 @@ absl::StatusOr<ValueProto> EncodeDecisionForest(TypedRef value,
                      value.As<DecisionForestPtr>());
     auto forest_proto =
         value_proto.MutableExtension(DecisionForestV1Proto::extension);
-    RETURN_IF_ERROR(
-        DecisionForestToProto(*forest, *forest_proto->mutable_forest()));
+    if (encoder.options().compact_decision_forests &&
+        SplitNodeCount(*forest) >= kCompactForestMinSplitNodes) {
+      RETURN_IF_ERROR(DecisionForestToCompactProto(
+          *forest, *forest_proto->mutable_compact_forest()));
+    } else {
+      RETURN_IF_ERROR(
+          DecisionForestToProto(*forest, *forest_proto->mutable_forest()));
+    }
   }
   return value_proto;
 }
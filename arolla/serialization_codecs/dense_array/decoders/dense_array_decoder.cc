@@ -12,11 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <optional>
 #include <type_traits>
 #include <utility>
 
+#include "absl/base/config.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -34,6 +39,7 @@
 #include "arolla/qtype/typed_value.h"
 #include "arolla/serialization/decode.h"
 #include "arolla/serialization_base/decode.h"
+#include "arolla/serialization_base/payload.h"
 #include "arolla/serialization_codecs/dense_array/codec_name.h"
 #include "arolla/serialization_codecs/dense_array/dense_array_codec.pb.h"
 #include "arolla/util/bytes.h"
@@ -48,8 +54,10 @@ namespace {
 namespace bm = ::arolla::bitmap;
 
 using ::arolla::expr::ExprNodePtr;
-using ::arolla::serialization::RegisterValueDecoder;
+using ::arolla::serialization::RegisterPayloadValueDecoder;
 using ::arolla::serialization_base::NoExtensionFound;
+using ::arolla::serialization_base::PayloadSection;
+using ::arolla::serialization_base::ResolvePayloadRef;
 using ::arolla::serialization_base::ValueDecoderResult;
 using ::arolla::serialization_base::ValueProto;
 using ::arolla::serialization_codecs::DenseArrayV1Proto;
@@ -72,6 +80,67 @@ absl::Status CheckRepeatedFieldSize(absl::string_view field_name,
                                                  ", got ", actual_size));
 }
 
+// Copies `raw` bytes holding little-endian `Word`s to `dst`.
+template <typename Word>
+void CopyFromLittleEndian(absl::string_view raw, void* dst) {
+  DCHECK_EQ(raw.size() % sizeof(Word), 0);
+#ifdef ABSL_IS_LITTLE_ENDIAN
+  std::memcpy(dst, raw.data(), raw.size());
+#else
+  for (size_t i = 0; i < raw.size(); i += sizeof(Word)) {
+    std::reverse_copy(raw.data() + i, raw.data() + i + sizeof(Word),
+                      static_cast<char*>(dst) + i);
+  }
+#endif
+}
+
+// Decodes `size` values stored as little-endian `Word`s in `raw`. If `raw`
+// has an owner, the result refers to its memory if possible.
+template <typename T, typename Word = T>
+absl::StatusOr<Buffer<T>> DecodeRawValues(absl::string_view field_name,
+                                          const PayloadSection& raw,
+                                          int64_t size) {
+  // Division instead of multiplication: `size` comes from the proto and
+  // can be arbitrarily large.
+  if (raw.data.size() % sizeof(T) != 0 || raw.data.size() / sizeof(T) != size) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("expected ", size, " items of ", sizeof(T), " bytes in ",
+                     field_name, ", got ", raw.data.size(), " bytes"));
+  }
+#ifdef ABSL_IS_LITTLE_ENDIAN
+  if (raw.owner != nullptr &&
+      reinterpret_cast<uintptr_t>(raw.data.data()) % alignof(T) == 0) {
+    return Buffer<T>(raw.owner,
+                     absl::Span<const T>(
+                         reinterpret_cast<const T*>(raw.data.data()), size));
+  }
+#endif
+  typename Buffer<T>::Builder values_builder(size);
+  CopyFromLittleEndian<Word>(raw.data, values_builder.GetMutableSpan().data());
+  return std::move(values_builder).Build(size);
+}
+
+// Returns either `raw_values` or the payload referenced by `raw_values_ref`,
+// or std::nullopt if none of them is set.
+template <typename Proto>
+auto GetRawValues(const Proto& proto, const PayloadSection* payload_section)
+    -> decltype(proto.raw_values_ref(),
+                absl::StatusOr<std::optional<PayloadSection>>()) {
+  if (proto.has_raw_values_ref()) {
+    return ResolvePayloadRef(payload_section, proto.raw_values_ref());
+  }
+  if (proto.has_raw_values()) {
+    return PayloadSection{nullptr, proto.raw_values()};
+  }
+  return std::nullopt;
+}
+
+// DenseArrayBooleanProto has no `raw_values` field.
+absl::StatusOr<std::optional<PayloadSection>> GetRawValues(
+    const DenseArrayV1Proto::DenseArrayBooleanProto&, const PayloadSection*) {
+  return std::nullopt;
+}
+
 // Deserializes and validates:
 //   * dense_array_size -- number of items in dense_array
 //   * bitmap -- bitmap buffer for dense_array
@@ -94,34 +163,49 @@ absl::Status CheckRepeatedFieldSize(absl::string_view field_name,
   }
 
 absl::StatusOr<TypedValue> DecodeDenseArrayUnitValue(
-    const DenseArrayV1Proto::DenseArrayUnitProto& dense_array_value_proto) {
+    const DenseArrayV1Proto::DenseArrayUnitProto& dense_array_value_proto,
+    const PayloadSection* /*payload_section*/) {
   DECODE_DENSE_ARRAY_HEADER(dense_array_unit)
   return TypedValue::FromValue(
       DenseArray<Unit>{VoidBuffer(dense_array_size), std::move(bitmap)});
 }
 
-#define GEN_DECODE_DENSE_ARRAY_VALUE(NAME, T, FIELD)                     \
-  absl::StatusOr<TypedValue> DecodeDenseArray##NAME##Value(              \
-      const std::decay_t<decltype(DenseArrayV1Proto().FIELD##_value())>& \
-          dense_array_value_proto) {                                     \
-    DECODE_DENSE_ARRAY_HEADER(FIELD)                                     \
-    const int64_t dense_array_count =                                    \
-        bm::CountBits(bitmap, 0, dense_array_size);                      \
-    RETURN_IF_ERROR(CheckRepeatedFieldSize(                              \
-        #FIELD "_value.values", dense_array_value_proto.values_size(),   \
-        dense_array_count));                                             \
-    Buffer<T>::Builder values_builder(dense_array_size);                 \
-    auto values_data = values_builder.GetMutableSpan();                  \
-    int64_t i = 0, j = 0;                                                \
-    bm::Iterate(bitmap, 0, dense_array_size, [&](bool present) {         \
-      if (present) {                                                     \
-        values_data[i] = dense_array_value_proto.values(j++);            \
-      }                                                                  \
-      ++i;                                                               \
-    });                                                                  \
-    return TypedValue::FromValue(                                        \
-        DenseArray<T>{std::move(values_builder).Build(dense_array_size), \
-                      std::move(bitmap)});                               \
+#define GEN_DECODE_DENSE_ARRAY_VALUE(NAME, T, FIELD)                       \
+  absl::StatusOr<TypedValue> DecodeDenseArray##NAME##Value(                \
+      const std::decay_t<decltype(DenseArrayV1Proto().FIELD##_value())>&   \
+          dense_array_value_proto,                                         \
+      const PayloadSection* payload_section) {                             \
+    DECODE_DENSE_ARRAY_HEADER(FIELD)                                       \
+    ASSIGN_OR_RETURN(                                                      \
+        auto raw_values,                                                   \
+        GetRawValues(dense_array_value_proto, payload_section));           \
+    if (raw_values.has_value()) {                                          \
+      RETURN_IF_ERROR(CheckRepeatedFieldSize(                              \
+          #FIELD "_value.values", dense_array_value_proto.values_size(),   \
+          0));                                                             \
+      ASSIGN_OR_RETURN(                                                    \
+          auto values, DecodeRawValues<T>(#FIELD "_value.raw_values",      \
+                                          *raw_values, dense_array_size)); \
+      return TypedValue::FromValue(                                        \
+          DenseArray<T>{std::move(values), std::move(bitmap)});            \
+    }                                                                      \
+    const int64_t dense_array_count =                                      \
+        bm::CountBits(bitmap, 0, dense_array_size);                        \
+    RETURN_IF_ERROR(CheckRepeatedFieldSize(                                \
+        #FIELD "_value.values", dense_array_value_proto.values_size(),     \
+        dense_array_count));                                               \
+    Buffer<T>::Builder values_builder(dense_array_size);                   \
+    auto values_data = values_builder.GetMutableSpan();                    \
+    int64_t i = 0, j = 0;                                                  \
+    bm::Iterate(bitmap, 0, dense_array_size, [&](bool present) {           \
+      if (present) {                                                       \
+        values_data[i] = dense_array_value_proto.values(j++);              \
+      }                                                                    \
+      ++i;                                                                 \
+    });                                                                    \
+    return TypedValue::FromValue(                                          \
+        DenseArray<T>{std::move(values_builder).Build(dense_array_size),   \
+                      std::move(bitmap)});                                 \
   }
 
 GEN_DECODE_DENSE_ARRAY_VALUE(Boolean, bool, dense_array_boolean)
@@ -160,14 +244,90 @@ absl::Status CheckStringsOffsets(absl::string_view field,
   return absl::OkStatus();
 }
 
+// Decodes `characters` or `characters_ref` of a DenseArrayStringProto.
+absl::StatusOr<Buffer<char>> DecodeCharacters(
+    absl::string_view field,
+    const DenseArrayV1Proto::DenseArrayStringProto& dense_array_value_proto,
+    const PayloadSection* payload_section) {
+  if (dense_array_value_proto.has_characters_ref()) {
+    ASSIGN_OR_RETURN(
+        auto characters,
+        ResolvePayloadRef(payload_section,
+                          dense_array_value_proto.characters_ref()));
+    return Buffer<char>(characters.owner,
+                        absl::Span<const char>(characters.data.data(),
+                                               characters.data.size()));
+  }
+  RETURN_IF_ERROR(
+      CheckFieldPresence(absl::StrCat(field, "_value.characters"),
+                         dense_array_value_proto.has_characters()));
+  return Buffer<char>::Create(dense_array_value_proto.characters().begin(),
+                              dense_array_value_proto.characters().end());
+}
+
+// Decodes `raw_value_offsets` or `raw_value_offsets_ref` of
+// a DenseArrayStringProto. Returns std::nullopt if none of them is set.
+absl::StatusOr<std::optional<Buffer<StringsBuffer::Offsets>>>
+DecodeRawStringsOffsets(
+    absl::string_view field,
+    const DenseArrayV1Proto::DenseArrayStringProto& dense_array_value_proto,
+    int64_t size, int64_t characters_size,
+    const PayloadSection* payload_section) {
+  static_assert(sizeof(StringsBuffer::Offsets) == 2 * sizeof(int64_t));
+  PayloadSection raw_offsets;
+  if (dense_array_value_proto.has_raw_value_offsets_ref()) {
+    ASSIGN_OR_RETURN(
+        raw_offsets,
+        ResolvePayloadRef(payload_section,
+                          dense_array_value_proto.raw_value_offsets_ref()));
+  } else if (dense_array_value_proto.has_raw_value_offsets()) {
+    raw_offsets.data = dense_array_value_proto.raw_value_offsets();
+  } else {
+    return std::nullopt;
+  }
+  RETURN_IF_ERROR(CheckRepeatedFieldSize(
+      absl::StrCat(field, "_value.value_offset_starts"),
+      dense_array_value_proto.value_offset_starts_size(), 0));
+  RETURN_IF_ERROR(CheckRepeatedFieldSize(
+      absl::StrCat(field, "_value.value_offset_ends"),
+      dense_array_value_proto.value_offset_ends_size(), 0));
+  ASSIGN_OR_RETURN(
+      auto offsets,
+      (DecodeRawValues<StringsBuffer::Offsets, int64_t>(
+          absl::StrCat(field, "_value.raw_value_offsets"), raw_offsets,
+          size)));
+  for (int64_t i = 0; i < size; ++i) {
+    const auto& offset = offsets[i];
+    if (offset.start < 0 || offset.start > offset.end ||
+        offset.end > characters_size) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "expected items in ", field,
+          "_value.raw_value_offsets to be within .characters of size ",
+          characters_size, ", got [", offset.start, ", ", offset.end,
+          ") at position ", i));
+    }
+  }
+  return offsets;
+}
+
 #define GEN_DECODE_DENSE_ARRAY_STRINGS_VALUE(NAME, T, FIELD)                   \
   absl::StatusOr<TypedValue> DecodeDenseArray##NAME##Value(                    \
-      const DenseArrayV1Proto::DenseArrayStringProto&                          \
-          dense_array_value_proto) {                                           \
+      const DenseArrayV1Proto::DenseArrayStringProto& dense_array_value_proto, \
+      const PayloadSection* payload_section) {                                 \
     DECODE_DENSE_ARRAY_HEADER(FIELD)                                           \
-    RETURN_IF_ERROR(                                                           \
-        CheckFieldPresence(#FIELD "_value.characters",                         \
-                           dense_array_value_proto.has_characters()));         \
+    ASSIGN_OR_RETURN(auto characters,                                          \
+                     DecodeCharacters(#FIELD, dense_array_value_proto,         \
+                                      payload_section));                       \
+    ASSIGN_OR_RETURN(auto raw_offsets,                                         \
+                     DecodeRawStringsOffsets(#FIELD, dense_array_value_proto,  \
+                                             dense_array_size,                 \
+                                             characters.size(),                \
+                                             payload_section));                \
+    if (raw_offsets.has_value()) {                                             \
+      return TypedValue::FromValue(DenseArray<T>{                              \
+          StringsBuffer(*std::move(raw_offsets), std::move(characters)),       \
+          std::move(bitmap)});                                                 \
+    }                                                                          \
     const int64_t dense_array_count =                                          \
         bm::CountBits(bitmap, 0, dense_array_size);                            \
     RETURN_IF_ERROR(CheckRepeatedFieldSize(                                    \
@@ -179,8 +339,7 @@ absl::Status CheckStringsOffsets(absl::string_view field,
         dense_array_value_proto.value_offset_ends_size(), dense_array_count)); \
     RETURN_IF_ERROR(CheckStringsOffsets(                                       \
         #FIELD, dense_array_value_proto.value_offset_starts(),                 \
-        dense_array_value_proto.value_offset_ends(),                           \
-        dense_array_value_proto.characters().size()));                         \
+        dense_array_value_proto.value_offset_ends(), characters.size()));      \
     auto offsets_builder =                                                     \
         Buffer<StringsBuffer::Offsets>::Builder(dense_array_size);             \
     auto offsets_data = offsets_builder.GetMutableSpan();                      \
@@ -195,9 +354,6 @@ absl::Status CheckStringsOffsets(absl::string_view field,
       }                                                                        \
       ++i;                                                                     \
     });                                                                        \
-    auto characters =                                                          \
-        Buffer<char>::Create(dense_array_value_proto.characters().begin(),     \
-                             dense_array_value_proto.characters().end());      \
     return TypedValue::FromValue(DenseArray<T>{                                \
         StringsBuffer(std::move(offsets_builder).Build(dense_array_size),      \
                       std::move(characters)),                                  \
@@ -295,17 +451,19 @@ absl::StatusOr<ValueDecoderResult> DecodeDenseArrayShapeValue(
 
 absl::StatusOr<ValueDecoderResult> DecodeDenseArray(
     const ValueProto& value_proto, absl::Span<const TypedValue> input_values,
-    absl::Span<const ExprNodePtr> input_exprs) {
+    absl::Span<const ExprNodePtr> input_exprs,
+    const PayloadSection* payload_section) {
   if (!value_proto.HasExtension(DenseArrayV1Proto::extension)) {
     return NoExtensionFound();
   }
   const auto& dense_array_proto =
       value_proto.GetExtension(DenseArrayV1Proto::extension);
   switch (dense_array_proto.value_case()) {
-#define GEN_CASE(NAME, T, FIELD)                                             \
-  case DenseArrayV1Proto::kDenseArray##NAME##Value:                          \
-    return DecodeDenseArray##NAME##Value(dense_array_proto.FIELD##_value()); \
-  case DenseArrayV1Proto::kDenseArray##NAME##Qtype:                          \
+#define GEN_CASE(NAME, T, FIELD)                                    \
+  case DenseArrayV1Proto::kDenseArray##NAME##Value:                 \
+    return DecodeDenseArray##NAME##Value(                           \
+        dense_array_proto.FIELD##_value(), payload_section);        \
+  case DenseArrayV1Proto::kDenseArray##NAME##Qtype:                 \
     return TypedValue::FromValue(GetDenseArrayQType<T>());
 
     GEN_CASE(Unit, Unit, dense_array_unit)
@@ -346,7 +504,8 @@ absl::StatusOr<ValueDecoderResult> DecodeDenseArray(
 AROLLA_REGISTER_INITIALIZER(
     kRegisterSerializationCodecs,
     register_serialization_codecs_dense_array_v1_decoder, []() -> absl::Status {
-      return RegisterValueDecoder(kDenseArrayV1Codec, DecodeDenseArray);
+      return RegisterPayloadValueDecoder(kDenseArrayV1Codec,
+                                         DecodeDenseArray);
     });
 
 }  // namespace arolla::serialization_codecs
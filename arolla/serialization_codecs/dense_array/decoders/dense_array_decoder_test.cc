@@ -0,0 +1,159 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/serialization/decode.h"
+#include "arolla/serialization_base/base.pb.h"
+#include "arolla/serialization_codecs/dense_array/codec_name.h"
+#include "arolla/serialization_codecs/dense_array/dense_array_codec.pb.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/text.h"
+
+namespace arolla::serialization_codecs {
+namespace {
+
+using ::arolla::serialization_base::ContainerProto;
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+// Decodes a container with a single DenseArrayV1Proto value.
+absl::StatusOr<TypedValue> DecodeDenseArrayProto(
+    const DenseArrayV1Proto& dense_array_proto) {
+  ContainerProto container_proto;
+  container_proto.set_version(1);
+  container_proto.add_codecs()->set_name(std::string(kDenseArrayV1Codec));
+  auto* value_proto = container_proto.add_decoding_steps()->mutable_value();
+  value_proto->set_codec_index(0);
+  *value_proto->MutableExtension(DenseArrayV1Proto::extension) =
+      dense_array_proto;
+  container_proto.add_output_value_indices(0);
+  return serialization::DecodeValue(container_proto);
+}
+
+// Returns the values as a string of little-endian bytes.
+template <typename T>
+std::string RawBytes(const std::vector<T>& values) {
+  std::string result;
+  for (T value : values) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      result.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+  }
+  return result;
+}
+
+class DecodeDenseArrayTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_OK(InitArolla()); }
+};
+
+TEST_F(DecodeDenseArrayTest, RawValues) {
+  DenseArrayV1Proto dense_array_proto;
+  auto* int32_proto = dense_array_proto.mutable_dense_array_int32_value();
+  int32_proto->set_size(3);
+  int32_proto->add_bitmap(0b101);
+  int32_proto->set_raw_values(RawBytes<int32_t>({1, 0, -3}));
+  ASSERT_OK_AND_ASSIGN(auto value, DecodeDenseArrayProto(dense_array_proto));
+  ASSERT_OK_AND_ASSIGN(auto array, value.As<DenseArray<int32_t>>());
+  EXPECT_THAT(array.get(), ElementsAre(1, std::nullopt, -3));
+}
+
+TEST_F(DecodeDenseArrayTest, MalformedRawValues) {
+  DenseArrayV1Proto dense_array_proto;
+  auto* int64_proto = dense_array_proto.mutable_dense_array_int64_value();
+  int64_proto->set_size(3);
+
+  // Too short.
+  int64_proto->set_raw_values(RawBytes<int64_t>({1, 2}));
+  EXPECT_THAT(DecodeDenseArrayProto(dense_array_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("expected 3 items of 8 bytes in "
+                                 "dense_array_int64_value.raw_values, got 16 "
+                                 "bytes")));
+
+  // Not a multiple of the item size.
+  int64_proto->set_raw_values(std::string(23, '\0'));
+  EXPECT_THAT(DecodeDenseArrayProto(dense_array_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("got 23 bytes")));
+
+  // The byte size of the array overflows int64_t.
+  int64_proto->set_size(int64_t{1} << 61);
+  int64_proto->set_raw_values("");
+  EXPECT_THAT(DecodeDenseArrayProto(dense_array_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("dense_array_int64_value.raw_values")));
+
+  // Both forms of the values.
+  int64_proto->set_size(1);
+  int64_proto->set_raw_values(RawBytes<int64_t>({1}));
+  int64_proto->add_values(1);
+  EXPECT_THAT(DecodeDenseArrayProto(dense_array_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("expected 0 items in "
+                                 "dense_array_int64_value.values, got 1")));
+}
+
+TEST_F(DecodeDenseArrayTest, MalformedRawValueOffsets) {
+  DenseArrayV1Proto dense_array_proto;
+  auto* text_proto = dense_array_proto.mutable_dense_array_text_value();
+  text_proto->set_size(2);
+  text_proto->set_characters("abc");
+
+  text_proto->set_raw_value_offsets(RawBytes<int64_t>({0, 1, 1, 3}));
+  ASSERT_OK_AND_ASSIGN(auto value, DecodeDenseArrayProto(dense_array_proto));
+  ASSERT_OK_AND_ASSIGN(auto array, value.As<DenseArray<Text>>());
+  EXPECT_THAT(array.get(), ElementsAre(Text("a"), Text("bc")));
+
+  // Too short.
+  text_proto->set_raw_value_offsets(RawBytes<int64_t>({0, 1, 1}));
+  EXPECT_THAT(DecodeDenseArrayProto(dense_array_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("dense_array_text_value.raw_value_offsets, "
+                                 "got 24 bytes")));
+
+  // Out of the characters.
+  text_proto->set_raw_value_offsets(RawBytes<int64_t>({0, 1, 1, 4}));
+  EXPECT_THAT(DecodeDenseArrayProto(dense_array_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("to be within .characters of size 3, got "
+                                 "[1, 4) at position 1")));
+
+  // Start after end.
+  text_proto->set_raw_value_offsets(RawBytes<int64_t>({2, 1, 1, 3}));
+  EXPECT_THAT(DecodeDenseArrayProto(dense_array_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("got [2, 1) at position 0")));
+
+  // Negative start.
+  text_proto->set_raw_value_offsets(RawBytes<int64_t>({-1, 1, 1, 3}));
+  EXPECT_THAT(DecodeDenseArrayProto(dense_array_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("got [-1, 1) at position 0")));
+}
+
+}  // namespace
+}  // namespace arolla::serialization_codecs
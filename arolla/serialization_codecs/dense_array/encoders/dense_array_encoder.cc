@@ -12,17 +12,23 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "absl/base/config.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "arolla/dense_array/bitmap.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/edge.h"
@@ -79,6 +85,73 @@ BitmapProto GenBitmapProto(const bm::Bitmap& bitmap, int offset, int64_t size) {
   return result;
 }
 
+// If EncodingOptions::dense_array_raw_values is set, arrays with at least this
+// many items, most of them present, are encoded using `raw_values` /
+// `raw_value_offsets` fields. It makes decoding a single memcpy instead of
+// parsing the items one by one.
+constexpr int64_t kRawEncodingMinSize = 1024;
+
+bool UseRawEncoding(const Encoder& encoder, const bm::Bitmap& bitmap,
+                    int offset, int64_t size) {
+  return encoder.options().dense_array_raw_values &&
+         size >= kRawEncodingMinSize &&
+         2 * bm::CountBits(bitmap, offset, size) >= size;
+}
+
+// Stores `value` at `dst` as little-endian bytes.
+template <typename T>
+void StoreLittleEndian(const T& value, char* dst) {
+  std::memcpy(dst, &value, sizeof(T));
+#ifndef ABSL_IS_LITTLE_ENDIAN
+  std::reverse(dst, dst + sizeof(T));
+#endif
+}
+
+// Returns the values as a string of little-endian bytes.
+template <typename T>
+std::string EncodeRawValues(absl::Span<const T> values) {
+  std::string result(values.size() * sizeof(T), '\0');
+#ifdef ABSL_IS_LITTLE_ENDIAN
+  std::memcpy(result.data(), values.data(), result.size());
+#else
+  for (size_t i = 0; i < values.size(); ++i) {
+    StoreLittleEndian(values[i], result.data() + i * sizeof(T));
+  }
+#endif
+  return result;
+}
+
+// Returns the values of the array as a string of little-endian bytes, with
+// zeros for the missing items. The values buffer is not copied as is because
+// the missing items may be uninitialized.
+template <typename T>
+std::string EncodeRawValues(const DenseArray<T>& dense_array) {
+  std::string result(dense_array.size() * sizeof(T), '\0');
+  dense_array.ForEachPresent([&](int64_t id, const T& value) {
+    StoreLittleEndian(value, result.data() + id * sizeof(T));
+  });
+  return result;
+}
+
+// Sets `raw_values` field of the proto if the raw encoding is applicable.
+template <typename T, typename Proto>
+auto SetRawValues(const Encoder& encoder, const DenseArray<T>& dense_array,
+                  Proto* proto)
+    -> decltype(proto->set_raw_values(std::string()), bool()) {
+  if (!UseRawEncoding(encoder, dense_array.bitmap,
+                      dense_array.bitmap_bit_offset, dense_array.size())) {
+    return false;
+  }
+  proto->set_raw_values(EncodeRawValues(dense_array));
+  return true;
+}
+
+// DenseArrayBooleanProto has no `raw_values` field.
+bool SetRawValues(const Encoder&, const DenseArray<bool>&,
+                  DenseArrayV1Proto::DenseArrayBooleanProto*) {
+  return false;
+}
+
 absl::StatusOr<ValueProto> EncodeDenseArrayUnitValue(TypedRef value,
                                                      Encoder& encoder) {
   DCHECK(value.GetType() == GetQType<DenseArray<Unit>>());
@@ -116,6 +189,9 @@ GEN_ENCODE_DENSE_ARRAY_QTYPE(Unit, dense_array_unit)
     *dense_array_value_proto->mutable_bitmap() =                               \
         GenBitmapProto(dense_array.bitmap, dense_array.bitmap_bit_offset,      \
                        dense_array.size());                                    \
+    if (SetRawValues(encoder, dense_array, dense_array_value_proto)) {         \
+      return value_proto;                                                      \
+    }                                                                          \
     dense_array.ForEach([&](int64_t, bool present, const T& value) {           \
       if (present) {                                                           \
         dense_array_value_proto->add_values(value);                            \
@@ -150,6 +226,20 @@ GEN_ENCODE_DENSE_ARRAY_VALUE(Float64, double, dense_array_float64)
     dense_array_value_proto->set_characters(                                   \
         dense_array.values.characters().span().data(),                         \
         dense_array.values.characters().span().size());                        \
+    if (UseRawEncoding(encoder, dense_array.bitmap,                            \
+                       dense_array.bitmap_bit_offset, dense_array.size())) {   \
+      std::vector<int64_t> offsets(2 * dense_array.size(), 0);                 \
+      for (size_t i = 0; i < dense_array.size(); ++i) {                        \
+        if (dense_array.present(i)) {                                          \
+          const auto& offset = dense_array.values.offsets()[i];                \
+          offsets[2 * i] = offset.start - dense_array.values.base_offset();    \
+          offsets[2 * i + 1] = offset.end - dense_array.values.base_offset();  \
+        }                                                                      \
+      }                                                                        \
+      dense_array_value_proto->set_raw_value_offsets(                          \
+          EncodeRawValues<int64_t>(offsets));                                  \
+      return value_proto;                                                      \
+    }                                                                          \
     for (size_t i = 0; i < dense_array.size(); ++i) {                          \
       if (dense_array.present(i)) {                                            \
         const auto& offset = dense_array.values.offsets()[i];                  \
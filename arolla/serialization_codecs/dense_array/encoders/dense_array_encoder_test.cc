@@ -21,20 +21,27 @@
 //
 //   * handling of dense_array.bitmap_bit_offset != 0
 //   * handling of string_buffer with base_offset != 0
+//   * raw encoding of big arrays
 //
 
 #include <cstdint>
+#include <cstring>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/log/check.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "arolla/dense_array/bitmap.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
+#include "arolla/memory/optional_value.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/serialization/decode.h"
 #include "arolla/serialization/encode.h"
 #include "arolla/serialization_codecs/dense_array/dense_array_codec.pb.h"
 #include "arolla/util/init_arolla.h"
@@ -48,9 +55,11 @@ using ::arolla::serialization_base::ValueProto;
 using ::arolla::serialization_codecs::DenseArrayV1Proto;
 
 template <typename T>
-absl::StatusOr<ValueProto> GenValueProto(const T& value) {
-  ASSIGN_OR_RETURN(auto container_proto,
-                   serialization::Encode({TypedValue::FromValue(value)}, {}));
+absl::StatusOr<ValueProto> GenValueProto(
+    const T& value, const serialization::EncodingOptions& options = {}) {
+  ASSIGN_OR_RETURN(auto container_proto, serialization::Encode(
+                                             {TypedValue::FromValue(value)},
+                                             {}, options));
   CHECK(!container_proto.decoding_steps().empty());
   CHECK(container_proto.decoding_steps().rbegin()->has_value());
   return container_proto.decoding_steps().rbegin()->value();
@@ -107,5 +116,101 @@ TEST_F(EncodeDenseArrayTest, StringBufferBaseOffset) {
               testing::ElementsAre(2, 9));
 }
 
+TEST_F(EncodeDenseArrayTest, RawValues) {
+  std::vector<OptionalValue<float>> values(2000);
+  for (int i = 0; i < values.size(); ++i) {
+    if (i % 3 != 0) {
+      values[i] = i * 0.5f;
+    }
+  }
+  auto arr = CreateDenseArray<float>(values);
+  ASSERT_OK_AND_ASSIGN(auto container_proto,
+                       serialization::Encode({TypedValue::FromValue(arr)}, {},
+                                             {.dense_array_raw_values = true}));
+  const auto& dense_array_float32_proto =
+      container_proto.decoding_steps().rbegin()->value()
+          .GetExtension(DenseArrayV1Proto::extension)
+          .dense_array_float32_value();
+  EXPECT_EQ(dense_array_float32_proto.size(), 2000);
+  EXPECT_TRUE(dense_array_float32_proto.values().empty());
+  EXPECT_EQ(dense_array_float32_proto.raw_values().size(),
+            2000 * sizeof(float));
+
+  ASSERT_OK_AND_ASSIGN(auto decoded,
+                       serialization::DecodeValue(container_proto));
+  ASSERT_OK_AND_ASSIGN(auto decoded_arr, decoded.As<DenseArray<float>>());
+  EXPECT_THAT(decoded_arr.get(), testing::ElementsAreArray(values));
+
+  // Sparse arrays are encoded item by item.
+  std::vector<OptionalValue<float>> sparse_values(2000);
+  sparse_values[7] = 1.0f;
+  ASSERT_OK_AND_ASSIGN(auto sparse_value_proto,
+                       GenValueProto(CreateDenseArray<float>(sparse_values),
+                                     {.dense_array_raw_values = true}));
+  const auto& sparse_float32_proto =
+      sparse_value_proto.GetExtension(DenseArrayV1Proto::extension)
+          .dense_array_float32_value();
+  EXPECT_FALSE(sparse_float32_proto.has_raw_values());
+  EXPECT_THAT(sparse_float32_proto.values(), testing::ElementsAre(1.0f));
+
+  // The raw encoding is opt-in, so the old decoders can read the default
+  // output.
+  ASSERT_OK_AND_ASSIGN(auto default_value_proto, GenValueProto(arr));
+  const auto& default_float32_proto =
+      default_value_proto.GetExtension(DenseArrayV1Proto::extension)
+          .dense_array_float32_value();
+  EXPECT_FALSE(default_float32_proto.has_raw_values());
+  EXPECT_EQ(default_float32_proto.values_size(), arr.PresentCount());
+}
+
+TEST_F(EncodeDenseArrayTest, RawValuesOfMissingItems) {
+  // The values buffer contains garbage at the missing positions, it must not
+  // get into the output.
+  DenseArray<int32_t> arr;
+  arr.values = Buffer<int32_t>::Create(std::vector<int32_t>(2000, 57));
+  std::vector<uint32_t> bitmap(bitmap::BitmapSize(2000), 0xffffffffU);
+  bitmap[1] = 0;
+  arr.bitmap = Buffer<uint32_t>::Create(std::move(bitmap));
+  ASSERT_OK_AND_ASSIGN(auto value_proto,
+                       GenValueProto(arr, {.dense_array_raw_values = true}));
+  const std::string& raw_values =
+      value_proto.GetExtension(DenseArrayV1Proto::extension)
+          .dense_array_int32_value()
+          .raw_values();
+  ASSERT_EQ(raw_values.size(), 2000 * sizeof(int32_t));
+  for (int64_t i = 0; i < 2000; ++i) {
+    int32_t value;
+    std::memcpy(&value, raw_values.data() + i * sizeof(int32_t),
+                sizeof(int32_t));
+    EXPECT_EQ(value, arr.present(i) ? 57 : 0) << i;
+  }
+}
+
+TEST_F(EncodeDenseArrayTest, RawValueOffsets) {
+  std::vector<OptionalValue<Text>> values(2000);
+  for (int i = 0; i < values.size(); ++i) {
+    if (i % 3 != 0) {
+      values[i] = Text(std::string(i % 5, 'a' + i % 7));
+    }
+  }
+  auto arr = CreateDenseArray<Text>(values);
+  ASSERT_OK_AND_ASSIGN(auto container_proto,
+                       serialization::Encode({TypedValue::FromValue(arr)}, {},
+                                             {.dense_array_raw_values = true}));
+  const auto& dense_array_text_proto =
+      container_proto.decoding_steps().rbegin()->value()
+          .GetExtension(DenseArrayV1Proto::extension)
+          .dense_array_text_value();
+  EXPECT_TRUE(dense_array_text_proto.value_offset_starts().empty());
+  EXPECT_TRUE(dense_array_text_proto.value_offset_ends().empty());
+  EXPECT_EQ(dense_array_text_proto.raw_value_offsets().size(),
+            2000 * 2 * sizeof(int64_t));
+
+  ASSERT_OK_AND_ASSIGN(auto decoded,
+                       serialization::DecodeValue(container_proto));
+  ASSERT_OK_AND_ASSIGN(auto decoded_arr, decoded.As<DenseArray<Text>>());
+  EXPECT_THAT(decoded_arr.get(), testing::ElementsAreArray(values));
+}
+
 }  // namespace
 }  // namespace arolla::serialization_codecs
@@ -12,13 +12,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <algorithm>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "arolla/expr/expr_node.h"
+#include "arolla/qtype/dict/bloom_filter.h"
 #include "arolla/qtype/dict/dict_types.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
@@ -84,6 +92,31 @@ absl::StatusOr<TypedValue> DecodeDictQType(
   return TypedValue::FromValue(dict_qtype);
 }
 
+absl::StatusOr<TypedValue> DecodeBloomFilter(
+    const DictV1Proto::BloomFilterProto& filter_proto) {
+  const std::string& data = filter_proto.words();
+  if (data.size() % sizeof(uint32_t) != 0) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "expected BloomFilterProto.words size to be a multiple of %d, got %d; "
+        "value=BLOOM_FILTER",
+        sizeof(uint32_t), data.size()));
+  }
+  std::vector<uint32_t> words(data.size() / sizeof(uint32_t));
+  for (size_t i = 0; i < words.size(); ++i) {
+    char bytes[sizeof(uint32_t)];
+    std::memcpy(bytes, data.data() + i * sizeof(uint32_t), sizeof(uint32_t));
+    if constexpr (std::endian::native == std::endian::big) {
+      std::reverse(bytes, bytes + sizeof(uint32_t));
+    }
+    std::memcpy(&words[i], bytes, sizeof(uint32_t));
+  }
+  ASSIGN_OR_RETURN(
+      BloomFilter filter,
+      BloomFilter::FromWords(filter_proto.size(), std::move(words)),
+      _ << "value=BLOOM_FILTER");
+  return TypedValue::FromValue(std::move(filter));
+}
+
 absl::StatusOr<ValueDecoderResult> DecodeDict(
     const ValueProto& value_proto, absl::Span<const TypedValue> input_values,
     absl::Span<const ExprNodePtr> /*input_exprs*/) {
@@ -96,6 +129,10 @@ absl::StatusOr<ValueDecoderResult> DecodeDict(
       return DecodeKeyToRowDictQType(input_values);
     case DictV1Proto::kDictQtype:
       return DecodeDictQType(input_values);
+    case DictV1Proto::kBloomFilter:
+      return DecodeBloomFilter(dict_proto.bloom_filter());
+    case DictV1Proto::kBloomFilterQtype:
+      return TypedValue::FromValue(GetQType<BloomFilter>());
     case DictV1Proto::VALUE_NOT_SET: {
       return absl::InvalidArgumentError("missing value");
     }
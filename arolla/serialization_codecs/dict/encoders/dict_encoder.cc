@@ -12,13 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <cstring>
+#include <string>
 
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "arolla/qtype/base_types.h"
+#include "arolla/qtype/dict/bloom_filter.h"
 #include "arolla/qtype/dict/dict_types.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
@@ -34,6 +39,7 @@
 namespace arolla::serialization_codecs {
 namespace {
 
+using ::arolla::serialization::RegisterValueEncoderByQType;
 using ::arolla::serialization::RegisterValueEncoderByQValueSpecialisationKey;
 using ::arolla::serialization_base::Encoder;
 using ::arolla::serialization_base::ValueProto;
@@ -81,6 +87,31 @@ absl::StatusOr<ValueProto> EncodeDictQType(QTypePtr dict_qtype,
   return value_proto;
 }
 
+absl::StatusOr<ValueProto> EncodeBloomFilter(TypedRef value,
+                                             Encoder& encoder) {
+  auto value_proto = GenValueProto(encoder);
+  auto* dict_proto = value_proto.MutableExtension(DictV1Proto::extension);
+  if (value.GetType() == GetQType<QTypePtr>()) {
+    DCHECK_EQ(value.UnsafeAs<QTypePtr>(), GetQType<BloomFilter>());
+    dict_proto->set_bloom_filter_qtype(true);
+    return value_proto;
+  }
+  ASSIGN_OR_RETURN(const BloomFilter& filter, value.As<BloomFilter>());
+  auto* filter_proto = dict_proto->mutable_bloom_filter();
+  filter_proto->set_size(filter.size());
+  std::string* words = filter_proto->mutable_words();
+  words->reserve(filter.ByteSize());
+  for (uint32_t word : filter.words()) {
+    char bytes[sizeof(word)];
+    std::memcpy(bytes, &word, sizeof(word));
+    if constexpr (std::endian::native == std::endian::big) {
+      std::reverse(bytes, bytes + sizeof(word));
+    }
+    words->append(bytes, sizeof(word));
+  }
+  return value_proto;
+}
+
 absl::StatusOr<ValueProto> EncodeDict(TypedRef value, Encoder& encoder) {
   if (value.GetType() == GetQType<QTypePtr>()) {
     const auto& qtype_value = value.UnsafeAs<QTypePtr>();
@@ -107,6 +138,8 @@ AROLLA_REGISTER_INITIALIZER(
           key_to_row_dict_qtype->qtype_specialization_key(), EncodeDict));
       RETURN_IF_ERROR(RegisterValueEncoderByQValueSpecialisationKey(
           dict_qtype->qtype_specialization_key(), EncodeDict));
+      RETURN_IF_ERROR(RegisterValueEncoderByQType(GetQType<BloomFilter>(),
+                                                  EncodeBloomFilter));
       return absl::OkStatus();
     });
 
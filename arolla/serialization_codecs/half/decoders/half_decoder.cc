@@ -0,0 +1,179 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/base/casts.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/bitmap.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/half/half_types.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/serialization/decode.h"
+#include "arolla/serialization_base/decode.h"
+#include "arolla/serialization_codecs/half/codec_name.h"
+#include "arolla/serialization_codecs/half/half_codec.pb.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::serialization_codecs {
+namespace {
+
+namespace bm = ::arolla::bitmap;
+
+using ::arolla::expr::ExprNodePtr;
+using ::arolla::serialization::RegisterValueDecoder;
+using ::arolla::serialization_base::NoExtensionFound;
+using ::arolla::serialization_base::ValueDecoderResult;
+using ::arolla::serialization_base::ValueProto;
+using ::arolla::serialization_codecs::HalfV1Proto;
+
+template <typename T>
+absl::StatusOr<T> FromBits(absl::string_view field_name, uint32_t bits) {
+  if (bits > 0xffff) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "expected a 16-bit value in %s, got 0x%x", field_name, bits));
+  }
+  return absl::bit_cast<T>(static_cast<uint16_t>(bits));
+}
+
+template <typename T>
+absl::StatusOr<TypedValue> DecodeValue(absl::string_view field_name,
+                                       uint32_t bits) {
+  ASSIGN_OR_RETURN(T value, FromBits<T>(field_name, bits));
+  return TypedValue::FromValue(value);
+}
+
+template <typename T>
+absl::StatusOr<TypedValue> DecodeOptionalValue(
+    absl::string_view field_name,
+    const HalfV1Proto::OptionalHalfProto& optional_value_proto) {
+  if (!optional_value_proto.has_bits()) {
+    return TypedValue::FromValue(OptionalValue<T>());
+  }
+  ASSIGN_OR_RETURN(T value,
+                   FromBits<T>(absl::StrCat(field_name, ".bits"),
+                               optional_value_proto.bits()));
+  return TypedValue::FromValue(OptionalValue<T>(value));
+}
+
+template <typename T>
+absl::StatusOr<TypedValue> DecodeDenseArrayValue(
+    absl::string_view field_name,
+    const HalfV1Proto::DenseArrayHalfProto& dense_array_value_proto) {
+  if (!dense_array_value_proto.has_size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("missing field ", field_name, ".size"));
+  }
+  const int64_t size = dense_array_value_proto.size();
+  if (size < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "expected a non-negative value in ", field_name, ".size, got ", size));
+  }
+  bm::Bitmap bitmap;
+  if (!dense_array_value_proto.bitmap().empty()) {
+    const auto& bitmap_proto = dense_array_value_proto.bitmap();
+    if (bitmap_proto.size() != bm::BitmapSize(size)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("expected ", bm::BitmapSize(size), " items in ",
+                       field_name, ".bitmap, got ", bitmap_proto.size()));
+    }
+    bitmap = bm::Bitmap::Create(bitmap_proto.begin(), bitmap_proto.end());
+  }
+  // Division instead of multiplication: `size` comes from the proto and can
+  // be arbitrarily large.
+  const std::string& raw = dense_array_value_proto.raw_values();
+  if (raw.size() % sizeof(uint16_t) != 0 ||
+      raw.size() / sizeof(uint16_t) != size) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("expected ", size, " items of 2 bytes in ", field_name,
+                     ".raw_values, got ", raw.size(), " bytes"));
+  }
+  typename Buffer<T>::Builder values_builder(size);
+  auto values = values_builder.GetMutableSpan();
+  for (int64_t i = 0; i < size; ++i) {
+    auto bits = static_cast<uint16_t>(static_cast<uint8_t>(raw[2 * i]) |
+                                      static_cast<uint8_t>(raw[2 * i + 1]) << 8);
+    values[i] = absl::bit_cast<T>(bits);
+  }
+  return TypedValue::FromValue(
+      DenseArray<T>{std::move(values_builder).Build(size), std::move(bitmap)});
+}
+
+absl::StatusOr<ValueDecoderResult> DecodeHalf(
+    const ValueProto& value_proto,
+    absl::Span<const TypedValue> /*input_values*/,
+    absl::Span<const ExprNodePtr> /*input_exprs*/) {
+  if (!value_proto.HasExtension(HalfV1Proto::extension)) {
+    return NoExtensionFound();
+  }
+  const auto& half_proto = value_proto.GetExtension(HalfV1Proto::extension);
+  switch (half_proto.value_case()) {
+    case HalfV1Proto::kFloat16Value:
+      return DecodeValue<Float16>("float16_value", half_proto.float16_value());
+    case HalfV1Proto::kBfloat16Value:
+      return DecodeValue<BFloat16>("bfloat16_value",
+                                   half_proto.bfloat16_value());
+    case HalfV1Proto::kOptionalFloat16Value:
+      return DecodeOptionalValue<Float16>("optional_float16_value",
+                                          half_proto.optional_float16_value());
+    case HalfV1Proto::kOptionalBfloat16Value:
+      return DecodeOptionalValue<BFloat16>(
+          "optional_bfloat16_value", half_proto.optional_bfloat16_value());
+    case HalfV1Proto::kDenseArrayFloat16Value:
+      return DecodeDenseArrayValue<Float16>(
+          "dense_array_float16_value", half_proto.dense_array_float16_value());
+    case HalfV1Proto::kDenseArrayBfloat16Value:
+      return DecodeDenseArrayValue<BFloat16>(
+          "dense_array_bfloat16_value",
+          half_proto.dense_array_bfloat16_value());
+    case HalfV1Proto::kFloat16Qtype:
+      return TypedValue::FromValue(GetQType<Float16>());
+    case HalfV1Proto::kBfloat16Qtype:
+      return TypedValue::FromValue(GetQType<BFloat16>());
+    case HalfV1Proto::kOptionalFloat16Qtype:
+      return TypedValue::FromValue(GetOptionalQType<Float16>());
+    case HalfV1Proto::kOptionalBfloat16Qtype:
+      return TypedValue::FromValue(GetOptionalQType<BFloat16>());
+    case HalfV1Proto::kDenseArrayFloat16Qtype:
+      return TypedValue::FromValue(GetDenseArrayQType<Float16>());
+    case HalfV1Proto::kDenseArrayBfloat16Qtype:
+      return TypedValue::FromValue(GetDenseArrayQType<BFloat16>());
+    case HalfV1Proto::VALUE_NOT_SET:
+      return absl::InvalidArgumentError("missing value");
+  }
+  return absl::InvalidArgumentError(absl::StrFormat(
+      "unexpected value=%d", static_cast<int>(half_proto.value_case())));
+}
+
+AROLLA_REGISTER_INITIALIZER(
+    kRegisterSerializationCodecs, register_serialization_codecs_half_v1_decoder,
+    []() -> absl::Status {
+      return RegisterValueDecoder(kHalfV1Codec, DecodeHalf);
+    });
+
+}  // namespace
+}  // namespace arolla::serialization_codecs
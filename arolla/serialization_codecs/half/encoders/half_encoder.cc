@@ -0,0 +1,215 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "absl/base/casts.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "arolla/dense_array/bitmap.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/half/half_types.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_ref.h"
+#include "arolla/serialization/encode.h"
+#include "arolla/serialization_base/encode.h"
+#include "arolla/serialization_codecs/half/codec_name.h"
+#include "arolla/serialization_codecs/half/half_codec.pb.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::serialization_codecs {
+namespace {
+
+namespace bm = ::arolla::bitmap;
+
+using ::arolla::serialization::RegisterValueEncoderByQType;
+using ::arolla::serialization_base::Encoder;
+using ::arolla::serialization_base::ValueProto;
+using ::arolla::serialization_codecs::HalfV1Proto;
+
+using BitmapProto = std::decay_t<std::remove_const_t<
+    decltype(std::declval<HalfV1Proto::DenseArrayHalfProto>().bitmap())>>;
+
+ValueProto GenValueProto(Encoder& encoder) {
+  ValueProto value_proto;
+  value_proto.set_codec_index(encoder.EncodeCodec(kHalfV1Codec));
+  return value_proto;
+}
+
+template <typename T>
+uint32_t ToBits(T value) {
+  return absl::bit_cast<uint16_t>(value);
+}
+
+BitmapProto GenBitmapProto(const bm::Bitmap& bitmap, int offset, int64_t size) {
+  BitmapProto result;
+  if (bm::CountBits(bitmap, offset, size) == size) {
+    return result;
+  }
+  const int64_t bitmapSize = bm::BitmapSize(size);
+  result.Resize(bitmapSize, 0);
+  for (int64_t i = 0; i < bitmapSize; ++i) {
+    result[i] = bm::GetWordWithOffset(bitmap, i, offset);
+  }
+  if (int last_word_usage = size % bm::kWordBitCount) {
+    result[bitmapSize - 1] &= (1U << last_word_usage) - 1;
+  }
+  return result;
+}
+
+// Returns the bit patterns of the values as a string of little-endian 16-bit
+// words, with zeros for the missing items.
+template <typename T>
+std::string EncodeRawValues(const DenseArray<T>& dense_array) {
+  std::string result(dense_array.size() * sizeof(uint16_t), '\0');
+  dense_array.ForEachPresent([&](int64_t id, T value) {
+    uint32_t bits = ToBits(value);
+    result[2 * id] = static_cast<char>(bits & 0xff);
+    result[2 * id + 1] = static_cast<char>(bits >> 8);
+  });
+  return result;
+}
+
+#define GEN_ENCODE_HALF(NAME, T, FIELD)                                       \
+  ValueProto Encode##NAME##QType(Encoder& encoder) {                          \
+    auto value_proto = GenValueProto(encoder);                                \
+    value_proto.MutableExtension(HalfV1Proto::extension)                      \
+        ->set_##FIELD##_qtype(true);                                          \
+    return value_proto;                                                       \
+  }                                                                           \
+                                                                              \
+  ValueProto EncodeOptional##NAME##QType(Encoder& encoder) {                  \
+    auto value_proto = GenValueProto(encoder);                                \
+    value_proto.MutableExtension(HalfV1Proto::extension)                      \
+        ->set_optional_##FIELD##_qtype(true);                                 \
+    return value_proto;                                                       \
+  }                                                                           \
+                                                                              \
+  ValueProto EncodeDenseArray##NAME##QType(Encoder& encoder) {                \
+    auto value_proto = GenValueProto(encoder);                                \
+    value_proto.MutableExtension(HalfV1Proto::extension)                      \
+        ->set_dense_array_##FIELD##_qtype(true);                              \
+    return value_proto;                                                       \
+  }                                                                           \
+                                                                              \
+  absl::StatusOr<ValueProto> Encode##NAME##Value(TypedRef value,              \
+                                                 Encoder& encoder) {          \
+    /* It's safe because we dispatch based on qtype in EncodeHalf(). */       \
+    auto value_proto = GenValueProto(encoder);                                \
+    value_proto.MutableExtension(HalfV1Proto::extension)                      \
+        ->set_##FIELD##_value(ToBits(value.UnsafeAs<T>()));                   \
+    return value_proto;                                                       \
+  }                                                                           \
+                                                                              \
+  absl::StatusOr<ValueProto> EncodeOptional##NAME##Value(TypedRef value,      \
+                                                         Encoder& encoder) {  \
+    /* It's safe because we dispatch based on qtype in EncodeHalf(). */       \
+    const auto& optional_value = value.UnsafeAs<OptionalValue<T>>();          \
+    auto value_proto = GenValueProto(encoder);                                \
+    auto* optional_value_proto =                                              \
+        value_proto.MutableExtension(HalfV1Proto::extension)                  \
+            ->mutable_optional_##FIELD##_value();                             \
+    if (optional_value.present) {                                             \
+      optional_value_proto->set_bits(ToBits(optional_value.value));           \
+    }                                                                         \
+    return value_proto;                                                       \
+  }                                                                           \
+                                                                              \
+  absl::StatusOr<ValueProto> EncodeDenseArray##NAME##Value(TypedRef value,    \
+                                                           Encoder& encoder) { \
+    /* It's safe because we dispatch based on qtype in EncodeHalf(). */       \
+    const auto& dense_array = value.UnsafeAs<DenseArray<T>>();                \
+    auto value_proto = GenValueProto(encoder);                                \
+    auto* dense_array_value_proto =                                           \
+        value_proto.MutableExtension(HalfV1Proto::extension)                  \
+            ->mutable_dense_array_##FIELD##_value();                          \
+    dense_array_value_proto->set_size(dense_array.size());                    \
+    *dense_array_value_proto->mutable_bitmap() =                              \
+        GenBitmapProto(dense_array.bitmap, dense_array.bitmap_bit_offset,     \
+                       dense_array.size());                                   \
+    dense_array_value_proto->set_raw_values(EncodeRawValues(dense_array));    \
+    return value_proto;                                                       \
+  }
+
+GEN_ENCODE_HALF(Float16, Float16, float16)
+GEN_ENCODE_HALF(BFloat16, BFloat16, bfloat16)
+
+#undef GEN_ENCODE_HALF
+
+absl::StatusOr<ValueProto> EncodeHalf(TypedRef value, Encoder& encoder) {
+  using QTypeEncoder = ValueProto (*)(Encoder&);
+  using ValueEncoder = absl::StatusOr<ValueProto> (*)(TypedRef, Encoder&);
+  using QTypeEncoders = absl::flat_hash_map<QTypePtr, QTypeEncoder>;
+  using ValueEncoders = absl::flat_hash_map<QTypePtr, ValueEncoder>;
+  static const Indestructible<QTypeEncoders> kQTypeEncoders(QTypeEncoders{
+      {GetQType<Float16>(), &EncodeFloat16QType},
+      {GetQType<BFloat16>(), &EncodeBFloat16QType},
+      {GetOptionalQType<Float16>(), &EncodeOptionalFloat16QType},
+      {GetOptionalQType<BFloat16>(), &EncodeOptionalBFloat16QType},
+      {GetDenseArrayQType<Float16>(), &EncodeDenseArrayFloat16QType},
+      {GetDenseArrayQType<BFloat16>(), &EncodeDenseArrayBFloat16QType},
+  });
+  static const Indestructible<ValueEncoders> kValueEncoders(ValueEncoders{
+      {GetQType<Float16>(), &EncodeFloat16Value},
+      {GetQType<BFloat16>(), &EncodeBFloat16Value},
+      {GetOptionalQType<Float16>(), &EncodeOptionalFloat16Value},
+      {GetOptionalQType<BFloat16>(), &EncodeOptionalBFloat16Value},
+      {GetDenseArrayQType<Float16>(), &EncodeDenseArrayFloat16Value},
+      {GetDenseArrayQType<BFloat16>(), &EncodeDenseArrayBFloat16Value},
+  });
+  if (value.GetType() == GetQType<QTypePtr>()) {
+    const auto& qtype_value = value.UnsafeAs<QTypePtr>();
+    auto it = kQTypeEncoders->find(qtype_value);
+    if (it != kQTypeEncoders->end()) {
+      return it->second(encoder);
+    }
+  } else {
+    auto it = kValueEncoders->find(value.GetType());
+    if (it != kValueEncoders->end()) {
+      return it->second(value, encoder);
+    }
+  }
+  return absl::UnimplementedError(absl::StrFormat(
+      "%s does not support serialization of %s: %s; this may indicate a "
+      "missing BUILD dependency on the encoder for this qtype",
+      kHalfV1Codec, value.GetType()->name(), value.Repr()));
+}
+
+AROLLA_REGISTER_INITIALIZER(
+    kRegisterSerializationCodecs, register_serialization_codecs_half_v1_encoder,
+    []() -> absl::Status {
+      for (QTypePtr qtype : {
+               GetQType<Float16>(),
+               GetQType<BFloat16>(),
+               GetOptionalQType<Float16>(),
+               GetOptionalQType<BFloat16>(),
+               GetDenseArrayQType<Float16>(),
+               GetDenseArrayQType<BFloat16>(),
+           }) {
+        RETURN_IF_ERROR(RegisterValueEncoderByQType(qtype, EncodeHalf));
+      }
+      return absl::OkStatus();
+    });
+
+}  // namespace
+}  // namespace arolla::serialization_codecs
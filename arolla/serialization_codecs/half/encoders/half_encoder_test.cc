@@ -0,0 +1,146 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/base/casts.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/half/half_types.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/serialization/decode.h"
+#include "arolla/serialization/encode.h"
+#include "arolla/serialization_base/base.pb.h"
+#include "arolla/serialization_codecs/half/codec_name.h"
+#include "arolla/serialization_codecs/half/half_codec.pb.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla::serialization_codecs {
+namespace {
+
+using ::arolla::serialization_base::ContainerProto;
+using ::arolla::testing::IsOkAndHolds;
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+
+absl::StatusOr<TypedValue> RoundTrip(const TypedValue& value) {
+  ASSIGN_OR_RETURN(auto container_proto, serialization::Encode({value}, {}));
+  return serialization::DecodeValue(container_proto);
+}
+
+class HalfCodecTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_OK(InitArolla()); }
+};
+
+TEST_F(HalfCodecTest, QTypes) {
+  for (QTypePtr qtype : {
+           GetQType<Float16>(),
+           GetQType<BFloat16>(),
+           GetOptionalQType<Float16>(),
+           GetOptionalQType<BFloat16>(),
+           GetDenseArrayQType<Float16>(),
+           GetDenseArrayQType<BFloat16>(),
+       }) {
+    ASSERT_OK_AND_ASSIGN(auto value, RoundTrip(TypedValue::FromValue(qtype)));
+    EXPECT_THAT(value.As<QTypePtr>(), IsOkAndHolds(Eq(qtype)));
+  }
+}
+
+TEST_F(HalfCodecTest, Scalars) {
+  ASSERT_OK_AND_ASSIGN(auto f16,
+                       RoundTrip(TypedValue::FromValue(Float16(-1.5f))));
+  EXPECT_THAT(f16.As<Float16>(), IsOkAndHolds(Eq(Float16(-1.5f))));
+  ASSERT_OK_AND_ASSIGN(auto bf16,
+                       RoundTrip(TypedValue::FromValue(BFloat16(3.0f))));
+  EXPECT_THAT(bf16.As<BFloat16>(), IsOkAndHolds(Eq(BFloat16(3.0f))));
+
+  // The bit pattern is preserved, including the NaN payload.
+  auto nan = absl::bit_cast<Float16>(uint16_t{0x7e01});
+  ASSERT_OK_AND_ASSIGN(auto nan_value, RoundTrip(TypedValue::FromValue(nan)));
+  ASSERT_OK_AND_ASSIGN(Float16 decoded_nan, nan_value.As<Float16>());
+  EXPECT_EQ(absl::bit_cast<uint16_t>(decoded_nan), 0x7e01);
+}
+
+TEST_F(HalfCodecTest, Optionals) {
+  ASSERT_OK_AND_ASSIGN(auto present, RoundTrip(TypedValue::FromValue(
+                                         OptionalValue<Float16>(2.0f))));
+  EXPECT_THAT(present.As<OptionalValue<Float16>>(),
+              IsOkAndHolds(Eq(OptionalValue<Float16>(2.0f))));
+  ASSERT_OK_AND_ASSIGN(auto missing, RoundTrip(TypedValue::FromValue(
+                                         OptionalValue<BFloat16>())));
+  EXPECT_THAT(missing.As<OptionalValue<BFloat16>>(),
+              IsOkAndHolds(Eq(OptionalValue<BFloat16>())));
+}
+
+TEST_F(HalfCodecTest, DenseArrays) {
+  auto array = CreateDenseArray<Float16>(
+      {Float16(1.0f), std::nullopt, Float16(-0.5f), Float16(65504.0f)});
+  ASSERT_OK_AND_ASSIGN(auto value, RoundTrip(TypedValue::FromValue(array)));
+  ASSERT_OK_AND_ASSIGN(auto decoded, value.As<DenseArray<Float16>>());
+  EXPECT_THAT(decoded, ElementsAre(Float16(1.0f), std::nullopt,
+                                   Float16(-0.5f), Float16(65504.0f)));
+
+  // A bitmap with a bit offset.
+  DenseArray<BFloat16> shifted;
+  shifted.values = CreateBuffer<BFloat16>(
+      {BFloat16(-1.0f), BFloat16(1.0f), BFloat16(-1.0f), BFloat16(3.0f)});
+  shifted.bitmap = CreateBuffer<uint32_t>({0b1010});
+  shifted.bitmap_bit_offset = 1;
+  ASSERT_OK_AND_ASSIGN(value, RoundTrip(TypedValue::FromValue(shifted)));
+  ASSERT_OK_AND_ASSIGN(auto decoded_shifted, value.As<DenseArray<BFloat16>>());
+  EXPECT_THAT(decoded_shifted,
+              ElementsAre(BFloat16(1.0f), std::nullopt, BFloat16(3.0f),
+                          std::nullopt));
+}
+
+TEST_F(HalfCodecTest, MalformedProto) {
+  ContainerProto container_proto;
+  container_proto.set_version(1);
+  container_proto.add_codecs()->set_name(std::string(kHalfV1Codec));
+  auto* value_proto = container_proto.add_decoding_steps()->mutable_value();
+  value_proto->set_codec_index(0);
+  container_proto.add_output_value_indices(0);
+  auto* half_proto = value_proto->MutableExtension(HalfV1Proto::extension);
+
+  half_proto->set_float16_value(0x10000);
+  EXPECT_THAT(serialization::DecodeValue(container_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("expected a 16-bit value in float16_value")));
+
+  auto* dense_array_proto = half_proto->mutable_dense_array_bfloat16_value();
+  dense_array_proto->set_size(2);
+  dense_array_proto->set_raw_values(std::string(3, '\0'));
+  EXPECT_THAT(serialization::DecodeValue(container_proto),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("expected 2 items of 2 bytes in "
+                                 "dense_array_bfloat16_value.raw_values, got "
+                                 "3 bytes")));
+}
+
+}  // namespace
+}  // namespace arolla::serialization_codecs
@@ -32,7 +32,9 @@
 // Use it to simplify work with codegen models or embedded dynamic eval models.
 // The provided model initialization code runs during InitArolla and the
 // result is stored in a static variable. In addition, the macro validates that
-// the model was successfully initialized during InitArolla.
+// the model was successfully initialized during InitArolla. When InitArolla is
+// called with a ThreadingInterface, embedded models are initialized
+// concurrently, so the initialization code must be thread-safe.
 //
 // Usage example:
 //
@@ -58,7 +60,35 @@
 //   using ModelFunction = ::arolla::ExprCompiler<...>::Function;
 //   const ModelFunction& MyModel();
 //
-#define AROLLA_DEFINE_EMBEDDED_MODEL_FN(fn_name, model_or)                    \
+#define AROLLA_DEFINE_EMBEDDED_MODEL_FN(fn_name, model_or)              \
+  AROLLA_DEFINE_LAZY_EMBEDDED_MODEL_FN(fn_name, model_or)               \
+                                                                        \
+  namespace {                                                           \
+  AROLLA_REGISTER_INDEPENDENT_INITIALIZER(                              \
+      kLowest, fn_name, []() -> absl::Status {                          \
+    RETURN_IF_ERROR(_arolla_embed_model_or_status_##fn_name().status()) \
+        << "while initializing embedded model " << #fn_name << " at "   \
+        << __FILE__ << ":" << __LINE__;                                 \
+    return absl::OkStatus();                                            \
+  });                                                                   \
+  }
+
+// Same as AROLLA_DEFINE_EMBEDDED_MODEL_FN, but the model is initialized on
+// the first call of the defined function instead of during InitArolla.
+//
+// Use it in binaries that embed many models but use only a few of them in a
+// single process. Initialization is thread-safe: concurrent first calls block
+// until the model is ready and it is initialized exactly once. Initialization
+// errors are not reported by InitArolla; instead all the calls of the model
+// function return the error. InitArolla must still be called before the first
+// use of the model.
+//
+// To move the initialization cost away from the first request, call the
+// function in advance, e.g. from a background thread:
+//
+//   std::thread([] { MyModel(); }).detach();
+//
+#define AROLLA_DEFINE_LAZY_EMBEDDED_MODEL_FN(fn_name, model_or)               \
   namespace {                                                                 \
   const decltype(model_or)& _arolla_embed_model_or_status_##fn_name() {       \
     using ModelT = decltype(model_or);                                        \
@@ -80,15 +110,6 @@
       return error_fn;                                                        \
     }                                                                         \
     return *model;                                                            \
-  }                                                                           \
-                                                                              \
-  namespace {                                                                 \
-  AROLLA_REGISTER_INITIALIZER(kLowest, fn_name, []() -> absl::Status {        \
-    RETURN_IF_ERROR(_arolla_embed_model_or_status_##fn_name().status())       \
-        << "while initializing embedded model " << #fn_name << " at "         \
-        << __FILE__ << ":" << __LINE__;                                       \
-    return absl::OkStatus();                                                  \
-  });                                                                         \
   }
 
 // Defines a function to initialize and access a model set embedded into the
@@ -97,7 +118,9 @@
 // Use it to simplify work with codegen models or embedded dynamic eval models.
 // The provided model set initialization code runs during InitArolla and the
 // result is stored in a static variable. In addition, the macro validates that
-// all the models were successfully initialized during InitArolla.
+// all the models were successfully initialized during InitArolla. Like in
+// AROLLA_DEFINE_EMBEDDED_MODEL_FN, the initialization code must be
+// thread-safe.
 //
 // Usage example:
 //
@@ -121,7 +144,23 @@
 //   absl::StatusOr<std::reference_wrapper<const ModelFunction>>
 //   MyModel(absl::string_view);
 //
-#define AROLLA_DEFINE_EMBEDDED_MODEL_SET_FN(fn_name, model_set_or)             \
+#define AROLLA_DEFINE_EMBEDDED_MODEL_SET_FN(fn_name, model_set_or)          \
+  AROLLA_DEFINE_LAZY_EMBEDDED_MODEL_SET_FN(fn_name, model_set_or)           \
+                                                                            \
+  namespace {                                                               \
+  AROLLA_REGISTER_INDEPENDENT_INITIALIZER(                                  \
+      kLowest, fn_name, []() -> absl::Status {                              \
+    RETURN_IF_ERROR(_arolla_embed_model_set_or_status_##fn_name().status()) \
+        << "while initializing embedded model " << #fn_name << " at "       \
+        << __FILE__ << ":" << __LINE__;                                     \
+    return absl::OkStatus();                                                \
+  });                                                                       \
+  }
+
+// Same as AROLLA_DEFINE_EMBEDDED_MODEL_SET_FN, but the model set is initialized
+// on the first call of the defined function instead of during InitArolla. See
+// AROLLA_DEFINE_LAZY_EMBEDDED_MODEL_FN for details.
+#define AROLLA_DEFINE_LAZY_EMBEDDED_MODEL_SET_FN(fn_name, model_set_or)        \
   namespace {                                                                  \
   const decltype(model_set_or)&                                                \
       _arolla_embed_model_set_or_status_##fn_name() {                          \
@@ -142,15 +181,6 @@
           absl::StrFormat("model \"%s\" not found in " #fn_name, model_name)); \
     }                                                                          \
     return it->second;                                                         \
-  }                                                                            \
-                                                                               \
-  namespace {                                                                  \
-  AROLLA_REGISTER_INITIALIZER(kLowest, fn_name, []() -> absl::Status {         \
-    RETURN_IF_ERROR(_arolla_embed_model_set_or_status_##fn_name().status())    \
-        << "while initializing embedded model " << #fn_name << " at "          \
-        << __FILE__ << ":" << __LINE__;                                        \
-    return absl::OkStatus();                                                   \
-  });                                                                          \
   }
 
 #endif  // AROLLA_SERVING_EMBEDDED_MODEL_H_
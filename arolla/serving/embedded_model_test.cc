@@ -246,6 +246,35 @@ TEST(ExprCompilerTest, UseCompiledEmbeddedExprSet) {
           "model \"missing_expr\" not found in MyCompiledEmbeddedExprSet"));
 }
 
+namespace test_namespace {
+
+int lazy_model_compilation_count = 0;
+
+using LazyModelCompiler =
+    ::arolla::ExprCompiler<TestInput, std::optional<float>>;
+
+absl::StatusOr<LazyModelCompiler::Function> CompileLazyModel() {
+  ++lazy_model_compilation_count;
+  return LazyModelCompiler()
+      .SetInputLoader(CreateInputLoader())
+      .AllowOutputCasting()
+      .Compile(CreateExpr().value());
+}
+
+AROLLA_DEFINE_LAZY_EMBEDDED_MODEL_FN(MyLazyEmbeddedModel, CompileLazyModel());
+
+}  // namespace test_namespace
+
+TEST(ExprCompilerTest, UseLazyEmbeddedExpr) {
+  ASSERT_OK(::arolla::InitArolla());
+  EXPECT_EQ(test_namespace::lazy_model_compilation_count, 0);
+
+  TestInput input{.x = 28, .y = 29};
+  EXPECT_THAT(test_namespace::MyLazyEmbeddedModel()(input), IsOkAndHolds(57));
+  EXPECT_THAT(test_namespace::MyLazyEmbeddedModel()(input), IsOkAndHolds(57));
+  EXPECT_EQ(test_namespace::lazy_model_compilation_count, 1);
+}
+
 void BM_MyDynamicEmbeddedModel_Request(benchmark::State& state) {
   CHECK_OK(::arolla::InitArolla());
   TestInput input{.x = 28, .y = 29};
@@ -15,6 +15,8 @@
 #ifndef AROLLA_SERVING_EXPR_COMPILER_H_
 #define AROLLA_SERVING_EXPR_COMPILER_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -30,6 +32,8 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "arolla/expr/eval/model_executor.h"
 #include "arolla/expr/eval/thread_safe_model_executor.h"
@@ -41,10 +45,14 @@
 #include "arolla/io/slot_listener.h"
 #include "arolla/io/tuple_input_loader.h"
 #include "arolla/io/typed_refs_input_loader.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/evaluation_engine.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_ref.h"
+#include "arolla/qtype/typed_value_interner.h"
 #include "arolla/util/indestructible.h"
+#include "arolla/util/numa.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
@@ -104,6 +112,10 @@ class ExprCompilerBase {
   using ModelExecutor = expr::ModelExecutor<Input, Output, SideOutput>;
   using ThreadSafePoolModelExecutor =
       expr::ThreadSafePoolModelExecutor<Input, Output, SideOutput>;
+  using ThreadSafeLockFreePoolModelExecutor =
+      expr::ThreadSafeLockFreePoolModelExecutor<Input, Output, SideOutput>;
+  using ThreadSafeNumaPoolModelExecutor =
+      expr::ThreadSafeNumaPoolModelExecutor<Input, Output, SideOutput>;
   using CopyableThreadUnsafeModelExecutor =
       expr::CopyableThreadUnsafeModelExecutor<Input, Output, SideOutput>;
   using ToFunctionHelper =
@@ -216,6 +228,50 @@ class ExprCompilerBase {
     return std::move(SetPoolThreadSafetyPolicy());
   }
 
+  // Sets "object pool" thread safety policy with the given pool options, e.g.
+  // a memory budget shared by the models of the process (see
+  // ExecutorPoolMemoryBudget).
+  Subclass& SetPoolThreadSafetyPolicy(
+      expr::ThreadSafePoolModelExecutorOptions pool_options) & {
+    thread_safety_policy_ = ThreadSafetyPolicy::kPool;
+    pool_options_ = std::move(pool_options);
+    return subclass();
+  }
+  Subclass&& SetPoolThreadSafetyPolicy(
+      expr::ThreadSafePoolModelExecutorOptions pool_options) && {
+    return std::move(SetPoolThreadSafetyPolicy(std::move(pool_options)));
+  }
+
+  // Sets "lock-free object pool" thread safety policy. Similar to the "object
+  // pool" policy, but the pool does not take locks and every thread prefers to
+  // reuse the same context. Recommended for servers with many (e.g. 64+)
+  // threads calling the same model concurrently. May keep up to 2x
+  // hardware_concurrency idle contexts in memory.
+  Subclass& SetLockFreePoolThreadSafetyPolicy() & {
+    thread_safety_policy_ = ThreadSafetyPolicy::kLockFreePool;
+    return subclass();
+  }
+  Subclass&& SetLockFreePoolThreadSafetyPolicy() && {
+    return std::move(SetLockFreePoolThreadSafetyPolicy());
+  }
+
+  // Sets "NUMA-aware lock-free object pool" thread safety policy. Similar to
+  // the "lock-free object pool" policy, but keeps a separate model replica and
+  // pool per NUMA node and serves every call from the replica of the caller's
+  // node. Unless SetLiteralBufferFactory is used, models compiled from
+  // expressions keep a copy of the array literals in each node's memory;
+  // models compiled from CompiledExpr share the literals between the replicas.
+  // Recommended for multi-socket servers with many threads calling the same
+  // model concurrently. Equivalent to the "lock-free object pool" policy on
+  // hosts with a single NUMA node.
+  Subclass& SetNumaPoolThreadSafetyPolicy() & {
+    thread_safety_policy_ = ThreadSafetyPolicy::kNumaPool;
+    return subclass();
+  }
+  Subclass&& SetNumaPoolThreadSafetyPolicy() && {
+    return std::move(SetNumaPoolThreadSafetyPolicy());
+  }
+
   // Sets "unsafe" thread safety policy. If used, the resulting function will be
   // thread-unsafe and potentially expensive (although thread-safe) to copy. But
   // the copies may be executed concurrently from different threads.
@@ -237,17 +293,103 @@ class ExprCompilerBase {
         SetThreadUnsafe_I_SWEAR_TO_COPY_MODEL_FUNCTION_BEFORE_CALL());
   }
 
-  // Enables arena allocator. See
-  // expr::ModelExecutorOptions::SetExperimentalArenaAllocator documentation for
-  // details and tradeoffs.
-  Subclass& SetExperimentalArenaAllocator(int64_t page_size_bytes = (64
-                                                                     << 10)) & {
+  // Enables arena allocator for intermediate buffers (e.g. of DenseArray or
+  // Array). The arena pages are kept between evaluations and only rewound. See
+  // expr::ModelExecutorOptions::arena_page_size documentation for details and
+  // tradeoffs.
+  Subclass& SetArenaAllocator(int64_t page_size_bytes = (64 << 10)) & {
     model_executor_options_.arena_page_size = page_size_bytes;
     return subclass();
   }
+  Subclass&& SetArenaAllocator(int64_t page_size_bytes = (64 << 10)) && {
+    return std::move(SetArenaAllocator(page_size_bytes));
+  }
+
+  // Preallocates the given number of bytes in the arenas used by the model, so
+  // the evaluations on batches of a fixed size do not allocate arena pages.
+  // Requires SetArenaAllocator. See
+  // expr::ModelExecutorOptions::arena_reserved_bytes documentation for details.
+  Subclass& SetArenaReservedBytes(int64_t reserved_bytes) & {
+    model_executor_options_.arena_reserved_bytes = reserved_bytes;
+    return subclass();
+  }
+  Subclass&& SetArenaReservedBytes(int64_t reserved_bytes) && {
+    return std::move(SetArenaReservedBytes(reserved_bytes));
+  }
+
+  // Warms up the compiled model before Compile() returns, so the first requests
+  // after a model rollout do not pay for the cold start. The pools of the
+  // thread safe policies are pre-populated with `executor_count` executors,
+  // each evaluated on all the `sample_inputs`: their arenas (see
+  // SetArenaAllocator) grow to the sizes needed by the samples, and the
+  // literals used by them are paged in. Use the expected number of the
+  // concurrent callers as `executor_count`. With the "unsafe" policy the
+  // samples are evaluated once. With the NUMA-aware policy only the pool of
+  // the compiling thread's node is populated. The "always clone" policy ignores
+  // the warmup, because every call evaluates on a fresh clone. The warmup
+  // evaluations bypass the output cache (see SetOutputCache).
+  //
+  // The samples are not copied and must outlive the Compile() call. An error
+  // in the sample evaluations fails the Compile() call.
+  Subclass& SetWarmup(absl::Span<const Input> sample_inputs,
+                      int64_t executor_count = 1) & {
+    warmup_inputs_ = sample_inputs;
+    warmup_executor_count_ = executor_count;
+    return subclass();
+  }
+  Subclass&& SetWarmup(absl::Span<const Input> sample_inputs,
+                       int64_t executor_count = 1) && {
+    return std::move(SetWarmup(sample_inputs, executor_count));
+  }
+
+  // Caches the model outputs keyed by the fingerprint of the loaded inputs, so
+  // the repeated inputs are not evaluated again. See
+  // expr::ModelExecutorOptions::output_cache documentation for details.
+  Subclass& SetOutputCache(expr::ModelOutputCacheOptions cache_options) & {
+    model_executor_options_.output_cache = std::move(cache_options);
+    return subclass();
+  }
+  Subclass&& SetOutputCache(expr::ModelOutputCacheOptions cache_options) && {
+    return std::move(SetOutputCache(std::move(cache_options)));
+  }
+
+  // Copies the array literals of the model into buffers allocated by the given
+  // factory, e.g. HugePageBufferFactory for big embedding tables. The factory
+  // must remain valid during the Compile() call.
+  Subclass& SetLiteralBufferFactory(RawBufferFactory* buffer_factory) & {
+    model_executor_options_.eval_options.literal_buffer_factory =
+        buffer_factory;
+    return subclass();
+  }
+  Subclass&& SetLiteralBufferFactory(RawBufferFactory* buffer_factory) && {
+    return std::move(SetLiteralBufferFactory(buffer_factory));
+  }
+
+  // Replaces the literals of the model with the equal values registered in the
+  // interner, so the models embedding the same vocabularies or forests share
+  // one instance of them. The literals of the models compiled later are
+  // deduplicated as long as any of the models is alive. Not compatible with
+  // SetLiteralBufferFactory() and SetNumaPoolThreadSafetyPolicy(), which
+  // copy the literals. The interner must remain valid during the Compile()
+  // call.
+  Subclass& SetLiteralInterner(
+      TypedValueInterner* interner = &TypedValueInterner::GetInstance()) & {
+    model_executor_options_.eval_options.literal_interner = interner;
+    return subclass();
+  }
+  Subclass&& SetLiteralInterner(
+      TypedValueInterner* interner = &TypedValueInterner::GetInstance()) && {
+    return std::move(SetLiteralInterner(interner));
+  }
+
+  // Deprecated: use SetArenaAllocator instead.
+  Subclass& SetExperimentalArenaAllocator(int64_t page_size_bytes = (64
+                                                                     << 10)) & {
+    return SetArenaAllocator(page_size_bytes);
+  }
   Subclass&& SetExperimentalArenaAllocator(
       int64_t page_size_bytes = (64 << 10)) && {
-    return std::move(SetExperimentalArenaAllocator(page_size_bytes));
+    return std::move(SetArenaAllocator(page_size_bytes));
   }
 
   // Sets Expr optimizer. Overrides the default optimizer, errors will be
@@ -310,6 +452,22 @@ class ExprCompilerBase {
     return std::move(IgnoreNotListenedNamedOutputs());
   }
 
+  // Compiles additional variants of the model evaluating only the given
+  // subsets of the side outputs. A variant is selected per call by
+  // ModelFunctionOptions::side_output_variant (requires
+  // ExprCompilerFlags::kEvalWithOptions), see
+  // ModelExecutorOptions::side_output_variants for details.
+  Subclass& SetSideOutputVariants(
+      std::vector<std::vector<std::string>> side_output_variants) & {
+    model_executor_options_.side_output_variants =
+        std::move(side_output_variants);
+    return subclass();
+  }
+  Subclass&& SetSideOutputVariants(
+      std::vector<std::vector<std::string>> side_output_variants) && {
+    return std::move(SetSideOutputVariants(std::move(side_output_variants)));
+  }
+
   // Compiles a model represented by CompiledExpr.
   template <int Flags = ExprCompilerFlags::kDefault>
   absl::StatusOr<Func<Flags>> Compile(const CompiledExpr& compiled_expr) const {
@@ -334,12 +492,7 @@ class ExprCompilerBase {
   template <int Flags = ExprCompilerFlags::kDefault>
   absl::StatusOr<Func<Flags>> Compile(const expr::ExprNodePtr& expr) const {
     RETURN_IF_ERROR(Validate());
-    ASSIGN_OR_RETURN(
-        auto model_executor,
-        ModelExecutor::Compile(expr, *input_loader_, slot_listener_.get(),
-                               model_executor_options_));
-    return MakeFunction<Flags>(std::move(model_executor),
-                               thread_safety_policy_);
+    return CompileAndMakeFunction<Flags>(expr, *input_loader_);
   }
 
   template <int Flags = ExprCompilerFlags::kDefault>
@@ -367,12 +520,7 @@ class ExprCompilerBase {
                      expr::CallOp(std::move(op), std::move(args)));
     ASSIGN_OR_RETURN(InputLoaderPtr<Input> input_loader,
                      TupleInputLoader<Input>::Create(std::move(arg_names)));
-    ASSIGN_OR_RETURN(
-        auto model_executor,
-        ModelExecutor::Compile(expr, *input_loader, slot_listener_.get(),
-                               model_executor_options_));
-    return MakeFunction<Flags>(std::move(model_executor),
-                               thread_safety_policy_);
+    return CompileAndMakeFunction<Flags>(expr, *input_loader);
   }
 
   // Compiles a model represented by ExprOperatorPtr with positional arguments.
@@ -396,12 +544,7 @@ class ExprCompilerBase {
     ASSIGN_OR_RETURN(expr::ExprNodePtr expr,
                      expr::CallOp(std::move(op), std::move(arg_exprs)));
     InputLoaderPtr<Input> input_loader = CreateTypedRefsInputLoader(args);
-    ASSIGN_OR_RETURN(
-        auto model_executor,
-        ModelExecutor::Compile(expr, *input_loader, slot_listener_.get(),
-                               model_executor_options_));
-    return MakeFunction<Flags>(std::move(model_executor),
-                               thread_safety_policy_);
+    return CompileAndMakeFunction<Flags>(expr, *input_loader);
   }
 
  protected:
@@ -424,6 +567,10 @@ class ExprCompilerBase {
     kAlwaysClone,
     // Use ThreadSafePoolModelExecutor.
     kPool,
+    // Use ThreadSafeLockFreePoolModelExecutor.
+    kLockFreePool,
+    // Use ThreadSafeNumaPoolModelExecutor.
+    kNumaPool,
     // Be thread unsafe.
     kUnsafe
   };
@@ -511,24 +658,90 @@ class ExprCompilerBase {
   // Wraps ModelExecutor into std::function, applying the requested thread
   // safety policy.
   template <bool EvalWithOptions>
-  static absl::StatusOr<Func<EvalWithOptions>> MakeFunction(
-      ModelExecutor&& executor, ThreadSafetyPolicy thread_safety_policy) {
+  absl::StatusOr<Func<EvalWithOptions>> MakeFunction(
+      ModelExecutor&& executor, ThreadSafetyPolicy thread_safety_policy) const {
     switch (thread_safety_policy) {
       case ThreadSafetyPolicy::kAlwaysClone:
+        // NOTE: Warmup is ignored, the clones do not share the warmed state.
         return MakeAlwaysCloneFunction<EvalWithOptions>(std::move(executor));
       // NOTE: some callers of MakeFunction may override kUnspecified themselve.
       case ThreadSafetyPolicy::kUnspecified:
       case ThreadSafetyPolicy::kPool:
-        return Func<EvalWithOptions>(
-            ThreadSafePoolModelExecutor(std::move(executor)));
-      case ThreadSafetyPolicy::kUnsafe:
-        return Func<EvalWithOptions>(
-            CopyableThreadUnsafeModelExecutor(std::move(executor)));
+        return WarmupAndMakeFunction<EvalWithOptions>(
+            ThreadSafePoolModelExecutor(std::move(executor), pool_options_));
+      case ThreadSafetyPolicy::kLockFreePool:
+        return WarmupAndMakeFunction<EvalWithOptions>(
+            ThreadSafeLockFreePoolModelExecutor(std::move(executor)));
+      case ThreadSafetyPolicy::kNumaPool: {
+        std::vector<ModelExecutor> replicas;
+        for (int node = 1; node < GetNumaNodeCount(); ++node) {
+          ASSIGN_OR_RETURN(auto replica, executor.Clone());
+          replicas.push_back(std::move(replica));
+        }
+        replicas.insert(replicas.begin(), std::move(executor));
+        return WarmupAndMakeFunction<EvalWithOptions>(
+            ThreadSafeNumaPoolModelExecutor(std::move(replicas)));
+      }
+      case ThreadSafetyPolicy::kUnsafe: {
+        CopyableThreadUnsafeModelExecutor unsafe_executor(std::move(executor));
+        if (warmup_executor_count_ > 0) {
+          RETURN_IF_ERROR(
+              unsafe_executor.Warmup(warmup_inputs_));
+        }
+        return Func<EvalWithOptions>(std::move(unsafe_executor));
+      }
     }
     return absl::InternalError(
         absl::StrCat("Unsupported ThreadSafetyPolicy: ", thread_safety_policy));
   }
 
+  // Warms up the thread safe pool (see SetWarmup) and wraps it into
+  // std::function.
+  template <int Flags, typename PoolModelExecutor>
+  absl::StatusOr<Func<Flags>> WarmupAndMakeFunction(
+      PoolModelExecutor&& pool_executor) const {
+    if (warmup_executor_count_ > 0) {
+      RETURN_IF_ERROR(
+          pool_executor.Warmup(warmup_inputs_, warmup_executor_count_));
+    }
+    return Func<Flags>(std::move(pool_executor));
+  }
+
+  // Compiles the expression and wraps it into std::function, applying the
+  // requested thread safety policy. For kNumaPool, compiles a replica per NUMA
+  // node with the literals allocated in the node's memory.
+  template <int Flags>
+  absl::StatusOr<Func<Flags>> CompileAndMakeFunction(
+      const expr::ExprNodePtr& expr,
+      const InputLoader<Input>& input_loader) const {
+    if (thread_safety_policy_ != ThreadSafetyPolicy::kNumaPool ||
+        model_executor_options_.eval_options.literal_buffer_factory !=
+            nullptr) {
+      ASSIGN_OR_RETURN(
+          auto model_executor,
+          ModelExecutor::Compile(expr, input_loader, slot_listener_.get(),
+                                 model_executor_options_));
+      return MakeFunction<Flags>(std::move(model_executor),
+                                 thread_safety_policy_);
+    }
+    std::vector<ModelExecutor> replicas;
+    for (int node = 0; node < GetNumaNodeCount(); ++node) {
+      HugePageBufferFactoryOptions literal_buffer_options;
+      literal_buffer_options.numa_node = node;
+      // The literals are copied during the compilation, the buffers don't keep
+      // a reference to the factory.
+      HugePageBufferFactory literal_buffer_factory(literal_buffer_options);
+      expr::ModelExecutorOptions options = model_executor_options_;
+      options.eval_options.literal_buffer_factory = &literal_buffer_factory;
+      ASSIGN_OR_RETURN(auto replica,
+                       ModelExecutor::Compile(expr, input_loader,
+                                              slot_listener_.get(), options));
+      replicas.push_back(std::move(replica));
+    }
+    return WarmupAndMakeFunction<Flags>(
+        ThreadSafeNumaPoolModelExecutor(std::move(replicas)));
+  }
+
   absl::Status Validate() const {
     RETURN_IF_ERROR(first_error_);
     if (input_loader_ == nullptr) {
@@ -566,7 +779,10 @@ class ExprCompilerBase {
   std::unique_ptr<const SlotListener<SideOutput>> slot_listener_ = nullptr;
 
   ThreadSafetyPolicy thread_safety_policy_ = ThreadSafetyPolicy::kUnspecified;
+  expr::ThreadSafePoolModelExecutorOptions pool_options_;
   expr::ModelExecutorOptions model_executor_options_;
+  absl::Span<const Input> warmup_inputs_;
+  int64_t warmup_executor_count_ = 0;
 };
 
 // Compiler for Arolla expressions into std::function.
@@ -599,6 +815,19 @@ class ExprCompiler final
     : public ExprCompilerBase<ExprCompiler<Input, Output, SideOutput>, Input,
                               Output, SideOutput> {};
 
+// Options for CompileExprSet.
+struct CompileExprSetOptions {
+  // If set, the models are compiled concurrently using up to
+  // threading->GetRecommendedThreadCount() threads. The ExprCompiler (and so
+  // the input loader, slot listener and optimizer) is shared by all the
+  // threads.
+  ThreadingInterface* /*nullable*/ threading = nullptr;
+
+  // If set, receives the compilation time of every compiled model.
+  absl::flat_hash_map<std::string, absl::Duration>* /*nullable*/
+      compile_times = nullptr;
+};
+
 // Compiles all models from (string -> model) map using the pre-configured
 // ExprCompiler. Returns an error if any of the models does not compile. See
 // ExprCompiler docs for more details.
@@ -613,16 +842,75 @@ class ExprCompiler final
 //               .AllowOutputCasting(),
 //           GetMyModels()));
 //
+// With CompileExprSetOptions::threading set, the models are compiled in
+// parallel. If several models fail to compile, the error for the
+// lexicographically smallest model name is returned.
+//
 template <typename Compiler, typename Model>
 absl::StatusOr<absl::flat_hash_map<std::string, typename Compiler::Function>>
 CompileExprSet(const Compiler& compiler,
-               absl::flat_hash_map<std::string, Model> model_set) {
+               absl::flat_hash_map<std::string, Model> model_set,
+               const CompileExprSetOptions& options = {}) {
   using Function = typename Compiler::Function;
+  std::vector<const std::pair<const std::string, Model>*> models;
+  models.reserve(model_set.size());
+  for (const auto& named_model : model_set) {
+    models.push_back(&named_model);
+  }
+  std::sort(models.begin(), models.end(),
+            [](const auto* a, const auto* b) { return a->first < b->first; });
+
+  std::vector<absl::StatusOr<Function>> results(
+      models.size(), absl::CancelledError("model is not compiled"));
+  std::vector<absl::Duration> compile_times(models.size());
+  auto compile_model = [&](size_t i) {
+    absl::Time start = absl::Now();
+    results[i] = compiler.Compile(models[i]->second);
+    compile_times[i] = absl::Now() - start;
+  };
+  const size_t thread_count =
+      options.threading == nullptr
+          ? 1
+          : std::min<size_t>(
+                std::max(options.threading->GetRecommendedThreadCount(), 1),
+                models.size());
+  if (thread_count <= 1) {
+    for (size_t i = 0; i < models.size(); ++i) {
+      compile_model(i);
+      if (!results[i].ok()) {
+        break;
+      }
+    }
+  } else {
+    std::atomic<size_t> next_model = 0;
+    auto worker = [&] {
+      for (size_t i = next_model++; i < models.size(); i = next_model++) {
+        compile_model(i);
+      }
+    };
+    options.threading->WithThreading([&] {
+      std::vector<ThreadingInterface::JoinFn> join_fns;
+      join_fns.reserve(thread_count - 1);
+      for (size_t i = 1; i < thread_count; ++i) {
+        join_fns.push_back(options.threading->StartThread(worker));
+      }
+      worker();
+      for (auto& join_fn : join_fns) {
+        join_fn();
+      }
+    });
+  }
+
   absl::flat_hash_map<std::string, Function> compiled_models;
-  compiled_models.reserve(model_set.size());
-  for (const auto& [name, model] : model_set) {
-    ASSIGN_OR_RETURN(compiled_models[name], compiler.Compile(model),
-                     _ << "while initializing model \"" << name << "\"");
+  compiled_models.reserve(models.size());
+  for (size_t i = 0; i < models.size(); ++i) {
+    const std::string& name = models[i]->first;
+    RETURN_IF_ERROR(results[i].status())
+        << "while initializing model \"" << name << "\"";
+    compiled_models.emplace(name, *std::move(results[i]));
+    if (options.compile_times != nullptr) {
+      (*options.compile_times)[name] = compile_times[i];
+    }
   }
   return compiled_models;
 }
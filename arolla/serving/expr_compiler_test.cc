@@ -28,6 +28,8 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/eval/thread_safe_model_executor.h"
@@ -52,6 +54,7 @@
 #include "arolla/qtype/typed_value.h"
 #include "arolla/util/init_arolla.h"
 #include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/threading.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace {
@@ -72,6 +75,7 @@ using ::testing::HasSubstr;
 using ::testing::IsNull;
 using ::testing::NotNull;
 using ::testing::Pair;
+using ::testing::SizeIs;
 using ::testing::UnorderedElementsAre;
 
 struct TestInput {
@@ -298,7 +302,7 @@ TEST_F(ExprCompilerTest, Move) {
               // We can set options on rvalue before the move into a function.
               .SetSlotListener(CreateSlotListener()))
           // We can set options on rvalue after the move into a function.
-          .SetExperimentalArenaAllocator()
+          .SetArenaAllocator()
           .AllowOutputCasting()
           .Compile(expr_));
 
@@ -335,7 +339,7 @@ TEST_F(ExprCompilerTest, OtherOptionsSmokeTest) {
       (ExprCompiler<TestInput, std::optional<float>, TestSideOutput>())
           .SetInputLoader(CreateInputLoader())
           .SetSlotListener(CreateSlotListener())
-          .SetExperimentalArenaAllocator()
+          .SetArenaAllocator()
           .SetAlwaysCloneThreadSafetyPolicy()
           .AllowOutputCasting()
           .Compile(expr_));
@@ -403,6 +407,46 @@ TEST_F(ExprCompilerTest, PoolThreadSafetyPolicy) {
               NotNull());
 }
 
+TEST_F(ExprCompilerTest, LockFreePoolThreadSafetyPolicy) {
+  ASSERT_OK_AND_ASSIGN(
+      auto model,
+      (ExprCompiler<TestInput, std::optional<float>, TestSideOutput>())
+          .SetInputLoader(CreateInputLoader())
+          .SetSlotListener(CreateSlotListener())
+          .SetLockFreePoolThreadSafetyPolicy()
+          .AllowOutputCasting()
+          .Compile(expr_));
+  TestInput input{.x = 28, .y = 29};
+  TestSideOutput side_output;
+  // NOTE: Thread safety is tested in
+  // expr/eval/thread_safe_model_executor_test.cc
+  EXPECT_THAT(model(input, &side_output), IsOkAndHolds(57));
+  EXPECT_THAT(side_output.subtract, Eq(-1));
+  EXPECT_THAT((model.target<expr::ThreadSafeLockFreePoolModelExecutor<
+                   TestInput, std::optional<float>, TestSideOutput>>()),
+              NotNull());
+}
+
+TEST_F(ExprCompilerTest, NumaPoolThreadSafetyPolicy) {
+  ASSERT_OK_AND_ASSIGN(
+      auto model,
+      (ExprCompiler<TestInput, std::optional<float>, TestSideOutput>())
+          .SetInputLoader(CreateInputLoader())
+          .SetSlotListener(CreateSlotListener())
+          .SetNumaPoolThreadSafetyPolicy()
+          .AllowOutputCasting()
+          .Compile(expr_));
+  TestInput input{.x = 28, .y = 29};
+  TestSideOutput side_output;
+  // NOTE: Thread safety is tested in
+  // expr/eval/thread_safe_model_executor_test.cc
+  EXPECT_THAT(model(input, &side_output), IsOkAndHolds(57));
+  EXPECT_THAT(side_output.subtract, Eq(-1));
+  EXPECT_THAT((model.target<expr::ThreadSafeNumaPoolModelExecutor<
+                   TestInput, std::optional<float>, TestSideOutput>>()),
+              NotNull());
+}
+
 TEST_F(ExprCompilerTest, AlwaysCloneThreadSafetyPolicy) {
   ASSERT_OK_AND_ASSIGN(
       auto model,
@@ -435,6 +479,46 @@ TEST_F(ExprCompilerTest, ThreadUnsafe) {
   EXPECT_THAT(side_output.subtract, Eq(-1));
 }
 
+TEST_F(ExprCompilerTest, Warmup) {
+  std::vector<TestInput> samples = {{.x = 1, .y = 2}, {.x = 3, .y = 4}};
+  ASSERT_OK_AND_ASSIGN(
+      auto model,
+      (ExprCompiler<TestInput, std::optional<float>, TestSideOutput>())
+          .SetInputLoader(CreateInputLoader())
+          .SetSlotListener(CreateSlotListener())
+          .SetPoolThreadSafetyPolicy()
+          .SetWarmup(samples, /*executor_count=*/2)
+          .AllowOutputCasting()
+          .Compile(expr_));
+  const auto* pool = model.target<expr::ThreadSafePoolModelExecutor<
+      TestInput, std::optional<float>, TestSideOutput>>();
+  ASSERT_THAT(pool, NotNull());
+  EXPECT_EQ(pool->GetStats().idle_executors, 2);
+  TestInput input{.x = 28, .y = 29};
+  TestSideOutput side_output;
+  EXPECT_THAT(model(input, &side_output), IsOkAndHolds(57));
+  EXPECT_EQ(pool->GetStats().idle_executors, 2);
+
+  using Compiler =
+      ExprCompiler<TestInput, std::optional<float>, TestSideOutput>;
+  for (auto set_policy : std::vector<std::function<void(Compiler&)>>{
+           [](Compiler& c) { c.SetLockFreePoolThreadSafetyPolicy(); },
+           [](Compiler& c) { c.SetAlwaysCloneThreadSafetyPolicy(); },
+           [](Compiler& c) {
+             c.SetThreadUnsafe_I_SWEAR_TO_COPY_MODEL_FUNCTION_BEFORE_CALL();
+           },
+       }) {
+    Compiler compiler;
+    compiler.SetInputLoader(CreateInputLoader())
+        .SetSlotListener(CreateSlotListener())
+        .SetWarmup(samples, /*executor_count=*/2)
+        .AllowOutputCasting();
+    set_policy(compiler);
+    ASSERT_OK_AND_ASSIGN(auto model, compiler.Compile(expr_));
+    EXPECT_THAT(model(input, &side_output), IsOkAndHolds(57));
+  }
+}
+
 TEST_F(ExprCompilerTest, ForceNonOptionalOutput) {
   ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.neg", {Leaf("x")}));
   ASSERT_OK_AND_ASSIGN(
@@ -555,5 +639,38 @@ TEST_F(ExprCompilerTest, CompileExprSet_Errors) {
                "very bad model; while initializing model \"bad_model\""));
 }
 
+TEST_F(ExprCompilerTest, CompileExprSetInParallel) {
+  absl::flat_hash_map<std::string, absl::StatusOr<expr::ExprNodePtr>> model_set;
+  for (int i = 0; i < 20; ++i) {
+    model_set.emplace(absl::StrCat("model_", i), expr_);
+  }
+  StdThreading threading(4);
+  absl::flat_hash_map<std::string, absl::Duration> compile_times;
+  ASSERT_OK_AND_ASSIGN(
+      auto models,
+      CompileExprSet(ExprCompiler<TestInput, std::optional<float>>()
+                         .SetInputLoader(CreateInputLoader())
+                         .AllowOutputCasting(),
+                     model_set,
+                     {.threading = &threading,
+                      .compile_times = &compile_times}));
+  EXPECT_THAT(models, SizeIs(20));
+  EXPECT_THAT(compile_times, SizeIs(20));
+  TestInput input{.x = 28, .y = 29};
+  for (const auto& [name, model] : models) {
+    EXPECT_THAT(model(input), IsOkAndHolds(57)) << name;
+  }
+
+  model_set["bad_model_1"] = absl::FailedPreconditionError("very bad model");
+  model_set["bad_model_2"] = absl::InternalError("even worse model");
+  EXPECT_THAT(
+      CompileExprSet(ExprCompiler<TestInput, std::optional<float>>()
+                         .SetInputLoader(CreateInputLoader())
+                         .AllowOutputCasting(),
+                     model_set, {.threading = &threading}),
+      StatusIs(absl::StatusCode::kFailedPrecondition,
+               "very bad model; while initializing model \"bad_model_1\""));
+}
+
 }  // namespace
 }  // namespace arolla
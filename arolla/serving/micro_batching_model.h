@@ -0,0 +1,242 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_SERVING_MICRO_BATCHING_MODEL_H_
+#define AROLLA_SERVING_MICRO_BATCHING_MODEL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+
+struct MicroBatchingOptions {
+  // Max number of requests evaluated in a single batch. Must be positive.
+  int64_t max_batch_size = 256;
+
+  // Max time the first request of a batch waits for further requests before
+  // the batch is evaluated. The latency budget added by batching.
+  absl::Duration max_batch_delay = absl::Microseconds(500);
+
+  // Max number of requests that are waiting for or undergoing evaluation. The
+  // requests above the limit fail immediately with ResourceExhaustedError, so
+  // the callers can shed the load instead of queueing indefinitely. Must be
+  // positive.
+  int64_t max_pending_requests = 4096;
+};
+
+// A thread-safe front-end for an array model that coalesces concurrent
+// single-row requests into batches.
+//
+// The first request arriving when there is no open batch opens a new one and
+// waits until it is full or `max_batch_delay` expires; then it evaluates
+// `batch_model` on the collected inputs in the calling thread and fans the
+// rows of the result out to the requests of the batch. So no background
+// threads are involved, and a single caller only pays `max_batch_delay`.
+//
+// Usage example:
+//
+//   ASSIGN_OR_RETURN(auto batch_loader,
+//                    BatchInputLoader<MyInput>::Create(CreateMyInputLoader()));
+//   ASSIGN_OR_RETURN(
+//       auto batch_model,
+//       (ExprCompiler<absl::Span<const MyInput>, DenseArray<float>>())
+//           .SetInputLoader(std::move(batch_loader))
+//           .Compile(expr));
+//   ASSIGN_OR_RETURN(auto model,
+//                    (MicroBatchingModel<MyInput, float>::Create(
+//                        std::move(batch_model), {.max_batch_size = 128})));
+//   // From many threads:
+//   ASSIGN_OR_RETURN(OptionalValue<float> result, model(my_input));
+//
+// NOTE: an error during the batch evaluation is returned to all the requests
+// of the batch.
+//
+// The inputs are copied into the batch, so Input must be copyable. The copies
+// of MicroBatchingModel share the batches and the stats.
+template <typename Input, typename T>
+class MicroBatchingModel {
+ public:
+  using BatchModel = std::function<absl::StatusOr<DenseArray<T>>(
+      const absl::Span<const Input>&)>;
+
+  struct Stats {
+    // Requests accepted for evaluation.
+    int64_t requests = 0;
+    // Requests rejected because of `max_pending_requests` limit.
+    int64_t rejected_requests = 0;
+    // Evaluated batches, including the failed ones.
+    int64_t batches = 0;
+    int64_t failed_batches = 0;
+    // Max number of pending requests observed.
+    int64_t peak_pending_requests = 0;
+  };
+
+  // Returns InvalidArgumentError if the options are invalid.
+  static absl::StatusOr<MicroBatchingModel> Create(
+      BatchModel batch_model, MicroBatchingOptions options = {}) {
+    if (options.max_batch_size <= 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("max_batch_size must be positive, got %d",
+                          options.max_batch_size));
+    }
+    if (options.max_pending_requests <= 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("max_pending_requests must be positive, got %d",
+                          options.max_pending_requests));
+    }
+    return MicroBatchingModel(std::move(batch_model), options);
+  }
+
+  // Evaluates the model on a single input. Blocks until the batch containing
+  // the input is evaluated.
+  absl::StatusOr<OptionalValue<T>> operator()(const Input& input) const {
+    Shared& shared = *shared_;
+    std::shared_ptr<Batch> batch;
+    int64_t row_id;
+    bool is_leader;
+    {
+      absl::MutexLock lock(&shared.mutex);
+      if (shared.pending_requests >= shared.options.max_pending_requests) {
+        ++shared.stats.rejected_requests;
+        return absl::ResourceExhaustedError(absl::StrFormat(
+            "too many pending requests (limit: %d)",
+            shared.options.max_pending_requests));
+      }
+      ++shared.pending_requests;
+      ++shared.stats.requests;
+      shared.stats.peak_pending_requests = std::max(
+          shared.stats.peak_pending_requests, shared.pending_requests);
+      is_leader = shared.open_batch == nullptr;
+      if (is_leader) {
+        shared.open_batch = std::make_shared<Batch>();
+        shared.open_batch->inputs.reserve(shared.options.max_batch_size);
+      }
+      batch = shared.open_batch;
+      row_id = batch->inputs.size();
+      batch->inputs.push_back(input);
+      if (row_id + 1 >= shared.options.max_batch_size) {
+        CloseBatch(shared, *batch);
+        batch->closed_or_done.SignalAll();
+      }
+      if (is_leader) {
+        const absl::Time deadline =
+            absl::Now() + shared.options.max_batch_delay;
+        while (!batch->closed &&
+               !batch->closed_or_done.WaitWithDeadline(&shared.mutex,
+                                                       deadline)) {
+        }
+        if (!batch->closed) {
+          CloseBatch(shared, *batch);
+        }
+      } else {
+        while (!batch->done) {
+          batch->closed_or_done.Wait(&shared.mutex);
+        }
+      }
+    }
+    if (is_leader) {
+      // The batch is closed, so nobody else accesses it until `done` is set.
+      auto result = shared.batch_model(batch->inputs);
+      absl::MutexLock lock(&shared.mutex);
+      ++shared.stats.batches;
+      const int64_t batch_size = batch->inputs.size();
+      if (result.ok() && result->size() != batch_size) {
+        result = absl::InternalError(absl::StrFormat(
+            "batch model returned %d rows for a batch of size %d",
+            result->size(), batch_size));
+      }
+      if (result.ok()) {
+        batch->outputs = *std::move(result);
+      } else {
+        ++shared.stats.failed_batches;
+        batch->status = std::move(result).status();
+      }
+      batch->done = true;
+      batch->closed_or_done.SignalAll();
+    }
+    {
+      absl::MutexLock lock(&shared.mutex);
+      --shared.pending_requests;
+    }
+    // `batch` is immutable once done.
+    RETURN_IF_ERROR(batch->status);
+    if (!batch->outputs.present(row_id)) {
+      return OptionalValue<T>{};
+    }
+    return OptionalValue<T>(T(batch->outputs.values[row_id]));
+  }
+
+  Stats GetStats() const {
+    absl::MutexLock lock(&shared_->mutex);
+    return shared_->stats;
+  }
+
+ private:
+  MicroBatchingModel(BatchModel batch_model, MicroBatchingOptions options)
+      : shared_(std::make_shared<Shared>(std::move(batch_model), options)) {}
+
+  struct Batch {
+    std::vector<Input> inputs;
+    bool closed = false;
+    bool done = false;
+    absl::CondVar closed_or_done;
+    absl::Status status;
+    DenseArray<T> outputs;
+  };
+
+  struct Shared {
+    Shared(BatchModel batch_model, MicroBatchingOptions options)
+        : batch_model(std::move(batch_model)), options(options) {}
+
+    const BatchModel batch_model;
+    const MicroBatchingOptions options;
+    absl::Mutex mutex;
+    // The batch accepting new requests.
+    std::shared_ptr<Batch> open_batch ABSL_GUARDED_BY(mutex);
+    int64_t pending_requests ABSL_GUARDED_BY(mutex) = 0;
+    Stats stats ABSL_GUARDED_BY(mutex);
+  };
+
+  static void CloseBatch(Shared& shared, Batch& batch)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shared.mutex) {
+    batch.closed = true;
+    if (shared.open_batch.get() == &batch) {
+      shared.open_batch = nullptr;
+    }
+  }
+
+  std::shared_ptr<Shared> shared_;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_SERVING_MICRO_BATCHING_MODEL_H_
@@ -0,0 +1,227 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/serving/micro_batching_model.h"
+
+#include <cstdint>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/expr.h"
+#include "arolla/io/accessors_input_loader.h"
+#include "arolla/io/batch_input_loader.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/serving/expr_compiler.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::IsOkAndHolds;
+using ::arolla::testing::StatusIs;
+using ::testing::Each;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+
+using DoubleModel = MicroBatchingModel<int64_t, int64_t>;
+
+// Returns 2 * x for each row, records the batch sizes.
+class DoublingBatchModel {
+ public:
+  absl::StatusOr<DenseArray<int64_t>> operator()(
+      absl::Span<const int64_t> inputs) {
+    absl::MutexLock lock(&mutex_);
+    batch_sizes_.push_back(inputs.size());
+    DenseArrayBuilder<int64_t> builder(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      builder.Set(i, 2 * inputs[i]);
+    }
+    return std::move(builder).Build();
+  }
+
+  std::vector<int64_t> batch_sizes() const {
+    absl::MutexLock lock(&mutex_);
+    return batch_sizes_;
+  }
+
+ private:
+  mutable absl::Mutex mutex_;
+  std::vector<int64_t> batch_sizes_ ABSL_GUARDED_BY(mutex_);
+};
+
+TEST(MicroBatchingModelTest, SingleRequest) {
+  DoublingBatchModel batch_model;
+  ASSERT_OK_AND_ASSIGN(
+      auto model,
+      (DoubleModel::Create(
+          [&](absl::Span<const int64_t> inputs) { return batch_model(inputs); },
+          {.max_batch_delay = absl::Milliseconds(1)})));
+  EXPECT_THAT(model(57), IsOkAndHolds(OptionalValue<int64_t>(114)));
+  EXPECT_THAT(model(5), IsOkAndHolds(OptionalValue<int64_t>(10)));
+  EXPECT_THAT(batch_model.batch_sizes(), ElementsAre(1, 1));
+  auto stats = model.GetStats();
+  EXPECT_THAT(stats.requests, Eq(2));
+  EXPECT_THAT(stats.batches, Eq(2));
+  EXPECT_THAT(stats.failed_batches, Eq(0));
+  EXPECT_THAT(stats.rejected_requests, Eq(0));
+}
+
+TEST(MicroBatchingModelTest, ConcurrentRequests) {
+  constexpr int64_t kThreadCount = 16;
+  DoublingBatchModel batch_model;
+  // The long delay guarantees that the batches are evaluated only when full.
+  ASSERT_OK_AND_ASSIGN(
+      auto model,
+      (DoubleModel::Create(
+          [&](absl::Span<const int64_t> inputs) { return batch_model(inputs); },
+          {.max_batch_size = 4, .max_batch_delay = absl::Hours(1)})));
+  std::vector<absl::StatusOr<OptionalValue<int64_t>>> results(kThreadCount);
+  std::vector<std::thread> threads;
+  for (int64_t i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&, i] { results[i] = model(i); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int64_t i = 0; i < kThreadCount; ++i) {
+    EXPECT_THAT(results[i], IsOkAndHolds(OptionalValue<int64_t>(2 * i)));
+  }
+  EXPECT_THAT(batch_model.batch_sizes(), Each(Eq(4)));
+  auto stats = model.GetStats();
+  EXPECT_THAT(stats.requests, Eq(kThreadCount));
+  EXPECT_THAT(stats.batches, Eq(kThreadCount / 4));
+}
+
+TEST(MicroBatchingModelTest, MissingRows) {
+  ASSERT_OK_AND_ASSIGN(
+      auto model,
+      (DoubleModel::Create(
+          [](absl::Span<const int64_t> inputs)
+              -> absl::StatusOr<DenseArray<int64_t>> {
+            return CreateEmptyDenseArray<int64_t>(inputs.size());
+          },
+          {.max_batch_delay = absl::ZeroDuration()})));
+  EXPECT_THAT(model(57), IsOkAndHolds(OptionalValue<int64_t>()));
+}
+
+TEST(MicroBatchingModelTest, Errors) {
+  ASSERT_OK_AND_ASSIGN(
+      auto failing_model,
+      (DoubleModel::Create(
+          [](absl::Span<const int64_t>) -> absl::StatusOr<DenseArray<int64_t>> {
+            return absl::InvalidArgumentError("failed");
+          },
+          {.max_batch_delay = absl::ZeroDuration()})));
+  EXPECT_THAT(failing_model(57),
+              StatusIs(absl::StatusCode::kInvalidArgument, "failed"));
+  EXPECT_THAT(failing_model.GetStats().failed_batches, Eq(1));
+
+  ASSERT_OK_AND_ASSIGN(
+      auto wrong_size_model,
+      (DoubleModel::Create(
+          [](absl::Span<const int64_t>) -> absl::StatusOr<DenseArray<int64_t>> {
+            return CreateDenseArray<int64_t>({1, 2});
+          },
+          {.max_batch_delay = absl::ZeroDuration()})));
+  EXPECT_THAT(wrong_size_model(57),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("returned 2 rows for a batch of size 1")));
+}
+
+TEST(MicroBatchingModelTest, BackPressure) {
+  absl::Notification started;
+  absl::Notification unblock;
+  ASSERT_OK_AND_ASSIGN(
+      auto model,
+      (DoubleModel::Create(
+          [&](absl::Span<const int64_t> inputs)
+              -> absl::StatusOr<DenseArray<int64_t>> {
+            if (!started.HasBeenNotified()) {
+              started.Notify();
+            }
+            unblock.WaitForNotification();
+            return CreateDenseArray<int64_t>({inputs[0]});
+          },
+          {.max_batch_delay = absl::ZeroDuration(),
+           .max_pending_requests = 1})));
+  std::thread thread([&] {
+    EXPECT_THAT(model(57), IsOkAndHolds(OptionalValue<int64_t>(57)));
+  });
+  started.WaitForNotification();
+  EXPECT_THAT(model(58), StatusIs(absl::StatusCode::kResourceExhausted));
+  unblock.Notify();
+  thread.join();
+  EXPECT_THAT(model(59), IsOkAndHolds(OptionalValue<int64_t>(59)));
+  auto stats = model.GetStats();
+  EXPECT_THAT(stats.requests, Eq(2));
+  EXPECT_THAT(stats.rejected_requests, Eq(1));
+  EXPECT_THAT(stats.peak_pending_requests, Eq(1));
+}
+
+TEST(MicroBatchingModelTest, InvalidOptions) {
+  auto batch_model = [](absl::Span<const int64_t> inputs)
+      -> absl::StatusOr<DenseArray<int64_t>> {
+    return CreateEmptyDenseArray<int64_t>(inputs.size());
+  };
+  EXPECT_THAT(DoubleModel::Create(batch_model, {.max_batch_size = 0}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "max_batch_size must be positive, got 0"));
+  EXPECT_THAT(DoubleModel::Create(batch_model, {.max_pending_requests = -1}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "max_pending_requests must be positive, got -1"));
+}
+
+struct TestInput {
+  float x;
+  float y;
+};
+
+TEST(MicroBatchingModelTest, ExprCompiler) {
+  ASSERT_OK(InitArolla());
+  ASSERT_OK_AND_ASSIGN(auto scalar_loader,
+                       CreateAccessorsInputLoader<TestInput>(
+                           "x", [](const TestInput& in) { return in.x; },
+                           "y", [](const TestInput& in) { return in.y; }));
+  ASSERT_OK_AND_ASSIGN(
+      auto batch_loader,
+      BatchInputLoader<TestInput>::Create(std::move(scalar_loader)));
+  ASSERT_OK_AND_ASSIGN(
+      auto batch_model,
+      (ExprCompiler<absl::Span<const TestInput>, DenseArray<float>>())
+          .SetInputLoader(std::move(batch_loader))
+          .Compile(expr::CallOp("math.add", {expr::Leaf("x"),
+                                             expr::Leaf("y")})));
+  ASSERT_OK_AND_ASSIGN(
+      auto model,
+      (MicroBatchingModel<TestInput, float>::Create(
+          std::move(batch_model), {.max_batch_delay = absl::ZeroDuration()})));
+  EXPECT_THAT(model(TestInput{.x = 28, .y = 29}),
+              IsOkAndHolds(OptionalValue<float>(57)));
+}
+
+}  // namespace
+}  // namespace arolla
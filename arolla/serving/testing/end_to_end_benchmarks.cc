@@ -0,0 +1,332 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// End-to-end benchmarks of a typical serving pipeline:
+//   proto input -> ProtoFieldsLoader -> preprocessing + decision forest +
+//   postprocessing -> slot listener.
+// In addition to the time per call they report p50/p99 latency and the number
+// of heap allocations per call, so that thread safety and arena policies can
+// be compared on the whole path.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/random/random.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/message.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/expr_operator/decision_forest_operator.h"
+#include "arolla/decision_forest/testing/test_util.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/testing/testing.h"
+#include "arolla/io/accessors_slot_listener.h"
+#include "arolla/io/proto/proto_input_loader.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/proto/test.pb.h"
+#include "arolla/serving/expr_compiler.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/status_macros_backport.h"
+
+namespace arolla {
+namespace {
+
+// Number of heap allocations made by the current thread. Incremented by the
+// replacements of the malloc family below. operator new, HeapBufferFactory and
+// the other allocators end up in malloc, so they are counted too.
+thread_local int64_t allocation_count = 0;
+
+#if defined(__GLIBC__)
+constexpr bool kCountsAllocations = true;
+#else
+// Replacing malloc is only supported on glibc, `allocs_per_call` is not
+// reported on other platforms.
+constexpr bool kCountsAllocations = false;
+#endif
+
+}  // namespace
+}  // namespace arolla
+
+#if defined(__GLIBC__)
+
+extern "C" {
+
+void* __libc_malloc(size_t size) noexcept;
+void* __libc_calloc(size_t count, size_t size) noexcept;
+void* __libc_realloc(void* ptr, size_t size) noexcept;
+void* __libc_memalign(size_t alignment, size_t size) noexcept;
+
+void* malloc(size_t size) noexcept {
+  ++arolla::allocation_count;
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+  ++arolla::allocation_count;
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+  ++arolla::allocation_count;
+  return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+  ++arolla::allocation_count;
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+  ++arolla::allocation_count;
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept {
+  ++arolla::allocation_count;
+  void* result = __libc_memalign(alignment, size);
+  if (result == nullptr) {
+    return ENOMEM;
+  }
+  *ptr = result;
+  return 0;
+}
+
+}  // extern "C"
+
+#endif  // defined(__GLIBC__)
+
+namespace arolla {
+namespace {
+
+using ::arolla::expr::CallOp;
+using ::arolla::expr::ExprNodePtr;
+using ::arolla::expr::Leaf;
+using ::arolla::expr::Literal;
+using ::arolla::testing::WithExportAnnotation;
+
+constexpr int kFeatureCount = 10;
+constexpr int64_t kBatchSize = 256;
+
+const DecisionForestPtr& GetForest() {
+  static const Indestructible<DecisionForestPtr> forest([] {
+    absl::BitGen rnd;
+    return DecisionForestPtr(CreateRandomFloatForest(
+        &rnd, kFeatureCount, /*interactions=*/true, /*min_num_splits=*/10,
+        /*max_num_splits=*/30, /*num_trees=*/300));
+  }());
+  return *forest;
+}
+
+// Reads x0 ... x9 under `path_prefix`, scales them into the [0, 1) range of
+// the forest thresholds, evaluates the forest and adds a linear term. The raw
+// forest score is exported as "forest_score".
+absl::StatusOr<ExprNodePtr> PipelineExpr(absl::string_view path_prefix) {
+  CHECK_OK(InitArolla());
+  std::vector<absl::StatusOr<ExprNodePtr>> features;
+  for (int i = 0; i < kFeatureCount; ++i) {
+    ASSIGN_OR_RETURN(
+        auto feature,
+        CallOp("core.to_float32", {Leaf(absl::StrCat(path_prefix, "/x", i))}));
+    ASSIGN_OR_RETURN(feature,
+                     CallOp("math.multiply", {feature, Literal(0.01f)}));
+    features.push_back(std::move(feature));
+  }
+  ASSIGN_OR_RETURN(auto scores,
+                   CallOp(std::make_shared<DecisionForestOperator>(
+                              GetForest(), std::vector<TreeFilter>{{}}),
+                          features));
+  ASSIGN_OR_RETURN(auto forest_score,
+                   WithExportAnnotation(
+                       CallOp("core.get_nth", {scores, Literal<int64_t>(0)}),
+                       "forest_score"));
+  return CallOp("math.add",
+                {forest_score, CallOp("math.multiply",
+                                      {features[0], Literal(0.5f)})});
+}
+
+void FillRow(absl::BitGen& rnd, ::testing_namespace::Root* row) {
+  const google::protobuf::Reflection* reflection = row->GetReflection();
+  for (int i = 0; i < kFeatureCount; ++i) {
+    reflection->SetInt32(
+        row,
+        row->GetDescriptor()->FindFieldByName(absl::StrCat("x", i)),
+        absl::Uniform<int32_t>(rnd, 0, 100));
+  }
+}
+
+// One proto per call, scalar evaluation.
+struct SingleRow {
+  using Output = OptionalValue<float>;
+  struct SideOutput {
+    float forest_score;
+  };
+  static constexpr absl::string_view kPathPrefix = "";
+
+  static ::testing_namespace::Root CreateInput(absl::BitGen& rnd) {
+    ::testing_namespace::Root input;
+    FillRow(rnd, &input);
+    return input;
+  }
+};
+
+// kBatchSize rows per call stored in inners[:].root_reference, evaluation on
+// DenseArrays.
+struct Batch {
+  using Output = DenseArray<float>;
+  struct SideOutput {
+    DenseArray<float> forest_score;
+  };
+  static constexpr absl::string_view kPathPrefix = "/inners[:]/root_reference";
+
+  static ::testing_namespace::Root CreateInput(absl::BitGen& rnd) {
+    ::testing_namespace::Root input;
+    for (int64_t i = 0; i < kBatchSize; ++i) {
+      FillRow(rnd, input.add_inners()->mutable_root_reference());
+    }
+    return input;
+  }
+};
+
+enum class Policy { kAlwaysClone, kPool, kLockFreePool };
+
+template <typename Pipeline>
+using ModelFunction = std::function<absl::StatusOr<typename Pipeline::Output>(
+    const google::protobuf::Message&, typename Pipeline::SideOutput*)>;
+
+template <typename Pipeline>
+ModelFunction<Pipeline> CompileModel(Policy policy, bool arena) {
+  using SideOutput = typename Pipeline::SideOutput;
+  ExprCompiler<google::protobuf::Message, typename Pipeline::Output, SideOutput>
+      compiler;
+  compiler
+      .SetInputLoader(
+          ProtoFieldsLoader::Create(::testing_namespace::Root::descriptor()))
+      .SetSlotListener(CreateAccessorsSlotListener<SideOutput>(
+          "forest_score",
+          [](const decltype(SideOutput::forest_score)& x, SideOutput* out) {
+            out->forest_score = x;
+          }));
+  switch (policy) {
+    case Policy::kAlwaysClone:
+      compiler.SetAlwaysCloneThreadSafetyPolicy();
+      break;
+    case Policy::kPool:
+      compiler.SetPoolThreadSafetyPolicy();
+      break;
+    case Policy::kLockFreePool:
+      compiler.SetLockFreePoolThreadSafetyPolicy();
+      break;
+  }
+  if (arena) {
+    compiler.SetArenaAllocator();
+  }
+  return compiler.Compile(PipelineExpr(Pipeline::kPathPrefix)).value();
+}
+
+// Runs a model shared by all the benchmark threads.
+template <typename Pipeline, Policy policy, bool arena>
+void BM_EndToEnd(benchmark::State& state) {
+  static Indestructible<ModelFunction<Pipeline>> model(
+      CompileModel<Pipeline>(policy, arena));
+
+  absl::BitGen rnd;
+  std::vector<::testing_namespace::Root> inputs;
+  for (int i = 0; i < 16; ++i) {
+    inputs.push_back(Pipeline::CreateInput(rnd));
+  }
+  typename Pipeline::SideOutput side_output;
+  // Warm-up the model pools and arenas.
+  for (const auto& input : inputs) {
+    CHECK_OK((*model)(input, &side_output).status());
+  }
+
+  std::vector<double> latencies_us;
+  latencies_us.reserve(1 << 16);
+  int64_t allocations = 0;
+  size_t index = 0;
+  for (auto _ : state) {
+    const auto& input = inputs[index];
+    index = (index + 1) % inputs.size();
+    int64_t allocation_count_before = allocation_count;
+    auto start = std::chrono::steady_clock::now();
+    auto output = (*model)(input, &side_output);
+    auto end = std::chrono::steady_clock::now();
+    allocations += allocation_count - allocation_count_before;
+    benchmark::DoNotOptimize(output);
+    if (latencies_us.size() < latencies_us.capacity()) {
+      latencies_us.push_back(
+          std::chrono::duration<double, std::micro>(end - start).count());
+    }
+  }
+
+  if (!latencies_us.empty()) {
+    std::sort(latencies_us.begin(), latencies_us.end());
+    state.counters["p50_us"] = benchmark::Counter(
+        latencies_us[latencies_us.size() / 2], benchmark::Counter::kAvgThreads);
+    state.counters["p99_us"] =
+        benchmark::Counter(latencies_us[latencies_us.size() * 99 / 100],
+                           benchmark::Counter::kAvgThreads);
+  }
+  if (kCountsAllocations) {
+    int64_t iterations = std::max<int64_t>(state.iterations(), 1);
+    state.counters["allocs_per_call"] =
+        benchmark::Counter(static_cast<double>(allocations) / iterations,
+                           benchmark::Counter::kAvgThreads);
+  }
+  if constexpr (std::is_same_v<Pipeline, Batch>) {
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+  } else {
+    state.SetItemsProcessed(state.iterations());
+  }
+}
+
+void BenchmarkSettings(benchmark::internal::Benchmark* bm) {
+  bm->Threads(1)->Threads(8)->Threads(64);
+}
+
+BENCHMARK(BM_EndToEnd<SingleRow, Policy::kAlwaysClone, false>)
+    ->Apply(BenchmarkSettings);
+BENCHMARK(BM_EndToEnd<SingleRow, Policy::kPool, false>)
+    ->Apply(BenchmarkSettings);
+BENCHMARK(BM_EndToEnd<SingleRow, Policy::kLockFreePool, false>)
+    ->Apply(BenchmarkSettings);
+
+BENCHMARK(BM_EndToEnd<Batch, Policy::kAlwaysClone, false>)
+    ->Apply(BenchmarkSettings);
+BENCHMARK(BM_EndToEnd<Batch, Policy::kPool, false>)->Apply(BenchmarkSettings);
+BENCHMARK(BM_EndToEnd<Batch, Policy::kLockFreePool, false>)
+    ->Apply(BenchmarkSettings);
+BENCHMARK(BM_EndToEnd<Batch, Policy::kAlwaysClone, true>)
+    ->Apply(BenchmarkSettings);
+BENCHMARK(BM_EndToEnd<Batch, Policy::kPool, true>)->Apply(BenchmarkSettings);
+BENCHMARK(BM_EndToEnd<Batch, Policy::kLockFreePool, true>)
+    ->Apply(BenchmarkSettings);
+
+}  // namespace
+}  // namespace arolla
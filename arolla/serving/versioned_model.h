@@ -0,0 +1,226 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_SERVING_VERSIONED_MODEL_H_
+#define AROLLA_SERVING_VERSIONED_MODEL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/log/check.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace arolla {
+
+// A handle to the current version of a model that can be replaced while the
+// model is evaluated from many threads, e.g. when a server receives a new
+// model version.
+//
+// Acquire() pins the current version for the duration of a call and never
+// takes a lock: it costs a few atomic operations. Swap() publishes the new
+// version atomically; the calls in flight keep using the version they
+// acquired, and an old version is destroyed by the release of its last
+// lease. Swap() is expected to receive a fully prepared model (e.g. a
+// ThreadSafePoolModelExecutor compiled with warmup), so the first requests
+// to the new version do not pay for its initialization.
+//
+// Usage example:
+//
+//   ASSIGN_OR_RETURN(auto model,
+//                    (ExprCompiler<MyInput, float>())
+//                        .SetInputLoader(CreateMyInputLoader())
+//                        .Compile(expr));
+//   using Model = decltype(model);
+//   VersionedModel<Model> versioned_model(
+//       std::make_shared<Model>(std::move(model)));
+//
+//   // From many threads:
+//   auto lease = versioned_model.Acquire();
+//   ASSIGN_OR_RETURN(float result, (*lease)(my_input));
+//
+//   // From the update thread:
+//   versioned_model.Swap(std::make_shared<Model>(std::move(new_model)));
+//   versioned_model.WaitForOldVersions(absl::Now() + absl::Seconds(10));
+//
+// Model must be safe to use from several threads via a const reference.
+template <typename Model>
+class VersionedModel {
+  struct Version;
+
+ public:
+  // A reference to a version of the model. The version is kept alive while
+  // the lease exists, so it must not be held longer than a single call.
+  class Lease {
+   public:
+    Lease() = default;
+    Lease(Lease&& other) noexcept
+        : version_(std::exchange(other.version_, nullptr)) {}
+    Lease& operator=(Lease&& other) noexcept {
+      if (this != &other) {
+        Release();
+        version_ = std::exchange(other.version_, nullptr);
+      }
+      return *this;
+    }
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    ~Lease() { Release(); }
+
+    explicit operator bool() const { return version_ != nullptr; }
+    const Model& operator*() const { return *version_->model; }
+    const Model* operator->() const { return version_->model.get(); }
+
+    // Id of the leased version, see VersionedModel::Swap.
+    int64_t version() const { return version_->id; }
+
+   private:
+    friend class VersionedModel;
+
+    explicit Lease(Version* version) : version_(version) {}
+
+    void Release() {
+      if (version_ != nullptr) {
+        Version::Unref(version_);
+        version_ = nullptr;
+      }
+    }
+
+    Version* version_ = nullptr;
+  };
+
+  // Creates the handle with the initial version (with id 0) of the model.
+  explicit VersionedModel(std::shared_ptr<const Model> model)
+      : live_versions_(std::make_shared<std::atomic<int64_t>>(0)),
+        current_(NewVersion(std::move(model), 0)) {}
+
+  VersionedModel(const VersionedModel&) = delete;
+  VersionedModel& operator=(const VersionedModel&) = delete;
+
+  // The old versions are destroyed by their last leases.
+  ~VersionedModel() { Version::Unref(current_.load()); }
+
+  // Returns a lease on the current version of the model.
+  Lease Acquire() const {
+    // A reader announces itself in the counter of the current epoch before
+    // loading `current_`, so a concurrent Swap() waits until the reader has
+    // referenced the version it loaded before releasing the version. If the
+    // epoch changes before the announcement is visible, the Swap() might
+    // have missed it, so the reader retries.
+    for (;;) {
+      int64_t epoch = epoch_.load();
+      std::atomic<int64_t>& readers = readers_[epoch & 1].count;
+      readers.fetch_add(1, std::memory_order_seq_cst);
+      if (ABSL_PREDICT_TRUE(epoch_.load(std::memory_order_seq_cst) == epoch)) {
+        Version* version = current_.load();
+        version->refs.fetch_add(1, std::memory_order_relaxed);
+        readers.fetch_sub(1, std::memory_order_release);
+        return Lease(version);
+      }
+      readers.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  // Atomically replaces the current version of the model, and returns the id
+  // of the new version. The old version is destroyed once the calls in
+  // flight release their leases.
+  int64_t Swap(std::shared_ptr<const Model> model)
+      ABSL_LOCKS_EXCLUDED(swap_mutex_) {
+    absl::MutexLock lock(&swap_mutex_);
+    int64_t id = ++last_version_id_;
+    Version* old_version = current_.exchange(NewVersion(std::move(model), id));
+    // The readers that have announced themselves in the old epoch may still
+    // be referencing the old version. The new readers use the other counter,
+    // so the wait is short.
+    //
+    // NOTE: The load must be seq_cst, as the reader's fetch_add and epoch_
+    // load are. With an acquire load the reader's announcement may not be yet
+    // visible here while the reader still sees the old epoch (store
+    // buffering), and the old version would be released under the reader.
+    int64_t old_epoch = epoch_.fetch_add(1);
+    while (readers_[old_epoch & 1].count.load(std::memory_order_seq_cst) !=
+           0) {
+      std::this_thread::yield();
+    }
+    Version::Unref(old_version);
+    return id;
+  }
+
+  // Returns id of the current version.
+  int64_t version() const { return current_.load()->id; }
+
+  // Returns the number of versions not destroyed yet, including the current
+  // one.
+  int64_t live_version_count() const {
+    return live_versions_->load(std::memory_order_acquire);
+  }
+
+  // Waits until all the old versions are destroyed. Returns false if the
+  // deadline has passed earlier.
+  bool WaitForOldVersions(absl::Time deadline) const {
+    while (live_version_count() > 1) {
+      if (absl::Now() >= deadline) {
+        return false;
+      }
+      absl::SleepFor(absl::Microseconds(100));
+    }
+    return true;
+  }
+
+ private:
+  struct Version {
+    std::shared_ptr<const Model> model;
+    int64_t id;
+    // The references from the handle (for the current version) and from the
+    // leases.
+    std::atomic<int64_t> refs = 1;
+    std::shared_ptr<std::atomic<int64_t>> live_versions;
+
+    static void Unref(Version* version) {
+      if (version->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        auto live_versions = std::move(version->live_versions);
+        delete version;
+        live_versions->fetch_sub(1, std::memory_order_release);
+      }
+    }
+  };
+
+  // Avoids false sharing between the counters of readers.
+  struct alignas(64) ReaderCount {
+    std::atomic<int64_t> count = 0;
+  };
+
+  Version* NewVersion(std::shared_ptr<const Model> model, int64_t id) {
+    DCHECK(model != nullptr);
+    live_versions_->fetch_add(1, std::memory_order_relaxed);
+    return new Version{std::move(model), id, {1}, live_versions_};
+  }
+
+  std::shared_ptr<std::atomic<int64_t>> live_versions_;
+  std::atomic<Version*> current_;
+  std::atomic<int64_t> epoch_ = 0;
+  mutable ReaderCount readers_[2];
+  absl::Mutex swap_mutex_;
+  int64_t last_version_id_ ABSL_GUARDED_BY(swap_mutex_) = 0;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_SERVING_VERSIONED_MODEL_H_
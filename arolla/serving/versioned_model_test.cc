@@ -0,0 +1,148 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/serving/versioned_model.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace arolla {
+namespace {
+
+// Checks that the model is alive when evaluated, and counts the destroyed
+// instances.
+class TestModel {
+ public:
+  TestModel(int64_t value, std::shared_ptr<std::atomic<int64_t>> destroyed)
+      : value_(value), destroyed_(std::move(destroyed)) {}
+  ~TestModel() {
+    alive_ = false;
+    destroyed_->fetch_add(1);
+  }
+
+  int64_t operator()() const {
+    EXPECT_TRUE(alive_);
+    return value_;
+  }
+
+ private:
+  int64_t value_;
+  std::shared_ptr<std::atomic<int64_t>> destroyed_;
+  bool alive_ = true;
+};
+
+class VersionedModelTest : public ::testing::Test {
+ protected:
+  std::shared_ptr<const TestModel> MakeModel(int64_t value) {
+    return std::make_shared<TestModel>(value, destroyed_);
+  }
+
+  std::shared_ptr<std::atomic<int64_t>> destroyed_ =
+      std::make_shared<std::atomic<int64_t>>(0);
+};
+
+TEST_F(VersionedModelTest, AcquireAndSwap) {
+  VersionedModel<TestModel> model(MakeModel(1));
+  EXPECT_EQ(model.version(), 0);
+  EXPECT_EQ(model.live_version_count(), 1);
+  {
+    auto lease = model.Acquire();
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(lease.version(), 0);
+    EXPECT_EQ((*lease)(), 1);
+  }
+  EXPECT_EQ(model.Swap(MakeModel(2)), 1);
+  EXPECT_EQ(model.version(), 1);
+  EXPECT_EQ(destroyed_->load(), 1);
+  EXPECT_EQ(model.live_version_count(), 1);
+  auto lease = model.Acquire();
+  EXPECT_EQ(lease.version(), 1);
+  EXPECT_EQ((*lease)(), 2);
+}
+
+TEST_F(VersionedModelTest, LeaseKeepsOldVersionAlive) {
+  VersionedModel<TestModel> model(MakeModel(1));
+  auto old_lease = model.Acquire();
+  model.Swap(MakeModel(2));
+  model.Swap(MakeModel(3));
+  // The second version had no leases.
+  EXPECT_EQ(destroyed_->load(), 1);
+  EXPECT_EQ(model.live_version_count(), 2);
+  EXPECT_FALSE(model.WaitForOldVersions(absl::Now()));
+  EXPECT_EQ(old_lease.version(), 0);
+  EXPECT_EQ((*old_lease)(), 1);
+  EXPECT_EQ((*model.Acquire())(), 3);
+
+  auto moved_lease = std::move(old_lease);
+  EXPECT_FALSE(old_lease);  // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(destroyed_->load(), 1);
+  moved_lease = decltype(moved_lease)();
+  EXPECT_EQ(destroyed_->load(), 2);
+  EXPECT_EQ(model.live_version_count(), 1);
+  EXPECT_TRUE(model.WaitForOldVersions(absl::Now()));
+}
+
+TEST_F(VersionedModelTest, LeaseOutlivesHandle) {
+  auto model = std::make_unique<VersionedModel<TestModel>>(MakeModel(1));
+  auto lease = model->Acquire();
+  model.reset();
+  EXPECT_EQ(destroyed_->load(), 0);
+  EXPECT_EQ((*lease)(), 1);
+  lease = decltype(lease)();
+  EXPECT_EQ(destroyed_->load(), 1);
+}
+
+TEST_F(VersionedModelTest, ConcurrentSwaps) {
+  constexpr int kReaderCount = 4;
+  constexpr int64_t kSwapCount = 200;
+  VersionedModel<TestModel> model(MakeModel(0));
+  std::atomic<bool> done = false;
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaderCount; ++i) {
+    readers.emplace_back([&] {
+      int64_t last_value = 0;
+      while (!done.load()) {
+        auto lease = model.Acquire();
+        int64_t value = (*lease)();
+        // The model values match the versions, and the versions never go
+        // back.
+        EXPECT_EQ(value, lease.version());
+        EXPECT_GE(value, last_value);
+        last_value = value;
+      }
+    });
+  }
+  for (int64_t i = 1; i <= kSwapCount; ++i) {
+    EXPECT_EQ(model.Swap(MakeModel(i)), i);
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_TRUE(model.WaitForOldVersions(absl::Now() + absl::Seconds(10)));
+  EXPECT_EQ(destroyed_->load(), kSwapCount);
+  EXPECT_EQ(model.live_version_count(), 1);
+}
+
+}  // namespace
+}  // namespace arolla
@@ -14,11 +14,13 @@
 //
 #include "arolla/util/binary_search.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 
+#include "absl/log/check.h"
 #include "absl/types/span.h"
 #include "arolla/util/bits.h"
 #include "arolla/util/switch_index.h"
@@ -140,4 +142,150 @@ size_t UpperBoundImpl(int64_t value, absl::Span<const int64_t> array) {
   return BinarySearchT(array, [value](auto arg) { return arg > value; });
 }
 
+namespace {
+
+// Runs FastBinarySearchT for kLanes values at once. The searches are
+// independent, so their loads are executed in parallel instead of waiting for
+// each other.
+//
+// go_right(x, value) must be the negation of the FastBinarySearchT predicate.
+template <size_t kArraySize, size_t kLanes, typename T, typename GoRight>
+void FastBatchBinarySearchT(const T* const array, size_t suffix_offset,
+                            const T* values, int64_t* results,
+                            GoRight go_right) {
+  static_assert((kArraySize & (kArraySize + 1)) == 0);
+  size_t offsets[kLanes];
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+  for (size_t j = 0; j < kLanes; ++j) {
+    offsets[j] = go_right(array[kArraySize], values[j]) * suffix_offset;
+  }
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+  for (size_t k = kArraySize; k > 0;) {
+    k >>= 1;
+    for (size_t j = 0; j < kLanes; ++j) {
+      // Unlike in FastBinarySearchT, the ternary operator is often compiled
+      // into a branch here, so we use arithmetic instead.
+      offsets[j] += (k + 1) * go_right(array[offsets[j] + k], values[j]);
+    }
+  }
+  for (size_t j = 0; j < kLanes; ++j) {
+    results[j] = offsets[j];
+  }
+}
+
+// Sets results[i] to the index of the first element `x` in `array` such that
+// `go_right(x, values[i])` is false.
+template <typename T, typename GoRight>
+void BatchBinarySearchT(absl::Span<const T> values, absl::Span<const T> array,
+                        absl::Span<int64_t> results, GoRight go_right) {
+  DCHECK_EQ(values.size(), results.size());
+  if (array.empty()) {
+    std::fill(results.begin(), results.end(), 0);
+    return;
+  }
+  // The same reduction as in BinarySearchT, but dispatched only once.
+  const int log2_size = BitScanReverse(array.size());
+  switch_index<8 * sizeof(size_t)>(
+      log2_size, [values, array, results, go_right](auto constexpr_log2_size) {
+        constexpr size_t size =
+            (1ULL << static_cast<int>(constexpr_log2_size)) - 1;
+        constexpr size_t kLanes = 8;
+        const size_t suffix_offset = array.size() - size;
+        size_t i = 0;
+        for (; i + kLanes <= values.size(); i += kLanes) {
+          FastBatchBinarySearchT<size, kLanes>(array.data(), suffix_offset,
+                                               values.data() + i,
+                                               results.data() + i, go_right);
+        }
+        for (; i < values.size(); ++i) {
+          FastBatchBinarySearchT<size, 1>(array.data(), suffix_offset,
+                                          values.data() + i,
+                                          results.data() + i, go_right);
+        }
+      });
+}
+
+// The conditions are negations of the std::upper_bound / std::lower_bound
+// ones, so NaN values are handled consistently with them.
+struct LowerBoundGoRight {
+  template <typename T>
+  bool operator()(T x, T value) const {
+    return x < value;
+  }
+};
+
+struct UpperBoundGoRight {
+  template <typename T>
+  bool operator()(T x, T value) const {
+    return !(value < x);
+  }
+};
+
+}  // namespace
+
 }  // namespace arolla::binary_search_details
+
+namespace arolla {
+
+void BatchLowerBound(absl::Span<const float> values,
+                     absl::Span<const float> array,
+                     absl::Span<int64_t> results) {
+  binary_search_details::BatchBinarySearchT(
+      values, array, results, binary_search_details::LowerBoundGoRight());
+}
+
+void BatchLowerBound(absl::Span<const double> values,
+                     absl::Span<const double> array,
+                     absl::Span<int64_t> results) {
+  binary_search_details::BatchBinarySearchT(
+      values, array, results, binary_search_details::LowerBoundGoRight());
+}
+
+void BatchLowerBound(absl::Span<const int32_t> values,
+                     absl::Span<const int32_t> array,
+                     absl::Span<int64_t> results) {
+  binary_search_details::BatchBinarySearchT(
+      values, array, results, binary_search_details::LowerBoundGoRight());
+}
+
+void BatchLowerBound(absl::Span<const int64_t> values,
+                     absl::Span<const int64_t> array,
+                     absl::Span<int64_t> results) {
+  binary_search_details::BatchBinarySearchT(
+      values, array, results, binary_search_details::LowerBoundGoRight());
+}
+
+void BatchUpperBound(absl::Span<const float> values,
+                     absl::Span<const float> array,
+                     absl::Span<int64_t> results) {
+  binary_search_details::BatchBinarySearchT(
+      values, array, results, binary_search_details::UpperBoundGoRight());
+}
+
+void BatchUpperBound(absl::Span<const double> values,
+                     absl::Span<const double> array,
+                     absl::Span<int64_t> results) {
+  binary_search_details::BatchBinarySearchT(
+      values, array, results, binary_search_details::UpperBoundGoRight());
+}
+
+void BatchUpperBound(absl::Span<const int32_t> values,
+                     absl::Span<const int32_t> array,
+                     absl::Span<int64_t> results) {
+  binary_search_details::BatchBinarySearchT(
+      values, array, results, binary_search_details::UpperBoundGoRight());
+}
+
+void BatchUpperBound(absl::Span<const int64_t> values,
+                     absl::Span<const int64_t> array,
+                     absl::Span<int64_t> results) {
+  binary_search_details::BatchBinarySearchT(
+      values, array, results, binary_search_details::UpperBoundGoRight());
+}
+
+}  // namespace arolla
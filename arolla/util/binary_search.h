@@ -56,6 +56,40 @@ size_t UpperBound(int32_t value, absl::Span<const int32_t> array);
 // It is a better performance version of std::upper_bound().
 size_t UpperBound(int64_t value, absl::Span<const int64_t> array);
 
+// Batched left sided binary search: sets `results[i]` to
+// LowerBound(values[i], array). `results` must have the same size as `values`.
+//
+// Much faster than calling LowerBound in a loop: the search is dispatched on
+// the array size once per batch, and several branchless searches are
+// interleaved, so their memory loads overlap.
+void BatchLowerBound(absl::Span<const float> values,
+                     absl::Span<const float> array,
+                     absl::Span<int64_t> results);
+void BatchLowerBound(absl::Span<const double> values,
+                     absl::Span<const double> array,
+                     absl::Span<int64_t> results);
+void BatchLowerBound(absl::Span<const int32_t> values,
+                     absl::Span<const int32_t> array,
+                     absl::Span<int64_t> results);
+void BatchLowerBound(absl::Span<const int64_t> values,
+                     absl::Span<const int64_t> array,
+                     absl::Span<int64_t> results);
+
+// Batched right sided binary search: sets `results[i]` to
+// UpperBound(values[i], array). See BatchLowerBound for details.
+void BatchUpperBound(absl::Span<const float> values,
+                     absl::Span<const float> array,
+                     absl::Span<int64_t> results);
+void BatchUpperBound(absl::Span<const double> values,
+                     absl::Span<const double> array,
+                     absl::Span<int64_t> results);
+void BatchUpperBound(absl::Span<const int32_t> values,
+                     absl::Span<const int32_t> array,
+                     absl::Span<int64_t> results);
+void BatchUpperBound(absl::Span<const int64_t> values,
+                     absl::Span<const int64_t> array,
+                     absl::Span<int64_t> results);
+
 // Implementation of lower bound using exponential search
 // (see https://en.wikipedia.org/wiki/Exponential_search).
 // Optimized for the case when the lower bound is more likely to be found close
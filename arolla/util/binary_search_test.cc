@@ -306,5 +306,70 @@ TEST(Algorithms, UpperBound_Stress) {
   }
 }
 
+template <typename T>
+void BatchBinarySearchStressTest(size_t array_size, size_t values_size) {
+  auto array = RandomVector<T>(array_size * 2 + 1, array_size);
+  std::sort(array.begin(), array.end());
+  // Add some duplicates.
+  for (size_t i = 1; i < array.size(); i += 7) {
+    array[i] = array[i - 1];
+  }
+  auto values = RandomVector<T>(values_size * 2 + 3, values_size);
+  // Add some exact matches and values out of the range.
+  for (size_t i = 0; i < values.size() && !array.empty(); i += 5) {
+    values[i] = array[i % array.size()];
+  }
+  if (!values.empty()) {
+    values.front() = std::numeric_limits<T>::lowest();
+    values.back() = std::numeric_limits<T>::max();
+  }
+  std::vector<int64_t> results(values.size());
+  BatchLowerBound(values, array, absl::MakeSpan(results));
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(results[i], StdLowerBound(values[i], array))
+        << "array_size=" << array_size << " i=" << i;
+  }
+  BatchUpperBound(values, array, absl::MakeSpan(results));
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(results[i], StdUpperBound(values[i], array))
+        << "array_size=" << array_size << " i=" << i;
+  }
+}
+
+TEST(Algorithms, BatchBinarySearch_Stress) {
+  // The sizes cover both the small arrays and the Eytzinger layout.
+  for (size_t array_size : {0, 1, 2, 3, 10, 1000, 20000, 100000}) {
+    BatchBinarySearchStressTest<float>(array_size, 50000);
+    BatchBinarySearchStressTest<double>(array_size, 50000);
+    BatchBinarySearchStressTest<int32_t>(array_size, 50000);
+    BatchBinarySearchStressTest<int64_t>(array_size, 50000);
+  }
+}
+
+TEST(Algorithms, BatchBinarySearch_Nan) {
+  const auto kNan = std::numeric_limits<float>::quiet_NaN();
+  const auto kInf = std::numeric_limits<float>::infinity();
+  for (int n : {2, 140, 20000}) {
+    std::vector<float> thresholds;
+    for (int i = 0; i < n; ++i) {
+      thresholds.push_back(i);
+    }
+    thresholds.front() = -kInf;
+    thresholds.back() = kInf;
+    std::vector<float> values(n, kNan);
+    values[0] = -kInf;
+    values[1] = kInf;
+    std::vector<int64_t> results(values.size());
+    BatchLowerBound(values, thresholds, absl::MakeSpan(results));
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ(results[i], StdLowerBound(values[i], thresholds)) << i;
+    }
+    BatchUpperBound(values, thresholds, absl::MakeSpan(results));
+    for (int i = 0; i < n; ++i) {
+      ASSERT_EQ(results[i], StdUpperBound(values[i], thresholds)) << i;
+    }
+  }
+}
+
 }  // namespace
 }  // namespace arolla
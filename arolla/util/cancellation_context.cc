@@ -0,0 +1,49 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/cancellation_context.h"
+
+#include <atomic>
+
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+
+namespace arolla {
+
+bool CancellationContext::Check() {
+  if (stopped_.load(std::memory_order_relaxed)) {
+    return true;
+  }
+  if (deadline_ != absl::InfiniteFuture() && absl::Now() >= deadline_) {
+    deadline_exceeded_.store(true, std::memory_order_relaxed);
+    stopped_.store(true, std::memory_order_release);
+    return true;
+  }
+  return false;
+}
+
+absl::Status CancellationContext::GetStatus() const {
+  if (!stopped_.load(std::memory_order_acquire)) {
+    return absl::OkStatus();
+  }
+  if (cancelled_.load(std::memory_order_relaxed)) {
+    return absl::CancelledError("evaluation is cancelled");
+  }
+  if (deadline_exceeded_.load(std::memory_order_relaxed)) {
+    return absl::DeadlineExceededError("evaluation deadline exceeded");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace arolla
@@ -0,0 +1,97 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_UTIL_CANCELLATION_CONTEXT_H_
+#define AROLLA_UTIL_CANCELLATION_CONTEXT_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "absl/base/optimization.h"
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "arolla/util/api.h"
+
+namespace arolla {
+
+// A token for the cooperative cancellation of long evaluations (loops,
+// sequence operations, big decision forest batches). The evaluation checks
+// the token at safe points and stops with an error once it is cancelled or
+// the deadline has passed.
+//
+// Cancel() can be called from any thread. SoftCheck() can be called from
+// several evaluation threads concurrently.
+//
+// Usage example:
+//
+//   CancellationContext cancellation_context(rpc->deadline());
+//   ASSIGN_OR_RETURN(auto result,
+//                    model.Execute({.cancellation_context =
+//                                       &cancellation_context},
+//                                  input));
+//
+class AROLLA_API CancellationContext {
+ public:
+  // How many SoftCheck() calls share a single clock reading.
+  static constexpr int64_t kClockCheckPeriod = 128;
+
+  explicit CancellationContext(absl::Time deadline = absl::InfiniteFuture())
+      : deadline_(deadline) {}
+
+  CancellationContext(const CancellationContext&) = delete;
+  CancellationContext& operator=(const CancellationContext&) = delete;
+
+  // Requests the evaluation to stop.
+  void Cancel() {
+    cancelled_.store(true, std::memory_order_relaxed);
+    stopped_.store(true, std::memory_order_release);
+  }
+
+  absl::Time deadline() const { return deadline_; }
+
+  // Returns true if the evaluation must stop. The clock is read only once per
+  // kClockCheckPeriod calls, so the check is cheap enough for every loop
+  // iteration, but the deadline may be noticed slightly later.
+  bool SoftCheck() {
+    if (ABSL_PREDICT_FALSE(stopped_.load(std::memory_order_relaxed))) {
+      return true;
+    }
+    if (deadline_ == absl::InfiniteFuture() ||
+        countdown_.fetch_sub(1, std::memory_order_relaxed) > 0) {
+      return false;
+    }
+    countdown_.store(kClockCheckPeriod, std::memory_order_relaxed);
+    return Check();
+  }
+
+  // The same as SoftCheck(), but always reads the clock.
+  bool Check();
+
+  // Returns CancelledError or DeadlineExceededError if the evaluation must
+  // stop according to the last check, OkStatus otherwise.
+  absl::Status GetStatus() const;
+
+ private:
+  absl::Time deadline_;
+  // Set on Cancel() or when the deadline is exceeded.
+  std::atomic<bool> stopped_ = false;
+  std::atomic<bool> cancelled_ = false;
+  std::atomic<bool> deadline_exceeded_ = false;
+  std::atomic<int64_t> countdown_ = 0;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_UTIL_CANCELLATION_CONTEXT_H_
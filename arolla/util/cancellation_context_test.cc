@@ -0,0 +1,73 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/cancellation_context.h"
+
+#include <cstdint>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::IsOk;
+using ::arolla::testing::StatusIs;
+
+TEST(CancellationContextTest, NotCancelled) {
+  CancellationContext cancellation_context;
+  for (int64_t i = 0; i < 10 * CancellationContext::kClockCheckPeriod; ++i) {
+    ASSERT_FALSE(cancellation_context.SoftCheck());
+  }
+  EXPECT_FALSE(cancellation_context.Check());
+  EXPECT_THAT(cancellation_context.GetStatus(), IsOk());
+}
+
+TEST(CancellationContextTest, Cancel) {
+  CancellationContext cancellation_context;
+  cancellation_context.Cancel();
+  EXPECT_TRUE(cancellation_context.SoftCheck());
+  EXPECT_TRUE(cancellation_context.Check());
+  EXPECT_THAT(cancellation_context.GetStatus(),
+              StatusIs(absl::StatusCode::kCancelled));
+}
+
+TEST(CancellationContextTest, Deadline) {
+  CancellationContext cancellation_context(absl::Now() - absl::Seconds(1));
+  // The clock is read only once per kClockCheckPeriod soft checks.
+  bool stopped = false;
+  for (int64_t i = 0; i <= CancellationContext::kClockCheckPeriod && !stopped;
+       ++i) {
+    stopped = cancellation_context.SoftCheck();
+  }
+  EXPECT_TRUE(stopped);
+  EXPECT_TRUE(cancellation_context.SoftCheck());
+  EXPECT_THAT(cancellation_context.GetStatus(),
+              StatusIs(absl::StatusCode::kDeadlineExceeded));
+}
+
+TEST(CancellationContextTest, FutureDeadline) {
+  CancellationContext cancellation_context(absl::Now() + absl::Hours(1));
+  for (int64_t i = 0; i < 10 * CancellationContext::kClockCheckPeriod; ++i) {
+    ASSERT_FALSE(cancellation_context.SoftCheck());
+  }
+  EXPECT_THAT(cancellation_context.GetStatus(), IsOk());
+}
+
+}  // namespace
+}  // namespace arolla
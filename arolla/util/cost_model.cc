@@ -0,0 +1,233 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/cost_model.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/time/clock.h"
+#include "arolla/util/threading.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif  // __linux__
+
+namespace arolla {
+namespace {
+
+// Pointwise decision forest evaluators use about this many bytes per split
+// node.
+constexpr int64_t kBytesPerSplitNode = 16;
+// FrameIterator frames of a typical model, with the inputs and the
+// intermediate results, take about this many bytes.
+constexpr int64_t kBytesPerFrame = 256;
+
+enum class CacheLevel { kL1Data, kLastLevel };
+
+// Returns the cache size in bytes, or 0 if it is not known.
+int64_t GetCacheSize(CacheLevel level) {
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+  if (level == CacheLevel::kL1Data) {
+    return std::max<int64_t>(sysconf(_SC_LEVEL1_DCACHE_SIZE), 0);
+  }
+  for (int name : {_SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE}) {
+    if (int64_t size = sysconf(name); size > 0) {
+      return size;
+    }
+  }
+#endif
+  return 0;
+}
+
+// Returns the min over `repetitions` of the time spent in fn(), in
+// nanoseconds.
+int64_t MinTimeNanos(int repetitions, absl::FunctionRef<void()> fn) {
+  int64_t result = std::numeric_limits<int64_t>::max();
+  for (int i = 0; i < repetitions; ++i) {
+    int64_t start_ns = absl::GetCurrentTimeNanos();
+    fn();
+    result = std::min(result, absl::GetCurrentTimeNanos() - start_ns);
+  }
+  return std::max<int64_t>(result, 1);
+}
+
+// Keeps the results of the benchmarks alive.
+volatile float benchmark_sink = 0;
+
+// Tree walking workload resembling a pointwise decision forest evaluation.
+class TreeWalkWorkload {
+ public:
+  static constexpr int kFeatureCount = 16;
+  static constexpr int kTreeCount = 8;
+  static constexpr int kDepth = 6;
+  static constexpr int kSplitCount = (1 << kDepth) - 1;
+
+  explicit TreeWalkWorkload(int64_t row_count)
+      : row_count_(row_count),
+        features_(row_count * kFeatureCount),
+        split_features_(kTreeCount * kSplitCount),
+        thresholds_(kTreeCount * kSplitCount),
+        leaves_(kTreeCount << kDepth) {
+    std::mt19937 rnd(34);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+    for (float& x : features_) x = value(rnd);
+    for (int& f : split_features_) f = rnd() % kFeatureCount;
+    for (float& t : thresholds_) t = value(rnd);
+    for (float& l : leaves_) l = value(rnd);
+  }
+
+  int64_t row_count() const { return row_count_; }
+
+  // Evaluates rows [begin, end) and returns the sum of the results.
+  float Eval(int64_t begin, int64_t end) const {
+    float sum = 0;
+    for (int64_t row = begin; row < end; ++row) {
+      const float* row_features = &features_[row * kFeatureCount];
+      for (int tree = 0; tree < kTreeCount; ++tree) {
+        const int offset = tree * kSplitCount;
+        int node = 0;
+        while (node < kSplitCount) {
+          node = 2 * node + 1 +
+                 (row_features[split_features_[offset + node]] >
+                  thresholds_[offset + node]);
+        }
+        sum += leaves_[(tree << kDepth) + node - kSplitCount];
+      }
+    }
+    return sum;
+  }
+
+ private:
+  int64_t row_count_;
+  std::vector<float> features_;
+  std::vector<int> split_features_;
+  std::vector<float> thresholds_;
+  std::vector<float> leaves_;
+};
+
+// Returns the number of rows of TreeWalkWorkload that take as much time as
+// passing a task to another thread and waiting for it, or 0 if it cannot be
+// measured.
+int64_t MeasureMinRowsPerThread() {
+  if (std::thread::hardware_concurrency() < 2) {
+    return 0;
+  }
+  TreeWalkWorkload workload(/*row_count=*/4096);
+  const int64_t rows_ns = MinTimeNanos(
+      5, [&] { benchmark_sink = workload.Eval(0, workload.row_count()); });
+
+  WorkStealingThreading threading(2);
+  auto run_empty_tasks = [&] {
+    ParallelFor(threading, 2, [](int64_t) {});
+  };
+  // Warm up the pool workers.
+  MinTimeNanos(10, run_empty_tasks);
+  const int64_t parallel_overhead_ns = MinTimeNanos(50, run_empty_tasks);
+  return parallel_overhead_ns * workload.row_count() / rows_ns;
+}
+
+// Returns the fraction of present elements at which a binary pointwise
+// operation takes the same time on dense arrays with presence bitmaps and on
+// sparse arrays (sorted ids and values of the present elements), which have to
+// intersect the ids.
+double MeasureDenseSparsityLimit() {
+  constexpr int64_t kSize = 1 << 16;
+  constexpr int64_t kWordCount = kSize / 32;
+  std::mt19937 rnd(34);
+  std::vector<float> a_values(kSize, 1.0f);
+  std::vector<float> b_values(kSize, 2.0f);
+  std::vector<uint32_t> a_bitmap(kWordCount);
+  std::vector<uint32_t> b_bitmap(kWordCount);
+  for (int64_t i = 0; i < kWordCount; ++i) {
+    a_bitmap[i] = rnd();
+    b_bitmap[i] = rnd();
+  }
+  std::vector<float> result(kSize);
+  std::vector<uint32_t> result_bitmap(kWordCount);
+  const int64_t dense_ns = MinTimeNanos(10, [&] {
+    for (int64_t i = 0; i < kSize; ++i) {
+      result[i] = a_values[i] + b_values[i];
+    }
+    for (int64_t i = 0; i < kWordCount; ++i) {
+      result_bitmap[i] = a_bitmap[i] & b_bitmap[i];
+    }
+    benchmark_sink = result[kSize / 2] + result_bitmap[kWordCount / 2];
+  });
+
+  // The same presence as in the dense arrays.
+  std::vector<int64_t> a_ids;
+  std::vector<int64_t> b_ids;
+  for (int64_t i = 0; i < kSize; ++i) {
+    if ((a_bitmap[i / 32] >> (i % 32)) & 1) a_ids.push_back(i);
+    if ((b_bitmap[i / 32] >> (i % 32)) & 1) b_ids.push_back(i);
+  }
+  std::vector<int64_t> result_ids(kSize);
+  const int64_t sparse_ns = MinTimeNanos(10, [&] {
+    size_t a = 0;
+    size_t b = 0;
+    size_t size = 0;
+    while (a < a_ids.size() && b < b_ids.size()) {
+      if (a_ids[a] < b_ids[b]) {
+        ++a;
+      } else if (b_ids[b] < a_ids[a]) {
+        ++b;
+      } else {
+        result_ids[size] = a_ids[a];
+        result[size++] = a_values[a++] + b_values[b++];
+      }
+    }
+    benchmark_sink = result[size / 2] + result_ids[size / 2];
+  });
+  // The dense operation takes dense_ns regardless of the presence, the sparse
+  // one with `p` fraction of present elements in each array processes
+  // 2 * p * kSize ids.
+  const double sparse_ns_per_id =
+      static_cast<double>(sparse_ns) / (a_ids.size() + b_ids.size());
+  return static_cast<double>(dense_ns) / (2 * kSize * sparse_ns_per_id);
+}
+
+}  // namespace
+
+CostModel CalibrateCostModel() {
+  CostModel result;
+  if (int64_t llc_size = GetCacheSize(CacheLevel::kLastLevel); llc_size > 0) {
+    // Leave a half of the cache for the inputs and other data.
+    result.optimal_splits_per_evaluator = std::clamp<int64_t>(
+        llc_size / 2 / kBytesPerSplitNode, 50000, 5000000);
+  }
+  if (int64_t l1_size = GetCacheSize(CacheLevel::kL1Data); l1_size > 0) {
+    // Leave a half of the cache for the operator data.
+    result.frame_buffer_count =
+        std::clamp<int64_t>(l1_size / 2 / kBytesPerFrame, 16, 1024);
+  }
+  if (int64_t min_rows = MeasureMinRowsPerThread(); min_rows > 0) {
+    result.min_rows_per_thread = std::clamp<int64_t>(min_rows, 16, 65536);
+  }
+  result.dense_sparsity_limit =
+      std::clamp(MeasureDenseSparsityLimit(), 0.05, 0.9);
+  return result;
+}
+
+const CostModel& GetCalibratedCostModel() {
+  static const CostModel cost_model = CalibrateCostModel();
+  return cost_model;
+}
+
+}  // namespace arolla
@@ -0,0 +1,63 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_UTIL_COST_MODEL_H_
+#define AROLLA_UTIL_COST_MODEL_H_
+
+#include <cstdint>
+
+namespace arolla {
+
+// Machine dependent parameters of the evaluation. The default values are the
+// constants tuned on the benchmarks, CalibrateCostModel() measures them on the
+// current host instead. Can be passed to the expression compiler via
+// DynamicEvaluationEngineOptions::cost_model.
+struct CostModel {
+  // If the total count of split nodes in a decision forest exceeds this
+  // number, the forest is evaluated by several pointwise evaluators (see
+  // BatchedForestEvaluator::CompilationParams).
+  int64_t optimal_splits_per_evaluator = 500000;
+
+  // Minimal number of rows per thread for the multithreaded batch evaluation.
+  int64_t min_rows_per_thread = 128;
+
+  // The number of frames FrameIterator processes at once in a single thread
+  // (see FrameIterator::Options::frame_buffer_count).
+  int64_t frame_buffer_count = 64;
+
+  // If a larger fraction of Array elements is present, the dense form is
+  // preferred to the sparse one (see IdFilter::DenseSparsityLimit()). It is a
+  // process-wide setting, so the compiler does not apply it: use
+  // IdFilter::SetDenseSparsityLimit(cost_model.dense_sparsity_limit).
+  double dense_sparsity_limit = 0.25;
+};
+
+// Runs a few built-in micro-benchmarks (tens of milliseconds) and returns the
+// cost model for the current host:
+//  - optimal_splits_per_evaluator and frame_buffer_count are derived from the
+//    cache sizes, so the forest pieces fit into the last level cache and the
+//    frame buffers into the L1 data cache;
+//  - min_rows_per_thread is the number of rows of a tree walking workload
+//    that pays for distributing it to another thread;
+//  - dense_sparsity_limit is the fraction of present elements at which a
+//    binary operation on dense and on sparse arrays takes the same time.
+// The parameters that cannot be measured keep the default values.
+CostModel CalibrateCostModel();
+
+// Returns CalibrateCostModel() computed on the first call in the process.
+const CostModel& GetCalibratedCostModel();
+
+}  // namespace arolla
+
+#endif  // AROLLA_UTIL_COST_MODEL_H_
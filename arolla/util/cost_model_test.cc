@@ -0,0 +1,47 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/cost_model.h"
+
+#include "gtest/gtest.h"
+
+namespace arolla {
+namespace {
+
+TEST(CostModelTest, Default) {
+  CostModel cost_model;
+  EXPECT_EQ(cost_model.optimal_splits_per_evaluator, 500000);
+  EXPECT_EQ(cost_model.min_rows_per_thread, 128);
+  EXPECT_EQ(cost_model.frame_buffer_count, 64);
+  EXPECT_EQ(cost_model.dense_sparsity_limit, 0.25);
+}
+
+TEST(CostModelTest, CalibrateCostModel) {
+  CostModel cost_model = CalibrateCostModel();
+  EXPECT_GE(cost_model.optimal_splits_per_evaluator, 50000);
+  EXPECT_LE(cost_model.optimal_splits_per_evaluator, 5000000);
+  EXPECT_GE(cost_model.min_rows_per_thread, 16);
+  EXPECT_LE(cost_model.min_rows_per_thread, 65536);
+  EXPECT_GE(cost_model.frame_buffer_count, 16);
+  EXPECT_LE(cost_model.frame_buffer_count, 1024);
+  EXPECT_GE(cost_model.dense_sparsity_limit, 0.05);
+  EXPECT_LE(cost_model.dense_sparsity_limit, 0.9);
+}
+
+TEST(CostModelTest, GetCalibratedCostModel) {
+  EXPECT_EQ(&GetCalibratedCostModel(), &GetCalibratedCostModel());
+}
+
+}  // namespace
+}  // namespace arolla
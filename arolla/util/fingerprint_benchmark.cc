@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <utility>
+#include <vector>
+
 #include "benchmark/benchmark.h"
 #include "arolla/util/fingerprint.h"
 
@@ -30,5 +33,29 @@ BENCHMARK(BM_RandomFingerprint)->Threads(2);
 BENCHMARK(BM_RandomFingerprint)->Threads(4);
 BENCHMARK(BM_RandomFingerprint)->Threads(8);
 
+void BM_CombineRawBytes(benchmark::State& state) {
+  std::vector<char> data(state.range(0), 'a');
+  for (auto s : state) {
+    FingerprintHasher hasher("salt");
+    hasher.CombineRawBytes(data.data(), data.size());
+    auto fgpt = std::move(hasher).Finish();
+    benchmark::DoNotOptimize(fgpt);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+BENCHMARK(BM_CombineRawBytes)->Range(16, 16 << 20);
+
+void BM_CombineSpan_Float(benchmark::State& state) {
+  std::vector<float> data(state.range(0), 1.0f);
+  for (auto s : state) {
+    auto fgpt = FingerprintHasher("salt").CombineSpan(data).Finish();
+    benchmark::DoNotOptimize(fgpt);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size() * sizeof(float));
+}
+
+BENCHMARK(BM_CombineSpan_Float)->Range(4, 4 << 20);
+
 }  // namespace
 }  // namespace arolla
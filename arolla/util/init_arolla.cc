@@ -15,30 +15,72 @@
 #include "arolla/util/init_arolla.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "arolla/util/indestructible.h"
+#include "arolla/util/threading.h"
+#include "arolla/util/status_macros_backport.h"
 
 namespace arolla {
 
 absl::Status InitArolla() {
-  return init_arolla_internal::ArollaInitializer::ExecuteAll();
+  return init_arolla_internal::ArollaInitializer::ExecuteAll(nullptr);
+}
+
+absl::Status InitArolla(ThreadingInterface& threading) {
+  return init_arolla_internal::ArollaInitializer::ExecuteAll(&threading);
 }
 
 namespace init_arolla_internal {
+namespace {
+
+struct TimingsRegistry {
+  absl::Mutex mutex;
+  std::vector<ArollaInitializerTiming> timings ABSL_GUARDED_BY(mutex);
+};
+
+TimingsRegistry& GetTimingsRegistry() {
+  static Indestructible<TimingsRegistry> registry;
+  return *registry;
+}
+
+void AddTimings(absl::Span<const ArollaInitializerTiming> timings) {
+  auto& registry = GetTimingsRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  registry.timings.insert(registry.timings.end(), timings.begin(),
+                          timings.end());
+}
+
+}  // namespace
 
 bool ArollaInitializer::execution_flag_ = false;
 
 const ArollaInitializer* ArollaInitializer::head_ = nullptr;
 
-absl::Status ArollaInitializer::ExecuteAll() {
-  static const Indestructible<absl::Status> result([]() -> absl::Status {
+absl::Status ArollaInitializer::Execute() const {
+  if (void_init_fn_ != nullptr) {
+    void_init_fn_();
+    return absl::OkStatus();
+  }
+  return status_init_fn_();
+}
+
+absl::Status ArollaInitializer::ExecuteAll(
+    ThreadingInterface* /*nullable*/ threading) {
+  static const Indestructible<absl::Status> result([&]() -> absl::Status {
     execution_flag_ = true;
     std::vector<const ArollaInitializer*> list;
     for (auto* it = head_; it != nullptr; it = it->next_) {
@@ -56,17 +98,52 @@ absl::Status ArollaInitializer::ExecuteAll() {
             "name collision in arolla initializers: ", list[i]->name_));
       }
     }
-    // Apply the priorities.
+    // Apply the priorities; within a priority, independent initializers go
+    // after the regular ones.
     std::stable_sort(list.begin(), list.end(), [](auto* it, auto* jt) {
-      return it->priority_ < jt->priority_;
+      return it->priority_ < jt->priority_ ||
+             (it->priority_ == jt->priority_ &&
+              it->independent_ < jt->independent_);
     });
     // Execute all.
-    for (auto* it : list) {
-      if (it->void_init_fn_ != nullptr) {
-        it->void_init_fn_();
-      } else if (auto status = it->status_init_fn_(); !status.ok()) {
-        return status;
+    for (size_t i = 0; i < list.size();) {
+      if (!list[i]->independent_ || threading == nullptr) {
+        absl::Time start = absl::Now();
+        absl::Status status = list[i]->Execute();
+        AddTimings({{list[i]->priority_, list[i]->name_, absl::Now() - start}});
+        RETURN_IF_ERROR(status);
+        ++i;
+        continue;
+      }
+      // Run the group of independent initializers of the same priority
+      // concurrently.
+      size_t group_end = i + 1;
+      while (group_end < list.size() &&
+             list[group_end]->priority_ == list[i]->priority_) {
+        ++group_end;
       }
+      absl::Span<const ArollaInitializer* const> group(list.data() + i,
+                                                       group_end - i);
+      std::vector<absl::Status> statuses(group.size());
+      std::vector<ArollaInitializerTiming> timings(group.size());
+      std::atomic<size_t> next_task = 0;
+      int64_t worker_count = std::min<int64_t>(
+          threading->GetRecommendedThreadCount(), group.size());
+      threading->WithThreading([&] {
+        ParallelFor(*threading, worker_count, [&](int64_t) {
+          for (size_t j = next_task++; j < group.size(); j = next_task++) {
+            absl::Time start = absl::Now();
+            statuses[j] = group[j]->Execute();
+            timings[j] = {group[j]->priority_, group[j]->name_,
+                          absl::Now() - start};
+          }
+        });
+      });
+      AddTimings(timings);
+      for (auto& status : statuses) {
+        RETURN_IF_ERROR(status);
+      }
+      i = group_end;
     }
     return absl::OkStatus();
   }());
@@ -74,11 +151,13 @@ absl::Status ArollaInitializer::ExecuteAll() {
 }
 
 ArollaInitializer::ArollaInitializer(ArollaInitializerPriority priority,
-                                     const char* name, VoidInitFn init_fn)
+                                     const char* name, VoidInitFn init_fn,
+                                     bool independent)
     : next_(std::exchange(head_, this)),
       priority_(priority),
       name_(name),
-      void_init_fn_(init_fn) {
+      void_init_fn_(init_fn),
+      independent_(independent) {
   if (init_fn == nullptr) {
     LOG(FATAL) << "init_fn == nullptr";
   }
@@ -89,11 +168,13 @@ ArollaInitializer::ArollaInitializer(ArollaInitializerPriority priority,
 }
 
 ArollaInitializer::ArollaInitializer(ArollaInitializerPriority priority,
-                                     const char* name, StatusInitFn init_fn)
+                                     const char* name, StatusInitFn init_fn,
+                                     bool independent)
     : next_(std::exchange(head_, this)),
       priority_(priority),
       name_(name),
-      status_init_fn_(init_fn) {
+      status_init_fn_(init_fn),
+      independent_(independent) {
   if (init_fn == nullptr) {
     LOG(FATAL) << "init_fn == nullptr";
   }
@@ -104,4 +185,11 @@ ArollaInitializer::ArollaInitializer(ArollaInitializerPriority priority,
 }
 
 }  // namespace init_arolla_internal
+
+std::vector<ArollaInitializerTiming> GetArollaInitializerTimings() {
+  auto& registry = init_arolla_internal::GetTimingsRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  return registry.timings;
+}
+
 }  // namespace arolla
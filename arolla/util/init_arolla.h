@@ -15,10 +15,15 @@
 #ifndef AROLLA_UTIL_INIT_AROLLA_H_
 #define AROLLA_UTIL_INIT_AROLLA_H_
 
+#include <vector>
+
 #include "absl/status/status.h"
+#include "absl/time/time.h"
 
 namespace arolla {
 
+class ThreadingInterface;
+
 // Initializes Arolla
 //
 // Usage:
@@ -49,6 +54,13 @@ namespace arolla {
 //
 absl::Status InitArolla();
 
+// Same as InitArolla(), but runs the initializers registered with
+// AROLLA_REGISTER_INDEPENDENT_INITIALIZER concurrently, using `threading`.
+//
+// Only the first call of InitArolla (with or without threading) executes the
+// initializers, so the threading argument has no effect on later calls.
+absl::Status InitArolla(ThreadingInterface& threading);
+
 // An initializer priority.
 enum class ArollaInitializerPriority {
   kHighest = 0,
@@ -69,6 +81,19 @@ enum class ArollaInitializerPriority {
 static_assert(static_cast<int>(ArollaInitializerPriority::kLowest) < 32,
               "Re-evaluate design when exceeding the threshold.");
 
+// Wall time spent in a single initializer during InitArolla().
+struct ArollaInitializerTiming {
+  ArollaInitializerPriority priority;
+  const char* /*nullable*/ name;  // nullptr for anonymous initializers.
+  absl::Duration duration;
+};
+
+// Returns the timings of all the initializers executed by InitArolla(), in
+// the order of their execution. Returns an empty list if InitArolla() has not
+// been called yet. If InitArolla() failed, only the initializers executed
+// before the failure are listed.
+std::vector<ArollaInitializerTiming> GetArollaInitializerTimings();
+
 // Registers an initialization function to be call by InitArolla().
 //
 // Args:
@@ -105,6 +130,30 @@ static_assert(static_cast<int>(ArollaInitializerPriority::kLowest) < 32,
           (__VA_ARGS__));                                               \
   }
 
+// Registers an initialization function that depends only on initializers
+// with higher priorities.
+//
+// When InitArolla is called with a ThreadingInterface, all the independent
+// initializers of the same priority run concurrently, after the regular
+// initializers of that priority. Otherwise they run sequentially in the same
+// order. So an independent initializer must be thread-safe and must not
+// depend on other initializers of the same priority.
+//
+// Args:
+//   priority: A priority value (see ArollaInitializerPriority enum)
+//   name: A globally unique name.
+//   init_fn: A function with signature `void (*)()` or `absl::Status (*)()`.
+//
+#define AROLLA_REGISTER_INDEPENDENT_INITIALIZER(priority, name,     \
+                                                /*init_fn*/...)     \
+  extern "C" {                                                      \
+  static ::arolla::init_arolla_internal::ArollaInitializer          \
+      AROLLA_REGISTER_INITIALIZER_IMPL_CONCAT(arolla_initializer_,  \
+                                              __COUNTER__)(         \
+          (::arolla::ArollaInitializerPriority::priority), (#name), \
+          (__VA_ARGS__), /*independent=*/true);                     \
+  }
+
 // Implementation note: By using the `extern "C"` and `static` keywords instead
 // of anonymous namespaces, we reduce the size of the binary file.
 
@@ -122,15 +171,17 @@ class ArollaInitializer {
   using VoidInitFn = void (*)();
   using StatusInitFn = absl::Status (*)();
 
-  static absl::Status ExecuteAll();
+  static absl::Status ExecuteAll(ThreadingInterface* /*nullable*/ threading);
 
   ArollaInitializer(ArollaInitializerPriority priority, const char* name,
-                    VoidInitFn init_fn);
+                    VoidInitFn init_fn, bool independent = false);
 
   ArollaInitializer(ArollaInitializerPriority priority, const char* name,
-                    StatusInitFn init_fn);
+                    StatusInitFn init_fn, bool independent = false);
 
  private:
+  absl::Status Execute() const;
+
   static bool execution_flag_;
   static const ArollaInitializer* head_;
 
@@ -139,6 +190,7 @@ class ArollaInitializer {
   const char* const /*nullable*/ name_;
   const VoidInitFn void_init_fn_ = nullptr;
   const StatusInitFn status_init_fn_ = nullptr;
+  const bool independent_;
 };
 
 }  // namespace init_arolla_internal
@@ -0,0 +1,92 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/barrier.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/init_arolla.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+#include "arolla/util/threading.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::IsOk;
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::StrEq;
+
+std::string& GetBuffer() {
+  static Indestructible<std::string> result;
+  return *result;
+}
+
+absl::Barrier& GetBarrier() {
+  static Indestructible<absl::Barrier> barrier(2);
+  return *barrier;
+}
+
+std::atomic<int> independent_count = 0;
+
+AROLLA_REGISTER_INITIALIZER(kHighest, Foo, [] { GetBuffer() += "Foo"; })
+
+// Both independent initializers wait on the same barrier, so the test can only
+// pass if they run concurrently.
+AROLLA_REGISTER_INDEPENDENT_INITIALIZER(kLowest, Bar, [] {
+  GetBarrier().Block();
+  ++independent_count;
+})
+
+AROLLA_REGISTER_INDEPENDENT_INITIALIZER(kLowest, Baz, []() -> absl::Status {
+  GetBarrier().Block();
+  ++independent_count;
+  return absl::OkStatus();
+})
+
+// Regular initializers run before the independent ones of the same priority.
+AROLLA_REGISTER_INITIALIZER(kLowest, Qux, []() -> absl::Status {
+  GetBuffer() += (independent_count == 0 ? "Qux" : "Error");
+  return absl::OkStatus();
+})
+
+// There is only one test for this subsystem because only the first
+// InitArolla() call makes the difference per process life-time.
+
+TEST(InitArollaParallelTest, Complex) {
+  EXPECT_THAT(GetArollaInitializerTimings(), ElementsAre());
+
+  StdThreading threading(4);
+  ASSERT_THAT(InitArolla(threading), IsOk());
+  EXPECT_EQ(GetBuffer(), "FooQux");
+  EXPECT_EQ(independent_count, 2);
+  EXPECT_THAT(GetArollaInitializerTimings(),
+              ElementsAre(Field(&ArollaInitializerTiming::name, StrEq("Foo")),
+                          Field(&ArollaInitializerTiming::name, StrEq("Qux")),
+                          Field(&ArollaInitializerTiming::name, StrEq("Bar")),
+                          Field(&ArollaInitializerTiming::name, StrEq("Baz"))));
+
+  // The following calls do nothing.
+  ASSERT_THAT(InitArolla(), IsOk());
+  EXPECT_EQ(GetBuffer(), "FooQux");
+  EXPECT_EQ(GetArollaInitializerTimings().size(), 4);
+}
+
+}  // namespace
+}  // namespace arolla
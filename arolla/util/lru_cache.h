@@ -79,6 +79,20 @@ class LruCache {
     return &entries_.front().second;
   }
 
+  // Removes the entry stored under `key`, if any. Returns true if the entry was
+  // present.
+  template <typename K>
+  bool Erase(K&& key) {
+    auto it = index_.find(std::forward<K>(key));
+    if (it == index_.end()) {
+      return false;
+    }
+    auto entry = it->entry;
+    index_.erase(it);
+    entries_.erase(entry);
+    return true;
+  }
+
   // Clears the cache.
   void Clear() {
     entries_.clear();
@@ -73,6 +73,21 @@ TEST(LruCache, Clear) {
   ASSERT_THAT(cache.LookupOrNull(1), IsNull());
 }
 
+TEST(LruCache, Erase) {
+  LruCache<int, double> cache(2);
+  (void)cache.Put(1, 1.5);
+  (void)cache.Put(2, 2.5);
+  EXPECT_TRUE(cache.Erase(1));
+  EXPECT_FALSE(cache.Erase(1));
+  EXPECT_THAT(cache.LookupOrNull(1), IsNull());
+  EXPECT_THAT(cache.LookupOrNull(2), Pointee(2.5));
+  (void)cache.Put(1, 1.1);
+  (void)cache.Put(3, 3.5);
+  EXPECT_THAT(cache.LookupOrNull(1), Pointee(1.1));
+  EXPECT_THAT(cache.LookupOrNull(2), IsNull());
+  EXPECT_THAT(cache.LookupOrNull(3), Pointee(3.5));
+}
+
 TEST(LruCache, Overwrite) {
   LruCache<int, double> cache(2);
   (void)cache.Put(1, 1.5);
@@ -0,0 +1,59 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_UTIL_MEMORY_USAGE_H_
+#define AROLLA_UTIL_MEMORY_USAGE_H_
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace arolla {
+
+// Traits estimating the heap memory owned by a value of type T, in addition to
+// sizeof(T), e.g. the buffers of an array. Used by the simple QTypes to
+// implement QType::UnsafeEstimateHeapMemoryUsage.
+//
+// The estimate is not exact: the allocator overhead is ignored, and the memory
+// shared between several values (e.g. an array and its slices) is counted in
+// each of them.
+template <typename T, typename Enabled = void>
+struct MemoryUsageTraits {};
+
+// Default implementation for types that implement size_t memory_usage() const.
+template <typename T>
+struct MemoryUsageTraits<
+    T, std::void_t<decltype(static_cast<size_t (T::*)() const>(
+           &T::memory_usage))>> {
+  size_t operator()(const T& value) const { return value.memory_usage(); }
+};
+
+// Returns the heap memory allocated by the vector for its elements, not
+// including the memory owned by the elements themselves.
+template <typename T, typename Allocator>
+size_t VectorMemoryUsage(const std::vector<T, Allocator>& v) {
+  return v.capacity() * sizeof(T);
+}
+
+// Returns the heap memory allocated by an absl open addressing hash table
+// (absl::flat_hash_map, absl::flat_hash_set): a control byte and a slot per
+// bucket. The memory owned by the elements themselves is not included.
+template <typename HashTable>
+size_t HashTableMemoryUsage(const HashTable& table) {
+  return table.capacity() * (sizeof(typename HashTable::value_type) + 1);
+}
+
+}  // namespace arolla
+
+#endif  // AROLLA_UTIL_MEMORY_USAGE_H_
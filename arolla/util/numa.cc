@@ -0,0 +1,74 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/numa.h"
+
+#include <fstream>
+#include <string>
+
+#include "absl/strings/numbers.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // __linux__
+
+// getcpu() wrapper is available since glibc 2.29. Unlike a raw syscall it
+// goes through vDSO, so it is cheap enough to call on every model evaluation.
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+#define AROLLA_HAVE_GETCPU 1
+#endif
+
+namespace arolla {
+
+int GetNumaNodeCount() {
+  static const int node_count = [] {
+#ifdef __linux__
+    // The file contains the list of node ranges, e.g. "0" or "0-1" or "0,2-3".
+    std::ifstream file("/sys/devices/system/node/online");
+    std::string nodes;
+    if (file && std::getline(file, nodes)) {
+      const size_t pos = nodes.find_last_of(",-");
+      int max_node = 0;
+      if (absl::SimpleAtoi(pos == std::string::npos ? nodes
+                                                     : nodes.substr(pos + 1),
+                           &max_node) &&
+          max_node >= 0) {
+        return max_node + 1;
+      }
+    }
+#endif  // __linux__
+    return 1;
+  }();
+  return node_count;
+}
+
+int GetCurrentNumaNode() {
+  unsigned int node = 0;
+#if defined(AROLLA_HAVE_GETCPU)
+  if (getcpu(nullptr, &node) != 0) {
+    return 0;
+  }
+#elif defined(__linux__) && defined(SYS_getcpu)
+  if (syscall(SYS_getcpu, nullptr, &node, nullptr) != 0) {
+    return 0;
+  }
+#endif
+  const int result = static_cast<int>(node);
+  return result < GetNumaNodeCount() ? result : 0;
+}
+
+}  // namespace arolla
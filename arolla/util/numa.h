@@ -0,0 +1,33 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_UTIL_NUMA_H_
+#define AROLLA_UTIL_NUMA_H_
+
+namespace arolla {
+
+// Returns the number of NUMA nodes on the host (or, more precisely, the max
+// online node id plus one). Returns 1 if the information is not available.
+int GetNumaNodeCount();
+
+// Returns the NUMA node the calling thread is currently running on, in
+// [0, GetNumaNodeCount()). Returns 0 if the information is not available.
+//
+// NOTE: the thread can be migrated to another node right after the call, so
+// the result should be used as a hint only.
+int GetCurrentNumaNode();
+
+}  // namespace arolla
+
+#endif  // AROLLA_UTIL_NUMA_H_
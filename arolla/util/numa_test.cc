@@ -0,0 +1,50 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/numa.h"
+
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace arolla {
+namespace {
+
+using ::testing::AllOf;
+using ::testing::Ge;
+using ::testing::Lt;
+
+TEST(NumaTest, GetNumaNodeCount) {
+  EXPECT_GE(GetNumaNodeCount(), 1);
+  EXPECT_EQ(GetNumaNodeCount(), GetNumaNodeCount());
+}
+
+TEST(NumaTest, GetCurrentNumaNode) {
+  EXPECT_THAT(GetCurrentNumaNode(), AllOf(Ge(0), Lt(GetNumaNodeCount())));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([] {
+      EXPECT_THAT(GetCurrentNumaNode(),
+                  AllOf(Ge(0), Lt(GetNumaNodeCount())));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+}  // namespace arolla
@@ -0,0 +1,166 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/perf_counters.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // __linux__
+
+namespace arolla {
+namespace {
+
+#ifdef __linux__
+
+constexpr size_t kEventCount = 4;
+
+// The events in the order of the PerfCounterValues fields.
+constexpr std::array<uint64_t, kEventCount> kEventConfigs = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+int OpenEvent(uint64_t config, int group_fd) {
+  perf_event_attr attr = {};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                     PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // The group is enabled at once via its leader.
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, /*pid=*/0,
+                                  /*cpu=*/-1, group_fd, /*flags=*/0));
+}
+
+// The counters of a single thread, grouped so that they are scheduled on the
+// PMU together and read with a single syscall.
+class ThreadPerfCounters {
+ public:
+  ThreadPerfCounters() {
+    fds_.fill(-1);
+    fds_[0] = OpenEvent(kEventConfigs[0], /*group_fd=*/-1);
+    if (fds_[0] == -1) {
+      return;
+    }
+    for (size_t i = 0; i < kEventCount; ++i) {
+      if (i > 0) {
+        fds_[i] = OpenEvent(kEventConfigs[i], fds_[0]);
+      }
+      if (fds_[i] != -1 && ioctl(fds_[i], PERF_EVENT_IOC_ID, &ids_[i]) == -1) {
+        close(fds_[i]);
+        fds_[i] = -1;
+      }
+    }
+    if (fds_[0] == -1) {
+      Close();
+      return;
+    }
+    ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  ~ThreadPerfCounters() { Close(); }
+
+  ThreadPerfCounters(const ThreadPerfCounters&) = delete;
+  ThreadPerfCounters& operator=(const ThreadPerfCounters&) = delete;
+
+  bool available() const { return fds_[0] != -1; }
+
+  PerfCounterValues Read() const {
+    PerfCounterValues result;
+    if (!available()) {
+      return result;
+    }
+    // The PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, then
+    // {value, id} per event.
+    std::array<uint64_t, 3 + 2 * kEventCount> buffer = {};
+    if (read(fds_[0], buffer.data(), sizeof(buffer)) <= 0) {
+      return result;
+    }
+    const uint64_t nr = buffer[0];
+    const uint64_t time_enabled = buffer[1];
+    const uint64_t time_running = buffer[2];
+    // Scale the values if the group was multiplexed with other events.
+    const double scale =
+        time_running == 0 || time_running >= time_enabled
+            ? 1.0
+            : static_cast<double>(time_enabled) / time_running;
+    std::array<int64_t*, kEventCount> fields = {
+        &result.cycles, &result.instructions, &result.llc_misses,
+        &result.branch_misses};
+    for (uint64_t j = 0; j < nr && j < kEventCount; ++j) {
+      const uint64_t value = buffer[3 + 2 * j];
+      const uint64_t id = buffer[3 + 2 * j + 1];
+      for (size_t i = 0; i < kEventCount; ++i) {
+        if (fds_[i] != -1 && ids_[i] == id) {
+          *fields[i] = static_cast<int64_t>(value * scale);
+        }
+      }
+    }
+    return result;
+  }
+
+ private:
+  void Close() {
+    for (int& fd : fds_) {
+      if (fd != -1) {
+        close(fd);
+        fd = -1;
+      }
+    }
+  }
+
+  std::array<int, kEventCount> fds_;
+  std::array<uint64_t, kEventCount> ids_ = {};
+};
+
+const ThreadPerfCounters& GetThreadPerfCounters() {
+  thread_local const ThreadPerfCounters counters;
+  return counters;
+}
+
+#endif  // __linux__
+
+}  // namespace
+
+bool PerfCountersAvailable() {
+#ifdef __linux__
+  return GetThreadPerfCounters().available();
+#else
+  return false;
+#endif  // __linux__
+}
+
+PerfCounterValues ReadThreadPerfCounters() {
+#ifdef __linux__
+  return GetThreadPerfCounters().Read();
+#else
+  return {};
+#endif  // __linux__
+}
+
+}  // namespace arolla
@@ -0,0 +1,71 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_UTIL_PERF_COUNTERS_H_
+#define AROLLA_UTIL_PERF_COUNTERS_H_
+
+#include <cstdint>
+
+namespace arolla {
+
+// Values of the hardware performance counters.
+struct PerfCounterValues {
+  int64_t cycles = 0;
+  int64_t instructions = 0;
+  // Last level cache misses.
+  int64_t llc_misses = 0;
+  int64_t branch_misses = 0;
+
+  PerfCounterValues& operator+=(const PerfCounterValues& other) {
+    cycles += other.cycles;
+    instructions += other.instructions;
+    llc_misses += other.llc_misses;
+    branch_misses += other.branch_misses;
+    return *this;
+  }
+
+  PerfCounterValues& operator-=(const PerfCounterValues& other) {
+    cycles -= other.cycles;
+    instructions -= other.instructions;
+    llc_misses -= other.llc_misses;
+    branch_misses -= other.branch_misses;
+    return *this;
+  }
+
+  friend PerfCounterValues operator-(PerfCounterValues lhs,
+                                     const PerfCounterValues& rhs) {
+    return lhs -= rhs;
+  }
+};
+
+// Returns true if the hardware performance counters can be read, i.e. on Linux
+// with a hardware PMU and access to perf_event_open (see
+// /proc/sys/kernel/perf_event_paranoid). Only the counters of the calling
+// thread in user space are measured, which is allowed by the default
+// perf_event_paranoid=2.
+bool PerfCountersAvailable();
+
+// Returns the current values of the calling thread counters. The counters are
+// opened on the first call in the thread and count from that moment, so only
+// the differences between the calls are meaningful. The counters that are not
+// supported by the hardware are always zero, all of them are zero if
+// !PerfCountersAvailable().
+//
+// The call costs a read() syscall, so it is suitable for measuring code
+// sections of at least a few microseconds.
+PerfCounterValues ReadThreadPerfCounters();
+
+}  // namespace arolla
+
+#endif  // AROLLA_UTIL_PERF_COUNTERS_H_
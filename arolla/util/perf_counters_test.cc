@@ -0,0 +1,77 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/perf_counters.h"
+
+#include <cstdint>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "gtest/gtest.h"
+
+namespace arolla {
+namespace {
+
+// Some work that the compiler cannot optimize away.
+int64_t Work(int64_t n) {
+  volatile int64_t result = 0;
+  for (int64_t i = 0; i < n; ++i) {
+    result = result + i * i;
+  }
+  return result;
+}
+
+TEST(PerfCountersTest, Arithmetic) {
+  PerfCounterValues a{10, 20, 3, 4};
+  PerfCounterValues b{1, 2, 1, 1};
+  PerfCounterValues diff = a - b;
+  EXPECT_EQ(diff.cycles, 9);
+  EXPECT_EQ(diff.instructions, 18);
+  EXPECT_EQ(diff.llc_misses, 2);
+  EXPECT_EQ(diff.branch_misses, 3);
+  diff += b;
+  EXPECT_EQ(diff.cycles, 10);
+  EXPECT_EQ(diff.instructions, 20);
+  EXPECT_EQ(diff.llc_misses, 3);
+  EXPECT_EQ(diff.branch_misses, 4);
+}
+
+TEST(PerfCountersTest, ReadThreadPerfCounters) {
+  if (!PerfCountersAvailable()) {
+    PerfCounterValues values = ReadThreadPerfCounters();
+    EXPECT_EQ(values.cycles, 0);
+    EXPECT_EQ(values.instructions, 0);
+    GTEST_SKIP() << "perf_event is not available";
+  }
+  PerfCounterValues start = ReadThreadPerfCounters();
+  Work(1000000);
+  PerfCounterValues diff = ReadThreadPerfCounters() - start;
+  EXPECT_GT(diff.cycles, 0);
+  EXPECT_GT(diff.instructions, 1000000);
+  EXPECT_GE(diff.llc_misses, 0);
+  EXPECT_GE(diff.branch_misses, 0);
+}
+
+TEST(PerfCountersTest, PerThread) {
+  if (!PerfCountersAvailable()) {
+    GTEST_SKIP() << "perf_event is not available";
+  }
+  PerfCounterValues start = ReadThreadPerfCounters();
+  std::thread([] { Work(10000000); }).join();
+  PerfCounterValues diff = ReadThreadPerfCounters() - start;
+  // The work of the other thread is not counted.
+  EXPECT_LT(diff.instructions, 10000000);
+}
+
+}  // namespace
+}  // namespace arolla
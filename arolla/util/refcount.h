@@ -59,6 +59,15 @@ class Refcount {
     return refcount != 1 && count_.fetch_sub(1, std::memory_order_acq_rel) != 1;
   }
 
+  // Returns true if the reference count is exactly one, i.e. the caller holds
+  // the only reference.
+  //
+  // Inserts barriers to ensure that the state written by the other (already
+  // released) owners is visible to the caller.
+  bool IsOne() const noexcept {
+    return count_.load(std::memory_order_acquire) == 1;
+  }
+
   // A custom  constructor used for testing purposes.
   struct TestOnly {};
   constexpr Refcount(TestOnly, int initial_count) noexcept
@@ -153,6 +153,37 @@ class RefcountPtr {
   T* ptr_ = nullptr;
 };
 
+// A non-owning reference to a RefcountPtr.
+//
+// Copying a BorrowedRefcountPtr doesn't touch the (atomic) reference counter.
+// Unlike `const RefcountPtr<T>&`, it is copy-assignable and can be stored in
+// containers, e.g. in the explicit stack of a single-threaded traversal, where
+// the objects are already owned by the traversed structure.
+//
+// The referenced RefcountPtr must outlive the BorrowedRefcountPtr.
+template <typename T>
+class BorrowedRefcountPtr {
+ public:
+  constexpr /*implicit*/ BorrowedRefcountPtr(  // NOLINT
+      const RefcountPtr<T>& ptr) noexcept
+      : ptr_(&ptr) {}
+
+  // Returns the referenced RefcountPtr; copy it to share the ownership.
+  constexpr /*implicit*/ operator const RefcountPtr<T>&()  // NOLINT
+      const noexcept {
+    return *ptr_;
+  }
+
+  constexpr T* get() const noexcept { return ptr_->get(); }
+
+  T& operator*() const noexcept { return **ptr_; }
+
+  T* operator->() const noexcept { return ptr_->get(); }
+
+ private:
+  const RefcountPtr<T>* ptr_;
+};
+
 // Integration with [D]CHECK_{EQ,NE}.
 template <typename T>
 std::ostream& operator<<(std::ostream& ostream, const RefcountPtr<T>& ptr) {
@@ -15,6 +15,7 @@
 #include <array>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 #include "arolla/util/refcount_ptr.h"
@@ -122,6 +123,19 @@ void BM_RefcountPtr_Copy_Reset_100(benchmark::State& state) {
 
 BENCHMARK(BM_RefcountPtr_Copy_Reset_100);
 
+void BM_BorrowedRefcountPtr_Copy_Reset_100(benchmark::State& state) {
+  auto ptr = RefcountedObjectPtr::Own(std::make_unique<RefcountedObject>());
+  for (auto _ : state) {
+    std::vector<BorrowedRefcountPtr<RefcountedObject>> array(100, ptr);
+    for (auto& item : array) {
+      item = ptr;
+      benchmark::DoNotOptimize(item);
+    }
+  }
+}
+
+BENCHMARK(BM_BorrowedRefcountPtr_Copy_Reset_100);
+
 void BM_StdSharedPtr_Alloc_Swap_Dealloc(benchmark::State& state) {
   for (auto _ : state) {
     auto ptr1 = std::make_shared<Object>();
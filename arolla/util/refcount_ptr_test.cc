@@ -274,6 +274,33 @@ TEST(RefcountPtr, Checks) {
   DCHECK_EQ(ptr2, nullptr);
 }
 
+TEST(BorrowedRefcountPtr, Basics) {
+  auto ptr = RefcountedObjectPtr::Own(std::make_unique<RefcountedObject>());
+  auto other_ptr =
+      RefcountedObjectPtr::Own(std::make_unique<RefcountedObject>());
+  BorrowedRefcountPtr<RefcountedObject> borrowed = ptr;
+  ASSERT_EQ(borrowed.get(), ptr.get());
+  borrowed->value = 1;
+  ASSERT_EQ((*borrowed).value, 1);
+  const RefcountedObjectPtr& owner = borrowed;
+  ASSERT_EQ(&owner, &ptr);
+  borrowed = other_ptr;
+  ASSERT_EQ(borrowed.get(), other_ptr.get());
+  ASSERT_EQ(RefcountedObject::instance_counter, 2);
+}
+
+TEST(BorrowedRefcountPtr, CopyToOwner) {
+  auto ptr = RefcountedObjectPtr::Own(std::make_unique<RefcountedObject>());
+  auto* raw_ptr = ptr.get();
+  BorrowedRefcountPtr<RefcountedObject> borrowed = ptr;
+  RefcountedObjectPtr copy = borrowed;
+  ptr.reset();
+  ASSERT_EQ(RefcountedObject::instance_counter, 1);
+  ASSERT_EQ(copy.get(), raw_ptr);
+  copy.reset();
+  ASSERT_EQ(RefcountedObject::instance_counter, 0);
+}
+
 // NOTE: Regression test.
 TEST(RefcountPtr, SelfReferencingCopyAssignment) {
   struct SelfReferencingObject;
@@ -54,5 +54,14 @@ TEST(RefcountTest, IncrementDecrement) {
   }
 }
 
+TEST(RefcountTest, IsOne) {
+  Refcount refcount;
+  EXPECT_TRUE(refcount.IsOne());
+  refcount.increment();
+  EXPECT_FALSE(refcount.IsOne());
+  ASSERT_TRUE(refcount.decrement());
+  EXPECT_TRUE(refcount.IsOne());
+}
+
 }  // namespace
 }  // namespace arolla
@@ -0,0 +1,81 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/row_errors.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/numeric/bits.h"
+#include "absl/status/status.h"
+#include "arolla/util/bits.h"
+
+namespace arolla {
+
+void RowErrors::Add(int64_t row_id, absl::Status status) {
+  DCHECK_GE(row_id, 0);
+  DCHECK(!status.ok());
+  if (IsFailed(row_id)) {
+    return;
+  }
+  size_t word = row_id / 32;
+  if (word >= bitmap_.size()) {
+    bitmap_.resize(word + 1, 0);
+  }
+  bitmap_[word] |= uint32_t{1} << (row_id % 32);
+  ++row_count_;
+  if (static_cast<int64_t>(errors_.size()) < max_statuses_) {
+    errors_.push_back({row_id, std::move(status)});
+  }
+}
+
+void RowErrors::Merge(const RowErrors& other) {
+  for (const Error& error : other.errors_) {
+    if (static_cast<int64_t>(errors_.size()) >= max_statuses_) {
+      break;
+    }
+    if (!IsFailed(error.row_id)) {
+      errors_.push_back(error);
+    }
+  }
+  if (bitmap_.size() < other.bitmap_.size()) {
+    bitmap_.resize(other.bitmap_.size(), 0);
+  }
+  for (size_t word = 0; word < other.bitmap_.size(); ++word) {
+    row_count_ += absl::popcount(other.bitmap_[word] & ~bitmap_[word]);
+    bitmap_[word] |= other.bitmap_[word];
+  }
+}
+
+std::vector<int64_t> RowErrors::row_ids() const {
+  std::vector<int64_t> result;
+  result.reserve(row_count_);
+  for (size_t word = 0; word < bitmap_.size(); ++word) {
+    for (uint32_t bits = bitmap_[word]; bits != 0; bits &= bits - 1) {
+      result.push_back(word * 32 + FindLSBSetNonZero(bits));
+    }
+  }
+  return result;
+}
+
+void RowErrors::Clear() {
+  row_count_ = 0;
+  bitmap_.clear();
+  errors_.clear();
+}
+
+}  // namespace arolla
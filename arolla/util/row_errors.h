@@ -0,0 +1,101 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_UTIL_ROW_ERRORS_H_
+#define AROLLA_UTIL_ROW_ERRORS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "arolla/util/api.h"
+
+namespace arolla {
+
+// Rows failed in the pointwise array operators evaluated with the row level
+// error isolation. Instead of failing the whole batch, such operators mark the
+// failed rows as missing in their outputs and record them here.
+//
+// Row ids are the positions in the arrays processed by the failed operators,
+// i.e. the batch rows for the pointwise parts of a model.
+//
+// Usage example:
+//
+//   RowErrors row_errors;
+//   ASSIGN_OR_RETURN(auto result,
+//                    model.Execute({.row_errors = &row_errors}, input));
+//   for (int64_t row_id : row_errors.row_ids()) {
+//     ...
+//   }
+//
+// Not thread-safe: the operators evaluated concurrently record their errors in
+// separate RowErrors instances, merged into the shared one afterwards.
+//
+class AROLLA_API RowErrors {
+ public:
+  struct Error {
+    int64_t row_id;
+    absl::Status status;
+  };
+
+  // Only the first `max_statuses` failed rows keep their error statuses.
+  explicit RowErrors(int64_t max_statuses = 16) : max_statuses_(max_statuses) {}
+
+  RowErrors(const RowErrors&) = delete;
+  RowErrors& operator=(const RowErrors&) = delete;
+
+  int64_t max_statuses() const { return max_statuses_; }
+
+  // Records that the row has failed. Only the first error of a row is kept.
+  void Add(int64_t row_id, absl::Status status);
+
+  // Records the failed rows of `other`, as if they were added after the
+  // failed rows of this instance.
+  void Merge(const RowErrors& other);
+
+  bool empty() const { return row_count_ == 0; }
+
+  // The number of the failed rows.
+  int64_t row_count() const { return row_count_; }
+
+  bool IsFailed(int64_t row_id) const {
+    size_t word = row_id / 32;
+    return word < bitmap_.size() && (bitmap_[word] >> (row_id % 32)) & 1;
+  }
+
+  // Sorted ids of the failed rows.
+  std::vector<int64_t> row_ids() const;
+
+  // Bitmap of the failed rows: bit `i % 32` of word `i / 32` is set iff row
+  // `i` has failed. The same layout as arolla/dense_array/bitmap.h. The words
+  // after the last failed row are omitted.
+  absl::Span<const uint32_t> bitmap() const { return bitmap_; }
+
+  // Errors of the first failed rows in the order they were recorded.
+  absl::Span<const Error> errors() const { return errors_; }
+
+  void Clear();
+
+ private:
+  int64_t max_statuses_;
+  int64_t row_count_ = 0;
+  std::vector<uint32_t> bitmap_;
+  std::vector<Error> errors_;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_UTIL_ROW_ERRORS_H_
@@ -0,0 +1,98 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/row_errors.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "arolla/util/testing/status_matchers_backport.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(RowErrorsTest, Empty) {
+  RowErrors row_errors;
+  EXPECT_TRUE(row_errors.empty());
+  EXPECT_EQ(row_errors.row_count(), 0);
+  EXPECT_FALSE(row_errors.IsFailed(0));
+  EXPECT_THAT(row_errors.row_ids(), IsEmpty());
+  EXPECT_THAT(row_errors.bitmap(), IsEmpty());
+  EXPECT_THAT(row_errors.errors(), IsEmpty());
+}
+
+TEST(RowErrorsTest, Add) {
+  RowErrors row_errors(/*max_statuses=*/2);
+  row_errors.Add(33, absl::InvalidArgumentError("a"));
+  row_errors.Add(1, absl::InvalidArgumentError("b"));
+  row_errors.Add(33, absl::InvalidArgumentError("c"));
+  row_errors.Add(70, absl::InvalidArgumentError("d"));
+  EXPECT_FALSE(row_errors.empty());
+  EXPECT_EQ(row_errors.row_count(), 3);
+  EXPECT_TRUE(row_errors.IsFailed(1));
+  EXPECT_FALSE(row_errors.IsFailed(2));
+  EXPECT_TRUE(row_errors.IsFailed(33));
+  EXPECT_TRUE(row_errors.IsFailed(70));
+  EXPECT_FALSE(row_errors.IsFailed(1000));
+  EXPECT_THAT(row_errors.row_ids(), ElementsAre(1, 33, 70));
+  EXPECT_THAT(row_errors.bitmap(), ElementsAre(0b10, 0b10, 0b1000000));
+  ASSERT_EQ(row_errors.errors().size(), 2);
+  EXPECT_EQ(row_errors.errors()[0].row_id, 33);
+  EXPECT_THAT(row_errors.errors()[0].status,
+              StatusIs(absl::StatusCode::kInvalidArgument, "a"));
+  EXPECT_EQ(row_errors.errors()[1].row_id, 1);
+  EXPECT_THAT(row_errors.errors()[1].status,
+              StatusIs(absl::StatusCode::kInvalidArgument, "b"));
+
+  row_errors.Clear();
+  EXPECT_TRUE(row_errors.empty());
+  EXPECT_FALSE(row_errors.IsFailed(1));
+  EXPECT_THAT(row_errors.row_ids(), IsEmpty());
+  EXPECT_THAT(row_errors.errors(), IsEmpty());
+}
+
+TEST(RowErrorsTest, Merge) {
+  RowErrors row_errors(/*max_statuses=*/3);
+  row_errors.Add(1, absl::InvalidArgumentError("a"));
+  row_errors.Add(40, absl::InvalidArgumentError("b"));
+  RowErrors other(/*max_statuses=*/3);
+  other.Add(40, absl::InvalidArgumentError("c"));
+  other.Add(2, absl::InvalidArgumentError("d"));
+  other.Add(70, absl::InvalidArgumentError("e"));
+  row_errors.Merge(other);
+  EXPECT_EQ(row_errors.row_count(), 4);
+  EXPECT_THAT(row_errors.row_ids(), ElementsAre(1, 2, 40, 70));
+  ASSERT_EQ(row_errors.errors().size(), 3);
+  EXPECT_EQ(row_errors.errors()[0].row_id, 1);
+  EXPECT_EQ(row_errors.errors()[1].row_id, 40);
+  EXPECT_THAT(row_errors.errors()[1].status,
+              StatusIs(absl::StatusCode::kInvalidArgument, "b"));
+  EXPECT_EQ(row_errors.errors()[2].row_id, 2);
+  EXPECT_THAT(row_errors.errors()[2].status,
+              StatusIs(absl::StatusCode::kInvalidArgument, "d"));
+
+  RowErrors empty;
+  row_errors.Merge(empty);
+  EXPECT_EQ(row_errors.row_count(), 4);
+  empty.Merge(row_errors);
+  EXPECT_THAT(empty.row_ids(), ElementsAre(1, 2, 40, 70));
+  EXPECT_EQ(empty.errors().size(), 3);
+}
+
+}  // namespace
+}  // namespace arolla
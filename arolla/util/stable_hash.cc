@@ -0,0 +1,46 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/stable_hash.h"
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "cityhash/city.h"
+
+namespace arolla {
+namespace {
+
+constexpr uint64_t kStringHashSeed = 0x9be4a5fba2d83b1bULL;
+
+}  // namespace
+
+uint64_t StableHash(uint64_t bits) {
+  // The finalizer of MurmurHash3.
+  bits ^= bits >> 33;
+  bits *= 0xff51afd7ed558ccdULL;
+  bits ^= bits >> 33;
+  bits *= 0xc4ceb9fe1a85ec53ULL;
+  bits ^= bits >> 33;
+  return bits;
+}
+
+uint64_t StableHash(absl::string_view value) {
+  // Some users (e.g. BloomFilter) rely on the high bits being uniform, so we
+  // apply the finalizer on top of CityHash.
+  return StableHash(static_cast<uint64_t>(cityhash::CityHash64WithSeed(
+      value.data(), value.size(), kStringHashSeed)));
+}
+
+}  // namespace arolla
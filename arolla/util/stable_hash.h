@@ -0,0 +1,57 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_UTIL_STABLE_HASH_H_
+#define AROLLA_UTIL_STABLE_HASH_H_
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "absl/strings/string_view.h"
+
+namespace arolla {
+
+// Returns a 64-bit hash of the value that is stable across processes and
+// binaries, so data structures built from it (e.g. sketches or filters) can be
+// serialized and used later. All the bits of the result are well mixed.
+//
+// Integral values are hashed by their value, so e.g. int32_t{-1} and
+// int64_t{-1} have the same hash. Numerically equal floating point values
+// (including 0.0 and -0.0) have the same hash, all NaNs have the same hash.
+uint64_t StableHash(absl::string_view value);
+uint64_t StableHash(uint64_t bits);
+
+template <typename T>
+uint64_t StableHash(T value) {
+  static_assert(std::is_arithmetic_v<T>);
+  if constexpr (std::is_floating_point_v<T>) {
+    double double_value = value;
+    if (double_value == 0) {
+      double_value = 0;  // Normalize -0.0.
+    } else if (double_value != double_value) {
+      double_value = std::numeric_limits<double>::quiet_NaN();
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &double_value, sizeof(bits));
+    return StableHash(bits);
+  } else {
+    return StableHash(static_cast<uint64_t>(value));
+  }
+}
+
+}  // namespace arolla
+
+#endif  // AROLLA_UTIL_STABLE_HASH_H_
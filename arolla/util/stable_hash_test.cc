@@ -0,0 +1,47 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/stable_hash.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+
+namespace arolla {
+namespace {
+
+TEST(StableHashTest, Normalization) {
+  EXPECT_EQ(StableHash(0.0), StableHash(-0.0));
+  EXPECT_EQ(StableHash(0.0f), StableHash(-0.0));
+  EXPECT_EQ(StableHash(std::numeric_limits<float>::quiet_NaN()),
+            StableHash(-std::numeric_limits<double>::quiet_NaN()));
+  EXPECT_NE(StableHash(1.0), StableHash(2.0));
+  EXPECT_NE(StableHash(int64_t{1}), StableHash(int64_t{2}));
+  EXPECT_EQ(StableHash(int32_t{-1}), StableHash(int64_t{-1}));
+  EXPECT_EQ(StableHash(absl::string_view("abc")),
+            StableHash(absl::string_view(std::string("abc"))));
+}
+
+TEST(StableHashTest, Golden) {
+  // The values must never change, they may be stored in serialized data.
+  EXPECT_EQ(StableHash(uint64_t{0}), uint64_t{0});
+  EXPECT_EQ(StableHash(uint64_t{1}), uint64_t{0xb456bcfc34c2cb2c});
+  EXPECT_EQ(StableHash(int64_t{-1}), uint64_t{0x64b5720b4b825f21});
+}
+
+}  // namespace
+}  // namespace arolla
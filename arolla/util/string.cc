@@ -15,12 +15,94 @@
 #include "arolla/util/string.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include "absl/log/check.h"
+#include "absl/strings/string_view.h"
 
 namespace arolla {
 
+size_t Utf8CodePointOffset(absl::string_view str, int64_t n) {
+  DCHECK_GE(n, 0);
+  // Skip the blocks that end before the requested code point.
+  constexpr size_t kBlockSize = 64;
+  size_t offset = 0;
+  while (offset + kBlockSize <= str.size()) {
+    int64_t count = Utf8CodePointCount(str.substr(offset, kBlockSize));
+    if (count > n) {
+      break;
+    }
+    n -= count;
+    offset += kBlockSize;
+  }
+  for (; offset < str.size(); ++offset) {
+    if ((static_cast<unsigned char>(str[offset]) & 0xC0) != 0x80) {
+      if (n == 0) {
+        return offset;
+      }
+      --n;
+    }
+  }
+  return str.size();
+}
+
+size_t Utf8ValidPrefixSize(absl::string_view str) {
+  const auto* data = reinterpret_cast<const unsigned char*>(str.data());
+  const size_t size = str.size();
+  constexpr size_t kBlockSize = 16;
+  size_t offset = 0;
+  while (offset < size) {
+    while (offset + kBlockSize <= size &&
+           IsAscii(str.substr(offset, kBlockSize))) {
+      offset += kBlockSize;
+    }
+    if (offset == size) {
+      break;
+    }
+    const unsigned char lead = data[offset];
+    if (lead < 0x80) {
+      ++offset;
+      continue;
+    }
+    // The valid range of the second byte excludes the overlong encodings,
+    // the surrogates and the code points above U+10FFFF (RFC 3629).
+    size_t length;
+    unsigned char min_second = 0x80;
+    unsigned char max_second = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+      length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+      length = 3;
+      if (lead == 0xE0) {
+        min_second = 0xA0;
+      } else if (lead == 0xED) {
+        max_second = 0x9F;
+      }
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+      length = 4;
+      if (lead == 0xF0) {
+        min_second = 0x90;
+      } else if (lead == 0xF4) {
+        max_second = 0x8F;
+      }
+    } else {
+      return offset;
+    }
+    if (size - offset < length || data[offset + 1] < min_second ||
+        data[offset + 1] > max_second) {
+      return offset;
+    }
+    for (size_t i = 2; i < length; ++i) {
+      if ((data[offset + i] & 0xC0) != 0x80) {
+        return offset;
+      }
+    }
+    offset += length;
+  }
+  return size;
+}
+
 std::string Truncate(std::string str, size_t max_length) {
   DCHECK_GT(max_length, 3);
   if (str.size() > max_length) {
@@ -16,6 +16,7 @@
 #define AROLLA_UTIL_STRING_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include "absl/strings/escaping.h"
@@ -35,6 +36,37 @@ constexpr bool IsDigit(char c) { return '0' <= c && c <= '9'; }
 // (ascii) Determines whether the given character is an alphanumeric character.
 constexpr bool IsAlnum(char c) { return IsAlpha(c) || IsDigit(c); }
 
+// Determines whether all bytes of the given string are 7-bit ascii. The loop
+// has no early exit, so that the compiler can vectorize it.
+constexpr bool IsAscii(absl::string_view str) {
+  unsigned char acc = 0;
+  for (char c : str) {
+    acc |= static_cast<unsigned char>(c);
+  }
+  return acc < 0x80;
+}
+
+// Returns the number of code points in the UTF-8 string, i.e. the number of
+// bytes that are not continuation bytes (0b10xxxxxx). The string is expected to
+// be a valid UTF-8, otherwise the result is unspecified. The loop has no early
+// exit, so that the compiler can vectorize it.
+constexpr int64_t Utf8CodePointCount(absl::string_view str) {
+  int64_t result = 0;
+  for (char c : str) {
+    result += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+  }
+  return result;
+}
+
+// Returns the byte offset of the code point `n` in the UTF-8 string, or
+// str.size() if the string has at most `n` code points. Requires n >= 0. The
+// string is expected to be a valid UTF-8, otherwise the result is unspecified.
+size_t Utf8CodePointOffset(absl::string_view str, int64_t n);
+
+// Returns the length of the longest prefix of `str` that is a valid UTF-8.
+// The ascii parts of the string are checked in blocks.
+size_t Utf8ValidPrefixSize(absl::string_view str);
+
 // Determines whether the given string holds a valid identifier.
 constexpr bool IsIdentifier(absl::string_view str) {
   if (str.empty()) {
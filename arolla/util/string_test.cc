@@ -14,6 +14,10 @@
 //
 #include "arolla/util/string.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -30,6 +34,58 @@ TEST(StringTest, Truncate) {
   EXPECT_THAT(Truncate("fifty seven", 20), Eq("fifty seven"));
 }
 
+TEST(StringTest, IsAscii) {
+  static_assert(IsAscii(""));
+  static_assert(IsAscii("Hello, World!\n\x7f"));
+  static_assert(!IsAscii("\x80"));
+  static_assert(!IsAscii("caf\xc3\xa9"));
+  EXPECT_TRUE(IsAscii(std::string(1000, 'a')));
+  EXPECT_FALSE(IsAscii(std::string(1000, 'a') + "\xff"));
+}
+
+TEST(StringTest, Utf8CodePointCount) {
+  static_assert(Utf8CodePointCount("") == 0);
+  static_assert(Utf8CodePointCount("abc") == 3);
+  static_assert(Utf8CodePointCount("caf\xc3\xa9") == 4);
+  EXPECT_EQ(Utf8CodePointCount("古池や蛙飛び込む水の音"), 11);
+  EXPECT_EQ(Utf8CodePointCount("\xf0\x9f\x98\x80!"), 2);
+}
+
+TEST(StringTest, Utf8CodePointOffset) {
+  EXPECT_EQ(Utf8CodePointOffset("", 0), 0);
+  EXPECT_EQ(Utf8CodePointOffset("abc", 1), 1);
+  EXPECT_EQ(Utf8CodePointOffset("abc", 3), 3);
+  EXPECT_EQ(Utf8CodePointOffset("abc", 5), 3);
+  EXPECT_EQ(Utf8CodePointOffset("caf\xc3\xa9!", 4), 5);
+  // Longer than a block.
+  std::string str;
+  for (int i = 0; i < 100; ++i) {
+    str += "\xd0\xb6";  // U+0436, 2 bytes.
+  }
+  for (int64_t n : {0, 31, 32, 33, 64, 99, 100, 200}) {
+    EXPECT_EQ(Utf8CodePointOffset(str, n), std::min<int64_t>(2 * n, 200))
+        << n;
+  }
+}
+
+TEST(StringTest, Utf8ValidPrefixSize) {
+  EXPECT_EQ(Utf8ValidPrefixSize(""), 0);
+  EXPECT_EQ(Utf8ValidPrefixSize("abc"), 3);
+  EXPECT_EQ(Utf8ValidPrefixSize("古池や蛙飛び込む水の音"), 33);
+  EXPECT_EQ(Utf8ValidPrefixSize("\xf4\x8f\xbf\xbf"), 4);  // U+10FFFF
+  EXPECT_EQ(Utf8ValidPrefixSize("ab\x80"), 2);
+  EXPECT_EQ(Utf8ValidPrefixSize("ab\xc3"), 2);              // truncated
+  EXPECT_EQ(Utf8ValidPrefixSize("ab\xc0\xaf"), 2);          // overlong
+  EXPECT_EQ(Utf8ValidPrefixSize("ab\xe0\x80\xaf"), 2);      // overlong
+  EXPECT_EQ(Utf8ValidPrefixSize("ab\xed\xa0\x80"), 2);      // surrogate
+  EXPECT_EQ(Utf8ValidPrefixSize("ab\xf4\x90\x80\x80"), 2);  // > U+10FFFF
+  EXPECT_EQ(Utf8ValidPrefixSize("ab\xe2\x82x"), 2);
+  EXPECT_EQ(Utf8ValidPrefixSize(std::string(100, 'a') + "\xff"), 100);
+  EXPECT_EQ(Utf8ValidPrefixSize(std::string(100, 'a') + "\xc3\xa9" +
+                                std::string(100, 'b')),
+            202);
+}
+
 TEST(StringTest, IsQualifiedIdentifier) {
   // Single token names are allowed.
   static_assert(IsQualifiedIdentifier("foo"));
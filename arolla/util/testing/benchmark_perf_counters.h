@@ -0,0 +1,72 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_UTIL_TESTING_BENCHMARK_PERF_COUNTERS_H_
+#define AROLLA_UTIL_TESTING_BENCHMARK_PERF_COUNTERS_H_
+
+#include "benchmark/benchmark.h"
+#include "arolla/util/perf_counters.h"
+
+namespace arolla::testing {
+
+// Reports the hardware performance counters of a benchmark loop (see
+// arolla/util/perf_counters.h) as per-iteration benchmark counters: "cycles",
+// "instructions", "llc_misses", "branch_misses" and "ipc". The counters are
+// collected from the construction till the destruction, so create the object
+// right before the loop:
+//
+//   void BM_Something(benchmark::State& state) {
+//     ...  // Setup.
+//     testing::BenchmarkPerfCounters perf_counters(state);
+//     for (auto _ : state) {
+//       ...
+//     }
+//   }
+//
+// Does nothing if the counters are not available.
+class BenchmarkPerfCounters {
+ public:
+  explicit BenchmarkPerfCounters(::benchmark::State& state)
+      : state_(state), start_(ReadThreadPerfCounters()) {}
+
+  ~BenchmarkPerfCounters() {
+    if (!PerfCountersAvailable()) {
+      return;
+    }
+    PerfCounterValues values = ReadThreadPerfCounters() - start_;
+    state_.counters["cycles"] = ::benchmark::Counter(
+        values.cycles, ::benchmark::Counter::kAvgIterations);
+    state_.counters["instructions"] = ::benchmark::Counter(
+        values.instructions, ::benchmark::Counter::kAvgIterations);
+    state_.counters["llc_misses"] = ::benchmark::Counter(
+        values.llc_misses, ::benchmark::Counter::kAvgIterations);
+    state_.counters["branch_misses"] = ::benchmark::Counter(
+        values.branch_misses, ::benchmark::Counter::kAvgIterations);
+    if (values.cycles > 0) {
+      state_.counters["ipc"] =
+          static_cast<double>(values.instructions) / values.cycles;
+    }
+  }
+
+  BenchmarkPerfCounters(const BenchmarkPerfCounters&) = delete;
+  BenchmarkPerfCounters& operator=(const BenchmarkPerfCounters&) = delete;
+
+ private:
+  ::benchmark::State& state_;
+  PerfCounterValues start_;
+};
+
+}  // namespace arolla::testing
+
+#endif  // AROLLA_UTIL_TESTING_BENCHMARK_PERF_COUNTERS_H_
@@ -17,12 +17,19 @@
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+
 namespace arolla {
 
 StdThreading::StdThreading()
@@ -32,6 +39,182 @@ std::function<void()> StdThreading::StartThread(std::function<void()> fn) {
   return [t = std::make_shared<std::thread>(std::move(fn))] { t->join(); };
 }
 
+struct WorkStealingThreading::Task {
+  explicit Task(TaskFn fn) : fn(std::move(fn)) {}
+
+  // Atomically marks the task as taken for execution. Returns false if it was
+  // already claimed by someone else.
+  bool Claim() { return !claimed.exchange(true, std::memory_order_acq_rel); }
+
+  void Run() {
+    fn();
+    fn = nullptr;
+    done.Notify();
+  }
+
+  TaskFn fn;
+  std::atomic<bool> claimed = false;
+  absl::Notification done;
+};
+
+struct WorkStealingThreading::Worker {
+  absl::Mutex mutex;
+  std::deque<std::shared_ptr<Task>> tasks ABSL_GUARDED_BY(mutex);
+  std::thread thread;
+};
+
+namespace {
+
+// Identifies the pool worker running in the current thread.
+struct CurrentWorker {
+  const void* pool = nullptr;
+  size_t index = 0;
+};
+
+thread_local CurrentWorker current_worker;
+
+}  // namespace
+
+WorkStealingThreading::WorkStealingThreading()
+    : WorkStealingThreading(std::thread::hardware_concurrency()) {}
+
+WorkStealingThreading::WorkStealingThreading(int thread_count)
+    : thread_count_(std::max(thread_count, 1)), available_(thread_count_) {
+  workers_.reserve(thread_count_);
+  for (int i = 0; i < thread_count_; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  // Start threads only after all workers are created, because they access
+  // each other deques.
+  for (int i = 0; i < thread_count_; ++i) {
+    workers_[i]->thread = std::thread([this, i] { WorkerLoop(i); });
+  }
+}
+
+WorkStealingThreading::~WorkStealingThreading() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stop_ = true;
+  }
+  has_tasks_.SignalAll();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+ThreadingInterface::JoinFn WorkStealingThreading::StartThread(TaskFn fn) {
+  // Reserve an idle worker for the task.
+  int64_t available = available_.load(std::memory_order_relaxed);
+  while (available > 0 && !available_.compare_exchange_weak(
+                              available, available - 1,
+                              std::memory_order_acq_rel)) {
+  }
+  if (available <= 0) {
+    // All the workers are busy, so we fall back to a dedicated thread to
+    // guarantee that the task will not wait for the others.
+    return [t = std::make_shared<std::thread>(std::move(fn))] { t->join(); };
+  }
+  auto task = std::make_shared<Task>(std::move(fn));
+  size_t worker_index =
+      (current_worker.pool == this)
+          ? current_worker.index
+          : next_worker_.fetch_add(1, std::memory_order_relaxed) %
+                workers_.size();
+  {
+    Worker& worker = *workers_[worker_index];
+    absl::MutexLock lock(&worker.mutex);
+    worker.tasks.push_back(task);
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    queued_.fetch_add(1, std::memory_order_release);
+  }
+  has_tasks_.Signal();
+  return [this, task = std::move(task)] { Join(*task); };
+}
+
+std::shared_ptr<WorkStealingThreading::Task> WorkStealingThreading::FindTask(
+    size_t worker_index) {
+  // Own deque is processed in LIFO order to improve locality.
+  {
+    Worker& worker = *workers_[worker_index];
+    absl::MutexLock lock(&worker.mutex);
+    while (!worker.tasks.empty()) {
+      std::shared_ptr<Task> task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+      if (task->Claim()) {
+        return task;
+      }
+    }
+  }
+  // Tasks of others are stolen in FIFO order.
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker& victim = *workers_[(worker_index + i) % workers_.size()];
+    absl::MutexLock lock(&victim.mutex);
+    while (!victim.tasks.empty()) {
+      std::shared_ptr<Task> task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      if (task->Claim()) {
+        return task;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void WorkStealingThreading::WorkerLoop(size_t worker_index) {
+  current_worker = {this, worker_index};
+  while (true) {
+    if (auto task = FindTask(worker_index)) {
+      queued_.fetch_sub(1, std::memory_order_relaxed);
+      task->Run();
+      available_.fetch_add(1, std::memory_order_release);
+      continue;
+    }
+    absl::MutexLock lock(&mutex_);
+    while (!stop_ && queued_.load(std::memory_order_acquire) <= 0) {
+      has_tasks_.Wait(&mutex_);
+    }
+    if (stop_) {
+      return;
+    }
+  }
+}
+
+void WorkStealingThreading::Join(Task& task) {
+  if (task.Claim()) {
+    // The task has not started yet, so the joining thread executes it itself
+    // and the reserved worker becomes available for other tasks. The task
+    // object stays in the deque until someone pops and skips it.
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    available_.fetch_add(1, std::memory_order_release);
+    task.Run();
+    return;
+  }
+  task.done.WaitForNotification();
+}
+
+void ParallelFor(ThreadingInterface& threading, int64_t task_count,
+                 absl::FunctionRef<void(int64_t)> fn) {
+  if (task_count <= 1) {
+    if (task_count == 1) {
+      fn(0);
+    }
+    return;
+  }
+  threading.WithThreading([&] {
+    std::vector<ThreadingInterface::JoinFn> join_fns;
+    join_fns.reserve(task_count - 1);
+    for (int64_t i = 1; i < task_count; ++i) {
+      join_fns.push_back(threading.StartThread([fn, i] { fn(i); }));
+    }
+    fn(0);
+    for (auto& join_fn : join_fns) {
+      join_fn();
+    }
+  });
+}
+
 void ExecuteTasksInParallel(int max_parallelism,
                             const std::vector<std::function<void()>>& tasks) {
   std::atomic<size_t> current_task_num(0);
@@ -16,9 +16,19 @@
 #define AROLLA_UTIL_THREADING_H_
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+
 namespace arolla {
 
 // Generic interface to start threads.
@@ -69,6 +79,62 @@ class StdThreading : public ThreadingInterface {
   int thread_count_;
 };
 
+// Implementation of ThreadingInterface based on a persistent pool of worker
+// threads with per-worker task deques and work stealing.
+//
+// Tasks started from a worker thread are pushed to the worker's own deque and,
+// if no idle worker steals them first, are executed inline by the join
+// function. Tasks started from other threads are distributed across the
+// deques in round-robin order.
+//
+// StartThread guarantees that every started task gets its own thread: if all
+// the pool workers are busy, the task falls back to a dedicated std::thread.
+// So tasks are allowed to block on each other (e.g. on a barrier, as
+// FrameIterator::ForEachFrame does).
+//
+// All the tasks must be joined before the pool is destroyed.
+class WorkStealingThreading : public ThreadingInterface {
+ public:
+  // thread_count = std::thread::hardware_concurrency()
+  WorkStealingThreading();
+  explicit WorkStealingThreading(int thread_count);
+  ~WorkStealingThreading() override;
+
+  WorkStealingThreading(const WorkStealingThreading&) = delete;
+  WorkStealingThreading& operator=(const WorkStealingThreading&) = delete;
+
+  int GetRecommendedThreadCount() const final { return thread_count_; };
+  [[nodiscard]] JoinFn StartThread(TaskFn fn) final;
+
+ private:
+  struct Task;
+  struct Worker;
+
+  void WorkerLoop(size_t worker_index);
+  // Pops a task from the own deque of the worker or steals it from others.
+  std::shared_ptr<Task> FindTask(size_t worker_index);
+  // Waits for the task to finish. Executes it inline if it is not started yet.
+  void Join(Task& task);
+
+  const int thread_count_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // The number of idle workers minus the number of queued tasks.
+  std::atomic<int64_t> available_;
+  // The number of queued tasks that are not yet claimed for execution.
+  std::atomic<int64_t> queued_ = 0;
+  std::atomic<size_t> next_worker_ = 0;
+
+  absl::Mutex mutex_;
+  absl::CondVar has_tasks_;
+  bool stop_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+// Runs fn(0), ..., fn(task_count - 1) in parallel, each in its own thread
+// started via `threading`, and waits for all of them. fn(0) runs in the
+// calling thread.
+void ParallelFor(ThreadingInterface& threading, int64_t task_count,
+                 absl::FunctionRef<void(int64_t)> fn);
+
 // Executes the given set of tasks in parallel and then waits for them to all
 // complete.
 //
@@ -77,6 +143,51 @@ class StdThreading : public ThreadingInterface {
 void ExecuteTasksInParallel(int max_parallelism,
                             const std::vector<std::function<void()>>& tasks);
 
+// Accumulators of group operations (see qexpr/aggregation_ops_interface.h)
+// can optionally define a non-virtual method
+//
+//   void Merge(const MyAccumulator& other);
+//
+// that adds the state of `other` to the state of this accumulator. Both of
+// them were Reset with the same parent arguments and then accumulated
+// disjoint sets of child rows of the group; the state set by Reset must be
+// accounted only once. It allows group operations to process child rows of
+// a MAPPING edge in parallel (see GroupOpParallelism).
+template <typename Accumulator, class = void>
+struct accumulator_has_merge : std::false_type {};
+
+template <typename Accumulator>
+struct accumulator_has_merge<
+    Accumulator, std::void_t<decltype(std::declval<Accumulator&>().Merge(
+                     std::declval<const Accumulator&>()))>> : std::true_type {
+};
+
+template <typename Accumulator>
+constexpr bool accumulator_has_merge_v =
+    accumulator_has_merge<Accumulator>::value;
+
+// Options for parallel evaluation of group operations. Only aggregators and
+// partial accumulators with fixed size results are evaluated in parallel:
+//  * aggregators with SPLIT_POINTS edges split the groups into contiguous
+//    ranges,
+//  * aggregators with MAPPING edges split the child rows into ranges
+//    accumulated in separate accumulators that are later merged,
+//  * partial accumulators (e.g. cumulative sum) with SPLIT_POINTS edges split
+//    the child rows into ranges and merge the states of the groups crossing
+//    the range bounds, so a single long group is processed in parallel too.
+// The last two require the accumulator to have a Merge method. The merges
+// change the order in which the child rows are accumulated, so for the inexact
+// accumulators (e.g. a floating point sum or cumulative sum) the results can
+// differ from the sequential evaluation by rounding errors, and depend on the
+// number of threads. Keep `threading` nullptr if the results must be
+// reproducible bit by bit.
+struct GroupOpParallelism {
+  // If nullptr, the operation is evaluated in the calling thread.
+  ThreadingInterface* threading = nullptr;
+  // Minimal number of child rows per thread.
+  int64_t min_child_rows_per_thread = 1 << 16;
+};
+
 }  // namespace arolla
 
 #endif  // AROLLA_UTIL_THREADING_H_
@@ -0,0 +1,133 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/threading.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/synchronization/barrier.h"
+
+namespace arolla {
+namespace {
+
+using ::testing::Each;
+using ::testing::Eq;
+
+void TestThreadingRunsAllTasks(ThreadingInterface& threading, int task_count) {
+  std::vector<int> results(task_count, 0);
+  threading.WithThreading([&] {
+    std::vector<ThreadingInterface::JoinFn> join_fns;
+    for (int i = 0; i < task_count; ++i) {
+      join_fns.push_back(
+          threading.StartThread([&results, i] { results[i]++; }));
+    }
+    for (auto& join_fn : join_fns) join_fn();
+  });
+  EXPECT_THAT(results, Each(Eq(1)));
+}
+
+void TestThreadingRunsTasksConcurrently(ThreadingInterface& threading,
+                                        int task_count) {
+  // Every task waits for all the others, so the test deadlocks if any of the
+  // started tasks doesn't get its own thread.
+  absl::Barrier* barrier = new absl::Barrier(task_count + 1);
+  std::atomic<int> counter = 0;
+  std::vector<ThreadingInterface::JoinFn> join_fns;
+  for (int i = 0; i < task_count; ++i) {
+    join_fns.push_back(threading.StartThread([&] {
+      if (barrier->Block()) {
+        delete barrier;
+      }
+      counter++;
+    }));
+  }
+  if (barrier->Block()) {
+    delete barrier;
+  }
+  for (auto& join_fn : join_fns) join_fn();
+  EXPECT_EQ(counter.load(), task_count);
+}
+
+TEST(StdThreadingTest, StartThread) {
+  StdThreading threading(4);
+  EXPECT_EQ(threading.GetRecommendedThreadCount(), 4);
+  TestThreadingRunsAllTasks(threading, 10);
+  TestThreadingRunsTasksConcurrently(threading, 10);
+}
+
+TEST(WorkStealingThreadingTest, GetRecommendedThreadCount) {
+  EXPECT_EQ(WorkStealingThreading(3).GetRecommendedThreadCount(), 3);
+  EXPECT_EQ(WorkStealingThreading(0).GetRecommendedThreadCount(), 1);
+  EXPECT_GE(WorkStealingThreading().GetRecommendedThreadCount(), 1);
+}
+
+TEST(WorkStealingThreadingTest, StartThread) {
+  WorkStealingThreading threading(4);
+  // Repeat several times to make sure that the workers are reused.
+  for (int i = 0; i < 10; ++i) {
+    TestThreadingRunsAllTasks(threading, 3);
+    TestThreadingRunsAllTasks(threading, 100);
+  }
+}
+
+TEST(WorkStealingThreadingTest, MoreBlockingTasksThanWorkers) {
+  WorkStealingThreading threading(2);
+  TestThreadingRunsTasksConcurrently(threading, 2);
+  TestThreadingRunsTasksConcurrently(threading, 10);
+}
+
+TEST(WorkStealingThreadingTest, NestedTasks) {
+  WorkStealingThreading threading(4);
+  std::atomic<int> counter = 0;
+  std::vector<ThreadingInterface::JoinFn> join_fns;
+  for (int i = 0; i < 8; ++i) {
+    join_fns.push_back(threading.StartThread([&] {
+      std::vector<ThreadingInterface::JoinFn> nested_join_fns;
+      for (int j = 0; j < 8; ++j) {
+        nested_join_fns.push_back(threading.StartThread([&] { counter++; }));
+      }
+      for (auto& join_fn : nested_join_fns) join_fn();
+    }));
+  }
+  for (auto& join_fn : join_fns) join_fn();
+  EXPECT_EQ(counter.load(), 64);
+}
+
+TEST(ParallelForTest, Simple) {
+  WorkStealingThreading threading(2);
+  for (int task_count : {0, 1, 10}) {
+    std::vector<int> results(task_count, 0);
+    ParallelFor(threading, task_count,
+                [&results](int64_t i) { results[i]++; });
+    EXPECT_THAT(results, Each(Eq(1)));
+  }
+}
+
+TEST(ExecuteTasksInParallelTest, Simple) {
+  std::vector<int> results(10, 0);
+  std::vector<std::function<void()>> tasks;
+  for (int i = 0; i < results.size(); ++i) {
+    tasks.push_back([&results, i] { results[i]++; });
+  }
+  ExecuteTasksInParallel(3, tasks);
+  EXPECT_THAT(results, Each(Eq(1)));
+}
+
+}  // namespace
+}  // namespace arolla
@@ -89,6 +89,7 @@ leaf = _rl_abc_expr.leaf
 list_registered_operators = _rl_abc_expr.list_registered_operators
 literal = _rl_abc_expr.literal
 lookup_operator = _rl_abc_expr.lookup_operator
+make_expr_dag = _rl_abc_expr.make_expr_dag
 make_lambda = _rl_abc_expr.make_lambda
 make_operator_node = _rl_abc_expr.make_operator_node
 placeholder = _rl_abc_expr.placeholder
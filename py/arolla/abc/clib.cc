@@ -116,6 +116,7 @@ PYBIND11_MODULE(clib, m) {
       kDefPyIsAnnotationOperator,             //
       kDefPyLeaf,                             //
       kDefPyLiteral,                          //
+      kDefPyMakeExprDag,                      //
       kDefPyMakeOperatorNode,                 //
       kDefPyPlaceholder,                      //
       kDefPyToLowerNode,                      //
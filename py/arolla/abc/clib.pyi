@@ -145,6 +145,13 @@ class CompiledExpr:
   ) -> Self: ...
   def __call__(self, *args: QValue, **kwargs: QValue) -> Any: ...
   def execute(self, input_qvalues: dict[str, QValue], /) -> Any: ...
+  def execute_many(
+      self,
+      input_qvalues_list: list[dict[str, QValue]],
+      /,
+      *,
+      num_threads: int = 1,
+  ) -> list[Any]: ...
 
 class ReprToken:
   class Precedence:
@@ -242,6 +249,10 @@ def list_registered_operators() -> list[str]: ...
 
 def literal(value: QValue, /) -> Expr: ...
 
+def make_expr_dag(
+    nodes: tuple[Expr | QValue | tuple[QValue | str, int, ...], ...], /
+) -> Expr: ...
+
 def make_operator_node(
     op: QValue | str, inputs: tuple[Expr | QValue, ...] = (), /
 ) -> Expr: ...
@@ -295,6 +295,51 @@ class CompiledExprTest(absltest.TestCase):
     ):
       compiled_expr.execute(dict(y=abc_qtype.QTYPE))
 
+  def test_execute_many(self):
+    expr = abc_expr.bind_op(
+        make_tuple_op, abc_expr.leaf('x'), abc_expr.leaf('y')
+    )
+    compiled_expr = clib.CompiledExpr(
+        expr, dict(x=abc_qtype.QTYPE, y=abc_qtype.QTYPE)
+    )
+    input_qvalues_list = [
+        dict(x=abc_qtype.QTYPE, y=abc_qtype.NOTHING),
+        dict(x=abc_qtype.NOTHING, y=abc_qtype.QTYPE),
+    ] * 100
+    for num_threads in (1, 4):
+      with self.subTest(num_threads=num_threads):
+        outputs = compiled_expr.execute_many(
+            input_qvalues_list, num_threads=num_threads
+        )
+        self.assertLen(outputs, len(input_qvalues_list))
+        for output, input_qvalues in zip(outputs, input_qvalues_list):
+          self.assertEqual(
+              repr(output), repr(compiled_expr.execute(input_qvalues))
+          )
+    self.assertEqual(compiled_expr.execute_many([]), [])
+
+  def test_execute_many_with_wrong_arguments(self):
+    expr = abc_expr.bind_op(make_tuple_op, abc_expr.leaf('x'))
+    compiled_expr = clib.CompiledExpr(expr, dict(x=abc_qtype.NOTHING))
+    with self.assertRaisesWithLiteralMatch(
+        TypeError, 'expected a list[dict[str, QValue]]'
+    ):
+      compiled_expr.execute_many(object())  # pytype: disable=wrong-arg-types
+    with self.assertRaisesWithLiteralMatch(
+        TypeError,
+        'arolla.abc.CompiledExpr.execute_many() expected NOTHING, got'
+        " input_qvalues['x']: QTYPE",
+    ):
+      compiled_expr.execute_many(
+          [dict(x=abc_qtype.NOTHING), dict(x=abc_qtype.QTYPE)]
+      )
+    with self.assertRaisesWithLiteralMatch(
+        ValueError,
+        'arolla.abc.CompiledExpr.execute_many() expected a positive'
+        ' num_threads, got 0',
+    ):
+      compiled_expr.execute_many([], num_threads=0)
+
   def test_eval_on_heap(self):
     inputs = {f'_{i}': abc_qtype.QTYPE for i in range(10000)}
     expr = abc_expr.bind_op(make_tuple_op, *map(abc_expr.leaf, inputs.keys()))
@@ -181,6 +181,9 @@ list_registered_operators = clib.list_registered_operators
 # Returns a literal node with the given value.
 literal = clib.literal
 
+# Returns an expression constructed from a flat description of a DAG.
+make_expr_dag = clib.make_expr_dag
+
 # Returns an operator node with the given operator and inputs.
 make_operator_node = clib.make_operator_node
 
@@ -12,7 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
-"""Test for arolla.abc.[unsafe_]make_operator_node()."""
+"""Test for arolla.abc.[unsafe_]make_operator_node() and make_expr_dag()."""
 
 import inspect
 import re
@@ -137,6 +137,82 @@ class MakeOperatorNodeTest(absltest.TestCase):
     )
 
 
+class MakeExprDagTest(absltest.TestCase):
+
+  def test_basics(self):
+    x = abc_expr.leaf('x')
+    expr = abc_expr.make_expr_dag((
+        x,
+        abc_qtype.NOTHING,
+        (op_tuple, 0, 1),
+        ('make_op_node_test.tuple', 2, 0, 2),
+    ))
+    inner = abc_expr.make_operator_node(op_tuple, (x, abc_qtype.NOTHING))
+    self.assertEqual(
+        expr.fingerprint,
+        abc_expr.make_operator_node(
+            'make_op_node_test.tuple', (inner, x, inner)
+        ).fingerprint,
+    )
+
+  def test_attr(self):
+    expr = abc_expr.make_expr_dag(
+        (abc_qtype.Unspecified(), (op_id, 0), (op_id, 1))
+    )
+    self.assertEqual(expr.qvalue, abc_qtype.Unspecified())
+
+  def test_error_wrong_arg_types(self):
+    with self.assertRaisesWithLiteralMatch(
+        TypeError,
+        'arolla.abc.make_expr_dag() expected a tuple, got nodes: list',
+    ):
+      abc_expr.make_expr_dag([abc_qtype.NOTHING])  # pytype: disable=wrong-arg-types
+    with self.assertRaisesWithLiteralMatch(
+        TypeError,
+        'arolla.abc.make_expr_dag() expected'
+        ' Expr|QValue|tuple[Operator|str, int, ...], got nodes[0]: object',
+    ):
+      abc_expr.make_expr_dag((object(),))  # pytype: disable=wrong-arg-types
+    with self.assertRaisesWithLiteralMatch(
+        TypeError,
+        'arolla.abc.make_expr_dag() expected an index, got nodes[1][1]: str',
+    ):
+      abc_expr.make_expr_dag((abc_qtype.NOTHING, (op_id, 'x')))  # pytype: disable=wrong-arg-types
+
+  def test_error_wrong_index(self):
+    with self.assertRaisesWithLiteralMatch(
+        ValueError,
+        'arolla.abc.make_expr_dag() expected an index of a preceding node,'
+        ' got nodes[1][1]: 1',
+    ):
+      abc_expr.make_expr_dag((abc_qtype.NOTHING, (op_id, 1)))
+    with self.assertRaisesWithLiteralMatch(
+        ValueError,
+        'arolla.abc.make_expr_dag() expected an index of a preceding node,'
+        ' got nodes[1][1]: 18446744073709551616',
+    ):
+      abc_expr.make_expr_dag((abc_qtype.NOTHING, (op_id, 2**64)))
+
+  def test_error_empty(self):
+    with self.assertRaisesWithLiteralMatch(
+        ValueError, 'arolla.abc.make_expr_dag() expected a non-empty tuple'
+    ):
+      abc_expr.make_expr_dag(())
+
+  def test_error_no_such_operator(self):
+    with self.assertRaisesWithLiteralMatch(
+        LookupError,
+        "arolla.abc.make_expr_dag() operator not found: 'no.such.operator'",
+    ):
+      abc_expr.make_expr_dag((('no.such.operator',),))
+
+  def test_signature(self):
+    self.assertEqual(
+        inspect.signature(abc_expr.make_expr_dag),
+        inspect.signature(lambda nodes, /: None),
+    )
+
+
 class UnsafeMakeOperatorNodeTest(absltest.TestCase):
 
   def test_op(self):
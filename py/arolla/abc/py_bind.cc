@@ -24,6 +24,7 @@
 #include <variant>
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -36,23 +37,74 @@
 #include "arolla/expr/expr_attributes.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_operator.h"
+#include "arolla/expr/expr_operator_signature.h"
 #include "arolla/expr/registered_expr_operator.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/indestructible.h"
+#include "arolla/util/lru_cache.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::python {
 namespace {
 
 using ::arolla::expr::BindOp;
+using ::arolla::expr::DecayRegisteredOperator;
 using ::arolla::expr::ExprAttributes;
 using ::arolla::expr::ExprNode;
 using ::arolla::expr::ExprNodePtr;
 using ::arolla::expr::ExprOperatorPtr;
+using ::arolla::expr::ExprOperatorSignature;
 using ::arolla::expr::Literal;
 using ::arolla::expr::MakeOpNode;
 using ::arolla::expr::RegisteredOperator;
 
+using ExprOperatorSignaturePtr = std::shared_ptr<const ExprOperatorSignature>;
+
+// A cache of operator signatures, keyed by the fingerprint of the operator
+// implementation.
+//
+// The signature of an operator is fixed by its fingerprint, so the entries
+// never become stale. For registered operators, we key by the implementation,
+// so that re-registration of an operator is picked up on the next lookup.
+class SignatureCache {
+ public:
+  static constexpr size_t kCacheSize = 4096;
+
+  // Returns the signature of the operator; or nullptr and sets a Python
+  // exception.
+  static absl::Nullable<ExprOperatorSignaturePtr> GetSignatureOrNull(
+      ExprOperatorPtr op) {
+    DCheckPyGIL();
+    auto decayed_op = DecayRegisteredOperator(std::move(op));
+    if (!decayed_op.ok()) {
+      SetPyErrFromStatus(decayed_op.status());
+      return nullptr;
+    }
+    const auto& fingerprint = (*decayed_op)->fingerprint();
+    if (auto* result = impl().LookupOrNull(fingerprint)) {
+      return *result;
+    }
+    auto signature = (*decayed_op)->GetSignature();
+    if (!signature.ok()) {
+      SetPyErrFromStatus(signature.status());
+      return nullptr;
+    }
+    return *impl().Put(fingerprint,
+                       std::make_shared<const ExprOperatorSignature>(
+                           *std::move(signature)));
+  }
+
+ private:
+  using Impl = LruCache<Fingerprint, ExprOperatorSignaturePtr>;
+
+  static Impl& impl() {
+    static Indestructible<Impl> result(kCacheSize);
+    return *result;
+  }
+};
+
 // def make_operator_node(
 //     op: str|QValue, inputs: tuple[QValue|Expr, ...] = (), /
 // ) -> Expr
@@ -178,6 +230,81 @@ PyObject* PyUnsafeMakeOperatorNode(PyObject* /*self*/, PyObject** py_args,
       std::move(op), std::move(inputs), ExprAttributes{}));
 }
 
+// def make_expr_dag(
+//     nodes: tuple[Expr|QValue|tuple[QValue|str, int, ...], ...], /
+// ) -> Expr
+PyObject* PyMakeExprDag(PyObject* /*self*/, PyObject* py_tuple_nodes) {
+  DCheckPyGIL();
+  if (!PyTuple_Check(py_tuple_nodes)) {
+    return PyErr_Format(PyExc_TypeError,
+                        "arolla.abc.make_expr_dag() expected a tuple, got "
+                        "nodes: %s",
+                        Py_TYPE(py_tuple_nodes)->tp_name);
+  }
+  const Py_ssize_t nodes_size = PyTuple_GET_SIZE(py_tuple_nodes);
+  if (nodes_size == 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "arolla.abc.make_expr_dag() expected a non-empty tuple");
+    return nullptr;
+  }
+  std::vector<ExprNodePtr> nodes(nodes_size);
+  // The operators are usually shared by many nodes, so we parse each distinct
+  // python object only once. The python objects are kept alive by
+  // `py_tuple_nodes`.
+  absl::flat_hash_map<PyObject*, ExprOperatorPtr> ops;
+  std::vector<ExprNodePtr> inputs;
+  for (Py_ssize_t i = 0; i < nodes_size; ++i) {
+    PyObject* py_node = PyTuple_GET_ITEM(py_tuple_nodes, i);
+    if (IsPyExprInstance(py_node)) {
+      nodes[i] = UnsafeUnwrapPyExpr(py_node);
+      continue;
+    } else if (IsPyQValueInstance(py_node)) {
+      nodes[i] = Literal(UnsafeUnwrapPyQValue(py_node));
+      continue;
+    } else if (!PyTuple_Check(py_node) || PyTuple_GET_SIZE(py_node) == 0) {
+      return PyErr_Format(PyExc_TypeError,
+                          "arolla.abc.make_expr_dag() expected "
+                          "Expr|QValue|tuple[Operator|str, int, ...], got "
+                          "nodes[%zd]: %s",
+                          i, Py_TYPE(py_node)->tp_name);
+    }
+    PyObject* py_op = PyTuple_GET_ITEM(py_node, 0);
+    auto& op = ops[py_op];
+    if (op == nullptr) {
+      op = ParseArgPyOperator("arolla.abc.make_expr_dag", py_op);
+      if (op == nullptr) {
+        ops.erase(py_op);
+        return nullptr;
+      }
+    }
+    inputs.resize(PyTuple_GET_SIZE(py_node) - 1);
+    for (size_t j = 0; j < inputs.size(); ++j) {
+      PyObject* py_index = PyTuple_GET_ITEM(py_node, j + 1);
+      // Out-of-range integers are clamped, so that they get reported as
+      // invalid indices rather than as values of a wrong type.
+      Py_ssize_t index = PyNumber_AsSsize_t(py_index, nullptr);
+      if (index == -1 && PyErr_Occurred()) {
+        PyErr_Clear();
+        return PyErr_Format(PyExc_TypeError,
+                            "arolla.abc.make_expr_dag() expected an index, "
+                            "got nodes[%zd][%zu]: %s",
+                            i, j + 1, Py_TYPE(py_index)->tp_name);
+      }
+      if (index < 0 || index >= i) {
+        return PyErr_Format(PyExc_ValueError,
+                            "arolla.abc.make_expr_dag() expected an index of "
+                            "a preceding node, got nodes[%zd][%zu]: %R",
+                            i, j + 1, py_index);
+      }
+      inputs[j] = nodes[index];
+    }
+    ASSIGN_OR_RETURN(nodes[i], MakeOpNode(op, std::move(inputs)),
+                     (SetPyErrFromStatus(_), nullptr));
+    inputs.clear();
+  }
+  return WrapAsPyExpr(std::move(nodes.back()));
+}
+
 // def bind_op(
 //     op: str|QValue, /, *args: QValue|Expr, **kwargs: QValue|Expr
 // ) -> Expr
@@ -268,9 +395,8 @@ PyObject* PyAuxBindOp(PyObject* /*self*/, PyObject** py_args, Py_ssize_t nargs,
     return nullptr;
   }
   // Bind the arguments.
-  auto signature = op->GetSignature();
-  if (!signature.ok()) {
-    SetPyErrFromStatus(signature.status());
+  auto signature = SignatureCache::GetSignatureOrNull(op);
+  if (signature == nullptr) {
     return nullptr;
   }
   std::vector<QValueOrExpr> bound_args;
@@ -322,9 +448,8 @@ PyObject* PyAuxGetPythonSignature(PyObject* /*self*/, PyObject* py_op) {
   if (op == nullptr) {
     return nullptr;
   }
-  auto signature = op->GetSignature();
-  if (!signature.ok()) {
-    SetPyErrFromStatus(signature.status());
+  auto signature = SignatureCache::GetSignatureOrNull(std::move(op));
+  if (signature == nullptr) {
     return nullptr;
   }
   return AuxMakePythonSignature(*signature);
@@ -362,6 +487,30 @@ const PyMethodDef kDefPyUnsafeMakeOperatorNode = {
      "    with the operator's signature."),
 };
 
+const PyMethodDef kDefPyMakeExprDag = {
+    "make_expr_dag",
+    &PyMakeExprDag,
+    METH_O,
+    ("make_expr_dag(nodes, /)\n"
+     "--\n\n"
+     "Returns an expression constructed from a flat description of a DAG.\n\n"
+     "Each item of `nodes` is either an Expr or a QValue (attached as-is or\n"
+     "as a literal), or a tuple `(op, *input_indices)` describing an operator\n"
+     "node whose inputs are the preceding items with the given indices. The\n"
+     "operator nodes are created as by make_operator_node(), i.e. with the\n"
+     "validation of the dependencies and the attribute inference, but without\n"
+     "creating intermediate python objects.\n\n"
+     "Args:\n"
+     "  nodes: A non-empty tuple of the node descriptions in a topological\n"
+     "    order.\n\n"
+     "Returns:\n"
+     "  The expression corresponding to the last item of `nodes`.\n\n"
+     "Raises:\n"
+     "  TypeError: If a node description or an input index has a wrong type.\n"
+     "  ValueError: If `nodes` is empty, or an input index does not refer to\n"
+     "    a preceding node."),
+};
+
 const PyMethodDef kDefPyBindOp = {
     "bind_op",
     reinterpret_cast<PyCFunction>(&PyBindOp),
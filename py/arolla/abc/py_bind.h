@@ -28,6 +28,9 @@ namespace arolla::python {
 // def make_operator_node(...)
 extern const PyMethodDef kDefPyMakeOperatorNode;
 
+// def make_expr_dag(...)
+extern const PyMethodDef kDefPyMakeExprDag;
+
 // def unsafe_make_operator_node(...)
 extern const PyMethodDef kDefPyUnsafeMakeOperatorNode;
 
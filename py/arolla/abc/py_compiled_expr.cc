@@ -32,6 +32,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "py/arolla/abc/py_expr.h"
 #include "py/arolla/abc/py_helpers.h"
 #include "py/arolla/abc/py_qtype.h"
@@ -48,6 +49,8 @@
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_value.h"
 #include "arolla/util/string.h"
+#include "arolla/util/threading.h"
+#include "arolla/util/unit.h"
 #include "arolla/util/status_macros_backport.h"
 
 namespace arolla::python {
@@ -56,6 +59,7 @@ namespace {
 using ::arolla::expr::CompileModelExecutor;
 using ::arolla::expr::DynamicEvaluationEngineOptions;
 using ::arolla::expr::ExprNodePtr;
+using ::arolla::expr::ModelBatchEvaluationOptions;
 using ::arolla::expr::ModelEvaluationOptions;
 using ::arolla::expr::ModelExecutor;
 using ::arolla::expr::ModelExecutorOptions;
@@ -150,66 +154,72 @@ absl::StatusOr<TypedValue> Execute(const Executor& executor,
   }
 }
 
-// CompiledExpr.execute(self, input_qvalues: dict[str, QValue]) method.
-PyObject* PyCompiledExpr_execute(PyObject* self,
-                                 PyObject* py_dict_input_qvalues) {
+// (internal) Parses `py_dict_input_qvalues` into `input_qvalues`.
+//
+// On success, returns true; otherwise, sets a Python exception and returns
+// false. `method_name` is used in the error messages.
+bool ParseInputQValues(PyObject* self, const char* method_name,
+                       PyObject* py_dict_input_qvalues,
+                       InputQValues& input_qvalues) {
   auto& self_fields = PyCompiledExpr_fields(self);
-
-  // Parse `input_qvalues`.
   if (!PyDict_Check(py_dict_input_qvalues)) {
-    return PyErr_Format(
-        PyExc_TypeError,
-        "%s.execute() expected a dict[str, QValue], got input_qvalues: %s",
-        Py_TYPE(self)->tp_name, Py_TYPE(py_dict_input_qvalues)->tp_name);
+    PyErr_Format(PyExc_TypeError,
+                 "%s.%s() expected a dict[str, QValue], got input_qvalues: %s",
+                 Py_TYPE(self)->tp_name, method_name,
+                 Py_TYPE(py_dict_input_qvalues)->tp_name);
+    return false;
   }
   const size_t input_qvalues_size = PyDict_Size(py_dict_input_qvalues);
-  InputQValues input_qvalues;
   input_qvalues.reserve(input_qvalues_size);
   PyObject *py_str, *py_qvalue;
   Py_ssize_t pos = 0;
   while (PyDict_Next(py_dict_input_qvalues, &pos, &py_str, &py_qvalue)) {
     Py_ssize_t input_name_size = 0;
     if (!PyUnicode_Check(py_str)) {
-      return PyErr_Format(
-          PyExc_TypeError,
-          "%s.execute() expected all input_qvalues.keys() to be "
-          "strings, got %s",
-          Py_TYPE(self)->tp_name, Py_TYPE(py_str)->tp_name);
+      PyErr_Format(PyExc_TypeError,
+                   "%s.%s() expected all input_qvalues.keys() to be "
+                   "strings, got %s",
+                   Py_TYPE(self)->tp_name, method_name,
+                   Py_TYPE(py_str)->tp_name);
+      return false;
     }
     const char* input_name_data =
         PyUnicode_AsUTF8AndSize(py_str, &input_name_size);
     if (input_name_data == nullptr) {
-      return nullptr;
+      return false;
     }
     const absl::string_view input_name(input_name_data, input_name_size);
     auto it = self_fields.input_qtypes.find(input_name);
     if (it == self_fields.input_qtypes.end()) {
-      return PyErr_Format(PyExc_TypeError,
-                          "%s.execute() got an unexpected input %R",
-                          Py_TYPE(self)->tp_name, py_str);
+      PyErr_Format(PyExc_TypeError, "%s.%s() got an unexpected input %R",
+                   Py_TYPE(self)->tp_name, method_name, py_str);
+      return false;
     }
     const auto* typed_value = UnwrapPyQValue(py_qvalue);
     if (typed_value == nullptr) {
       PyErr_Clear();
-      return PyErr_Format(
-          PyExc_TypeError,
-          "%s.execute() expected all input_qvalues.values() to be "
-          "QValues, got %s",
-          Py_TYPE(self)->tp_name, Py_TYPE(py_qvalue)->tp_name);
+      PyErr_Format(PyExc_TypeError,
+                   "%s.%s() expected all input_qvalues.values() to be "
+                   "QValues, got %s",
+                   Py_TYPE(self)->tp_name, method_name,
+                   Py_TYPE(py_qvalue)->tp_name);
+      return false;
     }
     if (typed_value->GetType() != it->second) {
-      return PyErr_Format(PyExc_TypeError,
-                          "%s.execute() expected %s, got input_qvalues[%R]: %s",
-                          Py_TYPE(self)->tp_name,
-                          std::string(it->second->name()).c_str(), py_str,
-                          std::string(typed_value->GetType()->name()).c_str());
+      PyErr_Format(PyExc_TypeError,
+                   "%s.%s() expected %s, got input_qvalues[%R]: %s",
+                   Py_TYPE(self)->tp_name, method_name,
+                   std::string(it->second->name()).c_str(), py_str,
+                   std::string(typed_value->GetType()->name()).c_str());
+      return false;
     }
     input_qvalues.try_emplace(input_name, typed_value->AsRef());
   }
   DCHECK(input_qvalues.size() <= self_fields.input_qtypes.size());
   if (input_qvalues.size() < self_fields.input_qtypes.size()) {
     std::ostringstream message;
-    message << Py_TYPE(self)->tp_name << ".execute() missing required input: ";
+    message << Py_TYPE(self)->tp_name << "." << method_name
+            << "() missing required input: ";
     bool is_first = true;
     for (size_t i = 0; i < self_fields.input_names.size(); ++i) {
       const auto& input_name = self_fields.input_names[i];
@@ -219,6 +229,18 @@ PyObject* PyCompiledExpr_execute(PyObject* self,
       }
     }
     PyErr_SetString(PyExc_TypeError, std::move(message).str().c_str());
+    return false;
+  }
+  return true;
+}
+
+// CompiledExpr.execute(self, input_qvalues: dict[str, QValue]) method.
+PyObject* PyCompiledExpr_execute(PyObject* self,
+                                 PyObject* py_dict_input_qvalues) {
+  auto& self_fields = PyCompiledExpr_fields(self);
+  InputQValues input_qvalues;
+  if (!ParseInputQValues(self, "execute", py_dict_input_qvalues,
+                         input_qvalues)) {
     return nullptr;
   }
   auto result = Execute(self_fields.executor, input_qvalues);
@@ -229,6 +251,83 @@ PyObject* PyCompiledExpr_execute(PyObject* self,
   return WrapAsPyQValue(*std::move(result));
 }
 
+// CompiledExpr.execute_many(
+//     self, input_qvalues_list: list[dict[str, QValue]], /, *,
+//     num_threads: int = 1) method.
+PyObject* PyCompiledExpr_execute_many(PyObject* self, PyObject* args,
+                                      PyObject* kwargs) {
+  DCheckPyGIL();
+  auto& self_fields = PyCompiledExpr_fields(self);
+  PyObject* py_input_qvalues_list = nullptr;
+  Py_ssize_t num_threads = 1;
+  static constexpr const char* keywords[] = {"", "num_threads", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwargs, "O|$n:arolla.abc.CompiledExpr.execute_many",
+          const_cast<char**>(keywords), &py_input_qvalues_list,
+          &num_threads)) {
+    return nullptr;
+  }
+  if (num_threads < 1) {
+    return PyErr_Format(PyExc_ValueError,
+                        "%s.execute_many() expected a positive num_threads, "
+                        "got %zd",
+                        Py_TYPE(self)->tp_name, num_threads);
+  }
+  auto py_sequence_fast = PyObjectPtr::Own(PySequence_Fast(
+      py_input_qvalues_list, "expected a list[dict[str, QValue]]"));
+  if (py_sequence_fast == nullptr) {
+    return nullptr;
+  }
+  const size_t size = PySequence_Fast_GET_SIZE(py_sequence_fast.get());
+  PyObject** py_dicts = PySequence_Fast_ITEMS(py_sequence_fast.get());
+  std::vector<InputQValues> inputs(size);
+  // The input names and qvalues must stay alive even if the dicts get modified
+  // by other Python threads while the GIL is released.
+  std::vector<PyObjectPtr> py_objects;
+  py_objects.reserve(2 * size * self_fields.input_qtypes.size());
+  for (size_t i = 0; i < size; ++i) {
+    if (!ParseInputQValues(self, "execute_many", py_dicts[i], inputs[i])) {
+      return nullptr;
+    }
+    PyObject *py_str, *py_qvalue;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(py_dicts[i], &pos, &py_str, &py_qvalue)) {
+      py_objects.push_back(PyObjectPtr::NewRef(py_str));
+      py_objects.push_back(PyObjectPtr::NewRef(py_qvalue));
+    }
+  }
+  std::vector<TypedValue> outputs(size, TypedValue::FromValue(kUnit));
+  absl::Status status = [&]() -> absl::Status {
+    ReleasePyGIL guard;
+    // The executor of the compiled expression can be shared between several
+    // Python threads, so the batch is evaluated by a clone of it. The clone
+    // reuses its frame for all the inputs.
+    ASSIGN_OR_RETURN(auto executor, self_fields.executor.Clone());
+    std::optional<StdThreading> threading;
+    ModelBatchEvaluationOptions options;
+    if (num_threads > 1) {
+      options.threading = &threading.emplace(static_cast<int>(num_threads));
+    }
+    return executor.ExecuteBatch(options, inputs, absl::MakeSpan(outputs));
+  }();
+  if (!status.ok()) {
+    SetPyErrFromStatus(status);
+    return nullptr;
+  }
+  auto result = PyObjectPtr::Own(PyList_New(size));
+  if (result == nullptr) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < size; ++i) {
+    auto* py_output = WrapAsPyQValue(std::move(outputs[i]));
+    if (py_output == nullptr) {
+      return nullptr;
+    }
+    PyList_SET_ITEM(result.get(), i, py_output);
+  }
+  return result.release();
+}
+
 // CompiledExpr.__call__(self, *args: QValue, **kwarg: QValue) method.
 PyObject* PyCompiledExpr_vectorcall(PyObject* self,
                                     PyObject* const* py_qvalue_args,
@@ -457,6 +556,15 @@ PyMethodDef kPyCompiledExpr_methods[] = {
         METH_O,
         "Executes the compiled expression with given inputs.",
     },
+    {
+        "execute_many",
+        reinterpret_cast<PyCFunction>(&PyCompiledExpr_execute_many),
+        METH_VARARGS | METH_KEYWORDS,
+        ("Executes the compiled expression on each of the given inputs.\n\n"
+         "All the inputs are evaluated in a single call without the GIL, "
+         "reusing\nthe same evaluation frame. If num_threads > 1, the inputs "
+         "are split into\nchunks evaluated in parallel."),
+    },
     {nullptr} /* sentinel */
 };
 
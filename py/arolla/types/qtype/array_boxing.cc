@@ -17,12 +17,20 @@
 #include <Python.h>
 
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
 
+#include "absl/base/config.h"
 #include "absl/base/no_destructor.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
+#include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
 #include "absl/types/span.h"
 #include "py/arolla/abc/py_qvalue.h"
 #include "py/arolla/abc/py_qvalue_specialization.h"
@@ -35,7 +43,9 @@
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
 #include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_value.h"
 #include "arolla/qtype/weak_qtype.h"
 #include "arolla/util/bytes.h"
@@ -135,10 +145,120 @@ using ArrayTraits =
                     ArrayTextTraits, ArrayUInt64Traits, ArrayUnitTraits,
                     ArrayWeakFloatTraits>;
 
+// Returns true if the buffer items, described by `format` and `itemsize`, can
+// be interpreted as values of type T.
+template <typename T>
+bool IsCompatibleBufferFormat(const char* format, Py_ssize_t itemsize) {
+  if (format == nullptr || itemsize != sizeof(T)) {
+    return false;
+  }
+  absl::string_view fmt = format;
+  // Accept the native and the standard sizes, with the native byte order.
+  if (!absl::ConsumePrefix(&fmt, "@") && !absl::ConsumePrefix(&fmt, "=")) {
+#ifdef ABSL_IS_LITTLE_ENDIAN
+    absl::ConsumePrefix(&fmt, "<");
+#else
+    absl::ConsumePrefix(&fmt, ">");
+#endif
+  }
+  if (fmt.size() != 1) {
+    return false;
+  }
+  if constexpr (std::is_same_v<T, bool>) {
+    return fmt == "?";
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return fmt == "f" || fmt == "d";
+  } else if constexpr (std::is_signed_v<T>) {
+    return absl::StrContains("bhilqn", fmt);
+  } else {
+    return absl::StrContains("BHILQN", fmt);
+  }
+}
+
+// Returns true if the memory exported through `view` is guaranteed to stay
+// unchanged while the view is held.
+//
+// The read-only flag of the view is not enough for that: for example,
+// a read-only numpy array may be a view of a writable one. So we only trust
+// `bytes` objects, possibly wrapped into a memoryview.
+bool IsImmutablePyBuffer(const Py_buffer& view) {
+  PyObject* obj = view.obj;
+  if (obj != nullptr && PyMemoryView_Check(obj)) {
+    obj = PyMemoryView_GET_BASE(obj);
+  }
+  return obj != nullptr && PyBytes_CheckExact(obj);
+}
+
+// Returns a buffer with the values exported by `py_arg` through the Python
+// buffer protocol. If the exported memory is immutable and suitably aligned,
+// the result shares it and keeps a reference to the exporter; otherwise,
+// the data gets copied.
+//
+// On failure, returns std::nullopt and sets a Python exception.
+template <typename T>
+std::optional<Buffer<T>> BufferFromPyBuffer(PyObject* py_arg) {
+  auto view = std::make_unique<Py_buffer>();
+  if (PyObject_GetBuffer(py_arg, view.get(), PyBUF_CONTIG_RO | PyBUF_FORMAT) <
+      0) {
+    return std::nullopt;
+  }
+  if (view->ndim != 1 ||
+      !IsCompatibleBufferFormat<T>(view->format, view->itemsize)) {
+    PyErr_Format(PyExc_TypeError,
+                 "expected a one-dimensional buffer of %s, got ndim=%d, "
+                 "format='%s'",
+                 std::string(GetQType<T>()->name()).c_str(), view->ndim,
+                 view->format != nullptr ? view->format : "");
+    PyBuffer_Release(view.get());
+    return std::nullopt;
+  }
+  const int64_t size = view->shape[0];
+  if (!IsImmutablePyBuffer(*view) ||
+      reinterpret_cast<uintptr_t>(view->buf) % alignof(T) != 0) {
+    // The exporter can modify the data later, or the data is not aligned to be
+    // accessed as T, so we make a copy.
+    typename Buffer<T>::Builder builder(size);
+    if (size > 0) {
+      std::memcpy(builder.GetMutableSpan().data(), view->buf, size * sizeof(T));
+    }
+    PyBuffer_Release(view.get());
+    return std::move(builder).Build();
+  }
+  const absl::Span<const T> values(static_cast<const T*>(view->buf), size);
+  RawBufferPtr holder(view->buf, [view = view.release()](const void*) {
+    AcquirePyGIL gil_acquire;
+    PyBuffer_Release(view);
+    delete view;
+  });
+  return Buffer<T>(std::move(holder), values);
+}
+
+// def dense_array_T_from_values_buffer(buffer, /) -> QValue
+template <typename ArrayTraits>
+PyObject* PyDenseArrayTFromValuesBuffer(PyObject* /*self*/, PyObject* py_arg) {
+  using T = typename ArrayTraits::value_type;
+  auto values = BufferFromPyBuffer<T>(py_arg);
+  if (!values.has_value()) {
+    return nullptr;
+  }
+  return WrapAsPyQValue(
+      ArrayTraits::MakeQValue(DenseArray<T>{*std::move(values)}));
+}
+
 // def dense_array_T_from_values(values, /) -> QValue
 template <typename ArrayTraits>
 PyObject* PyDenseArrayTFromValues(PyObject* /*self*/, PyObject* py_arg) {
   using T = typename ArrayTraits::value_type;
+  if constexpr (std::is_arithmetic_v<T>) {
+    // Fast path for objects supporting the buffer protocol, like memoryview.
+    if (PyObject_CheckBuffer(py_arg)) {
+      if (auto values = BufferFromPyBuffer<T>(py_arg)) {
+        return WrapAsPyQValue(
+            ArrayTraits::MakeQValue(DenseArray<T>{*std::move(values)}));
+      }
+      PyErr_Clear();  // Fallback to the sequence protocol.
+    }
+  }
   auto py_sequence_fast = PyObjectPtr::Own(
       PySequence_Fast(py_arg, "expected a sequence of values"));
   if (py_sequence_fast == nullptr) {
@@ -313,6 +433,17 @@ const PyMethodDef kDefPyDenseArrayBooleanFromValues = {
      "Returns DENSE_ARRAY_BOOLEAN qvalue."),
 };
 
+const PyMethodDef kDefPyDenseArrayBooleanFromValuesBuffer = {
+    "dense_array_boolean_from_values_buffer",
+    &PyDenseArrayTFromValuesBuffer<ArrayBooleanTraits>,
+    METH_O,
+    ("dense_array_boolean_from_values_buffer(buffer, /)\n"
+     "--\n\n"
+     "Returns DENSE_ARRAY_BOOLEAN qvalue.\n\n"
+     "If the buffer memory is immutable (e.g. owned by a bytes object), the\n"
+     "result shares it; otherwise, the data gets copied."),
+};
+
 const PyMethodDef kDefPyDenseArrayBytesFromValues = {
     "dense_array_bytes_from_values",
     &PyDenseArrayTFromValues<ArrayBytesTraits>,
@@ -331,6 +462,17 @@ const PyMethodDef kDefPyDenseArrayFloat32FromValues = {
      "Returns DENSE_ARRAY_FLOAT32 qvalue."),
 };
 
+const PyMethodDef kDefPyDenseArrayFloat32FromValuesBuffer = {
+    "dense_array_float32_from_values_buffer",
+    &PyDenseArrayTFromValuesBuffer<ArrayFloat32Traits>,
+    METH_O,
+    ("dense_array_float32_from_values_buffer(buffer, /)\n"
+     "--\n\n"
+     "Returns DENSE_ARRAY_FLOAT32 qvalue.\n\n"
+     "If the buffer memory is immutable (e.g. owned by a bytes object), the\n"
+     "result shares it; otherwise, the data gets copied."),
+};
+
 const PyMethodDef kDefPyDenseArrayFloat64FromValues = {
     "dense_array_float64_from_values",
     &PyDenseArrayTFromValues<ArrayFloat64Traits>,
@@ -340,6 +482,17 @@ const PyMethodDef kDefPyDenseArrayFloat64FromValues = {
      "Returns DENSE_ARRAY_FLOAT64 qvalue."),
 };
 
+const PyMethodDef kDefPyDenseArrayFloat64FromValuesBuffer = {
+    "dense_array_float64_from_values_buffer",
+    &PyDenseArrayTFromValuesBuffer<ArrayFloat64Traits>,
+    METH_O,
+    ("dense_array_float64_from_values_buffer(buffer, /)\n"
+     "--\n\n"
+     "Returns DENSE_ARRAY_FLOAT64 qvalue.\n\n"
+     "If the buffer memory is immutable (e.g. owned by a bytes object), the\n"
+     "result shares it; otherwise, the data gets copied."),
+};
+
 const PyMethodDef kDefPyDenseArrayInt32FromValues = {
     "dense_array_int32_from_values",
     &PyDenseArrayTFromValues<ArrayInt32Traits>,
@@ -349,6 +502,17 @@ const PyMethodDef kDefPyDenseArrayInt32FromValues = {
      "Returns DENSE_ARRAY_INT32 qvalue."),
 };
 
+const PyMethodDef kDefPyDenseArrayInt32FromValuesBuffer = {
+    "dense_array_int32_from_values_buffer",
+    &PyDenseArrayTFromValuesBuffer<ArrayInt32Traits>,
+    METH_O,
+    ("dense_array_int32_from_values_buffer(buffer, /)\n"
+     "--\n\n"
+     "Returns DENSE_ARRAY_INT32 qvalue.\n\n"
+     "If the buffer memory is immutable (e.g. owned by a bytes object), the\n"
+     "result shares it; otherwise, the data gets copied."),
+};
+
 const PyMethodDef kDefPyDenseArrayInt64FromValues = {
     "dense_array_int64_from_values",
     &PyDenseArrayTFromValues<ArrayInt64Traits>,
@@ -358,6 +522,17 @@ const PyMethodDef kDefPyDenseArrayInt64FromValues = {
      "Returns DENSE_ARRAY_INT64 qvalue."),
 };
 
+const PyMethodDef kDefPyDenseArrayInt64FromValuesBuffer = {
+    "dense_array_int64_from_values_buffer",
+    &PyDenseArrayTFromValuesBuffer<ArrayInt64Traits>,
+    METH_O,
+    ("dense_array_int64_from_values_buffer(buffer, /)\n"
+     "--\n\n"
+     "Returns DENSE_ARRAY_INT64 qvalue.\n\n"
+     "If the buffer memory is immutable (e.g. owned by a bytes object), the\n"
+     "result shares it; otherwise, the data gets copied."),
+};
+
 const PyMethodDef kDefPyDenseArrayTextFromValues = {
     "dense_array_text_from_values",
     &PyDenseArrayTFromValues<ArrayTextTraits>,
@@ -376,6 +551,17 @@ const PyMethodDef kDefPyDenseArrayUInt64FromValues = {
      "Returns DENSE_ARRAY_UINT64 qvalue."),
 };
 
+const PyMethodDef kDefPyDenseArrayUInt64FromValuesBuffer = {
+    "dense_array_uint64_from_values_buffer",
+    &PyDenseArrayTFromValuesBuffer<ArrayUInt64Traits>,
+    METH_O,
+    ("dense_array_uint64_from_values_buffer(buffer, /)\n"
+     "--\n\n"
+     "Returns DENSE_ARRAY_UINT64 qvalue.\n\n"
+     "If the buffer memory is immutable (e.g. owned by a bytes object), the\n"
+     "result shares it; otherwise, the data gets copied."),
+};
+
 const PyMethodDef kDefPyDenseArrayUnitFromValues = {
     "dense_array_unit_from_values",
     &PyDenseArrayTFromValues<ArrayUnitTraits>,
@@ -394,6 +580,17 @@ const PyMethodDef kDefPyDenseArrayWeakFloatFromValues = {
      "Returns DENSE_ARRAY_WEAK_FLOAT qvalue."),
 };
 
+const PyMethodDef kDefPyDenseArrayWeakFloatFromValuesBuffer = {
+    "dense_array_weak_float_from_values_buffer",
+    &PyDenseArrayTFromValuesBuffer<ArrayWeakFloatTraits>,
+    METH_O,
+    ("dense_array_weak_float_from_values_buffer(buffer, /)\n"
+     "--\n\n"
+     "Returns DENSE_ARRAY_WEAK_FLOAT qvalue.\n\n"
+     "If the buffer memory is immutable (e.g. owned by a bytes object), the\n"
+     "result shares it; otherwise, the data gets copied."),
+};
+
 const PyMethodDef kDefPyGetArrayItem = {
     "get_array_item",
     reinterpret_cast<PyCFunction>(&PyGetArrayItem),
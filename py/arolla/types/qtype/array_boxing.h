@@ -26,33 +26,54 @@ namespace arolla::python {
 // def dense_array_boolean_from_values(...)
 extern const PyMethodDef kDefPyDenseArrayBooleanFromValues;
 
+// def dense_array_boolean_from_values_buffer(...)
+extern const PyMethodDef kDefPyDenseArrayBooleanFromValuesBuffer;
+
 // def dense_array_bytes_from_values(...)
 extern const PyMethodDef kDefPyDenseArrayBytesFromValues;
 
 // def dense_array_float32_from_values(...)
 extern const PyMethodDef kDefPyDenseArrayFloat32FromValues;
 
+// def dense_array_float32_from_values_buffer(...)
+extern const PyMethodDef kDefPyDenseArrayFloat32FromValuesBuffer;
+
 // def dense_array_float64_from_values(...)
 extern const PyMethodDef kDefPyDenseArrayFloat64FromValues;
 
+// def dense_array_float64_from_values_buffer(...)
+extern const PyMethodDef kDefPyDenseArrayFloat64FromValuesBuffer;
+
 // def dense_array_int32_from_values(...)
 extern const PyMethodDef kDefPyDenseArrayInt32FromValues;
 
+// def dense_array_int32_from_values_buffer(...)
+extern const PyMethodDef kDefPyDenseArrayInt32FromValuesBuffer;
+
 // def dense_array_int64_from_values(...)
 extern const PyMethodDef kDefPyDenseArrayInt64FromValues;
 
+// def dense_array_int64_from_values_buffer(...)
+extern const PyMethodDef kDefPyDenseArrayInt64FromValuesBuffer;
+
 // def dense_array_text_from_values(...)
 extern const PyMethodDef kDefPyDenseArrayTextFromValues;
 
 // def dense_array_uint64_from_values(...)
 extern const PyMethodDef kDefPyDenseArrayUInt64FromValues;
 
+// def dense_array_uint64_from_values_buffer(...)
+extern const PyMethodDef kDefPyDenseArrayUInt64FromValuesBuffer;
+
 // def dense_array_unit_from_values(...)
 extern const PyMethodDef kDefPyDenseArrayUnitFromValues;
 
 // def dense_array_weak_float_from_values(...)
 extern const PyMethodDef kDefPyDenseArrayWeakFloatFromValues;
 
+// def dense_array_weak_float_from_values_buffer(...)
+extern const PyMethodDef kDefPyDenseArrayWeakFloatFromValuesBuffer;
+
 // def get_array_item(...)
 extern const PyMethodDef kDefPyGetArrayItem;
 
@@ -24,7 +24,6 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
-#include "absl/types/span.h"
 #include "py/arolla/abc/pybind11_utils.h"
 #include "py/arolla/types/qtype/array_boxing.h"
 #include "py/arolla/types/qtype/scalar_boxing.h"
@@ -37,7 +36,6 @@
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/qtype/types.h"
-#include "arolla/memory/buffer.h"
 #include "arolla/qtype/array_like/array_like_qtype.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/dict/dict_types.h"
@@ -65,46 +63,53 @@ PYBIND11_MODULE(clib, m) {
   py::options options;
   options.disable_function_signatures();
 
-  pybind11_module_add_functions<            // go/keep-sorted start
-      kDefPyBoolean,                        //
-      kDefPyBytes,                          //
-      kDefPyDenseArrayBooleanFromValues,    //
-      kDefPyDenseArrayBytesFromValues,      //
-      kDefPyDenseArrayFloat32FromValues,    //
-      kDefPyDenseArrayFloat64FromValues,    //
-      kDefPyDenseArrayInt32FromValues,      //
-      kDefPyDenseArrayInt64FromValues,      //
-      kDefPyDenseArrayTextFromValues,       //
-      kDefPyDenseArrayUInt64FromValues,     //
-      kDefPyDenseArrayUnitFromValues,       //
-      kDefPyDenseArrayWeakFloatFromValues,  //
-      kDefPyFloat32,                        //
-      kDefPyFloat64,                        //
-      kDefPyGetArrayItem,                   //
-      kDefPyGetArrayPyValue,                //
-      kDefPyInt32,                          //
-      kDefPyInt64,                          //
-      kDefPyOptionalBoolean,                //
-      kDefPyOptionalBytes,                  //
-      kDefPyOptionalFloat32,                //
-      kDefPyOptionalFloat64,                //
-      kDefPyOptionalInt32,                  //
-      kDefPyOptionalInt64,                  //
-      kDefPyOptionalText,                   //
-      kDefPyOptionalUInt64,                 //
-      kDefPyOptionalUnit,                   //
-      kDefPyOptionalWeakFloat,              //
-      kDefPyText,                           //
-      kDefPyUInt64,                         //
-      kDefPyUnit,                           //
-      kDefPyValueBoolean,                   //
-      kDefPyValueBytes,                     //
-      kDefPyValueFloat,                     //
-      kDefPyValueIndex,                     //
-      kDefPyValueText,                      //
-      kDefPyValueUnit,                      //
-      kDefPyWeakFloat                       //
-      >(m);                                 // go/keep-sorted end
+  pybind11_module_add_functions<                  // go/keep-sorted start
+      kDefPyBoolean,                              //
+      kDefPyBytes,                                //
+      kDefPyDenseArrayBooleanFromValues,          //
+      kDefPyDenseArrayBooleanFromValuesBuffer,    //
+      kDefPyDenseArrayBytesFromValues,            //
+      kDefPyDenseArrayFloat32FromValues,          //
+      kDefPyDenseArrayFloat32FromValuesBuffer,    //
+      kDefPyDenseArrayFloat64FromValues,          //
+      kDefPyDenseArrayFloat64FromValuesBuffer,    //
+      kDefPyDenseArrayInt32FromValues,            //
+      kDefPyDenseArrayInt32FromValuesBuffer,      //
+      kDefPyDenseArrayInt64FromValues,            //
+      kDefPyDenseArrayInt64FromValuesBuffer,      //
+      kDefPyDenseArrayTextFromValues,             //
+      kDefPyDenseArrayUInt64FromValues,           //
+      kDefPyDenseArrayUInt64FromValuesBuffer,     //
+      kDefPyDenseArrayUnitFromValues,             //
+      kDefPyDenseArrayWeakFloatFromValues,        //
+      kDefPyDenseArrayWeakFloatFromValuesBuffer,  //
+      kDefPyFloat32,                              //
+      kDefPyFloat64,                              //
+      kDefPyGetArrayItem,                         //
+      kDefPyGetArrayPyValue,                      //
+      kDefPyInt32,                                //
+      kDefPyInt64,                                //
+      kDefPyOptionalBoolean,                      //
+      kDefPyOptionalBytes,                        //
+      kDefPyOptionalFloat32,                      //
+      kDefPyOptionalFloat64,                      //
+      kDefPyOptionalInt32,                        //
+      kDefPyOptionalInt64,                        //
+      kDefPyOptionalText,                         //
+      kDefPyOptionalUInt64,                       //
+      kDefPyOptionalUnit,                         //
+      kDefPyOptionalWeakFloat,                    //
+      kDefPyText,                                 //
+      kDefPyUInt64,                               //
+      kDefPyUnit,                                 //
+      kDefPyValueBoolean,                         //
+      kDefPyValueBytes,                           //
+      kDefPyValueFloat,                           //
+      kDefPyValueIndex,                           //
+      kDefPyValueText,                            //
+      kDefPyValueUnit,                            //
+      kDefPyWeakFloat                             //
+      >(m);                                       // go/keep-sorted end
 
   m.add_object("MissingOptionalError",
                py::cast<py::type>(PyExc_MissingOptionalError));
@@ -128,85 +133,6 @@ PYBIND11_MODULE(clib, m) {
   // go/keep-sorted end
 
   // go/keep-sorted start block=yes newline_separated=yes
-  m.def(
-      "dense_array_boolean_from_values_buffer",
-      [](absl::Span<const bool> buffer) {
-        return TypedValue::FromValue(DenseArray<bool>{
-            Buffer<bool>::Create(buffer.begin(), buffer.end())});
-      },
-      py::arg("buffer"), py::pos_only(),
-      py::doc("dense_array_boolean_from_values_buffer(buffer, /)\n"
-              "--\n\n"
-              "Returns DENSE_ARRAY_BOOLEAN qvalue."));
-
-  m.def(
-      "dense_array_float32_from_values_buffer",
-      [](absl::Span<const float> buffer) {
-        return TypedValue::FromValue(DenseArray<float>{
-            Buffer<float>::Create(buffer.begin(), buffer.end())});
-      },
-      py::arg("buffer"), py::pos_only(),
-      py::doc("dense_array_float32_from_values_buffer(buffer, /)\n"
-              "--\n\n"
-              "Returns DENSE_ARRAY_FLOAT32 qvalue."));
-
-  m.def(
-      "dense_array_float64_from_values_buffer",
-      [](absl::Span<const double> buffer) {
-        return TypedValue::FromValue(DenseArray<double>{
-            Buffer<double>::Create(buffer.begin(), buffer.end())});
-      },
-      py::arg("buffer"), py::pos_only(),
-      py::doc("dense_array_float64_from_values_buffer(buffer, /)\n"
-              "--\n\n"
-              "Returns DENSE_ARRAY_FLOAT64 qvalue."));
-
-  m.def(
-      "dense_array_int32_from_values_buffer",
-      [](absl::Span<const int32_t> buffer) {
-        return TypedValue::FromValue(DenseArray<int32_t>{
-            Buffer<int32_t>::Create(buffer.begin(), buffer.end())});
-      },
-      py::arg("buffer"), py::pos_only(),
-      py::doc("dense_array_int32_from_values_buffer(buffer, /)\n"
-              "--\n\n"
-              "Returns DENSE_ARRAY_INT32 qvalue."));
-
-  m.def(
-      "dense_array_int64_from_values_buffer",
-      [](absl::Span<const int64_t> buffer) {
-        return TypedValue::FromValue(DenseArray<int64_t>{
-            Buffer<int64_t>::Create(buffer.begin(), buffer.end())});
-      },
-      py::arg("buffer"), py::pos_only(),
-      py::doc("dense_array_int64_from_values_buffer(buffer, /)\n"
-              "--\n\n"
-              "Returns DENSE_ARRAY_INT64 qvalue."));
-
-  m.def(
-      "dense_array_uint64_from_values_buffer",
-      [](absl::Span<const uint64_t> buffer) {
-        return TypedValue::FromValue(DenseArray<uint64_t>{
-            Buffer<uint64_t>::Create(buffer.begin(), buffer.end())});
-      },
-      py::arg("buffer"), py::pos_only(),
-      py::doc("dense_array_uint64_from_values_buffer(buffer, /)\n"
-              "--\n\n"
-              "Returns DENSE_ARRAY_UINT64 qvalue."));
-
-  m.def(
-      "dense_array_weak_float_from_values_buffer",
-      [](absl::Span<const double> buffer) {
-        return *TypedValue::FromValueWithQType(
-            DenseArray<double>{
-                Buffer<double>::Create(buffer.begin(), buffer.end())},
-            GetDenseArrayWeakFloatQType());
-      },
-      py::arg("buffer"), py::pos_only(),
-      py::doc("dense_array_weak_float_from_values_buffer(buffer, /)\n"
-              "--\n\n"
-              "Returns DENSE_ARRAY_WEAK_FLOAT qvalue."));
-
   m.def(
       "get_namedtuple_field_index",
       [](QTypePtr qtype, absl::string_view field_name) {
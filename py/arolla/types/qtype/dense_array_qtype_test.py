@@ -23,6 +23,7 @@ from absl.testing import parameterized
 import numpy
 from arolla.types.qtype import array_qtype
 from arolla.types.qtype import casting
+from arolla.types.qtype import clib
 from arolla.types.qtype import dense_array_qtype
 from arolla.types.qtype import optional_qtype
 from arolla.types.qtype import scalar_qtype
@@ -267,6 +268,65 @@ class DenseArrayQTypeTest(parameterized.TestCase):
     )
     _ = dense_array_factory(np_values)
 
+  def test_dense_array_from_values_buffer_copies_writable_data(self):
+    np_array = numpy.array([1, 2, 3], dtype=numpy.int64)
+    qvalue = clib.dense_array_int64_from_values_buffer(np_array)
+    np_array[0] = 10
+    self.assertListEqual(array_qtype.get_array_py_value(qvalue), [1, 2, 3])
+
+  def test_dense_array_from_values_buffer_copies_read_only_data(self):
+    np_array = numpy.array([1, 2, 3], dtype=numpy.int64)
+    np_view = np_array[:]
+    np_view.flags.writeable = False
+    qvalue = clib.dense_array_int64_from_values_buffer(np_view)
+    # The read-only view doesn't prevent modifications of the data.
+    np_array[0] = 10
+    self.assertListEqual(array_qtype.get_array_py_value(qvalue), [1, 2, 3])
+
+  def test_dense_array_from_values_buffer_shares_bytes_data(self):
+    data = numpy.array([1, 2, 3], dtype=numpy.int64).tobytes()
+    view = memoryview(data).cast('q')
+    view_weakref = weakref.ref(view)
+    qvalue = clib.dense_array_int64_from_values_buffer(view)
+    del view
+    gc.collect()
+    # The dense array keeps the exporter alive.
+    self.assertIsNotNone(view_weakref())
+    self.assertListEqual(array_qtype.get_array_py_value(qvalue), [1, 2, 3])
+    del qvalue
+    gc.collect()
+    self.assertIsNone(view_weakref())
+
+  def test_dense_array_from_values_buffer_unaligned_bytes_data(self):
+    data = b'\0' + numpy.array([1, 2, 3], dtype=numpy.int64).tobytes()
+    qvalue = clib.dense_array_int64_from_values_buffer(
+        memoryview(data)[1:].cast('q')
+    )
+    self.assertListEqual(array_qtype.get_array_py_value(qvalue), [1, 2, 3])
+
+  def test_dense_array_from_values_buffer_type_error(self):
+    with self.assertRaisesWithLiteralMatch(
+        TypeError,
+        "expected a one-dimensional buffer of INT64, got ndim=1, format='i'",
+    ):
+      clib.dense_array_int64_from_values_buffer(
+          numpy.array([1, 2, 3], dtype=numpy.int32)
+      )
+
+  def test_dense_array_from_values_memoryview(self):
+    qvalue = dense_array_qtype.dense_array_float64(
+        memoryview(numpy.array([0.5, 1.5, 2.5]))
+    )
+    self.assertEqual(qvalue.qtype, dense_array_qtype.DENSE_ARRAY_FLOAT64)
+    self.assertListEqual(
+        array_qtype.get_array_py_value(qvalue), [0.5, 1.5, 2.5]
+    )
+    # Incompatible buffers fall back to the sequence protocol.
+    qvalue = dense_array_qtype.dense_array_float64(
+        memoryview(numpy.array([1, 2], dtype=numpy.int32))
+    )
+    self.assertListEqual(array_qtype.get_array_py_value(qvalue), [1.0, 2.0])
+
   def test_dense_array_from_values_numpy_array_value_error(self):
     with self.assertRaises(ValueError):
       dense_array_qtype.dense_array_int32(numpy.array(['foo']))